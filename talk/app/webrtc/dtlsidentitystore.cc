@@ -119,18 +119,17 @@ class DtlsIdentityStoreImpl::WorkerTask : public sigslot::has_slots<>,
   const rtc::KeyType key_type_;
 };
 
+const size_t DtlsIdentityStoreImpl::kDefaultRsaPoolSize;
+const size_t DtlsIdentityStoreImpl::kDefaultEcdsaPoolSize;
+
 DtlsIdentityStoreImpl::DtlsIdentityStoreImpl(rtc::Thread* signaling_thread,
                                              rtc::Thread* worker_thread)
     : signaling_thread_(signaling_thread),
       worker_thread_(worker_thread),
       request_info_() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  // Preemptively generate identities unless the worker thread and signaling
-  // thread are the same (only do preemptive work in the background).
-  if (worker_thread_ != signaling_thread_) {
-    // Only necessary for RSA.
-    GenerateIdentity(rtc::KT_RSA, nullptr);
-  }
+  SetPoolSize(rtc::KT_RSA, kDefaultRsaPoolSize, kDefaultRsaPoolSize);
+  SetPoolSize(rtc::KT_ECDSA, kDefaultEcdsaPoolSize, kDefaultEcdsaPoolSize);
 }
 
 DtlsIdentityStoreImpl::~DtlsIdentityStoreImpl() {
@@ -160,10 +159,30 @@ void DtlsIdentityStoreImpl::OnMessage(rtc::Message* msg) {
   }
 }
 
+void DtlsIdentityStoreImpl::SetPoolSize(rtc::KeyType key_type,
+                                        size_t pool_size,
+                                        size_t refill_threshold) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK_LE(refill_threshold, pool_size);
+  RequestInfo& info = request_info_[key_type];
+  info.pool_size_ = pool_size;
+  info.refill_threshold_ = refill_threshold;
+  // Drop the identities that no longer fit in the pool.
+  while (info.free_identities_.size() > pool_size)
+    info.free_identities_.pop();
+  FillPool(key_type);
+}
+
 bool DtlsIdentityStoreImpl::HasFreeIdentityForTesting(
     rtc::KeyType key_type) const {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  return request_info_[key_type].free_identity_.get() != nullptr;
+  return !request_info_[key_type].free_identities_.empty();
+}
+
+size_t DtlsIdentityStoreImpl::NumFreeIdentitiesForTesting(
+    rtc::KeyType key_type) const {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  return request_info_[key_type].free_identities_.size();
 }
 
 void DtlsIdentityStoreImpl::GenerateIdentity(
@@ -176,14 +195,17 @@ void DtlsIdentityStoreImpl::GenerateIdentity(
     request_info_[key_type].request_observers_.push(observer);
 
     // Already have a free identity generated?
-    if (request_info_[key_type].free_identity_.get()) {
+    if (!request_info_[key_type].free_identities_.empty()) {
       // Return identity async - post even though we are on |signaling_thread_|.
       LOG(LS_VERBOSE) << "Using a free DTLS identity.";
       ++request_info_[key_type].gen_in_progress_counts_;
       IdentityResultMessageData* msg =
           new IdentityResultMessageData(new IdentityResult(
-              key_type, std::move(request_info_[key_type].free_identity_)));
+              key_type,
+              std::move(request_info_[key_type].free_identities_.front())));
+      request_info_[key_type].free_identities_.pop();
       signaling_thread_->Post(this, MSG_GENERATE_IDENTITY_RESULT, msg);
+      RefillPool(key_type);
       return;
     }
 
@@ -219,13 +241,15 @@ void DtlsIdentityStoreImpl::OnIdentityGenerated(
   }
 
   if (observer.get() == nullptr) {
-    // No observer - store result in |free_identities_|.
-    RTC_DCHECK(!request_info_[key_type].free_identity_.get());
-    request_info_[key_type].free_identity_.swap(identity);
-    if (request_info_[key_type].free_identity_.get())
-      LOG(LS_VERBOSE) << "A free DTLS identity was saved.";
-    else
+    // No observer - store result in |free_identities_|. Failures are not
+    // retried until the pool is drawn from again.
+    if (!identity.get()) {
       LOG(LS_WARNING) << "Failed to generate DTLS identity (preemptively).";
+    } else if (request_info_[key_type].free_identities_.size() <
+               request_info_[key_type].pool_size_) {
+      LOG(LS_VERBOSE) << "A free DTLS identity was saved.";
+      request_info_[key_type].free_identities_.push(std::move(identity));
+    }
   } else {
     // Return the result to the observer.
     if (identity.get()) {
@@ -237,13 +261,27 @@ void DtlsIdentityStoreImpl::OnIdentityGenerated(
     }
 
     // Preemptively generate another identity of the same type?
-    if (worker_thread_ != signaling_thread_ && // Only do in background thread.
-        key_type == rtc::KT_RSA &&             // Only necessary for RSA.
-        !request_info_[key_type].free_identity_.get() &&
-        request_info_[key_type].request_observers_.size() <=
-            request_info_[key_type].gen_in_progress_counts_) {
-      GenerateIdentity(key_type, nullptr);
-    }
+    RefillPool(key_type);
+  }
+}
+
+void DtlsIdentityStoreImpl::RefillPool(rtc::KeyType key_type) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (request_info_[key_type].NumPooledIdentities() <
+      request_info_[key_type].refill_threshold_) {
+    FillPool(key_type);
+  }
+}
+
+void DtlsIdentityStoreImpl::FillPool(rtc::KeyType key_type) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  // Only do preemptive work in the background.
+  if (worker_thread_ == signaling_thread_)
+    return;
+
+  while (request_info_[key_type].NumPooledIdentities() <
+         request_info_[key_type].pool_size_) {
+    GenerateIdentity(key_type, nullptr);
   }
 }
 
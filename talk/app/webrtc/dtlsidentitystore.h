@@ -95,9 +95,17 @@ class DtlsIdentityStoreInterface {
 
 // The WebRTC default implementation of DtlsIdentityStoreInterface.
 // Identity generation is performed on the worker thread.
+// If the worker thread is not the same as the signaling thread, the store keeps
+// a pool of free identities of each key type that is refilled in the
+// background, so that requests can be answered without waiting for key
+// generation.
 class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
                               public rtc::MessageHandler {
  public:
+  // By default the pool holds one RSA identity and no ECDSA identities.
+  static const size_t kDefaultRsaPoolSize = 1;
+  static const size_t kDefaultEcdsaPoolSize = 0;
+
   // This will start to preemptively generating an RSA identity in the
   // background if the worker thread is not the same as the signaling thread.
   DtlsIdentityStoreImpl(rtc::Thread* signaling_thread,
@@ -112,13 +120,31 @@ class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
   // rtc::MessageHandler override;
   void OnMessage(rtc::Message* msg) override;
 
-  // Returns true if there is a free RSA identity, used for unit tests.
+  // Keeps up to |pool_size| free identities of |key_type| generated, and starts
+  // filling the pool right away. Once the number of free and preemptively
+  // generating identities drops below |refill_threshold|, generation is
+  // started until the pool is full again.
+  // A |pool_size| of 0 disables the pool for |key_type|. Has no effect if the
+  // worker thread is the same as the signaling thread.
+  void SetPoolSize(rtc::KeyType key_type,
+                   size_t pool_size,
+                   size_t refill_threshold);
+
+  // Returns true if there is a free identity of |key_type|, used for unit
+  // tests.
   bool HasFreeIdentityForTesting(rtc::KeyType key_type) const;
+  // Returns the number of free identities of |key_type|, used for unit tests.
+  size_t NumFreeIdentitiesForTesting(rtc::KeyType key_type) const;
 
  private:
   void GenerateIdentity(
       rtc::KeyType key_type,
       const rtc::scoped_refptr<DtlsIdentityRequestObserver>& observer);
+  // Starts generating identities for the pool of |key_type| if it has dropped
+  // below its refill threshold.
+  void RefillPool(rtc::KeyType key_type);
+  // Starts generating identities until the pool of |key_type| is full.
+  void FillPool(rtc::KeyType key_type);
   void OnIdentityGenerated(rtc::KeyType key_type,
                            rtc::scoped_ptr<rtc::SSLIdentity> identity);
 
@@ -148,12 +174,25 @@ class DtlsIdentityStoreImpl : public DtlsIdentityStoreInterface,
 
   struct RequestInfo {
     RequestInfo()
-        : request_observers_(), gen_in_progress_counts_(0), free_identity_() {}
+        : request_observers_(),
+          gen_in_progress_counts_(0),
+          free_identities_(),
+          pool_size_(0),
+          refill_threshold_(0) {}
+
+    // The number of free identities plus the number of identities being
+    // generated that no observer is waiting for.
+    size_t NumPooledIdentities() const {
+      return free_identities_.size() + gen_in_progress_counts_ -
+             request_observers_.size();
+    }
 
     std::queue<rtc::scoped_refptr<DtlsIdentityRequestObserver>>
         request_observers_;
     size_t gen_in_progress_counts_;
-    rtc::scoped_ptr<rtc::SSLIdentity> free_identity_;
+    std::queue<rtc::scoped_ptr<rtc::SSLIdentity>> free_identities_;
+    size_t pool_size_;
+    size_t refill_threshold_;
   };
 
   // One RequestInfo per KeyType. Only touch on the |signaling_thread_|.
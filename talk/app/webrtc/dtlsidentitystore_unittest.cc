@@ -150,3 +150,27 @@ TEST_F(DtlsIdentityStoreTest, DeleteStoreEarlyNoCrashECDSA) {
   EXPECT_FALSE(observer_->call_back_called());
 }
 
+
+TEST_F(DtlsIdentityStoreTest, PoolIsFilledAndRefilledECDSA) {
+  store_->SetPoolSize(rtc::KT_ECDSA, 3, 2);
+  EXPECT_EQ_WAIT(3u, store_->NumFreeIdentitiesForTesting(rtc::KT_ECDSA),
+                 kTimeoutMs);
+
+  // Taking one identity leaves the pool above its refill threshold.
+  store_->RequestIdentity(rtc::KT_ECDSA, observer_.get());
+  EXPECT_EQ(2u, store_->NumFreeIdentitiesForTesting(rtc::KT_ECDSA));
+  EXPECT_TRUE_WAIT(observer_->LastRequestSucceeded(), kTimeoutMs);
+  EXPECT_EQ(2u, store_->NumFreeIdentitiesForTesting(rtc::KT_ECDSA));
+
+  // Taking another one drops it below the threshold, which fills it again.
+  observer_->Reset();
+  store_->RequestIdentity(rtc::KT_ECDSA, observer_.get());
+  EXPECT_FALSE(observer_->call_back_called());
+  EXPECT_TRUE_WAIT(observer_->LastRequestSucceeded(), kTimeoutMs);
+  EXPECT_EQ_WAIT(3u, store_->NumFreeIdentitiesForTesting(rtc::KT_ECDSA),
+                 kTimeoutMs);
+
+  // Shrinking the pool drops the extra identities.
+  store_->SetPoolSize(rtc::KT_ECDSA, 1, 1);
+  EXPECT_EQ(1u, store_->NumFreeIdentitiesForTesting(rtc::KT_ECDSA));
+}
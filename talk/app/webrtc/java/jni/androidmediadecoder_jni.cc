@@ -635,9 +635,6 @@ bool MediaCodecVideoDecoder::DeliverPendingOutputs(
       const jfloatArray j_transform_matrix =
           reinterpret_cast<jfloatArray>(GetObjectField(
               jni, j_decoder_output_buffer, j_transform_matrix_field_));
-      const int64_t timestamp_us =
-          GetLongField(jni, j_decoder_output_buffer,
-              j_texture_timestamp_ms_field_);
       output_timestamps_ms = GetLongField(jni, j_decoder_output_buffer,
                                           j_texture_timestamp_ms_field_);
       output_ntp_timestamps_ms =
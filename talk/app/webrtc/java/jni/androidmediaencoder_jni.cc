@@ -108,7 +108,10 @@ class MediaCodecVideoEncoder : public webrtc::VideoEncoder,
 
   int GetTargetFramerate() override;
 
-  bool SupportsNativeHandle() const override { return true; }
+  // Texture frames are rendered straight into the MediaCodec input surface,
+  // which needs an EGL context. Without one they are converted to I420 by the
+  // caller instead.
+  bool SupportsNativeHandle() const override { return egl_context_ != nullptr; }
   const char* ImplementationName() const override;
 
  private:
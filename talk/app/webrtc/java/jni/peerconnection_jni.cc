@@ -767,14 +767,16 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
   virtual ~JavaVideoRendererWrapper() {}
 
   void RenderFrame(const cricket::VideoFrame* video_frame) override {
-    ScopedLocalRefFrame local_ref_frame(jni());
+    // Look up the JNIEnv once per frame rather than for every JNI call below.
+    JNIEnv* jni = this->jni();
+    ScopedLocalRefFrame local_ref_frame(jni);
     jobject j_frame = (video_frame->GetNativeHandle() != nullptr)
-                          ? CricketToJavaTextureFrame(video_frame)
-                          : CricketToJavaI420Frame(video_frame);
+                          ? CricketToJavaTextureFrame(jni, video_frame)
+                          : CricketToJavaI420Frame(jni, video_frame);
     // |j_callbacks_| is responsible for releasing |j_frame| with
     // VideoRenderer.renderFrameDone().
-    jni()->CallVoidMethod(*j_callbacks_, j_render_frame_id_, j_frame);
-    CHECK_EXCEPTION(jni());
+    jni->CallVoidMethod(*j_callbacks_, j_render_frame_id_, j_frame);
+    CHECK_EXCEPTION(jni);
   }
 
  private:
@@ -786,25 +788,24 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
   }
 
   // Return a VideoRenderer.I420Frame referring to the data in |frame|.
-  jobject CricketToJavaI420Frame(const cricket::VideoFrame* frame) {
-    jintArray strides = jni()->NewIntArray(3);
-    jint* strides_array = jni()->GetIntArrayElements(strides, NULL);
-    strides_array[0] = frame->GetYPitch();
-    strides_array[1] = frame->GetUPitch();
-    strides_array[2] = frame->GetVPitch();
-    jni()->ReleaseIntArrayElements(strides, strides_array, 0);
-    jobjectArray planes = jni()->NewObjectArray(3, *j_byte_buffer_class_, NULL);
+  jobject CricketToJavaI420Frame(JNIEnv* jni,
+                                 const cricket::VideoFrame* frame) {
+    const jint strides_array[3] = {frame->GetYPitch(), frame->GetUPitch(),
+                                   frame->GetVPitch()};
+    jintArray strides = jni->NewIntArray(3);
+    jni->SetIntArrayRegion(strides, 0, 3, strides_array);
+    jobjectArray planes = jni->NewObjectArray(3, *j_byte_buffer_class_, NULL);
     jobject y_buffer =
-        jni()->NewDirectByteBuffer(const_cast<uint8_t*>(frame->GetYPlane()),
-                                   frame->GetYPitch() * frame->GetHeight());
-    jobject u_buffer = jni()->NewDirectByteBuffer(
+        jni->NewDirectByteBuffer(const_cast<uint8_t*>(frame->GetYPlane()),
+                                 frame->GetYPitch() * frame->GetHeight());
+    jobject u_buffer = jni->NewDirectByteBuffer(
         const_cast<uint8_t*>(frame->GetUPlane()), frame->GetChromaSize());
-    jobject v_buffer = jni()->NewDirectByteBuffer(
+    jobject v_buffer = jni->NewDirectByteBuffer(
         const_cast<uint8_t*>(frame->GetVPlane()), frame->GetChromaSize());
-    jni()->SetObjectArrayElement(planes, 0, y_buffer);
-    jni()->SetObjectArrayElement(planes, 1, u_buffer);
-    jni()->SetObjectArrayElement(planes, 2, v_buffer);
-    return jni()->NewObject(
+    jni->SetObjectArrayElement(planes, 0, y_buffer);
+    jni->SetObjectArrayElement(planes, 1, u_buffer);
+    jni->SetObjectArrayElement(planes, 2, v_buffer);
+    return jni->NewObject(
         *j_frame_class_, j_i420_frame_ctor_id_,
         frame->GetWidth(), frame->GetHeight(),
         static_cast<int>(frame->GetVideoRotation()),
@@ -812,12 +813,13 @@ class JavaVideoRendererWrapper : public VideoRendererInterface {
   }
 
   // Return a VideoRenderer.I420Frame referring texture object in |frame|.
-  jobject CricketToJavaTextureFrame(const cricket::VideoFrame* frame) {
+  jobject CricketToJavaTextureFrame(JNIEnv* jni,
+                                    const cricket::VideoFrame* frame) {
     NativeHandleImpl* handle =
         reinterpret_cast<NativeHandleImpl*>(frame->GetNativeHandle());
-    jfloatArray sampling_matrix = jni()->NewFloatArray(16);
-    jni()->SetFloatArrayRegion(sampling_matrix, 0, 16, handle->sampling_matrix);
-    return jni()->NewObject(
+    jfloatArray sampling_matrix = jni->NewFloatArray(16);
+    jni->SetFloatArrayRegion(sampling_matrix, 0, 16, handle->sampling_matrix);
+    return jni->NewObject(
         *j_frame_class_, j_texture_frame_ctor_id_,
         frame->GetWidth(), frame->GetHeight(),
         static_cast<int>(frame->GetVideoRotation()),
@@ -1074,13 +1076,15 @@ JOW(void, PeerConnectionFactory_shutdownInternalTracer)(JNIEnv* jni, jclass) {
 // single thing for Java to hold and eventually free.
 class OwnedFactoryAndThreads {
  public:
-  OwnedFactoryAndThreads(Thread* worker_thread,
+  OwnedFactoryAndThreads(Thread* network_thread,
+                         Thread* worker_thread,
                          Thread* signaling_thread,
                          WebRtcVideoEncoderFactory* encoder_factory,
                          WebRtcVideoDecoderFactory* decoder_factory,
                          rtc::NetworkMonitorFactory* network_monitor_factory,
                          PeerConnectionFactoryInterface* factory)
-      : worker_thread_(worker_thread),
+      : network_thread_(network_thread),
+        worker_thread_(worker_thread),
         signaling_thread_(signaling_thread),
         encoder_factory_(encoder_factory),
         decoder_factory_(decoder_factory),
@@ -1106,6 +1110,7 @@ class OwnedFactoryAndThreads {
  private:
   void JavaCallbackOnFactoryThreads();
 
+  const scoped_ptr<Thread> network_thread_;
   const scoped_ptr<Thread> worker_thread_;
   const scoped_ptr<Thread> signaling_thread_;
   WebRtcVideoEncoderFactory* encoder_factory_;
@@ -1119,6 +1124,10 @@ void OwnedFactoryAndThreads::JavaCallbackOnFactoryThreads() {
   ScopedLocalRefFrame local_ref_frame(jni);
   jclass j_factory_class = FindClass(jni, "org/webrtc/PeerConnectionFactory");
   jmethodID m = nullptr;
+  if (Thread::Current() == network_thread_) {
+    LOG(LS_INFO) << "Network thread JavaCallback";
+    m = GetStaticMethodID(jni, j_factory_class, "onNetworkThreadReady", "()V");
+  }
   if (Thread::Current() == worker_thread_) {
     LOG(LS_INFO) << "Worker thread JavaCallback";
     m = GetStaticMethodID(jni, j_factory_class, "onWorkerThreadReady", "()V");
@@ -1136,6 +1145,8 @@ void OwnedFactoryAndThreads::JavaCallbackOnFactoryThreads() {
 
 void OwnedFactoryAndThreads::InvokeJavaCallbacksOnFactoryThreads() {
   LOG(LS_INFO) << "InvokeJavaCallbacksOnFactoryThreads.";
+  network_thread_->Invoke<void>(
+      Bind(&OwnedFactoryAndThreads::JavaCallbackOnFactoryThreads, this));
   worker_thread_->Invoke<void>(
       Bind(&OwnedFactoryAndThreads::JavaCallbackOnFactoryThreads, this));
   signaling_thread_->Invoke<void>(
@@ -1151,11 +1162,14 @@ JOW(jlong, PeerConnectionFactory_nativeCreatePeerConnectionFactory)(
   // about ramifications of auto-wrapping there.
   rtc::ThreadManager::Instance()->WrapCurrentThread();
   webrtc::Trace::CreateTrace();
+  Thread* network_thread = new Thread();
+  network_thread->SetName("network_thread", NULL);
   Thread* worker_thread = new Thread();
   worker_thread->SetName("worker_thread", NULL);
   Thread* signaling_thread = new Thread();
   signaling_thread->SetName("signaling_thread", NULL);
-  RTC_CHECK(worker_thread->Start() && signaling_thread->Start())
+  RTC_CHECK(network_thread->Start() && worker_thread->Start() &&
+            signaling_thread->Start())
       << "Failed to start threads";
   WebRtcVideoEncoderFactory* encoder_factory = nullptr;
   WebRtcVideoDecoderFactory* decoder_factory = nullptr;
@@ -1170,7 +1184,8 @@ JOW(jlong, PeerConnectionFactory_nativeCreatePeerConnectionFactory)(
   rtc::NetworkMonitorFactory::SetFactory(network_monitor_factory);
 #endif
   rtc::scoped_refptr<PeerConnectionFactoryInterface> factory(
-      webrtc::CreatePeerConnectionFactory(worker_thread,
+      webrtc::CreatePeerConnectionFactory(network_thread,
+                                          worker_thread,
                                           signaling_thread,
                                           NULL,
                                           encoder_factory,
@@ -1178,7 +1193,7 @@ JOW(jlong, PeerConnectionFactory_nativeCreatePeerConnectionFactory)(
   RTC_CHECK(factory) << "Failed to create the peer connection factory; "
                      << "WebRTC/libjingle init likely failed on this device";
   OwnedFactoryAndThreads* owned_factory = new OwnedFactoryAndThreads(
-      worker_thread, signaling_thread,
+      network_thread, worker_thread, signaling_thread,
       encoder_factory, decoder_factory,
       network_monitor_factory, factory.release());
   owned_factory->InvokeJavaCallbacksOnFactoryThreads();
@@ -41,6 +41,7 @@ public class PeerConnectionFactory {
 
   private static final String TAG = "PeerConnectionFactory";
   private final long nativeFactory;
+  private static Thread networkThread;
   private static Thread workerThread;
   private static Thread signalingThread;
 
@@ -192,6 +193,7 @@ public class PeerConnectionFactory {
     nativeFreeFactory(nativeFactory);
     signalingThread = null;
     workerThread = null;
+    networkThread = null;
   }
 
   public void threadsCallbacks() {
@@ -211,10 +213,16 @@ public class PeerConnectionFactory {
   }
 
   public static void printStackTraces() {
+    printStackTrace(networkThread, "Network thread");
     printStackTrace(workerThread, "Worker thread");
     printStackTrace(signalingThread, "Signaling thread");
   }
 
+  private static void onNetworkThreadReady() {
+    networkThread = Thread.currentThread();
+    Logging.d(TAG, "onNetworkThreadReady");
+  }
+
   private static void onWorkerThreadReady() {
     workerThread = Thread.currentThread();
     Logging.d(TAG, "onWorkerThreadReady");
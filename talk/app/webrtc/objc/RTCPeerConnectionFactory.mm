@@ -57,6 +57,7 @@
 @implementation RTCPeerConnectionFactory {
   rtc::scoped_ptr<rtc::Thread> _signalingThread;
   rtc::scoped_ptr<rtc::Thread> _workerThread;
+  rtc::scoped_ptr<rtc::Thread> _networkThread;
 }
 
 @synthesize nativeFactory = _nativeFactory;
@@ -79,9 +80,13 @@
     _workerThread.reset(new rtc::Thread());
     result = _workerThread->Start();
     NSAssert(result, @"Failed to start worker thread.");
+    _networkThread.reset(new rtc::Thread());
+    result = _networkThread->Start();
+    NSAssert(result, @"Failed to start network thread.");
 
     _nativeFactory = webrtc::CreatePeerConnectionFactory(
-        _signalingThread.get(), _workerThread.get(), nullptr, nullptr, nullptr);
+        _networkThread.get(), _workerThread.get(), _signalingThread.get(),
+        nullptr, nullptr, nullptr);
     NSAssert(_nativeFactory, @"Failed to initialize PeerConnectionFactory!");
     // Uncomment to get sensitive logs emitted (to stderr or logcat).
     // rtc::LogMessage::LogToDebug(rtc::LS_SENSITIVE);
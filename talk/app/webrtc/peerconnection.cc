@@ -632,6 +632,9 @@ bool PeerConnection::Initialize(
   port_allocator_->set_flags(portallocator_flags);
   // No step delay is used while allocating ports.
   port_allocator_->set_step_delay(cricket::kMinimumStepDelay);
+  // Start all allocation phases at once, so that e.g. TURN allocations don't
+  // wait for the UDP phase.
+  port_allocator_->set_phases_per_step(cricket::kAllPhasesPerStep);
 
   media_controller_.reset(factory_->CreateMediaController());
 
@@ -640,7 +643,8 @@ bool PeerConnection::Initialize(
 
   session_.reset(
       new WebRtcSession(media_controller_.get(), factory_->signaling_thread(),
-                        factory_->worker_thread(), port_allocator_.get()));
+                        factory_->worker_thread(), factory_->network_thread(),
+                        port_allocator_.get()));
   stats_.reset(new StatsCollector(this));
 
   // Initialize the WebRtcSession. It creates transport channels etc.
@@ -1462,6 +1466,8 @@ bool PeerConnection::GetOptionsForOffer(
   if (session_->data_channel_type() == cricket::DCT_SCTP && HasDataChannels()) {
     session_options->data_channel_type = cricket::DCT_SCTP;
   }
+
+  session_options->crypto_options = factory_->options().crypto_options;
   return true;
 }
 
@@ -1486,6 +1492,8 @@ bool PeerConnection::GetOptionsForAnswer(
   if (session_->data_channel_type() == cricket::DCT_SCTP) {
     session_options->data_channel_type = cricket::DCT_SCTP;
   }
+
+  session_options->crypto_options = factory_->options().crypto_options;
   return true;
 }
 
@@ -72,6 +72,24 @@ class DtlsIdentityStoreWrapper : public DtlsIdentityStoreInterface {
   rtc::scoped_refptr<RefCountedDtlsIdentityStore> store_;
 };
 
+// Passes down the calls to a controller owned by the factory, which outlives
+// every PeerConnection. See usage in CreateMediaController.
+class SharedMediaControllerWrapper : public MediaControllerInterface {
+ public:
+  explicit SharedMediaControllerWrapper(MediaControllerInterface* controller)
+      : controller_(controller) {
+    RTC_DCHECK(controller_);
+  }
+
+  webrtc::Call* call_w() override { return controller_->call_w(); }
+  cricket::ChannelManager* channel_manager() const override {
+    return controller_->channel_manager();
+  }
+
+ private:
+  MediaControllerInterface* const controller_;
+};
+
 }  // anonymous namespace
 
 rtc::scoped_refptr<PeerConnectionFactoryInterface>
@@ -101,8 +119,22 @@ CreatePeerConnectionFactory(
     AudioDeviceModule* default_adm,
     cricket::WebRtcVideoEncoderFactory* encoder_factory,
     cricket::WebRtcVideoDecoderFactory* decoder_factory) {
+  return CreatePeerConnectionFactory(worker_thread, worker_thread,
+                                     signaling_thread, default_adm,
+                                     encoder_factory, decoder_factory);
+}
+
+rtc::scoped_refptr<PeerConnectionFactoryInterface>
+CreatePeerConnectionFactory(
+    rtc::Thread* network_thread,
+    rtc::Thread* worker_thread,
+    rtc::Thread* signaling_thread,
+    AudioDeviceModule* default_adm,
+    cricket::WebRtcVideoEncoderFactory* encoder_factory,
+    cricket::WebRtcVideoDecoderFactory* decoder_factory) {
   rtc::scoped_refptr<PeerConnectionFactory> pc_factory(
-      new rtc::RefCountedObject<PeerConnectionFactory>(worker_thread,
+      new rtc::RefCountedObject<PeerConnectionFactory>(network_thread,
+                                                       worker_thread,
                                                        signaling_thread,
                                                        default_adm,
                                                        encoder_factory,
@@ -125,15 +157,18 @@ PeerConnectionFactory::PeerConnectionFactory()
     : owns_ptrs_(true),
       wraps_current_thread_(false),
       signaling_thread_(rtc::ThreadManager::Instance()->CurrentThread()),
-      worker_thread_(new rtc::Thread) {
+      worker_thread_(new rtc::Thread),
+      network_thread_(new rtc::Thread) {
   if (!signaling_thread_) {
     signaling_thread_ = rtc::ThreadManager::Instance()->WrapCurrentThread();
     wraps_current_thread_ = true;
   }
   worker_thread_->Start();
+  network_thread_->Start();
 }
 
 PeerConnectionFactory::PeerConnectionFactory(
+    rtc::Thread* network_thread,
     rtc::Thread* worker_thread,
     rtc::Thread* signaling_thread,
     AudioDeviceModule* default_adm,
@@ -143,9 +178,11 @@ PeerConnectionFactory::PeerConnectionFactory(
       wraps_current_thread_(false),
       signaling_thread_(signaling_thread),
       worker_thread_(worker_thread),
+      network_thread_(network_thread),
       default_adm_(default_adm),
       video_encoder_factory_(video_encoder_factory),
       video_decoder_factory_(video_decoder_factory) {
+  ASSERT(network_thread != NULL);
   ASSERT(worker_thread != NULL);
   ASSERT(signaling_thread != NULL);
   // TODO: Currently there is no way creating an external adm in
@@ -155,9 +192,10 @@ PeerConnectionFactory::PeerConnectionFactory(
 
 PeerConnectionFactory::~PeerConnectionFactory() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
+  shared_media_controller_.reset();
   channel_manager_.reset(nullptr);
 
-  // Make sure |worker_thread_| and |signaling_thread_| outlive
+  // Make sure the threads outlive
   // |dtls_identity_store_|, |default_socket_factory_| and
   // |default_network_manager_|.
   dtls_identity_store_ = nullptr;
@@ -168,6 +206,7 @@ PeerConnectionFactory::~PeerConnectionFactory() {
     if (wraps_current_thread_)
       rtc::ThreadManager::Instance()->UnwrapCurrentThread();
     delete worker_thread_;
+    delete network_thread_;
   }
 }
 
@@ -181,7 +220,7 @@ bool PeerConnectionFactory::Initialize() {
   }
 
   default_socket_factory_.reset(
-      new rtc::BasicPacketSocketFactory(worker_thread_));
+      new rtc::BasicPacketSocketFactory(network_thread_));
   if (!default_socket_factory_) {
     return false;
   }
@@ -193,7 +232,8 @@ bool PeerConnectionFactory::Initialize() {
       &PeerConnectionFactory::CreateMediaEngine_w, this));
 
   channel_manager_.reset(
-      new cricket::ChannelManager(media_engine, worker_thread_));
+      new cricket::ChannelManager(media_engine, worker_thread_,
+                                  network_thread_));
 
   channel_manager_->SetVideoRtxEnabled(true);
   if (!channel_manager_->Init()) {
@@ -302,11 +342,18 @@ PeerConnectionFactory::CreateAudioTrack(const std::string& id,
   return AudioTrackProxy::Create(signaling_thread_, track);
 }
 
-webrtc::MediaControllerInterface* PeerConnectionFactory::CreateMediaController()
-    const {
+webrtc::MediaControllerInterface*
+PeerConnectionFactory::CreateMediaController() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  return MediaControllerInterface::Create(worker_thread_,
-                                          channel_manager_.get());
+  if (!options_.share_call) {
+    return MediaControllerInterface::Create(worker_thread_,
+                                            channel_manager_.get());
+  }
+  if (!shared_media_controller_) {
+    shared_media_controller_.reset(MediaControllerInterface::Create(
+        worker_thread_, channel_manager_.get()));
+  }
+  return new SharedMediaControllerWrapper(shared_media_controller_.get());
 }
 
 rtc::Thread* PeerConnectionFactory::signaling_thread() {
@@ -320,6 +367,11 @@ rtc::Thread* PeerConnectionFactory::worker_thread() {
   return worker_thread_;
 }
 
+rtc::Thread* PeerConnectionFactory::network_thread() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  return network_thread_;
+}
+
 cricket::MediaEngineInterface* PeerConnectionFactory::CreateMediaEngine_w() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
   return cricket::WebRtcMediaEngineFactory::Create(
@@ -87,14 +87,18 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   bool StartRtcEventLog(rtc::PlatformFile file) override;
   void StopRtcEventLog() override;
 
-  virtual webrtc::MediaControllerInterface* CreateMediaController() const;
+  // Returns a controller owned by the caller. With |options_.share_call| it
+  // forwards to one controller owned by the factory.
+  virtual webrtc::MediaControllerInterface* CreateMediaController();
   virtual rtc::Thread* signaling_thread();
   virtual rtc::Thread* worker_thread();
+  virtual rtc::Thread* network_thread();
   const Options& options() const { return options_; }
 
  protected:
   PeerConnectionFactory();
   PeerConnectionFactory(
+      rtc::Thread* network_thread,
       rtc::Thread* worker_thread,
       rtc::Thread* signaling_thread,
       AudioDeviceModule* default_adm,
@@ -109,10 +113,13 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   bool wraps_current_thread_;
   rtc::Thread* signaling_thread_;
   rtc::Thread* worker_thread_;
+  rtc::Thread* network_thread_;
   Options options_;
   // External Audio device used for audio playback.
   rtc::scoped_refptr<AudioDeviceModule> default_adm_;
   rtc::scoped_ptr<cricket::ChannelManager> channel_manager_;
+  // Created by the first PeerConnection which shares a Call.
+  rtc::scoped_ptr<MediaControllerInterface> shared_media_controller_;
   // External Video encoder factory. This can be NULL if the client has not
   // injected any. In that case, video engine will use the internal SW encoder.
   rtc::scoped_ptr<cricket::WebRtcVideoEncoderFactory>
@@ -38,7 +38,7 @@
 namespace webrtc {
 
 BEGIN_PROXY_MAP(PeerConnectionFactory)
-  PROXY_METHOD1(void, SetOptions, const Options&)
+  PROXY_ASYNC_METHOD1(SetOptions, const Options&)
   // Can't use PROXY_METHOD5 because scoped_ptr must be moved.
   // TODO(tommi,hbos): Use of templates to support scoped_ptr?
   rtc::scoped_refptr<PeerConnectionInterface> CreatePeerConnection(
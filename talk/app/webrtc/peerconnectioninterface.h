@@ -507,7 +507,8 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
           disable_sctp_data_channels(false),
           disable_network_monitor(false),
           network_ignore_mask(rtc::kDefaultNetworkIgnoreMask),
-          ssl_max_version(rtc::SSL_PROTOCOL_DTLS_12) {}
+          ssl_max_version(rtc::SSL_PROTOCOL_DTLS_12),
+          share_call(false) {}
     bool disable_encryption;
     bool disable_sctp_data_channels;
     bool disable_network_monitor;
@@ -521,6 +522,17 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
     // supported by both ends will be used for the connection, i.e. if one
     // party supports DTLS 1.0 and the other DTLS 1.2, DTLS 1.0 will be used.
     rtc::SSLProtocolVersion ssl_max_version;
+
+    // Sets crypto related options, e.g. enabled cipher suites.
+    rtc::CryptoOptions crypto_options;
+
+    // If true, PeerConnections created from now on share one webrtc::Call,
+    // and with it its threads, pacer and congestion controller, instead of
+    // creating one each. Meant for servers with many connections. Bandwidth
+    // estimation, bitrate configuration and network state are then common to
+    // all sharing connections, so one connection going down pauses sending
+    // on the others as well.
+    bool share_call;
   };
 
   virtual void SetOptions(const Options& options) = 0;
@@ -598,8 +610,21 @@ CreatePeerConnectionFactory();
 // Create a new instance of PeerConnectionFactoryInterface.
 // Ownership of |factory|, |default_adm|, and optionally |encoder_factory| and
 // |decoder_factory| transferred to the returned factory.
+// |worker_thread| also serves as the network thread.
+rtc::scoped_refptr<PeerConnectionFactoryInterface>
+CreatePeerConnectionFactory(
+    rtc::Thread* worker_thread,
+    rtc::Thread* signaling_thread,
+    AudioDeviceModule* default_adm,
+    cricket::WebRtcVideoEncoderFactory* encoder_factory,
+    cricket::WebRtcVideoDecoderFactory* decoder_factory);
+
+// Same as above, but sends and receives packets on |network_thread|, keeping
+// media processing on |worker_thread| from delaying packet I/O. The two may
+// be the same thread.
 rtc::scoped_refptr<PeerConnectionFactoryInterface>
 CreatePeerConnectionFactory(
+    rtc::Thread* network_thread,
     rtc::Thread* worker_thread,
     rtc::Thread* signaling_thread,
     AudioDeviceModule* default_adm,
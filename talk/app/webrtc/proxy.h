@@ -51,10 +51,22 @@
 // END_PROXY()
 //
 // The proxy can be created using TestProxy::Create(Thread*, TestInterface*).
+//
+// Each proxied call waits for a round trip to the owner thread, unless it is
+// made on that thread, where it runs directly. A sequence of calls can
+// therefore be marshaled once with InvokeOnProxyThread().
+//
+// Void methods whose arguments are copied may instead be declared with
+// PROXY_ASYNC_METHOD0/1, which post the call and return without waiting.
+// Posted calls still run in order with all other calls through any proxy on
+// the same thread. Do not use them for methods taking pointers the caller
+// may free once the call returns, such as observers and sinks.
 
 #ifndef TALK_APP_WEBRTC_PROXY_H_
 #define TALK_APP_WEBRTC_PROXY_H_
 
+#include <type_traits>
+
 #include "webrtc/base/event.h"
 #include "webrtc/base/thread.h"
 
@@ -312,6 +324,68 @@ class MethodCall5 : public rtc::Message,
   T5 a5_;
 };
 
+template <typename C>
+class AsyncMethodCall0 : public rtc::MessageData,
+                         public rtc::MessageHandler {
+ public:
+  typedef void (C::*Method)();
+  AsyncMethodCall0(C* c, Method m) : c_(c), m_(m) {}
+
+  // Deletes this once the call has run.
+  void Marshal(rtc::Thread* t) {
+    if (t->IsCurrent()) {
+      OnMessage(NULL);
+    } else {
+      t->Post(this, 0, this);
+    }
+  }
+
+ private:
+  void OnMessage(rtc::Message*) {
+    (c_->*m_)();
+    delete this;
+  }
+
+  rtc::scoped_refptr<C> c_;
+  Method m_;
+};
+
+template <typename C, typename T1>
+class AsyncMethodCall1 : public rtc::MessageData,
+                         public rtc::MessageHandler {
+ public:
+  typedef void (C::*Method)(T1 a1);
+  AsyncMethodCall1(C* c, Method m, T1 a1) : c_(c), m_(m), a1_(a1) {}
+
+  // Deletes this once the call has run.
+  void Marshal(rtc::Thread* t) {
+    if (t->IsCurrent()) {
+      OnMessage(NULL);
+    } else {
+      t->Post(this, 0, this);
+    }
+  }
+
+ private:
+  void OnMessage(rtc::Message*) {
+    (c_->*m_)(a1_);
+    delete this;
+  }
+
+  rtc::scoped_refptr<C> c_;
+  Method m_;
+  // A copy, since the caller's argument may be gone when the call runs.
+  typename std::decay<T1>::type a1_;
+};
+
+// Runs |functor| on |thread|, the owner thread of a set of proxies, and
+// returns its result. Proxy calls made from |functor| run directly, so the
+// whole sequence costs a single round trip.
+template <class ReturnT, class FunctorT>
+ReturnT InvokeOnProxyThread(rtc::Thread* thread, const FunctorT& functor) {
+  return thread->Invoke<ReturnT>(functor);
+}
+
 #define BEGIN_PROXY_MAP(c)                                                \
   class c##Proxy : public c##Interface {                                  \
    protected:                                                             \
@@ -377,6 +451,18 @@ class MethodCall5 : public rtc::Message,
     return call.Marshal(owner_thread_);                                      \
   }
 
+#define PROXY_ASYNC_METHOD0(method)                                \
+  void method() override {                                         \
+    (new AsyncMethodCall0<C>(c_.get(), &C::method))                \
+        ->Marshal(owner_thread_);                                  \
+  }
+
+#define PROXY_ASYNC_METHOD1(method, t1)                            \
+  void method(t1 a1) override {                                    \
+    (new AsyncMethodCall1<C, t1>(c_.get(), &C::method, a1))        \
+        ->Marshal(owner_thread_);                                  \
+  }
+
 #define END_PROXY() \
    private:\
     void Release_s() {\
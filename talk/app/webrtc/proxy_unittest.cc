@@ -52,6 +52,8 @@ class FakeInterface : public rtc::RefCountInterface {
   virtual std::string Method1(std::string s) = 0;
   virtual std::string ConstMethod1(std::string s) const = 0;
   virtual std::string Method2(std::string s1, std::string s2) = 0;
+  virtual void AsyncMethod0() = 0;
+  virtual void AsyncMethod1(const std::string& s) = 0;
 
  protected:
   ~FakeInterface() {}
@@ -65,6 +67,8 @@ BEGIN_PROXY_MAP(Fake)
   PROXY_METHOD1(std::string, Method1, std::string)
   PROXY_CONSTMETHOD1(std::string, ConstMethod1, std::string)
   PROXY_METHOD2(std::string, Method2, std::string, std::string)
+  PROXY_ASYNC_METHOD0(AsyncMethod0)
+  PROXY_ASYNC_METHOD1(AsyncMethod1, const std::string&)
 END_PROXY()
 
 // Implementation of the test interface.
@@ -82,6 +86,8 @@ class Fake : public FakeInterface {
   MOCK_CONST_METHOD1(ConstMethod1, std::string(std::string));
 
   MOCK_METHOD2(Method2, std::string(std::string, std::string));
+  MOCK_METHOD0(AsyncMethod0, void());
+  MOCK_METHOD1(AsyncMethod1, void(const std::string&));
 
  protected:
   Fake() {}
@@ -167,4 +173,33 @@ TEST_F(ProxyTest, Method2) {
   EXPECT_EQ("Method2", fake_proxy_->Method2(arg1, arg2));
 }
 
+TEST_F(ProxyTest, AsyncMethodsRunInOrderWithSynchronousOnes) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*fake_, AsyncMethod0())
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  EXPECT_CALL(*fake_, AsyncMethod1("arg1"))
+            .WillOnce(InvokeWithoutArgs(this, &ProxyTest::CheckThread));
+  EXPECT_CALL(*fake_, Method0()).WillOnce(Return("Method0"));
+  fake_proxy_->AsyncMethod0();
+  {
+    // The argument must be copied, as it is gone before the call runs.
+    std::string arg1 = "arg1";
+    fake_proxy_->AsyncMethod1(arg1);
+  }
+  EXPECT_EQ("Method0", fake_proxy_->Method0());
+}
+
+TEST_F(ProxyTest, InvokeOnProxyThreadRunsCallsDirectly) {
+  EXPECT_CALL(*fake_, Method0())
+            .Times(Exactly(2))
+            .WillRepeatedly(
+                DoAll(InvokeWithoutArgs(this, &ProxyTest::CheckThread),
+                      Return("Method0")));
+  rtc::scoped_refptr<FakeInterface> proxy = fake_proxy_;
+  EXPECT_EQ("Method0Method0",
+            InvokeOnProxyThread<std::string>(
+                signaling_thread_.get(),
+                [proxy] { return proxy->Method0() + proxy->Method0(); }));
+}
+
 }  // namespace webrtc
@@ -33,6 +33,7 @@
 #include "talk/app/webrtc/peerconnection.h"
 #include "talk/session/media/channel.h"
 #include "webrtc/base/base64.h"
+#include "webrtc/base/bind.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/timing.h"
@@ -210,6 +211,7 @@ void ExtractStats(const cricket::VideoReceiverInfo& info, StatsReport* report) {
   const IntForAdd ints[] = {
     { StatsReport::kStatsValueNameCurrentDelayMs, info.current_delay_ms },
     { StatsReport::kStatsValueNameDecodeMs, info.decode_ms },
+    { StatsReport::kStatsValueNameDecodeMsP95, info.decode_ms_p95 },
     { StatsReport::kStatsValueNameFirsSent, info.firs_sent },
     { StatsReport::kStatsValueNameFrameHeightReceived, info.frame_height },
     { StatsReport::kStatsValueNameFrameRateDecoded, info.framerate_decoded },
@@ -217,6 +219,8 @@ void ExtractStats(const cricket::VideoReceiverInfo& info, StatsReport* report) {
     { StatsReport::kStatsValueNameFrameRateReceived, info.framerate_rcvd },
     { StatsReport::kStatsValueNameFrameWidthReceived, info.frame_width },
     { StatsReport::kStatsValueNameJitterBufferMs, info.jitter_buffer_ms },
+    { StatsReport::kStatsValueNameJitterBufferMsP95,
+      info.jitter_buffer_ms_p95 },
     { StatsReport::kStatsValueNameMaxDecodeMs, info.max_decode_ms },
     { StatsReport::kStatsValueNameMinPlayoutDelayMs,
       info.min_playout_delay_ms },
@@ -247,6 +251,7 @@ void ExtractStats(const cricket::VideoSenderInfo& info, StatsReport* report) {
   const IntForAdd ints[] = {
     { StatsReport::kStatsValueNameAdaptationChanges, info.adapt_changes },
     { StatsReport::kStatsValueNameAvgEncodeMs, info.avg_encode_ms },
+    { StatsReport::kStatsValueNameEncodeMsP95, info.encode_ms_p95 },
     { StatsReport::kStatsValueNameEncodeUsagePercent,
       info.encode_usage_percent },
     { StatsReport::kStatsValueNameFirsReceived, info.firs_rcvd },
@@ -264,6 +269,9 @@ void ExtractStats(const cricket::VideoSenderInfo& info, StatsReport* report) {
 
   for (const auto& i : ints)
     report->AddInt(i.name, i.value);
+
+  report->AddInt64(StatsReport::kStatsValueNamePacketHistoryBytes,
+                   static_cast<int64_t>(info.packet_history_bytes));
 }
 
 void ExtractStats(const cricket::BandwidthEstimationInfo& info,
@@ -476,15 +484,20 @@ StatsCollector::UpdateStats(PeerConnectionInterface::StatsOutputLevel level) {
   stats_gathering_started_ = time_now;
 
   if (pc_->session()) {
-    // TODO(tommi): All of these hop over to the worker thread to fetch
-    // information.  We could use an AsyncInvoker to run all of these and post
+    // TODO(tommi): The session info still hops over to the worker thread on
+    // its own.  We could use an AsyncInvoker to run all of these and post
     // the information back to the signaling thread where we can create and
     // update stats reports.  That would also clean up the threading story a bit
     // since we'd be creating/updating the stats report objects consistently on
     // the same thread (this class has no locks right now).
     ExtractSessionInfo();
-    ExtractVoiceInfo();
-    ExtractVideoInfo(level);
+    MediaInfo media_info;
+    pc_->session()->worker_thread()->Invoke<void>(
+        rtc::Bind(&StatsCollector::GetMediaInfo_w, this, &media_info));
+    if (media_info.has_voice)
+      ExtractVoiceInfo(media_info.voice);
+    if (media_info.has_video)
+      ExtractVideoInfo(media_info.video, level);
     ExtractDataInfo();
     UpdateTrackReports();
   }
@@ -686,6 +699,13 @@ void StatsCollector::ExtractSessionInfo() {
   report->set_timestamp(stats_gathering_started_);
   report->AddBoolean(StatsReport::kStatsValueNameInitiator,
                      pc_->session()->initial_offerer());
+  // The DTLS session cache is shared by the whole process.
+  rtc::SSLSessionCacheStats cache_stats =
+      rtc::SSLStreamAdapter::GetDtlsSessionCacheStats();
+  report->AddInt64(StatsReport::kStatsValueNameDtlsSessionCacheLookups,
+                   static_cast<int64_t>(cache_stats.lookups));
+  report->AddInt64(StatsReport::kStatsValueNameDtlsSessionCacheHits,
+                   static_cast<int64_t>(cache_stats.hits));
 
   SessionStats stats;
   if (!pc_->session()->GetTransportStats(&stats)) {
@@ -769,20 +789,29 @@ void StatsCollector::ExtractSessionInfo() {
   }
 }
 
-void StatsCollector::ExtractVoiceInfo() {
-  RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
+void StatsCollector::GetMediaInfo_w(MediaInfo* info) {
+  RTC_DCHECK(pc_->session()->worker_thread()->IsCurrent());
 
-  if (!pc_->session()->voice_channel()) {
-    return;
+  // The channels run their GetStats() directly since we're already on the
+  // worker thread.
+  cricket::VoiceChannel* voice_channel = pc_->session()->voice_channel();
+  if (voice_channel) {
+    info->has_voice = voice_channel->GetStats(&info->voice);
+    if (!info->has_voice)
+      LOG(LS_ERROR) << "Failed to get voice channel stats.";
   }
-  cricket::VoiceMediaInfo voice_info;
-  if (!pc_->session()->voice_channel()->GetStats(&voice_info)) {
-    LOG(LS_ERROR) << "Failed to get voice channel stats.";
-    return;
+
+  cricket::VideoChannel* video_channel = pc_->session()->video_channel();
+  if (video_channel) {
+    info->has_video = video_channel->GetStats(&info->video);
+    if (!info->has_video)
+      LOG(LS_ERROR) << "Failed to get video channel stats.";
   }
+}
 
-  // TODO(tommi): The above code should run on the worker thread and post the
-  // results back to the signaling thread, where we can add data to the reports.
+void StatsCollector::ExtractVoiceInfo(
+    const cricket::VoiceMediaInfo& voice_info) {
+  RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
   rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
 
   StatsReport::Id transport_id(GetTransportIdFromProxy(
@@ -802,20 +831,9 @@ void StatsCollector::ExtractVoiceInfo() {
 }
 
 void StatsCollector::ExtractVideoInfo(
+    const cricket::VideoMediaInfo& video_info,
     PeerConnectionInterface::StatsOutputLevel level) {
   RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
-
-  if (!pc_->session()->video_channel())
-    return;
-
-  cricket::VideoMediaInfo video_info;
-  if (!pc_->session()->video_channel()->GetStats(&video_info)) {
-    LOG(LS_ERROR) << "Failed to get video channel stats.";
-    return;
-  }
-
-  // TODO(tommi): The above code should run on the worker thread and post the
-  // results back to the signaling thread, where we can add data to the reports.
   rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
 
   StatsReport::Id transport_id(GetTransportIdFromProxy(
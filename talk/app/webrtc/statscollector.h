@@ -39,6 +39,7 @@
 #include "talk/app/webrtc/peerconnectioninterface.h"
 #include "talk/app/webrtc/statstypes.h"
 #include "talk/app/webrtc/webrtcsession.h"
+#include "talk/media/base/mediachannel.h"
 
 namespace webrtc {
 
@@ -126,10 +127,21 @@ class StatsCollector {
       const StatsReport::Id& channel_report_id,
       const cricket::ConnectionInfo& info);
 
+  // Stats of the media channels, fetched in a single hop to the worker thread.
+  struct MediaInfo {
+    MediaInfo() : has_voice(false), has_video(false) {}
+    bool has_voice;
+    cricket::VoiceMediaInfo voice;
+    bool has_video;
+    cricket::VideoMediaInfo video;
+  };
+  void GetMediaInfo_w(MediaInfo* info);
+
   void ExtractDataInfo();
   void ExtractSessionInfo();
-  void ExtractVoiceInfo();
-  void ExtractVideoInfo(PeerConnectionInterface::StatsOutputLevel level);
+  void ExtractVoiceInfo(const cricket::VoiceMediaInfo& voice_info);
+  void ExtractVideoInfo(const cricket::VideoMediaInfo& video_info,
+                        PeerConnectionInterface::StatsOutputLevel level);
   void BuildSsrcToTransportId();
   webrtc::StatsReport* GetReport(const StatsReport::StatsType& type,
                                  const std::string& id,
@@ -46,6 +46,7 @@
 #include "webrtc/base/fakesslidentity.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/network.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/p2p/base/faketransportcontroller.h"
 
 using rtc::scoped_ptr;
@@ -85,6 +86,7 @@ class MockWebRtcSession : public webrtc::WebRtcSession {
  public:
   explicit MockWebRtcSession(webrtc::MediaControllerInterface* media_controller)
       : WebRtcSession(media_controller,
+                      rtc::Thread::Current(),
                       rtc::Thread::Current(),
                       rtc::Thread::Current(),
                       nullptr) {}
@@ -504,7 +506,9 @@ class StatsCollectorTest : public testing::Test {
   StatsCollectorTest()
       : media_engine_(new cricket::FakeMediaEngine()),
         channel_manager_(
-            new cricket::ChannelManager(media_engine_, rtc::Thread::Current())),
+            new cricket::ChannelManager(media_engine_,
+                                        rtc::Thread::Current(),
+                                        rtc::Thread::Current())),
         media_controller_(
             webrtc::MediaControllerInterface::Create(rtc::Thread::Current(),
                                                      channel_manager_.get())),
@@ -772,6 +776,82 @@ class StatsCollectorTest : public testing::Test {
 };
 
 // Verify that ExtractDataInfo populates reports.
+// Refreshing a value overwrites it in place, unless its type changes.
+TEST_F(StatsCollectorTest, ReportValuesAreUpdatedInPlace) {
+  StatsReport report(StatsReport::NewBandwidthEstimationId());
+  report.AddInt(StatsReport::kStatsValueNamePacketsSent, 1);
+  report.AddString(StatsReport::kStatsValueNameCodecName, "opus");
+  const StatsReport::Value* packets =
+      report.FindValue(StatsReport::kStatsValueNamePacketsSent);
+  const StatsReport::Value* codec =
+      report.FindValue(StatsReport::kStatsValueNameCodecName);
+
+  report.AddInt(StatsReport::kStatsValueNamePacketsSent, 2);
+  report.AddString(StatsReport::kStatsValueNameCodecName, std::string("G722"));
+  EXPECT_EQ(packets,
+            report.FindValue(StatsReport::kStatsValueNamePacketsSent));
+  EXPECT_EQ(2, packets->int_val());
+
+  const StatsReport::Value* new_codec =
+      report.FindValue(StatsReport::kStatsValueNameCodecName);
+  EXPECT_NE(codec, new_codec);
+  EXPECT_EQ("G722", new_codec->string_val());
+  report.AddString(StatsReport::kStatsValueNameCodecName, std::string("PCMU"));
+  EXPECT_EQ(new_codec, report.FindValue(StatsReport::kStatsValueNameCodecName));
+  EXPECT_EQ("PCMU", new_codec->string_val());
+}
+
+TEST_F(StatsCollectorTest, ExportStatsResolvesReportIds) {
+  StatsReport transport(StatsReport::NewComponentId("audio", 1));
+  transport.set_timestamp(1000);
+  transport.AddBoolean(StatsReport::kStatsValueNameWritable, true);
+  StatsReport ssrc(StatsReport::NewIdWithDirection(
+      StatsReport::kStatsReportTypeSsrc, "1234", StatsReport::kSend));
+  ssrc.set_timestamp(2000);
+  ssrc.AddId(StatsReport::kStatsValueNameTransportId, transport.id());
+  // An equal id which doesn't share the report's id object.
+  ssrc.AddId(StatsReport::kStatsValueNameChannelId,
+             StatsReport::NewComponentId("audio", 1));
+  ssrc.AddInt64(StatsReport::kStatsValueNameBytesSent, 1LL << 40);
+  ssrc.AddString(StatsReport::kStatsValueNameCodecName, std::string("opus"));
+
+  StatsReports reports;
+  reports.push_back(&transport);
+  reports.push_back(&ssrc);
+  std::vector<ExportedStatsReport> exported_reports;
+  std::vector<ExportedStatsValue> exported_values;
+  ExportStats(reports, &exported_reports, &exported_values);
+
+  ASSERT_EQ(2u, exported_reports.size());
+  EXPECT_EQ(StatsReport::kStatsReportTypeComponent, exported_reports[0].type);
+  EXPECT_EQ(1000, exported_reports[0].timestamp);
+  EXPECT_EQ(0u, exported_reports[0].first_value);
+  EXPECT_EQ(1u, exported_reports[0].num_values);
+  EXPECT_EQ(StatsReport::kStatsReportTypeSsrc, exported_reports[1].type);
+  EXPECT_EQ(1u, exported_reports[1].first_value);
+  ASSERT_EQ(4u, exported_reports[1].num_values);
+  ASSERT_EQ(5u, exported_values.size());
+
+  EXPECT_TRUE(exported_values[0].bool_val);
+  for (size_t i = 1; i < exported_values.size(); ++i) {
+    const ExportedStatsValue& value = exported_values[i];
+    switch (value.name) {
+      case StatsReport::kStatsValueNameTransportId:
+      case StatsReport::kStatsValueNameChannelId:
+        EXPECT_EQ(0, value.report_index);
+        break;
+      case StatsReport::kStatsValueNameBytesSent:
+        EXPECT_EQ(1LL << 40, value.int_val);
+        break;
+      case StatsReport::kStatsValueNameCodecName:
+        EXPECT_STREQ("opus", value.string_val);
+        break;
+      default:
+        ADD_FAILURE() << "Unexpected value " << value.name;
+    }
+  }
+}
+
 TEST_F(StatsCollectorTest, ExtractDataInfo) {
   const std::string label = "hacks";
   const int id = 31337;
@@ -826,7 +906,8 @@ TEST_F(StatsCollectorTest, BytesCounterHandles64Bits) {
                             Return(true)));
 
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVideoChannelName, false);
   StatsReports reports;  // returned values.
   cricket::VideoSenderInfo video_sender_info;
@@ -872,7 +953,8 @@ TEST_F(StatsCollectorTest, BandwidthEstimationInfoIsReported) {
                             Return(true)));
 
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVideoChannelName, false);
 
   StatsReports reports;  // returned values.
@@ -924,6 +1006,30 @@ TEST_F(StatsCollectorTest, SessionObjectExists) {
   EXPECT_FALSE(session_report == NULL);
 }
 
+// This test verifies that the session object reports the counters of the
+// DTLS session cache.
+TEST_F(StatsCollectorTest, SessionObjectHasDtlsSessionCacheStats) {
+  StatsCollectorForTest stats(&pc_);
+
+  StatsReports reports;  // returned values.
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStats(NULL, &reports);
+  const StatsReport* session_report = FindNthReportByType(
+      reports, StatsReport::kStatsReportTypeSession, 1);
+  ASSERT_FALSE(session_report == NULL);
+  rtc::SSLSessionCacheStats cache_stats =
+      rtc::SSLStreamAdapter::GetDtlsSessionCacheStats();
+  std::string value;
+  EXPECT_TRUE(GetValue(session_report,
+                       StatsReport::kStatsValueNameDtlsSessionCacheLookups,
+                       &value));
+  EXPECT_EQ(rtc::ToString(cache_stats.lookups), value);
+  EXPECT_TRUE(GetValue(session_report,
+                       StatsReport::kStatsValueNameDtlsSessionCacheHits,
+                       &value));
+  EXPECT_EQ(rtc::ToString(cache_stats.hits), value);
+}
+
 // This test verifies that only one object of type "googSession" exists
 // in the returned stats.
 TEST_F(StatsCollectorTest, OnlyOneSessionObjectExists) {
@@ -947,7 +1053,8 @@ TEST_F(StatsCollectorTest, TrackObjectExistsWithoutUpdateStats) {
   StatsCollectorForTest stats(&pc_);
 
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, "video", false);
   AddOutgoingVideoTrackStats();
   stats.AddStream(stream_);
@@ -983,7 +1090,8 @@ TEST_F(StatsCollectorTest, TrackAndSsrcObjectExistAfterUpdateSsrcStats) {
                             Return(true)));
 
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVideoChannelName, false);
   AddOutgoingVideoTrackStats();
   stats.AddStream(stream_);
@@ -1047,7 +1155,8 @@ TEST_F(StatsCollectorTest, TransportObjectLinkedFromSsrcObject) {
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
   // The transport_name known by the video channel.
   const std::string kVcName("vcname");
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVcName, false);
   AddOutgoingVideoTrackStats();
   stats.AddStream(stream_);
@@ -1105,7 +1214,8 @@ TEST_F(StatsCollectorTest, RemoteSsrcInfoIsAbsent) {
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
   // The transport_name known by the video channel.
   const std::string kVcName("vcname");
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVcName, false);
   AddOutgoingVideoTrackStats();
   stats.AddStream(stream_);
@@ -1131,7 +1241,8 @@ TEST_F(StatsCollectorTest, RemoteSsrcInfoIsPresent) {
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
   // The transport_name known by the video channel.
   const std::string kVcName("vcname");
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVcName, false);
   AddOutgoingVideoTrackStats();
   stats.AddStream(stream_);
@@ -1186,7 +1297,8 @@ TEST_F(StatsCollectorTest, ReportsFromRemoteTrack) {
                             Return(true)));
 
   MockVideoMediaChannel* media_channel = new MockVideoMediaChannel();
-  cricket::VideoChannel video_channel(rtc::Thread::Current(), media_channel,
+  cricket::VideoChannel video_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_channel,
                                       nullptr, kVideoChannelName, false);
   AddIncomingVideoTrackStats();
   stats.AddStream(stream_);
@@ -1493,7 +1605,8 @@ TEST_F(StatsCollectorTest, GetStatsFromLocalAudioTrack) {
   MockVoiceMediaChannel* media_channel = new MockVoiceMediaChannel();
   // The transport_name known by the voice channel.
   const std::string kVcName("vcname");
-  cricket::VoiceChannel voice_channel(rtc::Thread::Current(), media_engine_,
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_engine_,
                                       media_channel, nullptr, kVcName, false);
   AddOutgoingAudioTrackStats();
   stats.AddStream(stream_);
@@ -1528,7 +1641,8 @@ TEST_F(StatsCollectorTest, GetStatsFromRemoteStream) {
   MockVoiceMediaChannel* media_channel = new MockVoiceMediaChannel();
   // The transport_name known by the voice channel.
   const std::string kVcName("vcname");
-  cricket::VoiceChannel voice_channel(rtc::Thread::Current(), media_engine_,
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_engine_,
                                       media_channel, nullptr, kVcName, false);
   AddIncomingAudioTrackStats();
   stats.AddStream(stream_);
@@ -1557,7 +1671,8 @@ TEST_F(StatsCollectorTest, GetStatsAfterRemoveAudioStream) {
   MockVoiceMediaChannel* media_channel = new MockVoiceMediaChannel();
   // The transport_name known by the voice channel.
   const std::string kVcName("vcname");
-  cricket::VoiceChannel voice_channel(rtc::Thread::Current(), media_engine_,
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_engine_,
                                       media_channel, nullptr, kVcName, false);
   AddOutgoingAudioTrackStats();
   stats.AddStream(stream_);
@@ -1618,7 +1733,8 @@ TEST_F(StatsCollectorTest, LocalAndRemoteTracksWithSameSsrc) {
   MockVoiceMediaChannel* media_channel = new MockVoiceMediaChannel();
   // The transport_name known by the voice channel.
   const std::string kVcName("vcname");
-  cricket::VoiceChannel voice_channel(rtc::Thread::Current(), media_engine_,
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_engine_,
                                       media_channel, nullptr, kVcName, false);
 
   // Create a local stream with a local audio track and adds it to the stats.
@@ -1705,7 +1821,8 @@ TEST_F(StatsCollectorTest, TwoLocalTracksWithSameSsrc) {
   MockVoiceMediaChannel* media_channel = new MockVoiceMediaChannel();
   // The transport_name known by the voice channel.
   const std::string kVcName("vcname");
-  cricket::VoiceChannel voice_channel(rtc::Thread::Current(), media_engine_,
+  cricket::VoiceChannel voice_channel(rtc::Thread::Current(),
+                                      rtc::Thread::Current(), media_engine_,
                                       media_channel, nullptr, kVcName, false);
 
   // Create a local stream with a local audio track and adds it to the stats.
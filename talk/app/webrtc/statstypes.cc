@@ -29,6 +29,8 @@
 
 #include <string.h>
 
+#include <map>
+
 #include "webrtc/base/checks.h"
 
 // TODO(tommi): Could we have a static map of value name -> expected type
@@ -348,6 +350,52 @@ bool StatsReport::Value::operator==(const Id& value) const {
   return type_ == kId && (*value_.id_)->Equals(value);
 }
 
+bool StatsReport::Value::Set(const std::string& value) {
+  if (type_ != kString)
+    return false;
+  *value_.string_ = value;
+  return true;
+}
+
+bool StatsReport::Value::Set(const char* value) {
+  if (type_ != kStaticString)
+    return false;
+  value_.static_string_ = value;
+  return true;
+}
+
+bool StatsReport::Value::Set(int64_t value) {
+  if (type_ == kInt) {
+    value_.int_ = static_cast<int>(value);
+    return true;
+  }
+  if (type_ != kInt64)
+    return false;
+  value_.int64_ = value;
+  return true;
+}
+
+bool StatsReport::Value::Set(float value) {
+  if (type_ != kFloat)
+    return false;
+  value_.float_ = value;
+  return true;
+}
+
+bool StatsReport::Value::Set(bool value) {
+  if (type_ != kBool)
+    return false;
+  value_.bool_ = value;
+  return true;
+}
+
+bool StatsReport::Value::Set(const Id& value) {
+  if (type_ != kId)
+    return false;
+  *value_.id_ = value;
+  return true;
+}
+
 int StatsReport::Value::int_val() const {
   RTC_DCHECK(type_ == kInt);
   return value_.int_;
@@ -378,6 +426,11 @@ bool StatsReport::Value::bool_val() const {
   return value_.bool_;
 }
 
+const StatsReport::Id& StatsReport::Value::id_val() const {
+  RTC_DCHECK(type_ == kId);
+  return *value_.id_;
+}
+
 const char* StatsReport::Value::display_name() const {
   switch (name) {
     case kStatsValueNameAudioOutputLevel:
@@ -470,6 +523,10 @@ const char* StatsReport::Value::display_name() const {
       return "googDerBase64";
     case kStatsValueNameDtlsCipher:
       return "dtlsCipher";
+    case kStatsValueNameDtlsSessionCacheHits:
+      return "googDtlsSessionCacheHits";
+    case kStatsValueNameDtlsSessionCacheLookups:
+      return "googDtlsSessionCacheLookups";
     case kStatsValueNameEchoCancellationQualityMin:
       return "googEchoCancellationQualityMin";
     case kStatsValueNameEchoDelayMedian:
@@ -480,6 +537,8 @@ const char* StatsReport::Value::display_name() const {
       return "googEchoCancellationReturnLoss";
     case kStatsValueNameEchoReturnLossEnhancement:
       return "googEchoCancellationReturnLossEnhancement";
+    case kStatsValueNameEncodeMsP95:
+      return "googEncodeMsP95";
     case kStatsValueNameEncodeUsagePercent:
       return "googEncodeUsagePercent";
     case kStatsValueNameExpandRate:
@@ -506,6 +565,8 @@ const char* StatsReport::Value::display_name() const {
       return "googFrameRateOutput";
     case kStatsValueNameDecodeMs:
       return "googDecodeMs";
+    case kStatsValueNameDecodeMsP95:
+      return "googDecodeMsP95";
     case kStatsValueNameMaxDecodeMs:
       return "googMaxDecodeMs";
     case kStatsValueNameCurrentDelayMs:
@@ -514,6 +575,8 @@ const char* StatsReport::Value::display_name() const {
       return "googTargetDelayMs";
     case kStatsValueNameJitterBufferMs:
       return "googJitterBufferMs";
+    case kStatsValueNameJitterBufferMsP95:
+      return "googJitterBufferMsP95";
     case kStatsValueNameMinPlayoutDelayMs:
       return "googMinPlayoutDelayMs";
     case kStatsValueNameRenderDelayMs:
@@ -550,6 +613,8 @@ const char* StatsReport::Value::display_name() const {
       return "googNacksReceived";
     case kStatsValueNameNacksSent:
       return "googNacksSent";
+    case kStatsValueNamePacketHistoryBytes:
+      return "googPacketHistoryBytes";
     case kStatsValueNamePreemptiveExpandRate:
       return "googPreemptiveExpandRate";
     case kStatsValueNamePlisReceived:
@@ -669,46 +734,46 @@ const char* StatsReport::TypeToString() const {
 
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const std::string& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddString(StatsReport::StatsValueName name,
                             const char* value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddInt64(StatsReport::StatsValueName name, int64_t value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value, Value::kInt64));
 }
 
 void StatsReport::AddInt(StatsReport::StatsValueName name, int value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == static_cast<int64_t>(value)))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(static_cast<int64_t>(value)))
     values_[name] = ValuePtr(new Value(name, value, Value::kInt));
 }
 
 void StatsReport::AddFloat(StatsReport::StatsValueName name, float value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddBoolean(StatsReport::StatsValueName name, bool value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
 void StatsReport::AddId(StatsReport::StatsValueName name,
                         const Id& value) {
-  const Value* found = FindValue(name);
-  if (!found || !(*found == value))
+  Values::iterator it = values_.find(name);
+  if (it == values_.end() || !it->second->Set(value))
     values_[name] = ValuePtr(new Value(name, value));
 }
 
@@ -778,4 +843,67 @@ StatsReport* StatsCollection::Find(const StatsReport::Id& id) {
   return it == list_.end() ? nullptr : *it;
 }
 
+void ExportStats(const StatsReports& reports,
+                 std::vector<ExportedStatsReport>* exported_reports,
+                 std::vector<ExportedStatsValue>* exported_values) {
+  exported_reports->clear();
+  exported_values->clear();
+
+  // Id values usually share the referenced report's id object, so look ids up
+  // by pointer first and only compare them when that fails.
+  std::map<const StatsReport::IdBase*, int> report_indices;
+  for (size_t i = 0; i < reports.size(); ++i)
+    report_indices[reports[i]->id().get()] = static_cast<int>(i);
+  auto find_report_index = [&](const StatsReport::Id& id) -> int {
+    auto it = report_indices.find(id.get());
+    if (it != report_indices.end())
+      return it->second;
+    for (size_t i = 0; i < reports.size(); ++i) {
+      if (reports[i]->id()->Equals(id))
+        return static_cast<int>(i);
+    }
+    return -1;
+  };
+
+  for (const StatsReport* report : reports) {
+    ExportedStatsReport exported_report;
+    exported_report.type = report->type();
+    exported_report.timestamp = report->timestamp();
+    exported_report.first_value = exported_values->size();
+    exported_report.num_values = report->values().size();
+    exported_reports->push_back(exported_report);
+
+    for (const auto& it : report->values()) {
+      const StatsReport::Value& value = *it.second;
+      ExportedStatsValue exported;
+      exported.name = value.name;
+      exported.type = value.type();
+      switch (value.type()) {
+        case StatsReport::Value::kInt:
+          exported.int_val = value.int_val();
+          break;
+        case StatsReport::Value::kInt64:
+          exported.int_val = value.int64_val();
+          break;
+        case StatsReport::Value::kFloat:
+          exported.float_val = value.float_val();
+          break;
+        case StatsReport::Value::kString:
+          exported.string_val = value.string_val().c_str();
+          break;
+        case StatsReport::Value::kStaticString:
+          exported.string_val = value.static_string_val();
+          break;
+        case StatsReport::Value::kBool:
+          exported.bool_val = value.bool_val();
+          break;
+        case StatsReport::Value::kId:
+          exported.report_index = find_report_index(value.id_val());
+          break;
+      }
+      exported_values->push_back(exported);
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -155,6 +155,7 @@ class StatsReport {
     kStatsValueNameCpuLimitedResolution,
     kStatsValueNameCurrentDelayMs,
     kStatsValueNameDecodeMs,
+    kStatsValueNameDecodeMsP95,
     kStatsValueNameDecodingCNG,
     kStatsValueNameDecodingCTN,
     kStatsValueNameDecodingCTSG,
@@ -163,11 +164,14 @@ class StatsReport {
     kStatsValueNameDecodingPLCCNG,
     kStatsValueNameDer,
     kStatsValueNameDtlsCipher,
+    kStatsValueNameDtlsSessionCacheHits,
+    kStatsValueNameDtlsSessionCacheLookups,
     kStatsValueNameEchoCancellationQualityMin,
     kStatsValueNameEchoDelayMedian,
     kStatsValueNameEchoDelayStdDev,
     kStatsValueNameEchoReturnLoss,
     kStatsValueNameEchoReturnLossEnhancement,
+    kStatsValueNameEncodeMsP95,
     kStatsValueNameEncodeUsagePercent,
     kStatsValueNameExpandRate,
     kStatsValueNameFingerprint,
@@ -188,6 +192,7 @@ class StatsReport {
     kStatsValueNameInitiator,
     kStatsValueNameIssuerId,
     kStatsValueNameJitterBufferMs,
+    kStatsValueNameJitterBufferMsP95,
     kStatsValueNameJitterReceived,
     kStatsValueNameLabel,
     kStatsValueNameLocalAddress,
@@ -198,6 +203,7 @@ class StatsReport {
     kStatsValueNameMinPlayoutDelayMs,
     kStatsValueNameNacksReceived,
     kStatsValueNameNacksSent,
+    kStatsValueNamePacketHistoryBytes,
     kStatsValueNamePlisReceived,
     kStatsValueNamePlisSent,
     kStatsValueNamePreemptiveExpandRate,
@@ -287,6 +293,16 @@ class StatsReport {
     bool operator==(float value) const;
     bool operator==(const Id& value) const;
 
+    // Overwrite the value in place, so that a report which is refreshed
+    // periodically does not reallocate its values. Return false and leave the
+    // value untouched if the current instance holds a different type.
+    bool Set(const std::string& value);
+    bool Set(const char* value);
+    bool Set(int64_t value);
+    bool Set(float value);
+    bool Set(bool value);
+    bool Set(const Id& value);
+
     // Getters that allow getting the native value directly.
     // The caller must know the type beforehand or else hit a check.
     int int_val() const;
@@ -382,6 +398,38 @@ class StatsReport {
 // StatsCollection class.
 typedef std::vector<const StatsReport*> StatsReports;
 
+// Flat, typed form of a set of reports for consumers that ingest stats in
+// bulk. Names and report types are exported as their enum values, report ids
+// as indices into the exported set, and no value is formatted into a string.
+// String values point into the reports and are only valid as long as the
+// reports are.
+struct ExportedStatsValue {
+  StatsReport::StatsValueName name;
+  StatsReport::Value::Type type;
+  union {
+    int64_t int_val;  // kInt and kInt64.
+    float float_val;
+    bool bool_val;
+    const char* string_val;  // kString and kStaticString.
+    int report_index;  // kId. -1 if the report is not part of the export.
+  };
+};
+
+struct ExportedStatsReport {
+  StatsReport::StatsType type;
+  double timestamp;
+  // Range of this report's values in the exported value list.
+  size_t first_value;
+  size_t num_values;
+};
+
+// Exports |reports| into |exported_reports| and |exported_values|, in the same
+// order. Both vectors are cleared first, which keeps their capacity, so that
+// repeated exports don't reallocate.
+void ExportStats(const StatsReports& reports,
+                 std::vector<ExportedStatsReport>* exported_reports,
+                 std::vector<ExportedStatsValue>* exported_values);
+
 // A map from the report id to the report.
 // This class wraps an STL container and provides a limited set of
 // functionality in order to keep things simple.
@@ -130,7 +130,8 @@ class VideoSourceTest : public testing::Test {
       : capturer_cleanup_(new TestVideoCapturer()),
         capturer_(capturer_cleanup_.get()),
         channel_manager_(new cricket::ChannelManager(
-          new cricket::FakeMediaEngine(), rtc::Thread::Current())) {
+          new cricket::FakeMediaEngine(), rtc::Thread::Current(),
+          rtc::Thread::Current())) {
   }
 
   void SetUp() {
@@ -57,7 +57,8 @@ class VideoTrackTest : public testing::Test {
     static const char kVideoTrackId[] = "track_id";
 
     channel_manager_.reset(new cricket::ChannelManager(
-        new cricket::FakeMediaEngine(), rtc::Thread::Current()));
+        new cricket::FakeMediaEngine(), rtc::Thread::Current(),
+        rtc::Thread::Current()));
     EXPECT_TRUE(channel_manager_->Init());
     video_track_ = VideoTrack::Create(
         kVideoTrackId,
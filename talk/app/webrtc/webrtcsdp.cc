@@ -29,6 +29,7 @@
 
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -452,7 +453,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuse the capacity of |line|, which the parsers keep across lines.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -521,9 +523,10 @@ static bool GetLineWithType(const std::string& message, size_t* pos,
   return true;
 }
 
-static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
+// Takes the attribute as a C string, since the attribute names are string
+// literals and most lines are tested against several of them.
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  return (line.compare(kLinePrefixLength, strlen(attribute), attribute) == 0);
 }
 
 static bool AddSsrcLine(uint32_t ssrc_id,
@@ -540,18 +543,26 @@ static bool AddSsrcLine(uint32_t ssrc_id,
 }
 
 // Get value only from <attribute>:<value>.
-static bool GetValue(const std::string& message, const std::string& attribute,
+static bool GetValue(const std::string& message, const char* attribute,
                      std::string* value, SdpParseError* error) {
-  std::string leftpart;
-  if (!rtc::tokenize_first(message, kSdpDelimiterColon, &leftpart, value)) {
+  size_t colon = message.find(kSdpDelimiterColon);
+  if (colon == std::string::npos) {
     return ParseFailedGetValue(message, attribute, error);
   }
   // The left part should end with the expected attribute.
-  if (leftpart.length() < attribute.length() ||
-      leftpart.compare(leftpart.length() - attribute.length(),
-                       attribute.length(), attribute) != 0) {
+  size_t attribute_length = strlen(attribute);
+  if (colon < attribute_length ||
+      message.compare(colon - attribute_length, attribute_length,
+                      attribute) != 0) {
     return ParseFailedGetValue(message, attribute, error);
   }
+  // Like rtc::tokenize_first(), skip repeated delimiters.
+  size_t value_begin = message.find_first_not_of(kSdpDelimiterColon, colon);
+  if (value_begin == std::string::npos) {
+    value->clear();
+  } else {
+    value->assign(message, value_begin, std::string::npos);
+  }
   return true;
 }
 
@@ -798,7 +809,12 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
     return "";
   }
 
+  // A typical media section with its codecs, candidates and ssrc lines takes
+  // one to two KB. Reserving up front avoids growing |message| repeatedly for
+  // descriptions with many m-lines.
+  const size_t kReservedBytesPerContent = 2048;
   std::string message;
+  message.reserve((desc->contents().size() + 1) * kReservedBytesPerContent);
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -47,6 +47,7 @@
 #include "talk/session/media/mediasession.h"
 #include "webrtc/audio/audio_sink.h"
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/bind.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
@@ -542,16 +543,18 @@ class IceRestartAnswerLatch {
 WebRtcSession::WebRtcSession(webrtc::MediaControllerInterface* media_controller,
                              rtc::Thread* signaling_thread,
                              rtc::Thread* worker_thread,
+                             rtc::Thread* network_thread,
                              cricket::PortAllocator* port_allocator)
     : signaling_thread_(signaling_thread),
       worker_thread_(worker_thread),
+      network_thread_(network_thread),
       port_allocator_(port_allocator),
       // RFC 3264: The numeric value of the session id and version in the
       // o line MUST be representable with a "64 bit signed integer".
       // Due to this constraint session id |sid_| is max limited to LLONG_MAX.
       sid_(rtc::ToString(rtc::CreateRandomId64() & LLONG_MAX)),
       transport_controller_(new cricket::TransportController(signaling_thread,
-                                                             worker_thread,
+                                                             network_thread,
                                                              port_allocator)),
       media_controller_(media_controller),
       channel_manager_(media_controller_->channel_manager()),
@@ -604,6 +607,7 @@ bool WebRtcSession::Initialize(
   video_options_.disable_prerenderer_smoothing =
       rtc::Optional<bool>(rtc_configuration.disable_prerenderer_smoothing);
   transport_controller_->SetSslMaxProtocolVersion(options.ssl_max_version);
+  crypto_options_ = options.crypto_options;
 
   // Obtain a certificate from RTCConfiguration if any were provided (optional).
   rtc::scoped_refptr<rtc::RTCCertificate> certificate;
@@ -1022,6 +1026,19 @@ bool WebRtcSession::PushdownMediaDescription(
     cricket::ContentAction action,
     cricket::ContentSource source,
     std::string* err) {
+  // Update all channels in one call to the worker thread, where each
+  // channel's own Invoke runs directly, so that the signaling thread blocks
+  // once per description rather than once per channel.
+  return worker_thread()->Invoke<bool>(
+      rtc::Bind(&WebRtcSession::PushdownMediaDescription_w, this, action,
+                source, err));
+}
+
+bool WebRtcSession::PushdownMediaDescription_w(
+    cricket::ContentAction action,
+    cricket::ContentSource source,
+    std::string* err) {
+  RTC_DCHECK(worker_thread()->IsCurrent());
   auto set_content = [this, action, source, err](cricket::BaseChannel* ch) {
     if (!ch) {
       return true;
@@ -1651,6 +1668,12 @@ void WebRtcSession::OnTransportControllerCandidatesGathered(
 
 // Enabling voice and video channel.
 void WebRtcSession::EnableChannels() {
+  worker_thread()->Invoke<void>(
+      rtc::Bind(&WebRtcSession::EnableChannels_w, this));
+}
+
+void WebRtcSession::EnableChannels_w() {
+  RTC_DCHECK(worker_thread()->IsCurrent());
   if (voice_channel_ && !voice_channel_->enabled())
     voice_channel_->Enable(true);
 
@@ -1843,10 +1866,11 @@ bool WebRtcSession::CreateVoiceChannel(const cricket::ContentInfo* content) {
 
   voice_channel_->SignalDtlsSetupFailure.connect(
       this, &WebRtcSession::OnDtlsSetupFailure);
+  voice_channel_->SetCryptoOptions(crypto_options_);
 
   SignalVoiceChannelCreated();
   voice_channel_->transport_channel()->SignalSentPacket.connect(
-      this, &WebRtcSession::OnSentPacket_w);
+      this, &WebRtcSession::OnSentPacket_n);
   return true;
 }
 
@@ -1860,10 +1884,11 @@ bool WebRtcSession::CreateVideoChannel(const cricket::ContentInfo* content) {
 
   video_channel_->SignalDtlsSetupFailure.connect(
       this, &WebRtcSession::OnDtlsSetupFailure);
+  video_channel_->SetCryptoOptions(crypto_options_);
 
   SignalVideoChannelCreated();
   video_channel_->transport_channel()->SignalSentPacket.connect(
-      this, &WebRtcSession::OnSentPacket_w);
+      this, &WebRtcSession::OnSentPacket_n);
   return true;
 }
 
@@ -1882,10 +1907,11 @@ bool WebRtcSession::CreateDataChannel(const cricket::ContentInfo* content) {
 
   data_channel_->SignalDtlsSetupFailure.connect(
       this, &WebRtcSession::OnDtlsSetupFailure);
+  data_channel_->SetCryptoOptions(crypto_options_);
 
   SignalDataChannelCreated();
   data_channel_->transport_channel()->SignalSentPacket.connect(
-      this, &WebRtcSession::OnSentPacket_w);
+      this, &WebRtcSession::OnSentPacket_n);
   return true;
 }
 
@@ -2204,9 +2230,9 @@ void WebRtcSession::ReportNegotiatedCiphers(
   }
 }
 
-void WebRtcSession::OnSentPacket_w(cricket::TransportChannel* channel,
+void WebRtcSession::OnSentPacket_n(cricket::TransportChannel* channel,
                                    const rtc::SentPacket& sent_packet) {
-  RTC_DCHECK(worker_thread()->IsCurrent());
+  RTC_DCHECK(network_thread()->IsCurrent());
   media_controller_->call_w()->OnSentPacket(sent_packet);
 }
 
@@ -154,12 +154,14 @@ class WebRtcSession : public AudioProviderInterface,
   WebRtcSession(webrtc::MediaControllerInterface* media_controller,
                 rtc::Thread* signaling_thread,
                 rtc::Thread* worker_thread,
+                rtc::Thread* network_thread,
                 cricket::PortAllocator* port_allocator);
   virtual ~WebRtcSession();
 
   // These are const to allow them to be called from const methods.
   rtc::Thread* signaling_thread() const { return signaling_thread_; }
   rtc::Thread* worker_thread() const { return worker_thread_; }
+  rtc::Thread* network_thread() const { return network_thread_; }
   cricket::PortAllocator* port_allocator() const { return port_allocator_; }
 
   // The ID of this session.
@@ -360,6 +362,9 @@ class WebRtcSession : public AudioProviderInterface,
   bool PushdownMediaDescription(cricket::ContentAction action,
                                 cricket::ContentSource source,
                                 std::string* error_desc);
+  bool PushdownMediaDescription_w(cricket::ContentAction action,
+                                  cricket::ContentSource source,
+                                  std::string* error_desc);
 
   bool PushdownTransportDescription(cricket::ContentSource source,
                                     cricket::ContentAction action,
@@ -389,6 +394,7 @@ class WebRtcSession : public AudioProviderInterface,
 
   // Enables media channels to allow sending of media.
   void EnableChannels();
+  void EnableChannels_w();
   // Returns the media index for a local ice candidate given the content name.
   // Returns false if the local session description does not have a media
   // content called  |content_name|.
@@ -464,11 +470,12 @@ class WebRtcSession : public AudioProviderInterface,
 
   void ReportNegotiatedCiphers(const cricket::TransportStats& stats);
 
-  void OnSentPacket_w(cricket::TransportChannel* channel,
+  void OnSentPacket_n(cricket::TransportChannel* channel,
                       const rtc::SentPacket& sent_packet);
 
   rtc::Thread* const signaling_thread_;
   rtc::Thread* const worker_thread_;
+  rtc::Thread* const network_thread_;
   cricket::PortAllocator* const port_allocator_;
 
   State state_ = STATE_INIT;
@@ -516,6 +523,9 @@ class WebRtcSession : public AudioProviderInterface,
   // Declares the RTCP mux policy for the WebRTCSession.
   PeerConnectionInterface::RtcpMuxPolicy rtcp_mux_policy_;
 
+  // The SRTP crypto suites to use for the channels of the session.
+  rtc::CryptoOptions crypto_options_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(WebRtcSession);
 };
 }  // namespace webrtc
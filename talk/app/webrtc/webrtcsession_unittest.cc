@@ -239,11 +239,13 @@ class WebRtcSessionForTest : public webrtc::WebRtcSession {
   WebRtcSessionForTest(webrtc::MediaControllerInterface* media_controller,
                        rtc::Thread* signaling_thread,
                        rtc::Thread* worker_thread,
+                       rtc::Thread* network_thread,
                        cricket::PortAllocator* port_allocator,
                        webrtc::IceObserver* ice_observer)
       : WebRtcSession(media_controller,
                       signaling_thread,
                       worker_thread,
+                      network_thread,
                       port_allocator) {
     RegisterIceObserver(ice_observer);
   }
@@ -360,6 +362,7 @@ class WebRtcSessionTest
             new cricket::ChannelManager(media_engine_,
                                         data_engine_,
                                         new cricket::CaptureManager(),
+                                        rtc::Thread::Current(),
                                         rtc::Thread::Current())),
         fake_call_(webrtc::Call::Config()),
         media_controller_(
@@ -407,7 +410,7 @@ class WebRtcSessionTest
     ASSERT_TRUE(session_.get() == NULL);
     session_.reset(new WebRtcSessionForTest(
         media_controller_.get(), rtc::Thread::Current(), rtc::Thread::Current(),
-        allocator_.get(), &observer_));
+        rtc::Thread::Current(), allocator_.get(), &observer_));
     session_->SignalDataChannelOpenMessage.connect(
         this, &WebRtcSessionTest::OnDataChannelOpenMessage);
 
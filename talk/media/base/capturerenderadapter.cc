@@ -48,6 +48,7 @@ CaptureRenderAdapter::~CaptureRenderAdapter() {
   // OnVideoFrame is running.
   // We *don't* take capture_crit_ here since it could deadlock with the lock
   // taken by the video frame signal.
+  video_capturer_->RemoveFrameFilter(this);
   disconnect_all();
 }
 
@@ -92,6 +93,12 @@ void CaptureRenderAdapter::Init() {
   video_capturer_->SignalVideoFrame.connect(
       this,
       &CaptureRenderAdapter::OnVideoFrame);
+  video_capturer_->AddFrameFilter(this);
+}
+
+bool CaptureRenderAdapter::WillDropFrame() {
+  rtc::CritScope cs(&capture_crit_);
+  return video_renderers_.empty();
 }
 
 void CaptureRenderAdapter::OnVideoFrame(VideoCapturer* capturer,
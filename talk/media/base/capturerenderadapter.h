@@ -46,7 +46,8 @@ class VideoCapturer;
 class VideoProcessor;
 class VideoRenderer;
 
-class CaptureRenderAdapter : public sigslot::has_slots<> {
+class CaptureRenderAdapter : public sigslot::has_slots<>,
+                             public CapturedFrameFilter {
  public:
   static CaptureRenderAdapter* Create(VideoCapturer* video_capturer);
   ~CaptureRenderAdapter();
@@ -55,6 +56,10 @@ class CaptureRenderAdapter : public sigslot::has_slots<> {
   bool RemoveRenderer(VideoRenderer* video_renderer);
 
   VideoCapturer* video_capturer() { return video_capturer_; }
+
+  // Implements CapturedFrameFilter.
+  bool WillDropFrame() override;
+
  private:
   struct VideoRendererInfo {
     explicit VideoRendererInfo(VideoRenderer* r)
@@ -36,6 +36,7 @@
 #include "talk/media/base/streamparams.h"
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/dscp.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/optional.h"
@@ -456,9 +457,9 @@ class MediaChannel : public sigslot::has_slots<> {
   class NetworkInterface {
    public:
     enum SocketType { ST_RTP, ST_RTCP };
-    virtual bool SendPacket(rtc::Buffer* packet,
+    virtual bool SendPacket(rtc::CopyOnWriteBuffer* packet,
                             const rtc::PacketOptions& options) = 0;
-    virtual bool SendRtcp(rtc::Buffer* packet,
+    virtual bool SendRtcp(rtc::CopyOnWriteBuffer* packet,
                           const rtc::PacketOptions& options) = 0;
     virtual int SetOption(SocketType type, rtc::Socket::Option opt,
                           int option) = 0;
@@ -503,11 +504,13 @@ class MediaChannel : public sigslot::has_slots<> {
   }
 
   // Base method to send packet using NetworkInterface.
-  bool SendPacket(rtc::Buffer* packet, const rtc::PacketOptions& options) {
+  bool SendPacket(rtc::CopyOnWriteBuffer* packet,
+                  const rtc::PacketOptions& options) {
     return DoSendPacket(packet, false, options);
   }
 
-  bool SendRtcp(rtc::Buffer* packet, const rtc::PacketOptions& options) {
+  bool SendRtcp(rtc::CopyOnWriteBuffer* packet,
+                const rtc::PacketOptions& options) {
     return DoSendPacket(packet, true, options);
   }
 
@@ -537,7 +540,7 @@ class MediaChannel : public sigslot::has_slots<> {
   }
 
  private:
-  bool DoSendPacket(rtc::Buffer* packet,
+  bool DoSendPacket(rtc::CopyOnWriteBuffer* packet,
                     bool rtcp,
                     const rtc::PacketOptions& options) {
     rtc::CritScope cs(&network_interface_crit_);
@@ -779,7 +782,9 @@ struct VideoSenderInfo : public MediaSenderInfo {
         adapt_reason(0),
         adapt_changes(0),
         avg_encode_ms(0),
-        encode_usage_percent(0) {
+        encode_ms_p95(-1),
+        encode_usage_percent(0),
+        packet_history_bytes(0) {
   }
 
   std::vector<SsrcGroup> ssrc_groups;
@@ -799,7 +804,10 @@ struct VideoSenderInfo : public MediaSenderInfo {
   int adapt_reason;
   int adapt_changes;
   int avg_encode_ms;
+  int encode_ms_p95;
   int encode_usage_percent;
+  // Memory held for retransmissions.
+  size_t packet_history_bytes;
   VariableInfo<int> adapt_frame_drops;
   VariableInfo<int> effects_frame_drops;
   VariableInfo<double> capturer_frame_time;
@@ -820,7 +828,9 @@ struct VideoReceiverInfo : public MediaReceiverInfo {
         framerate_render_output(0),
         decode_ms(0),
         max_decode_ms(0),
+        decode_ms_p95(-1),
         jitter_buffer_ms(0),
+        jitter_buffer_ms_p95(-1),
         min_playout_delay_ms(0),
         render_delay_ms(0),
         target_delay_ms(0),
@@ -852,8 +862,12 @@ struct VideoReceiverInfo : public MediaReceiverInfo {
   int decode_ms;
   // Maximum observed frame decode latency.
   int max_decode_ms;
+  // 95th percentile of the decode latency.
+  int decode_ms_p95;
   // Jitter (network-related) latency.
   int jitter_buffer_ms;
+  // 95th percentile of the jitter latency.
+  int jitter_buffer_ms_p95;
   // Requested minimum playout latency.
   int min_playout_delay_ms;
   // Requested latency to account for rendering delay.
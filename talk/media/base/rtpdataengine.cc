@@ -32,6 +32,7 @@
 #include "talk/media/base/rtputils.h"
 #include "talk/media/base/streamparams.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/ratelimiter.h"
@@ -346,12 +347,12 @@ bool RtpDataMediaChannel::SendData(
   rtp_clock_by_send_ssrc_[header.ssrc]->Tick(
       now, &header.seq_num, &header.timestamp);
 
-  rtc::Buffer packet(kMinRtpPacketLen, packet_len);
+  rtc::CopyOnWriteBuffer packet(kMinRtpPacketLen, packet_len);
   if (!SetRtpHeader(packet.data(), packet.size(), header)) {
     return false;
   }
   packet.AppendData(kReservedSpace);
-  packet.AppendData(payload);
+  packet.AppendData(payload.data(), payload.size());
 
   LOG(LS_VERBOSE) << "Sent RTP data packet: "
                   << " stream=" << found_stream->id << " ssrc=" << header.ssrc
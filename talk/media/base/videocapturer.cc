@@ -327,6 +327,20 @@ void VideoCapturer::set_frame_factory(VideoFrameFactory* frame_factory) {
   }
 }
 
+void VideoCapturer::AddFrameFilter(CapturedFrameFilter* filter) {
+  rtc::CritScope cs(&frame_filters_crit_);
+  ASSERT(std::find(frame_filters_.begin(), frame_filters_.end(), filter) ==
+         frame_filters_.end());
+  frame_filters_.push_back(filter);
+}
+
+void VideoCapturer::RemoveFrameFilter(CapturedFrameFilter* filter) {
+  rtc::CritScope cs(&frame_filters_crit_);
+  frame_filters_.erase(
+      std::remove(frame_filters_.begin(), frame_filters_.end(), filter),
+      frame_filters_.end());
+}
+
 void VideoCapturer::GetStats(VariableInfo<int>* adapt_drops_stats,
                              VariableInfo<int>* effect_drops_stats,
                              VariableInfo<double>* frame_time_stats,
@@ -354,6 +368,12 @@ void VideoCapturer::OnFrameCaptured(VideoCapturer*,
     return;
   }
 
+  if (FiltersWillDropFrame()) {
+    // No sink would use the frame, so don't convert it.
+    ++adapt_frame_drops_;
+    return;
+  }
+
   // Use a temporary buffer to scale
   rtc::scoped_ptr<uint8_t[]> scale_buffer;
 
@@ -538,6 +558,19 @@ void VideoCapturer::OnFrameCaptured(VideoCapturer*,
   UpdateStats(captured_frame);
 }
 
+bool VideoCapturer::FiltersWillDropFrame() {
+  // The lock is held while the filters are called, so that a filter that has
+  // been removed is never called again.
+  rtc::CritScope cs(&frame_filters_crit_);
+  if (frame_filters_.empty())
+    return false;
+  // Every filter is asked, as they may count the frames they are asked about.
+  bool will_drop = true;
+  for (CapturedFrameFilter* filter : frame_filters_)
+    will_drop &= filter->WillDropFrame();
+  return will_drop;
+}
+
 void VideoCapturer::SetCaptureState(CaptureState state) {
   if (state == capture_state_) {
     // Don't trigger a state changed callback if the state hasn't changed.
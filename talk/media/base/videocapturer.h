@@ -99,6 +99,18 @@ struct CapturedFrame {
   RTC_DISALLOW_COPY_AND_ASSIGN(CapturedFrame);
 };
 
+// Implemented by sinks of VideoCapturer::SignalVideoFrame that can tell,
+// before a captured frame is converted and scaled, that they would drop it.
+class CapturedFrameFilter {
+ public:
+  // Returns true if a frame captured now would be dropped. Called on the
+  // capture thread, once for each captured frame.
+  virtual bool WillDropFrame() = 0;
+
+ protected:
+  virtual ~CapturedFrameFilter() {}
+};
+
 // VideoCapturer is an abstract class that defines the interfaces for video
 // capturing. The subclasses implement the video capturer for various types of
 // capturers and various platforms.
@@ -278,6 +290,15 @@ class VideoCapturer
   // Takes ownership.
   void set_frame_factory(VideoFrameFactory* frame_factory);
 
+  // Adds a filter that is asked about every captured frame. When there is at
+  // least one filter and all of them would drop a frame, the frame is dropped
+  // before it is converted or scaled. A sink of SignalVideoFrame that needs
+  // every frame must therefore add a filter of its own. Can be called on any
+  // thread.
+  void AddFrameFilter(CapturedFrameFilter* filter);
+  // Once this returns, |filter| is not called again.
+  void RemoveFrameFilter(CapturedFrameFilter* filter);
+
   // Gets statistics for tracked variables recorded since the last call to
   // GetStats.  Note that calling GetStats resets any gathered data so it
   // should be called only periodically to log statistics.
@@ -336,6 +357,10 @@ class VideoCapturer
 
   void UpdateStats(const CapturedFrame* captured_frame);
 
+  // Returns true if there are frame filters and all of them would drop the
+  // current frame.
+  bool FiltersWillDropFrame();
+
   // Helper function to save statistics on the current data from a
   // RollingAccumulator into stats.
   template<class T>
@@ -377,6 +402,9 @@ class VideoCapturer
   // Whether capturer should apply rotation to the frame before signaling it.
   bool apply_rotation_;
 
+  rtc::CriticalSection frame_filters_crit_;
+  std::vector<CapturedFrameFilter*> frame_filters_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(VideoCapturer);
 };
 
@@ -196,6 +196,51 @@ TEST_F(VideoCapturerTest, CameraOffOnMute) {
   EXPECT_EQ(33, video_frames_received());
 }
 
+namespace {
+class FakeFrameFilter : public cricket::CapturedFrameFilter {
+ public:
+  FakeFrameFilter() : will_drop_frame_(false), num_calls_(0) {}
+  bool WillDropFrame() override {
+    ++num_calls_;
+    return will_drop_frame_;
+  }
+  bool will_drop_frame_;
+  int num_calls_;
+};
+}  // namespace
+
+TEST_F(VideoCapturerTest, DropsFrameOnlyIfAllFiltersWillDrop) {
+  EXPECT_EQ(cricket::CS_RUNNING, capturer_.Start(cricket::VideoFormat(
+      640,
+      480,
+      cricket::VideoFormat::FpsToInterval(30),
+      cricket::FOURCC_I420)));
+  FakeFrameFilter filter1;
+  FakeFrameFilter filter2;
+  capturer_.AddFrameFilter(&filter1);
+  capturer_.AddFrameFilter(&filter2);
+
+  EXPECT_TRUE(capturer_.CaptureFrame());
+  EXPECT_EQ(1, video_frames_received());
+
+  filter1.will_drop_frame_ = true;
+  EXPECT_TRUE(capturer_.CaptureFrame());
+  EXPECT_EQ(2, video_frames_received());
+
+  filter2.will_drop_frame_ = true;
+  EXPECT_TRUE(capturer_.CaptureFrame());
+  EXPECT_EQ(2, video_frames_received());
+  EXPECT_EQ(3, filter1.num_calls_);
+  EXPECT_EQ(3, filter2.num_calls_);
+
+  // Without filters no frames are dropped.
+  capturer_.RemoveFrameFilter(&filter1);
+  capturer_.RemoveFrameFilter(&filter2);
+  EXPECT_TRUE(capturer_.CaptureFrame());
+  EXPECT_EQ(3, video_frames_received());
+  EXPECT_EQ(3, filter1.num_calls_);
+}
+
 TEST_F(VideoCapturerTest, ScreencastScaledOddWidth) {
   capturer_.SetScreencast(true);
 
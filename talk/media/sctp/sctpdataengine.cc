@@ -30,6 +30,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "talk/media/base/codec.h"
@@ -38,6 +39,7 @@
 #include "usrsctplib/usrsctp.h"
 #include "webrtc/base/arraysize.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/safe_conversions.h"
@@ -104,7 +106,6 @@ std::string ListArray(const uint16_t* array, int num_elems) {
 
 namespace cricket {
 typedef rtc::ScopedMessageData<SctpInboundPacket> InboundPacketMessage;
-typedef rtc::ScopedMessageData<rtc::Buffer> OutboundPacketMessage;
 
 // The biggest SCTP packet.  Starting from a 'safe' wire MTU value of 1280,
 // take off 80 bytes for DTLS/TURN/TCP/IP overhead.
@@ -113,16 +114,25 @@ static const size_t kSctpMtu = 1200;
 // The size of the SCTP association send buffer.  256kB, the usrsctp default.
 static const int kSendBufferSize = 262144;
 enum {
-  MSG_SCTPINBOUNDPACKET = 1,   // MessageData is SctpInboundPacket
-  MSG_SCTPOUTBOUNDPACKET = 2,  // MessageData is rtc:Buffer
+  MSG_SCTPINBOUNDPACKET = 1,    // MessageData is SctpInboundPacket
+  MSG_SCTPOUTBOUNDPACKETS = 2,  // No MessageData; see QueueOutboundPacket.
 };
 
 struct SctpInboundPacket {
-  rtc::Buffer buffer;
+  // Takes ownership of |data|, which usrsctp allocated with malloc.
+  SctpInboundPacket(void* data, size_t length)
+      : data(static_cast<uint8_t*>(data)), length(length), flags(0) {}
+  ~SctpInboundPacket() { free(data); }
+
+  uint8_t* const data;
+  const size_t length;
   ReceiveDataParams params;
   // The |flags| parameter is used by SCTP to distinguish notification packets
   // from other types of packets.
   int flags;
+
+ private:
+  RTC_DISALLOW_COPY_AND_ASSIGN(SctpInboundPacket);
 };
 
 // Helper for logging SCTP messages.
@@ -201,11 +211,8 @@ static int OnSctpOutboundPacket(void* addr, void* data, size_t length,
                   << "; tos: " << std::hex << static_cast<int>(tos)
                   << "; set_df: " << std::hex << static_cast<int>(set_df);
 
-  VerboseLogPacket(addr, length, SCTP_DUMP_OUTBOUND);
-  // Note: We have to copy the data; the caller will delete it.
-  auto* msg = new OutboundPacketMessage(
-      new rtc::Buffer(reinterpret_cast<uint8_t*>(data), length));
-  channel->worker_thread()->Post(channel, MSG_SCTPOUTBOUNDPACKET, msg);
+  VerboseLogPacket(data, length, SCTP_DUMP_OUTBOUND);
+  channel->QueueOutboundPacket(data, length);
   return 0;
 }
 
@@ -218,9 +225,8 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
                                struct sctp_rcvinfo rcv, int flags,
                                void* ulp_info) {
   SctpDataMediaChannel* channel = static_cast<SctpDataMediaChannel*>(ulp_info);
-  // Post data to the channel's receiver thread (copying it).
-  // TODO(ldixon): Unclear if copy is needed as this method is responsible for
-  // memory cleanup. But this does simplify code.
+  // Post data to the channel's receiver thread. We're responsible for freeing
+  // |data|, so rather than copying it, the packet takes it along.
   const SctpDataMediaChannel::PayloadProtocolIdentifier ppid =
       static_cast<SctpDataMediaChannel::PayloadProtocolIdentifier>(
           rtc::HostToNetwork32(rcv.rcv_ppid));
@@ -229,9 +235,9 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
     // It's neither a notification nor a recognized data packet.  Drop it.
     LOG(LS_ERROR) << "Received an unknown PPID " << ppid
                   << " on an SCTP packet.  Dropping.";
+    free(data);
   } else {
-    SctpInboundPacket* packet = new SctpInboundPacket;
-    packet->buffer.SetData(reinterpret_cast<uint8_t*>(data), length);
+    SctpInboundPacket* packet = new SctpInboundPacket(data, length);
     packet->params.ssrc = rcv.rcv_sid;
     packet->params.seq_num = rcv.rcv_ssn;
     packet->params.timestamp = rcv.rcv_tsn;
@@ -241,7 +247,6 @@ static int OnSctpInboundPacket(struct socket* sock, union sctp_sockstore addr,
     InboundPacketMessage* msg = new InboundPacketMessage(packet);
     channel->worker_thread()->Post(channel, MSG_SCTPINBOUNDPACKET, msg);
   }
-  free(data);
   return 1;
 }
 
@@ -692,34 +697,36 @@ void SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(
                   << "Received SCTP data:"
                   << " ssrc=" << packet->params.ssrc
                   << " notification: " << (packet->flags & MSG_NOTIFICATION)
-                  << " length=" << packet->buffer.size();
+                  << " length=" << packet->length;
   // Sending a packet with data == NULL (no data) is SCTPs "close the
   // connection" message. This sets sock_ = NULL;
-  if (!packet->buffer.size() || !packet->buffer.data()) {
+  if (!packet->length || !packet->data) {
     LOG(LS_INFO) << debug_name_ << "->OnInboundPacketFromSctpToChannel(...): "
                                    "No data, closing.";
     return;
   }
   if (packet->flags & MSG_NOTIFICATION) {
-    OnNotificationFromSctp(&packet->buffer);
+    OnNotificationFromSctp(packet->data, packet->length);
   } else {
-    OnDataFromSctpToChannel(packet->params, &packet->buffer);
+    OnDataFromSctpToChannel(packet->params,
+                            reinterpret_cast<const char*>(packet->data),
+                            packet->length);
   }
 }
 
 void SctpDataMediaChannel::OnDataFromSctpToChannel(
-    const ReceiveDataParams& params, rtc::Buffer* buffer) {
+    const ReceiveDataParams& params, const char* data, size_t length) {
   if (receiving_) {
     LOG(LS_VERBOSE) << debug_name_ << "->OnDataFromSctpToChannel(...): "
-                    << "Posting with length: " << buffer->size()
+                    << "Posting with length: " << length
                     << " on stream " << params.ssrc;
     // Reports all received messages to upper layers, no matter whether the sid
     // is known.
-    SignalDataReceived(params, buffer->data<char>(), buffer->size());
+    SignalDataReceived(params, data, length);
   } else {
     LOG(LS_WARNING) << debug_name_ << "->OnDataFromSctpToChannel(...): "
                     << "Not receiving packet with sid=" << params.ssrc
-                    << " len=" << buffer->size() << " before SetReceive(true).";
+                    << " len=" << length << " before SetReceive(true).";
   }
 }
 
@@ -782,10 +789,11 @@ bool SctpDataMediaChannel::ResetStream(uint32_t ssrc) {
   return true;
 }
 
-void SctpDataMediaChannel::OnNotificationFromSctp(rtc::Buffer* buffer) {
+void SctpDataMediaChannel::OnNotificationFromSctp(const uint8_t* data,
+                                                  size_t length) {
   const sctp_notification& notification =
-      reinterpret_cast<const sctp_notification&>(*buffer->data());
-  ASSERT(notification.sn_header.sn_length == buffer->size());
+      reinterpret_cast<const sctp_notification&>(*data);
+  ASSERT(notification.sn_header.sn_length == length);
 
   // TODO(ldixon): handle notifications appropriately.
   switch (notification.sn_header.sn_type) {
@@ -977,8 +985,34 @@ bool SctpDataMediaChannel::SetRecvCodecs(const std::vector<DataCodec>& codecs) {
       &local_port_);
 }
 
+void SctpDataMediaChannel::QueueOutboundPacket(const void* data,
+                                               size_t length) {
+  // Note: We have to copy the data; the caller will delete it.
+  rtc::CopyOnWriteBuffer packet(static_cast<const uint8_t*>(data), length);
+  bool post;
+  {
+    rtc::CritScope cs(&outbound_packets_lock_);
+    post = outbound_packets_.empty();
+    outbound_packets_.push_back(std::move(packet));
+  }
+  // Packets queued before the worker thread gets to the message go out with
+  // it, so there's at most one pending message per channel.
+  if (post)
+    worker_thread_->Post(this, MSG_SCTPOUTBOUNDPACKETS);
+}
+
+void SctpDataMediaChannel::SendQueuedOutboundPackets() {
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  {
+    rtc::CritScope cs(&outbound_packets_lock_);
+    packets.swap(outbound_packets_);
+  }
+  for (rtc::CopyOnWriteBuffer& packet : packets)
+    OnPacketFromSctpToNetwork(&packet);
+}
+
 void SctpDataMediaChannel::OnPacketFromSctpToNetwork(
-    rtc::Buffer* buffer) {
+    rtc::CopyOnWriteBuffer* buffer) {
   // usrsctp seems to interpret the MTU we give it strangely -- it seems to
   // give us back packets bigger than that MTU, if only by a fixed amount.
   // This is that amount that we've observed.
@@ -1042,12 +1076,9 @@ void SctpDataMediaChannel::OnMessage(rtc::Message* msg) {
       OnInboundPacketFromSctpToChannel(pdata->data().get());
       break;
     }
-    case MSG_SCTPOUTBOUNDPACKET: {
-      rtc::scoped_ptr<OutboundPacketMessage> pdata(
-          static_cast<OutboundPacketMessage*>(msg->pdata));
-      OnPacketFromSctpToNetwork(pdata->data().get());
+    case MSG_SCTPOUTBOUNDPACKETS:
+      SendQueuedOutboundPackets();
       break;
-    }
   }
 }
 }  // namespace cricket
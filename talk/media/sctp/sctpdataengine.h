@@ -45,7 +45,10 @@ enum PreservedErrno {
 #include "talk/media/base/mediachannel.h"
 #include "talk/media/base/mediaengine.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/copyonwritebuffer.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
 
 // Defined by "usrsctplib/usrsctp.h"
 struct sockaddr_conn;
@@ -74,20 +77,23 @@ class SctpDataMediaChannel;
 //  2.  usrsctp_sendv(data)
 // [worker thread returns; sctp thread then calls the following]
 //  3.  OnSctpOutboundPacket(wrapped_data)
-// [sctp thread returns having posted a message for the worker thread]
-//  4.  SctpDataMediaChannel::OnMessage(wrapped_data)
-//  5.  SctpDataMediaChannel::OnPacketFromSctpToNetwork(wrapped_data)
-//  6.  NetworkInterface::SendPacket(wrapped_data)
-//  7.  ... across network ... a packet is sent back ...
-//  8.  SctpDataMediaChannel::OnPacketReceived(wrapped_data)
-//  9.  usrsctp_conninput(wrapped_data)
+//  4.  SctpDataMediaChannel::QueueOutboundPacket(wrapped_data)
+// [sctp thread returns; the first packet queued posts a message for the
+//  worker thread, which then sends all the packets queued so far]
+//  5.  SctpDataMediaChannel::OnMessage()
+//  6.  SctpDataMediaChannel::OnPacketFromSctpToNetwork(wrapped_data)
+//  7.  NetworkInterface::SendPacket(wrapped_data)
+//  8.  ... across network ... a packet is sent back ...
+//  9.  SctpDataMediaChannel::OnPacketReceived(wrapped_data)
+//  10. usrsctp_conninput(wrapped_data)
 // [worker thread returns; sctp thread then calls the following]
-//  10.  OnSctpInboundData(data)
-// [sctp thread returns having posted a message fot the worker thread]
-//  11. SctpDataMediaChannel::OnMessage(inboundpacket)
-//  12. SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(inboundpacket)
-//  13. SctpDataMediaChannel::OnDataFromSctpToChannel(data)
-//  14. SctpDataMediaChannel::SignalDataReceived(data)
+//  11. OnSctpInboundData(data)
+// [sctp thread returns having posted a message fot the worker thread, which
+//  owns the data usrsctp allocated from here on]
+//  12. SctpDataMediaChannel::OnMessage(inboundpacket)
+//  13. SctpDataMediaChannel::OnInboundPacketFromSctpToChannel(inboundpacket)
+//  14. SctpDataMediaChannel::OnDataFromSctpToChannel(data)
+//  15. SctpDataMediaChannel::SignalDataReceived(data)
 // [from the same thread, methods registered/connected to
 //  SctpDataMediaChannel are called with the recieved data]
 class SctpDataEngine : public DataEngineInterface, public sigslot::has_slots<> {
@@ -170,6 +176,10 @@ class SctpDataMediaChannel : public DataMediaChannel,
 
   // Exposed to allow Post call from c-callbacks.
   rtc::Thread* worker_thread() const { return worker_thread_; }
+  // Called from the usrsctp thread with a packet to send on the network.
+  // Copies it, and has the worker thread send it along with any other packet
+  // queued by then.
+  void QueueOutboundPacket(const void* data, size_t length);
 
   // Many of these things are unused by SCTP, but are needed to fulfill
   // the MediaChannel interface.
@@ -209,13 +219,15 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Queues a stream for reset.
   bool ResetStream(uint32_t ssrc);
 
-  // Called by OnMessage to send packet on the network.
-  void OnPacketFromSctpToNetwork(rtc::Buffer* buffer);
+  // Called by OnMessage to send all the queued packets on the network.
+  void SendQueuedOutboundPackets();
+  void OnPacketFromSctpToNetwork(rtc::CopyOnWriteBuffer* buffer);
   // Called by OnMessage to decide what to do with the packet.
   void OnInboundPacketFromSctpToChannel(SctpInboundPacket* packet);
   void OnDataFromSctpToChannel(const ReceiveDataParams& params,
-                               rtc::Buffer* buffer);
-  void OnNotificationFromSctp(rtc::Buffer* buffer);
+                               const char* data,
+                               size_t length);
+  void OnNotificationFromSctp(const uint8_t* data, size_t length);
   void OnNotificationAssocChange(const sctp_assoc_change& change);
 
   void OnStreamResetEvent(const struct sctp_stream_reset_event* evt);
@@ -247,6 +259,11 @@ class SctpDataMediaChannel : public DataMediaChannel,
   StreamSet queued_reset_streams_;
   StreamSet sent_reset_streams_;
 
+  // Packets from usrsctp waiting for the worker thread to send them.
+  rtc::CriticalSection outbound_packets_lock_;
+  std::vector<rtc::CopyOnWriteBuffer> outbound_packets_
+      GUARDED_BY(outbound_packets_lock_);
+
   // A human-readable name for debugging messages.
   std::string debug_name_;
 };
@@ -36,6 +36,7 @@
 #include "talk/media/sctp/sctpdataengine.h"
 #include "webrtc/base/bind.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/helpers.h"
@@ -63,13 +64,12 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
 
  protected:
   // Called to send raw packet down the wire (e.g. SCTP an packet).
-  virtual bool SendPacket(rtc::Buffer* packet,
+  virtual bool SendPacket(rtc::CopyOnWriteBuffer* packet,
                           const rtc::PacketOptions& options) {
     LOG(LS_VERBOSE) << "SctpFakeNetworkInterface::SendPacket";
 
-    // TODO(ldixon): Can/should we use Buffer.TransferTo here?
-    // Note: this assignment does a deep copy of data from packet.
-    rtc::Buffer* buffer = new rtc::Buffer(packet->data(), packet->size());
+    // The receive side still takes an rtc::Buffer, so copy the data here.
+    rtc::Buffer* buffer = new rtc::Buffer(packet->cdata(), packet->size());
     thread_->Post(this, MSG_PACKET, rtc::WrapMessageData(buffer));
     LOG(LS_VERBOSE) << "SctpFakeNetworkInterface::SendPacket, Posted message.";
     return true;
@@ -92,7 +92,7 @@ class SctpFakeNetworkInterface : public cricket::MediaChannel::NetworkInterface,
   // Unsupported functions required to exist by NetworkInterface.
   // TODO(ldixon): Refactor parent NetworkInterface class so these are not
   // required. They are RTC specific and should be in an appropriate subclass.
-  virtual bool SendRtcp(rtc::Buffer* packet,
+  virtual bool SendRtcp(rtc::CopyOnWriteBuffer* packet,
                         const rtc::PacketOptions& options) {
     LOG(LS_WARNING) << "Unsupported: SctpFakeNetworkInterface::SendRtcp.";
     return false;
@@ -406,6 +406,23 @@ TEST_F(SctpDataMediaChannelTest, SendData) {
                   << ", recv1.last_data=" << receiver1()->last_data();
 }
 
+// A message that takes many SCTP packets, which usrsctp hands us in a burst,
+// arrives whole.
+TEST_F(SctpDataMediaChannelTest, SendLargeData) {
+  SetupConnectedChannels();
+
+  std::string msg(32 * 1024, 0);
+  for (size_t i = 0; i < msg.size(); ++i)
+    msg[i] = static_cast<char>(i % 251);
+
+  cricket::SendDataResult result;
+  ASSERT_TRUE(SendData(channel1(), 1, msg, &result));
+  EXPECT_EQ(cricket::SDR_SUCCESS, result);
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, msg), 1000);
+  ASSERT_TRUE(SendData(channel1(), 1, "small", &result));
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, "small"), 1000);
+}
+
 // Sends a lot of large messages at once and verifies SDR_BLOCK is returned.
 TEST_F(SctpDataMediaChannelTest, SendDataBlocked) {
   SetupConnectedChannels();
@@ -41,6 +41,7 @@
 #include "talk/media/webrtc/webrtcvideoframe.h"
 #include "talk/media/webrtc/webrtcvoiceengine.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/stringutils.h"
 #include "webrtc/base/timeutils.h"
@@ -293,6 +294,16 @@ bool IsCodecBlacklistedForSimulcast(const std::string& codec_name) {
          CodecNamesEq(codec_name, kVp9CodecName);
 }
 
+// Returns true if camera video sent with VP9 should use a single encode with
+// spatial and temporal layers, which the receivers or an SFU pick from,
+// instead of a single-layer stream.
+bool IsVp9CameraSvcEnabled() {
+  return webrtc::field_trial::FindFullName("WebRTC-Vp9CameraSvc") == "Enabled";
+}
+
+const int kVp9CameraSvcSpatialLayers = 3;
+const int kVp9CameraSvcTemporalLayers = 3;
+
 // The selected thresholds for QVGA and VGA corresponded to a QP around 10.
 // The change in QP declined above the selected bitrates.
 static int GetMaxDefaultVideoBitrateKbps(int width, int height) {
@@ -429,6 +440,9 @@ void* WebRtcVideoChannel2::WebRtcVideoSendStream::ConfigureVideoEncoderSettings(
     encoder_settings_.vp9.denoisingOn =
         codec_default_denoising ? false : denoising;
     encoder_settings_.vp9.frameDroppingOn = frame_dropping;
+    if (!is_screencast && IsVp9CameraSvcEnabled()) {
+      encoder_settings_.vp9.numberOfSpatialLayers = kVp9CameraSvcSpatialLayers;
+    }
     return &encoder_settings_.vp9;
   }
   return NULL;
@@ -1539,14 +1553,14 @@ void WebRtcVideoChannel2::OnLoadUpdate(Load load) {
 bool WebRtcVideoChannel2::SendRtp(const uint8_t* data,
                                   size_t len,
                                   const webrtc::PacketOptions& options) {
-  rtc::Buffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
   rtc::PacketOptions rtc_options;
   rtc_options.packet_id = options.packet_id;
   return MediaChannel::SendPacket(&packet, rtc_options);
 }
 
 bool WebRtcVideoChannel2::SendRtcp(const uint8_t* data, size_t len) {
-  rtc::Buffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
   return MediaChannel::SendRtcp(&packet, rtc::PacketOptions());
 }
 
@@ -1700,6 +1714,14 @@ void WebRtcVideoChannel2::WebRtcVideoSendStream::InputFrame(
   stream_->Input()->IncomingCapturedFrame(video_frame);
 }
 
+bool WebRtcVideoChannel2::WebRtcVideoSendStream::WillDropFrame() {
+  rtc::CritScope cs(&lock_);
+  // Same early returns as in InputFrame().
+  if (stream_ == NULL || !sending_ || format_.width == 0)
+    return true;
+  return stream_->Input()->WillDropFrame();
+}
+
 bool WebRtcVideoChannel2::WebRtcVideoSendStream::SetCapturer(
     VideoCapturer* capturer) {
   TRACE_EVENT0("webrtc", "WebRtcVideoSendStream::SetCapturer");
@@ -1742,6 +1764,7 @@ bool WebRtcVideoChannel2::WebRtcVideoSendStream::SetCapturer(
   // Lock cannot be held while connecting the capturer to prevent lock-order
   // violations.
   capturer->SignalVideoFrame.connect(this, &WebRtcVideoSendStream::InputFrame);
+  capturer->AddFrameFilter(this);
   return true;
 }
 
@@ -1788,6 +1811,7 @@ bool WebRtcVideoChannel2::WebRtcVideoSendStream::DisconnectCapturer() {
     capturer = capturer_;
     capturer_ = NULL;
   }
+  capturer->RemoveFrameFilter(this);
   capturer->SignalVideoFrame.disconnect(this);
   return true;
 }
@@ -2000,6 +2024,19 @@ WebRtcVideoChannel2::WebRtcVideoSendStream::CreateVideoEncoderConfig(
       CreateVideoStreams(clamped_codec, parameters_.options,
                          parameters_.max_bitrate_bps, stream_count);
 
+  // VP9 camera SVC derives the number of temporal layers from the number of
+  // thresholds. The encoder splits the rate of each spatial layer over its
+  // temporal layers itself, so the thresholds only mirror that split.
+  if (CodecNamesEq(codec.name, kVp9CodecName) && !dimensions.is_screencast &&
+      encoder_config.streams.size() == 1 && IsVp9CameraSvcEnabled()) {
+    webrtc::VideoStream* stream = &encoder_config.streams[0];
+    stream->temporal_layer_thresholds_bps.clear();
+    for (int i = 1; i < kVp9CameraSvcTemporalLayers; ++i) {
+      stream->temporal_layer_thresholds_bps.push_back(
+          stream->max_bitrate_bps - (stream->max_bitrate_bps >> i));
+    }
+  }
+
   // Conference mode screencast uses 2 temporal layers split at 100kbit.
   if (parameters_.options.conference_mode.value_or(false) &&
       dimensions.is_screencast && encoder_config.streams.size() == 1) {
@@ -2130,7 +2167,9 @@ WebRtcVideoChannel2::WebRtcVideoSendStream::GetVideoSenderInfo() {
   info.framerate_input = stats.input_frame_rate;
   info.framerate_sent = stats.encode_frame_rate;
   info.avg_encode_ms = stats.avg_encode_time_ms;
+  info.encode_ms_p95 = stats.encode_time_p95_ms;
   info.encode_usage_percent = stats.encode_usage_percent;
+  info.packet_history_bytes = stats.packet_history_bytes;
 
   info.nominal_bitrate = stats.media_bitrate_bps;
 
@@ -2540,9 +2579,11 @@ WebRtcVideoChannel2::WebRtcVideoReceiveStream::GetVideoReceiverInfo() {
 
   info.decode_ms = stats.decode_ms;
   info.max_decode_ms = stats.max_decode_ms;
+  info.decode_ms_p95 = stats.decode_ms_p95;
   info.current_delay_ms = stats.current_delay_ms;
   info.target_delay_ms = stats.target_delay_ms;
   info.jitter_buffer_ms = stats.jitter_buffer_ms;
+  info.jitter_buffer_ms_p95 = stats.jitter_buffer_ms_p95;
   info.min_playout_delay_ms = stats.min_playout_delay_ms;
   info.render_delay_ms = stats.render_delay_ms;
 
@@ -234,7 +234,8 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
 
   // Wrapper for the sender part, this is where the capturer is connected and
   // frames are then converted from cricket frames to webrtc frames.
-  class WebRtcVideoSendStream : public sigslot::has_slots<> {
+  class WebRtcVideoSendStream : public sigslot::has_slots<>,
+                                public CapturedFrameFilter {
    public:
     WebRtcVideoSendStream(
         webrtc::Call* call,
@@ -257,6 +258,8 @@ class WebRtcVideoChannel2 : public rtc::MessageHandler,
     void SetSendParameters(const VideoSendParameters& send_params);
 
     void InputFrame(VideoCapturer* capturer, const VideoFrame* frame);
+    // Implements CapturedFrameFilter.
+    bool WillDropFrame() override;
     bool SetCapturer(VideoCapturer* capturer);
     bool SetVideoFormat(const VideoFormat& format);
     void MuteStream(bool mute);
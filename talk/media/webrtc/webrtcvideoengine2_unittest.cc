@@ -1755,7 +1755,9 @@ TEST_F(WebRtcVideoChannel2Test, VerifyVp8SpecificSettings) {
 
 class Vp9SettingsTest : public WebRtcVideoChannel2Test {
  public:
-  Vp9SettingsTest() : WebRtcVideoChannel2Test() {
+  Vp9SettingsTest() : Vp9SettingsTest("") {}
+  explicit Vp9SettingsTest(const char* field_trials)
+      : WebRtcVideoChannel2Test(field_trials) {
     encoder_factory_.AddSupportedVideoCodecType(webrtc::kVideoCodecVP9, "VP9");
   }
   virtual ~Vp9SettingsTest() {}
@@ -1829,6 +1831,49 @@ TEST_F(Vp9SettingsTest, VerifyVp9SpecificSettings) {
   EXPECT_TRUE(channel_->SetCapturer(last_ssrc_, NULL));
 }
 
+class Vp9CameraSvcTest : public Vp9SettingsTest {
+ public:
+  Vp9CameraSvcTest() : Vp9SettingsTest("WebRTC-Vp9CameraSvc/Enabled/") {}
+};
+
+TEST_F(Vp9CameraSvcTest, CameraUsesSpatialAndTemporalLayers) {
+  cricket::VideoSendParameters parameters;
+  parameters.codecs.push_back(kVp9Codec);
+  ASSERT_TRUE(channel_->SetSendParameters(parameters));
+
+  FakeVideoSendStream* stream = SetUpSimulcast(false, false);
+
+  cricket::FakeVideoCapturer capturer;
+  capturer.SetScreencast(false);
+  EXPECT_EQ(cricket::CS_RUNNING,
+            capturer.Start(capturer.GetSupportedFormats()->front()));
+  EXPECT_TRUE(channel_->SetCapturer(last_ssrc_, &capturer));
+  channel_->SetSend(true);
+
+  EXPECT_TRUE(capturer.CaptureFrame());
+
+  stream = fake_call_->GetVideoSendStreams().back();
+  webrtc::VideoCodecVP9 vp9_settings;
+  ASSERT_TRUE(stream->GetVp9Settings(&vp9_settings)) << "No VP9 config set.";
+  EXPECT_EQ(3, vp9_settings.numberOfSpatialLayers);
+  std::vector<webrtc::VideoStream> streams = stream->GetVideoStreams();
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_EQ(2u, streams[0].temporal_layer_thresholds_bps.size());
+
+  // Screen sharing keeps its own layer configuration.
+  capturer.SetScreencast(true);
+  EXPECT_TRUE(capturer.CaptureFrame());
+
+  stream = fake_call_->GetVideoSendStreams().back();
+  ASSERT_TRUE(stream->GetVp9Settings(&vp9_settings)) << "No VP9 config set.";
+  EXPECT_EQ(1, vp9_settings.numberOfSpatialLayers);
+  streams = stream->GetVideoStreams();
+  ASSERT_EQ(1u, streams.size());
+  EXPECT_TRUE(streams[0].temporal_layer_thresholds_bps.empty());
+
+  EXPECT_TRUE(channel_->SetCapturer(last_ssrc_, NULL));
+}
+
 TEST_F(WebRtcVideoChannel2Test, DISABLED_MultipleSendStreamsWithOneCapturer) {
   FAIL() << "Not implemented.";  // TODO(pbos): Implement.
 }
@@ -27,10 +27,19 @@
 
 #include "talk/media/webrtc/webrtcvideoframe.h"
 #include "talk/media/webrtc/webrtcvideoframefactory.h"
+
+#include <algorithm>
+
+#include "libyuv/scale.h"
+#include "talk/media/base/videocapturer.h"
+#include "talk/media/base/videocommon.h"
 #include "webrtc/base/logging.h"
 
 namespace cricket {
 
+WebRtcVideoFrameFactory::WebRtcVideoFrameFactory()
+    : buffer_pool_(webrtc::SharedI420BufferPool::Default()) {}
+
 VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
     const CapturedFrame* aliased_frame, int width, int height) const {
   rtc::scoped_ptr<WebRtcVideoFrame> frame(new WebRtcVideoFrame());
@@ -42,4 +51,72 @@ VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
   return frame.release();
 }
 
+VideoFrame* WebRtcVideoFrameFactory::CreateAliasedFrame(
+    const CapturedFrame* input_frame,
+    int cropped_input_width,
+    int cropped_input_height,
+    int output_width,
+    int output_height) const {
+  const uint32_t fourcc = CanonicalFourCC(input_frame->fourcc);
+  const int width = input_frame->width;
+  const int height = input_frame->height;
+  const int chroma_width = (width + 1) / 2;
+  const int chroma_height = (height + 1) / 2;
+  // Rotation, flipped frames and packed formats take the two pass path.
+  if ((fourcc != FOURCC_I420 && fourcc != FOURCC_YV12) ||
+      (apply_rotation_ && input_frame->rotation != webrtc::kVideoRotation_0) ||
+      height <= 0 || cropped_input_width > width ||
+      cropped_input_height > height ||
+      (cropped_input_width == output_width &&
+       cropped_input_height == output_height) ||
+      input_frame->data_size < static_cast<uint32_t>(
+          width * height + 2 * chroma_width * chroma_height)) {
+    return VideoFrameFactory::CreateAliasedFrame(
+        input_frame, cropped_input_width, cropped_input_height, output_width,
+        output_height);
+  }
+
+  // Same center crop as WebRtcVideoFrame::Init().
+  int horiz_crop = ((width - cropped_input_width) / 2) & ~1;
+  int vert_crop = ((height - cropped_input_height) / 2) & ~1;
+  int src_width = cropped_input_width;
+  int src_height = cropped_input_height;
+  // Then the same aspect ratio crop as VideoFrame::Stretch() with
+  // |vert_crop| set, so the result matches the two pass path.
+  if (src_width * output_height > src_height * output_width) {
+    src_width = (src_height * output_width / output_height) & ~1;
+    horiz_crop += ((cropped_input_width - src_width) / 2) & ~1;
+  } else if (src_width * output_height < src_height * output_width) {
+    src_height = src_width * output_height / output_width;
+    vert_crop += ((cropped_input_height - src_height) >> 2) << 1;
+  }
+
+  const uint8_t* src_y = static_cast<const uint8_t*>(input_frame->data);
+  const uint8_t* src_u = src_y + width * height;
+  const uint8_t* src_v = src_u + chroma_width * chroma_height;
+  if (fourcc == FOURCC_YV12)
+    std::swap(src_u, src_v);
+  src_y += vert_crop * width + horiz_crop;
+  src_u += vert_crop / 2 * chroma_width + horiz_crop / 2;
+  src_v += vert_crop / 2 * chroma_width + horiz_crop / 2;
+
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+      buffer_pool_->CreateBuffer(output_width, output_height);
+  if (libyuv::Scale(src_y, src_u, src_v, width, chroma_width, chroma_width,
+                    src_width, src_height,
+                    buffer->MutableData(webrtc::kYPlane),
+                    buffer->MutableData(webrtc::kUPlane),
+                    buffer->MutableData(webrtc::kVPlane),
+                    buffer->stride(webrtc::kYPlane),
+                    buffer->stride(webrtc::kUPlane),
+                    buffer->stride(webrtc::kVPlane), output_width,
+                    output_height, true) != 0) {
+    LOG(LS_WARNING) << "Failed to scale frame to " << output_width << "x"
+                    << output_height;
+    return NULL;
+  }
+  return new WebRtcVideoFrame(buffer, input_frame->time_stamp,
+                              input_frame->rotation);
+}
+
 }  // namespace cricket
@@ -29,6 +29,8 @@
 #define TALK_MEDIA_WEBRTC_WEBRTCVIDEOFRAMEFACTORY_H_
 
 #include "talk/media/base/videoframefactory.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 
 namespace cricket {
 
@@ -37,9 +39,23 @@ struct CapturedFrame;
 // Creates instances of cricket::WebRtcVideoFrame.
 class WebRtcVideoFrameFactory : public VideoFrameFactory {
  public:
+  WebRtcVideoFrameFactory();
+
   VideoFrame* CreateAliasedFrame(const CapturedFrame* aliased_frame,
                                  int width,
                                  int height) const override;
+
+  // I420 and YV12 frames that need scaling are cropped and scaled straight
+  // from the captured sample into a pooled buffer, in a single pass. Other
+  // formats are converted to I420 first and then scaled.
+  VideoFrame* CreateAliasedFrame(const CapturedFrame* input_frame,
+                                 int cropped_input_width,
+                                 int cropped_input_height,
+                                 int output_width,
+                                 int output_height) const override;
+
+ private:
+  const rtc::scoped_refptr<webrtc::SharedI420BufferPool> buffer_pool_;
 };
 
 }  // namespace cricket
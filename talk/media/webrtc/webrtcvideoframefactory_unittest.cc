@@ -107,6 +107,32 @@ class WebRtcVideoFrameFactoryTest
                 new_height / 2, apply_rotation);
   }
 
+  // Checks that the single pass crop and scale gives the same picture as
+  // converting first and scaling after.
+  void TestCropAndScaleMatchesTwoPass(uint32_t fourcc,
+                                      int cropped_width,
+                                      int cropped_height,
+                                      int output_width,
+                                      int output_height) {
+    InitFrame(webrtc::kVideoRotation_0);
+    captured_frame_.fourcc = fourcc;
+    for (uint32_t i = 0; i < captured_frame_.data_size; ++i)
+      captured_frame_buffer_[i] = static_cast<uint8_t>(i * 7 + i / 1920);
+
+    const cricket::VideoFrameFactory& factory = factory_;
+    rtc::scoped_ptr<cricket::VideoFrame> frame(factory.CreateAliasedFrame(
+        &captured_frame_, cropped_width, cropped_height, output_width,
+        output_height));
+    rtc::scoped_ptr<cricket::VideoFrame> expected(
+        factory.VideoFrameFactory::CreateAliasedFrame(
+            &captured_frame_, cropped_width, cropped_height, output_width,
+            output_height));
+    ASSERT_TRUE(frame);
+    ASSERT_TRUE(expected);
+    EXPECT_EQ(captured_frame_.time_stamp, frame->GetTimeStamp());
+    EXPECT_TRUE(IsEqual(*expected, *frame, 0));
+  }
+
   const cricket::CapturedFrame& get_captured_frame() { return captured_frame_; }
 
  private:
@@ -122,3 +148,16 @@ TEST_F(WebRtcVideoFrameFactoryTest, NoApplyRotation) {
 TEST_F(WebRtcVideoFrameFactoryTest, ApplyRotation) {
   TestCreateAliasedFrame(true);
 }
+
+TEST_F(WebRtcVideoFrameFactoryTest, CropAndScaleI420) {
+  TestCropAndScaleMatchesTwoPass(cricket::FOURCC_I420, 1440, 1080, 640, 480);
+}
+
+TEST_F(WebRtcVideoFrameFactoryTest, CropAndScaleYV12) {
+  TestCropAndScaleMatchesTwoPass(cricket::FOURCC_YV12, 1440, 1080, 640, 480);
+}
+
+TEST_F(WebRtcVideoFrameFactoryTest, CropAndScaleToOtherAspectRatio) {
+  TestCropAndScaleMatchesTwoPass(cricket::FOURCC_I420, 1920, 1080, 640, 480);
+  TestCropAndScaleMatchesTwoPass(cricket::FOURCC_I420, 1440, 1080, 640, 360);
+}
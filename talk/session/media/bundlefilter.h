@@ -30,7 +30,7 @@
 
 #include <stdint.h>
 
-#include <set>
+#include <bitset>
 #include <vector>
 
 #include "talk/media/base/streamparams.h"
@@ -46,7 +46,8 @@ namespace cricket {
 //
 // This class determines whether a packet is destined for cricket::BaseChannel.
 // This is only to be used for RTP packets as RTCP packets are not filtered.
-// For RTP packets, this is decided based on the payload type.
+// For RTP packets, this is decided based on the payload type, which is looked
+// up in a bitmap since every channel on the bundle checks every packet.
 class BundleFilter {
  public:
   BundleFilter();
@@ -63,7 +64,8 @@ class BundleFilter {
   void ClearAllPayloadTypes();
 
  private:
-  std::set<int> payload_types_;
+  // RTP payload types are 7 bits.
+  std::bitset<128> payload_types_;
 };
 
 }  // namespace cricket
@@ -65,6 +65,9 @@ enum {
   MSG_DATARECEIVED,
   MSG_FIRSTPACKETRECEIVED,
   MSG_STREAMCLOSEDREMOTELY,
+  MSG_RECEIVEDPACKETS,
+  MSG_CHANGESTATE,
+  MSG_READYTOSEND,
 };
 
 // Value specified in RFC 5764.
@@ -79,7 +82,7 @@ static void SafeSetError(const std::string& message, std::string* error_desc) {
 }
 
 struct PacketMessageData : public rtc::MessageData {
-  rtc::Buffer packet;
+  rtc::CopyOnWriteBuffer packet;
   rtc::PacketOptions options;
 };
 
@@ -118,7 +121,8 @@ static const char* PacketType(bool rtcp) {
   return (!rtcp) ? "RTP" : "RTCP";
 }
 
-static bool ValidPacket(bool rtcp, const rtc::Buffer* packet) {
+template <class T>
+static bool ValidPacket(bool rtcp, const T* packet) {
   // Check the packet size. We could check the header too if needed.
   return (packet &&
           packet->size() >= (!rtcp ? kMinRtpPacketLen : kMinRtcpPacketLen) &&
@@ -166,12 +170,14 @@ void RtpSendParametersFromMediaDescription(
   send_params->max_bandwidth_bps = desc->bandwidth();
 }
 
-BaseChannel::BaseChannel(rtc::Thread* thread,
+BaseChannel::BaseChannel(rtc::Thread* worker_thread,
+                         rtc::Thread* network_thread,
                          MediaChannel* media_channel,
                          TransportController* transport_controller,
                          const std::string& content_name,
                          bool rtcp)
-    : worker_thread_(thread),
+    : worker_thread_(worker_thread),
+      network_thread_(network_thread),
       transport_controller_(transport_controller),
       media_channel_(media_channel),
       content_name_(content_name),
@@ -197,29 +203,32 @@ BaseChannel::~BaseChannel() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
   Deinit();
   StopConnectionMonitor();
-  FlushRtcpMessages();  // Send any outstanding RTCP packets.
   worker_thread_->Clear(this);  // eats any outstanding messages or packets
   // We must destroy the media channel before the transport channel, otherwise
   // the media channel may try to send on the dead transport channel. NULLing
   // is not an effective strategy since the sends will come on another thread.
   delete media_channel_;
-  // Note that we don't just call set_transport_channel(nullptr) because that
-  // would call a pure virtual method which we can't do from a destructor.
-  if (transport_channel_) {
-    DisconnectFromTransportChannel(transport_channel_);
-    transport_controller_->DestroyTransportChannel_w(
-        transport_name_, cricket::ICE_CANDIDATE_COMPONENT_RTP);
-  }
-  if (rtcp_transport_channel_) {
-    DisconnectFromTransportChannel(rtcp_transport_channel_);
-    transport_controller_->DestroyTransportChannel_w(
-        transport_name_, cricket::ICE_CANDIDATE_COMPONENT_RTCP);
-  }
+  network_thread_->Invoke<void>(
+      Bind(&BaseChannel::DestroyTransportChannels_n, this));
   LOG(LS_INFO) << "Destroyed channel";
 }
 
 bool BaseChannel::Init() {
-  if (!SetTransport(content_name())) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  if (!network_thread_->Invoke<bool>(
+          Bind(&BaseChannel::InitNetwork_n, this))) {
+    return false;
+  }
+
+  // Both RTP and RTCP channels are set, we can call SetInterface on
+  // media channel and it can set network options.
+  media_channel_->SetInterface(this);
+  return true;
+}
+
+bool BaseChannel::InitNetwork_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  if (!SetTransport_n(content_name())) {
     return false;
   }
 
@@ -230,24 +239,51 @@ bool BaseChannel::Init() {
       !SetDtlsSrtpCryptoSuites(rtcp_transport_channel(), true)) {
     return false;
   }
-
-  // Both RTP and RTCP channels are set, we can call SetInterface on
-  // media channel and it can set network options.
-  media_channel_->SetInterface(this);
   return true;
 }
 
 void BaseChannel::Deinit() {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
   media_channel_->SetInterface(NULL);
+  // Stop reading packets before the subclass goes away, since the network
+  // thread calls into it.
+  network_thread_->Invoke<void>(
+      Bind(&BaseChannel::DisconnectTransportChannels_n, this));
+}
+
+void BaseChannel::DisconnectTransportChannels_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  FlushRtcpMessages_n();  // Send any outstanding RTCP packets.
+  if (transport_channel_) {
+    DisconnectFromTransportChannel(transport_channel_);
+  }
+  if (rtcp_transport_channel_) {
+    DisconnectFromTransportChannel(rtcp_transport_channel_);
+  }
+}
+
+void BaseChannel::DestroyTransportChannels_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  network_thread_->Clear(this);
+  // Note that we don't just call set_transport_channel_n(nullptr) because that
+  // would call a pure virtual method which we can't do from a destructor.
+  if (transport_channel_) {
+    transport_controller_->DestroyTransportChannel_w(
+        transport_name_, cricket::ICE_CANDIDATE_COMPONENT_RTP);
+  }
+  if (rtcp_transport_channel_) {
+    transport_controller_->DestroyTransportChannel_w(
+        transport_name_, cricket::ICE_CANDIDATE_COMPONENT_RTCP);
+  }
 }
 
 bool BaseChannel::SetTransport(const std::string& transport_name) {
-  return worker_thread_->Invoke<bool>(
-      Bind(&BaseChannel::SetTransport_w, this, transport_name));
+  return network_thread_->Invoke<bool>(
+      Bind(&BaseChannel::SetTransport_n, this, transport_name));
 }
 
-bool BaseChannel::SetTransport_w(const std::string& transport_name) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+bool BaseChannel::SetTransport_n(const std::string& transport_name) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   if (transport_name == transport_name_) {
     // Nothing to do if transport name isn't changing
@@ -258,7 +294,7 @@ bool BaseChannel::SetTransport_w(const std::string& transport_name) {
   // changes and wait until the DTLS handshake is complete to set the newly
   // negotiated parameters.
   if (ShouldSetupDtlsSrtp()) {
-    // Set |writable_| to false such that UpdateWritableState_w can set up
+    // Set |writable_| to false such that UpdateWritableState_n can set up
     // DTLS-SRTP when the writable_ becomes true again.
     writable_ = false;
     srtp_filter_.ResetParams();
@@ -268,7 +304,7 @@ bool BaseChannel::SetTransport_w(const std::string& transport_name) {
   if (rtcp_transport_enabled()) {
     LOG(LS_INFO) << "Create RTCP TransportChannel for " << content_name()
                  << " on " << transport_name << " transport ";
-    set_rtcp_transport_channel(
+    set_rtcp_transport_channel_n(
         transport_controller_->CreateTransportChannel_w(
             transport_name, cricket::ICE_CANDIDATE_COMPONENT_RTCP),
         false /* update_writablity */);
@@ -278,7 +314,7 @@ bool BaseChannel::SetTransport_w(const std::string& transport_name) {
   }
 
   // We're not updating the writablity during the transition state.
-  set_transport_channel(transport_controller_->CreateTransportChannel_w(
+  set_transport_channel_n(transport_controller_->CreateTransportChannel_w(
       transport_name, cricket::ICE_CANDIDATE_COMPONENT_RTP));
   if (!transport_channel()) {
     return false;
@@ -286,7 +322,7 @@ bool BaseChannel::SetTransport_w(const std::string& transport_name) {
 
   // TODO(guoweis): Remove this grossness when we remove non-muxed RTCP.
   if (rtcp_transport_enabled()) {
-    // We can only update the RTCP ready to send after set_transport_channel has
+    // We can only update the RTCP ready to send after set_transport_channel_n has
     // handled channel writability.
     SetReadyToSend(
         true, rtcp_transport_channel() && rtcp_transport_channel()->writable());
@@ -295,8 +331,27 @@ bool BaseChannel::SetTransport_w(const std::string& transport_name) {
   return true;
 }
 
-void BaseChannel::set_transport_channel(TransportChannel* new_tc) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+bool BaseChannel::SetCryptoOptions(const rtc::CryptoOptions& crypto_options) {
+  return network_thread_->Invoke<bool>(
+      Bind(&BaseChannel::SetCryptoOptions_n, this, crypto_options));
+}
+
+bool BaseChannel::SetCryptoOptions_n(const rtc::CryptoOptions& crypto_options) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  crypto_options_ = crypto_options;
+  if (transport_channel() &&
+      !SetDtlsSrtpCryptoSuites(transport_channel(), false)) {
+    return false;
+  }
+  if (rtcp_transport_channel() &&
+      !SetDtlsSrtpCryptoSuites(rtcp_transport_channel(), true)) {
+    return false;
+  }
+  return true;
+}
+
+void BaseChannel::set_transport_channel_n(TransportChannel* new_tc) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   TransportChannel* old_tc = transport_channel_;
   if (!old_tc && !new_tc) {
@@ -322,13 +377,13 @@ void BaseChannel::set_transport_channel(TransportChannel* new_tc) {
 
   // Update aggregate writable/ready-to-send state between RTP and RTCP upon
   // setting new channel
-  UpdateWritableState_w();
+  UpdateWritableState_n();
   SetReadyToSend(false, new_tc && new_tc->writable());
 }
 
-void BaseChannel::set_rtcp_transport_channel(TransportChannel* new_tc,
-                                             bool update_writablity) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+void BaseChannel::set_rtcp_transport_channel_n(TransportChannel* new_tc,
+                                               bool update_writablity) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   TransportChannel* old_tc = rtcp_transport_channel_;
   if (!old_tc && !new_tc) {
@@ -358,13 +413,13 @@ void BaseChannel::set_rtcp_transport_channel(TransportChannel* new_tc,
   if (update_writablity) {
     // Update aggregate writable/ready-to-send state between RTP and RTCP upon
     // setting new channel
-    UpdateWritableState_w();
+    UpdateWritableState_n();
     SetReadyToSend(true, new_tc && new_tc->writable());
   }
 }
 
 void BaseChannel::ConnectToTransportChannel(TransportChannel* tc) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   tc->SignalWritableState.connect(this, &BaseChannel::OnWritableState);
   tc->SignalReadPacket.connect(this, &BaseChannel::OnChannelRead);
@@ -373,7 +428,7 @@ void BaseChannel::ConnectToTransportChannel(TransportChannel* tc) {
 }
 
 void BaseChannel::DisconnectFromTransportChannel(TransportChannel* tc) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   tc->SignalWritableState.disconnect(this);
   tc->SignalReadPacket.disconnect(this);
@@ -427,7 +482,7 @@ void BaseChannel::StartConnectionMonitor(int cms) {
   // because if the transport_channel_ changes, the ConnectionMonitor
   // would be pointing to the wrong TransportChannel.
   connection_monitor_.reset(new ConnectionMonitor(
-      this, worker_thread(), rtc::Thread::Current()));
+      this, network_thread(), rtc::Thread::Current()));
   connection_monitor_->SignalUpdate.connect(
       this, &BaseChannel::OnConnectionMonitorUpdate);
   connection_monitor_->Start(cms);
@@ -441,7 +496,7 @@ void BaseChannel::StopConnectionMonitor() {
 }
 
 bool BaseChannel::GetConnectionStats(ConnectionInfos* infos) {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(network_thread_ == rtc::Thread::Current());
   return transport_channel_->GetStats(infos);
 }
 
@@ -451,26 +506,40 @@ bool BaseChannel::IsReadyToReceive() const {
 }
 
 bool BaseChannel::IsReadyToSend() const {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
   // Send outgoing data if we are enabled, have local and remote content,
   // and we have had some form of connectivity.
   return enabled() && IsReceiveContentDirection(remote_content_direction_) &&
          IsSendContentDirection(local_content_direction_) &&
-         was_ever_writable() &&
+         network_thread_->Invoke<bool>(
+             Bind(&BaseChannel::IsTransportReadyToSend_n, this));
+}
+
+bool BaseChannel::IsTransportReadyToSend_n() const {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  return was_ever_writable() &&
          (srtp_filter_.IsActive() || !ShouldSetupDtlsSrtp());
 }
 
-bool BaseChannel::SendPacket(rtc::Buffer* packet,
+bool BaseChannel::SendPacket(rtc::CopyOnWriteBuffer* packet,
                              const rtc::PacketOptions& options) {
   return SendPacket(false, packet, options);
 }
 
-bool BaseChannel::SendRtcp(rtc::Buffer* packet,
+bool BaseChannel::SendRtcp(rtc::CopyOnWriteBuffer* packet,
                            const rtc::PacketOptions& options) {
   return SendPacket(true, packet, options);
 }
 
 int BaseChannel::SetOption(SocketType type, rtc::Socket::Option opt,
                            int value) {
+  return network_thread_->Invoke<int>(
+      Bind(&BaseChannel::SetOption_n, this, type, opt, value));
+}
+
+int BaseChannel::SetOption_n(SocketType type, rtc::Socket::Option opt,
+                             int value) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
   TransportChannel* channel = NULL;
   switch (type) {
     case ST_RTP:
@@ -489,7 +558,8 @@ int BaseChannel::SetOption(SocketType type, rtc::Socket::Option opt,
 
 void BaseChannel::OnWritableState(TransportChannel* channel) {
   ASSERT(channel == transport_channel_ || channel == rtcp_transport_channel_);
-  UpdateWritableState_w();
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  UpdateWritableState_n();
 }
 
 void BaseChannel::OnChannelRead(TransportChannel* channel,
@@ -498,7 +568,7 @@ void BaseChannel::OnChannelRead(TransportChannel* channel,
                                 int flags) {
   TRACE_EVENT0("webrtc", "BaseChannel::OnChannelRead");
   // OnChannelRead gets called from P2PSocket; now pass data to MediaEngine
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+  ASSERT(network_thread_ == rtc::Thread::Current());
 
   // When using RTCP multiplexing we might get RTCP packets on the RTP
   // transport. We feed RTP traffic into the demuxer to determine if it is RTCP.
@@ -519,7 +589,7 @@ void BaseChannel::OnDtlsState(TransportChannel* channel,
   }
 
   // Reset the srtp filter if it's not the CONNECTED state. For the CONNECTED
-  // state, setting up DTLS-SRTP context is deferred to ChannelWritable_w to
+  // state, setting up DTLS-SRTP context is deferred to ChannelWritable_n to
   // cover other scenarios like the whole channel is writable (not just this
   // TransportChannel) or when TransportChannel is attached after DTLS is
   // negotiated.
@@ -529,20 +599,23 @@ void BaseChannel::OnDtlsState(TransportChannel* channel,
 }
 
 void BaseChannel::SetReadyToSend(bool rtcp, bool ready) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
   if (rtcp) {
     rtcp_ready_to_send_ = ready;
   } else {
     rtp_ready_to_send_ = ready;
   }
 
-  if (rtp_ready_to_send_ &&
-      // In the case of rtcp mux |rtcp_transport_channel_| will be null.
-      (rtcp_ready_to_send_ || !rtcp_transport_channel_)) {
-    // Notify the MediaChannel when both rtp and rtcp channel can send.
-    media_channel_->OnReadyToSend(true);
+  // Notify the MediaChannel when both rtp and rtcp channel can send, or when
+  // either of them can't. In the case of rtcp mux |rtcp_transport_channel_|
+  // will be null.
+  bool ready_to_send = rtp_ready_to_send_ &&
+                       (rtcp_ready_to_send_ || !rtcp_transport_channel_);
+  if (network_thread_ == worker_thread_) {
+    media_channel_->OnReadyToSend(ready_to_send);
   } else {
-    // Notify the MediaChannel when either rtp or rtcp channel can't send.
-    media_channel_->OnReadyToSend(false);
+    worker_thread_->Post(this, MSG_READYTOSEND,
+                         new rtc::TypedMessageData<bool>(ready_to_send));
   }
 }
 
@@ -553,22 +626,36 @@ bool BaseChannel::PacketIsRtcp(const TransportChannel* channel,
 }
 
 bool BaseChannel::SendPacket(bool rtcp,
-                             rtc::Buffer* packet,
+                             rtc::CopyOnWriteBuffer* packet,
                              const rtc::PacketOptions& options) {
   // SendPacket gets called from MediaEngine, typically on an encoder thread.
-  // If the thread is not our worker thread, we will post to our worker
-  // so that the real work happens on our worker. This avoids us having to
+  // If the thread is not our network thread, we will post to our network
+  // thread so that the real work happens there. This avoids us having to
   // synchronize access to all the pieces of the send path, including
   // SRTP and the inner workings of the transport channels.
   // The only downside is that we can't return a proper failure code if
   // needed. Since UDP is unreliable anyway, this should be a non-issue.
-  if (rtc::Thread::Current() != worker_thread_) {
-    // Avoid a copy by transferring the ownership of the packet data.
-    int message_id = (!rtcp) ? MSG_RTPPACKET : MSG_RTCPPACKET;
+  if (rtc::Thread::Current() != network_thread_) {
+    // Hand the packet data over to the network thread without copying it.
+    if (!rtcp) {
+      // RTP packets tend to come in bursts from the pacer; queue them up so
+      // that the network thread protects and sends a whole burst at once.
+      bool post;
+      {
+        rtc::CritScope cs(&queued_rtp_packets_lock_);
+        post = queued_rtp_packets_.empty();
+        queued_rtp_packets_.push_back(QueuedRtpPacket());
+        queued_rtp_packets_.back().packet = std::move(*packet);
+        queued_rtp_packets_.back().options = options;
+      }
+      if (post)
+        network_thread_->Post(this, MSG_RTPPACKET);
+      return true;
+    }
     PacketMessageData* data = new PacketMessageData;
     data->packet = std::move(*packet);
     data->options = options;
-    worker_thread_->Post(this, message_id, data);
+    network_thread_->Post(this, MSG_RTCPPACKET, data);
     return true;
   }
 
@@ -595,6 +682,8 @@ bool BaseChannel::SendPacket(bool rtcp,
   // Protect if needed.
   if (srtp_filter_.IsActive()) {
     bool res;
+    // Protects in place; this only copies if the caller still shares the
+    // packet data.
     uint8_t* data = packet->data();
     int len = static_cast<int>(packet->size());
     if (!rtcp) {
@@ -607,22 +696,28 @@ bool BaseChannel::SendPacket(bool rtcp,
       res = srtp_filter_.ProtectRtp(
           data, len, static_cast<int>(packet->capacity()), &len);
 #else
-      updated_options.packet_time_params.rtp_sendtime_extension_id =
-          rtp_abs_sendtime_extn_id_;
-      res = srtp_filter_.ProtectRtp(
-          data, len, static_cast<int>(packet->capacity()), &len,
-          &updated_options.packet_time_params.srtp_packet_index);
-      // If protection succeeds, let's get auth params from srtp.
-      if (res) {
-        uint8_t* auth_key = NULL;
-        int key_len;
-        res = srtp_filter_.GetRtpAuthParams(
-            &auth_key, &key_len,
-            &updated_options.packet_time_params.srtp_auth_tag_len);
+      if (!srtp_filter_.IsExternalAuthActive()) {
+        // The GCM crypto suites are authenticated inside libsrtp.
+        res = srtp_filter_.ProtectRtp(
+            data, len, static_cast<int>(packet->capacity()), &len);
+      } else {
+        updated_options.packet_time_params.rtp_sendtime_extension_id =
+            rtp_abs_sendtime_extn_id_;
+        res = srtp_filter_.ProtectRtp(
+            data, len, static_cast<int>(packet->capacity()), &len,
+            &updated_options.packet_time_params.srtp_packet_index);
+        // If protection succeeds, let's get auth params from srtp.
         if (res) {
-          updated_options.packet_time_params.srtp_auth_key.resize(key_len);
-          updated_options.packet_time_params.srtp_auth_key.assign(
-              auth_key, auth_key + key_len);
+          uint8_t* auth_key = NULL;
+          int key_len;
+          res = srtp_filter_.GetRtpAuthParams(
+              &auth_key, &key_len,
+              &updated_options.packet_time_params.srtp_auth_tag_len);
+          if (res) {
+            updated_options.packet_time_params.srtp_auth_key.resize(key_len);
+            updated_options.packet_time_params.srtp_auth_key.assign(
+                auth_key, auth_key + key_len);
+          }
         }
       }
 #endif
@@ -661,10 +756,78 @@ bool BaseChannel::SendPacket(bool rtcp,
   }
 
   // Bon voyage.
+  return SendProtectedPacket_n(channel, rtcp, *packet, updated_options);
+}
+
+void BaseChannel::SendQueuedRtpPackets_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
+  {
+    rtc::CritScope cs(&queued_rtp_packets_lock_);
+    sending_rtp_packets_.swap(queued_rtp_packets_);
+  }
+
+#if !defined(ENABLE_EXTERNAL_AUTH)
+  // With external auth every packet needs its own auth params, so only
+  // batch when libsrtp does all of the work.
+  TransportChannel* channel = transport_channel_;
+  if (sending_rtp_packets_.size() > 1 && srtp_filter_.IsActive() && channel &&
+      channel->writable()) {
+    srtp_batch_.clear();
+    for (QueuedRtpPacket& queued : sending_rtp_packets_) {
+      rtc::CopyOnWriteBuffer* packet = &queued.packet;
+      if (!ValidPacket(false, packet)) {
+        LOG(LS_ERROR) << "Dropping outgoing " << content_name_ << " "
+                      << PacketType(false)
+                      << " packet: wrong size=" << packet->size();
+        srtp_batch_.push_back(SrtpPacket());
+        continue;
+      }
+      // Protects in place; this only copies if the caller still shares the
+      // packet data.
+      srtp_batch_.push_back(SrtpPacket(packet->data(),
+                                       static_cast<int>(packet->size()),
+                                       static_cast<int>(packet->capacity())));
+    }
+    srtp_filter_.ProtectRtpBatch(&srtp_batch_);
+
+    for (size_t i = 0; i < sending_rtp_packets_.size(); ++i) {
+      const SrtpPacket& protected_packet = srtp_batch_[i];
+      if (!protected_packet.data)
+        continue;
+      rtc::CopyOnWriteBuffer* packet = &sending_rtp_packets_[i].packet;
+      if (!protected_packet.ok) {
+        int seq_num = -1;
+        uint32_t ssrc = 0;
+        GetRtpSeqNum(packet->cdata(), packet->size(), &seq_num);
+        GetRtpSsrc(packet->cdata(), packet->size(), &ssrc);
+        LOG(LS_ERROR) << "Failed to protect " << content_name_
+                      << " RTP packet: size=" << packet->size()
+                      << ", seqnum=" << seq_num << ", SSRC=" << ssrc;
+        continue;
+      }
+      // Update the length of the packet now that we've added the auth tag.
+      packet->SetSize(protected_packet.len);
+      SendProtectedPacket_n(channel, false, *packet,
+                            sending_rtp_packets_[i].options);
+    }
+    sending_rtp_packets_.clear();
+    return;
+  }
+#endif
+
+  for (QueuedRtpPacket& queued : sending_rtp_packets_)
+    SendPacket(false, &queued.packet, queued.options);
+  sending_rtp_packets_.clear();
+}
+
+bool BaseChannel::SendProtectedPacket_n(TransportChannel* channel,
+                                        bool rtcp,
+                                        const rtc::CopyOnWriteBuffer& packet,
+                                        const rtc::PacketOptions& options) {
   int ret =
-      channel->SendPacket(packet->data<char>(), packet->size(), updated_options,
+      channel->SendPacket(packet.cdata<char>(), packet.size(), options,
                           (secure() && secure_dtls()) ? PF_SRTP_BYPASS : 0);
-  if (ret != static_cast<int>(packet->size())) {
+  if (ret != static_cast<int>(packet.size())) {
     if (channel->GetError() == EWOULDBLOCK) {
       LOG(LS_WARNING) << "Got EWOULDBLOCK from socket.";
       SetReadyToSend(rtcp, false);
@@ -749,11 +912,43 @@ void BaseChannel::HandlePacket(bool rtcp, rtc::Buffer* packet,
   }
 
   // Push it down to the media channel.
-  if (!rtcp) {
-    media_channel_->OnPacketReceived(packet, packet_time);
-  } else {
-    media_channel_->OnRtcpReceived(packet, packet_time);
+  if (network_thread_ == worker_thread_) {
+    if (!rtcp) {
+      media_channel_->OnPacketReceived(packet, packet_time);
+    } else {
+      media_channel_->OnRtcpReceived(packet, packet_time);
+    }
+    return;
+  }
+
+  // Hand the packet over to the worker, posting once per burst.
+  bool post;
+  {
+    rtc::CritScope cs(&received_packets_lock_);
+    post = received_packets_.empty();
+    received_packets_.push_back(ReceivedPacket());
+    received_packets_.back().rtcp = rtcp;
+    received_packets_.back().packet = std::move(*packet);
+    received_packets_.back().packet_time = packet_time;
   }
+  if (post)
+    worker_thread_->Post(this, MSG_RECEIVEDPACKETS);
+}
+
+void BaseChannel::DeliverReceivedPackets_w() {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  {
+    rtc::CritScope cs(&received_packets_lock_);
+    delivering_packets_.swap(received_packets_);
+  }
+  for (ReceivedPacket& received : delivering_packets_) {
+    if (!received.rtcp) {
+      media_channel_->OnPacketReceived(&received.packet, received.packet_time);
+    } else {
+      media_channel_->OnRtcpReceived(&received.packet, received.packet_time);
+    }
+  }
+  delivering_packets_.clear();
 }
 
 bool BaseChannel::PushdownLocalDescription(
@@ -804,17 +999,25 @@ void BaseChannel::DisableMedia_w() {
   ChangeState();
 }
 
-void BaseChannel::UpdateWritableState_w() {
+void BaseChannel::ChangeState_n() {
+  if (network_thread_ == worker_thread_) {
+    ChangeState();
+  } else {
+    worker_thread_->Post(this, MSG_CHANGESTATE);
+  }
+}
+
+void BaseChannel::UpdateWritableState_n() {
   if (transport_channel_ && transport_channel_->writable() &&
       (!rtcp_transport_channel_ || rtcp_transport_channel_->writable())) {
-    ChannelWritable_w();
+    ChannelWritable_n();
   } else {
-    ChannelNotWritable_w();
+    ChannelNotWritable_n();
   }
 }
 
-void BaseChannel::ChannelWritable_w() {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+void BaseChannel::ChannelWritable_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
   if (writable_) {
     return;
   }
@@ -834,13 +1037,13 @@ void BaseChannel::ChannelWritable_w() {
   }
 
   was_ever_writable_ = true;
-  MaybeSetupDtlsSrtp_w();
+  MaybeSetupDtlsSrtp_n();
   writable_ = true;
-  ChangeState();
+  ChangeState_n();
 }
 
-void BaseChannel::SignalDtlsSetupFailure_w(bool rtcp) {
-  ASSERT(worker_thread() == rtc::Thread::Current());
+void BaseChannel::SignalDtlsSetupFailure_n(bool rtcp) {
+  ASSERT(network_thread() == rtc::Thread::Current());
   signaling_thread()->Invoke<void>(Bind(
       &BaseChannel::SignalDtlsSetupFailure_s, this, rtcp));
 }
@@ -857,7 +1060,7 @@ bool BaseChannel::SetDtlsSrtpCryptoSuites(TransportChannel* tc, bool rtcp) {
   if (!rtcp) {
     GetSrtpCryptoSuites(&crypto_suites);
   } else {
-    GetDefaultSrtpCryptoSuites(&crypto_suites);
+    GetDefaultSrtpCryptoSuites(crypto_options(), &crypto_suites);
   }
   return tc->SetSrtpCryptoSuites(crypto_suites);
 }
@@ -869,7 +1072,7 @@ bool BaseChannel::ShouldSetupDtlsSrtp() const {
 
 // This function returns true if either DTLS-SRTP is not in use
 // *or* DTLS-SRTP is successfully set up.
-bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
+bool BaseChannel::SetupDtlsSrtp_n(bool rtcp_channel) {
   bool ret = false;
 
   TransportChannel* channel =
@@ -888,9 +1091,16 @@ bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
                << content_name() << " "
                << PacketType(rtcp_channel);
 
+  int key_len;
+  int salt_len;
+  if (!rtc::GetSrtpKeyAndSaltLengths(selected_crypto_suite, &key_len,
+      &salt_len)) {
+    LOG(LS_ERROR) << "Unknown DTLS-SRTP crypto suite" << selected_crypto_suite;
+    return false;
+  }
+
   // OK, we're now doing DTLS (RFC 5764)
-  std::vector<unsigned char> dtls_buffer(SRTP_MASTER_KEY_KEY_LEN * 2 +
-                                         SRTP_MASTER_KEY_SALT_LEN * 2);
+  std::vector<unsigned char> dtls_buffer(key_len * 2 + salt_len * 2);
 
   // RFC 5705 exporter using the RFC 5764 parameters
   if (!channel->ExportKeyingMaterial(
@@ -903,22 +1113,16 @@ bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
   }
 
   // Sync up the keys with the DTLS-SRTP interface
-  std::vector<unsigned char> client_write_key(SRTP_MASTER_KEY_KEY_LEN +
-    SRTP_MASTER_KEY_SALT_LEN);
-  std::vector<unsigned char> server_write_key(SRTP_MASTER_KEY_KEY_LEN +
-    SRTP_MASTER_KEY_SALT_LEN);
+  std::vector<unsigned char> client_write_key(key_len + salt_len);
+  std::vector<unsigned char> server_write_key(key_len + salt_len);
   size_t offset = 0;
-  memcpy(&client_write_key[0], &dtls_buffer[offset],
-    SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(&server_write_key[0], &dtls_buffer[offset],
-    SRTP_MASTER_KEY_KEY_LEN);
-  offset += SRTP_MASTER_KEY_KEY_LEN;
-  memcpy(&client_write_key[SRTP_MASTER_KEY_KEY_LEN],
-    &dtls_buffer[offset], SRTP_MASTER_KEY_SALT_LEN);
-  offset += SRTP_MASTER_KEY_SALT_LEN;
-  memcpy(&server_write_key[SRTP_MASTER_KEY_KEY_LEN],
-    &dtls_buffer[offset], SRTP_MASTER_KEY_SALT_LEN);
+  memcpy(&client_write_key[0], &dtls_buffer[offset], key_len);
+  offset += key_len;
+  memcpy(&server_write_key[0], &dtls_buffer[offset], key_len);
+  offset += key_len;
+  memcpy(&client_write_key[key_len], &dtls_buffer[offset], salt_len);
+  offset += salt_len;
+  memcpy(&server_write_key[key_len], &dtls_buffer[offset], salt_len);
 
   std::vector<unsigned char> *send_key, *recv_key;
   rtc::SSLRole role;
@@ -955,7 +1159,7 @@ bool BaseChannel::SetupDtlsSrtp(bool rtcp_channel) {
   return ret;
 }
 
-void BaseChannel::MaybeSetupDtlsSrtp_w() {
+void BaseChannel::MaybeSetupDtlsSrtp_n() {
   if (srtp_filter_.IsActive()) {
     return;
   }
@@ -964,27 +1168,27 @@ void BaseChannel::MaybeSetupDtlsSrtp_w() {
     return;
   }
 
-  if (!SetupDtlsSrtp(false)) {
-    SignalDtlsSetupFailure_w(false);
+  if (!SetupDtlsSrtp_n(false)) {
+    SignalDtlsSetupFailure_n(false);
     return;
   }
 
   if (rtcp_transport_channel_) {
-    if (!SetupDtlsSrtp(true)) {
-      SignalDtlsSetupFailure_w(true);
+    if (!SetupDtlsSrtp_n(true)) {
+      SignalDtlsSetupFailure_n(true);
       return;
     }
   }
 }
 
-void BaseChannel::ChannelNotWritable_w() {
-  ASSERT(worker_thread_ == rtc::Thread::Current());
+void BaseChannel::ChannelNotWritable_n() {
+  ASSERT(network_thread_ == rtc::Thread::Current());
   if (!writable_)
     return;
 
   LOG(LS_INFO) << "Channel not writable (" << content_name_ << ")";
   writable_ = false;
-  ChangeState();
+  ChangeState_n();
 }
 
 bool BaseChannel::SetRtpTransportParameters_w(
@@ -992,6 +1196,18 @@ bool BaseChannel::SetRtpTransportParameters_w(
     ContentAction action,
     ContentSource src,
     std::string* error_desc) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  return network_thread_->Invoke<bool>(
+      Bind(&BaseChannel::SetRtpTransportParameters_n, this, content, action,
+           src, error_desc));
+}
+
+bool BaseChannel::SetRtpTransportParameters_n(
+    const MediaContentDescription* content,
+    ContentAction action,
+    ContentSource src,
+    std::string* error_desc) {
+  ASSERT(network_thread_ == rtc::Thread::Current());
   if (action == CA_UPDATE) {
     // These parameters never get changed by a CA_UDPATE.
     return true;
@@ -1002,11 +1218,11 @@ bool BaseChannel::SetRtpTransportParameters_w(
     set_secure_required(content->crypto_required() != CT_NONE);
   }
 
-  if (!SetSrtp_w(content->cryptos(), action, src, error_desc)) {
+  if (!SetSrtp_n(content->cryptos(), action, src, error_desc)) {
     return false;
   }
 
-  if (!SetRtcpMux_w(content->rtcp_mux(), action, src, error_desc)) {
+  if (!SetRtcpMux_n(content->rtcp_mux(), action, src, error_desc)) {
     return false;
   }
 
@@ -1015,9 +1231,9 @@ bool BaseChannel::SetRtpTransportParameters_w(
 
 // |dtls| will be set to true if DTLS is active for transport channel and
 // crypto is empty.
-bool BaseChannel::CheckSrtpConfig(const std::vector<CryptoParams>& cryptos,
-                                  bool* dtls,
-                                  std::string* error_desc) {
+bool BaseChannel::CheckSrtpConfig_n(const std::vector<CryptoParams>& cryptos,
+                                    bool* dtls,
+                                    std::string* error_desc) {
   *dtls = transport_channel_->IsDtlsActive();
   if (*dtls && !cryptos.empty()) {
     SafeSetError("Cryptos must be empty when DTLS is active.",
@@ -1027,7 +1243,7 @@ bool BaseChannel::CheckSrtpConfig(const std::vector<CryptoParams>& cryptos,
   return true;
 }
 
-bool BaseChannel::SetSrtp_w(const std::vector<CryptoParams>& cryptos,
+bool BaseChannel::SetSrtp_n(const std::vector<CryptoParams>& cryptos,
                             ContentAction action,
                             ContentSource src,
                             std::string* error_desc) {
@@ -1037,7 +1253,7 @@ bool BaseChannel::SetSrtp_w(const std::vector<CryptoParams>& cryptos,
   }
   bool ret = false;
   bool dtls = false;
-  ret = CheckSrtpConfig(cryptos, &dtls, error_desc);
+  ret = CheckSrtpConfig_n(cryptos, &dtls, error_desc);
   if (!ret) {
     return false;
   }
@@ -1074,19 +1290,19 @@ bool BaseChannel::SetSrtp_w(const std::vector<CryptoParams>& cryptos,
 }
 
 void BaseChannel::ActivateRtcpMux() {
-  worker_thread_->Invoke<void>(Bind(
-      &BaseChannel::ActivateRtcpMux_w, this));
+  network_thread_->Invoke<void>(Bind(
+      &BaseChannel::ActivateRtcpMux_n, this));
 }
 
-void BaseChannel::ActivateRtcpMux_w() {
+void BaseChannel::ActivateRtcpMux_n() {
   if (!rtcp_mux_filter_.IsActive()) {
     rtcp_mux_filter_.SetActive();
-    set_rtcp_transport_channel(nullptr, true);
+    set_rtcp_transport_channel_n(nullptr, true);
     rtcp_transport_enabled_ = false;
   }
 }
 
-bool BaseChannel::SetRtcpMux_w(bool enable, ContentAction action,
+bool BaseChannel::SetRtcpMux_n(bool enable, ContentAction action,
                                ContentSource src,
                                std::string* error_desc) {
   bool ret = false;
@@ -1104,7 +1320,7 @@ bool BaseChannel::SetRtcpMux_w(bool enable, ContentAction action,
         LOG(LS_INFO) << "Enabling rtcp-mux for " << content_name()
                      << " by destroying RTCP transport channel for "
                      << transport_name();
-        set_rtcp_transport_channel(nullptr, true);
+        set_rtcp_transport_channel_n(nullptr, true);
         rtcp_transport_enabled_ = false;
       }
       break;
@@ -1125,7 +1341,7 @@ bool BaseChannel::SetRtcpMux_w(bool enable, ContentAction action,
   if (rtcp_mux_filter_.IsActive()) {
     // If the RTP transport is already writable, then so are we.
     if (transport_channel_->writable()) {
-      ChannelWritable_w();
+      ChannelWritable_n();
     }
   }
 
@@ -1289,22 +1505,33 @@ bool BaseChannel::UpdateRemoteStreams_w(
   return ret;
 }
 
-void BaseChannel::MaybeCacheRtpAbsSendTimeHeaderExtension(
+void BaseChannel::MaybeCacheRtpAbsSendTimeHeaderExtension_w(
     const std::vector<RtpHeaderExtension>& extensions) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
   const RtpHeaderExtension* send_time_extension =
       FindHeaderExtension(extensions, kRtpAbsoluteSenderTimeHeaderExtension);
-  rtp_abs_sendtime_extn_id_ =
+  int rtp_abs_sendtime_extn_id =
       send_time_extension ? send_time_extension->id : -1;
+  network_thread_->Invoke<void>(
+      Bind(&BaseChannel::CacheRtpAbsSendTimeHeaderExtension_n, this,
+           rtp_abs_sendtime_extn_id));
+}
+
+void BaseChannel::CacheRtpAbsSendTimeHeaderExtension_n(
+    int rtp_abs_sendtime_extn_id) {
+  rtp_abs_sendtime_extn_id_ = rtp_abs_sendtime_extn_id;
 }
 
 void BaseChannel::OnMessage(rtc::Message *pmsg) {
   TRACE_EVENT0("webrtc", "BaseChannel::OnMessage");
   switch (pmsg->message_id) {
-    case MSG_RTPPACKET:
+    case MSG_RTPPACKET: {
+      SendQueuedRtpPackets_n();
+      break;
+    }
     case MSG_RTCPPACKET: {
       PacketMessageData* data = static_cast<PacketMessageData*>(pmsg->pdata);
-      SendPacket(pmsg->message_id == MSG_RTCPPACKET, &data->packet,
-                 data->options);
+      SendPacket(true, &data->packet, data->options);
       delete data;  // because it is Posted
       break;
     }
@@ -1312,28 +1539,45 @@ void BaseChannel::OnMessage(rtc::Message *pmsg) {
       SignalFirstPacketReceived(this);
       break;
     }
+    case MSG_RECEIVEDPACKETS: {
+      DeliverReceivedPackets_w();
+      break;
+    }
+    case MSG_CHANGESTATE: {
+      ChangeState();
+      break;
+    }
+    case MSG_READYTOSEND: {
+      rtc::TypedMessageData<bool>* data =
+          static_cast<rtc::TypedMessageData<bool>*>(pmsg->pdata);
+      media_channel_->OnReadyToSend(data->data());
+      delete data;
+      break;
+    }
   }
 }
 
-void BaseChannel::FlushRtcpMessages() {
-  // Flush all remaining RTCP messages. This should only be called in
-  // destructor.
-  ASSERT(rtc::Thread::Current() == worker_thread_);
+void BaseChannel::FlushRtcpMessages_n() {
+  // Flush all remaining RTCP messages. This should only be called when the
+  // channel is being torn down.
+  ASSERT(rtc::Thread::Current() == network_thread_);
   rtc::MessageList rtcp_messages;
-  worker_thread_->Clear(this, MSG_RTCPPACKET, &rtcp_messages);
+  network_thread_->Clear(this, MSG_RTCPPACKET, &rtcp_messages);
   for (rtc::MessageList::iterator it = rtcp_messages.begin();
        it != rtcp_messages.end(); ++it) {
-    worker_thread_->Send(this, MSG_RTCPPACKET, it->pdata);
+    network_thread_->Send(this, MSG_RTCPPACKET, it->pdata);
   }
 }
 
-VoiceChannel::VoiceChannel(rtc::Thread* thread,
+VoiceChannel::VoiceChannel(rtc::Thread* worker_thread,
+                           rtc::Thread* network_thread,
                            MediaEngineInterface* media_engine,
                            VoiceMediaChannel* media_channel,
                            TransportController* transport_controller,
                            const std::string& content_name,
                            bool rtcp)
-    : BaseChannel(thread,
+    : BaseChannel(worker_thread,
+                  network_thread,
                   media_channel,
                   transport_controller,
                   content_name,
@@ -1578,7 +1822,7 @@ bool VoiceChannel::SetRemoteContent_w(const MediaContentDescription* content,
   }
 
   if (audio->rtp_header_extensions_set()) {
-    MaybeCacheRtpAbsSendTimeHeaderExtension(audio->rtp_header_extensions());
+    MaybeCacheRtpAbsSendTimeHeaderExtension_w(audio->rtp_header_extensions());
   }
 
   set_remote_content_direction(content->direction());
@@ -1637,15 +1881,17 @@ void VoiceChannel::OnAudioMonitorUpdate(AudioMonitor* monitor,
 }
 
 void VoiceChannel::GetSrtpCryptoSuites(std::vector<int>* crypto_suites) const {
-  GetSupportedAudioCryptoSuites(crypto_suites);
+  GetSupportedAudioCryptoSuites(crypto_options(), crypto_suites);
 }
 
-VideoChannel::VideoChannel(rtc::Thread* thread,
+VideoChannel::VideoChannel(rtc::Thread* worker_thread,
+                           rtc::Thread* network_thread,
                            VideoMediaChannel* media_channel,
                            TransportController* transport_controller,
                            const std::string& content_name,
                            bool rtcp)
-    : BaseChannel(thread,
+    : BaseChannel(worker_thread,
+                  network_thread,
                   media_channel,
                   transport_controller,
                   content_name,
@@ -1850,7 +2096,7 @@ bool VideoChannel::SetRemoteContent_w(const MediaContentDescription* content,
   }
 
   if (video->rtp_header_extensions_set()) {
-    MaybeCacheRtpAbsSendTimeHeaderExtension(video->rtp_header_extensions());
+    MaybeCacheRtpAbsSendTimeHeaderExtension_w(video->rtp_header_extensions());
   }
 
   set_remote_content_direction(content->direction());
@@ -2002,15 +2248,17 @@ bool VideoChannel::GetLocalSsrc(const VideoCapturer* capturer, uint32_t* ssrc) {
 }
 
 void VideoChannel::GetSrtpCryptoSuites(std::vector<int>* crypto_suites) const {
-  GetSupportedVideoCryptoSuites(crypto_suites);
+  GetSupportedVideoCryptoSuites(crypto_options(), crypto_suites);
 }
 
-DataChannel::DataChannel(rtc::Thread* thread,
+DataChannel::DataChannel(rtc::Thread* worker_thread,
+                         rtc::Thread* network_thread,
                          DataMediaChannel* media_channel,
                          TransportController* transport_controller,
                          const std::string& content_name,
                          bool rtcp)
-    : BaseChannel(thread,
+    : BaseChannel(worker_thread,
+                  network_thread,
                   media_channel,
                   transport_controller,
                   content_name,
@@ -2042,8 +2290,37 @@ bool DataChannel::Init() {
 bool DataChannel::SendData(const SendDataParams& params,
                            const rtc::Buffer& payload,
                            SendDataResult* result) {
-  return InvokeOnWorker(Bind(&DataMediaChannel::SendData,
-                             media_channel(), params, payload, result));
+  // Pass the payload by pointer, since the functor would copy it otherwise.
+  return InvokeOnWorker(Bind(&DataChannel::SendData_w, this, params, &payload,
+                             result));
+}
+
+size_t DataChannel::SendDataBatch(
+    const std::vector<SendDataParams>& params,
+    const std::vector<const rtc::Buffer*>& payloads,
+    SendDataResult* result) {
+  RTC_DCHECK_EQ(params.size(), payloads.size());
+  return worker_thread()->Invoke<size_t>(Bind(
+      &DataChannel::SendDataBatch_w, this, &params, &payloads, result));
+}
+
+bool DataChannel::SendData_w(const SendDataParams& params,
+                             const rtc::Buffer* payload,
+                             SendDataResult* result) {
+  return media_channel()->SendData(params, *payload, result);
+}
+
+size_t DataChannel::SendDataBatch_w(
+    const std::vector<SendDataParams>* params,
+    const std::vector<const rtc::Buffer*>* payloads,
+    SendDataResult* result) {
+  size_t sent = 0;
+  while (sent < params->size() &&
+         media_channel()->SendData((*params)[sent], *(*payloads)[sent],
+                                   result)) {
+    ++sent;
+  }
+  return sent;
 }
 
 const ContentInfo* DataChannel::GetFirstContent(
@@ -2290,6 +2567,10 @@ void DataChannel::OnMediaMonitorUpdate(
 
 void DataChannel::OnDataReceived(
     const ReceiveDataParams& params, const char* data, size_t len) {
+  if (!SignalDataReceivedOnWorker.is_empty()) {
+    SignalDataReceivedOnWorker(this, params, data, len);
+    return;
+  }
   DataReceivedMessageData* msg = new DataReceivedMessageData(
       params, data, len);
   signaling_thread()->Post(this, MSG_DATARECEIVED, msg);
@@ -2311,7 +2592,7 @@ void DataChannel::OnDataChannelReadyToSend(bool writable) {
 }
 
 void DataChannel::GetSrtpCryptoSuites(std::vector<int>* crypto_suites) const {
-  GetSupportedDataCryptoSuites(crypto_suites);
+  GetSupportedDataCryptoSuites(crypto_options(), crypto_suites);
 }
 
 bool DataChannel::ShouldSetupDtlsSrtp() const {
@@ -46,6 +46,7 @@
 #include "talk/session/media/srtpfilter.h"
 #include "webrtc/audio/audio_sink.h"
 #include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/network.h"
 #include "webrtc/base/sigslot.h"
@@ -72,6 +73,13 @@ enum SinkType {
 // enable, marshaling calls to a worker thread, and
 // connection and media monitors.
 //
+// BaseChannel runs on two threads, which may be the same. The worker thread
+// owns the media channel; methods ending in _w run there. The network thread
+// owns the transport channels and handles packet I/O, SRTP and the transport
+// state; methods ending in _n run there. Received packets and transport state
+// changes are posted from the network thread to the worker thread, so that
+// slow media work never delays reading packets.
+//
 // WARNING! SUBCLASSES MUST CALL Deinit() IN THEIR DESTRUCTORS!
 // This is required to avoid a data race between the destructor modifying the
 // vtable, and the media channel's thread using BaseChannel as the
@@ -82,7 +90,8 @@ class BaseChannel
       public MediaChannel::NetworkInterface,
       public ConnectionStatsGetter {
  public:
-  BaseChannel(rtc::Thread* thread,
+  BaseChannel(rtc::Thread* worker_thread,
+              rtc::Thread* network_thread,
               MediaChannel* channel,
               TransportController* transport_controller,
               const std::string& content_name,
@@ -94,6 +103,7 @@ class BaseChannel
   void Deinit();
 
   rtc::Thread* worker_thread() const { return worker_thread_; }
+  rtc::Thread* network_thread() const { return network_thread_; }
   const std::string& content_name() const { return content_name_; }
   const std::string& transport_name() const { return transport_name_; }
   TransportChannel* transport_channel() const {
@@ -121,6 +131,9 @@ class BaseChannel
   // description will fail.
   void ActivateRtcpMux();
   bool SetTransport(const std::string& transport_name);
+  // Sets the SRTP crypto suites to offer in the DTLS-SRTP handshake. Has no
+  // effect once the handshake has started.
+  bool SetCryptoOptions(const rtc::CryptoOptions& crypto_options);
   bool PushdownLocalDescription(const SessionDescription* local_desc,
                                 ContentAction action,
                                 std::string* error_desc);
@@ -159,13 +172,13 @@ class BaseChannel
   }
 
   sigslot::signal2<BaseChannel*, bool> SignalDtlsSetupFailure;
-  void SignalDtlsSetupFailure_w(bool rtcp);
+  void SignalDtlsSetupFailure_n(bool rtcp);
   void SignalDtlsSetupFailure_s(bool rtcp);
 
   // Used for latency measurements.
   sigslot::signal1<BaseChannel*> SignalFirstPacketReceived;
 
-  // Made public for easier testing.
+  // Made public for easier testing. Must be called on the network thread.
   void SetReadyToSend(bool rtcp, bool ready);
 
   // Only public for unit tests.  Otherwise, consider protected.
@@ -176,13 +189,17 @@ class BaseChannel
 
  protected:
   virtual MediaChannel* media_channel() const { return media_channel_; }
+  bool InitNetwork_n();
+  void DisconnectTransportChannels_n();
+  void DestroyTransportChannels_n();
   // Sets the |transport_channel_| (and |rtcp_transport_channel_|, if |rtcp_| is
   // true). Gets the transport channels from |transport_controller_|.
-  bool SetTransport_w(const std::string& transport_name);
+  bool SetTransport_n(const std::string& transport_name);
+  bool SetCryptoOptions_n(const rtc::CryptoOptions& crypto_options);
 
-  void set_transport_channel(TransportChannel* transport);
-  void set_rtcp_transport_channel(TransportChannel* transport,
-                                  bool update_writablity);
+  void set_transport_channel_n(TransportChannel* transport);
+  void set_rtcp_transport_channel_n(TransportChannel* transport,
+                                    bool update_writablity);
 
   bool was_ever_writable() const { return was_ever_writable_; }
   void set_local_content_direction(MediaContentDirection direction) {
@@ -195,7 +212,10 @@ class BaseChannel
     secure_required_ = secure_required;
   }
   bool IsReadyToReceive() const;
+  // Must be called on the worker thread; asks the network thread whether the
+  // transport is ready.
   bool IsReadyToSend() const;
+  bool IsTransportReadyToSend_n() const;
   rtc::Thread* signaling_thread() {
     return transport_controller_->signaling_thread();
   }
@@ -204,13 +224,13 @@ class BaseChannel
   void ConnectToTransportChannel(TransportChannel* tc);
   void DisconnectFromTransportChannel(TransportChannel* tc);
 
-  void FlushRtcpMessages();
+  void FlushRtcpMessages_n();
 
   // NetworkInterface implementation, called by MediaEngine
-  bool SendPacket(rtc::Buffer* packet,
-                          const rtc::PacketOptions& options) override;
-  bool SendRtcp(rtc::Buffer* packet, const rtc::PacketOptions& options)
-      override;
+  bool SendPacket(rtc::CopyOnWriteBuffer* packet,
+                  const rtc::PacketOptions& options) override;
+  bool SendRtcp(rtc::CopyOnWriteBuffer* packet,
+                const rtc::PacketOptions& options) override;
 
   // From TransportChannel
   void OnWritableState(TransportChannel* channel);
@@ -226,17 +246,30 @@ class BaseChannel
   bool PacketIsRtcp(const TransportChannel* channel, const char* data,
                     size_t len);
   bool SendPacket(bool rtcp,
-                  rtc::Buffer* packet,
+                  rtc::CopyOnWriteBuffer* packet,
                   const rtc::PacketOptions& options);
+  // Sends the RTP packets queued by SendPacket on other threads, protecting
+  // them as one batch.
+  void SendQueuedRtpPackets_n();
+  // Sends an already protected packet on |channel|.
+  bool SendProtectedPacket_n(TransportChannel* channel,
+                             bool rtcp,
+                             const rtc::CopyOnWriteBuffer& packet,
+                             const rtc::PacketOptions& options);
   virtual bool WantsPacket(bool rtcp, rtc::Buffer* packet);
   void HandlePacket(bool rtcp, rtc::Buffer* packet,
                     const rtc::PacketTime& packet_time);
+  // Hands the unprotected packets queued by HandlePacket to the media
+  // channel.
+  void DeliverReceivedPackets_w();
+  // Calls ChangeState() on the worker thread.
+  void ChangeState_n();
 
   void EnableMedia_w();
   void DisableMedia_w();
-  void UpdateWritableState_w();
-  void ChannelWritable_w();
-  void ChannelNotWritable_w();
+  void UpdateWritableState_n();
+  void ChannelWritable_n();
+  void ChannelNotWritable_n();
   bool AddRecvStream_w(const StreamParams& sp);
   bool RemoveRecvStream_w(uint32_t ssrc);
   bool AddSendStream_w(const StreamParams& sp);
@@ -244,8 +277,8 @@ class BaseChannel
   virtual bool ShouldSetupDtlsSrtp() const;
   // Do the DTLS key expansion and impose it on the SRTP/SRTCP filters.
   // |rtcp_channel| indicates whether to set up the RTP or RTCP filter.
-  bool SetupDtlsSrtp(bool rtcp_channel);
-  void MaybeSetupDtlsSrtp_w();
+  bool SetupDtlsSrtp_n(bool rtcp_channel);
+  void MaybeSetupDtlsSrtp_n();
   // Set the DTLS-SRTP cipher policy on this channel as appropriate.
   bool SetDtlsSrtpCryptoSuites(TransportChannel* tc, bool rtcp);
 
@@ -270,28 +303,36 @@ class BaseChannel
                                    ContentAction action,
                                    ContentSource src,
                                    std::string* error_desc);
+  bool SetRtpTransportParameters_n(const MediaContentDescription* content,
+                                   ContentAction action,
+                                   ContentSource src,
+                                   std::string* error_desc);
 
   // Helper method to get RTP Absoulute SendTime extension header id if
   // present in remote supported extensions list.
-  void MaybeCacheRtpAbsSendTimeHeaderExtension(
+  void MaybeCacheRtpAbsSendTimeHeaderExtension_w(
       const std::vector<RtpHeaderExtension>& extensions);
+  void CacheRtpAbsSendTimeHeaderExtension_n(int rtp_abs_sendtime_extn_id);
 
-  bool CheckSrtpConfig(const std::vector<CryptoParams>& cryptos,
-                       bool* dtls,
-                       std::string* error_desc);
-  bool SetSrtp_w(const std::vector<CryptoParams>& params,
+  bool CheckSrtpConfig_n(const std::vector<CryptoParams>& cryptos,
+                         bool* dtls,
+                         std::string* error_desc);
+  bool SetSrtp_n(const std::vector<CryptoParams>& params,
                  ContentAction action,
                  ContentSource src,
                  std::string* error_desc);
-  void ActivateRtcpMux_w();
-  bool SetRtcpMux_w(bool enable,
+  void ActivateRtcpMux_n();
+  bool SetRtcpMux_n(bool enable,
                     ContentAction action,
                     ContentSource src,
                     std::string* error_desc);
+  int SetOption_n(SocketType type, rtc::Socket::Option opt, int value);
 
   // From MessageHandler
   void OnMessage(rtc::Message* pmsg) override;
 
+  const rtc::CryptoOptions& crypto_options() const { return crypto_options_; }
+
   // Handled in derived classes
   // Get the SRTP crypto suites to use for RTP media
   virtual void GetSrtpCryptoSuites(std::vector<int>* crypto_suites) const = 0;
@@ -305,7 +346,18 @@ class BaseChannel
   }
 
  private:
-  rtc::Thread* worker_thread_;
+  struct QueuedRtpPacket {
+    rtc::CopyOnWriteBuffer packet;
+    rtc::PacketOptions options;
+  };
+  struct ReceivedPacket {
+    bool rtcp;
+    rtc::Buffer packet;
+    rtc::PacketTime packet_time;
+  };
+
+  rtc::Thread* const worker_thread_;
+  rtc::Thread* const network_thread_;
   TransportController* transport_controller_;
   MediaChannel* media_channel_;
   std::vector<StreamParams> local_streams_;
@@ -319,6 +371,21 @@ class BaseChannel
   TransportChannel* rtcp_transport_channel_;
   std::vector<std::pair<rtc::Socket::Option, int> > rtcp_socket_options_;
   SrtpFilter srtp_filter_;
+  // RTP packets sent from other threads are queued here, and a single
+  // message is posted to the network thread for each burst.
+  rtc::CriticalSection queued_rtp_packets_lock_;
+  std::vector<QueuedRtpPacket> queued_rtp_packets_
+      GUARDED_BY(queued_rtp_packets_lock_);
+  // Used on the network thread only. Kept around to not reallocate per burst.
+  std::vector<QueuedRtpPacket> sending_rtp_packets_;
+  std::vector<SrtpPacket> srtp_batch_;
+  // Packets received on the network thread wait here for the worker thread,
+  // with a single message posted for each burst.
+  rtc::CriticalSection received_packets_lock_;
+  std::vector<ReceivedPacket> received_packets_
+      GUARDED_BY(received_packets_lock_);
+  // Used on the worker thread only.
+  std::vector<ReceivedPacket> delivering_packets_;
   RtcpMuxFilter rtcp_mux_filter_;
   BundleFilter bundle_filter_;
   rtc::scoped_ptr<ConnectionMonitor> connection_monitor_;
@@ -332,6 +399,7 @@ class BaseChannel
   bool has_received_packet_;
   bool dtls_keyed_;
   bool secure_required_;
+  rtc::CryptoOptions crypto_options_;
   int rtp_abs_sendtime_extn_id_;
 };
 
@@ -339,7 +407,8 @@ class BaseChannel
 // and input/output level monitoring.
 class VoiceChannel : public BaseChannel {
  public:
-  VoiceChannel(rtc::Thread* thread,
+  VoiceChannel(rtc::Thread* worker_thread,
+               rtc::Thread* network_thread,
                MediaEngineInterface* media_engine,
                VoiceMediaChannel* channel,
                TransportController* transport_controller,
@@ -442,7 +511,8 @@ class VoiceChannel : public BaseChannel {
 // VideoChannel is a specialization for video.
 class VideoChannel : public BaseChannel {
  public:
-  VideoChannel(rtc::Thread* thread,
+  VideoChannel(rtc::Thread* worker_thread,
+               rtc::Thread* network_thread,
                VideoMediaChannel* channel,
                TransportController* transport_controller,
                const std::string& content_name,
@@ -530,7 +600,8 @@ class VideoChannel : public BaseChannel {
 // DataChannel is a specialization for data.
 class DataChannel : public BaseChannel {
  public:
-  DataChannel(rtc::Thread* thread,
+  DataChannel(rtc::Thread* worker_thread,
+              rtc::Thread* network_thread,
               DataMediaChannel* media_channel,
               TransportController* transport_controller,
               const std::string& content_name,
@@ -541,6 +612,12 @@ class DataChannel : public BaseChannel {
   virtual bool SendData(const SendDataParams& params,
                         const rtc::Buffer& payload,
                         SendDataResult* result);
+  // Sends several messages with a single hop to the worker thread. Stops at
+  // the first message which can't be sent and returns the number of messages
+  // sent; |result| is set for the last message tried.
+  size_t SendDataBatch(const std::vector<SendDataParams>& params,
+                       const std::vector<const rtc::Buffer*>& payloads,
+                       SendDataResult* result);
 
   void StartMediaMonitor(int cms);
   void StopMediaMonitor();
@@ -555,6 +632,12 @@ class DataChannel : public BaseChannel {
       SignalConnectionMonitor;
   sigslot::signal3<DataChannel*, const ReceiveDataParams&, const rtc::Buffer&>
       SignalDataReceived;
+  // Fired on the worker thread with a view of the received payload, which is
+  // only valid during the call. While a slot is connected, received messages
+  // are neither copied nor posted to the signaling thread, so
+  // SignalDataReceived is not fired.
+  sigslot::signal4<DataChannel*, const ReceiveDataParams&, const char*, size_t>
+      SignalDataReceivedOnWorker;
   // Signal for notifying when the channel becomes ready to send data.
   // That occurs when the channel is enabled, the transport is writable,
   // both local and remote descriptions are set, and the channel is unblocked.
@@ -627,6 +710,12 @@ class DataChannel : public BaseChannel {
   virtual void OnMediaMonitorUpdate(
       DataMediaChannel* media_channel, const DataMediaInfo& info);
   virtual bool ShouldSetupDtlsSrtp() const;
+  bool SendData_w(const SendDataParams& params,
+                  const rtc::Buffer* payload,
+                  SendDataResult* result);
+  size_t SendDataBatch_w(const std::vector<SendDataParams>* params,
+                         const std::vector<const rtc::Buffer*>* payloads,
+                         SendDataResult* result);
   void OnDataReceived(
       const ReceiveDataParams& params, const char* data, size_t len);
   void OnDataChannelError(uint32_t ssrc, DataMediaChannel::Error error);
@@ -80,28 +80,34 @@ static DataEngineInterface* ConstructDataEngine() {
 ChannelManager::ChannelManager(MediaEngineInterface* me,
                                DataEngineInterface* dme,
                                CaptureManager* cm,
-                               rtc::Thread* worker_thread) {
-  Construct(me, dme, cm, worker_thread);
+                               rtc::Thread* worker_thread,
+                               rtc::Thread* network_thread) {
+  Construct(me, dme, cm, worker_thread, network_thread);
 }
 
 ChannelManager::ChannelManager(MediaEngineInterface* me,
-                               rtc::Thread* worker_thread) {
+                               rtc::Thread* worker_thread,
+                               rtc::Thread* network_thread) {
   Construct(me,
             ConstructDataEngine(),
             new CaptureManager(),
-            worker_thread);
+            worker_thread,
+            network_thread);
 }
 
 void ChannelManager::Construct(MediaEngineInterface* me,
                                DataEngineInterface* dme,
                                CaptureManager* cm,
-                               rtc::Thread* worker_thread) {
+                               rtc::Thread* worker_thread,
+                               rtc::Thread* network_thread) {
   media_engine_.reset(me);
   data_media_engine_.reset(dme);
   capture_manager_.reset(cm);
   initialized_ = false;
+  media_engine_initialized_ = false;
   main_thread_ = rtc::Thread::Current();
   worker_thread_ = worker_thread;
+  network_thread_ = network_thread;
   audio_output_volume_ = kNotSetOutputVolume;
   local_renderer_ = NULL;
   capturing_ = false;
@@ -188,21 +194,20 @@ bool ChannelManager::Init() {
     return false;
   }
   ASSERT(worker_thread_ != NULL);
-  if (!worker_thread_) {
+  ASSERT(network_thread_ != NULL);
+  if (!worker_thread_ || !network_thread_) {
     return false;
   }
-  if (worker_thread_ != rtc::Thread::Current()) {
-    // Do not allow invoking calls to other threads on the worker thread.
-    worker_thread_->Invoke<bool>(rtc::Bind(
-        &rtc::Thread::SetAllowBlockingCalls, worker_thread_, false));
+  if (network_thread_ != rtc::Thread::Current()) {
+    // Do not allow invoking calls to other threads on the network thread. The
+    // worker thread invokes the network thread, so it must not be the other
+    // way around.
+    network_thread_->Invoke<bool>(rtc::Bind(
+        &rtc::Thread::SetAllowBlockingCalls, network_thread_, false));
   }
 
-  initialized_ = worker_thread_->Invoke<bool>(Bind(
-      &ChannelManager::InitMediaEngine_w, this));
-  ASSERT(initialized_);
-  if (!initialized_) {
-    return false;
-  }
+  // The media engine is started by InitMediaEngine_w() on first use.
+  initialized_ = true;
 
   // If audio_output_volume_ has been set via SetOutputVolume(), set the
   // audio output volume of the engine.
@@ -217,7 +222,13 @@ bool ChannelManager::Init() {
 
 bool ChannelManager::InitMediaEngine_w() {
   ASSERT(worker_thread_ == rtc::Thread::Current());
-  return (media_engine_->Init(worker_thread_));
+  if (!media_engine_initialized_) {
+    TRACE_EVENT0("webrtc", "ChannelManager::InitMediaEngine_w");
+    media_engine_initialized_ = media_engine_->Init(worker_thread_);
+    if (!media_engine_initialized_)
+      LOG(LS_ERROR) << "Failed to initialize the media engine.";
+  }
+  return media_engine_initialized_;
 }
 
 void ChannelManager::Terminate() {
@@ -244,7 +255,10 @@ void ChannelManager::Terminate_w() {
   while (!voice_channels_.empty()) {
     DestroyVoiceChannel_w(voice_channels_.back());
   }
-  media_engine_->Terminate();
+  if (media_engine_initialized_) {
+    media_engine_->Terminate();
+    media_engine_initialized_ = false;
+  }
 }
 
 VoiceChannel* ChannelManager::CreateVoiceChannel(
@@ -267,14 +281,16 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
   ASSERT(initialized_);
   ASSERT(worker_thread_ == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
+  if (!InitMediaEngine_w())
+    return nullptr;
   VoiceMediaChannel* media_channel =
       media_engine_->CreateChannel(media_controller->call_w(), options);
   if (!media_channel)
     return nullptr;
 
   VoiceChannel* voice_channel =
-      new VoiceChannel(worker_thread_, media_engine_.get(), media_channel,
-                       transport_controller, content_name, rtcp);
+      new VoiceChannel(worker_thread_, network_thread_, media_engine_.get(),
+                       media_channel, transport_controller, content_name, rtcp);
   if (!voice_channel->Init()) {
     delete voice_channel;
     return nullptr;
@@ -325,6 +341,8 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
   ASSERT(initialized_);
   ASSERT(worker_thread_ == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
+  if (!InitMediaEngine_w())
+    return NULL;
   VideoMediaChannel* media_channel =
       media_engine_->CreateVideoChannel(media_controller->call_w(), options);
   if (media_channel == NULL) {
@@ -332,7 +350,8 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
   }
 
   VideoChannel* video_channel = new VideoChannel(
-      worker_thread_, media_channel, transport_controller, content_name, rtcp);
+      worker_thread_, network_thread_, media_channel, transport_controller,
+      content_name, rtcp);
   if (!video_channel->Init()) {
     delete video_channel;
     return NULL;
@@ -390,7 +409,8 @@ DataChannel* ChannelManager::CreateDataChannel_w(
   }
 
   DataChannel* data_channel = new DataChannel(
-      worker_thread_, media_channel, transport_controller, content_name, rtcp);
+      worker_thread_, network_thread_, media_channel, transport_controller,
+      content_name, rtcp);
   if (!data_channel->Init()) {
     LOG(LS_WARNING) << "Failed to init data channel.";
     delete data_channel;
@@ -427,15 +447,19 @@ bool ChannelManager::GetOutputVolume(int* level) {
     return false;
   }
   return worker_thread_->Invoke<bool>(
-      Bind(&MediaEngineInterface::GetOutputVolume, media_engine_.get(), level));
+      Bind(&ChannelManager::GetOutputVolume_w, this, level));
+}
+
+bool ChannelManager::GetOutputVolume_w(int* level) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  return InitMediaEngine_w() && media_engine_->GetOutputVolume(level);
 }
 
 bool ChannelManager::SetOutputVolume(int level) {
   bool ret = level >= 0 && level <= 255;
   if (initialized_) {
     ret &= worker_thread_->Invoke<bool>(
-        Bind(&MediaEngineInterface::SetOutputVolume,
-             media_engine_.get(), level));
+        Bind(&ChannelManager::SetOutputVolume_w, this, level));
   }
 
   if (ret) {
@@ -445,6 +469,11 @@ bool ChannelManager::SetOutputVolume(int level) {
   return ret;
 }
 
+bool ChannelManager::SetOutputVolume_w(int level) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  return InitMediaEngine_w() && media_engine_->SetOutputVolume(level);
+}
+
 std::vector<cricket::VideoFormat> ChannelManager::GetSupportedFormats(
     VideoCapturer* capturer) const {
   ASSERT(capturer != NULL);
@@ -552,7 +581,12 @@ void ChannelManager::OnMessage(rtc::Message* message) {
 
 bool ChannelManager::StartAecDump(rtc::PlatformFile file) {
   return worker_thread_->Invoke<bool>(
-      Bind(&MediaEngineInterface::StartAecDump, media_engine_.get(), file));
+      Bind(&ChannelManager::StartAecDump_w, this, file));
+}
+
+bool ChannelManager::StartAecDump_w(rtc::PlatformFile file) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  return InitMediaEngine_w() && media_engine_->StartAecDump(file);
 }
 
 void ChannelManager::StopAecDump() {
@@ -60,13 +60,17 @@ class ChannelManager : public rtc::MessageHandler,
   // For testing purposes. Allows the media engine and data media
   // engine and dev manager to be mocks.  The ChannelManager takes
   // ownership of these objects.
+  // Media processing runs on |worker|; packet I/O and the transport channels
+  // of the created channels run on |network|, which may be the same thread.
   ChannelManager(MediaEngineInterface* me,
                  DataEngineInterface* dme,
                  CaptureManager* cm,
-                 rtc::Thread* worker);
+                 rtc::Thread* worker,
+                 rtc::Thread* network);
   // Same as above, but gives an easier default DataEngine.
   ChannelManager(MediaEngineInterface* me,
-                 rtc::Thread* worker);
+                 rtc::Thread* worker,
+                 rtc::Thread* network);
   ~ChannelManager();
 
   // Accessors for the worker thread, allowing it to be set after construction,
@@ -77,6 +81,12 @@ class ChannelManager : public rtc::MessageHandler,
     worker_thread_ = thread;
     return true;
   }
+  rtc::Thread* network_thread() const { return network_thread_; }
+  bool set_network_thread(rtc::Thread* thread) {
+    if (initialized_) return false;
+    network_thread_ = thread;
+    return true;
+  }
 
   MediaEngineInterface* media_engine() { return media_engine_.get(); }
 
@@ -88,11 +98,13 @@ class ChannelManager : public rtc::MessageHandler,
   void GetSupportedVideoRtpHeaderExtensions(RtpHeaderExtensions* ext) const;
   void GetSupportedDataCodecs(std::vector<DataCodec>* codecs) const;
 
-  // Indicates whether the media engine is started.
+  // Indicates whether the channel manager is started.
   bool initialized() const { return initialized_; }
-  // Starts up the media engine.
+  // Starts up the channel manager. The media engine itself, whose audio device
+  // and audio processing setup is slow, is started on first use, i.e. when the
+  // first channel is created or the output volume or AEC dump is used.
   bool Init();
-  // Shuts down the media engine.
+  // Shuts down the channel manager and, if it was started, the media engine.
   void Terminate();
 
   // The operations below all occur on the worker thread.
@@ -184,7 +196,9 @@ class ChannelManager : public rtc::MessageHandler,
   void Construct(MediaEngineInterface* me,
                  DataEngineInterface* dme,
                  CaptureManager* cm,
-                 rtc::Thread* worker_thread);
+                 rtc::Thread* worker_thread,
+                 rtc::Thread* network_thread);
+  // Starts the media engine if it isn't already started.
   bool InitMediaEngine_w();
   void DestructorDeletes_w();
   void Terminate_w();
@@ -213,14 +227,20 @@ class ChannelManager : public rtc::MessageHandler,
       VideoCapturer* capturer,
       std::vector<cricket::VideoFormat>* out_formats) const;
   bool IsScreencastRunning_w() const;
+  bool GetOutputVolume_w(int* level);
+  bool SetOutputVolume_w(int level);
+  bool StartAecDump_w(rtc::PlatformFile file);
   virtual void OnMessage(rtc::Message *message);
 
   rtc::scoped_ptr<MediaEngineInterface> media_engine_;
   rtc::scoped_ptr<DataEngineInterface> data_media_engine_;
   rtc::scoped_ptr<CaptureManager> capture_manager_;
   bool initialized_;
+  // Only accessed on the worker thread.
+  bool media_engine_initialized_;
   rtc::Thread* main_thread_;
   rtc::Thread* worker_thread_;
+  rtc::Thread* network_thread_;
 
   VoiceChannels voice_channels_;
   VideoChannels video_channels_;
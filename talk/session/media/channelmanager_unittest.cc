@@ -59,6 +59,7 @@ class ChannelManagerTest : public testing::Test {
         cm_(new cricket::ChannelManager(fme_,
                                         fdme_,
                                         fcm_,
+                                        rtc::Thread::Current(),
                                         rtc::Thread::Current())),
         fake_call_(webrtc::Call::Config()),
         fake_mc_(cm_, &fake_call_),
@@ -79,6 +80,7 @@ class ChannelManagerTest : public testing::Test {
     fme_ = NULL;
   }
 
+  rtc::Thread network_;
   rtc::Thread worker_;
   cricket::FakeMediaEngine* fme_;
   cricket::FakeDataEngine* fdme_;
@@ -114,6 +116,23 @@ TEST_F(ChannelManagerTest, StartupShutdownOnThread) {
   EXPECT_FALSE(cm_->initialized());
 }
 
+// Test that we startup/shutdown properly with separate network and worker
+// threads.
+TEST_F(ChannelManagerTest, StartupShutdownOnNetworkAndWorkerThreads) {
+  network_.Start();
+  worker_.Start();
+  EXPECT_EQ(rtc::Thread::Current(), cm_->network_thread());
+  EXPECT_TRUE(cm_->set_network_thread(&network_));
+  EXPECT_TRUE(cm_->set_worker_thread(&worker_));
+  EXPECT_EQ(&network_, cm_->network_thread());
+  EXPECT_TRUE(cm_->Init());
+  EXPECT_TRUE(cm_->initialized());
+  // Setting the network thread while initialized should fail.
+  EXPECT_FALSE(cm_->set_network_thread(rtc::Thread::Current()));
+  cm_->Terminate();
+  EXPECT_FALSE(cm_->initialized());
+}
+
 // Test that we can create and destroy a voice and video channel.
 TEST_F(ChannelManagerTest, CreateDestroyChannels) {
   EXPECT_TRUE(cm_->Init());
@@ -138,6 +157,7 @@ TEST_F(ChannelManagerTest, CreateDestroyChannels) {
 TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
   worker_.Start();
   EXPECT_TRUE(cm_->set_worker_thread(&worker_));
+  EXPECT_TRUE(cm_->set_network_thread(&worker_));
   EXPECT_TRUE(cm_->Init());
   delete transport_controller_;
   transport_controller_ =
@@ -159,6 +179,36 @@ TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
   cm_->Terminate();
 }
 
+// Test that we can create and destroy channels whose transport channels live
+// on a network thread separate from the worker thread.
+TEST_F(ChannelManagerTest, CreateDestroyChannelsOnNetworkAndWorkerThreads) {
+  network_.Start();
+  worker_.Start();
+  EXPECT_TRUE(cm_->set_network_thread(&network_));
+  EXPECT_TRUE(cm_->set_worker_thread(&worker_));
+  EXPECT_TRUE(cm_->Init());
+  delete transport_controller_;
+  transport_controller_ =
+      new cricket::FakeTransportController(&network_, ICEROLE_CONTROLLING);
+  cricket::VoiceChannel* voice_channel =
+      cm_->CreateVoiceChannel(&fake_mc_, transport_controller_,
+                              cricket::CN_AUDIO, false, AudioOptions());
+  ASSERT_TRUE(voice_channel != nullptr);
+  EXPECT_EQ(&network_, voice_channel->network_thread());
+  EXPECT_EQ(&worker_, voice_channel->worker_thread());
+  cricket::VideoChannel* video_channel =
+      cm_->CreateVideoChannel(&fake_mc_, transport_controller_,
+                              cricket::CN_VIDEO, false, VideoOptions());
+  EXPECT_TRUE(video_channel != nullptr);
+  cricket::DataChannel* data_channel = cm_->CreateDataChannel(
+      transport_controller_, cricket::CN_DATA, false, cricket::DCT_RTP);
+  EXPECT_TRUE(data_channel != nullptr);
+  cm_->DestroyVideoChannel(video_channel);
+  cm_->DestroyVoiceChannel(voice_channel);
+  cm_->DestroyDataChannel(data_channel);
+  cm_->Terminate();
+}
+
 // Test that we fail to create a voice/video channel if the session is unable
 // to create a cricket::TransportChannel
 TEST_F(ChannelManagerTest, NoTransportChannelTest) {
@@ -35,6 +35,7 @@
 
 #include "talk/media/base/rtputils.h"
 #include "webrtc/base/base64.h"
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/logging.h"
@@ -268,6 +269,24 @@ bool SrtpFilter::UnprotectRtcp(void* p, int in_len, int* out_len) {
   }
 }
 
+bool SrtpFilter::ProtectRtpBatch(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to ProtectRtpBatch: SRTP not active";
+    return false;
+  }
+  ASSERT(send_session_ != NULL);
+  return send_session_->ProtectRtpBatch(packets);
+}
+
+bool SrtpFilter::UnprotectRtpBatch(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to UnprotectRtpBatch: SRTP not active";
+    return false;
+  }
+  ASSERT(recv_session_ != NULL);
+  return recv_session_->UnprotectRtpBatch(packets);
+}
+
 bool SrtpFilter::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
   if (!IsActive()) {
     LOG(LS_WARNING) << "Failed to GetRtpAuthParams: SRTP not active";
@@ -278,6 +297,16 @@ bool SrtpFilter::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
   return send_session_->GetRtpAuthParams(key, key_len, tag_len);
 }
 
+bool SrtpFilter::IsExternalAuthActive() const {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to check IsExternalAuthActive: SRTP not active";
+    return false;
+  }
+
+  ASSERT(send_session_ != NULL);
+  return send_session_->IsExternalAuthActive();
+}
+
 void SrtpFilter::set_signal_silent_time(uint32_t signal_silent_time_in_ms) {
   signal_silent_time_in_ms_ = signal_silent_time_in_ms;
   if (IsActive()) {
@@ -421,19 +450,42 @@ bool SrtpFilter::ApplyParams(const CryptoParams& send_params,
     // We do not want to reset the ROC if the keys are the same. So just return.
     return true;
   }
+  int send_suite = rtc::SrtpCryptoSuiteFromName(send_params.cipher_suite);
+  int recv_suite = rtc::SrtpCryptoSuiteFromName(recv_params.cipher_suite);
+  if (send_suite == rtc::SRTP_INVALID_CRYPTO_SUITE ||
+      recv_suite == rtc::SRTP_INVALID_CRYPTO_SUITE) {
+    LOG(LS_WARNING) << "Unknown crypto suite(s) received:"
+                    << " send cipher_suite " << send_params.cipher_suite
+                    << " recv cipher_suite " << recv_params.cipher_suite;
+    return false;
+  }
+
+  int send_key_len, send_salt_len;
+  int recv_key_len, recv_salt_len;
+  if (!rtc::GetSrtpKeyAndSaltLengths(send_suite, &send_key_len,
+                                     &send_salt_len) ||
+      !rtc::GetSrtpKeyAndSaltLengths(recv_suite, &recv_key_len,
+                                     &recv_salt_len)) {
+    LOG(LS_WARNING) << "Could not get lengths for crypto suite(s):"
+                    << " send cipher_suite " << send_params.cipher_suite
+                    << " recv cipher_suite " << recv_params.cipher_suite;
+    return false;
+  }
+
   // TODO(juberti): Zero these buffers after use.
   bool ret;
-  uint8_t send_key[SRTP_MASTER_KEY_LEN], recv_key[SRTP_MASTER_KEY_LEN];
-  ret = (ParseKeyParams(send_params.key_params, send_key, sizeof(send_key)) &&
-         ParseKeyParams(recv_params.key_params, recv_key, sizeof(recv_key)));
+  rtc::Buffer send_key(send_key_len + send_salt_len);
+  rtc::Buffer recv_key(recv_key_len + recv_salt_len);
+  ret = (ParseKeyParams(send_params.key_params, send_key.data(),
+                        static_cast<int>(send_key.size())) &&
+         ParseKeyParams(recv_params.key_params, recv_key.data(),
+                        static_cast<int>(recv_key.size())));
   if (ret) {
     CreateSrtpSessions();
-    ret = (send_session_->SetSend(
-               rtc::SrtpCryptoSuiteFromName(send_params.cipher_suite), send_key,
-               sizeof(send_key)) &&
-           recv_session_->SetRecv(
-               rtc::SrtpCryptoSuiteFromName(recv_params.cipher_suite), recv_key,
-               sizeof(recv_key)));
+    ret = (send_session_->SetSend(send_suite, send_key.data(),
+                                  static_cast<int>(send_key.size())) &&
+           recv_session_->SetRecv(recv_suite, recv_key.data(),
+                                  static_cast<int>(recv_key.size())));
   }
   if (ret) {
     LOG(LS_INFO) << "SRTP activated with negotiated parameters:"
@@ -494,6 +546,7 @@ SrtpSession::SrtpSession()
     : session_(NULL),
       rtp_auth_tag_len_(0),
       rtcp_auth_tag_len_(0),
+      external_auth_active_(false),
       srtp_stat_(new SrtpStat()),
       last_send_seq_num_(-1) {
   {
@@ -621,6 +674,73 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+bool SrtpSession::ProtectRtpBatch(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    return false;
+  }
+
+  // Successful results don't need to be reported to |srtp_stat_|, and only
+  // the last sequence number sent is kept, so the packets are only parsed
+  // when something goes wrong.
+  bool all_ok = true;
+  SrtpPacket* last_sent = NULL;
+  for (SrtpPacket& packet : *packets) {
+    packet.ok = false;
+    int need_len = packet.len + rtp_auth_tag_len_;  // NOLINT
+    if (packet.max_len < need_len) {
+      LOG(LS_WARNING) << "Failed to protect SRTP packet: The buffer length "
+                      << packet.max_len << " is less than the needed "
+                      << need_len;
+      all_ok = false;
+      continue;
+    }
+    int in_len = packet.len;
+    int err = srtp_protect(session_, packet.data, &packet.len);
+    if (err != err_status_ok) {
+      packet.len = in_len;
+      uint32_t ssrc;
+      if (GetRtpSsrc(packet.data, in_len, &ssrc))
+        srtp_stat_->AddProtectRtpResult(ssrc, err);
+      int seq_num;
+      GetRtpSeqNum(packet.data, in_len, &seq_num);
+      LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum="
+                      << seq_num << ", err=" << err << ", last seqnum="
+                      << last_send_seq_num_;
+      all_ok = false;
+      continue;
+    }
+    packet.ok = true;
+    last_sent = &packet;
+  }
+  if (last_sent)
+    GetRtpSeqNum(last_sent->data, last_sent->len, &last_send_seq_num_);
+  return all_ok;
+}
+
+bool SrtpSession::UnprotectRtpBatch(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    return false;
+  }
+
+  bool all_ok = true;
+  for (SrtpPacket& packet : *packets) {
+    int in_len = packet.len;
+    int err = srtp_unprotect(session_, packet.data, &packet.len);
+    packet.ok = (err == err_status_ok);
+    if (!packet.ok) {
+      packet.len = in_len;
+      uint32_t ssrc;
+      if (GetRtpSsrc(packet.data, in_len, &ssrc))
+        srtp_stat_->AddUnprotectRtpResult(ssrc, err);
+      LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err;
+      all_ok = false;
+    }
+  }
+  return all_ok;
+}
+
 bool SrtpSession::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
 #if defined(ENABLE_EXTERNAL_AUTH)
   ExternalHmacContext* external_hmac = NULL;
@@ -646,6 +766,10 @@ bool SrtpSession::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
 #endif
 }
 
+bool SrtpSession::IsExternalAuthActive() const {
+  return external_auth_active_;
+}
+
 bool SrtpSession::GetSendStreamPacketIndex(void* p,
                                            int in_len,
                                            int64_t* index) {
@@ -684,13 +808,32 @@ bool SrtpSession::SetKey(int type, int cs, const uint8_t* key, int len) {
   } else if (cs == rtc::SRTP_AES128_CM_SHA1_32) {
     crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy.rtp);   // rtp is 32,
     crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtcp);  // rtcp still 80
+  } else if (cs == rtc::SRTP_AEAD_AES_128_GCM) {
+    // libsrtp does AES-GCM through the SSL library, which uses AES-NI/PCLMUL
+    // or the ARMv8 crypto extensions where the CPU has them. The cipher and
+    // the authentication tag are computed in a single pass.
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_128_16_auth(&policy.rtcp);
+  } else if (cs == rtc::SRTP_AEAD_AES_256_GCM) {
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtp);
+    crypto_policy_set_aes_gcm_256_16_auth(&policy.rtcp);
   } else {
     LOG(LS_WARNING) << "Failed to create SRTP session: unsupported"
                     << " cipher_suite " << cs;
     return false;
   }
 
-  if (!key || len != SRTP_MASTER_KEY_LEN) {
+  int expected_key_len;
+  int expected_salt_len;
+  if (!rtc::GetSrtpKeyAndSaltLengths(cs, &expected_key_len,
+      &expected_salt_len)) {
+    // This should never happen.
+    LOG(LS_WARNING) << "Failed to create SRTP session: unsupported"
+                    << " cipher_suite without length information" << cs;
+    return false;
+  }
+
+  if (!key || len != (expected_key_len + expected_salt_len)) {
     LOG(LS_WARNING) << "Failed to create SRTP session: invalid key";
     return false;
   }
@@ -706,9 +849,11 @@ bool SrtpSession::SetKey(int type, int cs, const uint8_t* key, int len) {
   // We want to set this option only for rtp packets.
   // By default policy structure is initialized to HMAC_SHA1.
 #if defined(ENABLE_EXTERNAL_AUTH)
-  // Enable external HMAC authentication only for outgoing streams.
-  if (type == ssrc_any_outbound) {
+  // Enable external HMAC authentication only for outgoing streams and only
+  // for cipher suites that support it (i.e. only non-GCM cipher suites).
+  if (type == ssrc_any_outbound && !rtc::IsGcmCryptoSuite(cs)) {
     policy.rtp.auth_type = EXTERNAL_HMAC_SHA1;
+    external_auth_active_ = true;
   }
 #endif
   policy.next = NULL;
@@ -842,6 +987,18 @@ bool SrtpSession::UnprotectRtcp(void* data, int in_len, int* out_len) {
   return SrtpNotAvailable(__FUNCTION__);
 }
 
+bool SrtpSession::ProtectRtpBatch(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
+bool SrtpSession::UnprotectRtpBatch(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
+bool SrtpSession::IsExternalAuthActive() const {
+  return false;
+}
+
 void SrtpSession::set_signal_silent_time(uint32_t signal_silent_time) {
   // Do nothing.
 }
@@ -61,6 +61,21 @@ class SrtpStat;
 void EnableSrtpDebugging();
 void ShutdownSrtp();
 
+// An RTP packet that is protected or unprotected in place as part of a batch.
+struct SrtpPacket {
+  SrtpPacket() : data(NULL), len(0), max_len(0), ok(false) {}
+  SrtpPacket(void* data, int len, int max_len)
+      : data(data), len(len), max_len(max_len), ok(false) {}
+
+  void* data;
+  // The length of the packet, updated when it has been (un)protected.
+  int len;
+  // The size of the buffer at |data|. Only used when protecting.
+  int max_len;
+  // Set to whether the packet was (un)protected successfully.
+  bool ok;
+};
+
 // Class to transform SRTP to/from RTP.
 // Initialize by calling SetSend with the local security params, then call
 // SetRecv once the remote security params are received. At that point
@@ -132,9 +147,20 @@ class SrtpFilter {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Encrypts/signs or decrypts/verifies a burst of RTP packets, in-place, in
+  // one pass. Each packet's |ok| is set to whether it succeeded. Returns true
+  // if all of them did.
+  bool ProtectRtpBatch(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtpBatch(std::vector<SrtpPacket>* packets);
+
   // Returns rtp auth params from srtp context.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
+  // Returns true if the outgoing RTP packets are authenticated by the
+  // external HMAC module rather than by libsrtp. This is never the case for
+  // the AES-GCM crypto suites, whose authentication is part of the cipher.
+  bool IsExternalAuthActive() const;
+
   // Update the silent threshold (in ms) for signaling errors.
   void set_signal_silent_time(uint32_t signal_silent_time_in_ms);
 
@@ -220,9 +246,17 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Encrypts/signs or decrypts/verifies a burst of RTP packets, in-place, in
+  // one pass. Each packet's |ok| is set to whether it succeeded. Returns true
+  // if all of them did.
+  bool ProtectRtpBatch(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtpBatch(std::vector<SrtpPacket>* packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
+  bool IsExternalAuthActive() const;
+
   // Update the silent threshold (in ms) for signaling errors.
   void set_signal_silent_time(uint32_t signal_silent_time_in_ms);
 
@@ -246,6 +280,7 @@ class SrtpSession {
   srtp_ctx_t* session_;
   int rtp_auth_tag_len_;
   int rtcp_auth_tag_len_;
+  bool external_auth_active_;
   rtc::scoped_ptr<SrtpStat> srtp_stat_;
   static bool inited_;
   static rtc::GlobalLockPod lock_;
@@ -42,6 +42,8 @@ extern "C" {
 
 using rtc::CS_AES_CM_128_HMAC_SHA1_80;
 using rtc::CS_AES_CM_128_HMAC_SHA1_32;
+using rtc::CS_AEAD_AES_128_GCM;
+using rtc::CS_AEAD_AES_256_GCM;
 using cricket::CryptoParams;
 using cricket::CS_LOCAL;
 using cricket::CS_REMOTE;
@@ -49,6 +51,14 @@ using cricket::CS_REMOTE;
 static const uint8_t kTestKey1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
 static const uint8_t kTestKey2[] = "4321ZYXWVUTSRQPONMLKJIHGFEDCBA";
 static const int kTestKeyLen = 30;
+static const uint8_t kTestKeyGcm128_1[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ12";
+static const uint8_t kTestKeyGcm128_2[] = "21ZYXWVUTSRQPONMLKJIHGFEDCBA";
+static const int kTestKeyGcm128Len = 28;  // 128 bits key + 96 bits salt.
+static const uint8_t kTestKeyGcm256_1[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqr";
+static const uint8_t kTestKeyGcm256_2[] =
+    "rqponmlkjihgfedcbaZYXWVUTSRQPONMLKJIHGFEDCBA";
+static const int kTestKeyGcm256Len = 44;  // 256 bits key + 96 bits salt.
 static const std::string kTestKeyParams1 =
     "inline:WVNfX19zZW1jdGwgKCkgewkyMjA7fQp9CnVubGVz";
 static const std::string kTestKeyParams2 =
@@ -61,12 +71,42 @@ static const cricket::CryptoParams kTestCryptoParams1(
     1, "AES_CM_128_HMAC_SHA1_80", kTestKeyParams1, "");
 static const cricket::CryptoParams kTestCryptoParams2(
     1, "AES_CM_128_HMAC_SHA1_80", kTestKeyParams2, "");
+static const std::string kTestKeyParamsGcm1 =
+    "inline:QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVoxMg==";
+static const std::string kTestKeyParamsGcm2 =
+    "inline:MjFaWVhXVlVUU1JRUE9OTUxLSklIR0ZFRENCQQ==";
+static const std::string kTestKeyParamsGcm3 =
+    "inline:QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVphYmNkZWZnaGlqa2xtbm9wcXI=";
+static const std::string kTestKeyParamsGcm4 =
+    "inline:cnFwb25tbGtqaWhnZmVkY2JhWllYV1ZVVFNSUVBPTk1MS0pJSEdGRURDQkE=";
+static const cricket::CryptoParams kTestCryptoParamsGcm1(
+    1, "AEAD_AES_256_GCM", kTestKeyParamsGcm3, "");
+static const cricket::CryptoParams kTestCryptoParamsGcm2(
+    1, "AEAD_AES_256_GCM", kTestKeyParamsGcm4, "");
+static const cricket::CryptoParams kTestCryptoParamsGcm3(
+    1, "AEAD_AES_128_GCM", kTestKeyParamsGcm1, "");
+static const cricket::CryptoParams kTestCryptoParamsGcm4(
+    1, "AEAD_AES_128_GCM", kTestKeyParamsGcm2, "");
+
+// The largest authentication tag of the supported crypto suites, which is the
+// one of AES-GCM.
+static const int kMaxAuthTagLen = 16;
 
 static int rtp_auth_tag_len(const std::string& cs) {
-  return (cs == CS_AES_CM_128_HMAC_SHA1_32) ? 4 : 10;
+  if (cs == CS_AES_CM_128_HMAC_SHA1_32) {
+    return 4;
+  } else if (cs == CS_AEAD_AES_128_GCM || cs == CS_AEAD_AES_256_GCM) {
+    return 16;
+  } else {
+    return 10;
+  }
 }
 static int rtcp_auth_tag_len(const std::string& cs) {
-  return 10;
+  if (cs == CS_AEAD_AES_128_GCM || cs == CS_AEAD_AES_256_GCM) {
+    return 16;
+  } else {
+    return 10;
+  }
 }
 
 class SrtpFilterTest : public testing::Test {
@@ -92,9 +132,9 @@ class SrtpFilterTest : public testing::Test {
     EXPECT_TRUE(f2_.IsActive());
   }
   void TestProtectUnprotect(const std::string& cs1, const std::string& cs2) {
-    char rtp_packet[sizeof(kPcmuFrame) + 10];
+    char rtp_packet[sizeof(kPcmuFrame) + kMaxAuthTagLen];
     char original_rtp_packet[sizeof(kPcmuFrame)];
-    char rtcp_packet[sizeof(kRtcpReport) + 4 + 10];
+    char rtcp_packet[sizeof(kRtcpReport) + 4 + kMaxAuthTagLen];
     int rtp_len = sizeof(kPcmuFrame), rtcp_len = sizeof(kRtcpReport), out_len;
     memcpy(rtp_packet, kPcmuFrame, rtp_len);
     // In order to be able to run this test function multiple times we can not
@@ -373,6 +413,36 @@ TEST_F(SrtpFilterTest, TestProtect_AES_CM_128_HMAC_SHA1_32) {
   TestProtectUnprotect(CS_AES_CM_128_HMAC_SHA1_32, CS_AES_CM_128_HMAC_SHA1_32);
 }
 
+// Test that we can encrypt/decrypt after negotiating AEAD_AES_128_GCM.
+TEST_F(SrtpFilterTest, TestProtect_AEAD_AES_128_GCM) {
+  std::vector<CryptoParams> offer(MakeVector(kTestCryptoParamsGcm3));
+  std::vector<CryptoParams> answer(MakeVector(kTestCryptoParamsGcm4));
+  TestSetParams(offer, answer);
+  TestProtectUnprotect(CS_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM);
+}
+
+// Test that we can encrypt/decrypt after negotiating AEAD_AES_256_GCM, when
+// the offer also lists AES_CM_128_HMAC_SHA1_80.
+TEST_F(SrtpFilterTest, TestProtect_AEAD_AES_256_GCM) {
+  std::vector<CryptoParams> offer(MakeVector(kTestCryptoParamsGcm1));
+  std::vector<CryptoParams> answer(MakeVector(kTestCryptoParamsGcm2));
+  offer.push_back(kTestCryptoParams1);
+  offer[1].tag = 2;
+  TestSetParams(offer, answer);
+  TestProtectUnprotect(CS_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM);
+}
+
+// Test that a GCM key of the wrong length is rejected.
+TEST_F(SrtpFilterTest, TestGcmKeyTooShort) {
+  std::vector<CryptoParams> offer(MakeVector(kTestCryptoParamsGcm1));
+  std::vector<CryptoParams> answer(MakeVector(kTestCryptoParamsGcm2));
+  // A 128 bit GCM key for the 256 bit crypto suite.
+  answer[0].key_params = kTestKeyParamsGcm2;
+  EXPECT_TRUE(f1_.SetOffer(offer, CS_LOCAL));
+  EXPECT_FALSE(f1_.SetAnswer(answer, CS_REMOTE));
+  EXPECT_FALSE(f1_.IsActive());
+}
+
 // Test that we can change encryption parameters.
 TEST_F(SrtpFilterTest, TestChangeParameters) {
   std::vector<CryptoParams> offer(MakeVector(kTestCryptoParams1));
@@ -525,6 +595,44 @@ TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AES_CM_128_HMAC_SHA1_80) {
   TestProtectUnprotect(CS_AES_CM_128_HMAC_SHA1_80, CS_AES_CM_128_HMAC_SHA1_80);
 }
 
+// Test directly setting the params with AEAD_AES_128_GCM.
+TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AEAD_AES_128_GCM) {
+  EXPECT_TRUE(f1_.SetRtpParams(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1,
+                               kTestKeyGcm128Len, rtc::SRTP_AEAD_AES_128_GCM,
+                               kTestKeyGcm128_2, kTestKeyGcm128Len));
+  EXPECT_TRUE(f2_.SetRtpParams(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_2,
+                               kTestKeyGcm128Len, rtc::SRTP_AEAD_AES_128_GCM,
+                               kTestKeyGcm128_1, kTestKeyGcm128Len));
+  EXPECT_TRUE(f1_.SetRtcpParams(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1,
+                                kTestKeyGcm128Len, rtc::SRTP_AEAD_AES_128_GCM,
+                                kTestKeyGcm128_2, kTestKeyGcm128Len));
+  EXPECT_TRUE(f2_.SetRtcpParams(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_2,
+                                kTestKeyGcm128Len, rtc::SRTP_AEAD_AES_128_GCM,
+                                kTestKeyGcm128_1, kTestKeyGcm128Len));
+  EXPECT_TRUE(f1_.IsActive());
+  EXPECT_TRUE(f2_.IsActive());
+  TestProtectUnprotect(CS_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM);
+}
+
+// Test directly setting the params with AEAD_AES_256_GCM.
+TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AEAD_AES_256_GCM) {
+  EXPECT_TRUE(f1_.SetRtpParams(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_1,
+                               kTestKeyGcm256Len, rtc::SRTP_AEAD_AES_256_GCM,
+                               kTestKeyGcm256_2, kTestKeyGcm256Len));
+  EXPECT_TRUE(f2_.SetRtpParams(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_2,
+                               kTestKeyGcm256Len, rtc::SRTP_AEAD_AES_256_GCM,
+                               kTestKeyGcm256_1, kTestKeyGcm256Len));
+  EXPECT_TRUE(f1_.SetRtcpParams(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_1,
+                                kTestKeyGcm256Len, rtc::SRTP_AEAD_AES_256_GCM,
+                                kTestKeyGcm256_2, kTestKeyGcm256Len));
+  EXPECT_TRUE(f2_.SetRtcpParams(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_2,
+                                kTestKeyGcm256Len, rtc::SRTP_AEAD_AES_256_GCM,
+                                kTestKeyGcm256_1, kTestKeyGcm256Len));
+  EXPECT_TRUE(f1_.IsActive());
+  EXPECT_TRUE(f2_.IsActive());
+  TestProtectUnprotect(CS_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM);
+}
+
 // Test directly setting the params with AES_CM_128_HMAC_SHA1_32
 TEST_F(SrtpFilterTest, TestProtect_SetParamsDirect_AES_CM_128_HMAC_SHA1_32) {
   EXPECT_TRUE(f1_.SetRtpParams(rtc::SRTP_AES128_CM_SHA1_32, kTestKey1,
@@ -609,8 +717,8 @@ class SrtpSessionTest : public testing::Test {
   }
   cricket::SrtpSession s1_;
   cricket::SrtpSession s2_;
-  char rtp_packet_[sizeof(kPcmuFrame) + 10];
-  char rtcp_packet_[sizeof(kRtcpReport) + 4 + 10];
+  char rtp_packet_[sizeof(kPcmuFrame) + kMaxAuthTagLen];
+  char rtcp_packet_[sizeof(kRtcpReport) + 4 + kMaxAuthTagLen];
   int rtp_len_;
   int rtcp_len_;
 };
@@ -657,6 +765,38 @@ TEST_F(SrtpSessionTest, TestProtect_AES_CM_128_HMAC_SHA1_32) {
   TestUnprotectRtcp(CS_AES_CM_128_HMAC_SHA1_32);
 }
 
+// Test that we can encrypt and decrypt RTP/RTCP using AEAD_AES_128_GCM.
+TEST_F(SrtpSessionTest, TestProtect_AEAD_AES_128_GCM) {
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1,
+                          kTestKeyGcm128Len));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AEAD_AES_128_GCM, kTestKeyGcm128_1,
+                          kTestKeyGcm128Len));
+  TestProtectRtp(CS_AEAD_AES_128_GCM);
+  TestProtectRtcp(CS_AEAD_AES_128_GCM);
+  TestUnprotectRtp(CS_AEAD_AES_128_GCM);
+  TestUnprotectRtcp(CS_AEAD_AES_128_GCM);
+}
+
+// Test that we can encrypt and decrypt RTP/RTCP using AEAD_AES_256_GCM.
+TEST_F(SrtpSessionTest, TestProtect_AEAD_AES_256_GCM) {
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_1,
+                          kTestKeyGcm256Len));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AEAD_AES_256_GCM, kTestKeyGcm256_1,
+                          kTestKeyGcm256Len));
+  TestProtectRtp(CS_AEAD_AES_256_GCM);
+  TestProtectRtcp(CS_AEAD_AES_256_GCM);
+  TestUnprotectRtp(CS_AEAD_AES_256_GCM);
+  TestUnprotectRtcp(CS_AEAD_AES_256_GCM);
+}
+
+// Test that the GCM crypto suites reject keys sized for AES-CM.
+TEST_F(SrtpSessionTest, TestGcmKeysWrongLength) {
+  EXPECT_FALSE(s1_.SetSend(rtc::SRTP_AEAD_AES_128_GCM, kTestKey1,
+                           kTestKeyLen));
+  EXPECT_FALSE(s2_.SetRecv(rtc::SRTP_AEAD_AES_256_GCM, kTestKey1,
+                           kTestKeyLen));
+}
+
 TEST_F(SrtpSessionTest, TestGetSendStreamPacketIndex) {
   EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_32, kTestKey1, kTestKeyLen));
   int64_t index;
@@ -695,9 +835,10 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
   int out_len;
   EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
   EXPECT_FALSE(s1_.ProtectRtp(rtp_packet_, rtp_len_,
-                              sizeof(rtp_packet_) - 10, &out_len));
+                              sizeof(rtp_packet_) - kMaxAuthTagLen, &out_len));
   EXPECT_FALSE(s1_.ProtectRtcp(rtcp_packet_, rtcp_len_,
-                               sizeof(rtcp_packet_) - 14, &out_len));
+                               sizeof(rtcp_packet_) - 4 - kMaxAuthTagLen,
+                               &out_len));
 }
 
 TEST_F(SrtpSessionTest, TestReplay) {
@@ -755,6 +896,48 @@ TEST_F(SrtpSessionTest, TestReplay) {
                              &out_len));
 }
 
+// Test that a batch of packets is protected and unprotected in one call, and
+// that a packet that fails doesn't affect the others.
+TEST_F(SrtpSessionTest, TestProtectUnprotectBatch) {
+  static const int kNumPackets = 5;
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+
+  char packets[kNumPackets][sizeof(kPcmuFrame) + 10];
+  std::vector<cricket::SrtpPacket> batch;
+  for (int i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, rtp_len_);
+    rtc::SetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2, 100 + i);
+    // The buffer of the last packet is too small to add the auth tag to.
+    int max_len = (i == kNumPackets - 1) ? rtp_len_ : sizeof(packets[i]);
+    batch.push_back(cricket::SrtpPacket(packets[i], rtp_len_, max_len));
+  }
+  EXPECT_FALSE(s1_.ProtectRtpBatch(&batch));
+  for (int i = 0; i < kNumPackets - 1; ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(rtp_len_ + rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80),
+              batch[i].len);
+  }
+  EXPECT_FALSE(batch.back().ok);
+  EXPECT_EQ(rtp_len_, batch.back().len);
+
+  // Tamper with one packet; the others should still be unprotected.
+  batch.pop_back();
+  packets[1][rtp_len_ - 1] ^= 0x01;
+  EXPECT_FALSE(s2_.UnprotectRtpBatch(&batch));
+  for (int i = 0; i < kNumPackets - 1; ++i) {
+    if (i == 1) {
+      EXPECT_FALSE(batch[i].ok);
+      continue;
+    }
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(rtp_len_, batch[i].len);
+    EXPECT_EQ(100 + i,
+              rtc::GetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2));
+    EXPECT_EQ(0, memcmp(packets[i] + 4, kPcmuFrame + 4, rtp_len_ - 4));
+  }
+}
+
 class SrtpStatTest
     : public testing::Test,
       public sigslot::has_slots<> {
@@ -104,11 +104,17 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int GetError() const = 0;
   virtual void SetError(int error) = 0;
 
+  // Returns the number of bytes in front of each packet passed to
+  // SignalReadPacket that handlers may overwrite, e.g. to prepend a header
+  // when relaying the packet without copying it. The bytes are only valid
+  // for the duration of the callback.
+  virtual size_t GetReceiveHeadroom() const { return 0; }
+
   // Emitted each time a packet is read. Used only for UDP and
   // connected TCP sockets.
-  sigslot::signal5<AsyncPacketSocket*, const char*, size_t,
-                   const SocketAddress&,
-                   const PacketTime&> SignalReadPacket;
+  sigslot::fast_signal5<AsyncPacketSocket*, const char*, size_t,
+                        const SocketAddress&,
+                        const PacketTime&> SignalReadPacket;
 
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
@@ -18,6 +18,28 @@ AsyncSocket::AsyncSocket() {
 AsyncSocket::~AsyncSocket() {
 }
 
+int AsyncSocket::RecvFromBatch(Datagram* datagrams, size_t count) {
+  size_t received = 0;
+  for (; received < count; ++received) {
+    Datagram* datagram = &datagrams[received];
+    int len = RecvFrom(datagram->data, datagram->size, &datagram->addr);
+    if (len < 0)
+      break;
+    datagram->length = static_cast<size_t>(len);
+  }
+  return (received == 0 && count > 0) ? -1 : static_cast<int>(received);
+}
+
+int AsyncSocket::SendToBatch(const Datagram* datagrams, size_t count) {
+  size_t sent = 0;
+  for (; sent < count; ++sent) {
+    const Datagram& datagram = datagrams[sent];
+    if (SendTo(datagram.data, datagram.length, datagram.addr) < 0)
+      break;
+  }
+  return (sent == 0 && count > 0) ? -1 : static_cast<int>(sent);
+}
+
 AsyncSocketAdapter::AsyncSocketAdapter(AsyncSocket* socket) : socket_(NULL) {
   Attach(socket);
 }
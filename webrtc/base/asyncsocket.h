@@ -27,6 +27,31 @@ class AsyncSocket : public Socket {
 
   AsyncSocket* Accept(SocketAddress* paddr) override = 0;
 
+  // Describes one datagram for RecvFromBatch() and SendToBatch().
+  struct Datagram {
+    Datagram() : data(nullptr), size(0), length(0) {}
+    // Buffer holding the payload.
+    void* data;
+    // Capacity of |data|; only used when receiving.
+    size_t size;
+    // Number of payload bytes; filled in when receiving, read when sending.
+    size_t length;
+    // Source address when receiving, destination when sending.
+    SocketAddress addr;
+  };
+
+  // Receives up to |count| datagrams, filling in |length| and |addr| of the
+  // first N entries, where N is the return value. Returns -1 if nothing could
+  // be read, in which case GetError() tells why. Datagrams larger than their
+  // buffer are truncated, as with RecvFrom(). The default implementation
+  // calls RecvFrom() repeatedly; sockets that can do this in a single system
+  // call override it.
+  virtual int RecvFromBatch(Datagram* datagrams, size_t count);
+  // Sends the first |count| entries of |datagrams|, stopping at the first
+  // failure. Returns the number of datagrams sent, or -1 if the first one
+  // could not be sent.
+  virtual int SendToBatch(const Datagram* datagrams, size_t count);
+
   // SignalReadEvent and SignalWriteEvent use multi_threaded_local to allow
   // access concurrently from different thread.
   // For example SignalReadEvent::connect will be called in AsyncUDPSocket ctor
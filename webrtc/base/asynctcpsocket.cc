@@ -55,7 +55,8 @@ AsyncTCPSocketBase::AsyncTCPSocketBase(AsyncSocket* socket, bool listen,
       insize_(max_packet_size),
       inpos_(0),
       outsize_(max_packet_size),
-      outpos_(0) {
+      outpos_(0),
+      outstart_(0) {
   inbuf_ = new char[insize_];
   outbuf_ = new char[outsize_];
 
@@ -137,11 +138,18 @@ int AsyncTCPSocketBase::SendTo(const void *pv, size_t cb,
 }
 
 int AsyncTCPSocketBase::SendRaw(const void * pv, size_t cb) {
-  if (outpos_ + cb > outsize_) {
+  if (outpos_ - outstart_ + cb > outsize_) {
     socket_->SetError(EMSGSIZE);
     return -1;
   }
 
+  if (outpos_ + cb > outsize_) {
+    // Only move the unsent data down when there is no room after it.
+    memmove(outbuf_, outbuf_ + outstart_, outpos_ - outstart_);
+    outpos_ -= outstart_;
+    outstart_ = 0;
+  }
+
   memcpy(outbuf_ + outpos_, pv, cb);
   outpos_ += cb;
 
@@ -149,18 +157,18 @@ int AsyncTCPSocketBase::SendRaw(const void * pv, size_t cb) {
 }
 
 int AsyncTCPSocketBase::FlushOutBuffer() {
-  int res = socket_->Send(outbuf_, outpos_);
+  int res = socket_->Send(outbuf_ + outstart_, outpos_ - outstart_);
   if (res <= 0) {
     return res;
   }
-  if (static_cast<size_t>(res) <= outpos_) {
-    outpos_ -= res;
+  if (static_cast<size_t>(res) <= outpos_ - outstart_) {
+    outstart_ += res;
   } else {
     ASSERT(false);
     return -1;
   }
-  if (outpos_ > 0) {
-    memmove(outbuf_, outbuf_ + res, outpos_);
+  if (outstart_ == outpos_) {
+    ClearOutBuffer();
   }
   return res;
 }
@@ -278,21 +286,23 @@ int AsyncTCPSocket::Send(const void *pv, size_t cb,
 void AsyncTCPSocket::ProcessInput(char * data, size_t* len) {
   SocketAddress remote_addr(GetRemoteAddress());
 
-  while (true) {
-    if (*len < kPacketLenSize)
-      return;
-
-    PacketLength pkt_len = rtc::GetBE16(data);
-    if (*len < kPacketLenSize + pkt_len)
-      return;
+  // Deliver every complete packet in place, then move a trailing partial
+  // packet to the front of the buffer once.
+  size_t pos = 0;
+  while (*len - pos >= kPacketLenSize) {
+    PacketLength pkt_len = rtc::GetBE16(data + pos);
+    if (*len - pos < kPacketLenSize + pkt_len)
+      break;
 
-    SignalReadPacket(this, data + kPacketLenSize, pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos + kPacketLenSize, pkt_len, remote_addr,
                      CreatePacketTime(0));
 
-    *len -= kPacketLenSize + pkt_len;
-    if (*len > 0) {
-      memmove(data, data + kPacketLenSize + pkt_len, *len);
-    }
+    pos += kPacketLenSize + pkt_len;
+  }
+
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
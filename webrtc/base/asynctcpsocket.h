@@ -60,7 +60,7 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
 
   // Helper methods for |outpos_|.
   bool IsOutBufferEmpty() const { return outpos_ == 0; }
-  void ClearOutBuffer() { outpos_ = 0; }
+  void ClearOutBuffer() { outstart_ = outpos_ = 0; }
 
  private:
   // Called by the underlying socket
@@ -73,6 +73,9 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   bool listen_;
   char* inbuf_, * outbuf_;
   size_t insize_, inpos_, outsize_, outpos_;
+  // Start of the unsent data in |outbuf_|. A partial send advances it rather
+  // than moving the remainder down; it is reset once the buffer drains.
+  size_t outstart_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(AsyncTCPSocketBase);
 };
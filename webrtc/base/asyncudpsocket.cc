@@ -15,6 +15,8 @@ namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
 
+const size_t AsyncUDPSocket::kReceiveHeadroom;
+
 AsyncUDPSocket* AsyncUDPSocket::Create(
     AsyncSocket* socket,
     const SocketAddress& bind_address) {
@@ -39,7 +41,7 @@ AsyncUDPSocket::AsyncUDPSocket(AsyncSocket* socket)
     : socket_(socket) {
   ASSERT(socket_);
   size_ = BUF_SIZE;
-  buf_ = new char[size_];
+  buf_ = new char[kReceiveHeadroom + size_];
 
   // The socket should start out readable but not writable.
   socket_->SignalReadEvent.connect(this, &AsyncUDPSocket::OnReadEvent);
@@ -99,25 +101,60 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+size_t AsyncUDPSocket::GetReceiveHeadroom() const {
+  return kReceiveHeadroom;
+}
+
+void AsyncUDPSocket::EnableBatchedReceive(size_t max_packets,
+                                          size_t max_packet_size) {
+  ASSERT(max_packets > 0);
+  ASSERT(max_packet_size > 0);
+  delete [] buf_;
+  datagrams_.clear();
+  if (max_packets <= 1) {
+    size_ = BUF_SIZE;
+    buf_ = new char[kReceiveHeadroom + size_];
+    return;
+  }
+  // Every datagram gets its own headroom.
+  const size_t stride = kReceiveHeadroom + max_packet_size;
+  size_ = max_packets * stride;
+  buf_ = new char[size_];
+  datagrams_.resize(max_packets);
+  for (size_t i = 0; i < max_packets; ++i) {
+    datagrams_[i].data = buf_ + i * stride + kReceiveHeadroom;
+    datagrams_[i].size = max_packet_size;
+  }
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   ASSERT(socket_.get() == socket);
 
+  if (!datagrams_.empty()) {
+    int count = socket_->RecvFromBatch(&datagrams_[0], datagrams_.size());
+    if (count < 0) {
+      OnReceiveError();
+      return;
+    }
+    for (int i = 0; i < count; ++i) {
+      const AsyncSocket::Datagram& datagram = datagrams_[i];
+      SignalReadPacket(this, static_cast<const char*>(datagram.data),
+                       datagram.length, datagram.addr, CreatePacketTime(0));
+    }
+    return;
+  }
+
   SocketAddress remote_addr;
-  int len = socket_->RecvFrom(buf_, size_, &remote_addr);
+  char* data = buf_ + kReceiveHeadroom;
+  int len = socket_->RecvFrom(data, size_, &remote_addr);
   if (len < 0) {
-    // An error here typically means we got an ICMP error in response to our
-    // send datagram, indicating the remote address was unreachable.
-    // When doing ICE, this kind of thing will often happen.
-    // TODO: Do something better like forwarding the error to the user.
-    SocketAddress local_addr = socket_->GetLocalAddress();
-    LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString() << "] "
-                 << "receive failed with error " << socket_->GetError();
+    OnReceiveError();
     return;
   }
 
   // TODO: Make sure that we got all of the packet.
   // If we did not, then we should resize our buffer to be large enough.
-  SignalReadPacket(this, buf_, static_cast<size_t>(len), remote_addr,
+  SignalReadPacket(this, data, static_cast<size_t>(len), remote_addr,
                    CreatePacketTime(0));
 }
 
@@ -125,4 +162,14 @@ void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
   SignalReadyToSend(this);
 }
 
+void AsyncUDPSocket::OnReceiveError() {
+  // An error here typically means we got an ICMP error in response to our
+  // send datagram, indicating the remote address was unreachable.
+  // When doing ICE, this kind of thing will often happen.
+  // TODO: Do something better like forwarding the error to the user.
+  SocketAddress local_addr = socket_->GetLocalAddress();
+  LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString() << "] "
+               << "receive failed with error " << socket_->GetError();
+}
+
 }  // namespace rtc
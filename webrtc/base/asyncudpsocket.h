@@ -11,6 +11,8 @@
 #ifndef WEBRTC_BASE_ASYNCUDPSOCKET_H_
 #define WEBRTC_BASE_ASYNCUDPSOCKET_H_
 
+#include <vector>
+
 #include "webrtc/base/asyncpacketsocket.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/socketfactory.h"
@@ -21,6 +23,10 @@ namespace rtc {
 // buffered since it is acceptable to drop packets under high load.
 class AsyncUDPSocket : public AsyncPacketSocket {
  public:
+  // Bytes reserved in front of every received packet; see
+  // AsyncPacketSocket::GetReceiveHeadroom().
+  static const size_t kReceiveHeadroom = 16;
+
   // Binds |socket| and creates AsyncUDPSocket for it. Takes ownership
   // of |socket|. Returns NULL if bind() fails (|socket| is destroyed
   // in that case).
@@ -49,16 +55,28 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int SetOption(Socket::Option opt, int value) override;
   int GetError() const override;
   void SetError(int error) override;
+  size_t GetReceiveHeadroom() const override;
+
+  // Makes every read event drain up to |max_packets| datagrams of at most
+  // |max_packet_size| bytes each, with a single system call where the
+  // platform supports it. Larger datagrams are truncated. Passing a
+  // |max_packets| of 1 restores the default of reading one datagram of up to
+  // 64 kB per read event.
+  void EnableBatchedReceive(size_t max_packets, size_t max_packet_size);
 
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
+  void OnReceiveError();
 
   scoped_ptr<AsyncSocket> socket_;
+  // Packets are received at |buf_| + kReceiveHeadroom.
   char* buf_;
   size_t size_;
+  // Slices of |buf_| handed to RecvFromBatch(), when batching is enabled.
+  std::vector<AsyncSocket::Datagram> datagrams_;
 };
 
 }  // namespace rtc
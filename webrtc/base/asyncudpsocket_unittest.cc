@@ -9,7 +9,9 @@
  */
 
 #include <string>
+#include <vector>
 
+#include "webrtc/base/arraysize.h"
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/physicalsocketserver.h"
@@ -36,12 +38,38 @@ class AsyncUdpSocketTest
     ready_to_send_ = true;
   }
 
+  void ListenForPackets(rtc::AsyncPacketSocket* socket) {
+    socket->SignalReadPacket.connect(this, &AsyncUdpSocketTest::OnReadPacket);
+  }
+
+  void ListenForPacketsAndWriteHeadroom(rtc::AsyncPacketSocket* socket) {
+    socket->SignalReadPacket.connect(
+        this, &AsyncUdpSocketTest::OnReadPacketWriteHeadroom);
+  }
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket, const char* data,
+                    size_t size, const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    packets_.push_back(std::string(data, size));
+  }
+
+  // Overwrites the headroom, as a relay prepending a header would.
+  void OnReadPacketWriteHeadroom(rtc::AsyncPacketSocket* socket,
+                                 const char* data, size_t size,
+                                 const rtc::SocketAddress& remote_addr,
+                                 const rtc::PacketTime& packet_time) {
+    size_t headroom = socket->GetReceiveHeadroom();
+    memset(const_cast<char*>(data) - headroom, 'x', headroom);
+    packets_.push_back(std::string(data - headroom, headroom + size));
+  }
+
  protected:
   scoped_ptr<PhysicalSocketServer> pss_;
   scoped_ptr<VirtualSocketServer> vss_;
   AsyncSocket* socket_;
   scoped_ptr<AsyncUDPSocket> udp_socket_;
   bool ready_to_send_;
+  std::vector<std::string> packets_;
 };
 
 TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
@@ -50,4 +78,55 @@ TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+TEST_F(AsyncUdpSocketTest, BatchedReceiveDrainsSocket) {
+  SocketServerScope scope(pss_.get());
+  scoped_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(pss_.get(), SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(receiver);
+  receiver->EnableBatchedReceive(4, 16);
+  ListenForPackets(receiver.get());
+  scoped_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(pss_.get(), SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(sender);
+
+  // More packets than fit in one batch.
+  const char* kPayloads[] = {"a", "bb", "ccc", "dddd", "eeeee", "ffffff"};
+  for (const char* payload : kPayloads) {
+    EXPECT_EQ(static_cast<int>(strlen(payload)),
+              sender->SendTo(payload, strlen(payload),
+                             receiver->GetLocalAddress(), PacketOptions()));
+  }
+  EXPECT_EQ_WAIT(arraysize(kPayloads), packets_.size(), 1000);
+  for (size_t i = 0; i < packets_.size(); ++i) {
+    EXPECT_EQ(kPayloads[i], packets_[i]);
+  }
+}
+
+TEST_F(AsyncUdpSocketTest, HeadroomCanBeWrittenInBatchedReceive) {
+  SocketServerScope scope(pss_.get());
+  scoped_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(pss_.get(), SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(receiver);
+  ASSERT_EQ(AsyncUDPSocket::kReceiveHeadroom, receiver->GetReceiveHeadroom());
+  receiver->EnableBatchedReceive(4, 16);
+  ListenForPacketsAndWriteHeadroom(receiver.get());
+  scoped_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(pss_.get(), SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(sender);
+
+  // Datagrams that fill their slots, so that each one's headroom directly
+  // follows the end of the previous one.
+  const std::string kPrefix(AsyncUDPSocket::kReceiveHeadroom, 'x');
+  const char* kPayloads[] = {"0123456789abcdef", "fedcba9876543210",
+                             "0123456789abcdef", "fedcba9876543210"};
+  for (const char* payload : kPayloads) {
+    sender->SendTo(payload, strlen(payload), receiver->GetLocalAddress(),
+                   PacketOptions());
+  }
+  EXPECT_EQ_WAIT(arraysize(kPayloads), packets_.size(), 1000);
+  for (size_t i = 0; i < packets_.size(); ++i) {
+    EXPECT_EQ(kPrefix + kPayloads[i], packets_[i]);
+  }
+}
+
 }  // namespace rtc
@@ -92,6 +92,10 @@
         'event_tracer.h',
         'exp_filter.cc',
         'exp_filter.h',
+        'lockcontentionprofiler.cc',
+        'lockcontentionprofiler.h',
+        'lockfreebufferqueue.cc',
+        'lockfreebufferqueue.h',
         'logging.cc',
         'logging.h',
         'md5.cc',
@@ -188,6 +192,8 @@
         'callback.h',
         'common.cc',
         'common.h',
+        'copyonwritebuffer.cc',
+        'copyonwritebuffer.h',
         'crc32.cc',
         'crc32.h',
         'cryptstring.cc',
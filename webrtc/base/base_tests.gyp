@@ -58,6 +58,7 @@
           'bytebuffer_unittest.cc',
           'byteorder_unittest.cc',
           'callback_unittest.cc',
+          'copyonwritebuffer_unittest.cc',
           'crc32_unittest.cc',
           'criticalsection_unittest.cc',
           'event_tracer_unittest.cc',
@@ -70,6 +71,7 @@
           'httpcommon_unittest.cc',
           'httpserver_unittest.cc',
           'ipaddress_unittest.cc',
+          'lockfreebufferqueue_unittest.cc',
           'logging_unittest.cc',
           'md5digest_unittest.cc',
           'messagedigest_unittest.cc',
@@ -22,12 +22,14 @@ namespace rtc {
 
 static const int DEFAULT_SIZE = 4096;
 
+const size_t ByteBuffer::kInlineSize;
+
 ByteBuffer::ByteBuffer() {
-  Construct(NULL, DEFAULT_SIZE, ORDER_NETWORK);
+  Construct(NULL, kInlineSize, ORDER_NETWORK);
 }
 
 ByteBuffer::ByteBuffer(ByteOrder byte_order) {
-  Construct(NULL, DEFAULT_SIZE, byte_order);
+  Construct(NULL, kInlineSize, byte_order);
 }
 
 ByteBuffer::ByteBuffer(const char* bytes, size_t len) {
@@ -46,13 +48,27 @@ ByteBuffer::ByteBuffer(const Buffer& buf) {
   Construct(buf.data<char>(), buf.size(), ORDER_NETWORK);
 }
 
+ByteBuffer::ByteBuffer(Buffer* storage) {
+  ConstructWithStorage(storage, ORDER_NETWORK);
+}
+
+ByteBuffer::ByteBuffer(Buffer* storage, ByteOrder byte_order) {
+  ConstructWithStorage(storage, byte_order);
+}
+
 void ByteBuffer::Construct(const char* bytes, size_t len,
                            ByteOrder byte_order) {
   version_ = 0;
   start_ = 0;
-  size_ = len;
   byte_order_ = byte_order;
-  bytes_ = new char[size_];
+  storage_ = NULL;
+  if (len <= kInlineSize) {
+    size_ = kInlineSize;
+    bytes_ = inline_bytes_;
+  } else {
+    size_ = len;
+    bytes_ = new char[size_];
+  }
 
   if (bytes) {
     end_ = len;
@@ -62,8 +78,25 @@ void ByteBuffer::Construct(const char* bytes, size_t len,
   }
 }
 
+void ByteBuffer::ConstructWithStorage(Buffer* storage, ByteOrder byte_order) {
+  version_ = 0;
+  start_ = 0;
+  end_ = 0;
+  byte_order_ = byte_order;
+  storage_ = storage;
+  storage_->SetSize(0);
+  size_ = storage_->capacity();
+  bytes_ = storage_->data<char>();
+}
+
 ByteBuffer::~ByteBuffer() {
-  delete[] bytes_;
+  if (storage_) {
+    if (start_ > 0)
+      memmove(bytes_, bytes_ + start_, Length());
+    storage_->SetSize(Length());
+  } else if (bytes_ != inline_bytes_) {
+    delete[] bytes_;
+  }
 }
 
 bool ByteBuffer::ReadUInt8(uint8_t* val) {
@@ -197,12 +230,25 @@ void ByteBuffer::Resize(size_t size) {
   if (size <= size_) {
     // Don't reallocate, just move data backwards
     memmove(bytes_, bytes_ + start_, len);
+  } else if (storage_) {
+    // Let |storage_| reallocate, keeping the data at its start.
+    if (start_ > 0)
+      memmove(bytes_, bytes_ + start_, len);
+    storage_->SetSize(len);
+    storage_->EnsureCapacity(std::max(size, 3 * size_ / 2));
+    size_ = storage_->capacity();
+    bytes_ = storage_->data<char>();
   } else {
-    // Reallocate a larger buffer.
-    size_ = std::max(size, 3 * size_ / 2);
+    // Reallocate a larger buffer. Once the data no longer fits inline, start
+    // at DEFAULT_SIZE to avoid growing it in many small steps.
+    if (bytes_ == inline_bytes_)
+      size_ = std::max<size_t>(size, DEFAULT_SIZE);
+    else
+      size_ = std::max(size, 3 * size_ / 2);
     char* new_bytes = new char[size_];
     memcpy(new_bytes, bytes_ + start_, len);
-    delete [] bytes_;
+    if (bytes_ != inline_bytes_)
+      delete [] bytes_;
     bytes_ = new_bytes;
   }
   start_ = 0;
@@ -230,7 +276,8 @@ bool ByteBuffer::SetReadPosition(const ReadPosition &position) {
 }
 
 void ByteBuffer::Clear() {
-  memset(bytes_, 0, size_);
+  if (size_ > 0)
+    memset(bytes_, 0, size_);
   start_ = end_ = 0;
   ++version_;
 }
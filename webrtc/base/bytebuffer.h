@@ -19,9 +19,13 @@
 
 namespace rtc {
 
+// Buffers of up to kInlineSize bytes are stored in the ByteBuffer itself, so
+// building or parsing a typical control packet doesn't allocate.
 class ByteBuffer {
  public:
 
+  static const size_t kInlineSize = 256;
+
   enum ByteOrder {
     ORDER_NETWORK = 0,  // Default, use network byte order (big endian).
     ORDER_HOST,         // Use the native order of the host.
@@ -38,6 +42,13 @@ class ByteBuffer {
 
   explicit ByteBuffer(const Buffer& buf);
 
+  // Writes into the memory of |storage|, which must outlive the ByteBuffer,
+  // growing it if needed. Lets a caller that builds packets repeatedly reuse
+  // one allocation. The previous contents of |storage| are discarded, and when
+  // the ByteBuffer is destroyed |storage| holds the unread bytes.
+  explicit ByteBuffer(Buffer* storage);
+  ByteBuffer(Buffer* storage, ByteOrder byte_order);
+
   ~ByteBuffer();
 
   const char* Data() const { return bytes_ + start_; }
@@ -104,13 +115,18 @@ class ByteBuffer {
 
  private:
   void Construct(const char* bytes, size_t size, ByteOrder byte_order);
+  void ConstructWithStorage(Buffer* storage, ByteOrder byte_order);
 
+  // Points to |inline_bytes_|, to the memory of |storage_|, or to an array of
+  // our own on the heap.
   char* bytes_;
   size_t size_;
   size_t start_;
   size_t end_;
   int version_;
   ByteOrder byte_order_;
+  Buffer* storage_;
+  char inline_bytes_[kInlineSize];
 
   // There are sensible ways to define these, but they aren't needed in our code
   // base.
@@ -112,6 +112,53 @@ TEST(ByteBufferTest, TestGetSetReadPosition) {
   EXPECT_EQ("DEF", read);
 }
 
+TEST(ByteBufferTest, TestGrowBeyondInlineSize) {
+  ByteBuffer buffer;
+  EXPECT_EQ(ByteBuffer::kInlineSize, buffer.Capacity());
+  for (size_t i = 0; i < 3 * ByteBuffer::kInlineSize; ++i)
+    buffer.WriteUInt8(static_cast<uint8_t>(i));
+  EXPECT_EQ(3 * ByteBuffer::kInlineSize, buffer.Length());
+  for (size_t i = 0; i < 3 * ByteBuffer::kInlineSize; ++i) {
+    uint8_t val;
+    EXPECT_TRUE(buffer.ReadUInt8(&val));
+    EXPECT_EQ(static_cast<uint8_t>(i), val);
+  }
+
+  std::string large(2 * ByteBuffer::kInlineSize, 'x');
+  ByteBuffer read_buffer(large.c_str());
+  EXPECT_EQ(large.size(), read_buffer.Length());
+  std::string read;
+  EXPECT_TRUE(read_buffer.ReadString(&read, large.size()));
+  EXPECT_EQ(large, read);
+}
+
+TEST(ByteBufferTest, TestWriteIntoStorage) {
+  Buffer storage(0, 16);
+  const uint8_t* data = storage.data();
+  {
+    ByteBuffer buffer(&storage);
+    buffer.WriteUInt32(0x01020304);
+    EXPECT_EQ(reinterpret_cast<const char*>(data), buffer.Data());
+  }
+  ASSERT_EQ(4U, storage.size());
+  EXPECT_EQ(1, storage.data()[0]);
+  EXPECT_EQ(4, storage.data()[3]);
+
+  // Reuses the allocation, and grows it when needed.
+  {
+    ByteBuffer buffer(&storage, ByteBuffer::ORDER_HOST);
+    EXPECT_EQ(0U, buffer.Length());
+    std::string write_string(100, 'a');
+    buffer.WriteUInt8(1);
+    buffer.WriteString(write_string);
+    uint8_t val;
+    EXPECT_TRUE(buffer.ReadUInt8(&val));
+    EXPECT_EQ(1, val);
+  }
+  EXPECT_EQ(std::string(100, 'a'),
+            std::string(storage.data<char>(), storage.size()));
+}
+
 TEST(ByteBufferTest, TestReadWriteBuffer) {
   ByteBuffer::ByteOrder orders[2] = { ByteBuffer::ORDER_HOST,
                                       ByteBuffer::ORDER_NETWORK };
@@ -10,9 +10,52 @@
 
 #include "webrtc/base/criticalsection.h"
 
+#if defined(WEBRTC_POSIX)
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
+#include "webrtc/base/lockcontentionprofiler.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/typedefs.h"
 
 namespace rtc {
+namespace {
+
+// -1 until the number of cores has been checked.
+volatile int g_spinning_allowed = -1;
+
+// Spinning only helps if the thread holding the lock can run meanwhile.
+bool SpinningAllowed() {
+  int allowed = AtomicOps::AcquireLoad(&g_spinning_allowed);
+  if (allowed < 0) {
+#if defined(WEBRTC_WIN)
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    allowed = info.dwNumberOfProcessors > 1 ? 1 : 0;
+#else
+    allowed = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 1 : 0;
+#endif
+    AtomicOps::ReleaseStore(&g_spinning_allowed, allowed);
+  }
+  return allowed != 0;
+}
+
+// Tells the CPU that this is a spin-wait loop, which saves power and lets a
+// hyperthread sibling, possibly the lock holder, run faster.
+inline void SpinPause() {
+#if defined(WEBRTC_WIN)
+  YieldProcessor();
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+}  // namespace
 
 CriticalSection::CriticalSection() {
 #if defined(WEBRTC_WIN)
@@ -118,6 +161,68 @@ bool CriticalSection::IsLocked() const {
 CritScope::CritScope(CriticalSection* cs) : cs_(cs) { cs_->Enter(); }
 CritScope::~CritScope() { cs_->Leave(); }
 
+const int AdaptiveCriticalSection::kMaxSpinCount;
+
+AdaptiveCriticalSection::AdaptiveCriticalSection()
+    : name_(nullptr), spin_estimate_(0) {}
+
+AdaptiveCriticalSection::AdaptiveCriticalSection(const char* name)
+    : name_(name), spin_estimate_(0) {}
+
+AdaptiveCriticalSection::~AdaptiveCriticalSection() {}
+
+void AdaptiveCriticalSection::Enter() EXCLUSIVE_LOCK_FUNCTION() {
+  if (crit_.TryEnter())
+    return;
+
+  const bool profile = name_ && LockContentionProfiler::IsEnabled();
+  const uint64_t start_time_us = profile ? TimeMicros() : 0;
+  // Same policy as glibc's PTHREAD_MUTEX_ADAPTIVE_NP: allow some more spins
+  // than have recently been needed, so the estimate can grow.
+  int max_spins = 0;
+  if (SpinningAllowed()) {
+    max_spins = std::min(kMaxSpinCount,
+                         2 * AtomicOps::AcquireLoad(&spin_estimate_) + 10);
+  }
+  int spins = 0;
+  bool acquired = false;
+  while (spins < max_spins) {
+    ++spins;
+    SpinPause();
+    if (crit_.TryEnter()) {
+      acquired = true;
+      break;
+    }
+  }
+  if (!acquired)
+    crit_.Enter();
+
+  const int estimate = spin_estimate_;
+  AtomicOps::ReleaseStore(&spin_estimate_,
+                          estimate + (spins - estimate) / 8);
+  if (profile) {
+    LockContentionProfiler::RecordWait(
+        name_, !acquired, static_cast<int64_t>(TimeMicros() - start_time_us));
+  }
+}
+
+bool AdaptiveCriticalSection::TryEnter() EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+  return crit_.TryEnter();
+}
+
+void AdaptiveCriticalSection::Leave() UNLOCK_FUNCTION() {
+  crit_.Leave();
+}
+
+bool AdaptiveCriticalSection::CurrentThreadIsOwner() const {
+  return crit_.CurrentThreadIsOwner();
+}
+
+AdaptiveCritScope::AdaptiveCritScope(AdaptiveCriticalSection* cs) : cs_(cs) {
+  cs_->Enter();
+}
+AdaptiveCritScope::~AdaptiveCritScope() { cs_->Leave(); }
+
 TryCritScope::TryCritScope(CriticalSection* cs)
     : cs_(cs), locked_(cs->TryEnter()) {
   CS_DEBUG_CODE(lock_was_called_ = false);
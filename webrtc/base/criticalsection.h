@@ -75,6 +75,47 @@ class SCOPED_LOCKABLE CritScope {
   RTC_DISALLOW_COPY_AND_ASSIGN(CritScope);
 };
 
+// A CriticalSection for locks that are taken often from several threads but
+// held only briefly. A contended Enter() retries TryEnter() for a bounded
+// number of spins before blocking in the kernel. The spin count adapts to how
+// long acquiring the lock has taken recently, and spinning is skipped on
+// single-core machines.
+// When LockContentionProfiler is enabled, the time spent waiting for a lock
+// with a |name| is recorded under that name. |name| must outlive the lock.
+class LOCKABLE AdaptiveCriticalSection {
+ public:
+  static const int kMaxSpinCount = 100;
+
+  AdaptiveCriticalSection();
+  explicit AdaptiveCriticalSection(const char* name);
+  ~AdaptiveCriticalSection();
+
+  void Enter() EXCLUSIVE_LOCK_FUNCTION();
+  bool TryEnter() EXCLUSIVE_TRYLOCK_FUNCTION(true);
+  void Leave() UNLOCK_FUNCTION();
+
+  // Use only for RTC_DCHECKing.
+  bool CurrentThreadIsOwner() const;
+
+ private:
+  CriticalSection crit_;
+  const char* const name_;
+  // Moving average of the spins needed by contended acquisitions. Only written
+  // while holding |crit_|.
+  volatile int spin_estimate_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(AdaptiveCriticalSection);
+};
+
+class SCOPED_LOCKABLE AdaptiveCritScope {
+ public:
+  explicit AdaptiveCritScope(AdaptiveCriticalSection* cs)
+      EXCLUSIVE_LOCK_FUNCTION(cs);
+  ~AdaptiveCritScope() UNLOCK_FUNCTION();
+ private:
+  AdaptiveCriticalSection* const cs_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(AdaptiveCritScope);
+};
+
 // Tries to lock a critical section on construction via
 // CriticalSection::TryEnter, and unlocks on destruction if the
 // lock was taken. Never blocks.
@@ -14,6 +14,8 @@
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/lockcontentionprofiler.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/thread.h"
@@ -124,6 +126,19 @@ class LOCKABLE CriticalSectionLock {
   CriticalSection cs_;
 };
 
+class LOCKABLE AdaptiveCriticalSectionLock {
+ public:
+  void Lock() EXCLUSIVE_LOCK_FUNCTION() {
+    cs_.Enter();
+  }
+  void Unlock() UNLOCK_FUNCTION() {
+    cs_.Leave();
+  }
+
+ private:
+  AdaptiveCriticalSection cs_;
+};
+
 template <class Lock>
 class LockRunner : public RunnerBase {
  public:
@@ -206,6 +221,35 @@ void StartThreads(ScopedPtrCollection<Thread>* threads,
   }
 }
 
+// Enters |cs| on a thread of its own, and waits until that thread is blocked
+// on it.
+class ContendingThread {
+ public:
+  explicit ContendingThread(AdaptiveCriticalSection* cs)
+      : cs_(cs),
+        entering_(false, false),
+        thread_(&ContendingThread::Run, this, "ContendingThread") {
+    thread_.Start();
+    EXPECT_TRUE(entering_.Wait(kLongTime));
+    // Give the thread time to give up spinning.
+    Thread::SleepMs(20);
+  }
+
+  ~ContendingThread() { thread_.Stop(); }
+
+ private:
+  static bool Run(void* obj) {
+    ContendingThread* self = static_cast<ContendingThread*>(obj);
+    self->entering_.Set();
+    AdaptiveCritScope cs(self->cs_);
+    return false;
+  }
+
+  AdaptiveCriticalSection* const cs_;
+  Event entering_;
+  PlatformThread thread_;
+};
+
 }  // namespace
 
 TEST(AtomicOpsTest, Simple) {
@@ -303,6 +347,59 @@ TEST(CriticalSectionTest, Basic) {
   EXPECT_EQ(0, runner.shared_value());
 }
 
+TEST(AdaptiveCriticalSectionTest, Basic) {
+  // Create and start lots of threads.
+  LockRunner<AdaptiveCriticalSectionLock> runner;
+  ScopedPtrCollection<Thread> threads;
+  StartThreads(&threads, &runner);
+  runner.SetExpectedThreadCount(kNumThreads);
+
+  // Release the hounds!
+  EXPECT_TRUE(runner.Run());
+  EXPECT_EQ(0, runner.shared_value());
+}
+
+TEST(AdaptiveCriticalSectionTest, IsRecursive) {
+  AdaptiveCriticalSection cs;
+  AdaptiveCritScope outer(&cs);
+  AdaptiveCritScope inner(&cs);
+  EXPECT_TRUE(cs.TryEnter());
+  cs.Leave();
+}
+
+TEST(LockContentionProfilerTest, RecordsWaitForNamedLocks) {
+  LockContentionProfiler::Reset();
+  LockContentionProfiler::SetEnabled(true);
+  AdaptiveCriticalSection named("LockContentionProfilerTest");
+  AdaptiveCriticalSection unnamed;
+  for (AdaptiveCriticalSection* cs : {&named, &unnamed}) {
+    cs->Enter();
+    ContendingThread thread(cs);
+    cs->Leave();
+  }
+  LockContentionProfiler::SetEnabled(false);
+
+  std::vector<LockContentionProfiler::SiteStats> stats =
+      LockContentionProfiler::GetStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ("LockContentionProfilerTest", stats[0].name);
+  EXPECT_EQ(1, stats[0].contended_count);
+  EXPECT_EQ(1, stats[0].blocked_count);
+  EXPECT_GE(stats[0].total_wait_us, 10000);
+  EXPECT_EQ(stats[0].total_wait_us, stats[0].max_wait_us);
+}
+
+TEST(LockContentionProfilerTest, RecordsNothingWhenDisabled) {
+  LockContentionProfiler::Reset();
+  AdaptiveCriticalSection cs("LockContentionProfilerTest");
+  cs.Enter();
+  {
+    ContendingThread thread(&cs);
+    cs.Leave();
+  }
+  EXPECT_TRUE(LockContentionProfiler::GetStats().empty());
+}
+
 #if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
 TEST(CriticalSectionTest, IsLocked) {
   // Simple single-threaded test of IsLocked.
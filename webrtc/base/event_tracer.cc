@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/event.h"
@@ -84,7 +85,8 @@ class EventLogger final {
  public:
   EventLogger()
       : logging_thread_(EventTracingThreadFunc, this, "EventTracingThread"),
-        shutdown_event_(false, false) {}
+        shutdown_event_(false, false),
+        dropped_events_(0) {}
   ~EventLogger() { RTC_DCHECK(thread_checker_.CalledOnValidThread()); }
 
   void AddTraceEvent(const char* name,
@@ -93,8 +95,13 @@ class EventLogger final {
                      uint64_t timestamp,
                      int pid,
                      rtc::PlatformThreadId thread_id) {
-    rtc::CritScope lock(&crit_);
-    trace_events_.push_back(
+    Shard& shard = shards_[static_cast<size_t>(thread_id) % kNumShards];
+    rtc::CritScope lock(&shard.crit);
+    if (shard.events.size() >= kMaxEventsPerShard) {
+      rtc::AtomicOps::Increment(&dropped_events_);
+      return;
+    }
+    shard.events.push_back(
         {name, category_enabled, phase, timestamp, 1, thread_id});
   }
 
@@ -105,30 +112,46 @@ class EventLogger final {
     static const int kLoggingIntervalMs = 100;
     fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
+    std::vector<TraceEvent> events;
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
-      {
-        rtc::CritScope lock(&crit_);
-        trace_events_.swap(events);
-      }
-      for (const TraceEvent& e : events) {
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
+      for (Shard& shard : shards_) {
+        // Swap in the buffer written out last time, so that neither side
+        // reallocates once tracing has warmed up.
+        events.clear();
+        {
+          rtc::CritScope lock(&shard.crit);
+          shard.events.swap(events);
+        }
+        for (const TraceEvent& e : events) {
+          fprintf(output_file_,
+                  "%s{ \"name\": \"%s\""
+                  ", \"cat\": \"%s\""
+                  ", \"ph\": \"%c\""
+                  ", \"ts\": %" PRIu64
+                  ", \"pid\": %d"
 #if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
+                  ", \"tid\": %lu"
 #else
-                ", \"tid\": %d"
+                  ", \"tid\": %d"
 #endif  // defined(WEBRTC_WIN)
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid);
-        has_logged_event = true;
+                  "}\n",
+                  has_logged_event ? "," : " ", e.name, e.category_enabled,
+                  e.phase, e.timestamp, e.pid, e.tid);
+          has_logged_event = true;
+        }
       }
+      // Take the count of dropped events, leaving zero behind.
+      int dropped = rtc::AtomicOps::AcquireLoad(&dropped_events_);
+      while (dropped > 0) {
+        int seen =
+            rtc::AtomicOps::CompareAndSwap(&dropped_events_, dropped, 0);
+        if (seen == dropped)
+          break;
+        dropped = seen;
+      }
+      if (dropped > 0)
+        LOG(LS_WARNING) << "Dropped " << dropped << " trace events.";
       if (shutting_down)
         break;
     }
@@ -143,13 +166,13 @@ class EventLogger final {
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
-    {
-      rtc::CritScope lock(&crit_);
+    for (Shard& shard : shards_) {
+      rtc::CritScope lock(&shard.crit);
       // Since the atomic fast-path for adding events to the queue can be
       // bypassed while the logging thread is shutting down there may be some
       // stale events in the queue, hence the vector needs to be cleared to not
       // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
+      shard.events.clear();
     }
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
@@ -181,13 +204,24 @@ class EventLogger final {
     rtc::PlatformThreadId tid;
   };
 
-  rtc::CriticalSection crit_;
-  std::vector<TraceEvent> trace_events_ GUARDED_BY(crit_);
+  // Events are spread over shards by thread id, so that instrumented threads
+  // rarely wait for each other or for the logging thread.
+  static const size_t kNumShards = 16;
+  // Bounds the memory used between two flushes. Events beyond it are
+  // dropped and counted.
+  static const size_t kMaxEventsPerShard = 8192;
+  struct Shard {
+    rtc::CriticalSection crit;
+    std::vector<TraceEvent> events GUARDED_BY(crit);
+  };
+
+  Shard shards_[kNumShards];
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
   FILE* output_file_ = nullptr;
   bool output_file_owned_ = false;
+  volatile int dropped_events_;
 };
 
 static bool EventTracingThreadFunc(void* params) {
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/lockcontentionprofiler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/criticalsection.h"
+
+namespace rtc {
+namespace {
+
+typedef std::map<std::string, LockContentionProfiler::SiteStats> SiteStatsMap;
+
+volatile int g_enabled = 0;
+GlobalLockPod g_stats_lock;
+// Allocated on first use and never freed, to avoid a static initializer.
+SiteStatsMap* g_stats GUARDED_BY(g_stats_lock) = nullptr;
+
+bool LongerTotalWait(const LockContentionProfiler::SiteStats& a,
+                     const LockContentionProfiler::SiteStats& b) {
+  return a.total_wait_us > b.total_wait_us;
+}
+
+}  // namespace
+
+LockContentionProfiler::SiteStats::SiteStats()
+    : contended_count(0), blocked_count(0), total_wait_us(0), max_wait_us(0) {}
+
+void LockContentionProfiler::SetEnabled(bool enabled) {
+  AtomicOps::ReleaseStore(&g_enabled, enabled ? 1 : 0);
+}
+
+bool LockContentionProfiler::IsEnabled() {
+  return AtomicOps::AcquireLoad(&g_enabled) != 0;
+}
+
+void LockContentionProfiler::RecordWait(const char* name,
+                                        bool blocked,
+                                        int64_t wait_us) {
+  GlobalLockScope lock(&g_stats_lock);
+  if (!g_stats)
+    g_stats = new SiteStatsMap();
+  SiteStats& stats = (*g_stats)[name];
+  if (stats.name.empty())
+    stats.name = name;
+  ++stats.contended_count;
+  if (blocked)
+    ++stats.blocked_count;
+  stats.total_wait_us += wait_us;
+  stats.max_wait_us = std::max(stats.max_wait_us, wait_us);
+}
+
+std::vector<LockContentionProfiler::SiteStats>
+LockContentionProfiler::GetStats() {
+  std::vector<SiteStats> stats;
+  {
+    GlobalLockScope lock(&g_stats_lock);
+    if (g_stats) {
+      for (const auto& it : *g_stats)
+        stats.push_back(it.second);
+    }
+  }
+  std::sort(stats.begin(), stats.end(), &LongerTotalWait);
+  return stats;
+}
+
+void LockContentionProfiler::Reset() {
+  GlobalLockScope lock(&g_stats_lock);
+  if (g_stats)
+    g_stats->clear();
+}
+
+}  // namespace rtc
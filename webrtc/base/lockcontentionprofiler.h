@@ -0,0 +1,54 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_LOCKCONTENTIONPROFILER_H_
+#define WEBRTC_BASE_LOCKCONTENTIONPROFILER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace rtc {
+
+// Records how long threads wait for named AdaptiveCriticalSections, so that
+// the locks that actually cost time can be found. Profiling is off by
+// default; while it is off, a contended lock pays for one atomic load.
+// Stats are aggregated by name, so all locks created with the same name, e.g.
+// the send lock of every RTP sender, share one entry.
+class LockContentionProfiler {
+ public:
+  struct SiteStats {
+    SiteStats();
+
+    std::string name;
+    // Acquisitions that didn't get the lock on the first try.
+    int contended_count;
+    // Of those, the acquisitions that stopped spinning and blocked.
+    int blocked_count;
+    int64_t total_wait_us;
+    int64_t max_wait_us;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Called by AdaptiveCriticalSection after a contended acquisition.
+  static void RecordWait(const char* name, bool blocked, int64_t wait_us);
+
+  // Returns the stats recorded since the last Reset(), the longest total wait
+  // first.
+  static std::vector<SiteStats> GetStats();
+  static void Reset();
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_LOCKCONTENTIONPROFILER_H_
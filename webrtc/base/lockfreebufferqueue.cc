@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/lockfreebufferqueue.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/atomicops.h"
+
+namespace rtc {
+
+LockFreeBufferQueue::LockFreeBufferQueue(size_t capacity, size_t default_size)
+    : read_pos_(0), write_pos_(0) {
+  slots_.reserve(capacity + 1);
+  for (size_t i = 0; i < capacity + 1; ++i)
+    slots_.push_back(Buffer(0, default_size));
+}
+
+LockFreeBufferQueue::~LockFreeBufferQueue() {}
+
+size_t LockFreeBufferQueue::size() const {
+  const int slots = static_cast<int>(slots_.size());
+  const int read_pos = AtomicOps::AcquireLoad(&read_pos_);
+  const int write_pos = AtomicOps::AcquireLoad(&write_pos_);
+  return static_cast<size_t>((write_pos - read_pos + slots) % slots);
+}
+
+bool LockFreeBufferQueue::ReadFront(void* buffer,
+                                    size_t bytes,
+                                    size_t* bytes_read) {
+  const int slots = static_cast<int>(slots_.size());
+  const int read_pos = read_pos_;
+  const int write_pos = AtomicOps::AcquireLoad(&write_pos_);
+  if (read_pos == write_pos) {
+    return false;
+  }
+
+  bool was_writable = (write_pos + 1) % slots != read_pos;
+  Buffer& packet = slots_[read_pos];
+  bytes = std::min(bytes, packet.size());
+  memcpy(buffer, packet.data(), bytes);
+  if (bytes_read) {
+    *bytes_read = bytes;
+  }
+  // Hands the slot back to the writing thread.
+  AtomicOps::ReleaseStore(&read_pos_, (read_pos + 1) % slots);
+  if (!was_writable) {
+    NotifyWritableForTest();
+  }
+  return true;
+}
+
+bool LockFreeBufferQueue::WriteBack(const void* buffer,
+                                    size_t bytes,
+                                    size_t* bytes_written) {
+  const int slots = static_cast<int>(slots_.size());
+  const int write_pos = write_pos_;
+  const int read_pos = AtomicOps::AcquireLoad(&read_pos_);
+  const int next_write_pos = (write_pos + 1) % slots;
+  if (next_write_pos == read_pos) {
+    return false;
+  }
+
+  bool was_readable = write_pos != read_pos;
+  slots_[write_pos].SetData(static_cast<const uint8_t*>(buffer), bytes);
+  if (bytes_written) {
+    *bytes_written = bytes;
+  }
+  // Publishes the packet to the reading thread.
+  AtomicOps::ReleaseStore(&write_pos_, next_write_pos);
+  if (!was_readable) {
+    NotifyReadableForTest();
+  }
+  return true;
+}
+
+}  // namespace rtc
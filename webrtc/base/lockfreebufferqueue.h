@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_LOCKFREEBUFFERQUEUE_H_
+#define WEBRTC_BASE_LOCKFREEBUFFERQUEUE_H_
+
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
+
+namespace rtc {
+
+// A BufferQueue for one writing and one reading thread, which can be
+// different, without a lock. The buffers are allocated up front in a ring,
+// and only reallocated to hold a packet larger than |default_size|.
+class LockFreeBufferQueue {
+ public:
+  // Creates a buffer queue with a given capacity and default buffer size.
+  LockFreeBufferQueue(size_t capacity, size_t default_size);
+  virtual ~LockFreeBufferQueue();
+
+  // Return number of queued buffers.
+  size_t size() const;
+
+  // ReadFront will only read one buffer at a time and will truncate buffers
+  // that don't fit in the passed memory.
+  // Returns true unless no data could be returned.
+  // Must only be called on the reading thread.
+  bool ReadFront(void* data, size_t bytes, size_t* bytes_read);
+
+  // WriteBack always writes either the complete memory or nothing.
+  // Returns true unless no data could be written.
+  // Must only be called on the writing thread.
+  bool WriteBack(const void* data, size_t bytes, size_t* bytes_written);
+
+ protected:
+  // These methods are called when the state of the queue changes, on the
+  // thread that changed it.
+  virtual void NotifyReadableForTest() {}
+  virtual void NotifyWritableForTest() {}
+
+ private:
+  // One more slot than |capacity|, so that a full queue can be told from an
+  // empty one.
+  std::vector<Buffer> slots_;
+  // Only written by the reading thread.
+  volatile int read_pos_;
+  // Only written by the writing thread.
+  volatile int write_pos_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LockFreeBufferQueue);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_LOCKFREEBUFFERQUEUE_H_
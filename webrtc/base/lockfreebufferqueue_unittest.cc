@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/lockfreebufferqueue.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace rtc {
+
+namespace {
+
+const int kNumPackets = 10000;
+
+struct ProducerState {
+  LockFreeBufferQueue* queue;
+  int next_packet;
+};
+
+bool WritePackets(void* obj) {
+  ProducerState* state = static_cast<ProducerState*>(obj);
+  if (state->next_packet == kNumPackets)
+    return false;
+  // Packets of varying size, some larger than the preallocated buffers.
+  char packet[64];
+  size_t size = 1 + state->next_packet % sizeof(packet);
+  memset(packet, state->next_packet & 0xff, size);
+  if (state->queue->WriteBack(packet, size, nullptr))
+    ++state->next_packet;
+  return true;
+}
+
+}  // namespace
+
+TEST(LockFreeBufferQueueTest, TestAll) {
+  const size_t kSize = 16;
+  const char in[kSize * 2 + 1] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+  char out[kSize * 2];
+  size_t bytes;
+  LockFreeBufferQueue queue1(1, kSize);
+  LockFreeBufferQueue queue2(2, kSize);
+
+  // The queue is initially empty.
+  EXPECT_EQ(0u, queue1.size());
+  EXPECT_FALSE(queue1.ReadFront(out, kSize, &bytes));
+
+  // A write should succeed.
+  EXPECT_TRUE(queue1.WriteBack(in, kSize, &bytes));
+  EXPECT_EQ(kSize, bytes);
+  EXPECT_EQ(1u, queue1.size());
+
+  // The queue is full now (only one buffer allowed).
+  EXPECT_FALSE(queue1.WriteBack(in, kSize, &bytes));
+  EXPECT_EQ(1u, queue1.size());
+
+  // Reading previously written buffer.
+  EXPECT_TRUE(queue1.ReadFront(out, kSize, &bytes));
+  EXPECT_EQ(kSize, bytes);
+  EXPECT_EQ(0, memcmp(in, out, kSize));
+
+  // The queue is empty again now.
+  EXPECT_FALSE(queue1.ReadFront(out, kSize, &bytes));
+  EXPECT_EQ(0u, queue1.size());
+
+  // Buffers larger than the default size are kept whole.
+  EXPECT_TRUE(queue1.WriteBack(in, kSize * 2, &bytes));
+  EXPECT_EQ(kSize * 2, bytes);
+  EXPECT_TRUE(queue1.ReadFront(out, kSize * 2, &bytes));
+  EXPECT_EQ(kSize * 2, bytes);
+  EXPECT_EQ(0, memcmp(in, out, kSize * 2));
+
+  // Reading maintains buffer boundaries, and truncates buffers.
+  EXPECT_TRUE(queue2.WriteBack(in, kSize / 2, &bytes));
+  EXPECT_TRUE(queue2.WriteBack(in + kSize / 2, kSize / 2, &bytes));
+  EXPECT_EQ(2u, queue2.size());
+  EXPECT_FALSE(queue2.WriteBack(in, kSize, &bytes));
+  EXPECT_TRUE(queue2.ReadFront(out, kSize / 4, &bytes));
+  EXPECT_EQ(kSize / 4, bytes);
+  EXPECT_EQ(0, memcmp(in, out, kSize / 4));
+  EXPECT_EQ(1u, queue2.size());
+  // The ring wraps around.
+  EXPECT_TRUE(queue2.WriteBack(in, kSize, &bytes));
+  EXPECT_TRUE(queue2.ReadFront(out, kSize, &bytes));
+  EXPECT_EQ(kSize / 2, bytes);
+  EXPECT_EQ(0, memcmp(in + kSize / 2, out, kSize / 2));
+  EXPECT_TRUE(queue2.ReadFront(out, kSize, &bytes));
+  EXPECT_EQ(kSize, bytes);
+  EXPECT_EQ(0, memcmp(in, out, kSize));
+  EXPECT_EQ(0u, queue2.size());
+}
+
+TEST(LockFreeBufferQueueTest, TestWriterThread) {
+  LockFreeBufferQueue queue(8, 32);
+  ProducerState state = {&queue, 0};
+  PlatformThread thread(&WritePackets, &state, "LockFreeBufferQueueWriter");
+  thread.Start();
+
+  for (int i = 0; i < kNumPackets;) {
+    char packet[64];
+    size_t bytes;
+    if (!queue.ReadFront(packet, sizeof(packet), &bytes))
+      continue;
+    ASSERT_EQ(1 + i % sizeof(packet), bytes);
+    for (size_t j = 0; j < bytes; ++j)
+      ASSERT_EQ(static_cast<char>(i & 0xff), packet[j]);
+    ++i;
+  }
+  thread.Stop();
+  EXPECT_EQ(0u, queue.size());
+}
+
+}  // namespace rtc
@@ -11,6 +11,7 @@
 #include "webrtc/base/fileutils.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/logsinks.h"
 #include "webrtc/base/pathutils.h"
 #include "webrtc/base/stream.h"
 #include "webrtc/base/thread.h"
@@ -152,4 +153,62 @@ TEST(LogTest, Perf) {
   LOG(LS_INFO) << "Average log time: " << TimeDiff(finish, start) << " us";
 }
 
+// Records messages, and blocks in the first one until released.
+class BlockingLogSink : public LogSink {
+ public:
+  BlockingLogSink() : entered_(false, false), released_(false, false) {}
+
+  void OnLogMessage(const std::string& message) override {
+    messages_.push_back(message);
+    if (messages_.size() == 1) {
+      entered_.Set();
+      released_.Wait(Event::kForever);
+    }
+  }
+
+  std::vector<std::string> messages_;
+  Event entered_;
+  Event released_;
+};
+
+TEST(LogTest, AsyncSinkPassesMessagesOn) {
+  std::string str;
+  LogSinkImpl<StringStream> stream(&str);
+  {
+    AsyncLogSink async_sink(&stream, 1024);
+    async_sink.OnLogMessage("first ");
+    async_sink.OnLogMessage("second");
+    async_sink.Flush();
+    EXPECT_EQ("first second", str);
+    async_sink.OnLogMessage(" third");
+  }
+  // Destruction writes out the rest.
+  EXPECT_EQ("first second third", str);
+}
+
+TEST(LogTest, AsyncSinkDropsMessagesWhenFull) {
+  const size_t kBufferSize = 100;
+  const std::string kMessage(20, 'x');
+  const size_t kRecordSize = sizeof(size_t) + kMessage.size();
+  BlockingLogSink sink;
+  AsyncLogSink async_sink(&sink, kBufferSize);
+  // Fill more than half of the buffer, so that the writer starts right away,
+  // and wait for it to block in the wrapped sink.
+  async_sink.OnLogMessage(std::string(kBufferSize / 2, 'a'));
+  ASSERT_TRUE(sink.entered_.Wait(10000));
+
+  const int kNumMessages = 10;
+  const int kNumFitting = kBufferSize / kRecordSize;
+  for (int i = 0; i < kNumMessages; ++i)
+    async_sink.OnLogMessage(kMessage);
+  EXPECT_EQ(kNumMessages - kNumFitting, async_sink.dropped_messages());
+
+  sink.released_.Set();
+  async_sink.Flush();
+  ASSERT_EQ(static_cast<size_t>(1 + kNumFitting + 1), sink.messages_.size());
+  EXPECT_EQ(kMessage, sink.messages_[kNumFitting]);
+  EXPECT_NE(std::string::npos,
+            sink.messages_.back().find("dropped 7 log messages"));
+}
+
 }  // namespace rtc
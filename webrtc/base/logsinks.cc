@@ -10,7 +10,10 @@
 
 #include "webrtc/base/logsinks.h"
 
+#include <string.h>
+
 #include <iostream>
+#include <sstream>
 #include <string>
 
 #include "webrtc/base/checks.h"
@@ -61,4 +64,102 @@ CallSessionFileRotatingLogSink::CallSessionFileRotatingLogSink(
 CallSessionFileRotatingLogSink::~CallSessionFileRotatingLogSink() {
 }
 
+namespace {
+// How long buffered messages may wait for the writer thread, unless the
+// buffer fills up first.
+const int kWriteIntervalMs = 100;
+}  // namespace
+
+AsyncLogSink::AsyncLogSink(LogSink* sink, size_t buffer_size)
+    : sink_(sink),
+      buffer_size_(buffer_size),
+      dropped_messages_(0),
+      unreported_drops_(0),
+      stopping_(false),
+      wake_(false, false),
+      thread_(&AsyncLogSink::WriterThread, this, "AsyncLogSink") {
+  RTC_DCHECK(sink);
+  RTC_DCHECK_GT(buffer_size, 0u);
+  // Both buffers keep their capacity when swapped, so logging never
+  // allocates once they have reached |buffer_size|.
+  pending_.reserve(buffer_size);
+  writing_.reserve(buffer_size);
+  thread_.Start();
+  thread_.SetPriority(kLowPriority);
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+  Flush();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  const size_t length = message.size();
+  bool wake = false;
+  {
+    CritScope lock(&crit_);
+    if (pending_.size() + sizeof(length) + length > buffer_size_) {
+      ++dropped_messages_;
+      ++unreported_drops_;
+      return;
+    }
+    pending_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    pending_.append(message);
+    // Write early rather than drop messages when there's a burst.
+    wake = pending_.size() > buffer_size_ / 2;
+  }
+  if (wake)
+    wake_.Set();
+}
+
+void AsyncLogSink::Flush() {
+  WritePending();
+}
+
+int AsyncLogSink::dropped_messages() const {
+  CritScope lock(&crit_);
+  return dropped_messages_;
+}
+
+bool AsyncLogSink::WriterThread(void* obj) {
+  return static_cast<AsyncLogSink*>(obj)->Process();
+}
+
+bool AsyncLogSink::Process() {
+  wake_.Wait(kWriteIntervalMs);
+  WritePending();
+  CritScope lock(&crit_);
+  return !stopping_;
+}
+
+void AsyncLogSink::WritePending() {
+  CritScope write_lock(&write_crit_);
+  int drops;
+  {
+    CritScope lock(&crit_);
+    pending_.swap(writing_);
+    drops = unreported_drops_;
+    unreported_drops_ = 0;
+  }
+  size_t pos = 0;
+  while (pos < writing_.size()) {
+    size_t length;
+    memcpy(&length, writing_.data() + pos, sizeof(length));
+    pos += sizeof(length);
+    sink_->OnLogMessage(writing_.substr(pos, length));
+    pos += length;
+  }
+  writing_.clear();
+  if (drops > 0) {
+    std::ostringstream oss;
+    oss << "AsyncLogSink: dropped " << drops << " log messages." << std::endl;
+    sink_->OnLogMessage(oss.str());
+  }
+}
+
 }  // namespace rtc
@@ -14,9 +14,13 @@
 #include <string>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/filerotatingstream.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/thread_annotations.h"
 
 namespace rtc {
 
@@ -63,6 +67,49 @@ class CallSessionFileRotatingLogSink : public FileRotatingLogSink {
   RTC_DISALLOW_COPY_AND_ASSIGN(CallSessionFileRotatingLogSink);
 };
 
+// Log sink that passes messages on to another sink from a thread of its own,
+// so that logging threads never wait for a slow sink such as a file on flash.
+// Logging a message only copies it into a buffer of fixed size. When the
+// buffer is full, messages are dropped and counted, and the writer thread
+// reports the count to the wrapped sink.
+class AsyncLogSink : public LogSink {
+ public:
+  // |sink| must outlive this object. |buffer_size| bounds the bytes of
+  // messages waiting to be written.
+  AsyncLogSink(LogSink* sink, size_t buffer_size);
+  // Writes out all buffered messages before returning.
+  ~AsyncLogSink() override;
+
+  void OnLogMessage(const std::string& message) override;
+
+  // Passes all messages logged so far on to the wrapped sink before
+  // returning.
+  void Flush();
+
+  int dropped_messages() const;
+
+ private:
+  static bool WriterThread(void* obj);
+  bool Process();
+  void WritePending();
+
+  LogSink* const sink_;
+  const size_t buffer_size_;
+  mutable CriticalSection crit_;
+  // Records of a size_t length followed by the message.
+  std::string pending_ GUARDED_BY(crit_);
+  int dropped_messages_ GUARDED_BY(crit_);
+  int unreported_drops_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+  // Held by whichever thread is writing to |sink_|.
+  CriticalSection write_crit_;
+  std::string writing_ GUARDED_BY(write_crit_);
+  Event wake_;
+  PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+};
+
 }  // namespace rtc
 
 #endif  // WEBRTC_BASE_FILE_ROTATING_LOG_SINK_H_
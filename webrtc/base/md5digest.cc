@@ -29,4 +29,9 @@ size_t Md5Digest::Finish(void* buf, size_t len) {
   return kSize;
 }
 
+bool Md5Digest::CopyStateFrom(const MessageDigest& other) {
+  ctx_ = static_cast<const Md5Digest&>(other).ctx_;
+  return true;
+}
+
 };  // namespace rtc
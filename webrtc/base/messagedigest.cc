@@ -179,4 +179,75 @@ std::string ComputeHmac(const std::string& alg, const std::string& key,
   return output;
 }
 
+HmacDigest::HmacDigest(const std::string& alg,
+                       const void* key,
+                       size_t key_len)
+    : inner_(MessageDigestFactory::Create(alg)),
+      outer_(MessageDigestFactory::Create(alg)) {
+  // We only handle algorithms with a 64-byte blocksize.
+  if (!inner_ || !outer_ || inner_->Size() > 32) {
+    inner_.reset();
+    outer_.reset();
+    return;
+  }
+  // Copy the key to a block-sized buffer to simplify padding.
+  // If the key is longer than a block, hash it and use the result instead.
+  uint8_t new_key[kBlockSize];
+  if (key_len > kBlockSize) {
+    ComputeDigest(inner_.get(), key, key_len, new_key, kBlockSize);
+    memset(new_key + inner_->Size(), 0, kBlockSize - inner_->Size());
+  } else {
+    memcpy(new_key, key, key_len);
+    memset(new_key + key_len, 0, kBlockSize - key_len);
+  }
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    o_pad_[i] = 0x5c ^ new_key[i];
+    i_pad_[i] = 0x36 ^ new_key[i];
+  }
+
+  keyed_inner_.reset(MessageDigestFactory::Create(alg));
+  keyed_outer_.reset(MessageDigestFactory::Create(alg));
+  keyed_inner_->Update(i_pad_, kBlockSize);
+  keyed_outer_->Update(o_pad_, kBlockSize);
+  if (!inner_->CopyStateFrom(*keyed_inner_)) {
+    keyed_inner_.reset();
+    keyed_outer_.reset();
+    inner_->Update(i_pad_, kBlockSize);
+  }
+}
+
+HmacDigest::~HmacDigest() {}
+
+size_t HmacDigest::Size() const {
+  return inner_ ? inner_->Size() : 0;
+}
+
+void HmacDigest::Update(const void* buf, size_t len) {
+  if (inner_) {
+    inner_->Update(buf, len);
+  }
+}
+
+size_t HmacDigest::Finish(void* buf, size_t len) {
+  if (!inner_ || len < Size()) {
+    return 0;
+  }
+  // Inner hash; the inner padding and the input are in |inner_| already.
+  uint8_t inner[kMaxSize];
+  size_t inner_len = inner_->Finish(inner, sizeof(inner));
+  StartWithKey(inner_.get(), keyed_inner_.get(), i_pad_);
+  // Outer hash; hash the outer padding, and then the result of the inner hash.
+  StartWithKey(outer_.get(), keyed_outer_.get(), o_pad_);
+  outer_->Update(inner, inner_len);
+  return outer_->Finish(buf, len);
+}
+
+void HmacDigest::StartWithKey(MessageDigest* digest,
+                              const MessageDigest* keyed,
+                              const uint8_t* pad) {
+  if (!keyed || !digest->CopyStateFrom(*keyed)) {
+    digest->Update(pad, kBlockSize);
+  }
+}
+
 }  // namespace rtc
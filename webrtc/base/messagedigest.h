@@ -13,6 +13,8 @@
 
 #include <string>
 
+#include "webrtc/base/scoped_ptr.h"
+
 namespace rtc {
 
 // Definitions for the digest algorithms.
@@ -35,6 +37,11 @@ class MessageDigest {
   // Outputs the digest value to |buf| with length |len|.
   // Returns the number of bytes written, i.e., Size().
   virtual size_t Finish(void* buf, size_t len) = 0;
+  // Puts this digest in the same state as |other|, which must have been
+  // created by MessageDigestFactory for the same algorithm, so that data both
+  // start with only has to be hashed once. Returns false if this kind of
+  // digest can't do that.
+  virtual bool CopyStateFrom(const MessageDigest& other) { return false; }
 };
 
 // A factory class for creating digest objects.
@@ -104,6 +111,38 @@ std::string ComputeHmac(const std::string& alg, const std::string& key,
 bool ComputeHmac(const std::string& alg, const std::string& key,
                  const std::string& input, std::string* output);
 
+// An RFC 2104 HMAC with a fixed key, for computing the HMACs of many messages
+// with the same key. The hash states after the inner and outer key pads are
+// kept, so each message costs only the hashing of the message itself. Like
+// other digests, it is ready for the next message after Finish(). Size() is 0
+// if there is no digest called |alg|.
+class HmacDigest : public MessageDigest {
+ public:
+  HmacDigest(const std::string& alg, const void* key, size_t key_len);
+  ~HmacDigest() override;
+  size_t Size() const override;
+  void Update(const void* buf, size_t len) override;
+  size_t Finish(void* buf, size_t len) override;
+
+ private:
+  enum { kBlockSize = 64 };
+
+  // Starts |digest| off from |keyed|, or by hashing |pad| if |keyed| is NULL.
+  static void StartWithKey(MessageDigest* digest,
+                           const MessageDigest* keyed,
+                           const uint8_t* pad);
+
+  scoped_ptr<MessageDigest> inner_;
+  scoped_ptr<MessageDigest> outer_;
+  // The states of |inner_| and |outer_| right after their pads, or NULL if
+  // the digest can't copy its state, in which case the pads are hashed again
+  // for every message.
+  scoped_ptr<MessageDigest> keyed_inner_;
+  scoped_ptr<MessageDigest> keyed_outer_;
+  uint8_t i_pad_[kBlockSize];
+  uint8_t o_pad_[kBlockSize];
+};
+
 }  // namespace rtc
 
 #endif  // WEBRTC_BASE_MESSAGEDIGEST_H_
@@ -142,10 +142,48 @@ TEST(MessageDigestTest, TestSha1Hmac) {
           input.c_str(), input.size(), output, sizeof(output) - 1));
 }
 
+// Computes the hex-encoded HMAC of |input| with |hmac|, in two pieces.
+static std::string HexHmac(HmacDigest* hmac, const std::string& input) {
+  char output[MessageDigest::kMaxSize];
+  size_t half = input.size() / 2;
+  hmac->Update(input.data(), half);
+  hmac->Update(input.data() + half, input.size() - half);
+  size_t len = hmac->Finish(output, sizeof(output));
+  return hex_encode(output, len);
+}
+
+// A keyed HmacDigest gives the same results as ComputeHmac, for every message
+// it's used for.
+TEST(MessageDigestTest, TestHmacDigest) {
+  HmacDigest hmac(DIGEST_SHA_1, "Jefe", 4);
+  EXPECT_EQ(20U, hmac.Size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ("effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+              HexHmac(&hmac, "what do ya want for nothing?"));
+    EXPECT_EQ(ComputeHmac(DIGEST_SHA_1, "Jefe", "Hi There"),
+              HexHmac(&hmac, "Hi There"));
+  }
+
+  std::string long_key(80, '\xaa');
+  HmacDigest long_key_hmac(DIGEST_SHA_1, long_key.data(), long_key.size());
+  EXPECT_EQ("aa4ae5e15272d00e95705637ce8a3b55ed402112",
+            HexHmac(&long_key_hmac,
+                    "Test Using Larger Than Block-Size Key - Hash Key First"));
+
+  HmacDigest md5_hmac(DIGEST_MD5, "Jefe", 4);
+  EXPECT_EQ("750c783e6ab0b503eaa86e310a5db738",
+            HexHmac(&md5_hmac, "what do ya want for nothing?"));
+
+  char output[20];
+  EXPECT_EQ(0U, hmac.Finish(output, sizeof(output) - 1));
+}
+
 TEST(MessageDigestTest, TestBadHmac) {
   std::string output;
   EXPECT_FALSE(ComputeHmac("sha-9000", "key", "abc", &output));
   EXPECT_EQ("", ComputeHmac("sha-9000", "key", "abc"));
+  HmacDigest hmac("sha-9000", "key", 3);
+  EXPECT_EQ(0U, hmac.Size());
 }
 
 }  // namespace rtc
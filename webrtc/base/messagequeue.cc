@@ -113,12 +113,331 @@ void MessageQueueManager::ClearInternal(MessageHandler *handler) {
     (*iter)->Clear(handler);
 }
 
+//------------------------------------------------------------------
+// PendingMessageQueue
+
+namespace {
+const size_t kNodesPerBlock = 64;
+
+int CountTrailingZeros(uint64_t word) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  int count = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// Returns true if |a| should become ready before |b|.
+template <typename Node>
+bool TriggersBefore(const Node* a, const Node* b) {
+  if (a->trigger != b->trigger)
+    return TimeIsLater(a->trigger, b->trigger);
+  return a->seq < b->seq;
+}
+}  // namespace
+
+struct PendingMessageQueue::Node {
+  Message msg;
+  uint32_t trigger;
+  uint64_t seq;
+  // The ready list or the wheel slot that this node is on.
+  List* list;
+  Node* prev;
+  Node* next;
+  Node* handler_prev;
+  Node* handler_next;
+};
+
+PendingMessageQueue::PendingMessageQueue()
+    : num_ready_(0),
+      num_delayed_(0),
+      wheel_time_(0),
+      next_seq_(0),
+      free_nodes_(NULL) {
+  memset(occupied_, 0, sizeof(occupied_));
+}
+
+PendingMessageQueue::~PendingMessageQueue() {
+  for (Node* block : blocks_)
+    delete[] block;
+}
+
+void PendingMessageQueue::PushReady(const Message& msg) {
+  Node* node = AllocateNode(msg);
+  node->seq = next_seq_++;
+  Insert(&ready_, ready_.tail, node);
+  ++num_ready_;
+}
+
+bool PendingMessageQueue::PopReady(Message* msg) {
+  Node* node = ready_.head;
+  if (!node)
+    return false;
+  Unlink(node);
+  --num_ready_;
+  *msg = node->msg;
+  FreeNode(node);
+  return true;
+}
+
+void PendingMessageQueue::PushDelayed(const Message& msg,
+                                      uint32_t trigger,
+                                      uint32_t now) {
+  // Nothing is pending, so the wheel can be moved to the current time. This
+  // keeps the trigger times within range of |wheel_time_|.
+  if (num_delayed_ == 0)
+    wheel_time_ = now;
+  Node* node = AllocateNode(msg);
+  node->trigger = trigger;
+  node->seq = next_seq_++;
+  InsertInWheel(node);
+  ++num_delayed_;
+}
+
+void PendingMessageQueue::AdvanceTo(uint32_t now) {
+  while (num_delayed_ > 0 && !TimeIsLater(now, wheel_time_)) {
+    size_t index = wheel_time_ & (kLevel0Slots - 1);
+    if (index == 0)
+      Cascade();
+    // Skip to the next occupied slot, or to where the next cascade is due.
+    int slot = NextOccupiedSlot(index);
+    uint32_t slot_time =
+        wheel_time_ + (slot < 0 ? kLevel0Slots : static_cast<size_t>(slot)) -
+        index;
+    if (TimeIsLater(now, slot_time)) {
+      wheel_time_ = now + 1;
+      break;
+    }
+    wheel_time_ = slot_time;
+    if (slot < 0)
+      continue;
+    List* list = &slots_[slot];
+    while (list->head) {
+      Node* node = list->head;
+      Unlink(node);
+      --num_delayed_;
+      node->seq = next_seq_++;
+      Insert(&ready_, ready_.tail, node);
+      ++num_ready_;
+    }
+    ++wheel_time_;
+  }
+}
+
+int PendingMessageQueue::DelayUntilNext(uint32_t now) const {
+  if (num_delayed_ == 0)
+    return MessageQueue::kForever;
+  size_t index = wheel_time_ & (kLevel0Slots - 1);
+  uint32_t time = wheel_time_;
+  // At the start of a level 0 turn the higher levels may not have been
+  // cascaded yet, so anything could be due.
+  if (index != 0) {
+    int slot = NextOccupiedSlot(index);
+    time += (slot < 0 ? kLevel0Slots : static_cast<size_t>(slot)) - index;
+  }
+  return std::max(0, TimeDiff(time, now));
+}
+
+void PendingMessageQueue::Clear(MessageHandler* phandler,
+                                uint32_t id,
+                                MessageList* removed) {
+  std::vector<Node*> matches;
+  for (auto it = phandler ? handlers_.find(phandler) : handlers_.begin();
+       it != handlers_.end(); ++it) {
+    for (Node* node = it->second; node; node = node->handler_next) {
+      if (node->msg.Match(phandler, id))
+        matches.push_back(node);
+    }
+    if (phandler)
+      break;
+  }
+
+  if (removed) {
+    std::sort(matches.begin(), matches.end(),
+              [this](const Node* a, const Node* b) {
+                bool a_ready = a->list == &ready_;
+                bool b_ready = b->list == &ready_;
+                if (a_ready != b_ready)
+                  return a_ready;
+                return a_ready ? a->seq < b->seq : TriggersBefore(a, b);
+              });
+  }
+
+  // Take all the messages out before deleting any data, in case a destructor
+  // posts to, or clears, this queue.
+  for (Node* node : matches) {
+    if (node->list == &ready_)
+      --num_ready_;
+    else
+      --num_delayed_;
+    Unlink(node);
+    RemoveFromHandler(node);
+  }
+  if (id == MQID_ANY) {
+    if (phandler)
+      handlers_.erase(phandler);
+    else
+      handlers_.clear();
+  }
+  for (Node* node : matches) {
+    if (removed)
+      removed->push_back(node->msg);
+    else
+      delete node->msg.pdata;
+    node->next = free_nodes_;
+    free_nodes_ = node;
+  }
+}
+
+PendingMessageQueue::Node* PendingMessageQueue::AllocateNode(
+    const Message& msg) {
+  if (!free_nodes_) {
+    Node* block = new Node[kNodesPerBlock];
+    blocks_.push_back(block);
+    for (size_t i = 0; i < kNodesPerBlock; ++i) {
+      block[i].next = free_nodes_;
+      free_nodes_ = &block[i];
+    }
+  }
+  Node* node = free_nodes_;
+  free_nodes_ = node->next;
+  node->msg = msg;
+  node->trigger = 0;
+  node->list = NULL;
+  node->prev = node->next = NULL;
+
+  Node*& head = handlers_[msg.phandler];
+  node->handler_prev = NULL;
+  node->handler_next = head;
+  if (head)
+    head->handler_prev = node;
+  head = node;
+  return node;
+}
+
+void PendingMessageQueue::FreeNode(Node* node) {
+  RemoveFromHandler(node);
+  node->next = free_nodes_;
+  free_nodes_ = node;
+}
+
+void PendingMessageQueue::RemoveFromHandler(Node* node) {
+  if (node->handler_prev)
+    node->handler_prev->handler_next = node->handler_next;
+  else
+    handlers_[node->msg.phandler] = node->handler_next;
+  if (node->handler_next)
+    node->handler_next->handler_prev = node->handler_prev;
+}
+
+void PendingMessageQueue::Insert(List* list, Node* after, Node* node) {
+  node->list = list;
+  node->prev = after;
+  node->next = after ? after->next : list->head;
+  if (node->next)
+    node->next->prev = node;
+  else
+    list->tail = node;
+  if (after)
+    after->next = node;
+  else
+    list->head = node;
+}
+
+void PendingMessageQueue::Unlink(Node* node) {
+  List* list = node->list;
+  if (node->prev)
+    node->prev->next = node->next;
+  else
+    list->head = node->next;
+  if (node->next)
+    node->next->prev = node->prev;
+  else
+    list->tail = node->prev;
+  node->list = NULL;
+
+  if (list != &ready_ && !list->head) {
+    size_t slot = list - slots_;
+    if (slot < kLevel0Slots)
+      occupied_[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+  }
+}
+
+void PendingMessageQueue::InsertInWheel(Node* node) {
+  int32_t delta = TimeDiff(node->trigger, wheel_time_);
+  uint32_t time = node->trigger;
+  if (delta < 0) {
+    // Already due, so make it ready on the next advance.
+    delta = 0;
+    time = wheel_time_;
+  }
+
+  if (delta < static_cast<int32_t>(kLevel0Slots)) {
+    size_t slot = time & (kLevel0Slots - 1);
+    List* list = &slots_[slot];
+    // Level 0 slots are kept in the order the messages become ready in. New
+    // messages normally go last, so search from the back.
+    Node* after = list->tail;
+    while (after && TriggersBefore(node, after))
+      after = after->prev;
+    Insert(list, after, node);
+    occupied_[slot / 64] |= uint64_t(1) << (slot % 64);
+    return;
+  }
+
+  size_t slot = kLevel0Slots;
+  int shift = kLevel0Bits;
+  for (int level = 1; level < kNumLevels - 1; ++level) {
+    if (delta < (int32_t(1) << (shift + kLevelBits)))
+      break;
+    shift += kLevelBits;
+    slot += kLevelSlots;
+  }
+  slot += (time >> shift) & (kLevelSlots - 1);
+  Insert(&slots_[slot], slots_[slot].tail, node);
+}
+
+void PendingMessageQueue::Cascade() {
+  size_t base = kLevel0Slots;
+  int shift = kLevel0Bits;
+  for (int level = 1; level < kNumLevels; ++level) {
+    size_t index = (wheel_time_ >> shift) & (kLevelSlots - 1);
+    Node* node = slots_[base + index].head;
+    slots_[base + index] = List();
+    while (node) {
+      Node* next = node->next;
+      InsertInWheel(node);
+      node = next;
+    }
+    // The next level only needs to be cascaded when this one has wrapped.
+    if (index != 0)
+      break;
+    base += kLevelSlots;
+    shift += kLevelBits;
+  }
+}
+
+int PendingMessageQueue::NextOccupiedSlot(size_t index) const {
+  for (size_t word = index / 64; word < kLevel0Slots / 64; ++word) {
+    uint64_t bits = occupied_[word];
+    if (word == index / 64)
+      bits &= ~uint64_t(0) << (index % 64);
+    if (bits)
+      return static_cast<int>(word * 64 + CountTrailingZeros(bits));
+  }
+  return -1;
+}
+
 //------------------------------------------------------------------
 // MessageQueue
 
 MessageQueue::MessageQueue(SocketServer* ss)
-    : ss_(ss), fStop_(false), fPeekKeep_(false),
-      dmsgq_next_num_(0) {
+    : ss_(ss), fStop_(false), fPeekKeep_(false) {
   if (!ss_) {
     // Currently, MessageQueue holds a socket server, and is the base class for
     // Thread.  It seems like it makes more sense for Thread to hold the socket
@@ -207,22 +526,12 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (TimeIsLater(msCurrent, dmsgq_.top().msTrigger_)) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
-          }
+          msgq_.AdvanceTo(msCurrent);
+          cmsDelayNext = msgq_.DelayUntilNext(msCurrent);
         }
         // Pull a message off the message queue, if available.
-        if (msgq_.empty()) {
+        if (!msgq_.PopReady(pmsg))
           break;
-        } else {
-          *pmsg = msgq_.front();
-          msgq_.pop_front();
-        }
       }  // crit_ is released here.
 
       // Log a warning for time-sensitive messages that we're late to deliver.
@@ -295,7 +604,7 @@ void MessageQueue::Post(MessageHandler* phandler,
   if (time_sensitive) {
     msg.ts_sensitive = Time() + kMaxMsgLatency;
   }
-  msgq_.push_back(msg);
+  msgq_.PushReady(msg);
   ss_->WakeUp();
 }
 
@@ -303,18 +612,17 @@ void MessageQueue::PostDelayed(int cmsDelay,
                                MessageHandler* phandler,
                                uint32_t id,
                                MessageData* pdata) {
-  return DoDelayPost(cmsDelay, TimeAfter(cmsDelay), phandler, id, pdata);
+  return DoDelayPost(TimeAfter(cmsDelay), phandler, id, pdata);
 }
 
 void MessageQueue::PostAt(uint32_t tstamp,
                           MessageHandler* phandler,
                           uint32_t id,
                           MessageData* pdata) {
-  return DoDelayPost(TimeUntil(tstamp), tstamp, phandler, id, pdata);
+  return DoDelayPost(tstamp, phandler, id, pdata);
 }
 
-void MessageQueue::DoDelayPost(int cmsDelay,
-                               uint32_t tstamp,
+void MessageQueue::DoDelayPost(uint32_t tstamp,
                                MessageHandler* phandler,
                                uint32_t id,
                                MessageData* pdata) {
@@ -322,7 +630,7 @@ void MessageQueue::DoDelayPost(int cmsDelay,
     return;
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timer wheel. Gets sorted soonest first.
   // Signal for the multiplexer to return.
 
   CritScope cs(&crit_);
@@ -330,29 +638,17 @@ void MessageQueue::DoDelayPost(int cmsDelay,
   msg.phandler = phandler;
   msg.message_id = id;
   msg.pdata = pdata;
-  DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-  dmsgq_.push(dmsg);
-  // If this message queue processes 1 message every millisecond for 50 days,
-  // we will wrap this number.  Even then, only messages with identical times
-  // will be misordered, and then only briefly.  This is probably ok.
-  VERIFY(0 != ++dmsgq_next_num_);
+  msgq_.PushDelayed(msg, tstamp, Time());
   ss_->WakeUp();
 }
 
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
 
-  if (!msgq_.empty())
+  if (msgq_.num_ready() > 0)
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
-    if (delay < 0)
-      delay = 0;
-    return delay;
-  }
-
-  return kForever;
+  return msgq_.DelayUntilNext(Time());
 }
 
 void MessageQueue::Clear(MessageHandler* phandler,
@@ -371,38 +667,9 @@ void MessageQueue::Clear(MessageHandler* phandler,
     fPeekKeep_ = false;
   }
 
-  // Remove from ordered message queue
+  // Remove from the ready and the delayed messages
 
-  for (MessageList::iterator it = msgq_.begin(); it != msgq_.end();) {
-    if (it->Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(*it);
-      } else {
-        delete it->pdata;
-      }
-      it = msgq_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // Remove from priority queue. Not directly iterable, so use this approach
-
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
-    } else {
-      *new_end++ = *it;
-    }
-  }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
+  msgq_.Clear(phandler, id, removed);
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
@@ -15,7 +15,7 @@
 
 #include <algorithm>
 #include <list>
-#include <queue>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/base/basictypes.h"
@@ -144,23 +144,91 @@ struct Message {
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
-// with the same trigger time are processed in num_ (FIFO) order.
-
-class DelayedMessage {
+// The messages of a MessageQueue that haven't been retrieved yet. Messages
+// that are ready are kept in FIFO order. Delayed messages are kept in a
+// hierarchical timer wheel, so that posting one is O(1) whatever the delay,
+// and become ready in order of trigger time as time advances. Messages with
+// the same trigger time become ready in the order they were posted. All
+// messages are also linked per handler, so that clearing the messages of a
+// handler only touches those. Message nodes are pooled. Not thread safe.
+class PendingMessageQueue {
  public:
-  DelayedMessage(int delay, uint32_t trigger, uint32_t num, const Message& msg)
-      : cmsDelay_(delay), msTrigger_(trigger), num_(num), msg_(msg) {}
+  PendingMessageQueue();
+  // Does not delete the MessageData of the messages that are left.
+  ~PendingMessageQueue();
+
+  size_t size() const { return num_ready_ + num_delayed_; }
+  size_t num_ready() const { return num_ready_; }
+  size_t num_delayed() const { return num_delayed_; }
+
+  void PushReady(const Message& msg);
+  bool PopReady(Message* msg);
+
+  // Adds a message, posted at |now|, that becomes ready at |trigger|.
+  void PushDelayed(const Message& msg, uint32_t trigger, uint32_t now);
+  // Makes the delayed messages with a trigger time up to and including |now|
+  // ready.
+  void AdvanceTo(uint32_t now);
+  // Returns the time in ms from |now| until delayed messages may become
+  // ready, or MessageQueue::kForever if there are none. This may be earlier
+  // than the first trigger time, but never later.
+  int DelayUntilNext(uint32_t now) const;
+
+  // Removes the messages that match |phandler| and |id|. The ready ones are
+  // added to |removed| in order, followed by the delayed ones in trigger time
+  // order. If |removed| is NULL, their MessageData is deleted.
+  void Clear(MessageHandler* phandler, uint32_t id, MessageList* removed);
 
-  bool operator< (const DelayedMessage& dmsg) const {
-    return (dmsg.msTrigger_ < msTrigger_)
-           || ((dmsg.msTrigger_ == msTrigger_) && (dmsg.num_ < num_));
-  }
+ private:
+  struct Node;
+  struct List {
+    List() : head(NULL), tail(NULL) {}
+    Node* head;
+    Node* tail;
+  };
 
-  int cmsDelay_;  // for debugging
-  uint32_t msTrigger_;
-  uint32_t num_;
-  Message msg_;
+  // The wheel has one level of 256 slots of 1 ms, followed by four levels of
+  // 64 slots where each slot spans all of the previous level, covering the
+  // whole 32 bit range of time stamps.
+  static const int kLevel0Bits = 8;
+  static const int kLevelBits = 6;
+  static const int kNumLevels = 5;
+  static const size_t kLevel0Slots = 1 << kLevel0Bits;
+  static const size_t kLevelSlots = 1 << kLevelBits;
+  static const size_t kNumSlots =
+      kLevel0Slots + (kNumLevels - 1) * kLevelSlots;
+
+  // Nodes are added to the list of their handler when allocated.
+  Node* AllocateNode(const Message& msg);
+  void FreeNode(Node* node);
+  void RemoveFromHandler(Node* node);
+  // Inserts |node| after |after|, or first if |after| is NULL.
+  void Insert(List* list, Node* after, Node* node);
+  void Unlink(Node* node);
+  // Puts |node| in the slot for its trigger time relative to |wheel_time_|.
+  void InsertInWheel(Node* node);
+  // Moves the delayed messages of the higher level slots that are due within
+  // the next 256 ms to the lower levels.
+  void Cascade();
+  // Returns the first occupied level 0 slot at or after |index|, or -1.
+  int NextOccupiedSlot(size_t index) const;
+
+  List ready_;
+  size_t num_ready_;
+  List slots_[kNumSlots];
+  uint64_t occupied_[kLevel0Slots / 64];  // One bit per level 0 slot.
+  size_t num_delayed_;
+  // All delayed messages due before this time have been made ready.
+  uint32_t wheel_time_;
+  // Orders messages posted with identical trigger times, and ready messages.
+  uint64_t next_seq_;
+  // The messages of each handler. An entry is kept when the handler has no
+  // messages left, until it's cleared, so that posting doesn't allocate.
+  std::unordered_map<MessageHandler*, Node*> handlers_;
+  std::vector<Node*> blocks_;
+  Node* free_nodes_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PendingMessageQueue);
 };
 
 class MessageQueue {
@@ -214,7 +282,7 @@ class MessageQueue {
   bool empty() const { return size() == 0u; }
   size_t size() const {
     CritScope cs(&crit_);  // msgq_.size() is not thread safe.
-    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
+    return msgq_.size() + (fPeekKeep_ ? 1u : 0u);
   }
 
   // Internally posts a message which causes the doomed object to be deleted
@@ -229,14 +297,7 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
-
-  void DoDelayPost(int cmsDelay,
-                   uint32_t tstamp,
+  void DoDelayPost(uint32_t tstamp,
                    MessageHandler* phandler,
                    uint32_t id,
                    MessageData* pdata);
@@ -248,9 +309,8 @@ class MessageQueue {
   bool fStop_;
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList msgq_;
-  PriorityQueue dmsgq_;
-  uint32_t dmsgq_next_num_;
+  // Both the ready and the delayed messages.
+  PendingMessageQueue msgq_;
   mutable CriticalSection crit_;
 
  private:
@@ -10,6 +10,11 @@
 
 #include "webrtc/base/messagequeue.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/arraysize.h"
 #include "webrtc/base/bind.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
@@ -138,3 +143,99 @@ TEST(MessageQueueManager, Clear) {
   EXPECT_TRUE(deleted);
   EXPECT_FALSE(MessageQueueManager::IsInitialized());
 }
+
+namespace {
+Message MakeMessage(MessageHandler* handler, uint32_t id) {
+  Message msg;
+  msg.phandler = handler;
+  msg.message_id = id;
+  return msg;
+}
+}  // namespace
+
+// Delayed messages spread over all levels of the timer wheel, and across the
+// wrap of the time stamps, become ready at their trigger times and in order.
+TEST(PendingMessageQueueTest, DelayedMessagesBecomeReadyInOrder) {
+  const uint32_t kStart = 0xFFFFFFFFu - 5000;
+  const uint32_t kDelays[] = {0,     1,       255,           256,
+                              257,   1000,    16383,         16384,
+                              20000, 1 << 20, 1000,          (1 << 20) + 3,
+                              255,   1 << 26, (1 << 26) + 7, 0};
+  PendingMessageQueue queue;
+  for (size_t i = 0; i < arraysize(kDelays); ++i)
+    queue.PushDelayed(MakeMessage(NULL, i), kStart + kDelays[i], kStart);
+  EXPECT_EQ(arraysize(kDelays), queue.num_delayed());
+
+  std::vector<std::pair<uint32_t, uint32_t>> expected;
+  for (size_t i = 0; i < arraysize(kDelays); ++i)
+    expected.push_back(std::make_pair(kDelays[i], i));
+  std::sort(expected.begin(), expected.end());
+
+  size_t next = 0;
+  uint32_t now = kStart;
+  while (queue.num_delayed() > 0) {
+    int delay = queue.DelayUntilNext(now);
+    ASSERT_GE(delay, 0);
+    // The delay may be early, but never past the next trigger time.
+    ASSERT_LE(static_cast<uint32_t>(delay),
+              expected[next].first - (now - kStart));
+    now += std::max(delay, 1);
+    queue.AdvanceTo(now);
+    Message msg;
+    while (queue.PopReady(&msg)) {
+      ASSERT_LT(next, expected.size());
+      EXPECT_EQ(expected[next].second, msg.message_id);
+      EXPECT_LE(expected[next].first, now - kStart);
+      ++next;
+    }
+  }
+  EXPECT_EQ(expected.size(), next);
+  EXPECT_EQ(0u, queue.size());
+}
+
+TEST(PendingMessageQueueTest, ClearsMessagesOfHandler) {
+  MessageHandler* const kHandler1 = reinterpret_cast<MessageHandler*>(1);
+  MessageHandler* const kHandler2 = reinterpret_cast<MessageHandler*>(2);
+  const uint32_t kNow = 1000;
+  PendingMessageQueue queue;
+  queue.PushDelayed(MakeMessage(kHandler1, 10), kNow + 20000, kNow);
+  queue.PushReady(MakeMessage(kHandler1, 1));
+  queue.PushDelayed(MakeMessage(kHandler2, 20), kNow + 10, kNow);
+  queue.PushDelayed(MakeMessage(kHandler1, 11), kNow + 30000, kNow);
+  queue.PushReady(MakeMessage(kHandler2, 2));
+  queue.PushDelayed(MakeMessage(kHandler1, 3), kNow + 5, kNow);
+  queue.PushReady(MakeMessage(kHandler1, 4));
+  queue.PushDelayed(MakeMessage(kHandler1, 12), kNow + 300, kNow);
+  queue.AdvanceTo(kNow + 5);
+  EXPECT_EQ(4u, queue.num_ready());
+  EXPECT_EQ(4u, queue.num_delayed());
+
+  // Ready messages come first in queue order, then delayed ones in trigger
+  // time order.
+  MessageList removed;
+  queue.Clear(kHandler1, MQID_ANY, &removed);
+  const uint32_t kExpectedIds[] = {1, 4, 3, 12, 10, 11};
+  ASSERT_EQ(arraysize(kExpectedIds), removed.size());
+  size_t i = 0;
+  for (const Message& msg : removed)
+    EXPECT_EQ(kExpectedIds[i++], msg.message_id);
+
+  EXPECT_EQ(1u, queue.num_ready());
+  EXPECT_EQ(1u, queue.num_delayed());
+  queue.AdvanceTo(kNow + 40000);
+  Message msg;
+  EXPECT_TRUE(queue.PopReady(&msg));
+  EXPECT_EQ(2u, msg.message_id);
+  EXPECT_TRUE(queue.PopReady(&msg));
+  EXPECT_EQ(20u, msg.message_id);
+  EXPECT_FALSE(queue.PopReady(&msg));
+
+  // Clearing by id only touches the matching messages.
+  queue.PushReady(MakeMessage(kHandler1, 1));
+  queue.PushDelayed(MakeMessage(kHandler2, 1), kNow + 40100, kNow + 40000);
+  queue.PushDelayed(MakeMessage(kHandler2, 2), kNow + 40100, kNow + 40000);
+  removed.clear();
+  queue.Clear(NULL, 1, &removed);
+  EXPECT_EQ(2u, removed.size());
+  EXPECT_EQ(1u, queue.size());
+}
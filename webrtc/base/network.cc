@@ -44,6 +44,7 @@
 #include "webrtc/base/stream.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 namespace rtc {
 namespace {
@@ -367,6 +368,7 @@ bool NetworkManagerBase::GetDefaultLocalAddress(int family,
 
 BasicNetworkManager::BasicNetworkManager()
     : thread_(NULL), sent_first_update_(false), start_count_(0),
+      has_updated_networks_(false), last_update_time_(0),
       ignore_non_default_routes_(false) {
 }
 
@@ -706,6 +708,17 @@ void BasicNetworkManager::StartUpdating() {
     // to start allocating ports.
     if (sent_first_update_)
       thread_->Post(this, kSignalNetworksMessage);
+  } else if (has_updated_networks_ &&
+             TimeSince(last_update_time_) < kNetworksUpdateIntervalMs) {
+    // The networks were enumerated for a previous client no longer ago than
+    // the polling interval, so they are as fresh as polling would keep them.
+    // Signal them right away and update them when the next update is due.
+    thread_->Post(this, kSignalNetworksMessage);
+    sent_first_update_ = true;
+    thread_->PostDelayed(
+        kNetworksUpdateIntervalMs - TimeSince(last_update_time_), this,
+        kUpdateNetworksMessage);
+    StartNetworkMonitor();
   } else {
     thread_->Post(this, kUpdateNetworksMessage);
     StartNetworkMonitor();
@@ -797,6 +810,8 @@ void BasicNetworkManager::UpdateNetworksOnce() {
     MergeNetworkList(list, &changed, &stats);
     set_default_local_addresses(QueryDefaultLocalAddress(AF_INET),
                                 QueryDefaultLocalAddress(AF_INET6));
+    has_updated_networks_ = true;
+    last_update_time_ = Time();
     if (changed || !sent_first_update_) {
       SignalNetworksChanged();
       sent_first_update_ = true;
@@ -806,7 +821,11 @@ void BasicNetworkManager::UpdateNetworksOnce() {
 
 void BasicNetworkManager::UpdateNetworksContinually() {
   UpdateNetworksOnce();
-  thread_->PostDelayed(kNetworksUpdateIntervalMs, this, kUpdateNetworksMessage);
+  // With a network monitor, networks are updated when it reports a change.
+  if (!network_monitor_) {
+    thread_->PostDelayed(kNetworksUpdateIntervalMs, this,
+                         kUpdateNetworksMessage);
+  }
 }
 
 void BasicNetworkManager::DumpNetworks() {
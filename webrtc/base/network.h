@@ -245,7 +245,8 @@ class BasicNetworkManager : public NetworkManagerBase,
   // Called when it receives updates from the network monitor.
   void OnNetworksChanged();
 
-  // Updates the networks and reschedules the next update.
+  // Updates the networks and, unless a network monitor reports the changes,
+  // reschedules the next update.
   void UpdateNetworksContinually();
   // Only updates the networks; does not reschedule the next update.
   void UpdateNetworksOnce();
@@ -253,6 +254,11 @@ class BasicNetworkManager : public NetworkManagerBase,
   Thread* thread_;
   bool sent_first_update_;
   int start_count_;
+  // When the networks were last enumerated, if they have been. A new client
+  // that starts updating within kNetworksUpdateIntervalMs of that gets the
+  // networks as they are, without enumerating them again.
+  bool has_updated_networks_;
+  uint32_t last_update_time_;
   std::vector<std::string> network_ignore_list_;
   bool ignore_non_default_routes_;
   scoped_ptr<NetworkMonitorInterface> network_monitor_;
@@ -255,6 +255,30 @@ TEST_F(NetworkTest, TestUpdateNetworks) {
   EXPECT_TRUE(callback_called_);
 }
 
+// Test that a client starting to update shortly after the networks were
+// enumerated gets them right away, without them being enumerated again.
+TEST_F(NetworkTest, TestStartUpdatingReusesRecentNetworks) {
+  BasicNetworkManager manager;
+  manager.SignalNetworksChanged.connect(
+      static_cast<NetworkTest*>(this), &NetworkTest::OnNetworksChanged);
+  manager.StartUpdating();
+  Thread::Current()->ProcessMessages(0);
+  EXPECT_TRUE(callback_called_);
+  manager.StopUpdating();
+  EXPECT_FALSE(manager.started());
+
+  // Clear the networks, which enumerating them again would bring back.
+  ClearNetworks(manager);
+  callback_called_ = false;
+  manager.StartUpdating();
+  Thread::Current()->ProcessMessages(0);
+  EXPECT_TRUE(callback_called_);
+  NetworkManager::NetworkList list;
+  manager.GetNetworks(&list);
+  EXPECT_TRUE(list.empty());
+  manager.StopUpdating();
+}
+
 // Verify that MergeNetworkList() merges network lists properly.
 TEST_F(NetworkTest, TestBasicMergeNetworkList) {
   Network ipv4_network1("test_eth0", "Test Network Adapter 1",
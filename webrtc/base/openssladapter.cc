@@ -284,6 +284,9 @@ OpenSSLAdapter::OpenSSLAdapter(AsyncSocket* socket)
     restartable_(false),
     ssl_(NULL), ssl_ctx_(NULL),
     ssl_mode_(SSL_MODE_TLS),
+    coalesce_delay_ms_(-1),
+    flush_posted_(false),
+    pending_blocked_(false),
     custom_verification_succeeded_(false) {
 }
 
@@ -297,6 +300,11 @@ OpenSSLAdapter::SetMode(SSLMode mode) {
   ssl_mode_ = mode;
 }
 
+void
+OpenSSLAdapter::SetWriteCoalescing(int max_delay_ms) {
+  coalesce_delay_ms_ = max_delay_ms;
+}
+
 int
 OpenSSLAdapter::StartSSL(const char* hostname, bool restartable) {
   if (state_ != SSL_NONE)
@@ -453,8 +461,94 @@ OpenSSLAdapter::Cleanup() {
     ssl_ctx_ = NULL;
   }
 
-  // Clear the DTLS timer
+  pending_.SetSize(0);
+  pending_blocked_ = false;
+  flush_posted_ = false;
+
+  // Clear the DTLS timer and any pending flush
   Thread::Current()->Clear(this, MSG_TIMEOUT);
+  Thread::Current()->Clear(this, MSG_FLUSH);
+}
+
+int
+OpenSSLAdapter::WriteSSL(const void* pv, size_t cb) {
+  ssl_write_needs_read_ = false;
+
+  int code = SSL_write(ssl_, pv, checked_cast<int>(cb));
+  switch (SSL_get_error(ssl_, code)) {
+  case SSL_ERROR_NONE:
+    //LOG(LS_INFO) << " -- success";
+    return code;
+  case SSL_ERROR_WANT_READ:
+    //LOG(LS_INFO) << " -- error want read";
+    ssl_write_needs_read_ = true;
+    SetError(EWOULDBLOCK);
+    break;
+  case SSL_ERROR_WANT_WRITE:
+    //LOG(LS_INFO) << " -- error want write";
+    SetError(EWOULDBLOCK);
+    break;
+  case SSL_ERROR_ZERO_RETURN:
+    //LOG(LS_INFO) << " -- remote side closed";
+    SetError(EWOULDBLOCK);
+    // do we need to signal closure?
+    break;
+  default:
+    //LOG(LS_INFO) << " -- error " << code;
+    Error("SSL_write", (code ? code : -1), false);
+    break;
+  }
+
+  return SOCKET_ERROR;
+}
+
+int
+OpenSSLAdapter::SendCoalesced(const void* pv, size_t cb) {
+  // A record carries at most SSL3_RT_MAX_PLAIN_LENGTH bytes; write out what
+  // is gathered so far if this send would not fit in the same record.
+  if (pending_.size() > 0 &&
+      (pending_blocked_ || pending_.size() + cb > SSL3_RT_MAX_PLAIN_LENGTH)) {
+    if (!FlushPending())
+      return SOCKET_ERROR;
+  }
+
+  if (cb >= SSL3_RT_MAX_PLAIN_LENGTH)
+    return WriteSSL(pv, cb);
+
+  pending_.AppendData(static_cast<const uint8_t*>(pv), cb);
+  if (!flush_posted_) {
+    flush_posted_ = true;
+    Thread::Current()->PostDelayed(coalesce_delay_ms_, this, MSG_FLUSH, 0);
+  }
+  return static_cast<int>(cb);
+}
+
+bool
+OpenSSLAdapter::FlushPending() {
+  while (pending_.size() > 0) {
+    int written = WriteSSL(pending_.data(), pending_.size());
+    if (written <= 0) {
+      pending_blocked_ = (state_ == SSL_CONNECTED);
+      return false;
+    }
+    // Partial writes only happen past a record boundary, which a coalesced
+    // record never crosses, so this move is rare.
+    size_t left = pending_.size() - written;
+    memmove(pending_.data(), pending_.data() + written, left);
+    pending_.SetSize(left);
+  }
+  pending_blocked_ = false;
+  return true;
+}
+
+void
+OpenSSLAdapter::OnWritable(AsyncSocket* socket) {
+  if (pending_.size() > 0 && !FlushPending()) {
+    if (state_ == SSL_ERROR)
+      AsyncSocketAdapter::OnCloseEvent(this, GetError());
+    return;
+  }
+  AsyncSocketAdapter::OnWriteEvent(socket);
 }
 
 //
@@ -486,34 +580,10 @@ OpenSSLAdapter::Send(const void* pv, size_t cb) {
   if (cb == 0)
     return 0;
 
-  ssl_write_needs_read_ = false;
-
-  int code = SSL_write(ssl_, pv, checked_cast<int>(cb));
-  switch (SSL_get_error(ssl_, code)) {
-  case SSL_ERROR_NONE:
-    //LOG(LS_INFO) << " -- success";
-    return code;
-  case SSL_ERROR_WANT_READ:
-    //LOG(LS_INFO) << " -- error want read";
-    ssl_write_needs_read_ = true;
-    SetError(EWOULDBLOCK);
-    break;
-  case SSL_ERROR_WANT_WRITE:
-    //LOG(LS_INFO) << " -- error want write";
-    SetError(EWOULDBLOCK);
-    break;
-  case SSL_ERROR_ZERO_RETURN:
-    //LOG(LS_INFO) << " -- remote side closed";
-    SetError(EWOULDBLOCK);
-    // do we need to signal closure?
-    break;
-  default:
-    //LOG(LS_INFO) << " -- error " << code;
-    Error("SSL_write", (code ? code : -1), false);
-    break;
-  }
+  if (coalesce_delay_ms_ >= 0 && ssl_mode_ == SSL_MODE_TLS)
+    return SendCoalesced(pv, cb);
 
-  return SOCKET_ERROR;
+  return WriteSSL(pv, cb);
 }
 
 int
@@ -622,6 +692,13 @@ OpenSSLAdapter::OnMessage(Message* msg) {
     LOG(LS_INFO) << "DTLS timeout expired";
     DTLSv1_handle_timeout(ssl_);
     ContinueSSL();
+  } else if (MSG_FLUSH == msg->message_id) {
+    flush_posted_ = false;
+    // If the socket is blocked the write event will flush instead.
+    if (state_ == SSL_CONNECTED && !pending_blocked_ && !FlushPending() &&
+        state_ == SSL_ERROR) {
+      AsyncSocketAdapter::OnCloseEvent(this, GetError());
+    }
   }
 }
 
@@ -663,7 +740,7 @@ OpenSSLAdapter::OnReadEvent(AsyncSocket* socket) {
   //PRefPtr<OpenSSLAdapter> lock(this); // TODO: fix this
   if (ssl_write_needs_read_)  {
     //LOG(LS_INFO) << " -- onStreamWriteable";
-    AsyncSocketAdapter::OnWriteEvent(socket);
+    OnWritable(socket);
   }
 
   //LOG(LS_INFO) << " -- onStreamReadable";
@@ -698,7 +775,7 @@ OpenSSLAdapter::OnWriteEvent(AsyncSocket* socket) {
   }
 
   //LOG(LS_INFO) << " -- onStreamWriteable";
-  AsyncSocketAdapter::OnWriteEvent(socket);
+  OnWritable(socket);
 }
 
 void
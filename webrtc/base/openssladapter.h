@@ -12,6 +12,7 @@
 #define WEBRTC_BASE_OPENSSLADAPTER_H__
 
 #include <string>
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/messagehandler.h"
 #include "webrtc/base/messagequeue.h"
 #include "webrtc/base/ssladapter.h"
@@ -34,6 +35,7 @@ public:
   ~OpenSSLAdapter() override;
 
   void SetMode(SSLMode mode) override;
+  void SetWriteCoalescing(int max_delay_ms) override;
   int StartSSL(const char* hostname, bool restartable) override;
   int Send(const void* pv, size_t cb) override;
   int SendTo(const void* pv, size_t cb, const SocketAddress& addr) override;
@@ -55,10 +57,17 @@ private:
     SSL_NONE, SSL_WAIT, SSL_CONNECTING, SSL_CONNECTED, SSL_ERROR
   };
 
-  enum { MSG_TIMEOUT };
+  enum { MSG_TIMEOUT, MSG_FLUSH };
 
   int BeginSSL();
   int ContinueSSL();
+  // Writes |cb| bytes with SSL_write, mapping its errors to socket errors.
+  int WriteSSL(const void* pv, size_t cb);
+  int SendCoalesced(const void* pv, size_t cb);
+  // Writes |pending_| out. Returns false if some of it is still pending.
+  bool FlushPending();
+  // Flushes |pending_| and signals writability if that drains it.
+  void OnWritable(AsyncSocket* socket);
   void Error(const char* context, int err, bool signal = true);
   void Cleanup();
 
@@ -89,6 +98,16 @@ private:
   // Do DTLS or not
   SSLMode ssl_mode_;
 
+  // Negative if every Send() is written right away.
+  int coalesce_delay_ms_;
+  // Plaintext gathered for the next record.
+  Buffer pending_;
+  // True while a MSG_FLUSH is posted.
+  bool flush_posted_;
+  // True once SSL_write has blocked on |pending_|; it must then be retried
+  // with the same data, so nothing more is appended until it goes out.
+  bool pending_blocked_;
+
   bool custom_verification_succeeded_;
 };
 
@@ -29,6 +29,8 @@ class OpenSSLDigest : public MessageDigest {
   void Update(const void* buf, size_t len) override;
   // Outputs the digest value to |buf| with length |len|.
   size_t Finish(void* buf, size_t len) override;
+  // Copies the context of |other|, which must be an OpenSSLDigest too.
+  bool CopyStateFrom(const MessageDigest& other) override;
 
   // Helper function to look up a digest's EVP by name.
   static bool GetDigestEVP(const std::string &algorithm,
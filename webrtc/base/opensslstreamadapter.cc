@@ -23,9 +23,14 @@
 #include <openssl/tls1.h>
 #include <openssl/x509v3.h>
 
+#include <list>
+#include <map>
+#include <utility>
 #include <vector>
 
+#include "webrtc/base/basictypes.h"
 #include "webrtc/base/common.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/safe_conversions.h"
 #include "webrtc/base/stream.h"
@@ -55,6 +60,8 @@ struct SrtpCipherMapEntry {
 static SrtpCipherMapEntry SrtpCipherMap[] = {
     {"SRTP_AES128_CM_SHA1_80", SRTP_AES128_CM_SHA1_80},
     {"SRTP_AES128_CM_SHA1_32", SRTP_AES128_CM_SHA1_32},
+    {"SRTP_AEAD_AES_128_GCM", SRTP_AEAD_AES_128_GCM},
+    {"SRTP_AEAD_AES_256_GCM", SRTP_AEAD_AES_256_GCM},
     {nullptr, 0}};
 #endif
 
@@ -293,6 +300,105 @@ static long stream_ctrl(BIO* b, int cmd, long num, void* ptr) {
   }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// DtlsSessionCache
+/////////////////////////////////////////////////////////////////////////////
+
+// Every stream sets up its own SSL_CTX, so OpenSSL's own session caches
+// don't outlive it. This keeps the sessions of peer-to-peer DTLS streams for
+// the whole process instead, keyed on our role and the digest of the peer's
+// certificate, and evicts the least recently used ones beyond |max_size_|.
+class DtlsSessionCache {
+ public:
+  DtlsSessionCache() : max_size_(0) {}
+
+  static DtlsSessionCache* Get() {
+    RTC_DEFINE_STATIC_LOCAL(DtlsSessionCache, instance, ());
+    return &instance;
+  }
+
+  void SetMaxSize(size_t max_size) {
+    CritScope cs(&lock_);
+    max_size_ = max_size;
+    EvictIfNeeded();
+  }
+
+  bool enabled() const {
+    CritScope cs(&lock_);
+    return max_size_ > 0;
+  }
+
+  // Returns the session cached for |key| with a reference the caller must
+  // release, or null.
+  SSL_SESSION* Lookup(const std::string& key) {
+    CritScope cs(&lock_);
+    auto it = index_.find(key);
+    if (it == index_.end())
+      return nullptr;
+    // Move it to the front, as the most recently used one.
+    entries_.splice(entries_.begin(), entries_, it->second);
+    SSL_SESSION* session = it->second->second;
+    UpRefSession(session);
+    return session;
+  }
+
+  // Takes over the reference the caller holds on |session|.
+  void Add(const std::string& key, SSL_SESSION* session) {
+    CritScope cs(&lock_);
+    if (max_size_ == 0) {
+      SSL_SESSION_free(session);
+      return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      SSL_SESSION_free(it->second->second);
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.push_front(std::make_pair(key, session));
+    index_[key] = entries_.begin();
+    EvictIfNeeded();
+  }
+
+  void RecordHandshake(bool resumed) {
+    CritScope cs(&lock_);
+    ++stats_.lookups;
+    if (resumed)
+      ++stats_.hits;
+  }
+
+  SSLSessionCacheStats stats() const {
+    CritScope cs(&lock_);
+    return stats_;
+  }
+
+ private:
+  typedef std::list<std::pair<std::string, SSL_SESSION*>> EntryList;
+
+  static void UpRefSession(SSL_SESSION* session) {
+#if defined(OPENSSL_IS_BORINGSSL) || (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+    SSL_SESSION_up_ref(session);
+#else
+    CRYPTO_add(&session->references, 1, CRYPTO_LOCK_SSL_SESSION);
+#endif
+  }
+
+  void EvictIfNeeded() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    while (entries_.size() > max_size_) {
+      SSL_SESSION_free(entries_.back().second);
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  mutable CriticalSection lock_;
+  size_t max_size_ GUARDED_BY(lock_);
+  // Most recently used first.
+  EntryList entries_ GUARDED_BY(lock_);
+  std::map<std::string, EntryList::iterator> index_ GUARDED_BY(lock_);
+  SSLSessionCacheStats stats_ GUARDED_BY(lock_);
+};
+
 /////////////////////////////////////////////////////////////////////////////
 // OpenSSLStreamAdapter
 /////////////////////////////////////////////////////////////////////////////
@@ -755,6 +861,17 @@ int OpenSSLStreamAdapter::BeginSSL() {
 
   BIO* bio = NULL;
 
+  // Sessions are only cached in peer-to-peer DTLS, where the peer's
+  // certificate digest is known up front.
+  session_cache_key_.clear();
+  if (ssl_mode_ == SSL_MODE_DTLS && ssl_server_name_.empty() &&
+      DtlsSessionCache::Get()->enabled()) {
+    session_cache_key_ = (role_ == SSL_CLIENT) ? "client:" : "server:";
+    session_cache_key_ += peer_certificate_digest_algorithm_ + ":";
+    session_cache_key_.append(peer_certificate_digest_value_.data<char>(),
+                              peer_certificate_digest_value_.size());
+  }
+
   // First set up the context
   ASSERT(ssl_ctx_ == NULL);
   ssl_ctx_ = SetupSSLContext();
@@ -773,6 +890,15 @@ int OpenSSLStreamAdapter::BeginSSL() {
 
   SSL_set_app_data(ssl_, this);
 
+  if (!session_cache_key_.empty() && role_ == SSL_CLIENT) {
+    if (SSL_SESSION* session = DtlsSessionCache::Get()->Lookup(
+            session_cache_key_)) {
+      LOG(LS_INFO) << "BeginSSL: offering to resume a cached session";
+      SSL_set_session(ssl_, session);
+      SSL_SESSION_free(session);
+    }
+  }
+
   SSL_set_bio(ssl_, bio, bio);  // the SSL object owns the bio now.
 #ifndef OPENSSL_IS_BORINGSSL
   if (ssl_mode_ == SSL_MODE_DTLS) {
@@ -818,6 +944,19 @@ int OpenSSLStreamAdapter::ContinueSSL() {
         return -1;
       }
 
+      if (!session_cache_key_.empty()) {
+        bool resumed = SSL_session_reused(ssl_) != 0;
+        // The peer doesn't send its certificate again when resuming, so
+        // SSLVerifyCallback hasn't seen it.
+        if (resumed && !VerifyResumedPeerCertificate()) {
+          LOG(LS_ERROR) << "Resumed session has the wrong peer certificate";
+          return -1;
+        }
+        DtlsSessionCache::Get()->RecordHandshake(resumed);
+        if (SSL_SESSION* session = SSL_get1_session(ssl_))
+          DtlsSessionCache::Get()->Add(session_cache_key_, session);
+      }
+
       state_ = SSL_CONNECTED;
       StreamAdapterInterface::OnEvent(stream(), SE_OPEN|SE_READ|SE_WRITE, 0);
       break;
@@ -1005,6 +1144,22 @@ SSL_CTX* OpenSSLStreamAdapter::SetupSSLContext() {
 
   SSL_CTX_set_verify(ctx, mode, SSLVerifyCallback);
   SSL_CTX_set_verify_depth(ctx, 4);
+
+  if (!session_cache_key_.empty()) {
+    // Session tickets are encrypted with keys of this context only, so use
+    // session IDs, and look them up in DtlsSessionCache when serving.
+    SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+    static const unsigned char kSessionIdContext[] = "webrtc-dtls";
+    SSL_CTX_set_session_id_context(ctx, kSessionIdContext,
+                                   sizeof(kSessionIdContext) - 1);
+    if (role_ == SSL_SERVER) {
+      SSL_CTX_set_session_cache_mode(
+          ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_get_cb(ctx, GetSessionCallback);
+    } else {
+      SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    }
+  }
   // Select list of available ciphers. Note that !SHA256 and !SHA384 only
   // remove HMAC-SHA256 and HMAC-SHA384 cipher suites, not GCM cipher suites
   // with SHA256 or SHA384 as the handshake hash.
@@ -1074,6 +1229,55 @@ int OpenSSLStreamAdapter::SSLVerifyCallback(int ok, X509_STORE_CTX* store) {
   return 1;
 }
 
+SSL_SESSION* OpenSSLStreamAdapter::GetSessionCallback(
+    SSL* ssl,
+    SessionIdType id,
+    int id_len,
+    int* copy) {
+  OpenSSLStreamAdapter* stream =
+      reinterpret_cast<OpenSSLStreamAdapter*>(SSL_get_app_data(ssl));
+  *copy = 0;  // We hand over our reference.
+
+  SSL_SESSION* session =
+      DtlsSessionCache::Get()->Lookup(stream->session_cache_key_);
+  if (!session)
+    return nullptr;
+  // Only resume the session the expected peer established with us last.
+  unsigned int cached_id_len = 0;
+  const unsigned char* cached_id = SSL_SESSION_get_id(session, &cached_id_len);
+  if (id_len < 0 || cached_id_len != static_cast<unsigned int>(id_len) ||
+      memcmp(cached_id, id, cached_id_len) != 0) {
+    SSL_SESSION_free(session);
+    return nullptr;
+  }
+  return session;
+}
+
+bool OpenSSLStreamAdapter::VerifyResumedPeerCertificate() {
+  X509* cert = SSL_get_peer_certificate(ssl_);
+  if (!cert)
+    return false;
+
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  bool ok = OpenSSLCertificate::ComputeDigest(
+                cert, peer_certificate_digest_algorithm_, digest,
+                sizeof(digest), &digest_length) &&
+            Buffer(digest, digest_length) == peer_certificate_digest_value_;
+  if (ok)
+    peer_certificate_.reset(new OpenSSLCertificate(cert));
+  X509_free(cert);
+  return ok;
+}
+
+void OpenSSLStreamAdapter::SetDtlsSessionCacheSize(size_t max_sessions) {
+  DtlsSessionCache::Get()->SetMaxSize(max_sessions);
+}
+
+SSLSessionCacheStats OpenSSLStreamAdapter::GetDtlsSessionCacheStats() {
+  return DtlsSessionCache::Get()->stats();
+}
+
 // This code is taken from the "Network Security with OpenSSL"
 // sample in chapter 5
 bool OpenSSLStreamAdapter::SSLPostConnectionCheck(SSL* ssl,
@@ -21,6 +21,7 @@
 typedef struct ssl_st SSL;
 typedef struct ssl_ctx_st SSL_CTX;
 typedef struct ssl_cipher_st SSL_CIPHER;
+typedef struct ssl_session_st SSL_SESSION;
 typedef struct x509_store_ctx_st X509_STORE_CTX;
 
 namespace rtc {
@@ -109,6 +110,9 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   static bool HaveDtlsSrtp();
   static bool HaveExporter();
 
+  static void SetDtlsSessionCacheSize(size_t max_sessions);
+  static SSLSessionCacheStats GetDtlsSessionCacheStats();
+
   // TODO(guoweis): Move this away from a static class method.
   static int GetDefaultSslCipherForTest(SSLProtocolVersion version,
                                         KeyType key_type);
@@ -171,6 +175,22 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // passed.
   static int SSLVerifyCallback(int ok, X509_STORE_CTX* store);
 
+#if defined(OPENSSL_IS_BORINGSSL) || (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+  typedef const unsigned char* SessionIdType;
+#else
+  typedef unsigned char* SessionIdType;
+#endif
+  // Called back by OpenSSL, when serving, with the ID of the session the
+  // client wants to resume. Returns it if it's the one the session cache has
+  // for our peer.
+  static SSL_SESSION* GetSessionCallback(SSL* ssl,
+                                         SessionIdType id,
+                                         int id_len,
+                                         int* copy);
+  // Checks the certificate of a resumed session against the expected digest,
+  // and records it as the peer's certificate.
+  bool VerifyResumedPeerCertificate();
+
   SSLState state_;
   SSLRole role_;
   int ssl_error_code_;  // valid when state_ == SSL_ERROR or SSL_CLOSED
@@ -194,6 +214,9 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // the peer must present.
   Buffer peer_certificate_digest_value_;
   std::string peer_certificate_digest_algorithm_;
+  // The key our session is cached under, if session caching is on and
+  // applies to this stream.
+  std::string session_cache_key_;
 
   // OpenSSLAdapter::custom_verify_callback_ result
   bool custom_verification_succeeded_;
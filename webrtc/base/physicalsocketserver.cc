@@ -97,9 +97,9 @@ static const int ICMP_PING_TIMEOUT_MILLIS = 10000u;
 #endif
 
 PhysicalSocket::PhysicalSocket(PhysicalSocketServer* ss, SOCKET s)
-  : ss_(ss), s_(s), enabled_events_(0), error_(0),
+  : ss_(ss), s_(s), error_(0),
     state_((s == INVALID_SOCKET) ? CS_CLOSED : CS_CONNECTED),
-    resolver_(nullptr) {
+    resolver_(nullptr), enabled_events_(0) {
 #if defined(WEBRTC_WIN)
   // EnsureWinsockInit() ensures that winsock is initialized. The default
   // version of this function doesn't do anything because winsock is
@@ -128,7 +128,7 @@ bool PhysicalSocket::Create(int family, int type) {
   udp_ = (SOCK_DGRAM == type);
   UpdateLastError();
   if (udp_)
-    enabled_events_ = DE_READ | DE_WRITE;
+    SetEnabledEvents(DE_READ | DE_WRITE);
   return s_ != INVALID_SOCKET;
 }
 
@@ -210,12 +210,12 @@ int PhysicalSocket::DoConnect(const SocketAddress& connect_addr) {
     state_ = CS_CONNECTED;
   } else if (IsBlockingError(GetError())) {
     state_ = CS_CONNECTING;
-    enabled_events_ |= DE_CONNECT;
+    EnableEvents(DE_CONNECT);
   } else {
     return SOCKET_ERROR;
   }
 
-  enabled_events_ |= DE_READ | DE_WRITE;
+  EnableEvents(DE_READ | DE_WRITE);
   return 0;
 }
 
@@ -279,7 +279,7 @@ int PhysicalSocket::Send(const void* pv, size_t cb) {
   // We have seen minidumps where this may be false.
   ASSERT(sent <= static_cast<int>(cb));
   if ((sent < 0) && IsBlockingError(GetError())) {
-    enabled_events_ |= DE_WRITE;
+    EnableEvents(DE_WRITE);
   }
   return sent;
 }
@@ -303,7 +303,7 @@ int PhysicalSocket::SendTo(const void* buffer,
   // We have seen minidumps where this may be false.
   ASSERT(sent <= static_cast<int>(length));
   if ((sent < 0) && IsBlockingError(GetError())) {
-    enabled_events_ |= DE_WRITE;
+    EnableEvents(DE_WRITE);
   }
   return sent;
 }
@@ -318,7 +318,7 @@ int PhysicalSocket::Recv(void* buffer, size_t length) {
     LOG(LS_WARNING) << "EOF from socket; deferring close event";
     // Must turn this back on so that the select() loop will notice the close
     // event.
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
     SetError(EWOULDBLOCK);
     return SOCKET_ERROR;
   }
@@ -326,7 +326,7 @@ int PhysicalSocket::Recv(void* buffer, size_t length) {
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
   }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -348,7 +348,7 @@ int PhysicalSocket::RecvFrom(void* buffer,
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
   }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -356,12 +356,87 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+#if defined(WEBRTC_USE_MMSG)
+// Upper bound on the number of datagrams moved per system call. The kernel
+// caps this at UIO_MAXIOV, but we keep the per-call state on the stack.
+static const size_t kMaxMmsgBatchSize = 32;
+
+int PhysicalSocket::RecvFromBatch(Datagram* datagrams, size_t count) {
+  count = std::min(count, kMaxMmsgBatchSize);
+  if (count == 0)
+    return 0;
+  mmsghdr msgs[kMaxMmsgBatchSize];
+  iovec iovs[kMaxMmsgBatchSize];
+  sockaddr_storage addrs[kMaxMmsgBatchSize];
+  memset(msgs, 0, sizeof(msgs[0]) * count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = datagrams[i].data;
+    iovs[i].iov_len = datagrams[i].size;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int received = ::recvmmsg(s_, msgs, static_cast<unsigned int>(count), 0,
+                            nullptr);
+  if (received < 0 && errno == ENOSYS) {
+    // Kernel older than 2.6.33.
+    return AsyncSocket::RecvFromBatch(datagrams, count);
+  }
+  UpdateLastError();
+  for (int i = 0; i < received; ++i) {
+    datagrams[i].length = msgs[i].msg_len;
+    SocketAddressFromSockAddrStorage(addrs[i], &datagrams[i].addr);
+  }
+  int error = GetError();
+  bool success = (received >= 0) || IsBlockingError(error);
+  if (udp_ || success) {
+    EnableEvents(DE_READ);
+  }
+  if (!success) {
+    LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  return received;
+}
+
+int PhysicalSocket::SendToBatch(const Datagram* datagrams, size_t count) {
+  count = std::min(count, kMaxMmsgBatchSize);
+  if (count == 0)
+    return 0;
+  mmsghdr msgs[kMaxMmsgBatchSize];
+  iovec iovs[kMaxMmsgBatchSize];
+  sockaddr_storage addrs[kMaxMmsgBatchSize];
+  memset(msgs, 0, sizeof(msgs[0]) * count);
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = datagrams[i].data;
+    iovs[i].iov_len = datagrams[i].length;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(
+        datagrams[i].addr.ToSockAddrStorage(&addrs[i]));
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  // Suppress SIGPIPE. See Send() for explanation.
+  int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(count),
+                        MSG_NOSIGNAL);
+  if (sent < 0 && errno == ENOSYS) {
+    return AsyncSocket::SendToBatch(datagrams, count);
+  }
+  UpdateLastError();
+  MaybeRemapSendError();
+  if ((sent < 0) && IsBlockingError(GetError())) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent;
+}
+#endif  // WEBRTC_USE_MMSG
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
   if (err == 0) {
     state_ = CS_CONNECTING;
-    enabled_events_ |= DE_ACCEPT;
+    EnableEvents(DE_ACCEPT);
 #if !defined(NDEBUG)
     dbg_addr_ = "Listening @ ";
     dbg_addr_.append(GetLocalAddress().ToString());
@@ -373,7 +448,7 @@ int PhysicalSocket::Listen(int backlog) {
 AsyncSocket* PhysicalSocket::Accept(SocketAddress* out_addr) {
   // Always re-subscribe DE_ACCEPT to make sure new incoming connections will
   // trigger an event even if DoAccept returns an error here.
-  enabled_events_ |= DE_ACCEPT;
+  EnableEvents(DE_ACCEPT);
   sockaddr_storage addr_storage;
   socklen_t addr_len = sizeof(addr_storage);
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
@@ -393,7 +468,7 @@ int PhysicalSocket::Close() {
   UpdateLastError();
   s_ = INVALID_SOCKET;
   state_ = CS_CLOSED;
-  enabled_events_ = 0;
+  SetEnabledEvents(0);
   if (resolver_) {
     resolver_->Destroy(false);
     resolver_ = nullptr;
@@ -490,6 +565,18 @@ void PhysicalSocket::OnResolveResult(AsyncResolverInterface* resolver) {
   }
 }
 
+void PhysicalSocket::SetEnabledEvents(uint8_t events) {
+  enabled_events_ = events;
+}
+
+void PhysicalSocket::EnableEvents(uint8_t events) {
+  enabled_events_ |= events;
+}
+
+void PhysicalSocket::DisableEvents(uint8_t events) {
+  enabled_events_ &= ~events;
+}
+
 void PhysicalSocket::UpdateLastError() {
   SetError(LAST_SYSTEM_ERROR);
 }
@@ -539,6 +626,15 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
       return -1;
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
     default:
       ASSERT(false);
       return -1;
@@ -549,6 +645,8 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
 SocketDispatcher::SocketDispatcher(PhysicalSocketServer *ss)
 #if defined(WEBRTC_WIN)
   : PhysicalSocket(ss), id_(0), signal_close_(false)
+#elif defined(WEBRTC_USE_EPOLL)
+  : PhysicalSocket(ss), saved_enabled_events_(-1)
 #else
   : PhysicalSocket(ss)
 #endif
@@ -558,6 +656,8 @@ SocketDispatcher::SocketDispatcher(PhysicalSocketServer *ss)
 SocketDispatcher::SocketDispatcher(SOCKET s, PhysicalSocketServer *ss)
 #if defined(WEBRTC_WIN)
   : PhysicalSocket(ss, s), id_(0), signal_close_(false)
+#elif defined(WEBRTC_USE_EPOLL)
+  : PhysicalSocket(ss, s), saved_enabled_events_(-1)
 #else
   : PhysicalSocket(ss, s)
 #endif
@@ -669,7 +769,7 @@ bool SocketDispatcher::IsDescriptorClosed() {
 #endif // WEBRTC_POSIX
 
 uint32_t SocketDispatcher::GetRequestedEvents() {
-  return enabled_events_;
+  return enabled_events();
 }
 
 void SocketDispatcher::OnPreEvent(uint32_t ff) {
@@ -693,7 +793,7 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
   if (((ff & DE_CONNECT) != 0) && (id_ == cache_id)) {
     if (ff != DE_CONNECT)
       LOG(LS_VERBOSE) << "Signalled with DE_CONNECT: " << ff;
-    enabled_events_ &= ~DE_CONNECT;
+    DisableEvents(DE_CONNECT);
 #if !defined(NDEBUG)
     dbg_addr_ = "Connected @ ";
     dbg_addr_.append(GetRemoteAddress().ToString());
@@ -701,15 +801,15 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
     SignalConnectEvent(this);
   }
   if (((ff & DE_ACCEPT) != 0) && (id_ == cache_id)) {
-    enabled_events_ &= ~DE_ACCEPT;
+    DisableEvents(DE_ACCEPT);
     SignalReadEvent(this);
   }
   if ((ff & DE_READ) != 0) {
-    enabled_events_ &= ~DE_READ;
+    DisableEvents(DE_READ);
     SignalReadEvent(this);
   }
   if (((ff & DE_WRITE) != 0) && (id_ == cache_id)) {
-    enabled_events_ &= ~DE_WRITE;
+    DisableEvents(DE_WRITE);
     SignalWriteEvent(this);
   }
   if (((ff & DE_CLOSE) != 0) && (id_ == cache_id)) {
@@ -721,33 +821,86 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
 #elif defined(WEBRTC_POSIX)
 
 void SocketDispatcher::OnEvent(uint32_t ff, int err) {
+#if defined(WEBRTC_USE_EPOLL)
+  // The signal handlers usually re-enable the events disabled here (e.g. by
+  // calling Recv), so only the net change is pushed to the epoll instance.
+  StartBatchedEventUpdates();
+#endif
   // Make sure we deliver connect/accept first. Otherwise, consumers may see
   // something like a READ followed by a CONNECT, which would be odd.
   if ((ff & DE_CONNECT) != 0) {
-    enabled_events_ &= ~DE_CONNECT;
+    DisableEvents(DE_CONNECT);
     SignalConnectEvent(this);
   }
   if ((ff & DE_ACCEPT) != 0) {
-    enabled_events_ &= ~DE_ACCEPT;
+    DisableEvents(DE_ACCEPT);
     SignalReadEvent(this);
   }
   if ((ff & DE_READ) != 0) {
-    enabled_events_ &= ~DE_READ;
+    DisableEvents(DE_READ);
     SignalReadEvent(this);
   }
   if ((ff & DE_WRITE) != 0) {
-    enabled_events_ &= ~DE_WRITE;
+    DisableEvents(DE_WRITE);
     SignalWriteEvent(this);
   }
   if ((ff & DE_CLOSE) != 0) {
     // The socket is now dead to us, so stop checking it.
-    enabled_events_ = 0;
+    SetEnabledEvents(0);
+  }
+#if defined(WEBRTC_USE_EPOLL)
+  // Flush before signalling close, as the receiver may delete us.
+  FinishBatchedEventUpdates();
+#endif
+  if ((ff & DE_CLOSE) != 0) {
     SignalCloseEvent(this, err);
   }
 }
 
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_USE_EPOLL)
+
+void SocketDispatcher::SetEnabledEvents(uint8_t events) {
+  uint8_t old_events = enabled_events();
+  PhysicalSocket::SetEnabledEvents(events);
+  MaybeUpdateDispatcher(old_events);
+}
+
+void SocketDispatcher::EnableEvents(uint8_t events) {
+  uint8_t old_events = enabled_events();
+  PhysicalSocket::EnableEvents(events);
+  MaybeUpdateDispatcher(old_events);
+}
+
+void SocketDispatcher::DisableEvents(uint8_t events) {
+  uint8_t old_events = enabled_events();
+  PhysicalSocket::DisableEvents(events);
+  MaybeUpdateDispatcher(old_events);
+}
+
+void SocketDispatcher::MaybeUpdateDispatcher(uint8_t old_events) {
+  // A closed socket has already been removed from the socket server.
+  if (enabled_events() != old_events && saved_enabled_events_ == -1 &&
+      s_ != INVALID_SOCKET) {
+    ss_->Update(this);
+  }
+}
+
+void SocketDispatcher::StartBatchedEventUpdates() {
+  ASSERT(saved_enabled_events_ == -1);
+  saved_enabled_events_ = enabled_events();
+}
+
+void SocketDispatcher::FinishBatchedEventUpdates() {
+  ASSERT(saved_enabled_events_ != -1);
+  uint8_t old_events = static_cast<uint8_t>(saved_enabled_events_);
+  saved_enabled_events_ = -1;
+  MaybeUpdateDispatcher(old_events);
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 int SocketDispatcher::Close() {
   if (s_ == INVALID_SOCKET)
     return 0;
@@ -998,9 +1151,8 @@ class PosixSignalDispatcher : public Dispatcher {
 
 class FileDispatcher: public Dispatcher, public AsyncFile {
  public:
-  FileDispatcher(int fd, PhysicalSocketServer *ss) : ss_(ss), fd_(fd) {
-    set_readable(true);
-
+  FileDispatcher(int fd, PhysicalSocketServer *ss)
+      : ss_(ss), fd_(fd), flags_(DE_READ) {
     ss_->Add(this);
 
     fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
@@ -1032,16 +1184,23 @@ class FileDispatcher: public Dispatcher, public AsyncFile {
   bool readable() override { return (flags_ & DE_READ) != 0; }
 
   void set_readable(bool value) override {
-    flags_ = value ? (flags_ | DE_READ) : (flags_ & ~DE_READ);
+    SetFlags(value ? (flags_ | DE_READ) : (flags_ & ~DE_READ));
   }
 
   bool writable() override { return (flags_ & DE_WRITE) != 0; }
 
   void set_writable(bool value) override {
-    flags_ = value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE);
+    SetFlags(value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE));
   }
 
  private:
+  void SetFlags(int flags) {
+    if (flags == flags_)
+      return;
+    flags_ = flags;
+    ss_->Update(this);
+  }
+
   PhysicalSocketServer* ss_;
   int fd_;
   int flags_;
@@ -1130,6 +1289,18 @@ class Signaler : public EventDispatcher {
 
 PhysicalSocketServer::PhysicalSocketServer()
     : fWait_(false) {
+#if defined(WEBRTC_USE_EPOLL)
+  // Since Linux 2.6.8, the size argument is ignored, but must be greater than
+  // zero. Before that the size served as hint to the kernel for the amount of
+  // space to initially allocate in internal data structures.
+  epoll_fd_ = epoll_create(FD_SETSIZE);
+  if (epoll_fd_ == -1) {
+    // Not an error, will fall back to "select" below.
+    LOG_E(LS_WARNING, EN, errno) << "epoll_create";
+    epoll_fd_ = INVALID_SOCKET;
+  }
+  pending_epoll_events_ = 0;
+#endif
   signal_wakeup_ = new Signaler(this, &fWait_);
 #if defined(WEBRTC_WIN)
   socket_ev_ = WSACreateEvent();
@@ -1144,6 +1315,11 @@ PhysicalSocketServer::~PhysicalSocketServer() {
   signal_dispatcher_.reset();
 #endif
   delete signal_wakeup_;
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    close(epoll_fd_);
+  }
+#endif
   ASSERT(dispatchers_.empty());
 }
 
@@ -1198,6 +1374,11 @@ void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   if (pos != dispatchers_.end())
     return;
   dispatchers_.push_back(pdispatcher);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    AddEpoll(pdispatcher);
+  }
+#endif  // WEBRTC_USE_EPOLL
 }
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
@@ -1221,10 +1402,38 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
       --**it;
     }
   }
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    RemoveEpoll(pdispatcher);
+  }
+#endif  // WEBRTC_USE_EPOLL
+}
+
+void PhysicalSocketServer::Update(Dispatcher* pdispatcher) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ == INVALID_SOCKET) {
+    return;
+  }
+
+  CritScope cs(&crit_);
+  UpdateEpoll(pdispatcher);
+#endif
 }
 
 #if defined(WEBRTC_POSIX)
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
+#if defined(WEBRTC_USE_EPOLL)
+  // We don't keep a dedicated epoll instance for the wakeup dispatcher, so
+  // fall back to select() when only waiting for a wakeup. The wakeup pipe is
+  // created first, so its descriptor is always below FD_SETSIZE.
+  if (epoll_fd_ != INVALID_SOCKET && process_io) {
+    return WaitEpoll(cmsWait);
+  }
+#endif
+  return WaitSelect(cmsWait, process_io);
+}
+
+bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
   // Calculate timing information
 
   struct timeval *ptvWait = NULL;
@@ -1382,6 +1591,198 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return true;
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+
+static int GetEpollEvents(uint32_t ff) {
+  int events = 0;
+  if (ff & (DE_READ | DE_ACCEPT)) {
+    events |= EPOLLIN;
+  }
+  if (ff & (DE_WRITE | DE_CONNECT)) {
+    events |= EPOLLOUT;
+  }
+  return events;
+}
+
+void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  int events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  if (!events) {
+    // Registered lazily by UpdateEpoll() once there is something to wait for.
+    // Level-triggered epoll always reports EPOLLHUP/EPOLLERR, so an idle
+    // descriptor would otherwise keep waking us up.
+    return;
+  }
+  int fd = pdispatcher->GetDescriptor();
+  struct epoll_event event = {0};
+  event.events = events;
+  event.data.ptr = pdispatcher;
+  int err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  if (err == -1 && errno == EEXIST) {
+    // Already registered through an Update() issued before Add().
+    err = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+  }
+  if (err == -1) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl EPOLL_CTL_ADD";
+  }
+}
+
+void PhysicalSocketServer::RemoveEpoll(Dispatcher* pdispatcher) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  // Make sure events still queued from the current epoll_wait() batch are
+  // not delivered to a dispatcher that may be deleted by now.
+  for (int i = 0; i < pending_epoll_events_; ++i) {
+    if (epoll_events_[i].data.ptr == pdispatcher) {
+      epoll_events_[i].data.ptr = nullptr;
+    }
+  }
+  int fd = pdispatcher->GetDescriptor();
+  if (fd == INVALID_SOCKET) {
+    return;
+  }
+  struct epoll_event event = {0};
+  int err = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+  if (err == -1 && errno != ENOENT && errno != EBADF) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl EPOLL_CTL_DEL";
+  }
+}
+
+void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  int fd = pdispatcher->GetDescriptor();
+  if (fd == INVALID_SOCKET) {
+    return;
+  }
+  int events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  struct epoll_event event = {0};
+  if (!events) {
+    // See AddEpoll() for why idle descriptors are not kept registered.
+    int err = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+    if (err == -1 && errno != ENOENT) {
+      LOG_E(LS_ERROR, EN, errno) << "epoll_ctl EPOLL_CTL_DEL";
+    }
+    return;
+  }
+  event.events = events;
+  event.data.ptr = pdispatcher;
+  int err = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+  if (err == -1 && errno == ENOENT) {
+    err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  }
+  if (err == -1) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl EPOLL_CTL_MOD";
+  }
+}
+
+bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  uint32_t msStop = 0;
+  int tvWait = -1;
+  if (cmsWait != kForever) {
+    tvWait = cmsWait;
+    msStop = TimeAfter(cmsWait);
+  }
+
+  fWait_ = true;
+
+  while (fWait_) {
+    // Wait then call handlers as appropriate
+    // < 0 means error
+    // 0 means timeout
+    // > 0 means count of descriptors ready
+    int n = epoll_wait(epoll_fd_, epoll_events_, kMaxEpollEvents, tvWait);
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "epoll";
+        return false;
+      }
+      // Else ignore the error and keep going. If this EINTR was for one of the
+      // signals managed by this PhysicalSocketServer, the
+      // PosixSignalDeliveryDispatcher will be in the signaled state in the next
+      // iteration.
+    } else if (n == 0) {
+      // If timeout, return success
+      return true;
+    } else {
+      // We have signaled descriptors
+      CritScope cr(&crit_);
+      pending_epoll_events_ = n;
+      for (int i = 0; i < n; ++i) {
+        const struct epoll_event& event = epoll_events_[i];
+        Dispatcher* pdispatcher = static_cast<Dispatcher*>(event.data.ptr);
+        if (!pdispatcher) {
+          // Removed while dispatching an earlier event of this batch.
+          continue;
+        }
+        int fd = pdispatcher->GetDescriptor();
+        uint32_t requested = pdispatcher->GetRequestedEvents();
+        uint32_t ff = 0;
+        int errcode = 0;
+
+        // Like select(), treat errors and hangups as both readable and
+        // writable so the dispatcher gets to see them.
+        bool failed = (event.events & (EPOLLERR | EPOLLHUP)) != 0;
+        bool readable = failed || (event.events & (EPOLLIN | EPOLLPRI)) != 0;
+        bool writable = failed || (event.events & EPOLLOUT) != 0;
+        readable = readable && (requested & (DE_READ | DE_ACCEPT)) != 0;
+        writable = writable && (requested & (DE_WRITE | DE_CONNECT)) != 0;
+
+        // Reap any error code, which can be signaled through reads or writes.
+        if (readable || writable) {
+          socklen_t len = sizeof(errcode);
+          ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errcode, &len);
+        }
+
+        // Check readable descriptors. If we're waiting on an accept, signal
+        // that. Otherwise we're waiting for data, check to see if we're
+        // readable or really closed.
+        if (readable) {
+          if (requested & DE_ACCEPT) {
+            ff |= DE_ACCEPT;
+          } else if (errcode || pdispatcher->IsDescriptorClosed()) {
+            ff |= DE_CLOSE;
+          } else {
+            ff |= DE_READ;
+          }
+        }
+
+        // Check writable descriptors. If we're waiting on a connect, detect
+        // success versus failure by the reaped error code.
+        if (writable) {
+          if (requested & DE_CONNECT) {
+            if (!errcode) {
+              ff |= DE_CONNECT;
+            } else {
+              ff |= DE_CLOSE;
+            }
+          } else {
+            ff |= DE_WRITE;
+          }
+        }
+
+        // Tell the descriptor about the event.
+        if (ff != 0) {
+          pdispatcher->OnPreEvent(ff);
+          pdispatcher->OnEvent(ff, errcode);
+        }
+      }
+      pending_epoll_events_ = 0;
+    }
+
+    if (cmsWait != kForever) {
+      tvWait = TimeUntil(msStop);
+      if (tvWait <= 0) {
+        // Return success on timeout.
+        return true;
+      }
+    }
+  }
+
+  return true;
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 static void GlobalSignalHandler(int signum) {
   PosixSignalHandler::Instance()->OnPosixSignalReceived(signum);
 }
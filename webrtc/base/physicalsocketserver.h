@@ -23,6 +23,18 @@
 typedef int SOCKET;
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_LINUX)
+// On Linux (and Android) the dispatchers are registered with an epoll
+// instance instead of being polled with select() on every Wait().
+#include <sys/epoll.h>
+#define WEBRTC_USE_EPOLL 1
+#endif
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// recvmmsg()/sendmmsg() are not available in all Android NDK versions.
+#define WEBRTC_USE_MMSG 1
+#endif
+
 namespace rtc {
 
 // Event constants for the Dispatcher class.
@@ -77,6 +89,10 @@ class PhysicalSocketServer : public SocketServer {
 
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
+  // Must be called by a dispatcher whenever the value returned by its
+  // GetRequestedEvents() changes, so the epoll registration can follow.
+  // This is a no-op when the select() based implementation is used.
+  void Update(Dispatcher* dispatcher);
 
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
@@ -104,7 +120,24 @@ class PhysicalSocketServer : public SocketServer {
 #if defined(WEBRTC_POSIX)
   static bool InstallSignal(int signum, void (*handler)(int));
 
+  bool WaitSelect(int cms, bool process_io);
+
   scoped_ptr<PosixSignalDispatcher> signal_dispatcher_;
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  void AddEpoll(Dispatcher* dispatcher);
+  void RemoveEpoll(Dispatcher* dispatcher);
+  void UpdateEpoll(Dispatcher* dispatcher);
+  bool WaitEpoll(int cms);
+
+  static const int kMaxEpollEvents = 128;
+
+  int epoll_fd_;
+  // Events returned by the last epoll_wait() call, and how many of them are
+  // still being dispatched. Remove() clears entries referring to a dispatcher
+  // that goes away while the batch is processed.
+  struct epoll_event epoll_events_[kMaxEpollEvents];
+  int pending_epoll_events_;
 #endif
   DispatcherList dispatchers_;
   IteratorList iterators_;
@@ -146,6 +179,12 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int Recv(void* buffer, size_t length) override;
   int RecvFrom(void* buffer, size_t length, SocketAddress* out_addr) override;
 
+#if defined(WEBRTC_USE_MMSG)
+  // Uses recvmmsg()/sendmmsg() to move a whole batch in one system call.
+  int RecvFromBatch(Datagram* datagrams, size_t count) override;
+  int SendToBatch(const Datagram* datagrams, size_t count) override;
+#endif
+
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
 
@@ -168,9 +207,13 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
   static int TranslateOption(Option opt, int* slevel, int* sopt);
 
+  uint8_t enabled_events() const { return enabled_events_; }
+  virtual void SetEnabledEvents(uint8_t events);
+  virtual void EnableEvents(uint8_t events);
+  virtual void DisableEvents(uint8_t events);
+
   PhysicalSocketServer* ss_;
   SOCKET s_;
-  uint8_t enabled_events_;
   bool udp_;
   mutable CriticalSection crit_;
   int error_ GUARDED_BY(crit_);
@@ -180,6 +223,9 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 #if !defined(NDEBUG)
   std::string dbg_addr_;
 #endif
+
+ private:
+  uint8_t enabled_events_;
 };
 
 class SocketDispatcher : public Dispatcher, public PhysicalSocket {
@@ -208,13 +254,28 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
 
   int Close() override;
 
-#if defined(WEBRTC_WIN)
+#if defined(WEBRTC_USE_EPOLL)
+ protected:
+  void SetEnabledEvents(uint8_t events) override;
+  void EnableEvents(uint8_t events) override;
+  void DisableEvents(uint8_t events) override;
+#endif
+
  private:
+#if defined(WEBRTC_WIN)
   static int next_id_;
   int id_;
   bool signal_close_;
   int signal_err_;
 #endif // WEBRTC_WIN
+#if defined(WEBRTC_USE_EPOLL)
+  void MaybeUpdateDispatcher(uint8_t old_events);
+  // Changes made while OnEvent() runs are collapsed into a single Update().
+  void StartBatchedEventUpdates();
+  void FinishBatchedEventUpdates();
+
+  int saved_enabled_events_;
+#endif
 };
 
 } // namespace rtc
@@ -8,8 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <signal.h>
 #include <stdarg.h>
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
@@ -390,6 +395,14 @@ TEST_F(PhysicalSocketTest, TestUdpReadyToSendIPv6) {
   SocketTest::TestUdpReadyToSendIPv6();
 }
 
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv4) {
+  SocketTest::TestUdpBatchIPv4();
+}
+
+TEST_F(PhysicalSocketTest, TestUdpBatchIPv6) {
+  SocketTest::TestUdpBatchIPv6();
+}
+
 TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv4) {
   SocketTest::TestGetSetOptionsIPv4();
 }
@@ -398,6 +411,43 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+// select() can't handle descriptors >= FD_SETSIZE, epoll can.
+TEST_F(PhysicalSocketTest, TestUdpDescriptorAboveFdSetSize) {
+  const int kHighFd = FD_SETSIZE + 16;
+  struct rlimit limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &limit));
+  if (limit.rlim_cur <= static_cast<rlim_t>(kHighFd)) {
+    limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, kHighFd + 1);
+    if (limit.rlim_cur <= static_cast<rlim_t>(kHighFd) ||
+        setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+      LOG(LS_WARNING) << "Can't raise RLIMIT_NOFILE, skipping test.";
+      return;
+    }
+  }
+  int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(kHighFd, dup2(fd, kHighFd));
+  close(fd);
+
+  scoped_ptr<AsyncSocket> receiver(server_->WrapSocket(kHighFd));
+  ASSERT_TRUE(receiver);
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  testing::StreamSink sink;
+  sink.Monitor(receiver.get());
+
+  scoped_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_TRUE(sender);
+  EXPECT_EQ(5, sender->SendTo("hello", 5, receiver->GetLocalAddress()));
+  EXPECT_TRUE_WAIT(sink.Check(receiver.get(), testing::SSE_READ), kTimeout);
+
+  char buffer[16];
+  EXPECT_EQ(5, receiver->Recv(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp("hello", buffer, 5));
+}
+#endif  // WEBRTC_USE_EPOLL
+
 #if defined(WEBRTC_POSIX)
 
 class PosixSignalDeliveryTest : public testing::Test {
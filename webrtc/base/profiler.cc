@@ -12,7 +12,9 @@
 
 #include <math.h>
 #include <algorithm>
+#include <functional>
 
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/timeutils.h"
 
 namespace {
@@ -36,6 +38,10 @@ std::ostream& operator<<(std::ostream& stream, const FormattedTime& time) {
   return stream;
 }
 
+double NanosToSeconds(uint64_t nanos) {
+  return static_cast<double>(nanos) / rtc::kNumNanosecsPerSec;
+}
+
 }  // namespace
 
 namespace rtc {
@@ -86,7 +92,63 @@ double ProfilerEvent::standard_deviation() const {
     return sqrt(sum_of_squared_differences_ / (event_count_ - 1.0));
 }
 
-Profiler::~Profiler() = default;
+ProfilerPoint::ProfilerPoint(const std::string& name) : name_(name) {}
+
+ProfilerPoint::~ProfilerPoint() {}
+
+ProfilerPoint* ProfilerPoint::RegisterSlow(ProfilerPoint* volatile* slot,
+                                           const char* name) {
+  ProfilerPoint* point = Profiler::Instance()->GetPoint(name);
+  // Racing threads get the same point from the Profiler, so it doesn't
+  // matter whose store wins.
+  AtomicOps::CompareAndSwapPtr(slot, static_cast<ProfilerPoint*>(NULL),
+                               point);
+  return point;
+}
+
+void ProfilerPoint::Record(uint64_t elapsed_ns) {
+  // Thread handles are usually aligned, so mix the bits before picking a
+  // shard.
+  uint64_t hash = static_cast<uint64_t>(
+      std::hash<PlatformThreadRef>()(CurrentThreadRef()));
+  Shard& shard = shards_[(hash * 0x9E3779B97F4A7C15ull) >> 60];
+  static_assert(kNumShards == 16, "The shift above picks one of 16 shards");
+  CritScope lock(&shard.crit);
+  Stats& stats = shard.stats;
+  if (stats.count == 0 || elapsed_ns < stats.min_ns)
+    stats.min_ns = elapsed_ns;
+  if (elapsed_ns > stats.max_ns)
+    stats.max_ns = elapsed_ns;
+  ++stats.count;
+  stats.total_ns += elapsed_ns;
+}
+
+ProfilerPoint::Stats ProfilerPoint::GetStats() const {
+  Stats total;
+  for (Shard& shard : shards_) {
+    CritScope lock(&shard.crit);
+    if (shard.stats.count == 0)
+      continue;
+    if (total.count == 0 || shard.stats.min_ns < total.min_ns)
+      total.min_ns = shard.stats.min_ns;
+    total.max_ns = std::max(total.max_ns, shard.stats.max_ns);
+    total.count += shard.stats.count;
+    total.total_ns += shard.stats.total_ns;
+  }
+  return total;
+}
+
+void ProfilerPoint::Reset() {
+  for (Shard& shard : shards_) {
+    CritScope lock(&shard.crit);
+    shard.stats = Stats();
+  }
+}
+
+Profiler::~Profiler() {
+  for (ProfilerPoint* point : points_)
+    delete point;
+}
 
 Profiler* Profiler::Instance() {
   RTC_DEFINE_STATIC_LOCAL(Profiler, instance, ());
@@ -146,6 +208,12 @@ void Profiler::ReportToLog(const char* file, int line,
           << it->first << " " << it->second;
     }
   }
+  for (const ProfilerPoint* point : points_) {
+    if (event_prefix.empty() || point->name().find(event_prefix) == 0) {
+      LogMessage(file, line, severity_to_use).stream()
+          << point->name() << " " << point->GetStats();
+    }
+  }
   LogMessage(file, line, severity_to_use).stream()
       << "=== End profile report ===";
 }
@@ -162,8 +230,20 @@ const ProfilerEvent* Profiler::GetEvent(const std::string& event_name) const {
   return (it == events_.end()) ? NULL : &it->second;
 }
 
+ProfilerPoint* Profiler::GetPoint(const std::string& point_name) {
+  ExclusiveScope scope(&lock_);
+  for (ProfilerPoint* point : points_) {
+    if (point->name() == point_name)
+      return point;
+  }
+  points_.push_back(new ProfilerPoint(point_name));
+  return points_.back();
+}
+
 bool Profiler::Clear() {
   ExclusiveScope scope(&lock_);
+  for (ProfilerPoint* point : points_)
+    point->Reset();
   bool result = true;
   // Clear all events that aren't started.
   EventMap::iterator it = events_.begin();
@@ -189,4 +269,17 @@ std::ostream& operator<<(std::ostream& stream,
   return stream;
 }
 
+std::ostream& operator<<(std::ostream& stream,
+                         const ProfilerPoint::Stats& stats) {
+  double mean = stats.count == 0
+                    ? 0.0
+                    : NanosToSeconds(stats.total_ns) / stats.count;
+  stream << "count=" << stats.count
+         << " total=" << FormattedTime(NanosToSeconds(stats.total_ns))
+         << " mean=" << FormattedTime(mean)
+         << " min=" << FormattedTime(NanosToSeconds(stats.min_ns))
+         << " max=" << FormattedTime(NanosToSeconds(stats.max_ns));
+  return stream;
+}
+
 }  // namespace rtc
@@ -9,7 +9,9 @@
  */
 
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/profiler.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread.h"
 
 namespace {
@@ -24,6 +26,15 @@ const char* TestFunc() {
   return __FUNCTION__;
 }
 
+const int kRecordsPerThread = 1000;
+
+bool RecordPoints(void* /* obj */) {
+  for (int i = 0; i < kRecordsPerThread; ++i) {
+    PROFILE_POINT("Threaded point");
+  }
+  return false;
+}
+
 }  // namespace
 
 namespace rtc {
@@ -110,4 +121,39 @@ TEST(ProfilerTest, Clear) {
   EXPECT_EQ(NULL, Profiler::Instance()->GetEvent("event"));
 }
 
+TEST(ProfilerTest, ProfilingPoint) {
+  ASSERT_TRUE(Profiler::Instance()->Clear());
+  for (int i = 0; i < 3; ++i) {
+    PROFILE_POINT("Point");
+    rtc::Thread::SleepMs(10);
+  }
+  {  // Another call site with the same name shares the point.
+    PROFILE_POINT("Point");
+  }
+  ProfilerPoint::Stats stats =
+      Profiler::Instance()->GetPoint("Point")->GetStats();
+  EXPECT_EQ(4u, stats.count);
+  EXPECT_GE(stats.total_ns, 3 * 10 * kNumNanosecsPerMillisec);
+  EXPECT_LE(stats.min_ns, stats.max_ns);
+  EXPECT_GE(stats.max_ns, 10 * kNumNanosecsPerMillisec);
+
+  EXPECT_TRUE(Profiler::Instance()->Clear());
+  EXPECT_EQ(0u, Profiler::Instance()->GetPoint("Point")->GetStats().count);
+}
+
+TEST(ProfilerTest, ProfilingPointFromSeveralThreads) {
+  ASSERT_TRUE(Profiler::Instance()->Clear());
+  const int kNumThreads = 4;
+  scoped_ptr<PlatformThread> threads[kNumThreads];
+  for (auto& thread : threads) {
+    thread.reset(new PlatformThread(&RecordPoints, NULL, "ProfilerTest"));
+    thread->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  EXPECT_EQ(static_cast<uint64_t>(kNumThreads * kRecordsPerThread),
+            Profiler::Instance()->GetPoint("Threaded point")
+                ->GetStats().count);
+}
+
 }  // namespace rtc
@@ -29,4 +29,9 @@ size_t Sha1Digest::Finish(void* buf, size_t len) {
   return kSize;
 }
 
+bool Sha1Digest::CopyStateFrom(const MessageDigest& other) {
+  ctx_ = static_cast<const Sha1Digest&>(other).ctx_;
+  return true;
+}
+
 }  // namespace rtc
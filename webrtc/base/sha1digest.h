@@ -26,6 +26,7 @@ class Sha1Digest : public MessageDigest {
   size_t Size() const override;
   void Update(const void* buf, size_t len) override;
   size_t Finish(void* buf, size_t len) override;
+  bool CopyStateFrom(const MessageDigest& other) override;
 
  private:
   SHA1_CTX ctx_;
@@ -51,4 +51,107 @@ void multi_threaded_local::unlock() {
 
 #endif  // _SIGSLOT_HAS_POSIX_THREADS
 
+_fast_signal_base::_fast_signal_base()
+    : m_num_slots(0), m_emit_depth(0), m_has_removed_slots(false) {}
+
+_fast_signal_base::~_fast_signal_base() {
+  disconnect_all();
+}
+
+bool _fast_signal_base::is_empty() const {
+  for (size_t i = 0; i < m_num_slots; ++i) {
+    if (slot(i).thunk)
+      return false;
+  }
+  return true;
+}
+
+void _fast_signal_base::disconnect_all() {
+  for (size_t i = 0; i < m_num_slots; ++i) {
+    if (slot(i).thunk)
+      slot(i).dest->signal_disconnect(this);
+  }
+  if (m_emit_depth > 0) {
+    for (size_t i = 0; i < m_num_slots; ++i)
+      mutable_slot(i).thunk = NULL;
+    m_has_removed_slots = true;
+  } else {
+    m_more_slots.clear();
+    m_num_slots = 0;
+  }
+}
+
+void _fast_signal_base::disconnect(has_slots_interface* pclass) {
+  for (size_t i = 0; i < m_num_slots; ++i) {
+    if (slot(i).thunk && slot(i).dest == pclass) {
+      remove_slot(i);
+      pclass->signal_disconnect(this);
+      return;
+    }
+  }
+}
+
+#if !defined(NDEBUG)
+bool _fast_signal_base::connected(has_slots_interface* pclass) const {
+  for (size_t i = 0; i < m_num_slots; ++i) {
+    if (slot(i).thunk && slot(i).dest == pclass)
+      return true;
+  }
+  return false;
+}
+#endif
+
+void _fast_signal_base::slot_disconnect(has_slots_interface* pslot) {
+  // Walk backwards so that erasing does not skip the following slot.
+  for (size_t i = m_num_slots; i > 0; --i) {
+    if (slot(i - 1).thunk && slot(i - 1).dest == pslot)
+      remove_slot(i - 1);
+  }
+}
+
+void _fast_signal_base::slot_duplicate(const has_slots_interface* poldslot,
+                                       has_slots_interface* pnewslot) {
+  for (size_t i = 0, size = m_num_slots; i < size; ++i) {
+    if (slot(i).thunk && slot(i).dest == poldslot) {
+      _fast_slot duplicate = slot(i);
+      duplicate.dest = pnewslot;
+      push_slot(duplicate);
+    }
+  }
+}
+
+void _fast_signal_base::push_slot(const _fast_slot& slot) {
+  if (m_num_slots == 0)
+    m_first_slot = slot;
+  else
+    m_more_slots.push_back(slot);
+  ++m_num_slots;
+}
+
+void _fast_signal_base::remove_slot(size_t index) {
+  if (m_emit_depth > 0) {
+    // The slot may be in the middle of being called; erase it later so that
+    // the indices used by emit() stay valid.
+    mutable_slot(index).thunk = NULL;
+    m_has_removed_slots = true;
+    return;
+  }
+  for (size_t i = index + 1; i < m_num_slots; ++i)
+    mutable_slot(i - 1) = slot(i);
+  if (m_num_slots > 1)
+    m_more_slots.pop_back();
+  --m_num_slots;
+}
+
+void _fast_signal_base::compact_slots() {
+  size_t kept = 0;
+  for (size_t i = 0; i < m_num_slots; ++i) {
+    if (slot(i).thunk)
+      mutable_slot(kept++) = slot(i);
+  }
+  m_more_slots.resize(kept > 0 ? kept - 1 : 0);
+  m_num_slots = kept;
+  m_has_removed_slots = false;
+}
+
 };  // namespace sigslot
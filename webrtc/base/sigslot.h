@@ -90,6 +90,8 @@
 #include <list>
 #include <set>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 // On our copy of sigslot.h, we set single threading as default.
 #define SIGSLOT_DEFAULT_MT_POLICY single_threaded
@@ -2799,6 +2801,190 @@ namespace sigslot {
 		}
 	};
 
+	// Libjingle specific:
+	// fast_signal4 and fast_signal5 are single threaded signals for the packet
+	// path, where a signal is emitted for every packet. The first connection
+	// is stored inside the signal and any further ones in a vector, and each
+	// slot is called through a plain function pointer. That saves the walk of
+	// a std::list of separately allocated connections and the virtual call per
+	// slot that signalN pays. There is no lock, so connect, disconnect and emit
+	// must all happen on one thread. Slots may disconnect themselves or other
+	// slots while the signal is emitted; slots connected while the signal is
+	// emitted are first called by the next emit.
+	struct _fast_slot
+	{
+		has_slots_interface* dest;
+		// Points to the static invoke<desttype>() of the owning signal class,
+		// which knows how to call |memfun|. NULL once disconnected.
+		void (*thunk)();
+		// The member function pointer, copied in as raw bytes since its type
+		// depends on the class of |dest|.
+		char memfun[4 * sizeof(void*)];
+	};
+
+	class _fast_signal_base : public _signal_base_interface
+	{
+	public:
+		_fast_signal_base();
+		~_fast_signal_base();
+
+		bool is_empty() const;
+		void disconnect_all();
+		void disconnect(has_slots_interface* pclass);
+#if !defined(NDEBUG)
+		bool connected(has_slots_interface* pclass) const;
+#endif
+
+		void slot_disconnect(has_slots_interface* pslot);
+		void slot_duplicate(const has_slots_interface* poldslot, has_slots_interface* pnewslot);
+
+	protected:
+		template<class memfun_type>
+		void add_slot(has_slots_interface* pclass, void (*thunk)(),
+			memfun_type pmemfun)
+		{
+			static_assert(sizeof(pmemfun) <= sizeof(_fast_slot().memfun),
+				"Member function pointer does not fit in _fast_slot.");
+			_fast_slot slot;
+			slot.dest = pclass;
+			slot.thunk = thunk;
+			memcpy(slot.memfun, &pmemfun, sizeof(pmemfun));
+			push_slot(slot);
+			pclass->signal_connect(this);
+		}
+
+		size_t num_slots() const
+		{
+			return m_num_slots;
+		}
+		const _fast_slot& slot(size_t index) const
+		{
+			return index == 0 ? m_first_slot : m_more_slots[index - 1];
+		}
+
+		// Brackets a call of every slot. Slots removed in between are only
+		// marked, and erased once the outermost emit has finished.
+		void begin_emit()
+		{
+			++m_emit_depth;
+		}
+		void end_emit()
+		{
+			if(--m_emit_depth == 0 && m_has_removed_slots)
+				compact_slots();
+		}
+
+	private:
+		_fast_slot& mutable_slot(size_t index)
+		{
+			return index == 0 ? m_first_slot : m_more_slots[index - 1];
+		}
+		void push_slot(const _fast_slot& slot);
+		void remove_slot(size_t index);
+		void compact_slots();
+
+		_fast_slot m_first_slot;
+		std::vector<_fast_slot> m_more_slots;
+		size_t m_num_slots;
+		int m_emit_depth;
+		bool m_has_removed_slots;
+
+		// Not copyable; the signals this is used for live in objects that are
+		// not copied.
+		_fast_signal_base(const _fast_signal_base&);
+		_fast_signal_base& operator=(const _fast_signal_base&);
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class arg4_type>
+	class fast_signal4 : public _fast_signal_base
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type, arg4_type))
+		{
+			add_slot(pclass, reinterpret_cast<void (*)()>(&invoke<desttype>),
+				pmemfun);
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4)
+		{
+			begin_emit();
+			for(size_t i = 0, size = num_slots(); i < size; ++i)
+			{
+				const _fast_slot& s = slot(i);
+				if(s.thunk)
+					reinterpret_cast<thunk_type>(s.thunk)(s, a1, a2, a3, a4);
+			}
+			end_emit();
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4)
+		{
+			emit(a1, a2, a3, a4);
+		}
+
+	private:
+		typedef void (*thunk_type)(const _fast_slot&, arg1_type, arg2_type,
+			arg3_type, arg4_type);
+
+		template<class desttype>
+		static void invoke(const _fast_slot& slot, arg1_type a1, arg2_type a2,
+			arg3_type a3, arg4_type a4)
+		{
+			void (desttype::*pmemfun)(arg1_type, arg2_type, arg3_type, arg4_type);
+			memcpy(&pmemfun, slot.memfun, sizeof(pmemfun));
+			(static_cast<desttype*>(slot.dest)->*pmemfun)(a1, a2, a3, a4);
+		}
+	};
+
+	template<class arg1_type, class arg2_type, class arg3_type, class arg4_type,
+	class arg5_type>
+	class fast_signal5 : public _fast_signal_base
+	{
+	public:
+		template<class desttype>
+			void connect(desttype* pclass, void (desttype::*pmemfun)(arg1_type,
+			arg2_type, arg3_type, arg4_type, arg5_type))
+		{
+			add_slot(pclass, reinterpret_cast<void (*)()>(&invoke<desttype>),
+				pmemfun);
+		}
+
+		void emit(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4,
+			arg5_type a5)
+		{
+			begin_emit();
+			for(size_t i = 0, size = num_slots(); i < size; ++i)
+			{
+				const _fast_slot& s = slot(i);
+				if(s.thunk)
+					reinterpret_cast<thunk_type>(s.thunk)(s, a1, a2, a3, a4, a5);
+			}
+			end_emit();
+		}
+
+		void operator()(arg1_type a1, arg2_type a2, arg3_type a3, arg4_type a4,
+			arg5_type a5)
+		{
+			emit(a1, a2, a3, a4, a5);
+		}
+
+	private:
+		typedef void (*thunk_type)(const _fast_slot&, arg1_type, arg2_type,
+			arg3_type, arg4_type, arg5_type);
+
+		template<class desttype>
+		static void invoke(const _fast_slot& slot, arg1_type a1, arg2_type a2,
+			arg3_type a3, arg4_type a4, arg5_type a5)
+		{
+			void (desttype::*pmemfun)(arg1_type, arg2_type, arg3_type, arg4_type,
+				arg5_type);
+			memcpy(&pmemfun, slot.memfun, sizeof(pmemfun));
+			(static_cast<desttype*>(slot.dest)->*pmemfun)(a1, a2, a3, a4, a5);
+		}
+	};
+
 }; // namespace sigslot
 
 #endif // WEBRTC_BASE_SIGSLOT_H__
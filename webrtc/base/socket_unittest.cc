@@ -170,6 +170,15 @@ void SocketTest::TestUdpReadyToSendIPv6() {
 #endif
 }
 
+void SocketTest::TestUdpBatchIPv4() {
+  UdpBatchInternal(kIPv4Loopback);
+}
+
+void SocketTest::TestUdpBatchIPv6() {
+  MAYBE_SKIP_IPV6;
+  UdpBatchInternal(kIPv6Loopback);
+}
+
 void SocketTest::TestGetSetOptionsIPv4() {
   GetSetOptionsInternal(kIPv4Loopback);
 }
@@ -905,6 +914,55 @@ void SocketTest::UdpInternal(const IPAddress& loopback) {
   }
 }
 
+void SocketTest::UdpBatchInternal(const IPAddress& loopback) {
+  scoped_ptr<AsyncSocket> receiver(
+      ss_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(loopback, 0)));
+  scoped_ptr<AsyncSocket> sender(
+      ss_->CreateAsyncSocket(loopback.family(), SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(loopback, 0)));
+
+  const char* kPayloads[] = {"foo", "bizbaz", "qux!"};
+  const size_t kNumPayloads = arraysize(kPayloads);
+  AsyncSocket::Datagram out[kNumPayloads];
+  for (size_t i = 0; i < kNumPayloads; ++i) {
+    out[i].data = const_cast<char*>(kPayloads[i]);
+    out[i].length = strlen(kPayloads[i]);
+    out[i].addr = receiver->GetLocalAddress();
+  }
+  EXPECT_EQ(static_cast<int>(kNumPayloads),
+            sender->SendToBatch(out, kNumPayloads));
+
+  // Reserve one slot more than needed, the batch must stop when the socket
+  // runs dry.
+  char buffers[kNumPayloads + 1][64];
+  AsyncSocket::Datagram in[kNumPayloads + 1];
+  for (size_t i = 0; i < kNumPayloads + 1; ++i) {
+    in[i].data = buffers[i];
+    in[i].size = sizeof(buffers[i]);
+  }
+  size_t received = 0;
+  uint32_t start = Time();
+  while (received < kNumPayloads && TimeSince(start) < kTimeout) {
+    int count = receiver->RecvFromBatch(&in[received],
+                                        kNumPayloads + 1 - received);
+    if (count < 0) {
+      EXPECT_TRUE(receiver->IsBlocking());
+      Thread::Current()->ProcessMessages(10);
+      continue;
+    }
+    received += count;
+  }
+  ASSERT_EQ(kNumPayloads, received);
+  for (size_t i = 0; i < kNumPayloads; ++i) {
+    EXPECT_EQ(std::string(kPayloads[i]),
+              std::string(static_cast<char*>(in[i].data), in[i].length));
+    EXPECT_EQ(sender->GetLocalAddress(), in[i].addr);
+  }
+  EXPECT_EQ(-1, receiver->RecvFromBatch(in, kNumPayloads + 1));
+  EXPECT_TRUE(receiver->IsBlocking());
+}
+
 void SocketTest::UdpReadyToSend(const IPAddress& loopback) {
   SocketAddress empty = EmptySocketAddressWithFamily(loopback.family());
   // RFC 5737 - The blocks 192.0.2.0/24 (TEST-NET-1) ... are provided for use in
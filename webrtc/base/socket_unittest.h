@@ -55,6 +55,8 @@ class SocketTest : public testing::Test {
   void TestUdpIPv6();
   void TestUdpReadyToSendIPv4();
   void TestUdpReadyToSendIPv6();
+  void TestUdpBatchIPv4();
+  void TestUdpBatchIPv6();
   void TestGetSetOptionsIPv4();
   void TestGetSetOptionsIPv6();
 
@@ -80,6 +82,7 @@ class SocketTest : public testing::Test {
   void SingleFlowControlCallbackInternal(const IPAddress& loopback);
   void UdpInternal(const IPAddress& loopback);
   void UdpReadyToSend(const IPAddress& loopback);
+  void UdpBatchInternal(const IPAddress& loopback);
   void GetSetOptionsInternal(const IPAddress& loopback);
 
   SocketServer* ss_;
@@ -29,6 +29,13 @@ class SSLAdapter : public AsyncSocketAdapter {
   // Do DTLS or TLS (default is TLS, if unspecified)
   virtual void SetMode(SSLMode mode) = 0;
 
+  // By default each Send() is written as its own TLS record. With a
+  // non-negative |max_delay_ms|, consecutive small sends are instead gathered
+  // into one record, written when it is full or |max_delay_ms| after the first
+  // of them (0 meaning the next message loop iteration). Ignored for DTLS,
+  // which must keep datagram boundaries.
+  virtual void SetWriteCoalescing(int max_delay_ms) = 0;
+
   // StartSSL returns 0 if successful.
   // If StartSSL is called while the socket is closed or connecting, the SSL
   // negotiation will begin as soon as the socket connects.
@@ -17,6 +17,7 @@
 #include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/sslidentity.h"
 #include "webrtc/base/stream.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/base/virtualsocketserver.h"
 
 static const int kTimeout = 5000;
@@ -40,7 +41,7 @@ static std::string GetSSLProtocolName(const rtc::SSLMode& ssl_mode) {
 class SSLAdapterTestDummyClient : public sigslot::has_slots<> {
  public:
   explicit SSLAdapterTestDummyClient(const rtc::SSLMode& ssl_mode)
-      : ssl_mode_(ssl_mode) {
+      : ssl_mode_(ssl_mode), packets_left_(0) {
     rtc::AsyncSocket* socket = CreateSocket(ssl_mode_);
 
     ssl_adapter_.reset(rtc::SSLAdapter::Create(socket));
@@ -56,6 +57,12 @@ class SSLAdapterTestDummyClient : public sigslot::has_slots<> {
         &SSLAdapterTestDummyClient::OnSSLAdapterReadEvent);
     ssl_adapter_->SignalCloseEvent.connect(this,
         &SSLAdapterTestDummyClient::OnSSLAdapterCloseEvent);
+    ssl_adapter_->SignalWriteEvent.connect(this,
+        &SSLAdapterTestDummyClient::OnSSLAdapterWriteEvent);
+  }
+
+  void SetWriteCoalescing(int max_delay_ms) {
+    ssl_adapter_->SetWriteCoalescing(max_delay_ms);
   }
 
   rtc::SocketAddress GetAddress() const {
@@ -97,6 +104,24 @@ class SSLAdapterTestDummyClient : public sigslot::has_slots<> {
     return ssl_adapter_->Send(message.data(), message.length());
   }
 
+  // Sends |packet| |count| times, resuming on write events whenever the
+  // adapter would block.
+  void SendPackets(const std::string& packet, int count) {
+    packet_ = packet;
+    packets_left_ = count;
+    OnSSLAdapterWriteEvent(ssl_adapter_.get());
+  }
+
+  int packets_left() const { return packets_left_; }
+
+  void OnSSLAdapterWriteEvent(rtc::AsyncSocket* socket) {
+    while (packets_left_ > 0) {
+      if (ssl_adapter_->Send(packet_.data(), packet_.length()) <= 0)
+        return;
+      --packets_left_;
+    }
+  }
+
   void OnSSLAdapterReadEvent(rtc::AsyncSocket* socket) {
     char buffer[4096] = "";
 
@@ -126,6 +151,9 @@ class SSLAdapterTestDummyClient : public sigslot::has_slots<> {
   rtc::scoped_ptr<rtc::SSLAdapter> ssl_adapter_;
 
   std::string data_;
+
+  std::string packet_;
+  int packets_left_;
 };
 
 class SSLAdapterTestDummyServer : public sigslot::has_slots<> {
@@ -214,13 +242,12 @@ class SSLAdapterTestDummyServer : public sigslot::has_slots<> {
       int error;
 
       // Read data received from the client and store it in our internal
-      // buffer.
-      rtc::StreamResult r = stream->Read(buffer,
-          sizeof(buffer) - 1, &read, &error);
-      if (r == rtc::SR_SUCCESS) {
+      // buffer. More than fits in |buffer| may have arrived at once.
+      while (stream->Read(buffer, sizeof(buffer) - 1, &read, &error) ==
+             rtc::SR_SUCCESS) {
         buffer[read] = '\0';
 
-        LOG(LS_INFO) << "Server received '" << buffer << "'";
+        LOG(LS_VERBOSE) << "Server received '" << buffer << "'";
 
         data_ += buffer;
       }
@@ -334,6 +361,25 @@ class SSLAdapterTestBase : public testing::Test,
     LOG(LS_INFO) << "Transfer complete.";
   }
 
+  void SetWriteCoalescing(int max_delay_ms) {
+    client_->SetWriteCoalescing(max_delay_ms);
+  }
+
+  // Sends |count| packets of |size| bytes from the client, as a TURN client
+  // relaying media over TLS does, and returns how long it took until the
+  // server had received all of them.
+  int64_t TestPacketTransfer(int count, size_t size) {
+    std::string packet(size, 'x');
+    size_t expected_size = server_->GetReceivedData().size() + count * size;
+    uint32_t start = rtc::Time();
+
+    client_->SendPackets(packet, count);
+
+    EXPECT_EQ_WAIT(expected_size, server_->GetReceivedData().size(), kTimeout);
+    EXPECT_EQ(0, client_->packets_left());
+    return rtc::TimeSince(start);
+  }
+
  private:
   const rtc::SSLMode ssl_mode_;
 
@@ -395,6 +441,36 @@ TEST_F(SSLAdapterTestTLS_ECDSA, TestTLSTransfer) {
   TestTransfer("Hello, world!");
 }
 
+// Test that small sends gathered into shared records all arrive, in order.
+TEST_F(SSLAdapterTestTLS_RSA, TestTLSTransferWithWriteCoalescing) {
+  SetWriteCoalescing(0);
+  TestHandshake(true);
+  TestTransfer("Hello, world!");
+  TestPacketTransfer(1000, 100);
+}
+
+// Test that coalescing with a delay still delivers everything.
+TEST_F(SSLAdapterTestTLS_ECDSA, TestTLSTransferWithDelayedWriteCoalescing) {
+  SetWriteCoalescing(10);
+  TestHandshake(true);
+  TestPacketTransfer(100, 1200);
+}
+
+// Compares relaying many media-sized packets over TLS with one record per
+// packet and with write coalescing.
+TEST_F(SSLAdapterTestTLS_RSA, DISABLED_BenchmarkTLSPacketTransfer) {
+  TestHandshake(true);
+  LOG(LS_INFO) << "One record per packet: "
+               << TestPacketTransfer(20000, 1200) << " ms";
+}
+
+TEST_F(SSLAdapterTestTLS_RSA, DISABLED_BenchmarkTLSPacketTransferCoalesced) {
+  SetWriteCoalescing(0);
+  TestHandshake(true);
+  LOG(LS_INFO) << "Coalesced records: "
+               << TestPacketTransfer(20000, 1200) << " ms";
+}
+
 // Basic tests: DTLS
 
 // Test that handshake works, using RSA
@@ -29,12 +29,18 @@ namespace rtc {
 // webrtc:5043.
 const char CS_AES_CM_128_HMAC_SHA1_80[] = "AES_CM_128_HMAC_SHA1_80";
 const char CS_AES_CM_128_HMAC_SHA1_32[] = "AES_CM_128_HMAC_SHA1_32";
+const char CS_AEAD_AES_128_GCM[] = "AEAD_AES_128_GCM";
+const char CS_AEAD_AES_256_GCM[] = "AEAD_AES_256_GCM";
 
 std::string SrtpCryptoSuiteToName(int crypto_suite) {
   if (crypto_suite == SRTP_AES128_CM_SHA1_32)
     return CS_AES_CM_128_HMAC_SHA1_32;
   if (crypto_suite == SRTP_AES128_CM_SHA1_80)
     return CS_AES_CM_128_HMAC_SHA1_80;
+  if (crypto_suite == SRTP_AEAD_AES_128_GCM)
+    return CS_AEAD_AES_128_GCM;
+  if (crypto_suite == SRTP_AEAD_AES_256_GCM)
+    return CS_AEAD_AES_256_GCM;
   return std::string();
 }
 
@@ -43,9 +49,51 @@ int SrtpCryptoSuiteFromName(const std::string& crypto_suite) {
     return SRTP_AES128_CM_SHA1_32;
   if (crypto_suite == CS_AES_CM_128_HMAC_SHA1_80)
     return SRTP_AES128_CM_SHA1_80;
+  if (crypto_suite == CS_AEAD_AES_128_GCM)
+    return SRTP_AEAD_AES_128_GCM;
+  if (crypto_suite == CS_AEAD_AES_256_GCM)
+    return SRTP_AEAD_AES_256_GCM;
   return SRTP_INVALID_CRYPTO_SUITE;
 }
 
+bool GetSrtpKeyAndSaltLengths(int crypto_suite,
+                              int* key_length,
+                              int* salt_length) {
+  switch (crypto_suite) {
+    case SRTP_AES128_CM_SHA1_32:
+    case SRTP_AES128_CM_SHA1_80:
+      // SRTP_AES128_CM_HMAC_SHA1_32 and SRTP_AES128_CM_HMAC_SHA1_80 are defined
+      // in RFC 5764 to use a 128 bits key and 112 bits salt for the cipher.
+      *key_length = 16;
+      *salt_length = 14;
+      return true;
+    case SRTP_AEAD_AES_128_GCM:
+      // SRTP_AEAD_AES_128_GCM is defined in RFC 7714 to use a 128 bits key and
+      // a 96 bits salt for the cipher.
+      *key_length = 16;
+      *salt_length = 12;
+      return true;
+    case SRTP_AEAD_AES_256_GCM:
+      // SRTP_AEAD_AES_256_GCM is defined in RFC 7714 to use a 256 bits key and
+      // a 96 bits salt for the cipher.
+      *key_length = 32;
+      *salt_length = 12;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsGcmCryptoSuite(int crypto_suite) {
+  return (crypto_suite == SRTP_AEAD_AES_256_GCM ||
+          crypto_suite == SRTP_AEAD_AES_128_GCM);
+}
+
+bool IsGcmCryptoSuiteName(const std::string& crypto_suite) {
+  return (crypto_suite == CS_AEAD_AES_256_GCM ||
+          crypto_suite == CS_AEAD_AES_128_GCM);
+}
+
 SSLStreamAdapter* SSLStreamAdapter::Create(StreamInterface* stream) {
 #if SSL_USE_OPENSSL
   return new OpenSSLStreamAdapter(stream);
@@ -86,6 +134,12 @@ bool SSLStreamAdapter::HaveDtlsSrtp() {
 bool SSLStreamAdapter::HaveExporter() {
   return OpenSSLStreamAdapter::HaveExporter();
 }
+void SSLStreamAdapter::SetDtlsSessionCacheSize(size_t max_sessions) {
+  OpenSSLStreamAdapter::SetDtlsSessionCacheSize(max_sessions);
+}
+SSLSessionCacheStats SSLStreamAdapter::GetDtlsSessionCacheStats() {
+  return OpenSSLStreamAdapter::GetDtlsSessionCacheStats();
+}
 int SSLStreamAdapter::GetDefaultSslCipherForTest(SSLProtocolVersion version,
                                                  KeyType key_type) {
   return OpenSSLStreamAdapter::GetDefaultSslCipherForTest(version, key_type);
@@ -26,6 +26,13 @@ const int TLS_NULL_WITH_NULL_NULL = 0;
 const int SRTP_INVALID_CRYPTO_SUITE = 0;
 const int SRTP_AES128_CM_SHA1_80 = 0x0001;
 const int SRTP_AES128_CM_SHA1_32 = 0x0002;
+// BoringSSL defines these as macros already.
+#ifndef SRTP_AEAD_AES_128_GCM
+const int SRTP_AEAD_AES_128_GCM = 0x0007;
+#endif
+#ifndef SRTP_AEAD_AES_256_GCM
+const int SRTP_AEAD_AES_256_GCM = 0x0008;
+#endif
 
 // Cipher suite to use for SRTP. Typically a 80-bit HMAC will be used, except
 // in applications (voice) where the additional bandwidth may be significant.
@@ -34,6 +41,12 @@ const int SRTP_AES128_CM_SHA1_32 = 0x0002;
 extern const char CS_AES_CM_128_HMAC_SHA1_80[];
 // 128-bit AES with 32-bit SHA-1 HMAC.
 extern const char CS_AES_CM_128_HMAC_SHA1_32[];
+// 128-bit AES in GCM mode with a 16 byte authentication tag (RFC 7714). It
+// encrypts and authenticates in one pass, which is much cheaper than AES-CM
+// followed by HMAC-SHA1 where the SSL library uses AES-NI or ARMv8 crypto.
+extern const char CS_AEAD_AES_128_GCM[];
+// 256-bit AES in GCM mode with a 16 byte authentication tag (RFC 7714).
+extern const char CS_AEAD_AES_256_GCM[];
 
 // Given the DTLS-SRTP protection profile ID, as defined in
 // https://tools.ietf.org/html/rfc4568#section-6.2 , return the SRTP profile
@@ -43,6 +56,34 @@ std::string SrtpCryptoSuiteToName(int crypto_suite);
 // The reverse of above conversion.
 int SrtpCryptoSuiteFromName(const std::string& crypto_suite);
 
+// Gets the key and salt lengths, in bytes, of the SRTP master keys of
+// |crypto_suite|. Returns false for unknown crypto suites.
+bool GetSrtpKeyAndSaltLengths(int crypto_suite,
+                              int* key_length,
+                              int* salt_length);
+
+// Returns true if |crypto_suite| is one of the AES-GCM crypto suites.
+bool IsGcmCryptoSuite(int crypto_suite);
+bool IsGcmCryptoSuiteName(const std::string& crypto_suite);
+
+// Options for the SRTP crypto suites to negotiate.
+struct CryptoOptions {
+  CryptoOptions() : enable_gcm_crypto_suites(false) {}
+
+  // Offer and accept the AES-GCM crypto suites, in preference to the AES-CM
+  // ones. Off by default, as not all endpoints support them.
+  bool enable_gcm_crypto_suites;
+};
+
+// Counters of the DTLS session cache. Every handshake made while the cache
+// is on counts as a lookup, and as a hit too if it resumed a session.
+struct SSLSessionCacheStats {
+  SSLSessionCacheStats() : lookups(0), hits(0) {}
+
+  uint64_t lookups;
+  uint64_t hits;
+};
+
 // SSLStreamAdapter : A StreamInterfaceAdapter that does SSL/TLS.
 // After SSL has been started, the stream will only open on successful
 // SSL verification of certificates, and the communication is
@@ -189,6 +230,14 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   static bool HaveDtlsSrtp();
   static bool HaveExporter();
 
+  // Peer-to-peer DTLS streams can keep the sessions they establish in a cache
+  // shared by the process, keyed on the digest of the peer's certificate, and
+  // resume them the next time they connect to the same peer, which saves the
+  // public key operations of a full handshake. |max_sessions| bounds the
+  // cache; it's 0, which turns caching off, by default.
+  static void SetDtlsSessionCacheSize(size_t max_sessions);
+  static SSLSessionCacheStats GetDtlsSessionCacheStats();
+
   // Returns the default Ssl cipher used between streams of this class
   // for the given protocol version. This is used by the unit tests.
   // TODO(guoweis): Move this away from a static class method.
@@ -335,8 +335,16 @@ void Thread::Send(MessageHandler* phandler, uint32_t id, MessageData* pdata) {
 
   AssertBlockingIsAllowedOnCurrentThread();
 
-  AutoThread thread;
-  Thread *current_thread = Thread::Current();
+  // The sending thread waits on its own socket server. Only wrap it for the
+  // duration of the call if it is not wrapped already; creating a Thread
+  // creates a socket server too, which would otherwise dominate the cost of
+  // every call.
+  scoped_ptr<AutoThread> auto_thread;
+  Thread* current_thread = Thread::Current();
+  if (!current_thread) {
+    auto_thread.reset(new AutoThread());
+    current_thread = Thread::Current();
+  }
   ASSERT(current_thread != NULL);  // AutoThread ensures this
 
   bool ready = false;
@@ -408,7 +416,7 @@ void Thread::ReceiveSendsFromThread(const Thread* source) {
 }
 
 bool Thread::PopSendMessageFromThread(const Thread* source, _SendMessage* msg) {
-  for (std::list<_SendMessage>::iterator it = sendlist_.begin();
+  for (std::vector<_SendMessage>::iterator it = sendlist_.begin();
        it != sendlist_.end(); ++it) {
     if (it->thread == source || source == NULL) {
       *msg = *it;
@@ -419,6 +427,12 @@ bool Thread::PopSendMessageFromThread(const Thread* source, _SendMessage* msg) {
   return false;
 }
 
+void Thread::TaskHandler::OnMessage(Message* msg) {
+  QueuedTask* task = static_cast<QueuedTask*>(msg->pdata);
+  task->Run();
+  delete task;
+}
+
 void Thread::InvokeBegin() {
   TRACE_EVENT_BEGIN0("webrtc", "Thread::Invoke");
 }
@@ -436,7 +450,7 @@ void Thread::Clear(MessageHandler* phandler,
   // Object target cleared: remove from send list, wakeup/set ready
   // if sender not NULL.
 
-  std::list<_SendMessage>::iterator iter = sendlist_.begin();
+  std::vector<_SendMessage>::iterator iter = sendlist_.begin();
   while (iter != sendlist_.end()) {
     _SendMessage smsg = *iter;
     if (smsg.msg.Match(phandler, id)) {
@@ -164,6 +164,17 @@ class Thread : public MessageQueue {
     return handler.result();
   }
 
+  // Posts |functor| to run on this thread and returns without waiting for it.
+  // Any copyable callable taking no arguments will do, including a lambda.
+  // Tasks that are still queued when the thread is cleared or destroyed are
+  // deleted without being run. Use AsyncInvoker to get the result back or to
+  // be able to cancel the call.
+  // Ex: thread.PostTask([this] { DoSomething(); });
+  template <class FunctorT>
+  void PostTask(const FunctorT& functor) {
+    Post(&task_handler_, 0, new FunctorTask<FunctorT>(functor));
+  }
+
   // From MessageQueue
   void Clear(MessageHandler* phandler,
              uint32_t id = MQID_ANY,
@@ -258,7 +269,32 @@ class Thread : public MessageQueue {
   void InvokeBegin();
   void InvokeEnd();
 
-  std::list<_SendMessage> sendlist_;
+  // The payload of a PostTask() message.
+  class QueuedTask : public MessageData {
+   public:
+    virtual void Run() = 0;
+  };
+
+  template <class FunctorT>
+  class FunctorTask : public QueuedTask {
+   public:
+    explicit FunctorTask(const FunctorT& functor) : functor_(functor) {}
+    void Run() override { functor_(); }
+
+   private:
+    FunctorT functor_;
+  };
+
+  // Runs and deletes the QueuedTask of each PostTask() message.
+  class TaskHandler : public MessageHandler {
+   public:
+    void OnMessage(Message* msg) override;
+  };
+
+  // A vector rather than a list, so that sending does not allocate once it
+  // has grown to the number of threads that send at the same time.
+  std::vector<_SendMessage> sendlist_;
+  TaskHandler task_handler_;
   std::string name_;
   Event running_;  // Signalled means running.
 
@@ -12,9 +12,11 @@
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 #if defined(WEBRTC_WIN)
 #include <comdef.h>  // NOLINT
@@ -377,6 +379,67 @@ TEST(ThreadTest, ThreeThreadsInvoke) {
   EXPECT_TRUE_WAIT(thread_a_called.Get(), 2000);
 }
 
+TEST(ThreadTest, PostTask) {
+  Thread thread;
+  thread.Start();
+  std::vector<int> order;
+  Event done(false, false);
+  for (int i = 0; i < 3; ++i)
+    thread.PostTask([&order, i] { order.push_back(i); });
+  thread.PostTask([&done] { done.Set(); });
+  EXPECT_TRUE(done.Wait(1000));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), order);
+}
+
+TEST(ThreadTest, ClearedPostTaskIsNotRun) {
+  Thread thread;
+  bool ran = false;
+  thread.PostTask([&ran] { ran = true; });
+  thread.Clear(NULL);
+  thread.Start();
+  Event done(false, false);
+  thread.PostTask([&done] { done.Set(); });
+  EXPECT_TRUE(done.Wait(1000));
+  EXPECT_FALSE(ran);
+}
+
+// Compares 1000 Invoke() calls from a wrapped thread with 1000 calls from an
+// unwrapped thread, which pays for a temporary Thread in every call as every
+// caller used to, and with 1000 PostTask() calls.
+TEST(ThreadTest, InvokePerf) {
+  const int kNumCalls = 1000;
+  Thread thread;
+  thread.Start();
+  int count = 0;
+  auto increment = [&count] { ++count; };
+
+  uint64_t start = TimeMicros();
+  for (int i = 0; i < kNumCalls; ++i)
+    thread.Invoke<void>(increment);
+  const uint64_t wrapped_us = TimeMicros() - start;
+
+  Thread* current_thread = Thread::Current();
+  current_thread->UnwrapCurrent();
+  start = TimeMicros();
+  for (int i = 0; i < kNumCalls; ++i)
+    thread.Invoke<void>(increment);
+  const uint64_t unwrapped_us = TimeMicros() - start;
+  current_thread->WrapCurrent();
+
+  Event done(false, false);
+  start = TimeMicros();
+  for (int i = 0; i < kNumCalls; ++i)
+    thread.PostTask(increment);
+  thread.PostTask([&done] { done.Set(); });
+  EXPECT_TRUE(done.Wait(10000));
+  const uint64_t posted_us = TimeMicros() - start;
+
+  EXPECT_EQ(3 * kNumCalls, count);
+  LOG(LS_INFO) << kNumCalls << " calls to Invoke from a wrapped thread: "
+               << wrapped_us << " us, from an unwrapped thread: "
+               << unwrapped_us << " us, PostTask: " << posted_us << " us";
+}
+
 class AsyncInvokeTest : public testing::Test {
  public:
   void IntCallback(int value) {
@@ -913,6 +913,67 @@ TEST_F(VirtualSocketServerTest, DISABLED_delay_v6) {
   DelayTest(kIPv6AnyAddress);
 }
 
+// Datagrams that are due at the same time are delivered together, and must
+// still arrive in the order they were sent.
+TEST_F(VirtualSocketServerTest, DatagramsDueTogetherArriveInOrder) {
+  ss_->set_delay_mean(50);
+  ss_->UpdateDelayDistribution();
+  scoped_ptr<AsyncSocket> send_socket(
+      ss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> recv_socket(
+      ss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, send_socket->Bind(kIPv4AnyAddress));
+  ASSERT_EQ(0, recv_socket->Bind(kIPv4AnyAddress));
+
+  const int kNumPackets = 100;
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(static_cast<int>(sizeof(i)),
+              send_socket->SendTo(&i, sizeof(i),
+                                  recv_socket->GetLocalAddress()));
+  }
+  ss_->ProcessMessagesUntilIdle();
+
+  SocketAddress addr;
+  int received;
+  for (int i = 0; i < kNumPackets; ++i) {
+    ASSERT_EQ(static_cast<int>(sizeof(received)),
+              recv_socket->RecvFrom(&received, sizeof(received), &addr));
+    EXPECT_EQ(i, received);
+  }
+  EXPECT_EQ(-1, recv_socket->RecvFrom(&received, sizeof(received), &addr));
+
+  ss_->set_delay_mean(0);
+  ss_->UpdateDelayDistribution();
+}
+
+TEST_F(VirtualSocketServerTest, DeletingSocketCancelsItsPackets) {
+  ss_->set_delay_mean(50);
+  ss_->UpdateDelayDistribution();
+  scoped_ptr<AsyncSocket> send_socket(
+      ss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> recv_socket(
+      ss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  scoped_ptr<AsyncSocket> other_recv_socket(
+      ss_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, send_socket->Bind(kIPv4AnyAddress));
+  ASSERT_EQ(0, recv_socket->Bind(kIPv4AnyAddress));
+  ASSERT_EQ(0, other_recv_socket->Bind(kIPv4AnyAddress));
+
+  EXPECT_EQ(3, send_socket->SendTo("foo", 3, recv_socket->GetLocalAddress()));
+  EXPECT_EQ(3, send_socket->SendTo("bar", 3,
+                                   other_recv_socket->GetLocalAddress()));
+  recv_socket.reset();
+  ss_->ProcessMessagesUntilIdle();
+
+  char buffer[3];
+  SocketAddress addr;
+  EXPECT_EQ(3, other_recv_socket->RecvFrom(buffer, sizeof(buffer), &addr));
+  EXPECT_EQ(0, memcmp("bar", buffer, 3));
+
+  ss_->set_delay_mean(0);
+  ss_->UpdateDelayDistribution();
+}
+
 // Works, receiving socket sees 127.0.0.2.
 TEST_F(VirtualSocketServerTest, CanConnectFromMappedIPv6ToIPv4Any) {
   CrossFamilyConnectionTest(SocketAddress("::ffff:127.0.0.2", 0),
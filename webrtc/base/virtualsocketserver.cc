@@ -52,7 +52,7 @@ const uint32_t TCP_MSS = 1400;        // Maximum segment size
 const int NUM_SAMPLES = 1000;
 
 enum {
-  MSG_ID_PACKET,
+  MSG_ID_DELIVER_PACKETS,
   MSG_ID_ADDRESS_BOUND,
   MSG_ID_CONNECT,
   MSG_ID_DISCONNECT,
@@ -94,6 +94,31 @@ struct MessageAddress : public MessageData {
   SocketAddress addr;
 };
 
+// The packets that are due at |time|, in the order they were sent. Entries of
+// cancelled or delivered packets are NULL.
+struct VirtualSocketServer::PacketBatch : public MessageData {
+  explicit PacketBatch(uint32_t time) : time(time) {}
+  ~PacketBatch() override {
+    for (const auto& entry : packets)
+      delete entry.second;
+  }
+
+  const uint32_t time;
+  std::vector<std::pair<VirtualSocket*, Packet*>> packets;
+};
+
+size_t VirtualSocketServer::AddressHash::operator()(
+    const SocketAddress& addr) const {
+  return addr.Hash();
+}
+
+size_t VirtualSocketServer::AddressPairHash::operator()(
+    const SocketAddressPair& pair) const {
+  // Connections are added in both directions, so don't hash (a, b) and (b, a)
+  // the same, as SocketAddressPair::Hash() does.
+  return pair.source().Hash() * 31 + pair.destination().Hash();
+}
+
 VirtualSocket::VirtualSocket(VirtualSocketServer* server,
                              int family,
                              int type,
@@ -115,6 +140,7 @@ VirtualSocket::VirtualSocket(VirtualSocketServer* server,
 
 VirtualSocket::~VirtualSocket() {
   Close();
+  server_->CancelPackets(this);
 
   for (RecvBuffer::iterator it = recv_buffer_.begin(); it != recv_buffer_.end();
        ++it) {
@@ -226,6 +252,7 @@ int VirtualSocket::Close() {
       delete data;
     }
     // Clear incoming packets and disconnect messages
+    server_->CancelPackets(this);
     if (server_->msg_queue_) {
       server_->msg_queue_->Clear(this);
     }
@@ -383,18 +410,16 @@ int VirtualSocket::EstimateMTU(uint16_t* mtu) {
     return 65536;
 }
 
-void VirtualSocket::OnMessage(Message* pmsg) {
-  if (pmsg->message_id == MSG_ID_PACKET) {
-    // ASSERT(!local_addr_.IsAnyIP());
-    ASSERT(NULL != pmsg->pdata);
-    Packet* packet = static_cast<Packet*>(pmsg->pdata);
+void VirtualSocket::OnPacket(Packet* packet) {
+  recv_buffer_.push_back(packet);
 
-    recv_buffer_.push_back(packet);
+  if (async_) {
+    SignalReadEvent(this);
+  }
+}
 
-    if (async_) {
-      SignalReadEvent(this);
-    }
-  } else if (pmsg->message_id == MSG_ID_CONNECT) {
+void VirtualSocket::OnMessage(Message* pmsg) {
+  if (pmsg->message_id == MSG_ID_CONNECT) {
     ASSERT(NULL != pmsg->pdata);
     MessageAddress* data = static_cast<MessageAddress*>(pmsg->pdata);
     if (listen_queue_ != NULL) {
@@ -590,6 +615,44 @@ void VirtualSocketServer::WakeUp() {
   socketserver()->WakeUp();
 }
 
+void VirtualSocketServer::OnMessage(Message* msg) {
+  ASSERT(msg->message_id == MSG_ID_DELIVER_PACKETS);
+  PacketBatch* batch = static_cast<PacketBatch*>(msg->pdata);
+  {
+    CritScope cs(&batches_crit_);
+    pending_batches_.erase(batch->time);
+    // A read handler can close or delete any socket, which cancels the rest
+    // of its packets in this batch.
+    delivering_batches_.push_back(batch);
+  }
+  for (size_t i = 0; i < batch->packets.size(); ++i) {
+    VirtualSocket* recipient;
+    Packet* packet;
+    {
+      CritScope cs(&batches_crit_);
+      recipient = batch->packets[i].first;
+      packet = batch->packets[i].second;
+      batch->packets[i].first = nullptr;
+      batch->packets[i].second = nullptr;
+    }
+    if (recipient)
+      recipient->OnPacket(packet);
+  }
+  {
+    CritScope cs(&batches_crit_);
+    RTC_DCHECK(delivering_batches_.back() == batch);
+    delivering_batches_.pop_back();
+  }
+  delete batch;
+}
+
+void VirtualSocketServer::OnMessageQueueDestroyed() {
+  msg_queue_ = NULL;
+  // The queue deletes the batches that are still posted.
+  CritScope cs(&batches_crit_);
+  pending_batches_.clear();
+}
+
 bool VirtualSocketServer::ProcessMessagesUntilIdle() {
   ASSERT(msg_queue_ == Thread::Current());
   stop_on_idle_ = true;
@@ -891,7 +954,8 @@ void VirtualSocketServer::AddPacketToNetwork(VirtualSocket* sender,
     sender_addr.SetIP(default_ip);
   }
 
-  // Post the packet as a message to be delivered (on our own thread)
+  // Add the packet to the batch to be delivered (on our own thread) at its
+  // arrival time.
   Packet* p = new Packet(data, data_size, sender_addr);
 
   uint32_t ts = TimeAfter(send_delay + transit_delay);
@@ -901,7 +965,13 @@ void VirtualSocketServer::AddPacketToNetwork(VirtualSocket* sender,
     // introduces artifical delay.
     ts = TimeMax(ts, network_delay_);
   }
-  msg_queue_->PostAt(ts, recipient, MSG_ID_PACKET, p);
+  CritScope cs(&batches_crit_);
+  PacketBatch*& batch = pending_batches_[ts];
+  if (!batch) {
+    batch = new PacketBatch(ts);
+    msg_queue_->PostAt(ts, this, MSG_ID_DELIVER_PACKETS, batch);
+  }
+  batch->packets.push_back(std::make_pair(recipient, p));
   network_delay_ = TimeMax(ts, network_delay_);
 }
 
@@ -915,6 +985,23 @@ void VirtualSocketServer::PurgeNetworkPackets(VirtualSocket* socket,
   }
 }
 
+void VirtualSocketServer::CancelPackets(VirtualSocket* socket) {
+  auto cancel = [socket](PacketBatch* batch) {
+    for (auto& entry : batch->packets) {
+      if (entry.first == socket) {
+        delete entry.second;
+        entry.first = nullptr;
+        entry.second = nullptr;
+      }
+    }
+  };
+  CritScope cs(&batches_crit_);
+  for (const auto& it : pending_batches_)
+    cancel(it.second);
+  for (PacketBatch* batch : delivering_batches_)
+    cancel(batch);
+}
+
 uint32_t VirtualSocketServer::SendDelay(uint32_t size) {
   if (bandwidth_ == 0)
     return 0;
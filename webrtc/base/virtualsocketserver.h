@@ -15,6 +15,8 @@
 
 #include <deque>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "webrtc/base/messagequeue.h"
 #include "webrtc/base/socketserver.h"
@@ -29,7 +31,11 @@ class SocketAddressPair;
 // interface can create as many addresses as you want.  All of the sockets
 // created by this network will be able to communicate with one another, unless
 // they are bound to addresses from incompatible families.
-class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
+// Packets that are due at the same time are delivered by a single message,
+// so a busy network doesn't post, and wake up the socket server, per packet.
+class VirtualSocketServer : public SocketServer,
+                            public MessageHandler,
+                            public sigslot::has_slots<> {
  public:
   // TODO: Add "owned" parameter.
   // If "owned" is set, the supplied socketserver will be deleted later.
@@ -101,6 +107,9 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
   bool Wait(int cms, bool process_io) override;
   void WakeUp() override;
 
+  // MessageHandler:
+  void OnMessage(Message* msg) override;
+
   typedef std::pair<double, double> Point;
   typedef std::vector<Point> Function;
 
@@ -177,6 +186,9 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
   // Removes stale packets from the network
   void PurgeNetworkPackets(VirtualSocket* socket, uint32_t cur_time);
 
+  // Drops the packets on their way to |socket|.
+  void CancelPackets(VirtualSocket* socket);
+
   // Computes the number of milliseconds required to send a packet of this size.
   uint32_t SendDelay(uint32_t size);
 
@@ -196,7 +208,7 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
   // NULL out our message queue if it goes away. Necessary in the case where
   // our lifetime is greater than that of the thread we are using, since we
   // try to send Close messages for all connected sockets when we shutdown.
-  void OnMessageQueueDestroyed() { msg_queue_ = NULL; }
+  void OnMessageQueueDestroyed();
 
   // Determine if two sockets should be able to communicate.
   // We don't (currently) specify an address family for sockets; instead,
@@ -219,8 +231,20 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
  private:
   friend class VirtualSocket;
 
-  typedef std::map<SocketAddress, VirtualSocket*> AddressMap;
-  typedef std::map<SocketAddressPair, VirtualSocket*> ConnectionMap;
+  struct AddressHash {
+    size_t operator()(const SocketAddress& addr) const;
+  };
+  struct AddressPairHash {
+    size_t operator()(const SocketAddressPair& pair) const;
+  };
+  struct PacketBatch;
+
+  typedef std::unordered_map<SocketAddress, VirtualSocket*, AddressHash>
+      AddressMap;
+  typedef std::unordered_map<SocketAddressPair, VirtualSocket*,
+                             AddressPairHash> ConnectionMap;
+  // Batches that are posted, by delivery time.
+  typedef std::unordered_map<uint32_t, PacketBatch*> PacketBatchMap;
 
   SocketServer* server_;
   bool server_owned_;
@@ -232,6 +256,12 @@ class VirtualSocketServer : public SocketServer, public sigslot::has_slots<> {
   uint16_t next_port_;
   AddressMap* bindings_;
   ConnectionMap* connections_;
+  // Packets can be sent from any thread.
+  CriticalSection batches_crit_;
+  PacketBatchMap pending_batches_ GUARDED_BY(batches_crit_);
+  // Batches being delivered; more than one if a socket's read handler
+  // processes messages.
+  std::vector<PacketBatch*> delivering_batches_ GUARDED_BY(batches_crit_);
 
   IPAddress default_route_v4_;
   IPAddress default_route_v6_;
@@ -305,6 +335,8 @@ class VirtualSocket : public AsyncSocket, public MessageHandler {
   void CompleteConnect(const SocketAddress& addr, bool notify);
   int SendUdp(const void* pv, size_t cb, const SocketAddress& addr);
   int SendTcp(const void* pv, size_t cb);
+  // Takes ownership of |packet|.
+  void OnPacket(Packet* packet);
 
   // Used by server sockets to set the local address without binding.
   void SetLocalAddress(const SocketAddress& addr);
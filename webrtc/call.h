@@ -24,6 +24,9 @@
 namespace webrtc {
 
 class AudioProcessing;
+class CpuBudgetCoordinator;
+class EncoderThreadPool;
+class PacerThreadPool;
 
 const char* Version();
 
@@ -87,6 +90,21 @@ class Call {
     // Audio Processing Module to be used in this call.
     // TODO(solenberg): Change this to a shared_ptr once we can use C++11.
     AudioProcessing* audio_processing = nullptr;
+
+    // If set, the pacer of this call runs on one of the threads of this pool,
+    // which may be shared by many calls, rather than on a thread of its own.
+    // Must outlive the call.
+    PacerThreadPool* pacer_thread_pool = nullptr;
+
+    // If set, captured frames of this call's video send streams are encoded
+    // on the threads of this pool, which may be shared by many calls, rather
+    // than on a thread per stream. Must outlive the call.
+    EncoderThreadPool* encoder_thread_pool = nullptr;
+
+    // If set, the video send streams of this call detect CPU overuse on the
+    // encode usage of all streams sharing this coordinator, which may span
+    // many calls, rather than each on its own. Must outlive the call.
+    CpuBudgetCoordinator* cpu_budget_coordinator = nullptr;
   };
 
   struct Stats {
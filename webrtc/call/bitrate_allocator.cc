@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <utility>
 
+#include "webrtc/base/checks.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 
 namespace webrtc {
@@ -26,6 +27,9 @@ const int kDefaultBitrateBps = 300000;
 BitrateAllocator::BitrateAllocator()
     : crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
       bitrate_observers_(),
+      sum_min_bitrates_(0),
+      sum_max_bitrates_(0),
+      next_insertion_order_(0),
       bitrate_observers_modified_(false),
       enforce_min_bitrate_(true),
       last_bitrate_bps_(kDefaultBitrateBps),
@@ -40,25 +44,23 @@ uint32_t BitrateAllocator::OnNetworkChanged(uint32_t bitrate,
   last_fraction_loss_ = fraction_loss;
   last_rtt_ = rtt;
   uint32_t allocated_bitrate_bps = 0;
-  ObserverBitrateMap allocation = AllocateBitrates();
-  for (const auto& kv : allocation) {
+  AllocateBitrates();
+  for (const auto& kv : allocation_) {
     kv.first->OnNetworkChanged(kv.second, last_fraction_loss_, last_rtt_);
     allocated_bitrate_bps += kv.second;
   }
   return allocated_bitrate_bps;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::AllocateBitrates() {
+void BitrateAllocator::AllocateBitrates() {
+  allocation_.clear();
   if (bitrate_observers_.empty())
-    return ObserverBitrateMap();
+    return;
 
-  uint32_t sum_min_bitrates = 0;
-  for (const auto& observer : bitrate_observers_)
-    sum_min_bitrates += observer.second.min_bitrate;
-  if (last_bitrate_bps_ <= sum_min_bitrates)
-    return LowRateAllocation(last_bitrate_bps_);
+  if (last_bitrate_bps_ <= sum_min_bitrates_)
+    LowRateAllocation(last_bitrate_bps_);
   else
-    return NormalRateAllocation(last_bitrate_bps_, sum_min_bitrates);
+    NormalRateAllocation(last_bitrate_bps_, sum_min_bitrates_);
 }
 
 int BitrateAllocator::AddBitrateObserver(BitrateObserver* observer,
@@ -66,28 +68,32 @@ int BitrateAllocator::AddBitrateObserver(BitrateObserver* observer,
                                          uint32_t max_bitrate_bps) {
   CriticalSectionScoped lock(crit_sect_.get());
 
-  BitrateObserverConfList::iterator it =
-      FindObserverConfigurationPair(observer);
+  ObserverIndexMap::iterator it = observer_index_.find(observer);
 
   // Allow the max bitrate to be exceeded for FEC and retransmissions.
   // TODO(holmer): We have to get rid of this hack as it makes it difficult to
   // properly allocate bitrate. The allocator should instead distribute any
   // extra bitrate after all streams have maxed out.
   max_bitrate_bps *= kTransmissionMaxBitrateMultiplier;
-  if (it != bitrate_observers_.end()) {
+  if (it != observer_index_.end()) {
     // Update current configuration.
-    it->second.min_bitrate = min_bitrate_bps;
-    it->second.max_bitrate = max_bitrate_bps;
+    BitrateConfiguration* configuration = &*it->second;
+    RemoveFromSortingAndSums(configuration);
+    configuration->min_bitrate = min_bitrate_bps;
+    configuration->max_bitrate = max_bitrate_bps;
+    AddToSortingAndSums(configuration);
   } else {
     // Add new settings.
-    bitrate_observers_.push_back(BitrateObserverConfiguration(
-        observer, BitrateConfiguration(min_bitrate_bps, max_bitrate_bps)));
+    bitrate_observers_.push_back(BitrateConfiguration(
+        observer, min_bitrate_bps, max_bitrate_bps, next_insertion_order_++));
+    observer_index_[observer] = --bitrate_observers_.end();
+    AddToSortingAndSums(&bitrate_observers_.back());
     bitrate_observers_modified_ = true;
   }
 
-  ObserverBitrateMap allocation = AllocateBitrates();
+  AllocateBitrates();
   int new_observer_bitrate_bps = 0;
-  for (auto& kv : allocation) {
+  for (auto& kv : allocation_) {
     kv.first->OnNetworkChanged(kv.second, last_fraction_loss_, last_rtt_);
     if (kv.first == observer)
       new_observer_bitrate_bps = kv.second;
@@ -97,35 +103,39 @@ int BitrateAllocator::AddBitrateObserver(BitrateObserver* observer,
 
 void BitrateAllocator::RemoveBitrateObserver(BitrateObserver* observer) {
   CriticalSectionScoped lock(crit_sect_.get());
-  BitrateObserverConfList::iterator it =
-      FindObserverConfigurationPair(observer);
-  if (it != bitrate_observers_.end()) {
-    bitrate_observers_.erase(it);
+  ObserverIndexMap::iterator it = observer_index_.find(observer);
+  if (it != observer_index_.end()) {
+    RemoveFromSortingAndSums(&*it->second);
+    bitrate_observers_.erase(it->second);
+    observer_index_.erase(it);
     bitrate_observers_modified_ = true;
   }
 }
 
 void BitrateAllocator::GetMinMaxBitrateSumBps(int* min_bitrate_sum_bps,
                                               int* max_bitrate_sum_bps) const {
-  *min_bitrate_sum_bps = 0;
-  *max_bitrate_sum_bps = 0;
-
   CriticalSectionScoped lock(crit_sect_.get());
-  for (const auto& observer : bitrate_observers_) {
-    *min_bitrate_sum_bps += observer.second.min_bitrate;
-    *max_bitrate_sum_bps += observer.second.max_bitrate;
-  }
+  *min_bitrate_sum_bps = static_cast<int>(sum_min_bitrates_);
+  *max_bitrate_sum_bps = static_cast<int>(sum_max_bitrates_);
 }
 
-BitrateAllocator::BitrateObserverConfList::iterator
-BitrateAllocator::FindObserverConfigurationPair(
-    const BitrateObserver* observer) {
-  for (auto it = bitrate_observers_.begin(); it != bitrate_observers_.end();
-       ++it) {
-    if (it->first == observer)
-      return it;
-  }
-  return bitrate_observers_.end();
+void BitrateAllocator::AddToSortingAndSums(
+    const BitrateConfiguration* configuration) {
+  bool inserted = observers_by_max_bitrate_
+                      .insert(std::make_pair(configuration->sorting_key(),
+                                             configuration))
+                      .second;
+  RTC_DCHECK(inserted);
+  sum_min_bitrates_ += configuration->min_bitrate;
+  sum_max_bitrates_ += configuration->max_bitrate;
+}
+
+void BitrateAllocator::RemoveFromSortingAndSums(
+    const BitrateConfiguration* configuration) {
+  size_t erased = observers_by_max_bitrate_.erase(configuration->sorting_key());
+  RTC_DCHECK_EQ(1u, erased);
+  sum_min_bitrates_ -= configuration->min_bitrate;
+  sum_max_bitrates_ -= configuration->max_bitrate;
 }
 
 void BitrateAllocator::EnforceMinBitrate(bool enforce_min_bitrate) {
@@ -133,62 +143,52 @@ void BitrateAllocator::EnforceMinBitrate(bool enforce_min_bitrate) {
   enforce_min_bitrate_ = enforce_min_bitrate;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::NormalRateAllocation(
-    uint32_t bitrate,
-    uint32_t sum_min_bitrates) {
+void BitrateAllocator::NormalRateAllocation(uint32_t bitrate,
+                                            uint32_t sum_min_bitrates) {
   uint32_t number_of_observers =
       static_cast<uint32_t>(bitrate_observers_.size());
   uint32_t bitrate_per_observer =
       (bitrate - sum_min_bitrates) / number_of_observers;
-  // Use map to sort list based on max bitrate.
-  ObserverSortingMap list_max_bitrates;
-  for (const auto& observer : bitrate_observers_) {
-    list_max_bitrates.insert(std::pair<uint32_t, ObserverConfiguration>(
-        observer.second.max_bitrate,
-        ObserverConfiguration(observer.first, observer.second.min_bitrate)));
-  }
-  ObserverBitrateMap allocation;
-  ObserverSortingMap::iterator max_it = list_max_bitrates.begin();
-  while (max_it != list_max_bitrates.end()) {
+  // Observers with lower max bitrates go first, so that what they can't use
+  // is carried forward to the ones that can.
+  for (const auto& kv : observers_by_max_bitrate_) {
+    const BitrateConfiguration* configuration = kv.second;
     number_of_observers--;
     uint32_t observer_allowance =
-        max_it->second.min_bitrate + bitrate_per_observer;
-    if (max_it->first < observer_allowance) {
+        configuration->min_bitrate + bitrate_per_observer;
+    if (configuration->max_bitrate < observer_allowance) {
       // We have more than enough for this observer.
       // Carry the remainder forward.
-      uint32_t remainder = observer_allowance - max_it->first;
+      uint32_t remainder = observer_allowance - configuration->max_bitrate;
       if (number_of_observers != 0) {
         bitrate_per_observer += remainder / number_of_observers;
       }
-      allocation[max_it->second.observer] = max_it->first;
+      allocation_.push_back(std::make_pair(configuration->observer,
+                                           configuration->max_bitrate));
     } else {
-      allocation[max_it->second.observer] = observer_allowance;
+      allocation_.push_back(
+          std::make_pair(configuration->observer, observer_allowance));
     }
-    list_max_bitrates.erase(max_it);
-    // Prepare next iteration.
-    max_it = list_max_bitrates.begin();
   }
-  return allocation;
 }
 
-BitrateAllocator::ObserverBitrateMap BitrateAllocator::LowRateAllocation(
-    uint32_t bitrate) {
-  ObserverBitrateMap allocation;
+void BitrateAllocator::LowRateAllocation(uint32_t bitrate) {
   if (enforce_min_bitrate_) {
     // Min bitrate to all observers.
-    for (const auto& observer : bitrate_observers_)
-      allocation[observer.first] = observer.second.min_bitrate;
+    for (const auto& observer : bitrate_observers_) {
+      allocation_.push_back(
+          std::make_pair(observer.observer, observer.min_bitrate));
+    }
   } else {
     // Allocate up to |min_bitrate| to one observer at a time, until
     // |bitrate| is depleted.
     uint32_t remainder = bitrate;
     for (const auto& observer : bitrate_observers_) {
-      uint32_t allocated_bitrate =
-          std::min(remainder, observer.second.min_bitrate);
-      allocation[observer.first] = allocated_bitrate;
+      uint32_t allocated_bitrate = std::min(remainder, observer.min_bitrate);
+      allocation_.push_back(
+          std::make_pair(observer.observer, allocated_bitrate));
       remainder -= allocated_bitrate;
     }
   }
-  return allocation;
 }
 }  // namespace webrtc
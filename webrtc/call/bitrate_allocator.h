@@ -18,6 +18,7 @@
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
@@ -61,37 +62,57 @@ class BitrateAllocator {
   void EnforceMinBitrate(bool enforce_min_bitrate);
 
  private:
+  // Observers are sorted by max bitrate, and in insertion order among equal
+  // max bitrates.
+  typedef std::pair<uint32_t, uint64_t> SortingKey;
   struct BitrateConfiguration {
-    BitrateConfiguration(uint32_t min_bitrate, uint32_t max_bitrate)
-        : min_bitrate(min_bitrate), max_bitrate(max_bitrate) {}
-    uint32_t min_bitrate;
-    uint32_t max_bitrate;
-  };
-  struct ObserverConfiguration {
-    ObserverConfiguration(BitrateObserver* observer, uint32_t bitrate)
-        : observer(observer), min_bitrate(bitrate) {}
+    BitrateConfiguration(BitrateObserver* observer,
+                         uint32_t min_bitrate,
+                         uint32_t max_bitrate,
+                         uint64_t insertion_order)
+        : observer(observer),
+          min_bitrate(min_bitrate),
+          max_bitrate(max_bitrate),
+          insertion_order(insertion_order) {}
+    SortingKey sorting_key() const {
+      return SortingKey(max_bitrate, insertion_order);
+    }
     BitrateObserver* const observer;
     uint32_t min_bitrate;
+    uint32_t max_bitrate;
+    const uint64_t insertion_order;
   };
-  typedef std::pair<BitrateObserver*, BitrateConfiguration>
-      BitrateObserverConfiguration;
-  typedef std::list<BitrateObserverConfiguration> BitrateObserverConfList;
-  typedef std::multimap<uint32_t, ObserverConfiguration> ObserverSortingMap;
-  typedef std::map<BitrateObserver*, int> ObserverBitrateMap;
+  typedef std::list<BitrateConfiguration> BitrateObserverConfList;
+  typedef std::map<const BitrateObserver*, BitrateObserverConfList::iterator>
+      ObserverIndexMap;
+  typedef std::map<SortingKey, const BitrateConfiguration*> ObserverSortingMap;
+  typedef std::vector<std::pair<BitrateObserver*, int>> ObserverAllocation;
 
-  BitrateObserverConfList::iterator FindObserverConfigurationPair(
-      const BitrateObserver* observer) EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
-  ObserverBitrateMap AllocateBitrates() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
-  ObserverBitrateMap NormalRateAllocation(uint32_t bitrate,
-                                          uint32_t sum_min_bitrates)
+  // Adds |configuration| to, or removes it from, the sorting and the sums.
+  void AddToSortingAndSums(const BitrateConfiguration* configuration)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
-
-  ObserverBitrateMap LowRateAllocation(uint32_t bitrate)
+  void RemoveFromSortingAndSums(const BitrateConfiguration* configuration)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  // Computes the allocation of |last_bitrate_bps_| into |allocation_|.
+  void AllocateBitrates() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  void NormalRateAllocation(uint32_t bitrate, uint32_t sum_min_bitrates)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  void LowRateAllocation(uint32_t bitrate)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
   rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
-  // Stored in a list to keep track of the insertion order.
+  // Stored in a list to keep track of the insertion order. The observers are
+  // also indexed by observer and sorted by max bitrate, and their min and max
+  // bitrates summed, as they are added and removed, so that neither is
+  // redone for every allocation.
   BitrateObserverConfList bitrate_observers_ GUARDED_BY(crit_sect_);
+  ObserverIndexMap observer_index_ GUARDED_BY(crit_sect_);
+  ObserverSortingMap observers_by_max_bitrate_ GUARDED_BY(crit_sect_);
+  uint32_t sum_min_bitrates_ GUARDED_BY(crit_sect_);
+  uint32_t sum_max_bitrates_ GUARDED_BY(crit_sect_);
+  uint64_t next_insertion_order_ GUARDED_BY(crit_sect_);
+  // The result of the last allocation, kept to reuse its storage.
+  ObserverAllocation allocation_ GUARDED_BY(crit_sect_);
   bool bitrate_observers_modified_ GUARDED_BY(crit_sect_);
   bool enforce_min_bitrate_ GUARDED_BY(crit_sect_);
   uint32_t last_bitrate_bps_ GUARDED_BY(crit_sect_);
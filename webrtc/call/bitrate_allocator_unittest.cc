@@ -100,6 +100,37 @@ TEST_F(BitrateAllocatorTest, TwoBitrateObserversOneRtcpObserver) {
   EXPECT_EQ(600000u, bitrate_observer_2.last_bitrate_);
 }
 
+TEST_F(BitrateAllocatorTest, KeepsMinMaxSumsAsObserversChange) {
+  TestBitrateObserver bitrate_observer_1;
+  TestBitrateObserver bitrate_observer_2;
+  int min_sum = 0;
+  int max_sum = 0;
+  allocator_->AddBitrateObserver(&bitrate_observer_1, 100000, 300000);
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 200000, 400000);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum, &max_sum);
+  EXPECT_EQ(300000, min_sum);
+  EXPECT_EQ(2 * 700000, max_sum);
+
+  // Lowering the max bitrate of the second observer below that of the first
+  // one makes it the first to be capped.
+  allocator_->AddBitrateObserver(&bitrate_observer_2, 200000, 100000);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum, &max_sum);
+  EXPECT_EQ(300000, min_sum);
+  EXPECT_EQ(2 * 400000, max_sum);
+  allocator_->OnNetworkChanged(700000, 0, 0);
+  EXPECT_EQ(200000u, bitrate_observer_2.last_bitrate_);
+  EXPECT_EQ(500000u, bitrate_observer_1.last_bitrate_);
+
+  allocator_->RemoveBitrateObserver(&bitrate_observer_1);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum, &max_sum);
+  EXPECT_EQ(200000, min_sum);
+  EXPECT_EQ(2 * 100000, max_sum);
+  allocator_->RemoveBitrateObserver(&bitrate_observer_2);
+  allocator_->GetMinMaxBitrateSumBps(&min_sum, &max_sum);
+  EXPECT_EQ(0, min_sum);
+  EXPECT_EQ(0, max_sum);
+}
+
 class BitrateAllocatorTestNoEnforceMin : public ::testing::Test {
  protected:
   BitrateAllocatorTestNoEnforceMin() : allocator_(new BitrateAllocator()) {
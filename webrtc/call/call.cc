@@ -27,6 +27,7 @@
 #include "webrtc/call/bitrate_allocator.h"
 #include "webrtc/call/congestion_controller.h"
 #include "webrtc/call/rtc_event_log.h"
+#include "webrtc/call/ssrc_table.h"
 #include "webrtc/common.h"
 #include "webrtc/config.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
@@ -104,6 +105,7 @@ class Call : public webrtc::Call, public PacketReceiver,
 
   void ConfigureSync(const std::string& sync_group)
       EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
+  void UpdateRtpDemuxTable() EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
 
   VoiceEngine* voice_engine() {
     internal::AudioState* audio_state =
@@ -138,6 +140,12 @@ class Call : public webrtc::Call, public PacketReceiver,
       GUARDED_BY(receive_crit_);
   std::map<std::string, AudioReceiveStream*> sync_stream_mapping_
       GUARDED_BY(receive_crit_);
+  // Receive streams of each SSRC, as in the maps above, for DeliverRtp().
+  struct RtpReceivers {
+    AudioReceiveStream* audio = nullptr;
+    VideoReceiveStream* video = nullptr;
+  };
+  SsrcTable<RtpReceivers> rtp_demux_table_ GUARDED_BY(receive_crit_);
 
   rtc::scoped_ptr<RWLockWrapper> send_crit_;
   // Audio and Video send streams are owned by the client that creates them.
@@ -200,7 +208,8 @@ Call::Call(const Call::Config& config)
       congestion_controller_(
           new CongestionController(module_process_thread_.get(),
                                    call_stats_.get(),
-                                   this)) {
+                                   this,
+                                   config.pacer_thread_pool)) {
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   RTC_DCHECK_GE(config.bitrate_config.min_bitrate_bps, 0);
   RTC_DCHECK_GE(config.bitrate_config.start_bitrate_bps,
@@ -342,6 +351,7 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
     RTC_DCHECK(audio_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
                audio_receive_ssrcs_.end());
     audio_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+    UpdateRtpDemuxTable();
     ConfigureSync(config.sync_group);
   }
   return receive_stream;
@@ -359,6 +369,7 @@ void Call::DestroyAudioReceiveStream(
     size_t num_deleted = audio_receive_ssrcs_.erase(
         audio_receive_stream->config().rtp.remote_ssrc);
     RTC_DCHECK(num_deleted == 1);
+    UpdateRtpDemuxTable();
     const std::string& sync_group = audio_receive_stream->config().sync_group;
     const auto it = sync_stream_mapping_.find(sync_group);
     if (it != sync_stream_mapping_.end() &&
@@ -381,7 +392,8 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   VideoSendStream* send_stream = new VideoSendStream(
       num_cpu_cores_, module_process_thread_.get(), call_stats_.get(),
       congestion_controller_.get(), bitrate_allocator_.get(), config,
-      encoder_config, suspended_video_send_ssrcs_);
+      encoder_config, suspended_video_send_ssrcs_,
+      config_.encoder_thread_pool, config_.cpu_budget_coordinator);
 
   if (!network_enabled_)
     send_stream->SignalNetworkState(kNetworkDown);
@@ -451,6 +463,7 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   if (it != config.rtp.rtx.end())
     video_receive_ssrcs_[it->second.ssrc] = receive_stream;
   video_receive_streams_.insert(receive_stream);
+  UpdateRtpDemuxTable();
 
   ConfigureSync(config.sync_group);
 
@@ -485,6 +498,7 @@ void Call::DestroyVideoReceiveStream(
       }
     }
     video_receive_streams_.erase(receive_stream_impl);
+    UpdateRtpDemuxTable();
     RTC_CHECK(receive_stream_impl != nullptr);
     ConfigureSync(receive_stream_impl->config().sync_group);
   }
@@ -651,6 +665,14 @@ void Call::ConfigureSync(const std::string& sync_group) {
   }
 }
 
+void Call::UpdateRtpDemuxTable() {
+  rtp_demux_table_.Clear();
+  for (const auto& kv : audio_receive_ssrcs_)
+    rtp_demux_table_.FindOrInsert(kv.first)->audio = kv.second;
+  for (const auto& kv : video_receive_ssrcs_)
+    rtp_demux_table_.FindOrInsert(kv.first)->video = kv.second;
+}
+
 PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
                                                  const uint8_t* packet,
                                                  size_t length) {
@@ -699,11 +721,13 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
 
   uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
   ReadLockScoped read_lock(*receive_crit_);
+  const RtpReceivers* receivers = rtp_demux_table_.Find(ssrc);
+  if (!receivers)
+    return DELIVERY_UNKNOWN_SSRC;
   if (media_type == MediaType::ANY || media_type == MediaType::AUDIO) {
-    auto it = audio_receive_ssrcs_.find(ssrc);
-    if (it != audio_receive_ssrcs_.end()) {
+    if (receivers->audio) {
       received_audio_bytes_ += length;
-      auto status = it->second->DeliverRtp(packet, length, packet_time)
+      auto status = receivers->audio->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
       if (status == DELIVERY_OK && event_log_)
@@ -712,10 +736,9 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    auto it = video_receive_ssrcs_.find(ssrc);
-    if (it != video_receive_ssrcs_.end()) {
+    if (receivers->video) {
       received_video_bytes_ += length;
-      auto status = it->second->DeliverRtp(packet, length, packet_time)
+      auto status = receivers->video->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
       if (status == DELIVERY_OK && event_log_)
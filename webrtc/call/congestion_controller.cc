@@ -16,6 +16,7 @@
 #include "webrtc/common.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
 #include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/pacing/pacer_thread_pool.h"
 #include "webrtc/modules/pacing/packet_router.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
@@ -147,6 +148,15 @@ class WrappingBitrateEstimator : public RemoteBitrateEstimator {
 CongestionController::CongestionController(ProcessThread* process_thread,
                                            CallStats* call_stats,
                                            BitrateObserver* bitrate_observer)
+    : CongestionController(process_thread,
+                           call_stats,
+                           bitrate_observer,
+                           nullptr) {}
+
+CongestionController::CongestionController(ProcessThread* process_thread,
+                                           CallStats* call_stats,
+                                           BitrateObserver* bitrate_observer,
+                                           PacerThreadPool* pacer_thread_pool)
     : remb_(new VieRemb(Clock::GetRealTimeClock())),
       packet_router_(new PacketRouter()),
       pacer_(new PacedSender(Clock::GetRealTimeClock(),
@@ -162,7 +172,7 @@ CongestionController::CongestionController(ProcessThread* process_thread,
                                    packet_router_.get())),
       process_thread_(process_thread),
       call_stats_(call_stats),
-      pacer_thread_(ProcessThread::Create("PacerThread")),
+      pacer_thread_pool_(pacer_thread_pool),
       // Constructed last as this object calls the provided callback on
       // construction.
       bitrate_controller_(
@@ -171,8 +181,13 @@ CongestionController::CongestionController(ProcessThread* process_thread,
       min_bitrate_bps_(RemoteBitrateEstimator::kDefaultMinBitrateBps) {
   call_stats_->RegisterStatsObserver(remote_bitrate_estimator_.get());
 
-  pacer_thread_->RegisterModule(pacer_.get());
-  pacer_thread_->Start();
+  if (pacer_thread_pool_) {
+    pacer_thread_pool_->AddPacer(pacer_.get());
+  } else {
+    pacer_thread_ = ProcessThread::Create("PacerThread");
+    pacer_thread_->RegisterModule(pacer_.get());
+    pacer_thread_->Start();
+  }
 
   process_thread->RegisterModule(remote_estimator_proxy_.get());
   process_thread->RegisterModule(remote_bitrate_estimator_.get());
@@ -180,8 +195,12 @@ CongestionController::CongestionController(ProcessThread* process_thread,
 }
 
 CongestionController::~CongestionController() {
-  pacer_thread_->Stop();
-  pacer_thread_->DeRegisterModule(pacer_.get());
+  if (pacer_thread_pool_) {
+    pacer_thread_pool_->RemovePacer(pacer_.get());
+  } else {
+    pacer_thread_->Stop();
+    pacer_thread_->DeRegisterModule(pacer_.get());
+  }
   process_thread_->DeRegisterModule(bitrate_controller_.get());
   process_thread_->DeRegisterModule(remote_bitrate_estimator_.get());
   process_thread_->DeRegisterModule(remote_estimator_proxy_.get());
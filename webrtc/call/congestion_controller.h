@@ -25,6 +25,7 @@ class BitrateObserver;
 class CallStats;
 class Config;
 class PacedSender;
+class PacerThreadPool;
 class PacketRouter;
 class ProcessThread;
 class RemoteBitrateEstimator;
@@ -40,6 +41,12 @@ class CongestionController {
  public:
   CongestionController(ProcessThread* process_thread, CallStats* call_stats,
                        BitrateObserver* bitrate_observer);
+  // Runs the pacer on |pacer_thread_pool| rather than on a thread of its own,
+  // unless it is null.
+  CongestionController(ProcessThread* process_thread,
+                       CallStats* call_stats,
+                       BitrateObserver* bitrate_observer,
+                       PacerThreadPool* pacer_thread_pool);
   virtual ~CongestionController();
   virtual void AddEncoder(ViEEncoder* encoder);
   virtual void RemoveEncoder(ViEEncoder* encoder);
@@ -81,6 +88,9 @@ class CongestionController {
   ProcessThread* const process_thread_;
   CallStats* const call_stats_;
 
+  // Either the pacer runs on |pacer_thread_pool_|, which is assumed to outlive
+  // this class, or on |pacer_thread_|.
+  PacerThreadPool* const pacer_thread_pool_;
   rtc::scoped_ptr<ProcessThread> pacer_thread_;
 
   rtc::scoped_ptr<BitrateController> bitrate_controller_;
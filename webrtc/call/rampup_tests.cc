@@ -10,11 +10,21 @@
 
 #include "webrtc/call/rampup_tests.h"
 
+#include <algorithm>
+
+#include "gflags/gflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/platform_thread.h"
 #include "webrtc/test/testsupport/perf_test.h"
 
+DEFINE_string(link_trace, "",
+              "Mahimahi link trace to replay in RampUpTest.LinkTraceFromFlag, "
+              "e.g. recorded on a cellular network.");
+DEFINE_int32(link_trace_delay_ms, 50,
+             "One-way delay to add to the trace in --link_trace.");
+
 namespace webrtc {
 namespace {
 
@@ -429,6 +439,71 @@ void RampUpDownUpTester::EvolveTestState(int bitrate_bps, bool suspended) {
   }
 }
 
+RampUpLinkTraceTester::RampUpLinkTraceTester(
+    const std::string& trace_name,
+    const FakeNetworkPipe::LinkTrace& trace)
+    : RampUpTester(1, 0, 0, RtpExtension::kTransportSequenceNumber, true,
+                   false),
+      trace_name_(trace_name),
+      ramped_up_bitrate_bps_(std::min<int>(kSingleStreamTargetBps,
+                                           800 * trace.AverageCapacityKbps())),
+      start_ms_(clock_->TimeInMilliseconds()),
+      ramp_up_time_ms_(-1),
+      bitrate_sum_bps_(0),
+      target_bitrate_sum_bps_(0),
+      num_samples_(0),
+      done_(false) {
+  forward_transport_config_.link_trace = trace;
+}
+
+RampUpLinkTraceTester::~RampUpLinkTraceTester() {}
+
+bool RampUpLinkTraceTester::PollStats() {
+  if (send_stream_ && !done_) {
+    int64_t now_ms = clock_->TimeInMilliseconds();
+    VideoSendStream::Stats stats = send_stream_->GetStats();
+    int bitrate_bps = 0;
+    for (const auto& it : stats.substreams)
+      bitrate_bps += it.second.total_bitrate_bps;
+    bitrate_sum_bps_ += bitrate_bps;
+    target_bitrate_sum_bps_ += stats.target_media_bitrate_bps;
+    ++num_samples_;
+
+    if (ramp_up_time_ms_ < 0 &&
+        stats.target_media_bitrate_bps >= ramped_up_bitrate_bps_) {
+      ramp_up_time_ms_ = now_ms - start_ms_;
+    }
+    if (now_ms - start_ms_ >= kTestDurationMs) {
+      ReportTraceResults(now_ms);
+      done_ = true;
+      observation_complete_.Set();
+    }
+  }
+
+  return !event_.Wait(kPollIntervalMs);
+}
+
+void RampUpLinkTraceTester::ReportTraceResults(int64_t now_ms) {
+  const std::string modifier = "_" + trace_name_;
+  // A trace that never ramps up reports the whole test duration.
+  webrtc::test::PrintResult(
+      "ramp_up_link_trace", modifier, "ramp_up_time",
+      ramp_up_time_ms_ >= 0 ? ramp_up_time_ms_ : now_ms - start_ms_, "ms",
+      false);
+  webrtc::test::PrintResult("ramp_up_link_trace", modifier,
+                            "average_network_latency",
+                            send_transport_->GetAverageDelayMs(), "ms", false);
+  if (num_samples_ > 0) {
+    webrtc::test::PrintResult("ramp_up_link_trace", modifier,
+                              "average_send_bitrate",
+                              bitrate_sum_bps_ / num_samples_, "bps", false);
+    webrtc::test::PrintResult("ramp_up_link_trace", modifier,
+                              "average_target_bitrate",
+                              target_bitrate_sum_bps_ / num_samples_, "bps",
+                              false);
+  }
+}
+
 class RampUpTest : public test::CallTest {
  public:
   RampUpTest() {}
@@ -584,4 +659,71 @@ TEST_F(RampUpTest, TransportSequenceNumberSingleStreamWithHighStartBitrate) {
                     RtpExtension::kTransportSequenceNumber, false, false);
   RunBaseTest(&test);
 }
+
+namespace {
+typedef FakeNetworkPipe::LinkTrace::Entry TraceEntry;
+
+// Capacity changing every 500 ms, as on a cellular link with fading.
+FakeNetworkPipe::LinkTrace FluctuatingTrace() {
+  const int kCapacitiesKbps[] = {1500, 800, 2000, 600, 1200, 1800, 900, 1400};
+  FakeNetworkPipe::LinkTrace trace;
+  for (size_t i = 0; i < arraysize(kCapacitiesKbps); ++i)
+    trace.entries.push_back(TraceEntry(i * 500, kCapacitiesKbps[i], 40, 1));
+  trace.duration_ms = arraysize(kCapacitiesKbps) * 500;
+  return trace;
+}
+
+// A good link that goes down for a second every ten seconds, as at a
+// handover.
+FakeNetworkPipe::LinkTrace OutageTrace() {
+  FakeNetworkPipe::LinkTrace trace;
+  trace.entries.push_back(TraceEntry(0, 2000, 30, 0));
+  trace.entries.push_back(TraceEntry(9000, 0, 30, 0));
+  trace.duration_ms = 10000;
+  return trace;
+}
+
+// A slow, lossy link with a long delay.
+FakeNetworkPipe::LinkTrace LossyHighDelayTrace() {
+  FakeNetworkPipe::LinkTrace trace;
+  trace.entries.push_back(TraceEntry(0, 700, 150, 3));
+  trace.entries.push_back(TraceEntry(5000, 500, 200, 5));
+  trace.duration_ms = 10000;
+  return trace;
+}
+}  // namespace
+
+TEST_F(RampUpTest, FluctuatingLinkTrace) {
+  RampUpLinkTraceTester test("fluctuating", FluctuatingTrace());
+  RunBaseTest(&test);
+}
+
+TEST_F(RampUpTest, OutageLinkTrace) {
+  RampUpLinkTraceTester test("outage", OutageTrace());
+  RunBaseTest(&test);
+}
+
+TEST_F(RampUpTest, LossyHighDelayLinkTrace) {
+  RampUpLinkTraceTester test("lossy_high_delay", LossyHighDelayTrace());
+  RunBaseTest(&test);
+}
+
+// Replays the trace given with --link_trace. Run once per trace to replay a
+// corpus of recorded traces.
+TEST_F(RampUpTest, LinkTraceFromFlag) {
+  const int64_t kTraceIntervalMs = 100;
+  const std::string path = FLAGS_link_trace;
+  if (path.empty())
+    return;
+  FakeNetworkPipe::LinkTrace trace;
+  ASSERT_TRUE(FakeNetworkPipe::LinkTrace::ReadFromMahimahiFile(
+      path, kTraceIntervalMs, &trace))
+      << "Failed to read " << path;
+  for (TraceEntry& entry : trace.entries)
+    entry.queue_delay_ms = FLAGS_link_trace_delay_ms;
+  // The file name, without directories, names the results.
+  RampUpLinkTraceTester test(path.substr(path.find_last_of("/\\") + 1),
+                             trace);
+  RunBaseTest(&test);
+}
 }  // namespace webrtc
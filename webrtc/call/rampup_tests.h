@@ -133,5 +133,32 @@ class RampUpDownUpTester : public RampUpTester {
   int64_t interval_start_ms_;
   int sent_bytes_;
 };
+
+// Replays a link trace on the forward link for a fixed time, and reports how
+// long the ramp-up took, the latency and the bitrate.
+class RampUpLinkTraceTester : public RampUpTester {
+ public:
+  RampUpLinkTraceTester(const std::string& trace_name,
+                        const FakeNetworkPipe::LinkTrace& trace);
+  ~RampUpLinkTraceTester() override;
+
+ protected:
+  bool PollStats() override;
+
+ private:
+  static const int64_t kTestDurationMs = 30000;
+
+  void ReportTraceResults(int64_t now_ms);
+
+  const std::string trace_name_;
+  // The rate that counts as ramped up, a bit below the average capacity.
+  const int ramped_up_bitrate_bps_;
+  const int64_t start_ms_;
+  int64_t ramp_up_time_ms_;
+  int64_t bitrate_sum_bps_;
+  int64_t target_bitrate_sum_bps_;
+  int num_samples_;
+  bool done_;
+};
 }  // namespace webrtc
 #endif  // WEBRTC_CALL_RAMPUP_TESTS_H_
@@ -10,11 +10,18 @@
 
 #include "webrtc/call/rtc_event_log.h"
 
-#include <deque>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
 #include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/call.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -63,9 +70,119 @@ class RtcEventLogImpl final : public RtcEventLog {
 
 #else  // ENABLE_RTC_EVENT_LOG is defined
 
+namespace {
+
+// Events are kept in a preallocated ring of binary records, so that logging a
+// packet neither allocates nor builds a protobuf. The writer thread turns the
+// records into protobufs and writes them to the file.
+enum class RecordType : uint8_t {
+  kRtp,
+  kRtcp,
+  kAudioPlayout,
+  kBwePacketLoss,
+  // A serialized rtclog::EventStream holding one configuration event.
+  kConfig,
+};
+
+struct RecordHeader {
+  int64_t timestamp_us;
+  // The packet length, the SSRC or the bitrate, depending on |type|.
+  uint32_t value;
+  int32_t total_packets;
+  // Number of bytes following the header.
+  uint32_t data_length;
+  RecordType type;
+  bool incoming;
+  MediaType media_type;
+  uint8_t fraction_loss;
+};
+
+// A byte ring holding RecordHeaders, each followed by its data. Records may
+// wrap around the end of the storage.
+class RecordBuffer {
+ public:
+  explicit RecordBuffer(size_t capacity)
+      : storage_(new uint8_t[capacity]),
+        capacity_(capacity),
+        begin_(0),
+        size_(0) {}
+
+  bool empty() const { return size_ == 0; }
+  size_t available() const { return capacity_ - size_; }
+
+  // Appends a record; returns false if there isn't room.
+  bool Append(const RecordHeader& header, const uint8_t* data) {
+    if (sizeof(header) + header.data_length > available())
+      return false;
+    Write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    Write(data, header.data_length);
+    return true;
+  }
+
+  // Copies the oldest record's header into |header|.
+  void PeekHeader(RecordHeader* header) const {
+    RTC_DCHECK(!empty());
+    Read(0, reinterpret_cast<uint8_t*>(header), sizeof(*header));
+  }
+
+  // Removes the oldest record, appending its data to |data| unless it is null.
+  void Pop(std::string* data) {
+    RecordHeader header;
+    PeekHeader(&header);
+    if (data) {
+      size_t old_size = data->size();
+      data->resize(old_size + header.data_length);
+      Read(sizeof(header),
+           reinterpret_cast<uint8_t*>(&(*data)[old_size]), header.data_length);
+    }
+    size_t record_size = sizeof(header) + header.data_length;
+    begin_ = (begin_ + record_size) % capacity_;
+    size_ -= record_size;
+  }
+
+  // Moves all records, in their binary form, to the end of |out|.
+  void PopAll(std::string* out) {
+    size_t old_size = out->size();
+    out->resize(old_size + size_);
+    Read(0, reinterpret_cast<uint8_t*>(&(*out)[old_size]), size_);
+    begin_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  void Write(const uint8_t* data, size_t length) {
+    size_t end = (begin_ + size_) % capacity_;
+    size_t first = std::min(length, capacity_ - end);
+    memcpy(&storage_[end], data, first);
+    memcpy(&storage_[0], data + first, length - first);
+    size_ += length;
+  }
+
+  void Read(size_t offset, uint8_t* data, size_t length) const {
+    size_t start = (begin_ + offset) % capacity_;
+    size_t first = std::min(length, capacity_ - start);
+    memcpy(data, &storage_[start], first);
+    memcpy(data + first, &storage_[0], length - first);
+  }
+
+  const rtc::scoped_ptr<uint8_t[]> storage_;
+  const size_t capacity_;
+  size_t begin_;
+  size_t size_;
+};
+
+// Enough for the default 10 s of buffered events at typical packet rates.
+const size_t kRecordBufferSize = 1 << 20;
+// How long logged events may wait before the writer thread writes them,
+// unless the buffer fills up first.
+const int kWriteIntervalMs = 100;
+
+}  // namespace
+
 class RtcEventLogImpl final : public RtcEventLog {
  public:
   RtcEventLogImpl();
+  ~RtcEventLogImpl() override;
 
   void SetBufferDuration(int64_t buffer_duration_us) override;
   void StartLogging(const std::string& file_name, int duration_ms) override;
@@ -88,37 +205,61 @@ class RtcEventLogImpl final : public RtcEventLog {
                              int32_t total_packets) override;
 
  private:
+  static bool WriterThread(void* obj);
+  bool Process();
+
   // Starts logging. This function assumes the file_ has been opened succesfully
   // and that the start_time_us_ and _duration_us_ have been set.
-  void StartLoggingLocked() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void StartLoggingLocked() EXCLUSIVE_LOCKS_REQUIRED(file_crit_, crit_);
   // Stops logging and clears the stored data and buffers.
-  void StopLoggingLocked() EXCLUSIVE_LOCKS_REQUIRED(crit_);
-  // Adds a new event to the logfile if logging is active, or adds it to the
-  // list of recent log events otherwise.
-  void HandleEvent(rtclog::Event* event) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void StopLoggingLocked() EXCLUSIVE_LOCKS_REQUIRED(file_crit_);
+  // Stops logging if the logging duration has passed.
+  void StopLoggingIfExpired();
+  // Adds an event to the record buffer, dropping buffered events that have
+  // become too old when not logging.
+  void AddRecord(const RecordHeader& header, const uint8_t* data);
+  // Serializes a configuration event and adds it to the record buffer.
+  void AddConfigEvent(rtclog::Event* event);
+  // Removes the oldest record, keeping it aside if it is a configuration
+  // event.
+  void DropOldestRecord() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Writes all buffered records to the file, if logging.
+  void WriteRecords() EXCLUSIVE_LOCKS_REQUIRED(file_crit_);
+  // Encodes the records in |write_buffer_| and writes them to the file.
+  void WriteRecordBuffer() EXCLUSIVE_LOCKS_REQUIRED(file_crit_);
   // Writes the event to the file. Note that this will destroy the state of the
   // input argument.
-  void StoreToFile(rtclog::Event* event) EXCLUSIVE_LOCKS_REQUIRED(crit_);
-  // Adds the event to the list of recent events, and removes any events that
-  // are too old and no longer fall in the time window.
-  void AddRecentEvent(const rtclog::Event& event)
-      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void StoreToFile(rtclog::Event* event) EXCLUSIVE_LOCKS_REQUIRED(file_crit_);
 
-  rtc::CriticalSection crit_;
-  rtc::scoped_ptr<FileWrapper> file_ GUARDED_BY(crit_) =
-      rtc::scoped_ptr<FileWrapper>(FileWrapper::Create());
-  rtc::PlatformFile platform_file_ GUARDED_BY(crit_) =
+  // Serializes access to |file_|. Taken before |crit_|.
+  rtc::CriticalSection file_crit_;
+  rtc::scoped_ptr<FileWrapper> file_ GUARDED_BY(file_crit_);
+  rtc::PlatformFile platform_file_ GUARDED_BY(file_crit_) =
       rtc::kInvalidPlatformFileValue;
-  rtclog::EventStream stream_ GUARDED_BY(crit_);
-  std::deque<rtclog::Event> recent_log_events_ GUARDED_BY(crit_);
-  std::vector<rtclog::Event> config_events_ GUARDED_BY(crit_);
+  rtclog::EventStream stream_ GUARDED_BY(file_crit_);
+  std::string dump_buffer_ GUARDED_BY(file_crit_);
+  // Records taken from |records_| for writing.
+  std::string write_buffer_ GUARDED_BY(file_crit_);
+
+  // Protects the records, and is the only lock taken when logging an event.
+  rtc::CriticalSection crit_;
+  RecordBuffer records_ GUARDED_BY(crit_);
+  // Configuration events which are older than the buffer duration, as
+  // serialized streams. They are written first when logging starts.
+  std::vector<std::string> config_events_ GUARDED_BY(crit_);
+  int dropped_events_ GUARDED_BY(crit_);
+  bool writer_woken_ GUARDED_BY(crit_);
 
   // Microseconds to record log events, before starting the actual log.
   int64_t buffer_duration_us_ GUARDED_BY(crit_);
   bool currently_logging_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
   int64_t start_time_us_ GUARDED_BY(crit_);
   int64_t duration_us_ GUARDED_BY(crit_);
   const Clock* const clock_;
+
+  rtc::Event wake_;
+  rtc::PlatformThread thread_;
 };
 
 namespace {
@@ -159,27 +300,61 @@ rtclog::MediaType ConvertMediaType(MediaType media_type) {
   return rtclog::ANY;
 }
 
-}  // namespace
-
-namespace {
-bool IsConfigEvent(const rtclog::Event& event) {
-  rtclog::Event_EventType event_type = event.type();
-  return event_type == rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT ||
-         event_type == rtclog::Event::VIDEO_SENDER_CONFIG_EVENT ||
-         event_type == rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT ||
-         event_type == rtclog::Event::AUDIO_SENDER_CONFIG_EVENT;
+RecordHeader MakeRecordHeader(RecordType type, int64_t timestamp_us) {
+  RecordHeader header;
+  memset(&header, 0, sizeof(header));
+  header.type = type;
+  header.timestamp_us = timestamp_us;
+  return header;
 }
+
 }  // namespace
 
 // RtcEventLogImpl member functions.
 RtcEventLogImpl::RtcEventLogImpl()
     : file_(FileWrapper::Create()),
       stream_(),
+      records_(kRecordBufferSize),
+      dropped_events_(0),
+      writer_woken_(false),
       buffer_duration_us_(10000000),
       currently_logging_(false),
+      stopping_(false),
       start_time_us_(0),
       duration_us_(0),
-      clock_(Clock::GetRealTimeClock()) {
+      clock_(Clock::GetRealTimeClock()),
+      wake_(false, false),
+      thread_(&RtcEventLogImpl::WriterThread, this, "RtcEventLog") {
+  thread_.Start();
+  thread_.SetPriority(rtc::kLowPriority);
+}
+
+RtcEventLogImpl::~RtcEventLogImpl() {
+  {
+    rtc::CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+  // Write out what has been logged, but leave the file without a LOG_END
+  // event, as if logging had been cut short.
+  rtc::CritScope file_lock(&file_crit_);
+  WriteRecords();
+}
+
+bool RtcEventLogImpl::WriterThread(void* obj) {
+  return static_cast<RtcEventLogImpl*>(obj)->Process();
+}
+
+bool RtcEventLogImpl::Process() {
+  wake_.Wait(kWriteIntervalMs);
+  StopLoggingIfExpired();
+  {
+    rtc::CritScope file_lock(&file_crit_);
+    WriteRecords();
+  }
+  rtc::CritScope lock(&crit_);
+  return !stopping_;
 }
 
 void RtcEventLogImpl::SetBufferDuration(int64_t buffer_duration_us) {
@@ -189,24 +364,20 @@ void RtcEventLogImpl::SetBufferDuration(int64_t buffer_duration_us) {
 
 void RtcEventLogImpl::StartLogging(const std::string& file_name,
                                    int duration_ms) {
-  rtc::CritScope lock(&crit_);
-  if (currently_logging_) {
-    StopLoggingLocked();
-  }
+  rtc::CritScope file_lock(&file_crit_);
+  StopLoggingLocked();
   if (file_->OpenFile(file_name.c_str(), false) != 0) {
     return;
   }
+  rtc::CritScope lock(&crit_);
   start_time_us_ = clock_->TimeInMicroseconds();
   duration_us_ = static_cast<int64_t>(duration_ms) * 1000;
   StartLoggingLocked();
 }
 
 bool RtcEventLogImpl::StartLogging(rtc::PlatformFile log_file) {
-  rtc::CritScope lock(&crit_);
-
-  if (currently_logging_) {
-    StopLoggingLocked();
-  }
+  rtc::CritScope file_lock(&file_crit_);
+  StopLoggingLocked();
   RTC_DCHECK(platform_file_ == rtc::kInvalidPlatformFileValue);
 
   FILE* file_stream = rtc::FdopenPlatformFileForWriting(log_file);
@@ -220,6 +391,7 @@ bool RtcEventLogImpl::StartLogging(rtc::PlatformFile log_file) {
     return false;
   }
   platform_file_ = log_file;
+  rtc::CritScope lock(&crit_);
   // Set the start time and duration to keep logging for 10 minutes.
   start_time_us_ = clock_->TimeInMicroseconds();
   duration_us_ = 10 * 60 * 1000000;
@@ -228,24 +400,33 @@ bool RtcEventLogImpl::StartLogging(rtc::PlatformFile log_file) {
 }
 
 void RtcEventLogImpl::StartLoggingLocked() {
-  currently_logging_ = true;
-
-  // Write all old configuration events to the log file.
-  for (auto& event : config_events_) {
-    StoreToFile(&event);
+  // Drop the recent events which are older than the buffer duration, keeping
+  // configuration events.
+  while (!records_.empty()) {
+    RecordHeader header;
+    records_.PeekHeader(&header);
+    if (header.timestamp_us >= start_time_us_ - buffer_duration_us_)
+      break;
+    DropOldestRecord();
   }
-  // Write all recent configuration events to the log file, and
-  // write all other recent events to the log file, ignoring any old events.
-  for (auto& event : recent_log_events_) {
-    if (IsConfigEvent(event)) {
-      StoreToFile(&event);
-      config_events_.push_back(event);
-    } else if (event.timestamp_us() >= start_time_us_ - buffer_duration_us_) {
-      StoreToFile(&event);
-    }
+  // Write all old configuration events to the log file.
+  for (const std::string& config_event : config_events_)
+    file_->Write(config_event.data(), config_event.size());
+  // Write all recent events, then a LOG_START event. Holding |crit_| keeps new
+  // events from getting in between, which is fine since logging starts
+  // rarely. Recent configuration events are kept for later sessions.
+  write_buffer_.clear();
+  records_.PopAll(&write_buffer_);
+  for (size_t pos = 0; pos < write_buffer_.size();) {
+    RecordHeader header;
+    memcpy(&header, &write_buffer_[pos], sizeof(header));
+    pos += sizeof(header);
+    if (header.type == RecordType::kConfig)
+      config_events_.push_back(write_buffer_.substr(pos, header.data_length));
+    pos += header.data_length;
   }
-  recent_log_events_.clear();
-  // Write a LOG_START event to the file.
+  WriteRecordBuffer();
+  currently_logging_ = true;
   rtclog::Event start_event;
   start_event.set_timestamp_us(start_time_us_);
   start_event.set_type(rtclog::Event::LOG_START);
@@ -253,14 +434,12 @@ void RtcEventLogImpl::StartLoggingLocked() {
 }
 
 void RtcEventLogImpl::StopLogging() {
-  rtc::CritScope lock(&crit_);
+  rtc::CritScope file_lock(&file_crit_);
   StopLoggingLocked();
 }
 
 void RtcEventLogImpl::LogVideoReceiveStreamConfig(
     const VideoReceiveStream::Config& config) {
-  rtc::CritScope lock(&crit_);
-
   rtclog::Event event;
   event.set_timestamp_us(clock_->TimeInMicroseconds());
   event.set_type(rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT);
@@ -292,13 +471,11 @@ void RtcEventLogImpl::LogVideoReceiveStreamConfig(
     decoder->set_name(d.payload_name);
     decoder->set_payload_type(d.payload_type);
   }
-  HandleEvent(&event);
+  AddConfigEvent(&event);
 }
 
 void RtcEventLogImpl::LogVideoSendStreamConfig(
     const VideoSendStream::Config& config) {
-  rtc::CritScope lock(&crit_);
-
   rtclog::Event event;
   event.set_timestamp_us(clock_->TimeInMicroseconds());
   event.set_type(rtclog::Event::VIDEO_SENDER_CONFIG_EVENT);
@@ -324,7 +501,7 @@ void RtcEventLogImpl::LogVideoSendStreamConfig(
   rtclog::EncoderConfig* encoder = sender_config->mutable_encoder();
   encoder->set_name(config.encoder_settings.payload_name);
   encoder->set_payload_type(config.encoder_settings.payload_type);
-  HandleEvent(&event);
+  AddConfigEvent(&event);
 }
 
 void RtcEventLogImpl::LogRtpHeader(bool incoming,
@@ -346,29 +523,23 @@ void RtcEventLogImpl::LogRtpHeader(bool incoming,
     size_t x_len = ByteReader<uint16_t>::ReadBigEndian(header + 14 + cc * 4);
     header_length += (x_len + 1) * 4;
   }
+  if (header_length > packet_length) {
+    return;  // Don't read outside the packet.
+  }
 
-  rtc::CritScope lock(&crit_);
-  rtclog::Event rtp_event;
-  rtp_event.set_timestamp_us(clock_->TimeInMicroseconds());
-  rtp_event.set_type(rtclog::Event::RTP_EVENT);
-  rtp_event.mutable_rtp_packet()->set_incoming(incoming);
-  rtp_event.mutable_rtp_packet()->set_type(ConvertMediaType(media_type));
-  rtp_event.mutable_rtp_packet()->set_packet_length(packet_length);
-  rtp_event.mutable_rtp_packet()->set_header(header, header_length);
-  HandleEvent(&rtp_event);
+  RecordHeader record =
+      MakeRecordHeader(RecordType::kRtp, clock_->TimeInMicroseconds());
+  record.incoming = incoming;
+  record.media_type = media_type;
+  record.value = static_cast<uint32_t>(packet_length);
+  record.data_length = static_cast<uint32_t>(header_length);
+  AddRecord(record, header);
 }
 
 void RtcEventLogImpl::LogRtcpPacket(bool incoming,
                                     MediaType media_type,
                                     const uint8_t* packet,
                                     size_t length) {
-  rtc::CritScope lock(&crit_);
-  rtclog::Event rtcp_event;
-  rtcp_event.set_timestamp_us(clock_->TimeInMicroseconds());
-  rtcp_event.set_type(rtclog::Event::RTCP_EVENT);
-  rtcp_event.mutable_rtcp_packet()->set_incoming(incoming);
-  rtcp_event.mutable_rtcp_packet()->set_type(ConvertMediaType(media_type));
-
   RTCPUtility::RtcpCommonHeader header;
   const uint8_t* block_begin = packet;
   const uint8_t* packet_end = packet + length;
@@ -413,37 +584,49 @@ void RtcEventLogImpl::LogRtcpPacket(bool incoming,
 
     block_begin += block_size;
   }
-  rtcp_event.mutable_rtcp_packet()->set_packet_data(buffer, buffer_length);
-  HandleEvent(&rtcp_event);
+
+  RecordHeader record =
+      MakeRecordHeader(RecordType::kRtcp, clock_->TimeInMicroseconds());
+  record.incoming = incoming;
+  record.media_type = media_type;
+  record.data_length = buffer_length;
+  AddRecord(record, buffer);
 }
 
 void RtcEventLogImpl::LogAudioPlayout(uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  rtclog::Event event;
-  event.set_timestamp_us(clock_->TimeInMicroseconds());
-  event.set_type(rtclog::Event::AUDIO_PLAYOUT_EVENT);
-  auto playout_event = event.mutable_audio_playout_event();
-  playout_event->set_local_ssrc(ssrc);
-  HandleEvent(&event);
+  RecordHeader record = MakeRecordHeader(RecordType::kAudioPlayout,
+                                         clock_->TimeInMicroseconds());
+  record.value = ssrc;
+  AddRecord(record, nullptr);
 }
 
 void RtcEventLogImpl::LogBwePacketLossEvent(int32_t bitrate,
                                             uint8_t fraction_loss,
                                             int32_t total_packets) {
-  rtc::CritScope lock(&crit_);
-  rtclog::Event event;
-  event.set_timestamp_us(clock_->TimeInMicroseconds());
-  event.set_type(rtclog::Event::BWE_PACKET_LOSS_EVENT);
-  auto bwe_event = event.mutable_bwe_packet_loss_event();
-  bwe_event->set_bitrate(bitrate);
-  bwe_event->set_fraction_loss(fraction_loss);
-  bwe_event->set_total_packets(total_packets);
-  HandleEvent(&event);
+  RecordHeader record = MakeRecordHeader(RecordType::kBwePacketLoss,
+                                         clock_->TimeInMicroseconds());
+  record.value = static_cast<uint32_t>(bitrate);
+  record.fraction_loss = fraction_loss;
+  record.total_packets = total_packets;
+  AddRecord(record, nullptr);
 }
 
 void RtcEventLogImpl::StopLoggingLocked() {
-  if (currently_logging_) {
+  WriteRecords();
+  bool was_logging;
+  int dropped_events;
+  {
+    rtc::CritScope lock(&crit_);
+    was_logging = currently_logging_;
     currently_logging_ = false;
+    dropped_events = dropped_events_;
+    dropped_events_ = 0;
+  }
+  if (was_logging) {
+    if (dropped_events > 0) {
+      LOG(LS_WARNING) << "RtcEventLog dropped " << dropped_events
+                      << " events since the writer fell behind.";
+    }
     // Create a LogEnd event
     rtclog::Event event;
     event.set_timestamp_us(clock_->TimeInMicroseconds());
@@ -461,15 +644,139 @@ void RtcEventLogImpl::StopLoggingLocked() {
   stream_.Clear();
 }
 
-void RtcEventLogImpl::HandleEvent(rtclog::Event* event) {
-  if (currently_logging_) {
-    if (clock_->TimeInMicroseconds() < start_time_us_ + duration_us_) {
-      StoreToFile(event);
+void RtcEventLogImpl::StopLoggingIfExpired() {
+  rtc::CritScope file_lock(&file_crit_);
+  {
+    rtc::CritScope lock(&crit_);
+    if (!currently_logging_ ||
+        clock_->TimeInMicroseconds() < start_time_us_ + duration_us_) {
       return;
     }
-    StopLoggingLocked();
   }
-  AddRecentEvent(*event);
+  StopLoggingLocked();
+}
+
+void RtcEventLogImpl::AddRecord(const RecordHeader& header,
+                                const uint8_t* data) {
+  const size_t record_size = sizeof(header) + header.data_length;
+  bool wake_writer = false;
+  {
+    rtc::CritScope lock(&crit_);
+    if (currently_logging_) {
+      if (!records_.Append(header, data))
+        ++dropped_events_;
+      // Write early rather than drop events, and stop on time. Waking the
+      // writer once is enough.
+      if (!writer_woken_ &&
+          (records_.available() < kRecordBufferSize / 2 ||
+           header.timestamp_us >= start_time_us_ + duration_us_)) {
+        writer_woken_ = true;
+        wake_writer = true;
+      }
+    } else {
+      // Make room, and drop the events which no longer fall in the time
+      // window.
+      while (!records_.empty()) {
+        RecordHeader oldest;
+        records_.PeekHeader(&oldest);
+        if (records_.available() >= record_size &&
+            oldest.timestamp_us >= header.timestamp_us - buffer_duration_us_) {
+          break;
+        }
+        DropOldestRecord();
+      }
+      records_.Append(header, data);
+    }
+  }
+  if (wake_writer)
+    wake_.Set();
+}
+
+void RtcEventLogImpl::AddConfigEvent(rtclog::Event* event) {
+  rtclog::EventStream stream;
+  stream.add_stream()->Swap(event);
+  std::string serialized;
+  stream.SerializeToString(&serialized);
+  RecordHeader record =
+      MakeRecordHeader(RecordType::kConfig, stream.stream(0).timestamp_us());
+  record.data_length = static_cast<uint32_t>(serialized.size());
+  AddRecord(record, reinterpret_cast<const uint8_t*>(serialized.data()));
+}
+
+void RtcEventLogImpl::DropOldestRecord() {
+  RecordHeader header;
+  records_.PeekHeader(&header);
+  if (header.type == RecordType::kConfig) {
+    config_events_.push_back(std::string());
+    records_.Pop(&config_events_.back());
+  } else {
+    records_.Pop(nullptr);
+  }
+}
+
+void RtcEventLogImpl::WriteRecords() {
+  write_buffer_.clear();
+  {
+    rtc::CritScope lock(&crit_);
+    writer_woken_ = false;
+    if (!currently_logging_)
+      return;
+    records_.PopAll(&write_buffer_);
+  }
+  WriteRecordBuffer();
+}
+
+void RtcEventLogImpl::WriteRecordBuffer() {
+  rtclog::Event event;
+  for (size_t pos = 0; pos < write_buffer_.size();) {
+    RecordHeader header;
+    memcpy(&header, &write_buffer_[pos], sizeof(header));
+    pos += sizeof(header);
+    const char* data = &write_buffer_[pos];
+    pos += header.data_length;
+    if (header.type == RecordType::kConfig) {
+      file_->Write(data, header.data_length);
+      continue;
+    }
+
+    event.Clear();
+    event.set_timestamp_us(header.timestamp_us);
+    switch (header.type) {
+      case RecordType::kRtp:
+        event.set_type(rtclog::Event::RTP_EVENT);
+        event.mutable_rtp_packet()->set_incoming(header.incoming);
+        event.mutable_rtp_packet()->set_type(
+            ConvertMediaType(header.media_type));
+        event.mutable_rtp_packet()->set_packet_length(header.value);
+        event.mutable_rtp_packet()->set_header(data, header.data_length);
+        break;
+      case RecordType::kRtcp:
+        event.set_type(rtclog::Event::RTCP_EVENT);
+        event.mutable_rtcp_packet()->set_incoming(header.incoming);
+        event.mutable_rtcp_packet()->set_type(
+            ConvertMediaType(header.media_type));
+        event.mutable_rtcp_packet()->set_packet_data(data, header.data_length);
+        break;
+      case RecordType::kAudioPlayout:
+        event.set_type(rtclog::Event::AUDIO_PLAYOUT_EVENT);
+        event.mutable_audio_playout_event()->set_local_ssrc(header.value);
+        break;
+      case RecordType::kBwePacketLoss:
+        event.set_type(rtclog::Event::BWE_PACKET_LOSS_EVENT);
+        event.mutable_bwe_packet_loss_event()->set_bitrate(
+            static_cast<int32_t>(header.value));
+        event.mutable_bwe_packet_loss_event()->set_fraction_loss(
+            header.fraction_loss);
+        event.mutable_bwe_packet_loss_event()->set_total_packets(
+            header.total_packets);
+        break;
+      case RecordType::kConfig:
+        RTC_NOTREACHED();
+        break;
+    }
+    StoreToFile(&event);
+  }
+  write_buffer_.clear();
 }
 
 void RtcEventLogImpl::StoreToFile(rtclog::Event* event) {
@@ -481,20 +788,8 @@ void RtcEventLogImpl::StoreToFile(rtclog::Event* event) {
   stream_.mutable_stream(0)->Swap(event);
   // TODO(terelius): Doesn't this create a new EventStream per event?
   // Is this guaranteed to work e.g. in future versions of protobuf?
-  std::string dump_buffer;
-  stream_.SerializeToString(&dump_buffer);
-  file_->Write(dump_buffer.data(), dump_buffer.size());
-}
-
-void RtcEventLogImpl::AddRecentEvent(const rtclog::Event& event) {
-  recent_log_events_.push_back(event);
-  while (recent_log_events_.front().timestamp_us() <
-         event.timestamp_us() - buffer_duration_us_) {
-    if (IsConfigEvent(recent_log_events_.front())) {
-      config_events_.push_back(recent_log_events_.front());
-    }
-    recent_log_events_.pop_front();
-  }
+  stream_.SerializeToString(&dump_buffer_);
+  file_->Write(dump_buffer_.data(), dump_buffer_.size());
 }
 
 bool RtcEventLog::ParseRtcEventLog(const std::string& file_name,
@@ -513,6 +808,81 @@ bool RtcEventLog::ParseRtcEventLog(const std::string& file_name,
   return result->ParseFromString(dump_buffer);
 }
 
+namespace {
+// Each event is written as an EventStream holding only that event, which is
+// encoded as field 1 with wire type 2 (length-delimited).
+const uint8_t kEventStreamTag = (1 << 3) | 2;
+const size_t kMaxVarintLength = 10;
+const size_t kReadChunkSize = 64 * 1024;
+}  // namespace
+
+RtcEventLogReader::RtcEventLogReader()
+    : file_(FileWrapper::Create()), read_pos_(0), end_pos_(0), failed_(false) {}
+
+RtcEventLogReader::~RtcEventLogReader() {}
+
+bool RtcEventLogReader::Open(const std::string& file_name) {
+  file_->CloseFile();
+  read_pos_ = 0;
+  end_pos_ = 0;
+  failed_ = false;
+  return file_->OpenFile(file_name.c_str(), true) == 0;
+}
+
+bool RtcEventLogReader::ReadNextEvent(rtclog::Event* event) {
+  if (failed_ || !Fill(1))
+    return false;
+  if (buffer_[read_pos_] != kEventStreamTag) {
+    failed_ = true;
+    return false;
+  }
+  // Decode the varint length which follows the tag.
+  uint64_t length = 0;
+  size_t length_bytes = 0;
+  for (;;) {
+    if (length_bytes == kMaxVarintLength || !Fill(2 + length_bytes)) {
+      failed_ = true;
+      return false;
+    }
+    uint8_t byte = buffer_[read_pos_ + 1 + length_bytes];
+    length |= static_cast<uint64_t>(byte & 0x7f) << (7 * length_bytes);
+    ++length_bytes;
+    if (!(byte & 0x80))
+      break;
+  }
+  const size_t header_size = 1 + length_bytes;
+  if (length > std::numeric_limits<int>::max() ||
+      !Fill(header_size + static_cast<size_t>(length)) ||
+      !event->ParseFromArray(&buffer_[read_pos_ + header_size],
+                             static_cast<int>(length))) {
+    failed_ = true;
+    return false;
+  }
+  read_pos_ += header_size + static_cast<size_t>(length);
+  return true;
+}
+
+bool RtcEventLogReader::Fill(size_t size) {
+  if (end_pos_ - read_pos_ >= size)
+    return true;
+  // Move the unread bytes to the front, and make room for at least one chunk
+  // more than needed.
+  if (read_pos_ > 0)
+    memmove(&buffer_[0], &buffer_[read_pos_], end_pos_ - read_pos_);
+  end_pos_ -= read_pos_;
+  read_pos_ = 0;
+  if (buffer_.size() < size + kReadChunkSize)
+    buffer_.resize(size + kReadChunkSize);
+  while (end_pos_ < size) {
+    int bytes_read =
+        file_->Read(&buffer_[end_pos_], buffer_.size() - end_pos_);
+    if (bytes_read <= 0)
+      return false;
+    end_pos_ += bytes_read;
+  }
+  return true;
+}
+
 #endif  // ENABLE_RTC_EVENT_LOG
 
 // RtcEventLog member functions.
@@ -12,7 +12,9 @@
 #define WEBRTC_CALL_RTC_EVENT_LOG_H_
 
 #include <string>
+#include <vector>
 
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/base/platform_file.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/video_receive_stream.h"
@@ -23,9 +25,11 @@ namespace webrtc {
 // Forward declaration of storage class that is automatically generated from
 // the protobuf file.
 namespace rtclog {
+class Event;
 class EventStream;
 }  // namespace rtclog
 
+class FileWrapper;
 class RtcEventLogImpl;
 
 enum class MediaType;
@@ -83,11 +87,42 @@ class RtcEventLog {
                                      int32_t total_packets) = 0;
 
   // Reads an RtcEventLog file and returns true when reading was successful.
-  // The result is stored in the given EventStream object.
+  // The result is stored in the given EventStream object. This holds the
+  // whole log in memory; use RtcEventLogReader for long logs.
   static bool ParseRtcEventLog(const std::string& file_name,
                                rtclog::EventStream* result);
 };
 
+// Reads an RtcEventLog file one event at a time, so that memory use does not
+// grow with the length of the log.
+class RtcEventLogReader {
+ public:
+  RtcEventLogReader();
+  ~RtcEventLogReader();
+
+  // Returns false if the file cannot be opened.
+  bool Open(const std::string& file_name);
+
+  // Reads the next event into |event|. Returns false at the end of the file,
+  // or if the rest of the file is malformed, in which case failed() is true.
+  bool ReadNextEvent(rtclog::Event* event);
+
+  bool failed() const { return failed_; }
+
+ private:
+  // Makes sure that at least |size| unread bytes are buffered. Returns false
+  // if the file ends first.
+  bool Fill(size_t size);
+
+  rtc::scoped_ptr<FileWrapper> file_;
+  std::vector<uint8_t> buffer_;
+  size_t read_pos_;
+  size_t end_pos_;
+  bool failed_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventLogReader);
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_CALL_RTC_EVENT_LOG_H_
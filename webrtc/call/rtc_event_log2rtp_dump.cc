@@ -94,9 +94,11 @@ int main(int argc, char* argv[]) {
     RTC_CHECK(ParseSsrc(FLAGS_ssrc, &ssrc_filter))
         << "Flag verification has failed.";
 
-  webrtc::rtclog::EventStream event_stream;
-  if (!webrtc::RtcEventLog::ParseRtcEventLog(input_file, &event_stream)) {
-    std::cerr << "Error while parsing input file: " << input_file << std::endl;
+  // Read the events one at a time, since logs of long calls can be too large
+  // to hold in memory.
+  webrtc::RtcEventLogReader reader;
+  if (!reader.Open(input_file)) {
+    std::cerr << "Error while opening input file: " << input_file << std::endl;
     return -1;
   }
 
@@ -110,14 +112,13 @@ int main(int argc, char* argv[]) {
     return -1;
   }
 
-  std::cout << "Found " << event_stream.stream_size()
-            << " events in the input file." << std::endl;
-  int rtp_counter = 0, rtcp_counter = 0;
+  int event_counter = 0, rtp_counter = 0, rtcp_counter = 0;
   bool header_only = false;
+  webrtc::rtclog::Event event;
   // TODO(ivoc): This can be refactored once the packet interpretation
   //             functions are finished.
-  for (int i = 0; i < event_stream.stream_size(); i++) {
-    const webrtc::rtclog::Event& event = event_stream.stream(i);
+  while (reader.ReadNextEvent(&event)) {
+    event_counter++;
     if (!FLAGS_nortp && event.has_type() && event.type() == event.RTP_EVENT) {
       if (event.has_timestamp_us() && event.has_rtp_packet() &&
           event.rtp_packet().has_header() &&
@@ -200,6 +201,12 @@ int main(int argc, char* argv[]) {
       }
     }
   }
+  if (reader.failed()) {
+    std::cerr << "Error while parsing input file: " << input_file
+              << ", stopped after " << event_counter << " events." << std::endl;
+  }
+  std::cout << "Found " << event_counter << " events in the input file."
+            << std::endl;
   std::cout << "Wrote " << rtp_counter << (header_only ? " header-only" : "")
             << " RTP packets and " << rtcp_counter << " RTCP packets to the "
             << "output file." << std::endl;
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "gflags/gflags.h"
+#include "webrtc/call/rtc_event_log.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+// Files generated at build-time by the protobuf compiler.
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/call/rtc_event_log.pb.h"
+#else
+#include "webrtc/call/rtc_event_log.pb.h"
+#endif
+
+namespace {
+
+DEFINE_int32(interval_ms,
+             1000,
+             "Length of the intervals that RTP statistics are aggregated "
+             "over.");
+
+const uint8_t kRtcpSenderReport = 200;
+const uint8_t kRtcpReceiverReport = 201;
+const size_t kRtcpReportBlockLength = 24;
+const size_t kRtcpSenderInfoLength = 20;
+
+const char* Direction(bool incoming) {
+  return incoming ? "in" : "out";
+}
+
+// Per-SSRC counters for the current interval. The only state kept across
+// intervals is the highest sequence number seen, so memory use depends on the
+// number of streams and not on the length of the log.
+struct RtpStreamStats {
+  RtpStreamStats()
+      : packets(0),
+        bytes(0),
+        has_sequence_number(false),
+        max_sequence_number(0),
+        interval_start_sequence_number(0) {}
+  int packets;
+  int64_t bytes;
+  bool has_sequence_number;
+  // Unwrapped, i.e. continues counting past 0xFFFF.
+  int64_t max_sequence_number;
+  int64_t interval_start_sequence_number;
+};
+
+typedef std::map<std::pair<bool, uint32_t>, RtpStreamStats> RtpStreamMap;
+
+void AddRtpPacket(const webrtc::rtclog::RtpPacket& packet,
+                  RtpStreamMap* streams) {
+  const std::string& header = packet.header();
+  if (header.size() < 12)
+    return;
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(header.data());
+  uint16_t sequence_number =
+      webrtc::ByteReader<uint16_t>::ReadBigEndian(data + 2);
+  uint32_t ssrc = webrtc::ByteReader<uint32_t>::ReadBigEndian(data + 8);
+  RtpStreamStats& stats = (*streams)[std::make_pair(packet.incoming(), ssrc)];
+  ++stats.packets;
+  stats.bytes += packet.packet_length();
+  if (!stats.has_sequence_number) {
+    stats.has_sequence_number = true;
+    stats.max_sequence_number = sequence_number;
+    stats.interval_start_sequence_number = sequence_number - 1;
+    return;
+  }
+  int16_t delta = static_cast<int16_t>(
+      sequence_number - static_cast<uint16_t>(stats.max_sequence_number));
+  if (delta > 0)
+    stats.max_sequence_number += delta;
+}
+
+// Prints one row per stream with traffic in the interval ending at |time_ms|,
+// and resets the per-interval counters.
+void PrintRtpInterval(int64_t time_ms, RtpStreamMap* streams) {
+  for (auto& it : *streams) {
+    RtpStreamStats& stats = it.second;
+    if (stats.packets == 0)
+      continue;
+    bool incoming = it.first.first;
+    // Loss is only meaningful for packets we receive; reordered packets from
+    // an earlier interval can make the count briefly negative.
+    int64_t lost = 0;
+    if (incoming) {
+      int64_t expected =
+          stats.max_sequence_number - stats.interval_start_sequence_number;
+      lost = std::max<int64_t>(expected - stats.packets, 0);
+    }
+    std::cout << "rtp," << time_ms << "," << Direction(incoming) << ","
+              << it.first.second << "," << stats.packets << ","
+              << stats.bytes * 8 / FLAGS_interval_ms << "," << lost
+              << std::endl;
+    stats.packets = 0;
+    stats.bytes = 0;
+    stats.interval_start_sequence_number = stats.max_sequence_number;
+  }
+}
+
+// Prints one row per report block in the sender and receiver reports of a
+// compound RTCP packet. Other RTCP packet types are skipped.
+void PrintRtcpPacket(int64_t time_ms,
+                     const webrtc::rtclog::RtcpPacket& packet) {
+  const std::string& packet_data = packet.packet_data();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(packet_data.data());
+  size_t size = packet_data.size();
+  size_t offset = 0;
+  while (offset + 4 <= size) {
+    const uint8_t* block = data + offset;
+    uint8_t report_count = block[0] & 0x1F;
+    uint8_t packet_type = block[1];
+    size_t length =
+        4 * (webrtc::ByteReader<uint16_t>::ReadBigEndian(block + 2) + 1);
+    if (offset + length > size)
+      return;
+    size_t blocks_offset = 8;
+    if (packet_type == kRtcpSenderReport)
+      blocks_offset += kRtcpSenderInfoLength;
+    if (packet_type == kRtcpSenderReport ||
+        packet_type == kRtcpReceiverReport) {
+      for (uint8_t i = 0; i < report_count; ++i) {
+        size_t report_offset = blocks_offset + i * kRtcpReportBlockLength;
+        if (report_offset + kRtcpReportBlockLength > length)
+          break;
+        const uint8_t* report = block + report_offset;
+        std::cout << "rtcp," << time_ms << "," << Direction(packet.incoming())
+                  << ","
+                  << webrtc::ByteReader<uint32_t>::ReadBigEndian(report)
+                  << "," << static_cast<int>(report[4]) << ","
+                  << webrtc::ByteReader<uint32_t>::ReadBigEndian(report + 12)
+                  << std::endl;
+      }
+    }
+    offset += length;
+  }
+}
+
+}  // namespace
+
+// This utility reads a stored event log one event at a time and prints a CSV
+// time series of per-stream bitrate and loss, RTCP report blocks and
+// bandwidth estimates. Delay is approximated by the interarrival jitter
+// reported in RTCP, since the log has no send times for incoming packets.
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for summarizing an RtcEventLog file as CSV.\n"
+      "Run " +
+      program_name +
+      " --helpshort for usage.\n"
+      "Example usage:\n" +
+      program_name + " input.rel > output.csv\n"
+      "Rows are one of:\n"
+      "  rtp,<time_ms>,<in|out>,<ssrc>,<packets>,<kbps>,<lost>\n"
+      "  rtcp,<time_ms>,<in|out>,<ssrc>,<fraction_lost>,<jitter>\n"
+      "  bwe,<time_ms>,<bitrate_bps>,<fraction_loss>,<total_packets>\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc != 2 || FLAGS_interval_ms <= 0) {
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+  std::string input_file = argv[1];
+
+  webrtc::RtcEventLogReader reader;
+  if (!reader.Open(input_file)) {
+    std::cerr << "Error while opening input file: " << input_file << std::endl;
+    return -1;
+  }
+
+  RtpStreamMap streams;
+  int64_t interval_end_ms = -1;
+  webrtc::rtclog::Event event;
+  while (reader.ReadNextEvent(&event)) {
+    int64_t time_ms = event.timestamp_us() / 1000;
+    if (interval_end_ms < 0)
+      interval_end_ms = time_ms + FLAGS_interval_ms;
+    while (time_ms >= interval_end_ms) {
+      PrintRtpInterval(interval_end_ms, &streams);
+      interval_end_ms += FLAGS_interval_ms;
+    }
+
+    if (event.type() == webrtc::rtclog::Event::RTP_EVENT &&
+        event.has_rtp_packet()) {
+      AddRtpPacket(event.rtp_packet(), &streams);
+    } else if (event.type() == webrtc::rtclog::Event::RTCP_EVENT &&
+               event.has_rtcp_packet()) {
+      PrintRtcpPacket(time_ms, event.rtcp_packet());
+    } else if (event.type() == webrtc::rtclog::Event::BWE_PACKET_LOSS_EVENT &&
+               event.has_bwe_packet_loss_event()) {
+      const webrtc::rtclog::BwePacketLossEvent& bwe =
+          event.bwe_packet_loss_event();
+      std::cout << "bwe," << time_ms << "," << bwe.bitrate() << ","
+                << bwe.fraction_loss() << "," << bwe.total_packets()
+                << std::endl;
+    }
+  }
+  if (interval_end_ms >= 0)
+    PrintRtpInterval(interval_end_ms, &streams);
+
+  if (reader.failed()) {
+    std::cerr << "Error while parsing input file: " << input_file << std::endl;
+    return -1;
+  }
+  return 0;
+}
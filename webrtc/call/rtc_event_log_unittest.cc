@@ -558,6 +558,20 @@ void LogSessionAndReadBack(size_t rtp_count,
     }
   }
 
+  // Reading the file one event at a time gives the same events.
+  RtcEventLogReader reader;
+  ASSERT_TRUE(reader.Open(temp_filename));
+  rtclog::Event event;
+  int read_count = 0;
+  while (reader.ReadNextEvent(&event)) {
+    ASSERT_LT(read_count, parsed_stream.stream_size());
+    EXPECT_EQ(parsed_stream.stream(read_count).SerializeAsString(),
+              event.SerializeAsString());
+    ++read_count;
+  }
+  EXPECT_FALSE(reader.failed());
+  EXPECT_EQ(parsed_stream.stream_size(), read_count);
+
   // Clean up temporary file - can be pretty slow.
   remove(temp_filename.c_str());
 }
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_SSRC_TABLE_H_
+#define WEBRTC_CALL_SSRC_TABLE_H_
+
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Open-addressing hash table keyed by SSRC, for lookups on the packet path.
+// All slots live in one array and a lookup is usually a single probe. Entries
+// can't be removed individually; the owner is expected to Clear() and refill
+// the table when its set of SSRCs changes, which is rare compared to lookups.
+template <typename T>
+class SsrcTable {
+ public:
+  SsrcTable() : slots_(kInitialCapacity), size_(0) {}
+
+  size_t size() const { return size_; }
+
+  void Clear() {
+    slots_.assign(kInitialCapacity, Slot());
+    size_ = 0;
+  }
+
+  // Returns the value for |ssrc|, inserting a default constructed one if
+  // there is none.
+  T* FindOrInsert(uint32_t ssrc) {
+    // Keep the load factor at or below one half so probe sequences stay short.
+    if (2 * (size_ + 1) > slots_.size())
+      Grow();
+    Slot* slot = Probe(ssrc);
+    if (!slot->used) {
+      slot->used = true;
+      slot->ssrc = ssrc;
+      slot->value = T();
+      ++size_;
+    }
+    return &slot->value;
+  }
+
+  // Returns nullptr if |ssrc| is not in the table.
+  const T* Find(uint32_t ssrc) const {
+    const Slot* slot = const_cast<SsrcTable*>(this)->Probe(ssrc);
+    return slot->used ? &slot->value : nullptr;
+  }
+
+ private:
+  static const size_t kInitialCapacity = 16;
+
+  struct Slot {
+    Slot() : used(false), ssrc(0), value() {}
+    bool used;
+    uint32_t ssrc;
+    T value;
+  };
+
+  // Returns the slot holding |ssrc|, or the empty slot where it would go.
+  Slot* Probe(uint32_t ssrc) {
+    const size_t mask = slots_.size() - 1;
+    // SSRCs are random, but multiply by a large odd constant anyway so that
+    // sequential test SSRCs don't all land in neighbouring slots.
+    size_t index = (ssrc * 0x9E3779B1u) & mask;
+    while (slots_[index].used && slots_[index].ssrc != ssrc)
+      index = (index + 1) & mask;
+    return &slots_[index];
+  }
+
+  void Grow() {
+    std::vector<Slot> old_slots(2 * slots_.size());
+    old_slots.swap(slots_);
+    for (const Slot& old_slot : old_slots) {
+      if (!old_slot.used)
+        continue;
+      Slot* slot = Probe(old_slot.ssrc);
+      RTC_DCHECK(!slot->used);
+      *slot = old_slot;
+    }
+  }
+
+  // Size is always a power of two.
+  std::vector<Slot> slots_;
+  size_t size_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_SSRC_TABLE_H_
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/call/ssrc_table.h"
+
+namespace webrtc {
+
+TEST(SsrcTableTest, FindsInsertedValues) {
+  SsrcTable<int> table;
+  EXPECT_TRUE(table.Find(0) == nullptr);
+  *table.FindOrInsert(0) = 10;
+  *table.FindOrInsert(0xFFFFFFFF) = 20;
+  EXPECT_EQ(2u, table.size());
+  ASSERT_TRUE(table.Find(0) != nullptr);
+  EXPECT_EQ(10, *table.Find(0));
+  ASSERT_TRUE(table.Find(0xFFFFFFFF) != nullptr);
+  EXPECT_EQ(20, *table.Find(0xFFFFFFFF));
+  EXPECT_TRUE(table.Find(1) == nullptr);
+}
+
+TEST(SsrcTableTest, FindOrInsertReturnsExistingValue) {
+  SsrcTable<int> table;
+  *table.FindOrInsert(1234) = 5;
+  EXPECT_EQ(5, *table.FindOrInsert(1234));
+  EXPECT_EQ(1u, table.size());
+}
+
+TEST(SsrcTableTest, GrowsAndKeepsValues) {
+  SsrcTable<uint32_t> table;
+  const uint32_t kNumSsrcs = 1000;
+  for (uint32_t i = 0; i < kNumSsrcs; ++i)
+    *table.FindOrInsert(i * 16) = i;
+  EXPECT_EQ(kNumSsrcs, table.size());
+  for (uint32_t i = 0; i < kNumSsrcs; ++i) {
+    ASSERT_TRUE(table.Find(i * 16) != nullptr);
+    EXPECT_EQ(i, *table.Find(i * 16));
+    EXPECT_TRUE(table.Find(i * 16 + 1) == nullptr);
+  }
+}
+
+TEST(SsrcTableTest, Clear) {
+  SsrcTable<int> table;
+  for (int i = 0; i < 100; ++i)
+    *table.FindOrInsert(i) = i;
+  table.Clear();
+  EXPECT_EQ(0u, table.size());
+  EXPECT_TRUE(table.Find(1) == nullptr);
+  *table.FindOrInsert(1) = 2;
+  EXPECT_EQ(2, *table.Find(1));
+}
+
+}  // namespace webrtc
@@ -11,9 +11,29 @@
 #include "webrtc/common_audio/include/audio_util.h"
 
 #include "webrtc/typedefs.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/common_audio/audio_util_sse2.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#endif
 
 namespace webrtc {
 
+namespace {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// If we know the minimum architecture at compile time, avoid CPU detection.
+bool HasSse2() {
+#if defined(__SSE2__)
+  return true;
+#else
+  static const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  return has_sse2;
+#endif
+}
+#endif
+
+}  // namespace
+
 void FloatToS16(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToS16(src[i]);
@@ -25,10 +45,27 @@ void S16ToFloat(const int16_t* src, size_t size, float* dest) {
 }
 
 void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    FloatS16ToS16_SSE2(src, size, dest);
+    return;
+  }
+#endif
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatS16ToS16(src[i]);
 }
 
+void S16ToFloatS16(const int16_t* src, size_t size, float* dest) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (HasSse2()) {
+    S16ToFloatS16_SSE2(src, size, dest);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = src[i];
+}
+
 void FloatToFloatS16(const float* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToFloatS16(src[i]);
@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SSE2_H_
+#define WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SSE2_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// SSE2 versions of the array conversions in audio_util.h, with the same
+// results. Use those functions instead, which pick these when available.
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest);
+void S16ToFloatS16_SSE2(const int16_t* src, size_t size, float* dest);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_AUDIO_UTIL_SSE2_H_
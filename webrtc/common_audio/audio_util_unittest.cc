@@ -68,6 +68,31 @@ TEST(AudioUtilTest, FloatS16ToS16) {
   ExpectArraysEq(kReference, output, kSize);
 }
 
+// Long enough to run the vectorized path as well as its tail.
+TEST(AudioUtilTest, FloatS16ToS16Long) {
+  const size_t kSize = 19;
+  const float kInput[kSize] = {
+      0.f,      0.4f,      0.5f,     -0.4f,    -0.5f,    32768.f, -32769.f,
+      1.5f,     -1.5f,     2.5f,     -2.5f,    32766.6f, -32767.6f, 1e10f,
+      -1e10f,   100.49f,   -100.49f, 32767.f,  -32768.f};
+  const int16_t kReference[kSize] = {
+      0,     0,      1,     0,     -1,     32767, -32768, 2,     -2,    3,
+      -3,    32767, -32768, 32767, -32768, 100,   -100,   32767, -32768};
+  int16_t output[kSize];
+  FloatS16ToS16(kInput, kSize, output);
+  ExpectArraysEq(kReference, output, kSize);
+}
+
+TEST(AudioUtilTest, S16ToFloatS16) {
+  const size_t kSize = 11;
+  const int16_t kInput[kSize] = {0,     1,      -1,    16384, -16384, 32767,
+                                 -32768, 12345, -12345, 7,     -7};
+  float output[kSize];
+  S16ToFloatS16(kInput, kSize, output);
+  for (size_t i = 0; i < kSize; ++i)
+    EXPECT_EQ(static_cast<float>(kInput[i]), output[i]);
+}
+
 TEST(AudioUtilTest, FloatToFloatS16) {
   const size_t kSize = 9;
   const float kInput[kSize] = {0.f,
@@ -34,6 +34,7 @@
         'audio_ring_buffer.cc',
         'audio_ring_buffer.h',
         'audio_util.cc',
+        'audio_util_sse2.h',
         'blocker.cc',
         'blocker.h',
         'channel_buffer.cc',
@@ -42,6 +43,7 @@
         'fft4g.h',
         'fir_filter.cc',
         'fir_filter.h',
+        'fir_filter_avx2.h',
         'fir_filter_neon.h',
         'fir_filter_sse.h',
         'include/audio_util.h',
@@ -135,7 +137,10 @@
           ],
         }],
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx2',
+            'common_audio_sse2',
+          ],
         }],
         ['build_with_neon==1', {
           'dependencies': ['common_audio_neon',],
@@ -198,8 +203,13 @@
           'target_name': 'common_audio_sse2',
           'type': 'static_library',
           'sources': [
+            'audio_util_sse2.cc',
             'fir_filter_sse.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
+            'signal_processing/min_max_operations_sse2.c',
+            'sparse_fir_filter_sse.cc',
           ],
           'conditions': [
             ['os_posix==1', {
@@ -210,6 +220,23 @@
             }],
           ],
         },
+        {
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'fir_filter_avx2.cc',
+            'resampler/sinc_resampler_avx2.cc',
+            'sparse_fir_filter_avx2.cc',
+          ],
+          'conditions': [
+            ['os_posix==1', {
+              'cflags': [ '-mavx2', ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-mavx2', ],
+              },
+            }],
+          ],
+        },
       ],  # targets
     }],
     ['build_with_neon==1', {
@@ -224,6 +251,7 @@
             'signal_processing/cross_correlation_neon.c',
             'signal_processing/downsample_fast_neon.c',
             'signal_processing/min_max_operations_neon.c',
+            'sparse_fir_filter_neon.cc',
           ],
         },
       ],  # targets
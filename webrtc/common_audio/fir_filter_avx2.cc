@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/fir_filter_avx2.h"
+
+#include <assert.h>
+#include <immintrin.h>
+#include <string.h>
+
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+FIRFilterAVX2::FIRFilterAVX2(const float* coefficients,
+                             size_t coefficients_length,
+                             size_t max_input_length)
+    :  // Closest higher multiple of eight.
+      coefficients_length_((coefficients_length + 7) & ~0x07),
+      state_length_(coefficients_length_ - 1),
+      coefficients_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * coefficients_length_, 32))),
+      state_(static_cast<float*>(
+          AlignedMalloc(sizeof(float) * (max_input_length + state_length_),
+                        32))) {
+  // Add zeros at the end of the coefficients.
+  size_t padding = coefficients_length_ - coefficients_length;
+  memset(coefficients_.get(), 0, padding * sizeof(coefficients_[0]));
+  // The coefficients are reversed to compensate for the order in which the
+  // input samples are acquired (most recent last).
+  for (size_t i = 0; i < coefficients_length; ++i) {
+    coefficients_[i + padding] = coefficients[coefficients_length - i - 1];
+  }
+  memset(state_.get(),
+         0,
+         (max_input_length + state_length_) * sizeof(state_[0]));
+}
+
+void FIRFilterAVX2::Filter(const float* in, size_t length, float* out) {
+  assert(length > 0);
+
+  memcpy(&state_[state_length_], in, length * sizeof(*in));
+
+  // Convolves the input signal |in| with the filter kernel |coefficients_|
+  // taking into account the previous state. The state is only 32-byte aligned
+  // for one in eight outputs, so it is always read with unaligned loads, which
+  // cost nothing extra on aligned data on CPUs with AVX2.
+  for (size_t i = 0; i < length; ++i) {
+    const float* in_ptr = &state_[i];
+    const float* coef_ptr = coefficients_.get();
+
+    __m256 m_sum = _mm256_setzero_ps();
+    for (size_t j = 0; j < coefficients_length_; j += 8) {
+      m_sum = _mm256_add_ps(m_sum, _mm256_mul_ps(_mm256_loadu_ps(in_ptr + j),
+                                                 _mm256_load_ps(coef_ptr + j)));
+    }
+    __m128 m_quad = _mm_add_ps(_mm256_castps256_ps128(m_sum),
+                               _mm256_extractf128_ps(m_sum, 1));
+    m_quad = _mm_add_ps(_mm_movehl_ps(m_quad, m_quad), m_quad);
+    _mm_store_ss(out + i,
+                 _mm_add_ss(m_quad, _mm_shuffle_ps(m_quad, m_quad, 1)));
+  }
+  _mm256_zeroupper();
+
+  // Update current state.
+  memmove(state_.get(), &state_[length], state_length_ * sizeof(state_[0]));
+}
+
+}  // namespace webrtc
@@ -152,6 +152,34 @@ TEST(FIRFilterTest, VerifySampleBasedVsBlockBasedFiltering) {
                       kInputLength));
 }
 
+TEST(FIRFilterTest, FilterWithLongerCoefficientsThanVectorWidth) {
+  // More coefficients than fit in one SIMD register, and not a multiple of
+  // the register width.
+  const size_t kLongCoefficientsLength = 19;
+  float long_coefficients[kLongCoefficientsLength];
+  for (size_t i = 0; i < kLongCoefficientsLength; ++i) {
+    long_coefficients[i] = 1.f / (i + 2.f);
+  }
+  const size_t kLongInputLength = 37;
+  float long_input[kLongInputLength];
+  for (size_t i = 0; i < kLongInputLength; ++i) {
+    long_input[i] = static_cast<float>(i % 5) - 2.f;
+  }
+
+  float output[kLongInputLength];
+  rtc::scoped_ptr<FIRFilter> filter(FIRFilter::Create(
+      long_coefficients, kLongCoefficientsLength, kLongInputLength));
+  filter->Filter(long_input, kLongInputLength, output);
+
+  for (size_t i = 0; i < kLongInputLength; ++i) {
+    float expected = 0.f;
+    for (size_t j = 0; j < kLongCoefficientsLength && j <= i; ++j) {
+      expected += long_coefficients[j] * long_input[i - j];
+    }
+    EXPECT_NEAR(expected, output[i], 1e-5f);
+  }
+}
+
 TEST(FIRFilterTest, SimplestHighPassFilter) {
   const float kCoefficients[] = {1.f, -1.f};
   const size_t kCoefficientsLength = sizeof(kCoefficients) /
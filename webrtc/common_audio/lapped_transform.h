@@ -46,6 +46,9 @@ class LappedTransform {
   // |block_length| defines the length of a block, in samples.
   // |shift_amount| is in samples. |callback| is the caller-owned audio
   // processing function called for each block of the input chunk.
+  // With |num_out_channels| of zero the transform only does the analysis: the
+  // callback gets no output channels, no inverse transforms are done and
+  // ProcessChunk() takes no output buffer.
   LappedTransform(size_t num_in_channels,
                   size_t num_out_channels,
                   size_t chunk_length,
@@ -58,7 +61,8 @@ class LappedTransform {
   // Main audio processing helper method. Internally slices |in_chunk| into
   // blocks, transforms them to frequency domain, calls the callback for each
   // block and returns a de-blocked time domain chunk of audio through
-  // |out_chunk|. Both buffers are caller-owned.
+  // |out_chunk|. Both buffers are caller-owned. |out_chunk| may be null when
+  // there are no output channels.
   void ProcessChunk(const float* const* in_chunk, float* const* out_chunk);
 
   // Get the chunk length.
@@ -77,6 +77,28 @@ class FftCheckerCallback : public webrtc::LappedTransform::Callback {
   size_t block_num_;
 };
 
+class AnalysisCallback : public webrtc::LappedTransform::Callback {
+ public:
+  AnalysisCallback() : block_num_(0), dc_sum_(0.0f) {}
+
+  virtual void ProcessAudioBlock(const complex<float>* const* in_block,
+                                 size_t in_channels,
+                                 size_t frames,
+                                 size_t out_channels,
+                                 complex<float>* const* out_block) {
+    RTC_CHECK_EQ(0u, out_channels);
+    dc_sum_ += in_block[0][0].real();
+    ++block_num_;
+  }
+
+  size_t block_num() { return block_num_; }
+  float dc_sum() { return dc_sum_; }
+
+ private:
+  size_t block_num_;
+  float dc_sum_;
+};
+
 void SetFloatArray(float value, int rows, int cols, float* const* array) {
   for (int i = 0; i < rows; ++i) {
     for (int j = 0; j < cols; ++j) {
@@ -182,6 +204,27 @@ TEST(LappedTransformTest, Callbacks) {
   ASSERT_EQ(kChunkLength / kBlockLength, call.block_num());
 }
 
+TEST(LappedTransformTest, AnalysisOnly) {
+  const size_t kChunkLength = 512;
+  const size_t kBlockLength = 64;
+  AnalysisCallback call;
+
+  // Rectangular window.
+  float window[kBlockLength];
+  std::fill(window, &window[kBlockLength], 1.0f);
+
+  LappedTransform trans(1, 0, kChunkLength, window, kBlockLength,
+                        kBlockLength, &call);
+  float in_buffer[kChunkLength];
+  float* in_chunk = in_buffer;
+  SetFloatArray(1.0f, 1, kChunkLength, &in_chunk);
+
+  trans.ProcessChunk(&in_chunk, nullptr);
+
+  ASSERT_EQ(kChunkLength / kBlockLength, call.block_num());
+  EXPECT_NEAR(static_cast<float>(kChunkLength), call.dc_sum(), 1e-3f);
+}
+
 TEST(LappedTransformTest, chunk_length) {
   const size_t kBlockLength = 64;
   FftCheckerCallback call;
@@ -67,9 +67,9 @@ void RealFourierOoura::Inverse(const complex<float>* src, float* dest) const {
     // The real output array is shorter than the input complex array by one
     // complex element.
     const size_t dest_complex_length = complex_length_ - 1;
-    std::copy(src, src + dest_complex_length, dest_complex);
-    // Restore Ooura's conjugate definition.
-    Conjugate(dest_complex, dest_complex_length);
+    // Copy while restoring Ooura's conjugate definition, in a single pass.
+    std::transform(src, src + dest_complex_length, dest_complex,
+                   [](const complex<float>& v) { return std::conj(v); });
     // Restore real[n/2] to imag[0].
     dest_complex[0] = complex<float>(dest_complex[0].real(),
                                      src[complex_length_ - 1].real());
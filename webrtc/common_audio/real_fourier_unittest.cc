@@ -10,12 +10,14 @@
 
 #include "webrtc/common_audio/real_fourier.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
 #include "webrtc/common_audio/real_fourier_ooura.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 
 namespace webrtc {
 
@@ -106,5 +108,49 @@ TYPED_TEST(RealFourierTest, SimpleBackwardTransform) {
   EXPECT_NEAR(this->real_buffer_[3], 4.0f, 1e-8f);
 }
 
+TYPED_TEST(RealFourierTest, ForwardInverseRoundTrip) {
+  for (int order = 6; order <= 10; ++order) {
+    TypeParam rf(order);
+    const size_t length = RealFourier::FftLength(order);
+    RealFourier::fft_real_scoper input = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_real_scoper output = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_cplx_scoper cplx =
+        RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+    for (size_t i = 0; i < length; ++i)
+      input[i] = static_cast<float>(i % 7) - 3.0f;
+
+    rf.Forward(input.get(), cplx.get());
+    rf.Inverse(cplx.get(), output.get());
+
+    for (size_t i = 0; i < length; ++i)
+      EXPECT_NEAR(input[i], output[i], 1e-4f) << "order " << order;
+  }
+}
+
+// Compares the speed of the available implementations for the FFT sizes used
+// by the audio processing modules. Disabled because it is slow; use it for
+// benchmarking when needed.
+TYPED_TEST(RealFourierTest, DISABLED_Benchmark) {
+  const int kIterations = 100000;
+  for (int order = 6; order <= 10; ++order) {
+    TypeParam rf(order);
+    const size_t length = RealFourier::FftLength(order);
+    RealFourier::fft_real_scoper real = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_cplx_scoper cplx =
+        RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+    for (size_t i = 0; i < length; ++i)
+      real[i] = static_cast<float>(rand()) / RAND_MAX;
+
+    TickTime start = TickTime::Now();
+    for (int i = 0; i < kIterations; ++i) {
+      rf.Forward(real.get(), cplx.get());
+      rf.Inverse(cplx.get(), real.get());
+    }
+    double total_time_us = (TickTime::Now() - start).Microseconds();
+    printf("FFT size %4d: %.3f us per forward and inverse transform.\n",
+           static_cast<int>(length), total_time_us / kIterations);
+  }
+}
+
 }  // namespace webrtc
 
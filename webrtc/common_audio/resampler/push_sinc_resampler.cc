@@ -26,7 +26,10 @@ PushSincResampler::PushSincResampler(size_t source_frames,
       source_ptr_int_(nullptr),
       destination_frames_(destination_frames),
       first_pass_(true),
-      source_available_(0) {}
+      source_available_(0) {
+  // Common conversions, e.g., 48 to 16 kHz, use the faster fixed ratio path.
+  resampler_->SetFixedRatio(source_frames, destination_frames);
+}
 
 PushSincResampler::~PushSincResampler() {
 }
@@ -78,6 +81,11 @@ size_t PushSincResampler::Resample(const float* source,
   return destination_frames_;
 }
 
+void PushSincResampler::Reset() {
+  resampler_->Flush();
+  first_pass_ = true;
+}
+
 void PushSincResampler::Run(size_t frames, float* destination) {
   // Ensure we are only asked for the available samples. This would fail if
   // Run() was triggered more than once per Resample() call.
@@ -42,6 +42,9 @@ class PushSincResampler : public SincResamplerCallback {
                   float* destination,
                   size_t destination_capacity);
 
+  // Resets the state, as after construction.
+  void Reset();
+
   // Delay due to the filter kernel. Essentially, the time after which an input
   // sample will appear in the resampled output.
   static float AlgorithmicDelaySeconds(int source_rate_hz) {
@@ -119,32 +119,42 @@ double SincScaleFactor(double io_ratio) {
 }  // namespace
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
+// On x86, AVX2 still has to be detected at run time.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
 #define CONVOLVE_FUNC convolve_proc_
-
+#define CONVOLVE_SINGLE_FUNC convolve_single_proc_
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
-}
+#if defined(__SSE2__)
+  convolve_proc_ = Convolve_SSE;
+  convolve_single_proc_ = ConvolveSingle_SSE;
+#else
+  // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+  const bool has_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  convolve_proc_ = has_sse2 ? Convolve_SSE : Convolve_C;
+  convolve_single_proc_ = has_sse2 ? ConvolveSingle_SSE : ConvolveSingle_C;
 #endif
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    convolve_proc_ = Convolve_AVX2;
+    convolve_single_proc_ = ConvolveSingle_AVX2;
+  }
+}
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #elif defined(WEBRTC_DETECT_NEON)
 #define CONVOLVE_FUNC convolve_proc_
+#define CONVOLVE_SINGLE_FUNC convolve_single_proc_
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON ?
-      Convolve_NEON : Convolve_C;
+  const bool has_neon =
+      (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0;
+  convolve_proc_ = has_neon ? Convolve_NEON : Convolve_C;
+  convolve_single_proc_ = has_neon ? ConvolveSingle_NEON : ConvolveSingle_C;
 }
 #else
 // Unknown architecture.
 #define CONVOLVE_FUNC Convolve_C
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_C
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #endif
 
@@ -152,26 +162,32 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
                              size_t request_frames,
                              SincResamplerCallback* read_cb)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
+      phase_count_(0),
+      fixed_step_frames_(0),
+      fixed_step_phases_(0),
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
       // Create input buffers with a 16-byte alignment for SSE optimizations.
+      // The kernels are 32-byte aligned for AVX.
       kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_pre_sinc_storage_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
       kernel_window_storage_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
       input_buffer_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * input_buffer_size_, 16))),
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_CPU_DETECTION) || defined(WEBRTC_ARCH_X86_FAMILY)
       convolve_proc_(NULL),
+      convolve_single_proc_(NULL),
 #endif
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_CPU_DETECTION) || defined(WEBRTC_ARCH_X86_FAMILY)
   InitializeCPUSpecificFeatures();
   assert(convolve_proc_);
+  assert(convolve_single_proc_);
 #endif
   assert(request_frames_ > 0);
   Flush();
@@ -242,7 +258,70 @@ void SincResampler::InitializeKernel() {
   }
 }
 
+void SincResampler::InitializePhaseKernels() {
+  if (!phase_kernel_storage_) {
+    phase_kernel_storage_.reset(static_cast<float*>(
+        AlignedMalloc(sizeof(float) * kKernelSize * kMaxPhaseCount, 32)));
+  }
+
+  // Interpolate the kernels for each sub-sample offset in the same way as
+  // Resample() interpolates the convolutions.  Offsets which fall on a stored
+  // kernel, e.g., all of them for 48 to 16 kHz, are copied unchanged.
+  for (size_t phase = 0; phase < phase_count_; ++phase) {
+    const double virtual_offset_idx =
+        static_cast<double>(phase * kKernelOffsetCount) / phase_count_;
+    const size_t offset_idx = static_cast<size_t>(virtual_offset_idx);
+    const double kernel_interpolation_factor = virtual_offset_idx - offset_idx;
+    const float* const k1 = kernel_storage_.get() + offset_idx * kKernelSize;
+    const float* const k2 = k1 + kKernelSize;
+    float* const k = phase_kernel_storage_.get() + phase * kKernelSize;
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      k[i] = static_cast<float>((1.0 - kernel_interpolation_factor) * k1[i] +
+                                kernel_interpolation_factor * k2[i]);
+    }
+  }
+}
+
+bool SincResampler::SetFixedRatio(size_t source_frames,
+                                  size_t destination_frames) {
+  assert(source_frames > 0);
+  assert(destination_frames > 0);
+  SetRatio(static_cast<double>(source_frames) / destination_frames);
+
+  size_t a = source_frames;
+  size_t b = destination_frames;
+  while (b != 0) {
+    const size_t remainder = a % b;
+    a = b;
+    b = remainder;
+  }
+  const size_t phase_count = destination_frames / a;
+  if (phase_count > kMaxPhaseCount)
+    return false;
+
+  // Continue from the current position, which is on one of the phases unless
+  // the ratio changed in the middle of the stream.
+  phase_count_ = phase_count;
+  fixed_step_frames_ = source_frames / destination_frames;
+  fixed_step_phases_ = (source_frames / a) % phase_count_;
+  fixed_source_idx_ = static_cast<size_t>(virtual_source_idx_);
+  fixed_phase_ = static_cast<size_t>(
+      (virtual_source_idx_ - fixed_source_idx_) * phase_count_ + 0.5);
+  if (fixed_phase_ == phase_count_) {
+    fixed_phase_ = 0;
+    ++fixed_source_idx_;
+  }
+  InitializePhaseKernels();
+  return true;
+}
+
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
+  if (phase_count_) {
+    virtual_source_idx_ =
+        fixed_source_idx_ + static_cast<double>(fixed_phase_) / phase_count_;
+    phase_count_ = 0;
+  }
+
   if (fabs(io_sample_rate_ratio_ - io_sample_rate_ratio) <
       std::numeric_limits<double>::epsilon()) {
     return;
@@ -280,55 +359,86 @@ void SincResampler::Resample(size_t frames, float* destination) {
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
   const float* const kernel_ptr = kernel_storage_.get();
+  const float* const phase_kernel_ptr = phase_kernel_storage_.get();
   while (remaining_frames) {
-    // |i| may be negative if the last Resample() call ended on an iteration
-    // that put |virtual_source_idx_| over the limit.
-    //
-    // Note: The loop construct here can severely impact performance on ARM
-    // or when built with clang.  See https://codereview.chromium.org/18566009/
-    for (int i = static_cast<int>(
-             ceil((block_size_ - virtual_source_idx_) / current_io_ratio));
-         i > 0; --i) {
-      assert(virtual_source_idx_ < block_size_);
-
-      // |virtual_source_idx_| lies in between two kernel offsets so figure out
-      // what they are.
-      const int source_idx = static_cast<int>(virtual_source_idx_);
-      const double subsample_remainder = virtual_source_idx_ - source_idx;
-
-      const double virtual_offset_idx =
-          subsample_remainder * kKernelOffsetCount;
-      const int offset_idx = static_cast<int>(virtual_offset_idx);
-
-      // We'll compute "convolutions" for the two kernels which straddle
-      // |virtual_source_idx_|.
-      const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
-      const float* const k2 = k1 + kKernelSize;
-
-      // Ensure |k1|, |k2| are 16-byte aligned for SIMD usage.  Should always be
-      // true so long as kKernelSize is a multiple of 16.
-      assert(0u == (reinterpret_cast<uintptr_t>(k1) & 0x0F));
-      assert(0u == (reinterpret_cast<uintptr_t>(k2) & 0x0F));
-
-      // Initialize input pointer based on quantized |virtual_source_idx_|.
-      const float* const input_ptr = r1_ + source_idx;
-
-      // Figure out how much to weight each kernel's "convolution".
-      const double kernel_interpolation_factor =
-          virtual_offset_idx - offset_idx;
-      *destination++ = CONVOLVE_FUNC(
-          input_ptr, k1, k2, kernel_interpolation_factor);
-
-      // Advance the virtual index.
-      virtual_source_idx_ += current_io_ratio;
-
-      if (!--remaining_frames)
-        return;
+    if (phase_count_) {
+      // With a fixed ratio, each output frame takes a single convolution with
+      // the precomputed kernel of its phase.  The position may be past the
+      // end of the block, in the same way as |virtual_source_idx_| below.
+      const size_t block_end = block_size_ * phase_count_;
+      const size_t position = fixed_source_idx_ * phase_count_ + fixed_phase_;
+      const size_t step =
+          fixed_step_frames_ * phase_count_ + fixed_step_phases_;
+      for (size_t i = position < block_end ?
+               (block_end - position + step - 1) / step : 0;
+           i > 0; --i) {
+        assert(fixed_source_idx_ < block_size_);
+        const float* const k = phase_kernel_ptr + fixed_phase_ * kKernelSize;
+        assert(0u == (reinterpret_cast<uintptr_t>(k) & 0x0F));
+        *destination++ = CONVOLVE_SINGLE_FUNC(r1_ + fixed_source_idx_, k);
+
+        fixed_source_idx_ += fixed_step_frames_;
+        fixed_phase_ += fixed_step_phases_;
+        if (fixed_phase_ >= phase_count_) {
+          fixed_phase_ -= phase_count_;
+          ++fixed_source_idx_;
+        }
+
+        if (!--remaining_frames)
+          return;
+      }
+      fixed_source_idx_ -= block_size_;
+    } else {
+      // |i| may be negative if the last Resample() call ended on an iteration
+      // that put |virtual_source_idx_| over the limit.
+      //
+      // Note: The loop construct here can severely impact performance on ARM
+      // or when built with clang.  See
+      // https://codereview.chromium.org/18566009/
+      for (int i = static_cast<int>(
+               ceil((block_size_ - virtual_source_idx_) / current_io_ratio));
+           i > 0; --i) {
+        assert(virtual_source_idx_ < block_size_);
+
+        // |virtual_source_idx_| lies in between two kernel offsets so figure
+        // out what they are.
+        const int source_idx = static_cast<int>(virtual_source_idx_);
+        const double subsample_remainder = virtual_source_idx_ - source_idx;
+
+        const double virtual_offset_idx =
+            subsample_remainder * kKernelOffsetCount;
+        const int offset_idx = static_cast<int>(virtual_offset_idx);
+
+        // We'll compute "convolutions" for the two kernels which straddle
+        // |virtual_source_idx_|.
+        const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
+        const float* const k2 = k1 + kKernelSize;
+
+        // Ensure |k1|, |k2| are 16-byte aligned for SIMD usage.  Should always
+        // be true so long as kKernelSize is a multiple of 16.
+        assert(0u == (reinterpret_cast<uintptr_t>(k1) & 0x0F));
+        assert(0u == (reinterpret_cast<uintptr_t>(k2) & 0x0F));
+
+        // Initialize input pointer based on quantized |virtual_source_idx_|.
+        const float* const input_ptr = r1_ + source_idx;
+
+        // Figure out how much to weight each kernel's "convolution".
+        const double kernel_interpolation_factor =
+            virtual_offset_idx - offset_idx;
+        *destination++ = CONVOLVE_FUNC(
+            input_ptr, k1, k2, kernel_interpolation_factor);
+
+        // Advance the virtual index.
+        virtual_source_idx_ += current_io_ratio;
+
+        if (!--remaining_frames)
+          return;
+      }
+
+      // Wrap back around to the start.
+      virtual_source_idx_ -= block_size_;
     }
 
-    // Wrap back around to the start.
-    virtual_source_idx_ -= block_size_;
-
     // Step (3) -- Copy r3_, r4_ to r1_, r2_.
     // This wraps the last input frames back to the start of the buffer.
     memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
@@ -343,6 +453,7 @@ void SincResampler::Resample(size_t frames, float* destination) {
 }
 
 #undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_FUNC
 
 size_t SincResampler::ChunkSize() const {
   return static_cast<size_t>(block_size_ / io_sample_rate_ratio_);
@@ -350,6 +461,8 @@ size_t SincResampler::ChunkSize() const {
 
 void SincResampler::Flush() {
   virtual_source_idx_ = 0;
+  fixed_source_idx_ = 0;
+  fixed_phase_ = 0;
   buffer_primed_ = false;
   memset(input_buffer_.get(), 0,
          sizeof(*input_buffer_.get()) * input_buffer_size_);
@@ -375,4 +488,12 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       kernel_interpolation_factor * sum2);
 }
 
+float SincResampler::ConvolveSingle_C(const float* input_ptr, const float* k) {
+  float sum = 0;
+  size_t n = kKernelSize;
+  while (n--)
+    sum += *input_ptr++ * *k++;
+  return sum;
+}
+
 }  // namespace webrtc
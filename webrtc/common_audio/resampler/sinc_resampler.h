@@ -50,6 +50,9 @@ class SincResampler {
   static const size_t kKernelStorageSize =
       kKernelSize * (kKernelOffsetCount + 1);
 
+  // The maximum number of output phases of a fixed ratio, see SetFixedRatio().
+  static const size_t kMaxPhaseCount = kKernelOffsetCount;
+
   // Constructs a SincResampler with the specified |read_cb|, which is used to
   // acquire audio data for resampling.  |io_sample_rate_ratio| is the ratio
   // of input / output sample rates.  |request_frames| controls the size in
@@ -82,13 +85,25 @@ class SincResampler {
   // SincResampler.  We would also need a way to update |request_frames_|.
   void SetRatio(double io_sample_rate_ratio);
 
+  // Sets the ratio to exactly |source_frames| / |destination_frames|.  If the
+  // output then repeats the same sub-sample offsets every kMaxPhaseCount or
+  // fewer frames, e.g., one offset for 48 to 16 kHz or three for 16 to 48 kHz,
+  // a kernel is precomputed for each of these phases.  Every output frame then
+  // takes a single convolution rather than two interpolated ones, and the
+  // position is tracked exactly.  Returns false, keeping the interpolating
+  // kernels, for other ratios.  A later SetRatio() switches back.  Not thread
+  // safe, do not call while Resample() is in progress.
+  bool SetFixedRatio(size_t source_frames, size_t destination_frames);
+
   float* get_kernel_for_testing() { return kernel_storage_.get(); }
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveAVX2);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
 
   void InitializeKernel();
+  void InitializePhaseKernels();
   void UpdateRegions(bool second_load);
 
   // Selects runtime specific CPU features like SSE.  Must be called before
@@ -102,14 +117,23 @@ class SincResampler {
   // the underlying implementation is chosen at run time.
   static float Convolve_C(const float* input_ptr, const float* k1,
                           const float* k2, double kernel_interpolation_factor);
+  // Compute the convolution of the single kernel |k| over |input_ptr|.  Gives
+  // the same result as the above with |kernel_interpolation_factor| zero.
+  static float ConvolveSingle_C(const float* input_ptr, const float* k);
 #if defined(WEBRTC_ARCH_X86_FAMILY)
   static float Convolve_SSE(const float* input_ptr, const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float ConvolveSingle_SSE(const float* input_ptr, const float* k);
+  static float Convolve_AVX2(const float* input_ptr, const float* k1,
+                             const float* k2,
+                             double kernel_interpolation_factor);
+  static float ConvolveSingle_AVX2(const float* input_ptr, const float* k);
 #elif defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr, const float* k1,
                              const float* k2,
                              double kernel_interpolation_factor);
+  static float ConvolveSingle_NEON(const float* input_ptr, const float* k);
 #endif
 
   // The ratio of input / output sample rates.
@@ -119,6 +143,17 @@ class SincResampler {
   // double precision to avoid drift.
   double virtual_source_idx_;
 
+  // With a fixed ratio, the position is instead kept exactly as the source
+  // frame |fixed_source_idx_| plus |fixed_phase_| / |phase_count_|, and each
+  // output frame advances it by |fixed_step_frames_| plus
+  // |fixed_step_phases_| / |phase_count_|.  |phase_count_| is zero when the
+  // interpolating kernels are used.
+  size_t phase_count_;
+  size_t fixed_step_frames_;
+  size_t fixed_step_phases_;
+  size_t fixed_source_idx_;
+  size_t fixed_phase_;
+
   // The buffer is primed once at the very beginning of processing.
   bool buffer_primed_;
 
@@ -141,17 +176,25 @@ class SincResampler {
   rtc::scoped_ptr<float[], AlignedFreeDeleter> kernel_pre_sinc_storage_;
   rtc::scoped_ptr<float[], AlignedFreeDeleter> kernel_window_storage_;
 
+  // Contains |phase_count_| kernels back-to-back, each of size kKernelSize,
+  // interpolated from |kernel_storage_| for the sub-sample offsets of a fixed
+  // ratio.  Allocated by the first successful SetFixedRatio().
+  rtc::scoped_ptr<float[], AlignedFreeDeleter> phase_kernel_storage_;
+
   // Data from the source is copied into this buffer for each processing pass.
   rtc::scoped_ptr<float[], AlignedFreeDeleter> input_buffer_;
 
   // Stores the runtime selection of which Convolve function to use.
   // TODO(ajm): Move to using a global static which must only be initialized
   // once by the user. We're not doing this initially, because we don't have
-  // e.g. a LazyInstance helper in webrtc.
-#if defined(WEBRTC_CPU_DETECTION)
+  // e.g. a LazyInstance helper in webrtc.  On x86, AVX2 is always detected at
+  // run time.
+#if defined(WEBRTC_CPU_DETECTION) || defined(WEBRTC_ARCH_X86_FAMILY)
   typedef float (*ConvolveProc)(const float*, const float*, const float*,
                                 double);
+  typedef float (*ConvolveSingleProc)(const float*, const float*);
   ConvolveProc convolve_proc_;
+  ConvolveSingleProc convolve_single_proc_;
 #endif
 
   // Pointers to the various regions inside |input_buffer_|.  See the diagram at
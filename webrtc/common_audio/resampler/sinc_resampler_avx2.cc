@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// AVX2 versions of the convolutions, selected at run time.  The kernels are
+// 32-byte aligned while the input may be at any offset, so it is always read
+// with unaligned loads, which cost nothing extra on aligned data on CPUs with
+// AVX2.
+
+#include "webrtc/common_audio/resampler/sinc_resampler.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+// Sums the eight lanes of |m_sums|.
+float HorizontalSum(__m256 m_sums) {
+  __m128 m_quad = _mm_add_ps(_mm256_castps256_ps128(m_sums),
+                             _mm256_extractf128_ps(m_sums, 1));
+  m_quad = _mm_add_ps(_mm_movehl_ps(m_quad, m_quad), m_quad);
+  return _mm_cvtss_f32(
+      _mm_add_ss(m_quad, _mm_shuffle_ps(m_quad, m_quad, 1)));
+}
+
+}  // namespace
+
+float SincResampler::Convolve_AVX2(const float* input_ptr, const float* k1,
+                                   const float* k2,
+                                   double kernel_interpolation_factor) {
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+
+  for (size_t i = 0; i < kKernelSize; i += 8) {
+    const __m256 m_input = _mm256_loadu_ps(input_ptr + i);
+    m_sums1 = _mm256_add_ps(m_sums1,
+                            _mm256_mul_ps(m_input, _mm256_load_ps(k1 + i)));
+    m_sums2 = _mm256_add_ps(m_sums2,
+                            _mm256_mul_ps(m_input, _mm256_load_ps(k2 + i)));
+  }
+
+  // Linearly interpolate the two "convolutions".
+  m_sums1 = _mm256_mul_ps(m_sums1, _mm256_set1_ps(
+      static_cast<float>(1.0 - kernel_interpolation_factor)));
+  m_sums2 = _mm256_mul_ps(m_sums2, _mm256_set1_ps(
+      static_cast<float>(kernel_interpolation_factor)));
+  const float result = HorizontalSum(_mm256_add_ps(m_sums1, m_sums2));
+  _mm256_zeroupper();
+
+  return result;
+}
+
+float SincResampler::ConvolveSingle_AVX2(const float* input_ptr,
+                                         const float* k) {
+  __m256 m_sums = _mm256_setzero_ps();
+
+  for (size_t i = 0; i < kKernelSize; i += 8) {
+    m_sums = _mm256_add_ps(m_sums, _mm256_mul_ps(_mm256_loadu_ps(input_ptr + i),
+                                                 _mm256_load_ps(k + i)));
+  }
+  const float result = HorizontalSum(m_sums);
+  _mm256_zeroupper();
+
+  return result;
+}
+
+}  // namespace webrtc
@@ -117,8 +117,10 @@ TEST(SincResamplerTest, DISABLED_SetRatioBench) {
 // Define platform independent function name for Convolve* tests.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 #define CONVOLVE_FUNC Convolve_SSE
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_SSE
 #elif defined(WEBRTC_ARCH_ARM_V7)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_FUNC ConvolveSingle_NEON
 #endif
 
 // Ensure various optimized Convolve() methods return the same value.  Only run
@@ -159,6 +161,47 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+  // Test the single kernel convolution, which must match the above without
+  // interpolation exactly.
+  result = resampler.CONVOLVE_SINGLE_FUNC(
+      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get());
+  EXPECT_NEAR(result, resampler.ConvolveSingle_C(
+      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get()),
+      kEpsilon);
+  EXPECT_EQ(result, resampler.CONVOLVE_FUNC(
+      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+      resampler.kernel_storage_.get() + SincResampler::kKernelSize, 0.0));
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(SincResamplerTest, ConvolveAVX2) {
+  if (!WebRtc_GetCPUInfo(kAVX2)) {
+    printf("Skipping test, AVX2 is not supported.\n");
+    return;
+  }
+
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  static const double kEpsilon = 0.00000005;
+  const float* const kernel = resampler.kernel_storage_.get();
+
+  // Aligned and unaligned input.
+  for (size_t offset = 0; offset < 2; ++offset) {
+    EXPECT_NEAR(resampler.Convolve_C(kernel + offset, kernel, kernel,
+                                     kKernelInterpolationFactor),
+                resampler.Convolve_AVX2(kernel + offset, kernel, kernel,
+                                        kKernelInterpolationFactor),
+                kEpsilon);
+    const float result =
+        resampler.ConvolveSingle_AVX2(kernel + offset, kernel);
+    EXPECT_NEAR(resampler.ConvolveSingle_C(kernel + offset, kernel), result,
+                kEpsilon);
+    EXPECT_EQ(result, resampler.Convolve_AVX2(
+        kernel + offset, kernel, kernel + SincResampler::kKernelSize, 0.0));
+  }
 }
 #endif
 
@@ -226,6 +269,70 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
 }
 
 #undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_FUNC
+
+// Test that the fixed ratio path matches the interpolating one.  With at most
+// two phases, the phase kernels are stored kernels and the outputs are equal.
+// Otherwise, the interpolating path at times lands just below a whole source
+// frame, where it uses the kernels shifted by one frame, which are truncated
+// slightly differently.
+TEST(SincResamplerTest, FixedRatio) {
+  static const struct {
+    int input_rate;
+    int output_rate;
+    bool exact;
+  } kRates[] = {
+    {48000, 16000, true},
+    {48000, 8000, true},
+    {32000, 16000, true},
+    {48000, 32000, true},
+    {16000, 32000, true},
+    {16000, 48000, false},
+    {8000, 48000, false},
+    {32000, 48000, false},
+  };
+  static const size_t kOutputFrames = 4800;
+
+  for (const auto& rates : kRates) {
+    SCOPED_TRACE(rates.input_rate);
+    SCOPED_TRACE(rates.output_rate);
+    const size_t input_frames =
+        kOutputFrames * rates.input_rate / rates.output_rate;
+    const double io_ratio =
+        rates.input_rate / static_cast<double>(rates.output_rate);
+    SinusoidalLinearChirpSource source(rates.input_rate, input_frames,
+                                       0.5 * rates.input_rate, 0);
+    SinusoidalLinearChirpSource fixed_source(rates.input_rate, input_frames,
+                                             0.5 * rates.input_rate, 0);
+    SincResampler resampler(io_ratio, SincResampler::kDefaultRequestSize,
+                            &source);
+    SincResampler fixed_resampler(io_ratio, SincResampler::kDefaultRequestSize,
+                                  &fixed_source);
+    ASSERT_TRUE(fixed_resampler.SetFixedRatio(rates.input_rate / 100,
+                                              rates.output_rate / 100));
+
+    rtc::scoped_ptr<float[]> expected(new float[kOutputFrames]);
+    rtc::scoped_ptr<float[]> actual(new float[kOutputFrames]);
+    // Split the requests to also cover a position carried across calls.
+    resampler.Resample(kOutputFrames, expected.get());
+    fixed_resampler.Resample(kOutputFrames / 3, actual.get());
+    fixed_resampler.Resample(kOutputFrames - kOutputFrames / 3,
+                             actual.get() + kOutputFrames / 3);
+    for (size_t i = 0; i < kOutputFrames; ++i) {
+      if (rates.exact) {
+        ASSERT_EQ(expected[i], actual[i]) << i;
+      } else {
+        ASSERT_NEAR(expected[i], actual[i], 0.0005) << i;
+      }
+    }
+  }
+
+  // 44.1 kHz has too many phases to any of the other rates.
+  MockSource mock_source;
+  SincResampler resampler(441 / 480.0, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  EXPECT_FALSE(resampler.SetFixedRatio(441, 480));
+}
 
 typedef std::tr1::tuple<int, int, double, double> SincResamplerTestData;
 class SincResamplerTest
@@ -348,7 +455,7 @@ INSTANTIATE_TEST_CASE_P(
         std::tr1::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::tr1::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::tr1::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::tr1::make_tuple(48000, 44100, -15.01, -64.04),
         std::tr1::make_tuple(96000, 44100, -18.49, -25.51),
         std::tr1::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+// Reverses the order of the eight 16-bit lanes of |v|.
+static __m128i ReverseW16(__m128i v) {
+  v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+  return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. The products
+// are summed with wrap-around in 32 bits, like in WebRtcSpl_DownsampleFastC(),
+// so the result is bit-exact.
+int WebRtcSpl_DownsampleFastSse2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  int32_t out_s32 = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  for (i = delay; i < endpos; i += factor) {
+    __m128i sum = _mm_setzero_si128();
+
+    // Coefficients j to j + 7 apply to data_in[i - j - 7] to data_in[i - j],
+    // in reverse order.
+    for (j = 0; j + 8 <= coefficients_length; j += 8) {
+      const __m128i coef = _mm_loadu_si128((const __m128i*)&coefficients[j]);
+      const __m128i data = ReverseW16(
+          _mm_loadu_si128((const __m128i*)&data_in[i - j - 7]));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(coef, data));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    out_s32 = 2048 + _mm_cvtsi128_si32(sum);  // Round value, 0.5 in Q12.
+
+    for (; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
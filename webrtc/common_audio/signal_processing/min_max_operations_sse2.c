@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <assert.h>
+#include <emmintrin.h>
+
+// SSE2 versions of the min/max functions for x86 platforms. They give the
+// same results as the C versions in min_max_operations.c.
+
+// Returns the largest of the eight lanes of |v|.
+static int16_t HorizontalMaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// Returns the smallest of the eight lanes of |v|.
+static int16_t HorizontalMinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// SSE2 has no 32-bit min/max, so they are built from a compare and a select.
+static __m128i MaxW32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, a),
+                      _mm_andnot_si128(a_greater, b));
+}
+
+static __m128i MinW32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, b),
+                      _mm_andnot_si128(a_greater, a));
+}
+
+static int32_t HorizontalMaxW32(__m128i v) {
+  v = MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+static int32_t HorizontalMinW32(__m128i v) {
+  v = MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+// Finds both the maximum and the minimum value of a word16 vector.
+static void MaxMinW16(const int16_t* vector, size_t length,
+                      int16_t* maximum, int16_t* minimum) {
+  __m128i max_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  __m128i min_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  size_t i = 0;
+  int16_t max_value, min_value;
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_v = _mm_max_epi16(max_v, v);
+    min_v = _mm_min_epi16(min_v, v);
+  }
+  max_value = HorizontalMaxW16(max_v);
+  min_value = HorizontalMinW16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > max_value)
+      max_value = vector[i];
+    if (vector[i] < min_value)
+      min_value = vector[i];
+  }
+  *maximum = max_value;
+  *minimum = min_value;
+}
+
+// Finds both the maximum and the minimum value of a word32 vector.
+static void MaxMinW32(const int32_t* vector, size_t length,
+                      int32_t* maximum, int32_t* minimum) {
+  __m128i max_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  __m128i min_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  size_t i = 0;
+  int32_t max_value, min_value;
+
+  for (; i + 4 <= length; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_v = MaxW32(max_v, v);
+    min_v = MinW32(min_v, v);
+  }
+  max_value = HorizontalMaxW32(max_v);
+  min_value = HorizontalMinW32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > max_value)
+      max_value = vector[i];
+    if (vector[i] < min_value)
+      min_value = vector[i];
+  }
+  *maximum = max_value;
+  *minimum = min_value;
+}
+
+// The largest absolute value is the larger of the maximum and the negated
+// minimum, which avoids computing abs(-32768) in 16 bits.
+int16_t WebRtcSpl_MaxAbsValueW16Sse2(const int16_t* vector, size_t length) {
+  int16_t maximum, minimum;
+  int absolute;
+
+  assert(length > 0);
+
+  MaxMinW16(vector, length, &maximum, &minimum);
+  absolute = WEBRTC_SPL_MAX((int)maximum, -(int)minimum);
+
+  // Guard the case for abs(-32768).
+  return (int16_t)WEBRTC_SPL_MIN(absolute, WEBRTC_SPL_WORD16_MAX);
+}
+
+int32_t WebRtcSpl_MaxAbsValueW32Sse2(const int32_t* vector, size_t length) {
+  int32_t maximum, minimum;
+  int64_t absolute;
+
+  assert(length > 0);
+
+  MaxMinW32(vector, length, &maximum, &minimum);
+  absolute = WEBRTC_SPL_MAX((int64_t)maximum, -(int64_t)minimum);
+
+  // Guard the case for abs(-2147483648).
+  return (int32_t)WEBRTC_SPL_MIN(absolute, WEBRTC_SPL_WORD32_MAX);
+}
+
+int16_t WebRtcSpl_MaxValueW16Sse2(const int16_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  size_t i = 0;
+  int16_t maximum;
+
+  assert(length > 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm_max_epi16(max_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW16(max_v);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+int32_t WebRtcSpl_MaxValueW32Sse2(const int32_t* vector, size_t length) {
+  __m128i max_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  size_t i = 0;
+  int32_t maximum;
+
+  assert(length > 0);
+
+  for (; i + 4 <= length; i += 4) {
+    max_v = MaxW32(max_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  maximum = HorizontalMaxW32(max_v);
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+int16_t WebRtcSpl_MinValueW16Sse2(const int16_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  size_t i = 0;
+  int16_t minimum;
+
+  assert(length > 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm_min_epi16(min_v,
+                          _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinW16(min_v);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+int32_t WebRtcSpl_MinValueW32Sse2(const int32_t* vector, size_t length) {
+  __m128i min_v = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  size_t i = 0;
+  int32_t minimum;
+
+  assert(length > 0);
+
+  for (; i + 4 <= length; i += 4) {
+    min_v = MinW32(min_v, _mm_loadu_si128((const __m128i*)&vector[i]));
+  }
+  minimum = HorizontalMinW32(min_v);
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
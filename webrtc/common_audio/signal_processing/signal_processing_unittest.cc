@@ -10,6 +10,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 static const size_t kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -447,10 +448,10 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if (defined WEBRTC_DETECT_NEON) || (defined WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -459,6 +460,128 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The SSE2 version must be bit-exact with the C version, for all shifts and
+// for both sliding directions.
+TEST_F(SplTest, CrossCorrelationSse2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kSeqLength = 123;
+  const size_t kNumLags = 37;
+  int16_t seq1[kSeqLength];
+  int16_t seq2[kSeqLength + 2 * kNumLags];
+  uint32_t seed = 17;
+  for (size_t i = 0; i < kSeqLength; ++i) {
+    seq1[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) * 2 - 32768);
+  }
+  for (size_t i = 0; i < kSeqLength + 2 * kNumLags; ++i) {
+    seq2[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) * 2 - 32768);
+  }
+  // Include extreme values, where the products are largest.
+  seq1[0] = seq2[kNumLags] = WEBRTC_SPL_WORD16_MIN;
+  seq1[9] = seq2[kNumLags + 9] = WEBRTC_SPL_WORD16_MAX;
+
+  int32_t expected[kNumLags];
+  int32_t result[kNumLags];
+  for (int shift = 0; shift <= 8; ++shift) {
+    for (int step = -1; step <= 1; step += 2) {
+      for (size_t length = 1; length <= kSeqLength; length += 7) {
+        WebRtcSpl_CrossCorrelationC(expected, seq1, &seq2[kNumLags], length,
+                                    kNumLags, shift, step);
+        WebRtcSpl_CrossCorrelationSse2(result, seq1, &seq2[kNumLags], length,
+                                       kNumLags, shift, step);
+        for (size_t i = 0; i < kNumLags; ++i) {
+          ASSERT_EQ(expected[i], result[i])
+              << "shift = " << shift << ", step = " << step
+              << ", length = " << length << ", i = " << i;
+        }
+      }
+    }
+  }
+}
+
+// The SSE2 min/max versions must match the C versions for every length, so
+// that the extremes are found both in the vector loop and in the tail.
+TEST_F(SplTest, MinMaxSse2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kMaxLength = 41;
+  int16_t vector16[kMaxLength];
+  int32_t vector32[kMaxLength];
+  uint32_t seed = 5;
+  for (int extreme = 0; extreme < 3; ++extreme) {
+    for (size_t i = 0; i < kMaxLength; ++i) {
+      vector16[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) * 2 - 32768);
+      vector32[i] = vector16[i] * 65536 + WebRtcSpl_RandU(&seed);
+    }
+    // Put the smallest values in the vector loop and in the tail. The C
+    // version takes abs() of the 32-bit values, which is undefined for
+    // WEBRTC_SPL_WORD32_MIN, so one above it is used.
+    if (extreme == 1) {
+      vector16[3] = WEBRTC_SPL_WORD16_MIN;
+      vector32[3] = WEBRTC_SPL_WORD32_MIN + 1;
+    } else if (extreme == 2) {
+      vector16[kMaxLength - 1] = WEBRTC_SPL_WORD16_MIN;
+      vector32[kMaxLength - 1] = WEBRTC_SPL_WORD32_MIN + 1;
+    }
+    for (size_t length = 1; length <= kMaxLength; ++length) {
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector16, length),
+                WebRtcSpl_MaxAbsValueW16Sse2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(vector32, length),
+                WebRtcSpl_MaxAbsValueW32Sse2(vector32, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(vector16, length),
+                WebRtcSpl_MaxValueW16Sse2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(vector32, length),
+                WebRtcSpl_MaxValueW32Sse2(vector32, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(vector16, length),
+                WebRtcSpl_MinValueW16Sse2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(vector32, length),
+                WebRtcSpl_MinValueW32Sse2(vector32, length));
+    }
+  }
+}
+
+TEST_F(SplTest, DownsampleFastSse2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kDataLength = 200;
+  const size_t kMaxCoefficients = 21;
+  int16_t data_in[kDataLength];
+  int16_t coefficients[kMaxCoefficients];
+  int16_t expected[kDataLength];
+  int16_t result[kDataLength];
+  uint32_t seed = 11;
+  for (size_t i = 0; i < kDataLength; ++i) {
+    data_in[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) * 2 - 32768);
+  }
+  for (size_t i = 0; i < kMaxCoefficients; ++i) {
+    coefficients[i] = static_cast<int16_t>(WebRtcSpl_RandU(&seed) - 16384);
+  }
+  // Include the extreme product.
+  data_in[kMaxCoefficients] = WEBRTC_SPL_WORD16_MIN;
+  coefficients[1] = WEBRTC_SPL_WORD16_MIN;
+
+  for (size_t num_coefficients = 1; num_coefficients <= kMaxCoefficients;
+       ++num_coefficients) {
+    for (int factor = 1; factor <= 3; ++factor) {
+      const size_t delay = num_coefficients - 1;
+      const size_t out_length = (kDataLength - delay - 1) / factor + 1;
+      ASSERT_EQ(0, WebRtcSpl_DownsampleFastC(
+          data_in, kDataLength, expected, out_length, coefficients,
+          num_coefficients, factor, delay));
+      ASSERT_EQ(0, WebRtcSpl_DownsampleFastSse2(
+          data_in, kDataLength, result, out_length, coefficients,
+          num_coefficients, factor, delay));
+      for (size_t i = 0; i < out_length; ++i) {
+        ASSERT_EQ(expected[i], result[i])
+            << "coefficients = " << num_coefficients
+            << ", factor = " << factor << ", i = " << i;
+      }
+    }
+  }
+}
+#endif
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -42,6 +42,18 @@ static void InitPointersToC() {
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16Sse2;
+    WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32Sse2;
+    WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16Sse2;
+    WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32Sse2;
+    WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16Sse2;
+    WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32Sse2;
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSse2;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSse2;
+  }
+#endif
 }
 #endif
 
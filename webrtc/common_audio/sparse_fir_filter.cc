@@ -10,7 +10,10 @@
 
 #include "webrtc/common_audio/sparse_fir_filter.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
@@ -21,39 +24,68 @@ SparseFIRFilter::SparseFIRFilter(const float* nonzero_coeffs,
     : sparsity_(sparsity),
       offset_(offset),
       nonzero_coeffs_(nonzero_coeffs, nonzero_coeffs + num_nonzero_coeffs),
-      state_(sparsity_ * (num_nonzero_coeffs - 1) + offset_, 0.f) {
+      state_length_(sparsity_ * (num_nonzero_coeffs - 1) + offset_),
+      history_(state_length_, 0.f) {
   RTC_CHECK_GE(num_nonzero_coeffs, 1u);
   RTC_CHECK_GE(sparsity, 1u);
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// AVX2 always has to be detected at run time.
+#if defined(__SSE2__)
+  filter_proc_ = WebRtc_GetCPUInfo(kAVX2) ? Filter_AVX2 : Filter_SSE;
+#else
+  if (WebRtc_GetCPUInfo(kAVX2))
+    filter_proc_ = Filter_AVX2;
+  else
+    filter_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Filter_SSE : Filter_C;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  filter_proc_ = Filter_NEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  filter_proc_ = WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON ? Filter_NEON
+                                                               : Filter_C;
+#else
+  filter_proc_ = Filter_C;
+#endif
+}
+
+void SparseFIRFilter::Reset() {
+  std::fill(history_.begin(), history_.begin() + state_length_, 0.f);
 }
 
 void SparseFIRFilter::Filter(const float* in, size_t length, float* out) {
+  if (history_.size() < state_length_ + length) {
+    history_.resize(state_length_ + length);
+  }
+  std::memcpy(&history_[state_length_], in, length * sizeof(*in));
+
   // Convolves the input signal |in| with the filter kernel |nonzero_coeffs_|
   // taking into account the previous state.
-  for (size_t i = 0; i < length; ++i) {
-    out[i] = 0.f;
-    size_t j;
-    for (j = 0; i >= j * sparsity_ + offset_ &&
-                j < nonzero_coeffs_.size(); ++j) {
-      out[i] += in[i - j * sparsity_ - offset_] * nonzero_coeffs_[j];
-    }
-    for (; j < nonzero_coeffs_.size(); ++j) {
-      out[i] += state_[i + (nonzero_coeffs_.size() - j - 1) * sparsity_] *
-                nonzero_coeffs_[j];
-    }
-  }
+  filter_proc_(&history_[0], &nonzero_coeffs_[0], nonzero_coeffs_.size(),
+               sparsity_, length, out);
 
   // Update current state.
-  if (state_.size() > 0u) {
-    if (length >= state_.size()) {
-      std::memcpy(&state_[0],
-                  &in[length - state_.size()],
-                  state_.size() * sizeof(*in));
-    } else {
-      std::memmove(&state_[0],
-                   &state_[length],
-                   (state_.size() - length) * sizeof(state_[0]));
-      std::memcpy(&state_[state_.size() - length], in, length * sizeof(*in));
+  if (state_length_ > 0u) {
+    std::memmove(&history_[0], &history_[length],
+                 state_length_ * sizeof(history_[0]));
+  }
+}
+
+void SparseFIRFilter::Filter_C(const float* history,
+                               const float* nonzero_coeffs,
+                               size_t num_nonzero_coeffs,
+                               size_t sparsity,
+                               size_t length,
+                               float* out) {
+  // |history[i + state_length]| is the current input sample, so coefficient
+  // |j| applies to |history[i + (num_nonzero_coeffs - j - 1) * sparsity]|.
+  for (size_t i = 0; i < length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < num_nonzero_coeffs; ++j) {
+      sum += history[i + (num_nonzero_coeffs - j - 1) * sparsity] *
+             nonzero_coeffs[j];
     }
+    out[i] = sum;
   }
 }
 
@@ -15,6 +15,8 @@
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
+#include "webrtc/typedefs.h"
 
 namespace webrtc {
 
@@ -38,11 +40,59 @@ class SparseFIRFilter final {
   // |out| must be previously allocated and it must be at least of |length|.
   void Filter(const float* in, size_t length, float* out);
 
+  // Resets the state to zeros, as after construction.
+  void Reset();
+
  private:
+  FRIEND_TEST_ALL_PREFIXES(SparseFIRFilterTest, OptimizedFilterIsBitExact);
+  FRIEND_TEST_ALL_PREFIXES(SparseFIRFilterTest, AVX2FilterIsBitExact);
+
+  // Computes |length| output samples from |history|, which holds the filter
+  // state followed by the input. The coefficients are accumulated in the same
+  // order by all versions, so they give bit-exact results. On x86 and ARM the
+  // underlying implementation is chosen at run time.
+  typedef void (*FilterProc)(const float* history,
+                             const float* nonzero_coeffs,
+                             size_t num_nonzero_coeffs,
+                             size_t sparsity,
+                             size_t length,
+                             float* out);
+  static void Filter_C(const float* history,
+                       const float* nonzero_coeffs,
+                       size_t num_nonzero_coeffs,
+                       size_t sparsity,
+                       size_t length,
+                       float* out);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void Filter_SSE(const float* history,
+                         const float* nonzero_coeffs,
+                         size_t num_nonzero_coeffs,
+                         size_t sparsity,
+                         size_t length,
+                         float* out);
+  static void Filter_AVX2(const float* history,
+                          const float* nonzero_coeffs,
+                          size_t num_nonzero_coeffs,
+                          size_t sparsity,
+                          size_t length,
+                          float* out);
+#elif defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
+  static void Filter_NEON(const float* history,
+                          const float* nonzero_coeffs,
+                          size_t num_nonzero_coeffs,
+                          size_t sparsity,
+                          size_t length,
+                          float* out);
+#endif
+
   const size_t sparsity_;
   const size_t offset_;
   const std::vector<float> nonzero_coeffs_;
-  std::vector<float> state_;
+  const size_t state_length_;
+  // The last |state_length_| input samples, followed by room for the input of
+  // the current call.
+  std::vector<float> history_;
+  FilterProc filter_proc_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(SparseFIRFilter);
 };
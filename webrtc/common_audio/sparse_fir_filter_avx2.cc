@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/sparse_fir_filter.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+// Computes eight output samples at a time, with the same per-lane
+// accumulation order as Filter_C() and Filter_SSE() and no fused
+// multiply-add, so the result is bit-exact.
+void SparseFIRFilter::Filter_AVX2(const float* history,
+                                  const float* nonzero_coeffs,
+                                  size_t num_nonzero_coeffs,
+                                  size_t sparsity,
+                                  size_t length,
+                                  float* out) {
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    __m256 m_sum = _mm256_setzero_ps();
+    for (size_t j = 0; j < num_nonzero_coeffs; ++j) {
+      const __m256 m_in = _mm256_loadu_ps(
+          &history[i + (num_nonzero_coeffs - j - 1) * sparsity]);
+      m_sum = _mm256_add_ps(
+          m_sum, _mm256_mul_ps(m_in, _mm256_set1_ps(nonzero_coeffs[j])));
+    }
+    _mm256_storeu_ps(&out[i], m_sum);
+  }
+  _mm256_zeroupper();
+
+  // Fewer than eight samples left.
+  Filter_SSE(&history[i], nonzero_coeffs, num_nonzero_coeffs, sparsity,
+             length - i, &out[i]);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/sparse_fir_filter.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+// Computes four output samples at a time. Each lane accumulates the products
+// in the same order as Filter_C(). The multiplications and additions are kept
+// separate, rather than using vmlaq_f32(), so the result is bit-exact.
+void SparseFIRFilter::Filter_NEON(const float* history,
+                                  const float* nonzero_coeffs,
+                                  size_t num_nonzero_coeffs,
+                                  size_t sparsity,
+                                  size_t length,
+                                  float* out) {
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    float32x4_t sum = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < num_nonzero_coeffs; ++j) {
+      const float32x4_t in =
+          vld1q_f32(&history[i + (num_nonzero_coeffs - j - 1) * sparsity]);
+      sum = vaddq_f32(sum, vmulq_n_f32(in, nonzero_coeffs[j]));
+    }
+    vst1q_f32(&out[i], sum);
+  }
+
+  // Scalar tail.
+  Filter_C(&history[i], nonzero_coeffs, num_nonzero_coeffs, sparsity,
+           length - i, &out[i]);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/sparse_fir_filter.h"
+
+#include <xmmintrin.h>
+
+namespace webrtc {
+
+// Computes four output samples at a time. Each lane accumulates the products
+// in the same order as Filter_C(), and no fused multiply-add is used, so the
+// result is bit-exact.
+void SparseFIRFilter::Filter_SSE(const float* history,
+                                 const float* nonzero_coeffs,
+                                 size_t num_nonzero_coeffs,
+                                 size_t sparsity,
+                                 size_t length,
+                                 float* out) {
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    __m128 m_sum = _mm_setzero_ps();
+    for (size_t j = 0; j < num_nonzero_coeffs; ++j) {
+      const __m128 m_in = _mm_loadu_ps(
+          &history[i + (num_nonzero_coeffs - j - 1) * sparsity]);
+      m_sum = _mm_add_ps(m_sum,
+                         _mm_mul_ps(m_in, _mm_set1_ps(nonzero_coeffs[j])));
+    }
+    _mm_storeu_ps(&out[i], m_sum);
+  }
+
+  // Scalar tail.
+  Filter_C(&history[i], nonzero_coeffs, num_nonzero_coeffs, sparsity,
+           length - i, &out[i]);
+}
+
+}  // namespace webrtc
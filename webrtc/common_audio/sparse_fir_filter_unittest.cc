@@ -10,10 +10,13 @@
 
 #include "webrtc/common_audio/sparse_fir_filter.h"
 
+#include <stdio.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/arraysize.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/fir_filter.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 namespace {
@@ -228,4 +231,62 @@ TEST(SparseFIRFilterTest, SameOutputAsFIRFilterWhenSparsityOneAndOffsetZero) {
   }
 }
 
+// Define platform independent function name for the optimized filter test.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#define FILTER_FUNC Filter_SSE
+#elif defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
+#define FILTER_FUNC Filter_NEON
+#endif
+
+#if defined(FILTER_FUNC)
+TEST(SparseFIRFilterTest, OptimizedFilterIsBitExact) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  ASSERT_TRUE(WebRtc_GetCPUInfo(kSSE2));
+#elif defined(WEBRTC_DETECT_NEON)
+  ASSERT_TRUE(WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON);
+#endif
+  const size_t kSparsity = 4;
+  // Odd length to also cover the scalar tail.
+  const size_t kLength = 39;
+  const size_t kHistoryLength =
+      kSparsity * (arraysize(kCoeffs) - 1) + kLength;
+  float history[kHistoryLength];
+  for (size_t i = 0; i < kHistoryLength; ++i) {
+    history[i] = 1.f / (i + 1.f) - 0.3f;
+  }
+  float output_c[kLength];
+  float output_optimized[kLength];
+  SparseFIRFilter::Filter_C(history, kCoeffs, arraysize(kCoeffs), kSparsity,
+                            kLength, output_c);
+  SparseFIRFilter::FILTER_FUNC(history, kCoeffs, arraysize(kCoeffs), kSparsity,
+                               kLength, output_optimized);
+  VerifyOutput(output_c, output_optimized);
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(SparseFIRFilterTest, AVX2FilterIsBitExact) {
+  if (!WebRtc_GetCPUInfo(kAVX2)) {
+    printf("Skipping test, AVX2 is not supported.\n");
+    return;
+  }
+  const size_t kSparsity = 3;
+  // Not a multiple of eight or four, to also cover both tails.
+  const size_t kLength = 47;
+  const size_t kHistoryLength =
+      kSparsity * (arraysize(kCoeffs) - 1) + kLength;
+  float history[kHistoryLength];
+  for (size_t i = 0; i < kHistoryLength; ++i) {
+    history[i] = 1.f / (i + 1.f) - 0.3f;
+  }
+  float output_c[kLength];
+  float output_avx2[kLength];
+  SparseFIRFilter::Filter_C(history, kCoeffs, arraysize(kCoeffs), kSparsity,
+                            kLength, output_c);
+  SparseFIRFilter::Filter_AVX2(history, kCoeffs, arraysize(kCoeffs), kSparsity,
+                               kLength, output_avx2);
+  VerifyOutput(output_c, output_avx2);
+}
+#endif
+
 }  // namespace webrtc
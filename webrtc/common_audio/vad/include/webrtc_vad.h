@@ -70,6 +70,30 @@ int WebRtcVad_set_mode(VadInst* handle, int mode);
 int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
                       size_t frame_length);
 
+// Calculates VAD decisions for one frame from each of |num_streams| streams,
+// e.g. all participants of a conference, in one call. All frames must have the
+// same sampling frequency and length, which are only validated once.
+//
+// - handles       [i/o] : VAD instances, one per stream. Each needs to be
+//                         initialized by WebRtcVad_Init() before call.
+// - num_streams   [i]   : Number of streams.
+// - fs            [i]   : Sampling frequency (Hz): 8000, 16000, or 32000
+// - audio_frames  [i]   : One audio frame buffer per stream.
+// - frame_length  [i]   : Length of each audio frame buffer in number of
+//                         samples.
+// - vad_decisions [o]   : The decision for each stream, as returned by
+//                         WebRtcVad_Process().
+//
+// returns               :  0 - (OK, the decisions have been written),
+//                         -1 - (NULL pointer, or invalid |fs| and
+//                               |frame_length| combination)
+int WebRtcVad_ProcessMultiple(VadInst* const* handles,
+                              size_t num_streams,
+                              int fs,
+                              const int16_t* const* audio_frames,
+                              size_t frame_length,
+                              int* vad_decisions);
+
 // Checks for valid combinations of |rate| and |frame_length|. We support 10,
 // 20 and 30 ms frames and the rates 8000, 16000 and 32000 Hz.
 //
@@ -151,6 +151,60 @@ TEST_F(VadTest, ValidRatesFrameLengths) {
   }
 }
 
+TEST_F(VadTest, ProcessMultipleMatchesProcess) {
+  const size_t kNumStreams = 3;
+  const int kRate = 16000;
+  const size_t kFrameLength = 160;
+  int16_t zeros[kFrameLength] = { 0 };
+  int16_t speech[kFrameLength];
+  for (size_t i = 0; i < kFrameLength; i++) {
+    speech[i] = static_cast<int16_t>(i * i);
+  }
+  const int16_t* frames[kNumStreams] = { speech, zeros, speech };
+
+  VadInst* handles[kNumStreams];
+  VadInst* reference_handles[kNumStreams];
+  for (size_t i = 0; i < kNumStreams; i++) {
+    handles[i] = WebRtcVad_Create();
+    reference_handles[i] = WebRtcVad_Create();
+    ASSERT_EQ(0, WebRtcVad_Init(handles[i]));
+    ASSERT_EQ(0, WebRtcVad_Init(reference_handles[i]));
+  }
+
+  int decisions[kNumStreams];
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, kNumStreams, 9999, frames,
+                                          kFrameLength, decisions));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(handles, kNumStreams, kRate, frames,
+                                          kFrameLength + 1, decisions));
+  EXPECT_EQ(-1, WebRtcVad_ProcessMultiple(nullptr, kNumStreams, kRate, frames,
+                                          kFrameLength, decisions));
+
+  // Run a few frames, so that the decisions depend on each instance's state.
+  for (int frame = 0; frame < 10; frame++) {
+    ASSERT_EQ(0, WebRtcVad_ProcessMultiple(handles, kNumStreams, kRate, frames,
+                                           kFrameLength, decisions));
+    for (size_t i = 0; i < kNumStreams; i++) {
+      EXPECT_EQ(WebRtcVad_Process(reference_handles[i], kRate, frames[i],
+                                  kFrameLength),
+                decisions[i]);
+    }
+  }
+  EXPECT_EQ(1, decisions[0]);
+  EXPECT_EQ(0, decisions[1]);
+
+  // A stream without a frame gets an error without affecting the others.
+  frames[1] = nullptr;
+  ASSERT_EQ(0, WebRtcVad_ProcessMultiple(handles, kNumStreams, kRate, frames,
+                                         kFrameLength, decisions));
+  EXPECT_EQ(-1, decisions[1]);
+  EXPECT_EQ(1, decisions[2]);
+
+  for (size_t i = 0; i < kNumStreams; i++) {
+    WebRtcVad_Free(handles[i]);
+    WebRtcVad_Free(reference_handles[i]);
+  }
+}
+
 // TODO(bjornv): Add a process test, run on file.
 
 }  // namespace
@@ -55,8 +55,11 @@ int WebRtcVad_set_mode(VadInst* handle, int mode) {
   return WebRtcVad_set_mode_core(self, mode);
 }
 
-int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
-                      size_t frame_length) {
+// Calculates the VAD decision for a frame whose rate and length have already
+// been validated.
+static int ProcessValidFrame(VadInst* handle, int fs,
+                             const int16_t* audio_frame,
+                             size_t frame_length) {
   int vad = -1;
   VadInstT* self = (VadInstT*) handle;
 
@@ -70,9 +73,6 @@ int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
   if (audio_frame == NULL) {
     return -1;
   }
-  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
-    return -1;
-  }
 
   if (fs == 48000) {
       vad = WebRtcVad_CalcVad48khz(self, audio_frame, frame_length);
@@ -90,6 +90,37 @@ int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
   return vad;
 }
 
+int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
+                      size_t frame_length) {
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+
+  return ProcessValidFrame(handle, fs, audio_frame, frame_length);
+}
+
+int WebRtcVad_ProcessMultiple(VadInst* const* handles,
+                              size_t num_streams,
+                              int fs,
+                              const int16_t* const* audio_frames,
+                              size_t frame_length,
+                              int* vad_decisions) {
+  size_t i;
+
+  if (handles == NULL || audio_frames == NULL || vad_decisions == NULL) {
+    return -1;
+  }
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+
+  for (i = 0; i < num_streams; i++) {
+    vad_decisions[i] = ProcessValidFrame(handles[i], fs, audio_frames[i],
+                                         frame_length);
+  }
+  return 0;
+}
+
 int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length) {
   int return_value = -1;
   size_t i;
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 #include <sstream>
 
@@ -20,11 +21,18 @@
 #include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/common_audio/wav_header.h"
 
+#if defined(WEBRTC_POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace webrtc {
 
 // We write 16-bit PCM WAV files.
 static const WavFormat kWavFormat = kWavFormatPcm;
 static const size_t kBytesPerSample = 2;
+// Number of samples WavWriter collects before writing them, 256 KiB.
+static const size_t kWriteBufferSamples = 128 * 1024;
 
 // Doesn't take ownership of the file handle and won't close it.
 class ReadableWavFile : public ReadableWav {
@@ -47,7 +55,10 @@ std::string WavFile::FormatAsString() const {
 }
 
 WavReader::WavReader(const std::string& filename)
-    : file_handle_(fopen(filename.c_str(), "rb")) {
+    : file_handle_(fopen(filename.c_str(), "rb")),
+      mapped_file_(NULL),
+      mapped_size_(0),
+      mapped_samples_(NULL) {
   RTC_CHECK(file_handle_) << "Could not open wav file for reading.";
 
   ReadableWavFile readable(file_handle_);
@@ -58,18 +69,56 @@ WavReader::WavReader(const std::string& filename)
   num_samples_remaining_ = num_samples_;
   RTC_CHECK_EQ(kWavFormat, format);
   RTC_CHECK_EQ(kBytesPerSample, bytes_per_sample);
+  MapFile();
 }
 
 WavReader::~WavReader() {
   Close();
 }
 
+bool WavReader::MapFile() {
+#if defined(WEBRTC_POSIX)
+  const long data_offset = ftell(file_handle_);
+  struct stat file_stat;
+  if (data_offset < 0 || fstat(fileno(file_handle_), &file_stat) != 0 ||
+      file_stat.st_size <= data_offset ||
+      static_cast<uint64_t>(file_stat.st_size) >
+          std::numeric_limits<size_t>::max()) {
+    return false;
+  }
+  void* mapped = mmap(NULL, static_cast<size_t>(file_stat.st_size), PROT_READ,
+                      MAP_PRIVATE, fileno(file_handle_), 0);
+  if (mapped == MAP_FAILED)
+    return false;
+  // The file is read front to back, once.
+  madvise(mapped, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+  mapped_file_ = mapped;
+  mapped_size_ = static_cast<size_t>(file_stat.st_size);
+  mapped_samples_ = reinterpret_cast<const int16_t*>(
+      static_cast<const uint8_t*>(mapped) + data_offset);
+  // A file cut short holds fewer samples than its header says; read up to
+  // the end of the file, like fread() would.
+  const size_t samples_in_file =
+      (mapped_size_ - data_offset) / kBytesPerSample;
+  num_samples_remaining_ = std::min(num_samples_remaining_, samples_in_file);
+  return true;
+#else
+  return false;
+#endif
+}
+
 size_t WavReader::ReadSamples(size_t num_samples, int16_t* samples) {
 #ifndef WEBRTC_ARCH_LITTLE_ENDIAN
 #error "Need to convert samples to big-endian when reading from WAV file"
 #endif
   // There could be metadata after the audio; ensure we don't read it.
   num_samples = std::min(num_samples, num_samples_remaining_);
+  if (mapped_file_) {
+    memcpy(samples, mapped_samples_, num_samples * sizeof(*samples));
+    mapped_samples_ += num_samples;
+    num_samples_remaining_ -= num_samples;
+    return num_samples;
+  }
   const size_t read =
       fread(samples, sizeof(*samples), num_samples, file_handle_);
   // If we didn't read what was requested, ensure we've reached the EOF.
@@ -80,20 +129,34 @@ size_t WavReader::ReadSamples(size_t num_samples, int16_t* samples) {
 }
 
 size_t WavReader::ReadSamples(size_t num_samples, float* samples) {
+  if (mapped_file_) {
+    // Convert straight from the mapping, without a copy in between.
+    num_samples = std::min(num_samples, num_samples_remaining_);
+    S16ToFloatS16(mapped_samples_, num_samples, samples);
+    mapped_samples_ += num_samples;
+    num_samples_remaining_ -= num_samples;
+    return num_samples;
+  }
   static const size_t kChunksize = 4096 / sizeof(uint16_t);
   size_t read = 0;
   for (size_t i = 0; i < num_samples; i += kChunksize) {
     int16_t isamples[kChunksize];
     size_t chunk = std::min(kChunksize, num_samples - i);
     chunk = ReadSamples(chunk, isamples);
-    for (size_t j = 0; j < chunk; ++j)
-      samples[i + j] = isamples[j];
+    S16ToFloatS16(isamples, chunk, samples + i);
     read += chunk;
+    if (chunk < std::min(kChunksize, num_samples - i))
+      break;
   }
   return read;
 }
 
 void WavReader::Close() {
+#if defined(WEBRTC_POSIX)
+  if (mapped_file_)
+    RTC_CHECK_EQ(0, munmap(mapped_file_, mapped_size_));
+#endif
+  mapped_file_ = NULL;
   RTC_CHECK_EQ(0, fclose(file_handle_));
   file_handle_ = NULL;
 }
@@ -103,7 +166,9 @@ WavWriter::WavWriter(const std::string& filename, int sample_rate,
     : sample_rate_(sample_rate),
       num_channels_(num_channels),
       num_samples_(0),
-      file_handle_(fopen(filename.c_str(), "wb")) {
+      file_handle_(fopen(filename.c_str(), "wb")),
+      buffer_(new int16_t[kWriteBufferSamples]),
+      buffered_samples_(0) {
   RTC_CHECK(file_handle_) << "Could not open wav file for writing.";
   RTC_CHECK(CheckWavParameters(num_channels_, sample_rate_, kWavFormat,
                                kBytesPerSample, num_samples_));
@@ -122,24 +187,49 @@ void WavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
 #ifndef WEBRTC_ARCH_LITTLE_ENDIAN
 #error "Need to convert samples to little-endian when writing to WAV file"
 #endif
+  num_samples_ += num_samples;
+  RTC_CHECK(num_samples_ >= num_samples);  // detect size_t overflow
+  if (buffered_samples_ + num_samples <= kWriteBufferSamples) {
+    memcpy(&buffer_[buffered_samples_], samples,
+           num_samples * sizeof(*samples));
+    buffered_samples_ += num_samples;
+    return;
+  }
+  // Too large to buffer; write it directly, after what is already buffered.
+  Flush();
   const size_t written =
       fwrite(samples, sizeof(*samples), num_samples, file_handle_);
   RTC_CHECK_EQ(num_samples, written);
-  num_samples_ += written;
-  RTC_CHECK(num_samples_ >= written);  // detect size_t overflow
 }
 
 void WavWriter::WriteSamples(const float* samples, size_t num_samples) {
-  static const size_t kChunksize = 4096 / sizeof(uint16_t);
-  for (size_t i = 0; i < num_samples; i += kChunksize) {
-    int16_t isamples[kChunksize];
-    const size_t chunk = std::min(kChunksize, num_samples - i);
-    FloatS16ToS16(samples + i, chunk, isamples);
-    WriteSamples(isamples, chunk);
+  num_samples_ += num_samples;
+  RTC_CHECK(num_samples_ >= num_samples);  // detect size_t overflow
+  // Convert straight into the buffer.
+  while (num_samples > 0) {
+    if (buffered_samples_ == kWriteBufferSamples)
+      Flush();
+    const size_t chunk =
+        std::min(num_samples, kWriteBufferSamples - buffered_samples_);
+    FloatS16ToS16(samples, chunk, &buffer_[buffered_samples_]);
+    buffered_samples_ += chunk;
+    samples += chunk;
+    num_samples -= chunk;
   }
 }
 
+void WavWriter::Flush() {
+  if (buffered_samples_ == 0)
+    return;
+  const size_t written =
+      fwrite(buffer_.get(), sizeof(buffer_[0]), buffered_samples_,
+             file_handle_);
+  RTC_CHECK_EQ(buffered_samples_, written);
+  buffered_samples_ = 0;
+}
+
 void WavWriter::Close() {
+  Flush();
   RTC_CHECK_EQ(0, fseek(file_handle_, 0, SEEK_SET));
   uint8_t header[kWavHeaderSize];
   WriteWavHeader(header, num_channels_, sample_rate_, kWavFormat,
@@ -18,6 +18,7 @@
 #include <string>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
 
 namespace webrtc {
 
@@ -36,6 +37,7 @@ class WavFile {
 
 // Simple C++ class for writing 16-bit PCM WAV files. All error handling is
 // by calls to RTC_CHECK(), making it unsuitable for anything but debug code.
+// Samples are collected in a buffer and written in large blocks.
 class WavWriter final : public WavFile {
  public:
   // Open a new WAV file for writing.
@@ -56,15 +58,21 @@ class WavWriter final : public WavFile {
 
  private:
   void Close();
+  // Writes the buffered samples to the file.
+  void Flush();
   const int sample_rate_;
   const size_t num_channels_;
   size_t num_samples_;  // Total number of samples written to file.
   FILE* file_handle_;  // Output file, owned by this class
+  const rtc::scoped_ptr<int16_t[]> buffer_;
+  size_t buffered_samples_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(WavWriter);
 };
 
-// Follows the conventions of WavWriter.
+// Follows the conventions of WavWriter. Where supported, the file is mapped
+// into memory, so that reading is a copy or conversion straight out of the
+// page cache.
 class WavReader final : public WavFile {
  public:
   // Opens an existing WAV file for reading.
@@ -84,11 +92,18 @@ class WavReader final : public WavFile {
 
  private:
   void Close();
+  // Maps the file, if supported, and returns true on success.
+  bool MapFile();
   int sample_rate_;
   size_t num_channels_;
   size_t num_samples_;  // Total number of samples in the file.
   size_t num_samples_remaining_;
   FILE* file_handle_;  // Input file, owned by this class.
+  // The mapped file, or NULL if it is read with fread().
+  void* mapped_file_;
+  size_t mapped_size_;
+  // The next sample to read, in |mapped_file_|.
+  const int16_t* mapped_samples_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(WavReader);
 };
@@ -11,8 +11,10 @@
 // MSVC++ requires this to be set before any other includes to get M_PI.
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/wav_header.h"
@@ -174,4 +176,54 @@ TEST(WavWriterTest, LargeFile) {
   }
 }
 
+// Write more samples than WavWriter buffers, in pieces of different sizes, and
+// read them back in pieces that don't line up with them.
+TEST(WavWriterTest, LargerThanWriteBuffer) {
+  std::string outfile = test::OutputPath() + "wavtest4.wav";
+  static const int kSampleRate = 48000;
+  static const size_t kNumChannels = 1;
+  static const size_t kNumSamples = 300000;
+  std::vector<int16_t> samples(kNumSamples);
+  for (size_t i = 0; i < kNumSamples; ++i)
+    samples[i] = static_cast<int16_t>(i * 7919);
+  {
+    WavWriter w(outfile, kSampleRate, kNumChannels);
+    size_t written = 0;
+    std::vector<float> float_samples;
+    for (size_t chunk = 1; written < kNumSamples; chunk *= 3) {
+      chunk = std::min(chunk, kNumSamples - written);
+      if (chunk % 2) {
+        w.WriteSamples(&samples[written], chunk);
+      } else {
+        float_samples.assign(samples.begin() + written,
+                             samples.begin() + written + chunk);
+        w.WriteSamples(&float_samples[0], chunk);
+      }
+      written += chunk;
+    }
+    EXPECT_EQ(kNumSamples, w.num_samples());
+  }
+  EXPECT_EQ(sizeof(int16_t) * kNumSamples + kWavHeaderSize,
+            test::GetFileSize(outfile));
+
+  WavReader r(outfile);
+  EXPECT_EQ(kNumSamples, r.num_samples());
+  static const size_t kChunk = 4999;
+  int16_t read_samples[kChunk];
+  float read_float_samples[kChunk];
+  for (size_t i = 0; i < kNumSamples; i += kChunk) {
+    const size_t chunk = std::min(kChunk, kNumSamples - i);
+    if ((i / kChunk) % 2) {
+      ASSERT_EQ(chunk, r.ReadSamples(kChunk, read_samples));
+      for (size_t j = 0; j < chunk; ++j)
+        ASSERT_EQ(samples[i + j], read_samples[j]);
+    } else {
+      ASSERT_EQ(chunk, r.ReadSamples(kChunk, read_float_samples));
+      for (size_t j = 0; j < chunk; ++j)
+        ASSERT_EQ(samples[i + j], read_float_samples[j]);
+    }
+  }
+  EXPECT_EQ(0u, r.ReadSamples(kChunk, read_samples));
+}
+
 }  // namespace webrtc
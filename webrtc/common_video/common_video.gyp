@@ -52,6 +52,8 @@
         'video_frame_buffer.cc',
         'video_render_frames.cc',
         'video_render_frames.h',
+        'video_render_scheduler.cc',
+        'video_render_scheduler.h',
       ],
     },
   ],  # targets
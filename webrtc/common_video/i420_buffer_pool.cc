@@ -10,10 +10,39 @@
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 
+#include "webrtc/base/basictypes.h"
 #include "webrtc/base/checks.h"
 
 namespace {
 
+// Buffers kept by an I420BufferPool, beyond those of the current resolution.
+const size_t kDefaultMaxBytesPerPool = 16 * 1024 * 1024;
+
+// Free buffers kept by SharedI420BufferPool::Default(), enough for a few
+// dozen 720p frames.
+const size_t kDefaultMaxPooledBytes = 32 * 1024 * 1024;
+
+// Strides are multiples of this, so that SIMD code, e.g. in the scalers, can
+// process whole rows with aligned loads and stores.
+const int kStrideAlignment = 32;
+
+int AlignStride(int stride) {
+  return (stride + kStrideAlignment - 1) & ~(kStrideAlignment - 1);
+}
+
+rtc::scoped_refptr<webrtc::I420Buffer> CreateAlignedBuffer(int width,
+                                                           int height) {
+  const int stride_uv = AlignStride((width + 1) / 2);
+  return new rtc::RefCountedObject<webrtc::I420Buffer>(
+      width, height, AlignStride(width), stride_uv, stride_uv);
+}
+
+size_t BufferSizeBytes(const webrtc::I420Buffer& buffer) {
+  return buffer.stride(webrtc::kYPlane) * buffer.height() +
+         (buffer.stride(webrtc::kUPlane) + buffer.stride(webrtc::kVPlane)) *
+             ((buffer.height() + 1) / 2);
+}
+
 // One extra indirection is needed to make |HasOneRef| work.
 class PooledI420Buffer : public webrtc::VideoFrameBuffer {
  public:
@@ -53,38 +82,157 @@ class PooledI420Buffer : public webrtc::VideoFrameBuffer {
 
 namespace webrtc {
 
-I420BufferPool::I420BufferPool() {
+I420BufferPool::I420BufferPool() : I420BufferPool(kDefaultMaxBytesPerPool) {}
+
+I420BufferPool::I420BufferPool(size_t max_pooled_bytes)
+    : max_pooled_bytes_(max_pooled_bytes), hits_(0), misses_(0) {
   Release();
 }
 
 void I420BufferPool::Release() {
   thread_checker_.DetachFromThread();
   buffers_.clear();
+  pooled_bytes_ = 0;
+  use_count_ = 0;
 }
 
 rtc::scoped_refptr<VideoFrameBuffer> I420BufferPool::CreateBuffer(int width,
                                                                   int height) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
-      it = buffers_.erase(it);
-    else
-      ++it;
-  }
+  ++use_count_;
+  BufferMap::iterator bucket =
+      buffers_.insert(std::make_pair(std::make_pair(width, height),
+                                     std::list<Entry>()))
+          .first;
   // Look for a free buffer.
-  for (const rtc::scoped_refptr<I420Buffer>& buffer : buffers_) {
+  for (Entry& entry : bucket->second) {
     // If the buffer is in use, the ref count will be 2, one from the list we
     // are looping over and one from a PooledI420Buffer returned from
     // CreateBuffer that has not been released yet. If the ref count is 1
     // (HasOneRef), then the list we are looping over holds the only reference
     // and it's safe to reuse.
-    if (buffer->HasOneRef())
-      return new rtc::RefCountedObject<PooledI420Buffer>(buffer);
+    if (entry.buffer->HasOneRef()) {
+      entry.last_use = use_count_;
+      ++hits_;
+      return new rtc::RefCountedObject<PooledI420Buffer>(entry.buffer);
+    }
   }
   // Allocate new buffer.
-  buffers_.push_back(new rtc::RefCountedObject<I420Buffer>(width, height));
-  return new rtc::RefCountedObject<PooledI420Buffer>(buffers_.back());
+  ++misses_;
+  Entry entry = {CreateAlignedBuffer(width, height), use_count_};
+  bucket->second.push_back(entry);
+  pooled_bytes_ += BufferSizeBytes(*entry.buffer);
+  Trim(bucket);
+  return new rtc::RefCountedObject<PooledI420Buffer>(entry.buffer);
+}
+
+void I420BufferPool::Trim(const BufferMap::iterator& in_use) {
+  while (pooled_bytes_ > max_pooled_bytes_) {
+    BufferMap::iterator lru_bucket = buffers_.end();
+    std::list<Entry>::iterator lru_entry;
+    for (BufferMap::iterator bucket = buffers_.begin();
+         bucket != buffers_.end(); ++bucket) {
+      if (bucket == in_use)
+        continue;
+      for (auto it = bucket->second.begin(); it != bucket->second.end();
+           ++it) {
+        if (it->buffer->HasOneRef() &&
+            (lru_bucket == buffers_.end() ||
+             it->last_use < lru_entry->last_use)) {
+          lru_bucket = bucket;
+          lru_entry = it;
+        }
+      }
+    }
+    if (lru_bucket == buffers_.end())
+      return;
+    pooled_bytes_ -= BufferSizeBytes(*lru_entry->buffer);
+    lru_bucket->second.erase(lru_entry);
+    if (lru_bucket->second.empty())
+      buffers_.erase(lru_bucket);
+  }
+}
+
+// Hands the buffer back to the pool when the last reference to it is
+// released.
+class SharedI420BufferPool::PooledBuffer : public VideoFrameBuffer {
+ public:
+  PooledBuffer(const rtc::scoped_refptr<SharedI420BufferPool>& pool,
+               const rtc::scoped_refptr<I420Buffer>& buffer)
+      : pool_(pool), buffer_(buffer) {}
+
+ private:
+  ~PooledBuffer() override { pool_->ReturnBuffer(buffer_); }
+
+  int width() const override { return buffer_->width(); }
+  int height() const override { return buffer_->height(); }
+  const uint8_t* data(PlaneType type) const override {
+    return buffer_->data(type);
+  }
+  uint8_t* MutableData(PlaneType type) override {
+    RTC_DCHECK(HasOneRef());
+    return const_cast<uint8_t*>(buffer_->data(type));
+  }
+  int stride(PlaneType type) const override { return buffer_->stride(type); }
+  void* native_handle() const override { return nullptr; }
+
+  rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() override {
+    RTC_NOTREACHED();
+    return nullptr;
+  }
+
+  friend class rtc::RefCountedObject<PooledBuffer>;
+  const rtc::scoped_refptr<SharedI420BufferPool> pool_;
+  const rtc::scoped_refptr<I420Buffer> buffer_;
+};
+
+SharedI420BufferPool* SharedI420BufferPool::Default() {
+  RTC_DEFINE_STATIC_LOCAL(rtc::scoped_refptr<SharedI420BufferPool>, pool,
+                          (new rtc::RefCountedObject<SharedI420BufferPool>(
+                              kDefaultMaxPooledBytes)));
+  return pool.get();
+}
+
+SharedI420BufferPool::SharedI420BufferPool(size_t max_pooled_bytes)
+    : max_pooled_bytes_(max_pooled_bytes), pooled_bytes_(0) {}
+
+SharedI420BufferPool::~SharedI420BufferPool() {}
+
+rtc::scoped_refptr<VideoFrameBuffer> SharedI420BufferPool::CreateBuffer(
+    int width,
+    int height) {
+  rtc::scoped_refptr<I420Buffer> buffer;
+  {
+    rtc::CritScope lock(&crit_);
+    auto it = free_buffers_.find(std::make_pair(width, height));
+    if (it != free_buffers_.end()) {
+      buffer = it->second.back();
+      it->second.pop_back();
+      if (it->second.empty())
+        free_buffers_.erase(it);
+      pooled_bytes_ -= BufferSizeBytes(*buffer);
+    }
+  }
+  // Allocate outside the lock so that other decoders don't wait for it.
+  if (!buffer)
+    buffer = CreateAlignedBuffer(width, height);
+  return new rtc::RefCountedObject<PooledBuffer>(this, buffer);
+}
+
+size_t SharedI420BufferPool::pooled_bytes() const {
+  rtc::CritScope lock(&crit_);
+  return pooled_bytes_;
+}
+
+void SharedI420BufferPool::ReturnBuffer(
+    const rtc::scoped_refptr<I420Buffer>& buffer) {
+  const size_t size = BufferSizeBytes(*buffer);
+  rtc::CritScope lock(&crit_);
+  if (pooled_bytes_ + size > max_pooled_bytes_)
+    return;
+  free_buffers_[std::make_pair(buffer->width(), buffer->height())].push_back(
+      buffer);
+  pooled_bytes_ += size;
 }
 
 }  // namespace webrtc
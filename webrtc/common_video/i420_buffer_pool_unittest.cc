@@ -71,4 +71,99 @@ TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   memset(buffer->MutableData(kYPlane), 0xA5, 16 * buffer->stride(kYPlane));
 }
 
+TEST(TestI420BufferPool, ReuseAfterResolutionChange) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(16, 16);
+  const uint8_t* y_ptr = buffer->data(kYPlane);
+  buffer = pool.CreateBuffer(32, 16);
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->data(kYPlane));
+  EXPECT_EQ(1, pool.hits());
+  EXPECT_EQ(2, pool.misses());
+}
+
+TEST(TestI420BufferPool, TrimsLeastRecentlyUsedResolution) {
+  // Room for two 16x16 buffers, whose aligned planes take 32 * 16 + 2 * 32 * 8
+  // bytes.
+  I420BufferPool pool(2048);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer1 = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer2 = pool.CreateBuffer(16, 8);
+  const uint8_t* y_ptr2 = buffer2->data(kYPlane);
+  buffer1 = nullptr;
+  buffer2 = nullptr;
+  EXPECT_LE(pool.pooled_bytes(), 2048u);
+
+  // The 16x16 buffer was used least recently, so it is released to make room.
+  buffer1 = pool.CreateBuffer(24, 16);
+  EXPECT_LE(pool.pooled_bytes(), 2048u);
+  buffer2 = pool.CreateBuffer(16, 8);
+  EXPECT_EQ(y_ptr2, buffer2->data(kYPlane));
+  EXPECT_EQ(1, pool.hits());
+
+  // Buffers of the requested resolution, and buffers in use, are kept even if
+  // that exceeds the limit.
+  rtc::scoped_refptr<VideoFrameBuffer> buffer3 = pool.CreateBuffer(16, 8);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer4 = pool.CreateBuffer(16, 8);
+  EXPECT_GT(pool.pooled_bytes(), 2048u);
+}
+
+TEST(TestI420BufferPool, AlignedStrides) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(33, 17);
+  EXPECT_GE(buffer->stride(kYPlane), 33);
+  EXPECT_GE(buffer->stride(kUPlane), 17);
+  for (int plane = 0; plane < kNumOfPlanes; ++plane) {
+    const PlaneType type = static_cast<PlaneType>(plane);
+    EXPECT_EQ(0, buffer->stride(type) % 32);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buffer->data(type)) % 32);
+  }
+}
+
+TEST(TestSharedI420BufferPool, ReusesBuffersPerResolution) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool(
+      new rtc::RefCountedObject<SharedI420BufferPool>(1024 * 1024));
+  rtc::scoped_refptr<VideoFrameBuffer> buffer16 = pool->CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer32 = pool->CreateBuffer(32, 16);
+  EXPECT_TRUE(buffer16->HasOneRef());
+  const uint8_t* y_ptr16 = buffer16->data(kYPlane);
+  const uint8_t* y_ptr32 = buffer32->data(kYPlane);
+  EXPECT_EQ(0u, pool->pooled_bytes());
+  buffer16 = nullptr;
+  buffer32 = nullptr;
+  EXPECT_GT(pool->pooled_bytes(), 0u);
+
+  // Unlike I420BufferPool, a buffer of one resolution doesn't purge buffers
+  // of another.
+  buffer32 = pool->CreateBuffer(32, 16);
+  buffer16 = pool->CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr16, buffer16->data(kYPlane));
+  EXPECT_EQ(y_ptr32, buffer32->data(kYPlane));
+  EXPECT_EQ(0u, pool->pooled_bytes());
+}
+
+TEST(TestSharedI420BufferPool, KeepsAtMostMaxPooledBytes) {
+  // Room for one 16x16 buffer, whose aligned planes take 32 * 16 + 2 * 32 * 8
+  // bytes.
+  const size_t kMaxPooledBytes = 1500;
+  rtc::scoped_refptr<SharedI420BufferPool> pool(
+      new rtc::RefCountedObject<SharedI420BufferPool>(kMaxPooledBytes));
+  rtc::scoped_refptr<VideoFrameBuffer> buffer1 = pool->CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer2 = pool->CreateBuffer(16, 16);
+  buffer1 = nullptr;
+  const size_t buffer_size = pool->pooled_bytes();
+  EXPECT_GT(buffer_size, 0u);
+  EXPECT_LE(buffer_size, kMaxPooledBytes);
+  buffer2 = nullptr;
+  EXPECT_EQ(buffer_size, pool->pooled_bytes());
+}
+
+TEST(TestSharedI420BufferPool, FrameValidAfterPoolReleased) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool(
+      new rtc::RefCountedObject<SharedI420BufferPool>(1024 * 1024));
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool->CreateBuffer(16, 16);
+  pool = nullptr;
+  EXPECT_TRUE(buffer->HasOneRef());
+  memset(buffer->MutableData(kYPlane), 0xA5, 16 * buffer->stride(kYPlane));
+}
+
 }  // namespace webrtc
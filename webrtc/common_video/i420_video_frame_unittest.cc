@@ -240,6 +240,76 @@ TEST(TestVideoFrame, FailToReuseAllocation) {
   EXPECT_NE(v, frame1.buffer(kVPlane));
 }
 
+TEST(TestVideoFrame, UpdateRegion) {
+  VideoFrameUpdateRegion region;
+  EXPECT_FALSE(region.known());
+  EXPECT_FALSE(region.IsEmpty());
+  // Rectangles can't be added to an unknown region.
+  region.AddRect(0, 0, 16, 16);
+  EXPECT_TRUE(region.rects().empty());
+
+  region.SetEmpty();
+  EXPECT_TRUE(region.known());
+  EXPECT_TRUE(region.IsEmpty());
+  region.AddRect(0, 0, 0, 16);
+  EXPECT_TRUE(region.IsEmpty());
+  region.AddRect(16, 0, 8, 8);
+  EXPECT_FALSE(region.IsEmpty());
+  ASSERT_EQ(1u, region.rects().size());
+  EXPECT_EQ(16, region.rects()[0].x);
+
+  VideoFrameUpdateRegion other;
+  other.SetEmpty();
+  other.AddRect(0, 40, 8, 8);
+  region.Add(other);
+  EXPECT_EQ(2u, region.rects().size());
+
+  // A 48x48 frame has 3x3 blocks of 16x16.
+  uint8_t map[9];
+  region.FillBlockMap(48, 48, 16, map);
+  const uint8_t kExpectedMap[9] = {0, 1, 0, 0, 0, 0, 1, 0, 0};
+  EXPECT_EQ(0, memcmp(kExpectedMap, map, sizeof(map)));
+
+  region.Add(VideoFrameUpdateRegion());
+  EXPECT_FALSE(region.known());
+  region.FillBlockMap(48, 48, 16, map);
+  const uint8_t kAllBlocks[9] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+  EXPECT_EQ(0, memcmp(kAllBlocks, map, sizeof(map)));
+}
+
+TEST(TestVideoFrame, UpdateRegionCollapsesToBoundingBox) {
+  VideoFrameUpdateRegion region;
+  region.SetEmpty();
+  for (size_t i = 0; i <= VideoFrameUpdateRegion::kMaxRects; ++i)
+    region.AddRect(static_cast<int>(10 * i), 5, 1, static_cast<int>(i + 1));
+  ASSERT_EQ(1u, region.rects().size());
+  EXPECT_EQ(0, region.rects()[0].x);
+  EXPECT_EQ(5, region.rects()[0].y);
+  EXPECT_EQ(static_cast<int>(10 * VideoFrameUpdateRegion::kMaxRects + 1),
+            region.rects()[0].width);
+  EXPECT_EQ(static_cast<int>(VideoFrameUpdateRegion::kMaxRects + 1),
+            region.rects()[0].height);
+}
+
+TEST(TestVideoFrame, CopiesUpdateRegion) {
+  VideoFrame frame1;
+  ASSERT_EQ(0, frame1.CreateEmptyFrame(16, 16, 16, 8, 8));
+  EXPECT_FALSE(frame1.update_region().known());
+  frame1.mutable_update_region()->SetEmpty();
+  frame1.mutable_update_region()->AddRect(1, 2, 3, 4);
+
+  VideoFrame frame2;
+  frame2.ShallowCopy(frame1);
+  ASSERT_EQ(1u, frame2.update_region().rects().size());
+  VideoFrame frame3;
+  ASSERT_EQ(0, frame3.CopyFrame(frame1));
+  ASSERT_EQ(1u, frame3.update_region().rects().size());
+  EXPECT_EQ(4, frame3.update_region().rects()[0].height);
+
+  frame1.Reset();
+  EXPECT_FALSE(frame1.update_region().known());
+}
+
 TEST(TestVideoFrame, TextureInitialValues) {
   test::FakeNativeHandle* handle = new test::FakeNativeHandle();
   VideoFrame frame = test::FakeNativeHandle::CreateFrame(
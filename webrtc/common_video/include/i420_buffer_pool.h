@@ -12,7 +12,13 @@
 #define WEBRTC_COMMON_VIDEO_INCLUDE_I420_BUFFER_POOL_H_
 
 #include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/thread_annotations.h"
 #include "webrtc/base/thread_checker.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 
@@ -21,11 +27,15 @@ namespace webrtc {
 // Simple buffer pool to avoid unnecessary allocations of I420Buffer objects.
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
-// by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// by subsequent calls to CreateBuffer. Buffers are kept per resolution, so
+// switching back and forth between resolutions reuses them. Once the pool
+// holds more than its maximum number of bytes, free buffers of resolutions
+// other than the one requested are released, least recently used first.
+// Buffer strides are aligned for SIMD code.
 class I420BufferPool {
  public:
   I420BufferPool();
+  explicit I420BufferPool(size_t max_pooled_bytes);
   // Returns a buffer from the pool, or creates a new buffer if no suitable
   // buffer exists in the pool.
   rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(int width, int height);
@@ -33,9 +43,66 @@ class I420BufferPool {
   // later from another thread.
   void Release();
 
+  // Bytes held by the pool's buffers, both free and in use.
+  size_t pooled_bytes() const { return pooled_bytes_; }
+  // Number of CreateBuffer() calls that reused a buffer, and that allocated
+  // one.
+  int hits() const { return hits_; }
+  int misses() const { return misses_; }
+
  private:
+  struct Entry {
+    rtc::scoped_refptr<I420Buffer> buffer;
+    // Value of |use_count_| when the buffer was last handed out.
+    uint64_t last_use;
+  };
+  typedef std::map<std::pair<int, int>, std::list<Entry>> BufferMap;
+
+  // Releases free buffers of other resolutions than |in_use|, least recently
+  // used first, until the pool is below its maximum size.
+  void Trim(const BufferMap::iterator& in_use);
+
   rtc::ThreadChecker thread_checker_;
-  std::list<rtc::scoped_refptr<I420Buffer>> buffers_;
+  const size_t max_pooled_bytes_;
+  BufferMap buffers_;
+  size_t pooled_bytes_;
+  uint64_t use_count_;
+  int hits_;
+  int misses_;
+};
+
+// Thread-safe buffer pool that can be shared by many decoders, e.g. by all
+// the streams a server-side recorder decodes. Free buffers are kept per
+// resolution, so streams of different resolutions don't purge each other's
+// buffers, and at most |max_pooled_bytes| worth of free buffers is kept. A
+// buffer that is returned while the pool is full is deleted.
+class SharedI420BufferPool : public rtc::RefCountInterface {
+ public:
+  // The pool shared by the whole process.
+  static SharedI420BufferPool* Default();
+
+  // Returns a buffer from the pool, or creates a new buffer if there is no
+  // free buffer of this resolution. Can be called on any thread, and the
+  // returned buffer can be released on any thread.
+  rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(int width, int height);
+
+  // Bytes held by free buffers in the pool.
+  size_t pooled_bytes() const;
+
+ protected:
+  explicit SharedI420BufferPool(size_t max_pooled_bytes);
+  ~SharedI420BufferPool() override;
+
+ private:
+  class PooledBuffer;
+
+  void ReturnBuffer(const rtc::scoped_refptr<I420Buffer>& buffer);
+
+  const size_t max_pooled_bytes_;
+  mutable rtc::CriticalSection crit_;
+  std::map<std::pair<int, int>, std::vector<rtc::scoped_refptr<I420Buffer>>>
+      free_buffers_ GUARDED_BY(crit_);
+  size_t pooled_bytes_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -11,14 +11,13 @@
 #ifndef WEBRTC_COMMON_VIDEO_INCLUDE_INCOMING_VIDEO_STREAM_H_
 #define WEBRTC_COMMON_VIDEO_INCLUDE_INCOMING_VIDEO_STREAM_H_
 
-#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_video/video_render_frames.h"
+#include "webrtc/common_video/video_render_scheduler.h"
 
 namespace webrtc {
 class CriticalSectionWrapper;
-class EventTimerWrapper;
 
 class VideoRenderCallback {
  public:
@@ -29,7 +28,10 @@ class VideoRenderCallback {
   virtual ~VideoRenderCallback() {}
 };
 
-class IncomingVideoStream : public VideoRenderCallback {
+// Unless prerenderer smoothing is disabled, frames are queued and rendered at
+// their render time from the thread of the shared VideoRenderScheduler.
+class IncomingVideoStream : public VideoRenderCallback,
+                            public VideoRenderScheduler::Stream {
  public:
   IncomingVideoStream(uint32_t stream_id, bool disable_prerenderer_smoothing);
   ~IncomingVideoStream();
@@ -63,15 +65,14 @@ class IncomingVideoStream : public VideoRenderCallback {
 
   int32_t SetExpectedRenderDelay(int32_t delay_ms);
 
- protected:
-  static bool IncomingVideoStreamThreadFun(void* obj);
-  bool IncomingVideoStreamProcess();
-
  private:
   enum { kEventStartupTimeMs = 10 };
   enum { kEventMaxWaitTimeMs = 100 };
   enum { kFrameRatePeriodMs = 1000 };
 
+  // VideoRenderScheduler::Stream implementation.
+  uint32_t RenderNextFrame() override;
+
   void DeliverFrame(const VideoFrame& video_frame);
 
   uint32_t const stream_id_;
@@ -80,11 +81,8 @@ class IncomingVideoStream : public VideoRenderCallback {
   const rtc::scoped_ptr<CriticalSectionWrapper> stream_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> thread_critsect_;
   const rtc::scoped_ptr<CriticalSectionWrapper> buffer_critsect_;
-  // TODO(pbos): Make plain member and stop resetting this thread, just
-  // start/stoping it is enough.
-  rtc::scoped_ptr<rtc::PlatformThread> incoming_render_thread_
-      GUARDED_BY(thread_critsect_);
-  rtc::scoped_ptr<EventTimerWrapper> deliver_buffer_event_;
+  // Set while running, unless prerenderer smoothing is disabled.
+  VideoRenderScheduler* scheduler_ GUARDED_BY(stream_critsect_);
 
   bool running_ GUARDED_BY(stream_critsect_);
   VideoRenderCallback* external_callback_ GUARDED_BY(thread_critsect_);
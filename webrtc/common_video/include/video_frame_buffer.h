@@ -57,6 +57,12 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   // native handle.
   virtual rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() = 0;
 
+  // Returns a new native-handle buffer with the contents of this one scaled to
+  // |width| x |height|, e.g. on the GPU, or nullptr if that is not supported.
+  // Memory-backed buffers return nullptr and are scaled by the caller.
+  virtual rtc::scoped_refptr<VideoFrameBuffer> ScaleNative(int width,
+                                                           int height);
+
  protected:
   virtual ~VideoFrameBuffer();
 };
@@ -21,11 +21,9 @@
 #include <sys/time.h>
 #endif
 
-#include "webrtc/base/platform_thread.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/video_render_frames.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
-#include "webrtc/system_wrappers/include/event_wrapper.h"
 #include "webrtc/system_wrappers/include/tick_util.h"
 #include "webrtc/system_wrappers/include/trace.h"
 #include "webrtc/video_renderer.h"
@@ -39,8 +37,7 @@ IncomingVideoStream::IncomingVideoStream(uint32_t stream_id,
       stream_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       thread_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       buffer_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
-      incoming_render_thread_(),
-      deliver_buffer_event_(EventTimerWrapper::Create()),
+      scheduler_(nullptr),
       running_(false),
       external_callback_(nullptr),
       render_callback_(nullptr),
@@ -88,7 +85,7 @@ int32_t IncomingVideoStream::RenderFrame(const uint32_t stream_id,
   } else {
     CriticalSectionScoped csB(buffer_critsect_.get());
     if (render_buffers_->AddFrame(video_frame) == 1) {
-      deliver_buffer_event_->Set();
+      scheduler_->WakeStream(this);
     }
   }
   return 0;
@@ -135,18 +132,9 @@ int32_t IncomingVideoStream::Start() {
   }
 
   if (!disable_prerenderer_smoothing_) {
-    CriticalSectionScoped csT(thread_critsect_.get());
-    assert(incoming_render_thread_ == NULL);
-
-    incoming_render_thread_.reset(new rtc::PlatformThread(
-        IncomingVideoStreamThreadFun, this, "IncomingVideoStreamThread"));
-    if (!incoming_render_thread_) {
-      return -1;
-    }
-
-    incoming_render_thread_->Start();
-    incoming_render_thread_->SetPriority(rtc::kRealtimePriority);
-    deliver_buffer_event_->StartTimer(false, kEventStartupTimeMs);
+    assert(scheduler_ == NULL);
+    scheduler_ = VideoRenderScheduler::Acquire();
+    scheduler_->AddStream(this, kEventStartupTimeMs);
   }
 
   running_ = true;
@@ -160,22 +148,12 @@ int32_t IncomingVideoStream::Stop() {
     return 0;
   }
 
-  rtc::PlatformThread* thread = NULL;
-  {
-    CriticalSectionScoped cs_thread(thread_critsect_.get());
-    if (incoming_render_thread_) {
-      // Setting the incoming render thread to NULL marks that we're performing
-      // a shutdown and will make IncomingVideoStreamProcess abort after wakeup.
-      thread = incoming_render_thread_.release();
-      deliver_buffer_event_->StopTimer();
-      // Set the event to allow the thread to wake up and shut down without
-      // waiting for a timeout.
-      deliver_buffer_event_->Set();
-    }
-  }
-  if (thread) {
-    thread->Stop();
-    delete thread;
+  if (scheduler_) {
+    // Once removed, the stream is no longer rendering on the scheduler
+    // thread.
+    scheduler_->RemoveStream(this);
+    VideoRenderScheduler::Release();
+    scheduler_ = NULL;
   }
   running_ = false;
   return 0;
@@ -196,36 +174,23 @@ uint32_t IncomingVideoStream::IncomingRate() const {
   return incoming_rate_;
 }
 
-bool IncomingVideoStream::IncomingVideoStreamThreadFun(void* obj) {
-  return static_cast<IncomingVideoStream*>(obj)->IncomingVideoStreamProcess();
-}
-
-bool IncomingVideoStream::IncomingVideoStreamProcess() {
-  if (kEventError != deliver_buffer_event_->Wait(kEventMaxWaitTimeMs)) {
-    CriticalSectionScoped cs(thread_critsect_.get());
-    if (incoming_render_thread_ == NULL) {
-      // Terminating
-      return false;
-    }
-
-    // Get a new frame to render and the time for the frame after this one.
-    VideoFrame frame_to_render;
-    uint32_t wait_time;
-    {
-      CriticalSectionScoped cs(buffer_critsect_.get());
-      frame_to_render = render_buffers_->FrameToRender();
-      wait_time = render_buffers_->TimeToNextFrameRelease();
-    }
+uint32_t IncomingVideoStream::RenderNextFrame() {
+  // Get a new frame to render and the time for the frame after this one.
+  VideoFrame frame_to_render;
+  uint32_t wait_time;
+  {
+    CriticalSectionScoped cs(buffer_critsect_.get());
+    frame_to_render = render_buffers_->FrameToRender();
+    wait_time = render_buffers_->TimeToNextFrameRelease();
+  }
 
-    // Set timer for next frame to render.
-    if (wait_time > kEventMaxWaitTimeMs) {
-      wait_time = kEventMaxWaitTimeMs;
-    }
-    deliver_buffer_event_->StartTimer(false, wait_time);
+  DeliverFrame(frame_to_render);
 
-    DeliverFrame(frame_to_render);
+  // Come back at least this often to render the start and timeout images.
+  if (wait_time > kEventMaxWaitTimeMs) {
+    wait_time = kEventMaxWaitTimeMs;
   }
-  return true;
+  return wait_time;
 }
 
 void IncomingVideoStream::DeliverFrame(const VideoFrame& video_frame) {
@@ -39,6 +39,72 @@ int ExpectedSize(int plane_stride, int image_height, PlaneType type) {
   return plane_stride * ((image_height + 1) / 2);
 }
 
+VideoFrameUpdateRegion::VideoFrameUpdateRegion() : known_(false) {}
+
+void VideoFrameUpdateRegion::SetUnknown() {
+  known_ = false;
+  rects_.clear();
+}
+
+void VideoFrameUpdateRegion::SetEmpty() {
+  known_ = true;
+  rects_.clear();
+}
+
+void VideoFrameUpdateRegion::AddRect(int x, int y, int width, int height) {
+  if (!known_ || width <= 0 || height <= 0)
+    return;
+  Rect rect = {x, y, width, height};
+  if (rects_.size() < kMaxRects) {
+    rects_.push_back(rect);
+    return;
+  }
+  // Too many rectangles to be worth tracking separately.
+  int left = x;
+  int top = y;
+  int right = x + width;
+  int bottom = y + height;
+  for (const Rect& r : rects_) {
+    left = std::min(left, r.x);
+    top = std::min(top, r.y);
+    right = std::max(right, r.x + r.width);
+    bottom = std::max(bottom, r.y + r.height);
+  }
+  rects_.clear();
+  Rect bounds = {left, top, right - left, bottom - top};
+  rects_.push_back(bounds);
+}
+
+void VideoFrameUpdateRegion::Add(const VideoFrameUpdateRegion& region) {
+  if (!region.known_) {
+    SetUnknown();
+    return;
+  }
+  for (const Rect& r : region.rects_)
+    AddRect(r.x, r.y, r.width, r.height);
+}
+
+void VideoFrameUpdateRegion::FillBlockMap(int width,
+                                          int height,
+                                          int block_size,
+                                          uint8_t* map) const {
+  const int cols = (width + block_size - 1) / block_size;
+  const int rows = (height + block_size - 1) / block_size;
+  memset(map, known_ ? 0 : 1, cols * rows);
+  for (const Rect& r : rects_) {
+    const int first_col = std::max(r.x, 0) / block_size;
+    const int first_row = std::max(r.y, 0) / block_size;
+    const int end_col =
+        std::min((r.x + r.width + block_size - 1) / block_size, cols);
+    const int end_row =
+        std::min((r.y + r.height + block_size - 1) / block_size, rows);
+    for (int row = first_row; row < end_row; ++row) {
+      for (int col = first_col; col < end_col; ++col)
+        map[row * cols + col] = 1;
+    }
+  }
+}
+
 VideoFrame::VideoFrame() {
   // Intentionally using Reset instead of initializer list so that any missed
   // fields in Reset will be caught by memory checkers.
@@ -73,6 +139,7 @@ int VideoFrame::CreateEmptyFrame(int width,
   ntp_time_ms_ = 0;
   render_time_ms_ = 0;
   rotation_ = kVideoRotation_0;
+  update_region_.SetUnknown();
 
   // Check if it's safe to reuse allocation.
   if (video_frame_buffer_ && video_frame_buffer_->HasOneRef() &&
@@ -152,6 +219,7 @@ int VideoFrame::CopyFrame(const VideoFrame& videoFrame) {
   ntp_time_ms_ = videoFrame.ntp_time_ms_;
   render_time_ms_ = videoFrame.render_time_ms_;
   rotation_ = videoFrame.rotation_;
+  update_region_ = videoFrame.update_region_;
   return 0;
 }
 
@@ -161,6 +229,7 @@ void VideoFrame::ShallowCopy(const VideoFrame& videoFrame) {
   ntp_time_ms_ = videoFrame.ntp_time_ms_;
   render_time_ms_ = videoFrame.render_time_ms_;
   rotation_ = videoFrame.rotation_;
+  update_region_ = videoFrame.update_region_;
 }
 
 void VideoFrame::Reset() {
@@ -169,6 +238,7 @@ void VideoFrame::Reset() {
   ntp_time_ms_ = 0;
   render_time_ms_ = 0;
   rotation_ = kVideoRotation_0;
+  update_region_.SetUnknown();
 }
 
 uint8_t* VideoFrame::buffer(PlaneType type) {
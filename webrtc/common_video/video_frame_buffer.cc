@@ -23,6 +23,11 @@ uint8_t* VideoFrameBuffer::MutableData(PlaneType type) {
   return nullptr;
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::ScaleNative(int width,
+                                                                   int height) {
+  return nullptr;
+}
+
 VideoFrameBuffer::~VideoFrameBuffer() {}
 
 I420Buffer::I420Buffer(int width, int height)
@@ -23,7 +23,10 @@ const uint32_t kMinRenderDelayMs = 10;
 const uint32_t kMaxRenderDelayMs = 500;
 
 VideoRenderFrames::VideoRenderFrames()
-    : render_delay_ms_(10) {
+    : incoming_frames_(KMaxNumberOfFrames),
+      first_frame_(0),
+      num_frames_(0),
+      render_delay_ms_(10) {
 }
 
 int32_t VideoRenderFrames::AddFrame(const VideoFrame& new_frame) {
@@ -31,7 +34,7 @@ int32_t VideoRenderFrames::AddFrame(const VideoFrame& new_frame) {
 
   // Drop old frames only when there are other frames in the queue, otherwise, a
   // really slow system never renders any frames.
-  if (!incoming_frames_.empty() &&
+  if (num_frames_ > 0 &&
       new_frame.render_time_ms() + KOldRenderTimestampMS < time_now) {
     WEBRTC_TRACE(kTraceWarning,
                  kTraceVideoRenderer,
@@ -49,32 +52,41 @@ int32_t VideoRenderFrames::AddFrame(const VideoFrame& new_frame) {
     return -1;
   }
 
-  incoming_frames_.push_back(new_frame);
-  return static_cast<int32_t>(incoming_frames_.size());
+  if (num_frames_ == KMaxNumberOfFrames) {
+    WEBRTC_TRACE(kTraceWarning, kTraceVideoRenderer, -1,
+                 "%s: render queue full, dropping oldest frame.",
+                 __FUNCTION__);
+    PopFrame();
+  }
+
+  incoming_frames_[(first_frame_ + num_frames_) % KMaxNumberOfFrames] =
+      new_frame;
+  ++num_frames_;
+  return static_cast<int32_t>(num_frames_);
 }
 
 VideoFrame VideoRenderFrames::FrameToRender() {
   VideoFrame render_frame;
   // Get the newest frame that can be released for rendering.
-  while (!incoming_frames_.empty() && TimeToNextFrameRelease() <= 0) {
-    render_frame = incoming_frames_.front();
-    incoming_frames_.pop_front();
-  }
+  while (num_frames_ > 0 && TimeToNextFrameRelease() <= 0)
+    render_frame = PopFrame();
   return render_frame;
 }
 
 int32_t VideoRenderFrames::ReleaseAllFrames() {
-  incoming_frames_.clear();
+  while (num_frames_ > 0)
+    PopFrame();
+  first_frame_ = 0;
   return 0;
 }
 
 uint32_t VideoRenderFrames::TimeToNextFrameRelease() {
-  if (incoming_frames_.empty()) {
+  if (num_frames_ == 0) {
     return KEventMaxWaitTimeMs;
   }
-  const int64_t time_to_release = incoming_frames_.front().render_time_ms() -
-                                  render_delay_ms_ -
-                                  TickTime::MillisecondTimestamp();
+  const int64_t time_to_release =
+      incoming_frames_[first_frame_].render_time_ms() - render_delay_ms_ -
+      TickTime::MillisecondTimestamp();
   return time_to_release < 0 ? 0u : static_cast<uint32_t>(time_to_release);
 }
 
@@ -92,4 +104,14 @@ int32_t VideoRenderFrames::SetRenderDelay(
   return 0;
 }
 
+VideoFrame VideoRenderFrames::PopFrame() {
+  assert(num_frames_ > 0);
+  VideoFrame frame = incoming_frames_[first_frame_];
+  // Release the buffer now rather than when the slot is reused.
+  incoming_frames_[first_frame_].Reset();
+  first_frame_ = (first_frame_ + 1) % KMaxNumberOfFrames;
+  --num_frames_;
+  return frame;
+}
+
 }  // namespace webrtc
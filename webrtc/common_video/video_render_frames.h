@@ -13,7 +13,7 @@
 
 #include <stdint.h>
 
-#include <list>
+#include <vector>
 
 #include "webrtc/video_frame.h"
 
@@ -40,15 +40,22 @@ class VideoRenderFrames {
   int32_t SetRenderDelay(const uint32_t render_delay);
 
  private:
-  // 10 seconds for 30 fps.
+  // 10 seconds for 30 fps. When the queue is full the oldest frame is
+  // dropped.
   enum { KMaxNumberOfFrames = 300 };
   // Don't render frames with timestamp older than 500ms from now.
   enum { KOldRenderTimestampMS = 500 };
   // Don't render frames with timestamp more than 10s into the future.
   enum { KFutureRenderTimestampMS = 10000 };
 
-  // Sorted list with framed to be rendered, oldest first.
-  std::list<VideoFrame> incoming_frames_;
+  // Removes and returns the oldest frame. The queue must not be empty.
+  VideoFrame PopFrame();
+
+  // Ring of KMaxNumberOfFrames frames to be rendered, oldest first. The
+  // queued frames are |num_frames_| entries starting at |first_frame_|.
+  std::vector<VideoFrame> incoming_frames_;
+  size_t first_frame_;
+  size_t num_frames_;
 
   // Estimated delay from a frame is released until it's rendered.
   uint32_t render_delay_ms_;
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/video_render_scheduler.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
+
+namespace webrtc {
+
+namespace {
+
+rtc::GlobalLockPod g_scheduler_lock;
+VideoRenderScheduler* g_scheduler = nullptr;
+int g_scheduler_ref_count = 0;
+
+}  // namespace
+
+// static
+VideoRenderScheduler* VideoRenderScheduler::Acquire() {
+  rtc::GlobalLockScope lock(&g_scheduler_lock);
+  if (g_scheduler_ref_count++ == 0)
+    g_scheduler = new VideoRenderScheduler();
+  return g_scheduler;
+}
+
+// static
+void VideoRenderScheduler::Release() {
+  VideoRenderScheduler* scheduler = nullptr;
+  {
+    rtc::GlobalLockScope lock(&g_scheduler_lock);
+    RTC_DCHECK_GT(g_scheduler_ref_count, 0);
+    if (--g_scheduler_ref_count == 0) {
+      scheduler = g_scheduler;
+      g_scheduler = nullptr;
+    }
+  }
+  // Stopping the thread can take a while, so don't spin on the global lock
+  // meanwhile.
+  delete scheduler;
+}
+
+VideoRenderScheduler::VideoRenderScheduler()
+    : next_sequence_number_(0),
+      rendering_stream_(nullptr),
+      stopping_(false),
+      wake_(false, false),
+      thread_(&VideoRenderScheduler::Run, this, "VideoRenderScheduler") {
+  thread_.Start();
+  thread_.SetPriority(rtc::kRealtimePriority);
+}
+
+VideoRenderScheduler::~VideoRenderScheduler() {
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(streams_.empty());
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+}
+
+void VideoRenderScheduler::AddStream(Stream* stream, uint32_t delay_ms) {
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(streams_.find(stream) == streams_.end());
+    ScheduleLocked(stream, TickTime::MillisecondTimestamp() + delay_ms);
+  }
+  wake_.Set();
+}
+
+void VideoRenderScheduler::RemoveStream(Stream* stream) {
+  bool rendering;
+  {
+    rtc::CritScope lock(&crit_);
+    streams_.erase(stream);
+    rendering = rendering_stream_ == stream;
+  }
+  // Its entries in the heap are skipped from now on, but it may be rendering
+  // right now.
+  if (rendering) {
+    rtc::CritScope lock(&render_crit_);
+  }
+}
+
+void VideoRenderScheduler::WakeStream(Stream* stream) {
+  {
+    rtc::CritScope lock(&crit_);
+    if (streams_.find(stream) == streams_.end())
+      return;
+    ScheduleLocked(stream, TickTime::MillisecondTimestamp());
+  }
+  wake_.Set();
+}
+
+void VideoRenderScheduler::ScheduleLocked(Stream* stream,
+                                          int64_t due_time_ms) {
+  const uint64_t sequence_number = next_sequence_number_++;
+  streams_[stream] = sequence_number;
+  ScheduledStream entry = {due_time_ms, stream, sequence_number};
+  heap_.push_back(entry);
+  std::push_heap(heap_.begin(), heap_.end());
+}
+
+bool VideoRenderScheduler::Run(void* obj) {
+  return static_cast<VideoRenderScheduler*>(obj)->Process();
+}
+
+bool VideoRenderScheduler::Process() {
+  int wait_ms = rtc::Event::kForever;
+  {
+    rtc::CritScope render_lock(&render_crit_);
+    Stream* stream = nullptr;
+    uint64_t sequence_number = 0;
+    const int64_t now_ms = TickTime::MillisecondTimestamp();
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_)
+        return false;
+      while (!heap_.empty()) {
+        const ScheduledStream& first = heap_.front();
+        std::map<Stream*, uint64_t>::const_iterator it =
+            streams_.find(first.stream);
+        if (it == streams_.end() || it->second != first.sequence_number) {
+          // Removed or rescheduled.
+          std::pop_heap(heap_.begin(), heap_.end());
+          heap_.pop_back();
+          continue;
+        }
+        if (first.due_time_ms > now_ms) {
+          wait_ms = static_cast<int>(first.due_time_ms - now_ms);
+          break;
+        }
+        stream = first.stream;
+        sequence_number = first.sequence_number;
+        std::pop_heap(heap_.begin(), heap_.end());
+        heap_.pop_back();
+        break;
+      }
+      rendering_stream_ = stream;
+    }
+
+    if (stream) {
+      const uint32_t delay_ms = stream->RenderNextFrame();
+      rtc::CritScope lock(&crit_);
+      rendering_stream_ = nullptr;
+      std::map<Stream*, uint64_t>::const_iterator it = streams_.find(stream);
+      // Unless the stream was removed or woken up while rendering. The delay
+      // counts from when rendering started.
+      if (it != streams_.end() && it->second == sequence_number)
+        ScheduleLocked(stream, now_ms + delay_ms);
+      return true;
+    }
+  }
+  wake_.Wait(wait_ms);
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
+#define WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
+
+#include <map>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Renders the frames of all IncomingVideoStreams from a single thread. The
+// streams are kept in a heap ordered by when they are next due, and the
+// thread sleeps until the first of them is, instead of each stream having a
+// thread and a timer of its own.
+class VideoRenderScheduler {
+ public:
+  class Stream {
+   public:
+    // Called on the scheduler thread when the stream is due. Returns the
+    // number of ms until it is due again.
+    virtual uint32_t RenderNextFrame() = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  // Returns the shared scheduler, creating it if needed. Every call must be
+  // matched by a call to Release(); the last one stops the thread.
+  static VideoRenderScheduler* Acquire();
+  static void Release();
+
+  // Schedules |stream|, which must not already be added, |delay_ms| from now.
+  void AddStream(Stream* stream, uint32_t delay_ms);
+  // Unschedules |stream|. Once this returns, RenderNextFrame() is no longer
+  // running and won't be called again. Must not be called from
+  // RenderNextFrame().
+  void RemoveStream(Stream* stream);
+  // Makes |stream| due now, e.g. because a frame was added to its empty
+  // queue. Does nothing if |stream| hasn't been added.
+  void WakeStream(Stream* stream);
+
+ private:
+  struct ScheduledStream {
+    int64_t due_time_ms;
+    Stream* stream;
+    // Entries with a sequence number other than the stream's current one
+    // have been rescheduled and are skipped.
+    uint64_t sequence_number;
+
+    // For a min-heap on |due_time_ms| with the std heap algorithms.
+    bool operator<(const ScheduledStream& other) const {
+      return due_time_ms > other.due_time_ms;
+    }
+  };
+
+  VideoRenderScheduler();
+  ~VideoRenderScheduler();
+
+  static bool Run(void* obj);
+  bool Process();
+
+  void ScheduleLocked(Stream* stream, int64_t due_time_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Held by the thread while a stream renders, so that RemoveStream() can
+  // wait for it to finish.
+  rtc::CriticalSection render_crit_;
+  rtc::CriticalSection crit_ ACQUIRED_AFTER(render_crit_);
+  std::vector<ScheduledStream> heap_ GUARDED_BY(crit_);
+  // The current sequence number of each added stream.
+  std::map<Stream*, uint64_t> streams_ GUARDED_BY(crit_);
+  uint64_t next_sequence_number_ GUARDED_BY(crit_);
+  Stream* rendering_stream_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  rtc::Event wake_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VideoRenderScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_VIDEO_RENDER_SCHEDULER_H_
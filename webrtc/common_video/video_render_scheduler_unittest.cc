@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/video_render_scheduler.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kTimeoutMs = 1000;
+
+class FakeStream : public VideoRenderScheduler::Stream {
+ public:
+  explicit FakeStream(uint32_t delay_ms)
+      : delay_ms_(delay_ms), renders_(0), rendered_(false, false) {}
+
+  uint32_t RenderNextFrame() override {
+    {
+      rtc::CritScope lock(&crit_);
+      ++renders_;
+    }
+    rendered_.Set();
+    return delay_ms_;
+  }
+
+  int renders() const {
+    rtc::CritScope lock(&crit_);
+    return renders_;
+  }
+
+  bool WaitForRenders(int renders, int timeout_ms) {
+    while (this->renders() < renders) {
+      if (!rendered_.Wait(timeout_ms))
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  const uint32_t delay_ms_;
+  mutable rtc::CriticalSection crit_;
+  int renders_;
+  rtc::Event rendered_;
+};
+
+}  // namespace
+
+TEST(VideoRenderSchedulerTest, RendersStreamsFromOneThread) {
+  VideoRenderScheduler* scheduler = VideoRenderScheduler::Acquire();
+  EXPECT_EQ(scheduler, VideoRenderScheduler::Acquire());
+  VideoRenderScheduler::Release();
+
+  FakeStream fast_stream(5);
+  FakeStream slow_stream(50);
+  scheduler->AddStream(&fast_stream, 0);
+  scheduler->AddStream(&slow_stream, 0);
+  EXPECT_TRUE(slow_stream.WaitForRenders(3, kTimeoutMs));
+  EXPECT_TRUE(fast_stream.WaitForRenders(3, kTimeoutMs));
+  EXPECT_GT(fast_stream.renders(), slow_stream.renders());
+
+  scheduler->RemoveStream(&fast_stream);
+  scheduler->RemoveStream(&slow_stream);
+  VideoRenderScheduler::Release();
+}
+
+TEST(VideoRenderSchedulerTest, WakeStreamRendersImmediately) {
+  VideoRenderScheduler* scheduler = VideoRenderScheduler::Acquire();
+  FakeStream stream(60 * 1000);
+  scheduler->AddStream(&stream, 0);
+  EXPECT_TRUE(stream.WaitForRenders(1, kTimeoutMs));
+  scheduler->WakeStream(&stream);
+  EXPECT_TRUE(stream.WaitForRenders(2, kTimeoutMs));
+  scheduler->RemoveStream(&stream);
+  VideoRenderScheduler::Release();
+}
+
+TEST(VideoRenderSchedulerTest, RemovedStreamIsNotRendered) {
+  VideoRenderScheduler* scheduler = VideoRenderScheduler::Acquire();
+  FakeStream stream(1);
+  scheduler->AddStream(&stream, 0);
+  EXPECT_TRUE(stream.WaitForRenders(2, kTimeoutMs));
+  scheduler->RemoveStream(&stream);
+  const int renders = stream.renders();
+  scheduler->WakeStream(&stream);
+  EXPECT_FALSE(stream.WaitForRenders(renders + 1, 100));
+  VideoRenderScheduler::Release();
+}
+
+}  // namespace webrtc
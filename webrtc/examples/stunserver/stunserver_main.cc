@@ -12,7 +12,10 @@
 #include <errno.h>
 #endif  // WEBRTC_POSIX
 
+#include <stdlib.h>
+
 #include <iostream>
+#include <vector>
 
 #include "webrtc/p2p/base/stunserver.h"
 #include "webrtc/base/thread.h"
@@ -20,8 +23,8 @@
 using cricket::StunServer;
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    std::cerr << "usage: stunserver address" << std::endl;
+  if (argc != 2 && argc != 3) {
+    std::cerr << "usage: stunserver address [threads]" << std::endl;
     return 1;
   }
 
@@ -31,21 +34,58 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  int num_threads = argc == 3 ? atoi(argv[2]) : 1;
+  if (num_threads < 1) {
+    std::cerr << "Invalid number of threads: " << argv[2] << std::endl;
+    return 1;
+  }
+
+  // With more than one thread, every thread serves a socket of its own, all
+  // bound to |server_addr| with SO_REUSEPORT, and the kernel spreads the
+  // clients over them.
   rtc::Thread *pthMain = rtc::Thread::Current();
+  std::vector<rtc::Thread*> threads(1, pthMain);
+  for (int i = 1; i < num_threads; ++i)
+    threads.push_back(new rtc::Thread());
 
-  rtc::AsyncUDPSocket* server_socket =
-      rtc::AsyncUDPSocket::Create(pthMain->socketserver(), server_addr);
-  if (!server_socket) {
-    std::cerr << "Failed to create a UDP socket" << std::endl;
-    return 1;
+  std::vector<StunServer*> servers;
+  for (rtc::Thread* thread : threads) {
+    rtc::AsyncSocket* socket = thread->socketserver()->CreateAsyncSocket(
+        server_addr.family(), SOCK_DGRAM);
+    if (!socket) {
+      std::cerr << "Failed to create a UDP socket" << std::endl;
+      return 1;
+    }
+    if (num_threads > 1 &&
+        socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) != 0) {
+      std::cerr << "Failed to share the address between threads" << std::endl;
+      return 1;
+    }
+    rtc::AsyncUDPSocket* server_socket =
+        rtc::AsyncUDPSocket::Create(socket, server_addr);
+    if (!server_socket) {
+      std::cerr << "Failed to bind a UDP socket" << std::endl;
+      return 1;
+    }
+
+    StunServer* server = new StunServer(server_socket);
+    server->set_fast_binding_responses(true);
+    servers.push_back(server);
   }
 
-  StunServer* server = new StunServer(server_socket);
+  for (size_t i = 1; i < threads.size(); ++i)
+    threads[i]->Start();
 
-  std::cout << "Listening at " << server_addr.ToString() << std::endl;
+  std::cout << "Listening at " << server_addr.ToString() << " on "
+            << num_threads << " thread(s)" << std::endl;
 
   pthMain->Run();
 
-  delete server;
+  for (size_t i = 1; i < threads.size(); ++i)
+    threads[i]->Stop();
+  for (StunServer* server : servers)
+    delete server;
+  for (size_t i = 1; i < threads.size(); ++i)
+    delete threads[i];
   return 0;
 }
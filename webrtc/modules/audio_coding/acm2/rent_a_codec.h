@@ -140,6 +140,7 @@ class RentACodec {
     kDecoderArbitrary,
     kDecoderOpus,
     kDecoderOpus_2ch,
+    kDecoderOpus_6ch,
   };
 
   static inline size_t NumberOfCodecs() {
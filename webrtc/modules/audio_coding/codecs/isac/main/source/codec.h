@@ -228,6 +228,27 @@ void WebRtcIsac_NormLatticeFilterAr(int orderCoef, float* stateF, float* stateG,
 
 void WebRtcIsac_Dir2Lat(double* a, int orderCoef, float* sth, float* cth);
 
-void WebRtcIsac_AutoCorr(double* r, const double* x, size_t N, size_t order);
+/******************************* correlations ********************************/
+
+/* Computes the autocorrelation r[lag] = sum_n x[n] * x[n + lag] of the |N|
+ * samples in |x|, for lag = 0, ..., |order|. */
+typedef void (*WebRtcIsacAutoCorr)(double* r, const double* x, size_t N,
+                                   size_t order);
+extern WebRtcIsacAutoCorr WebRtcIsac_AutoCorr;
+
+/* Computes the cross-correlation r[lag] = sum_n x[n] * y[n + lag], with n from
+ * 0 to |N| - 1, for lag = 0, ..., |num_lags| - 1. */
+typedef void (*WebRtcIsacCrossCorr)(double* r, const double* x,
+                                    const double* y, size_t N,
+                                    size_t num_lags);
+extern WebRtcIsacCrossCorr WebRtcIsac_CrossCorr;
+
+/* Points the functions above to the fastest version for the CPU. All versions
+ * give bit-exact results, since each correlation is summed in the same order.
+ */
+void WebRtcIsac_InitFunctionPointers(void);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIsac_InitSse2(void);
+#endif
 
 #endif /* WEBRTC_MODULES_AUDIO_CODING_CODECS_ISAC_MAIN_SOURCE_CODEC_H_ */
@@ -16,6 +16,7 @@
 #include "pitch_estimator.h"
 #include "lpc_analysis.h"
 #include "codec.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 
 
@@ -95,7 +96,7 @@ void WebRtcIsac_ZeroPoleFilter(double* In,
 }
 
 
-void WebRtcIsac_AutoCorr(double* r, const double* x, size_t N, size_t order) {
+static void AutoCorrC(double* r, const double* x, size_t N, size_t order) {
   size_t  lag, n;
   double sum, prod;
   const double *x_lag;
@@ -115,6 +116,34 @@ void WebRtcIsac_AutoCorr(double* r, const double* x, size_t N, size_t order) {
 
 }
 
+static void CrossCorrC(double* r, const double* x, const double* y, size_t N,
+                       size_t num_lags) {
+  size_t lag, n;
+  double sum;
+
+  for (lag = 0; lag < num_lags; lag++) {
+    sum = 0.0;
+    for (n = 0; n < N; n++) {
+      sum += x[n] * y[n + lag];
+    }
+    r[lag] = sum;
+  }
+}
+
+WebRtcIsacAutoCorr WebRtcIsac_AutoCorr = AutoCorrC;
+WebRtcIsacCrossCorr WebRtcIsac_CrossCorr = CrossCorrC;
+
+void WebRtcIsac_InitFunctionPointers(void) {
+  WebRtcIsac_AutoCorr = AutoCorrC;
+  WebRtcIsac_CrossCorr = CrossCorrC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcIsac_InitSse2();
+  }
+#endif
+}
+
 
 void WebRtcIsac_BwExpand(double* out, double* in, double coef, size_t length) {
   size_t i;
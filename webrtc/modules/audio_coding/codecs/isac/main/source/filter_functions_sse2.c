@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * SSE2 versions of the correlation functions. Instead of splitting one sum
+ * over several lanes, which would change the order of the additions, each lane
+ * computes the sum for its own lag in the same order as the C versions. The
+ * results are therefore bit-exact.
+ */
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+
+/*
+ * Computes r[i] = sum_n x[n] * y[n + i], with n from 0 to
+ * |length| - |shrink| * i - 1, for the 2 * |num_vectors| lags i = 0, 1, ....
+ * With |shrink| = 1, each lag has one term less than the previous one, as in
+ * an autocorrelation. |num_vectors| must be at most 4.
+ */
+static __inline void CorrelateLags(const double* x,
+                                   const double* y,
+                                   size_t length,
+                                   size_t shrink,
+                                   int num_vectors,
+                                   double* r) {
+  const int num_lags = 2 * num_vectors;
+  const size_t common_length = length - shrink * (num_lags - 1);
+  __m128d sums[4];
+  double lag_sums[8];
+  size_t n;
+  int i;
+
+  for (i = 0; i < num_vectors; ++i) {
+    sums[i] = _mm_setzero_pd();
+  }
+  for (n = 0; n < common_length; ++n) {
+    const __m128d xn = _mm_set1_pd(x[n]);
+    for (i = 0; i < num_vectors; ++i) {
+      sums[i] = _mm_add_pd(sums[i],
+                           _mm_mul_pd(xn, _mm_loadu_pd(&y[n + 2 * i])));
+    }
+  }
+  for (i = 0; i < num_vectors; ++i) {
+    _mm_storeu_pd(&lag_sums[2 * i], sums[i]);
+  }
+
+  /* The lower lags have a few more terms when |shrink| is set. */
+  for (i = 0; i < num_lags; ++i) {
+    for (n = common_length; n < length - shrink * i; ++n) {
+      lag_sums[i] += x[n] * y[n + i];
+    }
+    r[i] = lag_sums[i];
+  }
+}
+
+static void AutoCorrSse2(double* r, const double* x, size_t N, size_t order) {
+  size_t lag = 0;
+  size_t n;
+  double sum;
+
+  /* Eight lags at a time keep four independent additions in flight. */
+  for (; lag + 8 <= order + 1; lag += 8) {
+    CorrelateLags(x, &x[lag], N - lag, 1, 4, &r[lag]);
+  }
+  for (; lag + 2 <= order + 1; lag += 2) {
+    CorrelateLags(x, &x[lag], N - lag, 1, 1, &r[lag]);
+  }
+  if (lag <= order) {
+    sum = 0.0;
+    for (n = 0; n < N - lag; n++) {
+      sum += x[n] * x[n + lag];
+    }
+    r[lag] = sum;
+  }
+}
+
+static void CrossCorrSse2(double* r, const double* x, const double* y,
+                          size_t N, size_t num_lags) {
+  size_t lag = 0;
+  size_t n;
+  double sum;
+
+  for (; lag + 8 <= num_lags; lag += 8) {
+    CorrelateLags(x, &y[lag], N, 0, 4, &r[lag]);
+  }
+  for (; lag + 2 <= num_lags; lag += 2) {
+    CorrelateLags(x, &y[lag], N, 0, 1, &r[lag]);
+  }
+  if (lag < num_lags) {
+    sum = 0.0;
+    for (n = 0; n < N; n++) {
+      sum += x[n] * y[n + lag];
+    }
+    r[lag] = sum;
+  }
+}
+
+void WebRtcIsac_InitSse2(void) {
+  WebRtcIsac_AutoCorr = AutoCorrSse2;
+  WebRtcIsac_CrossCorr = CrossCorrSse2;
+}
@@ -288,6 +288,7 @@ int16_t WebRtcIsac_Create(ISACStruct** ISAC_main_inst) {
       instISAC->in_sample_rate_hz = 16000;
 
       WebRtcIsac_InitTransform(&instISAC->transform_tables);
+      WebRtcIsac_InitFunctionPointers();
       return 0;
     } else {
       return -1;
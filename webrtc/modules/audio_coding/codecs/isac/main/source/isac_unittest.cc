@@ -11,6 +11,9 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/codecs/isac/main/include/isac.h"
+extern "C" {
+#include "webrtc/modules/audio_coding/codecs/isac/main/source/codec.h"
+}
 #include "webrtc/test/testsupport/fileutils.h"
 
 struct WebRtcISACStruct;
@@ -108,4 +111,35 @@ TEST_F(IsacTest, IsacUpdateBWE) {
   EXPECT_EQ(0, WebRtcIsac_Free(isac_codec_));
 }
 
+// The optimized correlation functions must give exactly the same results as
+// the straightforward sums, since they change the encoded bitstream otherwise.
+TEST_F(IsacTest, CorrelationsAreBitExact) {
+  const size_t kLength = 240;
+  const size_t kMaxLags = 70;
+  double x[kLength + kMaxLags];
+  for (size_t n = 0; n < kLength + kMaxLags; ++n)
+    x[n] = speech_data_[n] / 32768.0;
+
+  WebRtcIsac_InitFunctionPointers();
+  double r[kMaxLags];
+  for (size_t order = 0; order < 16; ++order) {
+    WebRtcIsac_AutoCorr(r, x, kLength, order);
+    for (size_t lag = 0; lag <= order; ++lag) {
+      double sum = 0.0;
+      for (size_t n = 0; n < kLength - lag; ++n)
+        sum += x[n] * x[n + lag];
+      EXPECT_EQ(sum, r[lag]) << "order " << order << ", lag " << lag;
+    }
+  }
+  for (size_t num_lags = 1; num_lags <= kMaxLags; num_lags += 3) {
+    WebRtcIsac_CrossCorr(r, &x[kMaxLags], x, kLength, num_lags);
+    for (size_t lag = 0; lag < num_lags; ++lag) {
+      double sum = 0.0;
+      for (size_t n = 0; n < kLength; ++n)
+        sum += x[kMaxLags + n] * x[n + lag];
+      EXPECT_EQ(sum, r[lag]) << "num_lags " << num_lags << ", lag " << lag;
+    }
+  }
+}
+
 }  // namespace webrtc
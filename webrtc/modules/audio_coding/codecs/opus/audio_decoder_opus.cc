@@ -16,8 +16,12 @@ namespace webrtc {
 
 AudioDecoderOpus::AudioDecoderOpus(size_t num_channels)
     : channels_(num_channels) {
-  RTC_DCHECK(num_channels == 1 || num_channels == 2);
-  WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+  RTC_DCHECK(num_channels >= 1 && num_channels <= 8);
+  if (num_channels > 2) {
+    WebRtcOpus_SurroundDecoderCreate(&dec_state_, channels_);
+  } else {
+    WebRtcOpus_DecoderCreate(&dec_state_, channels_);
+  }
   WebRtcOpus_DecoderInit(dec_state_);
 }
 
@@ -82,6 +86,8 @@ int AudioDecoderOpus::PacketDurationRedundant(const uint8_t* encoded,
 
 bool AudioDecoderOpus::PacketHasFec(const uint8_t* encoded,
                                     size_t encoded_len) const {
+  if (channels_ > 2)
+    return false;  // FEC is not parsed from multistream packets.
   int fec;
   fec = WebRtcOpus_PacketHasFec(encoded, encoded_len);
   return (fec == 1);
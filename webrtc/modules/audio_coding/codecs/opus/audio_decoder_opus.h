@@ -18,6 +18,8 @@ namespace webrtc {
 
 class AudioDecoderOpus final : public AudioDecoder {
  public:
+  // More than two channels are decoded as surround sound, see
+  // WebRtcOpus_SurroundDecoderCreate().
   explicit AudioDecoderOpus(size_t num_channels);
   ~AudioDecoderOpus() override;
 
@@ -12,6 +12,7 @@
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/safe_conversions.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
 
@@ -22,6 +23,7 @@ namespace {
 const int kSampleRateHz = 48000;
 const int kMinBitrateBps = 500;
 const int kMaxBitrateBps = 512000;
+const size_t kMaxSurroundChannels = 8;
 
 AudioEncoderOpus::Config CreateConfig(const CodecInst& codec_inst) {
   AudioEncoderOpus::Config config;
@@ -79,12 +81,16 @@ double OptimizePacketLossRate(double new_loss_rate, double old_loss_rate) {
 bool AudioEncoderOpus::Config::IsOk() const {
   if (frame_size_ms <= 0 || frame_size_ms % 10 != 0)
     return false;
-  if (num_channels != 1 && num_channels != 2)
+  if (num_channels < 1 || num_channels > kMaxSurroundChannels)
+    return false;
+  if (num_channels > 2 && dtx_enabled)
     return false;
   if (bitrate_bps < kMinBitrateBps || bitrate_bps > kMaxBitrateBps)
     return false;
   if (complexity < 0 || complexity > 10)
     return false;
+  if (max_encode_load < 0.0)
+    return false;
   return true;
 }
 
@@ -145,11 +151,19 @@ AudioEncoder::EncodedInfo AudioEncoderOpus::EncodeInternal(
   }
   RTC_CHECK_EQ(input_buffer_.size(),
                Num10msFramesPerPacket() * SamplesPer10msFrame());
+  const uint64_t encode_start_us = rtc::TimeMicros();
   int status = WebRtcOpus_Encode(
       inst_, &input_buffer_[0],
       rtc::CheckedDivExact(input_buffer_.size(), config_.num_channels),
       rtc::saturated_cast<int16_t>(max_encoded_bytes), encoded);
   RTC_CHECK_GE(status, 0);  // Fails only if fed invalid data.
+  if (complexity_controller_ &&
+      complexity_controller_->Update(
+          static_cast<int64_t>(rtc::TimeMicros() - encode_start_us),
+          config_.frame_size_ms)) {
+    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(
+                        inst_, complexity_controller_->complexity()));
+  }
   input_buffer_.clear();
   EncodedInfo info;
   info.encoded_bytes = static_cast<size_t>(status);
@@ -230,8 +244,13 @@ bool AudioEncoderOpus::RecreateEncoderInstance(const Config& config) {
     RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
-                                           config.application));
+  if (config.num_channels > 2) {
+    RTC_CHECK_EQ(0, WebRtcOpus_SurroundEncoderCreate(
+                        &inst_, config.num_channels, config.application));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             config.application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, config.bitrate_bps));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -240,7 +259,19 @@ bool AudioEncoderOpus::RecreateEncoderInstance(const Config& config) {
   }
   RTC_CHECK_EQ(
       0, WebRtcOpus_SetMaxPlaybackRate(inst_, config.max_playback_rate_hz));
-  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, config.complexity));
+  // Keep the adapted complexity when only other settings change.
+  if (config.max_encode_load <= 0.0) {
+    complexity_controller_.reset();
+  } else if (!complexity_controller_ ||
+             config.complexity != config_.complexity ||
+             config.max_encode_load != config_.max_encode_load) {
+    complexity_controller_.reset(new OpusComplexityController(
+        config.complexity, config.max_encode_load));
+  }
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(
+                      inst_, complexity_controller_
+                                 ? complexity_controller_->complexity()
+                                 : config.complexity));
   if (config.dtx_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableDtx(inst_));
   } else {
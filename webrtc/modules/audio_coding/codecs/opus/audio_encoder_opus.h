@@ -14,6 +14,8 @@
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_complexity_controller.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
 #include "webrtc/modules/audio_coding/codecs/audio_encoder.h"
 
@@ -26,11 +28,16 @@ class AudioEncoderOpus final : public AudioEncoder {
   enum ApplicationMode {
     kVoip = 0,
     kAudio = 1,
+    // CELT only, with the lowest algorithmic delay (2.5 ms look-ahead instead
+    // of 6.5 ms). Meant for interactive music.
+    kLowDelay = 2,
   };
 
   struct Config {
     bool IsOk() const;
     int frame_size_ms = 20;
+    // More than two channels (up to 8, in Vorbis channel order) are coded as
+    // surround sound with a multistream encoder, which does not support DTX.
     size_t num_channels = 1;
     int payload_type = 120;
     ApplicationMode application = kVoip;
@@ -38,6 +45,10 @@ class AudioEncoderOpus final : public AudioEncoder {
     bool fec_enabled = false;
     int max_playback_rate_hz = 48000;
     int complexity = kDefaultComplexity;
+    // If positive, the complexity is adapted to the measured encode time so
+    // that encoding takes at most this fraction of real time, and |complexity|
+    // is the highest complexity used. See OpusComplexityController.
+    double max_encode_load = 0.0;
     bool dtx_enabled = false;
 
    private:
@@ -94,6 +105,7 @@ class AudioEncoderOpus final : public AudioEncoder {
   std::vector<int16_t> input_buffer_;
   OpusEncInst* inst_;
   uint32_t first_timestamp_in_buffer_;
+  rtc::scoped_ptr<OpusComplexityController> complexity_controller_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderOpus);
 };
 
@@ -76,6 +76,13 @@ TEST_F(AudioEncoderOpusTest, ToggleDtx) {
   EXPECT_TRUE(encoder_->SetDtx(false));
 }
 
+TEST_F(AudioEncoderOpusTest, SurroundRejectsDtx) {
+  CreateCodec(6);
+  EXPECT_EQ(6u, encoder_->NumChannels());
+  EXPECT_FALSE(encoder_->SetDtx(true));
+  EXPECT_FALSE(encoder_->dtx_enabled());
+}
+
 TEST_F(AudioEncoderOpusTest, SetBitrate) {
   CreateCodec(1);
   // Constants are replicated from audio_encoder_opus.cc.
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/codecs/opus/opus_complexity_controller.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+const int OpusComplexityController::kWindowMs;
+const int OpusComplexityController::kHoldWindows;
+
+OpusComplexityController::OpusComplexityController(int max_complexity,
+                                                   double max_load)
+    : max_complexity_(max_complexity),
+      max_load_(max_load),
+      complexity_(max_complexity) {
+  RTC_DCHECK_GE(max_complexity, 0);
+  RTC_DCHECK_GT(max_load, 0.0);
+}
+
+bool OpusComplexityController::Update(int64_t encode_time_us,
+                                      int audio_duration_ms) {
+  RTC_DCHECK_GT(audio_duration_ms, 0);
+  window_encode_time_us_ += encode_time_us;
+  window_audio_ms_ += audio_duration_ms;
+  if (window_audio_ms_ < kWindowMs)
+    return false;
+
+  const double load = static_cast<double>(window_encode_time_us_) /
+                      (1000.0 * window_audio_ms_);
+  window_encode_time_us_ = 0;
+  window_audio_ms_ = 0;
+  if (hold_windows_ > 0)
+    --hold_windows_;
+
+  if (load > max_load_ && complexity_ > 0) {
+    --complexity_;
+    hold_windows_ = kHoldWindows;
+    return true;
+  }
+  if (load < max_load_ / 2 && complexity_ < max_complexity_ &&
+      hold_windows_ == 0) {
+    ++complexity_;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace webrtc
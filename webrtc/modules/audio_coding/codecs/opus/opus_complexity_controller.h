@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
+#define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Adapts the Opus encoder complexity to the measured encode time, so that a
+// slow device lowers the complexity until encoding fits its CPU budget, while
+// a fast device keeps the configured complexity.
+//
+// The load, i.e., the encode time divided by the duration of the encoded
+// audio, is averaged over windows of kWindowMs of audio. After each window,
+// the complexity is lowered by one if the load exceeded |max_load|, and raised
+// by one (up to |max_complexity|) if the load was below half of |max_load|. To
+// avoid oscillating, it is not raised again for kHoldWindows windows after it
+// has been lowered.
+class OpusComplexityController {
+ public:
+  static const int kWindowMs = 1000;
+  static const int kHoldWindows = 10;
+
+  OpusComplexityController(int max_complexity, double max_load);
+
+  // Reports that encoding |audio_duration_ms| of audio took |encode_time_us|.
+  // Returns true if complexity() changed.
+  bool Update(int64_t encode_time_us, int audio_duration_ms);
+
+  int complexity() const { return complexity_; }
+
+ private:
+  const int max_complexity_;
+  const double max_load_;
+  int complexity_;
+  int64_t window_encode_time_us_ = 0;
+  int window_audio_ms_ = 0;
+  int hold_windows_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpusComplexityController);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
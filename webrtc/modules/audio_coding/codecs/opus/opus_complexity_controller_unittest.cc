@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/codecs/opus/opus_complexity_controller.h"
+
+namespace webrtc {
+
+namespace {
+const int kFrameMs = 20;
+const int kFramesPerWindow = OpusComplexityController::kWindowMs / kFrameMs;
+
+// Feeds one window of frames which each take |encode_time_us| to encode.
+// Returns true if the complexity changed at the end of the window.
+bool RunWindow(OpusComplexityController* controller, int64_t encode_time_us) {
+  for (int i = 0; i < kFramesPerWindow - 1; ++i)
+    EXPECT_FALSE(controller->Update(encode_time_us, kFrameMs));
+  return controller->Update(encode_time_us, kFrameMs);
+}
+}  // namespace
+
+TEST(OpusComplexityControllerTest, StartsAtMaxComplexity) {
+  OpusComplexityController controller(9, 0.1);
+  EXPECT_EQ(9, controller.complexity());
+  // Fast encoding keeps the maximum.
+  EXPECT_FALSE(RunWindow(&controller, 100));
+  EXPECT_EQ(9, controller.complexity());
+}
+
+TEST(OpusComplexityControllerTest, LowersComplexityWhenOverloaded) {
+  // 10% of a 20 ms frame is 2000 us.
+  OpusComplexityController controller(9, 0.1);
+  EXPECT_TRUE(RunWindow(&controller, 3000));
+  EXPECT_EQ(8, controller.complexity());
+  EXPECT_TRUE(RunWindow(&controller, 3000));
+  EXPECT_EQ(7, controller.complexity());
+  // Between half and the full budget, the complexity stays.
+  EXPECT_FALSE(RunWindow(&controller, 1500));
+  EXPECT_EQ(7, controller.complexity());
+}
+
+TEST(OpusComplexityControllerTest, NeverBelowZero) {
+  OpusComplexityController controller(1, 0.1);
+  EXPECT_TRUE(RunWindow(&controller, 3000));
+  EXPECT_EQ(0, controller.complexity());
+  EXPECT_FALSE(RunWindow(&controller, 3000));
+  EXPECT_EQ(0, controller.complexity());
+}
+
+TEST(OpusComplexityControllerTest, RaisesComplexityAfterHoldTime) {
+  OpusComplexityController controller(9, 0.1);
+  EXPECT_TRUE(RunWindow(&controller, 3000));
+  EXPECT_EQ(8, controller.complexity());
+  // Right after lowering, the complexity is not raised again.
+  for (int i = 0; i < OpusComplexityController::kHoldWindows - 1; ++i)
+    EXPECT_FALSE(RunWindow(&controller, 100));
+  EXPECT_EQ(8, controller.complexity());
+  EXPECT_TRUE(RunWindow(&controller, 100));
+  EXPECT_EQ(9, controller.complexity());
+  // Never above the maximum.
+  EXPECT_FALSE(RunWindow(&controller, 100));
+  EXPECT_EQ(9, controller.complexity());
+}
+
+}  // namespace webrtc
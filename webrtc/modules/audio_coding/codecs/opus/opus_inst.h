@@ -14,9 +14,13 @@
 #include <stddef.h>
 
 #include "opus.h"
+#include "opus_multistream.h"
 
 struct WebRtcOpusEncInst {
+  // Exactly one of |encoder| and |multistream_encoder| is set; the latter is
+  // used for surround sound, i.e., more than two channels.
   OpusEncoder* encoder;
+  OpusMSEncoder* multistream_encoder;
   size_t channels;
   int in_dtx_mode;
   // When Opus is in DTX mode, we use |zero_counts| to count consecutive zeros
@@ -28,7 +32,9 @@ struct WebRtcOpusEncInst {
 };
 
 struct WebRtcOpusDecInst {
+  // Exactly one of |decoder| and |multistream_decoder| is set.
   OpusDecoder* decoder;
+  OpusMSDecoder* multistream_decoder;
   int prev_decoded_samples;
   size_t channels;
   int in_dtx_mode;
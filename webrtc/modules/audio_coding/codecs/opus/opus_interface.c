@@ -31,6 +31,10 @@ enum {
   /* Default frame size, 20 ms @ 48 kHz, in samples (for one channel). */
   kWebRtcOpusDefaultFrameSize = 960,
 
+  /* Maximum number of channels of the surround (multistream) codec. This is
+   * the largest layout of channel mapping family 1, i.e., 7.1 surround. */
+  kWebRtcOpusMaxSurroundChannels = 8,
+
   // Maximum number of consecutive zeros, beyond or equal to which DTX can fail.
   kZeroBreakCount = 157,
 
@@ -41,23 +45,61 @@ enum {
 #endif
 };
 
-int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
-                                 size_t channels,
-                                 int32_t application) {
-  int opus_app;
-  if (!inst)
-    return -1;
+/* Stream layouts of channel mapping family 1 (Vorbis channel order), indexed
+ * by the number of channels minus one. These are the layouts which
+ * opus_multistream_surround_encoder_create() picks, so the decoder can be set
+ * up from the number of channels alone. */
+static const struct {
+  int streams;
+  int coupled_streams;
+  unsigned char mapping[kWebRtcOpusMaxSurroundChannels];
+} kSurroundLayouts[kWebRtcOpusMaxSurroundChannels] = {
+  {1, 0, {0}},                       /* Mono. */
+  {1, 1, {0, 1}},                    /* Stereo. */
+  {2, 1, {0, 2, 1}},                 /* 1-d surround. */
+  {2, 2, {0, 1, 2, 3}},              /* Quadraphonic. */
+  {3, 2, {0, 4, 1, 2, 3}},           /* 5.0 surround. */
+  {4, 2, {0, 4, 1, 2, 3, 5}},        /* 5.1 surround. */
+  {4, 3, {0, 4, 1, 2, 3, 5, 6}},     /* 6.1 surround. */
+  {5, 3, {0, 6, 1, 2, 3, 4, 5, 7}},  /* 7.1 surround. */
+};
+
+/* Forward a ctl request to whichever of the single and multistream states the
+ * instance uses. */
+#define ENCODER_CTL(inst, vargs)                                              \
+  ((inst)->encoder                                                            \
+       ? opus_encoder_ctl((inst)->encoder, vargs)                             \
+       : opus_multistream_encoder_ctl((inst)->multistream_encoder, vargs))
 
+#define DECODER_CTL(inst, vargs)                                              \
+  ((inst)->decoder                                                            \
+       ? opus_decoder_ctl((inst)->decoder, vargs)                             \
+       : opus_multistream_decoder_ctl((inst)->multistream_decoder, vargs))
+
+/* Maps the WebRTC application mode to the Opus one. Returns -1 if invalid. */
+static int OpusApplication(int32_t application) {
   switch (application) {
     case 0:
-      opus_app = OPUS_APPLICATION_VOIP;
-      break;
+      return OPUS_APPLICATION_VOIP;
     case 1:
-      opus_app = OPUS_APPLICATION_AUDIO;
-      break;
+      return OPUS_APPLICATION_AUDIO;
+    case 2:
+      return OPUS_APPLICATION_RESTRICTED_LOWDELAY;
     default:
       return -1;
   }
+}
+
+int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
+                                 size_t channels,
+                                 int32_t application) {
+  int opus_app;
+  if (!inst)
+    return -1;
+
+  opus_app = OpusApplication(application);
+  if (opus_app < 0)
+    return -1;
 
   OpusEncInst* state = calloc(1, sizeof(OpusEncInst));
   assert(state);
@@ -81,9 +123,50 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   return 0;
 }
 
+int16_t WebRtcOpus_SurroundEncoderCreate(OpusEncInst** inst,
+                                         size_t channels,
+                                         int32_t application) {
+  int opus_app;
+  if (!inst || channels == 0 || channels > kWebRtcOpusMaxSurroundChannels)
+    return -1;
+
+  opus_app = OpusApplication(application);
+  if (opus_app < 0)
+    return -1;
+
+  OpusEncInst* state = calloc(1, sizeof(OpusEncInst));
+  assert(state);
+
+  state->zero_counts = calloc(channels, sizeof(size_t));
+  assert(state->zero_counts);
+
+  int error;
+  int streams;
+  int coupled_streams;
+  unsigned char mapping[kWebRtcOpusMaxSurroundChannels];
+  state->multistream_encoder = opus_multistream_surround_encoder_create(
+      48000, (int)channels, 1, &streams, &coupled_streams, mapping, opus_app,
+      &error);
+  if (error != OPUS_OK || !state->multistream_encoder) {
+    WebRtcOpus_EncoderFree(state);
+    return -1;
+  }
+  assert(streams == kSurroundLayouts[channels - 1].streams);
+  assert(coupled_streams == kSurroundLayouts[channels - 1].coupled_streams);
+
+  state->in_dtx_mode = 0;
+  state->channels = channels;
+
+  *inst = state;
+  return 0;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder)
+      opus_encoder_destroy(inst->encoder);
+    if (inst->multistream_encoder)
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
     free(inst->zero_counts);
     free(inst);
     return 0;
@@ -111,8 +194,9 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
   int use_buffer = 0;
 
   // Break long consecutive zeros by forcing a "1" every |kZeroBreakCount|
-  // samples.
-  if (inst->in_dtx_mode) {
+  // samples. DTX is not available for surround, so |buffer| only needs to
+  // hold stereo.
+  if (inst->in_dtx_mode && inst->encoder) {
     for (i = 0; i < samples; ++i) {
       for (c = 0; c < channels; ++c) {
         if (audio_in[i * channels + c] == 0) {
@@ -132,11 +216,19 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
     }
   }
 
-  res = opus_encode(inst->encoder,
-                    use_buffer ? buffer : audio_in,
-                    (int)samples,
-                    encoded,
-                    (opus_int32)length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder,
+                      use_buffer ? buffer : audio_in,
+                      (int)samples,
+                      encoded,
+                      (opus_int32)length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder,
+                                  audio_in,
+                                  (int)samples,
+                                  encoded,
+                                  (opus_int32)length_encoded_buffer);
+  }
 
   if (res == 1) {
     // Indicates DTX since the packet has nothing but a header. In principle,
@@ -158,7 +250,7 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -166,8 +258,7 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return ENCODER_CTL(inst, OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -190,13 +281,12 @@ int16_t WebRtcOpus_SetMaxPlaybackRate(OpusEncInst* inst, int32_t frequency_hz) {
   } else {
     set_bandwidth = OPUS_BANDWIDTH_FULLBAND;
   }
-  return opus_encoder_ctl(inst->encoder,
-                          OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
+  return ENCODER_CTL(inst, OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
 }
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -204,14 +294,15 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
 }
 
 int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
-  if (!inst) {
+  if (!inst || !inst->encoder) {
+    // DTX is not supported for surround.
     return -1;
   }
 
@@ -220,21 +311,19 @@ int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
   // last long during a pure silence, if the signal type is not forced.
   // TODO(minyue): Remove the signal type forcing when Opus DTX works properly
   // without it.
-  int ret = opus_encoder_ctl(inst->encoder,
-                             OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+  int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
   if (ret != OPUS_OK)
     return ret;
 
-  return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(1));
+  return ENCODER_CTL(inst, OPUS_SET_DTX(1));
 }
 
 int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
   if (inst) {
-    int ret = opus_encoder_ctl(inst->encoder,
-                               OPUS_SET_SIGNAL(OPUS_AUTO));
+    int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_AUTO));
     if (ret != OPUS_OK)
       return ret;
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(0));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(0));
   } else {
     return -1;
   }
@@ -242,7 +331,7 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
@@ -279,9 +368,38 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, size_t channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_SurroundDecoderCreate(OpusDecInst** inst, size_t channels) {
+  int error;
+  OpusDecInst* state;
+
+  if (!inst || channels == 0 || channels > kWebRtcOpusMaxSurroundChannels)
+    return -1;
+
+  state = (OpusDecInst*) calloc(1, sizeof(OpusDecInst));
+  if (state == NULL)
+    return -1;
+
+  state->multistream_decoder = opus_multistream_decoder_create(
+      48000, (int)channels, kSurroundLayouts[channels - 1].streams,
+      kSurroundLayouts[channels - 1].coupled_streams,
+      kSurroundLayouts[channels - 1].mapping, &error);
+  if (error != OPUS_OK || state->multistream_decoder == NULL) {
+    WebRtcOpus_DecoderFree(state);
+    return -1;
+  }
+  state->channels = channels;
+  state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+  state->in_dtx_mode = 0;
+  *inst = state;
+  return 0;
+}
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
-    opus_decoder_destroy(inst->decoder);
+    if (inst->decoder)
+      opus_decoder_destroy(inst->decoder);
+    if (inst->multistream_decoder)
+      opus_multistream_decoder_destroy(inst->multistream_decoder);
     free(inst);
     return 0;
   } else {
@@ -294,7 +412,7 @@ size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 }
 
 void WebRtcOpus_DecoderInit(OpusDecInst* inst) {
-  opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
+  DECODER_CTL(inst, OPUS_RESET_STATE);
   inst->in_dtx_mode = 0;
 }
 
@@ -319,8 +437,15 @@ static int16_t DetermineAudioType(OpusDecInst* inst, size_t encoded_bytes) {
 static int DecodeNative(OpusDecInst* inst, const uint8_t* encoded,
                         size_t encoded_bytes, int frame_size,
                         int16_t* decoded, int16_t* audio_type, int decode_fec) {
-  int res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
-                        (opus_int16*)decoded, frame_size, decode_fec);
+  int res;
+  if (inst->decoder) {
+    res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
+                      (opus_int16*)decoded, frame_size, decode_fec);
+  } else {
+    res = opus_multistream_decode(inst->multistream_decoder, encoded,
+                                  (opus_int32)encoded_bytes,
+                                  (opus_int16*)decoded, frame_size, decode_fec);
+  }
 
   if (res <= 0)
     return -1;
@@ -384,7 +509,9 @@ int WebRtcOpus_DecodeFec(OpusDecInst* inst, const uint8_t* encoded,
   int decoded_samples;
   int fec_samples;
 
-  if (WebRtcOpus_PacketHasFec(encoded, encoded_bytes) != 1) {
+  /* WebRtcOpus_PacketHasFec() only parses single stream packets. */
+  if (inst->multistream_decoder ||
+      WebRtcOpus_PacketHasFec(encoded, encoded_bytes) != 1) {
     return 0;
   }
 
@@ -34,6 +34,8 @@ typedef struct WebRtcOpusDecInst OpusDecInst;
  *                                 Favor speech intelligibility.
  *                             1 - Audio applications.
  *                                 Favor faithfulness to the original input.
+ *                             2 - Restricted low delay. CELT only, with
+ *                                 the lowest algorithmic delay.
  *
  * Output:
  *      - inst               : a pointer to Encoder context that is created
@@ -46,6 +48,35 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application);
 
+/****************************************************************************
+ * WebRtcOpus_SurroundEncoderCreate(...)
+ *
+ * This function creates a multistream Opus encoder for surround sound. The
+ * channels are coded in coupled pairs and single streams as given by the Opus
+ * channel mapping family 1, and the input must be in Vorbis channel order
+ * (e.g., L, C, R, rear L, rear R, LFE for 5.1). All streams go into one
+ * packet. DTX is not supported.
+ *
+ * Input:
+ *      - channels           : number of channels, 1 to 8.
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *                             2 - Restricted low delay. CELT only, with
+ *                                 the lowest algorithmic delay.
+ *
+ * Output:
+ *      - inst               : a pointer to Encoder context that is created
+ *                             if success.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_SurroundEncoderCreate(OpusEncInst** inst,
+                                         size_t channels,
+                                         int32_t application);
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
 /****************************************************************************
@@ -196,6 +227,21 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst);
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity);
 
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, size_t channels);
+
+/****************************************************************************
+ * WebRtcOpus_SurroundDecoderCreate(...)
+ *
+ * Creates a decoder for the packets of WebRtcOpus_SurroundEncoderCreate()
+ * with the same number of channels. The decoded audio is in Vorbis channel
+ * order. In-band FEC is not decoded, i.e., WebRtcOpus_DecodeFec() returns 0.
+ *
+ * Input:
+ *      - channels           : number of channels, 1 to 8.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_SurroundDecoderCreate(OpusDecInst** inst, size_t channels);
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
 /****************************************************************************
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <string>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/checks.h"
@@ -303,7 +304,7 @@ TEST(OpusTest, OpusCreateFail) {
   // Invalid channel number.
   EXPECT_EQ(-1, WebRtcOpus_EncoderCreate(&opus_encoder, 3, 0));
   // Invalid applciation mode.
-  EXPECT_EQ(-1, WebRtcOpus_EncoderCreate(&opus_encoder, 1, 2));
+  EXPECT_EQ(-1, WebRtcOpus_EncoderCreate(&opus_encoder, 1, 3));
 
   EXPECT_EQ(-1, WebRtcOpus_DecoderCreate(NULL, 1));
   // Invalid channel number.
@@ -666,6 +667,62 @@ TEST_P(OpusTest, OpusDecodeRepacketized) {
   EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder_));
 }
 
+// Encode and decode 5.1 surround sound, all channels in one packet.
+TEST(OpusTest, OpusSurroundEncodeDecode) {
+  const size_t kChannels = 6;
+  WebRtcOpusEncInst* opus_encoder;
+  WebRtcOpusDecInst* opus_decoder;
+
+  // Invalid channel numbers.
+  EXPECT_EQ(-1, WebRtcOpus_SurroundEncoderCreate(&opus_encoder, 0, 1));
+  EXPECT_EQ(-1, WebRtcOpus_SurroundEncoderCreate(&opus_encoder, 9, 1));
+  EXPECT_EQ(-1, WebRtcOpus_SurroundDecoderCreate(&opus_decoder, 9));
+
+  ASSERT_EQ(0, WebRtcOpus_SurroundEncoderCreate(&opus_encoder, kChannels, 1));
+  ASSERT_EQ(0, WebRtcOpus_SurroundDecoderCreate(&opus_decoder, kChannels));
+  EXPECT_EQ(kChannels, WebRtcOpus_DecoderChannels(opus_decoder));
+  EXPECT_EQ(0, WebRtcOpus_SetBitRate(opus_encoder, 192000));
+  EXPECT_EQ(0, WebRtcOpus_SetComplexity(opus_encoder, 9));
+  // DTX is not supported for surround.
+  EXPECT_EQ(-1, WebRtcOpus_EnableDtx(opus_encoder));
+
+  // Feed the same speech to all channels.
+  AudioLoop speech_data;
+  ASSERT_TRUE(speech_data.Init(
+      webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm"),
+      10 * kOpus20msFrameSamples, kOpus20msFrameSamples));
+  std::vector<int16_t> input(kOpus20msFrameSamples * kChannels);
+  std::vector<int16_t> output(kOpus20msFrameSamples * kChannels);
+  uint8_t bitstream[kMaxBytes];
+  int16_t audio_type;
+  for (int i = 0; i < 10; ++i) {
+    rtc::ArrayView<const int16_t> mono = speech_data.GetNextBlock();
+    for (size_t n = 0; n < kOpus20msFrameSamples; ++n) {
+      for (size_t c = 0; c < kChannels; ++c)
+        input[n * kChannels + c] = mono[n];
+    }
+    int encoded_bytes = WebRtcOpus_Encode(opus_encoder, input.data(),
+                                          kOpus20msFrameSamples, kMaxBytes,
+                                          bitstream);
+    ASSERT_GT(encoded_bytes, 0);
+    EXPECT_EQ(static_cast<int>(kOpus20msFrameSamples),
+              WebRtcOpus_DurationEst(opus_decoder, bitstream,
+                                     static_cast<size_t>(encoded_bytes)));
+    EXPECT_EQ(static_cast<int>(kOpus20msFrameSamples),
+              WebRtcOpus_Decode(opus_decoder, bitstream,
+                                static_cast<size_t>(encoded_bytes),
+                                output.data(), &audio_type));
+    EXPECT_EQ(0, audio_type);  // Speech.
+  }
+
+  // Packet loss concealment covers all channels.
+  EXPECT_EQ(static_cast<int>(kOpus20msFrameSamples),
+            WebRtcOpus_DecodePlc(opus_decoder, output.data(), 1));
+
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(opus_encoder));
+  EXPECT_EQ(0, WebRtcOpus_DecoderFree(opus_decoder));
+}
+
 INSTANTIATE_TEST_CASE_P(VariousMode,
                         OpusTest,
                         Combine(Values(1, 2), Values(0, 1)));
@@ -0,0 +1,324 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the encode and decode time of all bundled audio codecs, over a
+// range of sample rates, channel counts, bitrates and complexities. All codecs
+// are driven through the AudioEncoder and AudioDecoder interfaces, the same way
+// the ACM and NetEq use them. For each case, the results are printed as
+// RESULT lines (see test/testsupport/perf_test.h):
+//   audio_encode_time / audio_decode_time: nanoseconds per 10 ms of audio.
+//   audio_encode_speed / audio_decode_speed: real-time factor on one core,
+//       i.e., seconds of audio processed per second of CPU time.
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/audio_coding/codecs/cng/audio_encoder_cng.h"
+#include "webrtc/modules/audio_coding/codecs/cng/webrtc_cng.h"
+#include "webrtc/modules/audio_coding/codecs/g711/audio_decoder_pcm.h"
+#include "webrtc/modules/audio_coding/codecs/g711/audio_encoder_pcm.h"
+#include "webrtc/modules/audio_coding/codecs/g722/audio_decoder_g722.h"
+#include "webrtc/modules/audio_coding/codecs/g722/audio_encoder_g722.h"
+#include "webrtc/modules/audio_coding/codecs/ilbc/audio_decoder_ilbc.h"
+#include "webrtc/modules/audio_coding/codecs/ilbc/audio_encoder_ilbc.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/include/audio_decoder_isacfix.h"
+#include "webrtc/modules/audio_coding/codecs/isac/fix/include/audio_encoder_isacfix.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/include/audio_decoder_isac.h"
+#include "webrtc/modules/audio_coding/codecs/isac/main/include/audio_encoder_isac.h"
+#include "webrtc/modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "webrtc/modules/audio_coding/codecs/opus/audio_encoder_opus.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/audio_decoder_pcm16b.h"
+#include "webrtc/modules/audio_coding/codecs/pcm16b/audio_encoder_pcm16b.h"
+#include "webrtc/modules/audio_coding/codecs/red/audio_encoder_copy_red.h"
+#include "webrtc/modules/audio_coding/neteq/tools/resample_input_audio_file.h"
+#include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+// Duration of audio coded in each case.
+const int kDurationMs = 10000;
+const int kCngPayloadType = 13;
+// Largest decoder output per packet and channel: 120 ms at 48 kHz.
+const size_t kMaxDecodedSamplesPerChannel = 48 * 120;
+
+enum class Codec {
+  kPcmU,
+  kPcmA,
+  kPcm16B,
+  kG722,
+  kIlbc,
+  kIsac,
+  kIsacFix,
+  kOpus,
+  kCng,  // PCM16B with VAD and comfort noise.
+  kRed,  // Opus with one redundant copy.
+};
+
+struct BenchmarkCase {
+  const char* name;
+  Codec codec;
+  int sample_rate_hz;
+  size_t num_channels;
+  int frame_size_ms;
+  int bitrate_bps;  // Ignored by fixed-rate codecs.
+  int complexity;   // Opus only.
+};
+
+// Makes gtest print the case name instead of a byte dump.
+void PrintTo(const BenchmarkCase& benchmark_case, std::ostream* os) {
+  *os << benchmark_case.name;
+}
+
+const BenchmarkCase kCases[] = {
+    {"pcmu_8k_1ch", Codec::kPcmU, 8000, 1, 20, 64000, 0},
+    {"pcmu_8k_2ch", Codec::kPcmU, 8000, 2, 20, 128000, 0},
+    {"pcma_8k_1ch", Codec::kPcmA, 8000, 1, 20, 64000, 0},
+    {"pcm16b_8k_1ch", Codec::kPcm16B, 8000, 1, 20, 128000, 0},
+    {"pcm16b_16k_1ch", Codec::kPcm16B, 16000, 1, 20, 256000, 0},
+    {"pcm16b_32k_1ch", Codec::kPcm16B, 32000, 1, 20, 512000, 0},
+    {"pcm16b_48k_2ch", Codec::kPcm16B, 48000, 2, 20, 1536000, 0},
+    {"g722_16k_1ch", Codec::kG722, 16000, 1, 20, 64000, 0},
+    {"g722_16k_2ch", Codec::kG722, 16000, 2, 20, 128000, 0},
+    {"ilbc_8k_20ms", Codec::kIlbc, 8000, 1, 20, 15200, 0},
+    {"ilbc_8k_30ms", Codec::kIlbc, 8000, 1, 30, 13330, 0},
+    {"isac_16k_32kbps", Codec::kIsac, 16000, 1, 30, 32000, 0},
+    {"isac_16k_10kbps", Codec::kIsac, 16000, 1, 30, 10000, 0},
+    {"isac_32k_56kbps", Codec::kIsac, 32000, 1, 30, 56000, 0},
+    {"isacfix_16k_32kbps", Codec::kIsacFix, 16000, 1, 30, 32000, 0},
+    {"isacfix_16k_10kbps", Codec::kIsacFix, 16000, 1, 30, 10000, 0},
+    {"opus_48k_1ch_32kbps_c0", Codec::kOpus, 48000, 1, 20, 32000, 0},
+    {"opus_48k_1ch_32kbps_c5", Codec::kOpus, 48000, 1, 20, 32000, 5},
+    {"opus_48k_1ch_32kbps_c9", Codec::kOpus, 48000, 1, 20, 32000, 9},
+    {"opus_48k_1ch_32kbps_c10", Codec::kOpus, 48000, 1, 20, 32000, 10},
+    {"opus_48k_1ch_16kbps_c9", Codec::kOpus, 48000, 1, 20, 16000, 9},
+    {"opus_48k_1ch_32kbps_c9_10ms", Codec::kOpus, 48000, 1, 10, 32000, 9},
+    {"opus_48k_2ch_64kbps_c9", Codec::kOpus, 48000, 2, 20, 64000, 9},
+    {"opus_48k_2ch_128kbps_c9", Codec::kOpus, 48000, 2, 20, 128000, 9},
+    {"cng_16k_1ch", Codec::kCng, 16000, 1, 20, 256000, 0},
+    {"red_opus_48k_1ch_32kbps_c9", Codec::kRed, 48000, 1, 20, 32000, 9},
+};
+
+class AudioCodecBenchmark : public ::testing::TestWithParam<BenchmarkCase> {
+ protected:
+  void SetUp() override {
+    const BenchmarkCase& c = GetParam();
+    switch (c.codec) {
+      case Codec::kPcmU: {
+        AudioEncoderPcmU::Config config;
+        config.frame_size_ms = c.frame_size_ms;
+        config.num_channels = c.num_channels;
+        encoder_.reset(new AudioEncoderPcmU(config));
+        decoder_.reset(new AudioDecoderPcmU(c.num_channels));
+        break;
+      }
+      case Codec::kPcmA: {
+        AudioEncoderPcmA::Config config;
+        config.frame_size_ms = c.frame_size_ms;
+        config.num_channels = c.num_channels;
+        encoder_.reset(new AudioEncoderPcmA(config));
+        decoder_.reset(new AudioDecoderPcmA(c.num_channels));
+        break;
+      }
+      case Codec::kPcm16B:
+      case Codec::kCng: {
+        AudioEncoderPcm16B::Config config;
+        config.sample_rate_hz = c.sample_rate_hz;
+        config.frame_size_ms = c.frame_size_ms;
+        config.num_channels = c.num_channels;
+        encoder_.reset(new AudioEncoderPcm16B(config));
+        decoder_.reset(new AudioDecoderPcm16B(c.num_channels));
+        break;
+      }
+      case Codec::kG722: {
+        AudioEncoderG722::Config config;
+        config.frame_size_ms = c.frame_size_ms;
+        config.num_channels = c.num_channels;
+        encoder_.reset(new AudioEncoderG722(config));
+        if (c.num_channels == 1) {
+          decoder_.reset(new AudioDecoderG722);
+        } else {
+          decoder_.reset(new AudioDecoderG722Stereo);
+        }
+        break;
+      }
+      case Codec::kIlbc: {
+        AudioEncoderIlbc::Config config;
+        config.frame_size_ms = c.frame_size_ms;
+        encoder_.reset(new AudioEncoderIlbc(config));
+        decoder_.reset(new AudioDecoderIlbc);
+        break;
+      }
+      case Codec::kIsac: {
+        AudioEncoderIsac::Config config;
+        config.sample_rate_hz = c.sample_rate_hz;
+        config.frame_size_ms = c.frame_size_ms;
+        config.bit_rate = c.bitrate_bps;
+        encoder_.reset(new AudioEncoderIsac(config));
+        decoder_.reset(new AudioDecoderIsac);
+        break;
+      }
+      case Codec::kIsacFix: {
+        AudioEncoderIsacFix::Config config;
+        config.sample_rate_hz = c.sample_rate_hz;
+        config.frame_size_ms = c.frame_size_ms;
+        config.bit_rate = c.bitrate_bps;
+        encoder_.reset(new AudioEncoderIsacFix(config));
+        decoder_.reset(new AudioDecoderIsacFix);
+        break;
+      }
+      case Codec::kOpus:
+      case Codec::kRed: {
+        AudioEncoderOpus::Config config;
+        config.frame_size_ms = c.frame_size_ms;
+        config.num_channels = c.num_channels;
+        config.bitrate_bps = c.bitrate_bps;
+        config.complexity = c.complexity;
+        config.application = c.num_channels == 1 ? AudioEncoderOpus::kVoip
+                                                 : AudioEncoderOpus::kAudio;
+        encoder_.reset(new AudioEncoderOpus(config));
+        decoder_.reset(new AudioDecoderOpus(c.num_channels));
+        break;
+      }
+    }
+
+    // The CNG and RED encoders wrap the speech encoder created above.
+    if (c.codec == Codec::kCng) {
+      speech_encoder_.reset(encoder_.release());
+      AudioEncoderCng::Config config;
+      config.num_channels = c.num_channels;
+      config.payload_type = kCngPayloadType;
+      config.speech_encoder = speech_encoder_.get();
+      encoder_.reset(new AudioEncoderCng(config));
+      ASSERT_EQ(0, WebRtcCng_CreateDec(&cng_decoder_));
+      WebRtcCng_InitDec(cng_decoder_);
+    } else if (c.codec == Codec::kRed) {
+      speech_encoder_.reset(encoder_.release());
+      AudioEncoderCopyRed::Config config;
+      config.payload_type = 127;
+      config.speech_encoder = speech_encoder_.get();
+      encoder_.reset(new AudioEncoderCopyRed(config));
+    }
+
+    ASSERT_EQ(c.sample_rate_hz, encoder_->SampleRateHz());
+    ASSERT_EQ(c.num_channels, encoder_->NumChannels());
+    samples_per_10ms_ = static_cast<size_t>(c.sample_rate_hz / 100);
+
+    // Read the input once, so that file access is not measured. The file is
+    // mono; all channels get the same audio.
+    const size_t num_samples = samples_per_10ms_ * kDurationMs / 10;
+    std::vector<int16_t> mono(num_samples);
+    test::ResampleInputAudioFile input_file(
+        test::ResourcePath("audio_coding/testfile32kHz", "pcm"), 32000);
+    ASSERT_TRUE(input_file.Read(num_samples, c.sample_rate_hz, mono.data()));
+    input_.resize(num_samples * c.num_channels);
+    for (size_t n = 0; n < num_samples; ++n) {
+      for (size_t ch = 0; ch < c.num_channels; ++ch)
+        input_[n * c.num_channels + ch] = mono[n];
+    }
+  }
+
+  void TearDown() override {
+    if (cng_decoder_)
+      WebRtcCng_FreeDec(cng_decoder_);
+  }
+
+  // Decodes the primary payload of the packet in |encoded|, or generates
+  // comfort noise in between CNG packets. Returns the time it took.
+  uint64_t Decode(const AudioEncoder::EncodedInfo& info,
+                  uint8_t* encoded,
+                  int16_t* decoded) {
+    const BenchmarkCase& c = GetParam();
+    const size_t max_decoded_bytes =
+        kMaxDecodedSamplesPerChannel * c.num_channels * sizeof(int16_t);
+    uint64_t start_ns = rtc::TimeNanos();
+    if (info.encoded_bytes > 0 && info.payload_type == kCngPayloadType &&
+        cng_decoder_) {
+      EXPECT_EQ(0, WebRtcCng_UpdateSid(cng_decoder_, encoded,
+                                       info.encoded_bytes));
+      in_cng_ = true;
+    } else if (info.encoded_bytes > 0) {
+      // For RED, the primary encoding comes first.
+      const size_t primary_bytes = info.redundant.empty()
+                                       ? info.encoded_bytes
+                                       : info.redundant[0].encoded_bytes;
+      AudioDecoder::SpeechType speech_type;
+      EXPECT_GT(decoder_->Decode(encoded, primary_bytes, c.sample_rate_hz,
+                                 max_decoded_bytes, decoded, &speech_type),
+                0);
+      in_cng_ = false;
+    }
+    if (in_cng_) {
+      EXPECT_EQ(0, WebRtcCng_Generate(cng_decoder_, decoded, samples_per_10ms_,
+                                      0));
+    }
+    return rtc::TimeNanos() - start_ns;
+  }
+
+  rtc::scoped_ptr<AudioEncoder> speech_encoder_;
+  rtc::scoped_ptr<AudioEncoder> encoder_;
+  rtc::scoped_ptr<AudioDecoder> decoder_;
+  CNG_dec_inst* cng_decoder_ = nullptr;
+  bool in_cng_ = false;
+  size_t samples_per_10ms_ = 0;
+  std::vector<int16_t> input_;
+};
+
+void PrintSpeed(const std::string& measurement,
+                const std::string& trace,
+                uint64_t total_ns,
+                int num_blocks) {
+  test::PrintResult(measurement + "_time", "", trace,
+                    static_cast<size_t>(total_ns / num_blocks), "ns_per_10ms",
+                    false);
+  std::ostringstream speed;
+  speed << (total_ns > 0 ? 1e6 * kDurationMs / total_ns : 0.0);
+  test::PrintResult(measurement + "_speed", "", trace, speed.str(),
+                    "x_realtime", false);
+}
+
+}  // namespace
+
+TEST_P(AudioCodecBenchmark, EncodeDecode) {
+  const BenchmarkCase& c = GetParam();
+  const size_t block_size = samples_per_10ms_ * c.num_channels;
+  std::vector<uint8_t> encoded(encoder_->MaxEncodedBytes());
+  std::vector<int16_t> decoded(kMaxDecodedSamplesPerChannel * c.num_channels);
+  const uint32_t timestamp_step =
+      static_cast<uint32_t>(encoder_->RtpTimestampRateHz() / 100);
+  uint32_t timestamp = 0;
+  uint64_t encode_ns = 0;
+  uint64_t decode_ns = 0;
+  const int num_blocks = kDurationMs / 10;
+  for (int i = 0; i < num_blocks; ++i) {
+    rtc::ArrayView<const int16_t> block(&input_[i * block_size], block_size);
+    uint64_t start_ns = rtc::TimeNanos();
+    AudioEncoder::EncodedInfo info =
+        encoder_->Encode(timestamp, block, encoded.size(), encoded.data());
+    encode_ns += rtc::TimeNanos() - start_ns;
+    timestamp += timestamp_step;
+    decode_ns += Decode(info, encoded.data(), decoded.data());
+  }
+  PrintSpeed("audio_encode", c.name, encode_ns, num_blocks);
+  PrintSpeed("audio_decode", c.name, decode_ns, num_blocks);
+}
+
+INSTANTIATE_TEST_CASE_P(AllCodecs,
+                        AudioCodecBenchmark,
+                        ::testing::ValuesIn(kCases));
+
+}  // namespace webrtc
@@ -104,6 +104,7 @@ bool CodecSupported(NetEqDecoder codec_type) {
 #ifdef WEBRTC_CODEC_OPUS
     case NetEqDecoder::kDecoderOpus:
     case NetEqDecoder::kDecoderOpus_2ch:
+    case NetEqDecoder::kDecoderOpus_6ch:
 #endif
     case NetEqDecoder::kDecoderRED:
     case NetEqDecoder::kDecoderAVT:
@@ -161,7 +162,8 @@ int CodecSampleRateHz(NetEqDecoder codec_type) {
     }
 #ifdef WEBRTC_CODEC_OPUS
     case NetEqDecoder::kDecoderOpus:
-    case NetEqDecoder::kDecoderOpus_2ch: {
+    case NetEqDecoder::kDecoderOpus_2ch:
+    case NetEqDecoder::kDecoderOpus_6ch: {
       return 48000;
     }
 #endif
@@ -223,6 +225,8 @@ AudioDecoder* CreateAudioDecoder(NetEqDecoder codec_type) {
       return new AudioDecoderOpus(1);
     case NetEqDecoder::kDecoderOpus_2ch:
       return new AudioDecoderOpus(2);
+    case NetEqDecoder::kDecoderOpus_6ch:
+      return new AudioDecoderOpus(6);
 #endif
     case NetEqDecoder::kDecoderCNGnb:
     case NetEqDecoder::kDecoderCNGwb:
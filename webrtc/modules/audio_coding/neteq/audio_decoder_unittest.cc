@@ -711,6 +711,8 @@ TEST(AudioDecoder, CodecSampleRateHz) {
             CodecSampleRateHz(NetEqDecoder::kDecoderOpus));
   EXPECT_EQ(has_opus ? 48000 : -1,
             CodecSampleRateHz(NetEqDecoder::kDecoderOpus_2ch));
+  EXPECT_EQ(has_opus ? 48000 : -1,
+            CodecSampleRateHz(NetEqDecoder::kDecoderOpus_6ch));
   EXPECT_EQ(48000, CodecSampleRateHz(NetEqDecoder::kDecoderOpus));
   EXPECT_EQ(48000, CodecSampleRateHz(NetEqDecoder::kDecoderOpus_2ch));
   // TODO(tlegrand): Change 32000 to 48000 below once ACM has 48 kHz support.
@@ -746,6 +748,7 @@ TEST(AudioDecoder, CodecSupported) {
   EXPECT_TRUE(CodecSupported(NetEqDecoder::kDecoderArbitrary));
   EXPECT_EQ(has_opus, CodecSupported(NetEqDecoder::kDecoderOpus));
   EXPECT_EQ(has_opus, CodecSupported(NetEqDecoder::kDecoderOpus_2ch));
+  EXPECT_EQ(has_opus, CodecSupported(NetEqDecoder::kDecoderOpus_6ch));
 }
 
 }  // namespace webrtc
@@ -18,55 +18,98 @@
 
 namespace webrtc {
 
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+  size_t power_of_two = 1;
+  while (power_of_two < n) {
+    power_of_two <<= 1;
+  }
+  return power_of_two;
+}
+
+}  // namespace
+
 AudioVector::AudioVector()
     : array_(new int16_t[kDefaultInitialSize]),
-      first_free_ix_(0),
-      capacity_(kDefaultInitialSize) {
+      capacity_(kDefaultInitialSize),
+      begin_index_(0),
+      size_(0) {
 }
 
 AudioVector::AudioVector(size_t initial_size)
-    : array_(new int16_t[initial_size]),
-      first_free_ix_(initial_size),
-      capacity_(initial_size) {
+    : array_(new int16_t[RoundUpToPowerOfTwo(initial_size)]),
+      capacity_(RoundUpToPowerOfTwo(initial_size)),
+      begin_index_(0),
+      size_(initial_size) {
   memset(array_.get(), 0, initial_size * sizeof(int16_t));
 }
 
 AudioVector::~AudioVector() = default;
 
 void AudioVector::Clear() {
-  first_free_ix_ = 0;
+  begin_index_ = 0;
+  size_ = 0;
 }
 
 void AudioVector::CopyTo(AudioVector* copy_to) const {
   if (copy_to) {
+    copy_to->Clear();
     copy_to->Reserve(Size());
-    assert(copy_to->capacity_ >= Size());
-    memcpy(copy_to->array_.get(), array_.get(), Size() * sizeof(int16_t));
-    copy_to->first_free_ix_ = first_free_ix_;
+    CopyTo(Size(), 0, copy_to->array_.get());
+    copy_to->size_ = Size();
   }
 }
 
+void AudioVector::CopyTo(size_t length,
+                         size_t position,
+                         int16_t* copy_to) const {
+  assert(position + length <= Size());
+  const size_t start = RingIndex(position);
+  const size_t first_chunk_length = std::min(length, capacity_ - start);
+  memcpy(copy_to, &array_[start], first_chunk_length * sizeof(int16_t));
+  memcpy(&copy_to[first_chunk_length], array_.get(),
+         (length - first_chunk_length) * sizeof(int16_t));
+}
+
 void AudioVector::PushFront(const AudioVector& prepend_this) {
-  size_t insert_length = prepend_this.Size();
-  Reserve(Size() + insert_length);
-  memmove(&array_[insert_length], &array_[0], Size() * sizeof(int16_t));
-  memcpy(&array_[0], &prepend_this.array_[0], insert_length * sizeof(int16_t));
-  first_free_ix_ += insert_length;
+  const size_t length = prepend_this.Size();
+  Reserve(Size() + length);
+  // Prepend the part of |prepend_this| that wraps around first.
+  const size_t start = prepend_this.RingIndex(0);
+  const size_t first_chunk_length =
+      std::min(length, prepend_this.capacity_ - start);
+  PushFront(prepend_this.array_.get(), length - first_chunk_length);
+  PushFront(&prepend_this.array_[start], first_chunk_length);
 }
 
 void AudioVector::PushFront(const int16_t* prepend_this, size_t length) {
-  // Same operation as InsertAt beginning.
-  InsertAt(prepend_this, length, 0);
+  Reserve(Size() + length);
+  begin_index_ = (begin_index_ - length) & (capacity_ - 1);
+  size_ += length;
+  WriteAt(prepend_this, length, 0);
 }
 
 void AudioVector::PushBack(const AudioVector& append_this) {
-  PushBack(append_this.array_.get(), append_this.Size());
+  PushBack(append_this, append_this.Size(), 0);
+}
+
+void AudioVector::PushBack(const AudioVector& append_this,
+                           size_t length,
+                           size_t position) {
+  assert(position + length <= append_this.Size());
+  Reserve(Size() + length);
+  const size_t start = append_this.RingIndex(position);
+  const size_t first_chunk_length =
+      std::min(length, append_this.capacity_ - start);
+  PushBack(&append_this.array_[start], first_chunk_length);
+  PushBack(append_this.array_.get(), length - first_chunk_length);
 }
 
 void AudioVector::PushBack(const int16_t* append_this, size_t length) {
   Reserve(Size() + length);
-  memcpy(&array_[first_free_ix_], append_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  WriteAt(append_this, length, Size());
+  size_ += length;
 }
 
 void AudioVector::PopFront(size_t length) {
@@ -74,51 +117,40 @@ void AudioVector::PopFront(size_t length) {
     // Remove all elements.
     Clear();
   } else {
-    size_t remaining_samples = Size() - length;
-    memmove(&array_[0], &array_[length], remaining_samples * sizeof(int16_t));
-    first_free_ix_ -= length;
+    begin_index_ = RingIndex(length);
+    size_ -= length;
   }
 }
 
 void AudioVector::PopBack(size_t length) {
   // Never remove more than what is in the array.
   length = std::min(length, Size());
-  first_free_ix_ -= length;
+  size_ -= length;
 }
 
 void AudioVector::Extend(size_t extra_length) {
   Reserve(Size() + extra_length);
-  memset(&array_[first_free_ix_], 0, extra_length * sizeof(int16_t));
-  first_free_ix_ += extra_length;
+  WriteAt(NULL, extra_length, Size());
+  size_ += extra_length;
 }
 
 void AudioVector::InsertAt(const int16_t* insert_this,
                            size_t length,
                            size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
   position = std::min(Size(), position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memcpy(insert_position_ptr, insert_this, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  OpenGapAt(length, position);
+  WriteAt(insert_this, length, position);
 }
 
 void AudioVector::InsertZerosAt(size_t length,
                                 size_t position) {
-  Reserve(Size() + length);
   // Cap the position at the current vector length, to be sure the iterator
   // does not extend beyond the end of the vector.
-  position = std::min(capacity_, position);
-  int16_t* insert_position_ptr = &array_[position];
-  size_t samples_to_move = Size() - position;
-  memmove(insert_position_ptr + length, insert_position_ptr,
-          samples_to_move * sizeof(int16_t));
-  memset(insert_position_ptr, 0, length * sizeof(int16_t));
-  first_free_ix_ += length;
+  position = std::min(Size(), position);
+  OpenGapAt(length, position);
+  WriteAt(NULL, length, position);
 }
 
 void AudioVector::OverwriteAt(const int16_t* insert_this,
@@ -127,11 +159,22 @@ void AudioVector::OverwriteAt(const int16_t* insert_this,
   // Cap the insert position at the current array length.
   position = std::min(Size(), position);
   Reserve(position + length);
-  memcpy(&array_[position], insert_this, length * sizeof(int16_t));
-  if (position + length > Size()) {
-    // Array was expanded.
-    first_free_ix_ += position + length - Size();
-  }
+  WriteAt(insert_this, length, position);
+  // Expand the array if needed.
+  size_ = std::max(Size(), position + length);
+}
+
+void AudioVector::OverwriteAt(const AudioVector& insert_this,
+                              size_t length,
+                              size_t position) {
+  assert(length <= insert_this.Size());
+  const size_t start = insert_this.RingIndex(0);
+  const size_t first_chunk_length =
+      std::min(length, insert_this.capacity_ - start);
+  position = std::min(Size(), position);
+  OverwriteAt(&insert_this.array_[start], first_chunk_length, position);
+  OverwriteAt(insert_this.array_.get(), length - first_chunk_length,
+              position + first_chunk_length);
 }
 
 void AudioVector::CrossFade(const AudioVector& append_this,
@@ -150,41 +193,72 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   int alpha = 16384;
   for (size_t i = 0; i < fade_length; ++i) {
     alpha -= alpha_step;
-    array_[position + i] = (alpha * array_[position + i] +
+    (*this)[position + i] = (alpha * (*this)[position + i] +
         (16384 - alpha) * append_this[i] + 8192) >> 14;
   }
   assert(alpha >= 0);  // Verify that the slope was correct.
   // Append what is left of |append_this|.
   size_t samples_to_push_back = append_this.Size() - fade_length;
   if (samples_to_push_back > 0)
-    PushBack(&append_this[fade_length], samples_to_push_back);
+    PushBack(append_this, samples_to_push_back, fade_length);
 }
 
 // Returns the number of elements in this AudioVector.
 size_t AudioVector::Size() const {
-  return first_free_ix_;
+  return size_;
 }
 
 // Returns true if this AudioVector is empty.
 bool AudioVector::Empty() const {
-  return first_free_ix_ == 0;
+  return size_ == 0;
 }
 
-const int16_t& AudioVector::operator[](size_t index) const {
-  return array_[index];
+void AudioVector::Reserve(size_t n) {
+  if (capacity_ < n) {
+    const size_t new_capacity = RoundUpToPowerOfTwo(n);
+    rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[new_capacity]);
+    CopyTo(Size(), 0, temp_array.get());
+    array_.swap(temp_array);
+    capacity_ = new_capacity;
+    begin_index_ = 0;
+  }
 }
 
-int16_t& AudioVector::operator[](size_t index) {
-  return array_[index];
+void AudioVector::WriteAt(const int16_t* source,
+                          size_t length,
+                          size_t position) {
+  assert(position + length <= capacity_);
+  const size_t start = RingIndex(position);
+  const size_t first_chunk_length = std::min(length, capacity_ - start);
+  const size_t second_chunk_length = length - first_chunk_length;
+  if (source) {
+    memcpy(&array_[start], source, first_chunk_length * sizeof(int16_t));
+    memcpy(array_.get(), &source[first_chunk_length],
+           second_chunk_length * sizeof(int16_t));
+  } else {
+    memset(&array_[start], 0, first_chunk_length * sizeof(int16_t));
+    memset(array_.get(), 0, second_chunk_length * sizeof(int16_t));
+  }
 }
 
-void AudioVector::Reserve(size_t n) {
-  if (capacity_ < n) {
-    rtc::scoped_ptr<int16_t[]> temp_array(new int16_t[n]);
-    memcpy(temp_array.get(), array_.get(), Size() * sizeof(int16_t));
-    array_.swap(temp_array);
-    capacity_ = n;
+void AudioVector::OpenGapAt(size_t length, size_t position) {
+  Reserve(Size() + length);
+  const size_t mask = capacity_ - 1;
+  if (position < Size() - position) {
+    // Move the samples before |position| towards the front.
+    begin_index_ = (begin_index_ - length) & mask;
+    for (size_t i = 0; i < position; ++i) {
+      array_[(begin_index_ + i) & mask] =
+          array_[(begin_index_ + length + i) & mask];
+    }
+  } else {
+    // Move the samples from |position| on towards the back.
+    for (size_t i = Size(); i > position; --i) {
+      array_[(begin_index_ + length + i - 1) & mask] =
+          array_[(begin_index_ + i - 1) & mask];
+    }
   }
+  size_ += length;
 }
 
 }  // namespace webrtc
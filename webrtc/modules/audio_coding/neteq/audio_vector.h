@@ -19,6 +19,9 @@
 
 namespace webrtc {
 
+// A vector of audio samples stored in a ring buffer whose capacity is a power
+// of two. Removing samples from either end is O(1), and so is adding samples
+// to either end when no reallocation is needed.
 class AudioVector {
  public:
   // Creates an empty AudioVector.
@@ -37,6 +40,9 @@ class AudioVector {
   // |copy_to| will be an exact replica of this object.
   virtual void CopyTo(AudioVector* copy_to) const;
 
+  // Copies |length| values from |position| in this vector to |copy_to|.
+  virtual void CopyTo(size_t length, size_t position, int16_t* copy_to) const;
+
   // Prepends the contents of AudioVector |prepend_this| to this object. The
   // length of this object is increased with the length of |prepend_this|.
   virtual void PushFront(const AudioVector& prepend_this);
@@ -48,6 +54,12 @@ class AudioVector {
   // Same as PushFront but will append to the end of this object.
   virtual void PushBack(const AudioVector& append_this);
 
+  // Appends a segment of |append_this| to the end of this object. The segment
+  // starts from |position| and has |length| samples.
+  virtual void PushBack(const AudioVector& append_this,
+                        size_t length,
+                        size_t position);
+
   // Same as PushFront but will append to the end of this object.
   virtual void PushBack(const int16_t* append_this, size_t length);
 
@@ -80,6 +92,12 @@ class AudioVector {
                            size_t length,
                            size_t position);
 
+  // Same as above, but with the first |length| samples of the AudioVector
+  // |insert_this| as source.
+  virtual void OverwriteAt(const AudioVector& insert_this,
+                           size_t length,
+                           size_t position);
+
   // Appends |append_this| to the end of the current vector. Lets the two
   // vectors overlap by |fade_length| samples, and cross-fade linearly in this
   // region.
@@ -92,18 +110,34 @@ class AudioVector {
   virtual bool Empty() const;
 
   // Accesses and modifies an element of AudioVector.
-  const int16_t& operator[](size_t index) const;
-  int16_t& operator[](size_t index);
+  const int16_t& operator[](size_t index) const {
+    return array_[RingIndex(index)];
+  }
+  int16_t& operator[](size_t index) { return array_[RingIndex(index)]; }
 
  private:
-  static const size_t kDefaultInitialSize = 10;
+  static const size_t kDefaultInitialSize = 16;
+
+  // Returns the index in |array_| of the sample at |index| in this vector.
+  size_t RingIndex(size_t index) const {
+    return (begin_index_ + index) & (capacity_ - 1);
+  }
 
   void Reserve(size_t n);
 
+  // Writes |length| samples from |source| to the already reserved positions
+  // starting at |position| in this vector. Writes zeros if |source| is NULL.
+  void WriteAt(const int16_t* source, size_t length, size_t position);
+
+  // Makes room for |length| samples at |position| by moving the samples on the
+  // shorter side of |position| outwards.
+  void OpenGapAt(size_t length, size_t position);
+
   rtc::scoped_ptr<int16_t[]> array_;
-  size_t first_free_ix_;  // The first index after the last sample in array_.
-                          // Note that this index may point outside of array_.
-  size_t capacity_;  // Allocated number of samples in the array.
+  size_t capacity_;  // Allocated number of samples in the array. Always a
+                     // power of two.
+  size_t begin_index_;  // The index of the first sample in |array_|.
+  size_t size_;  // The number of samples in the vector.
 
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioVector);
 };
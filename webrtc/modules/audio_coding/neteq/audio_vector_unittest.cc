@@ -391,4 +391,46 @@ TEST_F(AudioVectorTest, CrossFade) {
   }
 }
 
+// Test that the data is kept in order when the samples wrap around the end of
+// the internal ring buffer.
+TEST_F(AudioVectorTest, WrapAround) {
+  AudioVector vec;
+  // Move the start of the data away from the beginning of the ring buffer.
+  vec.PushBack(array_, array_length());
+  vec.PopFront(array_length());
+  ASSERT_TRUE(vec.Empty());
+  vec.PushBack(array_, array_length());
+  ASSERT_EQ(array_length(), vec.Size());
+  for (size_t i = 0; i < array_length(); ++i) {
+    EXPECT_EQ(array_[i], vec[i]);
+  }
+
+  // Copy out all samples in one go.
+  int16_t copy[10];
+  ASSERT_EQ(array_length(), sizeof(copy) / sizeof(copy[0]));
+  vec.CopyTo(array_length(), 0, copy);
+  for (size_t i = 0; i < array_length(); ++i) {
+    EXPECT_EQ(array_[i], copy[i]);
+  }
+
+  // Insert zeros in the middle and prepend a few samples.
+  static const size_t kNumZeros = 3;
+  static const size_t kZerosPosition = 5;
+  vec.InsertZerosAt(kNumZeros, kZerosPosition);
+  vec.PushFront(array_, 2);
+  ASSERT_EQ(array_length() + kNumZeros + 2, vec.Size());
+  EXPECT_EQ(array_[0], vec[0]);
+  EXPECT_EQ(array_[1], vec[1]);
+  size_t pos = 2;
+  for (size_t i = 0; i < kZerosPosition; ++i, ++pos) {
+    EXPECT_EQ(array_[i], vec[pos]);
+  }
+  for (size_t i = 0; i < kNumZeros; ++i, ++pos) {
+    EXPECT_EQ(0, vec[pos]);
+  }
+  for (size_t i = kZerosPosition; i < array_length(); ++i, ++pos) {
+    EXPECT_EQ(array_[i], vec[pos]);
+  }
+}
+
 }  // namespace webrtc
@@ -32,7 +32,6 @@ int ComfortNoise::UpdateParameters(Packet* packet) {
   AudioDecoder* cng_decoder = decoder_database_->GetDecoder(
       packet->header.payloadType);
   if (!cng_decoder) {
-    delete [] packet->payload;
     delete packet;
     return kUnknownPayloadType;
   }
@@ -41,7 +40,6 @@ int ComfortNoise::UpdateParameters(Packet* packet) {
   int16_t ret = WebRtcCng_UpdateSid(cng_inst,
                                     packet->payload,
                                     packet->payload_length);
-  delete [] packet->payload;
   delete packet;
   if (ret < 0) {
     internal_error_code_ = WebRtcCng_GetErrorCodeDec(cng_inst);
@@ -77,9 +75,10 @@ int ComfortNoise::Generate(size_t requested_length,
     return kUnknownPayloadType;
   }
   CNG_dec_inst* cng_inst = cng_decoder->CngDecoderInstance();
-  // The expression &(*output)[0][0] is a pointer to the first element in
-  // the first channel.
-  if (WebRtcCng_Generate(cng_inst, &(*output)[0][0], number_of_samples,
+  // WebRtcCng_Generate() fails without writing anything if
+  // |number_of_samples| is larger than WEBRTC_CNG_MAX_OUTSIZE_ORDER.
+  int16_t temp_data[WEBRTC_CNG_MAX_OUTSIZE_ORDER];
+  if (WebRtcCng_Generate(cng_inst, temp_data, number_of_samples,
                          new_period) < 0) {
     // Error returned.
     output->Zeros(requested_length);
@@ -87,6 +86,7 @@ int ComfortNoise::Generate(size_t requested_length,
     LOG(LS_ERROR) << "WebRtcCng_Generate produced " << internal_error_code_;
     return kInternalError;
   }
+  (*output)[0].OverwriteAt(temp_data, number_of_samples, 0);
 
   if (first_call_) {
     // Set tapering window parameters. Values are in Q15.
@@ -298,8 +298,7 @@ int Expand::Process(AudioMultiVector* output) {
     } else {
       assert(output->Size() == current_lag);
     }
-    memcpy(&(*output)[channel_ix][0], temp_data,
-           sizeof(temp_data[0]) * current_lag);
+    (*output)[channel_ix].OverwriteAt(temp_data, current_lag, 0);
   }
 
   // Increase call number and cap it.
@@ -372,8 +371,9 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
   size_t fs_mult_lpc_analysis_len = fs_mult * kLpcAnalysisLength;
 
   const size_t signal_length = static_cast<size_t>(256 * fs_mult);
-  const int16_t* audio_history =
-      &(*sync_buffer_)[0][sync_buffer_->Size() - signal_length];
+  int16_t audio_history[256 * kMaxSampleRate / 8000];
+  (*sync_buffer_)[0].CopyTo(signal_length, sync_buffer_->Size() - signal_length,
+                            audio_history);
 
   // Initialize.
   InitializeForAnExpandPeriod();
@@ -112,6 +112,8 @@ class Expand {
     int16_t ar_gain_scale;
     int16_t voice_mix_factor; /* Q14 */
     int16_t current_voice_mix_factor; /* Q14 */
+    // These are only ever filled from empty, so their samples start at the
+    // beginning of the ring buffer and can be addressed as plain arrays.
     AudioVector expand_vector0;
     AudioVector expand_vector1;
     bool onset;
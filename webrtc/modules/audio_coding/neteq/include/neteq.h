@@ -254,6 +254,17 @@ class NetEq {
   // Disables post-decode VAD.
   virtual void DisableVad() = 0;
 
+  // Enables muted output, for when the caller knows that the output of
+  // GetAudio() will not be used, e.g., because the stream is not mixed. While
+  // enabled, GetAudio() writes zeros instead of generating expansion or
+  // comfort noise, but still decodes available packets and advances the
+  // timestamps and statistics as usual. Disabling muted output resumes normal
+  // signal generation, fading in from silence.
+  virtual void EnableMutedOutput() = 0;
+
+  // Disables muted output.
+  virtual void DisableMutedOutput() = 0;
+
   // Gets the RTP timestamp for the last sample delivered by GetAudio().
   // Returns true if the RTP timestamp is valid, otherwise false.
   virtual bool GetPlayoutTimestamp(uint32_t* timestamp) = 0;
@@ -38,6 +38,8 @@ class MockPacketBuffer : public PacketBuffer {
       int(uint32_t* next_timestamp));
   MOCK_CONST_METHOD2(NextHigherTimestamp,
       int(uint32_t timestamp, uint32_t* next_timestamp));
+  MOCK_CONST_METHOD1(ContainsTimestamp,
+      bool(uint32_t timestamp));
   MOCK_CONST_METHOD0(NextRtpHeader,
       const RTPHeader*());
   MOCK_METHOD1(GetNextPacket,
@@ -21,6 +21,9 @@ class MockPayloadSplitter : public PayloadSplitter {
  public:
   MOCK_METHOD1(SplitRed,
       int(PacketList* packet_list));
+  MOCK_METHOD4(SplitRed,
+      int(PacketList* packet_list, const PacketBuffer& packet_buffer,
+          rtc::Optional<uint32_t> timestamp_limit, uint32_t horizon_samples));
   MOCK_METHOD2(SplitFec,
       int(PacketList* packet_list, DecoderDatabase* decoder_database));
   MOCK_METHOD2(CheckRedPayloads,
@@ -70,7 +70,7 @@ void Nack::UpdateLastReceivedPacket(uint16_t sequence_number,
     return;
 
   // Received RTP should not be in the list.
-  nack_list_.erase(sequence_number);
+  nack_list_.Erase(sequence_number);
 
   // If this is an old sequence number, no more action is required, return.
   if (IsNewerSequenceNumber(sequence_num_last_received_rtp_, sequence_number))
@@ -96,22 +96,19 @@ void Nack::UpdateSamplesPerPacket(uint16_t sequence_number_current_received_rtp,
 }
 
 void Nack::UpdateList(uint16_t sequence_number_current_received_rtp) {
-  // Some of the packets which were considered late, now are considered missing.
-  ChangeFromLateToMissing(sequence_number_current_received_rtp);
-
+  // Some of the packets which were considered late are now considered missing;
+  // that follows from |sequence_num_last_received_rtp_| moving forward, see
+  // IsMissing().
   if (IsNewerSequenceNumber(sequence_number_current_received_rtp,
                             sequence_num_last_received_rtp_ + 1))
     AddToList(sequence_number_current_received_rtp);
 }
 
-void Nack::ChangeFromLateToMissing(
-    uint16_t sequence_number_current_received_rtp) {
-  NackList::const_iterator lower_bound =
-      nack_list_.lower_bound(static_cast<uint16_t>(
-          sequence_number_current_received_rtp - nack_threshold_packets_));
-
-  for (NackList::iterator it = nack_list_.begin(); it != lower_bound; ++it)
-    it->second.is_missing = true;
+bool Nack::IsMissing(uint16_t sequence_number) const {
+  return IsNewerSequenceNumber(
+      static_cast<uint16_t>(sequence_num_last_received_rtp_ -
+                            nack_threshold_packets_),
+      sequence_number);
 }
 
 uint32_t Nack::EstimateTimestamp(uint16_t sequence_num) {
@@ -124,27 +121,25 @@ void Nack::AddToList(uint16_t sequence_number_current_received_rtp) {
          IsNewerSequenceNumber(sequence_number_current_received_rtp,
                                sequence_num_last_decoded_rtp_));
 
-  // Packets with sequence numbers older than |upper_bound_missing| are
-  // considered missing, and the rest are considered late.
-  uint16_t upper_bound_missing =
-      sequence_number_current_received_rtp - nack_threshold_packets_;
-
-  for (uint16_t n = sequence_num_last_received_rtp_ + 1;
-       IsNewerSequenceNumber(sequence_number_current_received_rtp, n); ++n) {
-    bool is_missing = IsNewerSequenceNumber(upper_bound_missing, n);
-    uint32_t timestamp = EstimateTimestamp(n);
-    NackElement nack_element(TimeToPlay(timestamp), timestamp, is_missing);
-    nack_list_.insert(nack_list_.end(), std::make_pair(n, nack_element));
-  }
+  // Packets older than the list size allows, counting from the current one,
+  // would be removed by LimitNackListSize() right away.
+  uint16_t first = sequence_num_last_received_rtp_ + 1;
+  uint16_t oldest_kept = sequence_number_current_received_rtp -
+                         static_cast<uint16_t>(max_nack_list_size_);
+  if (IsNewerSequenceNumber(oldest_kept, first))
+    first = oldest_kept;
+
+  nack_list_.InsertRange(first, sequence_number_current_received_rtp);
+  for (uint16_t n = first; n != sequence_number_current_received_rtp; ++n)
+    StoredTimestamp(n) = EstimateTimestamp(n);
 }
 
 void Nack::UpdateEstimatedPlayoutTimeBy10ms() {
+  // The time-to-play of what is left drops by 10 ms as the caller moves
+  // |timestamp_last_decoded_rtp_| on.
   while (!nack_list_.empty() &&
-         nack_list_.begin()->second.time_to_play_ms <= 10)
-    nack_list_.erase(nack_list_.begin());
-
-  for (NackList::iterator it = nack_list_.begin(); it != nack_list_.end(); ++it)
-    it->second.time_to_play_ms -= 10;
+         TimeToPlay(StoredTimestamp(nack_list_.oldest())) <= 10)
+    nack_list_.Erase(nack_list_.oldest());
 }
 
 void Nack::UpdateLastDecodedPacket(uint16_t sequence_number,
@@ -156,13 +151,7 @@ void Nack::UpdateLastDecodedPacket(uint16_t sequence_number,
     // Packets in the list with sequence numbers less than the
     // sequence number of the decoded RTP should be removed from the lists.
     // They will be discarded by the jitter buffer if they arrive.
-    nack_list_.erase(nack_list_.begin(),
-                     nack_list_.upper_bound(sequence_num_last_decoded_rtp_));
-
-    // Update estimated time-to-play.
-    for (NackList::iterator it = nack_list_.begin(); it != nack_list_.end();
-         ++it)
-      it->second.time_to_play_ms = TimeToPlay(it->second.estimated_timestamp);
+    nack_list_.EraseUpTo(sequence_num_last_decoded_rtp_);
   } else {
     assert(sequence_number == sequence_num_last_decoded_rtp_);
 
@@ -178,11 +167,21 @@ void Nack::UpdateLastDecodedPacket(uint16_t sequence_number,
 }
 
 Nack::NackList Nack::GetNackList() const {
-  return nack_list_;
+  NackList nack_list;
+  nack_list_.ForEach([this, &nack_list](uint16_t sequence_number) {
+    uint32_t timestamp = StoredTimestamp(sequence_number);
+    nack_list.insert(
+        nack_list.end(),
+        std::make_pair(sequence_number,
+                       NackElement(TimeToPlay(timestamp), timestamp,
+                                   IsMissing(sequence_number))));
+    return true;
+  });
+  return nack_list;
 }
 
 void Nack::Reset() {
-  nack_list_.clear();
+  nack_list_.Clear();
 
   sequence_num_last_received_rtp_ = 0;
   timestamp_last_received_rtp_ = 0;
@@ -207,11 +206,13 @@ void Nack::SetMaxNackListSize(size_t max_nack_list_size) {
 void Nack::LimitNackListSize() {
   uint16_t limit = sequence_num_last_received_rtp_ -
                    static_cast<uint16_t>(max_nack_list_size_) - 1;
-  nack_list_.erase(nack_list_.begin(), nack_list_.upper_bound(limit));
+  nack_list_.EraseUpTo(limit);
 }
 
 int64_t Nack::TimeToPlay(uint32_t timestamp) const {
-  uint32_t timestamp_increase = timestamp - timestamp_last_decoded_rtp_;
+  // Negative for packets whose playout time has already passed.
+  int32_t timestamp_increase =
+      static_cast<int32_t>(timestamp - timestamp_last_decoded_rtp_);
   return timestamp_increase / sample_rate_khz_;
 }
 
@@ -219,12 +220,14 @@ int64_t Nack::TimeToPlay(uint32_t timestamp) const {
 std::vector<uint16_t> Nack::GetNackList(int64_t round_trip_time_ms) const {
   RTC_DCHECK_GE(round_trip_time_ms, 0);
   std::vector<uint16_t> sequence_numbers;
-  for (NackList::const_iterator it = nack_list_.begin(); it != nack_list_.end();
-       ++it) {
-    if (it->second.is_missing &&
-        it->second.time_to_play_ms > round_trip_time_ms)
-      sequence_numbers.push_back(it->first);
-  }
+  // Missing packets all come before the late ones.
+  nack_list_.ForEach([&](uint16_t sequence_number) {
+    if (!IsMissing(sequence_number))
+      return false;
+    if (TimeToPlay(StoredTimestamp(sequence_number)) > round_trip_time_ms)
+      sequence_numbers.push_back(sequence_number);
+    return true;
+  });
   return sequence_numbers;
 }
 
@@ -16,6 +16,7 @@
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_coding/include/audio_coding_module_typedefs.h"
+#include "webrtc/modules/include/sequence_number_bitset.h"
 #include "webrtc/test/testsupport/gtest_prod_util.h"
 
 //
@@ -103,8 +104,7 @@ class Nack {
           estimated_timestamp(initial_timestamp),
           is_missing(missing) {}
 
-    // Estimated time (ms) left for this packet to be decoded. This estimate is
-    // updated every time jitter buffer decodes a packet.
+    // Estimated time (ms) left for this packet to be decoded.
     int64_t time_to_play_ms;
 
     // A guess about the timestamp of the missing packet, it is used for
@@ -130,6 +130,12 @@ class Nack {
 
   typedef std::map<uint16_t, NackElement, NackListCompare> NackList;
 
+  // Slots in |estimated_timestamps_|, enough for a list of
+  // |kNackListSizeLimit| consecutive sequence numbers.
+  static const size_t kEstimatedTimestampsSize = 512;
+  static_assert(kEstimatedTimestampsSize > kNackListSizeLimit,
+                "Too few slots for the largest NACK list");
+
   // Constructor.
   explicit Nack(int nack_threshold_packets);
 
@@ -137,12 +143,24 @@ class Nack {
   // computed correctly.
   NackList GetNackList() const;
 
+  // True if |sequence_number|, which is in the list, is considered missing
+  // rather than late.
+  bool IsMissing(uint16_t sequence_number) const;
+
+  uint32_t& StoredTimestamp(uint16_t sequence_number) {
+    return estimated_timestamps_[sequence_number % kEstimatedTimestampsSize];
+  }
+  uint32_t StoredTimestamp(uint16_t sequence_number) const {
+    return estimated_timestamps_[sequence_number % kEstimatedTimestampsSize];
+  }
+
   // Given the |sequence_number_current_received_rtp| of currently received RTP,
   // recognize packets which are not arrive and add to the list.
   void AddToList(uint16_t sequence_number_current_received_rtp);
 
-  // This function subtracts 10 ms of time-to-play for all packets in NACK list.
-  // This is called when 10 ms elapsed with no new RTP packet decoded.
+  // This function removes the packets at the front of the NACK list which
+  // have no more than 10 ms left to play. This is called when 10 ms elapsed
+  // with no new RTP packet decoded.
   void UpdateEstimatedPlayoutTimeBy10ms();
 
   // Given the |sequence_number_current_received_rtp| and
@@ -156,10 +174,6 @@ class Nack {
   // some packets are inserted as missing and some inserted as late.
   void UpdateList(uint16_t sequence_number_current_received_rtp);
 
-  // Packets which are considered late for too long (according to
-  // |nack_threshold_packets_|) are flagged as missing.
-  void ChangeFromLateToMissing(uint16_t sequence_number_current_received_rtp);
-
   // Packets which have sequence number older that
   // |sequence_num_last_received_rtp_| - |max_nack_list_size_| are removed
   // from the NACK list.
@@ -194,10 +208,17 @@ class Nack {
   // packet, not only for consecutive packets.
   int samples_per_packet_;
 
-  // A list of missing packets to be retransmitted. Components of the list
-  // contain the sequence number of missing packets and the estimated time that
-  // each pack is going to be played out.
-  NackList nack_list_;
+  // The sequence numbers of the missing and late packets. A packet is missing
+  // rather than late if it is older than |sequence_num_last_received_rtp_| -
+  // |nack_threshold_packets_|, and its time-to-play is computed from its
+  // estimated timestamp when needed rather than kept up to date for every
+  // packet in the list.
+  SequenceNumberBitset nack_list_;
+
+  // The estimated timestamps of the packets in |nack_list_|, indexed by
+  // sequence number modulo |kEstimatedTimestampsSize|. The list never spans
+  // more sequence numbers than that.
+  uint32_t estimated_timestamps_[kEstimatedTimestampsSize];
 
   // NACK list will not keep track of missing packets prior to
   // |sequence_num_last_received_rtp_| - |max_nack_list_size_|.
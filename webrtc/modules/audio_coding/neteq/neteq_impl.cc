@@ -97,6 +97,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       background_noise_mode_(config.background_noise_mode),
       playout_mode_(config.playout_mode),
       enable_fast_accelerate_(config.enable_fast_accelerate),
+      muted_output_(false),
       nack_enabled_(false) {
   LOG(LS_INFO) << "NetEq config: " << config.ToString();
   int fs = config.sample_rate_hz;
@@ -361,6 +362,16 @@ void NetEqImpl::DisableVad() {
   vad_->Disable();
 }
 
+void NetEqImpl::EnableMutedOutput() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  muted_output_ = true;
+}
+
+void NetEqImpl::DisableMutedOutput() {
+  CriticalSectionScoped lock(crit_sect_.get());
+  muted_output_ = false;
+}
+
 bool NetEqImpl::GetPlayoutTimestamp(uint32_t* timestamp) {
   CriticalSectionScoped lock(crit_sect_.get());
   if (first_packet_) {
@@ -488,16 +499,11 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
     packet->header.timestamp = rtp_header.header.timestamp;
     packet->header.ssrc = rtp_header.header.ssrc;
     packet->header.numCSRCs = 0;
-    packet->payload_length = payload.size();
     packet->primary = true;
     packet->waiting_time = 0;
-    packet->payload = new uint8_t[packet->payload_length];
     packet->sync_packet = is_sync_packet;
-    if (!packet->payload) {
-      LOG_F(LS_ERROR) << "Payload pointer is NULL.";
-    }
     assert(!payload.empty());  // Already checked above.
-    memcpy(packet->payload, payload.data(), packet->payload_length);
+    packet->SetPayload(payload.data(), payload.size());
     // Insert packet in a packet list.
     packet_list.push_back(packet);
     // Save main payloads header for later.
@@ -540,7 +546,24 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   // Check for RED payload type, and separate payloads into several packets.
   if (decoder_database_->IsRed(main_header.payloadType)) {
     assert(!is_sync_packet);  // We had a sanity check for this.
-    if (payload_splitter_->SplitRed(&packet_list) != PayloadSplitter::kOK) {
+    int ret;
+    if (timestamp_scaler_->IsScaling()) {
+      // The timestamps in the packet buffer cannot be compared with the RTP
+      // timestamps.
+      ret = payload_splitter_->SplitRed(&packet_list);
+    } else {
+      // Do not create packets for redundant payloads which are already in the
+      // packet buffer, or which have already been played out. Old packets are
+      // discarded under the same conditions as in GetDecision().
+      rtc::Optional<uint32_t> timestamp_limit;
+      if (!new_codec_ && !update_sample_rate_and_channels) {
+        timestamp_limit =
+            rtc::Optional<uint32_t>(sync_buffer_->end_timestamp());
+      }
+      ret = payload_splitter_->SplitRed(&packet_list, *packet_buffer_,
+                                        timestamp_limit, 5 * fs_hz_);
+    }
+    if (ret != PayloadSplitter::kOK) {
       PacketBuffer::DeleteAllPackets(&packet_list);
       return kRedundancySplitError;
     }
@@ -585,8 +608,6 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
         PacketBuffer::DeleteAllPackets(&packet_list);
         return kDtmfInsertError;
       }
-      // TODO(hlundin): Let the destructor of Packet handle the payload.
-      delete [] current_packet->payload;
       delete current_packet;
       it = packet_list.erase(it);
     } else {
@@ -900,11 +921,12 @@ int NetEqImpl::GetAudioInternal(size_t max_length,
   // Update the background noise parameters if last operation wrote data
   // straight from the decoder to the |sync_buffer_|. That is, none of the
   // operations that modify the signal can be followed by a parameter update.
+  // Muted comfort noise is only zeros, and must not be used either.
   if ((last_mode_ == kModeNormal) ||
       (last_mode_ == kModeAccelerateFail) ||
       (last_mode_ == kModePreemptiveExpandFail) ||
-      (last_mode_ == kModeRfc3389Cng) ||
-      (last_mode_ == kModeCodecInternalCng)) {
+      (!muted_output_ && ((last_mode_ == kModeRfc3389Cng) ||
+                          (last_mode_ == kModeCodecInternalCng)))) {
     background_noise_->Update(*sync_buffer_, *vad_.get());
   }
 
@@ -1383,7 +1405,6 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, const Operations& operation,
               &decoded_buffer_[*decoded_length], speech_type);
     }
 
-    delete[] packet->payload;
     delete packet;
     packet = NULL;
     if (decode_length > 0) {
@@ -1473,6 +1494,25 @@ void NetEqImpl::DoMerge(int16_t* decoded_buffer, size_t decoded_length,
 }
 
 int NetEqImpl::DoExpand(bool play_dtmf) {
+  if (muted_output_) {
+    // Fill the |sync_buffer_| with zeros instead of expanding. Resetting
+    // |expand_| makes the next real expansion, or the merge when a packet
+    // arrives, start over from the silence.
+    const size_t required_length =
+        output_size_samples_ + expand_->overlap_length();
+    if (sync_buffer_->FutureLength() < required_length) {
+      expand_->Reset();
+      algorithm_buffer_->Zeros(required_length - sync_buffer_->FutureLength());
+      stats_.ExpandedNoiseSamples(algorithm_buffer_->Size());
+      last_mode_ = kModeExpand;
+      sync_buffer_->PushBack(*algorithm_buffer_);
+      algorithm_buffer_->Clear();
+    }
+    if (!play_dtmf) {
+      dtmf_tone_generator_->Reset();
+    }
+    return 0;
+  }
   while ((sync_buffer_->FutureLength() - expand_->overlap_length()) <
       output_size_samples_) {
     algorithm_buffer_->Clear();
@@ -1683,8 +1723,13 @@ int NetEqImpl::DoRfc3389Cng(PacketList* packet_list, bool play_dtmf) {
       return -comfort_noise_->internal_error_code();
     }
   }
-  int cn_return = comfort_noise_->Generate(output_size_samples_,
-                                           algorithm_buffer_.get());
+  int cn_return = ComfortNoise::kOK;
+  if (muted_output_) {
+    algorithm_buffer_->Zeros(output_size_samples_);
+  } else {
+    cn_return = comfort_noise_->Generate(output_size_samples_,
+                                         algorithm_buffer_.get());
+  }
   expand_->Reset();
   last_mode_ = kModeRfc3389Cng;
   if (!play_dtmf) {
@@ -1703,8 +1748,12 @@ void NetEqImpl::DoCodecInternalCng(const int16_t* decoded_buffer,
                                    size_t decoded_length) {
   RTC_DCHECK(normal_.get());
   RTC_DCHECK(mute_factor_array_.get());
-  normal_->Process(decoded_buffer, decoded_length, last_mode_,
-                   mute_factor_array_.get(), algorithm_buffer_.get());
+  if (muted_output_) {
+    algorithm_buffer_->Zeros(decoded_length / algorithm_buffer_->Channels());
+  } else {
+    normal_->Process(decoded_buffer, decoded_length, last_mode_,
+                     mute_factor_array_.get(), algorithm_buffer_.get());
+  }
   last_mode_ = kModeCodecInternalCng;
   expand_->Reset();
 }
@@ -164,6 +164,10 @@ class NetEqImpl : public webrtc::NetEq {
   // Disables post-decode VAD.
   void DisableVad() override;
 
+  void EnableMutedOutput() override;
+
+  void DisableMutedOutput() override;
+
   bool GetPlayoutTimestamp(uint32_t* timestamp) override;
 
   int last_output_sample_rate_hz() const override;
@@ -396,6 +400,7 @@ class NetEqImpl : public webrtc::NetEq {
   const BackgroundNoiseMode background_noise_mode_ GUARDED_BY(crit_sect_);
   NetEqPlayoutMode playout_mode_ GUARDED_BY(crit_sect_);
   bool enable_fast_accelerate_ GUARDED_BY(crit_sect_);
+  bool muted_output_ GUARDED_BY(crit_sect_);
   rtc::scoped_ptr<Nack> nack_ GUARDED_BY(crit_sect_);
   bool nack_enabled_ GUARDED_BY(crit_sect_);
 
@@ -1645,4 +1645,77 @@ TEST_F(NetEqDecodingTest, CngFirst) {
   EXPECT_EQ(kOutputNormal, type);
 }
 
+TEST_F(NetEqDecodingTest, MutedOutput) {
+  uint16_t seq_no = 0;
+  uint32_t timestamp = 0;
+  const int kFrameSizeMs = 10;
+  const int kSampleRateKhz = 16;
+  const int kSamples = kFrameSizeMs * kSampleRateKhz;
+  const size_t kPayloadBytes = kSamples * 2;
+  const int kFrames = 10;
+
+  // Big-endian PCM16 payload with a non-zero waveform.
+  uint8_t payload[kPayloadBytes];
+  for (int i = 0; i < kSamples; ++i) {
+    const int16_t sample = static_cast<int16_t>(((i % 32) - 16) * 500);
+    payload[2 * i] = static_cast<uint8_t>(sample >> 8);
+    payload[2 * i + 1] = static_cast<uint8_t>(sample);
+  }
+  WebRtcRTPHeader rtp_info;
+  size_t out_len;
+  size_t num_channels;
+  NetEqOutputType type;
+
+  // Play some speech.
+  for (int i = 0; i < kFrames; ++i) {
+    PopulateRtpInfo(seq_no, timestamp, &rtp_info);
+    ASSERT_EQ(0, neteq_->InsertPacket(rtp_info, payload, 0));
+    ++seq_no;
+    timestamp += kSamples;
+    ASSERT_EQ(0, neteq_->GetAudio(kMaxBlockSize, out_data_, &out_len,
+                                  &num_channels, &type));
+    ASSERT_EQ(kBlockSize16kHz, out_len);
+  }
+  EXPECT_EQ(kOutputNormal, type);
+
+  // Stop sending packets. The expansion should be muted, while the playout
+  // timestamp keeps advancing.
+  neteq_->EnableMutedOutput();
+  for (int i = 0; i < kFrames; ++i) {
+    const uint32_t playout_timestamp = PlayoutTimestamp();
+    ASSERT_EQ(0, neteq_->GetAudio(kMaxBlockSize, out_data_, &out_len,
+                                  &num_channels, &type));
+    ASSERT_EQ(kBlockSize16kHz, out_len);
+    EXPECT_NE(kOutputNormal, type);
+    EXPECT_EQ(playout_timestamp + kSamples, PlayoutTimestamp());
+    timestamp += kSamples;
+    if (i == 0) {
+      // The first frame still holds the look-ahead of the last speech frame.
+      continue;
+    }
+    for (size_t j = 0; j < out_len; ++j) {
+      ASSERT_EQ(0, out_data_[j]) << "i = " << i << ", j = " << j;
+    }
+  }
+
+  // Resume sending packets with muted output disabled. The speech should be
+  // back after a few frames.
+  neteq_->DisableMutedOutput();
+  for (int i = 0; i < kFrames; ++i) {
+    PopulateRtpInfo(seq_no, timestamp, &rtp_info);
+    ASSERT_EQ(0, neteq_->InsertPacket(rtp_info, payload, 0));
+    ++seq_no;
+    timestamp += kSamples;
+    ASSERT_EQ(0, neteq_->GetAudio(kMaxBlockSize, out_data_, &out_len,
+                                  &num_channels, &type));
+    ASSERT_EQ(kBlockSize16kHz, out_len);
+  }
+  EXPECT_EQ(kOutputNormal, type);
+  int max_abs_sample = 0;
+  for (size_t j = 0; j < out_len; ++j) {
+    max_abs_sample = std::max(max_abs_sample, std::abs(out_data_[j]));
+  }
+  EXPECT_LT(4000, max_abs_sample);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/neteq/packet.h"
+
+#include <string.h>  // memcpy
+
+namespace webrtc {
+
+void Packet::SetPayload(const uint8_t* data, size_t length) {
+  if (payload != inline_payload_) {
+    delete [] payload;
+  }
+  payload = length <= kMaxInlinePayloadLength ? inline_payload_
+                                              : new uint8_t[length];
+  memcpy(payload, data, length);
+  payload_length = length;
+}
+
+}  // namespace webrtc
@@ -13,13 +13,20 @@
 
 #include <list>
 
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
-// Struct for holding RTP packets.
+// Struct for holding RTP packets. The packet owns |payload| and deletes it when
+// destroyed. Payloads set with SetPayload() are stored inside the object itself
+// if they are small enough, which saves a separate allocation per packet.
 struct Packet {
+  // Payloads of up to this many bytes are stored inside the object. This is
+  // enough for 20 ms of G.711 or G.722, and for 20 ms of Opus at 128 kbps.
+  static const size_t kMaxInlinePayloadLength = 320;
+
   RTPHeader header;
   uint8_t* payload;  // Datagram excluding RTP header and header extension.
   size_t payload_length;
@@ -36,6 +43,17 @@ struct Packet {
         sync_packet(false) {
   }
 
+  ~Packet() {
+    if (payload != inline_payload_) {
+      delete [] payload;
+    }
+  }
+
+  // Copies |length| bytes from |data| into memory owned by the packet, and
+  // sets |payload| and |payload_length| accordingly. Any previous payload is
+  // deleted.
+  void SetPayload(const uint8_t* data, size_t length);
+
   // Comparison operators. Establish a packet ordering based on (1) timestamp,
   // (2) sequence number, (3) regular packet vs sync-packet and (4) redundancy.
   // Timestamp and sequence numbers are compared taking wrap-around into
@@ -79,6 +97,11 @@ struct Packet {
   bool operator>(const Packet& rhs) const { return rhs.operator<(*this); }
   bool operator<=(const Packet& rhs) const { return !operator>(rhs); }
   bool operator>=(const Packet& rhs) const { return !operator<(rhs); }
+
+ private:
+  uint8_t inline_payload_[kMaxInlinePayloadLength];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Packet);
 };
 
 // A list of packets.
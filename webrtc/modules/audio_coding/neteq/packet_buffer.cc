@@ -8,13 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. It is based on a ring
+// buffer of packet pointers, which is allocated once when the buffer is
+// created. The packets are kept sorted at all times so that the next packet to
+// decode is at the beginning of the buffer.
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
-#include <algorithm>  // find_if()
+#include <algorithm>  // max()
 
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/audio_coding/codecs/audio_decoder.h"
@@ -22,23 +23,13 @@
 
 namespace webrtc {
 
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet* new_packet)
-      : new_packet_(new_packet) {
-  }
-  bool operator()(Packet* packet) {
-    return (*new_packet_ >= *packet);
-  }
-
- private:
-  const Packet* new_packet_;
-};
-
 PacketBuffer::PacketBuffer(size_t max_number_of_packets)
-    : max_number_of_packets_(max_number_of_packets) {}
+    : max_number_of_packets_(max_number_of_packets),
+      // A full buffer is flushed before the next packet is inserted, so there
+      // is always room for at least one packet.
+      buffer_(std::max(max_number_of_packets, static_cast<size_t>(1)), NULL),
+      begin_index_(0),
+      num_packets_(0) {}
 
 // Destructor. All packets in the buffer will be destroyed.
 PacketBuffer::~PacketBuffer() {
@@ -47,11 +38,16 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  DeleteAllPackets(&buffer_);
+  for (size_t i = 0; i < num_packets_; ++i) {
+    delete PacketAt(i);
+    PacketAt(i) = NULL;
+  }
+  begin_index_ = 0;
+  num_packets_ = 0;
 }
 
 bool PacketBuffer::Empty() const {
-  return buffer_.empty();
+  return num_packets_ == 0;
 }
 
 int PacketBuffer::InsertPacket(Packet* packet) {
@@ -65,41 +61,46 @@ int PacketBuffer::InsertPacket(Packet* packet) {
 
   int return_val = kOK;
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (num_packets_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     LOG(LS_WARNING) << "Packet buffer flushed";
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(),
-      NewTimestampIsLarger(packet));
-
-  // The new packet is to be inserted to the right of |rit|. If it has the same
-  // timestamp as |rit|, which has a higher priority, do not insert the new
-  // packet to list.
-  if (rit != buffer_.rend() &&
-      packet->header.timestamp == (*rit)->header.timestamp) {
-    delete [] packet->payload;
+  // Find the position in the buffer where the new packet should be inserted.
+  // The buffer is searched from the back, since the most likely case is that
+  // the new packet should be near the end of the buffer.
+  size_t index = num_packets_;
+  while (index > 0 && !(*packet >= *PacketAt(index - 1))) {
+    --index;
+  }
+
+  // The new packet is to be inserted to the right of |index| - 1. If it has the
+  // same timestamp as that packet, which has a higher priority, do not insert
+  // the new packet in the buffer.
+  if (index > 0 &&
+      packet->header.timestamp == PacketAt(index - 1)->header.timestamp) {
     delete packet;
     return return_val;
   }
 
-  // The new packet is to be inserted to the left of |it|. If it has the same
-  // timestamp as |it|, which has a lower priority, replace |it| with the new
-  // packet.
-  PacketList::iterator it = rit.base();
-  if (it != buffer_.end() &&
-      packet->header.timestamp == (*it)->header.timestamp) {
-    delete [] (*it)->payload;
-    delete *it;
-    it = buffer_.erase(it);
+  // The new packet is to be inserted to the left of |index|. If it has the same
+  // timestamp as that packet, which has a lower priority, replace it with the
+  // new packet.
+  if (index < num_packets_ &&
+      packet->header.timestamp == PacketAt(index)->header.timestamp) {
+    delete PacketAt(index);
+    PacketAt(index) = packet;
+    return return_val;
   }
-  buffer_.insert(it, packet);  // Insert the packet at that position.
+
+  // Move the later packets one step towards the back, and insert the packet.
+  for (size_t i = num_packets_; i > index; --i) {
+    PacketAt(i) = PacketAt(i - 1);
+  }
+  PacketAt(index) = packet;
+  ++num_packets_;
 
   return return_val;
 }
@@ -151,7 +152,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front()->header.timestamp;
+  *next_timestamp = PacketAt(0)->header.timestamp;
   return kOK;
 }
 
@@ -163,22 +164,31 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if ((*it)->header.timestamp >= timestamp) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    if (PacketAt(i)->header.timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = (*it)->header.timestamp;
+      *next_timestamp = PacketAt(i)->header.timestamp;
       return kOK;
     }
   }
   return kNotFound;
 }
 
+bool PacketBuffer::ContainsTimestamp(uint32_t timestamp) const {
+  // Search from the back, since recent timestamps are the most likely ones.
+  for (size_t i = num_packets_; i > 0; --i) {
+    if (PacketAt(i - 1)->header.timestamp == timestamp) {
+      return true;
+    }
+  }
+  return false;
+}
+
 const RTPHeader* PacketBuffer::NextRtpHeader() const {
   if (Empty()) {
     return NULL;
   }
-  return const_cast<const RTPHeader*>(&(buffer_.front()->header));
+  return &PacketAt(0)->header;
 }
 
 Packet* PacketBuffer::GetNextPacket(size_t* discard_count) {
@@ -187,17 +197,17 @@ Packet* PacketBuffer::GetNextPacket(size_t* discard_count) {
     return NULL;
   }
 
-  Packet* packet = buffer_.front();
+  Packet* packet = PacketAt(0);
   // Assert that the packet sanity checks in InsertPacket method works.
   assert(packet && packet->payload);
-  buffer_.pop_front();
+  PopFront();
 
   // Discard other packets with the same timestamp. These are duplicates or
   // redundant payloads that should not be used.
   size_t discards = 0;
 
   while (!Empty() &&
-      buffer_.front()->header.timestamp == packet->header.timestamp) {
+      PacketAt(0)->header.timestamp == packet->header.timestamp) {
     if (DiscardNextPacket() != kOK) {
       assert(false);  // Must be ok by design.
     }
@@ -217,16 +227,17 @@ int PacketBuffer::DiscardNextPacket() {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  assert(buffer_.front());
-  assert(buffer_.front()->payload);
-  DeleteFirstPacket(&buffer_);
+  assert(PacketAt(0));
+  assert(PacketAt(0)->payload);
+  delete PacketAt(0);
+  PopFront();
   return kOK;
 }
 
 int PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                     uint32_t horizon_samples) {
-  while (!Empty() && timestamp_limit != buffer_.front()->header.timestamp &&
-         IsObsoleteTimestamp(buffer_.front()->header.timestamp,
+  while (!Empty() && timestamp_limit != PacketAt(0)->header.timestamp &&
+         IsObsoleteTimestamp(PacketAt(0)->header.timestamp,
                              timestamp_limit,
                              horizon_samples)) {
     if (DiscardNextPacket() != kOK) {
@@ -241,16 +252,15 @@ int PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit) {
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
-  return buffer_.size();
+  return num_packets_;
 }
 
 size_t PacketBuffer::NumSamplesInBuffer(DecoderDatabase* decoder_database,
                                         size_t last_decoded_length) const {
-  PacketList::const_iterator it;
   size_t num_samples = 0;
   size_t last_duration = last_decoded_length;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    Packet* packet = (*it);
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet* packet = PacketAt(i);
     AudioDecoder* decoder =
         decoder_database->GetDecoder(packet->header.payloadType);
     if (decoder && !packet->sync_packet) {
@@ -269,9 +279,8 @@ size_t PacketBuffer::NumSamplesInBuffer(DecoderDatabase* decoder_database,
 }
 
 void PacketBuffer::IncrementWaitingTimes(int inc) {
-  PacketList::iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    (*it)->waiting_time += inc;
+  for (size_t i = 0; i < num_packets_; ++i) {
+    PacketAt(i)->waiting_time += inc;
   }
 }
 
@@ -279,9 +288,7 @@ bool PacketBuffer::DeleteFirstPacket(PacketList* packet_list) {
   if (packet_list->empty()) {
     return false;
   }
-  Packet* first_packet = packet_list->front();
-  delete [] first_packet->payload;
-  delete first_packet;
+  delete packet_list->front();
   packet_list->pop_front();
   return true;
 }
@@ -293,8 +300,31 @@ void PacketBuffer::DeleteAllPackets(PacketList* packet_list) {
 }
 
 void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
-  *num_packets = static_cast<int>(buffer_.size());
+  *num_packets = static_cast<int>(num_packets_);
   *max_num_packets = static_cast<int>(max_number_of_packets_);
 }
 
+Packet*& PacketBuffer::PacketAt(size_t index) {
+  assert(index < buffer_.size());
+  size_t buffer_index = begin_index_ + index;
+  if (buffer_index >= buffer_.size()) {
+    buffer_index -= buffer_.size();
+  }
+  return buffer_[buffer_index];
+}
+
+const Packet* PacketBuffer::PacketAt(size_t index) const {
+  return const_cast<PacketBuffer*>(this)->PacketAt(index);
+}
+
+void PacketBuffer::PopFront() {
+  assert(num_packets_ > 0);
+  PacketAt(0) = NULL;
+  ++begin_index_;
+  if (begin_index_ == buffer_.size()) {
+    begin_index_ = 0;
+  }
+  --num_packets_;
+}
+
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
 #include "webrtc/typedefs.h"
@@ -78,6 +80,9 @@ class PacketBuffer {
   virtual int NextHigherTimestamp(uint32_t timestamp,
                                   uint32_t* next_timestamp) const;
 
+  // Returns true if a packet with timestamp |timestamp| is in the buffer.
+  virtual bool ContainsTimestamp(uint32_t timestamp) const;
+
   // Returns a (constant) pointer the RTP header of the first packet in the
   // buffer. Returns NULL if the buffer is empty.
   virtual const RTPHeader* NextRtpHeader() const;
@@ -122,13 +127,11 @@ class PacketBuffer {
 
   virtual void BufferStat(int* num_packets, int* max_num_packets) const;
 
-  // Static method that properly deletes the first packet, and its payload
-  // array, in |packet_list|. Returns false if |packet_list| already was empty,
-  // otherwise true.
+  // Static method that properly deletes the first packet in |packet_list|.
+  // Returns false if |packet_list| already was empty, otherwise true.
   static bool DeleteFirstPacket(PacketList* packet_list);
 
-  // Static method that properly deletes all packets, and their payload arrays,
-  // in |packet_list|.
+  // Static method that properly deletes all packets in |packet_list|.
   static void DeleteAllPackets(PacketList* packet_list);
 
   // Static method returning true if |timestamp| is older than |timestamp_limit|
@@ -146,8 +149,20 @@ class PacketBuffer {
   }
 
  private:
+  // Returns the packet at position |index| in the buffer, where position 0 is
+  // the next packet to decode.
+  Packet*& PacketAt(size_t index);
+  const Packet* PacketAt(size_t index) const;
+
+  // Removes the first packet from the buffer without deleting it.
+  void PopFront();
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  // The packets are kept sorted in a ring buffer, which is allocated once with
+  // room for all packets the buffer can hold.
+  std::vector<Packet*> buffer_;
+  size_t begin_index_;  // Index in |buffer_| of the first packet.
+  size_t num_packets_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
 
@@ -282,7 +282,6 @@ TEST(PacketBuffer, ExtractOrderRedundancy) {
     Packet* packet = buffer.GetNextPacket(&drop_count);
     EXPECT_EQ(0u, drop_count);
     EXPECT_EQ(packet, expect_order[i]);  // Compare pointer addresses.
-    delete[] packet->payload;
     delete packet;
   }
   EXPECT_TRUE(buffer.Empty());
@@ -317,6 +316,21 @@ TEST(PacketBuffer, DiscardPackets) {
   EXPECT_TRUE(buffer.Empty());
 }
 
+TEST(PacketBuffer, ContainsTimestamp) {
+  PacketBuffer buffer(10);  // 10 packets.
+  PacketGenerator gen(17u, 4711u, 0, 10);
+  EXPECT_FALSE(buffer.ContainsTimestamp(4711u));
+  for (int i = 0; i < 3; ++i) {
+    buffer.InsertPacket(gen.NextPacket(10));
+  }
+  EXPECT_TRUE(buffer.ContainsTimestamp(4711u));
+  EXPECT_TRUE(buffer.ContainsTimestamp(4731u));
+  EXPECT_FALSE(buffer.ContainsTimestamp(4721u + 1));
+  EXPECT_FALSE(buffer.ContainsTimestamp(4741u));
+  EXPECT_EQ(PacketBuffer::kOK, buffer.DiscardNextPacket());
+  EXPECT_FALSE(buffer.ContainsTimestamp(4711u));
+}
+
 TEST(PacketBuffer, Reordering) {
   PacketBuffer buffer(100);  // 100 packets.
   const uint16_t start_seq_no = 17;
@@ -359,7 +373,6 @@ TEST(PacketBuffer, Reordering) {
     ASSERT_FALSE(packet == NULL);
     EXPECT_EQ(current_ts, packet->header.timestamp);
     current_ts += ts_increment;
-    delete [] packet->payload;
     delete packet;
   }
   EXPECT_TRUE(buffer.Empty());
@@ -367,6 +380,53 @@ TEST(PacketBuffer, Reordering) {
   EXPECT_CALL(decoder_database, Die());  // Called when object is deleted.
 }
 
+// Test that the packets are kept in order when the buffer wraps around the end
+// of its internal storage.
+TEST(PacketBuffer, InsertAndExtractWithWrapAround) {
+  PacketBuffer buffer(5);  // 5 packets.
+  PacketGenerator gen(0, 0, 0, 10);
+  const int payload_len = 10;
+
+  EXPECT_EQ(PacketBuffer::kOK,
+            buffer.InsertPacket(gen.NextPacket(payload_len)));
+  uint32_t expected_ts = 0;
+  for (int i = 0; i < 10; ++i) {
+    // Insert two packets in reverse order, and extract two packets.
+    Packet* first_packet = gen.NextPacket(payload_len);
+    Packet* second_packet = gen.NextPacket(payload_len);
+    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(second_packet));
+    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(first_packet));
+    EXPECT_EQ(3u, buffer.NumPacketsInBuffer());
+    for (int j = 0; j < 2; ++j) {
+      Packet* packet = buffer.GetNextPacket(NULL);
+      ASSERT_FALSE(packet == NULL);
+      EXPECT_EQ(expected_ts, packet->header.timestamp);
+      expected_ts += 10;
+      delete packet;
+    }
+  }
+  EXPECT_EQ(1u, buffer.NumPacketsInBuffer());
+}
+
+// Test that the packet keeps its own copy of the payload, both when it is
+// stored inside the packet and when it is allocated separately.
+TEST(PacketBuffer, PacketSetPayload) {
+  const size_t kLargePayloadLength = Packet::kMaxInlinePayloadLength + 1;
+  uint8_t data[kLargePayloadLength];
+  for (size_t i = 0; i < kLargePayloadLength; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  const size_t kPayloadLengths[] = {10, kLargePayloadLength, 20};
+  Packet* packet = new Packet;
+  for (size_t length : kPayloadLengths) {
+    packet->SetPayload(data, length);
+    EXPECT_EQ(length, packet->payload_length);
+    EXPECT_NE(data, packet->payload);
+    EXPECT_EQ(0, memcmp(data, packet->payload, length));
+  }
+  delete packet;
+}
+
 TEST(PacketBuffer, Failures) {
   const uint16_t start_seq_no = 17;
   const uint32_t start_ts = 4711;
@@ -489,9 +549,7 @@ TEST(PacketBuffer, ComparePackets) {
   EXPECT_FALSE(*a <= *b);
   EXPECT_TRUE(*a >= *b);
 
-  delete [] a->payload;
   delete a;
-  delete [] b->payload;
   delete b;
 }
 
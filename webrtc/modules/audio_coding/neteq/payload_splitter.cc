@@ -11,27 +11,46 @@
 #include "webrtc/modules/audio_coding/neteq/payload_splitter.h"
 
 #include <assert.h>
+#include <string.h>  // memmove
 
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/audio_coding/neteq/decoder_database.h"
+#include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
 namespace webrtc {
 
-// The method loops through a list of packets {A, B, C, ...}. Each packet is
-// split into its corresponding RED payloads, {A1, A2, ...}, which is
-// temporarily held in the list |new_packets|.
-// When the first packet in |packet_list| has been processed, the orignal packet
-// is replaced by the new ones in |new_packets|, so that |packet_list| becomes:
-// {A1, A2, ..., B, C, ...}. The method then continues with B, and C, until all
-// the original packets have been replaced by their split payloads.
 int PayloadSplitter::SplitRed(PacketList* packet_list) {
+  return SplitRedInternal(packet_list, NULL, rtc::Optional<uint32_t>(), 0);
+}
+
+int PayloadSplitter::SplitRed(PacketList* packet_list,
+                              const PacketBuffer& packet_buffer,
+                              rtc::Optional<uint32_t> timestamp_limit,
+                              uint32_t horizon_samples) {
+  return SplitRedInternal(packet_list, &packet_buffer, timestamp_limit,
+                          horizon_samples);
+}
+
+// The method loops through a list of packets {A, B, C, ...}. Each packet is
+// split into its corresponding RED payloads, {A1, A2, ...}, where A1 is the
+// primary payload. The primary payload is moved to the front of the payload of
+// A itself, so that no new packet is needed for it, and the redundant payloads
+// are inserted as new packets directly after A, so that |packet_list| becomes:
+// {A1, A2, ..., B, C, ...}. The RED headers are parsed before any payload is
+// copied, which makes it possible to skip the redundant payloads that the
+// packet buffer would discard anyway. The method then continues with B, and C,
+// until all the original packets have been split.
+int PayloadSplitter::SplitRedInternal(PacketList* packet_list,
+                                      const PacketBuffer* packet_buffer,
+                                      rtc::Optional<uint32_t> timestamp_limit,
+                                      uint32_t horizon_samples) {
   int ret = kOK;
   PacketList::iterator it = packet_list->begin();
   while (it != packet_list->end()) {
-    PacketList new_packets;  // An empty list to store the split packets in.
     Packet* red_packet = (*it);
     assert(red_packet->payload);
-    uint8_t* payload_ptr = red_packet->payload;
+    const uint8_t* payload_end =
+        red_packet->payload + red_packet->payload_length;
 
     // Read RED headers (according to RFC 2198):
     //
@@ -46,77 +65,76 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
     //   |0|   Block PT  |
     //   +-+-+-+-+-+-+-+-+
 
-    bool last_block = false;
-    size_t sum_length = 0;
-    while (!last_block) {
-      Packet* new_packet = new Packet;
-      new_packet->header = red_packet->header;
-      // Check the F bit. If F == 0, this was the last block.
-      last_block = ((*payload_ptr & 0x80) == 0);
-      // Bits 1 through 7 are payload type.
-      new_packet->header.payloadType = payload_ptr[0] & 0x7F;
-      if (last_block) {
-        // No more header data to read.
-        ++sum_length;  // Account for RED header size of 1 byte.
-        new_packet->payload_length = red_packet->payload_length - sum_length;
-        new_packet->primary = true;  // Last block is always primary.
-        payload_ptr += 1;  // Advance to first payload byte.
-      } else {
-        // Bits 8 through 21 are timestamp offset.
-        int timestamp_offset = (payload_ptr[1] << 6) +
-            ((payload_ptr[2] & 0xFC) >> 2);
-        new_packet->header.timestamp = red_packet->header.timestamp -
-            timestamp_offset;
-        // Bits 22 through 31 are payload length.
-        new_packet->payload_length = ((payload_ptr[2] & 0x03) << 8) +
-            payload_ptr[3];
-        new_packet->primary = false;
-        payload_ptr += 4;  // Advance to next RED header.
-      }
-      sum_length += new_packet->payload_length;
-      sum_length += 4;  // Account for RED header size of 4 bytes.
-      // Store in new list of packets.
-      new_packets.push_back(new_packet);
+    // Find the last RED header, which is followed by the first payload byte.
+    // The F bit is set in all headers but the last one.
+    const uint8_t* last_header_ptr = red_packet->payload;
+    while (last_header_ptr < payload_end && (*last_header_ptr & 0x80)) {
+      last_header_ptr += 4;
+    }
+    if (last_header_ptr >= payload_end) {
+      // The headers do not fit in the packet. Something is corrupt. Discard
+      // the whole packet.
+      LOG(LS_WARNING) << "SplitRed length mismatch";
+      delete red_packet;
+      it = packet_list->erase(it);
+      ret = kRedLengthMismatch;
+      continue;
     }
 
-    // Populate the new packets with payload data.
-    // |payload_ptr| now points at the first payload byte.
-    PacketList::iterator new_it;
-    for (new_it = new_packets.begin(); new_it != new_packets.end(); ++new_it) {
-      size_t payload_length = (*new_it)->payload_length;
-      if (payload_ptr + payload_length >
-          red_packet->payload + red_packet->payload_length) {
+    // Create packets for the redundant payloads, oldest first. Each new packet
+    // is inserted in front of the previous one, so that the newest redundant
+    // payload ends up directly after the primary payload.
+    PacketList::iterator next_it = it;
+    ++next_it;
+    PacketList::iterator insert_it = next_it;
+    const uint8_t* header_ptr = red_packet->payload;
+    const uint8_t* block_ptr = last_header_ptr + 1;
+    bool length_mismatch = false;
+    for (; header_ptr < last_header_ptr; header_ptr += 4) {
+      // Bits 8 through 21 are timestamp offset.
+      int timestamp_offset = (header_ptr[1] << 6) +
+          ((header_ptr[2] & 0xFC) >> 2);
+      uint32_t timestamp = red_packet->header.timestamp - timestamp_offset;
+      // Bits 22 through 31 are payload length.
+      size_t payload_length = ((header_ptr[2] & 0x03) << 8) + header_ptr[3];
+      if (payload_length > static_cast<size_t>(payload_end - block_ptr)) {
         // The block lengths in the RED headers do not match the overall packet
         // length. Something is corrupt. Discard this and the remaining
         // payloads from this packet.
         LOG(LS_WARNING) << "SplitRed length mismatch";
-        while (new_it != new_packets.end()) {
-          // Payload should not have been allocated yet.
-          assert(!(*new_it)->payload);
-          delete (*new_it);
-          new_it = new_packets.erase(new_it);
-        }
-        ret = kRedLengthMismatch;
+        length_mismatch = true;
         break;
       }
-      (*new_it)->payload = new uint8_t[payload_length];
-      memcpy((*new_it)->payload, payload_ptr, payload_length);
-      payload_ptr += payload_length;
+      if (!packet_buffer || !(packet_buffer->ContainsTimestamp(timestamp) ||
+                              (timestamp_limit &&
+                               PacketBuffer::IsObsoleteTimestamp(
+                                   timestamp, *timestamp_limit,
+                                   horizon_samples)))) {
+        Packet* new_packet = new Packet;
+        new_packet->header = red_packet->header;
+        // Bits 1 through 7 are payload type.
+        new_packet->header.payloadType = header_ptr[0] & 0x7F;
+        new_packet->header.timestamp = timestamp;
+        new_packet->primary = false;
+        new_packet->SetPayload(block_ptr, payload_length);
+        insert_it = packet_list->insert(insert_it, new_packet);
+      }
+      block_ptr += payload_length;
     }
-    // Reverse the order of the new packets, so that the primary payload is
-    // always first.
-    new_packets.reverse();
-    // Insert new packets into original list, before the element pointed to by
-    // iterator |it|.
-    packet_list->splice(it, new_packets, new_packets.begin(),
-                        new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
-    delete (*it);
-    // Remove |it| from the packet list. This operation effectively moves the
-    // iterator |it| to the next packet in the list. Thus, we do not have to
-    // increment it manually.
-    it = packet_list->erase(it);
+
+    if (length_mismatch) {
+      ret = kRedLengthMismatch;
+      delete red_packet;
+      packet_list->erase(it);
+    } else {
+      // The last block is always primary, and takes the rest of the packet.
+      // Move it to the start of the payload buffer.
+      red_packet->header.payloadType = *last_header_ptr & 0x7F;
+      red_packet->payload_length = payload_end - block_ptr;
+      red_packet->primary = true;
+      memmove(red_packet->payload, block_ptr, red_packet->payload_length);
+    }
+    it = next_it;
   }
   return ret;
 }
@@ -163,9 +181,7 @@ int PayloadSplitter::SplitFec(PacketList* packet_list,
         int duration = decoder->
             PacketDurationRedundant(packet->payload, packet->payload_length);
         new_packet->header.timestamp -= duration;
-        new_packet->payload = new uint8_t[packet->payload_length];
-        memcpy(new_packet->payload, packet->payload, packet->payload_length);
-        new_packet->payload_length = packet->payload_length;
+        new_packet->SetPayload(packet->payload, packet->payload_length);
         new_packet->primary = false;
         new_packet->waiting_time = packet->waiting_time;
         new_packet->sync_packet = packet->sync_packet;
@@ -200,7 +216,6 @@ int PayloadSplitter::CheckRedPayloads(PacketList* packet_list,
         if (this_payload_type != main_payload_type) {
           // We do not allow redundant payloads of a different type.
           // Discard this payload.
-          delete [] (*it)->payload;
           delete (*it);
           // Remove |it| from the packet list. This operation effectively
           // moves the iterator |it| to the next packet in the list. Thus, we
@@ -344,8 +359,7 @@ int PayloadSplitter::SplitAudio(PacketList* packet_list,
     // iterator |it|.
     packet_list->splice(it, new_packets, new_packets.begin(),
                         new_packets.end());
-    // Delete old packet payload.
-    delete [] (*it)->payload;
+    // Delete old packet.
     delete (*it);
     // Remove |it| from the packet list. This operation effectively moves the
     // iterator |it| to the next packet in the list. Thus, we do not have to
@@ -380,13 +394,11 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   size_t len = packet->payload_length;
   while (len >= (2 * split_size_bytes)) {
     Packet* new_packet = new Packet;
-    new_packet->payload_length = split_size_bytes;
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     timestamp += timestamps_per_chunk;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[split_size_bytes];
-    memcpy(new_packet->payload, payload_ptr, split_size_bytes);
+    new_packet->SetPayload(payload_ptr, split_size_bytes);
     payload_ptr += split_size_bytes;
     new_packets->push_back(new_packet);
     len -= split_size_bytes;
@@ -394,12 +406,10 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
 
   if (len > 0) {
     Packet* new_packet = new Packet;
-    new_packet->payload_length = len;
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[len];
-    memcpy(new_packet->payload, payload_ptr, len);
+    new_packet->SetPayload(payload_ptr, len);
     new_packets->push_back(new_packet);
   }
 }
@@ -424,13 +434,11 @@ int PayloadSplitter::SplitByFrames(const Packet* packet,
   while (len > 0) {
     assert(len >= bytes_per_frame);
     Packet* new_packet = new Packet;
-    new_packet->payload_length = bytes_per_frame;
     new_packet->header = packet->header;
     new_packet->header.timestamp = timestamp;
     timestamp += timestamps_per_frame;
     new_packet->primary = packet->primary;
-    new_packet->payload = new uint8_t[bytes_per_frame];
-    memcpy(new_packet->payload, payload_ptr, bytes_per_frame);
+    new_packet->SetPayload(payload_ptr, bytes_per_frame);
     payload_ptr += bytes_per_frame;
     new_packets->push_back(new_packet);
     len -= bytes_per_frame;
@@ -12,12 +12,14 @@
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_PAYLOAD_SPLITTER_H_
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
 
 namespace webrtc {
 
 // Forward declarations.
 class DecoderDatabase;
+class PacketBuffer;
 
 // This class handles splitting of payloads into smaller parts.
 // The class does not have any member variables, and the methods could have
@@ -42,12 +44,25 @@ class PayloadSplitter {
 
   // Splits each packet in |packet_list| into its separate RED payloads. Each
   // RED payload is packetized into a Packet. The original elements in
-  // |packet_list| are properly deleted, and replaced by the new packets.
+  // |packet_list| are reused for the primary payloads, and the redundant
+  // payloads are inserted after them as new packets.
   // Note that all packets in |packet_list| must be RED payloads, i.e., have
   // RED headers according to RFC 2198 at the very beginning of the payload.
   // Returns kOK or an error.
   virtual int SplitRed(PacketList* packet_list);
 
+  // Same as above, but does not create packets for redundant payloads that
+  // would be discarded right away: those with a timestamp that is already in
+  // |packet_buffer|, and, if |timestamp_limit| is set, those that are older
+  // than |timestamp_limit| but newer than |timestamp_limit| - |horizon_samples|
+  // (see PacketBuffer::DiscardOldPackets()). The payloads of such blocks are
+  // never copied. The timestamps in |packet_buffer| must not be scaled, i.e.,
+  // they must be comparable to the RTP timestamps in |packet_list|.
+  virtual int SplitRed(PacketList* packet_list,
+                       const PacketBuffer& packet_buffer,
+                       rtc::Optional<uint32_t> timestamp_limit,
+                       uint32_t horizon_samples);
+
   // Iterates through |packet_list| and, duplicate each audio payload that has
   // FEC as new packet for redundant decoding. The decoder database is needed to
   // get information about which payload type each packet contains.
@@ -68,6 +83,13 @@ class PayloadSplitter {
                          const DecoderDatabase& decoder_database);
 
  private:
+  // Implements both versions of SplitRed(). Redundant payloads are only
+  // filtered if |packet_buffer| is not NULL.
+  int SplitRedInternal(PacketList* packet_list,
+                       const PacketBuffer* packet_buffer,
+                       rtc::Optional<uint32_t> timestamp_limit,
+                       uint32_t horizon_samples);
+
   // Splits the payload in |packet|. The payload is assumed to be from a
   // sample-based codec.
   virtual void SplitBySamples(const Packet* packet,
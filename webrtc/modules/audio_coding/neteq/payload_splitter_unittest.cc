@@ -20,6 +20,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_coding/neteq/mock/mock_decoder_database.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
+#include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
 using ::testing::Return;
 using ::testing::ReturnNull;
@@ -178,14 +179,12 @@ TEST(RedPayloadSplitter, OnePacketTwoPayloads) {
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
                kBaseTimestamp, 1, true);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check second packet.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
                kBaseTimestamp - kTimestampOffset, 0, false);
-  delete [] packet->payload;
   delete packet;
 }
 
@@ -211,14 +210,12 @@ TEST(RedPayloadSplitter, TwoPacketsOnePayload) {
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
                kBaseTimestamp, 0, true);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check second packet.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber + 1,
                kBaseTimestamp + kTimestampOffset, 0, true);
-  delete [] packet->payload;
   delete packet;
 }
 
@@ -251,42 +248,36 @@ TEST(RedPayloadSplitter, TwoPacketsThreePayloads) {
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[2], kSequenceNumber,
                kBaseTimestamp, 2, true);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check second packet, A2.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
                kBaseTimestamp - kTimestampOffset, 1, false);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check third packet, A3.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
                kBaseTimestamp - 2 * kTimestampOffset, 0, false);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check fourth packet, B1.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[2], kSequenceNumber + 1,
                kBaseTimestamp + kTimestampOffset, 2, true);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check fifth packet, B2.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber + 1,
                kBaseTimestamp, 1, false);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
   // Check sixth packet, B3.
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber + 1,
                kBaseTimestamp - kTimestampOffset, 0, false);
-  delete [] packet->payload;
   delete packet;
 }
 
@@ -324,13 +315,47 @@ TEST(RedPayloadSplitter, CheckRedPayloads) {
   for (int i = 0; i <= 2; ++i) {
     Packet* packet = packet_list.front();
     VerifyPacket(packet, 10, i, kSequenceNumber, kBaseTimestamp, 0, true);
-    delete [] packet->payload;
     delete packet;
     packet_list.pop_front();
   }
   EXPECT_TRUE(packet_list.empty());
 }
 
+// Packet A is split into A1, A2, A3 and A4, where A2 is already in the packet
+// buffer and A4 is older than the timestamp limit. No packets are created for
+// those two payloads.
+TEST(RedPayloadSplitter, SkipsDuplicateAndOldPayloads) {
+  uint8_t payload_types[] = {3, 2, 1, 0};  // Primary is the last one.
+  const int kTimestampOffset = 160;
+  Packet* packet = CreateRedPayload(4, payload_types, kTimestampOffset);
+  PacketList packet_list;
+  packet_list.push_back(packet);
+
+  PacketBuffer packet_buffer(10);
+  Packet* buffered_packet = CreatePacket(1, kPayloadLength, 0);
+  buffered_packet->header.timestamp = kBaseTimestamp - kTimestampOffset;
+  EXPECT_EQ(PacketBuffer::kOK, packet_buffer.InsertPacket(buffered_packet));
+
+  PayloadSplitter splitter;
+  EXPECT_EQ(PayloadSplitter::kOK,
+            splitter.SplitRed(&packet_list, packet_buffer,
+                              rtc::Optional<uint32_t>(
+                                  kBaseTimestamp - 2 * kTimestampOffset),
+                              0));
+  ASSERT_EQ(2u, packet_list.size());
+  // The primary payload A1 is first.
+  packet = packet_list.front();
+  VerifyPacket(packet, kPayloadLength, payload_types[3], kSequenceNumber,
+               kBaseTimestamp, 3, true);
+  delete packet;
+  packet_list.pop_front();
+  // A3 has the same timestamp as the limit, and is kept.
+  packet = packet_list.front();
+  VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
+               kBaseTimestamp - 2 * kTimestampOffset, 1, false);
+  delete packet;
+}
+
 // Packet A is split into A1, A2 and A3. But the length parameter is off, so
 // the last payloads should be discarded.
 TEST(RedPayloadSplitter, WrongPayloadLength) {
@@ -351,7 +376,6 @@ TEST(RedPayloadSplitter, WrongPayloadLength) {
   packet = packet_list.front();
   VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
                kBaseTimestamp - 2 * kTimestampOffset, 0, false);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 }
@@ -413,7 +437,6 @@ TEST(AudioPayloadSplitter, NonSplittable) {
     VerifyPacket((*it), kPayloadLength, payload_type, kSequenceNumber,
                  kBaseTimestamp, 10 * payload_type);
     ++payload_type;
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
   }
@@ -444,7 +467,6 @@ TEST(AudioPayloadSplitter, UnknownPayloadType) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
   }
@@ -564,7 +586,6 @@ TEST_P(SplitBySamplesTest, PayloadSizes) {
         expected_timestamp_offset_ms[i] * samples_per_ms_;
     VerifyPacket((*it), length_bytes, kPayloadType, kSequenceNumber,
                  expected_timestamp, expected_payload_value[i]);
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
     ++i;
@@ -648,7 +669,6 @@ TEST_P(SplitIlbcTest, NumFrames) {
       EXPECT_EQ(payload_value, packet->payload[i]);
       ++payload_value;
     }
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
     ++frame_num;
@@ -700,7 +720,6 @@ TEST(IlbcPayloadSplitter, TooLargePayload) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
   }
@@ -732,7 +751,6 @@ TEST(IlbcPayloadSplitter, UnevenPayload) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete [] (*it)->payload;
     delete (*it);
     it = packet_list.erase(it);
   }
@@ -768,7 +786,6 @@ TEST(FecPayloadSplitter, MixedPayload) {
   EXPECT_EQ(kBaseTimestamp - 20 * 48, packet->header.timestamp);
   EXPECT_EQ(10U, packet->payload_length);
   EXPECT_FALSE(packet->primary);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
@@ -778,21 +795,18 @@ TEST(FecPayloadSplitter, MixedPayload) {
   EXPECT_EQ(kBaseTimestamp, packet->header.timestamp);
   EXPECT_EQ(10U, packet->payload_length);
   EXPECT_TRUE(packet->primary);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
   // Check third packet.
   packet = packet_list.front();
   VerifyPacket(packet, 10, 0, kSequenceNumber, kBaseTimestamp, 0, true);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
   // Check fourth packet.
   packet = packet_list.front();
   VerifyPacket(packet, 10, 1, kSequenceNumber, kBaseTimestamp, 0, true);
-  delete [] packet->payload;
   delete packet;
 }
 
@@ -821,7 +835,6 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   EXPECT_EQ(kPayloadLength, packet->payload_length);
   EXPECT_FALSE(packet->primary);
   EXPECT_EQ(packet->payload[3], 1);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
@@ -832,7 +845,6 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   EXPECT_EQ(kPayloadLength, packet->payload_length);
   EXPECT_TRUE(packet->primary);
   EXPECT_EQ(packet->payload[3], 1);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
@@ -843,7 +855,6 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   EXPECT_EQ(kPayloadLength, packet->payload_length);
   EXPECT_FALSE(packet->primary);
   EXPECT_EQ(packet->payload[3], 0);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 
@@ -854,7 +865,6 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   EXPECT_EQ(kPayloadLength, packet->payload_length);
   EXPECT_TRUE(packet->primary);
   EXPECT_EQ(packet->payload[3], 0);
-  delete [] packet->payload;
   delete packet;
   packet_list.pop_front();
 }
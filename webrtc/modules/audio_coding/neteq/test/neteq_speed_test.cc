@@ -49,6 +49,17 @@ DEFINE_double(drift, 0.1,
 static const bool drift_dummy =
     google::RegisterFlagValidator(&FLAGS_drift, &ValidateDriftfactor);
 
+static void PrintOperationCost(
+    const char* name,
+    const webrtc::test::NetEqPerformanceTest::OperationCost& cost) {
+  std::cout << name << ": " << cost.calls << " calls";
+  if (cost.calls > 0) {
+    std::cout << ", " << static_cast<double>(cost.total_time_us) / cost.calls
+              << " us per call";
+  }
+  std::cout << std::endl;
+}
+
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
   std::string usage = "Tool for measuring the speed of NetEq.\n"
@@ -66,9 +77,10 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  webrtc::test::NetEqPerformanceTest::OperationCosts costs;
   int64_t result =
       webrtc::test::NetEqPerformanceTest::Run(FLAGS_runtime_ms, FLAGS_lossrate,
-                                              FLAGS_drift);
+                                              FLAGS_drift, &costs);
   if (result <= 0) {
     std::cout << "There was an error" << std::endl;
     return -1;
@@ -76,5 +88,11 @@ int main(int argc, char* argv[]) {
 
   std::cout << "Simulation done" << std::endl;
   std::cout << "Runtime = " << result << " ms" << std::endl;
+  PrintOperationCost("Normal", costs.normal);
+  PrintOperationCost("Expand", costs.expand);
+  PrintOperationCost("Merge", costs.merge);
+  PrintOperationCost("Accelerate", costs.accelerate);
+  PrintOperationCost("Preemptive expand", costs.preemptive_expand);
+  PrintOperationCost("Comfort noise", costs.comfort_noise);
   return 0;
 }
@@ -100,4 +100,8 @@ uint32_t TimestampScaler::ToExternal(uint32_t internal_timestamp) const {
   }
 }
 
+bool TimestampScaler::IsScaling() const {
+  return first_packet_received_ && !(numerator_ == 1 && denominator_ == 1);
+}
+
 }  // namespace webrtc
@@ -53,6 +53,10 @@ class TimestampScaler {
   // Scales back to external timestamp. This is the inverse of ToInternal().
   virtual uint32_t ToExternal(uint32_t internal_timestamp) const;
 
+  // Returns true if internal and external timestamps currently differ, i.e.,
+  // if the last scaled packet was from a codec that uses timestamp scaling.
+  virtual bool IsScaling() const;
+
  private:
   bool first_packet_received_;
   int numerator_;
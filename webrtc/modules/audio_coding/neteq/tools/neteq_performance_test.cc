@@ -10,6 +10,7 @@
 
 #include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/audio_coding/codecs/pcm16b/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/include/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
@@ -29,6 +30,13 @@ namespace test {
 int64_t NetEqPerformanceTest::Run(int runtime_ms,
                                   int lossrate,
                                   double drift_factor) {
+  return Run(runtime_ms, lossrate, drift_factor, nullptr);
+}
+
+int64_t NetEqPerformanceTest::Run(int runtime_ms,
+                                  int lossrate,
+                                  double drift_factor,
+                                  OperationCosts* costs) {
   const std::string kInputFileName =
       webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
   const int kSampRateHz = 32000;
@@ -111,11 +119,24 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
     int16_t out_data[kOutDataLen];
     size_t num_channels;
     size_t samples_per_channel;
+    NetEqOutputType type;
+    const uint64_t get_audio_start_us = costs ? rtc::TimeMicros() : 0;
     int error = neteq->GetAudio(kOutDataLen, out_data, &samples_per_channel,
-                                &num_channels, NULL);
+                                &num_channels, &type);
     if (error != NetEq::kOK)
       return -1;
 
+    if (costs) {
+      const int64_t get_audio_time_us =
+          static_cast<int64_t>(rtc::TimeMicros() - get_audio_start_us);
+      // The statistics are reset by each call, so they only cover the last
+      // GetAudio() call.
+      NetEqNetworkStatistics stats;
+      if (neteq->NetworkStatistics(&stats) != NetEq::kOK)
+        return -1;
+      AddCost(type, stats, get_audio_time_us, costs);
+    }
+
     assert(samples_per_channel == static_cast<size_t>(kSampRateHz * 10 / 1000));
 
     time_now_ms += kOutputBlockSizeMs;
@@ -130,5 +151,26 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
   return end_time_ms - start_time_ms;
 }
 
+void NetEqPerformanceTest::AddCost(NetEqOutputType type,
+                                   const NetEqNetworkStatistics& stats,
+                                   int64_t time_us,
+                                   OperationCosts* costs) {
+  OperationCost* cost = &costs->normal;
+  if (type == kOutputCNG) {
+    cost = &costs->comfort_noise;
+  } else if (stats.accelerate_rate > 0) {
+    cost = &costs->accelerate;
+  } else if (stats.preemptive_rate > 0) {
+    cost = &costs->preemptive_expand;
+  } else if (type == kOutputPLC || type == kOutputPLCtoCNG) {
+    cost = &costs->expand;
+  } else if (stats.expand_rate > 0) {
+    // Only a merge adds concealment without ending in expand mode.
+    cost = &costs->merge;
+  }
+  ++cost->calls;
+  cost->total_time_us += time_us;
+}
+
 }  // namespace test
 }  // namespace webrtc
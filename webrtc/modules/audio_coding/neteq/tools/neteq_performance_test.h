@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 
+#include "webrtc/modules/audio_coding/neteq/include/neteq.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -18,12 +19,47 @@ namespace test {
 
 class NetEqPerformanceTest {
  public:
+  // Number of GetAudio() calls and the total time spent in them.
+  struct OperationCost {
+    int calls = 0;
+    int64_t total_time_us = 0;
+  };
+
+  // The cost of GetAudio() per operation. The operation of each call is
+  // deduced from the output type and the network statistics.
+  struct OperationCosts {
+    OperationCost normal;
+    OperationCost expand;
+    // A merge that did not need to extend the concealment is counted as
+    // normal.
+    OperationCost merge;
+    OperationCost accelerate;
+    OperationCost preemptive_expand;
+    OperationCost comfort_noise;
+  };
+
   // Runs a performance test with parameters as follows:
   //   |runtime_ms|: the simulation time, i.e., the duration of the audio data.
   //   |lossrate|: drop one out of |lossrate| packets, e.g., one out of 10.
   //   |drift_factor|: clock drift in [0, 1].
   // Returns the runtime in ms.
   static int64_t Run(int runtime_ms, int lossrate, double drift_factor);
+
+  // Same as above, but also reports the cost per operation in |costs|, if not
+  // null. Collecting the costs adds a NetworkStatistics() call after each
+  // GetAudio() call, which is included in the returned runtime.
+  static int64_t Run(int runtime_ms,
+                     int lossrate,
+                     double drift_factor,
+                     OperationCosts* costs);
+
+  // Adds a GetAudio() call that took |time_us| to |costs|. |type| is the
+  // output type of the call and |stats| the network statistics fetched right
+  // after it, so that they cover that call only.
+  static void AddCost(NetEqOutputType type,
+                      const NetEqNetworkStatistics& stats,
+                      int64_t time_us,
+                      OperationCosts* costs);
 };
 
 }  // namespace test
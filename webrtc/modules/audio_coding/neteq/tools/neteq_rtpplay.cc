@@ -21,20 +21,25 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "google/gflags.h"
 #include "webrtc/base/checks.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/safe_conversions.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/audio_coding/codecs/pcm16b/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/include/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/tools/input_audio_file.h"
+#include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 #include "webrtc/modules/audio_coding/neteq/tools/output_audio_file.h"
 #include "webrtc/modules/audio_coding/neteq/tools/output_wav_file.h"
 #include "webrtc/modules/audio_coding/neteq/tools/packet.h"
 #include "webrtc/modules/audio_coding/neteq/tools/rtc_event_log_source.h"
 #include "webrtc/modules/audio_coding/neteq/tools/rtp_file_source.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/trace.h"
 #include "webrtc/test/rtp_file_reader.h"
 #include "webrtc/test/testsupport/fileutils.h"
@@ -143,6 +148,13 @@ DEFINE_string(ssrc,
               "starting with 0x)");
 const bool hex_ssrc_dummy =
     google::RegisterFlagValidator(&FLAGS_ssrc, &ValidateSsrcValue);
+DEFINE_bool(benchmark, false,
+            "Decodes all input files as fast as possible, without writing any "
+            "output, and prints the time spent per NetEq operation and the "
+            "concealment statistics");
+DEFINE_int32(num_threads, 0,
+             "Number of files to decode in parallel in benchmark mode; 0 uses "
+             "one thread per core");
 
 // Maps a codec type to a printable name string.
 std::string CodecName(webrtc::NetEqDecoder codec) {
@@ -379,6 +391,313 @@ size_t ReplacePayload(webrtc::test::InputAudioFile* replacement_audio_file,
   return payload_len;
 }
 
+// The result of decoding one file in benchmark mode.
+struct BenchmarkResult {
+  bool ok = false;
+  int64_t audio_ms = 0;
+  int64_t insert_time_us = 0;
+  webrtc::test::NetEqPerformanceTest::OperationCosts costs;
+  // The network statistics rates of the GetAudio() calls summed, in Q14.
+  int64_t packet_loss_rate_sum = 0;
+  int64_t expand_rate_sum = 0;
+  int64_t speech_expand_rate_sum = 0;
+  int64_t accelerate_rate_sum = 0;
+  int64_t preemptive_rate_sum = 0;
+  // The number of times NetEq went from playing out audio to concealing.
+  int concealment_events = 0;
+
+  int get_audio_calls() const {
+    return costs.normal.calls + costs.expand.calls + costs.merge.calls +
+           costs.accelerate.calls + costs.preemptive_expand.calls +
+           costs.comfort_noise.calls;
+  }
+};
+
+void AddOperationCost(
+    const webrtc::test::NetEqPerformanceTest::OperationCost& from,
+    webrtc::test::NetEqPerformanceTest::OperationCost* to) {
+  to->calls += from.calls;
+  to->total_time_us += from.total_time_us;
+}
+
+void AddBenchmarkResult(const BenchmarkResult& from, BenchmarkResult* to) {
+  to->audio_ms += from.audio_ms;
+  to->insert_time_us += from.insert_time_us;
+  AddOperationCost(from.costs.normal, &to->costs.normal);
+  AddOperationCost(from.costs.expand, &to->costs.expand);
+  AddOperationCost(from.costs.merge, &to->costs.merge);
+  AddOperationCost(from.costs.accelerate, &to->costs.accelerate);
+  AddOperationCost(from.costs.preemptive_expand,
+                   &to->costs.preemptive_expand);
+  AddOperationCost(from.costs.comfort_noise, &to->costs.comfort_noise);
+  to->packet_loss_rate_sum += from.packet_loss_rate_sum;
+  to->expand_rate_sum += from.expand_rate_sum;
+  to->speech_expand_rate_sum += from.speech_expand_rate_sum;
+  to->accelerate_rate_sum += from.accelerate_rate_sum;
+  to->preemptive_rate_sum += from.preemptive_rate_sum;
+  to->concealment_events += from.concealment_events;
+}
+
+// Decodes |file_name| through NetEq like main() does, but without pacing,
+// replacement audio or output, and times each InsertPacket() and GetAudio()
+// call. Returns false if the file could not be decoded.
+bool BenchmarkFile(const std::string& file_name, BenchmarkResult* result) {
+  static const int kMaxChannels = 5;
+  static const size_t kMaxSamplesPerMs = 48000 / 1000;
+  static const int kOutputBlockSizeMs = 10;
+
+  bool is_rtp_dump = false;
+  rtc::scoped_ptr<webrtc::test::PacketSource> file_source;
+  webrtc::test::RtcEventLogSource* event_log_source = nullptr;
+  if (webrtc::test::RtpFileSource::ValidRtpDump(file_name) ||
+      webrtc::test::RtpFileSource::ValidPcap(file_name)) {
+    is_rtp_dump = true;
+    file_source.reset(webrtc::test::RtpFileSource::Create(file_name));
+  } else {
+    event_log_source = webrtc::test::RtcEventLogSource::Create(file_name);
+    file_source.reset(event_log_source);
+  }
+  if (!file_source)
+    return false;
+  if (!FLAGS_ssrc.empty()) {
+    uint32_t ssrc;
+    RTC_CHECK(ParseSsrc(FLAGS_ssrc, &ssrc)) << "Flag verification has failed.";
+    file_source->SelectSsrc(ssrc);
+  }
+
+  rtc::scoped_ptr<webrtc::test::Packet> packet(file_source->NextPacket());
+  if (!packet || packet->payload_length_bytes() == 0)
+    return false;
+  int sample_rate_hz = CodecSampleRate(packet->header().payloadType);
+  if (sample_rate_hz <= 0)
+    return false;
+
+  NetEq::Config config;
+  config.sample_rate_hz = sample_rate_hz;
+  rtc::scoped_ptr<NetEq> neteq(NetEq::Create(config));
+  RegisterPayloadTypes(neteq.get());
+
+  // Keep the same simulated time as main(), so that NetEq makes the same
+  // decisions.
+  int64_t start_time_ms = rtc::checked_cast<int64_t>(packet->time_ms());
+  int64_t time_now_ms = start_time_ms;
+  int64_t next_input_time_ms = time_now_ms;
+  int64_t next_output_time_ms = time_now_ms;
+  if (time_now_ms % kOutputBlockSizeMs != 0) {
+    next_output_time_ms +=
+        kOutputBlockSizeMs - time_now_ms % kOutputBlockSizeMs;
+  }
+  bool packet_available = true;
+  bool output_event_available = true;
+  if (!is_rtp_dump) {
+    next_output_time_ms = event_log_source->NextAudioOutputEventMs();
+    if (next_output_time_ms == std::numeric_limits<int64_t>::max())
+      output_event_available = false;
+    start_time_ms = time_now_ms =
+        std::min(next_input_time_ms, next_output_time_ms);
+  }
+  bool concealing = false;
+  while (packet_available || output_event_available) {
+    time_now_ms = std::min(next_input_time_ms, next_output_time_ms);
+    while (time_now_ms >= next_input_time_ms && packet_available) {
+      WebRtcRTPHeader rtp_header;
+      packet->ConvertHeader(&rtp_header);
+      const uint64_t insert_start_us = rtc::TimeMicros();
+      // Insertion errors are ignored; a file with a few bad packets is still
+      // worth timing.
+      neteq->InsertPacket(
+          rtp_header,
+          rtc::ArrayView<const uint8_t>(packet->payload(),
+                                        packet->payload_length_bytes()),
+          static_cast<uint32_t>(packet->time_ms() * sample_rate_hz / 1000));
+      result->insert_time_us +=
+          static_cast<int64_t>(rtc::TimeMicros() - insert_start_us);
+
+      packet.reset(file_source->NextPacket());
+      if (packet) {
+        next_input_time_ms = rtc::checked_cast<int64_t>(packet->time_ms());
+      } else {
+        next_input_time_ms = std::numeric_limits<int64_t>::max();
+        packet_available = false;
+      }
+    }
+
+    while (time_now_ms >= next_output_time_ms && output_event_available) {
+      static const size_t kOutDataLen =
+          kOutputBlockSizeMs * kMaxSamplesPerMs * kMaxChannels;
+      int16_t out_data[kOutDataLen];
+      size_t num_channels;
+      size_t samples_per_channel;
+      webrtc::NetEqOutputType type;
+      const uint64_t get_audio_start_us = rtc::TimeMicros();
+      if (neteq->GetAudio(kOutDataLen, out_data, &samples_per_channel,
+                          &num_channels, &type) != NetEq::kOK) {
+        return false;
+      }
+      const int64_t get_audio_time_us =
+          static_cast<int64_t>(rtc::TimeMicros() - get_audio_start_us);
+
+      // The statistics are reset by each call, so they only cover the last
+      // GetAudio() call.
+      webrtc::NetEqNetworkStatistics stats;
+      if (neteq->NetworkStatistics(&stats) != NetEq::kOK)
+        return false;
+      webrtc::test::NetEqPerformanceTest::AddCost(type, stats,
+                                                  get_audio_time_us,
+                                                  &result->costs);
+      result->packet_loss_rate_sum += stats.packet_loss_rate;
+      result->expand_rate_sum += stats.expand_rate;
+      result->speech_expand_rate_sum += stats.speech_expand_rate;
+      result->accelerate_rate_sum += stats.accelerate_rate;
+      result->preemptive_rate_sum += stats.preemptive_rate;
+      const bool expanding =
+          type == webrtc::kOutputPLC || type == webrtc::kOutputPLCtoCNG;
+      if (expanding && !concealing)
+        ++result->concealment_events;
+      concealing = expanding;
+
+      if (is_rtp_dump) {
+        next_output_time_ms += kOutputBlockSizeMs;
+        if (!packet_available)
+          output_event_available = false;
+      } else {
+        next_output_time_ms = event_log_source->NextAudioOutputEventMs();
+        if (next_output_time_ms == std::numeric_limits<int64_t>::max())
+          output_event_available = false;
+      }
+    }
+  }
+  result->audio_ms = time_now_ms - start_time_ms;
+  result->ok = true;
+  return true;
+}
+
+// Decodes every |stride|th file of |file_names| in benchmark mode, starting
+// with the |first|.
+class BenchmarkWorker {
+ public:
+  BenchmarkWorker(const std::vector<std::string>* file_names,
+                  std::vector<BenchmarkResult>* results,
+                  size_t first,
+                  size_t stride)
+      : file_names_(file_names),
+        results_(results),
+        first_(first),
+        stride_(stride) {}
+
+  static bool Run(void* obj) {
+    static_cast<BenchmarkWorker*>(obj)->BenchmarkFiles();
+    return false;
+  }
+
+  void BenchmarkFiles() {
+    for (size_t i = first_; i < file_names_->size(); i += stride_)
+      BenchmarkFile((*file_names_)[i], &(*results_)[i]);
+  }
+
+ private:
+  const std::vector<std::string>* const file_names_;
+  std::vector<BenchmarkResult>* const results_;
+  const size_t first_;
+  const size_t stride_;
+};
+
+void PrintOperationCost(
+    const char* name,
+    const webrtc::test::NetEqPerformanceTest::OperationCost& cost) {
+  printf("  %-18s %8d calls", name, cost.calls);
+  if (cost.calls > 0) {
+    printf(", %8.2f us per call, %10.1f ms in total",
+           static_cast<double>(cost.total_time_us) / cost.calls,
+           cost.total_time_us / 1000.0);
+  }
+  printf("\n");
+}
+
+// Prints a rate summed over |calls| GetAudio() calls in Q14 as a percentage.
+void PrintRate(const char* name, int64_t rate_sum, int calls) {
+  printf("  %-18s %6.2f %%\n", name,
+         calls > 0 ? 100.0 * rate_sum / calls / (1 << 14) : 0.0);
+}
+
+void PrintBenchmarkResult(const std::string& name,
+                          const BenchmarkResult& result) {
+  const int64_t get_audio_time_us =
+      result.costs.normal.total_time_us + result.costs.expand.total_time_us +
+      result.costs.merge.total_time_us +
+      result.costs.accelerate.total_time_us +
+      result.costs.preemptive_expand.total_time_us +
+      result.costs.comfort_noise.total_time_us;
+  const int64_t neteq_time_us = get_audio_time_us + result.insert_time_us;
+  printf("%s: %d ms of audio decoded in %.1f ms", name.c_str(),
+         static_cast<int>(result.audio_ms), neteq_time_us / 1000.0);
+  if (neteq_time_us > 0) {
+    printf(" (%.0f times real time)",
+           1000.0 * result.audio_ms / neteq_time_us);
+  }
+  printf("\n");
+  printf("  %-18s %10.1f ms in total\n", "InsertPacket",
+         result.insert_time_us / 1000.0);
+  PrintOperationCost("Normal", result.costs.normal);
+  PrintOperationCost("Expand", result.costs.expand);
+  PrintOperationCost("Merge", result.costs.merge);
+  PrintOperationCost("Accelerate", result.costs.accelerate);
+  PrintOperationCost("Preemptive expand", result.costs.preemptive_expand);
+  PrintOperationCost("Comfort noise", result.costs.comfort_noise);
+  const int calls = result.get_audio_calls();
+  PrintRate("Packet loss rate", result.packet_loss_rate_sum, calls);
+  PrintRate("Expand rate", result.expand_rate_sum, calls);
+  PrintRate("Speech expand rate", result.speech_expand_rate_sum, calls);
+  PrintRate("Accelerate rate", result.accelerate_rate_sum, calls);
+  PrintRate("Preemptive rate", result.preemptive_rate_sum, calls);
+  printf("  %-18s %8d\n", "Concealment events", result.concealment_events);
+}
+
+// Decodes |file_names| in parallel in benchmark mode and prints the results.
+// Returns the number of files that could not be decoded.
+int RunBenchmark(const std::vector<std::string>& file_names) {
+  size_t num_threads = FLAGS_num_threads > 0
+                           ? static_cast<size_t>(FLAGS_num_threads)
+                           : webrtc::CpuInfo::DetectNumberOfCores();
+  num_threads = std::max<size_t>(1, std::min(num_threads, file_names.size()));
+
+  std::vector<BenchmarkResult> results(file_names.size());
+  std::vector<BenchmarkWorker> workers;
+  for (size_t i = 0; i < num_threads; ++i)
+    workers.push_back(BenchmarkWorker(&file_names, &results, i, num_threads));
+
+  const uint64_t start_time_us = rtc::TimeMicros();
+  std::vector<rtc::scoped_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.push_back(rtc::scoped_ptr<rtc::PlatformThread>(
+        new rtc::PlatformThread(&BenchmarkWorker::Run, &workers[i],
+                                "NetEqBenchmarkWorker")));
+    threads.back()->Start();
+  }
+  workers[0].BenchmarkFiles();
+  for (const auto& thread : threads)
+    thread->Stop();
+  const int64_t wall_time_us =
+      static_cast<int64_t>(rtc::TimeMicros() - start_time_us);
+
+  int num_failed = 0;
+  BenchmarkResult total;
+  for (size_t i = 0; i < file_names.size(); ++i) {
+    if (!results[i].ok) {
+      printf("%s: could not be decoded\n", file_names[i].c_str());
+      ++num_failed;
+      continue;
+    }
+    PrintBenchmarkResult(file_names[i], results[i]);
+    AddBenchmarkResult(results[i], &total);
+  }
+  PrintBenchmarkResult("Total", total);
+  printf("Decoded %d files on %d threads in %.1f ms\n",
+         static_cast<int>(file_names.size()) - num_failed,
+         static_cast<int>(num_threads), wall_time_us / 1000.0);
+  return num_failed;
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -390,7 +709,8 @@ int main(int argc, char* argv[]) {
   std::string usage = "Tool for decoding an RTP dump file using NetEq.\n"
       "Run " + program_name + " --helpshort for usage.\n"
       "Example usage:\n" + program_name +
-      " input.rtp output.{pcm, wav}\n";
+      " input.rtp output.{pcm, wav}\n" +
+      program_name + " --benchmark input1.rtp [input2.rtp ...]\n";
   google::SetUsageMessage(usage);
   google::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -398,6 +718,14 @@ int main(int argc, char* argv[]) {
     PrintCodecMapping();
   }
 
+  if (FLAGS_benchmark && argc >= 2) {
+    RTC_CHECK(FLAGS_replacement_audio_file.empty())
+        << "Replacement audio is not supported in benchmark mode.";
+    return RunBenchmark(std::vector<std::string>(argv + 1, argv + argc)) == 0
+               ? 0
+               : -1;
+  }
+
   if (argc != 3) {
     if (FLAGS_codec_map) {
       // We have already printed the codec map. Just end the program.
@@ -76,8 +76,8 @@ bool RtcEventLogSource::RegisterRtpHeaderExtension(RTPExtensionType type,
 }
 
 Packet* RtcEventLogSource::NextPacket() {
-  while (rtp_packet_index_ < event_log_->stream_size()) {
-    const rtclog::Event& event = event_log_->stream(rtp_packet_index_);
+  while (packet_reader_->ReadNextEvent(event_.get())) {
+    const rtclog::Event& event = *event_;
     const rtclog::RtpPacket* rtp_packet = GetRtpPacket(event);
     rtp_packet_index_++;
     if (rtp_packet) {
@@ -105,23 +105,24 @@ Packet* RtcEventLogSource::NextPacket() {
 }
 
 int64_t RtcEventLogSource::NextAudioOutputEventMs() {
-  while (audio_output_index_ < event_log_->stream_size()) {
-    const rtclog::Event& event = event_log_->stream(audio_output_index_);
-    const rtclog::AudioPlayoutEvent* playout_event =
-        GetAudioPlayoutEvent(event);
-    audio_output_index_++;
-    if (playout_event)
+  rtclog::Event event;
+  while (audio_output_reader_->ReadNextEvent(&event)) {
+    if (GetAudioPlayoutEvent(event))
       return event.timestamp_us() / 1000;
   }
   return std::numeric_limits<int64_t>::max();
 }
 
 RtcEventLogSource::RtcEventLogSource()
-    : PacketSource(), parser_(RtpHeaderParser::Create()) {}
+    : PacketSource(),
+      packet_reader_(new RtcEventLogReader()),
+      audio_output_reader_(new RtcEventLogReader()),
+      event_(new rtclog::Event()),
+      parser_(RtpHeaderParser::Create()) {}
 
 bool RtcEventLogSource::OpenFile(const std::string& file_name) {
-  event_log_.reset(new rtclog::EventStream());
-  return RtcEventLog::ParseRtcEventLog(file_name, event_log_.get());
+  return packet_reader_->Open(file_name) &&
+         audio_output_reader_->Open(file_name);
 }
 
 }  // namespace test
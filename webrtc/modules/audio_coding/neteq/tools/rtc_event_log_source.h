@@ -22,8 +22,10 @@ namespace webrtc {
 
 class RtpHeaderParser;
 
+class RtcEventLogReader;
+
 namespace rtclog {
-class EventStream;
+class Event;
 }  // namespace rtclog
 
 namespace test {
@@ -55,10 +57,12 @@ class RtcEventLogSource : public PacketSource {
 
   bool OpenFile(const std::string& file_name);
 
+  // The log is read one event at a time, with separate readers for packets
+  // and for audio output events, so that long logs need not fit in memory.
   int rtp_packet_index_ = 0;
-  int audio_output_index_ = 0;
-
-  rtc::scoped_ptr<rtclog::EventStream> event_log_;
+  rtc::scoped_ptr<RtcEventLogReader> packet_reader_;
+  rtc::scoped_ptr<RtcEventLogReader> audio_output_reader_;
+  rtc::scoped_ptr<rtclog::Event> event_;
   rtc::scoped_ptr<RtpHeaderParser> parser_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventLogSource);
@@ -33,6 +33,11 @@ public:
         kLowestPossible   = -1,
         kDefaultFrequency = kWbInHz
     };
+    enum LimiterType
+    {
+        kAgcLimiter,        // The fixed digital AGC of AudioProcessing.
+        kLookaheadLimiter   // A cheap peak limiter.
+    };
 
     // Factory method. Constructor disabled.
     static AudioConferenceMixer* Create(int id);
@@ -69,6 +74,48 @@ public:
     // downsampling of audio contributing to the mixed audio.
     virtual int32_t SetMinimumMixingFrequency(Frequency freq) = 0;
 
+    // Set the sampling frequency that the mixed audio is converted to after
+    // mixing, e.g. the playout frequency of the audio device. When the
+    // participants do not all need the mixing frequency, so that some of
+    // them would be resampled to it and then once more with the mix, the
+    // mixer mixes at |freq| instead, at least the minimum mixing frequency.
+    // Each participant is then resampled at most once, and the mix not at
+    // all. Defaults to kLowestPossible, i.e. disabled.
+    virtual int32_t SetPreferredMixingFrequency(Frequency freq) = 0;
+
+    // Set the number of worker threads used to pull audio from the mixable
+    // participants. With |num_threads| > 0 the GetAudioFrame() calls of
+    // different participants run concurrently, so the participants must not
+    // share unprotected state. Defaults to 0, i.e. all participants are
+    // called sequentially on the thread calling Process().
+    virtual int32_t SetNumFetchThreads(size_t num_threads) = 0;
+
+    // Limit the number of participants whose audio is pulled each iteration,
+    // for rooms with many participants where decoding everyone is wasted.
+    // With |num_candidates| > 0, the mixable participants are ranked by
+    // MixerParticipant::GetAudioLevel() and GetAudioFrame() is only called for
+    // the |num_candidates| loudest ones, plus those that were mixed in the
+    // previous iteration (so that they can be ramped out) and those that
+    // report no level. The others must cope with not being pulled, e.g. by
+    // discarding the audio they have buffered. Defaults to 0, i.e. the audio
+    // of all participants is pulled.
+    virtual int32_t SetAudioLevelPreselection(size_t num_candidates) = 0;
+
+    // Enable N-1 mixes. When enabled, NewMixedAudio() also gets one frame per
+    // participant that contributed to the mix, holding the mix without that
+    // participant's own audio. The id_ of such a frame is the id_ of the
+    // participant's frame. The N-1 mixes are derived from the full mix by
+    // subtracting each contribution, and are not passed through the limiter;
+    // instead, their level is restored with saturation. Disabled by default.
+    virtual int32_t SetUniqueMixesEnabled(bool enable) = 0;
+
+    // Select the limiter that protects the mix from saturation when more than
+    // one participant is mixed. kAgcLimiter, the default, compresses smoothly
+    // but costs about as much as running the AGC on the mix. kLookaheadLimiter
+    // only attenuates where the mix would clip, at a fraction of the cost, and
+    // works at all sample rates.
+    virtual int32_t SetLimiterType(LimiterType type) = 0;
+
 protected:
     AudioConferenceMixer() {}
 };
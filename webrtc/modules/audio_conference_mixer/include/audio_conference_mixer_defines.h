@@ -35,6 +35,14 @@ public:
     // for future GetAudioFrame(..) calls.
     virtual int32_t NeededFrequency(int32_t id) const = 0;
 
+    // Reports the level of the audio that the next GetAudioFrame() call will
+    // return, as signaled by the RTP audio level header extension (RFC 6464),
+    // i.e. in -dBov from 0 (loudest) to 127 (silence). It is used to rank the
+    // participants before any audio is decoded, see
+    // AudioConferenceMixer::SetAudioLevelPreselection(). Returns false if no
+    // level is known, which is the default.
+    virtual bool GetAudioLevel(int32_t id, uint8_t* level) const;
+
     MixHistory* _mixHistory;
 protected:
     MixerParticipant();
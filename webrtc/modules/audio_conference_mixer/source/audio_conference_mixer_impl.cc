@@ -8,9 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_conference_mixer_impl.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
+#include "webrtc/modules/audio_conference_mixer/source/lookahead_limiter.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
@@ -46,7 +50,7 @@ void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter) {
     AudioFrameOperations::MonoToStereo(frame);
   }
 
-  *mixed_frame += *frame;
+  AudioFrameOperations::Add(*frame, mixed_frame);
 }
 
 // Return the max number of channels from a |list| composed of AudioFrames.
@@ -74,6 +78,10 @@ bool MixerParticipant::IsMixed() const {
     return _mixHistory->IsMixed();
 }
 
+bool MixerParticipant::GetAudioLevel(int32_t id, uint8_t* level) const {
+    return false;
+}
+
 MixHistory::MixHistory()
     : _isMixed(0) {
 }
@@ -112,6 +120,7 @@ AudioConferenceMixer* AudioConferenceMixer::Create(int id) {
 AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
     : _id(id),
       _minimumMixingFreq(kLowestPossible),
+      _preferredMixingFreq(kLowestPossible),
       _mixReceiver(NULL),
       _outputFrequency(kDefaultFrequency),
       _sampleSize(0),
@@ -122,7 +131,11 @@ AudioConferenceMixerImpl::AudioConferenceMixerImpl(int id)
       use_limiter_(true),
       _timeStamp(0),
       _timeScheduler(kProcessPeriodicityInMs),
-      _processCalls(0) {}
+      _processCalls(0),
+      _numPreselectedCandidates(0),
+      _uniqueMixesEnabled(false),
+      _limiterType(kAgcLimiter),
+      _lookaheadLimiter(new LookaheadLimiter()) {}
 
 bool AudioConferenceMixerImpl::Init() {
     _crit.reset(CriticalSectionWrapper::CreateCriticalSection());
@@ -139,6 +152,8 @@ bool AudioConferenceMixerImpl::Init() {
     if(!_limiter.get())
         return false;
 
+    _frameFetcher.reset(new ParallelFrameFetcher(0));
+
     MemoryPool<AudioFrame>::CreateMemoryPool(_audioFramePool,
                                              DEFAULT_AUDIO_FRAME_POOLSIZE);
     if(_audioFramePool == NULL)
@@ -204,11 +219,13 @@ int32_t AudioConferenceMixerImpl::Process() {
     AudioFrameList mixList;
     AudioFrameList rampOutList;
     AudioFrameList additionalFramesList;
+    AudioFrameList uniqueFramesList;
     std::map<int, MixerParticipant*> mixedParticipantsMap;
     {
         CriticalSectionScoped cs(_cbCrit.get());
 
-        int32_t lowFreq = GetLowestMixingFrequency();
+        int32_t lowestNeededFreq = 0;
+        int32_t lowFreq = GetLowestMixingFrequency(&lowestNeededFreq);
         // SILK can run in 12 kHz and 24 kHz. These frequencies are not
         // supported so use the closest higher frequency to not lose any
         // information.
@@ -219,6 +236,14 @@ int32_t AudioConferenceMixerImpl::Process() {
         } else if (lowFreq == 24000) {
             lowFreq = 32000;
         }
+        // If some participants have to be resampled to lowFreq anyway, mix
+        // directly at the preferred frequency so that the mix needs no
+        // further resampling.
+        if (_preferredMixingFreq != kLowestPossible &&
+            lowFreq > 0 && lowestNeededFreq < lowFreq &&
+            _preferredMixingFreq >= _minimumMixingFreq) {
+            lowFreq = _preferredMixingFreq;
+        }
         if(lowFreq <= 0) {
             CriticalSectionScoped cs(_crit.get());
             _processCalls--;
@@ -292,7 +317,8 @@ int32_t AudioConferenceMixerImpl::Process() {
         // we're actually mixing multiple streams.
         use_limiter_ =
             _numMixedParticipants > 1 &&
-            _outputFrequency <= AudioProcessing::kMaxNativeSampleRateHz;
+            (_limiterType == kLookaheadLimiter ||
+             _outputFrequency <= AudioProcessing::kMaxNativeSampleRateHz);
 
         MixFromList(mixedAudio, mixList);
         MixAnonomouslyFromList(mixedAudio, additionalFramesList);
@@ -303,6 +329,10 @@ int32_t AudioConferenceMixerImpl::Process() {
             mixedAudio->samples_per_channel_ = _sampleSize;
             mixedAudio->Mute();
         } else {
+            if(_uniqueMixesEnabled) {
+                CreateUniqueMixes(*mixedAudio, mixList, &uniqueFramesList);
+                CreateUniqueMixes(*mixedAudio, rampOutList, &uniqueFramesList);
+            }
             // Only call the limiter if we have something to mix.
             if(!LimitMixedAudio(mixedAudio))
                 retval = -1;
@@ -312,12 +342,13 @@ int32_t AudioConferenceMixerImpl::Process() {
     {
         CriticalSectionScoped cs(_cbCrit.get());
         if(_mixReceiver != NULL) {
-            const AudioFrame** dummy = NULL;
+            std::vector<const AudioFrame*> uniqueFrames(
+                uniqueFramesList.begin(), uniqueFramesList.end());
             _mixReceiver->NewMixedAudio(
                 _id,
                 *mixedAudio,
-                dummy,
-                0);
+                uniqueFrames.empty() ? NULL : &uniqueFrames[0],
+                static_cast<uint32_t>(uniqueFrames.size()));
         }
     }
 
@@ -326,6 +357,7 @@ int32_t AudioConferenceMixerImpl::Process() {
     ClearAudioFrameList(&mixList);
     ClearAudioFrameList(&rampOutList);
     ClearAudioFrameList(&additionalFramesList);
+    ClearAudioFrameList(&uniqueFramesList);
     {
         CriticalSectionScoped cs(_crit.get());
         _processCalls--;
@@ -486,28 +518,84 @@ int32_t AudioConferenceMixerImpl::SetMinimumMixingFrequency(
     }
 }
 
+int32_t AudioConferenceMixerImpl::SetPreferredMixingFrequency(
+    Frequency freq) {
+    if((freq != kNbInHz) && (freq != kWbInHz) && (freq != kSwbInHz) &&
+       (freq != kFbInHz) && (freq != kLowestPossible)) {
+        WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
+                     "SetPreferredMixingFrequency incorrect frequency: %i",
+                     freq);
+        return -1;
+    }
+    CriticalSectionScoped cs(_cbCrit.get());
+    _preferredMixingFreq = freq;
+    return 0;
+}
+
+int32_t AudioConferenceMixerImpl::SetNumFetchThreads(size_t num_threads) {
+    CriticalSectionScoped cs(_cbCrit.get());
+    if(num_threads != _frameFetcher->num_threads()) {
+        // Stop the old threads before starting the new ones.
+        _frameFetcher.reset();
+        _frameFetcher.reset(new ParallelFrameFetcher(num_threads));
+    }
+    return 0;
+}
+
+int32_t AudioConferenceMixerImpl::SetAudioLevelPreselection(
+    size_t num_candidates) {
+    CriticalSectionScoped cs(_cbCrit.get());
+    _numPreselectedCandidates = num_candidates;
+    return 0;
+}
+
+int32_t AudioConferenceMixerImpl::SetUniqueMixesEnabled(bool enable) {
+    CriticalSectionScoped cs(_crit.get());
+    _uniqueMixesEnabled = enable;
+    return 0;
+}
+
+int32_t AudioConferenceMixerImpl::SetLimiterType(LimiterType type) {
+    CriticalSectionScoped cs(_crit.get());
+    if(type != _limiterType) {
+        _lookaheadLimiter->Reset();
+    }
+    _limiterType = type;
+    return 0;
+}
+
 // Check all AudioFrames that are to be mixed. The highest sampling frequency
 // found is the lowest that can be used without losing information.
-int32_t AudioConferenceMixerImpl::GetLowestMixingFrequency() const {
+int32_t AudioConferenceMixerImpl::GetLowestMixingFrequency(
+    int32_t* lowestNeededFreq) const {
+    int32_t participantListLowest = 0;
+    int32_t anonymousListLowest = 0;
     const int participantListFrequency =
-        GetLowestMixingFrequencyFromList(_participantList);
+        GetLowestMixingFrequencyFromList(_participantList,
+                                         &participantListLowest);
     const int anonymousListFrequency =
-        GetLowestMixingFrequencyFromList(_additionalParticipantList);
-    const int highestFreq =
+        GetLowestMixingFrequencyFromList(_additionalParticipantList,
+                                         &anonymousListLowest);
+    int highestFreq =
         (participantListFrequency > anonymousListFrequency) ?
             participantListFrequency : anonymousListFrequency;
     // Check if the user specified a lowest mixing frequency.
     if(_minimumMixingFreq != kLowestPossible) {
         if(_minimumMixingFreq > highestFreq) {
-            return _minimumMixingFreq;
+            highestFreq = _minimumMixingFreq;
         }
     }
+    *lowestNeededFreq = std::min(highestFreq,
+                                 std::min(participantListLowest,
+                                          anonymousListLowest));
     return highestFreq;
 }
 
 int32_t AudioConferenceMixerImpl::GetLowestMixingFrequencyFromList(
-    const MixerParticipantList& mixList) const {
+    const MixerParticipantList& mixList,
+    int32_t* lowestNeededFreq) const {
     int32_t highestFreq = 8000;
+    *lowestNeededFreq = std::numeric_limits<int32_t>::max();
     for (MixerParticipantList::const_iterator iter = mixList.begin();
          iter != mixList.end();
          ++iter) {
@@ -515,10 +603,89 @@ int32_t AudioConferenceMixerImpl::GetLowestMixingFrequencyFromList(
         if(neededFrequency > highestFreq) {
             highestFreq = neededFrequency;
         }
+        if(neededFrequency < *lowestNeededFreq) {
+            *lowestNeededFreq = neededFrequency;
+        }
     }
     return highestFreq;
 }
 
+bool AudioConferenceMixerImpl::FetchAudioFrames(
+    std::vector<MixerParticipant*>* participants,
+    std::vector<AudioFrame*>* frames,
+    std::vector<int32_t>* results) const {
+    participants->assign(_participantList.begin(), _participantList.end());
+    PreselectByAudioLevel(participants);
+    frames->assign(participants->size(), NULL);
+    for (size_t i = 0; i < frames->size(); ++i) {
+        if(_audioFramePool->PopMemory((*frames)[i]) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            for (size_t j = 0; j < i; ++j) {
+                _audioFramePool->PushMemory((*frames)[j]);
+            }
+            return false;
+        }
+        (*frames)[i]->sample_rate_hz_ = _outputFrequency;
+        // Pooled frames may still carry the level of earlier audio.
+        (*frames)[i]->sum_squares_ = -1;
+    }
+    _frameFetcher->FetchFrames(_id, *participants, *frames, results);
+    return true;
+}
+
+void AudioConferenceMixerImpl::PreselectByAudioLevel(
+    std::vector<MixerParticipant*>* participants) const {
+    if(_numPreselectedCandidates == 0 ||
+       participants->size() <= _numPreselectedCandidates) {
+        return;
+    }
+    // Participants that were mixed last iteration are always pulled, so that
+    // they can be ramped out, and so are those without a known level. Rank
+    // the others.
+    const uint8_t kNotRanked = 0xFF;
+    std::vector<uint8_t> levels(participants->size(), kNotRanked);
+    std::vector<uint8_t> rankedLevels;
+    for (size_t i = 0; i < participants->size(); ++i) {
+        const MixerParticipant* participant = (*participants)[i];
+        uint8_t level = 0;
+        if(!participant->_mixHistory->WasMixed() &&
+           participant->GetAudioLevel(_id, &level)) {
+            levels[i] = level;
+            rankedLevels.push_back(level);
+        }
+    }
+    if(rankedLevels.size() <= _numPreselectedCandidates) {
+        return;
+    }
+    // Find the level of the quietest candidate. Lower values are louder.
+    std::nth_element(rankedLevels.begin(),
+                     rankedLevels.begin() + _numPreselectedCandidates - 1,
+                     rankedLevels.end());
+    const uint8_t threshold = rankedLevels[_numPreselectedCandidates - 1];
+    size_t numLouder = 0;
+    for (size_t i = 0; i < rankedLevels.size(); ++i) {
+        if(rankedLevels[i] < threshold) {
+            ++numLouder;
+        }
+    }
+    // Participants at the threshold level are picked in list order.
+    size_t numAtThreshold = _numPreselectedCandidates - numLouder;
+    size_t numSelected = 0;
+    for (size_t i = 0; i < participants->size(); ++i) {
+        bool selected = levels[i] == kNotRanked || levels[i] < threshold;
+        if(levels[i] == threshold && numAtThreshold > 0) {
+            --numAtThreshold;
+            selected = true;
+        }
+        if(selected) {
+            (*participants)[numSelected++] = (*participants)[i];
+        }
+    }
+    participants->resize(numSelected);
+}
+
 void AudioConferenceMixerImpl::UpdateToMix(
     AudioFrameList* mixList,
     AudioFrameList* rampOutList,
@@ -533,9 +700,16 @@ void AudioConferenceMixerImpl::UpdateToMix(
     // belongs to which MixerParticipant.
     ParticipantFramePairList passiveWasNotMixedList;
     ParticipantFramePairList passiveWasMixedList;
-    for (MixerParticipantList::const_iterator participant =
-        _participantList.begin(); participant != _participantList.end();
-         ++participant) {
+    // Pull the audio of all participants up front, so that the decoding can
+    // be done in parallel, and then decide which frames to mix.
+    std::vector<MixerParticipant*> participants;
+    std::vector<AudioFrame*> frames;
+    std::vector<int32_t> results;
+    if(!FetchAudioFrames(&participants, &frames, &results)) {
+        return;
+    }
+    for (size_t i = 0; i < participants.size(); ++i) {
+        MixerParticipant* participant = participants[i];
         // Stop keeping track of passive participants if there are already
         // enough participants available (they wont be mixed anyway).
         bool mustAddToPassiveList = (*maxAudioFrameCounter >
@@ -544,17 +718,9 @@ void AudioConferenceMixerImpl::UpdateToMix(
                                      passiveWasNotMixedList.size()));
 
         bool wasMixed = false;
-        wasMixed = (*participant)->_mixHistory->WasMixed();
-        AudioFrame* audioFrame = NULL;
-        if(_audioFramePool->PopMemory(audioFrame) == -1) {
-            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
-                         "failed PopMemory() call");
-            assert(false);
-            return;
-        }
-        audioFrame->sample_rate_hz_ = _outputFrequency;
-
-        if((*participant)->GetAudioFrame(_id, audioFrame) != 0) {
+        wasMixed = participant->_mixHistory->WasMixed();
+        AudioFrame* audioFrame = frames[i];
+        if(results[i] != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
                          "failed to GetAudioFrame() from participant");
             _audioFramePool->PushMemory(audioFrame);
@@ -584,16 +750,16 @@ void AudioConferenceMixerImpl::UpdateToMix(
                 // mixed. Only keep the ones with the highest energy.
                 AudioFrameList::iterator replaceItem;
                 CalculateEnergy(*audioFrame);
-                uint32_t lowestEnergy = audioFrame->energy_;
+                int64_t lowestEnergy = audioFrame->sum_squares_;
 
                 bool found_replace_item = false;
                 for (AudioFrameList::iterator iter = activeList.begin();
                      iter != activeList.end();
                      ++iter) {
                     CalculateEnergy(**iter);
-                    if((*iter)->energy_ < lowestEnergy) {
+                    if((*iter)->sum_squares_ < lowestEnergy) {
                         replaceItem = iter;
-                        lowestEnergy = (*iter)->energy_;
+                        lowestEnergy = (*iter)->sum_squares_;
                         found_replace_item = true;
                     }
                 }
@@ -614,7 +780,7 @@ void AudioConferenceMixerImpl::UpdateToMix(
                     activeList.erase(replaceItem);
 
                     activeList.push_front(audioFrame);
-                    (*mixParticipantList)[audioFrame->id_] = *participant;
+                    (*mixParticipantList)[audioFrame->id_] = participant;
                     assert(mixParticipantList->size() <=
                            kMaximumAmountOfMixedParticipants);
 
@@ -638,7 +804,7 @@ void AudioConferenceMixerImpl::UpdateToMix(
                 }
             } else {
                 activeList.push_front(audioFrame);
-                (*mixParticipantList)[audioFrame->id_] = *participant;
+                (*mixParticipantList)[audioFrame->id_] = participant;
                 assert(mixParticipantList->size() <=
                        kMaximumAmountOfMixedParticipants);
             }
@@ -646,13 +812,13 @@ void AudioConferenceMixerImpl::UpdateToMix(
             if(wasMixed) {
                 ParticipantFramePair* pair = new ParticipantFramePair;
                 pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                pair->participant = participant;
                 passiveWasMixedList.push_back(pair);
             } else if(mustAddToPassiveList) {
                 RampIn(*audioFrame);
                 ParticipantFramePair* pair = new ParticipantFramePair;
                 pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                pair->participant = participant;
                 passiveWasNotMixedList.push_back(pair);
             } else {
                 _audioFramePool->PushMemory(audioFrame);
@@ -730,6 +896,7 @@ void AudioConferenceMixerImpl::GetAdditionalAudio(
             return;
         }
         audioFrame->sample_rate_hz_ = _outputFrequency;
+        audioFrame->sum_squares_ = -1;
         if((*participant)->GetAudioFrame(_id, audioFrame) != 0) {
             WEBRTC_TRACE(kTraceWarning, kTraceAudioMixerServer, _id,
                          "failed to GetAudioFrame() from participant");
@@ -897,11 +1064,46 @@ int32_t AudioConferenceMixerImpl::MixAnonomouslyFromList(
     return 0;
 }
 
+void AudioConferenceMixerImpl::CreateUniqueMixes(
+    const AudioFrame& mixedAudio,
+    const AudioFrameList& audioFrameList,
+    AudioFrameList* uniqueFramesList) const {
+    for (AudioFrameList::const_iterator iter = audioFrameList.begin();
+         iter != audioFrameList.end();
+         ++iter) {
+        AudioFrame* uniqueAudio = NULL;
+        if(_audioFramePool->PopMemory(uniqueAudio) == -1) {
+            WEBRTC_TRACE(kTraceMemory, kTraceAudioMixerServer, _id,
+                         "failed PopMemory() call");
+            assert(false);
+            return;
+        }
+        // MixFrames() has already scaled and upmixed the frame, so it is
+        // exactly what was added to the mix, unless the mix saturated.
+        uniqueAudio->CopyFrom(mixedAudio);
+        *uniqueAudio -= **iter;
+        if(use_limiter_) {
+            // Restore the level, like LimitMixedAudio() does.
+            AudioFrameOperations::Add(*uniqueAudio, uniqueAudio);
+        }
+        uniqueAudio->id_ = (*iter)->id_;
+        uniqueFramesList->push_back(uniqueAudio);
+    }
+}
+
 bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame* mixedAudio) const {
     if (!use_limiter_) {
       return true;
     }
 
+    if(_limiterType == kLookaheadLimiter) {
+        // Keep the peaks at half scale, so that they do not clip when the
+        // level is restored below.
+        _lookaheadLimiter->Process(16383, mixedAudio);
+        AudioFrameOperations::Add(*mixedAudio, mixedAudio);
+        return true;
+    }
+
     // Smoothly limit the mixed frame.
     const int error = _limiter->ProcessStream(mixedAudio);
 
@@ -915,7 +1117,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame* mixedAudio) const {
     //
     // Instead we double the frame (with addition since left-shifting a
     // negative value is undefined).
-    *mixedAudio += *mixedAudio;
+    AudioFrameOperations::Add(*mixedAudio, mixedAudio);
 
     if(error != _limiter->kNoError) {
         WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
@@ -13,17 +13,20 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/source/memory_pool.h"
+#include "webrtc/modules/audio_conference_mixer/source/parallel_frame_fetcher.h"
 #include "webrtc/modules/audio_conference_mixer/source/time_scheduler.h"
 #include "webrtc/modules/include/module_common_types.h"
 
 namespace webrtc {
 class AudioProcessing;
 class CriticalSectionWrapper;
+class LookaheadLimiter;
 
 typedef std::list<AudioFrame*> AudioFrameList;
 typedef std::list<MixerParticipant*> MixerParticipantList;
@@ -74,10 +77,15 @@ public:
                                 bool mixable) override;
     bool MixabilityStatus(const MixerParticipant& participant) const override;
     int32_t SetMinimumMixingFrequency(Frequency freq) override;
+    int32_t SetPreferredMixingFrequency(Frequency freq) override;
     int32_t SetAnonymousMixabilityStatus(
         MixerParticipant* participant, bool mixable) override;
     bool AnonymousMixabilityStatus(
         const MixerParticipant& participant) const override;
+    int32_t SetNumFetchThreads(size_t num_threads) override;
+    int32_t SetAudioLevelPreselection(size_t num_candidates) override;
+    int32_t SetUniqueMixesEnabled(bool enable) override;
+    int32_t SetLimiterType(LimiterType type) override;
 
 private:
     enum{DEFAULT_AUDIO_FRAME_POOLSIZE = 50};
@@ -99,11 +107,28 @@ private:
         std::map<int, MixerParticipant*>* mixParticipantList,
         size_t* maxAudioFrameCounter) const;
 
+    // Pops an AudioFrame from the memory pool for every participant in
+    // _participantList and fills it by calling GetAudioFrame(), using the
+    // fetch threads if there are any. frames and results are indexed like
+    // participants. Returns false if the memory pool is exhausted.
+    bool FetchAudioFrames(std::vector<MixerParticipant*>* participants,
+                          std::vector<AudioFrame*>* frames,
+                          std::vector<int32_t>* results) const;
+
+    // Removes the participants that should not be pulled this iteration
+    // according to the audio level preselection, keeping the order of the
+    // remaining ones.
+    void PreselectByAudioLevel(
+        std::vector<MixerParticipant*>* participants) const;
+
     // Return the lowest mixing frequency that can be used without having to
-    // downsample any audio.
-    int32_t GetLowestMixingFrequency() const;
+    // downsample any audio. lowestNeededFreq is set to the lowest frequency
+    // needed by any participant, or to the returned frequency if there are
+    // none.
+    int32_t GetLowestMixingFrequency(int32_t* lowestNeededFreq) const;
     int32_t GetLowestMixingFrequencyFromList(
-        const MixerParticipantList& mixList) const;
+        const MixerParticipantList& mixList,
+        int32_t* lowestNeededFreq) const;
 
     // Return the AudioFrames that should be mixed anonymously.
     void GetAdditionalAudio(AudioFrameList* additionalFramesList) const;
@@ -144,6 +169,13 @@ private:
     int32_t MixAnonomouslyFromList(AudioFrame* mixedAudio,
                                    const AudioFrameList& audioFrameList) const;
 
+    // Fills uniqueFramesList with one N-1 mix for every AudioFrame in
+    // audioFrameList, by subtracting it from mixedAudio. Must be called before
+    // mixedAudio is limited.
+    void CreateUniqueMixes(const AudioFrame& mixedAudio,
+                           const AudioFrameList& audioFrameList,
+                           AudioFrameList* uniqueFramesList) const;
+
     bool LimitMixedAudio(AudioFrame* mixedAudio) const;
 
     rtc::scoped_ptr<CriticalSectionWrapper> _crit;
@@ -152,6 +184,7 @@ private:
     int32_t _id;
 
     Frequency _minimumMixingFreq;
+    Frequency _preferredMixingFreq;
 
     // Mix result callback
     AudioMixerOutputReceiver* _mixReceiver;
@@ -184,6 +217,18 @@ private:
 
     // Used for inhibiting saturation in mixing.
     rtc::scoped_ptr<AudioProcessing> _limiter;
+
+    // Pulls the participants' audio, possibly in parallel. Protected by
+    // _cbCrit.
+    rtc::scoped_ptr<ParallelFrameFetcher> _frameFetcher;
+
+    // The number of participants to pull when ranking them by audio level, or
+    // 0 to pull all. Protected by _cbCrit.
+    size_t _numPreselectedCandidates;
+    // Protected by _crit.
+    bool _uniqueMixesEnabled;
+    LimiterType _limiterType;
+    rtc::scoped_ptr<LookaheadLimiter> _lookaheadLimiter;
 };
 }  // namespace webrtc
 
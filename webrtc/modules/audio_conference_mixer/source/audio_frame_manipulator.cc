@@ -8,8 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/utility/include/audio_frame_operations.h"
 #include "webrtc/typedefs.h"
 
 namespace {
@@ -41,14 +44,13 @@ const size_t rampSize = sizeof(rampArray)/sizeof(rampArray[0]);
 namespace webrtc {
 void CalculateEnergy(AudioFrame& audioFrame)
 {
-    audioFrame.energy_ = 0;
-    for(size_t position = 0; position < audioFrame.samples_per_channel_;
-        position++)
+    if(audioFrame.sum_squares_ < 0)
     {
-        // TODO(andrew): this can easily overflow.
-        audioFrame.energy_ += audioFrame.data_[position] *
-                              audioFrame.data_[position];
+        AudioFrameOperations::UpdateLevel(&audioFrame);
     }
+    // Saturate rather than wrap; the mixer ranks by |sum_squares_|.
+    audioFrame.energy_ = static_cast<uint32_t>(
+        std::min<int64_t>(audioFrame.sum_squares_, 0xfffffffe));
 }
 
 void RampIn(AudioFrame& audioFrame)
@@ -59,6 +61,7 @@ void RampIn(AudioFrame& audioFrame)
         audioFrame.data_[i] = static_cast<int16_t>(rampArray[i] *
                                                    audioFrame.data_[i]);
     }
+    audioFrame.sum_squares_ = -1;
 }
 
 void RampOut(AudioFrame& audioFrame)
@@ -73,5 +76,6 @@ void RampOut(AudioFrame& audioFrame)
     memset(&audioFrame.data_[rampSize], 0,
            (audioFrame.samples_per_channel_ - rampSize) *
            sizeof(audioFrame.data_[0]));
+    audioFrame.sum_squares_ = -1;
 }
 }  // namespace webrtc
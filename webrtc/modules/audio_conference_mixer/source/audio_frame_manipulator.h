@@ -14,7 +14,8 @@
 namespace webrtc {
 class AudioFrame;
 
-// Updates the audioFrame's energy (based on its samples).
+// Updates the audioFrame's energy (based on its samples), reusing the level
+// the frame carries, if any.
 void CalculateEnergy(AudioFrame& audioFrame);
 
 // Apply linear step function that ramps in/out the audio samples in audioFrame
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_conference_mixer/source/lookahead_limiter.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+const int LookaheadLimiter::kNumBlocks;
+// Recovers from 6 dB of attenuation in 50 ms.
+const float LookaheadLimiter::kReleasePerBlock = 0.01f;
+
+LookaheadLimiter::LookaheadLimiter() : gain_(1.f) {}
+
+void LookaheadLimiter::Reset() {
+  gain_ = 1.f;
+}
+
+void LookaheadLimiter::Process(int16_t limit, AudioFrame* frame) {
+  const size_t num_channels = frame->num_channels_;
+  const size_t samples_per_channel = frame->samples_per_channel_;
+  if (samples_per_channel < static_cast<size_t>(kNumBlocks))
+    return;
+
+  // Block b covers the samples from block_start[b] to block_start[b + 1].
+  size_t block_start[kNumBlocks + 1];
+  for (int b = 0; b <= kNumBlocks; ++b)
+    block_start[b] = b * samples_per_channel / kNumBlocks;
+
+  // The gain which brings the peak of each block down to |limit|.
+  float required_gain[kNumBlocks];
+  bool limiting = gain_ < 1.f;
+  for (int b = 0; b < kNumBlocks; ++b) {
+    int peak = 0;
+    for (size_t i = block_start[b] * num_channels;
+         i < block_start[b + 1] * num_channels; ++i) {
+      peak = std::max(peak, std::abs(static_cast<int>(frame->data_[i])));
+    }
+    required_gain[b] = 1.f;
+    if (peak > limit) {
+      required_gain[b] = static_cast<float>(limit) / peak;
+      limiting = true;
+    }
+  }
+  if (!limiting)
+    return;
+
+  float boundary_gain[kNumBlocks + 1];
+  boundary_gain[0] = std::min(gain_, required_gain[0]);
+  for (int b = 1; b <= kNumBlocks; ++b) {
+    float gain = std::min(boundary_gain[b - 1] + kReleasePerBlock, 1.f);
+    gain = std::min(gain, required_gain[b - 1]);
+    if (b < kNumBlocks)
+      gain = std::min(gain, required_gain[b]);
+    boundary_gain[b] = gain;
+  }
+  gain_ = boundary_gain[kNumBlocks];
+
+  for (int b = 0; b < kNumBlocks; ++b) {
+    const size_t block_length = block_start[b + 1] - block_start[b];
+    const float step =
+        (boundary_gain[b + 1] - boundary_gain[b]) / block_length;
+    float gain = boundary_gain[b];
+    int16_t* data = &frame->data_[block_start[b] * num_channels];
+    for (size_t i = 0; i < block_length; ++i) {
+      for (size_t ch = 0; ch < num_channels; ++ch) {
+        *data = static_cast<int16_t>(gain * *data);
+        ++data;
+      }
+      gain += step;
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_LOOKAHEAD_LIMITER_H_
+#define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_LOOKAHEAD_LIMITER_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class AudioFrame;
+
+// A peak limiter which is much cheaper than the fixed digital AGC, for
+// mixing many streams. Each frame is split into kNumBlocks blocks, and the
+// gain needed to keep the peak of each block at or below the limit is
+// computed up front. The gain is then interpolated linearly between the block
+// boundaries, where it is never above the gain needed by the adjacent blocks,
+// so that the attack starts one block ahead of a peak without adding delay.
+// After a peak, the gain is released by kReleasePerBlock per block.
+class LookaheadLimiter {
+ public:
+  static const int kNumBlocks = 10;
+  static const float kReleasePerBlock;
+
+  LookaheadLimiter();
+
+  // Attenuates |frame| in place so that no sample exceeds |limit| in
+  // magnitude.
+  void Process(int16_t limit, AudioFrame* frame);
+
+  // Restores unity gain.
+  void Reset();
+
+  // The gain at the end of the last processed frame.
+  float gain() const { return gain_; }
+
+ private:
+  float gain_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LookaheadLimiter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_LOOKAHEAD_LIMITER_H_
@@ -12,12 +12,20 @@
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_MEMORY_POOL_GENERIC_H_
 
 #include <assert.h>
-#include <list>
+#include <algorithm>
+#include <vector>
 
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+// The memory is allocated in slabs of |initialPoolSize| items, which are kept
+// until the pool is terminated. The first thread to pop memory becomes the
+// owner of the pool and gets a cache of free items which it pops from and
+// pushes to without locking; the cache is refilled from, and drained to, the
+// shared free list in batches. Other threads always use the shared free list.
 template<class MemoryType>
 class MemoryPoolImpl
 {
@@ -33,25 +41,44 @@ public:
     int32_t Terminate();
     bool Initialize();
 private:
+    enum {kNoOwner = 0, kClaimingOwner = 1, kHasOwner = 2};
+
     // Non-atomic function.
     int32_t CreateMemory(uint32_t amountToCreate);
 
+    // Returns true if the calling thread owns _ownerCache, claiming it if the
+    // pool has no owner yet.
+    bool IsOwnerThread();
+
     CriticalSectionWrapper* _crit;
 
-    bool _terminate;
+    volatile int _terminate;
+
+    // Free items shared by all threads. Protected by _crit.
+    std::vector<MemoryType*> _memoryPool;
+    // Slabs of items, allocated with new[]. Protected by _crit.
+    std::vector<MemoryType*> _slabs;
 
-    std::list<MemoryType*> _memoryPool;
+    // Free items only accessed by the owner thread.
+    std::vector<MemoryType*> _ownerCache;
+    volatile int _ownerState;
+    rtc::PlatformThreadRef _ownerThread;
 
     uint32_t _initialPoolSize;
+    // The number of items moved between _ownerCache and _memoryPool at once.
+    size_t _batchSize;
     uint32_t _createdMemory;
-    uint32_t _outstandingMemory;
+    volatile int _outstandingMemory;
 };
 
 template<class MemoryType>
 MemoryPoolImpl<MemoryType>::MemoryPoolImpl(int32_t initialPoolSize)
     : _crit(CriticalSectionWrapper::CreateCriticalSection()),
-      _terminate(false),
+      _terminate(0),
+      _ownerState(kNoOwner),
+      _ownerThread(),
       _initialPoolSize(initialPoolSize),
+      _batchSize(std::max<size_t>(initialPoolSize / 2, 1)),
       _createdMemory(0),
       _outstandingMemory(0)
 {
@@ -66,27 +93,59 @@ MemoryPoolImpl<MemoryType>::~MemoryPoolImpl()
     delete _crit;
 }
 
+template<class MemoryType>
+bool MemoryPoolImpl<MemoryType>::IsOwnerThread()
+{
+    int state = rtc::AtomicOps::AcquireLoad(&_ownerState);
+    if(state == kNoOwner &&
+       rtc::AtomicOps::CompareAndSwap(&_ownerState, kNoOwner,
+                                      kClaimingOwner) == kNoOwner)
+    {
+        _ownerThread = rtc::CurrentThreadRef();
+        rtc::AtomicOps::ReleaseStore(&_ownerState, kHasOwner);
+        return true;
+    }
+    return state == kHasOwner &&
+           rtc::IsThreadRefEqual(_ownerThread, rtc::CurrentThreadRef());
+}
+
 template<class MemoryType>
 int32_t MemoryPoolImpl<MemoryType>::PopMemory(MemoryType*& memory)
 {
-    CriticalSectionScoped cs(_crit);
-    if(_terminate)
+    if(rtc::AtomicOps::AcquireLoad(&_terminate))
     {
         memory = NULL;
         return -1;
     }
-    if (_memoryPool.empty()) {
-        // _memoryPool empty create new memory.
-        CreateMemory(_initialPoolSize);
-        if(_memoryPool.empty())
+    const bool owner = IsOwnerThread();
+    if(!owner || _ownerCache.empty())
+    {
+        CriticalSectionScoped cs(_crit);
+        if (_memoryPool.empty()) {
+            // _memoryPool empty create new memory.
+            CreateMemory(_initialPoolSize);
+            if(_memoryPool.empty())
+            {
+                memory = NULL;
+                return -1;
+            }
+        }
+        if(!owner)
         {
-            memory = NULL;
-            return -1;
+            memory = _memoryPool.back();
+            _memoryPool.pop_back();
+            rtc::AtomicOps::Increment(&_outstandingMemory);
+            return 0;
         }
+        // Refill the cache with up to a batch of items.
+        const size_t count = std::min(_batchSize, _memoryPool.size());
+        _ownerCache.insert(_ownerCache.end(), _memoryPool.end() - count,
+                           _memoryPool.end());
+        _memoryPool.resize(_memoryPool.size() - count);
     }
-    memory = _memoryPool.front();
-    _memoryPool.pop_front();
-    _outstandingMemory++;
+    memory = _ownerCache.back();
+    _ownerCache.pop_back();
+    rtc::AtomicOps::Increment(&_outstandingMemory);
     return 0;
 }
 
@@ -97,16 +156,23 @@ int32_t MemoryPoolImpl<MemoryType>::PushMemory(MemoryType*& memory)
     {
         return -1;
     }
-    CriticalSectionScoped cs(_crit);
-    _outstandingMemory--;
-    if(_memoryPool.size() > (_initialPoolSize << 1))
+    rtc::AtomicOps::Decrement(&_outstandingMemory);
+    if(IsOwnerThread())
     {
-        // Reclaim memory if less than half of the pool is unused.
-        _createdMemory--;
-        delete memory;
+        _ownerCache.push_back(memory);
         memory = NULL;
+        if(_ownerCache.size() >= 2 * _batchSize)
+        {
+            // Give a batch back to the other threads.
+            CriticalSectionScoped cs(_crit);
+            _memoryPool.insert(_memoryPool.end(),
+                               _ownerCache.end() - _batchSize,
+                               _ownerCache.end());
+            _ownerCache.resize(_ownerCache.size() - _batchSize);
+        }
         return 0;
     }
+    CriticalSectionScoped cs(_crit);
     _memoryPool.push_back(memory);
     memory = NULL;
     return 0;
@@ -123,17 +189,19 @@ template<class MemoryType>
 int32_t MemoryPoolImpl<MemoryType>::Terminate()
 {
     CriticalSectionScoped cs(_crit);
-    assert(_createdMemory == _outstandingMemory + _memoryPool.size());
+    assert(_createdMemory == static_cast<uint32_t>(_outstandingMemory) +
+                             _memoryPool.size() + _ownerCache.size());
 
-    _terminate = true;
+    rtc::AtomicOps::ReleaseStore(&_terminate, 1);
     // Reclaim all memory.
-    while(_createdMemory > 0)
+    for(size_t i = 0; i < _slabs.size(); i++)
     {
-        MemoryType* memory = _memoryPool.front();
-        _memoryPool.pop_front();
-        delete memory;
-        _createdMemory--;
+        delete [] _slabs[i];
     }
+    _slabs.clear();
+    _memoryPool.clear();
+    _ownerCache.clear();
+    _createdMemory = 0;
     return 0;
 }
 
@@ -141,16 +209,21 @@ template<class MemoryType>
 int32_t MemoryPoolImpl<MemoryType>::CreateMemory(
     uint32_t amountToCreate)
 {
+    if(amountToCreate == 0)
+    {
+        return 0;
+    }
+    MemoryType* slab = new MemoryType[amountToCreate];
+    if(slab == NULL)
+    {
+        return -1;
+    }
+    _slabs.push_back(slab);
     for(uint32_t i = 0; i < amountToCreate; i++)
     {
-        MemoryType* memory = new MemoryType();
-        if(memory == NULL)
-        {
-            return -1;
-        }
-        _memoryPool.push_back(memory);
-        _createdMemory++;
+        _memoryPool.push_back(&slab[i]);
     }
+    _createdMemory += amountToCreate;
     return 0;
 }
 }  // namespace webrtc
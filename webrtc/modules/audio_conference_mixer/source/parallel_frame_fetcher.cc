@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_conference_mixer/source/parallel_frame_fetcher.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
+
+namespace webrtc {
+
+ParallelFrameFetcher::Worker::Worker(ParallelFrameFetcher* parent,
+                                     const char* name)
+    : parent(parent),
+      wake_up(false, false),
+      thread(&ParallelFrameFetcher::WorkerThreadFunc, this, name) {}
+
+ParallelFrameFetcher::ParallelFrameFetcher(size_t num_threads)
+    : all_workers_done_(false, false) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(rtc::scoped_ptr<Worker>(
+        new Worker(this, "AudioMixerFetchThread")));
+    workers_.back()->thread.Start();
+    workers_.back()->thread.SetPriority(rtc::kRealtimePriority);
+  }
+}
+
+ParallelFrameFetcher::~ParallelFrameFetcher() {
+  rtc::AtomicOps::ReleaseStore(&stopping_, 1);
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+    worker->thread.Stop();
+  }
+}
+
+void ParallelFrameFetcher::FetchFrames(
+    int32_t id,
+    const std::vector<MixerParticipant*>& participants,
+    const std::vector<AudioFrame*>& frames,
+    std::vector<int32_t>* results) {
+  RTC_DCHECK_EQ(participants.size(), frames.size());
+  results->resize(participants.size());
+  id_ = id;
+  participants_ = &participants;
+  frames_ = &frames;
+  results_ = results;
+  rtc::AtomicOps::ReleaseStore(&next_index_, 0);
+
+  // Don't bother waking up the workers when there is at most one frame.
+  const bool use_workers = !workers_.empty() && participants.size() > 1;
+  if (use_workers) {
+    rtc::AtomicOps::ReleaseStore(&workers_running_,
+                                 static_cast<int>(workers_.size()));
+    for (auto& worker : workers_)
+      worker->wake_up.Set();
+  }
+  FetchPendingFrames();
+  if (use_workers)
+    all_workers_done_.Wait(rtc::Event::kForever);
+
+  participants_ = nullptr;
+  frames_ = nullptr;
+  results_ = nullptr;
+}
+
+bool ParallelFrameFetcher::WorkerThreadFunc(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  return worker->parent->RunWorker(worker);
+}
+
+bool ParallelFrameFetcher::RunWorker(Worker* worker) {
+  worker->wake_up.Wait(rtc::Event::kForever);
+  if (rtc::AtomicOps::AcquireLoad(&stopping_))
+    return false;
+  FetchPendingFrames();
+  if (rtc::AtomicOps::Decrement(&workers_running_) == 0)
+    all_workers_done_.Set();
+  return true;
+}
+
+void ParallelFrameFetcher::FetchPendingFrames() {
+  const int num_frames = static_cast<int>(participants_->size());
+  for (int i = rtc::AtomicOps::Increment(&next_index_) - 1; i < num_frames;
+       i = rtc::AtomicOps::Increment(&next_index_) - 1) {
+    (*results_)[i] = (*participants_)[i]->GetAudioFrame(id_, (*frames_)[i]);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARALLEL_FRAME_FETCHER_H_
+#define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARALLEL_FRAME_FETCHER_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+class AudioFrame;
+class MixerParticipant;
+
+// Pulls the audio of many participants at once by spreading their
+// GetAudioFrame() calls (i.e., the decoding done by each participant's NetEq)
+// over a pool of worker threads. The calling thread takes part in the work,
+// so a fetcher without worker threads fetches all frames sequentially.
+class ParallelFrameFetcher {
+ public:
+  explicit ParallelFrameFetcher(size_t num_threads);
+  ~ParallelFrameFetcher();
+
+  // Calls participants[i]->GetAudioFrame(id, frames[i]) for every i and
+  // stores the return value in (*results)[i]. Returns once all calls have
+  // completed. The participants must tolerate being called concurrently with
+  // each other.
+  void FetchFrames(int32_t id,
+                   const std::vector<MixerParticipant*>& participants,
+                   const std::vector<AudioFrame*>& frames,
+                   std::vector<int32_t>* results);
+
+  size_t num_threads() const { return workers_.size(); }
+
+ private:
+  struct Worker {
+    Worker(ParallelFrameFetcher* parent, const char* name);
+    ParallelFrameFetcher* const parent;
+    rtc::Event wake_up;
+    rtc::PlatformThread thread;
+  };
+
+  static bool WorkerThreadFunc(void* obj);
+  bool RunWorker(Worker* worker);
+
+  // Claims and fetches frames of the current job until none are left.
+  void FetchPendingFrames();
+
+  std::vector<rtc::scoped_ptr<Worker>> workers_;
+  rtc::Event all_workers_done_;
+  volatile int workers_running_ = 0;
+  volatile int stopping_ = 0;
+
+  // The current job. Only written by FetchFrames() while the workers are idle.
+  int32_t id_ = 0;
+  const std::vector<MixerParticipant*>* participants_ = nullptr;
+  const std::vector<AudioFrame*>* frames_ = nullptr;
+  std::vector<int32_t>* results_ = nullptr;
+  volatile int next_index_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelFrameFetcher);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_PARALLEL_FRAME_FETCHER_H_
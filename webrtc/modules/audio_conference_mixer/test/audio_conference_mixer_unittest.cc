@@ -17,8 +17,10 @@ namespace webrtc {
 
 using testing::_;
 using testing::AtLeast;
+using testing::DoAll;
 using testing::Invoke;
 using testing::Return;
+using testing::SetArgPointee;
 
 class MockAudioMixerOutputReceiver : public AudioMixerOutputReceiver {
  public:
@@ -37,6 +39,7 @@ class MockMixerParticipant : public MixerParticipant {
   MOCK_METHOD2(GetAudioFrame,
                int32_t(const int32_t id, AudioFrame* audio_frame));
   MOCK_CONST_METHOD1(NeededFrequency, int32_t(const int32_t id));
+  MOCK_CONST_METHOD2(GetAudioLevel, bool(const int32_t id, uint8_t* level));
   AudioFrame* fake_frame() { return &fake_frame_; }
 
  private:
@@ -162,4 +165,248 @@ TEST(AudioConferenceMixer, LargestEnergyVadActiveMixed) {
   EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
 }
 
+// Mixes a number of participants for a few iterations, pulling their audio on
+// |num_fetch_threads| threads, and returns the last mixed frame.
+void MixWithFetchThreads(size_t num_fetch_threads, AudioFrame* mixed_frame) {
+  const int kId = 1;
+  const int kParticipants =
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants + 5;
+  const int kSampleRateHz = 32000;
+  const int kIterations = 5;
+
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(kId));
+  EXPECT_EQ(0, mixer->SetNumFetchThreads(num_fetch_threads));
+
+  MockAudioMixerOutputReceiver output_receiver;
+  EXPECT_CALL(output_receiver, NewMixedAudio(_, _, _, _))
+      .Times(kIterations)
+      .WillRepeatedly(Invoke([mixed_frame](const int32_t id,
+                                           const AudioFrame& frame,
+                                           const AudioFrame** unique_frames,
+                                           const uint32_t size) {
+        mixed_frame->CopyFrom(frame);
+      }));
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&output_receiver));
+
+  MockMixerParticipant participants[kParticipants];
+  for (int i = 0; i < kParticipants; ++i) {
+    AudioFrame* frame = participants[i].fake_frame();
+    frame->id_ = i;
+    frame->sample_rate_hz_ = kSampleRateHz;
+    frame->speech_type_ = AudioFrame::kNormalSpeech;
+    frame->vad_activity_ =
+        i % 2 ? AudioFrame::kVadActive : AudioFrame::kVadPassive;
+    frame->num_channels_ = 1;
+    frame->samples_per_channel_ = kSampleRateHz / 100;
+    for (size_t j = 0; j < frame->samples_per_channel_; ++j) {
+      frame->data_[j] = static_cast<int16_t>((i + 1) * ((j % 64) - 32));
+    }
+
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    EXPECT_CALL(participants[i], GetAudioFrame(_, _)).Times(kIterations);
+    EXPECT_CALL(participants[i], NeededFrequency(_))
+        .WillRepeatedly(Return(kSampleRateHz));
+  }
+
+  for (int i = 0; i < kIterations; ++i) {
+    EXPECT_EQ(0, mixer->Process());
+  }
+  EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
+}
+
+TEST(AudioConferenceMixer, FetchThreadsGiveSameMix) {
+  AudioFrame reference;
+  MixWithFetchThreads(0, &reference);
+  ASSERT_EQ(320u, reference.samples_per_channel_);
+
+  for (size_t num_threads : {1, 3}) {
+    AudioFrame mixed;
+    MixWithFetchThreads(num_threads, &mixed);
+    ASSERT_EQ(reference.samples_per_channel_, mixed.samples_per_channel_);
+    ASSERT_EQ(reference.num_channels_, mixed.num_channels_);
+    for (size_t i = 0; i < reference.samples_per_channel_; ++i) {
+      EXPECT_EQ(reference.data_[i], mixed.data_[i]);
+    }
+  }
+}
+
+TEST(AudioConferenceMixer, AudioLevelPreselectionPullsOnlyLoudest) {
+  const int kId = 1;
+  const int kParticipants = 10;
+  const size_t kCandidates =
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants + 1;
+  const int kSampleRateHz = 32000;
+
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(kId));
+  EXPECT_EQ(0, mixer->SetAudioLevelPreselection(kCandidates));
+
+  MockAudioMixerOutputReceiver output_receiver;
+  EXPECT_CALL(output_receiver, NewMixedAudio(_, _, _, _)).Times(1);
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&output_receiver));
+
+  // The last participant reports no level, and is always pulled. Of the
+  // others, the ones with odd index are the loudest.
+  MockMixerParticipant participants[kParticipants];
+  for (int i = 0; i < kParticipants; ++i) {
+    AudioFrame* frame = participants[i].fake_frame();
+    frame->id_ = i;
+    frame->sample_rate_hz_ = kSampleRateHz;
+    frame->speech_type_ = AudioFrame::kNormalSpeech;
+    frame->vad_activity_ = AudioFrame::kVadActive;
+    frame->num_channels_ = 1;
+    frame->samples_per_channel_ = kSampleRateHz / 100;
+    frame->data_[80] = i;
+
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    EXPECT_CALL(participants[i], NeededFrequency(_))
+        .WillRepeatedly(Return(kSampleRateHz));
+    const bool loud = i % 2 == 1 && i < 2 * static_cast<int>(kCandidates);
+    if (i == kParticipants - 1) {
+      EXPECT_CALL(participants[i], GetAudioLevel(_, _))
+          .WillRepeatedly(Return(false));
+      EXPECT_CALL(participants[i], GetAudioFrame(_, _)).Times(1);
+    } else {
+      EXPECT_CALL(participants[i], GetAudioLevel(_, _))
+          .WillRepeatedly(DoAll(SetArgPointee<1>(loud ? 10 : 40 + i),
+                                Return(true)));
+      EXPECT_CALL(participants[i], GetAudioFrame(_, _)).Times(loud ? 1 : 0);
+    }
+  }
+
+  EXPECT_EQ(0, mixer->Process());
+
+  // Of the pulled participants, the ones with the largest energy are mixed.
+  for (int i = 0; i < kParticipants; ++i) {
+    EXPECT_EQ(i == 5 || i == 7 || i == 9, participants[i].IsMixed())
+        << "Mixing status of Participant #" << i << " wrong.";
+  }
+  EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
+}
+
+TEST(AudioConferenceMixer, UniqueMixesExcludeOwnAudio) {
+  const int kId = 1;
+  const int kParticipants =
+      AudioConferenceMixer::kMaximumAmountOfMixedParticipants;
+  const int kSampleRateHz = 32000;
+  // Past the samples modified by the ramp-in window.
+  const size_t kSample = 100;
+
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(kId));
+  EXPECT_EQ(0, mixer->SetUniqueMixesEnabled(true));
+
+  uint32_t num_unique_frames = 0;
+  int16_t unique_samples[kParticipants] = {0};
+  MockAudioMixerOutputReceiver output_receiver;
+  EXPECT_CALL(output_receiver, NewMixedAudio(_, _, _, _))
+      .WillOnce(Invoke([&](const int32_t id,
+                           const AudioFrame& frame,
+                           const AudioFrame** unique_frames,
+                           const uint32_t size) {
+        num_unique_frames = size;
+        for (uint32_t i = 0; i < size; ++i) {
+          ASSERT_GE(unique_frames[i]->id_, 0);
+          ASSERT_LT(unique_frames[i]->id_, kParticipants);
+          unique_samples[unique_frames[i]->id_] =
+              unique_frames[i]->data_[kSample];
+        }
+      }));
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&output_receiver));
+
+  MockMixerParticipant participants[kParticipants];
+  for (int i = 0; i < kParticipants; ++i) {
+    AudioFrame* frame = participants[i].fake_frame();
+    frame->id_ = i;
+    frame->sample_rate_hz_ = kSampleRateHz;
+    frame->speech_type_ = AudioFrame::kNormalSpeech;
+    frame->vad_activity_ = AudioFrame::kVadActive;
+    frame->num_channels_ = 1;
+    frame->samples_per_channel_ = kSampleRateHz / 100;
+    frame->data_[kSample] = static_cast<int16_t>(100 * (i + 1));
+
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    EXPECT_CALL(participants[i], GetAudioFrame(_, _)).Times(1);
+    EXPECT_CALL(participants[i], NeededFrequency(_))
+        .WillRepeatedly(Return(kSampleRateHz));
+  }
+
+  EXPECT_EQ(0, mixer->Process());
+  ASSERT_EQ(static_cast<uint32_t>(kParticipants), num_unique_frames);
+  // 100 + 200 + 300 minus the participant's own audio.
+  EXPECT_EQ(500, unique_samples[0]);
+  EXPECT_EQ(400, unique_samples[1]);
+  EXPECT_EQ(300, unique_samples[2]);
+  EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
+}
+
+TEST(AudioConferenceMixer, PreferredFrequencyUsedForMixedRates) {
+  const int kId = 1;
+  const int kParticipants = 2;
+  const int kNeededFrequencies[kParticipants] = {16000, 48000};
+
+  rtc::scoped_ptr<AudioConferenceMixer> mixer(
+      AudioConferenceMixer::Create(kId));
+  EXPECT_EQ(-1, mixer->SetPreferredMixingFrequency(
+      static_cast<AudioConferenceMixer::Frequency>(44100)));
+  EXPECT_EQ(0, mixer->SetPreferredMixingFrequency(
+      AudioConferenceMixer::kSwbInHz));
+
+  int mixed_frequency = 0;
+  MockAudioMixerOutputReceiver output_receiver;
+  EXPECT_CALL(output_receiver, NewMixedAudio(_, _, _, _))
+      .WillRepeatedly(Invoke([&](const int32_t id,
+                                 const AudioFrame& frame,
+                                 const AudioFrame** unique_frames,
+                                 const uint32_t size) {
+        mixed_frequency = frame.sample_rate_hz_;
+      }));
+  EXPECT_EQ(0, mixer->RegisterMixedStreamCallback(&output_receiver));
+
+  MockMixerParticipant participants[kParticipants];
+  int requested_frequencies[kParticipants] = {0};
+  for (int i = 0; i < kParticipants; ++i) {
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    EXPECT_CALL(participants[i], NeededFrequency(_))
+        .WillRepeatedly(Invoke([&kNeededFrequencies, i](const int32_t id) {
+          return kNeededFrequencies[i];
+        }));
+    EXPECT_CALL(participants[i], GetAudioFrame(_, _))
+        .WillRepeatedly(Invoke([&requested_frequencies, i](
+                                   const int32_t id, AudioFrame* frame) {
+          requested_frequencies[i] = frame->sample_rate_hz_;
+          frame->samples_per_channel_ =
+              static_cast<size_t>(frame->sample_rate_hz_ / 100);
+          frame->num_channels_ = 1;
+          frame->speech_type_ = AudioFrame::kNormalSpeech;
+          frame->vad_activity_ = AudioFrame::kVadActive;
+          return 0;
+        }));
+  }
+
+  // The 16 kHz participant is resampled anyway, so the mix is made at the
+  // preferred frequency rather than at 48 kHz.
+  EXPECT_EQ(0, mixer->Process());
+  EXPECT_EQ(32000, mixed_frequency);
+  EXPECT_EQ(32000, requested_frequencies[0]);
+  EXPECT_EQ(32000, requested_frequencies[1]);
+
+  // Without a preference, the lowest frequency without downsampling is used.
+  EXPECT_EQ(0, mixer->SetPreferredMixingFrequency(
+      AudioConferenceMixer::kLowestPossible));
+  EXPECT_EQ(0, mixer->Process());
+  EXPECT_EQ(48000, mixed_frequency);
+  EXPECT_EQ(48000, requested_frequencies[0]);
+
+  // When everyone needs the same frequency, only the mix is resampled.
+  EXPECT_EQ(0, mixer->SetPreferredMixingFrequency(
+      AudioConferenceMixer::kFbInHz));
+  EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[1], false));
+  EXPECT_EQ(0, mixer->Process());
+  EXPECT_EQ(16000, mixed_frequency);
+  EXPECT_EQ(16000, requested_frequencies[0]);
+  EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
+}
+
 }  // namespace webrtc
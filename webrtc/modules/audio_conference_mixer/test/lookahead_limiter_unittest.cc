@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_conference_mixer/source/lookahead_limiter.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+namespace {
+const size_t kSamplesPerChannel = 320;
+
+void SetFrame(int16_t amplitude, size_t num_channels, AudioFrame* frame) {
+  frame->samples_per_channel_ = kSamplesPerChannel;
+  frame->num_channels_ = num_channels;
+  // A square wave, so that every block has a peak.
+  for (size_t i = 0; i < kSamplesPerChannel * num_channels; ++i) {
+    frame->data_[i] = (i / num_channels) % 2 ? amplitude : -amplitude;
+  }
+}
+
+int Peak(const AudioFrame& frame) {
+  int peak = 0;
+  for (size_t i = 0; i < frame.samples_per_channel_ * frame.num_channels_;
+       ++i) {
+    peak = std::max(peak, std::abs(static_cast<int>(frame.data_[i])));
+  }
+  return peak;
+}
+}  // namespace
+
+TEST(LookaheadLimiterTest, LeavesQuietAudioUntouched) {
+  LookaheadLimiter limiter;
+  AudioFrame frame;
+  SetFrame(1000, 2, &frame);
+  limiter.Process(16383, &frame);
+  EXPECT_EQ(1.f, limiter.gain());
+  for (size_t i = 0; i < kSamplesPerChannel * 2; ++i)
+    EXPECT_EQ(i / 2 % 2 ? 1000 : -1000, frame.data_[i]);
+}
+
+TEST(LookaheadLimiterTest, KeepsPeaksBelowLimit) {
+  LookaheadLimiter limiter;
+  AudioFrame frame;
+  for (size_t num_channels = 1; num_channels <= 2; ++num_channels) {
+    limiter.Reset();
+    SetFrame(1000, num_channels, &frame);
+    limiter.Process(16383, &frame);
+    // A loud frame right after a quiet one, and a sudden peak in the middle
+    // of a frame.
+    SetFrame(32767, num_channels, &frame);
+    limiter.Process(16383, &frame);
+    EXPECT_LE(Peak(frame), 16383);
+    SetFrame(1000, num_channels, &frame);
+    frame.data_[kSamplesPerChannel / 2 * num_channels] = -32768;
+    limiter.Process(16383, &frame);
+    EXPECT_LE(Peak(frame), 16383);
+  }
+}
+
+TEST(LookaheadLimiterTest, ReleasesGainAfterPeak) {
+  LookaheadLimiter limiter;
+  AudioFrame frame;
+  SetFrame(32000, 1, &frame);
+  limiter.Process(16000, &frame);
+  EXPECT_FLOAT_EQ(0.5f, limiter.gain());
+
+  // Each quiet frame raises the gain by one release step per block.
+  SetFrame(1000, 1, &frame);
+  limiter.Process(16000, &frame);
+  EXPECT_FLOAT_EQ(
+      0.5f + LookaheadLimiter::kNumBlocks * LookaheadLimiter::kReleasePerBlock,
+      limiter.gain());
+  EXPECT_LT(Peak(frame), 1000);
+
+  for (int i = 0; i < 10; ++i) {
+    SetFrame(1000, 1, &frame);
+    limiter.Process(16000, &frame);
+  }
+  EXPECT_EQ(1.f, limiter.gain());
+  EXPECT_EQ(1000, Peak(frame));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/modules/audio_conference_mixer/source/memory_pool.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+namespace {
+const int kIterations = 10000;
+
+// Pops and pushes a few frames at a time, and checks that no other thread is
+// handed the same frames meanwhile.
+bool UseFrames(MemoryPool<AudioFrame>* pool, int marker) {
+  AudioFrame* frames[3];
+  for (AudioFrame*& frame : frames) {
+    if (pool->PopMemory(frame) != 0)
+      return false;
+    frame->id_ = marker;
+  }
+  bool ok = true;
+  for (AudioFrame*& frame : frames) {
+    ok &= frame->id_ == marker;
+    pool->PushMemory(frame);
+  }
+  return ok;
+}
+
+struct Worker {
+  MemoryPool<AudioFrame>* pool;
+  bool ok;
+
+  static bool Run(void* obj) {
+    Worker* worker = static_cast<Worker*>(obj);
+    for (int i = 0; i < kIterations; ++i)
+      worker->ok &= UseFrames(worker->pool, 2);
+    return false;
+  }
+};
+}  // namespace
+
+TEST(MemoryPoolTest, GrowsAndReusesMemory) {
+  MemoryPool<AudioFrame>* pool = NULL;
+  ASSERT_EQ(0, MemoryPool<AudioFrame>::CreateMemoryPool(pool, 4));
+
+  // More than the initial size can be popped, and all items are distinct.
+  std::vector<AudioFrame*> frames(10);
+  for (AudioFrame*& frame : frames) {
+    ASSERT_EQ(0, pool->PopMemory(frame));
+    ASSERT_TRUE(frame != NULL);
+  }
+  std::set<AudioFrame*> distinct(frames.begin(), frames.end());
+  EXPECT_EQ(frames.size(), distinct.size());
+
+  for (AudioFrame*& frame : frames) {
+    EXPECT_EQ(0, pool->PushMemory(frame));
+    EXPECT_TRUE(frame == NULL);
+  }
+  AudioFrame* frame = NULL;
+  ASSERT_EQ(0, pool->PopMemory(frame));
+  EXPECT_EQ(1u, distinct.count(frame));
+  EXPECT_EQ(0, pool->PushMemory(frame));
+
+  EXPECT_EQ(0, MemoryPool<AudioFrame>::DeleteMemoryPool(pool));
+  EXPECT_TRUE(pool == NULL);
+}
+
+TEST(MemoryPoolTest, OwnerAndOtherThreadsShareThePool) {
+  MemoryPool<AudioFrame>* pool = NULL;
+  ASSERT_EQ(0, MemoryPool<AudioFrame>::CreateMemoryPool(pool, 4));
+
+  // The first thread to pop becomes the owner.
+  AudioFrame* frame = NULL;
+  ASSERT_EQ(0, pool->PopMemory(frame));
+  ASSERT_EQ(0, pool->PushMemory(frame));
+
+  Worker worker = {pool, true};
+  rtc::PlatformThread thread(&Worker::Run, &worker, "MemoryPoolTest");
+  thread.Start();
+  bool ok = true;
+  for (int i = 0; i < kIterations; ++i)
+    ok &= UseFrames(pool, 1);
+  thread.Stop();
+
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(worker.ok);
+  EXPECT_EQ(0, MemoryPool<AudioFrame>::DeleteMemoryPool(pool));
+}
+
+}  // namespace webrtc
@@ -236,16 +236,19 @@ void OpenSLESPlayer::AllocateDataBuffers() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   RTC_DCHECK(!simple_buffer_queue_);
   RTC_CHECK(audio_device_buffer_);
-  // Don't use the lowest possible size as native buffer size. Instead,
-  // use 10ms to better match the frame size that WebRTC uses. It will result
-  // in a reduced risk for audio glitches and also in a more "clean" sequence
-  // of callbacks from the OpenSL ES thread in to WebRTC when asking for audio
-  // to render.
+  // Use the native burst size as buffer size when it is shorter than 10ms,
+  // since each queued buffer adds its length to the output latency. The
+  // FineAudioBuffer then asks WebRTC for 10ms of audio every few callbacks.
+  // Longer native buffers (and unknown sizes) are replaced by 10ms, which
+  // matches the frame size that WebRTC uses and lets the FineAudioBuffer
+  // pass the audio straight through.
   ALOGD("lowest possible buffer size: %" PRIuS,
       audio_parameters_.GetBytesPerBuffer());
-  bytes_per_buffer_ = audio_parameters_.GetBytesPerFrame() *
-      audio_parameters_.frames_per_10ms_buffer();
-  RTC_DCHECK_GE(bytes_per_buffer_, audio_parameters_.GetBytesPerBuffer());
+  const size_t bytes_per_10ms_buffer =
+      audio_parameters_.GetBytesPer10msBuffer();
+  bytes_per_buffer_ = audio_parameters_.GetBytesPerBuffer();
+  if (bytes_per_buffer_ == 0 || bytes_per_buffer_ > bytes_per_10ms_buffer)
+    bytes_per_buffer_ = bytes_per_10ms_buffer;
   ALOGD("native buffer size: %" PRIuS, bytes_per_buffer_);
   // Create a modified audio buffer class which allows us to ask for any number
   // of samples (and not only multiple of 10ms) to match the native OpenSL ES
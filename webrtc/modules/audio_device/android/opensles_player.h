@@ -144,7 +144,7 @@ class OpenSLESPlayer {
 
   // Number of bytes per audio buffer in each |audio_buffers_[i]|.
   // Typical sizes are 480 or 512 bytes corresponding to native output buffer
-  // sizes of 240 or 256 audio frames respectively.
+  // sizes of 240 or 256 audio frames respectively. Never more than 10ms.
   size_t bytes_per_buffer_;
 
   // Queue of audio buffers to be used by the player object for rendering
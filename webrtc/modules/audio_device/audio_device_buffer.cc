@@ -13,6 +13,7 @@
 #include <assert.h>
 #include <string.h>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/modules/audio_device/audio_device_config.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
@@ -24,6 +25,10 @@ namespace webrtc {
 static const int kHighDelayThresholdMs = 300;
 static const int kLogHighDelayIntervalFrames = 500;  // 5 seconds.
 
+// _playFormat holds the sample rate above the channel count.
+static const int kPlayChannelBits = 4;
+static const int kPlayChannelMask = (1 << kPlayChannelBits) - 1;
+
 // ----------------------------------------------------------------------------
 //  ctor
 // ----------------------------------------------------------------------------
@@ -32,20 +37,18 @@ AudioDeviceBuffer::AudioDeviceBuffer() :
     _id(-1),
     _critSect(*CriticalSectionWrapper::CreateCriticalSection()),
     _critSectCb(*CriticalSectionWrapper::CreateCriticalSection()),
-    _ptrCbAudioTransport(NULL),
     _recSampleRate(0),
-    _playSampleRate(0),
     _recChannels(0),
-    _playChannels(0),
+    _playFormat(0),
     _recChannel(AudioDeviceModule::kChannelBoth),
     _recBytesPerSample(0),
-    _playBytesPerSample(0),
     _recSamples(0),
     _recSize(0),
     _playSamples(0),
     _playSize(0),
     _recFile(*FileWrapper::Create()),
     _playFile(*FileWrapper::Create()),
+    _playFileOpen(0),
     _currentMicLevel(0),
     _newMicLevel(0),
     _typingStatus(false),
@@ -100,7 +103,8 @@ void AudioDeviceBuffer::SetId(uint32_t id)
 int32_t AudioDeviceBuffer::RegisterAudioCallback(AudioTransport* audioCallback)
 {
     CriticalSectionScoped lock(&_critSectCb);
-    _ptrCbAudioTransport = audioCallback;
+    // Returns once the audio threads are done with the previous callback.
+    _audioTransport.Set(audioCallback);
 
     return 0;
 }
@@ -143,7 +147,10 @@ int32_t AudioDeviceBuffer::SetRecordingSampleRate(uint32_t fsHz)
 int32_t AudioDeviceBuffer::SetPlayoutSampleRate(uint32_t fsHz)
 {
     CriticalSectionScoped lock(&_critSect);
-    _playSampleRate = fsHz;
+    const int format = rtc::AtomicOps::AcquireLoad(&_playFormat);
+    rtc::AtomicOps::ReleaseStore(&_playFormat,
+        static_cast<int>(fsHz << kPlayChannelBits) |
+        (format & kPlayChannelMask));
     return 0;
 }
 
@@ -162,7 +169,7 @@ int32_t AudioDeviceBuffer::RecordingSampleRate() const
 
 int32_t AudioDeviceBuffer::PlayoutSampleRate() const
 {
-    return _playSampleRate;
+    return rtc::AtomicOps::AcquireLoad(&_playFormat) >> kPlayChannelBits;
 }
 
 // ----------------------------------------------------------------------------
@@ -183,10 +190,14 @@ int32_t AudioDeviceBuffer::SetRecordingChannels(size_t channels)
 
 int32_t AudioDeviceBuffer::SetPlayoutChannels(size_t channels)
 {
+    if (channels > static_cast<size_t>(kPlayChannelMask))
+    {
+        return -1;
+    }
     CriticalSectionScoped lock(&_critSect);
-    _playChannels = channels;
-    // 16 bits per sample in mono, 32 bits in stereo
-    _playBytesPerSample = 2*channels;
+    const int format = rtc::AtomicOps::AcquireLoad(&_playFormat);
+    rtc::AtomicOps::ReleaseStore(&_playFormat,
+        (format & ~kPlayChannelMask) | static_cast<int>(channels));
     return 0;
 }
 
@@ -250,7 +261,7 @@ size_t AudioDeviceBuffer::RecordingChannels() const
 
 size_t AudioDeviceBuffer::PlayoutChannels() const
 {
-    return _playChannels;
+    return rtc::AtomicOps::AcquireLoad(&_playFormat) & kPlayChannelMask;
 }
 
 // ----------------------------------------------------------------------------
@@ -343,10 +354,16 @@ int32_t AudioDeviceBuffer::StartOutputFileRecording(
 
     CriticalSectionScoped lock(&_critSect);
 
+    rtc::AtomicOps::ReleaseStore(&_playFileOpen, 0);
     _playFile.Flush();
     _playFile.CloseFile();
 
-    return (_playFile.OpenFile(fileName, false, false, false));
+    if (_playFile.OpenFile(fileName, false, false, false) != 0)
+    {
+        return -1;
+    }
+    rtc::AtomicOps::ReleaseStore(&_playFileOpen, 1);
+    return 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -359,6 +376,7 @@ int32_t AudioDeviceBuffer::StopOutputFileRecording()
 
     CriticalSectionScoped lock(&_critSect);
 
+    rtc::AtomicOps::ReleaseStore(&_playFileOpen, 0);
     _playFile.Flush();
     _playFile.CloseFile();
 
@@ -439,7 +457,8 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audioBuffer,
 
 int32_t AudioDeviceBuffer::DeliverRecordedData()
 {
-    CriticalSectionScoped lock(&_critSectCb);
+    LockFreePointer<AudioTransport>::ScopedAccess audioTransport(
+        &_audioTransport);
 
     // Ensure that user has initialized all essential members
     if ((_recSampleRate == 0)     ||
@@ -451,7 +470,7 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
         return -1;
     }
 
-    if (_ptrCbAudioTransport == NULL)
+    if (audioTransport.get() == NULL)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "failed to deliver recorded data (AudioTransport does not exist)");
         return 0;
@@ -461,16 +480,16 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
     uint32_t newMicLevel(0);
     uint32_t totalDelayMS = _playDelayMS +_recDelayMS;
 
-    res = _ptrCbAudioTransport->RecordedDataIsAvailable(&_recBuffer[0],
-                                                        _recSamples,
-                                                        _recBytesPerSample,
-                                                        _recChannels,
-                                                        _recSampleRate,
-                                                        totalDelayMS,
-                                                        _clockDrift,
-                                                        _currentMicLevel,
-                                                        _typingStatus,
-                                                        newMicLevel);
+    res = audioTransport->RecordedDataIsAvailable(&_recBuffer[0],
+                                                  _recSamples,
+                                                  _recBytesPerSample,
+                                                  _recChannels,
+                                                  _recSampleRate,
+                                                  totalDelayMS,
+                                                  _clockDrift,
+                                                  _currentMicLevel,
+                                                  _typingStatus,
+                                                  newMicLevel);
     if (res != -1)
     {
         _newMicLevel = newMicLevel;
@@ -485,69 +504,57 @@ int32_t AudioDeviceBuffer::DeliverRecordedData()
 
 int32_t AudioDeviceBuffer::RequestPlayoutData(size_t nSamples)
 {
-    uint32_t playSampleRate = 0;
-    size_t playBytesPerSample = 0;
-    size_t playChannels = 0;
-    {
-        CriticalSectionScoped lock(&_critSect);
-
-        // Store copies under lock and use copies hereafter to avoid race with
-        // setter methods.
-        playSampleRate = _playSampleRate;
-        playBytesPerSample = _playBytesPerSample;
-        playChannels = _playChannels;
-
-        // Ensure that user has initialized all essential members
-        if ((playBytesPerSample == 0) ||
-            (playChannels == 0)       ||
-            (playSampleRate == 0))
-        {
-            assert(false);
-            return -1;
-        }
+    // This runs on the real-time playout thread and must not block. The
+    // format is read in one atomic load and the transport through
+    // _audioTransport; neither waits for the API thread.
+    const int playFormat = rtc::AtomicOps::AcquireLoad(&_playFormat);
+    const uint32_t playSampleRate =
+        static_cast<uint32_t>(playFormat >> kPlayChannelBits);
+    const size_t playChannels = playFormat & kPlayChannelMask;
+    // 16 bits per sample in mono, 32 bits in stereo
+    const size_t playBytesPerSample = 2 * playChannels;
 
-        _playSamples = nSamples;
-        _playSize = playBytesPerSample * nSamples;  // {2,4}*nSamples
-        if (_playSize > kMaxBufferSizeBytes)
-        {
-            assert(false);
-            return -1;
-        }
+    // Ensure that user has initialized all essential members
+    if ((playChannels == 0) ||
+        (playSampleRate == 0))
+    {
+        assert(false);
+        return -1;
+    }
 
-        if (nSamples != _playSamples)
-        {
-            WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "invalid number of samples to be played out (%d)", nSamples);
-            return -1;
-        }
+    _playSamples = nSamples;
+    _playSize = playBytesPerSample * nSamples;  // {2,4}*nSamples
+    if (_playSize > kMaxBufferSizeBytes)
+    {
+        assert(false);
+        return -1;
     }
 
     size_t nSamplesOut(0);
 
-    CriticalSectionScoped lock(&_critSectCb);
+    LockFreePointer<AudioTransport>::ScopedAccess audioTransport(
+        &_audioTransport);
 
-    if (_ptrCbAudioTransport == NULL)
+    if (audioTransport.get() == NULL)
     {
         WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id, "failed to feed data to playout (AudioTransport does not exist)");
         return 0;
     }
 
-    if (_ptrCbAudioTransport)
+    uint32_t res(0);
+    int64_t elapsed_time_ms = -1;
+    int64_t ntp_time_ms = -1;
+    res = audioTransport->NeedMorePlayData(_playSamples,
+                                           playBytesPerSample,
+                                           playChannels,
+                                           playSampleRate,
+                                           &_playBuffer[0],
+                                           nSamplesOut,
+                                           &elapsed_time_ms,
+                                           &ntp_time_ms);
+    if (res != 0)
     {
-        uint32_t res(0);
-        int64_t elapsed_time_ms = -1;
-        int64_t ntp_time_ms = -1;
-        res = _ptrCbAudioTransport->NeedMorePlayData(_playSamples,
-                                                     playBytesPerSample,
-                                                     playChannels,
-                                                     playSampleRate,
-                                                     &_playBuffer[0],
-                                                     nSamplesOut,
-                                                     &elapsed_time_ms,
-                                                     &ntp_time_ms);
-        if (res != 0)
-        {
-            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id, "NeedMorePlayData() failed");
-        }
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id, "NeedMorePlayData() failed");
     }
 
     return static_cast<int32_t>(nSamplesOut);
@@ -559,8 +566,6 @@ int32_t AudioDeviceBuffer::RequestPlayoutData(size_t nSamples)
 
 int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 {
-    CriticalSectionScoped lock(&_critSect);
-
     if (_playSize > kMaxBufferSizeBytes)
     {
        WEBRTC_TRACE(kTraceError, kTraceUtility, _id,
@@ -572,10 +577,15 @@ int32_t AudioDeviceBuffer::GetPlayoutData(void* audioBuffer)
 
     memcpy(audioBuffer, &_playBuffer[0], _playSize);
 
-    if (_playFile.Open())
+    // Only take the lock when the playout is being recorded to a file.
+    if (rtc::AtomicOps::AcquireLoad(&_playFileOpen))
     {
-        // write to binary file in mono or stereo (interleaved)
-        _playFile.Write(&_playBuffer[0], _playSize);
+        CriticalSectionScoped lock(&_critSect);
+        if (_playFile.Open())
+        {
+            // write to binary file in mono or stereo (interleaved)
+            _playFile.Write(&_playBuffer[0], _playSize);
+        }
     }
 
     return static_cast<int32_t>(_playSamples);
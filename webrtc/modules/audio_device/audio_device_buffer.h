@@ -13,6 +13,7 @@
 
 #include "webrtc/modules/audio_device/include/audio_device.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
+#include "webrtc/system_wrappers/include/lock_free_pointer.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -73,22 +74,24 @@ public:
 private:
     int32_t                   _id;
     CriticalSectionWrapper&         _critSect;
+    // serializes RegisterAudioCallback(); the audio threads never take it
     CriticalSectionWrapper&         _critSectCb;
 
-    AudioTransport*                 _ptrCbAudioTransport;
+    LockFreePointer<AudioTransport> _audioTransport;
 
     uint32_t                  _recSampleRate;
-    uint32_t                  _playSampleRate;
 
     size_t                   _recChannels;
-    size_t                   _playChannels;
+
+    // playout sample rate and channels packed into one word, so that
+    // RequestPlayoutData() reads a consistent format without locking
+    volatile int              _playFormat;
 
     // selected recording channel (left/right/both)
     AudioDeviceModule::ChannelType _recChannel;
 
     // 2 or 4 depending on mono or stereo
     size_t                   _recBytesPerSample;
-    size_t                   _playBytesPerSample;
 
     // 10ms in stereo @ 96kHz
     int8_t                          _recBuffer[kMaxBufferSizeBytes];
@@ -98,6 +101,7 @@ private:
     size_t                    _recSize;           // in bytes
 
     // 10ms in stereo @ 96kHz
+    // only accessed on the playout thread
     int8_t                          _playBuffer[kMaxBufferSizeBytes];
 
     // one sample <=> 2 or 4 bytes
@@ -106,6 +110,9 @@ private:
 
     FileWrapper&                    _recFile;
     FileWrapper&                    _playFile;
+    // set while _playFile is open, so that the playout thread only takes
+    // _critSect when it has something to write
+    volatile int              _playFileOpen;
 
     uint32_t                  _currentMicLevel;
     uint32_t                  _newMicLevel;
@@ -28,6 +28,8 @@ FineAudioBuffer::FineAudioBuffer(AudioDeviceBuffer* device_buffer,
       sample_rate_(sample_rate),
       samples_per_10_ms_(static_cast<size_t>(sample_rate_ * 10 / 1000)),
       bytes_per_10_ms_(samples_per_10_ms_ * sizeof(int16_t)),
+      frame_size_is_multiple_of_10_ms_(
+          desired_frame_size_bytes % bytes_per_10_ms_ == 0),
       playout_cached_buffer_start_(0),
       playout_cached_bytes_(0),
       // Allocate extra space on the recording side to reduce the number of
@@ -48,6 +50,8 @@ size_t FineAudioBuffer::RequiredPlayoutBufferSizeBytes() {
   // It is possible that we store the desired frame size - 1 samples. Since new
   // audio frames are pulled in chunks of 10ms we will need a buffer that can
   // hold desired_frame_size - 1 + 10ms of data. We omit the - 1.
+  if (frame_size_is_multiple_of_10_ms_)
+    return desired_frame_size_bytes_;
   return desired_frame_size_bytes_ + bytes_per_10_ms_;
 }
 
@@ -65,6 +69,19 @@ void FineAudioBuffer::ResetRecord() {
 }
 
 void FineAudioBuffer::GetPlayoutData(int8_t* buffer) {
+  if (frame_size_is_multiple_of_10_ms_) {
+    // Nothing is ever cached; let the ADB write each 10ms chunk in place.
+    for (size_t offset = 0; offset < desired_frame_size_bytes_;
+         offset += bytes_per_10_ms_) {
+      device_buffer_->RequestPlayoutData(samples_per_10_ms_);
+      int num_out = device_buffer_->GetPlayoutData(&buffer[offset]);
+      if (static_cast<size_t>(num_out) != samples_per_10_ms_) {
+        RTC_CHECK_EQ(num_out, 0);
+        return;
+      }
+    }
+    return;
+  }
   if (desired_frame_size_bytes_ <= playout_cached_bytes_) {
     memcpy(buffer, &playout_cache_buffer_.get()[playout_cached_buffer_start_],
            desired_frame_size_bytes_);
@@ -115,6 +132,17 @@ void FineAudioBuffer::DeliverRecordedData(const int8_t* buffer,
                                           size_t size_in_bytes,
                                           int playout_delay_ms,
                                           int record_delay_ms) {
+  if (record_cached_bytes_ == 0 && size_in_bytes % bytes_per_10_ms_ == 0) {
+    // Whole 10ms chunks and nothing left over from earlier calls: hand them
+    // to the ADB without copying them into the cache first.
+    for (size_t offset = 0; offset < size_in_bytes;
+         offset += bytes_per_10_ms_) {
+      device_buffer_->SetRecordedBuffer(&buffer[offset], samples_per_10_ms_);
+      device_buffer_->SetVQEData(playout_delay_ms, record_delay_ms, 0);
+      device_buffer_->DeliverRecordedData();
+    }
+    return;
+  }
   // Check if the temporary buffer can store the incoming buffer. If not,
   // move the remaining (old) bytes to the beginning of the temporary buffer
   // and start adding new samples after the old samples.
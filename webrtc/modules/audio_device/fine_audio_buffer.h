@@ -26,6 +26,8 @@ class AudioDeviceBuffer;
 // in 10ms chunks when the size of the provided audio buffers differs from 10ms.
 // As an example: calling DeliverRecordedData() with 5ms buffers will deliver
 // accumulated 10ms worth of data to the ADB every second call.
+// When the device buffers hold a whole number of 10ms chunks, they are
+// exchanged with the ADB directly and the internal caches are bypassed.
 class FineAudioBuffer {
  public:
   // |device_buffer| is a buffer that provides 10ms of audio data.
@@ -41,7 +43,8 @@ class FineAudioBuffer {
   ~FineAudioBuffer();
 
   // Returns the required size of |buffer| when calling GetPlayoutData(). If
-  // the buffer is smaller memory trampling will happen.
+  // the buffer is smaller memory trampling will happen. No extra space is
+  // needed when |desired_frame_size_bytes| is a multiple of 10ms.
   size_t RequiredPlayoutBufferSizeBytes();
 
   // Clears buffers and counters dealing with playour and/or recording.
@@ -85,6 +88,9 @@ class FineAudioBuffer {
   const size_t samples_per_10_ms_;
   // Number of audio bytes per 10ms.
   const size_t bytes_per_10_ms_;
+  // True if |desired_frame_size_bytes_| is a multiple of |bytes_per_10_ms_|.
+  // Playout audio is then written directly to the output buffer.
+  const bool frame_size_is_multiple_of_10_ms_;
   // Storage for output samples that are not yet asked for.
   rtc::scoped_ptr<int8_t[]> playout_cache_buffer_;
   // Location of first unread output sample.
@@ -144,4 +144,55 @@ TEST(FineBufferTest, GreaterThan10ms) {
   RunFineBufferTest(kSampleRate, kFrameSizeSamples);
 }
 
+TEST(FineBufferTest, MultipleOf10msIsNotCached) {
+  const int kSampleRate = 48000;
+  const int kSamplesPer10Ms = kSampleRate * 10 / 1000;
+  const int kFrameSizeBytes =
+      2 * kSamplesPer10Ms * static_cast<int>(sizeof(int16_t));
+  const int kNumberOfFrames = 3;
+
+  MockAudioDeviceBuffer audio_device_buffer;
+  FineAudioBuffer fine_buffer(&audio_device_buffer, kFrameSizeBytes,
+                              kSampleRate);
+  // No room for a cached chunk is needed.
+  EXPECT_EQ(static_cast<size_t>(kFrameSizeBytes),
+            fine_buffer.RequiredPlayoutBufferSizeBytes());
+
+  rtc::scoped_ptr<int8_t[]> out_buffer(new int8_t[kFrameSizeBytes]);
+  rtc::scoped_ptr<int8_t[]> in_buffer(new int8_t[kFrameSizeBytes]);
+  EXPECT_CALL(audio_device_buffer, RequestPlayoutData(_))
+      .WillRepeatedly(Return(kSamplesPer10Ms));
+  EXPECT_CALL(audio_device_buffer, SetVQEData(_, _, _))
+      .Times(2 * kNumberOfFrames);
+  EXPECT_CALL(audio_device_buffer, DeliverRecordedData())
+      .Times(2 * kNumberOfFrames)
+      .WillRepeatedly(Return(kSamplesPer10Ms));
+  for (int i = 0; i < kNumberOfFrames; ++i) {
+    {
+      InSequence s;
+      EXPECT_CALL(audio_device_buffer, GetPlayoutData(out_buffer.get()))
+          .WillOnce(UpdateBuffer(2 * i, kSamplesPer10Ms))
+          .RetiresOnSaturation();
+      EXPECT_CALL(audio_device_buffer,
+                  GetPlayoutData(out_buffer.get() + kFrameSizeBytes / 2))
+          .WillOnce(UpdateBuffer(2 * i + 1, kSamplesPer10Ms))
+          .RetiresOnSaturation();
+      // The recorded chunks are read straight from |in_buffer|.
+      EXPECT_CALL(audio_device_buffer,
+                  SetRecordedBuffer(in_buffer.get(), kSamplesPer10Ms))
+          .WillOnce(VerifyInputBuffer(2 * i, kSamplesPer10Ms))
+          .RetiresOnSaturation();
+      EXPECT_CALL(audio_device_buffer,
+                  SetRecordedBuffer(in_buffer.get() + kFrameSizeBytes / 2,
+                                    kSamplesPer10Ms))
+          .WillOnce(VerifyInputBuffer(2 * i + 1, kSamplesPer10Ms))
+          .RetiresOnSaturation();
+    }
+    fine_buffer.GetPlayoutData(out_buffer.get());
+    EXPECT_TRUE(VerifyBuffer(out_buffer.get(), i, kFrameSizeBytes));
+    UpdateInputBuffer(in_buffer.get(), i, kFrameSizeBytes);
+    fine_buffer.DeliverRecordedData(in_buffer.get(), kFrameSizeBytes, 0, 0);
+  }
+}
+
 }  // namespace webrtc
@@ -9,6 +9,10 @@
  */
 
 #include <assert.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
 
 #include "webrtc/base/checks.h"
 
@@ -16,6 +20,7 @@
 #include "webrtc/modules/audio_device/linux/audio_device_pulse_linux.h"
 
 #include "webrtc/system_wrappers/include/event_wrapper.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/system_wrappers/include/trace.h"
 
 webrtc_adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
@@ -29,6 +34,37 @@ webrtc_adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
 namespace webrtc
 {
 
+static const char kPlayoutCallbackExperiment[] = "WebRTC-PulsePlayoutCallback";
+static const char kEnabledPrefix[] = "Enabled";
+static const size_t kEnabledPrefixLength = sizeof(kEnabledPrefix) - 1;
+
+// Reads the "WebRTC-PulsePlayoutCallback" field trial. "Enabled" drives
+// playout from the write callback, and "Enabled-<target_ms>,<request_ms>" also
+// sets the target fill level and request size of the play stream buffer, e.g.
+// "WebRTC-PulsePlayoutCallback/Enabled-20,5/" for low-latency playout.
+static bool ReadPlayoutCallbackExperiment(uint32_t* latencyMs,
+                                          uint32_t* requestMs)
+{
+    std::string experiment =
+        field_trial::FindFullName(kPlayoutCallbackExperiment);
+    if (experiment.compare(0, kEnabledPrefixLength, kEnabledPrefix) != 0)
+    {
+        return false;
+    }
+
+    unsigned int latency = 0;
+    unsigned int request = 0;
+    if (experiment.length() > kEnabledPrefixLength + 1 &&
+        sscanf(experiment.c_str() + kEnabledPrefixLength + 1, "%u,%u",
+               &latency, &request) == 2 &&
+        latency > 0 && request > 0 && request <= latency)
+    {
+        *latencyMs = latency;
+        *requestMs = request;
+    }
+    return true;
+}
+
 AudioDeviceLinuxPulse::AudioDeviceLinuxPulse(const int32_t id) :
     _ptrAudioBuffer(NULL),
     _critSect(*CriticalSectionWrapper::CreateCriticalSection()),
@@ -57,6 +93,9 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse(const int32_t id) :
     _stopPlay(false),
     _AGC(false),
     update_speaker_volume_at_startup_(false),
+    _playoutFromCallback(false),
+    _playLatencyMs(WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS),
+    _playRequestMs(0),
     _playBufDelayFixed(20),
     _sndCardPlayDelay(0),
     _sndCardRecDelay(0),
@@ -100,6 +139,9 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse(const int32_t id) :
     memset(&_playBufferAttr, 0, sizeof(_playBufferAttr));
     memset(&_recBufferAttr, 0, sizeof(_recBufferAttr));
     memset(_oldKeyState, 0, sizeof(_oldKeyState));
+
+    _playoutFromCallback = ReadPlayoutCallbackExperiment(&_playLatencyMs,
+                                                         &_playRequestMs);
 }
 
 AudioDeviceLinuxPulse::~AudioDeviceLinuxPulse()
@@ -207,10 +249,13 @@ int32_t AudioDeviceLinuxPulse::Init()
     _ptrThreadRec->SetPriority(rtc::kRealtimePriority);
 
     // PLAYOUT
-    _ptrThreadPlay.reset(new rtc::PlatformThread(
-        PlayThreadFunc, this, "webrtc_audio_module_play_thread"));
-    _ptrThreadPlay->Start();
-    _ptrThreadPlay->SetPriority(rtc::kRealtimePriority);
+    if (!_playoutFromCallback)
+    {
+        _ptrThreadPlay.reset(new rtc::PlatformThread(
+            PlayThreadFunc, this, "webrtc_audio_module_play_thread"));
+        _ptrThreadPlay->Start();
+        _ptrThreadPlay->SetPriority(rtc::kRealtimePriority);
+    }
 
     _initialized = true;
 
@@ -1186,15 +1231,14 @@ int32_t AudioDeviceLinuxPulse::InitPlayout()
         }
 
         size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-        uint32_t latency = bytesPerSec *
-                           WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS /
+        uint32_t latency = bytesPerSec * _playLatencyMs /
                            WEBRTC_PA_MSECS_PER_SEC;
 
         // Set the play buffer attributes
         _playBufferAttr.maxlength = latency; // num bytes stored in the buffer
         _playBufferAttr.tlength = latency; // target fill level of play buffer
         // minimum free num bytes before server request more data
-        _playBufferAttr.minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+        _playBufferAttr.minreq = PlayRequestBytes(bytesPerSec, latency);
         // prebuffer tlength before starting playout
         _playBufferAttr.prebuf = _playBufferAttr.tlength -
                                  _playBufferAttr.minreq;
@@ -1477,6 +1521,21 @@ int32_t AudioDeviceLinuxPulse::StartPlayout()
         return 0;
     }
 
+    if (_playoutFromCallback)
+    {
+        // There is no playout thread; once connected, the write callback
+        // drives playout on its own.
+        CriticalSectionScoped lock(&_critSect);
+        if (ConnectPlayStream() == -1)
+        {
+            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                         "  failed to activate playing");
+            return -1;
+        }
+        _playing = true;
+        return 0;
+    }
+
     // Set state to ensure that playout starts from the audio thread.
     {
         CriticalSectionScoped lock(&_critSect);
@@ -2242,6 +2301,21 @@ void AudioDeviceLinuxPulse::WaitForOperationCompletion(
 
 void AudioDeviceLinuxPulse::EnableWriteCallback()
 {
+    if (_playoutFromCallback)
+    {
+        // The callback stays registered for as long as we play out, but it
+        // is not called for space that is already available, so fill that
+        // here.
+        LATE(pa_stream_set_write_callback)(_playStream, &PaStreamWriteCallback,
+                                           this);
+        size_t bufferSpace = LATE(pa_stream_writable_size)(_playStream);
+        if (bufferSpace != (size_t) -1 && bufferSpace > 0)
+        {
+            WritePlayoutData(bufferSpace);
+        }
+        return;
+    }
+
     if (LATE(pa_stream_get_state)(_playStream) == PA_STREAM_READY)
     {
         // May already have available space. Must check.
@@ -2275,6 +2349,12 @@ void AudioDeviceLinuxPulse::PaStreamWriteCallback(pa_stream */*unused*/,
 
 void AudioDeviceLinuxPulse::PaStreamWriteCallbackHandler(size_t bufferSpace)
 {
+    if (_playoutFromCallback)
+    {
+        WritePlayoutData(bufferSpace);
+        return;
+    }
+
     _tempBufferSpace = bufferSpace;
 
     // Since we write the data asynchronously on a different thread, we have
@@ -2284,6 +2364,84 @@ void AudioDeviceLinuxPulse::PaStreamWriteCallbackHandler(size_t bufferSpace)
     _timeEventPlay.Set();
 }
 
+void AudioDeviceLinuxPulse::WritePlayoutData(size_t bufferSpace)
+{
+    // Runs with the mainloop locked, either on the mainloop thread or in
+    // StartPlayout(). |_playBuffer| and |_playbackBufferUnused| are only
+    // touched here once playout has started, so no other lock is needed.
+    _sndCardPlayDelay = (uint32_t) (LatencyUsecs(_playStream) / 1000);
+
+    const uint32_t numPlaySamples = _playbackBufferSize / (2 * _playChannels);
+    while (bufferSpace > 0)
+    {
+        if (_playbackBufferUnused == _playbackBufferSize)
+        {
+            _ptrAudioBuffer->RequestPlayoutData(numPlaySamples);
+            uint32_t nSamples = _ptrAudioBuffer->GetPlayoutData(_playBuffer);
+            if (nSamples != numPlaySamples)
+            {
+                WEBRTC_TRACE(kTraceError, kTraceAudioDevice,
+                             _id, "  invalid number of output samples(%d)",
+                             nSamples);
+            }
+            _playbackBufferUnused = 0;
+        }
+
+        // Whatever does not fit is written at the next callback.
+        size_t write = std::min(bufferSpace,
+                                _playbackBufferSize - _playbackBufferUnused);
+        if (!WriteToPlayStream(&_playBuffer[_playbackBufferUnused], write))
+        {
+            return;
+        }
+        _playbackBufferUnused += write;
+        bufferSpace -= write;
+    }
+}
+
+bool AudioDeviceLinuxPulse::WriteToPlayStream(const void* data, size_t size)
+{
+    if (LATE(pa_stream_write)(_playStream, const_cast<void*>(data), size,
+                              NULL, (int64_t) 0, PA_SEEK_RELATIVE) == PA_OK)
+    {
+        return true;
+    }
+
+    _writeErrors++;
+    if (_writeErrors > 10)
+    {
+        if (_playError == 1)
+        {
+            WEBRTC_TRACE(kTraceWarning,
+                         kTraceUtility, _id,
+                         "  pending playout error exists");
+        }
+        // Triggers callback from module process thread.
+        _playError = 1;
+        WEBRTC_TRACE(
+                     kTraceError,
+                     kTraceUtility,
+                     _id,
+                     "  kPlayoutError message posted: "
+                     "_writeErrors=%u, error=%d",
+                     _writeErrors,
+                     LATE(pa_context_errno)(_paContext));
+        _writeErrors = 0;
+    }
+    return false;
+}
+
+uint32_t AudioDeviceLinuxPulse::PlayRequestBytes(size_t bytesPerSec,
+                                                 uint32_t latency) const
+{
+    if (_playRequestMs == 0)
+    {
+        return latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+    }
+    uint32_t request = bytesPerSec * _playRequestMs / WEBRTC_PA_MSECS_PER_SEC;
+    return std::min(request, latency);
+}
+
 void AudioDeviceLinuxPulse::PaStreamUnderflowCallback(pa_stream */*unused*/,
                                                       void *pThis)
 {
@@ -2321,7 +2479,7 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler()
     // Set the play buffer attributes
     _playBufferAttr.maxlength = newLatency;
     _playBufferAttr.tlength = newLatency;
-    _playBufferAttr.minreq = newLatency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+    _playBufferAttr.minreq = PlayRequestBytes(bytesPerSec, newLatency);
     _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
 
     pa_operation *op = LATE(pa_stream_set_buffer_attr)(_playStream,
@@ -2588,6 +2746,97 @@ int32_t AudioDeviceLinuxPulse::ProcessRecordedData(
     return 0;
 }
 
+int32_t AudioDeviceLinuxPulse::ConnectPlayStream()
+{
+    _playDeviceName = NULL;
+
+    // Set if not default device
+    if (_outputDeviceIndex > 0)
+    {
+        // Get the playout device name
+        _playDeviceName = new char[kAdmMaxDeviceNameSize];
+        _deviceIndex = _outputDeviceIndex;
+        PlayoutDevices();
+    }
+
+    // Start muted only supported on 0.9.11 and up
+    if (LATE(pa_context_get_protocol_version)(_paContext)
+        >= WEBRTC_PA_ADJUST_LATENCY_PROTOCOL_VERSION)
+    {
+        // Get the currently saved speaker mute status
+        // and set the initial mute status accordingly
+        bool enabled(false);
+        _mixerManager.SpeakerMute(enabled);
+        if (enabled)
+        {
+            _playStreamFlags |= PA_STREAM_START_MUTED;
+        }
+    }
+
+    // Get the currently saved speaker volume
+    uint32_t volume = 0;
+    if (update_speaker_volume_at_startup_)
+      _mixerManager.SpeakerVolume(volume);
+
+    PaLock();
+
+    // NULL gives PA the choice of startup volume.
+    pa_cvolume* ptr_cvolume = NULL;
+    pa_cvolume cVolumes;
+    if (update_speaker_volume_at_startup_) {
+      ptr_cvolume = &cVolumes;
+
+      // Set the same volume for all channels
+      const pa_sample_spec *spec =
+          LATE(pa_stream_get_sample_spec)(_playStream);
+      LATE(pa_cvolume_set)(&cVolumes, spec->channels, volume);
+      update_speaker_volume_at_startup_ = false;
+    }
+
+    int32_t result = 0;
+
+    // Connect the stream to a sink
+    if (LATE(pa_stream_connect_playback)(
+        _playStream,
+        _playDeviceName,
+        &_playBufferAttr,
+        (pa_stream_flags_t) _playStreamFlags,
+        ptr_cvolume, NULL) != PA_OK)
+    {
+        WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
+                     "  failed to connect play stream, err=%d",
+                     LATE(pa_context_errno)(_paContext));
+        result = -1;
+    } else
+    {
+        WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
+                     "  play stream connected");
+
+        // Wait for state change
+        while (LATE(pa_stream_get_state)(_playStream) != PA_STREAM_READY)
+        {
+            LATE(pa_threaded_mainloop_wait)(_paMainloop);
+        }
+
+        WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
+                     "  play stream ready");
+
+        // We can now handle write callbacks
+        EnableWriteCallback();
+    }
+
+    PaUnLock();
+
+    // Clear device name
+    if (_playDeviceName)
+    {
+        delete [] _playDeviceName;
+        _playDeviceName = NULL;
+    }
+
+    return result;
+}
+
 bool AudioDeviceLinuxPulse::PlayThreadFunc(void* pThis)
 {
     return (static_cast<AudioDeviceLinuxPulse*> (pThis)->PlayThreadProcess());
@@ -2620,89 +2869,11 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
                      "_startPlay true, performing initial actions");
 
         _startPlay = false;
-        _playDeviceName = NULL;
-
-        // Set if not default device
-        if (_outputDeviceIndex > 0)
-        {
-            // Get the playout device name
-            _playDeviceName = new char[kAdmMaxDeviceNameSize];
-            _deviceIndex = _outputDeviceIndex;
-            PlayoutDevices();
-        }
-
-        // Start muted only supported on 0.9.11 and up
-        if (LATE(pa_context_get_protocol_version)(_paContext)
-            >= WEBRTC_PA_ADJUST_LATENCY_PROTOCOL_VERSION)
-        {
-            // Get the currently saved speaker mute status
-            // and set the initial mute status accordingly
-            bool enabled(false);
-            _mixerManager.SpeakerMute(enabled);
-            if (enabled)
-            {
-                _playStreamFlags |= PA_STREAM_START_MUTED;
-            }
-        }
-
-        // Get the currently saved speaker volume
-        uint32_t volume = 0;
-        if (update_speaker_volume_at_startup_)
-          _mixerManager.SpeakerVolume(volume);
-
-        PaLock();
-
-        // NULL gives PA the choice of startup volume.
-        pa_cvolume* ptr_cvolume = NULL;
-        if (update_speaker_volume_at_startup_) {
-          pa_cvolume cVolumes;
-          ptr_cvolume = &cVolumes;
-
-          // Set the same volume for all channels
-          const pa_sample_spec *spec =
-              LATE(pa_stream_get_sample_spec)(_playStream);
-          LATE(pa_cvolume_set)(&cVolumes, spec->channels, volume);
-          update_speaker_volume_at_startup_ = false;
-        }
-
-        // Connect the stream to a sink
-        if (LATE(pa_stream_connect_playback)(
-            _playStream,
-            _playDeviceName,
-            &_playBufferAttr,
-            (pa_stream_flags_t) _playStreamFlags,
-            ptr_cvolume, NULL) != PA_OK)
-        {
-            WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                         "  failed to connect play stream, err=%d",
-                         LATE(pa_context_errno)(_paContext));
-        }
-
-        WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
-                     "  play stream connected");
-
-        // Wait for state change
-        while (LATE(pa_stream_get_state)(_playStream) != PA_STREAM_READY)
+        if (ConnectPlayStream() == 0)
         {
-            LATE(pa_threaded_mainloop_wait)(_paMainloop);
+            _playing = true;
         }
-
-        WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
-                     "  play stream ready");
-
-        // We can now handle write callbacks
-        EnableWriteCallback();
-
-        PaUnLock();
-
-        // Clear device name
-        if (_playDeviceName)
-        {
-            delete [] _playDeviceName;
-            _playDeviceName = NULL;
-        }
-
-        _playing = true;
+        // StartPlayout() reports the failure if |_playing| was not set.
         _playStartEvent.Set();
 
         return true;
@@ -2727,34 +2898,7 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
             }
 
             PaLock();
-            if (LATE(pa_stream_write)(
-                _playStream,
-                (void *) &_playBuffer[_playbackBufferUnused],
-                write, NULL, (int64_t) 0,
-                PA_SEEK_RELATIVE) != PA_OK)
-            {
-                _writeErrors++;
-                if (_writeErrors > 10)
-                {
-                    if (_playError == 1)
-                    {
-                        WEBRTC_TRACE(kTraceWarning,
-                                     kTraceUtility, _id,
-                                     "  pending playout error exists");
-                    }
-                    // Triggers callback from module process thread.
-                    _playError = 1;
-                    WEBRTC_TRACE(
-                                 kTraceError,
-                                 kTraceUtility,
-                                 _id,
-                                 "  kPlayoutError message posted: "
-                                 "_writeErrors=%u, error=%d",
-                                 _writeErrors,
-                                 LATE(pa_context_errno)(_paContext));
-                    _writeErrors = 0;
-                }
-            }
+            WriteToPlayStream(&_playBuffer[_playbackBufferUnused], write);
             PaUnLock();
 
             _playbackBufferUnused += write;
@@ -2798,32 +2942,7 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess()
             WEBRTC_TRACE(kTraceDebug, kTraceAudioDevice, _id,
                          "  will write");
             PaLock();
-            if (LATE(pa_stream_write)(_playStream, (void *) &_playBuffer[0],
-                                      write, NULL, (int64_t) 0,
-                                      PA_SEEK_RELATIVE) != PA_OK)
-            {
-                _writeErrors++;
-                if (_writeErrors > 10)
-                {
-                    if (_playError == 1)
-                    {
-                        WEBRTC_TRACE(kTraceWarning,
-                                     kTraceUtility, _id,
-                                     "  pending playout error exists");
-                    }
-                     // Triggers callback from module process thread.
-                    _playError = 1;
-                    WEBRTC_TRACE(
-                                 kTraceError,
-                                 kTraceUtility,
-                                 _id,
-                                 "  kPlayoutError message posted: "
-                                 "_writeErrors=%u, error=%d",
-                                 _writeErrors,
-                                 LATE(pa_context_errno)(_paContext));
-                    _writeErrors = 0;
-                }
-            }
+            WriteToPlayStream(&_playBuffer[0], write);
             PaUnLock();
 
             _playbackBufferUnused = write;
@@ -247,6 +247,9 @@ private:
     static void PaStreamWriteCallback(pa_stream *unused, size_t buffer_space,
                                       void *pThis);
     void PaStreamWriteCallbackHandler(size_t buffer_space);
+    void WritePlayoutData(size_t bufferSpace);
+    bool WriteToPlayStream(const void* data, size_t size);
+    uint32_t PlayRequestBytes(size_t bytesPerSec, uint32_t latency) const;
     static void PaStreamUnderflowCallback(pa_stream *unused, void *pThis);
     void PaStreamUnderflowCallbackHandler();
     void EnableReadCallback();
@@ -271,6 +274,8 @@ private:
     void PaLock();
     void PaUnLock();
 
+    int32_t ConnectPlayStream();
+
     static bool RecThreadFunc(void*);
     static bool PlayThreadFunc(void*);
     bool RecThreadProcess();
@@ -320,6 +325,17 @@ private:
     bool _AGC;
     bool update_speaker_volume_at_startup_;
 
+    // Set by the "WebRTC-PulsePlayoutCallback" field trial. Playout is then
+    // driven from the PulseAudio write callback on the mainloop thread, which
+    // pulls each 10 ms block straight from the AudioDeviceBuffer, and there is
+    // no playout thread. The callback does not take |_critSect|; it runs with
+    // the mainloop locked, which is what StopPlayout() takes to unregister it.
+    bool _playoutFromCallback;
+    // Target fill level and request size of the play stream buffer. A request
+    // size of 0 means a fixed fraction of the target.
+    uint32_t _playLatencyMs;
+    uint32_t _playRequestMs;
+
     uint16_t _playBufDelayFixed; // fixed playback delay
 
     uint32_t _sndCardPlayDelay;
@@ -1514,6 +1514,10 @@ AecCore* WebRtcAec_CreateAec() {
   if (WebRtc_GetCPUInfo(kSSE2)) {
     WebRtcAec_InitAec_SSE2();
   }
+  // Only replaces the filter functions, the rest stay SSE2.
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcAec_InitAec_AVX2();
+  }
 #endif
 
 #if defined(MIPS_FPU_LE)
@@ -48,6 +48,7 @@ extern RftSub128 bitrv2_128;
 // entry points
 void aec_rdft_init(void);
 void aec_rdft_init_sse2(void);
+void aec_rdft_init_avx2(void);
 void aec_rdft_forward_128(float* a);
 void aec_rdft_inverse_128(float* a);
 
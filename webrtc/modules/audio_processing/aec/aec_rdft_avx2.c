@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// AVX2 versions of the real-to-complex post- and pre-processing steps of the
+// 128 point RDFT. The butterflies in cft1st_128() and cftmdl_128() work on
+// groups of four complex values with per-group twiddles and are left to the
+// SSE2 versions.
+
+#include "webrtc/modules/audio_processing/aec/aec_rdft.h"
+
+#include <immintrin.h>
+
+// Splits eight interleaved complex values, at |p|, into real and imaginary
+// parts, in order.
+__inline static void LoadDeinterleaved(const float* p,
+                                       __m256* re,
+                                       __m256* im) {
+  const __m256 a0 = _mm256_loadu_ps(p);
+  const __m256 a8 = _mm256_loadu_ps(p + 8);
+  // The shuffles work within each 128 bit lane, which leaves the 64 bit
+  // halves in the order (0, 2, 1, 3).
+  *re = _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(_mm256_shuffle_ps(a0, a8, _MM_SHUFFLE(2, 0, 2, 0))),
+      _MM_SHUFFLE(3, 1, 2, 0)));
+  *im = _mm256_castpd_ps(_mm256_permute4x64_pd(
+      _mm256_castps_pd(_mm256_shuffle_ps(a0, a8, _MM_SHUFFLE(3, 1, 3, 1))),
+      _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// The inverse of LoadDeinterleaved().
+__inline static void StoreInterleaved(float* p, __m256 re, __m256 im) {
+  const __m256 lo = _mm256_unpacklo_ps(re, im);
+  const __m256 hi = _mm256_unpackhi_ps(re, im);
+  _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+  _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+__inline static __m256 Reverse(__m256 a) {
+  return _mm256_permutevar8x32_ps(a, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+static void rftfsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    // Load 'wk'.
+    const __m256 c_k1 = _mm256_loadu_ps(&c[25 - j1]);  // 24, ..., 31,
+    const __m256 wkr_ = Reverse(_mm256_sub_ps(mm_half, c_k1));  // 31, ..., 24,
+    const __m256 wki_ = _mm256_loadu_ps(&c[j1]);                //  1, ...,  8,
+    // Load and shuffle 'a'.
+    LoadDeinterleaved(&a[j2], &a_j2_p0, &a_j2_p1);  //   2, ...,  16, 3, ...
+    LoadDeinterleaved(&a[114 - j2], &a_k2_p0, &a_k2_p1);
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, ..., 113,
+    {
+      // Calculate 'x'.
+      const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+      const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+      // Calculate product into 'y'.
+      //    yr = wkr * xr - wki * xi;
+      //    yi = wkr * xi + wki * xr;
+      const __m256 a_ = _mm256_mul_ps(wkr_, xr_);
+      const __m256 b_ = _mm256_mul_ps(wki_, xi_);
+      const __m256 c_ = _mm256_mul_ps(wkr_, xi_);
+      const __m256 d_ = _mm256_mul_ps(wki_, xr_);
+      const __m256 yr_ = _mm256_sub_ps(a_, b_);
+      const __m256 yi_ = _mm256_add_ps(c_, d_);
+      // Update 'a'.
+      //    a[j2 + 0] -= yr;
+      //    a[j2 + 1] -= yi;
+      //    a[k2 + 0] += yr;
+      //    a[k2 + 1] -= yi;
+      StoreInterleaved(&a[j2], _mm256_sub_ps(a_j2_p0, yr_),
+                       _mm256_sub_ps(a_j2_p1, yi_));
+      StoreInterleaved(&a[114 - j2], Reverse(_mm256_add_ps(a_k2_p0, yr_)),
+                       Reverse(_mm256_sub_ps(a_k2_p1, yi_)));
+    }
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr - wki * xi;
+    yi = wkr * xi + wki * xr;
+    a[j2 + 0] -= yr;
+    a[j2 + 1] -= yi;
+    a[k2 + 0] += yr;
+    a[k2 + 1] -= yi;
+  }
+  // Clear the upper halves of the YMM registers, which the compiler does not
+  // always do, to avoid AVX-SSE transition penalties in the code after it.
+  _mm256_zeroupper();
+}
+
+static void rftbsub_128_AVX2(float* a) {
+  const float* c = rdft_w + 32;
+  int j1, j2, k1, k2;
+  float wkr, wki, xr, xi, yr, yi;
+
+  const __m256 mm_half = _mm256_set1_ps(0.5f);
+
+  a[1] = -a[1];
+  // Vectorized code (eight at once).
+  //    Note: commented number are indexes for the first iteration of the loop.
+  for (j1 = 1, j2 = 2; j2 + 15 < 64; j1 += 8, j2 += 16) {
+    __m256 a_j2_p0, a_j2_p1, a_k2_p0, a_k2_p1;
+    // Load 'wk'.
+    const __m256 c_k1 = _mm256_loadu_ps(&c[25 - j1]);  // 24, ..., 31,
+    const __m256 wkr_ = Reverse(_mm256_sub_ps(mm_half, c_k1));  // 31, ..., 24,
+    const __m256 wki_ = _mm256_loadu_ps(&c[j1]);                //  1, ...,  8,
+    // Load and shuffle 'a'.
+    LoadDeinterleaved(&a[j2], &a_j2_p0, &a_j2_p1);  //   2, ...,  16, 3, ...
+    LoadDeinterleaved(&a[114 - j2], &a_k2_p0, &a_k2_p1);
+    a_k2_p0 = Reverse(a_k2_p0);  // 126, ..., 112,
+    a_k2_p1 = Reverse(a_k2_p1);  // 127, ..., 113,
+    {
+      // Calculate 'x'.
+      const __m256 xr_ = _mm256_sub_ps(a_j2_p0, a_k2_p0);
+      const __m256 xi_ = _mm256_add_ps(a_j2_p1, a_k2_p1);
+      // Calculate product into 'y'.
+      //    yr = wkr * xr + wki * xi;
+      //    yi = wkr * xi - wki * xr;
+      const __m256 a_ = _mm256_mul_ps(wkr_, xr_);
+      const __m256 b_ = _mm256_mul_ps(wki_, xi_);
+      const __m256 c_ = _mm256_mul_ps(wkr_, xi_);
+      const __m256 d_ = _mm256_mul_ps(wki_, xr_);
+      const __m256 yr_ = _mm256_add_ps(a_, b_);
+      const __m256 yi_ = _mm256_sub_ps(c_, d_);
+      // Update 'a'.
+      //    a[j2 + 0] = a[j2 + 0] - yr;
+      //    a[j2 + 1] = yi - a[j2 + 1];
+      //    a[k2 + 0] = yr + a[k2 + 0];
+      //    a[k2 + 1] = yi - a[k2 + 1];
+      StoreInterleaved(&a[j2], _mm256_sub_ps(a_j2_p0, yr_),
+                       _mm256_sub_ps(yi_, a_j2_p1));
+      StoreInterleaved(&a[114 - j2], Reverse(_mm256_add_ps(a_k2_p0, yr_)),
+                       Reverse(_mm256_sub_ps(yi_, a_k2_p1)));
+    }
+  }
+  // Scalar code for the remaining items.
+  for (; j2 < 64; j1 += 1, j2 += 2) {
+    k2 = 128 - j2;
+    k1 = 32 - j1;
+    wkr = 0.5f - c[k1];
+    wki = c[j1];
+    xr = a[j2 + 0] - a[k2 + 0];
+    xi = a[j2 + 1] + a[k2 + 1];
+    yr = wkr * xr + wki * xi;
+    yi = wkr * xi - wki * xr;
+    a[j2 + 0] = a[j2 + 0] - yr;
+    a[j2 + 1] = yi - a[j2 + 1];
+    a[k2 + 0] = yr + a[k2 + 0];
+    a[k2 + 1] = yi - a[k2 + 1];
+  }
+  a[65] = -a[65];
+  _mm256_zeroupper();
+}
+
+void aec_rdft_init_avx2(void) {
+  rftfsub_128 = rftfsub_128_AVX2;
+  rftbsub_128 = rftbsub_128_AVX2;
+}
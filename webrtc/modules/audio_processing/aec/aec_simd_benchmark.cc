@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "gflags/gflags.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/timeutils.h"
+extern "C" {
+#include "webrtc/modules/audio_processing/aec/aec_core.h"
+#include "webrtc/modules/audio_processing/aec/aec_core_internal.h"
+#include "webrtc/modules/audio_processing/aec/aec_rdft.h"
+}
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+DEFINE_int32(iterations, 100000, "Number of calls to time per function.");
+DEFINE_int32(partitions, 12, "Number of filter partitions, at most 32.");
+
+namespace webrtc {
+namespace {
+
+const char kUsage[] =
+    "Times the C, SSE2 and AVX2 versions of the AEC filter functions and the\n"
+    "128 point RDFT, and prints the largest difference of each from C.";
+
+// Makes the AEC pick the SSE2 functions even when AVX2 is available.
+int GetCPUInfoSSE2Only(CPUFeature feature) {
+  return feature == kSSE2 ? 1 : 0;
+}
+
+struct Variant {
+  const char* name;
+  WebRtc_CPUInfo cpu_info;
+};
+
+struct Buffers {
+  float x_fft_buf[2][kExtendedNumPartitions * PART_LEN1];
+  float h_fft_buf[2][kExtendedNumPartitions * PART_LEN1];
+  float y_fft[2][PART_LEN1];
+  float x_pow[PART_LEN1];
+  float ef[2][PART_LEN1];
+  float fft[PART_LEN2];
+};
+
+void Randomize(float* data, size_t length, float scale) {
+  for (size_t i = 0; i < length; ++i)
+    data[i] = scale * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+}
+
+void InitBuffers(Buffers* buffers) {
+  srand(42);
+  Randomize(&buffers->x_fft_buf[0][0],
+            sizeof(buffers->x_fft_buf) / sizeof(float), 2.f);
+  Randomize(&buffers->h_fft_buf[0][0],
+            sizeof(buffers->h_fft_buf) / sizeof(float), 0.1f);
+  Randomize(&buffers->y_fft[0][0], sizeof(buffers->y_fft) / sizeof(float), 1.f);
+  Randomize(buffers->x_pow, PART_LEN1, 1.f);
+  for (int i = 0; i < PART_LEN1; ++i)
+    buffers->x_pow[i] += 1.f;
+  Randomize(&buffers->ef[0][0], sizeof(buffers->ef) / sizeof(float), 1.f);
+  Randomize(buffers->fft, PART_LEN2, 2.f);
+}
+
+float MaxDiff(const float* a, const float* b, size_t length) {
+  float max_diff = 0.f;
+  for (size_t i = 0; i < length; ++i)
+    max_diff = std::max(max_diff, fabsf(a[i] - b[i]));
+  return max_diff;
+}
+
+// Runs each function once from the same input, so that the outputs of the
+// variants can be compared.
+void RunOnce(Buffers* buffers) {
+  InitBuffers(buffers);
+  WebRtcAec_FilterFar(FLAGS_partitions, 1, buffers->x_fft_buf,
+                      buffers->h_fft_buf, buffers->y_fft);
+  WebRtcAec_ScaleErrorSignal(0, 0.6f, 2e-6f, buffers->x_pow, buffers->ef);
+  WebRtcAec_FilterAdaptation(FLAGS_partitions, 1, buffers->x_fft_buf,
+                             buffers->ef, buffers->h_fft_buf);
+  aec_rdft_forward_128(buffers->fft);
+}
+
+void PrintTime(const char* function, uint64_t start_ns) {
+  const double ns_per_call =
+      static_cast<double>(rtc::TimeNanos() - start_ns) / FLAGS_iterations;
+  printf("  %-20s %10.1f ns/call\n", function, ns_per_call);
+}
+
+void TimeFunctions(Buffers* buffers) {
+  float ef[2][PART_LEN1];
+  float fft[PART_LEN2];
+  uint64_t start_ns;
+
+  InitBuffers(buffers);
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    WebRtcAec_FilterFar(FLAGS_partitions, i % FLAGS_partitions,
+                        buffers->x_fft_buf, buffers->h_fft_buf,
+                        buffers->y_fft);
+  }
+  PrintTime("FilterFar", start_ns);
+
+  // The error signal shrinks with each call, so it is restored to keep the
+  // input away from denormals. Same for the RDFT input, which grows.
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    memcpy(ef, buffers->ef, sizeof(ef));
+    WebRtcAec_ScaleErrorSignal(0, 0.6f, 2e-6f, buffers->x_pow, ef);
+  }
+  PrintTime("ScaleErrorSignal", start_ns);
+
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    WebRtcAec_FilterAdaptation(FLAGS_partitions, i % FLAGS_partitions,
+                               buffers->x_fft_buf, buffers->ef,
+                               buffers->h_fft_buf);
+  }
+  PrintTime("FilterAdaptation", start_ns);
+
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    memcpy(fft, buffers->fft, sizeof(fft));
+    aec_rdft_forward_128(fft);
+    aec_rdft_inverse_128(fft);
+  }
+  PrintTime("RDFT forward+inverse", start_ns);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  google::SetUsageMessage(kUsage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  RTC_CHECK_GT(FLAGS_iterations, 0);
+  RTC_CHECK(FLAGS_partitions > 0 &&
+            FLAGS_partitions <= kExtendedNumPartitions);
+
+  const WebRtc_CPUInfo detected_cpu_info = WebRtc_GetCPUInfo;
+  const Variant kVariants[] = {
+      {"C", WebRtc_GetCPUInfoNoASM},
+      {"SSE2", GetCPUInfoSSE2Only},
+      {"AVX2", detected_cpu_info},
+  };
+  const bool kAvailable[] = {true, detected_cpu_info(kSSE2) != 0,
+                             detected_cpu_info(kAVX2) != 0};
+
+  Buffers* reference = new Buffers();
+  Buffers* buffers = new Buffers();
+  for (size_t i = 0; i < sizeof(kVariants) / sizeof(kVariants[0]); ++i) {
+    if (!kAvailable[i]) {
+      printf("%s: not supported on this CPU\n", kVariants[i].name);
+      continue;
+    }
+    // The AEC picks its functions, and the RDFT's, when it is created.
+    WebRtc_GetCPUInfo = kVariants[i].cpu_info;
+    AecCore* aec = WebRtcAec_CreateAec();
+    WebRtc_GetCPUInfo = detected_cpu_info;
+    RTC_CHECK(aec);
+
+    printf("%s:\n", kVariants[i].name);
+    Buffers* output = i == 0 ? reference : buffers;
+    RunOnce(output);
+    if (i > 0) {
+      printf("  max diff from C: y_fft %g, ef %g, h_fft %g, rdft %g\n",
+             MaxDiff(&output->y_fft[0][0], &reference->y_fft[0][0],
+                     sizeof(output->y_fft) / sizeof(float)),
+             MaxDiff(&output->ef[0][0], &reference->ef[0][0],
+                     sizeof(output->ef) / sizeof(float)),
+             MaxDiff(&output->h_fft_buf[0][0], &reference->h_fft_buf[0][0],
+                     sizeof(output->h_fft_buf) / sizeof(float)),
+             MaxDiff(output->fft, reference->fft, PART_LEN2));
+    }
+    TimeFunctions(buffers);
+    WebRtcAec_FreeAec(aec);
+  }
+  delete buffers;
+  delete reference;
+  return 0;
+}
+
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  return webrtc::main(argc, argv);
+}
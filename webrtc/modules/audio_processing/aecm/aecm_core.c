@@ -360,6 +360,16 @@ static void ResetAdaptiveChannelC(AecmCore* aecm) {
     aecm->channelAdapt32[i] = (int32_t)aecm->channelStored[i] << 16;
 }
 
+// Initialize function pointers for x86 platforms with SSE2.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcAecm_InitSse2(void)
+{
+  WebRtcAecm_StoreAdaptiveChannel = WebRtcAecm_StoreAdaptiveChannelSse2;
+  WebRtcAecm_ResetAdaptiveChannel = WebRtcAecm_ResetAdaptiveChannelSse2;
+  WebRtcAecm_CalcLinearEnergies = WebRtcAecm_CalcLinearEnergiesSse2;
+}
+#endif
+
 // Initialize function pointers for ARM Neon platform.
 #if (defined WEBRTC_DETECT_NEON || defined WEBRTC_HAS_NEON)
 static void WebRtcAecm_InitNeon(void)
@@ -508,6 +518,13 @@ int WebRtcAecm_InitCore(AecmCore* const aecm, int samplingFreq) {
     WebRtcAecm_StoreAdaptiveChannel = StoreAdaptiveChannelC;
     WebRtcAecm_ResetAdaptiveChannel = ResetAdaptiveChannelC;
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (WebRtc_GetCPUInfo(kSSE2))
+    {
+      WebRtcAecm_InitSse2();
+    }
+#endif
+
 #ifdef WEBRTC_DETECT_NEON
     uint64_t features = WebRtc_GetCPUFeaturesARM();
     if ((features & kCPUFeatureNEON) != 0)
@@ -398,8 +398,24 @@ typedef void (*ResetAdaptiveChannel)(AecmCore* aecm);
 extern ResetAdaptiveChannel WebRtcAecm_ResetAdaptiveChannel;
 
 // For the above function pointers, functions for generic platforms are declared
-// and defined as static in file aecm_core.c, while those for ARM Neon platforms
-// are declared below and defined in file aecm_core_neon.c.
+// and defined as static in file aecm_core.c, while those for SSE2 and ARM Neon
+// platforms are declared below and defined in files aecm_core_sse2.c and
+// aecm_core_neon.c.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcAecm_CalcLinearEnergiesSse2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored);
+
+void WebRtcAecm_StoreAdaptiveChannelSse2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est);
+
+void WebRtcAecm_ResetAdaptiveChannelSse2(AecmCore* aecm);
+#endif
+
 #if defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
 void WebRtcAecm_CalcLinearEnergiesNeon(AecmCore* aecm,
                                        const uint16_t* far_spectrum,
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/aecm/aecm_core.h"
+
+#include <emmintrin.h>
+#include <string.h>
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+// Multiplies the signed 16-bit |a| with the unsigned 16-bit |b|, as
+// WEBRTC_SPL_MUL_16_U16() does, giving the 32-bit products of the low and high
+// four lanes in |lo| and |hi|. _mm_mulhi_epi16() treats |b| as signed, which
+// for |b| >= 0x8000 leaves the high half short by |a|.
+static void MulS16U16(__m128i a, __m128i b, __m128i* lo, __m128i* hi) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high =
+      _mm_add_epi16(_mm_mulhi_epi16(a, b),
+                    _mm_and_si128(a, _mm_srai_epi16(b, 15)));
+  *lo = _mm_unpacklo_epi16(low, high);
+  *hi = _mm_unpackhi_epi16(low, high);
+}
+
+static uint32_t SumLanes(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+void WebRtcAecm_CalcLinearEnergiesSse2(AecmCore* aecm,
+                                       const uint16_t* far_spectrum,
+                                       int32_t* echo_est,
+                                       uint32_t* far_energy,
+                                       uint32_t* echo_energy_adapt,
+                                       uint32_t* echo_energy_stored) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i far_energy_v = zero;
+  __m128i echo_adapt_v = zero;
+  __m128i echo_stored_v = zero;
+  int i;
+
+  // The sums wrap around the same way as the 32-bit unsigned sums of
+  // CalcLinearEnergiesC() in aecm_core.c.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i spectrum =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    const __m128i adapt =
+        _mm_loadu_si128((const __m128i*)&aecm->channelAdapt16[i]);
+    __m128i est_lo, est_hi, adapt_lo, adapt_hi;
+
+    far_energy_v = _mm_add_epi32(far_energy_v,
+                                 _mm_unpacklo_epi16(spectrum, zero));
+    far_energy_v = _mm_add_epi32(far_energy_v,
+                                 _mm_unpackhi_epi16(spectrum, zero));
+
+    MulS16U16(stored, spectrum, &est_lo, &est_hi);
+    _mm_storeu_si128((__m128i*)&echo_est[i], est_lo);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], est_hi);
+    echo_stored_v = _mm_add_epi32(echo_stored_v, est_lo);
+    echo_stored_v = _mm_add_epi32(echo_stored_v, est_hi);
+
+    MulS16U16(adapt, spectrum, &adapt_lo, &adapt_hi);
+    echo_adapt_v = _mm_add_epi32(echo_adapt_v, adapt_lo);
+    echo_adapt_v = _mm_add_epi32(echo_adapt_v, adapt_hi);
+  }
+
+  *far_energy += SumLanes(far_energy_v);
+  *echo_energy_adapt += SumLanes(echo_adapt_v);
+  *echo_energy_stored += SumLanes(echo_stored_v);
+
+  // Last bin.
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+  *far_energy += (uint32_t)far_spectrum[PART_LEN];
+  *echo_energy_adapt +=
+      aecm->channelAdapt16[PART_LEN] * far_spectrum[PART_LEN];
+  *echo_energy_stored += (uint32_t)echo_est[PART_LEN];
+}
+
+void WebRtcAecm_StoreAdaptiveChannelSse2(AecmCore* aecm,
+                                         const uint16_t* far_spectrum,
+                                         int32_t* echo_est) {
+  int i;
+
+  // During startup we store the channel every block.
+  memcpy(aecm->channelStored, aecm->channelAdapt16,
+         sizeof(int16_t) * PART_LEN1);
+  // Recalculate echo estimate.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i spectrum =
+        _mm_loadu_si128((const __m128i*)&far_spectrum[i]);
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    __m128i est_lo, est_hi;
+    MulS16U16(stored, spectrum, &est_lo, &est_hi);
+    _mm_storeu_si128((__m128i*)&echo_est[i], est_lo);
+    _mm_storeu_si128((__m128i*)&echo_est[i + 4], est_hi);
+  }
+  echo_est[PART_LEN] = WEBRTC_SPL_MUL_16_U16(aecm->channelStored[PART_LEN],
+                                             far_spectrum[PART_LEN]);
+}
+
+void WebRtcAecm_ResetAdaptiveChannelSse2(AecmCore* aecm) {
+  const __m128i zero = _mm_setzero_si128();
+  int i;
+
+  // The stored channel has a significantly lower MSE than the adaptive one for
+  // two consecutive calculations. Reset the adaptive channel.
+  memcpy(aecm->channelAdapt16, aecm->channelStored,
+         sizeof(int16_t) * PART_LEN1);
+  // Restore the W32 channel, placing each 16-bit value in the high half.
+  for (i = 0; i < PART_LEN; i += 8) {
+    const __m128i stored =
+        _mm_loadu_si128((const __m128i*)&aecm->channelStored[i]);
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i],
+                     _mm_unpacklo_epi16(zero, stored));
+    _mm_storeu_si128((__m128i*)&aecm->channelAdapt32[i + 4],
+                     _mm_unpackhi_epi16(zero, stored));
+  }
+  aecm->channelAdapt32[PART_LEN] = (int32_t)aecm->channelStored[PART_LEN] << 16;
+}
@@ -1318,6 +1318,9 @@ int WebRtcAgc_get_config(void* agcInst, WebRtcAgcConfig* config) {
 void* WebRtcAgc_Create() {
   LegacyAgc* stt = malloc(sizeof(LegacyAgc));
 
+  // Initialize the SPL function pointers used by the digital AGC.
+  WebRtcSpl_Init();
+
 #ifdef WEBRTC_AGC_DEBUG_DUMP
   stt->fpt = fopen("./agc_test_log.txt", "wt");
   stt->agcLog = fopen("./agc_debug_log.txt", "wt");
@@ -302,7 +302,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
 
     int32_t out_tmp, tmp32;
     int32_t env[10];
-    int32_t max_nrg;
+    int32_t max_abs;
     int32_t cur_level;
     int32_t gain32, delta;
     int16_t logratio;
@@ -399,17 +399,16 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
     // iterate over sub frames
     for (k = 0; k < 10; k++)
     {
-        // iterate over samples
-        max_nrg = 0;
-        for (n = 0; n < L; n++)
+        // The largest energy is the square of the largest absolute value,
+        // which is found with the (vectorized) SPL function. It saturates
+        // abs(-32768) to 32767, so that case is checked for separately.
+        max_abs = WebRtcSpl_MaxAbsValueW16(&out[0][k * L], L);
+        if (max_abs == WEBRTC_SPL_WORD16_MAX &&
+            WebRtcSpl_MinValueW16(&out[0][k * L], L) == WEBRTC_SPL_WORD16_MIN)
         {
-            int32_t nrg = out[0][k * L + n] * out[0][k * L + n];
-            if (nrg > max_nrg)
-            {
-                max_nrg = nrg;
-            }
+            max_abs = 32768;
         }
-        env[k] = max_nrg;
+        env[k] = max_abs * max_abs;
     }
 
     // Calculate gain per sub frame
@@ -57,6 +57,7 @@ AudioBuffer::AudioBuffer(size_t input_num_frames,
     num_bands_(NumBandsFromSamplesPerChannel(proc_num_frames_)),
     num_split_frames_(rtc::CheckedDivExact(proc_num_frames_, num_bands_)),
     mixed_low_pass_valid_(false),
+    split_pending_(false),
     reference_copied_(false),
     activity_(AudioFrame::kVadUnknown),
     keyboard_data_(NULL),
@@ -102,6 +103,31 @@ AudioBuffer::AudioBuffer(size_t input_num_frames,
 
 AudioBuffer::~AudioBuffer() {}
 
+bool AudioBuffer::HasDimensions(size_t input_num_frames,
+                                size_t num_input_channels,
+                                size_t process_num_frames,
+                                size_t num_process_channels,
+                                size_t output_num_frames) const {
+  return input_num_frames_ == input_num_frames &&
+         num_input_channels_ == num_input_channels &&
+         proc_num_frames_ == process_num_frames &&
+         num_proc_channels_ == num_process_channels &&
+         output_num_frames_ == output_num_frames;
+}
+
+void AudioBuffer::Reset() {
+  for (size_t i = 0; i < input_resamplers_.size(); ++i) {
+    input_resamplers_[i]->Reset();
+  }
+  for (size_t i = 0; i < output_resamplers_.size(); ++i) {
+    output_resamplers_[i]->Reset();
+  }
+  if (splitting_filter_) {
+    splitting_filter_->Reset();
+  }
+  InitForNewData();
+}
+
 void AudioBuffer::CopyFrom(const float* const* data,
                            const StreamConfig& stream_config) {
   assert(stream_config.num_frames() == input_num_frames_);
@@ -183,6 +209,7 @@ void AudioBuffer::CopyTo(const StreamConfig& stream_config,
 void AudioBuffer::InitForNewData() {
   keyboard_data_ = NULL;
   mixed_low_pass_valid_ = false;
+  split_pending_ = false;
   reference_copied_ = false;
   activity_ = AudioFrame::kVadUnknown;
   num_channels_ = num_proc_channels_;
@@ -193,17 +220,20 @@ const int16_t* const* AudioBuffer::channels_const() const {
 }
 
 int16_t* const* AudioBuffer::channels() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return data_->ibuf()->channels();
 }
 
 const int16_t* const* AudioBuffer::split_bands_const(size_t channel) const {
+  MaybeSplitIntoFrequencyBands();
   return split_data_.get() ?
          split_data_->ibuf_const()->bands(channel) :
          data_->ibuf_const()->bands(channel);
 }
 
 int16_t* const* AudioBuffer::split_bands(size_t channel) {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return split_data_.get() ?
          split_data_->ibuf()->bands(channel) :
@@ -211,6 +241,7 @@ int16_t* const* AudioBuffer::split_bands(size_t channel) {
 }
 
 const int16_t* const* AudioBuffer::split_channels_const(Band band) const {
+  MaybeSplitIntoFrequencyBands();
   if (split_data_.get()) {
     return split_data_->ibuf_const()->channels(band);
   } else {
@@ -219,6 +250,7 @@ const int16_t* const* AudioBuffer::split_channels_const(Band band) const {
 }
 
 int16_t* const* AudioBuffer::split_channels(Band band) {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   if (split_data_.get()) {
     return split_data_->ibuf()->channels(band);
@@ -228,6 +260,7 @@ int16_t* const* AudioBuffer::split_channels(Band band) {
 }
 
 ChannelBuffer<int16_t>* AudioBuffer::data() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return data_->ibuf();
 }
@@ -237,11 +270,13 @@ const ChannelBuffer<int16_t>* AudioBuffer::data() const {
 }
 
 ChannelBuffer<int16_t>* AudioBuffer::split_data() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return split_data_.get() ? split_data_->ibuf() : data_->ibuf();
 }
 
 const ChannelBuffer<int16_t>* AudioBuffer::split_data() const {
+  MaybeSplitIntoFrequencyBands();
   return split_data_.get() ? split_data_->ibuf_const() : data_->ibuf_const();
 }
 
@@ -250,17 +285,20 @@ const float* const* AudioBuffer::channels_const_f() const {
 }
 
 float* const* AudioBuffer::channels_f() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return data_->fbuf()->channels();
 }
 
 const float* const* AudioBuffer::split_bands_const_f(size_t channel) const {
+  MaybeSplitIntoFrequencyBands();
   return split_data_.get() ?
          split_data_->fbuf_const()->bands(channel) :
          data_->fbuf_const()->bands(channel);
 }
 
 float* const* AudioBuffer::split_bands_f(size_t channel) {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return split_data_.get() ?
          split_data_->fbuf()->bands(channel) :
@@ -268,6 +306,7 @@ float* const* AudioBuffer::split_bands_f(size_t channel) {
 }
 
 const float* const* AudioBuffer::split_channels_const_f(Band band) const {
+  MaybeSplitIntoFrequencyBands();
   if (split_data_.get()) {
     return split_data_->fbuf_const()->channels(band);
   } else {
@@ -276,6 +315,7 @@ const float* const* AudioBuffer::split_channels_const_f(Band band) const {
 }
 
 float* const* AudioBuffer::split_channels_f(Band band) {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   if (split_data_.get()) {
     return split_data_->fbuf()->channels(band);
@@ -285,6 +325,7 @@ float* const* AudioBuffer::split_channels_f(Band band) {
 }
 
 ChannelBuffer<float>* AudioBuffer::data_f() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return data_->fbuf();
 }
@@ -294,11 +335,13 @@ const ChannelBuffer<float>* AudioBuffer::data_f() const {
 }
 
 ChannelBuffer<float>* AudioBuffer::split_data_f() {
+  MaybeSplitIntoFrequencyBands();
   mixed_low_pass_valid_ = false;
   return split_data_.get() ? split_data_->fbuf() : data_->fbuf();
 }
 
 const ChannelBuffer<float>* AudioBuffer::split_data_f() const {
+  MaybeSplitIntoFrequencyBands();
   return split_data_.get() ? split_data_->fbuf_const() : data_->fbuf_const();
 }
 
@@ -457,11 +500,23 @@ void AudioBuffer::CopyLowPassToReference() {
 }
 
 void AudioBuffer::SplitIntoFrequencyBands() {
-  splitting_filter_->Analysis(data_.get(), split_data_.get());
+  split_pending_ = true;
 }
 
 void AudioBuffer::MergeFrequencyBands() {
+  if (split_pending_) {
+    // Nothing has touched the bands, so the full-band signal is still valid.
+    split_pending_ = false;
+    return;
+  }
   splitting_filter_->Synthesis(split_data_.get(), data_.get());
 }
 
+void AudioBuffer::MaybeSplitIntoFrequencyBands() const {
+  if (split_pending_) {
+    split_pending_ = false;
+    splitting_filter_->Analysis(data_.get(), split_data_.get());
+  }
+}
+
 }  // namespace webrtc
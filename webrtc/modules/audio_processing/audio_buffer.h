@@ -40,6 +40,16 @@ class AudioBuffer {
               size_t output_num_frames);
   virtual ~AudioBuffer();
 
+  // Returns true if the buffer was constructed with these dimensions.
+  bool HasDimensions(size_t input_num_frames,
+                     size_t num_input_channels,
+                     size_t process_num_frames,
+                     size_t num_process_channels,
+                     size_t output_num_frames) const;
+  // Resets the resampler and splitting filter states, as after construction,
+  // without reallocating them.
+  void Reset();
+
   size_t num_channels() const;
   void set_num_channels(size_t num_channels);
   size_t num_frames() const;
@@ -116,15 +126,21 @@ class AudioBuffer {
   void CopyTo(const StreamConfig& stream_config, float* const* data);
   void CopyLowPassToReference();
 
-  // Splits the signal into different bands.
+  // Splits the signal into different bands. The filter bank is run lazily,
+  // when the split data is first accessed.
   void SplitIntoFrequencyBands();
-  // Recombine the different bands into one signal.
+  // Recombine the different bands into one signal. If the split data was never
+  // accessed, the full-band signal is left untouched.
   void MergeFrequencyBands();
 
  private:
   // Called from DeinterleaveFrom() and CopyFrom().
   void InitForNewData();
 
+  // Runs the analysis filter bank if a split has been requested but not yet
+  // performed.
+  void MaybeSplitIntoFrequencyBands() const;
+
   // The audio is passed into DeinterleaveFrom() or CopyFrom() with input
   // format (samples per channel and number of channels).
   const size_t input_num_frames_;
@@ -142,6 +158,9 @@ class AudioBuffer {
   size_t num_bands_;
   size_t num_split_frames_;
   bool mixed_low_pass_valid_;
+  // Whether SplitIntoFrequencyBands() has been called without the split data
+  // having been computed yet.
+  mutable bool split_pending_;
   bool reference_copied_;
   AudioFrame::VADActivity activity_;
 
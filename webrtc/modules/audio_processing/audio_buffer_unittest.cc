@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/splitting_filter.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumChannels = 2;
+const size_t kChunks = 4;
+
+void FillChunk(size_t chunk, ChannelBuffer<float>* buffer) {
+  for (size_t i = 0; i < buffer->num_channels(); ++i) {
+    for (size_t j = 0; j < buffer->num_frames(); ++j) {
+      buffer->channels()[i][j] =
+          0.001f * ((chunk * buffer->num_frames() + j * (i + 1)) % 200) - 0.1f;
+    }
+  }
+}
+
+void ExpectSplitMatchesSplittingFilter(int sample_rate_hz) {
+  const size_t num_frames = static_cast<size_t>(sample_rate_hz / 100);
+  const StreamConfig stream_config(sample_rate_hz, kNumChannels);
+  AudioBuffer audio(num_frames, kNumChannels, num_frames, kNumChannels,
+                    num_frames);
+  SplittingFilter splitting_filter(kNumChannels, audio.num_bands(),
+                                   num_frames);
+  IFChannelBuffer reference(num_frames, kNumChannels);
+  IFChannelBuffer reference_bands(num_frames, kNumChannels, audio.num_bands());
+  ChannelBuffer<float> input(num_frames, kNumChannels);
+
+  for (size_t chunk = 0; chunk < kChunks; ++chunk) {
+    FillChunk(chunk, &input);
+    audio.CopyFrom(input.channels(), stream_config);
+    for (size_t i = 0; i < kNumChannels; ++i) {
+      memcpy(reference.fbuf()->channels()[i], audio.channels_const_f()[i],
+             num_frames * sizeof(float));
+    }
+    splitting_filter.Analysis(&reference, &reference_bands);
+
+    audio.SplitIntoFrequencyBands();
+    for (size_t i = 0; i < kNumChannels; ++i) {
+      for (size_t band = 0; band < audio.num_bands(); ++band) {
+        for (size_t j = 0; j < audio.num_frames_per_band(); ++j) {
+          EXPECT_EQ(reference_bands.fbuf_const()->bands(i)[band][j],
+                    audio.split_bands_const_f(i)[band][j]);
+        }
+      }
+    }
+    audio.MergeFrequencyBands();
+  }
+}
+
+// Runs |kChunks| chunks through |audio|, splitting and merging the bands and
+// scaling the lowest one, and stores the output of the last chunk in |output|.
+void ProcessChunks(const StreamConfig& stream_config,
+                   AudioBuffer* audio,
+                   ChannelBuffer<float>* output) {
+  ChannelBuffer<float> input(stream_config.num_frames(), kNumChannels);
+  for (size_t chunk = 0; chunk < kChunks; ++chunk) {
+    FillChunk(chunk, &input);
+    audio->CopyFrom(input.channels(), stream_config);
+    audio->SplitIntoFrequencyBands();
+    for (size_t i = 0; i < audio->num_channels(); ++i) {
+      for (size_t j = 0; j < audio->num_frames_per_band(); ++j) {
+        audio->split_bands_f(i)[kBand0To8kHz][j] *= 0.5f;
+      }
+    }
+    audio->MergeFrequencyBands();
+    audio->CopyTo(stream_config, output->channels());
+  }
+}
+
+void ExpectResetMatchesNewBuffer(size_t process_num_frames,
+                                 size_t num_process_channels) {
+  const int kSampleRateHz = 48000;
+  const size_t kNumFrames = kSampleRateHz / 100;
+  const StreamConfig stream_config(kSampleRateHz, kNumChannels);
+  AudioBuffer audio(kNumFrames, kNumChannels, process_num_frames,
+                    num_process_channels, kNumFrames);
+  EXPECT_TRUE(audio.HasDimensions(kNumFrames, kNumChannels, process_num_frames,
+                                  num_process_channels, kNumFrames));
+  EXPECT_FALSE(audio.HasDimensions(kNumFrames, kNumChannels,
+                                   process_num_frames / 2,
+                                   num_process_channels, kNumFrames));
+  ChannelBuffer<float> output(kNumFrames, kNumChannels);
+  ProcessChunks(stream_config, &audio, &output);
+  audio.Reset();
+  ProcessChunks(stream_config, &audio, &output);
+
+  AudioBuffer new_audio(kNumFrames, kNumChannels, process_num_frames,
+                        num_process_channels, kNumFrames);
+  ChannelBuffer<float> new_output(kNumFrames, kNumChannels);
+  ProcessChunks(stream_config, &new_audio, &new_output);
+  for (size_t i = 0; i < kNumChannels; ++i) {
+    for (size_t j = 0; j < kNumFrames; ++j) {
+      EXPECT_EQ(new_output.channels()[i][j], output.channels()[i][j]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(AudioBufferTest, SplitsOnFirstAccessAt32kHz) {
+  ExpectSplitMatchesSplittingFilter(32000);
+}
+
+TEST(AudioBufferTest, SplitsOnFirstAccessAt48kHz) {
+  ExpectSplitMatchesSplittingFilter(48000);
+}
+
+TEST(AudioBufferTest, UntouchedBandsLeaveFullBandSignalUnchanged) {
+  const int kSampleRateHz = 48000;
+  const size_t kNumFrames = kSampleRateHz / 100;
+  const StreamConfig stream_config(kSampleRateHz, kNumChannels);
+  AudioBuffer audio(kNumFrames, kNumChannels, kNumFrames, kNumChannels,
+                    kNumFrames);
+  ChannelBuffer<float> input(kNumFrames, kNumChannels);
+  ChannelBuffer<float> output(kNumFrames, kNumChannels);
+
+  for (size_t chunk = 0; chunk < kChunks; ++chunk) {
+    FillChunk(chunk, &input);
+    audio.CopyFrom(input.channels(), stream_config);
+    audio.SplitIntoFrequencyBands();
+    audio.MergeFrequencyBands();
+    audio.CopyTo(stream_config, output.channels());
+    for (size_t i = 0; i < kNumChannels; ++i) {
+      for (size_t j = 0; j < kNumFrames; ++j) {
+        EXPECT_FLOAT_EQ(input.channels()[i][j], output.channels()[i][j]);
+      }
+    }
+  }
+}
+
+TEST(AudioBufferTest, ResetMatchesNewBufferWithResampling) {
+  ExpectResetMatchesNewBuffer(320, kNumChannels);
+}
+
+TEST(AudioBufferTest, ResetMatchesNewBufferWithThreeBands) {
+  ExpectResetMatchesNewBuffer(480, 1);
+}
+
+}  // namespace webrtc
@@ -75,6 +75,28 @@ static bool LayoutHasKeyboard(AudioProcessing::ChannelLayout layout) {
   assert(false);
   return false;
 }
+
+// Reuses |audio| if it already has the requested dimensions, resetting its
+// state in place, and reallocates it otherwise. Reinitializations usually
+// change the format of only one direction, and this avoids rebuilding the
+// resamplers and filter banks of the other.
+void ResetOrCreateAudioBuffer(size_t input_num_frames,
+                              size_t num_input_channels,
+                              size_t process_num_frames,
+                              size_t num_process_channels,
+                              size_t output_num_frames,
+                              rtc::scoped_ptr<AudioBuffer>* audio) {
+  if (*audio &&
+      (*audio)->HasDimensions(input_num_frames, num_input_channels,
+                              process_num_frames, num_process_channels,
+                              output_num_frames)) {
+    (*audio)->Reset();
+  } else {
+    audio->reset(new AudioBuffer(input_num_frames, num_input_channels,
+                                 process_num_frames, num_process_channels,
+                                 output_num_frames));
+  }
+}
 }  // namespace
 
 // Throughout webrtc, it's assumed that success is represented by zero.
@@ -239,7 +261,7 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config,
     public_submodules_->echo_control_mobile =
         new EchoControlMobileImpl(this, &crit_render_, &crit_capture_);
     public_submodules_->gain_control =
-        new GainControlImpl(this, &crit_capture_, &crit_capture_);
+        new GainControlImpl(this, &crit_render_, &crit_capture_);
     public_submodules_->high_pass_filter.reset(
         new HighPassFilterImpl(&crit_capture_));
     public_submodules_->level_estimator.reset(
@@ -327,6 +349,17 @@ int AudioProcessingImpl::MaybeInitializeRender(
 
 int AudioProcessingImpl::MaybeInitializeCapture(
     const ProcessingConfig& processing_config) {
+  {
+    // The formats are only written while holding both locks, so the capture
+    // lock suffices for checking them. This avoids waiting for the render
+    // thread on every call when no reinitialization is needed.
+    rtc::CritScope cs_capture(&crit_capture_);
+    if (processing_config == formats_.api_format) {
+      return kNoError;
+    }
+  }
+
+  rtc::CritScope cs_render(&crit_render_);
   return MaybeInitialize(processing_config);
 }
 
@@ -353,12 +386,12 @@ int AudioProcessingImpl::InitializeLocked() {
           ? formats_.rev_proc_format.num_frames()
           : formats_.api_format.reverse_output_stream().num_frames();
   if (formats_.api_format.reverse_input_stream().num_channels() > 0) {
-    render_.render_audio.reset(new AudioBuffer(
+    ResetOrCreateAudioBuffer(
         formats_.api_format.reverse_input_stream().num_frames(),
         formats_.api_format.reverse_input_stream().num_channels(),
         formats_.rev_proc_format.num_frames(),
         formats_.rev_proc_format.num_channels(),
-        rev_audio_buffer_out_num_frames));
+        rev_audio_buffer_out_num_frames, &render_.render_audio);
     if (rev_conversion_needed()) {
       render_.render_converter = AudioConverter::Create(
           formats_.api_format.reverse_input_stream().num_channels(),
@@ -372,12 +405,12 @@ int AudioProcessingImpl::InitializeLocked() {
     render_.render_audio.reset(nullptr);
     render_.render_converter.reset(nullptr);
   }
-  capture_.capture_audio.reset(
-      new AudioBuffer(formats_.api_format.input_stream().num_frames(),
-                      formats_.api_format.input_stream().num_channels(),
-                      capture_nonlocked_.fwd_proc_format.num_frames(),
-                      fwd_audio_buffer_channels,
-                      formats_.api_format.output_stream().num_frames()));
+  ResetOrCreateAudioBuffer(formats_.api_format.input_stream().num_frames(),
+                           formats_.api_format.input_stream().num_channels(),
+                           capture_nonlocked_.fwd_proc_format.num_frames(),
+                           fwd_audio_buffer_channels,
+                           formats_.api_format.output_stream().num_frames(),
+                           &capture_.capture_audio);
 
   // Initialize all components.
   for (auto item : private_submodules_->component_list) {
@@ -611,11 +644,9 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   processing_config.input_stream() = input_config;
   processing_config.output_stream() = output_config;
 
-  {
-    // Do conditional reinitialization.
-    rtc::CritScope cs_render(&crit_render_);
-    RETURN_ON_ERR(MaybeInitializeCapture(processing_config));
-  }
+  // Do conditional reinitialization.
+  RETURN_ON_ERR(MaybeInitializeCapture(processing_config));
+
   rtc::CritScope cs_capture(&crit_capture_);
   assert(processing_config.input_stream().num_frames() ==
          formats_.api_format.input_stream().num_frames());
@@ -701,11 +732,9 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   processing_config.output_stream().set_sample_rate_hz(frame->sample_rate_hz_);
   processing_config.output_stream().set_num_channels(frame->num_channels_);
 
-  {
-    // Do conditional reinitialization.
-    rtc::CritScope cs_render(&crit_render_);
-    RETURN_ON_ERR(MaybeInitializeCapture(processing_config));
-  }
+  // Do conditional reinitialization.
+  RETURN_ON_ERR(MaybeInitializeCapture(processing_config));
+
   rtc::CritScope cs_capture(&crit_capture_);
   if (frame->samples_per_channel_ !=
       formats_.api_format.input_stream().num_frames()) {
@@ -983,10 +1012,6 @@ int AudioProcessingImpl::ProcessReverseStreamLocked() {
   }
 
   if (constants_.intelligibility_enabled) {
-    // Currently run in single-threaded mode when the intelligibility
-    // enhancer is activated.
-    // TODO(peah): Fix to be properly multi-threaded.
-    rtc::CritScope cs(&crit_capture_);
     public_submodules_->intelligibility_enhancer->ProcessRenderAudio(
         ra->split_channels_f(kBand0To8kHz), capture_nonlocked_.split_rate,
         ra->num_channels());
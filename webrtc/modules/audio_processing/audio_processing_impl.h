@@ -155,7 +155,8 @@ class AudioProcessingImpl : public AudioProcessing {
   // are needed is done while holding the render lock only, thereby avoiding
   // that the capture thread blocks the render thread.
   // The struct is modified in a single-threaded manner by holding both the
-  // render and capture locks.
+  // render and capture locks. The capture thread does its check while holding
+  // the capture lock only, so that it does not block on the render thread.
   int MaybeInitialize(const ProcessingConfig& config)
       EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
 
@@ -163,7 +164,7 @@ class AudioProcessingImpl : public AudioProcessing {
       EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
 
   int MaybeInitializeCapture(const ProcessingConfig& processing_config)
-      EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
+      LOCKS_EXCLUDED(crit_render_);
 
   // Method for checking for the need of conversion. Accesses the formats
   // structs in a read manner but the requirement for the render lock to be held
@@ -20,10 +20,16 @@
 #include "webrtc/base/platform_thread.h"
 #include "webrtc/base/random.h"
 #include "webrtc/base/safe_conversions.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/config.h"
+#include "webrtc/modules/audio_processing/aecm/echo_control_mobile.h"
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE)
+#include "webrtc/modules/audio_processing/ns/noise_suppression.h"
+#endif
 #include "webrtc/modules/audio_processing/test/test_utils.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/testsupport/perf_test.h"
@@ -709,6 +715,108 @@ bool TimedThreadApiProcessor::Process() {
 
 const float CallSimulator::kRenderInputFloatLevel = 0.5f;
 const float CallSimulator::kCaptureInputFloatLevel = 0.03125f;
+
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE)
+// Runs the float noise suppressor over 16 kHz noise with bursts of a harmonic
+// tone, with the per-frequency-bin loops picked for |cpu_info|. Returns the
+// average duration of a 10 ms frame in ns and the output in |output|.
+int64_t TimeNoiseSuppression(WebRtc_CPUInfo cpu_info,
+                             std::vector<float>* output) {
+  const uint32_t kSampleRateHz = 16000;
+  const size_t kFrameLength = 160;
+  const int kNumFrames = 3000;
+  const int kBurstFrames = 50;
+  const float kNoiseLevel = 300.f;
+  const float kToneLevel = 3000.f;
+  const float kToneFrequencyHz = 200.f;
+  const float kPi = 3.14159265358979f;
+
+  // The loops are picked when the suppressor is initialized.
+  const WebRtc_CPUInfo detected_cpu_info = WebRtc_GetCPUInfo;
+  NsHandle* ns = WebRtcNs_Create();
+  WebRtc_GetCPUInfo = cpu_info;
+  EXPECT_EQ(0, WebRtcNs_Init(ns, kSampleRateHz));
+  WebRtc_GetCPUInfo = detected_cpu_info;
+  EXPECT_EQ(0, WebRtcNs_set_policy(ns, 2));
+
+  Random random_generator(42U);
+  std::vector<float> frame(kFrameLength);
+  output->resize(kNumFrames * kFrameLength);
+  int64_t duration_ns = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const bool tone = (i / kBurstFrames) % 2 == 1;
+    for (size_t j = 0; j < kFrameLength; ++j) {
+      const float t = static_cast<float>(i * kFrameLength + j) / kSampleRateHz;
+      frame[j] = static_cast<float>(
+          random_generator.Gaussian(0, kNoiseLevel));
+      if (tone) {
+        for (int harmonic = 1; harmonic <= 5; ++harmonic) {
+          frame[j] += kToneLevel / harmonic *
+                      sinf(2.f * kPi * kToneFrequencyHz * harmonic * t);
+        }
+      }
+    }
+    const float* const input = &frame[0];
+    float* const out = &(*output)[i * kFrameLength];
+    const uint64_t start_ns = rtc::TimeNanos();
+    WebRtcNs_Analyze(ns, input);
+    WebRtcNs_Process(ns, &input, 1, &out);
+    duration_ns += rtc::TimeNanos() - start_ns;
+  }
+  WebRtcNs_Free(ns);
+  return duration_ns / kNumFrames;
+}
+#endif  // WEBRTC_AUDIOPROC_FLOAT_PROFILE
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Runs the mobile echo canceller over 16 kHz far-end noise and a near end
+// holding an attenuated, delayed copy of it, with the channel loops picked for
+// |cpu_info|. Returns the average duration of a 10 ms frame in ns and the
+// output in |output|.
+int64_t TimeEchoControlMobile(WebRtc_CPUInfo cpu_info,
+                              std::vector<int16_t>* output) {
+  const int32_t kSampleRateHz = 16000;
+  const size_t kFrameLength = 160;
+  const int kNumFrames = 3000;
+  const size_t kEchoDelay = 80;
+  const float kFarEndLevel = 3000.f;
+  const float kNearEndLevel = 100.f;
+
+  // The loops are picked when the canceller is initialized.
+  const WebRtc_CPUInfo detected_cpu_info = WebRtc_GetCPUInfo;
+  void* aecm = WebRtcAecm_Create();
+  WebRtc_GetCPUInfo = cpu_info;
+  EXPECT_EQ(0, WebRtcAecm_Init(aecm, kSampleRateHz));
+  WebRtc_GetCPUInfo = detected_cpu_info;
+
+  Random random_generator(42U);
+  std::vector<int16_t> far_end((kNumFrames + 1) * kFrameLength);
+  for (int16_t& sample : far_end) {
+    sample = rtc::saturated_cast<int16_t>(
+        random_generator.Gaussian(0, kFarEndLevel));
+  }
+  std::vector<int16_t> near_end(kFrameLength);
+  output->resize(kNumFrames * kFrameLength);
+  int64_t duration_ns = 0;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const size_t far_start = (i + 1) * kFrameLength;
+    const int16_t* const far_frame = &far_end[far_start];
+    for (size_t j = 0; j < kFrameLength; ++j) {
+      near_end[j] = rtc::saturated_cast<int16_t>(
+          far_end[far_start + j - kEchoDelay] / 4 +
+          random_generator.Gaussian(0, kNearEndLevel));
+    }
+    const uint64_t start_ns = rtc::TimeNanos();
+    EXPECT_EQ(0, WebRtcAecm_BufferFarend(aecm, far_frame, kFrameLength));
+    EXPECT_EQ(0, WebRtcAecm_Process(aecm, &near_end[0], nullptr,
+                                    &(*output)[i * kFrameLength],
+                                    kFrameLength, 0));
+    duration_ns += rtc::TimeNanos() - start_ns;
+  }
+  WebRtcAecm_Free(aecm);
+  return duration_ns / kNumFrames;
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
 }  // anonymous namespace
 
 TEST_P(CallSimulator, ApiCallDurationTest) {
@@ -721,4 +829,60 @@ INSTANTIATE_TEST_CASE_P(
     CallSimulator,
     ::testing::ValuesIn(SimulationConfig::GenerateSimulationConfigs()));
 
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE) && defined(WEBRTC_ARCH_X86_FAMILY)
+// Compares the float noise suppressor with the generic C and the SSE2
+// per-frequency-bin loops. The SSE2 loops use polynomial approximations of log
+// and exp, so the outputs are close but not bit-exact.
+TEST(NoiseSuppressionPerformanceTest, SimdLoops) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+
+  std::vector<float> c_output;
+  std::vector<float> simd_output;
+  const int64_t c_duration_ns =
+      TimeNoiseSuppression(WebRtc_GetCPUInfoNoASM, &c_output);
+  const int64_t simd_duration_ns =
+      TimeNoiseSuppression(WebRtc_GetCPUInfo, &simd_output);
+  webrtc::test::PrintResult("ns_frame_duration", "_16000Hz", "C",
+                            rtc::checked_cast<size_t>(c_duration_ns), "ns",
+                            false);
+  webrtc::test::PrintResult("ns_frame_duration", "_16000Hz", "SSE2",
+                            rtc::checked_cast<size_t>(simd_duration_ns), "ns",
+                            false);
+
+  // The output is in the 16 bit range, and peaks at about 5000 here.
+  const float kMaxDifference = 1.f;
+  ASSERT_EQ(c_output.size(), simd_output.size());
+  float max_difference = 0.f;
+  for (size_t i = 0; i < c_output.size(); ++i) {
+    max_difference =
+        std::max(max_difference, fabsf(c_output[i] - simd_output[i]));
+  }
+  EXPECT_LE(max_difference, kMaxDifference);
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Compares the mobile echo canceller with the generic C and the SSE2 channel
+// loops, which are bit-exact.
+TEST(EchoControlMobilePerformanceTest, SimdLoops) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+
+  std::vector<int16_t> c_output;
+  std::vector<int16_t> simd_output;
+  const int64_t c_duration_ns =
+      TimeEchoControlMobile(WebRtc_GetCPUInfoNoASM, &c_output);
+  const int64_t simd_duration_ns =
+      TimeEchoControlMobile(WebRtc_GetCPUInfo, &simd_output);
+  webrtc::test::PrintResult("aecm_frame_duration", "_16000Hz", "C",
+                            rtc::checked_cast<size_t>(c_duration_ns), "ns",
+                            false);
+  webrtc::test::PrintResult("aecm_frame_duration", "_16000Hz", "SSE2",
+                            rtc::checked_cast<size_t>(simd_duration_ns), "ns",
+                            false);
+  EXPECT_EQ(c_output, simd_output);
+}
+#endif
+
 }  // namespace webrtc
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/batched_audio_processing.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_processing/agc/legacy/gain_control.h"
+#include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/noise_suppression_impl.h"
+
+namespace webrtc {
+
+namespace {
+// The defaults of GainControlImpl. The digital modes never have their analog
+// level set, so it stays at the minimum.
+const int kMinimumCaptureLevel = 0;
+const int kMaximumCaptureLevel = 255;
+const int32_t kAnalogCaptureLevel = 0;
+}  // namespace
+
+BatchedAudioProcessing* BatchedAudioProcessing::Create(size_t num_streams,
+                                                       const Config& config) {
+  if (num_streams == 0)
+    return nullptr;
+  if (config.sample_rate_hz != AudioProcessing::kSampleRate8kHz &&
+      config.sample_rate_hz != AudioProcessing::kSampleRate16kHz &&
+      config.sample_rate_hz != AudioProcessing::kSampleRate32kHz &&
+      config.sample_rate_hz != AudioProcessing::kSampleRate48kHz) {
+    return nullptr;
+  }
+  if (config.gain_control_enabled &&
+      config.gain_control_mode == GainControl::kAdaptiveAnalog) {
+    return nullptr;
+  }
+  rtc::scoped_ptr<BatchedAudioProcessing> apm(
+      new BatchedAudioProcessing(num_streams, config));
+  if (!apm->Initialize())
+    return nullptr;
+  return apm.release();
+}
+
+BatchedAudioProcessing::BatchedAudioProcessing(size_t num_streams,
+                                               const Config& config)
+    : num_streams_(num_streams),
+      config_(config),
+      stream_config_(config.sample_rate_hz, num_streams),
+      saturated_(num_streams, false) {}
+
+BatchedAudioProcessing::~BatchedAudioProcessing() {
+  for (void* handle : agc_handles_)
+    WebRtcAgc_Free(handle);
+}
+
+bool BatchedAudioProcessing::Initialize() {
+  const size_t num_frames = stream_config_.num_frames();
+  audio_.reset(new AudioBuffer(num_frames, num_streams_, num_frames,
+                               num_streams_, num_frames));
+
+  if (config_.noise_suppression_enabled) {
+    noise_suppression_.reset(new NoiseSuppressionImpl(&crit_));
+    noise_suppression_->Initialize(num_streams_, config_.sample_rate_hz);
+    noise_suppression_->set_level(config_.noise_suppression_level);
+    // Creates a suppressor per stream.
+    noise_suppression_->Enable(true);
+  }
+
+  if (config_.gain_control_enabled) {
+    const int16_t mode = config_.gain_control_mode == GainControl::kFixedDigital
+                             ? kAgcModeFixedDigital
+                             : kAgcModeAdaptiveDigital;
+    WebRtcAgcConfig agc_config;
+    agc_config.targetLevelDbfs =
+        static_cast<int16_t>(config_.target_level_dbfs);
+    agc_config.compressionGaindB =
+        static_cast<int16_t>(config_.compression_gain_db);
+    agc_config.limiterEnable = config_.limiter_enabled;
+    for (size_t i = 0; i < num_streams_; ++i) {
+      void* handle = WebRtcAgc_Create();
+      if (!handle)
+        return false;
+      agc_handles_.push_back(handle);
+      if (WebRtcAgc_Init(handle, kMinimumCaptureLevel, kMaximumCaptureLevel,
+                         mode, config_.sample_rate_hz) != 0 ||
+          WebRtcAgc_set_config(handle, agc_config) != 0) {
+        return false;
+      }
+    }
+    capture_levels_.assign(num_streams_, kAnalogCaptureLevel);
+  }
+  return true;
+}
+
+bool BatchedAudioProcessing::needs_band_split() const {
+  return config_.sample_rate_hz == AudioProcessing::kSampleRate32kHz ||
+         config_.sample_rate_hz == AudioProcessing::kSampleRate48kHz;
+}
+
+int BatchedAudioProcessing::ProcessStreams(const float* const* src,
+                                           float* const* dest) {
+  if (!src || !dest)
+    return AudioProcessing::kNullPointerError;
+
+  AudioBuffer* audio = audio_.get();
+  audio->CopyFrom(src, stream_config_);
+  if (needs_band_split())
+    audio->SplitIntoFrequencyBands();
+
+  // Every step below runs over all streams before the next one, in the order
+  // of AudioProcessingImpl::ProcessStreamLocked().
+  const bool gain_control = !agc_handles_.empty();
+  if (gain_control &&
+      config_.gain_control_mode == GainControl::kAdaptiveDigital) {
+    for (size_t i = 0; i < num_streams_; ++i) {
+      if (WebRtcAgc_VirtualMic(agc_handles_[i], audio->split_bands(i),
+                               audio->num_bands(),
+                               audio->num_frames_per_band(),
+                               kAnalogCaptureLevel, &capture_levels_[i]) != 0) {
+        return AudioProcessing::kUnspecifiedError;
+      }
+    }
+  }
+
+  if (noise_suppression_) {
+    noise_suppression_->AnalyzeCaptureAudio(audio);
+    noise_suppression_->ProcessCaptureAudio(audio);
+  }
+
+  if (gain_control) {
+    for (size_t i = 0; i < num_streams_; ++i) {
+      int32_t capture_level_out = 0;
+      uint8_t saturation_warning = 0;
+      if (WebRtcAgc_Process(agc_handles_[i], audio->split_bands_const(i),
+                            audio->num_bands(), audio->num_frames_per_band(),
+                            audio->split_bands(i), capture_levels_[i],
+                            &capture_level_out, 0, &saturation_warning) != 0) {
+        return AudioProcessing::kUnspecifiedError;
+      }
+      capture_levels_[i] = capture_level_out;
+      saturated_[i] = saturation_warning == 1;
+    }
+  }
+
+  if (needs_band_split())
+    audio->MergeFrequencyBands();
+  audio->CopyTo(stream_config_, dest);
+  return AudioProcessing::kNoError;
+}
+
+bool BatchedAudioProcessing::stream_is_saturated(size_t stream) const {
+  RTC_DCHECK_LT(stream, num_streams_);
+  return saturated_[stream];
+}
+
+}  // namespace webrtc
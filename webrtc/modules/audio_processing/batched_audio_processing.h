@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+
+namespace webrtc {
+
+class AudioBuffer;
+class NoiseSuppressionImpl;
+
+// Applies noise suppression and digital gain control to many independent mono
+// streams, e.g. the participants of a conference on a server, with one call
+// per 10 ms for all of them. The streams share one planar buffer, with a
+// channel per stream, and each processing step runs over all streams before
+// the next one starts, so that the code and tables of a step are only brought
+// into the cache once per call instead of once per stream.
+//
+// Each stream is processed as if by its own AudioProcessing instance with the
+// same configuration. The class is not thread-safe.
+class BatchedAudioProcessing {
+ public:
+  struct Config {
+    // 8000, 16000, 32000 or 48000.
+    int sample_rate_hz = 16000;
+    bool noise_suppression_enabled = true;
+    NoiseSuppression::Level noise_suppression_level =
+        NoiseSuppression::kModerate;
+    bool gain_control_enabled = true;
+    // kAdaptiveAnalog needs an analog level for every stream from the capture
+    // devices and is not supported.
+    GainControl::Mode gain_control_mode = GainControl::kAdaptiveDigital;
+    int target_level_dbfs = 3;
+    int compression_gain_db = 9;
+    bool limiter_enabled = true;
+  };
+
+  // Returns null if |config| is not supported.
+  static BatchedAudioProcessing* Create(size_t num_streams,
+                                        const Config& config);
+  ~BatchedAudioProcessing();
+
+  // Processes 10 ms of every stream. |src| and |dest| hold one channel per
+  // stream at the configured sample rate, and may point to the same data.
+  // Returns an AudioProcessing::Error.
+  int ProcessStreams(const float* const* src, float* const* dest);
+
+  size_t num_streams() const { return num_streams_; }
+
+  // Whether the gain control saturated stream |stream| in the last call.
+  bool stream_is_saturated(size_t stream) const;
+
+ private:
+  BatchedAudioProcessing(size_t num_streams, const Config& config);
+  bool Initialize();
+  bool needs_band_split() const;
+
+  const size_t num_streams_;
+  const Config config_;
+  const StreamConfig stream_config_;
+  rtc::scoped_ptr<AudioBuffer> audio_;
+
+  // Only taken by |noise_suppression_|, which expects a lock.
+  rtc::CriticalSection crit_;
+  rtc::scoped_ptr<NoiseSuppressionImpl> noise_suppression_;
+
+  // The gain control state of each stream.
+  std::vector<void*> agc_handles_;
+  std::vector<int32_t> capture_levels_;
+  std::vector<bool> saturated_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BatchedAudioProcessing);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_BATCHED_AUDIO_PROCESSING_H_
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/modules/audio_processing/batched_audio_processing.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumStreams = 3;
+const int kNumChunks = 200;
+
+// Fills 10 ms of each stream with a tone at a frequency of its own, a level
+// of its own and some noise.
+void GenerateChunk(int chunk, ChannelBuffer<float>* buffer) {
+  const int sample_rate_hz =
+      static_cast<int>(buffer->num_frames()) * 100;
+  for (size_t i = 0; i < buffer->num_channels(); ++i) {
+    float* samples = buffer->channels()[i];
+    const float frequency_hz = 300.f + 250.f * i;
+    const float amplitude = 0.05f * (i + 1);
+    uint32_t seed = static_cast<uint32_t>(chunk * 31 + i);
+    for (size_t j = 0; j < buffer->num_frames(); ++j) {
+      const size_t n = chunk * buffer->num_frames() + j;
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = (static_cast<float>(seed >> 16) / 65536.f - 0.5f);
+      samples[j] = amplitude * std::sin(2 * M_PI * frequency_hz * n /
+                                        sample_rate_hz) +
+                   0.01f * noise;
+    }
+  }
+}
+
+void ExpectStreamsAreIndependent(const BatchedAudioProcessing::Config& config) {
+  rtc::scoped_ptr<BatchedAudioProcessing> batch(
+      BatchedAudioProcessing::Create(kNumStreams, config));
+  ASSERT_TRUE(batch);
+  rtc::scoped_ptr<BatchedAudioProcessing> single[kNumStreams];
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    single[i].reset(BatchedAudioProcessing::Create(1, config));
+    ASSERT_TRUE(single[i]);
+  }
+
+  const size_t num_frames = config.sample_rate_hz / 100;
+  ChannelBuffer<float> batch_audio(num_frames, kNumStreams);
+  ChannelBuffer<float> single_audio(num_frames, kNumStreams);
+  for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+    GenerateChunk(chunk, &batch_audio);
+    GenerateChunk(chunk, &single_audio);
+    ASSERT_EQ(AudioProcessing::kNoError,
+              batch->ProcessStreams(batch_audio.channels(),
+                                    batch_audio.channels()));
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      float* stream = single_audio.channels()[i];
+      ASSERT_EQ(AudioProcessing::kNoError,
+                single[i]->ProcessStreams(&stream, &stream));
+    }
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      for (size_t j = 0; j < num_frames; ++j) {
+        ASSERT_EQ(single_audio.channels()[i][j], batch_audio.channels()[i][j])
+            << "chunk " << chunk << ", stream " << i << ", sample " << j;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BatchedAudioProcessingTest, RejectsUnsupportedConfigs) {
+  BatchedAudioProcessing::Config config;
+  EXPECT_FALSE(BatchedAudioProcessing::Create(0, config));
+
+  config.sample_rate_hz = 44100;
+  EXPECT_FALSE(BatchedAudioProcessing::Create(2, config));
+
+  config.sample_rate_hz = 16000;
+  config.gain_control_mode = GainControl::kAdaptiveAnalog;
+  EXPECT_FALSE(BatchedAudioProcessing::Create(2, config));
+
+  config.gain_control_enabled = false;
+  rtc::scoped_ptr<BatchedAudioProcessing> batch(
+      BatchedAudioProcessing::Create(2, config));
+  ASSERT_TRUE(batch);
+  EXPECT_EQ(2u, batch->num_streams());
+}
+
+TEST(BatchedAudioProcessingTest, StreamsAreIndependentAt16kHz) {
+  BatchedAudioProcessing::Config config;
+  ExpectStreamsAreIndependent(config);
+}
+
+TEST(BatchedAudioProcessingTest, StreamsAreIndependentAt48kHz) {
+  BatchedAudioProcessing::Config config;
+  config.sample_rate_hz = 48000;
+  config.noise_suppression_level = NoiseSuppression::kHigh;
+  config.gain_control_mode = GainControl::kFixedDigital;
+  ExpectStreamsAreIndependent(config);
+}
+
+TEST(BatchedAudioProcessingTest, MatchesAudioProcessing) {
+  BatchedAudioProcessing::Config config;
+  config.sample_rate_hz = 32000;
+  rtc::scoped_ptr<BatchedAudioProcessing> batch(
+      BatchedAudioProcessing::Create(kNumStreams, config));
+  ASSERT_TRUE(batch);
+
+  Config apm_config;
+  apm_config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+  rtc::scoped_ptr<AudioProcessing> apms[kNumStreams];
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    apms[i].reset(AudioProcessing::Create(apm_config));
+    ASSERT_TRUE(apms[i]);
+    ASSERT_EQ(AudioProcessing::kNoError,
+              apms[i]->noise_suppression()->Enable(true));
+    ASSERT_EQ(AudioProcessing::kNoError,
+              apms[i]->gain_control()->set_mode(GainControl::kAdaptiveDigital));
+    ASSERT_EQ(AudioProcessing::kNoError,
+              apms[i]->gain_control()->Enable(true));
+  }
+
+  const size_t num_frames = config.sample_rate_hz / 100;
+  const StreamConfig mono(config.sample_rate_hz, 1);
+  ChannelBuffer<float> batch_audio(num_frames, kNumStreams);
+  ChannelBuffer<float> apm_audio(num_frames, kNumStreams);
+  for (int chunk = 0; chunk < kNumChunks; ++chunk) {
+    GenerateChunk(chunk, &batch_audio);
+    GenerateChunk(chunk, &apm_audio);
+    ASSERT_EQ(AudioProcessing::kNoError,
+              batch->ProcessStreams(batch_audio.channels(),
+                                    batch_audio.channels()));
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      float* stream = apm_audio.channels()[i];
+      ASSERT_EQ(AudioProcessing::kNoError,
+                apms[i]->ProcessStream(&stream, mono, mono, &stream));
+    }
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      for (size_t j = 0; j < num_frames; ++j) {
+        ASSERT_EQ(apm_audio.channels()[i][j], batch_audio.channels()[i][j])
+            << "chunk " << chunk << ", stream " << i << ", sample " << j;
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -22,6 +22,11 @@ LOCAL_SRC_FILES := \
     covariance_matrix_generator.cc \
     nonlinear_beamformer.cc \
 
+ifeq ($(TARGET_ARCH),$(filter $(TARGET_ARCH),x86 x86_64))
+LOCAL_SRC_FILES += \
+    nonlinear_beamformer_sse2.cc
+endif
+
 # Flags passed to both C and C++ files.
 LOCAL_CFLAGS := \
     $(MY_WEBRTC_COMMON_DEFS)
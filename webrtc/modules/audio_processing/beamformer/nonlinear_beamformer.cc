@@ -20,6 +20,7 @@
 #include "webrtc/base/arraysize.h"
 #include "webrtc/common_audio/window_generator.h"
 #include "webrtc/modules/audio_processing/beamformer/covariance_matrix_generator.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 namespace {
@@ -194,8 +195,27 @@ NonlinearBeamformer::NonlinearBeamformer(
       away_radians_(std::min(
           static_cast<float>(M_PI),
           std::max(kMinAwayRadians,
-                   kAwaySlope * static_cast<float>(M_PI) / min_mic_spacing_))) {
+                   kAwaySlope * static_cast<float>(M_PI) / min_mic_spacing_))),
+      split_stride_((num_input_channels_ + 3) & ~static_cast<size_t>(3)),
+      split_eig_m_(2 * split_stride_, 0.f) {
   WindowGenerator::KaiserBesselDerived(kKbdAlpha, kFftSize, window_);
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  quadratic_forms_proc_ = QuadraticForms_SSE2;
+#else
+  quadratic_forms_proc_ =
+      WebRtc_GetCPUInfo(kSSE2) ? QuadraticForms_SSE2 : QuadraticForms_C;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  quadratic_forms_proc_ = QuadraticForms_NEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  quadratic_forms_proc_ = WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON
+                              ? QuadraticForms_NEON
+                              : QuadraticForms_C;
+#else
+  quadratic_forms_proc_ = QuadraticForms_C;
+#endif
 }
 
 void NonlinearBeamformer::Initialize(int chunk_size_ms, int sample_rate_hz) {
@@ -366,6 +386,59 @@ void NonlinearBeamformer::NormalizeCovMats() {
   }
 }
 
+void NonlinearBeamformer::InitSplitCovMats() {
+  const size_t num_mats = 1 + interf_angles_radians_.size();
+  const size_t mat_size = 2 * num_input_channels_ * split_stride_;
+  for (size_t i = 0; i < kNumFreqBins; ++i) {
+    split_cov_mats_[i].assign(num_mats * mat_size, 0.f);
+    for (size_t k = 0; k < num_mats; ++k) {
+      const complex_f* const* mat_els =
+          k == 0 ? target_cov_mats_[i].elements()
+                 : interf_cov_mats_[i][k - 1]->elements();
+      float* split_re = &split_cov_mats_[i][k * mat_size];
+      float* split_im = split_re + num_input_channels_ * split_stride_;
+      for (size_t j = 0; j < num_input_channels_; ++j) {
+        for (size_t l = 0; l < num_input_channels_; ++l) {
+          split_re[j * split_stride_ + l] = mat_els[j][l].real();
+          split_im[j * split_stride_ + l] = mat_els[j][l].imag();
+        }
+      }
+    }
+  }
+  cov_mat_norms_.resize(num_mats);
+}
+
+// Expands the product of Norm() into real arithmetic. With |vec| = a + ib and
+// |mat| = x + iy, column i of conjugate(|vec|) * |mat| is
+//   u_i = sum_j (a_j x_ji + b_j y_ji) + i (a_j y_ji - b_j x_ji),
+// and the norm is the real part of sum_i u_i (a_i + i b_i).
+void NonlinearBeamformer::QuadraticForms_C(const float* mats,
+                                           size_t num_mats,
+                                           size_t num_channels,
+                                           size_t stride,
+                                           const float* vec,
+                                           float* norms) {
+  const float* vec_re = vec;
+  const float* vec_im = vec + stride;
+  for (size_t k = 0; k < num_mats; ++k) {
+    const float* mat_re = mats + 2 * k * num_channels * stride;
+    const float* mat_im = mat_re + num_channels * stride;
+    float norm = 0.f;
+    for (size_t i = 0; i < num_channels; ++i) {
+      float u_re = 0.f;
+      float u_im = 0.f;
+      for (size_t j = 0; j < num_channels; ++j) {
+        const float x = mat_re[j * stride + i];
+        const float y = mat_im[j * stride + i];
+        u_re += vec_re[j] * x + vec_im[j] * y;
+        u_im += vec_re[j] * y - vec_im[j] * x;
+      }
+      norm += u_re * vec_re[i] - u_im * vec_im[i];
+    }
+    norms[k] = std::max(norm, 0.f);
+  }
+}
+
 void NonlinearBeamformer::ProcessChunk(const ChannelBuffer<float>& input,
                                        ChannelBuffer<float>* output) {
   RTC_DCHECK_EQ(input.num_channels(), num_input_channels_);
@@ -398,6 +471,7 @@ void NonlinearBeamformer::AimAt(const SphericalPointf& target_direction) {
   InitTargetCovMats();
   InitInterfCovMats();
   NormalizeCovMats();
+  InitSplitCovMats();
 }
 
 bool NonlinearBeamformer::IsInBeam(const SphericalPointf& spherical_point) {
@@ -426,7 +500,16 @@ void NonlinearBeamformer::ProcessAudioBlock(const complex_f* const* input,
       eig_m_.Scale(1.f / eig_m_norm_factor);
     }
 
-    float rxim = Norm(target_cov_mats_[i], eig_m_);
+    const complex_f* eig_m_els = eig_m_.elements()[0];
+    for (size_t j = 0; j < num_input_channels_; ++j) {
+      split_eig_m_[j] = eig_m_els[j].real();
+      split_eig_m_[split_stride_ + j] = eig_m_els[j].imag();
+    }
+    quadratic_forms_proc_(&split_cov_mats_[i][0], cov_mat_norms_.size(),
+                          num_input_channels_, split_stride_, &split_eig_m_[0],
+                          &cov_mat_norms_[0]);
+
+    float rxim = cov_mat_norms_[0];
     float ratio_rxiw_rxim = 0.f;
     if (rxim > 0.f) {
       ratio_rxiw_rxim = rxiws_[i] / rxim;
@@ -436,12 +519,12 @@ void NonlinearBeamformer::ProcessAudioBlock(const complex_f* const* input,
     rmw *= rmw;
     float rmw_r = rmw.real();
 
-    new_mask_[i] = CalculatePostfilterMask(*interf_cov_mats_[i][0],
+    new_mask_[i] = CalculatePostfilterMask(cov_mat_norms_[1],
                                            rpsiws_[i][0],
                                            ratio_rxiw_rxim,
                                            rmw_r);
     for (size_t j = 1; j < interf_angles_radians_.size(); ++j) {
-      float tmp_mask = CalculatePostfilterMask(*interf_cov_mats_[i][j],
+      float tmp_mask = CalculatePostfilterMask(cov_mat_norms_[j + 1],
                                                rpsiws_[i][j],
                                                ratio_rxiw_rxim,
                                                rmw_r);
@@ -459,13 +542,10 @@ void NonlinearBeamformer::ProcessAudioBlock(const complex_f* const* input,
   ApplyMasks(input, output);
 }
 
-float NonlinearBeamformer::CalculatePostfilterMask(
-    const ComplexMatrixF& interf_cov_mat,
-    float rpsiw,
-    float ratio_rxiw_rxim,
-    float rmw_r) {
-  float rpsim = Norm(interf_cov_mat, eig_m_);
-
+float NonlinearBeamformer::CalculatePostfilterMask(float rpsim,
+                                                   float rpsiw,
+                                                   float ratio_rxiw_rxim,
+                                                   float rmw_r) {
   float ratio = 0.f;
   if (rpsim > 0.f) {
     ratio = rpsiw / rpsim;
@@ -22,6 +22,8 @@
 #include "webrtc/modules/audio_processing/beamformer/beamformer.h"
 #include "webrtc/modules/audio_processing/beamformer/complex_matrix.h"
 #include "webrtc/system_wrappers/include/scoped_vector.h"
+#include "webrtc/test/testsupport/gtest_prod_util.h"
+#include "webrtc/typedefs.h"
 
 namespace webrtc {
 
@@ -75,6 +77,8 @@ class NonlinearBeamformer
  private:
   FRIEND_TEST_ALL_PREFIXES(NonlinearBeamformerTest,
                            InterfAnglesTakeAmbiguityIntoAccount);
+  FRIEND_TEST_ALL_PREFIXES(NonlinearBeamformerTest, QuadraticForms);
+  FRIEND_TEST_ALL_PREFIXES(NonlinearBeamformerTest, QuadraticFormsBenchmark);
 
   typedef Matrix<float> MatrixF;
   typedef ComplexMatrix<float> ComplexMatrixF;
@@ -88,10 +92,47 @@ class NonlinearBeamformer
   void InitDiffuseCovMats();
   void InitInterfCovMats();
   void NormalizeCovMats();
+  void InitSplitCovMats();
+
+  // Computes the norms conjugate(|vec|) * mat * transpose(|vec|), clamped to be
+  // non-negative, of the |num_mats| |num_channels| x |num_channels| matrices in
+  // |mats|. Each matrix is stored as its real part followed by its imaginary
+  // part, row by row, with rows of |stride| elements. |vec| holds the real
+  // part followed by the imaginary part, also |stride| elements each. |stride|
+  // is a multiple of 4, and the padding is zero. On x86 and ARM the
+  // underlying implementation is chosen at run time.
+  typedef void (*QuadraticFormsProc)(const float* mats,
+                                     size_t num_mats,
+                                     size_t num_channels,
+                                     size_t stride,
+                                     const float* vec,
+                                     float* norms);
+  static void QuadraticForms_C(const float* mats,
+                               size_t num_mats,
+                               size_t num_channels,
+                               size_t stride,
+                               const float* vec,
+                               float* norms);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void QuadraticForms_SSE2(const float* mats,
+                                  size_t num_mats,
+                                  size_t num_channels,
+                                  size_t stride,
+                                  const float* vec,
+                                  float* norms);
+#elif defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
+  static void QuadraticForms_NEON(const float* mats,
+                                  size_t num_mats,
+                                  size_t num_channels,
+                                  size_t stride,
+                                  const float* vec,
+                                  float* norms);
+#endif
 
   // Calculates postfilter masks that minimize the mean squared error of our
-  // estimation of the desired signal.
-  float CalculatePostfilterMask(const ComplexMatrixF& interf_cov_mat,
+  // estimation of the desired signal. |rpsim| is the norm of the interferer
+  // covariance matrix with respect to |eig_m_|.
+  float CalculatePostfilterMask(float rpsim,
                                 float rpsiw,
                                 float ratio_rxiw_rxim,
                                 float rmxi_r);
@@ -183,6 +224,16 @@ class NonlinearBeamformer
   // The microphone normalization factor.
   ComplexMatrixF eig_m_;
 
+  // The target covariance matrix followed by the interferer covariance
+  // matrices of each frequency bin, in the layout of QuadraticForms_C().
+  size_t split_stride_;
+  std::vector<float> split_cov_mats_[kNumFreqBins];
+  // |eig_m_| in the same layout.
+  std::vector<float> split_eig_m_;
+  // The norms of the matrices in |split_cov_mats_| for one bin.
+  std::vector<float> cov_mat_norms_;
+  QuadraticFormsProc quadratic_forms_proc_;
+
   // For processing the high-frequency input signal.
   float high_pass_postfilter_mask_;
 
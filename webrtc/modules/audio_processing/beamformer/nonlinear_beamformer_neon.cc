@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer.h"
+
+#include <arm_neon.h>
+
+#include <algorithm>
+
+namespace webrtc {
+
+// Computes four columns of conjugate(|vec|) * mat at a time. The zero padding
+// of the rows and of |vec| makes the padded columns contribute nothing.
+void NonlinearBeamformer::QuadraticForms_NEON(const float* mats,
+                                              size_t num_mats,
+                                              size_t num_channels,
+                                              size_t stride,
+                                              const float* vec,
+                                              float* norms) {
+  const float* vec_re = vec;
+  const float* vec_im = vec + stride;
+  for (size_t k = 0; k < num_mats; ++k) {
+    const float* mat_re = mats + 2 * k * num_channels * stride;
+    const float* mat_im = mat_re + num_channels * stride;
+    float32x4_t m_norm = vdupq_n_f32(0.f);
+    for (size_t i = 0; i < stride; i += 4) {
+      float32x4_t m_u_re = vdupq_n_f32(0.f);
+      float32x4_t m_u_im = vdupq_n_f32(0.f);
+      for (size_t j = 0; j < num_channels; ++j) {
+        const float32x4_t m_x = vld1q_f32(&mat_re[j * stride + i]);
+        const float32x4_t m_y = vld1q_f32(&mat_im[j * stride + i]);
+        m_u_re = vmlaq_n_f32(m_u_re, m_x, vec_re[j]);
+        m_u_re = vmlaq_n_f32(m_u_re, m_y, vec_im[j]);
+        m_u_im = vmlaq_n_f32(m_u_im, m_y, vec_re[j]);
+        m_u_im = vmlsq_n_f32(m_u_im, m_x, vec_im[j]);
+      }
+      m_norm = vmlaq_f32(m_norm, m_u_re, vld1q_f32(&vec_re[i]));
+      m_norm = vmlsq_f32(m_norm, m_u_im, vld1q_f32(&vec_im[i]));
+    }
+    // Horizontal sum.
+    const float32x2_t m_sum =
+        vadd_f32(vget_low_f32(m_norm), vget_high_f32(m_norm));
+    const float norm = vget_lane_f32(vpadd_f32(m_sum, m_sum), 0);
+    norms[k] = std::max(norm, 0.f);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer.h"
+
+#include <xmmintrin.h>
+
+#include <algorithm>
+
+namespace webrtc {
+
+// Computes four columns of conjugate(|vec|) * mat at a time. The zero padding
+// of the rows and of |vec| makes the padded columns contribute nothing.
+void NonlinearBeamformer::QuadraticForms_SSE2(const float* mats,
+                                              size_t num_mats,
+                                              size_t num_channels,
+                                              size_t stride,
+                                              const float* vec,
+                                              float* norms) {
+  const float* vec_re = vec;
+  const float* vec_im = vec + stride;
+  for (size_t k = 0; k < num_mats; ++k) {
+    const float* mat_re = mats + 2 * k * num_channels * stride;
+    const float* mat_im = mat_re + num_channels * stride;
+    __m128 m_norm = _mm_setzero_ps();
+    for (size_t i = 0; i < stride; i += 4) {
+      __m128 m_u_re = _mm_setzero_ps();
+      __m128 m_u_im = _mm_setzero_ps();
+      for (size_t j = 0; j < num_channels; ++j) {
+        const __m128 m_x = _mm_loadu_ps(&mat_re[j * stride + i]);
+        const __m128 m_y = _mm_loadu_ps(&mat_im[j * stride + i]);
+        const __m128 m_a = _mm_set1_ps(vec_re[j]);
+        const __m128 m_b = _mm_set1_ps(vec_im[j]);
+        m_u_re = _mm_add_ps(
+            m_u_re, _mm_add_ps(_mm_mul_ps(m_a, m_x), _mm_mul_ps(m_b, m_y)));
+        m_u_im = _mm_add_ps(
+            m_u_im, _mm_sub_ps(_mm_mul_ps(m_a, m_y), _mm_mul_ps(m_b, m_x)));
+      }
+      m_norm = _mm_add_ps(
+          m_norm, _mm_sub_ps(_mm_mul_ps(m_u_re, _mm_loadu_ps(&vec_re[i])),
+                             _mm_mul_ps(m_u_im, _mm_loadu_ps(&vec_im[i]))));
+    }
+    // Horizontal sum.
+    m_norm = _mm_add_ps(m_norm, _mm_movehl_ps(m_norm, m_norm));
+    m_norm = _mm_add_ss(m_norm, _mm_shuffle_ps(m_norm, m_norm, 1));
+    float norm;
+    _mm_store_ss(&norm, m_norm);
+    norms[k] = std::max(norm, 0.f);
+  }
+}
+
+}  // namespace webrtc
@@ -14,8 +14,14 @@
 #include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer.h"
 
 #include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+#include "webrtc/system_wrappers/include/stringize_macros.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
 
 namespace webrtc {
 namespace {
@@ -48,6 +54,31 @@ void AimAndVerify(NonlinearBeamformer* bf, float target_azimuth_radians) {
   Verify(bf, target_azimuth_radians);
 }
 
+// A five microphone array, so that the split covariance matrices are padded.
+std::vector<Point> CreatePaddedArrayGeometry() {
+  std::vector<Point> array_geometry;
+  array_geometry.push_back(Point(-0.1f, 0.f, 0.f));
+  array_geometry.push_back(Point(0.f, 0.f, 0.f));
+  array_geometry.push_back(Point(0.2f, 0.f, 0.f));
+  array_geometry.push_back(Point(0.1f, 0.f, 0.2f));
+  array_geometry.push_back(Point(0.f, 0.f, -0.1f));
+  return array_geometry;
+}
+
+// Fills the split layout of a vector of unit norm.
+void FillSplitVector(size_t num_channels, size_t stride, float* vec) {
+  float sum_squares = 0.f;
+  for (size_t i = 0; i < num_channels; ++i) {
+    vec[i] = 0.1f * (i + 1);
+    vec[stride + i] = 0.05f * (static_cast<float>(num_channels) - 2.f * i);
+    sum_squares += vec[i] * vec[i] + vec[stride + i] * vec[stride + i];
+  }
+  for (size_t i = 0; i < num_channels; ++i) {
+    vec[i] /= sqrtf(sum_squares);
+    vec[stride + i] /= sqrtf(sum_squares);
+  }
+}
+
 }  // namespace
 
 TEST(NonlinearBeamformerTest, AimingModifiesBeam) {
@@ -144,4 +175,99 @@ TEST(NonlinearBeamformerTest, InterfAnglesTakeAmbiguityIntoAccount) {
   }
 }
 
+// Define platform independent function name for QuadraticForms* tests.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#define QUADRATIC_FORMS_FUNC QuadraticForms_SSE2
+#elif defined(WEBRTC_ARCH_ARM_V7)
+#define QUADRATIC_FORMS_FUNC QuadraticForms_NEON
+#endif
+
+TEST(NonlinearBeamformerTest, QuadraticForms) {
+  NonlinearBeamformer bf(CreatePaddedArrayGeometry());
+  bf.Initialize(kChunkSizeMs, kSampleRateHz);
+  const size_t num_channels = bf.num_input_channels_;
+  const size_t stride = bf.split_stride_;
+  const size_t num_mats = bf.cov_mat_norms_.size();
+  ASSERT_EQ(8u, stride);
+  ASSERT_EQ(1 + bf.interf_angles_radians_.size(), num_mats);
+
+  std::vector<float> vec(2 * stride, 0.f);
+  FillSplitVector(num_channels, stride, &vec[0]);
+  std::vector<float> norms(num_mats);
+  std::vector<float> optimized_norms(num_mats);
+  for (size_t i = 0; i < NonlinearBeamformer::kNumFreqBins; ++i) {
+    NonlinearBeamformer::QuadraticForms_C(&bf.split_cov_mats_[i][0], num_mats,
+                                          num_channels, stride, &vec[0],
+                                          &norms[0]);
+
+    // Compare the target norm to the complex arithmetic it replaces.
+    const complex<float>* const* mat = bf.target_cov_mats_[i].elements();
+    complex<float> expected = 0.f;
+    for (size_t j = 0; j < num_channels; ++j) {
+      complex<float> u = 0.f;
+      for (size_t k = 0; k < num_channels; ++k) {
+        u += conj(complex<float>(vec[k], vec[stride + k])) * mat[k][j];
+      }
+      expected += u * complex<float>(vec[j], vec[stride + j]);
+    }
+    EXPECT_NEAR(std::max(expected.real(), 0.f), norms[0], 1e-5f);
+
+#if defined(QUADRATIC_FORMS_FUNC)
+    NonlinearBeamformer::QUADRATIC_FORMS_FUNC(&bf.split_cov_mats_[i][0],
+                                              num_mats, num_channels, stride,
+                                              &vec[0], &optimized_norms[0]);
+    for (size_t j = 0; j < num_mats; ++j) {
+      EXPECT_NEAR(norms[j], optimized_norms[j], 1e-5f);
+    }
+#endif
+  }
+}
+
+// Benchmark for the QuadraticForms() methods, over all frequency bins.
+TEST(NonlinearBeamformerTest, QuadraticFormsBenchmark) {
+  const int kIterations = 1000;
+  NonlinearBeamformer bf(CreatePaddedArrayGeometry());
+  bf.Initialize(kChunkSizeMs, kSampleRateHz);
+  const size_t num_channels = bf.num_input_channels_;
+  const size_t stride = bf.split_stride_;
+  const size_t num_mats = bf.cov_mat_norms_.size();
+  std::vector<float> vec(2 * stride, 0.f);
+  FillSplitVector(num_channels, stride, &vec[0]);
+  std::vector<float> norms(num_mats);
+  printf("Benchmarking %d iterations:\n", kIterations);
+
+  TickTime start = TickTime::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < NonlinearBeamformer::kNumFreqBins; ++j) {
+      NonlinearBeamformer::QuadraticForms_C(&bf.split_cov_mats_[j][0],
+                                            num_mats, num_channels, stride,
+                                            &vec[0], &norms[0]);
+    }
+  }
+  double total_time_c_us = (TickTime::Now() - start).Microseconds();
+  printf("QuadraticForms_C took %.2fms.\n", total_time_c_us / 1000);
+
+#if defined(QUADRATIC_FORMS_FUNC)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  ASSERT_TRUE(WebRtc_GetCPUInfo(kSSE2));
+#elif defined(WEBRTC_ARCH_ARM_V7)
+  ASSERT_TRUE(WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON);
+#endif
+  start = TickTime::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    for (size_t j = 0; j < NonlinearBeamformer::kNumFreqBins; ++j) {
+      NonlinearBeamformer::QUADRATIC_FORMS_FUNC(&bf.split_cov_mats_[j][0],
+                                                num_mats, num_channels, stride,
+                                                &vec[0], &norms[0]);
+    }
+  }
+  double total_time_optimized_us = (TickTime::Now() - start).Microseconds();
+  printf(STRINGIZE(QUADRATIC_FORMS_FUNC) " took %.2fms; which is %.2fx "
+         "faster than QuadraticForms_C.\n", total_time_optimized_us / 1000,
+         total_time_c_us / total_time_optimized_us);
+#endif
+}
+
+#undef QUADRATIC_FORMS_FUNC
+
 }  // namespace webrtc
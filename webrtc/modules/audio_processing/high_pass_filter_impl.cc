@@ -22,10 +22,13 @@ const int16_t kFilterCoefficients[5] = {4012, -8024, 4012, 8002, -3913};
 
 class HighPassFilterImpl::BiquadFilter {
  public:
-  explicit BiquadFilter(int sample_rate_hz) :
-      ba_(sample_rate_hz == AudioProcessing::kSampleRate8kHz ?
-          kFilterCoefficients8kHz : kFilterCoefficients)
-  {
+  explicit BiquadFilter(int sample_rate_hz) {
+    Initialize(sample_rate_hz);
+  }
+
+  void Initialize(int sample_rate_hz) {
+    ba_ = sample_rate_hz == AudioProcessing::kSampleRate8kHz ?
+        kFilterCoefficients8kHz : kFilterCoefficients;
     Reset();
   }
 
@@ -80,7 +83,7 @@ class HighPassFilterImpl::BiquadFilter {
   }
 
  private:
-  const int16_t* const ba_ = nullptr;
+  const int16_t* ba_ = nullptr;
   int16_t x_[2];
   int16_t y_[4];
 };
@@ -93,12 +96,17 @@ HighPassFilterImpl::HighPassFilterImpl(rtc::CriticalSection* crit)
 HighPassFilterImpl::~HighPassFilterImpl() {}
 
 void HighPassFilterImpl::Initialize(size_t channels, int sample_rate_hz) {
-  std::vector<rtc::scoped_ptr<BiquadFilter>> new_filters(channels);
+  rtc::CritScope cs(crit_);
+  // Reinitialize the existing filters in place and only allocate the missing
+  // ones.
+  filters_.resize(channels);
   for (size_t i = 0; i < channels; i++) {
-    new_filters[i].reset(new BiquadFilter(sample_rate_hz));
+    if (filters_[i]) {
+      filters_[i]->Initialize(sample_rate_hz);
+    } else {
+      filters_[i].reset(new BiquadFilter(sample_rate_hz));
+    }
   }
-  rtc::CritScope cs(crit_);
-  filters_.swap(new_filters);
 }
 
 void HighPassFilterImpl::ProcessCaptureAudio(AudioBuffer* audio) {
@@ -38,6 +38,8 @@ const float kConfigRho = 0.02f;  // Default production and interpretation SNR.
 const float kKbdAlpha = 1.5f;
 const float kLambdaBot = -1.0f;      // Extreme values in bisection
 const float kLambdaTop = -10e-18f;  // search for lamda.
+// Capture chunks the noise estimate can run ahead of the render side.
+const size_t kMaxNumNoiseEstimatesToBuffer = 100;
 
 }  // namespace
 
@@ -56,11 +58,13 @@ void IntelligibilityEnhancer::TransformCallback::ProcessAudioBlock(
     const complex<float>* const* in_block,
     size_t in_channels,
     size_t frames,
-    size_t /* out_channels */,
+    size_t out_channels,
     complex<float>* const* out_block) {
   RTC_DCHECK_EQ(parent_->freqs_, frames);
   for (size_t i = 0; i < in_channels; ++i) {
-    parent_->DispatchAudio(source_, in_block[i], out_block[i]);
+    // The capture stream is analyzed only and has no output channels.
+    parent_->DispatchAudio(source_, in_block[i],
+                           i < out_channels ? out_block[i] : nullptr);
   }
 }
 
@@ -89,6 +93,10 @@ IntelligibilityEnhancer::IntelligibilityEnhancer(const Config& config)
                       config.var_type,
                       config.var_window_size,
                       config.var_decay_rate),
+      render_noise_variance_(freqs_, 0.f),
+      capture_noise_variance_(freqs_, 0.f),
+      noise_variance_queue_(kMaxNumNoiseEstimatesToBuffer,
+                            std::vector<float>(freqs_, 0.f)),
       filtered_clear_var_(new float[bank_size_]),
       filtered_noise_var_(new float[bank_size_]),
       filter_bank_(bank_size_),
@@ -97,7 +105,6 @@ IntelligibilityEnhancer::IntelligibilityEnhancer(const Config& config)
       gains_eq_(new float[bank_size_]),
       gain_applier_(freqs_, config.gain_change_limit),
       temp_render_out_buffer_(chunk_length_, num_render_channels_),
-      temp_capture_out_buffer_(chunk_length_, num_capture_channels_),
       kbd_window_(new float[window_size_]),
       render_callback_(this, AudioSource::kRenderStream),
       capture_callback_(this, AudioSource::kCaptureStream),
@@ -123,8 +130,8 @@ IntelligibilityEnhancer::IntelligibilityEnhancer(const Config& config)
       num_render_channels_, num_render_channels_, chunk_length_,
       kbd_window_.get(), window_size_, window_size_ / 2, &render_callback_));
   capture_mangler_.reset(new LappedTransform(
-      num_capture_channels_, num_capture_channels_, chunk_length_,
-      kbd_window_.get(), window_size_, window_size_ / 2, &capture_callback_));
+      num_capture_channels_, 0, chunk_length_, kbd_window_.get(), window_size_,
+      window_size_ / 2, &capture_callback_));
 }
 
 void IntelligibilityEnhancer::ProcessRenderAudio(float* const* audio,
@@ -133,6 +140,10 @@ void IntelligibilityEnhancer::ProcessRenderAudio(float* const* audio,
   RTC_CHECK_EQ(sample_rate_hz_, sample_rate_hz);
   RTC_CHECK_EQ(num_render_channels_, num_channels);
 
+  // Only the most recent noise estimate is of interest.
+  while (noise_variance_queue_.Remove(&render_noise_variance_)) {
+  }
+
   if (active_) {
     render_mangler_->ProcessChunk(audio, temp_render_out_buffer_.channels());
   }
@@ -151,7 +162,14 @@ void IntelligibilityEnhancer::AnalyzeCaptureAudio(float* const* audio,
   RTC_CHECK_EQ(sample_rate_hz_, sample_rate_hz);
   RTC_CHECK_EQ(num_capture_channels_, num_channels);
 
-  capture_mangler_->ProcessChunk(audio, temp_capture_out_buffer_.channels());
+  capture_mangler_->ProcessChunk(audio, nullptr);
+
+  std::copy(noise_variance_.variance(), noise_variance_.variance() + freqs_,
+            capture_noise_variance_.begin());
+  if (!noise_variance_queue_.Insert(&capture_noise_variance_)) {
+    // The render side has fallen behind. Dropping this estimate is harmless,
+    // as it would be superseded by the next one anyway.
+  }
 }
 
 void IntelligibilityEnhancer::DispatchAudio(
@@ -195,7 +213,7 @@ void IntelligibilityEnhancer::ProcessClearBlock(const complex<float>* in_block,
 
 void IntelligibilityEnhancer::AnalyzeClearBlock(float power_target) {
   FilterVariance(clear_variance_.variance(), filtered_clear_var_.get());
-  FilterVariance(noise_variance_.variance(), filtered_noise_var_.get());
+  FilterVariance(&render_noise_variance_[0], filtered_noise_var_.get());
 
   SolveForGainsGivenLambda(kLambdaTop, start_freq_, gains_eq_.get());
   const float power_top =
@@ -21,6 +21,7 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_audio/lapped_transform.h"
 #include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/common_audio/swap_queue.h"
 #include "webrtc/modules/audio_processing/intelligibility/intelligibility_utils.h"
 
 namespace webrtc {
@@ -60,7 +61,9 @@ class IntelligibilityEnhancer {
   explicit IntelligibilityEnhancer(const Config& config);
   IntelligibilityEnhancer();  // Initialize with default config.
 
-  // Reads and processes chunk of noise stream in time domain.
+  // Reads and processes chunk of noise stream in time domain. May be called
+  // concurrently with ProcessRenderAudio(); the noise estimate is handed over
+  // to the render side through a queue.
   void AnalyzeCaptureAudio(float* const* audio,
                            int sample_rate_hz,
                            size_t num_channels);
@@ -153,6 +156,10 @@ class IntelligibilityEnhancer {
 
   intelligibility::VarianceArray clear_variance_;
   intelligibility::VarianceArray noise_variance_;
+  // Noise variance as last received from the capture side.
+  std::vector<float> render_noise_variance_;
+  std::vector<float> capture_noise_variance_;
+  SwapQueue<std::vector<float>> noise_variance_queue_;
   rtc::scoped_ptr<float[]> filtered_clear_var_;
   rtc::scoped_ptr<float[]> filtered_noise_var_;
   std::vector<std::vector<float>> filter_bank_;
@@ -163,10 +170,10 @@ class IntelligibilityEnhancer {
   rtc::scoped_ptr<float[]> gains_eq_;  // Pre-filter modified gains.
   intelligibility::GainApplier gain_applier_;
 
-  // Destination buffers used to reassemble blocked chunks before overwriting
-  // the original input array with modifications.
+  // Destination buffer used to reassemble blocked chunks before overwriting
+  // the original input array with modifications. The capture stream is only
+  // analyzed, so it has no inverse transform and no such buffer.
   ChannelBuffer<float> temp_render_out_buffer_;
-  ChannelBuffer<float> temp_capture_out_buffer_;
 
   rtc::scoped_ptr<float[]> kbd_window_;
   TransformCallback render_callback_;
@@ -129,25 +129,29 @@ void VarianceArray::InfiniteStep(const complex<float>* data, bool skip_fudge) {
 
 // Compute the variance from the beginning, with exponential decaying of the
 // series data.
+// This is the default step for the intelligibility enhancer and runs on every
+// block of both streams, so the products of a value and its conjugate are
+// computed as the real numbers they are. Complex multiplications would go
+// through the NaN-handling library routine on every bin.
 void VarianceArray::DecayStep(const complex<float>* data, bool /*dummy*/) {
   array_mean_ = 0.0f;
   ++count_;
   for (size_t i = 0; i < num_freqs_; ++i) {
-    complex<float> sample = data[i];
-    sample = zerofudge(sample);
+    const complex<float> sample = zerofudge(data[i]);
+    const float power =
+        sample.real() * sample.real() + sample.imag() * sample.imag();
 
     if (count_ == 1) {
       running_mean_[i] = sample;
-      running_mean_sq_[i] = sample * std::conj(sample);
+      running_mean_sq_[i] = power;
       variance_[i] = 0.0f;
     } else {
-      complex<float> prev = running_mean_[i];
-      complex<float> prev2 = running_mean_sq_[i];
-      running_mean_[i] = decay_ * prev + (1.0f - decay_) * sample;
+      running_mean_[i] = decay_ * running_mean_[i] + (1.0f - decay_) * sample;
       running_mean_sq_[i] =
-          decay_ * prev2 + (1.0f - decay_) * sample * std::conj(sample);
-      variance_[i] = (running_mean_sq_[i] -
-                      running_mean_[i] * std::conj(running_mean_[i])).real();
+          decay_ * running_mean_sq_[i].real() + (1.0f - decay_) * power;
+      const complex<float> mean = running_mean_[i];
+      variance_[i] = running_mean_sq_[i].real() -
+                     (mean.real() * mean.real() + mean.imag() * mean.imag());
     }
 
     array_mean_ += (variance_[i] - array_mean_) / (i + 1);
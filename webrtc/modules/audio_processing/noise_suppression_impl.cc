@@ -33,12 +33,15 @@ class NoiseSuppressionImpl::Suppressor {
   explicit Suppressor(int sample_rate_hz) {
     state_ = NS_CREATE();
     RTC_CHECK(state_);
-    int error = NS_INIT(state_, sample_rate_hz);
-    RTC_DCHECK_EQ(0, error);
+    Initialize(sample_rate_hz);
   }
   ~Suppressor() {
     NS_FREE(state_);
   }
+  void Initialize(int sample_rate_hz) {
+    int error = NS_INIT(state_, sample_rate_hz);
+    RTC_DCHECK_EQ(0, error);
+  }
   NsState* state() { return state_; }
  private:
   NsState* state_ = nullptr;
@@ -56,14 +59,20 @@ void NoiseSuppressionImpl::Initialize(size_t channels, int sample_rate_hz) {
   rtc::CritScope cs(crit_);
   channels_ = channels;
   sample_rate_hz_ = sample_rate_hz;
-  std::vector<rtc::scoped_ptr<Suppressor>> new_suppressors;
-  if (enabled_) {
-    new_suppressors.resize(channels);
+  if (!enabled_) {
+    suppressors_.clear();
+  } else {
+    // Reinitialize the existing suppressors in place and only allocate the
+    // missing ones.
+    suppressors_.resize(channels);
     for (size_t i = 0; i < channels; i++) {
-      new_suppressors[i].reset(new Suppressor(sample_rate_hz));
+      if (suppressors_[i]) {
+        suppressors_[i]->Initialize(sample_rate_hz);
+      } else {
+        suppressors_[i].reset(new Suppressor(sample_rate_hz));
+      }
     }
   }
-  suppressors_.swap(new_suppressors);
   set_level(level_);
 }
 
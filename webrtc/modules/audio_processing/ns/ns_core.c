@@ -18,6 +18,15 @@
 #include "webrtc/modules/audio_processing/ns/noise_suppression.h"
 #include "webrtc/modules/audio_processing/ns/ns_core.h"
 #include "webrtc/modules/audio_processing/ns/windows_private.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+WebRtcNsComputeSpectralFlatness WebRtcNs_ComputeSpectralFlatness;
+WebRtcNsComputeSnr WebRtcNs_ComputeSnr;
+WebRtcNsUpdateLogLrt WebRtcNs_UpdateLogLrt;
+WebRtcNsComputeSpeechProb WebRtcNs_ComputeSpeechProb;
+WebRtcNsComputeDdBasedWienerFilter WebRtcNs_ComputeDdBasedWienerFilter;
+
+static void InitFunctionPointers(void);
 
 // Set Feature Extraction Parameters.
 static void set_feature_extraction_parameters(NoiseSuppressionC* self) {
@@ -209,6 +218,8 @@ int WebRtcNs_InitCore(NoiseSuppressionC* self, uint32_t fs) {
   // Default mode.
   WebRtcNs_set_policy_core(self, 0);
 
+  InitFunctionPointers();
+
   self->initFlag = 1;
   return 0;
 }
@@ -520,8 +531,8 @@ static void FeatureParameterExtraction(NoiseSuppressionC* self, int flag) {
 // Compute spectral flatness on input spectrum.
 // |magnIn| is the magnitude spectrum.
 // Spectral flatness is returned in self->featureData[0].
-static void ComputeSpectralFlatness(NoiseSuppressionC* self,
-                                    const float* magnIn) {
+static void ComputeSpectralFlatnessC(NoiseSuppressionC* self,
+                                     const float* magnIn) {
   size_t i;
   size_t shiftLP = 1;  // Option to remove first bin(s) from spectral measures.
   float avgSpectralFlatnessNum, avgSpectralFlatnessDen, spectralTmp;
@@ -563,11 +574,11 @@ static void ComputeSpectralFlatness(NoiseSuppressionC* self,
 // Outputs:
 //   * |snrLocPrior| is the computed prior SNR.
 //   * |snrLocPost| is the computed post SNR.
-static void ComputeSnr(const NoiseSuppressionC* self,
-                       const float* magn,
-                       const float* noise,
-                       float* snrLocPrior,
-                       float* snrLocPost) {
+static void ComputeSnrC(const NoiseSuppressionC* self,
+                        const float* magn,
+                        const float* noise,
+                        float* snrLocPrior,
+                        float* snrLocPost) {
   size_t i;
 
   for (i = 0; i < self->magnLen; i++) {
@@ -633,6 +644,42 @@ static void ComputeSpectralDifference(NoiseSuppressionC* self,
       SPECT_DIFF_TAVG * (avgDiffNormMagn - self->featureData[4]);
 }
 
+// Update the time-smoothed log LRT factor and return its sum over frequencies.
+// |snrLocPrior| is the prior SNR for each frequency.
+// |snrLocPost| is the post SNR for each frequency.
+static float UpdateLogLrtC(NoiseSuppressionC* self,
+                           const float* snrLocPrior,
+                           const float* snrLocPost) {
+  size_t i;
+  float tmpFloat1, tmpFloat2, besselTmp;
+  float logLrtTimeAvgKsum = 0.0;
+
+  for (i = 0; i < self->magnLen; i++) {
+    tmpFloat1 = 1.f + 2.f * snrLocPrior[i];
+    tmpFloat2 = 2.f * snrLocPrior[i] / (tmpFloat1 + 0.0001f);
+    besselTmp = (snrLocPost[i] + 1.f) * tmpFloat2;
+    self->logLrtTimeAvg[i] +=
+        LRT_TAVG * (besselTmp - (float)log(tmpFloat1) - self->logLrtTimeAvg[i]);
+    logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
+  }
+  return logLrtTimeAvgKsum;
+}
+
+// Combine the prior model, through |gainPrior|, with the LR factor into the
+// final speech probability |probSpeechFinal|.
+static void ComputeSpeechProbC(const NoiseSuppressionC* self,
+                               float gainPrior,
+                               float* probSpeechFinal) {
+  size_t i;
+  float invLrt;
+
+  for (i = 0; i < self->magnLen; i++) {
+    invLrt = (float)exp(-self->logLrtTimeAvg[i]);
+    invLrt = (float)gainPrior * invLrt;
+    probSpeechFinal[i] = 1.f / (1.f + invLrt);
+  }
+}
+
 // Compute speech/noise probability.
 // Speech/noise probability is returned in |probSpeechFinal|.
 // |magn| is the input magnitude spectrum.
@@ -643,12 +690,11 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
                             float* probSpeechFinal,
                             const float* snrLocPrior,
                             const float* snrLocPost) {
-  size_t i;
   int sgnMap;
-  float invLrt, gainPrior, indPrior;
-  float logLrtTimeAvgKsum, besselTmp;
+  float gainPrior, indPrior;
+  float logLrtTimeAvgKsum;
   float indicator0, indicator1, indicator2;
-  float tmpFloat1, tmpFloat2;
+  float tmpFloat1;
   float weightIndPrior0, weightIndPrior1, weightIndPrior2;
   float threshPrior0, threshPrior1, threshPrior2;
   float widthPrior, widthPrior0, widthPrior1, widthPrior2;
@@ -673,15 +719,7 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
 
   // Compute feature based on average LR factor.
   // This is the average over all frequencies of the smooth log LRT.
-  logLrtTimeAvgKsum = 0.0;
-  for (i = 0; i < self->magnLen; i++) {
-    tmpFloat1 = 1.f + 2.f * snrLocPrior[i];
-    tmpFloat2 = 2.f * snrLocPrior[i] / (tmpFloat1 + 0.0001f);
-    besselTmp = (snrLocPost[i] + 1.f) * tmpFloat2;
-    self->logLrtTimeAvg[i] +=
-        LRT_TAVG * (besselTmp - (float)log(tmpFloat1) - self->logLrtTimeAvg[i]);
-    logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
-  }
+  logLrtTimeAvgKsum = WebRtcNs_UpdateLogLrt(self, snrLocPrior, snrLocPost);
   logLrtTimeAvgKsum = (float)logLrtTimeAvgKsum / (self->magnLen);
   self->featureData[3] = logLrtTimeAvgKsum;
   // Done with computation of LR factor.
@@ -742,11 +780,7 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
 
   // Final speech probability: combine prior model with LR factor:.
   gainPrior = (1.f - self->priorSpeechProb) / (self->priorSpeechProb + 0.0001f);
-  for (i = 0; i < self->magnLen; i++) {
-    invLrt = (float)exp(-self->logLrtTimeAvg[i]);
-    invLrt = (float)gainPrior * invLrt;
-    probSpeechFinal[i] = 1.f / (1.f + invLrt);
-  }
+  WebRtcNs_ComputeSpeechProb(self, gainPrior, probSpeechFinal);
 }
 
 // Update the noise features.
@@ -757,7 +791,7 @@ static void FeatureUpdate(NoiseSuppressionC* self,
                           const float* magn,
                           int updateParsFlag) {
   // Compute spectral flatness on input spectrum.
-  ComputeSpectralFlatness(self, magn);
+  WebRtcNs_ComputeSpectralFlatness(self, magn);
   // Compute difference of input spectrum with learned/estimated noise spectrum.
   ComputeSpectralDifference(self, magn);
   // Compute histograms for parameter decisions (thresholds and weights for
@@ -983,9 +1017,9 @@ static void Windowing(const float* window,
 //   * |magn| is the signal magnitude spectrum estimate.
 // Output:
 //   * |theFilter| is the frequency response of the computed Wiener filter.
-static void ComputeDdBasedWienerFilter(const NoiseSuppressionC* self,
-                                       const float* magn,
-                                       float* theFilter) {
+static void ComputeDdBasedWienerFilterC(const NoiseSuppressionC* self,
+                                        const float* magn,
+                                        float* theFilter) {
   size_t i;
   float snrPrior, previousEstimateStsa, currentEstimateStsa;
 
@@ -1007,6 +1041,29 @@ static void ComputeDdBasedWienerFilter(const NoiseSuppressionC* self,
   }  // End of loop over frequencies.
 }
 
+// Initialize function pointers, with the SSE2 or Neon versions where available.
+static void InitFunctionPointers(void) {
+  WebRtcNs_ComputeSpectralFlatness = ComputeSpectralFlatnessC;
+  WebRtcNs_ComputeSnr = ComputeSnrC;
+  WebRtcNs_UpdateLogLrt = UpdateLogLrtC;
+  WebRtcNs_ComputeSpeechProb = ComputeSpeechProbC;
+  WebRtcNs_ComputeDdBasedWienerFilter = ComputeDdBasedWienerFilterC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcNs_InitSse2();
+  }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  WebRtcNs_InitNeon();
+#elif defined(WEBRTC_DETECT_NEON)
+  if ((WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0) {
+    WebRtcNs_InitNeon();
+  }
+#endif
+}
+
 // Changes the aggressiveness of the noise suppression method.
 // |mode| = 0 is mild (6dB), |mode| = 1 is medium (10dB) and |mode| = 2 is
 // aggressive (15dB).
@@ -1170,7 +1227,7 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   }
 
   // Post and prior SNR needed for SpeechNoiseProb.
-  ComputeSnr(self, magn, noise, snrLocPrior, snrLocPost);
+  WebRtcNs_ComputeSnr(self, magn, noise, snrLocPrior, snrLocPost);
 
   FeatureUpdate(self, magn, updateParsFlag);
   SpeechNoiseProb(self, self->speechProb, snrLocPrior, snrLocPost);
@@ -1272,7 +1329,7 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
     }
   }
 
-  ComputeDdBasedWienerFilter(self, magn, theFilter);
+  WebRtcNs_ComputeDdBasedWienerFilter(self, magn, theFilter);
 
   for (i = 0; i < self->magnLen; i++) {
     // Flooring bottom.
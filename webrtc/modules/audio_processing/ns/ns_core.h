@@ -11,7 +11,10 @@
 #ifndef WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 #define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 
+#include <stddef.h>
+
 #include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/typedefs.h"
 
 typedef struct NSParaExtract_ {
   // Bin size of histogram.
@@ -184,6 +187,55 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
                           size_t num_bands,
                           float* const* outFrame);
 
+/****************************************************************************
+ * Some function pointers, for the per-frequency-bin loops shared by SSE2, ARM
+ * NEON and generic C code. They are set by WebRtcNs_InitCore().
+ */
+// Compute spectral flatness of |magnIn| into self->featureData[0].
+typedef void (*WebRtcNsComputeSpectralFlatness)(NoiseSuppressionC* self,
+                                                const float* magnIn);
+extern WebRtcNsComputeSpectralFlatness WebRtcNs_ComputeSpectralFlatness;
+
+// Compute prior and post SNR of |magn| given the |noise| estimate.
+typedef void (*WebRtcNsComputeSnr)(const NoiseSuppressionC* self,
+                                   const float* magn,
+                                   const float* noise,
+                                   float* snrLocPrior,
+                                   float* snrLocPost);
+extern WebRtcNsComputeSnr WebRtcNs_ComputeSnr;
+
+// Update the time-smoothed log LRT factor, self->logLrtTimeAvg, from the prior
+// and post SNR. Returns its sum over all frequency bins.
+typedef float (*WebRtcNsUpdateLogLrt)(NoiseSuppressionC* self,
+                                      const float* snrLocPrior,
+                                      const float* snrLocPost);
+extern WebRtcNsUpdateLogLrt WebRtcNs_UpdateLogLrt;
+
+// Combine the prior model, through |gainPrior|, with the LRT factor into the
+// final speech probability |probSpeechFinal|.
+typedef void (*WebRtcNsComputeSpeechProb)(const NoiseSuppressionC* self,
+                                          float gainPrior,
+                                          float* probSpeechFinal);
+extern WebRtcNsComputeSpeechProb WebRtcNs_ComputeSpeechProb;
+
+// Estimate prior SNR decision-directed and compute the Wiener filter
+// |theFilter|.
+typedef void (*WebRtcNsComputeDdBasedWienerFilter)(
+    const NoiseSuppressionC* self,
+    const float* magn,
+    float* theFilter);
+extern WebRtcNsComputeDdBasedWienerFilter WebRtcNs_ComputeDdBasedWienerFilter;
+
+// For the above function pointers, functions for generic platforms are defined
+// as static in file ns_core.c, while those for SSE2 and ARM Neon platforms are
+// defined in files ns_core_sse2.c and ns_core_neon.c.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcNs_InitSse2(void);
+#endif
+#if (defined WEBRTC_DETECT_NEON || defined WEBRTC_HAS_NEON)
+void WebRtcNs_InitNeon(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,341 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, neon version of the per-frequency-bin
+ * loops.
+ *
+ * Based on ns_core_sse2.c.
+ */
+
+#include <arm_neon.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/modules/audio_processing/ns/ns_core.h"
+
+// ARM64's arm_neon.h has already defined vdivq_f32.
+#if !defined (WEBRTC_ARCH_ARM64)
+static float32x4_t vdivq_f32(float32x4_t a, float32x4_t b) {
+  int i;
+  float32x4_t x = vrecpeq_f32(b);
+  // from arm documentation
+  // The Newton-Raphson iteration:
+  //     x[n+1] = x[n] * (2 - d * x[n])
+  // converges to (1/d) if x0 is the result of VRECPE applied to d.
+  //
+  // Note: The precision did not improve after 2 iterations.
+  for (i = 0; i < 2; i++) {
+    x = vmulq_f32(vrecpsq_f32(b, x), x);
+  }
+  // a/b = a*(1/b)
+  return vmulq_f32(a, x);
+}
+#endif  // WEBRTC_ARCH_ARM64
+
+// Natural logarithm of four positive floats, see mm_log_ps() in
+// ns_core_sse2.c.
+static float32x4_t vlogq_f32(float32x4_t a) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  int32x4_t exponent;
+  uint32x4_t mask;
+  float32x4_t e, tmp, x, y, z;
+
+  // Split |a| into a mantissa |x| in [0.5, 1) and an exponent |e|.
+  a = vmaxq_f32(a, vreinterpretq_f32_u32(vdupq_n_u32(0x00800000)));
+  exponent = vshrq_n_s32(vreinterpretq_s32_f32(a), 23);
+  x = vreinterpretq_f32_u32(
+      vorrq_u32(vandq_u32(vreinterpretq_u32_f32(a), vdupq_n_u32(~0x7f800000u)),
+                vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+  exponent = vsubq_s32(exponent, vdupq_n_s32(0x7f));
+  e = vaddq_f32(vcvtq_f32_s32(exponent), one);
+
+  // Move the mantissa to [sqrt(0.5), sqrt(2)) and subtract one.
+  mask = vcltq_f32(x, vdupq_n_f32(0.707106781186547524f));
+  tmp = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(x), mask));
+  x = vsubq_f32(x, one);
+  e = vsubq_f32(
+      e, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(one), mask)));
+  x = vaddq_f32(x, tmp);
+
+  // log(1 + x) = x - x^2 / 2 + x^3 * P(x).
+  z = vmulq_f32(x, x);
+  y = vdupq_n_f32(7.0376836292E-2f);
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(-1.1514610310E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.1676998740E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(-1.2420140846E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.4249322787E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(-1.6668057665E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(2.0000714765E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(-2.4999993993E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(3.3333331174E-1f));
+  y = vmulq_f32(vmulq_f32(y, x), z);
+
+  // Add e * log(2), with log(2) split in two for precision.
+  y = vaddq_f32(y, vmulq_f32(e, vdupq_n_f32(-2.12194440e-4f)));
+  y = vsubq_f32(y, vmulq_f32(z, vdupq_n_f32(0.5f)));
+  x = vaddq_f32(x, y);
+  return vaddq_f32(x, vmulq_f32(e, vdupq_n_f32(0.693359375f)));
+}
+
+// Exponential of four floats, see mm_exp_ps() in ns_core_sse2.c.
+static float32x4_t vexpq_f32(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  int32x4_t n;
+  uint32x4_t mask;
+  float32x4_t fx, tmp, y, z;
+
+  x = vminq_f32(x, vdupq_n_f32(88.3762626647949f));
+  x = vmaxq_f32(x, vdupq_n_f32(-88.3762626647949f));
+
+  // exp(x) = 2^n * exp(g), with n = floor(x / log(2) + 0.5) and
+  // g = x - n * log(2), the latter split in two for precision.
+  fx = vaddq_f32(vmulq_f32(x, vdupq_n_f32(1.44269504088896341f)),
+                 vdupq_n_f32(0.5f));
+  tmp = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+  mask = vandq_u32(vcgtq_f32(tmp, fx), vreinterpretq_u32_f32(one));
+  fx = vsubq_f32(tmp, vreinterpretq_f32_u32(mask));
+  x = vsubq_f32(x, vmulq_f32(fx, vdupq_n_f32(0.693359375f)));
+  x = vsubq_f32(x, vmulq_f32(fx, vdupq_n_f32(-2.12194440e-4f)));
+
+  // exp(g) = 1 + g + g^2 * P(g).
+  z = vmulq_f32(x, x);
+  y = vdupq_n_f32(1.9875691500E-4f);
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.3981999507E-3f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(8.3334519073E-3f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(4.1665795894E-2f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.6666665459E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(5.0000001201E-1f));
+  y = vaddq_f32(vaddq_f32(vmulq_f32(y, z), x), one);
+
+  // Build 2^n in the exponent bits.
+  n = vaddq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(0x7f));
+  n = vshlq_n_s32(n, 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(n));
+}
+
+__inline static float vsumq_f32(float32x4_t a) {
+  float32x2_t sum = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+  sum = vpadd_f32(sum, sum);
+  return vget_lane_f32(sum, 0);
+}
+
+static void ComputeSpectralFlatnessNEON(NoiseSuppressionC* self,
+                                        const float* magnIn) {
+  size_t i;
+  size_t shiftLP = 1;  // Option to remove first bin(s) from spectral measures.
+  float avgSpectralFlatnessNum, avgSpectralFlatnessDen, spectralTmp;
+  const float32x4_t vec_zero = vdupq_n_f32(0.f);
+  float32x4_t vec_sum = vdupq_n_f32(0.f);
+  uint32x4_t vec_positive = vdupq_n_u32(0xFFFFFFFF);
+  uint32x2_t positive;
+
+  // Compute spectral measures.
+  // For flatness.
+  avgSpectralFlatnessDen = self->sumMagn;
+  for (i = 0; i < shiftLP; i++) {
+    avgSpectralFlatnessDen -= magnIn[i];
+  }
+  // Compute log of ratio of the geometric to arithmetic mean: check for log(0)
+  // case.
+  for (i = shiftLP; i + 3 < self->magnLen; i += 4) {
+    const float32x4_t vec_magn = vld1q_f32(&magnIn[i]);
+    vec_positive = vandq_u32(vec_positive, vcgtq_f32(vec_magn, vec_zero));
+    vec_sum = vaddq_f32(vec_sum, vlogq_f32(vec_magn));
+  }
+  positive = vand_u32(vget_low_u32(vec_positive), vget_high_u32(vec_positive));
+  if ((vget_lane_u32(positive, 0) & vget_lane_u32(positive, 1)) == 0) {
+    self->featureData[0] -= SPECT_FL_TAVG * self->featureData[0];
+    return;
+  }
+  avgSpectralFlatnessNum = vsumq_f32(vec_sum);
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    if (magnIn[i] > 0.0) {
+      avgSpectralFlatnessNum += (float)log(magnIn[i]);
+    } else {
+      self->featureData[0] -= SPECT_FL_TAVG * self->featureData[0];
+      return;
+    }
+  }
+  // Normalize.
+  avgSpectralFlatnessDen = avgSpectralFlatnessDen / self->magnLen;
+  avgSpectralFlatnessNum = avgSpectralFlatnessNum / self->magnLen;
+
+  // Ratio and inverse log: check for case of log(0).
+  spectralTmp = (float)exp(avgSpectralFlatnessNum) / avgSpectralFlatnessDen;
+
+  // Time-avg update of spectral flatness feature.
+  self->featureData[0] += SPECT_FL_TAVG * (spectralTmp - self->featureData[0]);
+}
+
+static void ComputeSnrNEON(const NoiseSuppressionC* self,
+                           const float* magn,
+                           const float* noise,
+                           float* snrLocPrior,
+                           float* snrLocPost) {
+  size_t i;
+  const float32x4_t vec_one = vdupq_n_f32(1.f);
+  const float32x4_t vec_eps = vdupq_n_f32(0.0001f);
+  const float32x4_t vec_dd = vdupq_n_f32(DD_PR_SNR);
+  const float32x4_t vec_one_minus_dd = vdupq_n_f32(1.f - DD_PR_SNR);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const float32x4_t vec_magn = vld1q_f32(&magn[i]);
+    const float32x4_t vec_noise = vld1q_f32(&noise[i]);
+    // Previous estimate: based on previous frame with gain filter.
+    const float32x4_t vec_previous_estimate = vmulq_f32(
+        vdivq_f32(vld1q_f32(&self->magnPrevAnalyze[i]),
+                  vaddq_f32(vld1q_f32(&self->noisePrev[i]), vec_eps)),
+        vld1q_f32(&self->smooth[i]));
+    // Post SNR, zero where |magn| does not exceed |noise|.
+    const float32x4_t vec_post = vreinterpretq_f32_u32(vandq_u32(
+        vcgtq_f32(vec_magn, vec_noise),
+        vreinterpretq_u32_f32(vsubq_f32(
+            vdivq_f32(vec_magn, vaddq_f32(vec_noise, vec_eps)), vec_one))));
+    vst1q_f32(&snrLocPost[i], vec_post);
+    // DD estimate is sum of two terms: current estimate and previous estimate.
+    vst1q_f32(&snrLocPrior[i],
+              vaddq_f32(vmulq_f32(vec_dd, vec_previous_estimate),
+                        vmulq_f32(vec_one_minus_dd, vec_post)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    float previousEstimateStsa = self->magnPrevAnalyze[i] /
+        (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    snrLocPost[i] = 0.f;
+    if (magn[i] > noise[i]) {
+      snrLocPost[i] = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    snrLocPrior[i] =
+        DD_PR_SNR * previousEstimateStsa + (1.f - DD_PR_SNR) * snrLocPost[i];
+  }
+}
+
+static float UpdateLogLrtNEON(NoiseSuppressionC* self,
+                              const float* snrLocPrior,
+                              const float* snrLocPost) {
+  size_t i;
+  float tmpFloat1, tmpFloat2, besselTmp;
+  float logLrtTimeAvgKsum;
+  const float32x4_t vec_one = vdupq_n_f32(1.f);
+  const float32x4_t vec_two = vdupq_n_f32(2.f);
+  const float32x4_t vec_eps = vdupq_n_f32(0.0001f);
+  const float32x4_t vec_lrt_tavg = vdupq_n_f32(LRT_TAVG);
+  float32x4_t vec_sum = vdupq_n_f32(0.f);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const float32x4_t vec_prior = vld1q_f32(&snrLocPrior[i]);
+    const float32x4_t vec_post = vld1q_f32(&snrLocPost[i]);
+    const float32x4_t vec_tmp1 =
+        vaddq_f32(vec_one, vmulq_f32(vec_two, vec_prior));
+    const float32x4_t vec_tmp2 = vdivq_f32(vmulq_f32(vec_two, vec_prior),
+                                           vaddq_f32(vec_tmp1, vec_eps));
+    const float32x4_t vec_bessel =
+        vmulq_f32(vaddq_f32(vec_post, vec_one), vec_tmp2);
+    float32x4_t vec_lrt = vld1q_f32(&self->logLrtTimeAvg[i]);
+    vec_lrt = vaddq_f32(
+        vec_lrt,
+        vmulq_f32(vec_lrt_tavg,
+                  vsubq_f32(vsubq_f32(vec_bessel, vlogq_f32(vec_tmp1)),
+                            vec_lrt)));
+    vst1q_f32(&self->logLrtTimeAvg[i], vec_lrt);
+    vec_sum = vaddq_f32(vec_sum, vec_lrt);
+  }
+  logLrtTimeAvgKsum = vsumq_f32(vec_sum);
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    tmpFloat1 = 1.f + 2.f * snrLocPrior[i];
+    tmpFloat2 = 2.f * snrLocPrior[i] / (tmpFloat1 + 0.0001f);
+    besselTmp = (snrLocPost[i] + 1.f) * tmpFloat2;
+    self->logLrtTimeAvg[i] +=
+        LRT_TAVG * (besselTmp - (float)log(tmpFloat1) - self->logLrtTimeAvg[i]);
+    logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
+  }
+  return logLrtTimeAvgKsum;
+}
+
+static void ComputeSpeechProbNEON(const NoiseSuppressionC* self,
+                                  float gainPrior,
+                                  float* probSpeechFinal) {
+  size_t i;
+  float invLrt;
+  const float32x4_t vec_one = vdupq_n_f32(1.f);
+  const float32x4_t vec_gain_prior = vdupq_n_f32(gainPrior);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const float32x4_t vec_minus_lrt =
+        vnegq_f32(vld1q_f32(&self->logLrtTimeAvg[i]));
+    const float32x4_t vec_inv_lrt =
+        vmulq_f32(vec_gain_prior, vexpq_f32(vec_minus_lrt));
+    vst1q_f32(&probSpeechFinal[i],
+              vdivq_f32(vec_one, vaddq_f32(vec_one, vec_inv_lrt)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    invLrt = (float)exp(-self->logLrtTimeAvg[i]);
+    invLrt = (float)gainPrior * invLrt;
+    probSpeechFinal[i] = 1.f / (1.f + invLrt);
+  }
+}
+
+static void ComputeDdBasedWienerFilterNEON(const NoiseSuppressionC* self,
+                                           const float* magn,
+                                           float* theFilter) {
+  size_t i;
+  float snrPrior, previousEstimateStsa, currentEstimateStsa;
+  const float32x4_t vec_one = vdupq_n_f32(1.f);
+  const float32x4_t vec_eps = vdupq_n_f32(0.0001f);
+  const float32x4_t vec_dd = vdupq_n_f32(DD_PR_SNR);
+  const float32x4_t vec_one_minus_dd = vdupq_n_f32(1.f - DD_PR_SNR);
+  const float32x4_t vec_overdrive = vdupq_n_f32(self->overdrive);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const float32x4_t vec_magn = vld1q_f32(&magn[i]);
+    const float32x4_t vec_noise = vld1q_f32(&self->noise[i]);
+    // Previous estimate: based on previous frame with gain filter.
+    const float32x4_t vec_previous_estimate = vmulq_f32(
+        vdivq_f32(vld1q_f32(&self->magnPrevProcess[i]),
+                  vaddq_f32(vld1q_f32(&self->noisePrev[i]), vec_eps)),
+        vld1q_f32(&self->smooth[i]));
+    // Post and prior SNR.
+    const float32x4_t vec_current_estimate = vreinterpretq_f32_u32(vandq_u32(
+        vcgtq_f32(vec_magn, vec_noise),
+        vreinterpretq_u32_f32(vsubq_f32(
+            vdivq_f32(vec_magn, vaddq_f32(vec_noise, vec_eps)), vec_one))));
+    const float32x4_t vec_snr_prior =
+        vaddq_f32(vmulq_f32(vec_dd, vec_previous_estimate),
+                  vmulq_f32(vec_one_minus_dd, vec_current_estimate));
+    // Gain filter.
+    vst1q_f32(&theFilter[i],
+              vdivq_f32(vec_snr_prior,
+                        vaddq_f32(vec_overdrive, vec_snr_prior)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    previousEstimateStsa = self->magnPrevProcess[i] /
+                           (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    currentEstimateStsa = 0.f;
+    if (magn[i] > self->noise[i]) {
+      currentEstimateStsa = magn[i] / (self->noise[i] + 0.0001f) - 1.f;
+    }
+    snrPrior = DD_PR_SNR * previousEstimateStsa +
+               (1.f - DD_PR_SNR) * currentEstimateStsa;
+    theFilter[i] = snrPrior / (self->overdrive + snrPrior);
+  }
+}
+
+void WebRtcNs_InitNeon(void) {
+  WebRtcNs_ComputeSpectralFlatness = ComputeSpectralFlatnessNEON;
+  WebRtcNs_ComputeSnr = ComputeSnrNEON;
+  WebRtcNs_UpdateLogLrt = UpdateLogLrtNEON;
+  WebRtcNs_ComputeSpeechProb = ComputeSpeechProbNEON;
+  WebRtcNs_ComputeDdBasedWienerFilter = ComputeDdBasedWienerFilterNEON;
+}
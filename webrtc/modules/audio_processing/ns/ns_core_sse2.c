@@ -0,0 +1,322 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * The core noise suppression algorithm, SSE2 version of the per-frequency-bin
+ * loops.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/modules/audio_processing/ns/ns_core.h"
+
+// Natural logarithm of four positive floats, with the range reduction and
+// polynomial of the Cephes library's logf(). The result is within a few ulp of
+// log(); zero and negative inputs give garbage and must be handled by the
+// caller.
+static __m128 mm_log_ps(__m128 a) {
+  const __m128 min_norm_pos = _mm_castsi128_ps(_mm_set1_epi32(0x00800000));
+  const __m128 inv_mant_mask = _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000));
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 sqrt_half = _mm_set1_ps(0.707106781186547524f);
+  __m128i exponent;
+  __m128 e, mask, tmp, x, y, z;
+
+  // Split |a| into a mantissa |x| in [0.5, 1) and an exponent |e|.
+  a = _mm_max_ps(a, min_norm_pos);
+  exponent = _mm_srli_epi32(_mm_castps_si128(a), 23);
+  x = _mm_or_ps(_mm_and_ps(a, inv_mant_mask), half);
+  exponent = _mm_sub_epi32(exponent, _mm_set1_epi32(0x7f));
+  e = _mm_add_ps(_mm_cvtepi32_ps(exponent), one);
+
+  // Move the mantissa to [sqrt(0.5), sqrt(2)) and subtract one:
+  //   if (x < sqrt_half) { e -= 1; x = x + x - 1; } else { x = x - 1; }
+  mask = _mm_cmplt_ps(x, sqrt_half);
+  tmp = _mm_and_ps(x, mask);
+  x = _mm_sub_ps(x, one);
+  e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+  x = _mm_add_ps(x, tmp);
+
+  // log(1 + x) = x - x^2 / 2 + x^3 * P(x).
+  z = _mm_mul_ps(x, x);
+  y = _mm_set1_ps(7.0376836292E-2f);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174E-1f));
+  y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+
+  // Add e * log(2), with log(2) split in two for precision.
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, half));
+  x = _mm_add_ps(x, y);
+  return _mm_add_ps(x, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+
+// Exponential of four floats, with the range reduction and polynomial of the
+// Cephes library's expf(). Inputs are clamped to +-88.376, which keeps the
+// result finite.
+static __m128 mm_exp_ps(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.f);
+  __m128i n;
+  __m128 fx, tmp, y, z;
+
+  x = _mm_min_ps(x, _mm_set1_ps(88.3762626647949f));
+  x = _mm_max_ps(x, _mm_set1_ps(-88.3762626647949f));
+
+  // exp(x) = 2^n * exp(g), with n = floor(x / log(2) + 0.5) and
+  // g = x - n * log(2), the latter split in two for precision.
+  fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)),
+                  _mm_set1_ps(0.5f));
+  tmp = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+  fx = _mm_sub_ps(tmp, _mm_and_ps(_mm_cmpgt_ps(tmp, fx), one));
+  x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+  x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+
+  // exp(g) = 1 + g + g^2 * P(g).
+  z = _mm_mul_ps(x, x);
+  y = _mm_set1_ps(1.9875691500E-4f);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507E-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073E-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894E-2f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201E-1f));
+  y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), one);
+
+  // Build 2^n in the exponent bits.
+  n = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(0x7f));
+  n = _mm_slli_epi32(n, 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(n));
+}
+
+__inline static float mm_sum_ps(__m128 a) {
+  // a = {a0 + a2, a1 + a3, ...} then {a0 + a2 + a1 + a3, ...}.
+  a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+  a = _mm_add_ss(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(a);
+}
+
+static void ComputeSpectralFlatnessSSE2(NoiseSuppressionC* self,
+                                        const float* magnIn) {
+  size_t i;
+  size_t shiftLP = 1;  // Option to remove first bin(s) from spectral measures.
+  float avgSpectralFlatnessNum, avgSpectralFlatnessDen, spectralTmp;
+  const __m128 vec_zero = _mm_setzero_ps();
+  __m128 vec_sum = _mm_setzero_ps();
+  __m128 vec_not_positive = _mm_setzero_ps();
+
+  // Compute spectral measures.
+  // For flatness.
+  avgSpectralFlatnessDen = self->sumMagn;
+  for (i = 0; i < shiftLP; i++) {
+    avgSpectralFlatnessDen -= magnIn[i];
+  }
+  // Compute log of ratio of the geometric to arithmetic mean: check for log(0)
+  // case.
+  for (i = shiftLP; i + 3 < self->magnLen; i += 4) {
+    const __m128 vec_magn = _mm_loadu_ps(&magnIn[i]);
+    vec_not_positive =
+        _mm_or_ps(vec_not_positive, _mm_cmpngt_ps(vec_magn, vec_zero));
+    vec_sum = _mm_add_ps(vec_sum, mm_log_ps(vec_magn));
+  }
+  if (_mm_movemask_ps(vec_not_positive) != 0) {
+    self->featureData[0] -= SPECT_FL_TAVG * self->featureData[0];
+    return;
+  }
+  avgSpectralFlatnessNum = mm_sum_ps(vec_sum);
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    if (magnIn[i] > 0.0) {
+      avgSpectralFlatnessNum += (float)log(magnIn[i]);
+    } else {
+      self->featureData[0] -= SPECT_FL_TAVG * self->featureData[0];
+      return;
+    }
+  }
+  // Normalize.
+  avgSpectralFlatnessDen = avgSpectralFlatnessDen / self->magnLen;
+  avgSpectralFlatnessNum = avgSpectralFlatnessNum / self->magnLen;
+
+  // Ratio and inverse log: check for case of log(0).
+  spectralTmp = (float)exp(avgSpectralFlatnessNum) / avgSpectralFlatnessDen;
+
+  // Time-avg update of spectral flatness feature.
+  self->featureData[0] += SPECT_FL_TAVG * (spectralTmp - self->featureData[0]);
+}
+
+static void ComputeSnrSSE2(const NoiseSuppressionC* self,
+                           const float* magn,
+                           const float* noise,
+                           float* snrLocPrior,
+                           float* snrLocPost) {
+  size_t i;
+  const __m128 vec_one = _mm_set1_ps(1.f);
+  const __m128 vec_eps = _mm_set1_ps(0.0001f);
+  const __m128 vec_dd = _mm_set1_ps(DD_PR_SNR);
+  const __m128 vec_one_minus_dd = _mm_set1_ps(1.f - DD_PR_SNR);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const __m128 vec_magn = _mm_loadu_ps(&magn[i]);
+    const __m128 vec_noise = _mm_loadu_ps(&noise[i]);
+    // Previous estimate: based on previous frame with gain filter.
+    const __m128 vec_previous_estimate = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&self->magnPrevAnalyze[i]),
+                   _mm_add_ps(_mm_loadu_ps(&self->noisePrev[i]), vec_eps)),
+        _mm_loadu_ps(&self->smooth[i]));
+    // Post SNR, zero where |magn| does not exceed |noise|.
+    const __m128 vec_post = _mm_and_ps(
+        _mm_cmpgt_ps(vec_magn, vec_noise),
+        _mm_sub_ps(_mm_div_ps(vec_magn, _mm_add_ps(vec_noise, vec_eps)),
+                   vec_one));
+    _mm_storeu_ps(&snrLocPost[i], vec_post);
+    // DD estimate is sum of two terms: current estimate and previous estimate.
+    _mm_storeu_ps(&snrLocPrior[i],
+                  _mm_add_ps(_mm_mul_ps(vec_dd, vec_previous_estimate),
+                             _mm_mul_ps(vec_one_minus_dd, vec_post)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    float previousEstimateStsa = self->magnPrevAnalyze[i] /
+        (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    snrLocPost[i] = 0.f;
+    if (magn[i] > noise[i]) {
+      snrLocPost[i] = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    snrLocPrior[i] =
+        DD_PR_SNR * previousEstimateStsa + (1.f - DD_PR_SNR) * snrLocPost[i];
+  }
+}
+
+static float UpdateLogLrtSSE2(NoiseSuppressionC* self,
+                              const float* snrLocPrior,
+                              const float* snrLocPost) {
+  size_t i;
+  float tmpFloat1, tmpFloat2, besselTmp;
+  float logLrtTimeAvgKsum;
+  const __m128 vec_one = _mm_set1_ps(1.f);
+  const __m128 vec_two = _mm_set1_ps(2.f);
+  const __m128 vec_eps = _mm_set1_ps(0.0001f);
+  const __m128 vec_lrt_tavg = _mm_set1_ps(LRT_TAVG);
+  __m128 vec_sum = _mm_setzero_ps();
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const __m128 vec_prior = _mm_loadu_ps(&snrLocPrior[i]);
+    const __m128 vec_post = _mm_loadu_ps(&snrLocPost[i]);
+    const __m128 vec_tmp1 = _mm_add_ps(vec_one, _mm_mul_ps(vec_two, vec_prior));
+    const __m128 vec_tmp2 = _mm_div_ps(_mm_mul_ps(vec_two, vec_prior),
+                                       _mm_add_ps(vec_tmp1, vec_eps));
+    const __m128 vec_bessel = _mm_mul_ps(_mm_add_ps(vec_post, vec_one),
+                                         vec_tmp2);
+    __m128 vec_lrt = _mm_loadu_ps(&self->logLrtTimeAvg[i]);
+    vec_lrt = _mm_add_ps(
+        vec_lrt,
+        _mm_mul_ps(vec_lrt_tavg,
+                   _mm_sub_ps(_mm_sub_ps(vec_bessel, mm_log_ps(vec_tmp1)),
+                              vec_lrt)));
+    _mm_storeu_ps(&self->logLrtTimeAvg[i], vec_lrt);
+    vec_sum = _mm_add_ps(vec_sum, vec_lrt);
+  }
+  logLrtTimeAvgKsum = mm_sum_ps(vec_sum);
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    tmpFloat1 = 1.f + 2.f * snrLocPrior[i];
+    tmpFloat2 = 2.f * snrLocPrior[i] / (tmpFloat1 + 0.0001f);
+    besselTmp = (snrLocPost[i] + 1.f) * tmpFloat2;
+    self->logLrtTimeAvg[i] +=
+        LRT_TAVG * (besselTmp - (float)log(tmpFloat1) - self->logLrtTimeAvg[i]);
+    logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
+  }
+  return logLrtTimeAvgKsum;
+}
+
+static void ComputeSpeechProbSSE2(const NoiseSuppressionC* self,
+                                  float gainPrior,
+                                  float* probSpeechFinal) {
+  size_t i;
+  float invLrt;
+  const __m128 vec_one = _mm_set1_ps(1.f);
+  const __m128 vec_gain_prior = _mm_set1_ps(gainPrior);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const __m128 vec_minus_lrt =
+        _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&self->logLrtTimeAvg[i]));
+    const __m128 vec_inv_lrt =
+        _mm_mul_ps(vec_gain_prior, mm_exp_ps(vec_minus_lrt));
+    _mm_storeu_ps(&probSpeechFinal[i],
+                  _mm_div_ps(vec_one, _mm_add_ps(vec_one, vec_inv_lrt)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    invLrt = (float)exp(-self->logLrtTimeAvg[i]);
+    invLrt = (float)gainPrior * invLrt;
+    probSpeechFinal[i] = 1.f / (1.f + invLrt);
+  }
+}
+
+static void ComputeDdBasedWienerFilterSSE2(const NoiseSuppressionC* self,
+                                           const float* magn,
+                                           float* theFilter) {
+  size_t i;
+  float snrPrior, previousEstimateStsa, currentEstimateStsa;
+  const __m128 vec_one = _mm_set1_ps(1.f);
+  const __m128 vec_eps = _mm_set1_ps(0.0001f);
+  const __m128 vec_dd = _mm_set1_ps(DD_PR_SNR);
+  const __m128 vec_one_minus_dd = _mm_set1_ps(1.f - DD_PR_SNR);
+  const __m128 vec_overdrive = _mm_set1_ps(self->overdrive);
+
+  for (i = 0; i + 3 < self->magnLen; i += 4) {
+    const __m128 vec_magn = _mm_loadu_ps(&magn[i]);
+    const __m128 vec_noise = _mm_loadu_ps(&self->noise[i]);
+    // Previous estimate: based on previous frame with gain filter.
+    const __m128 vec_previous_estimate = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&self->magnPrevProcess[i]),
+                   _mm_add_ps(_mm_loadu_ps(&self->noisePrev[i]), vec_eps)),
+        _mm_loadu_ps(&self->smooth[i]));
+    // Post and prior SNR.
+    const __m128 vec_current_estimate = _mm_and_ps(
+        _mm_cmpgt_ps(vec_magn, vec_noise),
+        _mm_sub_ps(_mm_div_ps(vec_magn, _mm_add_ps(vec_noise, vec_eps)),
+                   vec_one));
+    const __m128 vec_snr_prior =
+        _mm_add_ps(_mm_mul_ps(vec_dd, vec_previous_estimate),
+                   _mm_mul_ps(vec_one_minus_dd, vec_current_estimate));
+    // Gain filter.
+    _mm_storeu_ps(&theFilter[i],
+                  _mm_div_ps(vec_snr_prior,
+                             _mm_add_ps(vec_overdrive, vec_snr_prior)));
+  }
+  // Scalar code for the remaining items.
+  for (; i < self->magnLen; i++) {
+    previousEstimateStsa = self->magnPrevProcess[i] /
+                           (self->noisePrev[i] + 0.0001f) * self->smooth[i];
+    currentEstimateStsa = 0.f;
+    if (magn[i] > self->noise[i]) {
+      currentEstimateStsa = magn[i] / (self->noise[i] + 0.0001f) - 1.f;
+    }
+    snrPrior = DD_PR_SNR * previousEstimateStsa +
+               (1.f - DD_PR_SNR) * currentEstimateStsa;
+    theFilter[i] = snrPrior / (self->overdrive + snrPrior);
+  }
+}
+
+void WebRtcNs_InitSse2(void) {
+  WebRtcNs_ComputeSpectralFlatness = ComputeSpectralFlatnessSSE2;
+  WebRtcNs_ComputeSnr = ComputeSnrSSE2;
+  WebRtcNs_UpdateLogLrt = UpdateLogLrtSSE2;
+  WebRtcNs_ComputeSpeechProb = ComputeSpeechProbSSE2;
+  WebRtcNs_ComputeDdBasedWienerFilter = ComputeDdBasedWienerFilterSSE2;
+}
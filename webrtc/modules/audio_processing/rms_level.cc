@@ -35,6 +35,11 @@ void RMSLevel::Process(const int16_t* data, size_t length) {
   sample_count_ += length;
 }
 
+void RMSLevel::ProcessSumSquares(int64_t sum_squares, size_t length) {
+  sum_square_ += sum_squares;
+  sample_count_ += length;
+}
+
 void RMSLevel::ProcessMuted(size_t length) {
   sample_count_ += length;
 }
@@ -39,6 +39,10 @@ class RMSLevel {
   // Pass each chunk of audio to Process() to accumulate the level.
   void Process(const int16_t* data, size_t length);
 
+  // Like Process(), for a chunk whose squared samples have already been
+  // summed, e.g. by AudioFrameOperations::UpdateLevel().
+  void ProcessSumSquares(int64_t sum_squares, size_t length);
+
   // If all samples with the given |length| have a magnitude of zero, this is
   // a shortcut to avoid some computation.
   void ProcessMuted(size_t length);
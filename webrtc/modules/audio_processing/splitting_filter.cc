@@ -56,6 +56,15 @@ void SplittingFilter::Synthesis(const IFChannelBuffer* bands,
   }
 }
 
+void SplittingFilter::Reset() {
+  for (size_t i = 0; i < two_bands_states_.size(); ++i) {
+    two_bands_states_[i] = TwoBandsStates();
+  }
+  for (size_t i = 0; i < three_band_filter_banks_.size(); ++i) {
+    three_band_filter_banks_[i]->Reset();
+  }
+}
+
 void SplittingFilter::TwoBandsAnalysis(const IFChannelBuffer* data,
                                        IFChannelBuffer* bands) {
   RTC_DCHECK_EQ(two_bands_states_.size(), data->num_channels());
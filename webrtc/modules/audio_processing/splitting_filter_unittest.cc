@@ -14,6 +14,7 @@
 #include <cmath>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
 #include "webrtc/common_audio/channel_buffer.h"
 #include "webrtc/modules/audio_processing/splitting_filter.h"
 
@@ -23,6 +24,21 @@ namespace {
 const size_t kSamplesPer16kHzChannel = 160;
 const size_t kSamplesPer48kHzChannel = 480;
 
+// Output of the three band filter bank for the pseudo-random input of
+// ThreeBandsMatchReferenceOutput, which the optimized filters must reproduce
+// exactly. Every 20th sample of each band and every 60th sample of the merged
+// signal is stored, after three chunks.
+const float kReferenceBands[3][8] = {
+    {5808.75146f, 3475.41162f, -127.862793f, -2588.08008f, -13333.8184f,
+     -11163.1074f, 23315.0625f, 10619.4072f},
+    {-3144.00317f, -3502.20117f, 8158.25391f, 4606.10645f, 1705.00085f,
+     -6064.95605f, 8980.01758f, 3196.94897f},
+    {2357.03076f, 25125.4258f, 11583.4512f, -1864.50391f, -11814.0166f,
+     16691.377f, 1856.39111f, 17615.6777f}};
+const float kReferenceMerged[8] = {
+    -16495.0137f, -1721.17334f, 29142.1035f, 7317.65137f, 10535.458f,
+    -11414.0098f, -16109.1475f, -35609.0039f};
+
 }  // namespace
 
 // Generates a signal from presence or absence of sine waves of different
@@ -103,4 +119,35 @@ TEST(SplittingFilterTest, SplitsIntoThreeBandsAndReconstructs) {
   }
 }
 
+TEST(SplittingFilterTest, ThreeBandsMatchReferenceOutput) {
+  static const int kChannels = 1;
+  static const size_t kNumBands = 3;
+  static const size_t kChunks = 3;
+  SplittingFilter splitting_filter(kChannels,
+                                   kNumBands,
+                                   kSamplesPer48kHzChannel);
+  IFChannelBuffer in_data(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  IFChannelBuffer bands(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  IFChannelBuffer out_data(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < kChunks; ++i) {
+    for (size_t k = 0; k < kSamplesPer48kHzChannel; ++k) {
+      seed = seed * 1664525u + 1013904223u;
+      in_data.fbuf()->channels()[0][k] = static_cast<int16_t>(seed >> 16);
+    }
+    splitting_filter.Analysis(&in_data, &bands);
+    splitting_filter.Synthesis(&bands, &out_data);
+  }
+  for (size_t j = 0; j < kNumBands; ++j) {
+    for (size_t k = 0; k < arraysize(kReferenceBands[j]); ++k) {
+      EXPECT_EQ(kReferenceBands[j][k],
+                bands.fbuf_const()->channels(j)[0][20 * k + 1]);
+    }
+  }
+  for (size_t k = 0; k < arraysize(kReferenceMerged); ++k) {
+    EXPECT_EQ(kReferenceMerged[k],
+              out_data.fbuf_const()->channels()[0][60 * k + 7]);
+  }
+}
+
 }  // namespace webrtc
@@ -177,6 +177,13 @@ void ThreeBandFilterBank::Synthesis(const float* const* in,
   }
 }
 
+void ThreeBandFilterBank::Reset() {
+  for (size_t i = 0; i < analysis_filters_.size(); ++i) {
+    analysis_filters_[i]->Reset();
+    synthesis_filters_[i]->Reset();
+  }
+}
+
 
 // Modulates |in| by |dct_modulation_| and accumulates it in each of the
 // |kNumBands| bands of |out|. |offset| is the index in the period of the
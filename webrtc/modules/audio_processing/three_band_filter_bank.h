@@ -46,6 +46,9 @@ class ThreeBandFilterBank final {
   // least a length of 3 * |split_length|.
   void Synthesis(const float* const* in, size_t split_length, float* out);
 
+  // Resets the filter states, as after construction.
+  void Reset();
+
  private:
   void DownModulate(const float* in,
                     size_t split_length,
@@ -265,6 +265,15 @@ void TransientSuppressor::Suppress(float* in_ptr,
                        kMeanIIRCoefficient * magnitudes_[i];
   }
 
+  if (!suppression_enabled_) {
+    // The spectrum is untouched, so going back to time domain would only give
+    // the windowed input back. Skip the inverse transform.
+    for (size_t i = 0; i < analysis_length_; ++i) {
+      out_ptr[i] += in_ptr[i] * window_[i] * window_[i];
+    }
+    return;
+  }
+
   // Back to time domain.
   // Put R[n/2] back in fft_buffer_[1].
   fft_buffer_[1] = fft_buffer_[analysis_length_];
@@ -20,6 +20,25 @@
 
 namespace webrtc {
 
+namespace {
+
+// Creates a filter with every other coefficient in |coefficients|, starting at
+// |first|.
+FIRFilter* CreatePolyphaseFilter(const float* coefficients,
+                                 size_t coefficients_length,
+                                 size_t first,
+                                 size_t max_input_length) {
+  const size_t polyphase_length = (coefficients_length - first + 1) / 2;
+  rtc::scoped_ptr<float[]> polyphase_coefficients(new float[polyphase_length]);
+  for (size_t i = 0; i < polyphase_length; ++i) {
+    polyphase_coefficients[i] = coefficients[first + 2 * i];
+  }
+  return FIRFilter::Create(polyphase_coefficients.get(), polyphase_length,
+                           max_input_length);
+}
+
+}  // namespace
+
 WPDNode::WPDNode(size_t length,
                  const float* coefficients,
                  size_t coefficients_length)
@@ -29,9 +48,20 @@ WPDNode::WPDNode(size_t length,
       length_(length),
       filter_(FIRFilter::Create(coefficients,
                                 coefficients_length,
-                                2 * length + 1)) {
+                                2 * length + 1)),
+      odd_parent_data_(new float[length]),
+      even_parent_data_(new float[length]),
+      odd_filtered_data_(new float[length]),
+      even_filter_(CreatePolyphaseFilter(coefficients,
+                                         coefficients_length,
+                                         0,
+                                         length)) {
   assert(length > 0 && coefficients && coefficients_length > 0);
   memset(data_.get(), 0.f, (2 * length + 1) * sizeof(data_[0]));
+  if (coefficients_length > 1) {
+    odd_filter_.reset(
+        CreatePolyphaseFilter(coefficients, coefficients_length, 1, length));
+  }
 }
 
 WPDNode::~WPDNode() {}
@@ -41,15 +71,34 @@ int WPDNode::Update(const float* parent_data, size_t parent_data_length) {
     return -1;
   }
 
-  // Filter data.
-  filter_->Filter(parent_data, parent_data_length, data_.get());
-
-  // Decimate data.
   const bool kOddSequence = true;
-  size_t output_samples = DyadicDecimate(
-      data_.get(), parent_data_length, kOddSequence, data_.get(), length_);
-  if (output_samples != length_) {
-    return -1;
+  if (parent_data_length % 2 == 1) {
+    // The polyphase streams would change parity from one update to the next,
+    // so filter at the full rate and decimate afterwards.
+    filter_->Filter(parent_data, parent_data_length, data_.get());
+    size_t output_samples = DyadicDecimate(
+        data_.get(), parent_data_length, kOddSequence, data_.get(), length_);
+    if (output_samples != length_) {
+      return -1;
+    }
+  } else {
+    // Split the parent data into its odd and even samples.
+    DyadicDecimate(parent_data, parent_data_length, kOddSequence,
+                   odd_parent_data_.get(), length_);
+    DyadicDecimate(parent_data, parent_data_length, !kOddSequence,
+                   even_parent_data_.get(), length_);
+
+    // The odd samples of the filtered parent data are the odd samples filtered
+    // with the even coefficients plus the even samples filtered with the odd
+    // coefficients.
+    even_filter_->Filter(odd_parent_data_.get(), length_, data_.get());
+    if (odd_filter_) {
+      odd_filter_->Filter(even_parent_data_.get(), length_,
+                          odd_filtered_data_.get());
+      for (size_t i = 0; i < length_; ++i) {
+        data_[i] += odd_filtered_data_[i];
+      }
+    }
   }
 
   // Get abs to all values.
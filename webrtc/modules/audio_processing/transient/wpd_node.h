@@ -39,6 +39,16 @@ class WPDNode {
   rtc::scoped_ptr<float[]> data_;
   size_t length_;
   rtc::scoped_ptr<FIRFilter> filter_;
+  // For an even |parent_data_length| the filtering and the decimation are done
+  // in polyphase form: the odd and even parent samples are filtered separately
+  // with the even and odd coefficients respectively, so only the samples kept
+  // after decimation are computed. |odd_filter_| is NULL if the node has only
+  // one coefficient.
+  rtc::scoped_ptr<float[]> odd_parent_data_;
+  rtc::scoped_ptr<float[]> even_parent_data_;
+  rtc::scoped_ptr<float[]> odd_filtered_data_;
+  rtc::scoped_ptr<FIRFilter> even_filter_;
+  rtc::scoped_ptr<FIRFilter> odd_filter_;
 };
 
 }  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "webrtc/modules/audio_processing/transient/wpd_node.h"
 
+#include <math.h>
 #include <string.h>
 
 #include "testing/gtest/include/gtest/gtest.h"
@@ -55,6 +56,39 @@ TEST(WPDNodeTest, UpdateWithArbitraryDataAndArbitraryFilter) {
   EXPECT_NEAR(0.94f, node.data()[4], kTolerance);
 }
 
+// Filters and decimates a few consecutive chunks of |parent_data_length| and
+// compares the result with a direct convolution of the whole sequence.
+static void ExpectUpdateMatchesConvolution(size_t parent_data_length) {
+  const size_t kNumChunks = 3;
+  const size_t kLength = parent_data_length / 2;
+  const size_t kTotalLength = kNumChunks * parent_data_length;
+  rtc::scoped_ptr<float[]> parent_data(new float[kTotalLength]);
+  for (size_t i = 0; i < kTotalLength; ++i) {
+    parent_data[i] = ((i * 7) % 11) - 5.f;
+  }
+  WPDNode node(kLength, kCoefficients, kCoefficientsLength);
+  for (size_t chunk = 0; chunk < kNumChunks; ++chunk) {
+    const size_t offset = chunk * parent_data_length;
+    EXPECT_EQ(0, node.Update(&parent_data[offset], parent_data_length));
+    for (size_t i = 0; i < kLength; ++i) {
+      const size_t n = offset + 2 * i + 1;
+      float expected = 0.f;
+      for (size_t j = 0; j < kCoefficientsLength && j <= n; ++j) {
+        expected += kCoefficients[j] * parent_data[n - j];
+      }
+      EXPECT_NEAR(fabs(expected), node.data()[i], kTolerance);
+    }
+  }
+}
+
+TEST(WPDNodeTest, UpdateMatchesConvolutionForEvenParentDataLength) {
+  ExpectUpdateMatchesConvolution(kParentDataLength);
+}
+
+TEST(WPDNodeTest, UpdateMatchesConvolutionForOddParentDataLength) {
+  ExpectUpdateMatchesConvolution(kParentDataLength + 1);
+}
+
 TEST(WPDNodeTest, ExpectedErrorReturnValue) {
   WPDNode node(kDataLength, kCoefficients, kCoefficientsLength);
   EXPECT_EQ(-1, node.Update(kParentData, kParentDataLength - 1));
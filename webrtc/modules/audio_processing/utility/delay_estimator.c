@@ -36,7 +36,12 @@ static const float kMinFractionWhenPossiblyCausal = 0.5f;
 static const float kMinFractionWhenPossiblyNonCausal = 0.25f;
 
 // Counts and returns number of bits of a 32-bit word.
-static int BitCount(uint32_t u32) {
+static __inline int BitCount(uint32_t u32) {
+#if defined(__GNUC__) && \
+    (defined(__POPCNT__) || defined(__ARM_NEON__) || defined(__aarch64__))
+  // Use the hardware population count when the target has one.
+  return __builtin_popcount(u32);
+#else
   uint32_t tmp = u32 - ((u32 >> 1) & 033333333333) -
       ((u32 >> 2) & 011111111111);
   tmp = ((tmp + (tmp >> 3)) & 030707070707);
@@ -44,30 +49,24 @@ static int BitCount(uint32_t u32) {
   tmp = (tmp + (tmp >> 12) + (tmp >> 24)) & 077;
 
   return ((int) tmp);
+#endif
 }
 
-// Compares the |binary_vector| with all rows of the |binary_matrix| and counts
-// per row the number of times they have the same value.
-//
-// Inputs:
-//      - binary_vector     : binary "vector" stored in a long
-//      - binary_matrix     : binary "matrix" stored as a vector of long
-//      - matrix_size       : size of binary "matrix"
-//
-// Output:
-//      - bit_counts        : "Vector" stored as a long, containing for each
-//                            row the number of times the matrix row and the
-//                            input vector have the same value
-//
-static void BitCountComparison(uint32_t binary_vector,
-                               const uint32_t* binary_matrix,
-                               int matrix_size,
-                               int32_t* bit_counts) {
-  int n = 0;
-
-  // Compare |binary_vector| with all rows of the |binary_matrix|
-  for (; n < matrix_size; n++) {
-    bit_counts[n] = (int32_t) BitCount(binary_vector ^ binary_matrix[n]);
+// Decreases the |histogram| bins in [|begin|, |end|) with |value|, limited to
+// the range [0, |history_size|).  No bin can go below 0.
+static void DecreaseHistogram(float* histogram,
+                              int history_size,
+                              int begin,
+                              int end,
+                              float value) {
+  int i = 0;
+  begin = (begin > 0 ? begin : 0);
+  end = (end < history_size ? end : history_size);
+  for (i = begin; i < end; ++i) {
+    histogram[i] -= value;
+    if (histogram[i] < 0) {
+      histogram[i] = 0;
+    }
   }
 }
 
@@ -96,6 +95,10 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
   float decrease_in_last_set = valley_depth;
   const int max_hits_for_slow_change = (candidate_delay < self->last_delay) ?
       kMaxHitsWhenPossiblyNonCausal : kMaxHitsWhenPossiblyCausal;
+  int candidate_begin = 0;
+  int last_begin = 0;
+  int first_begin = 0;
+  int second_begin = 0;
   int i = 0;
 
   assert(self->history_size == self->farend->history_size);
@@ -129,20 +132,34 @@ static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
         valley_level_q14) * kQ14Scaling;
   }
   // 4. All other bins are decreased with |valley_depth|.
-  // TODO(bjornv): Investigate how to make this loop more efficient.  Split up
-  // the loop?  Remove parts that doesn't add too much.
-  for (i = 0; i < self->history_size; ++i) {
-    int is_in_last_set = (i >= self->last_delay - 2) &&
-        (i <= self->last_delay + 1) && (i != candidate_delay);
-    int is_in_candidate_set = (i >= candidate_delay - 2) &&
-        (i <= candidate_delay + 1);
-    self->histogram[i] -= decrease_in_last_set * is_in_last_set +
-        valley_depth * (!is_in_last_set && !is_in_candidate_set);
-    // 5. No histogram bin can go below 0.
-    if (self->histogram[i] < 0) {
-      self->histogram[i] = 0;
+  // The two neighborhoods are four bins wide each, so instead of classifying
+  // every bin we decrease the ranges around them in straight loops and treat
+  // the bins of the |last_delay| neighborhood separately.
+  candidate_begin = candidate_delay - 2;
+  last_begin = self->last_delay - 2;
+  if (candidate_begin < last_begin) {
+    first_begin = candidate_begin;
+    second_begin = last_begin;
+  } else {
+    first_begin = last_begin;
+    second_begin = candidate_begin;
+  }
+  DecreaseHistogram(self->histogram, self->history_size, 0, first_begin,
+                    valley_depth);
+  DecreaseHistogram(self->histogram, self->history_size, first_begin + 4,
+                    second_begin, valley_depth);
+  DecreaseHistogram(self->histogram, self->history_size, second_begin + 4,
+                    self->history_size, valley_depth);
+  // The |last_delay| neighborhood, except the |candidate_delay| bin itself, is
+  // decreased with |decrease_in_last_set|.
+  for (i = last_begin; i < last_begin + 4; ++i) {
+    if (i == candidate_delay) {
+      continue;
     }
+    DecreaseHistogram(self->histogram, self->history_size, i, i + 1,
+                      decrease_in_last_set);
   }
+  // 5. No histogram bin can go below 0, which DecreaseHistogram() ensures.
 }
 
 // Validates the |candidate_delay|, estimated in WebRtc_ProcessBinarySpectrum(),
@@ -382,9 +399,6 @@ void WebRtc_FreeBinaryDelayEstimator(BinaryDelayEstimator* self) {
   free(self->mean_bit_counts);
   self->mean_bit_counts = NULL;
 
-  free(self->bit_counts);
-  self->bit_counts = NULL;
-
   free(self->binary_near_history);
   self->binary_near_history = NULL;
 
@@ -420,7 +434,6 @@ BinaryDelayEstimator* WebRtc_CreateBinaryDelayEstimator(
 
   // Allocate memory for spectrum and history buffers.
   self->mean_bit_counts = NULL;
-  self->bit_counts = NULL;
   self->histogram = NULL;
   self->binary_near_history =
       malloc((max_lookahead + 1) * sizeof(*self->binary_near_history));
@@ -447,14 +460,10 @@ int WebRtc_AllocateHistoryBufferMemory(BinaryDelayEstimator* self,
   self->mean_bit_counts =
       realloc(self->mean_bit_counts,
               (history_size + 1) * sizeof(*self->mean_bit_counts));
-  self->bit_counts =
-      realloc(self->bit_counts, history_size * sizeof(*self->bit_counts));
   self->histogram =
       realloc(self->histogram, (history_size + 1) * sizeof(*self->histogram));
 
-  if ((self->mean_bit_counts == NULL) ||
-      (self->bit_counts == NULL) ||
-      (self->histogram == NULL)) {
+  if ((self->mean_bit_counts == NULL) || (self->histogram == NULL)) {
     history_size = 0;
   }
   // Fill with zeros if we have expanded the buffers.
@@ -463,9 +472,6 @@ int WebRtc_AllocateHistoryBufferMemory(BinaryDelayEstimator* self,
     memset(&self->mean_bit_counts[self->history_size],
            0,
            sizeof(*self->mean_bit_counts) * size_diff);
-    memset(&self->bit_counts[self->history_size],
-           0,
-           sizeof(*self->bit_counts) * size_diff);
     memset(&self->histogram[self->history_size],
            0,
            sizeof(*self->histogram) * size_diff);
@@ -479,7 +485,6 @@ void WebRtc_InitBinaryDelayEstimator(BinaryDelayEstimator* self) {
   int i = 0;
   assert(self != NULL);
 
-  memset(self->bit_counts, 0, sizeof(int32_t) * self->history_size);
   memset(self->binary_near_history,
          0,
          sizeof(uint32_t) * self->near_history_size);
@@ -516,6 +521,8 @@ int WebRtc_SoftResetBinaryDelayEstimator(BinaryDelayEstimator* self,
 
 int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
                                  uint32_t binary_near_spectrum) {
+  const uint32_t* binary_far_history = NULL;
+  const int* far_bit_counts = NULL;
   int i = 0;
   int candidate_delay = -1;
   int valid_candidate = 0;
@@ -537,37 +544,36 @@ int WebRtc_ProcessBinarySpectrum(BinaryDelayEstimator* self,
     self->binary_near_history[0] = binary_near_spectrum;
     binary_near_spectrum = self->binary_near_history[self->lookahead];
   }
+  binary_far_history = self->farend->binary_far_history;
+  far_bit_counts = self->farend->far_bit_counts;
 
-  // Compare with delayed spectra and store the |bit_counts| for each delay.
-  BitCountComparison(binary_near_spectrum, self->farend->binary_far_history,
-                     self->history_size, self->bit_counts);
-
-  // Update |mean_bit_counts|, which is the smoothed version of |bit_counts|.
+  // Compare with delayed spectra, update |mean_bit_counts| and find
+  // |candidate_delay|, |value_best_candidate| and |value_worst_candidate| in a
+  // single pass over the history.
   for (i = 0; i < self->history_size; i++) {
-    // |bit_counts| is constrained to [0, 32], meaning we can smooth with a
+    // The bit count is constrained to [0, 32], meaning we can smooth with a
     // factor up to 2^26. We use Q9.
-    int32_t bit_count = (self->bit_counts[i] << 9);  // Q9.
+    int32_t bit_count =
+        BitCount(binary_near_spectrum ^ binary_far_history[i]) << 9;  // Q9.
+    int32_t mean_bit_count = self->mean_bit_counts[i];
 
     // Update |mean_bit_counts| only when far-end signal has something to
     // contribute. If |far_bit_counts| is zero the far-end signal is weak and
     // we likely have a poor echo condition, hence don't update.
-    if (self->farend->far_bit_counts[i] > 0) {
+    if (far_bit_counts[i] > 0) {
       // Make number of right shifts piecewise linear w.r.t. |far_bit_counts|.
       int shifts = kShiftsAtZero;
-      shifts -= (kShiftsLinearSlope * self->farend->far_bit_counts[i]) >> 4;
-      WebRtc_MeanEstimatorFix(bit_count, shifts, &(self->mean_bit_counts[i]));
+      shifts -= (kShiftsLinearSlope * far_bit_counts[i]) >> 4;
+      WebRtc_MeanEstimatorFix(bit_count, shifts, &mean_bit_count);
+      self->mean_bit_counts[i] = mean_bit_count;
     }
-  }
 
-  // Find |candidate_delay|, |value_best_candidate| and |value_worst_candidate|
-  // of |mean_bit_counts|.
-  for (i = 0; i < self->history_size; i++) {
-    if (self->mean_bit_counts[i] < value_best_candidate) {
-      value_best_candidate = self->mean_bit_counts[i];
+    if (mean_bit_count < value_best_candidate) {
+      value_best_candidate = mean_bit_count;
       candidate_delay = i;
     }
-    if (self->mean_bit_counts[i] > value_worst_candidate) {
-      value_worst_candidate = self->mean_bit_counts[i];
+    if (mean_bit_count > value_worst_candidate) {
+      value_worst_candidate = mean_bit_count;
     }
   }
   valley_depth = value_worst_candidate - value_best_candidate;
@@ -29,9 +29,6 @@ typedef struct {
 typedef struct {
   // Pointer to bit counts.
   int32_t* mean_bit_counts;
-  // Array only used locally in ProcessBinarySpectrum() but whose size is
-  // determined at run-time.
-  int32_t* bit_counts;
 
   // Binary history variables.
   uint32_t* binary_near_history;
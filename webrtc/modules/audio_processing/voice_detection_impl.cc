@@ -19,12 +19,15 @@ class VoiceDetectionImpl::Vad {
   Vad() {
     state_ = WebRtcVad_Create();
     RTC_CHECK(state_);
-    int error = WebRtcVad_Init(state_);
-    RTC_DCHECK_EQ(0, error);
+    Initialize();
   }
   ~Vad() {
     WebRtcVad_Free(state_);
   }
+  void Initialize() {
+    int error = WebRtcVad_Init(state_);
+    RTC_DCHECK_EQ(0, error);
+  }
   VadInst* state() { return state_; }
  private:
   VadInst* state_ = nullptr;
@@ -41,11 +44,14 @@ VoiceDetectionImpl::~VoiceDetectionImpl() {}
 void VoiceDetectionImpl::Initialize(int sample_rate_hz) {
   rtc::CritScope cs(crit_);
   sample_rate_hz_ = sample_rate_hz;
-  rtc::scoped_ptr<Vad> new_vad;
-  if (enabled_) {
-    new_vad.reset(new Vad());
+  if (!enabled_) {
+    vad_.reset();
+  } else if (vad_) {
+    // Reinitialize in place to avoid reallocating.
+    vad_->Initialize();
+  } else {
+    vad_.reset(new Vad());
   }
-  vad_.swap(new_vad);
   using_external_vad_ = false;
   frame_size_samples_ =
       static_cast<size_t>(frame_size_ms_ * sample_rate_hz_) / 1000;
@@ -10,8 +10,6 @@
 
 #include "webrtc/modules/desktop_capture/desktop_and_cursor_composer.h"
 
-#include <string.h>
-
 #include "webrtc/modules/desktop_capture/desktop_capturer.h"
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
 #include "webrtc/modules/desktop_capture/mouse_cursor.h"
@@ -20,37 +18,6 @@ namespace webrtc {
 
 namespace {
 
-// Helper function that blends one image into another. Source image must be
-// pre-multiplied with the alpha channel. Destination is assumed to be opaque.
-void AlphaBlend(uint8_t* dest, int dest_stride,
-                const uint8_t* src, int src_stride,
-                const DesktopSize& size) {
-  for (int y = 0; y < size.height(); ++y) {
-    for (int x = 0; x < size.width(); ++x) {
-      uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
-      if (base_alpha == 255) {
-        continue;
-      } else if (base_alpha == 0) {
-        memcpy(dest + x * DesktopFrame::kBytesPerPixel,
-               src + x * DesktopFrame::kBytesPerPixel,
-               DesktopFrame::kBytesPerPixel);
-      } else {
-        dest[x * DesktopFrame::kBytesPerPixel] =
-            dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel];
-        dest[x * DesktopFrame::kBytesPerPixel + 1] =
-            dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 1];
-        dest[x * DesktopFrame::kBytesPerPixel + 2] =
-            dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 2];
-      }
-    }
-    src += src_stride;
-    dest += dest_stride;
-  }
-}
-
 // DesktopFrame wrapper that draws mouse on a frame and restores original
 // content before releasing the underlying frame.
 class DesktopFrameWithCursor : public DesktopFrame {
@@ -83,7 +50,6 @@ DesktopFrameWithCursor::DesktopFrameWithCursor(DesktopFrame* frame,
   DesktopVector image_pos = position.subtract(cursor.hotspot());
   DesktopRect target_rect = DesktopRect::MakeSize(cursor.image()->size());
   target_rect.Translate(image_pos);
-  DesktopVector target_origin = target_rect.top_left();
   target_rect.IntersectWith(DesktopRect::MakeSize(size()));
 
   if (target_rect.is_empty())
@@ -96,16 +62,7 @@ DesktopFrameWithCursor::DesktopFrameWithCursor(DesktopFrame* frame,
                                  DesktopRect::MakeSize(restore_frame_->size()));
 
   // Blit the cursor.
-  uint8_t* target_rect_data = reinterpret_cast<uint8_t*>(data()) +
-                              target_rect.top() * stride() +
-                              target_rect.left() * DesktopFrame::kBytesPerPixel;
-  DesktopVector origin_shift = target_rect.top_left().subtract(target_origin);
-  AlphaBlend(target_rect_data, stride(),
-             cursor.image()->data() +
-                 origin_shift.y() * cursor.image()->stride() +
-                 origin_shift.x() * DesktopFrame::kBytesPerPixel,
-             cursor.image()->stride(),
-             target_rect.size());
+  DrawMouseCursor(cursor, position, this);
 }
 
 DesktopFrameWithCursor::~DesktopFrameWithCursor() {
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/desktop_frame_to_i420.h"
+
+#include <algorithm>
+
+#include "libyuv/convert.h"  // NOLINT
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/mouse_cursor.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kMacroblockSize = 16;
+
+int RoundDownToMacroblock(int value) {
+  return value / kMacroblockSize * kMacroblockSize;
+}
+
+int RoundUpToMacroblock(int value) {
+  return RoundDownToMacroblock(value + kMacroblockSize - 1);
+}
+
+}  // namespace
+
+bool ConvertDesktopFrameToI420(const DesktopFrame& frame,
+                               const MouseCursor* cursor,
+                               const DesktopVector& cursor_position,
+                               uint8_t* dst_y,
+                               int dst_stride_y,
+                               uint8_t* dst_u,
+                               int dst_stride_u,
+                               uint8_t* dst_v,
+                               int dst_stride_v) {
+  // DesktopFrame pixels are BGRA in memory, which libyuv calls ARGB.
+  if (libyuv::ARGBToI420(frame.data(), frame.stride(), dst_y, dst_stride_y,
+                         dst_u, dst_stride_u, dst_v, dst_stride_v,
+                         frame.size().width(), frame.size().height()) != 0) {
+    return false;
+  }
+
+  if (!cursor || !cursor->image())
+    return true;
+
+  DesktopRect cursor_rect = DesktopRect::MakeOriginSize(
+      cursor_position.subtract(cursor->hotspot()), cursor->image()->size());
+  cursor_rect.IntersectWith(DesktopRect::MakeSize(frame.size()));
+  if (cursor_rect.is_empty())
+    return true;
+
+  // Whole macroblocks keep the chroma subsampling of the patch aligned with
+  // the rest of the frame.
+  DesktopRect patch_rect = DesktopRect::MakeLTRB(
+      RoundDownToMacroblock(cursor_rect.left()),
+      RoundDownToMacroblock(cursor_rect.top()),
+      std::min(RoundUpToMacroblock(cursor_rect.right()), frame.size().width()),
+      std::min(RoundUpToMacroblock(cursor_rect.bottom()),
+               frame.size().height()));
+  BasicDesktopFrame patch(patch_rect.size());
+  patch.CopyPixelsFrom(frame, patch_rect.top_left(),
+                       DesktopRect::MakeSize(patch.size()));
+  DrawMouseCursor(*cursor, cursor_position.subtract(patch_rect.top_left()),
+                  &patch);
+
+  const int left = patch_rect.left();
+  const int top = patch_rect.top();
+  return libyuv::ARGBToI420(
+             patch.data(), patch.stride(),
+             dst_y + top * dst_stride_y + left, dst_stride_y,
+             dst_u + top / 2 * dst_stride_u + left / 2, dst_stride_u,
+             dst_v + top / 2 * dst_stride_v + left / 2, dst_stride_v,
+             patch.size().width(), patch.size().height()) == 0;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_TO_I420_H_
+#define WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_TO_I420_H_
+
+#include "webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class DesktopFrame;
+class MouseCursor;
+
+// Converts |frame| to I420, written to planes the size of the frame, with
+// |cursor| drawn with its hotspot at |cursor_position|. |cursor| may be NULL.
+//
+// The frame is converted straight from the capture buffer and isn't modified.
+// Only the macroblocks under the cursor are copied, blended with the cursor
+// and converted again over the output, so unlike converting the frames from
+// DesktopAndCursorComposer, the cursor doesn't have to be drawn into the
+// frame and the frame restored afterwards. Returns false if the conversion
+// fails.
+bool ConvertDesktopFrameToI420(const DesktopFrame& frame,
+                               const MouseCursor* cursor,
+                               const DesktopVector& cursor_position,
+                               uint8_t* dst_y,
+                               int dst_stride_y,
+                               uint8_t* dst_u,
+                               int dst_stride_u,
+                               uint8_t* dst_v,
+                               int dst_stride_v);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_TO_I420_H_
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/desktop_frame_to_i420.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "libyuv/convert.h"  // NOLINT
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/mouse_cursor.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kFrameWidth = 100;
+const int kFrameHeight = 70;
+const int kCursorSize = 20;
+
+struct I420Image {
+  I420Image(int width, int height)
+      : width(width),
+        height(height),
+        chroma_width((width + 1) / 2),
+        y(width * height),
+        u(chroma_width * ((height + 1) / 2)),
+        v(u.size()) {}
+
+  int width;
+  int height;
+  int chroma_width;
+  std::vector<uint8_t> y;
+  std::vector<uint8_t> u;
+  std::vector<uint8_t> v;
+};
+
+void FillFrame(DesktopFrame* frame, uint32_t seed, uint8_t alpha) {
+  for (int y = 0; y < frame->size().height(); ++y) {
+    uint32_t* row =
+        reinterpret_cast<uint32_t*>(frame->data() + y * frame->stride());
+    for (int x = 0; x < frame->size().width(); ++x) {
+      uint32_t value = (seed + 7 * x + 13 * y) & 0xff;
+      uint32_t color = (value * 0x010203) & 0xffffff;
+      // Keep the channels pre-multiplied, i.e. no larger than alpha.
+      if (alpha != 0xff)
+        color = value < alpha ? value * 0x010101 : 0;
+      row[x] = (static_cast<uint32_t>(alpha) << 24) | color;
+    }
+  }
+}
+
+bool ConvertReference(const DesktopFrame& frame, I420Image* image) {
+  return libyuv::ARGBToI420(frame.data(), frame.stride(), &image->y[0],
+                            image->width, &image->u[0], image->chroma_width,
+                            &image->v[0], image->chroma_width,
+                            frame.size().width(),
+                            frame.size().height()) == 0;
+}
+
+bool Convert(const DesktopFrame& frame,
+             const MouseCursor* cursor,
+             const DesktopVector& position,
+             I420Image* image) {
+  return ConvertDesktopFrameToI420(frame, cursor, position, &image->y[0],
+                                   image->width, &image->u[0],
+                                   image->chroma_width, &image->v[0],
+                                   image->chroma_width);
+}
+
+void ExpectEqual(const I420Image& expected, const I420Image& actual) {
+  EXPECT_TRUE(expected.y == actual.y);
+  EXPECT_TRUE(expected.u == actual.u);
+  EXPECT_TRUE(expected.v == actual.v);
+}
+
+class DesktopFrameToI420Test : public testing::Test {
+ protected:
+  DesktopFrameToI420Test()
+      : frame_(new BasicDesktopFrame(DesktopSize(kFrameWidth, kFrameHeight))) {
+    FillFrame(frame_.get(), 0, 0xff);
+    DesktopFrame* image =
+        new BasicDesktopFrame(DesktopSize(kCursorSize, kCursorSize));
+    FillFrame(image, 100, 0x80);
+    cursor_.reset(new MouseCursor(image, DesktopVector(3, 5)));
+  }
+
+  // Checks that the conversion matches drawing the cursor into a copy of the
+  // frame and converting that, and that the frame isn't modified.
+  void TestCursorAt(const DesktopVector& position) {
+    rtc::scoped_ptr<DesktopFrame> expected_frame(
+        BasicDesktopFrame::CopyOf(*frame_));
+    DrawMouseCursor(*cursor_, position, expected_frame.get());
+    I420Image expected(kFrameWidth, kFrameHeight);
+    ASSERT_TRUE(ConvertReference(*expected_frame, &expected));
+
+    rtc::scoped_ptr<DesktopFrame> original_frame(
+        BasicDesktopFrame::CopyOf(*frame_));
+    I420Image actual(kFrameWidth, kFrameHeight);
+    ASSERT_TRUE(Convert(*frame_, cursor_.get(), position, &actual));
+    ExpectEqual(expected, actual);
+    EXPECT_EQ(0, memcmp(original_frame->data(), frame_->data(),
+                        frame_->stride() * kFrameHeight));
+  }
+
+  rtc::scoped_ptr<DesktopFrame> frame_;
+  rtc::scoped_ptr<MouseCursor> cursor_;
+};
+
+}  // namespace
+
+TEST_F(DesktopFrameToI420Test, NoCursor) {
+  I420Image expected(kFrameWidth, kFrameHeight);
+  ASSERT_TRUE(ConvertReference(*frame_, &expected));
+  I420Image actual(kFrameWidth, kFrameHeight);
+  ASSERT_TRUE(Convert(*frame_, nullptr, DesktopVector(), &actual));
+  ExpectEqual(expected, actual);
+}
+
+TEST_F(DesktopFrameToI420Test, CursorInside) {
+  TestCursorAt(DesktopVector(37, 21));
+}
+
+TEST_F(DesktopFrameToI420Test, CursorOnEdges) {
+  TestCursorAt(DesktopVector(0, 0));
+  TestCursorAt(DesktopVector(kFrameWidth - 1, kFrameHeight - 1));
+  TestCursorAt(DesktopVector(kFrameWidth - 7, 2));
+}
+
+TEST_F(DesktopFrameToI420Test, CursorOutside) {
+  TestCursorAt(DesktopVector(-kCursorSize, 10));
+  TestCursorAt(DesktopVector(10, kFrameHeight + 10));
+}
+
+}  // namespace webrtc
@@ -13,7 +13,13 @@
 #include <string.h>
 
 #include "webrtc/typedefs.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/modules/desktop_capture/differ_block_avx2.h"
 #include "webrtc/modules/desktop_capture/differ_block_sse2.h"
+#endif
+#if defined(WEBRTC_HAS_NEON) || defined(WEBRTC_DETECT_NEON)
+#include "webrtc/modules/desktop_capture/differ_block_neon.h"
+#endif
 #include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
@@ -38,20 +44,29 @@ bool BlockDifference(const uint8_t* image1,
   static bool (*diff_proc)(const uint8_t*, const uint8_t*, int) = NULL;
 
   if (!diff_proc) {
-#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
-    diff_proc = &BlockDifference_C;
-#else
+#if defined(WEBRTC_ARCH_X86_FAMILY)
     bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
+    // For x86 processors, check if AVX2 or SSE2 is supported.
+    if (kBlockSize == 32 && WebRtc_GetCPUInfo(kAVX2)) {
+      diff_proc = &BlockDifference_AVX2_W32;
+    } else if (have_sse2 && kBlockSize == 32) {
       diff_proc = &BlockDifference_SSE2_W32;
     } else if (have_sse2 && kBlockSize == 16) {
       diff_proc = &BlockDifference_SSE2_W16;
     } else {
       diff_proc = &BlockDifference_C;
     }
+#elif defined(WEBRTC_HAS_NEON)
+    diff_proc = kBlockSize == 32 ? &BlockDifference_NEON_W32
+                                 : &BlockDifference_C;
+#elif defined(WEBRTC_DETECT_NEON)
+    diff_proc = kBlockSize == 32 &&
+                        (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) != 0
+                    ? &BlockDifference_NEON_W32
+                    : &BlockDifference_C;
+#else
+    // For MIPS and other processors, always use C version.
+    diff_proc = &BlockDifference_C;
 #endif
   }
 
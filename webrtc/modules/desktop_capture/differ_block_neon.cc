@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_block_neon.h"
+
+#include <arm_neon.h>
+
+#include "webrtc/modules/desktop_capture/differ_block.h"
+
+namespace webrtc {
+
+extern bool BlockDifference_NEON_W32(const uint8_t* image1,
+                                     const uint8_t* image2,
+                                     int stride) {
+  // A row of the block is 128 bytes, eight registers. Only equality matters,
+  // so xor the rows and test whether any bit is set.
+  for (int y = 0; y < kBlockSize; ++y) {
+    uint8x16_t diff = veorq_u8(vld1q_u8(image1), vld1q_u8(image2));
+    for (int x = 16; x < kBlockSize * kBytesPerPixel; x += 16) {
+      diff = vorrq_u8(diff,
+                      veorq_u8(vld1q_u8(image1 + x), vld1q_u8(image2 + x)));
+    }
+    const uint64x2_t diff64 = vreinterpretq_u64_u8(diff);
+    if (vgetq_lane_u64(diff64, 0) | vgetq_lane_u64(diff64, 1))
+      return true;
+    image1 += stride;
+    image2 += stride;
+  }
+  return false;
+}
+
+}  // namespace webrtc
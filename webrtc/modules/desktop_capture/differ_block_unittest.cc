@@ -10,6 +10,10 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "webrtc/modules/desktop_capture/differ_block.h"
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "webrtc/modules/desktop_capture/differ_block_avx2.h"
+#endif
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/include/ref_count.h"
 
 namespace webrtc {
@@ -84,4 +88,23 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+// BlockDifference() only runs one of the implementations, so test the others
+// separately where the CPU supports them.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(BlockDifferenceTestAVX2, EveryByte) {
+  if (kBlockSize != 32 || !WebRtc_GetCPUInfo(kAVX2))
+    return;
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+  const int stride = kBlockSize * kBytesPerPixel;
+  EXPECT_FALSE(BlockDifference_AVX2_W32(block1, block2, stride));
+  for (int i = 0; i < kSizeOfBlock; ++i) {
+    block2[i] += 1;
+    EXPECT_TRUE(BlockDifference_AVX2_W32(block1, block2, stride)) << i;
+    block2[i] -= 1;
+  }
+}
+#endif
+
 }  // namespace webrtc
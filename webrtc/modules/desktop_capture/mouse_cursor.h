@@ -43,6 +43,13 @@ class MouseCursor {
   RTC_DISALLOW_COPY_AND_ASSIGN(MouseCursor);
 };
 
+// Blends |cursor| into |frame| with its hotspot at |position|, clipping it to
+// the frame. The cursor image must be pre-multiplied with the alpha channel,
+// and |frame| is assumed to be opaque.
+void DrawMouseCursor(const MouseCursor& cursor,
+                     const DesktopVector& position,
+                     DesktopFrame* frame);
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_MOUSE_CURSOR_H_
@@ -69,11 +69,12 @@ class ScreenCapturerLinux : public ScreenCapturer,
   void ScreenConfigurationChanged();
 
   // Synchronize the current buffer with |last_buffer_|, by copying pixels from
-  // the area of |last_invalid_rects|.
+  // the area of |last_invalid_rects|, except for |captured_region|, which is
+  // about to be captured anyway.
   // Note this only works on the assumption that kNumBuffers == 2, as
   // |last_invalid_rects| holds the differences from the previous buffer and
   // the one prior to that (which will then be the current buffer).
-  void SynchronizeFrame();
+  void SynchronizeFrame(const DesktopRegion& captured_region);
 
   void DeinitXlib();
 
@@ -314,13 +315,6 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
   // expands that region to a grid.
   helper_.set_size_most_recent(frame->size());
 
-  // In the DAMAGE case, ensure the frame is up-to-date with the previous frame
-  // if any.  If there isn't a previous frame, that means a screen-resolution
-  // change occurred, and |invalid_rects| will be updated to include the whole
-  // screen.
-  if (use_damage_ && queue_.previous_frame())
-    SynchronizeFrame();
-
   DesktopRegion* updated_region = frame->mutable_updated_region();
 
   x_server_pixel_buffer_.Synchronize();
@@ -347,6 +341,11 @@ DesktopFrame* ScreenCapturerLinux::CaptureScreen() {
     updated_region->IntersectWith(
         DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
 
+    // In the DAMAGE case, ensure the frame is up-to-date with the previous
+    // frame. If there isn't a previous frame, that means a screen-resolution
+    // change occurred, and the whole screen is captured below.
+    SynchronizeFrame(*updated_region);
+
     for (DesktopRegion::Iterator it(*updated_region);
          !it.IsAtEnd(); it.Advance()) {
       x_server_pixel_buffer_.CaptureRect(it.rect(), frame);
@@ -387,21 +386,22 @@ void ScreenCapturerLinux::ScreenConfigurationChanged() {
   }
 }
 
-void ScreenCapturerLinux::SynchronizeFrame() {
+void ScreenCapturerLinux::SynchronizeFrame(
+    const DesktopRegion& captured_region) {
   // Synchronize the current buffer with the previous one since we do not
   // capture the entire desktop. Note that encoder may be reading from the
   // previous buffer at this time so thread access complaints are false
   // positives.
-
-  // TODO(hclam): We can reduce the amount of copying here by subtracting
-  // |capturer_helper_|s region from |last_invalid_region_|.
-  // http://crbug.com/92354
   RTC_DCHECK(queue_.previous_frame());
 
+  // Pixels that are captured again don't need to be copied first.
+  DesktopRegion copy_region(last_invalid_region_);
+  copy_region.Subtract(captured_region);
+
   DesktopFrame* current = queue_.current_frame();
   DesktopFrame* last = queue_.previous_frame();
   RTC_DCHECK(current != last);
-  for (DesktopRegion::Iterator it(last_invalid_region_);
+  for (DesktopRegion::Iterator it(copy_region);
        !it.IsAtEnd(); it.Advance()) {
     current->CopyPixelsFrom(*last, it.rect().top_left(), it.rect());
   }
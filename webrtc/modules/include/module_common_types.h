@@ -540,6 +540,14 @@ class AudioFrame {
   // TODO(henrike) Remove |energy_|.
   // See https://code.google.com/p/webrtc/issues/detail?id=3315.
   uint32_t energy_;
+  // Sum of the squared samples and the largest sample magnitude, computed in
+  // one pass by AudioFrameOperations::UpdateLevel() so that the level
+  // indicators, the RTP audio level and the mixer can share it.
+  // |sum_squares_| is -1 when they are not known for the current samples.
+  // The methods below keep them up to date; code which writes |data_|
+  // directly must reset |sum_squares_| if the frame may carry a level.
+  int64_t sum_squares_;
+  int max_abs_;
   bool interleaved_;
 
  private:
@@ -564,6 +572,8 @@ inline void AudioFrame::Reset() {
   speech_type_ = kUndefined;
   vad_activity_ = kVadUnknown;
   energy_ = 0xffffffff;
+  sum_squares_ = -1;
+  max_abs_ = 0;
   interleaved_ = true;
 }
 
@@ -589,9 +599,12 @@ inline void AudioFrame::UpdateFrame(int id,
   assert(length <= kMaxDataSizeSamples);
   if (data != NULL) {
     memcpy(data_, data, sizeof(int16_t) * length);
+    sum_squares_ = -1;
   } else {
     memset(data_, 0, sizeof(int16_t) * length);
+    sum_squares_ = 0;
   }
+  max_abs_ = 0;
 }
 
 inline void AudioFrame::CopyFrom(const AudioFrame& src) {
@@ -607,6 +620,8 @@ inline void AudioFrame::CopyFrom(const AudioFrame& src) {
   vad_activity_ = src.vad_activity_;
   num_channels_ = src.num_channels_;
   energy_ = src.energy_;
+  sum_squares_ = src.sum_squares_;
+  max_abs_ = src.max_abs_;
   interleaved_ = src.interleaved_;
 
   const size_t length = samples_per_channel_ * num_channels_;
@@ -616,6 +631,8 @@ inline void AudioFrame::CopyFrom(const AudioFrame& src) {
 
 inline void AudioFrame::Mute() {
   memset(data_, 0, samples_per_channel_ * num_channels_ * sizeof(int16_t));
+  sum_squares_ = 0;
+  max_abs_ = 0;
 }
 
 inline AudioFrame& AudioFrame::operator>>=(const int rhs) {
@@ -625,6 +642,7 @@ inline AudioFrame& AudioFrame::operator>>=(const int rhs) {
   for (size_t i = 0; i < samples_per_channel_ * num_channels_; i++) {
     data_[i] = static_cast<int16_t>(data_[i] >> rhs);
   }
+  sum_squares_ = -1;
   return *this;
 }
 
@@ -649,6 +667,7 @@ inline AudioFrame& AudioFrame::Append(const AudioFrame& rhs) {
     data_[offset + i] = rhs.data_[i];
   }
   samples_per_channel_ += rhs.samples_per_channel_;
+  sum_squares_ = -1;
   return *this;
 }
 
@@ -702,6 +721,7 @@ inline AudioFrame& AudioFrame::operator+=(const AudioFrame& rhs) {
     }
   }
   energy_ = 0xffffffff;
+  sum_squares_ = -1;
   return *this;
 }
 
@@ -726,6 +746,7 @@ inline AudioFrame& AudioFrame::operator-=(const AudioFrame& rhs) {
     data_[i] = ClampToInt16(wrap_guard);
   }
   energy_ = 0xffffffff;
+  sum_squares_ = -1;
   return *this;
 }
 
@@ -0,0 +1,208 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_INCLUDE_SEQUENCE_NUMBER_BITSET_H_
+#define WEBRTC_MODULES_INCLUDE_SEQUENCE_NUMBER_BITSET_H_
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// A set of RTP sequence numbers, such as the ones a receiver is missing, kept
+// as one bit per sequence number. Inserting, erasing and looking up a sequence
+// number take constant time, ranges are inserted and erased a 64-bit word at a
+// time, and members are visited by skipping from set bit to set bit rather
+// than from node to node as in a std::set.
+//
+// Members are ordered as IsNewerSequenceNumber() orders them, from the oldest
+// one, so they must all lie within half the sequence number space of it.
+class SequenceNumberBitset {
+ public:
+  SequenceNumberBitset() : oldest_(0), size_(0) {
+    memset(words_, 0, sizeof(words_));
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // The oldest member. Must not be called on an empty set.
+  uint16_t oldest() const {
+    RTC_DCHECK(!empty());
+    return oldest_;
+  }
+
+  bool Contains(uint16_t sequence_number) const {
+    return (words_[sequence_number / kBitsPerWord] & Bit(sequence_number)) !=
+           0;
+  }
+
+  // Returns false if |sequence_number| already is a member.
+  bool Insert(uint16_t sequence_number) {
+    uint64_t& word = words_[sequence_number / kBitsPerWord];
+    const uint64_t bit = Bit(sequence_number);
+    if (word & bit)
+      return false;
+    word |= bit;
+    if (size_ == 0 || IsNewerSequenceNumber(oldest_, sequence_number))
+      oldest_ = sequence_number;
+    ++size_;
+    return true;
+  }
+
+  // Inserts the sequence numbers from |first| up to, but not including, |end|.
+  void InsertRange(uint16_t first, uint16_t end) {
+    if (first == end)
+      return;
+    size_t count = 0;
+    for (uint16_t i = first; i != end;) {
+      const int offset = i % kBitsPerWord;
+      const int bits = std::min<int>(kBitsPerWord - offset,
+                                     static_cast<uint16_t>(end - i));
+      const uint64_t mask = Mask(offset, bits);
+      uint64_t& word = words_[i / kBitsPerWord];
+      count += PopCount(mask & ~word);
+      word |= mask;
+      i += bits;
+    }
+    if (size_ == 0 || IsNewerSequenceNumber(oldest_, first))
+      oldest_ = first;
+    size_ += count;
+  }
+
+  // Returns false if |sequence_number| is not a member.
+  bool Erase(uint16_t sequence_number) {
+    uint64_t& word = words_[sequence_number / kBitsPerWord];
+    const uint64_t bit = Bit(sequence_number);
+    if (!(word & bit))
+      return false;
+    word &= ~bit;
+    --size_;
+    if (size_ > 0 && sequence_number == oldest_)
+      oldest_ = NextMember(sequence_number);
+    return true;
+  }
+
+  // Erases every member that is not newer than |last|.
+  void EraseUpTo(uint16_t last) {
+    if (size_ == 0 || IsNewerSequenceNumber(oldest_, last))
+      return;
+    const uint16_t end = last + 1;
+    for (uint16_t i = oldest_; i != end && size_ > 0;) {
+      const int offset = i % kBitsPerWord;
+      const int bits = std::min<int>(kBitsPerWord - offset,
+                                     static_cast<uint16_t>(end - i));
+      uint64_t& word = words_[i / kBitsPerWord];
+      const uint64_t erased = word & Mask(offset, bits);
+      size_ -= PopCount(erased);
+      word &= ~erased;
+      i += bits;
+    }
+    if (size_ > 0)
+      oldest_ = NextMember(end);
+  }
+
+  void Clear() {
+    // Only the words holding members need to be cleared.
+    uint16_t word_index = oldest_ / kBitsPerWord;
+    while (size_ > 0) {
+      size_ -= PopCount(words_[word_index]);
+      words_[word_index] = 0;
+      word_index = (word_index + 1) % kNumWords;
+    }
+  }
+
+  // Calls |visitor| with each member, from the oldest to the newest, until it
+  // returns false.
+  template <typename Visitor>
+  void ForEach(Visitor visitor) const {
+    size_t left = size_;
+    if (left == 0)
+      return;
+    int word_index = oldest_ / kBitsPerWord;
+    uint64_t word = words_[word_index] & ~(Bit(oldest_) - 1);
+    while (true) {
+      while (word == 0) {
+        word_index = (word_index + 1) % kNumWords;
+        word = words_[word_index];
+      }
+      const uint16_t sequence_number = static_cast<uint16_t>(
+          word_index * kBitsPerWord + CountTrailingZeros(word));
+      if (!visitor(sequence_number) || --left == 0)
+        return;
+      word &= word - 1;
+    }
+  }
+
+ private:
+  static const int kBitsPerWord = 64;
+  static const int kNumWords = (1 << 16) / kBitsPerWord;
+
+  static uint64_t Bit(uint16_t sequence_number) {
+    return uint64_t{1} << (sequence_number % kBitsPerWord);
+  }
+
+  // |bits| set bits starting at bit |offset|.
+  static uint64_t Mask(int offset, int bits) {
+    const uint64_t low_bits =
+        bits == kBitsPerWord ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    return low_bits << offset;
+  }
+
+  static int CountTrailingZeros(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while ((word & 1) == 0) {
+      word >>= 1;
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  static size_t PopCount(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    size_t count = 0;
+    for (; word != 0; word &= word - 1)
+      ++count;
+    return count;
+#endif
+  }
+
+  // The first member at or after |sequence_number|. The set must not be
+  // empty.
+  uint16_t NextMember(uint16_t sequence_number) const {
+    int word_index = sequence_number / kBitsPerWord;
+    uint64_t word = words_[word_index] & ~(Bit(sequence_number) - 1);
+    while (word == 0) {
+      word_index = (word_index + 1) % kNumWords;
+      word = words_[word_index];
+    }
+    return static_cast<uint16_t>(word_index * kBitsPerWord +
+                                 CountTrailingZeros(word));
+  }
+
+  uint64_t words_[kNumWords];
+  uint16_t oldest_;
+  size_t size_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_INCLUDE_SEQUENCE_NUMBER_BITSET_H_
@@ -172,6 +172,7 @@
                 'audio_coding/codecs/isac/main/source/isac_unittest.cc',
                 'audio_coding/codecs/isac/unittest.cc',
                 'audio_coding/codecs/opus/audio_encoder_opus_unittest.cc',
+                'audio_coding/codecs/opus/opus_complexity_controller_unittest.cc',
                 'audio_coding/codecs/opus/opus_unittest.cc',
                 'audio_coding/codecs/red/audio_encoder_copy_red_unittest.cc',
                 'audio_coding/neteq/audio_classifier_unittest.cc',
@@ -218,6 +219,8 @@
                 'audio_coding/neteq/tools/input_audio_file_unittest.cc',
                 'audio_coding/neteq/tools/packet_unittest.cc',
                 'audio_conference_mixer/test/audio_conference_mixer_unittest.cc',
+                'audio_conference_mixer/test/lookahead_limiter_unittest.cc',
+                'audio_conference_mixer/test/memory_pool_unittest.cc',
                 'audio_device/fine_audio_buffer_unittest.cc',
                 'audio_processing/aec/echo_cancellation_unittest.cc',
                 'audio_processing/aec/system_delay_unittest.cc',
@@ -226,6 +229,8 @@
                 # 'audio_processing/agc/agc_unittest.cc',
                 'audio_processing/agc/histogram_unittest.cc',
                 'audio_processing/agc/mock_agc.h',
+                'audio_processing/audio_buffer_unittest.cc',
+                'audio_processing/batched_audio_processing_unittest.cc',
                 'audio_processing/beamformer/array_util_unittest.cc',
                 'audio_processing/beamformer/complex_matrix_unittest.cc',
                 'audio_processing/beamformer/covariance_matrix_generator_unittest.cc',
@@ -257,6 +262,7 @@
                 'bitrate_controller/bitrate_controller_unittest.cc',
                 'bitrate_controller/send_side_bandwidth_estimation_unittest.cc',
                 'desktop_capture/desktop_and_cursor_composer_unittest.cc',
+                'desktop_capture/desktop_frame_to_i420_unittest.cc',
                 'desktop_capture/desktop_region_unittest.cc',
                 'desktop_capture/differ_block_unittest.cc',
                 'desktop_capture/differ_unittest.cc',
@@ -273,6 +279,7 @@
                 'module_common_types_unittest.cc',
                 'pacing/bitrate_prober_unittest.cc',
                 'pacing/paced_sender_unittest.cc',
+                'pacing/pacer_thread_pool_unittest.cc',
                 'pacing/packet_router_unittest.cc',
                 'remote_bitrate_estimator/bwe_simulations.cc',
                 'remote_bitrate_estimator/include/mock/mock_remote_bitrate_observer.h',
@@ -286,6 +293,7 @@
                 'remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h',
                 'remote_bitrate_estimator/remote_estimator_proxy_unittest.cc',
                 'remote_bitrate_estimator/send_time_history_unittest.cc',
+                'remote_bitrate_estimator/test/bwe_scenario_runner_unittest.cc',
                 'remote_bitrate_estimator/test/bwe_test_framework_unittest.cc',
                 'remote_bitrate_estimator/test/bwe_unittest.cc',
                 'remote_bitrate_estimator/test/metric_recorder_unittest.cc',
@@ -294,6 +302,8 @@
                 'rtp_rtcp/source/mock/mock_rtp_payload_strategy.h',
                 'rtp_rtcp/source/byte_io_unittest.cc',
                 'rtp_rtcp/source/fec_receiver_unittest.cc',
+                'rtp_rtcp/source/fec_xor_unittest.cc',
+                'rtp_rtcp/source/flexfec_unittest.cc',
                 'rtp_rtcp/source/fec_test_helper.cc',
                 'rtp_rtcp/source/fec_test_helper.h',
                 'rtp_rtcp/source/h264_sps_parser_unittest.cc',
@@ -311,6 +321,7 @@
                 'rtp_rtcp/source/rtcp_packet/dlrr_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/extended_jitter_report_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/nack_unittest.cc',
+                'rtp_rtcp/source/rtcp_packet/packet_view_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/pli_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/receiver_report_unittest.cc',
                 'rtp_rtcp/source/rtcp_packet/report_block_unittest.cc',
@@ -341,9 +352,12 @@
                 'rtp_rtcp/test/testAPI/test_api_audio.cc',
                 'rtp_rtcp/test/testAPI/test_api_rtcp.cc',
                 'rtp_rtcp/test/testAPI/test_api_video.cc',
+                'sequence_number_bitset_unittest.cc',
                 'utility/source/audio_frame_operations_unittest.cc',
                 'utility/source/file_player_unittests.cc',
                 'utility/source/process_thread_impl_unittest.cc',
+                'utility/source/process_thread_pool_impl_unittest.cc',
+                'utility/source/rtp_packet_recorder_impl_unittest.cc',
                 'video_coding/codecs/test/packet_manipulator_unittest.cc',
                 'video_coding/codecs/test/stats_unittest.cc',
                 'video_coding/codecs/test/videoprocessor_unittest.cc',
@@ -361,6 +375,7 @@
                 'video_coding/media_optimization_unittest.cc',
                 'video_coding/receiver_unittest.cc',
                 'video_coding/session_info_unittest.cc',
+                'video_coding/temporal_layer_dropper_unittest.cc',
                 'video_coding/timing_unittest.cc',
                 'video_coding/video_coding_robustness_unittest.cc',
                 'video_coding/video_receiver_unittest.cc',
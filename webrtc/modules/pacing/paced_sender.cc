@@ -10,9 +10,7 @@
 
 #include "webrtc/modules/pacing/paced_sender.h"
 
-#include <map>
-#include <queue>
-#include <set>
+#include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -21,11 +19,15 @@
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
 
 namespace {
 // Time limit in milliseconds between packet bursts.
 const int64_t kMinPacketLimitMs = 5;
 
+// Smallest burst when pacing with a shorter interval than kMinPacketLimitMs.
+const int64_t kMinBurstBytes = 1200;
+
 // Upper cap on process interval, in case process has not been called in a long
 // time.
 const int64_t kMaxIntervalTimeMs = 30;
@@ -63,33 +65,24 @@ struct Packet {
   size_t bytes;
   bool retransmission;
   uint64_t enqueue_order;
-  std::list<Packet>::iterator this_it;
-};
-
-// Used by priority queue to sort packets.
-struct Comparator {
-  bool operator()(const Packet* first, const Packet* second) {
-    // Highest prio = 0.
-    if (first->priority != second->priority)
-      return first->priority > second->priority;
-
-    // Retransmissions go first.
-    if (second->retransmission && !first->retransmission)
-      return true;
-
-    // Older frames have higher prio.
-    if (first->capture_time_ms != second->capture_time_ms)
-      return first->capture_time_ms > second->capture_time_ms;
-
-    return first->enqueue_order > second->enqueue_order;
-  }
 };
 
 // Class encapsulating a priority queue with some extensions.
+//
+// Packets are kept in one FIFO per priority, with retransmissions in a FIFO of
+// their own that goes first. Each FIFO is sorted on capture time and then on
+// enqueue order, so that older frames have higher priority. Packets normally
+// arrive in that order, which makes pushing O(1) in practice. The list nodes
+// are recycled rather than freed, so once the queue has reached its high-water
+// mark it no longer allocates.
 class PacketQueue {
  public:
   explicit PacketQueue(Clock* clock)
-      : bytes_(0),
+      : free_nodes_(nullptr),
+        oldest_(nullptr),
+        newest_(nullptr),
+        size_(0),
+        bytes_(0),
         clock_(clock),
         queue_time_sum_(0),
         time_last_updated_(clock_->TimeInMilliseconds()) {}
@@ -101,98 +94,217 @@ class PacketQueue {
 
     UpdateQueueTime(packet.enqueue_time_ms);
 
-    // Store packet in list, use pointers in priority queue for cheaper moves.
-    // Packets have a handle to its own iterator in the list, for easy removal
-    // when popping from queue.
-    packet_list_.push_front(packet);
-    std::list<Packet>::iterator it = packet_list_.begin();
-    it->this_it = it;          // Handle for direct removal from list.
-    prio_queue_.push(&(*it));  // Pointer into list.
+    Node* node = AllocateNode(packet);
+    InsertSorted(&buckets_[BucketIndex(packet)], node);
+    // Also keep all packets in the order they were enqueued.
+    node->older = newest_;
+    node->newer = nullptr;
+    if (newest_)
+      newest_->newer = node;
+    else
+      oldest_ = node;
+    newest_ = node;
+    ++size_;
     bytes_ += packet.bytes;
   }
 
+  // The packet stays in the queue until FinalizePop() is called, so that it
+  // can be put back if sending fails.
   const Packet& BeginPop() {
-    const Packet& packet = *prio_queue_.top();
-    prio_queue_.pop();
-    return packet;
+    RTC_DCHECK(!Empty());
+    const Bucket* bucket = buckets_;
+    while (!bucket->head)
+      ++bucket;
+    return bucket->head->packet;
   }
 
-  void CancelPop(const Packet& packet) { prio_queue_.push(&(*packet.this_it)); }
+  void CancelPop(const Packet& packet) {}
 
   void FinalizePop(const Packet& packet) {
+    Node* node = NodeFromPacket(packet);
     RemoveFromDupeSet(packet);
     bytes_ -= packet.bytes;
     queue_time_sum_ -= (time_last_updated_ - packet.enqueue_time_ms);
-    packet_list_.erase(packet.this_it);
-    RTC_DCHECK_EQ(packet_list_.size(), prio_queue_.size());
-    if (packet_list_.empty())
+
+    Bucket* bucket = &buckets_[BucketIndex(packet)];
+    if (node->prev)
+      node->prev->next = node->next;
+    else
+      bucket->head = node->next;
+    if (node->next)
+      node->next->prev = node->prev;
+    else
+      bucket->tail = node->prev;
+
+    if (node->older)
+      node->older->newer = node->newer;
+    else
+      oldest_ = node->newer;
+    if (node->newer)
+      node->newer->older = node->older;
+    else
+      newest_ = node->older;
+
+    node->next = free_nodes_;
+    free_nodes_ = node;
+    --size_;
+    if (size_ == 0)
       RTC_DCHECK_EQ(0u, queue_time_sum_);
   }
 
-  bool Empty() const { return prio_queue_.empty(); }
+  bool Empty() const { return size_ == 0; }
 
-  size_t SizeInPackets() const { return prio_queue_.size(); }
+  size_t SizeInPackets() const { return size_; }
 
   uint64_t SizeInBytes() const { return bytes_; }
 
   int64_t OldestEnqueueTimeMs() const {
-    auto it = packet_list_.rbegin();
-    if (it == packet_list_.rend())
+    if (!oldest_)
       return 0;
-    return it->enqueue_time_ms;
+    return oldest_->packet.enqueue_time_ms;
   }
 
   void UpdateQueueTime(int64_t timestamp_ms) {
     RTC_DCHECK_GE(timestamp_ms, time_last_updated_);
     int64_t delta = timestamp_ms - time_last_updated_;
-    // Use packet packet_list_.size() not prio_queue_.size() here, as there
-    // might be an outstanding element popped from prio_queue_ currently in the
-    // SendPacket() call, while packet_list_ will always be correct.
-    queue_time_sum_ += delta * packet_list_.size();
+    queue_time_sum_ += delta * size_;
     time_last_updated_ = timestamp_ms;
   }
 
   int64_t AverageQueueTimeMs() const {
-    if (prio_queue_.empty())
+    if (size_ == 0)
       return 0;
-    return queue_time_sum_ / packet_list_.size();
+    return queue_time_sum_ / size_;
   }
 
  private:
+  struct Node {
+    explicit Node(const Packet& packet) : packet(packet) {}
+
+    // Must be the first member, see NodeFromPacket().
+    Packet packet;
+    // Links within the packet's bucket, or the free list for unused nodes.
+    Node* prev;
+    Node* next;
+    // Links in enqueue order.
+    Node* older;
+    Node* newer;
+  };
+
+  struct Bucket {
+    Bucket() : head(nullptr), tail(nullptr) {}
+    Node* head;
+    Node* tail;
+  };
+
+  // Queued sequence numbers of one ssrc, one bit each.
+  struct SsrcSeqNoBitmap {
+    SsrcSeqNoBitmap() : ssrc(0), num_packets(0), bits(1 << 11, 0) {}
+    uint32_t ssrc;
+    size_t num_packets;
+    std::vector<uint32_t> bits;
+  };
+
+  // Two buckets per priority; retransmissions go first.
+  static const size_t kNumBuckets = 2 * (RtpPacketSender::kLowPriority + 1);
+
+  static size_t BucketIndex(const Packet& packet) {
+    return 2 * packet.priority + (packet.retransmission ? 0 : 1);
+  }
+
+  static Node* NodeFromPacket(const Packet& packet) {
+    return reinterpret_cast<Node*>(const_cast<Packet*>(&packet));
+  }
+
+  Node* AllocateNode(const Packet& packet) {
+    Node* node = free_nodes_;
+    if (node) {
+      free_nodes_ = node->next;
+      node->packet = packet;
+    } else {
+      node = new Node(packet);
+      nodes_.push_back(node);
+    }
+    return node;
+  }
+
+  // Inserts after the last packet from the same or an older frame. Since the
+  // enqueue order only grows, this also keeps packets from the same frame in
+  // the order they were enqueued.
+  static void InsertSorted(Bucket* bucket, Node* node) {
+    Node* prev = bucket->tail;
+    while (prev && prev->packet.capture_time_ms > node->packet.capture_time_ms)
+      prev = prev->prev;
+    node->prev = prev;
+    node->next = prev ? prev->next : bucket->head;
+    if (node->next)
+      node->next->prev = node;
+    else
+      bucket->tail = node;
+    if (prev)
+      prev->next = node;
+    else
+      bucket->head = node;
+  }
+
   // Try to add a packet to the set of ssrc/seqno identifiers currently in the
   // queue. Return true if inserted, false if this is a duplicate.
   bool AddToDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    if (it == dupe_map_.end()) {
-      // First for this ssrc, just insert.
-      dupe_map_[packet.ssrc].insert(packet.sequence_number);
-      return true;
+    SsrcSeqNoBitmap* bitmap = FindDupeBitmap(packet.ssrc);
+    if (!bitmap) {
+      // First for this ssrc; reuse the bitmap of one no longer in the queue.
+      for (SsrcSeqNoBitmap& unused : dupe_bitmaps_) {
+        if (unused.num_packets == 0) {
+          bitmap = &unused;
+          break;
+        }
+      }
+      if (!bitmap) {
+        dupe_bitmaps_.push_back(SsrcSeqNoBitmap());
+        bitmap = &dupe_bitmaps_.back();
+      }
+      bitmap->ssrc = packet.ssrc;
     }
 
-    // Insert returns a pair, where second is a bool set to true if new element.
-    return it->second.insert(packet.sequence_number).second;
+    uint32_t& word = bitmap->bits[packet.sequence_number >> 5];
+    const uint32_t bit = 1u << (packet.sequence_number & 31);
+    if (word & bit)
+      return false;
+    word |= bit;
+    ++bitmap->num_packets;
+    return true;
   }
 
   void RemoveFromDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    RTC_DCHECK(it != dupe_map_.end());
-    it->second.erase(packet.sequence_number);
-    if (it->second.empty()) {
-      dupe_map_.erase(it);
+    SsrcSeqNoBitmap* bitmap = FindDupeBitmap(packet.ssrc);
+    RTC_DCHECK(bitmap);
+    bitmap->bits[packet.sequence_number >> 5] &=
+        ~(1u << (packet.sequence_number & 31));
+    --bitmap->num_packets;
+  }
+
+  SsrcSeqNoBitmap* FindDupeBitmap(uint32_t ssrc) {
+    // There are only a handful of ssrcs, so a linear search is fastest.
+    for (SsrcSeqNoBitmap& bitmap : dupe_bitmaps_) {
+      if (bitmap.num_packets > 0 && bitmap.ssrc == ssrc)
+        return &bitmap;
     }
+    return nullptr;
   }
 
-  // List of packets, in the order the were enqueued. Since dequeueing may
-  // occur out of order, use list instead of vector.
-  std::list<Packet> packet_list_;
-  // Priority queue of the packets, sorted according to Comparator.
-  // Use pointers into list, to avoid moving whole struct within heap.
-  std::priority_queue<Packet*, std::vector<Packet*>, Comparator> prio_queue_;
+  // Owns all nodes, whether queued or free.
+  ScopedVector<Node> nodes_;
+  Node* free_nodes_;
+  Bucket buckets_[kNumBuckets];
+  // Oldest and newest packet in enqueue order.
+  Node* oldest_;
+  Node* newest_;
+  size_t size_;
   // Total number of bytes in the queue.
   uint64_t bytes_;
-  // Map<ssrc, set<seq_no> >, for checking duplicates.
-  typedef std::map<uint32_t, std::set<uint16_t> > SsrcSeqNoMap;
-  SsrcSeqNoMap dupe_map_;
+  // Bitmaps of the ssrcs that have, or had, packets in the queue, for
+  // checking duplicates.
+  std::vector<SsrcSeqNoBitmap> dupe_bitmaps_;
   Clock* const clock_;
   int64_t queue_time_sum_;
   int64_t time_last_updated_;
@@ -250,7 +362,8 @@ PacedSender::PacedSender(Clock* clock,
                          int min_bitrate_kbps)
     : clock_(clock),
       callback_(callback),
-      critsect_(CriticalSectionWrapper::CreateCriticalSection()),
+      critsect_(CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+          "PacedSender::critsect_")),
       paused_(false),
       probing_enabled_(true),
       media_budget_(new paced_sender::IntervalBudget(max_bitrate_kbps)),
@@ -258,6 +371,7 @@ PacedSender::PacedSender(Clock* clock,
       prober_(new BitrateProber()),
       bitrate_bps_(1000 * bitrate_kbps),
       max_bitrate_kbps_(max_bitrate_kbps),
+      pacing_interval_ms_(kMinPacketLimitMs),
       time_last_update_us_(clock->TimeInMicroseconds()),
       packets_(new paced_sender::PacketQueue(clock)),
       packet_counter_(0) {
@@ -281,6 +395,12 @@ void PacedSender::SetProbingEnabled(bool enabled) {
   probing_enabled_ = enabled;
 }
 
+void PacedSender::SetPacingIntervalMs(int64_t interval_ms) {
+  RTC_DCHECK_GT(interval_ms, 0);
+  CriticalSectionScoped cs(critsect_.get());
+  pacing_interval_ms_ = interval_ms;
+}
+
 void PacedSender::UpdateBitrate(int bitrate_kbps,
                                 int max_bitrate_kbps,
                                 int min_bitrate_kbps) {
@@ -350,7 +470,20 @@ int64_t PacedSender::TimeUntilNextProcess() {
   }
   int64_t elapsed_time_us = clock_->TimeInMicroseconds() - time_last_update_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
-  return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
+  return std::max<int64_t>(ProcessIntervalMs() - elapsed_time_ms, 0);
+}
+
+int64_t PacedSender::ProcessIntervalMs() const {
+  if (pacing_interval_ms_ >= kMinPacketLimitMs)
+    return pacing_interval_ms_;
+  // Coalesce into bursts of at least kMinBurstBytes, so that low rates don't
+  // wake up the process thread for a fraction of a packet.
+  int rate_kbps = media_budget_->target_rate_kbps();
+  if (rate_kbps <= 0)
+    return kMinPacketLimitMs;
+  int64_t burst_ms = (kMinBurstBytes * 8 + rate_kbps - 1) / rate_kbps;
+  return std::min(kMinPacketLimitMs,
+                  std::max(pacing_interval_ms_, burst_ms));
 }
 
 int32_t PacedSender::Process() {
@@ -366,7 +499,7 @@ int32_t PacedSender::Process() {
       // Assuming equal size packets and input/output rate, the average packet
       // has avg_time_left_ms left to get queue_size_bytes out of the queue, if
       // time constraint shall be met. Determine bitrate needed for that.
-      packets_->UpdateQueueTime(clock_->TimeInMilliseconds());
+      packets_->UpdateQueueTime((now_us + 500) / 1000);
       int64_t avg_time_left_ms = std::max<int64_t>(
           1, kMaxQueueLengthMs - packets_->AverageQueueTimeMs());
       int min_bitrate_needed_kbps =
@@ -384,9 +517,8 @@ int32_t PacedSender::Process() {
     if (media_budget_->bytes_remaining() == 0 && !prober_->IsProbing())
       return 0;
 
-    // Since we need to release the lock in order to send, we first pop the
-    // element from the priority queue but keep it in storage, so that we can
-    // reinsert it if send fails.
+    // Since we need to release the lock in order to send, we first peek at the
+    // next packet and only remove it from the queue once it has been sent.
     const paced_sender::Packet& packet = packets_->BeginPop();
 
     if (SendPacket(packet)) {
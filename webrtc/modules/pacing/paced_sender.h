@@ -86,6 +86,12 @@ class PacedSender : public Module, public RtpPacketSender {
   // effect.
   void SetProbingEnabled(bool enabled);
 
+  // Sets the time between bursts of paced packets, 5 ms by default. Shorter
+  // intervals spread the packets more evenly at the cost of processing more
+  // often. The interval is stretched when the pacing rate is too low to fill
+  // a full size packet per interval, so bursts never shrink below that.
+  void SetPacingIntervalMs(int64_t interval_ms);
+
   // Set target bitrates for the pacer.
   // We will pace out bursts of packets at a bitrate of |max_bitrate_kbps|.
   // |bitrate_kbps| is our estimate of what we are allowed to send on average.
@@ -129,6 +135,9 @@ class PacedSender : public Module, public RtpPacketSender {
   void UpdateBytesPerInterval(int64_t delta_time_in_ms)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
+  // Time between bursts, given the configured interval and the current rate.
+  int64_t ProcessIntervalMs() const EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+
   bool SendPacket(const paced_sender::Packet& packet)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void SendPadding(size_t padding_needed) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
@@ -155,6 +164,7 @@ class PacedSender : public Module, public RtpPacketSender {
   int bitrate_bps_ GUARDED_BY(critsect_);
   int max_bitrate_kbps_ GUARDED_BY(critsect_);
 
+  int64_t pacing_interval_ms_ GUARDED_BY(critsect_);
   int64_t time_last_update_us_ GUARDED_BY(critsect_);
 
   rtc::scoped_ptr<paced_sender::PacketQueue> packets_ GUARDED_BY(critsect_);
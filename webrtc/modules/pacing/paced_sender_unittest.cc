@@ -343,6 +343,50 @@ TEST_F(PacedSenderTest, CanQueuePacketsWithSameSequenceNumberOnDifferentSsrcs) {
   send_bucket_->Process();
 }
 
+TEST_F(PacedSenderTest, ShortPacingInterval) {
+  const int kBitrateKbps = 9600;
+  const size_t kPacketSize = 1200;
+  send_bucket_.reset(
+      new PacedSender(&clock_, &callback_, kBitrateKbps, kBitrateKbps, 0));
+  send_bucket_->SetProbingEnabled(false);
+  send_bucket_->SetPacingIntervalMs(1);
+
+  uint32_t ssrc = 12345;
+  uint16_t sequence_number = 1234;
+  for (int i = 0; i < 30; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                               sequence_number++, clock_.TimeInMilliseconds(),
+                               kPacketSize, false);
+  }
+  EXPECT_CALL(callback_, TimeToSendPadding(_)).Times(0);
+  // Initial budget is for the default interval.
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false))
+      .Times(5)
+      .WillRepeatedly(Return(true));
+  send_bucket_->Process();
+  // After that one packet goes out per millisecond, on average.
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(1, send_bucket_->TimeUntilNextProcess());
+    clock_.AdvanceTimeMilliseconds(1);
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+    EXPECT_EQ(0, send_bucket_->Process());
+    testing::Mock::VerifyAndClearExpectations(&callback_);
+  }
+}
+
+TEST_F(PacedSenderTest, ShortPacingIntervalCoalescesAtLowRate) {
+  // At kPaceMultiplier * kTargetBitrate a full size packet takes 8 ms.
+  send_bucket_->SetPacingIntervalMs(1);
+  EXPECT_EQ(5, send_bucket_->TimeUntilNextProcess());
+  send_bucket_->UpdateBitrate(2400, 2400, 0);
+  send_bucket_->SetPacingIntervalMs(2);
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->Process();
+  EXPECT_EQ(4, send_bucket_->TimeUntilNextProcess());
+}
+
 TEST_F(PacedSenderTest, Padding) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
@@ -833,6 +877,65 @@ TEST_F(PacedSenderTest, PriorityInversion) {
   }
 }
 
+TEST_F(PacedSenderTest, RetransmissionsGoFirstWithinPriority) {
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+  const size_t kPacketSize = 250;
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                             sequence_number + 1, capture_time_ms, kPacketSize,
+                             false);
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                             sequence_number + 2, capture_time_ms, kPacketSize,
+                             false);
+  // Retransmission of a packet from a newer frame.
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                             sequence_number, capture_time_ms + 33,
+                             kPacketSize, true);
+  // A lower priority retransmission still goes last.
+  send_bucket_->InsertPacket(PacedSender::kLowPriority, ssrc,
+                             sequence_number + 3, capture_time_ms - 33,
+                             kPacketSize, true);
+
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number,
+                                            capture_time_ms + 33, true))
+        .WillOnce(Return(true));
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + 1,
+                                            capture_time_ms, false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + 2,
+                                            capture_time_ms, false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + 3,
+                                            capture_time_ms - 33, true))
+        .WillOnce(Return(true));
+
+    while (send_bucket_->QueueSizePackets() > 0) {
+      int time_until_process = send_bucket_->TimeUntilNextProcess();
+      if (time_until_process <= 0) {
+        send_bucket_->Process();
+      } else {
+        clock_.AdvanceTimeMilliseconds(time_until_process);
+      }
+    }
+  }
+
+  // A sequence number that has been sent is no longer a duplicate.
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                             sequence_number, capture_time_ms + 33,
+                             kPacketSize, true);
+  EXPECT_EQ(1u, send_bucket_->QueueSizePackets());
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number,
+                                          capture_time_ms + 33, true))
+      .WillOnce(Return(true));
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->Process();
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+}
+
 TEST_F(PacedSenderTest, PaddingOveruse) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/pacing/pacer_thread_pool.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/include/module.h"
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+namespace {
+// Pacers due within this many milliseconds are processed early rather than
+// getting a wake-up of their own. A pacer accounts for the time that has
+// actually elapsed since it was last processed, so this doesn't change the
+// rate it sends at.
+const int64_t kMaxEarlyProcessMs = 2;
+}  // namespace
+
+// All the pacers of one thread, registered on it as a single module.
+class PacerThreadPool::PacerGroup : public Module {
+ public:
+  PacerGroup()
+      : clock_(Clock::GetRealTimeClock()),
+        thread_(ProcessThread::Create("PacerThread")) {
+    thread_->RegisterModule(this);
+    thread_->Start();
+  }
+
+  ~PacerGroup() override {
+    thread_->Stop();
+    thread_->DeRegisterModule(this);
+    RTC_DCHECK(pacers_.empty());
+  }
+
+  void AddPacer(PacedSender* pacer) {
+    {
+      rtc::CritScope lock(&lock_);
+      // Process the new pacer on the next wake-up.
+      pacers_.push_back(ScheduledPacer(pacer, 0));
+    }
+    thread_->WakeUp(this);
+  }
+
+  bool RemovePacer(PacedSender* pacer) {
+    rtc::CritScope lock(&lock_);
+    for (auto it = pacers_.begin(); it != pacers_.end(); ++it) {
+      if (it->pacer == pacer) {
+        pacers_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t NumPacers() const {
+    rtc::CritScope lock(&lock_);
+    return pacers_.size();
+  }
+
+  int64_t TimeUntilNextProcess() override {
+    rtc::CritScope lock(&lock_);
+    int64_t next_process_ms = std::numeric_limits<int64_t>::max();
+    for (const ScheduledPacer& scheduled : pacers_)
+      next_process_ms = std::min(next_process_ms, scheduled.next_process_ms);
+    if (pacers_.empty())
+      return 1000;
+    return std::max<int64_t>(next_process_ms - clock_->TimeInMilliseconds(),
+                             0);
+  }
+
+  int32_t Process() override {
+    // The lock is held while processing, so that a pacer that has been
+    // removed is never processed again.
+    rtc::CritScope lock(&lock_);
+    int64_t now_ms = clock_->TimeInMilliseconds();
+    for (ScheduledPacer& scheduled : pacers_) {
+      if (scheduled.next_process_ms > now_ms + kMaxEarlyProcessMs)
+        continue;
+      scheduled.pacer->Process();
+      scheduled.next_process_ms =
+          clock_->TimeInMilliseconds() +
+          std::max<int64_t>(scheduled.pacer->TimeUntilNextProcess(), 0);
+    }
+    return 0;
+  }
+
+ private:
+  struct ScheduledPacer {
+    ScheduledPacer(PacedSender* pacer, int64_t next_process_ms)
+        : pacer(pacer), next_process_ms(next_process_ms) {}
+    PacedSender* pacer;
+    int64_t next_process_ms;
+  };
+
+  Clock* const clock_;
+  const rtc::scoped_ptr<ProcessThread> thread_;
+  mutable rtc::CriticalSection lock_;
+  std::vector<ScheduledPacer> pacers_ GUARDED_BY(lock_);
+};
+
+PacerThreadPool::PacerThreadPool(size_t num_threads) {
+  RTC_DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i)
+    groups_.push_back(new PacerGroup());
+}
+
+PacerThreadPool::~PacerThreadPool() {}
+
+void PacerThreadPool::AddPacer(PacedSender* pacer) {
+  PacerGroup* least_loaded = nullptr;
+  size_t min_pacers = std::numeric_limits<size_t>::max();
+  for (PacerGroup* group : groups_) {
+    size_t num_pacers = group->NumPacers();
+    if (num_pacers < min_pacers) {
+      min_pacers = num_pacers;
+      least_loaded = group;
+    }
+  }
+  least_loaded->AddPacer(pacer);
+}
+
+void PacerThreadPool::RemovePacer(PacedSender* pacer) {
+  for (PacerGroup* group : groups_) {
+    if (group->RemovePacer(pacer))
+      return;
+  }
+  RTC_NOTREACHED();
+}
+
+std::vector<size_t> PacerThreadPool::NumPacersPerThread() const {
+  std::vector<size_t> num_pacers;
+  for (const PacerGroup* group : groups_)
+    num_pacers.push_back(group->NumPacers());
+  return num_pacers;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_PACING_PACER_THREAD_POOL_H_
+#define WEBRTC_MODULES_PACING_PACER_THREAD_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+
+namespace webrtc {
+
+class PacedSender;
+
+// Runs the pacers of many calls on a small, fixed number of threads, instead
+// of on a thread per call. Each thread has a single timer for all of its
+// pacers, and pacers that are due at about the same time are processed in
+// the same wake-up. Every pacer keeps its own budgets and queue.
+class PacerThreadPool {
+ public:
+  // Starts |num_threads| threads.
+  explicit PacerThreadPool(size_t num_threads);
+  // All pacers must have been removed.
+  ~PacerThreadPool();
+
+  // Starts processing |pacer| on the least loaded thread. Can be called on any
+  // thread.
+  void AddPacer(PacedSender* pacer);
+
+  // Stops processing |pacer|. Once this returns, the pacer is not being
+  // processed and will not be again. Can be called on any thread.
+  void RemovePacer(PacedSender* pacer);
+
+  // The number of pacers on each thread.
+  std::vector<size_t> NumPacersPerThread() const;
+
+ private:
+  class PacerGroup;
+
+  ScopedVector<PacerGroup> groups_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PacerThreadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_PACING_PACER_THREAD_POOL_H_
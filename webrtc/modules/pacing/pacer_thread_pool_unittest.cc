@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/pacing/pacer_thread_pool.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+const int kTargetBitrateKbps = 800;
+const int kTimeoutMs = 5000;
+
+// Counts the packets sent by one pacer and signals when all have been sent.
+class CountingCallback : public PacedSender::Callback {
+ public:
+  explicit CountingCallback(int expected_packets)
+      : expected_packets_(expected_packets),
+        packets_sent_(0),
+        done_(false, false) {}
+
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission) override {
+    if (rtc::AtomicOps::Increment(&packets_sent_) == expected_packets_)
+      done_.Set();
+    return true;
+  }
+
+  size_t TimeToSendPadding(size_t bytes) override { return 0; }
+
+  bool Wait() { return done_.Wait(kTimeoutMs); }
+
+  int packets_sent() const {
+    return rtc::AtomicOps::AcquireLoad(&packets_sent_);
+  }
+
+ private:
+  const int expected_packets_;
+  volatile int packets_sent_;
+  rtc::Event done_;
+};
+
+PacedSender* CreatePacer(PacedSender::Callback* callback) {
+  PacedSender* pacer =
+      new PacedSender(Clock::GetRealTimeClock(), callback, kTargetBitrateKbps,
+                      PacedSender::kDefaultPaceMultiplier * kTargetBitrateKbps,
+                      0);
+  pacer->SetProbingEnabled(false);
+  return pacer;
+}
+}  // namespace
+
+TEST(PacerThreadPoolTest, SpreadsPacersOverThreads) {
+  PacerThreadPool pool(3);
+  CountingCallback callback(0);
+  ScopedVector<PacedSender> pacers;
+  for (int i = 0; i < 7; ++i) {
+    pacers.push_back(CreatePacer(&callback));
+    pool.AddPacer(pacers.back());
+  }
+  std::vector<size_t> num_pacers = pool.NumPacersPerThread();
+  ASSERT_EQ(3u, num_pacers.size());
+  EXPECT_EQ(3u, num_pacers[0]);
+  EXPECT_EQ(2u, num_pacers[1]);
+  EXPECT_EQ(2u, num_pacers[2]);
+
+  pool.RemovePacer(pacers[1]);
+  num_pacers = pool.NumPacersPerThread();
+  EXPECT_EQ(1u, num_pacers[1]);
+  // New pacers go to the least loaded thread.
+  pacers.push_back(CreatePacer(&callback));
+  pool.AddPacer(pacers.back());
+  EXPECT_EQ(2u, pool.NumPacersPerThread()[1]);
+
+  for (size_t i = 0; i < pacers.size(); ++i) {
+    if (i != 1)
+      pool.RemovePacer(pacers[i]);
+  }
+}
+
+TEST(PacerThreadPoolTest, SendsPacketsOfAllPacers) {
+  const int kNumPacers = 10;
+  const int kPacketsPerPacer = 20;
+  PacerThreadPool pool(2);
+  ScopedVector<CountingCallback> callbacks;
+  ScopedVector<PacedSender> pacers;
+  for (int i = 0; i < kNumPacers; ++i) {
+    callbacks.push_back(new CountingCallback(kPacketsPerPacer));
+    pacers.push_back(CreatePacer(callbacks.back()));
+    pool.AddPacer(pacers.back());
+  }
+  for (int i = 0; i < kNumPacers; ++i) {
+    for (int j = 0; j < kPacketsPerPacer; ++j) {
+      pacers[i]->InsertPacket(PacedSender::kNormalPriority, 1000 + i, j, -1,
+                              250, false);
+    }
+  }
+  for (CountingCallback* callback : callbacks)
+    EXPECT_TRUE(callback->Wait());
+  for (PacedSender* pacer : pacers)
+    pool.RemovePacer(pacer);
+}
+
+TEST(PacerThreadPoolTest, RemovedPacerIsNotProcessed) {
+  PacerThreadPool pool(1);
+  CountingCallback callback(1);
+  rtc::scoped_ptr<PacedSender> pacer(CreatePacer(&callback));
+  pool.AddPacer(pacer.get());
+  pacer->InsertPacket(PacedSender::kNormalPriority, 1000, 1, -1, 250, false);
+  EXPECT_TRUE(callback.Wait());
+
+  pool.RemovePacer(pacer.get());
+  pacer->InsertPacket(PacedSender::kNormalPriority, 1000, 2, -1, 250, false);
+  SleepMs(100);
+  EXPECT_EQ(1, callback.packets_sent());
+  EXPECT_EQ(1u, pacer->QueueSizePackets());
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -18,6 +18,14 @@
 
 namespace webrtc {
 
+namespace {
+bool IsSendingOnSsrc(RtpRtcp* rtp_module, uint32_t ssrc) {
+  return rtp_module->SendingMedia() &&
+         (ssrc == rtp_module->SSRC() ||
+          (ssrc != 0 && ssrc == rtp_module->FlexfecSsrc()));
+}
+}  // namespace
+
 PacketRouter::PacketRouter() : transport_seq_(0) {
 }
 
@@ -37,6 +45,28 @@ void PacketRouter::RemoveRtpModule(RtpRtcp* rtp_module) {
   auto it = std::find(rtp_modules_.begin(), rtp_modules_.end(), rtp_module);
   RTC_DCHECK(it != rtp_modules_.end());
   rtp_modules_.erase(it);
+  for (auto ssrc_it = ssrc_modules_.begin(); ssrc_it != ssrc_modules_.end();) {
+    if (ssrc_it->second == rtp_module)
+      ssrc_it = ssrc_modules_.erase(ssrc_it);
+    else
+      ++ssrc_it;
+  }
+}
+
+RtpRtcp* PacketRouter::FindModule(uint32_t ssrc) {
+  auto it = ssrc_modules_.find(ssrc);
+  if (it != ssrc_modules_.end()) {
+    if (IsSendingOnSsrc(it->second, ssrc))
+      return it->second;
+    ssrc_modules_.erase(it);
+  }
+  for (auto* rtp_module : rtp_modules_) {
+    if (IsSendingOnSsrc(rtp_module, ssrc)) {
+      ssrc_modules_[ssrc] = rtp_module;
+      return rtp_module;
+    }
+  }
+  return nullptr;
 }
 
 bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
@@ -44,13 +74,11 @@ bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     int64_t capture_timestamp,
                                     bool retransmission) {
   rtc::CritScope cs(&modules_lock_);
-  for (auto* rtp_module : rtp_modules_) {
-    if (rtp_module->SendingMedia() && ssrc == rtp_module->SSRC()) {
-      return rtp_module->TimeToSendPacket(ssrc, sequence_number,
-                                          capture_timestamp, retransmission);
-    }
-  }
-  return true;
+  RtpRtcp* rtp_module = FindModule(ssrc);
+  if (!rtp_module)
+    return true;
+  return rtp_module->TimeToSendPacket(ssrc, sequence_number, capture_timestamp,
+                                      retransmission);
 }
 
 size_t PacketRouter::TimeToSendPadding(size_t bytes_to_send) {
@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_PACING_PACKET_ROUTER_H_
 
 #include <list>
+#include <unordered_map>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -54,9 +55,17 @@ class PacketRouter : public PacedSender::Callback,
   virtual bool SendFeedback(rtcp::TransportFeedback* packet);
 
  private:
+  // Returns the module sending media on |ssrc|, as its media or FlexFEC SSRC,
+  // or nullptr if there is none.
+  RtpRtcp* FindModule(uint32_t ssrc) EXCLUSIVE_LOCKS_REQUIRED(modules_lock_);
+
   rtc::CriticalSection modules_lock_;
-  // Map from ssrc to sending rtp module.
   std::list<RtpRtcp*> rtp_modules_ GUARDED_BY(modules_lock_);
+  // Map from ssrc to the rtp module last found sending on it, so that paced
+  // packets don't have to search all modules. Modules can change their SSRCs
+  // and stop sending, so an entry is only used after checking the module.
+  std::unordered_map<uint32_t, RtpRtcp*> ssrc_modules_
+      GUARDED_BY(modules_lock_);
 
   volatile int transport_seq_;
 
@@ -20,8 +20,10 @@
 
 using ::testing::_;
 using ::testing::AnyNumber;
+using ::testing::Mock;
 using ::testing::NiceMock;
 using ::testing::Return;
+using ::testing::ReturnPointee;
 
 namespace webrtc {
 
@@ -70,8 +72,9 @@ TEST_F(PacketRouterTest, TimeToSendPacket) {
   EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, sequence_number,
                                                timestamp, retransmission));
 
-  // No module is sending, hence no packet should be sent.
-  EXPECT_CALL(rtp_1, SendingMedia()).Times(1).WillOnce(Return(false));
+  // No module is sending, hence no packet should be sent. rtp_1 is asked
+  // twice, since kSsrc1 was last routed to it.
+  EXPECT_CALL(rtp_1, SendingMedia()).Times(2).WillRepeatedly(Return(false));
   EXPECT_CALL(rtp_1, TimeToSendPacket(_, _, _, _)).Times(0);
   EXPECT_CALL(rtp_2, SendingMedia()).Times(1).WillOnce(Return(false));
   EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _)).Times(0);
@@ -101,6 +104,84 @@ TEST_F(PacketRouterTest, TimeToSendPacket) {
   packet_router_->RemoveRtpModule(&rtp_2);
 }
 
+TEST_F(PacketRouterTest, TimeToSendFlexfecPacket) {
+  MockRtpRtcp rtp;
+  packet_router_->AddRtpModule(&rtp);
+
+  const uint32_t kSsrc = 1234;
+  const uint32_t kFlexfecSsrc = 5678;
+  const uint16_t kSequenceNumber = 17;
+  const int64_t kTimestamp = 7890;
+  EXPECT_CALL(rtp, SendingMedia()).WillRepeatedly(Return(true));
+  EXPECT_CALL(rtp, SSRC()).WillRepeatedly(Return(kSsrc));
+  EXPECT_CALL(rtp, FlexfecSsrc()).WillRepeatedly(Return(kFlexfecSsrc));
+  EXPECT_CALL(rtp, TimeToSendPacket(kFlexfecSsrc, kSequenceNumber, kTimestamp,
+                                    false))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kFlexfecSsrc, kSequenceNumber,
+                                               kTimestamp, false));
+
+  packet_router_->RemoveRtpModule(&rtp);
+}
+
+TEST_F(PacketRouterTest, TimeToSendPacketFollowsSsrcChanges) {
+  MockRtpRtcp rtp_1;
+  MockRtpRtcp rtp_2;
+  packet_router_->AddRtpModule(&rtp_1);
+  packet_router_->AddRtpModule(&rtp_2);
+
+  const uint32_t kSsrc1 = 1234;
+  const uint32_t kSsrc2 = 4567;
+  const uint16_t kSequenceNumber = 17;
+  const int64_t kTimestamp = 7890;
+  uint32_t ssrc_1 = kSsrc1;
+  EXPECT_CALL(rtp_1, SendingMedia()).WillRepeatedly(Return(true));
+  EXPECT_CALL(rtp_1, SSRC()).WillRepeatedly(ReturnPointee(&ssrc_1));
+  EXPECT_CALL(rtp_1, FlexfecSsrc()).WillRepeatedly(Return(0));
+  EXPECT_CALL(rtp_2, SendingMedia()).WillRepeatedly(Return(true));
+  EXPECT_CALL(rtp_2, SSRC()).WillRepeatedly(Return(kSsrc2));
+  EXPECT_CALL(rtp_2, FlexfecSsrc()).WillRepeatedly(Return(0));
+
+  EXPECT_CALL(rtp_2, TimeToSendPacket(kSsrc2, kSequenceNumber, kTimestamp,
+                                      false))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber,
+                                               kTimestamp, false));
+
+  // Once found, the module of an SSRC is used without searching the others.
+  EXPECT_CALL(rtp_1, SendingMedia()).Times(0);
+  EXPECT_CALL(rtp_1, SSRC()).Times(0);
+  EXPECT_CALL(rtp_2, TimeToSendPacket(kSsrc2, kSequenceNumber + 1,
+                                      kTimestamp, false))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber + 1,
+                                               kTimestamp, false));
+
+  // Packets follow an SSRC when it moves to another module.
+  Mock::VerifyAndClearExpectations(&rtp_1);
+  Mock::VerifyAndClearExpectations(&rtp_2);
+  ssrc_1 = kSsrc2;
+  EXPECT_CALL(rtp_1, SendingMedia()).WillRepeatedly(Return(true));
+  EXPECT_CALL(rtp_1, SSRC()).WillRepeatedly(ReturnPointee(&ssrc_1));
+  EXPECT_CALL(rtp_1, FlexfecSsrc()).WillRepeatedly(Return(0));
+  EXPECT_CALL(rtp_2, SendingMedia()).WillRepeatedly(Return(true));
+  EXPECT_CALL(rtp_2, SSRC()).WillRepeatedly(Return(kSsrc1));
+  EXPECT_CALL(rtp_2, FlexfecSsrc()).WillRepeatedly(Return(0));
+  EXPECT_CALL(rtp_1, TimeToSendPacket(kSsrc2, kSequenceNumber + 2,
+                                      kTimestamp, false))
+      .Times(1)
+      .WillOnce(Return(true));
+  EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _)).Times(0);
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber + 2,
+                                               kTimestamp, false));
+
+  packet_router_->RemoveRtpModule(&rtp_1);
+  packet_router_->RemoveRtpModule(&rtp_2);
+}
+
 TEST_F(PacketRouterTest, TimeToSendPadding) {
   const uint16_t kSsrc1 = 1234;
   const uint16_t kSsrc2 = 4567;
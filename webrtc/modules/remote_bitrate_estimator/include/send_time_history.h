@@ -11,14 +11,19 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/basictypes.h"
+#include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
 
 namespace webrtc {
 
+// Keeps the packets sent in the last |packet_age_limit| ms, by transport
+// sequence number. The packets are kept in a ring buffer indexed by unwrapped
+// sequence number, since sequence numbers are assigned in the order packets
+// are added.
 class SendTimeHistory {
  public:
   SendTimeHistory(Clock* clock, int64_t packet_age_limit);
@@ -33,13 +38,30 @@ class SendTimeHistory {
   void Clear();
 
  private:
-  void EraseOld();
-  void UpdateOldestSequenceNumber();
+  struct Packet {
+    Packet() : info(-1, 0), in_history(false) {}
+    PacketInfo info;
+    // False for sequence numbers that were skipped or already removed.
+    bool in_history;
+  };
+
+  Packet& Slot(int64_t unwrapped_sequence_number);
+  // Returns null if |sequence_number| is not in the history.
+  Packet* FindPacket(uint16_t sequence_number);
+  void RemoveOldest();
+  void EraseOld(int64_t now_ms);
+  // Doubles the size of |history_|, keeping the packets in it.
+  void Grow();
 
   Clock* const clock_;
   const int64_t packet_age_limit_;
-  uint16_t oldest_sequence_number_;  // Oldest may not be lowest.
-  std::map<uint16_t, PacketInfo> history_;
+  SequenceNumberUnwrapper seq_num_unwrapper_;
+  // Ring buffer holding the unwrapped sequence numbers
+  // [oldest_sequence_number_, oldest_sequence_number_ + num_packets_). Its
+  // size is zero or a power of two.
+  std::vector<Packet> history_;
+  int64_t oldest_sequence_number_;
+  size_t num_packets_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(SendTimeHistory);
 };
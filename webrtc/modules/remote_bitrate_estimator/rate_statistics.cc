@@ -12,15 +12,26 @@
 
 #include <assert.h>
 
+#include <algorithm>
+
 namespace webrtc {
 
 RateStatistics::RateStatistics(uint32_t window_size_ms, float scale)
-    : num_buckets_(window_size_ms + 1),  // N ms in (N+1) buckets.
+    : RateStatistics(window_size_ms, scale, 1) {}
+
+RateStatistics::RateStatistics(uint32_t window_size_ms,
+                               float scale,
+                               uint32_t bucket_size_ms)
+    : bucket_size_ms_(bucket_size_ms),
+      // N buckets of window in (N+1) buckets.
+      num_buckets_(window_size_ms / bucket_size_ms + 1),
       buckets_(new size_t[num_buckets_]()),
       accumulated_count_(0),
       oldest_time_(0),
       oldest_index_(0),
-      scale_(scale / (num_buckets_ - 1)) {
+      scale_(scale / window_size_ms) {
+  assert(bucket_size_ms > 0);
+  assert(window_size_ms % bucket_size_ms == 0);
 }
 
 RateStatistics::~RateStatistics() {
@@ -30,20 +41,32 @@ void RateStatistics::Reset() {
   accumulated_count_ = 0;
   oldest_time_ = 0;
   oldest_index_ = 0;
-  for (int i = 0; i < num_buckets_; i++) {
-    buckets_[i] = 0;
-  }
+  std::fill(buckets_.get(), buckets_.get() + num_buckets_, 0);
 }
 
 void RateStatistics::Update(size_t count, int64_t now_ms) {
-  if (now_ms < oldest_time_) {
+  AddToBucket(count, now_ms);
+}
+
+void RateStatistics::Update(const size_t* counts,
+                            size_t num_counts,
+                            int64_t now_ms) {
+  size_t total_count = 0;
+  for (size_t i = 0; i < num_counts; ++i)
+    total_count += counts[i];
+  AddToBucket(total_count, now_ms);
+}
+
+void RateStatistics::AddToBucket(size_t count, int64_t now_ms) {
+  const int64_t now = now_ms / bucket_size_ms_;
+  if (now < oldest_time_) {
     // Too old data is ignored.
     return;
   }
 
-  EraseOld(now_ms);
+  EraseOld(now);
 
-  int now_offset = static_cast<int>(now_ms - oldest_time_);
+  int now_offset = static_cast<int>(now - oldest_time_);
   assert(now_offset < num_buckets_);
   int index = oldest_index_ + now_offset;
   if (index >= num_buckets_) {
@@ -54,12 +77,13 @@ void RateStatistics::Update(size_t count, int64_t now_ms) {
 }
 
 uint32_t RateStatistics::Rate(int64_t now_ms) {
-  EraseOld(now_ms);
+  EraseOld(now_ms / bucket_size_ms_);
   return static_cast<uint32_t>(accumulated_count_ * scale_ + 0.5f);
 }
 
-void RateStatistics::EraseOld(int64_t now_ms) {
-  int64_t new_oldest_time = now_ms - num_buckets_ + 1;
+// |now| is in units of |bucket_size_ms_|.
+void RateStatistics::EraseOld(int64_t now) {
+  int64_t new_oldest_time = now - num_buckets_ + 1;
   if (new_oldest_time <= oldest_time_) {
     return;
   }
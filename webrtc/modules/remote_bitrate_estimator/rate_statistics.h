@@ -22,24 +22,36 @@ class RateStatistics {
   // scale = coefficient to convert counts/ms to desired units,
   //         ex: if counts represents bytes, use 8*1000 to go to bits/s
   RateStatistics(uint32_t window_size_ms, float scale);
+  // As above, but with counts kept per |bucket_size_ms| instead of per
+  // millisecond, which uses less memory and makes the window slide in steps
+  // of |bucket_size_ms|. |window_size_ms| must be a multiple of
+  // |bucket_size_ms|.
+  RateStatistics(uint32_t window_size_ms,
+                 float scale,
+                 uint32_t bucket_size_ms);
   ~RateStatistics();
 
   void Reset();
   void Update(size_t count, int64_t now_ms);
+  // Same as calling Update() for each of the |num_counts| counts in |counts|,
+  // e.g. for a burst of packets received at the same time.
+  void Update(const size_t* counts, size_t num_counts, int64_t now_ms);
   uint32_t Rate(int64_t now_ms);
 
  private:
+  void AddToBucket(size_t count, int64_t now_ms);
   void EraseOld(int64_t now_ms);
 
   // Counters are kept in buckets (circular buffer), with one bucket
-  // per millisecond.
+  // per |bucket_size_ms_|.
+  const int64_t bucket_size_ms_;
   const int num_buckets_;
   rtc::scoped_ptr<size_t[]> buckets_;
 
   // Total count recorded in buckets.
   size_t accumulated_count_;
 
-  // Oldest time recorded in buckets.
+  // Oldest time recorded in buckets, in units of |bucket_size_ms_|.
   int64_t oldest_time_;
 
   // Bucket index of oldest counter recorded in buckets.
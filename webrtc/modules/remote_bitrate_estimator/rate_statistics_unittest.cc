@@ -94,4 +94,40 @@ TEST_F(RateStatisticsTest, IncreasingThenDecreasingBitrate) {
     EXPECT_EQ(0u, stats_.Rate(now_ms));
   }
 }
+
+TEST_F(RateStatisticsTest, BatchUpdate) {
+  int64_t now_ms = 0;
+  const size_t kCounts[] = {500, 600, 400};
+  stats_.Update(kCounts, 3, now_ms);
+  // Expecting 24 kbps given a 500 ms window with 1500 bytes.
+  EXPECT_EQ(24000u, stats_.Rate(now_ms));
+  now_ms += 501;
+  EXPECT_EQ(0u, stats_.Rate(now_ms));
+}
+
+TEST(RateStatisticsBucketTest, CoarseBuckets) {
+  // 500 ms window in 10 ms buckets.
+  RateStatistics stats(500, 8000, 10);
+  int64_t now_ms = 0;
+  EXPECT_EQ(0u, stats.Rate(now_ms));
+  stats.Update(1500, now_ms);
+  EXPECT_EQ(24000u, stats.Rate(now_ms));
+  stats.Reset();
+  for (int i = 0; i < 100000; ++i) {
+    if (now_ms % 10 == 0) {
+      stats.Update(1500, now_ms);
+    }
+    // Approximately 1200 kbps expected. Not exact since the window covers
+    // 50 to 51 buckets.
+    if (now_ms > 500 && now_ms % 7 == 0) {
+      EXPECT_NEAR(1200000u, stats.Rate(now_ms), 24000u);
+    }
+    now_ms += 1;
+  }
+  // The window slides in whole buckets, so the last packet, received 10 ms
+  // ago at the start of its bucket, is dropped 510 ms after it was received.
+  now_ms += 500;
+  EXPECT_EQ(24000u, stats.Rate(now_ms - 1));
+  EXPECT_EQ(0u, stats.Rate(now_ms));
+}
 }  // namespace
@@ -13,6 +13,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <utility>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/logging.h"
@@ -33,7 +34,6 @@ enum {
   kInterArrivalShift = kAbsSendTimeFraction + kAbsSendTimeInterArrivalUpshift,
   kInitialProbingIntervalMs = 2000,
   kMinClusterSize = 4,
-  kMaxProbePackets = 15,
   kExpectedNumberOfProbes = 3
 };
 
@@ -86,7 +86,7 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   }
 
   void RemoteBitrateEstimatorAbsSendTime::AddCluster(
-      std::list<Cluster>* clusters,
+      std::vector<Cluster>* clusters,
       Cluster* cluster) {
     cluster->send_mean_ms /= static_cast<float>(cluster->count);
     cluster->recv_mean_ms /= static_cast<float>(cluster->count);
@@ -112,50 +112,83 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         last_process_time_(-1),
         process_interval_ms_(kProcessIntervalMs),
         total_propagation_delta_ms_(0),
+        first_probe_(0),
+        num_probes_(0),
         total_probes_received_(0),
-        first_packet_time_ms_(-1) {
+        first_packet_time_ms_(-1),
+        estimate_crit_sect_(CriticalSectionWrapper::CreateCriticalSection()),
+        valid_estimate_(false),
+        latest_estimate_bps_(0) {
   assert(observer_);
   assert(clock_);
+  // There are never more than kExpectedNumberOfProbes clusters, one of which
+  // may be |current_cluster_| added by ProcessClusters().
+  clusters_.reserve(kExpectedNumberOfProbes + 1);
   LOG(LS_INFO) << "RemoteBitrateEstimatorAbsSendTime: Instantiating.";
 }
 
-void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
-  Cluster current;
-  int64_t prev_send_time = -1;
-  int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
-       it != probes_.end();
-       ++it) {
-    if (prev_send_time >= 0) {
-      int send_delta_ms = it->send_time_ms - prev_send_time;
-      int recv_delta_ms = it->recv_time_ms - prev_recv_time;
-      if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
-        ++current.num_above_min_delta;
-      }
-      if (!IsWithinClusterBounds(send_delta_ms, current)) {
-        if (current.count >= kMinClusterSize)
-          AddCluster(clusters, &current);
-        current = Cluster();
-      }
-      current.send_mean_ms += send_delta_ms;
-      current.recv_mean_ms += recv_delta_ms;
-      current.mean_size += it->payload_size;
-      ++current.count;
-    }
-    prev_send_time = it->send_time_ms;
-    prev_recv_time = it->recv_time_ms;
+const Probe& RemoteBitrateEstimatorAbsSendTime::GetProbe(size_t index) const {
+  RTC_DCHECK_LT(index, num_probes_);
+  return probes_[(first_probe_ + index) % kMaxProbePackets];
+}
+
+void RemoteBitrateEstimatorAbsSendTime::AddProbe(const Probe& probe) {
+  if (num_probes_ > 0)
+    UpdateClusters(GetProbe(num_probes_ - 1), probe);
+  if (num_probes_ == kMaxProbePackets) {
+    // A cluster has been found, so the oldest probe is no longer needed.
+    first_probe_ = (first_probe_ + 1) % kMaxProbePackets;
+    --num_probes_;
+  }
+  probes_[(first_probe_ + num_probes_) % kMaxProbePackets] = probe;
+  ++num_probes_;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RemoveOldestProbe() {
+  RTC_DCHECK_GT(num_probes_, 0u);
+  first_probe_ = (first_probe_ + 1) % kMaxProbePackets;
+  --num_probes_;
+  RecomputeClusters();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ClearProbes() {
+  first_probe_ = 0;
+  num_probes_ = 0;
+  clusters_.clear();
+  current_cluster_ = Cluster();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::UpdateClusters(const Probe& prev_probe,
+                                                       const Probe& probe) {
+  int send_delta_ms = probe.send_time_ms - prev_probe.send_time_ms;
+  int recv_delta_ms = probe.recv_time_ms - prev_probe.recv_time_ms;
+  if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
+    ++current_cluster_.num_above_min_delta;
+  }
+  if (!IsWithinClusterBounds(send_delta_ms, current_cluster_)) {
+    if (current_cluster_.count >= kMinClusterSize)
+      AddCluster(&clusters_, &current_cluster_);
+    current_cluster_ = Cluster();
   }
-  if (current.count >= kMinClusterSize)
-    AddCluster(clusters, &current);
+  current_cluster_.send_mean_ms += send_delta_ms;
+  current_cluster_.recv_mean_ms += recv_delta_ms;
+  current_cluster_.mean_size += probe.payload_size;
+  ++current_cluster_.count;
 }
 
-std::list<Cluster>::const_iterator
+void RemoteBitrateEstimatorAbsSendTime::RecomputeClusters() {
+  clusters_.clear();
+  current_cluster_ = Cluster();
+  for (size_t i = 1; i < num_probes_; ++i)
+    UpdateClusters(GetProbe(i - 1), GetProbe(i));
+}
+
+std::vector<Cluster>::const_iterator
 RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
+    const std::vector<Cluster>& clusters) const {
   int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
+  std::vector<Cluster>::const_iterator best_it = clusters.end();
+  for (std::vector<Cluster>::const_iterator it = clusters.begin();
        it != clusters.end();
        ++it) {
     if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
@@ -184,18 +217,24 @@ RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
 }
 
 void RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
-  ComputeClusters(&clusters);
-  if (clusters.empty()) {
+  const bool current_is_cluster = current_cluster_.count >= kMinClusterSize;
+  if (clusters_.empty() && !current_is_cluster) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
-    if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+    if (num_probes_ >= kMaxProbePackets)
+      RemoveOldestProbe();
     return;
   }
 
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
-  if (best_it != clusters.end()) {
+  // The current cluster is evaluated as if it ended with the latest probe,
+  // and is taken out of |clusters_| again below.
+  if (current_is_cluster) {
+    Cluster cluster = current_cluster_;
+    AddCluster(&clusters_, &cluster);
+  }
+
+  std::vector<Cluster>::const_iterator best_it = FindBestProbe(clusters_);
+  if (best_it != clusters_.end()) {
     int probe_bitrate_bps =
         std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
     // Make sure that a probe sent on a lower bitrate than our estimate can't
@@ -209,13 +248,17 @@ void RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
                    << " ms, mean recv delta: " << best_it->recv_mean_ms
                    << " ms, num probes: " << best_it->count;
       remote_rate_.SetEstimate(probe_bitrate_bps, now_ms);
+      PublishEstimate();
     }
   }
 
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
-  if (clusters.size() >= kExpectedNumberOfProbes)
-    probes_.clear();
+  if (clusters_.size() >= kExpectedNumberOfProbes) {
+    ClearProbes();
+  } else if (current_is_cluster) {
+    clusters_.pop_back();
+  }
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
@@ -265,12 +308,18 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   int64_t now_ms = clock_->TimeInMilliseconds();
   // TODO(holmer): SSRCs are only needed for REMB, should be broken out from
   // here.
-  ssrcs_[ssrc] = now_ms;
+  std::pair<Ssrcs::iterator, bool> inserted =
+      ssrcs_.insert(std::make_pair(ssrc, now_ms));
+  if (inserted.second) {
+    PublishEstimate();
+  } else {
+    inserted.first->second = now_ms;
+  }
   incoming_bitrate_.Update(payload_size, now_ms);
   const BandwidthUsage prior_state = detector_.State();
 
   if (first_packet_time_ms_ == -1)
-    first_packet_time_ms_ = clock_->TimeInMilliseconds();
+    first_packet_time_ms_ = now_ms;
 
   uint32_t ts_delta = 0;
   int64_t t_delta = 0;
@@ -286,16 +335,17 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
     if (total_probes_received_ < kMaxProbePackets) {
       int send_delta_ms = -1;
       int recv_delta_ms = -1;
-      if (!probes_.empty()) {
-        send_delta_ms = send_time_ms - probes_.back().send_time_ms;
-        recv_delta_ms = arrival_time_ms - probes_.back().recv_time_ms;
+      if (num_probes_ > 0) {
+        const Probe& last_probe = GetProbe(num_probes_ - 1);
+        send_delta_ms = send_time_ms - last_probe.send_time_ms;
+        recv_delta_ms = arrival_time_ms - last_probe.recv_time_ms;
       }
       LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
                    << " ms, recv time=" << arrival_time_ms
                    << " ms, send delta=" << send_delta_ms
                    << " ms, recv delta=" << recv_delta_ms << " ms.";
     }
-    probes_.push_back(Probe(send_time_ms, arrival_time_ms, payload_size));
+    AddProbe(Probe(send_time_ms, arrival_time_ms, payload_size));
     ++total_probes_received_;
     ProcessClusters(now_ms);
   }
@@ -352,13 +402,17 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateEstimate(int64_t now_ms) {
     // No packets have been received on the active streams.
     return;
   }
+  bool ssrcs_removed = false;
   for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end();) {
     if ((now_ms - it->second) > kStreamTimeOutMs) {
       ssrcs_.erase(it++);
+      ssrcs_removed = true;
     } else {
       ++it;
     }
   }
+  if (ssrcs_removed)
+    PublishEstimate();
   if (ssrcs_.empty()) {
     // We can't update the estimate if we don't have any active streams.
     inter_arrival_.reset();
@@ -372,6 +426,7 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateEstimate(int64_t now_ms) {
                                estimator_.var_noise());
   remote_rate_.Update(&input, now_ms);
   unsigned int target_bitrate = remote_rate_.UpdateBandwidthEstimate(now_ms);
+  PublishEstimate();
   if (remote_rate_.ValidEstimate()) {
     process_interval_ms_ = remote_rate_.GetFeedbackInterval();
     observer_->OnReceiveBitrateChanged(Keys(ssrcs_), target_bitrate);
@@ -386,27 +441,31 @@ void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(int64_t avg_rtt_ms,
 
 void RemoteBitrateEstimatorAbsSendTime::RemoveStream(unsigned int ssrc) {
   CriticalSectionScoped cs(crit_sect_.get());
-  ssrcs_.erase(ssrc);
+  if (ssrcs_.erase(ssrc) > 0)
+    PublishEstimate();
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
     std::vector<unsigned int>* ssrcs,
     unsigned int* bitrate_bps) const {
-  CriticalSectionScoped cs(crit_sect_.get());
+  CriticalSectionScoped cs(estimate_crit_sect_.get());
   assert(ssrcs);
   assert(bitrate_bps);
-  if (!remote_rate_.ValidEstimate()) {
+  if (!valid_estimate_) {
     return false;
   }
-  *ssrcs = Keys(ssrcs_);
-  if (ssrcs_.empty()) {
-    *bitrate_bps = 0;
-  } else {
-    *bitrate_bps = remote_rate_.LatestEstimate();
-  }
+  *ssrcs = latest_estimate_ssrcs_;
+  *bitrate_bps = latest_estimate_bps_;
   return true;
 }
 
+void RemoteBitrateEstimatorAbsSendTime::PublishEstimate() {
+  CriticalSectionScoped cs(estimate_crit_sect_.get());
+  valid_estimate_ = remote_rate_.ValidEstimate();
+  latest_estimate_ssrcs_ = Keys(ssrcs_);
+  latest_estimate_bps_ = ssrcs_.empty() ? 0 : remote_rate_.LatestEstimate();
+}
+
 bool RemoteBitrateEstimatorAbsSendTime::GetStats(
     ReceiveBandwidthEstimatorStats* output) const {
   {
@@ -447,5 +506,6 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateStats(int propagation_delta_ms,
 void RemoteBitrateEstimatorAbsSendTime::SetMinBitrate(int min_bitrate_bps) {
   CriticalSectionScoped cs(crit_sect_.get());
   remote_rate_.SetMinBitrate(min_bitrate_bps);
+  PublishEstimate();
 }
 }  // namespace webrtc
@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
-#include <list>
 #include <map>
 #include <vector>
 
@@ -28,6 +27,7 @@
 namespace webrtc {
 
 struct Probe {
+  Probe() : send_time_ms(-1), recv_time_ms(-1), payload_size(0) {}
   Probe(int64_t send_time_ms, int64_t recv_time_ms, size_t payload_size)
       : send_time_ms(send_time_ms),
         recv_time_ms(recv_time_ms),
@@ -92,10 +92,12 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
  private:
   typedef std::map<unsigned int, int64_t> Ssrcs;
 
+  static const size_t kMaxProbePackets = 15;
+
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  static void AddCluster(std::vector<Cluster>* clusters, Cluster* cluster);
 
   int Id() const;
 
@@ -115,10 +117,27 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   void UpdateStats(int propagation_delta_ms, int64_t now_ms)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  // Returns the |index|th oldest probe of |probes_|.
+  const Probe& GetProbe(size_t index) const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  // Adds |probe| to |probes_| and to the clusters.
+  void AddProbe(const Probe& probe) EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  void RemoveOldestProbe() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  void ClearProbes() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const
+  // Adds |probe|, received after |prev_probe|, to |current_cluster_|, first
+  // moving |current_cluster_| to |clusters_| if |probe| doesn't fit in it.
+  void UpdateClusters(const Probe& prev_probe, const Probe& probe)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  // Computes the clusters from scratch from the probes in |probes_|.
+  void RecomputeClusters() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  std::vector<Cluster>::const_iterator FindBestProbe(
+      const std::vector<Cluster>& clusters) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
   void ProcessClusters(int64_t now_ms)
@@ -127,6 +146,10 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   bool IsBitrateImproving(int probe_bitrate_bps) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
+  // Copies the estimate and the SSRCs to the members read by
+  // LatestEstimate(). Must be called whenever either of them changes.
+  void PublishEstimate() EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
   rtc::scoped_ptr<CriticalSectionWrapper> crit_sect_;
   RemoteBitrateObserver* observer_ GUARDED_BY(crit_sect_.get());
   Clock* clock_;
@@ -142,9 +165,26 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   int64_t process_interval_ms_ GUARDED_BY(crit_sect_.get());
   int total_propagation_delta_ms_ GUARDED_BY(crit_sect_.get());
 
-  std::list<Probe> probes_;
-  size_t total_probes_received_;
-  int64_t first_packet_time_ms_;
+  // The most recent probes, as a ring buffer starting at |first_probe_|.
+  // While no cluster has been found, no more than kMaxProbePackets probes are
+  // kept, so the clusters can always be recomputed from this.
+  Probe probes_[kMaxProbePackets] GUARDED_BY(crit_sect_.get());
+  size_t first_probe_ GUARDED_BY(crit_sect_.get());
+  size_t num_probes_ GUARDED_BY(crit_sect_.get());
+  // The completed clusters of the probes, with means rather than sums.
+  std::vector<Cluster> clusters_ GUARDED_BY(crit_sect_.get());
+  // The cluster the latest probe belongs to, with sums rather than means.
+  Cluster current_cluster_ GUARDED_BY(crit_sect_.get());
+  size_t total_probes_received_ GUARDED_BY(crit_sect_.get());
+  int64_t first_packet_time_ms_ GUARDED_BY(crit_sect_.get());
+
+  // LatestEstimate() only takes this lock, so that it doesn't wait for
+  // incoming packets to be processed.
+  rtc::scoped_ptr<CriticalSectionWrapper> estimate_crit_sect_;
+  bool valid_estimate_ GUARDED_BY(estimate_crit_sect_.get());
+  unsigned int latest_estimate_bps_ GUARDED_BY(estimate_crit_sect_.get());
+  std::vector<unsigned int> latest_estimate_ssrcs_
+      GUARDED_BY(estimate_crit_sect_.get());
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RemoteBitrateEstimatorAbsSendTime);
 };
@@ -127,6 +127,41 @@ TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestProbeDetection) {
   EXPECT_GT(bitrate_observer_->latest_bitrate(), 1500000u);
 }
 
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest,
+       TestProbeDetectionAfterManyUnclusteredProbes) {
+  int64_t now_ms = clock_.TimeInMilliseconds();
+  // More probes than are kept while no cluster is found, with deltas that
+  // never form a cluster.
+  for (int i = 0; i < 40; ++i) {
+    clock_.AdvanceTimeMilliseconds(i % 2 == 0 ? 3 : 10);
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(0, 1000, now_ms, 90 * now_ms, AbsSendTime(now_ms, 1000),
+                   true);
+  }
+  EXPECT_EQ(0, bitrate_estimator_->Process());
+  EXPECT_FALSE(bitrate_observer_->updated());
+
+  // Burst sent at 8 * 1000 / 5 = 1600 kbps.
+  const int kProbeLength = 5;
+  for (int i = 0; i < kProbeLength; ++i) {
+    clock_.AdvanceTimeMilliseconds(5);
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(0, 1000, now_ms, 90 * now_ms, AbsSendTime(now_ms, 1000),
+                   true);
+  }
+
+  clock_.AdvanceTimeMilliseconds(1000);
+  EXPECT_EQ(0, bitrate_estimator_->Process());
+  EXPECT_TRUE(bitrate_observer_->updated());
+  EXPECT_GT(bitrate_observer_->latest_bitrate(), 1500000u);
+  std::vector<unsigned int> ssrcs;
+  unsigned int bitrate_bps = 0;
+  EXPECT_TRUE(bitrate_estimator_->LatestEstimate(&ssrcs, &bitrate_bps));
+  EXPECT_EQ(bitrate_observer_->latest_bitrate(), bitrate_bps);
+  ASSERT_EQ(1u, ssrcs.size());
+  EXPECT_EQ(0u, ssrcs[0]);
+}
+
 TEST_F(RemoteBitrateEstimatorAbsSendTimeTest,
        TestProbeDetectionNonPacedPackets) {
   const int kProbeLength = 5;
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/remote_estimator_proxy.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -23,6 +25,13 @@ namespace webrtc {
 const int RemoteEstimatorProxy::kDefaultProcessIntervalMs = 50;
 const int RemoteEstimatorProxy::kBackWindowMs = 500;
 
+namespace {
+const size_t kInitialWindowSize = 256;
+// Packets further back than this from the newest one are forgotten, even if
+// they are within kBackWindowMs.
+const int64_t kMaxWindowSize = 1 << 15;
+}  // namespace
+
 RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
                                            PacketRouter* packet_router)
     : clock_(clock),
@@ -30,7 +39,10 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
       last_process_time_ms_(-1),
       media_ssrc_(0),
       feedback_sequence_(0),
-      window_start_seq_(-1) {}
+      window_start_seq_(-1),
+      arrival_times_ms_(kInitialWindowSize, -1),
+      first_seq_(0),
+      end_seq_(0) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
 
@@ -104,21 +116,67 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   int64_t seq = unwrapper_.Unwrap(sequence_number);
 
   if (window_start_seq_ == -1) {
-    window_start_seq_ = seq;
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (first_seq_ < end_seq_ && first_seq_ < seq &&
+           (ArrivalTimeMs(first_seq_) == -1 ||
+            arrival_time - ArrivalTimeMs(first_seq_) >= kBackWindowMs)) {
+      ++first_seq_;
     }
-  } else if (seq < window_start_seq_) {
+  }
+
+  if (!ExtendWindow(seq))
+    return;
+
+  if (window_start_seq_ == -1 || seq < window_start_seq_)
     window_start_seq_ = seq;
+
+  RTC_DCHECK_EQ(-1, ArrivalTimeMs(seq));
+  ArrivalTimeMs(seq) = arrival_time;
+}
+
+bool RemoteEstimatorProxy::ExtendWindow(int64_t seq) {
+  if (first_seq_ == end_seq_) {
+    first_seq_ = seq;
+    end_seq_ = seq;
+  }
+  if (seq < end_seq_ - kMaxWindowSize) {
+    LOG(LS_WARNING) << "Dropping arrival time of sequence number " << seq
+                    << ", too far behind " << end_seq_ << ".";
+    return false;
+  }
+  if (seq >= first_seq_ + kMaxWindowSize) {
+    first_seq_ = seq - kMaxWindowSize + 1;
+    if (window_start_seq_ != -1 && window_start_seq_ < first_seq_) {
+      window_start_seq_ = first_seq_;
+      while (window_start_seq_ < end_seq_ &&
+             ArrivalTimeMs(window_start_seq_) == -1) {
+        ++window_start_seq_;
+      }
+      if (window_start_seq_ >= end_seq_)
+        window_start_seq_ = -1;
+    }
   }
 
-  RTC_DCHECK(packet_arrival_times_.end() == packet_arrival_times_.find(seq));
-  packet_arrival_times_[seq] = arrival_time;
+  const int64_t new_first_seq = std::min(first_seq_, seq);
+  const int64_t new_end_seq = std::max(end_seq_, seq + 1);
+  const size_t size = arrival_times_ms_.size();
+  if (new_end_seq - new_first_seq > static_cast<int64_t>(size)) {
+    size_t new_size = size;
+    while (new_end_seq - new_first_seq > static_cast<int64_t>(new_size))
+      new_size *= 2;
+    std::vector<int64_t> arrival_times_ms(new_size, -1);
+    for (int64_t i = first_seq_; i < end_seq_; ++i)
+      arrival_times_ms[i & (new_size - 1)] = ArrivalTimeMs(i);
+    arrival_times_ms_.swap(arrival_times_ms);
+  }
+  // Slots entering the window may hold times from an earlier lap.
+  for (int64_t i = new_first_seq; i < first_seq_; ++i)
+    ArrivalTimeMs(i) = -1;
+  for (int64_t i = end_seq_; i < new_end_seq; ++i)
+    ArrivalTimeMs(i) = -1;
+  first_seq_ = new_first_seq;
+  end_seq_ = new_end_seq;
+  return true;
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -128,34 +186,38 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
     return false;
 
   // window_start_seq_ is the first sequence number to include in the current
-  // feedback packet. Some older may still be in the map, in case a reordering
-  // happens and we need to retransmit them.
-  auto it = packet_arrival_times_.find(window_start_seq_);
-  RTC_DCHECK(it != packet_arrival_times_.end());
+  // feedback packet. Some older may still be in the buffer, in case a
+  // reordering happens and we need to retransmit them.
+  RTC_DCHECK_GE(window_start_seq_, first_seq_);
+  RTC_DCHECK_NE(-1, ArrivalTimeMs(window_start_seq_));
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
   feedback_packet->WithMediaSourceSsrc(media_ssrc_);
-  feedback_packet->WithBase(static_cast<uint16_t>(it->first & 0xFFFF),
-                            it->second * 1000);
+  feedback_packet->WithBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
+                            ArrivalTimeMs(window_start_seq_) * 1000);
   feedback_packet->WithFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
+  int64_t seq = window_start_seq_;
+  for (; seq < end_seq_; ++seq) {
+    const int64_t arrival_time_ms = ArrivalTimeMs(seq);
+    if (arrival_time_ms == -1)
+      continue;
     if (!feedback_packet->WithReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+            static_cast<uint16_t>(seq & 0xFFFF), arrival_time_ms * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(window_start_seq_, it->first);
+      RTC_CHECK_NE(window_start_seq_, seq);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
-      window_start_seq_ = it->first;
+      window_start_seq_ = seq;
       break;
     }
-    // Note: Don't erase items from packet_arrival_times_ after sending, in case
-    // they need to be re-sent after a reordering. Removal will be handled
-    // by OnPacketArrival once packets are too old.
+    // Note: Don't clear arrival times after sending, in case they need to be
+    // re-sent after a reordering. Removal will be handled by OnPacketArrival
+    // once packets are too old.
   }
-  if (it == packet_arrival_times_.end())
+  if (seq == end_seq_)
     window_start_seq_ = -1;
 
   return true;
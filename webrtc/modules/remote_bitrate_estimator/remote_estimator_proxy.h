@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
@@ -56,6 +55,12 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
  private:
   void OnPacketArrival(uint16_t sequence_number, int64_t arrival_time)
       EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  // Makes room for |seq| in |arrival_times_ms_|. Returns false if |seq| is too
+  // old to be kept.
+  bool ExtendWindow(int64_t seq) EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  int64_t& ArrivalTimeMs(int64_t seq) EXCLUSIVE_LOCKS_REQUIRED(&lock_) {
+    return arrival_times_ms_[seq & (arrival_times_ms_.size() - 1)];
+  }
   bool BuildFeedbackPacket(rtcp::TransportFeedback* feedback_packetket);
 
   Clock* const clock_;
@@ -68,8 +73,13 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ GUARDED_BY(&lock_);
   int64_t window_start_seq_ GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  // Ring buffer of arrival times, indexed by unwrapped seq modulo its size
+  // (a power of two), holding the packets in [first_seq_, end_seq_). Packets
+  // that were not received are -1. The buffer is reused across intervals, so
+  // no allocation is made per packet once it has grown to fit the window.
+  std::vector<int64_t> arrival_times_ms_ GUARDED_BY(&lock_);
+  int64_t first_seq_ GUARDED_BY(&lock_);
+  int64_t end_seq_ GUARDED_BY(&lock_);
 };
 
 }  // namespace webrtc
@@ -269,4 +269,29 @@ TEST_F(RemoteEstimatorProxyTest, RemovesTimestampsOutOfScope) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, SendsFeedbackAcrossSequenceNumberWrap) {
+  // Enough packets to outgrow the initial arrival time buffer, wrapping the
+  // 16-bit sequence number on the way.
+  const uint16_t kFirstSeq = 0xFF00;
+  const size_t kNumPackets = 1000;
+  for (size_t i = 0; i < kNumPackets; ++i)
+    IncomingPacket(static_cast<uint16_t>(kFirstSeq + i), kBaseTimeMs + i);
+
+  EXPECT_CALL(router_, SendFeedback(_))
+      .Times(1)
+      .WillOnce(Invoke([kFirstSeq, kNumPackets, this](
+                           rtcp::TransportFeedback* packet) {
+        packet->Build();
+        EXPECT_EQ(kFirstSeq, packet->GetBaseSequence());
+        EXPECT_EQ(kNumPackets, packet->GetStatusVector().size());
+        std::vector<int64_t> delta_vec = packet->GetReceiveDeltasUs();
+        EXPECT_EQ(kNumPackets, delta_vec.size());
+        EXPECT_EQ(kBaseTimeMs, (packet->GetBaseTimeUs() + delta_vec[0]) / 1000);
+        EXPECT_EQ(1000, delta_vec[kNumPackets - 1]);
+        return true;
+      }));
+
+  Process();
+}
+
 }  // namespace webrtc
@@ -10,91 +10,139 @@
 
 #include <assert.h>
 
+#include <algorithm>
+
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 
 namespace webrtc {
 
+namespace {
+const size_t kInitialHistorySize = 64;
+// Sequence numbers further apart than this can't be told apart after
+// wrapping, so the history never spans more.
+const int64_t kMaxSequenceNumberSpan = 1 << 15;
+}  // namespace
+
 SendTimeHistory::SendTimeHistory(Clock* clock, int64_t packet_age_limit)
     : clock_(clock),
       packet_age_limit_(packet_age_limit),
-      oldest_sequence_number_(0) {}
+      oldest_sequence_number_(0),
+      num_packets_(0) {}
 
 SendTimeHistory::~SendTimeHistory() {
 }
 
 void SendTimeHistory::Clear() {
-  history_.clear();
+  while (num_packets_ > 0)
+    RemoveOldest();
+  seq_num_unwrapper_ = SequenceNumberUnwrapper();
 }
 
 void SendTimeHistory::AddAndRemoveOld(uint16_t sequence_number,
                                       size_t length,
                                       bool was_paced) {
-  EraseOld();
-
-  if (history_.empty())
-    oldest_sequence_number_ = sequence_number;
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  EraseOld(now_ms);
+
+  int64_t unwrapped = seq_num_unwrapper_.UnwrapWithoutUpdate(sequence_number);
+  if (num_packets_ > 0 && unwrapped < oldest_sequence_number_) {
+    // Older than anything in the history. Sequence numbers are assigned in
+    // the order packets are added, so this packet would have been removed
+    // already.
+    return;
+  }
+  while (num_packets_ > 0 &&
+         unwrapped - oldest_sequence_number_ >= kMaxSequenceNumberSpan) {
+    RemoveOldest();
+  }
+  if (num_packets_ == 0)
+    oldest_sequence_number_ = unwrapped;
+
+  // Extend the history up to |unwrapped|, leaving out skipped sequence
+  // numbers.
+  while (oldest_sequence_number_ + static_cast<int64_t>(num_packets_) <=
+         unwrapped) {
+    if (num_packets_ == history_.size())
+      Grow();
+    Slot(oldest_sequence_number_ + num_packets_).in_history = false;
+    ++num_packets_;
+  }
 
-  history_.insert(std::pair<uint16_t, PacketInfo>(
-      sequence_number, PacketInfo(clock_->TimeInMilliseconds(), 0, -1,
-                                  sequence_number, length, was_paced)));
+  Packet& packet = Slot(unwrapped);
+  packet.info =
+      PacketInfo(now_ms, 0, -1, sequence_number, length, was_paced);
+  packet.in_history = true;
+  // Unwrap relative to the newest packet.
+  if (unwrapped == oldest_sequence_number_ + num_packets_ - 1)
+    seq_num_unwrapper_.UpdateLast(unwrapped);
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
-  auto it = history_.find(sequence_number);
-  if (it == history_.end())
+  Packet* packet = FindPacket(sequence_number);
+  if (!packet)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  packet->info.send_time_ms = send_time_ms;
   return true;
 }
 
-void SendTimeHistory::EraseOld() {
-  while (!history_.empty()) {
-    auto it = history_.find(oldest_sequence_number_);
-    assert(it != history_.end());
+SendTimeHistory::Packet& SendTimeHistory::Slot(
+    int64_t unwrapped_sequence_number) {
+  return history_[unwrapped_sequence_number & (history_.size() - 1)];
+}
+
+SendTimeHistory::Packet* SendTimeHistory::FindPacket(
+    uint16_t sequence_number) {
+  if (num_packets_ == 0)
+    return nullptr;
+  int64_t unwrapped = seq_num_unwrapper_.UnwrapWithoutUpdate(sequence_number);
+  if (unwrapped < oldest_sequence_number_ ||
+      unwrapped >=
+          oldest_sequence_number_ + static_cast<int64_t>(num_packets_)) {
+    return nullptr;
+  }
+  Packet& packet = Slot(unwrapped);
+  return packet.in_history ? &packet : nullptr;
+}
+
+void SendTimeHistory::RemoveOldest() {
+  assert(num_packets_ > 0);
+  Slot(oldest_sequence_number_).in_history = false;
+  ++oldest_sequence_number_;
+  --num_packets_;
+}
 
-    if (clock_->TimeInMilliseconds() - it->second.creation_time_ms <=
-        packet_age_limit_) {
+void SendTimeHistory::EraseOld(int64_t now_ms) {
+  while (num_packets_ > 0) {
+    const Packet& oldest = Slot(oldest_sequence_number_);
+    if (oldest.in_history &&
+        now_ms - oldest.info.creation_time_ms <= packet_age_limit_) {
       return;  // Oldest packet within age limit, return.
     }
-
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(it);
-    UpdateOldestSequenceNumber();
+    RemoveOldest();
   }
 }
 
-void SendTimeHistory::UpdateOldestSequenceNumber() {
-  // After removing an element from the map, update oldest_sequence_number_ to
-  // the element with the lowest sequence number higher than the previous
-  // value (there might be gaps).
-  if (history_.empty())
-    return;
-  auto it = history_.upper_bound(oldest_sequence_number_);
-  if (it == history_.end()) {
-    // No element with higher sequence number than oldest_sequence_number_
-    // found, check wrap around. Note that history_.upper_bound(0) will not
-    // find 0 even if it is there, need to explicitly check for 0.
-    it = history_.find(0);
-    if (it == history_.end())
-      it = history_.upper_bound(0);
+void SendTimeHistory::Grow() {
+  std::vector<Packet> history(
+      std::max(kInitialHistorySize, 2 * history_.size()));
+  for (size_t i = 0; i < num_packets_; ++i) {
+    int64_t unwrapped = oldest_sequence_number_ + i;
+    history[unwrapped & (history.size() - 1)] = Slot(unwrapped);
   }
-  assert(it != history_.end());
-  oldest_sequence_number_ = it->first;
+  history_.swap(history);
 }
 
 bool SendTimeHistory::GetInfo(PacketInfo* packet, bool remove) {
-  auto it = history_.find(packet->sequence_number);
-  if (it == history_.end())
+  Packet* found = FindPacket(packet->sequence_number);
+  if (!found)
     return false;
   int64_t receive_time = packet->arrival_time_ms;
-  *packet = it->second;
+  *packet = found->info;
   packet->arrival_time_ms = receive_time;
-  if (remove) {
-    history_.erase(it);
-    if (packet->sequence_number == oldest_sequence_number_)
-      UpdateOldestSequenceNumber();
-  }
+  if (remove)
+    found->in_history = false;
   return true;
 }
 
@@ -230,5 +230,34 @@ TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_EQ(packets[2], info3);
 }
 
+TEST_F(SendTimeHistoryTest, ManyPacketsWithWraparound) {
+  // Enough packets to wrap the sequence number and fill the history.
+  const int kNumPackets = 100000;
+  for (int i = 0; i < kNumPackets; ++i) {
+    clock_.AdvanceTimeMilliseconds(1);
+    AddPacketWithSendTime(static_cast<uint16_t>(i), 0, false, i);
+    if (i >= kDefaultHistoryLengthMs) {
+      PacketInfo oldest(0, static_cast<uint16_t>(i - kDefaultHistoryLengthMs));
+      EXPECT_TRUE(history_.GetInfo(&oldest, false));
+      EXPECT_EQ(i - kDefaultHistoryLengthMs, oldest.send_time_ms);
+      PacketInfo too_old(
+          0, static_cast<uint16_t>(i - kDefaultHistoryLengthMs - 1));
+      EXPECT_FALSE(history_.GetInfo(&too_old, false));
+    }
+  }
+}
+
+TEST_F(SendTimeHistoryTest, SkippedSequenceNumbers) {
+  AddPacketWithSendTime(1, 0, false, 1);
+  AddPacketWithSendTime(5, 0, false, 5);
+  for (uint16_t seq = 2; seq < 5; ++seq) {
+    PacketInfo info(0, seq);
+    EXPECT_FALSE(history_.GetInfo(&info, false));
+  }
+  PacketInfo info(0, 5);
+  EXPECT_TRUE(history_.GetInfo(&info, false));
+  EXPECT_EQ(5, info.send_time_ms);
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_logging.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+BweScenario::BweScenario(const std::string& name)
+    : BweTest(false), name_(name) {}
+
+BweScenario::~BweScenario() {}
+
+LinkScenario::Config::Config()
+    : bwe_type(kFullSendSideEstimator),
+      run_time_ms(60 * 1000),
+      capacity_kbps(kMaxCapacityKbps),
+      max_queueing_delay_ms(kMaxQueueingDelayMs),
+      one_way_delay_ms(kOneWayDelayMs),
+      max_jitter_ms(kMaxJitterMs),
+      loss_percent(0.0f) {}
+
+LinkScenario::LinkScenario(const std::string& name, const Config& config)
+    : BweScenario(name), config_(config) {}
+
+LinkScenario::~LinkScenario() {}
+
+void LinkScenario::Run(BweScenarioResult* result) {
+  const int kFlowId = 0;
+  AdaptiveVideoSource source(kFlowId, 30, 300, 0, 0);
+  PacedVideoSender sender(&uplink_, &source, config_.bwe_type);
+  rtc::scoped_ptr<ChokeFilter> choke;
+  rtc::scoped_ptr<TraceBasedDeliveryFilter> trace;
+  if (config_.capacity_trace_path.empty()) {
+    choke.reset(new ChokeFilter(&uplink_, kFlowId));
+    choke->set_capacity_kbps(config_.capacity_kbps);
+    choke->set_max_delay_ms(config_.max_queueing_delay_ms);
+  } else {
+    trace.reset(new TraceBasedDeliveryFilter(&uplink_, kFlowId));
+    trace->set_max_delay_ms(config_.max_queueing_delay_ms);
+    RTC_CHECK(trace->Init(config_.capacity_trace_path))
+        << "Failed to read " << config_.capacity_trace_path;
+  }
+  LossFilter loss(&uplink_, kFlowId);
+  loss.SetLoss(config_.loss_percent);
+  DelayFilter delay(&uplink_, kFlowId);
+  delay.SetOneWayDelayMs(config_.one_way_delay_ms);
+  JitterFilter jitter(&uplink_, kFlowId);
+  jitter.SetMaxJitter(config_.max_jitter_ms);
+  RateCounterFilter counter(&uplink_, kFlowId, "Receiver",
+                            bwe_names[config_.bwe_type]);
+  PacketReceiver receiver(&uplink_, kFlowId, config_.bwe_type, false, false);
+  DelayFilter feedback_delay(&downlink_, kFlowId);
+  feedback_delay.SetOneWayDelayMs(config_.one_way_delay_ms);
+
+  RunFor(config_.run_time_ms);
+
+  result->throughput_kbps = counter.GetBitrateStats();
+  result->delay_ms = receiver.GetDelayStats();
+  result->packet_loss = receiver.GlobalPacketLoss();
+}
+
+BweScenarioRunner::BweScenarioRunner(size_t num_threads)
+    : num_threads_(num_threads), next_scenario_(0) {
+  RTC_DCHECK_GT(num_threads, 0u);
+}
+
+BweScenarioRunner::~BweScenarioRunner() {}
+
+void BweScenarioRunner::AddScenario(BweScenario* scenario) {
+  scenarios_.push_back(scenario);
+}
+
+std::vector<BweScenarioResult> BweScenarioRunner::RunAll() {
+  results_.clear();
+  results_.resize(scenarios_.size());
+  next_scenario_ = 0;
+  ScopedVector<rtc::PlatformThread> threads;
+  for (size_t i = 0; i < num_threads_; ++i) {
+    threads.push_back(
+        new rtc::PlatformThread(&RunScenariosThread, this, "BweScenario"));
+    threads.back()->Start();
+  }
+  for (rtc::PlatformThread* thread : threads)
+    thread->Stop();
+  std::vector<BweScenarioResult> results;
+  results.swap(results_);
+  scenarios_.clear();
+  return results;
+}
+
+bool BweScenarioRunner::RunScenariosThread(void* obj) {
+  static_cast<BweScenarioRunner*>(obj)->RunScenarios();
+  return false;
+}
+
+void BweScenarioRunner::RunScenarios() {
+  while (true) {
+    size_t index =
+        static_cast<size_t>(rtc::AtomicOps::Increment(&next_scenario_) - 1);
+    if (index >= scenarios_.size())
+      return;
+    BweScenario* scenario = scenarios_[index];
+    // Logging state is kept per thread.
+    BWE_TEST_LOGGING_GLOBAL_CONTEXT(scenario->name());
+    BWE_TEST_LOGGING_GLOBAL_ENABLE(false);
+    scenario->Run(&results_[index]);
+    results_[index].name = scenario->name();
+  }
+}
+
+void BweScenarioRunner::PrintResults(const std::string& test_name,
+                                     std::vector<BweScenarioResult> results) {
+  Stats<double> throughput_kbps;
+  Stats<double> delay_ms;
+  Stats<double> loss_percent;
+  for (BweScenarioResult& result : results) {
+    webrtc::test::PrintResultMeanAndError(
+        "BweScenario", test_name, result.name + " throughput",
+        result.throughput_kbps.AsString(), "kbps", false);
+    webrtc::test::PrintResultMeanAndError("BweScenario", test_name,
+                                          result.name + " delay",
+                                          result.delay_ms.AsString(), "ms",
+                                          false);
+    webrtc::test::PrintResult("BweScenario", test_name, result.name + " loss",
+                              100.0 * result.packet_loss, "%", false);
+    throughput_kbps.Push(result.throughput_kbps.GetMean());
+    delay_ms.Push(result.delay_ms.GetMean());
+    loss_percent.Push(100.0 * result.packet_loss);
+  }
+  if (results.empty())
+    return;
+  webrtc::test::PrintResultMeanAndError("BweScenario", test_name,
+                                        "Mean throughput",
+                                        throughput_kbps.AsString(), "kbps",
+                                        false);
+  webrtc::test::PrintResultMeanAndError("BweScenario", test_name,
+                                        "Mean delay", delay_ms.AsString(),
+                                        "ms", false);
+  webrtc::test::PrintResultMeanAndError("BweScenario", test_name, "Loss",
+                                        loss_percent.AsString(), "%", false);
+  webrtc::test::PrintResult("BweScenario", test_name,
+                            "Min mean throughput", throughput_kbps.GetMin(),
+                            "kbps", false);
+  webrtc::test::PrintResult("BweScenario", test_name, "Max mean delay",
+                            delay_ms.GetMax(), "ms", false);
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
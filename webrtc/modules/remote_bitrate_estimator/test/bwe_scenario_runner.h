@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+#define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+struct BweScenarioResult {
+  BweScenarioResult() : packet_loss(0.0f) {}
+
+  std::string name;
+  // Throughput at the receiver, sampled over the run.
+  Stats<double> throughput_kbps;
+  // One-way delay of the received packets.
+  Stats<double> delay_ms;
+  // Fraction of the packets that were lost.
+  float packet_loss;
+};
+
+// A simulation that doesn't depend on gtest, so that many of them can run at
+// once on different threads. All time is simulated and all filters use fixed
+// seeds, so the result of a scenario doesn't depend on how it is scheduled.
+class BweScenario : public BweTest {
+ public:
+  explicit BweScenario(const std::string& name);
+  virtual ~BweScenario();
+
+  const std::string& name() const { return name_; }
+
+  // Sets up the links, runs the simulation and fills in |result|.
+  virtual void Run(BweScenarioResult* result) = 0;
+
+ private:
+  const std::string name_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BweScenario);
+};
+
+// One adaptive video flow over a bottleneck link, with either a fixed
+// capacity or the capacity from a delivery trace (see
+// TraceBasedDeliveryFilter::Init()).
+class LinkScenario : public BweScenario {
+ public:
+  struct Config {
+    Config();
+
+    BandwidthEstimatorType bwe_type;
+    int64_t run_time_ms;
+    // Used if |capacity_trace_path| is empty.
+    uint32_t capacity_kbps;
+    std::string capacity_trace_path;
+    int64_t max_queueing_delay_ms;
+    int64_t one_way_delay_ms;
+    int64_t max_jitter_ms;
+    float loss_percent;
+  };
+
+  LinkScenario(const std::string& name, const Config& config);
+  virtual ~LinkScenario();
+
+  void Run(BweScenarioResult* result) override;
+
+ private:
+  const Config config_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LinkScenario);
+};
+
+// Runs many scenarios spread over a number of threads.
+class BweScenarioRunner {
+ public:
+  explicit BweScenarioRunner(size_t num_threads);
+  ~BweScenarioRunner();
+
+  // Takes ownership of |scenario|.
+  void AddScenario(BweScenario* scenario);
+
+  // Runs all scenarios and returns their results in the order the scenarios
+  // were added. Each scenario can only be run once.
+  std::vector<BweScenarioResult> RunAll();
+
+  // Prints the results of each scenario, and the distribution of the
+  // throughput, delay and loss over all scenarios.
+  static void PrintResults(const std::string& test_name,
+                           std::vector<BweScenarioResult> results);
+
+ private:
+  static bool RunScenariosThread(void* obj);
+  void RunScenarios();
+
+  const size_t num_threads_;
+  ScopedVector<BweScenario> scenarios_;
+  std::vector<BweScenarioResult> results_;
+  // Index of the next scenario to run.
+  volatile int next_scenario_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BweScenarioRunner);
+};
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
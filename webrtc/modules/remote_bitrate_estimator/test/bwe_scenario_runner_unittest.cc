@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include <sstream>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+namespace {
+const int kNumScenarios = 6;
+
+void AddScenarios(BweScenarioRunner* runner) {
+  for (int i = 0; i < kNumScenarios; ++i) {
+    LinkScenario::Config config;
+    config.run_time_ms = 5000;
+    config.capacity_kbps = 500 + 250 * i;
+    config.loss_percent = i % 2 == 0 ? 0.0f : 1.0f;
+    std::stringstream name;
+    name << "Link" << config.capacity_kbps;
+    runner->AddScenario(new LinkScenario(name.str(), config));
+  }
+}
+}  // namespace
+
+TEST(BweScenarioRunnerTest, ResultsDoNotDependOnNumberOfThreads) {
+  BweScenarioRunner serial_runner(1);
+  AddScenarios(&serial_runner);
+  std::vector<BweScenarioResult> serial_results = serial_runner.RunAll();
+
+  BweScenarioRunner parallel_runner(4);
+  AddScenarios(&parallel_runner);
+  std::vector<BweScenarioResult> parallel_results = parallel_runner.RunAll();
+
+  ASSERT_EQ(static_cast<size_t>(kNumScenarios), serial_results.size());
+  ASSERT_EQ(serial_results.size(), parallel_results.size());
+  for (size_t i = 0; i < serial_results.size(); ++i) {
+    EXPECT_EQ(serial_results[i].name, parallel_results[i].name);
+    EXPECT_EQ(serial_results[i].throughput_kbps.GetMean(),
+              parallel_results[i].throughput_kbps.GetMean());
+    EXPECT_EQ(serial_results[i].delay_ms.GetMean(),
+              parallel_results[i].delay_ms.GetMean());
+    EXPECT_EQ(serial_results[i].packet_loss, parallel_results[i].packet_loss);
+  }
+}
+
+TEST(BweScenarioRunnerTest, ThroughputFollowsCapacity) {
+  BweScenarioRunner runner(2);
+  AddScenarios(&runner);
+  std::vector<BweScenarioResult> results = runner.RunAll();
+  ASSERT_EQ(static_cast<size_t>(kNumScenarios), results.size());
+  EXPECT_EQ("Link500", results[0].name);
+  EXPECT_GT(results[0].throughput_kbps.GetMean(), 0.0);
+  EXPECT_LT(results[0].throughput_kbps.GetMean(), 500.0);
+  EXPECT_GT(results.back().throughput_kbps.GetMean(),
+            results[0].throughput_kbps.GetMean());
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
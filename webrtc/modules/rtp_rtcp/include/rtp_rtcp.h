@@ -538,6 +538,9 @@ class RtpRtcp : public Module {
     // Returns true if the module is configured to store packets.
     virtual bool StorePackets() const = 0;
 
+    // Returns the number of bytes allocated for storing sent packets.
+    virtual size_t PacketHistoryMemoryUsage() const = 0;
+
     // Called on receipt of RTCP report block from remote side.
     virtual void RegisterRtcpStatisticsCallback(
         RtcpStatisticsCallback* callback) = 0;
@@ -635,6 +638,21 @@ class RtpRtcp : public Module {
         const FecProtectionParams* delta_params,
         const FecProtectionParams* key_params) = 0;
 
+    /*
+    *   Turn on/off FlexFEC, which is sent with |payload_type| as a stream of
+    *   its own on |ssrc| rather than RED encapsulated with the media, and
+    *   follows the parameters of SetFecParameters(). Generic FEC takes
+    *   precedence while enabled.
+    */
+    virtual void SetFlexfecStatus(bool enable,
+                                  uint8_t payload_type,
+                                  uint32_t ssrc) = 0;
+
+    /*
+    *   Get the SSRC of FlexFEC, or 0 if it's off.
+    */
+    virtual uint32_t FlexfecSsrc() const = 0;
+
     /*
     *   Set method for requestion a new key frame
     *
@@ -213,6 +213,7 @@ class MockRtpRtcp : public RtpRtcp {
   MOCK_METHOD2(SetStorePacketsStatus,
                void(const bool enable, const uint16_t numberToStore));
   MOCK_CONST_METHOD0(StorePackets, bool());
+  MOCK_CONST_METHOD0(PacketHistoryMemoryUsage, size_t());
   MOCK_METHOD1(RegisterRtcpStatisticsCallback, void(RtcpStatisticsCallback*));
   MOCK_METHOD0(GetRtcpStatisticsCallback, RtcpStatisticsCallback*());
   MOCK_METHOD1(SendFeedbackPacket, bool(const rtcp::TransportFeedback& packet));
@@ -242,6 +243,9 @@ class MockRtpRtcp : public RtpRtcp {
   MOCK_METHOD2(SetFecParameters,
       int32_t(const FecProtectionParams* delta_params,
               const FecProtectionParams* key_params));
+  MOCK_METHOD3(SetFlexfecStatus,
+               void(bool enable, uint8_t payload_type, uint32_t ssrc));
+  MOCK_CONST_METHOD0(FlexfecSsrc, uint32_t());
   MOCK_METHOD1(SetKeyFrameRequestMethod,
       int32_t(const KeyFrameRequestMethod method));
   MOCK_METHOD0(RequestKeyFrame,
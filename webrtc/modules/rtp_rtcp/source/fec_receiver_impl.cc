@@ -91,7 +91,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
 
   rtc::scoped_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
       new ForwardErrorCorrection::ReceivedPacket);
-  received_packet->pkt = new ForwardErrorCorrection::Packet;
+  received_packet->pkt = fec_->NewPacket();
 
   // get payload type from RED header
   uint8_t payload_type =
@@ -161,7 +161,7 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
     received_packet->pkt->length = blockLength;
 
     second_received_packet.reset(new ForwardErrorCorrection::ReceivedPacket);
-    second_received_packet->pkt = new ForwardErrorCorrection::Packet;
+    second_received_packet->pkt = fec_->NewPacket();
 
     second_received_packet->is_fec = true;
     second_received_packet->seq_num = header.sequenceNumber;
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <string.h>
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+
+void FecXorC(uint8_t* dst, const uint8_t* src, size_t length) {
+  // Work on a word at a time; memcpy keeps unaligned accesses well defined
+  // and is compiled down to plain loads and stores.
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t a;
+    uint64_t b;
+    memcpy(&a, dst + i, sizeof(a));
+    memcpy(&b, src + i, sizeof(b));
+    a ^= b;
+    memcpy(dst + i, &a, sizeof(a));
+  }
+  for (; i < length; ++i)
+    dst[i] ^= src[i];
+}
+
+FecXorFunction GetFecXorFunction() {
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return FecXorSSE2;
+#else
+  // x86 CPU detection required.
+  return WebRtc_GetCPUInfo(kSSE2) ? FecXorSSE2 : FecXorC;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return FecXorNEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? FecXorNEON : FecXorC;
+#else
+  return FecXorC;
+#endif
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace internal {
+
+// XORs the |length| bytes at |src| into |dst|. The two ranges must not
+// overlap, and need not be aligned.
+typedef void (*FecXorFunction)(uint8_t* dst, const uint8_t* src, size_t length);
+
+void FecXorC(uint8_t* dst, const uint8_t* src, size_t length);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void FecXorSSE2(uint8_t* dst, const uint8_t* src, size_t length);
+#endif
+#if defined(WEBRTC_HAS_NEON) || defined(WEBRTC_DETECT_NEON)
+void FecXorNEON(uint8_t* dst, const uint8_t* src, size_t length);
+#endif
+
+// Returns the fastest of the above that the CPU supports.
+FecXorFunction GetFecXorFunction();
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace internal {
+
+void FecXorNEON(uint8_t* dst, const uint8_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    uint8x16_t d0 = vld1q_u8(dst + i);
+    uint8x16_t d1 = vld1q_u8(dst + i + 16);
+    uint8x16_t d2 = vld1q_u8(dst + i + 32);
+    uint8x16_t d3 = vld1q_u8(dst + i + 48);
+    d0 = veorq_u8(d0, vld1q_u8(src + i));
+    d1 = veorq_u8(d1, vld1q_u8(src + i + 16));
+    d2 = veorq_u8(d2, vld1q_u8(src + i + 32));
+    d3 = veorq_u8(d3, vld1q_u8(src + i + 48));
+    vst1q_u8(dst + i, d0);
+    vst1q_u8(dst + i + 16, d1);
+    vst1q_u8(dst + i + 32, d2);
+    vst1q_u8(dst + i + 48, d3);
+  }
+  for (; i + 16 <= length; i += 16)
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+  FecXorC(dst + i, src + i, length - i);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace internal {
+
+void FecXorSSE2(uint8_t* dst, const uint8_t* src, size_t length) {
+  size_t i = 0;
+  for (; i + 64 <= length; i += 64) {
+    __m128i d0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    __m128i d1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i + 16));
+    __m128i d2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i + 32));
+    __m128i d3 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i + 48));
+    d0 = _mm_xor_si128(
+        d0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    d1 = _mm_xor_si128(
+        d1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)));
+    d2 = _mm_xor_si128(
+        d2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32)));
+    d3 = _mm_xor_si128(
+        d3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), d1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 32), d2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 48), d3);
+  }
+  for (; i + 16 <= length; i += 16) {
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    d = _mm_xor_si128(
+        d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+  }
+  FecXorC(dst + i, src + i, length - i);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdlib.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+
+namespace webrtc {
+namespace internal {
+
+// Checks |xor_function| against a byte by byte XOR, for all lengths up to a
+// few vectors and for unaligned buffers.
+void VerifyFecXor(FecXorFunction xor_function) {
+  const size_t kMaxLength = 200;
+  const size_t kMaxOffset = 16;
+  srand(1);
+  std::vector<uint8_t> src(kMaxLength + kMaxOffset);
+  std::vector<uint8_t> dst(kMaxLength + kMaxOffset);
+  for (size_t offset = 0; offset < kMaxOffset; offset += 3) {
+    for (size_t length = 0; length <= kMaxLength; ++length) {
+      for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = static_cast<uint8_t>(rand());
+        dst[i] = static_cast<uint8_t>(rand());
+      }
+      std::vector<uint8_t> expected(dst);
+      for (size_t i = 0; i < length; ++i)
+        expected[offset + i] ^= src[i];
+
+      xor_function(&dst[offset], &src[0], length);
+      ASSERT_EQ(expected, dst) << "offset " << offset << ", length " << length;
+    }
+  }
+}
+
+TEST(FecXorTest, C) {
+  VerifyFecXor(FecXorC);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, SSE2) {
+  VerifyFecXor(FecXorSSE2);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON) || defined(WEBRTC_DETECT_NEON)
+TEST(FecXorTest, NEON) {
+  VerifyFecXor(FecXorNEON);
+}
+#endif
+
+TEST(FecXorTest, Default) {
+  VerifyFecXor(GetFecXorFunction());
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+namespace webrtc {
+namespace flexfec {
+
+void XorMediaPacket(const uint8_t* media,
+                    size_t media_length,
+                    internal::FecXorFunction xor_bytes,
+                    uint8_t* fec,
+                    size_t* fec_length) {
+  RTC_DCHECK_GE(media_length, kRtpHeaderSize);
+  RTC_DCHECK_LE(media_length, static_cast<size_t>(IP_PACKET_SIZE));
+  // P, X, CC, M and PT.
+  fec[0] ^= media[0];
+  fec[1] ^= media[1];
+  uint16_t length_recovery =
+      ByteReader<uint16_t>::ReadBigEndian(&fec[kLengthRecoveryOffset]) ^
+      static_cast<uint16_t>(media_length - kRtpHeaderSize);
+  ByteWriter<uint16_t>::WriteBigEndian(&fec[kLengthRecoveryOffset],
+                                       length_recovery);
+  xor_bytes(&fec[kTimestampRecoveryOffset], &media[4], 4);
+  xor_bytes(&fec[kHeaderSize], &media[kRtpHeaderSize],
+            media_length - kRtpHeaderSize);
+  *fec_length = std::max(*fec_length, kHeaderSize + media_length -
+                                          kRtpHeaderSize);
+}
+
+}  // namespace flexfec
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_HEADER_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_HEADER_H_
+
+#include <stddef.h>
+
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace flexfec {
+
+// FlexFEC packets (RFC 8627) are sent in their own RTP stream. We use the
+// fixed row and column protection of a single SSRC (R = 0, F = 1), where the
+// RTP header is followed by:
+//
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |0|1|P|X|  CC   |M| PT recovery |        length recovery        |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                          TS recovery                          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |   SSRCCount   |                    reserved                   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                             SSRC_i                            |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |           SN base_i           |  M (columns)  |    N (rows)   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |                   Repair "Payload" follows                    |
+//
+// With N <= 1 the packet is a row FEC packet protecting the M packets
+// SN base, SN base + 1, ..., and N = 1 tells that column FEC packets follow.
+// With N > 1 it's a column FEC packet protecting the N packets SN base,
+// SN base + M, ..., SN base + (N - 1) * M. The recovery fields and the repair
+// payload are the XOR of the protected packets; the latter of everything past
+// their 12 byte RTP header, i.e. CSRCs and header extensions included.
+
+const size_t kHeaderSize = 20;
+const size_t kLengthRecoveryOffset = 2;
+const size_t kTimestampRecoveryOffset = 4;
+const size_t kSsrcCountOffset = 8;
+const size_t kSsrcOffset = 12;
+const size_t kSeqNumBaseOffset = 16;
+const size_t kColumnsOffset = 18;
+const size_t kRowsOffset = 19;
+
+// Largest number of media packets an FEC packet may span, from the first to
+// the last one it protects, and thus largest block of rows and columns.
+const size_t kMaxProtectedPackets = 48;
+
+// Largest FlexFEC header and repair payload, for media packets of up to
+// IP_PACKET_SIZE bytes.
+const size_t kMaxFecSize = IP_PACKET_SIZE + kHeaderSize - kRtpHeaderSize;
+
+// XORs the RTP packet |media| of |media_length| bytes into the FlexFEC header
+// and repair payload at |fec|, growing |fec_length| to cover the packet.
+// |fec| must have room for kMaxFecSize bytes, and the repair payload past
+// |fec_length| must be zeroed.
+void XorMediaPacket(const uint8_t* media,
+                    size_t media_length,
+                    internal::FecXorFunction xor_bytes,
+                    uint8_t* fec,
+                    size_t* fec_length);
+
+}  // namespace flexfec
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_HEADER_H_
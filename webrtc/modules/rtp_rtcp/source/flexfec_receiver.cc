@@ -0,0 +1,245 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/flexfec_receiver.h"
+
+#include <string.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+namespace webrtc {
+
+namespace {
+
+// Number of recent media packets kept for recovery.
+const size_t kMediaPacketStoreSize = 128;
+// FEC packets protecting packets older than this, relative to the newest
+// media packet, are dropped, so that all packets they protect are still in
+// the store.
+const uint16_t kMaxFecPacketAge =
+    kMediaPacketStoreSize - flexfec::kMaxProtectedPackets;
+const size_t kMaxFecPackets = 64;
+
+// Returns the size of the RTP header of |packet|, or 0 if it's malformed.
+size_t RtpHeaderLength(const uint8_t* packet, size_t length) {
+  size_t header_length = kRtpHeaderSize + 4 * (packet[0] & 0x0f);
+  if (packet[0] & 0x10) {
+    if (length < header_length + 4)
+      return 0;
+    header_length +=
+        4 + 4 * ByteReader<uint16_t>::ReadBigEndian(&packet[header_length + 2]);
+  }
+  return header_length <= length ? header_length : 0;
+}
+
+}  // namespace
+
+FlexfecReceiver::FlexfecReceiver(uint32_t ssrc,
+                                 uint32_t protected_media_ssrc,
+                                 RtpData* callback)
+    : ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      callback_(callback),
+      xor_bytes_(internal::GetFecXorFunction()),
+      media_packets_(kMediaPacketStoreSize),
+      media_packet_received_(false),
+      newest_seq_num_(0) {
+  RTC_DCHECK(callback_);
+  fec_packets_.reserve(kMaxFecPackets + 1);
+  free_fec_packets_.reserve(kMaxFecPackets + 1);
+}
+
+FlexfecReceiver::~FlexfecReceiver() {
+  for (FecPacket* fec_packet : fec_packets_)
+    delete fec_packet;
+  for (FecPacket* fec_packet : free_fec_packets_)
+    delete fec_packet;
+}
+
+bool FlexfecReceiver::AddReceivedPacket(const uint8_t* packet, size_t length) {
+  if (length < kRtpHeaderSize)
+    return false;
+  uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
+  if (ssrc == ssrc_) {
+    ++packet_counter_.num_packets;
+    return AddFecPacket(packet, length);
+  }
+  if (ssrc != protected_media_ssrc_ || length > IP_PACKET_SIZE)
+    return false;
+  ++packet_counter_.num_packets;
+  uint16_t seq_num = ByteReader<uint16_t>::ReadBigEndian(&packet[2]);
+  if (GetMediaPacket(seq_num))
+    return true;  // Duplicate, or already recovered.
+  StoreMediaPacket(packet, length);
+  AttemptRecovery();
+  return true;
+}
+
+bool FlexfecReceiver::AddFecPacket(const uint8_t* packet, size_t length) {
+  size_t header_length = RtpHeaderLength(packet, length);
+  if (header_length == 0)
+    return false;
+  if (packet[0] & 0x20) {
+    // Strip the padding.
+    size_t padding_length = packet[length - 1];
+    if (padding_length > length - header_length)
+      return false;
+    length -= padding_length;
+  }
+  const uint8_t* fec = &packet[header_length];
+  size_t fec_length = length - header_length;
+  if (fec_length < flexfec::kHeaderSize || fec_length > flexfec::kMaxFecSize) {
+    LOG(LS_WARNING) << "Truncated or oversized FlexFEC packet.";
+    return false;
+  }
+  // Only fixed row and column protection of a single SSRC is supported.
+  if ((fec[0] & 0xc0) != 0x40 || fec[flexfec::kSsrcCountOffset] != 1 ||
+      ByteReader<uint32_t>::ReadBigEndian(&fec[flexfec::kSsrcOffset]) !=
+          protected_media_ssrc_) {
+    return false;
+  }
+  size_t columns = fec[flexfec::kColumnsOffset];
+  size_t rows = fec[flexfec::kRowsOffset];
+  size_t num_protected = rows <= 1 ? columns : rows;
+  size_t step = rows <= 1 ? 1 : columns;
+  if (num_protected == 0 ||
+      (num_protected - 1) * step + 1 > flexfec::kMaxProtectedPackets) {
+    LOG(LS_WARNING) << "Invalid FlexFEC packet mask.";
+    return false;
+  }
+  ++packet_counter_.num_fec_packets;
+
+  FecPacket* fec_packet;
+  if (free_fec_packets_.empty()) {
+    fec_packet = new FecPacket;
+  } else {
+    fec_packet = free_fec_packets_.back();
+    free_fec_packets_.pop_back();
+  }
+  fec_packet->seq_num_base =
+      ByteReader<uint16_t>::ReadBigEndian(&fec[flexfec::kSeqNumBaseOffset]);
+  fec_packet->num_protected = num_protected;
+  fec_packet->step = step;
+  fec_packet->length = fec_length;
+  memcpy(fec_packet->data, fec, fec_length);
+  fec_packets_.push_back(fec_packet);
+  if (fec_packets_.size() > kMaxFecPackets)
+    DiscardFecPacket(0);
+  AttemptRecovery();
+  return true;
+}
+
+void FlexfecReceiver::StoreMediaPacket(const uint8_t* packet, size_t length) {
+  uint16_t seq_num = ByteReader<uint16_t>::ReadBigEndian(&packet[2]);
+  rtc::scoped_ptr<MediaPacket>& stored =
+      media_packets_[seq_num % kMediaPacketStoreSize];
+  if (!stored)
+    stored.reset(new MediaPacket);
+  stored->seq_num = seq_num;
+  stored->length = length;
+  memcpy(stored->data, packet, length);
+  if (!media_packet_received_ ||
+      IsNewerSequenceNumber(seq_num, newest_seq_num_)) {
+    newest_seq_num_ = seq_num;
+  }
+  media_packet_received_ = true;
+}
+
+const FlexfecReceiver::MediaPacket* FlexfecReceiver::GetMediaPacket(
+    uint16_t seq_num) const {
+  const MediaPacket* stored =
+      media_packets_[seq_num % kMediaPacketStoreSize].get();
+  return stored && stored->seq_num == seq_num ? stored : nullptr;
+}
+
+void FlexfecReceiver::AttemptRecovery() {
+  size_t i = 0;
+  while (i < fec_packets_.size()) {
+    const FecPacket* fec_packet = fec_packets_[i];
+    if (media_packet_received_ &&
+        IsNewerSequenceNumber(
+            static_cast<uint16_t>(newest_seq_num_ - kMaxFecPacketAge),
+            fec_packet->seq_num_base)) {
+      DiscardFecPacket(i);
+      continue;
+    }
+    int num_missing = 0;
+    uint16_t missing_seq_num = 0;
+    for (size_t k = 0; k < fec_packet->num_protected && num_missing < 2; ++k) {
+      uint16_t seq_num = static_cast<uint16_t>(fec_packet->seq_num_base +
+                                               k * fec_packet->step);
+      if (!GetMediaPacket(seq_num)) {
+        missing_seq_num = seq_num;
+        ++num_missing;
+      }
+    }
+    if (num_missing == 1) {
+      bool recovered = RecoverPacket(*fec_packet, missing_seq_num);
+      DiscardFecPacket(i);
+      // The recovered packet may complete FEC packets already looked at.
+      if (recovered)
+        i = 0;
+    } else if (num_missing == 0) {
+      DiscardFecPacket(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+bool FlexfecReceiver::RecoverPacket(const FecPacket& fec_packet,
+                                    uint16_t seq_num) {
+  uint8_t recovered[flexfec::kMaxFecSize];
+  memcpy(recovered, fec_packet.data, fec_packet.length);
+  size_t recovered_length = fec_packet.length;
+  for (size_t k = 0; k < fec_packet.num_protected; ++k) {
+    const MediaPacket* media_packet = GetMediaPacket(
+        static_cast<uint16_t>(fec_packet.seq_num_base + k * fec_packet.step));
+    if (!media_packet)
+      continue;
+    if (media_packet->length - kRtpHeaderSize >
+        fec_packet.length - flexfec::kHeaderSize) {
+      LOG(LS_WARNING) << "FlexFEC packet shorter than a protected packet.";
+      return false;
+    }
+    flexfec::XorMediaPacket(media_packet->data, media_packet->length,
+                            xor_bytes_, recovered, &recovered_length);
+  }
+  size_t payload_length = ByteReader<uint16_t>::ReadBigEndian(
+      &recovered[flexfec::kLengthRecoveryOffset]);
+  if (payload_length > fec_packet.length - flexfec::kHeaderSize) {
+    LOG(LS_WARNING) << "Incorrect FlexFEC length recovery, dropping.";
+    return false;
+  }
+
+  uint8_t packet[IP_PACKET_SIZE];
+  packet[0] = 0x80 | (recovered[0] & 0x3f);  // Version 2.
+  packet[1] = recovered[1];
+  ByteWriter<uint16_t>::WriteBigEndian(&packet[2], seq_num);
+  memcpy(&packet[4], &recovered[flexfec::kTimestampRecoveryOffset], 4);
+  ByteWriter<uint32_t>::WriteBigEndian(&packet[8], protected_media_ssrc_);
+  memcpy(&packet[kRtpHeaderSize], &recovered[flexfec::kHeaderSize],
+         payload_length);
+  size_t length = kRtpHeaderSize + payload_length;
+  StoreMediaPacket(packet, length);
+  ++packet_counter_.num_recovered_packets;
+  callback_->OnRecoveredPacket(packet, length);
+  return true;
+}
+
+void FlexfecReceiver::DiscardFecPacket(size_t index) {
+  free_fec_packets_.push_back(fec_packets_[index]);
+  fec_packets_.erase(fec_packets_.begin() + index);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_RECEIVER_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_RECEIVER_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/rtp_rtcp/include/fec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Recovers lost media packets of one RTP stream from the FlexFEC packets,
+// see flexfec_header.h, sent for it in a stream of their own. Recovered
+// packets are handed to RtpData::OnRecoveredPacket() as soon as possible, so
+// that losses are repaired without waiting for the rest of the frame or for a
+// retransmission. Recovered packets can in turn complete other FEC packets,
+// which is what lets row and column FEC repair bursts.
+//
+// Not thread safe.
+class FlexfecReceiver {
+ public:
+  FlexfecReceiver(uint32_t ssrc, uint32_t protected_media_ssrc,
+                  RtpData* callback);
+  ~FlexfecReceiver();
+
+  uint32_t ssrc() const { return ssrc_; }
+  uint32_t protected_media_ssrc() const { return protected_media_ssrc_; }
+
+  // Takes the RTP packet |packet| of |length| bytes, which is either a media
+  // packet of the protected stream or an FEC packet. Returns false if the
+  // packet belongs to neither or is malformed.
+  bool AddReceivedPacket(const uint8_t* packet, size_t length);
+
+  FecPacketCounter GetPacketCounter() const { return packet_counter_; }
+
+ private:
+  struct MediaPacket {
+    uint16_t seq_num;
+    size_t length;
+    uint8_t data[IP_PACKET_SIZE];
+  };
+  struct FecPacket {
+    uint16_t seq_num_base;
+    size_t num_protected;
+    size_t step;
+    size_t length;
+    uint8_t data[flexfec::kMaxFecSize];
+  };
+
+  bool AddFecPacket(const uint8_t* packet, size_t length);
+  void StoreMediaPacket(const uint8_t* packet, size_t length);
+  // Returns the stored media packet with |seq_num|, or null if it's missing.
+  const MediaPacket* GetMediaPacket(uint16_t seq_num) const;
+  // Recovers what the stored FEC packets allow, until nothing changes.
+  void AttemptRecovery();
+  // Recovers the packet with |seq_num|, the only one |fec_packet| protects
+  // that is missing, and delivers it. Returns false if the FEC packet turns
+  // out to be inconsistent with the media packets.
+  bool RecoverPacket(const FecPacket& fec_packet, uint16_t seq_num);
+  void DiscardFecPacket(size_t index);
+
+  const uint32_t ssrc_;
+  const uint32_t protected_media_ssrc_;
+  RtpData* const callback_;
+  const internal::FecXorFunction xor_bytes_;
+
+  // The recent media packets, indexed by sequence number modulo the size.
+  std::vector<rtc::scoped_ptr<MediaPacket>> media_packets_;
+  bool media_packet_received_;
+  uint16_t newest_seq_num_;
+  // FEC packets that still protect a missing media packet, and storage to
+  // reuse for new ones.
+  std::vector<FecPacket*> fec_packets_;
+  std::vector<FecPacket*> free_fec_packets_;
+  FecPacketCounter packet_counter_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FlexfecReceiver);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_RECEIVER_H_
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/flexfec_sender.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+namespace webrtc {
+
+namespace {
+
+// Overhead, in the [0, 255] domain, from which on blocks get column FEC.
+const int kMinFecRateForColumns = 255 / 3;
+
+}  // namespace
+
+FlexfecSender::Accumulator::Accumulator() {
+  Reset();
+}
+
+void FlexfecSender::Accumulator::Reset() {
+  memset(data, 0, sizeof(data));
+  length = flexfec::kHeaderSize;
+}
+
+FlexfecSender::FlexfecSender(uint8_t payload_type, uint32_t ssrc)
+    : payload_type_(payload_type),
+      ssrc_(ssrc),
+      xor_bytes_(internal::GetFecXorFunction()),
+      seq_num_(0),
+      next_columns_(0),
+      next_rows_(0),
+      columns_(0),
+      rows_(0),
+      media_ssrc_(0),
+      seq_num_base_(0),
+      num_media_packets_(0),
+      timestamp_(0) {}
+
+FlexfecSender::~FlexfecSender() {}
+
+void FlexfecSender::SetProtection(size_t columns, size_t rows) {
+  RTC_DCHECK_LE(columns * std::max<size_t>(rows, 1),
+                flexfec::kMaxProtectedPackets);
+  next_columns_ = columns;
+  next_rows_ = columns > 0 && rows > 1 ? rows : 0;
+}
+
+void FlexfecSender::SetFecRate(int fec_rate) {
+  fec_rate = std::min(fec_rate, 255);
+  if (fec_rate <= 0) {
+    SetProtection(0, 0);
+  } else if (fec_rate < kMinFecRateForColumns) {
+    SetProtection(std::min<size_t>((255 + fec_rate - 1) / fec_rate,
+                                   flexfec::kMaxProtectedPackets),
+                  0);
+  } else {
+    // Half the overhead goes to each of the rows and the columns.
+    size_t size = (2 * 255 + fec_rate - 1) / fec_rate;
+    SetProtection(size, size);
+  }
+}
+
+void FlexfecSender::AddMediaPacket(const uint8_t* packet, size_t length) {
+  RTC_DCHECK_GE(length, kRtpHeaderSize);
+  uint16_t seq_num = ByteReader<uint16_t>::ReadBigEndian(&packet[2]);
+  uint32_t media_ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
+  if (num_media_packets_ > 0 &&
+      (media_ssrc != media_ssrc_ ||
+       seq_num != static_cast<uint16_t>(seq_num_base_ + num_media_packets_))) {
+    ResetBlock();
+  }
+  if (num_media_packets_ == 0) {
+    columns_ = next_columns_;
+    rows_ = next_rows_;
+    media_ssrc_ = media_ssrc;
+    seq_num_base_ = seq_num;
+    if (column_fec_.size() < columns_)
+      column_fec_.resize(columns_);
+  }
+  if (columns_ == 0)
+    return;
+
+  timestamp_ = ByteReader<uint32_t>::ReadBigEndian(&packet[4]);
+  const size_t index = num_media_packets_++;
+  const size_t row = index / columns_;
+  const size_t column = index % columns_;
+
+  flexfec::XorMediaPacket(packet, length, xor_bytes_, row_fec_.data,
+                          &row_fec_.length);
+  if (column == columns_ - 1) {
+    AddFecPacket(&row_fec_, static_cast<uint16_t>(seq_num - column),
+                 static_cast<uint8_t>(columns_), rows_ > 1 ? 1 : 0);
+  }
+  if (rows_ > 1) {
+    Accumulator* column_fec = &column_fec_[column];
+    flexfec::XorMediaPacket(packet, length, xor_bytes_, column_fec->data,
+                            &column_fec->length);
+    if (row == rows_ - 1) {
+      AddFecPacket(column_fec, static_cast<uint16_t>(seq_num_base_ + column),
+                   static_cast<uint8_t>(columns_), static_cast<uint8_t>(rows_));
+    }
+  }
+  if (num_media_packets_ == columns_ * std::max<size_t>(rows_, 1))
+    num_media_packets_ = 0;
+}
+
+std::vector<rtc::Buffer> FlexfecSender::GetFecPackets() {
+  std::vector<rtc::Buffer> fec_packets;
+  fec_packets.swap(fec_packets_);
+  return fec_packets;
+}
+
+void FlexfecSender::ResetBlock() {
+  row_fec_.Reset();
+  for (size_t i = 0; i < columns_ && rows_ > 1; ++i)
+    column_fec_[i].Reset();
+  num_media_packets_ = 0;
+}
+
+void FlexfecSender::AddFecPacket(Accumulator* fec,
+                                 uint16_t seq_num_base,
+                                 uint8_t columns,
+                                 uint8_t rows) {
+  uint8_t* data = fec->data;
+  // R = 0 and F = 1, next to the recovered P, X and CC.
+  data[0] = 0x40 | (data[0] & 0x3f);
+  data[flexfec::kSsrcCountOffset] = 1;
+  ByteWriter<uint32_t>::WriteBigEndian(&data[flexfec::kSsrcOffset],
+                                       media_ssrc_);
+  ByteWriter<uint16_t>::WriteBigEndian(&data[flexfec::kSeqNumBaseOffset],
+                                       seq_num_base);
+  data[flexfec::kColumnsOffset] = columns;
+  data[flexfec::kRowsOffset] = rows;
+
+  rtc::Buffer packet(kRtpHeaderSize + fec->length);
+  uint8_t* rtp_header = packet.data();
+  rtp_header[0] = 0x80;  // Version 2.
+  rtp_header[1] = payload_type_;
+  ByteWriter<uint16_t>::WriteBigEndian(&rtp_header[2], seq_num_++);
+  ByteWriter<uint32_t>::WriteBigEndian(&rtp_header[4], timestamp_);
+  ByteWriter<uint32_t>::WriteBigEndian(&rtp_header[8], ssrc_);
+  memcpy(&rtp_header[kRtpHeaderSize], data, fec->length);
+  fec_packets_.push_back(std::move(packet));
+  fec->Reset();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_SENDER_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_SENDER_H_
+
+#include <vector>
+
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Generates FlexFEC packets, see flexfec_header.h, for the media packets of
+// one RTP stream. The media packets are laid out in blocks of |rows| rows of
+// |columns| consecutive packets each. Every row is protected by a row FEC
+// packet and, if there is more than one row, every column by a column FEC
+// packet, so that any single loss, and bursts of up to |columns| losses, can
+// be recovered. Blocks span frames, so the overhead is exactly
+// 1 / |columns| + 1 / |rows|, without RED encapsulation of the media.
+//
+// Not thread safe.
+class FlexfecSender {
+ public:
+  FlexfecSender(uint8_t payload_type, uint32_t ssrc);
+  ~FlexfecSender();
+
+  uint8_t payload_type() const { return payload_type_; }
+  uint32_t ssrc() const { return ssrc_; }
+
+  // Sets the protection of the next block of media packets, which can't be
+  // larger than flexfec::kMaxProtectedPackets. Zero |columns| turns FEC off,
+  // and |rows| <= 1 only protects rows.
+  void SetProtection(size_t columns, size_t rows);
+
+  // Sets the protection from |fec_rate|, the FEC overhead in the [0, 255]
+  // domain like in FecProtectionParams. Up to a third of overhead is spent on
+  // row FEC only; beyond that blocks are square.
+  void SetFecRate(int fec_rate);
+
+  // Protects the RTP packet |packet| of |length| bytes, which must have the
+  // sequence number following the previous packet; otherwise the current
+  // block is dropped unprotected.
+  void AddMediaPacket(const uint8_t* packet, size_t length);
+
+  // Returns the RTP packets of the FEC generated since the last call.
+  std::vector<rtc::Buffer> GetFecPackets();
+
+ private:
+  struct Accumulator {
+    Accumulator();
+
+    void Reset();
+
+    uint8_t data[flexfec::kMaxFecSize];
+    size_t length;
+  };
+
+  void ResetBlock();
+  // Writes the RTP and FlexFEC headers around the repair payload in |fec|,
+  // queues the packet and resets |fec|.
+  void AddFecPacket(Accumulator* fec, uint16_t seq_num_base, uint8_t columns,
+                    uint8_t rows);
+
+  const uint8_t payload_type_;
+  const uint32_t ssrc_;
+  const internal::FecXorFunction xor_bytes_;
+  uint16_t seq_num_;
+
+  size_t next_columns_;
+  size_t next_rows_;
+
+  // The current block.
+  size_t columns_;
+  size_t rows_;
+  uint32_t media_ssrc_;
+  uint16_t seq_num_base_;
+  size_t num_media_packets_;
+  uint32_t timestamp_;
+  Accumulator row_fec_;
+  std::vector<Accumulator> column_fec_;
+
+  std::vector<rtc::Buffer> fec_packets_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FlexfecSender);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FLEXFEC_SENDER_H_
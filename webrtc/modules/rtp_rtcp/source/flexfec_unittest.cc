@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_sender.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint8_t kFlexfecPayloadType = 118;
+const uint32_t kFlexfecSsrc = 0x11111111;
+const uint32_t kMediaSsrc = 0x22222222;
+
+class RecoveredPacketCollector : public NullRtpData {
+ public:
+  bool OnRecoveredPacket(const uint8_t* packet, size_t length) override {
+    uint16_t seq_num = ByteReader<uint16_t>::ReadBigEndian(&packet[2]);
+    EXPECT_EQ(0u, packets_.count(seq_num)) << "Recovered twice: " << seq_num;
+    packets_[seq_num] = rtc::Buffer(packet, length);
+    return true;
+  }
+
+  std::map<uint16_t, rtc::Buffer> packets_;
+};
+
+}  // namespace
+
+class FlexfecTest : public ::testing::Test {
+ protected:
+  FlexfecTest()
+      : sender_(kFlexfecPayloadType, kFlexfecSsrc),
+        receiver_(kFlexfecSsrc, kMediaSsrc, &recovered_) {}
+
+  // Creates and protects |num_packets| media packets of varying size.
+  void GenerateMediaPackets(size_t num_packets) {
+    for (size_t i = 0; i < num_packets; ++i) {
+      uint16_t seq_num = static_cast<uint16_t>(kFirstSeqNum + i);
+      rtc::Buffer packet(kRtpHeaderSize + 100 + 37 * (i % 5));
+      uint8_t* data = packet.data();
+      for (size_t j = 0; j < packet.size(); ++j)
+        data[j] = static_cast<uint8_t>(j * 7 + i);
+      data[0] = 0x80;
+      data[1] = 100 | (i % 3 == 0 ? 0x80 : 0);  // Payload type and marker.
+      ByteWriter<uint16_t>::WriteBigEndian(&data[2], seq_num);
+      ByteWriter<uint32_t>::WriteBigEndian(&data[4], 3000 * (i / 3));
+      ByteWriter<uint32_t>::WriteBigEndian(&data[8], kMediaSsrc);
+      sender_.AddMediaPacket(data, packet.size());
+      media_packets_.push_back(std::move(packet));
+    }
+    fec_packets_ = sender_.GetFecPackets();
+  }
+
+  // Delivers the media packets except for the |lost| ones, and all FEC
+  // packets, after or before the media, then checks that the lost packets
+  // were recovered exactly.
+  void ReceiveAndExpectRecovery(const std::set<size_t>& lost,
+                                bool fec_first) {
+    if (fec_first)
+      ReceiveFecPackets();
+    for (size_t i = 0; i < media_packets_.size(); ++i) {
+      if (lost.count(i) == 0) {
+        EXPECT_TRUE(receiver_.AddReceivedPacket(media_packets_[i].data(),
+                                                media_packets_[i].size()));
+      }
+    }
+    if (!fec_first)
+      ReceiveFecPackets();
+    for (size_t i : lost) {
+      uint16_t seq_num = static_cast<uint16_t>(kFirstSeqNum + i);
+      EXPECT_EQ(1u, recovered_.packets_.count(seq_num)) << i;
+    }
+    // With the FEC first, packets that are merely late get recovered too.
+    if (!fec_first)
+      EXPECT_EQ(lost.size(), recovered_.packets_.size());
+    for (const auto& kv : recovered_.packets_) {
+      size_t i = static_cast<uint16_t>(kv.first - kFirstSeqNum);
+      ASSERT_LT(i, media_packets_.size());
+      EXPECT_EQ(media_packets_[i], kv.second) << i;
+    }
+  }
+
+  void ReceiveFecPackets() {
+    for (const rtc::Buffer& fec_packet : fec_packets_) {
+      EXPECT_TRUE(
+          receiver_.AddReceivedPacket(fec_packet.data(), fec_packet.size()));
+    }
+  }
+
+  static const uint16_t kFirstSeqNum = 65530;  // Wraps within the tests.
+
+  FlexfecSender sender_;
+  RecoveredPacketCollector recovered_;
+  FlexfecReceiver receiver_;
+  std::vector<rtc::Buffer> media_packets_;
+  std::vector<rtc::Buffer> fec_packets_;
+};
+
+TEST_F(FlexfecTest, NoFecByDefault) {
+  GenerateMediaPackets(10);
+  EXPECT_TRUE(fec_packets_.empty());
+}
+
+TEST_F(FlexfecTest, RowFecPacketHeaders) {
+  sender_.SetProtection(4, 0);
+  GenerateMediaPackets(9);
+  ASSERT_EQ(2u, fec_packets_.size());
+  for (size_t i = 0; i < fec_packets_.size(); ++i) {
+    const uint8_t* data = fec_packets_[i].data();
+    EXPECT_EQ(0x80, data[0]);
+    EXPECT_EQ(kFlexfecPayloadType, data[1]);
+    EXPECT_EQ(i, ByteReader<uint16_t>::ReadBigEndian(&data[2]));
+    EXPECT_EQ(kFlexfecSsrc, ByteReader<uint32_t>::ReadBigEndian(&data[8]));
+    const uint8_t* fec = &data[kRtpHeaderSize];
+    EXPECT_EQ(0x40, fec[0] & 0xc0);
+    EXPECT_EQ(1, fec[flexfec::kSsrcCountOffset]);
+    EXPECT_EQ(kMediaSsrc,
+              ByteReader<uint32_t>::ReadBigEndian(&fec[flexfec::kSsrcOffset]));
+    EXPECT_EQ(static_cast<uint16_t>(kFirstSeqNum + 4 * i),
+              ByteReader<uint16_t>::ReadBigEndian(
+                  &fec[flexfec::kSeqNumBaseOffset]));
+    EXPECT_EQ(4, fec[flexfec::kColumnsOffset]);
+    EXPECT_EQ(0, fec[flexfec::kRowsOffset]);
+  }
+}
+
+TEST_F(FlexfecTest, RecoversOneLossPerRow) {
+  sender_.SetProtection(4, 0);
+  GenerateMediaPackets(12);
+  EXPECT_EQ(3u, fec_packets_.size());
+  ReceiveAndExpectRecovery({1, 4, 11}, false);
+  EXPECT_EQ(3u, receiver_.GetPacketCounter().num_recovered_packets);
+}
+
+TEST_F(FlexfecTest, CantRecoverTwoLossesInARow) {
+  sender_.SetProtection(4, 0);
+  GenerateMediaPackets(4);
+  for (size_t i = 2; i < media_packets_.size(); ++i) {
+    EXPECT_TRUE(receiver_.AddReceivedPacket(media_packets_[i].data(),
+                                            media_packets_[i].size()));
+  }
+  ReceiveFecPackets();
+  EXPECT_TRUE(recovered_.packets_.empty());
+}
+
+TEST_F(FlexfecTest, ColumnFecRecoversBurst) {
+  sender_.SetProtection(4, 3);
+  GenerateMediaPackets(12);
+  // 3 row and 4 column FEC packets.
+  EXPECT_EQ(7u, fec_packets_.size());
+  ReceiveAndExpectRecovery({4, 5, 6, 7}, false);
+}
+
+TEST_F(FlexfecTest, RowAndColumnFecRecoverTogether) {
+  sender_.SetProtection(4, 3);
+  GenerateMediaPackets(12);
+  // Rows 1 and 2 recover 4 and 9, which lets column 0 recover 0, and then
+  // row 0 recover 1.
+  ReceiveAndExpectRecovery({0, 1, 4, 9}, false);
+}
+
+TEST_F(FlexfecTest, RecoversWhenFecArrivesFirst) {
+  sender_.SetProtection(4, 3);
+  GenerateMediaPackets(12);
+  ReceiveAndExpectRecovery({2, 3, 6, 10}, true);
+}
+
+TEST_F(FlexfecTest, SequenceNumberGapStartsNewBlock) {
+  sender_.SetProtection(2, 0);
+  GenerateMediaPackets(1);
+  // A packet that doesn't follow the previous one.
+  rtc::Buffer packet(media_packets_[0]);
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[2], 1000);
+  sender_.AddMediaPacket(packet.data(), packet.size());
+  EXPECT_TRUE(sender_.GetFecPackets().empty());
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[2], 1001);
+  sender_.AddMediaPacket(packet.data(), packet.size());
+  std::vector<rtc::Buffer> fec_packets = sender_.GetFecPackets();
+  ASSERT_EQ(1u, fec_packets.size());
+  EXPECT_EQ(1000, ByteReader<uint16_t>::ReadBigEndian(
+                      &fec_packets[0].data()[kRtpHeaderSize +
+                                             flexfec::kSeqNumBaseOffset]));
+}
+
+TEST_F(FlexfecTest, LowFecRateProtectsRows) {
+  // 20% overhead: rows of 5 packets.
+  sender_.SetFecRate(51);
+  GenerateMediaPackets(10);
+  EXPECT_EQ(2u, fec_packets_.size());
+}
+
+TEST_F(FlexfecTest, HighFecRateProtectsRowsAndColumns) {
+  // 50% overhead: blocks of 4 x 4 packets.
+  sender_.SetFecRate(128);
+  GenerateMediaPackets(16);
+  EXPECT_EQ(8u, fec_packets_.size());
+  ReceiveAndExpectRecovery({4, 5, 6, 7, 15}, false);
+}
+
+TEST_F(FlexfecTest, IgnoresOtherAndMalformedPackets) {
+  sender_.SetProtection(4, 0);
+  GenerateMediaPackets(4);
+  rtc::Buffer packet(fec_packets_[0]);
+  ByteWriter<uint32_t>::WriteBigEndian(&packet.data()[8], 0x33333333);
+  EXPECT_FALSE(receiver_.AddReceivedPacket(packet.data(), packet.size()));
+  // Truncated FlexFEC header.
+  EXPECT_FALSE(receiver_.AddReceivedPacket(fec_packets_[0].data(),
+                                           kRtpHeaderSize + 10));
+  // Retransmission (R = 1) and flexible mask (F = 0) modes.
+  packet = fec_packets_[0];
+  packet.data()[kRtpHeaderSize] ^= 0xc0;
+  EXPECT_FALSE(receiver_.AddReceivedPacket(packet.data(), packet.size()));
+  packet.data()[kRtpHeaderSize] ^= 0x40;
+  EXPECT_FALSE(receiver_.AddReceivedPacket(packet.data(), packet.size()));
+  // Protecting another SSRC.
+  packet = fec_packets_[0];
+  packet.data()[kRtpHeaderSize + flexfec::kSsrcOffset] ^= 0xff;
+  EXPECT_FALSE(receiver_.AddReceivedPacket(packet.data(), packet.size()));
+  EXPECT_EQ(0u, receiver_.GetPacketCounter().num_fec_packets);
+}
+
+}  // namespace webrtc
@@ -18,8 +18,10 @@
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/refcount.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction_internal.h"
 
 namespace webrtc {
@@ -38,6 +40,51 @@ const uint8_t kTransportOverhead = 28;
 
 enum { kMaxFecPackets = ForwardErrorCorrection::kMaxMediaPackets };
 
+// Enough packets for full recovered and FEC packet lists.
+const size_t kMaxPooledPackets = 2 * ForwardErrorCorrection::kMaxMediaPackets;
+
+// Keeps up to kMaxPooledPackets released packets for reuse. Packets handed out
+// by the pool hold a reference to it, while the ones it keeps don't, so the
+// pool goes away with the last of its owner and the packets in use.
+class ForwardErrorCorrection::PacketPool : public rtc::RefCountInterface {
+ public:
+  PacketPool() { free_packets_.reserve(kMaxPooledPackets); }
+
+  Packet* Get() {
+    Packet* packet;
+    if (free_packets_.empty()) {
+      packet = new Packet;
+    } else {
+      packet = free_packets_.back();
+      free_packets_.pop_back();
+      packet->length = 0;
+      memset(packet->data, 0, sizeof(packet->data));
+    }
+    packet->pool_ = this;
+    return packet;
+  }
+
+  void Recycle(Packet* packet) {
+    if (free_packets_.size() < kMaxPooledPackets)
+      free_packets_.push_back(packet);
+    else
+      delete packet;
+  }
+
+ protected:
+  ~PacketPool() override {
+    for (Packet* packet : free_packets_)
+      delete packet;
+  }
+
+ private:
+  std::vector<Packet*> free_packets_;
+};
+
+ForwardErrorCorrection::Packet::Packet() : length(0), data(), ref_count_(0) {}
+
+ForwardErrorCorrection::Packet::~Packet() {}
+
 int32_t ForwardErrorCorrection::Packet::AddRef() {
   return ++ref_count_;
 }
@@ -45,8 +92,16 @@ int32_t ForwardErrorCorrection::Packet::AddRef() {
 int32_t ForwardErrorCorrection::Packet::Release() {
   int32_t ref_count;
   ref_count = --ref_count_;
-  if (ref_count == 0)
-    delete this;
+  if (ref_count == 0) {
+    if (pool_) {
+      // The pool may go away with this reference.
+      rtc::scoped_refptr<PacketPool> pool;
+      pool.swap(pool_);
+      pool->Recycle(this);
+    } else {
+      delete this;
+    }
+  }
   return ref_count;
 }
 
@@ -58,7 +113,7 @@ class ProtectedPacket : public ForwardErrorCorrection::SortablePacket {
   rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
 };
 
-typedef std::list<ProtectedPacket*> ProtectedPacketList;
+typedef std::vector<ProtectedPacket*> ProtectedPacketList;
 
 //
 // Used for internal storage of FEC packets in a list.
@@ -66,6 +121,11 @@ typedef std::list<ProtectedPacket*> ProtectedPacketList;
 // TODO(holmer): Refactor into a proper class.
 class FecPacket : public ForwardErrorCorrection::SortablePacket {
  public:
+  FecPacket() { protected_pkt_list.reserve(kMaxFecPackets); }
+
+  // Storage for the entries of |protected_pkt_list|, one per bit of the
+  // largest packet mask.
+  ProtectedPacket protected_pkts[kMaxFecPackets];
   ProtectedPacketList protected_pkt_list;
   uint32_t ssrc;  // SSRC of the current frame.
   rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
@@ -84,9 +144,25 @@ ForwardErrorCorrection::RecoveredPacket::RecoveredPacket() {}
 ForwardErrorCorrection::RecoveredPacket::~RecoveredPacket() {}
 
 ForwardErrorCorrection::ForwardErrorCorrection()
-    : generated_fec_packets_(kMaxMediaPackets), fec_packet_received_(false) {}
+    : generated_fec_packets_(kMaxMediaPackets),
+      fec_packet_received_(false),
+      xor_bytes_(internal::GetFecXorFunction()),
+      packet_pool_(new rtc::RefCountedObject<PacketPool>()) {
+  fec_packet_list_.reserve(kMaxFecPackets + 1);
+  free_fec_packets_.reserve(kMaxFecPackets + 1);
+}
+
+ForwardErrorCorrection::~ForwardErrorCorrection() {
+  while (!fec_packet_list_.empty())
+    DiscardFECPacket(fec_packet_list_.begin());
+  for (FecPacket* fec_packet : free_fec_packets_)
+    delete fec_packet;
+}
 
-ForwardErrorCorrection::~ForwardErrorCorrection() {}
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::NewPacket() {
+  return packet_pool_->Get();
+}
 
 // Input packet
 //   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
@@ -216,71 +292,69 @@ void ForwardErrorCorrection::GenerateFecBitStrings(
   const uint16_t fec_rtp_offset =
       kFecHeaderSize + ulp_header_size - kRtpHeaderSize;
 
-  for (int i = 0; i < num_fec_packets; ++i) {
-    Packet* const fec_packet = &generated_fec_packets_[i];
-    PacketList::const_iterator media_list_it = media_packet_list.begin();
-    uint32_t pkt_mask_idx = i * num_mask_bytes;
-    uint32_t media_pkt_idx = 0;
-    uint16_t fec_packet_length = 0;
-    uint16_t prev_seq_num = ParseSequenceNumber((*media_list_it)->data);
-    while (media_list_it != media_packet_list.end()) {
+  // Each media packet is XORed into all the FEC packets that protect it
+  // before moving on to the next one, so that it's only brought into the
+  // cache once.
+  const uint16_t first_seq_num =
+      ParseSequenceNumber(media_packet_list.front()->data);
+  for (Packet* media_packet : media_packet_list) {
+    // The position of this media packet in the packet masks.
+    const uint16_t media_pkt_idx =
+        ParseSequenceNumber(media_packet->data) - first_seq_num;
+    const int mask_byte_idx = media_pkt_idx / 8;
+    const uint8_t mask_bit = 1 << (7 - media_pkt_idx % 8);
+
+    // Assign network-ordered media payload length.
+    ByteWriter<uint16_t>::WriteBigEndian(
+        media_payload_length, media_packet->length - kRtpHeaderSize);
+    const uint16_t fec_packet_length = media_packet->length + fec_rtp_offset;
+
+    for (int i = 0; i < num_fec_packets; ++i) {
       // Each FEC packet has a multiple byte mask. Determine if this media
       // packet should be included in FEC packet i.
-      if (packet_mask[pkt_mask_idx] & (1 << (7 - media_pkt_idx))) {
-        Packet* media_packet = *media_list_it;
-
-        // Assign network-ordered media payload length.
-        ByteWriter<uint16_t>::WriteBigEndian(
-            media_payload_length, media_packet->length - kRtpHeaderSize);
-
-        fec_packet_length = media_packet->length + fec_rtp_offset;
-        // On the first protected packet, we don't need to XOR.
-        if (fec_packet->length == 0) {
-          // Copy the first 2 bytes of the RTP header.
-          memcpy(fec_packet->data, media_packet->data, 2);
-          // Copy the 5th to 8th bytes of the RTP header.
-          memcpy(&fec_packet->data[4], &media_packet->data[4], 4);
-          // Copy network-ordered payload size.
-          memcpy(&fec_packet->data[8], media_payload_length, 2);
-
-          // Copy RTP payload, leaving room for the ULP header.
-          memcpy(&fec_packet->data[kFecHeaderSize + ulp_header_size],
-                 &media_packet->data[kRtpHeaderSize],
-                 media_packet->length - kRtpHeaderSize);
-        } else {
-          // XOR with the first 2 bytes of the RTP header.
-          fec_packet->data[0] ^= media_packet->data[0];
-          fec_packet->data[1] ^= media_packet->data[1];
-
-          // XOR with the 5th to 8th bytes of the RTP header.
-          for (uint32_t j = 4; j < 8; ++j) {
-            fec_packet->data[j] ^= media_packet->data[j];
-          }
-
-          // XOR with the network-ordered payload size.
-          fec_packet->data[8] ^= media_payload_length[0];
-          fec_packet->data[9] ^= media_payload_length[1];
-
-          // XOR with RTP payload, leaving room for the ULP header.
-          for (int32_t j = kFecHeaderSize + ulp_header_size;
-               j < fec_packet_length; j++) {
-            fec_packet->data[j] ^= media_packet->data[j - fec_rtp_offset];
-          }
-        }
-        if (fec_packet_length > fec_packet->length) {
-          fec_packet->length = fec_packet_length;
+      if (!(packet_mask[i * num_mask_bytes + mask_byte_idx] & mask_bit))
+        continue;
+
+      Packet* const fec_packet = &generated_fec_packets_[i];
+      // On the first protected packet, we don't need to XOR.
+      if (fec_packet->length == 0) {
+        // Copy the first 2 bytes of the RTP header.
+        memcpy(fec_packet->data, media_packet->data, 2);
+        // Copy the 5th to 8th bytes of the RTP header.
+        memcpy(&fec_packet->data[4], &media_packet->data[4], 4);
+        // Copy network-ordered payload size.
+        memcpy(&fec_packet->data[8], media_payload_length, 2);
+
+        // Copy RTP payload, leaving room for the ULP header.
+        memcpy(&fec_packet->data[kFecHeaderSize + ulp_header_size],
+               &media_packet->data[kRtpHeaderSize],
+               media_packet->length - kRtpHeaderSize);
+      } else {
+        // XOR with the first 2 bytes of the RTP header.
+        fec_packet->data[0] ^= media_packet->data[0];
+        fec_packet->data[1] ^= media_packet->data[1];
+
+        // XOR with the 5th to 8th bytes of the RTP header.
+        for (uint32_t j = 4; j < 8; ++j) {
+          fec_packet->data[j] ^= media_packet->data[j];
         }
+
+        // XOR with the network-ordered payload size.
+        fec_packet->data[8] ^= media_payload_length[0];
+        fec_packet->data[9] ^= media_payload_length[1];
+
+        // XOR with RTP payload, leaving room for the ULP header.
+        xor_bytes_(&fec_packet->data[kFecHeaderSize + ulp_header_size],
+                   &media_packet->data[kRtpHeaderSize],
+                   media_packet->length - kRtpHeaderSize);
       }
-      media_list_it++;
-      if (media_list_it != media_packet_list.end()) {
-        uint16_t seq_num = ParseSequenceNumber((*media_list_it)->data);
-        media_pkt_idx += static_cast<uint16_t>(seq_num - prev_seq_num);
-        prev_seq_num = seq_num;
+      if (fec_packet_length > fec_packet->length) {
+        fec_packet->length = fec_packet_length;
       }
-      pkt_mask_idx += media_pkt_idx / 8;
-      media_pkt_idx %= 8;
     }
-    RTC_DCHECK_GT(fec_packet->length, 0u)
+  }
+  for (int i = 0; i < num_fec_packets; ++i) {
+    RTC_DCHECK_GT(generated_fec_packets_[i].length, 0u)
         << "Packet mask is wrong or poorly designed.";
   }
 }
@@ -461,21 +535,8 @@ void ForwardErrorCorrection::ResetState(
   assert(recovered_packet_list->empty());
 
   // Free the FEC packet list.
-  while (!fec_packet_list_.empty()) {
-    FecPacketList::iterator fec_packet_list_it = fec_packet_list_.begin();
-    FecPacket* fec_packet = *fec_packet_list_it;
-    ProtectedPacketList::iterator protected_packet_list_it;
-    protected_packet_list_it = fec_packet->protected_pkt_list.begin();
-    while (protected_packet_list_it != fec_packet->protected_pkt_list.end()) {
-      delete *protected_packet_list_it;
-      protected_packet_list_it =
-          fec_packet->protected_pkt_list.erase(protected_packet_list_it);
-    }
-    assert(fec_packet->protected_pkt_list.empty());
-    delete fec_packet;
-    fec_packet_list_.pop_front();
-  }
-  assert(fec_packet_list_.empty());
+  while (!fec_packet_list_.empty())
+    DiscardFECPacket(fec_packet_list_.begin());
 }
 
 void ForwardErrorCorrection::InsertMediaPacket(
@@ -539,7 +600,13 @@ void ForwardErrorCorrection::InsertFECPacket(
     }
     fec_packet_list_it++;
   }
-  FecPacket* fec_packet = new FecPacket;
+  FecPacket* fec_packet;
+  if (free_fec_packets_.empty()) {
+    fec_packet = new FecPacket;
+  } else {
+    fec_packet = free_fec_packets_.back();
+    free_fec_packets_.pop_back();
+  }
   fec_packet->pkt = rx_packet->pkt;
   fec_packet->seq_num = rx_packet->seq_num;
   fec_packet->ssrc = rx_packet->ssrc;
@@ -554,7 +621,8 @@ void ForwardErrorCorrection::InsertFECPacket(
     uint8_t packet_mask = fec_packet->pkt->data[12 + byte_idx];
     for (uint16_t bit_idx = 0; bit_idx < 8; ++bit_idx) {
       if (packet_mask & (1 << (7 - bit_idx))) {
-        ProtectedPacket* protected_packet = new ProtectedPacket;
+        ProtectedPacket* protected_packet =
+            &fec_packet->protected_pkts[fec_packet->protected_pkt_list.size()];
         fec_packet->protected_pkt_list.push_back(protected_packet);
         // This wraps naturally with the sequence number.
         protected_packet->seq_num =
@@ -566,17 +634,16 @@ void ForwardErrorCorrection::InsertFECPacket(
   if (fec_packet->protected_pkt_list.empty()) {
     // All-zero packet mask; we can discard this FEC packet.
     LOG(LS_WARNING) << "FEC packet has an all-zero packet mask.";
-    delete fec_packet;
+    fec_packet->pkt = NULL;
+    free_fec_packets_.push_back(fec_packet);
   } else {
     AssignRecoveredPackets(fec_packet, recovered_packet_list);
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    fec_packet_list_.push_back(fec_packet);
-    fec_packet_list_.sort(SortablePacket::LessThan);
-    if (fec_packet_list_.size() > kMaxFecPackets) {
-      DiscardFECPacket(fec_packet_list_.front());
-      fec_packet_list_.pop_front();
-    }
+    fec_packet_list_.insert(
+        std::upper_bound(fec_packet_list_.begin(), fec_packet_list_.end(),
+                         fec_packet, SortablePacket::LessThan),
+        fec_packet);
+    if (fec_packet_list_.size() > kMaxFecPackets)
+      DiscardFECPacket(fec_packet_list_.begin());
     assert(fec_packet_list_.size() <= kMaxFecPackets);
   }
 }
@@ -622,10 +689,8 @@ void ForwardErrorCorrection::InsertPackets(
       uint16_t seq_num_diff =
           abs(static_cast<int>(rx_packet->seq_num) -
               static_cast<int>(fec_packet_list_.front()->seq_num));
-      if (seq_num_diff > 0x3fff) {
-        DiscardFECPacket(fec_packet_list_.front());
-        fec_packet_list_.pop_front();
-      }
+      if (seq_num_diff > 0x3fff)
+        DiscardFECPacket(fec_packet_list_.begin());
     }
 
     if (rx_packet->is_fec) {
@@ -654,8 +719,7 @@ bool ForwardErrorCorrection::InitRecovery(const FecPacket* fec_packet,
         << "Truncated FEC packet doesn't contain room for ULP header.";
     return false;
   }
-  recovered->pkt = new Packet;
-  memset(recovered->pkt->data, 0, IP_PACKET_SIZE);
+  recovered->pkt = packet_pool_->Get();
   recovered->returned = false;
   recovered->was_recovered = true;
   uint16_t protection_length =
@@ -720,8 +784,10 @@ void ForwardErrorCorrection::XorPackets(const Packet* src_packet,
 
   // XOR with RTP payload.
   // TODO(marpan/ajm): Are we doing more XORs than required here?
-  for (size_t i = kRtpHeaderSize; i < src_packet->length; ++i) {
-    dst_packet->pkt->data[i] ^= src_packet->data[i];
+  if (src_packet->length > kRtpHeaderSize) {
+    xor_bytes_(&dst_packet->pkt->data[kRtpHeaderSize],
+               &src_packet->data[kRtpHeaderSize],
+               src_packet->length - kRtpHeaderSize);
   }
 }
 
@@ -760,8 +826,7 @@ void ForwardErrorCorrection::AttemptRecover(
       packet_to_insert->pkt = NULL;
       if (!RecoverPacket(*fec_packet_list_it, packet_to_insert)) {
         // Can't recover using this packet, drop it.
-        DiscardFECPacket(*fec_packet_list_it);
-        fec_packet_list_it = fec_packet_list_.erase(fec_packet_list_it);
+        fec_packet_list_it = DiscardFECPacket(fec_packet_list_it);
         delete packet_to_insert;
         continue;
       }
@@ -775,8 +840,7 @@ void ForwardErrorCorrection::AttemptRecover(
       recovered_packet_list->sort(SortablePacket::LessThan);
       UpdateCoveringFECPackets(packet_to_insert);
       DiscardOldPackets(recovered_packet_list);
-      DiscardFECPacket(*fec_packet_list_it);
-      fec_packet_list_it = fec_packet_list_.erase(fec_packet_list_it);
+      DiscardFECPacket(fec_packet_list_it);
 
       // A packet has been recovered. We need to check the FEC list again, as
       // this may allow additional packets to be recovered.
@@ -785,8 +849,7 @@ void ForwardErrorCorrection::AttemptRecover(
     } else if (packets_missing == 0) {
       // Either all protected packets arrived or have been recovered. We can
       // discard this FEC packet.
-      DiscardFECPacket(*fec_packet_list_it);
-      fec_packet_list_it = fec_packet_list_.erase(fec_packet_list_it);
+      fec_packet_list_it = DiscardFECPacket(fec_packet_list_it);
     } else {
       fec_packet_list_it++;
     }
@@ -809,13 +872,16 @@ int ForwardErrorCorrection::NumCoveredPacketsMissing(
   return packets_missing;
 }
 
-void ForwardErrorCorrection::DiscardFECPacket(FecPacket* fec_packet) {
-  while (!fec_packet->protected_pkt_list.empty()) {
-    delete fec_packet->protected_pkt_list.front();
-    fec_packet->protected_pkt_list.pop_front();
-  }
-  assert(fec_packet->protected_pkt_list.empty());
-  delete fec_packet;
+ForwardErrorCorrection::FecPacketList::iterator
+ForwardErrorCorrection::DiscardFECPacket(FecPacketList::iterator it) {
+  FecPacket* fec_packet = *it;
+  // Drop the references to the packet data, but keep the storage.
+  for (ProtectedPacket* protected_packet : fec_packet->protected_pkt_list)
+    protected_packet->pkt = NULL;
+  fec_packet->protected_pkt_list.clear();
+  fec_packet->pkt = NULL;
+  free_fec_packets_.push_back(fec_packet);
+  return fec_packet_list_.erase(it);
 }
 
 void ForwardErrorCorrection::DiscardOldPackets(
@@ -16,6 +16,7 @@
 
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/fec_xor.h"
 #include "webrtc/system_wrappers/include/ref_count.h"
 #include "webrtc/typedefs.h"
 
@@ -33,27 +34,34 @@ class ForwardErrorCorrection {
   // Maximum number of media packets we can protect
   static const unsigned int kMaxMediaPackets = 48u;
 
+  // Recycles the storage of released packets; see NewPacket().
+  class PacketPool;
+
   // TODO(holmer): As a next step all these struct-like packet classes should be
   // refactored into proper classes, and their members should be made private.
   // This will require parts of the functionality in forward_error_correction.cc
   // and receiver_fec.cc to be refactored into the packet classes.
   class Packet {
    public:
-    Packet() : length(0), data(), ref_count_(0) {}
-    virtual ~Packet() {}
+    Packet();
+    virtual ~Packet();
 
     // Add a reference.
     virtual int32_t AddRef();
 
-    // Release a reference. Will delete the object if the reference count
-    // reaches zero.
+    // Release a reference. Will delete the object, or hand it back to the
+    // pool it came from, if the reference count reaches zero.
     virtual int32_t Release();
 
     size_t length;               // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
    private:
+    friend class PacketPool;
+
     int32_t ref_count_;  // Counts the number of references to a packet.
+    // The pool to return the packet to once released, if any.
+    rtc::scoped_refptr<PacketPool> pool_;
   };
 
   // TODO(holmer): Refactor into a proper class.
@@ -193,6 +201,11 @@ class ForwardErrorCorrection {
   int32_t DecodeFEC(ReceivedPacketList* received_packet_list,
                     RecoveredPacketList* recovered_packet_list);
 
+  // Returns a zeroed packet for use in the received packet list of
+  // DecodeFEC(). The storage of released packets is reused, so that decoding
+  // does no heap allocation in steady state.
+  rtc::scoped_refptr<Packet> NewPacket();
+
   // Get the number of FEC packets, given the number of media packets and the
   // protection factor.
   int GetNumberOfFecPackets(int num_media_packets, int protection_factor);
@@ -207,7 +220,7 @@ class ForwardErrorCorrection {
   void ResetState(RecoveredPacketList* recovered_packet_list);
 
  private:
-  typedef std::list<FecPacket*> FecPacketList;
+  typedef std::vector<FecPacket*> FecPacketList;
 
   void GenerateFecUlpHeaders(const PacketList& media_packet_list,
                              uint8_t* packet_mask, bool l_bit,
@@ -279,12 +292,11 @@ class ForwardErrorCorrection {
   void AttemptRecover(RecoveredPacketList* recovered_packet_list);
 
   // Initializes the packet recovery using the FEC packet.
-  static bool InitRecovery(const FecPacket* fec_packet,
-                           RecoveredPacket* recovered);
+  bool InitRecovery(const FecPacket* fec_packet, RecoveredPacket* recovered);
 
   // Performs XOR between |src_packet| and |dst_packet| and stores the result
   // in |dst_packet|.
-  static void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
+  void XorPackets(const Packet* src_packet, RecoveredPacket* dst_packet);
 
   // Finish up the recovery of a packet.
   static bool FinishRecovery(RecoveredPacket* recovered);
@@ -299,13 +311,19 @@ class ForwardErrorCorrection {
   // This function returns 2 when two or more packets are missing.
   static int NumCoveredPacketsMissing(const FecPacket* fec_packet);
 
-  static void DiscardFECPacket(FecPacket* fec_packet);
+  // Removes the FEC packet at |it| from |fec_packet_list_| and keeps it for
+  // reuse. Returns the iterator following it.
+  FecPacketList::iterator DiscardFECPacket(FecPacketList::iterator it);
   static void DiscardOldPackets(RecoveredPacketList* recovered_packet_list);
   static uint16_t ParseSequenceNumber(uint8_t* packet);
 
   std::vector<Packet> generated_fec_packets_;
   FecPacketList fec_packet_list_;
+  // Discarded FEC packets, kept for reuse by InsertFECPacket().
+  std::vector<FecPacket*> free_fec_packets_;
+  const rtc::scoped_refptr<PacketPool> packet_pool_;
   bool fec_packet_received_;
+  const internal::FecXorFunction xor_bytes_;
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_H_
@@ -9,13 +9,10 @@
  */
 #include "webrtc/modules/rtp_rtcp/source/h264_bitstream_parser.h"
 
-#include <vector>
+#include <string.h>
 
-#include "webrtc/base/bitbuffer.h"
-#include "webrtc/base/bytebuffer.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
-#include "webrtc/base/scoped_ptr.h"
 
 namespace webrtc {
 namespace {
@@ -35,54 +32,123 @@ static const uint8_t kSliceTypeP = 0x0;
 static const uint8_t kSliceTypeB = 0x1;
 static const uint8_t kSliceTypeSp = 0x3;
 
-// Returns a vector of the NALU start sequences (0 0 0 1) in the given buffer.
-std::vector<size_t> FindNaluStartSequences(const uint8_t* buffer,
-                                           size_t buffer_size) {
-  std::vector<size_t> sequences;
-  // This is sorta like Boyer-Moore, but with only the first optimization step:
-  // given a 4-byte sequence we're looking at, if the 4th byte isn't 1 or 0,
-  // skip ahead to the next 4-byte sequence. 0s and 1s are relatively rare, so
-  // this will skip the majority of reads/checks.
-  const uint8_t* end = buffer + buffer_size - 4;
-  for (const uint8_t* head = buffer; head < end;) {
-    if (head[3] > 1) {
-      head += 4;
-    } else if (head[3] == 1 && head[2] == 0 && head[1] == 0 && head[0] == 0) {
-      sequences.push_back(static_cast<size_t>(head - buffer));
-      head += 4;
-    } else {
-      head++;
+// Returns the offset of the first NALU start sequence (0 0 0 1) at or after
+// |offset| that is followed by at least one byte, or |buffer_size| if there is
+// none. memchr() is vectorized by the common C libraries, so looking for the
+// 1s with it and only then checking the bytes before them scans most of the
+// buffer in wide loads rather than byte by byte.
+size_t FindNaluStartSequence(const uint8_t* buffer,
+                             size_t buffer_size,
+                             size_t offset) {
+  for (size_t pos = offset + 3; pos + 1 < buffer_size; ++pos) {
+    const uint8_t* one = static_cast<const uint8_t*>(
+        memchr(buffer + pos, 1, buffer_size - 1 - pos));
+    if (!one)
+      break;
+    pos = static_cast<size_t>(one - buffer);
+    if (buffer[pos - 1] == 0 && buffer[pos - 2] == 0 && buffer[pos - 3] == 0)
+      return pos - 3;
+  }
+  return buffer_size;
+}
+
+// Reads the RBSP of a NALU, skipping emulation prevention bytes as it goes.
+// Only the part that is read is unescaped, so parsing the header of a slice
+// touches a few bytes instead of copying the whole slice, which can be tens of
+// kilobytes. The rbsp_trailing_bits() are left in the stream, since none of
+// the parsing reads all the way to the end of a RBSP.
+class RbspBitReader {
+ public:
+  RbspBitReader(const uint8_t* bytes, size_t length)
+      : bytes_(bytes),
+        length_(length),
+        byte_offset_(0),
+        bit_offset_(0),
+        zero_count_(0) {}
+
+  bool ReadUInt8(uint8_t* val) {
+    uint32_t bits;
+    if (!ReadBits(&bits, 8))
+      return false;
+    *val = static_cast<uint8_t>(bits);
+    return true;
+  }
+
+  bool ReadBits(uint32_t* val, size_t bit_count) {
+    RTC_DCHECK_LE(bit_count, 32u);
+    uint32_t bits = 0;
+    for (size_t i = 0; i < bit_count; ++i) {
+      uint32_t bit;
+      if (!ReadBit(&bit))
+        return false;
+      bits = (bits << 1) | bit;
     }
+    *val = bits;
+    return true;
   }
 
-  return sequences;
-}
-}  // namespace
+  bool ReadExponentialGolomb(uint32_t* val) {
+    // The value is coded as a number of leading 0 bits, a 1 bit and as many
+    // bits as there were 0s, and is what those last bits and the 1 spell, - 1.
+    size_t zero_bit_count = 0;
+    uint32_t bit;
+    if (!ReadBit(&bit))
+      return false;
+    while (bit == 0) {
+      if (++zero_bit_count > 31 || !ReadBit(&bit))
+        return false;
+    }
+    uint32_t suffix = 0;
+    if (zero_bit_count > 0 && !ReadBits(&suffix, zero_bit_count))
+      return false;
+    *val = ((1u << zero_bit_count) | suffix) - 1;
+    return true;
+  }
 
-// Parses RBSP from source bytes. Removes emulation bytes, but leaves the
-// rbsp_trailing_bits() in the stream, since none of the parsing reads all the
-// way to the end of a parsed RBSP sequence. When writing, that means the
-// rbsp_trailing_bits() should be preserved and don't need to be restored (i.e.
-// the rbsp_stop_one_bit, which is just a 1, then zero padded), and alignment
-// should "just work".
-// TODO(pbos): Make parsing RBSP something that can be integrated into BitBuffer
-// so we don't have to copy the entire frames when only interested in the
-// headers.
-rtc::ByteBuffer* ParseRbsp(const uint8_t* bytes, size_t length) {
-  // Copied from webrtc::H264SpsParser::Parse.
-  rtc::ByteBuffer* rbsp_buffer = new rtc::ByteBuffer;
-  for (size_t i = 0; i < length;) {
-    if (length - i >= 3 && bytes[i] == 0 && bytes[i + 1] == 0 &&
-        bytes[i + 2] == 3) {
-      rbsp_buffer->WriteBytes(reinterpret_cast<const char*>(bytes) + i, 2);
-      i += 3;
+  bool ReadSignedExponentialGolomb(int32_t* val) {
+    uint32_t unsigned_val;
+    if (!ReadExponentialGolomb(&unsigned_val))
+      return false;
+    if ((unsigned_val & 1) == 0) {
+      *val = -static_cast<int32_t>(unsigned_val / 2);
     } else {
-      rbsp_buffer->WriteBytes(reinterpret_cast<const char*>(bytes) + i, 1);
-      i++;
+      *val = (unsigned_val + 1) / 2;
     }
+    return true;
   }
-  return rbsp_buffer;
-}
+
+ private:
+  bool ReadBit(uint32_t* bit) {
+    if (byte_offset_ >= length_)
+      return false;
+    *bit = (bytes_[byte_offset_] >> (7 - bit_offset_)) & 1;
+    if (++bit_offset_ == 8) {
+      zero_count_ = bytes_[byte_offset_] == 0 ? zero_count_ + 1 : 0;
+      bit_offset_ = 0;
+      ++byte_offset_;
+      SkipEmulationPreventionByte();
+    }
+    return true;
+  }
+
+  // An emulation prevention byte (3) is inserted after every two 0s that
+  // would otherwise be followed by a byte <= 3.
+  void SkipEmulationPreventionByte() {
+    if (zero_count_ >= 2 && byte_offset_ < length_ &&
+        bytes_[byte_offset_] == 3) {
+      ++byte_offset_;
+      zero_count_ = 0;
+    }
+  }
+
+  const uint8_t* const bytes_;
+  const size_t length_;
+  size_t byte_offset_;
+  size_t bit_offset_;
+  // The number of 0 bytes right before |byte_offset_|.
+  int zero_count_;
+};
+}  // namespace
 
 #define RETURN_FALSE_ON_FAIL(x)       \
   if (!(x)) {                         \
@@ -101,12 +167,8 @@ bool H264BitstreamParser::ParseSpsNalu(const uint8_t* sps, size_t length) {
   // Reset SPS state.
   sps_ = SpsState();
   sps_parsed_ = false;
-  // Parse out the SPS RBSP. It should be small, so it's ok that we create a
-  // copy. We'll eventually write this back.
-  rtc::scoped_ptr<rtc::ByteBuffer> sps_rbsp(
-      ParseRbsp(sps + kNaluHeaderAndTypeSize, length - kNaluHeaderAndTypeSize));
-  rtc::BitBuffer sps_parser(reinterpret_cast<const uint8_t*>(sps_rbsp->Data()),
-                            sps_rbsp->Length());
+  RbspBitReader sps_parser(sps + kNaluHeaderAndTypeSize,
+                           length - kNaluHeaderAndTypeSize);
 
   uint8_t byte_tmp;
   uint32_t golomb_tmp;
@@ -209,10 +271,8 @@ bool H264BitstreamParser::ParsePpsNalu(const uint8_t* pps, size_t length) {
   // We're starting a new stream, so reset picture type rewriting values.
   pps_ = PpsState();
   pps_parsed_ = false;
-  rtc::scoped_ptr<rtc::ByteBuffer> buffer(
-      ParseRbsp(pps + kNaluHeaderAndTypeSize, length - kNaluHeaderAndTypeSize));
-  rtc::BitBuffer parser(reinterpret_cast<const uint8_t*>(buffer->Data()),
-                        buffer->Length());
+  RbspBitReader parser(pps + kNaluHeaderAndTypeSize,
+                       length - kNaluHeaderAndTypeSize);
 
   uint32_t bits_tmp;
   uint32_t golomb_ignored;
@@ -317,11 +377,8 @@ bool H264BitstreamParser::ParseNonParameterSetNalu(const uint8_t* source,
   RTC_CHECK(sps_parsed_);
   RTC_CHECK(pps_parsed_);
   last_slice_qp_delta_parsed_ = false;
-  rtc::scoped_ptr<rtc::ByteBuffer> slice_rbsp(ParseRbsp(
-      source + kNaluHeaderAndTypeSize, source_length - kNaluHeaderAndTypeSize));
-  rtc::BitBuffer slice_reader(
-      reinterpret_cast<const uint8_t*>(slice_rbsp->Data()),
-      slice_rbsp->Length());
+  RbspBitReader slice_reader(source + kNaluHeaderAndTypeSize,
+                             source_length - kNaluHeaderAndTypeSize);
   // Check to see if this is an IDR slice, which has an extra field to parse
   // out.
   bool is_idr = (source[kNaluHeaderSize] & 0x0F) == kNaluIdr;
@@ -545,14 +602,14 @@ void H264BitstreamParser::ParseSlice(const uint8_t* slice, size_t length) {
 void H264BitstreamParser::ParseBitstream(const uint8_t* bitstream,
                                          size_t length) {
   RTC_CHECK_GE(length, 4u);
-  std::vector<size_t> slice_markers = FindNaluStartSequences(bitstream, length);
-  RTC_CHECK(!slice_markers.empty());
-  for (size_t i = 0; i < slice_markers.size() - 1; ++i) {
-    ParseSlice(bitstream + slice_markers[i],
-               slice_markers[i + 1] - slice_markers[i]);
+  size_t slice_start = FindNaluStartSequence(bitstream, length, 0);
+  RTC_CHECK_LT(slice_start, length);
+  while (slice_start < length) {
+    size_t next_slice_start =
+        FindNaluStartSequence(bitstream, length, slice_start + kNaluHeaderSize);
+    ParseSlice(bitstream + slice_start, next_slice_start - slice_start);
+    slice_start = next_slice_start;
   }
-  // Parse the last slice.
-  ParseSlice(bitstream + slice_markers.back(), length - slice_markers.back());
 }
 
 bool H264BitstreamParser::GetLastSliceQp(int* qp) const {
@@ -32,6 +32,14 @@ uint8_t kH264BitstreamNextImageSliceChunk[] = {
     0x00, 0x00, 0x00, 0x01, 0x41, 0xe2, 0x01, 0x16, 0x0e, 0x3e, 0x2b, 0x86,
 };
 
+// The IDR slice of kH264BitstreamChunk, with a first_mb_in_slice large enough
+// that the slice header has to contain emulation prevention bytes.
+uint8_t kH264EscapedImageSliceChunk[] = {
+    0x00, 0x00, 0x00, 0x01, 0x65, 0x00, 0x00, 0x03, 0x02, 0x00, 0x00,
+    0x03, 0x03, 0x84, 0x0f, 0x08, 0xc0, 0x3f, 0x27, 0x56, 0x7a, 0xd4,
+    0x16, 0x42, 0x40, 0xea, 0x0b, 0x21, 0x21, 0xef,
+};
+
 TEST(H264BitstreamParserTest, ReportsNoQpWithoutParsedSlices) {
   H264BitstreamParser h264_parser;
   int qp;
@@ -59,4 +67,14 @@ TEST(H264BitstreamParserTest, ReportsLastSliceQpForImageSlices) {
   EXPECT_EQ(37, qp);
 }
 
+TEST(H264BitstreamParserTest, SkipsEmulationPreventionBytes) {
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(kH264SpsPps, sizeof(kH264SpsPps));
+  h264_parser.ParseBitstream(kH264EscapedImageSliceChunk,
+                             sizeof(kH264EscapedImageSliceChunk));
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(35, qp);
+}
+
 }  // namespace webrtc
@@ -16,6 +16,7 @@
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/modules/rtp_rtcp/source/time_util.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/include/rw_lock_wrapper.h"
 
 namespace webrtc {
 
@@ -29,7 +30,8 @@ StreamStatisticianImpl::StreamStatisticianImpl(
     RtcpStatisticsCallback* rtcp_callback,
     StreamDataCountersCallback* rtp_callback)
     : clock_(clock),
-      stream_lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      stream_lock_(CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+          "StreamStatisticianImpl::stream_lock_")),
       incoming_bitrate_(clock, NULL),
       ssrc_(0),
       max_reordering_threshold_(kDefaultMaxReorderingThreshold),
@@ -52,14 +54,23 @@ StreamStatisticianImpl::StreamStatisticianImpl(
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  UpdateCounters(header, packet_length, retransmitted);
-  NotifyRtpCallback();
+  // Update and snapshot the counters under a single acquisition of the lock;
+  // the callback is made without it.
+  StreamDataCounters data;
+  uint32_t ssrc;
+  {
+    CriticalSectionScoped cs(stream_lock_.get());
+    UpdateCounters(header, packet_length, retransmitted);
+    data = receive_counters_;
+    ssrc = ssrc_;
+  }
+  rtp_callback_->DataCountersUpdated(data, ssrc);
 }
 
 void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  CriticalSectionScoped cs(stream_lock_.get());
+  int64_t now_ms = clock_->TimeInMilliseconds();
   bool in_order = InOrderPacketInternal(header.sequenceNumber);
   ssrc_ = header.ssrc;
   incoming_bitrate_.Update(packet_length);
@@ -70,7 +81,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
 
   if (receive_counters_.transmitted.packets == 1) {
     received_seq_first_ = header.sequenceNumber;
-    receive_counters_.first_packet_time_ms = clock_->TimeInMilliseconds();
+    receive_counters_.first_packet_time_ms = now_ms;
   }
 
   // Count only the new packets received. That is, if packets 1, 2, 3, 5, 4, 6
@@ -97,7 +108,7 @@ void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
     }
     last_received_timestamp_ = header.timestamp;
     last_receive_time_ntp_ = receive_time;
-    last_receive_time_ms_ = clock_->TimeInMilliseconds();
+    last_receive_time_ms_ = now_ms;
   }
 
   size_t packet_oh = header.headerLength + header.paddingLength;
@@ -146,17 +157,6 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   }
 }
 
-void StreamStatisticianImpl::NotifyRtpCallback() {
-  StreamDataCounters data;
-  uint32_t ssrc;
-  {
-    CriticalSectionScoped cs(stream_lock_.get());
-    data = receive_counters_;
-    ssrc = ssrc_;
-  }
-  rtp_callback_->DataCountersUpdated(data, ssrc);
-}
-
 void StreamStatisticianImpl::NotifyRtcpCallback() {
   RtcpStatistics data;
   uint32_t ssrc;
@@ -170,11 +170,15 @@ void StreamStatisticianImpl::NotifyRtcpCallback() {
 
 void StreamStatisticianImpl::FecPacketReceived(const RTPHeader& header,
                                                size_t packet_length) {
+  StreamDataCounters data;
+  uint32_t ssrc;
   {
     CriticalSectionScoped cs(stream_lock_.get());
     receive_counters_.fec.AddPacket(packet_length, header);
+    data = receive_counters_;
+    ssrc = ssrc_;
   }
-  NotifyRtpCallback();
+  rtp_callback_->DataCountersUpdated(data, ssrc);
 }
 
 void StreamStatisticianImpl::SetMaxReorderingThreshold(
@@ -377,7 +381,10 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
 
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
-      receive_statistics_lock_(CriticalSectionWrapper::CreateCriticalSection()),
+      receive_statistics_lock_(
+          CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+              "ReceiveStatisticsImpl::receive_statistics_lock_")),
+      statisticians_lock_(RWLockWrapper::CreateRWLock()),
       last_rate_update_ms_(0),
       rtcp_stats_callback_(NULL),
       rtp_stats_callback_(NULL) {}
@@ -392,9 +399,13 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
-  {
-    CriticalSectionScoped cs(receive_statistics_lock_.get());
+  // StreamStatisticianImpl instance is created once and only destroyed when
+  // this whole ReceiveStatisticsImpl is destroyed, so the common case of a
+  // known SSRC only needs a shared lock on the map. StreamStatisticianImpl has
+  // it's own locking so don't hold statisticians_lock_ (potential deadlock).
+  StreamStatisticianImpl* impl = FindStatistician(header.ssrc);
+  if (!impl) {
+    WriteLockScoped lock(*statisticians_lock_);
     StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
     if (it != statisticians_.end()) {
       impl = it->second;
@@ -403,25 +414,28 @@ void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
       statisticians_[header.ssrc] = impl;
     }
   }
-  // StreamStatisticianImpl instance is created once and only destroyed when
-  // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
-  // it's own locking so don't hold receive_statistics_lock_ (potential
-  // deadlock).
   impl->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  StatisticianImplMap::iterator it = statisticians_.find(header.ssrc);
+  StreamStatisticianImpl* impl = FindStatistician(header.ssrc);
   // Ignore FEC if it is the first packet.
-  if (it != statisticians_.end()) {
-    it->second->FecPacketReceived(header, packet_length);
-  }
+  if (impl)
+    impl->FecPacketReceived(header, packet_length);
+}
+
+StreamStatisticianImpl* ReceiveStatisticsImpl::FindStatistician(
+    uint32_t ssrc) const {
+  ReadLockScoped lock(*statisticians_lock_);
+  StatisticianImplMap::const_iterator it = statisticians_.find(ssrc);
+  if (it == statisticians_.end())
+    return nullptr;
+  return it->second;
 }
 
 StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped lock(*statisticians_lock_);
   StatisticianMap active_statisticians;
   for (StatisticianImplMap::const_iterator it = statisticians_.begin();
        it != statisticians_.end(); ++it) {
@@ -438,16 +452,12 @@ StatisticianMap ReceiveStatisticsImpl::GetActiveStatisticians() const {
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
     uint32_t ssrc) const {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  StatisticianImplMap::const_iterator it = statisticians_.find(ssrc);
-  if (it == statisticians_.end())
-    return NULL;
-  return it->second;
+  return FindStatistician(ssrc);
 }
 
 void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
     int max_reordering_threshold) {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
+  ReadLockScoped lock(*statisticians_lock_);
   for (StatisticianImplMap::iterator it = statisticians_.begin();
        it != statisticians_.end(); ++it) {
     it->second->SetMaxReorderingThreshold(max_reordering_threshold);
@@ -455,11 +465,14 @@ void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
 }
 
 int32_t ReceiveStatisticsImpl::Process() {
-  CriticalSectionScoped cs(receive_statistics_lock_.get());
-  for (StatisticianImplMap::iterator it = statisticians_.begin();
-       it != statisticians_.end(); ++it) {
-    it->second->ProcessBitrate();
+  {
+    ReadLockScoped lock(*statisticians_lock_);
+    for (StatisticianImplMap::iterator it = statisticians_.begin();
+         it != statisticians_.end(); ++it) {
+      it->second->ProcessBitrate();
+    }
   }
+  CriticalSectionScoped cs(receive_statistics_lock_.get());
   last_rate_update_ms_ = clock_->TimeInMilliseconds();
   return 0;
 }
@@ -20,6 +20,7 @@
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/ntp_time.h"
+#include "webrtc/system_wrappers/include/rw_lock_wrapper.h"
 
 namespace webrtc {
 
@@ -56,8 +57,8 @@ class StreamStatisticianImpl : public StreamStatistician {
   void UpdateJitter(const RTPHeader& header, NtpTime receive_time);
   void UpdateCounters(const RTPHeader& rtp_header,
                       size_t packet_length,
-                      bool retransmitted);
-  void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_.get());
+                      bool retransmitted)
+      EXCLUSIVE_LOCKS_REQUIRED(stream_lock_.get());
   void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_.get());
 
   Clock* clock_;
@@ -128,12 +129,19 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   void DataCountersUpdated(const StreamDataCounters& counters,
                            uint32_t ssrc) override;
 
+  StreamStatisticianImpl* FindStatistician(uint32_t ssrc) const;
+
   typedef std::map<uint32_t, StreamStatisticianImpl*> StatisticianImplMap;
 
   Clock* clock_;
+  // Guards the callbacks and the process timer.
   rtc::scoped_ptr<CriticalSectionWrapper> receive_statistics_lock_;
+  // Statisticians are only ever added, so readers, including the per-packet
+  // lookup, share this lock and only the first packet of a new SSRC takes it
+  // exclusively.
+  rtc::scoped_ptr<RWLockWrapper> statisticians_lock_;
   int64_t last_rate_update_ms_;
-  StatisticianImplMap statisticians_;
+  StatisticianImplMap statisticians_ GUARDED_BY(statisticians_lock_.get());
 
   RtcpStatisticsCallback* rtcp_stats_callback_;
   StreamDataCountersCallback* rtp_stats_callback_;
@@ -96,6 +96,28 @@ TEST_F(ReceiveStatisticsTest, TwoIncomingSsrcs) {
   EXPECT_EQ(3u, packets_received);
 }
 
+TEST_F(ReceiveStatisticsTest, StatisticianIsCreatedOncePerSsrc) {
+  EXPECT_TRUE(receive_statistics_->GetStatistician(kSsrc1) == NULL);
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  StreamStatistician* statistician =
+      receive_statistics_->GetStatistician(kSsrc1);
+  ASSERT_TRUE(statistician != NULL);
+
+  for (int i = 0; i < 10; ++i) {
+    ++header1_.sequenceNumber;
+    receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+    receive_statistics_->IncomingPacket(header2_, kPacketSize2, false);
+    ++header2_.sequenceNumber;
+  }
+  EXPECT_EQ(statistician, receive_statistics_->GetStatistician(kSsrc1));
+  uint32_t packets_received = 0;
+  statistician->GetDataCounters(NULL, &packets_received);
+  EXPECT_EQ(11u, packets_received);
+  receive_statistics_->GetStatistician(kSsrc2)->GetDataCounters(
+      NULL, &packets_received);
+  EXPECT_EQ(10u, packets_received);
+}
+
 TEST_F(ReceiveStatisticsTest, ActiveStatisticians) {
   receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
   ++header1_.sequenceNumber;
@@ -0,0 +1,248 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/packet_view.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+using webrtc::RTCPUtility::PT_PSFB;
+using webrtc::RTCPUtility::PT_RR;
+using webrtc::RTCPUtility::PT_RTPFB;
+using webrtc::RTCPUtility::PT_SR;
+using webrtc::RTCPUtility::RtcpCommonHeader;
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+// Sender SSRC.
+const size_t kRrBaseLength = 4;
+// Sender SSRC and sender info.
+const size_t kSrBaseLength = 24;
+// Sender SSRC and media source SSRC.
+const size_t kFeedbackBaseLength = 8;
+const size_t kNackItemLength = 4;
+// Feedback base, "REMB", number of SSRCs, exponent and mantissa.
+const size_t kRembBaseLength = 16;
+// Feedback base, base sequence number, packet status count, reference time
+// and feedback packet count.
+const size_t kTransportFeedbackBaseLength = 16;
+
+const uint8_t kNackFormat = 1;
+const uint8_t kTransportFeedbackFormat = 15;
+const uint8_t kAfbFormat = 15;
+const uint32_t kRembIdentifier = 0x52454D42;  // 'R' 'E' 'M' 'B'.
+}  // namespace
+
+bool CompoundPacketView::Next(BlockView* block) {
+  RTC_DCHECK(block);
+  if (next_ >= end_)
+    return false;
+  if (!RTCPUtility::RtcpParseCommonHeader(next_, end_ - next_,
+                                          &block->header)) {
+    next_ = end_;
+    return false;
+  }
+  block->data = next_;
+  block->payload = next_ + RtcpCommonHeader::kHeaderSizeBytes;
+  next_ += block->header.BlockSize();
+  return true;
+}
+
+uint32_t ReportBlockView::source_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[0]);
+}
+
+uint8_t ReportBlockView::fraction_lost() const {
+  return buffer_[4];
+}
+
+uint32_t ReportBlockView::cumulative_lost() const {
+  return ByteReader<uint32_t, 3>::ReadBigEndian(&buffer_[5]);
+}
+
+uint32_t ReportBlockView::extended_high_seq_num() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[8]);
+}
+
+uint32_t ReportBlockView::jitter() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[12]);
+}
+
+uint32_t ReportBlockView::last_sr() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[16]);
+}
+
+uint32_t ReportBlockView::delay_since_last_sr() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&buffer_[20]);
+}
+
+bool ReportView::Parse(const BlockView& block) {
+  const RtcpCommonHeader& header = block.header;
+  if (header.packet_type != PT_SR && header.packet_type != PT_RR)
+    return false;
+  has_sender_info_ = header.packet_type == PT_SR;
+  const size_t base_length = has_sender_info_ ? kSrBaseLength : kRrBaseLength;
+  num_blocks_ = header.count_or_format;
+  if (header.payload_size_bytes <
+      base_length + num_blocks_ * ReportBlockView::kLength) {
+    LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+  payload_ = block.payload;
+  return true;
+}
+
+uint32_t ReportView::sender_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[0]);
+}
+
+uint32_t ReportView::ntp_seconds() const {
+  RTC_DCHECK(has_sender_info_);
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[4]);
+}
+
+uint32_t ReportView::ntp_fraction() const {
+  RTC_DCHECK(has_sender_info_);
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[8]);
+}
+
+uint32_t ReportView::rtp_timestamp() const {
+  RTC_DCHECK(has_sender_info_);
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[12]);
+}
+
+uint32_t ReportView::sender_packet_count() const {
+  RTC_DCHECK(has_sender_info_);
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[16]);
+}
+
+uint32_t ReportView::sender_octet_count() const {
+  RTC_DCHECK(has_sender_info_);
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[20]);
+}
+
+ReportBlockView ReportView::report_block(size_t index) const {
+  RTC_DCHECK_LT(index, num_blocks_);
+  const size_t base_length = has_sender_info_ ? kSrBaseLength : kRrBaseLength;
+  return ReportBlockView(payload_ + base_length +
+                         index * ReportBlockView::kLength);
+}
+
+bool NackView::Parse(const BlockView& block) {
+  const RtcpCommonHeader& header = block.header;
+  if (header.packet_type != PT_RTPFB || header.count_or_format != kNackFormat)
+    return false;
+  if (header.payload_size_bytes < kFeedbackBaseLength + kNackItemLength) {
+    LOG(LS_WARNING) << "Payload length " << header.payload_size_bytes
+                    << " is too small for a Nack.";
+    return false;
+  }
+  num_items_ =
+      (header.payload_size_bytes - kFeedbackBaseLength) / kNackItemLength;
+  payload_ = block.payload;
+  return true;
+}
+
+uint32_t NackView::sender_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[0]);
+}
+
+uint32_t NackView::media_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[4]);
+}
+
+uint16_t NackView::packet_id(size_t index) const {
+  RTC_DCHECK_LT(index, num_items_);
+  return ByteReader<uint16_t>::ReadBigEndian(
+      &payload_[kFeedbackBaseLength + index * kNackItemLength]);
+}
+
+uint16_t NackView::bitmask(size_t index) const {
+  RTC_DCHECK_LT(index, num_items_);
+  return ByteReader<uint16_t>::ReadBigEndian(
+      &payload_[kFeedbackBaseLength + index * kNackItemLength + 2]);
+}
+
+bool RembView::Parse(const BlockView& block) {
+  const RtcpCommonHeader& header = block.header;
+  if (header.packet_type != PT_PSFB || header.count_or_format != kAfbFormat)
+    return false;
+  if (header.payload_size_bytes < kRembBaseLength)
+    return false;
+  const uint8_t* payload = block.payload;
+  if (ByteReader<uint32_t>::ReadBigEndian(&payload[8]) != kRembIdentifier)
+    return false;
+  num_ssrcs_ = payload[12];
+  if (header.payload_size_bytes < kRembBaseLength + num_ssrcs_ * 4) {
+    LOG(LS_WARNING) << "Payload size " << header.payload_size_bytes
+                    << " is too small for " << num_ssrcs_ << " SSRCs.";
+    return false;
+  }
+  const uint8_t exponent = payload[13] >> 2;
+  const uint32_t mantissa =
+      ByteReader<uint32_t, 3>::ReadBigEndian(&payload[13]) & 0x3ffff;
+  bitrate_bps_ = static_cast<uint64_t>(mantissa) << exponent;
+  payload_ = payload;
+  return true;
+}
+
+uint32_t RembView::sender_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[0]);
+}
+
+uint32_t RembView::ssrc(size_t index) const {
+  RTC_DCHECK_LT(index, num_ssrcs_);
+  return ByteReader<uint32_t>::ReadBigEndian(
+      &payload_[kRembBaseLength + index * 4]);
+}
+
+bool TransportFeedbackView::Parse(const BlockView& block) {
+  const RtcpCommonHeader& header = block.header;
+  if (header.packet_type != PT_RTPFB ||
+      header.count_or_format != kTransportFeedbackFormat) {
+    return false;
+  }
+  if (header.payload_size_bytes < kTransportFeedbackBaseLength) {
+    LOG(LS_WARNING) << "Payload length " << header.payload_size_bytes
+                    << " is too small for transport feedback.";
+    return false;
+  }
+  payload_ = block.payload;
+  return true;
+}
+
+uint32_t TransportFeedbackView::sender_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[0]);
+}
+
+uint32_t TransportFeedbackView::media_ssrc() const {
+  return ByteReader<uint32_t>::ReadBigEndian(&payload_[4]);
+}
+
+uint16_t TransportFeedbackView::base_sequence() const {
+  return ByteReader<uint16_t>::ReadBigEndian(&payload_[8]);
+}
+
+uint16_t TransportFeedbackView::packet_status_count() const {
+  return ByteReader<uint16_t>::ReadBigEndian(&payload_[10]);
+}
+
+int32_t TransportFeedbackView::reference_time() const {
+  return ByteReader<int32_t, 3>::ReadBigEndian(&payload_[12]);
+}
+
+uint8_t TransportFeedbackView::feedback_sequence() const {
+  return payload_[15];
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
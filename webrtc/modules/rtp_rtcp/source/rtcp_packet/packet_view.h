@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VIEW_H_
+#define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VIEW_H_
+
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
+
+namespace webrtc {
+namespace rtcp {
+
+// Read-only views over RTCP packets in a received buffer. Unlike the packet
+// classes and RTCPParserV2 these copy nothing out of the buffer, so the buffer
+// must outlive the views. Fields are decoded on access.
+
+// A single RTCP packet within a compound packet.
+struct BlockView {
+  BlockView() : data(nullptr), payload(nullptr) {}
+
+  // Start of the packet, i.e. of its common header.
+  const uint8_t* data;
+  // Payload after the common header, |header.payload_size_bytes| long.
+  const uint8_t* payload;
+  RTCPUtility::RtcpCommonHeader header;
+};
+
+// Walks the packets of a compound RTCP packet.
+class CompoundPacketView {
+ public:
+  CompoundPacketView(const uint8_t* buffer, size_t length)
+      : next_(buffer), end_(buffer + length) {}
+
+  // Returns false when there are no more packets, or the next one is
+  // malformed, in which case the rest of the buffer is ignored.
+  bool Next(BlockView* block);
+
+ private:
+  const uint8_t* next_;
+  const uint8_t* const end_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CompoundPacketView);
+};
+
+class ReportBlockView {
+ public:
+  static const size_t kLength = 24;
+
+  explicit ReportBlockView(const uint8_t* buffer) : buffer_(buffer) {}
+
+  uint32_t source_ssrc() const;
+  uint8_t fraction_lost() const;
+  uint32_t cumulative_lost() const;
+  uint32_t extended_high_seq_num() const;
+  uint32_t jitter() const;
+  uint32_t last_sr() const;
+  uint32_t delay_since_last_sr() const;
+
+ private:
+  const uint8_t* buffer_;
+};
+
+// Sender report or receiver report.
+class ReportView {
+ public:
+  ReportView() : payload_(nullptr), has_sender_info_(false), num_blocks_(0) {}
+
+  bool Parse(const BlockView& block);
+
+  uint32_t sender_ssrc() const;
+  bool has_sender_info() const { return has_sender_info_; }
+  // Sender info, only valid if has_sender_info().
+  uint32_t ntp_seconds() const;
+  uint32_t ntp_fraction() const;
+  uint32_t rtp_timestamp() const;
+  uint32_t sender_packet_count() const;
+  uint32_t sender_octet_count() const;
+
+  size_t num_report_blocks() const { return num_blocks_; }
+  ReportBlockView report_block(size_t index) const;
+
+ private:
+  const uint8_t* payload_;
+  bool has_sender_info_;
+  size_t num_blocks_;
+};
+
+// Generic NACK (RFC 4585).
+class NackView {
+ public:
+  NackView() : payload_(nullptr), num_items_(0) {}
+
+  bool Parse(const BlockView& block);
+
+  uint32_t sender_ssrc() const;
+  uint32_t media_ssrc() const;
+
+  // Each item is a packet id and a bitmask of the 16 following ids.
+  size_t num_items() const { return num_items_; }
+  uint16_t packet_id(size_t index) const;
+  uint16_t bitmask(size_t index) const;
+
+ private:
+  const uint8_t* payload_;
+  size_t num_items_;
+};
+
+// Receiver estimated max bitrate (draft-alvestrand-rmcat-remb).
+class RembView {
+ public:
+  RembView() : payload_(nullptr), num_ssrcs_(0), bitrate_bps_(0) {}
+
+  bool Parse(const BlockView& block);
+
+  uint32_t sender_ssrc() const;
+  uint64_t bitrate_bps() const { return bitrate_bps_; }
+  size_t num_ssrcs() const { return num_ssrcs_; }
+  uint32_t ssrc(size_t index) const;
+
+ private:
+  const uint8_t* payload_;
+  size_t num_ssrcs_;
+  uint64_t bitrate_bps_;
+};
+
+// Transport-wide feedback (draft-holmer-rmcat-transport-wide-cc-extensions).
+// Only the fixed fields are exposed; the packet status chunks and deltas are
+// left to TransportFeedback::ParseFrom(), which should only be called for
+// feedback that is actually going to be used.
+class TransportFeedbackView {
+ public:
+  TransportFeedbackView() : payload_(nullptr) {}
+
+  bool Parse(const BlockView& block);
+
+  uint32_t sender_ssrc() const;
+  uint32_t media_ssrc() const;
+  uint16_t base_sequence() const;
+  uint16_t packet_status_count() const;
+  // In multiples of 64 ms.
+  int32_t reference_time() const;
+  uint8_t feedback_sequence() const;
+
+ private:
+  const uint8_t* payload_;
+};
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_PACKET_VIEW_H_
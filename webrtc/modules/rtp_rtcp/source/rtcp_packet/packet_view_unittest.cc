@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/packet_view.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+
+using webrtc::rtcp::BlockView;
+using webrtc::rtcp::CompoundPacketView;
+using webrtc::rtcp::Nack;
+using webrtc::rtcp::NackView;
+using webrtc::rtcp::RawPacket;
+using webrtc::rtcp::ReceiverReport;
+using webrtc::rtcp::Remb;
+using webrtc::rtcp::RembView;
+using webrtc::rtcp::ReportBlock;
+using webrtc::rtcp::ReportBlockView;
+using webrtc::rtcp::ReportView;
+using webrtc::rtcp::SenderReport;
+using webrtc::rtcp::TransportFeedback;
+using webrtc::rtcp::TransportFeedbackView;
+
+namespace webrtc {
+namespace {
+const uint32_t kSenderSsrc = 0x12345678;
+const uint32_t kRemoteSsrc = 0x23456789;
+}  // namespace
+
+TEST(RtcpPacketViewTest, WalksCompoundPacket) {
+  ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  Remb remb;
+  remb.From(kSenderSsrc);
+  remb.AppliesTo(kRemoteSsrc);
+  remb.WithBitrateBps(500000);
+  rr.Append(&remb);
+  rtc::scoped_ptr<RawPacket> packet = rr.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  EXPECT_EQ(packet->Buffer(), block.data);
+  ReportView report;
+  EXPECT_TRUE(report.Parse(block));
+  RembView remb_view;
+  EXPECT_FALSE(remb_view.Parse(block));
+
+  ASSERT_TRUE(compound.Next(&block));
+  EXPECT_TRUE(remb_view.Parse(block));
+  EXPECT_EQ(packet->Buffer() + packet->Length(),
+            block.data + block.header.BlockSize());
+  EXPECT_FALSE(compound.Next(&block));
+}
+
+TEST(RtcpPacketViewTest, StopsAtTruncatedPacket) {
+  ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  rtc::scoped_ptr<RawPacket> packet = rr.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length() - 1);
+  BlockView block;
+  EXPECT_FALSE(compound.Next(&block));
+}
+
+TEST(RtcpPacketViewTest, SenderReport) {
+  ReportBlock rb;
+  rb.To(kRemoteSsrc);
+  rb.WithFractionLost(55);
+  rb.WithCumulativeLost(0x111213);
+  rb.WithExtHighestSeqNum(0x22232425);
+  rb.WithJitter(0x33343536);
+  rb.WithLastSr(0x44454647);
+  rb.WithDelayLastSr(0x55565758);
+  SenderReport sr;
+  sr.From(kSenderSsrc);
+  sr.WithNtpSec(0x11111111);
+  sr.WithNtpFrac(0x22222222);
+  sr.WithRtpTimestamp(0x33333333);
+  sr.WithPacketCount(0x44444444);
+  sr.WithOctetCount(0x55555555);
+  EXPECT_TRUE(sr.WithReportBlock(rb));
+  rtc::scoped_ptr<RawPacket> packet = sr.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  ReportView report;
+  ASSERT_TRUE(report.Parse(block));
+  EXPECT_TRUE(report.has_sender_info());
+  EXPECT_EQ(kSenderSsrc, report.sender_ssrc());
+  EXPECT_EQ(0x11111111u, report.ntp_seconds());
+  EXPECT_EQ(0x22222222u, report.ntp_fraction());
+  EXPECT_EQ(0x33333333u, report.rtp_timestamp());
+  EXPECT_EQ(0x44444444u, report.sender_packet_count());
+  EXPECT_EQ(0x55555555u, report.sender_octet_count());
+  ASSERT_EQ(1u, report.num_report_blocks());
+  ReportBlockView block_view = report.report_block(0);
+  EXPECT_EQ(kRemoteSsrc, block_view.source_ssrc());
+  EXPECT_EQ(55, block_view.fraction_lost());
+  EXPECT_EQ(0x111213u, block_view.cumulative_lost());
+  EXPECT_EQ(0x22232425u, block_view.extended_high_seq_num());
+  EXPECT_EQ(0x33343536u, block_view.jitter());
+  EXPECT_EQ(0x44454647u, block_view.last_sr());
+  EXPECT_EQ(0x55565758u, block_view.delay_since_last_sr());
+}
+
+TEST(RtcpPacketViewTest, ReceiverReportWithoutSenderInfo) {
+  ReportBlock rb;
+  rb.To(kRemoteSsrc);
+  ReceiverReport rr;
+  rr.From(kSenderSsrc);
+  EXPECT_TRUE(rr.WithReportBlock(rb));
+  EXPECT_TRUE(rr.WithReportBlock(rb));
+  rtc::scoped_ptr<RawPacket> packet = rr.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  ReportView report;
+  ASSERT_TRUE(report.Parse(block));
+  EXPECT_FALSE(report.has_sender_info());
+  EXPECT_EQ(kSenderSsrc, report.sender_ssrc());
+  ASSERT_EQ(2u, report.num_report_blocks());
+  EXPECT_EQ(kRemoteSsrc, report.report_block(1).source_ssrc());
+}
+
+TEST(RtcpPacketViewTest, Nack) {
+  const uint16_t kList[] = {0, 1, 3, 8, 16, 100};
+  Nack nack;
+  nack.From(kSenderSsrc);
+  nack.To(kRemoteSsrc);
+  nack.WithList(kList, sizeof(kList) / sizeof(kList[0]));
+  rtc::scoped_ptr<RawPacket> packet = nack.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  NackView view;
+  ASSERT_TRUE(view.Parse(block));
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(kRemoteSsrc, view.media_ssrc());
+  ASSERT_EQ(2u, view.num_items());
+  EXPECT_EQ(0, view.packet_id(0));
+  EXPECT_EQ((1 << 0) | (1 << 2) | (1 << 7) | (1 << 15), view.bitmask(0));
+  EXPECT_EQ(100, view.packet_id(1));
+  EXPECT_EQ(0, view.bitmask(1));
+}
+
+TEST(RtcpPacketViewTest, Remb) {
+  Remb remb;
+  remb.From(kSenderSsrc);
+  remb.AppliesTo(kRemoteSsrc);
+  remb.AppliesTo(kRemoteSsrc + 1);
+  remb.WithBitrateBps(0x3ffff << 2);
+  rtc::scoped_ptr<RawPacket> packet = remb.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  RembView view;
+  ASSERT_TRUE(view.Parse(block));
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(static_cast<uint64_t>(0x3ffff << 2), view.bitrate_bps());
+  ASSERT_EQ(2u, view.num_ssrcs());
+  EXPECT_EQ(kRemoteSsrc, view.ssrc(0));
+  EXPECT_EQ(kRemoteSsrc + 1, view.ssrc(1));
+}
+
+TEST(RtcpPacketViewTest, TransportFeedback) {
+  TransportFeedback feedback;
+  feedback.WithPacketSenderSsrc(kSenderSsrc);
+  feedback.WithMediaSourceSsrc(kRemoteSsrc);
+  feedback.WithBase(1000, 64 * 1000 * 3);
+  feedback.WithFeedbackSequenceNumber(7);
+  EXPECT_TRUE(feedback.WithReceivedPacket(1000, 64 * 1000 * 3));
+  EXPECT_TRUE(feedback.WithReceivedPacket(1002, 64 * 1000 * 3 + 1000));
+  rtc::scoped_ptr<RawPacket> packet = feedback.Build();
+
+  CompoundPacketView compound(packet->Buffer(), packet->Length());
+  BlockView block;
+  ASSERT_TRUE(compound.Next(&block));
+  NackView nack;
+  EXPECT_FALSE(nack.Parse(block));
+  TransportFeedbackView view;
+  ASSERT_TRUE(view.Parse(block));
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(kRemoteSsrc, view.media_ssrc());
+  EXPECT_EQ(1000, view.base_sequence());
+  EXPECT_EQ(3, view.packet_status_count());
+  EXPECT_EQ(3, view.reference_time());
+  EXPECT_EQ(7, view.feedback_sequence());
+}
+
+}  // namespace webrtc
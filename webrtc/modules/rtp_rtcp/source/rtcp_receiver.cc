@@ -18,6 +18,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/trace_event.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/packet_view.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_impl.h"
@@ -36,6 +37,32 @@ const int kRrTimeoutIntervals = 3;
 
 const int64_t kMaxWarningLogIntervalMs = 10000;
 
+// Number of report block slots allocated up front, enough for a module with a
+// handful of remote SSRCs reporting on each of our simulcast/RTX streams.
+const size_t kReportBlockSlots = 32;
+
+namespace {
+struct KeyLess {
+  template <typename Entry, typename Key>
+  bool operator()(const Entry& entry, Key key) const {
+    return entry.first < key;
+  }
+};
+
+// Returns the entry with |key| in a table sorted by key, or table.end().
+template <typename Table, typename Key>
+auto FindEntry(Table& table, Key key) -> decltype(table.begin()) {
+  auto it = std::lower_bound(table.begin(), table.end(), key, KeyLess());
+  if (it == table.end() || it->first != key)
+    return table.end();
+  return it;
+}
+
+uint64_t ReportBlockKey(uint32_t remote_ssrc, uint32_t source_ssrc) {
+  return (static_cast<uint64_t>(source_ssrc) << 32) | remote_ssrc;
+}
+}  // namespace
+
 RTCPReceiver::RTCPReceiver(
     Clock* clock,
     bool receiver_only,
@@ -65,7 +92,8 @@ RTCPReceiver::RTCPReceiver(
       _lastReceivedXRNTPsecs(0),
       _lastReceivedXRNTPfrac(0),
       xr_rr_rtt_ms_(0),
-      _receivedInfoMap(),
+      report_blocks_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      report_blocks_main_ssrc_(0),
       _packetTimeOutMS(0),
       _lastReceivedRrMs(0),
       _lastIncreasedSequenceNumberMs(0),
@@ -74,32 +102,16 @@ RTCPReceiver::RTCPReceiver(
       num_skipped_packets_(0),
       last_skipped_packets_warning_(clock->TimeInMilliseconds()) {
   memset(&_remoteSenderInfo, 0, sizeof(_remoteSenderInfo));
+  _receivedReportBlocks.reserve(kReportBlockSlots);
 }
 
 RTCPReceiver::~RTCPReceiver() {
   delete _criticalSectionRTCPReceiver;
   delete _criticalSectionFeedbacks;
 
-  ReportBlockMap::iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    ReportBlockInfoMap* info_map = &(it->second);
-    while (!info_map->empty()) {
-      ReportBlockInfoMap::iterator it_info = info_map->begin();
-      delete it_info->second;
-      info_map->erase(it_info);
-    }
-  }
-  while (!_receivedInfoMap.empty()) {
-    std::map<uint32_t, RTCPReceiveInformation*>::iterator first =
-        _receivedInfoMap.begin();
-    delete first->second;
-    _receivedInfoMap.erase(first);
-  }
-  while (!_receivedCnameMap.empty()) {
-    std::map<uint32_t, RTCPCnameInformation*>::iterator first =
-        _receivedCnameMap.begin();
-    delete first->second;
-    _receivedCnameMap.erase(first);
+  for (ReceivedInfoTable::iterator it = _receivedInfo.begin();
+       it != _receivedInfo.end(); ++it) {
+    delete it->second;
   }
 }
 
@@ -121,8 +133,8 @@ int64_t RTCPReceiver::LastReceived() {
 int64_t RTCPReceiver::LastReceivedReceiverReport() const {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
   int64_t last_received_rr = -1;
-  for (ReceivedInfoMap::const_iterator it = _receivedInfoMap.begin();
-       it != _receivedInfoMap.end(); ++it) {
+  for (ReceivedInfoTable::const_iterator it = _receivedInfo.begin();
+       it != _receivedInfo.end(); ++it) {
     if (it->second->lastTimeReceived > last_received_rr) {
       last_received_rr = it->second->lastTimeReceived;
     }
@@ -154,6 +166,8 @@ void RTCPReceiver::SetSsrcs(uint32_t main_ssrc,
     old_ssrc = main_ssrc_;
     main_ssrc_ = main_ssrc;
     registered_ssrcs_ = registered_ssrcs;
+    CriticalSectionScoped report_blocks_lock(report_blocks_crit_.get());
+    report_blocks_main_ssrc_ = main_ssrc;
   }
   {
     if (_cbRtcpIntraFrameObserver && old_ssrc != main_ssrc) {
@@ -167,10 +181,10 @@ int32_t RTCPReceiver::RTT(uint32_t remoteSSRC,
                           int64_t* avgRTT,
                           int64_t* minRTT,
                           int64_t* maxRTT) const {
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
+  CriticalSectionScoped lock(report_blocks_crit_.get());
 
-  RTCPReportBlockInformation* reportBlock =
-      GetReportBlockInformation(remoteSSRC, main_ssrc_);
+  const RTCPReportBlockInformation* reportBlock =
+      GetReportBlockInformation(remoteSSRC, report_blocks_main_ssrc_);
 
   if (reportBlock == NULL) {
     return -1;
@@ -270,14 +284,10 @@ int32_t RTCPReceiver::SenderInfoReceived(RTCPSenderInfo* senderInfo) const {
 int32_t RTCPReceiver::StatisticsReceived(
     std::vector<RTCPReportBlock>* receiveBlocks) const {
   assert(receiveBlocks);
-  CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
-  ReportBlockMap::const_iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    const ReportBlockInfoMap* info_map = &(it->second);
-    ReportBlockInfoMap::const_iterator it_info = info_map->begin();
-    for (; it_info != info_map->end(); ++it_info) {
-      receiveBlocks->push_back(it_info->second->remoteReceiveBlock);
-    }
+  CriticalSectionScoped lock(report_blocks_crit_.get());
+  for (ReportBlockTable::const_iterator it = _receivedReportBlocks.begin();
+       it != _receivedReportBlocks.end(); ++it) {
+    receiveBlocks->push_back(it->second.remoteReceiveBlock);
   }
   return 0;
 }
@@ -494,6 +504,7 @@ void RTCPReceiver::HandleReportBlock(
       _rtpRtcp.SendTimeOfSendReport(rtcpPacket.ReportBlockItem.LastSR);
   _criticalSectionRTCPReceiver->Enter();
 
+  CriticalSectionScoped report_blocks_lock(report_blocks_crit_.get());
   RTCPReportBlockInformation* reportBlock =
       CreateOrGetReportBlockInformation(remoteSSRC,
                                         rtcpPacket.ReportBlockItem.SSRC);
@@ -587,71 +598,70 @@ void RTCPReceiver::HandleReportBlock(
 RTCPReportBlockInformation* RTCPReceiver::CreateOrGetReportBlockInformation(
     uint32_t remote_ssrc,
     uint32_t source_ssrc) {
-  RTCPReportBlockInformation* info =
-      GetReportBlockInformation(remote_ssrc, source_ssrc);
-  if (info == NULL) {
-    info = new RTCPReportBlockInformation;
-    _receivedReportBlockMap[source_ssrc][remote_ssrc] = info;
-  }
-  return info;
+  const uint64_t key = ReportBlockKey(remote_ssrc, source_ssrc);
+  ReportBlockTable::iterator it =
+      std::lower_bound(_receivedReportBlocks.begin(),
+                       _receivedReportBlocks.end(), key, KeyLess());
+  if (it == _receivedReportBlocks.end() || it->first != key) {
+    it = _receivedReportBlocks.insert(
+        it, std::make_pair(key, RTCPReportBlockInformation()));
+  }
+  return &it->second;
 }
 
-RTCPReportBlockInformation* RTCPReceiver::GetReportBlockInformation(
+const RTCPReportBlockInformation* RTCPReceiver::GetReportBlockInformation(
     uint32_t remote_ssrc,
     uint32_t source_ssrc) const {
-  ReportBlockMap::const_iterator it = _receivedReportBlockMap.find(source_ssrc);
-  if (it == _receivedReportBlockMap.end()) {
-    return NULL;
-  }
-  const ReportBlockInfoMap* info_map = &(it->second);
-  ReportBlockInfoMap::const_iterator it_info = info_map->find(remote_ssrc);
-  if (it_info == info_map->end()) {
+  ReportBlockTable::const_iterator it = FindEntry(
+      _receivedReportBlocks, ReportBlockKey(remote_ssrc, source_ssrc));
+  if (it == _receivedReportBlocks.end()) {
     return NULL;
   }
-  return it_info->second;
+  return &it->second;
 }
 
 RTCPCnameInformation*
 RTCPReceiver::CreateCnameInformation(uint32_t remoteSSRC) {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPCnameInformation*>::iterator it =
-      _receivedCnameMap.find(remoteSSRC);
+  CnameTable::iterator it = std::lower_bound(
+      _receivedCnames.begin(), _receivedCnames.end(), remoteSSRC, KeyLess());
 
-  if (it != _receivedCnameMap.end()) {
-    return it->second;
+  if (it != _receivedCnames.end() && it->first == remoteSSRC) {
+    return &it->second;
   }
-  RTCPCnameInformation* cnameInfo = new RTCPCnameInformation;
-  memset(cnameInfo->name, 0, RTCP_CNAME_SIZE);
-  _receivedCnameMap[remoteSSRC] = cnameInfo;
-  return cnameInfo;
+  RTCPCnameInformation cnameInfo;
+  memset(cnameInfo.name, 0, RTCP_CNAME_SIZE);
+  it = _receivedCnames.insert(it, std::make_pair(remoteSSRC, cnameInfo));
+  return &it->second;
 }
 
 RTCPCnameInformation*
 RTCPReceiver::GetCnameInformation(uint32_t remoteSSRC) const {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPCnameInformation*>::const_iterator it =
-      _receivedCnameMap.find(remoteSSRC);
+  CnameTable::const_iterator it = FindEntry(_receivedCnames, remoteSSRC);
 
-  if (it == _receivedCnameMap.end()) {
+  if (it == _receivedCnames.end()) {
     return NULL;
   }
-  return it->second;
+  // The table hands out mutable pointers to its entries, as the map of
+  // heap allocated entries did.
+  return const_cast<RTCPCnameInformation*>(&it->second);
 }
 
 RTCPReceiveInformation*
 RTCPReceiver::CreateReceiveInformation(uint32_t remoteSSRC) {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator it =
-      _receivedInfoMap.find(remoteSSRC);
+  ReceivedInfoTable::iterator it = std::lower_bound(
+      _receivedInfo.begin(), _receivedInfo.end(), remoteSSRC, KeyLess());
 
-  if (it != _receivedInfoMap.end()) {
+  if (it != _receivedInfo.end() && it->first == remoteSSRC) {
     return it->second;
   }
   RTCPReceiveInformation* receiveInfo = new RTCPReceiveInformation;
-  _receivedInfoMap[remoteSSRC] = receiveInfo;
+  _receivedInfo.insert(it, std::make_pair(remoteSSRC, receiveInfo));
   return receiveInfo;
 }
 
@@ -659,9 +669,8 @@ RTCPReceiveInformation*
 RTCPReceiver::GetReceiveInformation(uint32_t remoteSSRC) {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator it =
-      _receivedInfoMap.find(remoteSSRC);
-  if (it == _receivedInfoMap.end()) {
+  ReceivedInfoTable::iterator it = FindEntry(_receivedInfo, remoteSSRC);
+  if (it == _receivedInfo.end()) {
     return NULL;
   }
   return it->second;
@@ -708,10 +717,9 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
   bool updateBoundingSet = false;
   int64_t timeNow = _clock->TimeInMilliseconds();
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.begin();
+  ReceivedInfoTable::iterator receiveInfoIt = _receivedInfo.begin();
 
-  while (receiveInfoIt != _receivedInfoMap.end()) {
+  while (receiveInfoIt != _receivedInfo.end()) {
     RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
     if (receiveInfo == NULL) {
       return updateBoundingSet;
@@ -733,12 +741,8 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
       }
       receiveInfoIt++;
     } else if (receiveInfo->readyForDelete) {
-      // store our current receiveInfoItem
-      std::map<uint32_t, RTCPReceiveInformation*>::iterator
-      receiveInfoItemToBeErased = receiveInfoIt;
-      receiveInfoIt++;
-      delete receiveInfoItemToBeErased->second;
-      _receivedInfoMap.erase(receiveInfoItemToBeErased);
+      delete receiveInfoIt->second;
+      receiveInfoIt = _receivedInfo.erase(receiveInfoIt);
     } else {
       receiveInfoIt++;
     }
@@ -749,10 +753,10 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
 int32_t RTCPReceiver::BoundingSet(bool* tmmbrOwner, TMMBRSet* boundingSetRec) {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.find(_remoteSSRC);
+  ReceivedInfoTable::iterator receiveInfoIt =
+      FindEntry(_receivedInfo, _remoteSSRC);
 
-  if (receiveInfoIt == _receivedInfoMap.end()) {
+  if (receiveInfoIt == _receivedInfo.end()) {
     return -1;
   }
   RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
@@ -850,31 +854,31 @@ void RTCPReceiver::HandleBYE(RTCPUtility::RTCPParserV2& rtcpParser) {
   const RTCPUtility::RTCPPacket& rtcpPacket = rtcpParser.Packet();
 
   // clear our lists
-  ReportBlockMap::iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    ReportBlockInfoMap* info_map = &(it->second);
-    ReportBlockInfoMap::iterator it_info = info_map->find(
-        rtcpPacket.BYE.SenderSSRC);
-    if (it_info != info_map->end()) {
-      delete it_info->second;
-      info_map->erase(it_info);
-    }
+  {
+    CriticalSectionScoped report_blocks_lock(report_blocks_crit_.get());
+    const uint32_t bye_ssrc = rtcpPacket.BYE.SenderSSRC;
+    _receivedReportBlocks.erase(
+        std::remove_if(_receivedReportBlocks.begin(),
+                       _receivedReportBlocks.end(),
+                       [bye_ssrc](const ReportBlockTable::value_type& entry) {
+                         return static_cast<uint32_t>(entry.first) == bye_ssrc;
+                       }),
+        _receivedReportBlocks.end());
   }
 
   //  we can't delete it due to TMMBR
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.find(rtcpPacket.BYE.SenderSSRC);
+  ReceivedInfoTable::iterator receiveInfoIt =
+      FindEntry(_receivedInfo, rtcpPacket.BYE.SenderSSRC);
 
-  if (receiveInfoIt != _receivedInfoMap.end()) {
+  if (receiveInfoIt != _receivedInfo.end()) {
     receiveInfoIt->second->readyForDelete = true;
   }
 
-  std::map<uint32_t, RTCPCnameInformation*>::iterator cnameInfoIt =
-      _receivedCnameMap.find(rtcpPacket.BYE.SenderSSRC);
+  CnameTable::iterator cnameInfoIt =
+      FindEntry(_receivedCnames, rtcpPacket.BYE.SenderSSRC);
 
-  if (cnameInfoIt != _receivedCnameMap.end()) {
-    delete cnameInfoIt->second;
-    _receivedCnameMap.erase(cnameInfoIt);
+  if (cnameInfoIt != _receivedCnames.end()) {
+    _receivedCnames.erase(cnameInfoIt);
   }
   xr_rr_rtt_ms_ = 0;
   rtcpParser.Iterate();
@@ -1320,6 +1324,57 @@ RtcpStatisticsCallback* RTCPReceiver::GetRtcpStatisticsCallback() {
   return stats_callback_;
 }
 
+bool RTCPReceiver::IncomingTransportFeedback(const uint8_t* packet,
+                                             size_t length) {
+  // Each feedback packet for a stream of ours is a separate callback, so at
+  // most one compound packet worth of them is collected.
+  const size_t kMaxFeedbackBlocks = 8;
+  rtcp::BlockView blocks[kMaxFeedbackBlocks];
+  uint32_t media_ssrcs[kMaxFeedbackBlocks];
+  size_t num_blocks = 0;
+
+  rtcp::CompoundPacketView compound(packet, length);
+  rtcp::BlockView block;
+  rtcp::TransportFeedbackView feedback;
+  size_t parsed_length = 0;
+  while (compound.Next(&block)) {
+    if (num_blocks == kMaxFeedbackBlocks || !feedback.Parse(block))
+      return false;
+    blocks[num_blocks] = block;
+    media_ssrcs[num_blocks] = feedback.media_ssrc();
+    ++num_blocks;
+    parsed_length += block.header.BlockSize();
+  }
+  if (num_blocks == 0 || parsed_length != length)
+    return false;
+
+  bool for_us[kMaxFeedbackBlocks];
+  {
+    CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
+    _lastReceived = _clock->TimeInMilliseconds();
+    if (packet_type_counter_.first_packet_time_ms == -1)
+      packet_type_counter_.first_packet_time_ms = _lastReceived;
+    for (size_t i = 0; i < num_blocks; ++i) {
+      for_us[i] = media_ssrcs[i] == main_ssrc_ ||
+                  registered_ssrcs_.find(media_ssrcs[i]) !=
+                      registered_ssrcs_.end();
+    }
+  }
+
+  if (!_cbTransportFeedbackObserver)
+    return true;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (!for_us[i])
+      continue;
+    rtc::scoped_ptr<rtcp::TransportFeedback> parsed =
+        rtcp::TransportFeedback::ParseFrom(blocks[i].data,
+                                           blocks[i].header.BlockSize());
+    if (parsed)
+      _cbTransportFeedbackObserver->OnTransportFeedback(*parsed);
+  }
+  return true;
+}
+
 // Holding no Critical section
 void RTCPReceiver::TriggerCallbacksFromRTCPPacket(
     RTCPPacketInformation& rtcpPacketInformation) {
@@ -1444,14 +1499,13 @@ int32_t RTCPReceiver::TMMBRReceived(uint32_t size,
                                     TMMBRSet* candidateSet) const {
   CriticalSectionScoped lock(_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReceiveInformation*>::const_iterator
-      receiveInfoIt = _receivedInfoMap.begin();
-  if (receiveInfoIt == _receivedInfoMap.end()) {
+  ReceivedInfoTable::const_iterator receiveInfoIt = _receivedInfo.begin();
+  if (receiveInfoIt == _receivedInfo.end()) {
     return -1;
   }
   uint32_t num = accNumCandidates;
   if (candidateSet) {
-    while( num < size && receiveInfoIt != _receivedInfoMap.end()) {
+    while( num < size && receiveInfoIt != _receivedInfo.end()) {
       RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
       if (receiveInfo == NULL) {
         return 0;
@@ -1466,7 +1520,7 @@ int32_t RTCPReceiver::TMMBRReceived(uint32_t size,
       receiveInfoIt++;
     }
   } else {
-    while (receiveInfoIt != _receivedInfoMap.end()) {
+    while (receiveInfoIt != _receivedInfo.end()) {
       RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
       if(receiveInfo == NULL) {
         return -1;
@@ -11,10 +11,11 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTCP_RECEIVER_H_
 
-#include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_receiver_help.h"
@@ -59,6 +60,12 @@ public:
     void TriggerCallbacksFromRTCPPacket(
         RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
 
+    // Handles a packet made up of transport feedback only, which remote
+    // endpoints send on their own every 50-100 ms. Feedback about streams
+    // that are not ours is dropped without being decoded. Returns false,
+    // without doing anything, if the packet contains anything else.
+    bool IncomingTransportFeedback(const uint8_t* packet, size_t length);
+
     // get received cname
     int32_t CNAME(uint32_t remoteSSRC, char cName[RTCP_CNAME_SIZE]) const;
 
@@ -252,20 +259,26 @@ protected:
         EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
 
  private:
-  typedef std::map<uint32_t, RTCPHelp::RTCPReceiveInformation*>
-      ReceivedInfoMap;
-  // RTCP report block information mapped by remote SSRC.
-  typedef std::map<uint32_t, RTCPHelp::RTCPReportBlockInformation*>
-      ReportBlockInfoMap;
-  // RTCP report block information map mapped by source SSRC.
-  typedef std::map<uint32_t, ReportBlockInfoMap> ReportBlockMap;
+  // The per-SSRC state is kept in flat tables sorted by SSRC, which are
+  // cheaper to look up and walk than maps when there are many remote SSRCs.
+  typedef std::vector<std::pair<uint32_t, RTCPHelp::RTCPReceiveInformation*>>
+      ReceivedInfoTable;
+  typedef std::vector<std::pair<uint32_t, RTCPUtility::RTCPCnameInformation>>
+      CnameTable;
+  // RTCP report block information keyed by source SSRC in the upper and remote
+  // SSRC in the lower 32 bits, so that the blocks about one of our SSRCs are
+  // next to each other.
+  typedef std::vector<
+      std::pair<uint64_t, RTCPHelp::RTCPReportBlockInformation>>
+      ReportBlockTable;
 
   RTCPHelp::RTCPReportBlockInformation* CreateOrGetReportBlockInformation(
       uint32_t remote_ssrc, uint32_t source_ssrc)
-          EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
-  RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(
+          EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver,
+                                   report_blocks_crit_);
+  const RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(
       uint32_t remote_ssrc, uint32_t source_ssrc) const
-          EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
+          EXCLUSIVE_LOCKS_REQUIRED(report_blocks_crit_);
 
   Clock* const _clock;
   const bool receiver_only_;
@@ -297,11 +310,15 @@ protected:
   // Estimated rtt, zero when there is no valid estimate.
   int64_t xr_rr_rtt_ms_;
 
-  // Received report blocks.
-  ReportBlockMap _receivedReportBlockMap
-      GUARDED_BY(_criticalSectionRTCPReceiver);
-  ReceivedInfoMap _receivedInfoMap;
-  std::map<uint32_t, RTCPUtility::RTCPCnameInformation*> _receivedCnameMap;
+  // Received report blocks. These are read by RTT() and StatisticsReceived()
+  // under their own lock, so that those don't wait for the processing of a
+  // whole compound packet. Writers hold both locks.
+  rtc::scoped_ptr<CriticalSectionWrapper> report_blocks_crit_;
+  ReportBlockTable _receivedReportBlocks GUARDED_BY(report_blocks_crit_);
+  // Copy of |main_ssrc_| for looking up report blocks.
+  uint32_t report_blocks_main_ssrc_ GUARDED_BY(report_blocks_crit_);
+  ReceivedInfoTable _receivedInfo GUARDED_BY(_criticalSectionRTCPReceiver);
+  CnameTable _receivedCnames GUARDED_BY(_criticalSectionRTCPReceiver);
 
   uint32_t _packetTimeOutMS;
 
@@ -1098,6 +1098,33 @@ TEST_F(RtcpReceiverTest, HandlesInvalidTransportFeedback) {
   EXPECT_EQ(kBitrateBps, rtcp_packet_info_.receiverEstimatedMaxBitrate);
 }
 
+TEST_F(RtcpReceiverTest, HandlesStandAloneTransportFeedbackDirectly) {
+  const uint32_t kSenderSsrc = 0x10203;
+  const uint32_t kSourceSsrc = 0x123456;
+
+  rtcp::TransportFeedback packet;
+  packet.WithMediaSourceSsrc(kSourceSsrc);
+  packet.WithPacketSenderSsrc(kSenderSsrc);
+  packet.WithBase(1, 1000);
+  packet.WithReceivedPacket(1, 1000);
+  rtc::scoped_ptr<rtcp::RawPacket> built_packet = packet.Build();
+
+  EXPECT_EQ(0, rtcp_receiver_->LastReceived());
+  EXPECT_TRUE(rtcp_receiver_->IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length()));
+  EXPECT_EQ(system_clock_.TimeInMilliseconds(),
+            rtcp_receiver_->LastReceived());
+
+  // Anything else in the packet has to go through the full parser.
+  rtcp::Remb remb;
+  remb.From(kSenderSsrc);
+  remb.WithBitrateBps(50000);
+  packet.Append(&remb);
+  built_packet = packet.Build();
+  EXPECT_FALSE(rtcp_receiver_->IncomingTransportFeedback(
+      built_packet->Buffer(), built_packet->Length()));
+}
+
 }  // Anonymous namespace
 
 }  // namespace webrtc
@@ -798,6 +798,28 @@ TEST_F(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(IsRecoveryComplete());
 }
 
+TEST_F(RtpFecTest, ReleasedPacketsAreReused) {
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> packet =
+      fec_->NewPacket();
+  const ForwardErrorCorrection::Packet* storage = packet.get();
+  packet->length = 100;
+  memset(packet->data, 0xff, packet->length);
+  packet = NULL;
+
+  // The storage is handed out again, zeroed.
+  packet = fec_->NewPacket();
+  EXPECT_EQ(storage, packet.get());
+  EXPECT_EQ(0u, packet->length);
+  for (size_t i = 0; i < sizeof(packet->data); ++i)
+    ASSERT_EQ(0, packet->data[i]);
+
+  // Packets may outlive the ForwardErrorCorrection they came from.
+  delete fec_;
+  fec_ = new ForwardErrorCorrection();
+  packet->length = 1;
+  packet = NULL;
+}
+
 void RtpFecTest::TearDown() {
   fec_->ResetState(&recovered_packet_list_);
   delete fec_;
@@ -28,6 +28,15 @@ class RtpPacketizer {
 
   virtual ~RtpPacketizer() {}
 
+  // Sets the header of the next frame to packetize, so that a packetizer can
+  // be reused for every frame of a stream instead of being created per frame.
+  // Must be called before SetPayloadData(). The header the packetizer was
+  // created with is used for the first frame.
+  virtual void SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                              FrameType frame_type) = 0;
+
+  // Starts packetizing a new frame. Any packets left of the previous frame
+  // are discarded.
   virtual void SetPayloadData(const uint8_t* payload_data,
                               size_t payload_size,
                               const RTPFragmentationHeader* fragmentation) = 0;
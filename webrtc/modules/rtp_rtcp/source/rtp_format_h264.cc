@@ -153,20 +153,26 @@ RtpPacketizerH264::RtpPacketizerH264(FrameType frame_type,
                                      size_t max_payload_len)
     : payload_data_(NULL),
       payload_size_(0),
-      max_payload_len_(max_payload_len) {
+      max_payload_len_(max_payload_len),
+      next_packet_(0) {
 }
 
 RtpPacketizerH264::~RtpPacketizerH264() {
 }
 
+void RtpPacketizerH264::SetVideoHeader(
+    const RTPVideoTypeHeader* rtp_type_header,
+    FrameType frame_type) {}
+
 void RtpPacketizerH264::SetPayloadData(
     const uint8_t* payload_data,
     size_t payload_size,
     const RTPFragmentationHeader* fragmentation) {
-  assert(packets_.empty());
   assert(fragmentation);
   payload_data_ = payload_data;
   payload_size_ = payload_size;
+  packets_.clear();
+  next_packet_ = 0;
   fragmentation_.CopyFrom(*fragmentation);
   GeneratePackets();
 }
@@ -199,12 +205,12 @@ void RtpPacketizerH264::PacketizeFuA(size_t fragment_offset,
     if (fragment_length < avg_size)
       packet_length = fragment_length;
     uint8_t header = payload_data_[fragment_offset];
-    packets_.push(Packet(offset,
-                         packet_length,
-                         offset - kNalHeaderSize == fragment_offset,
-                         fragment_length == packet_length,
-                         false,
-                         header));
+    packets_.push_back(Packet(offset,
+                              packet_length,
+                              offset - kNalHeaderSize == fragment_offset,
+                              fragment_length == packet_length,
+                              false,
+                              header));
     offset += packet_length;
     fragment_length -= packet_length;
   }
@@ -221,12 +227,12 @@ int RtpPacketizerH264::PacketizeStapA(size_t fragment_index,
   while (payload_size_left >= fragment_length + fragment_headers_length) {
     assert(fragment_length > 0);
     uint8_t header = payload_data_[fragment_offset];
-    packets_.push(Packet(fragment_offset,
-                         fragment_length,
-                         aggregated_fragments == 0,
-                         false,
-                         true,
-                         header));
+    packets_.push_back(Packet(fragment_offset,
+                              fragment_length,
+                              aggregated_fragments == 0,
+                              false,
+                              true,
+                              header));
     payload_size_left -= fragment_length;
     payload_size_left -= fragment_headers_length;
 
@@ -253,19 +259,19 @@ bool RtpPacketizerH264::NextPacket(uint8_t* buffer,
                                    size_t* bytes_to_send,
                                    bool* last_packet) {
   *bytes_to_send = 0;
-  if (packets_.empty()) {
+  if (NoPacketsLeft()) {
     *bytes_to_send = 0;
     *last_packet = true;
     return false;
   }
 
-  Packet packet = packets_.front();
+  Packet packet = packets_[next_packet_];
 
   if (packet.first_fragment && packet.last_fragment) {
     // Single NAL unit packet.
     *bytes_to_send = packet.size;
     memcpy(buffer, &payload_data_[packet.offset], packet.size);
-    packets_.pop();
+    ++next_packet_;
     assert(*bytes_to_send <= max_payload_len_);
   } else if (packet.aggregated) {
     NextAggregatePacket(buffer, bytes_to_send);
@@ -274,13 +280,13 @@ bool RtpPacketizerH264::NextPacket(uint8_t* buffer,
     NextFragmentPacket(buffer, bytes_to_send);
     assert(*bytes_to_send <= max_payload_len_);
   }
-  *last_packet = packets_.empty();
+  *last_packet = NoPacketsLeft();
   return true;
 }
 
 void RtpPacketizerH264::NextAggregatePacket(uint8_t* buffer,
                                             size_t* bytes_to_send) {
-  Packet packet = packets_.front();
+  Packet packet = packets_[next_packet_];
   assert(packet.first_fragment);
   // STAP-A NALU header.
   buffer[0] = (packet.header & (kFBit | kNriMask)) | kStapA;
@@ -295,17 +301,17 @@ void RtpPacketizerH264::NextAggregatePacket(uint8_t* buffer,
     memcpy(&buffer[index], &payload_data_[packet.offset], packet.size);
     index += packet.size;
     *bytes_to_send += packet.size;
-    packets_.pop();
+    ++next_packet_;
     if (packet.last_fragment)
       break;
-    packet = packets_.front();
+    packet = packets_[next_packet_];
   }
   assert(packet.last_fragment);
 }
 
 void RtpPacketizerH264::NextFragmentPacket(uint8_t* buffer,
                                            size_t* bytes_to_send) {
-  Packet packet = packets_.front();
+  Packet packet = packets_[next_packet_];
   // NAL unit fragmented over multiple packets (FU-A).
   // We do not send original NALU header, so it will be replaced by the
   // FU indicator header of the first packet.
@@ -327,7 +333,7 @@ void RtpPacketizerH264::NextFragmentPacket(uint8_t* buffer,
     *bytes_to_send = packet.size + kFuAHeaderSize;
     memcpy(buffer + kFuAHeaderSize, &payload_data_[packet.offset], packet.size);
   }
-  packets_.pop();
+  ++next_packet_;
 }
 
 ProtectionType RtpPacketizerH264::GetProtectionType() {
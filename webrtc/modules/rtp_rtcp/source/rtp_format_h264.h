@@ -11,8 +11,8 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_H264_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_H264_H_
 
-#include <queue>
 #include <string>
+#include <vector>
 
 #include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 
@@ -26,6 +26,9 @@ class RtpPacketizerH264 : public RtpPacketizer {
 
   virtual ~RtpPacketizerH264();
 
+  void SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                      FrameType frame_type) override;
+
   void SetPayloadData(const uint8_t* payload_data,
                       size_t payload_size,
                       const RTPFragmentationHeader* fragmentation) override;
@@ -69,7 +72,6 @@ class RtpPacketizerH264 : public RtpPacketizer {
     bool aggregated;
     uint8_t header;
   };
-  typedef std::queue<Packet> PacketQueue;
 
   void GeneratePackets();
   void PacketizeFuA(size_t fragment_offset, size_t fragment_length);
@@ -78,12 +80,17 @@ class RtpPacketizerH264 : public RtpPacketizer {
                      size_t fragment_length);
   void NextAggregatePacket(uint8_t* buffer, size_t* bytes_to_send);
   void NextFragmentPacket(uint8_t* buffer, size_t* bytes_to_send);
+  bool NoPacketsLeft() const { return next_packet_ == packets_.size(); }
 
   const uint8_t* payload_data_;
   size_t payload_size_;
   const size_t max_payload_len_;
   RTPFragmentationHeader fragmentation_;
-  PacketQueue packets_;
+  // The packets of the current frame, of which the ones from |next_packet_|
+  // on are still to be sent. Kept between frames so that the storage is
+  // reused.
+  std::vector<Packet> packets_;
+  size_t next_packet_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketizerH264);
 };
@@ -204,6 +204,44 @@ TEST(RtpPacketizerH264Test, TestSingleNaluTwoPackets) {
   EXPECT_FALSE(packetizer->NextPacket(packet, &length, &last));
 }
 
+TEST(RtpPacketizerH264Test, TestReusedForNextFrame) {
+  const size_t kFrameSize = kMaxPayloadSize + 100;
+  uint8_t frame[kFrameSize] = {0};
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(2);
+  fragmentation.fragmentationOffset[0] = 0;
+  fragmentation.fragmentationLength[0] = kMaxPayloadSize;
+  fragmentation.fragmentationOffset[1] = kMaxPayloadSize;
+  fragmentation.fragmentationLength[1] = 100;
+  frame[fragmentation.fragmentationOffset[0]] = 0x01;
+  frame[fragmentation.fragmentationOffset[1]] = 0x01;
+
+  rtc::scoped_ptr<RtpPacketizer> packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize, NULL, kEmptyFrame));
+  packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+  uint8_t packet[kMaxPayloadSize] = {0};
+  size_t length = 0;
+  bool last = false;
+  // Leave the second packet of the first frame unsent.
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_FALSE(last);
+
+  const uint8_t next_frame[2] = {0x05, 0xFF};  // F=0, NRI=0, Type=5.
+  RTPFragmentationHeader next_fragmentation;
+  next_fragmentation.VerifyAndAllocateFragmentationHeader(1);
+  next_fragmentation.fragmentationOffset[0] = 0;
+  next_fragmentation.fragmentationLength[0] = sizeof(next_frame);
+  packetizer->SetVideoHeader(NULL, kVideoFrameKey);
+  packetizer->SetPayloadData(next_frame, sizeof(next_frame),
+                             &next_fragmentation);
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(2u, length);
+  EXPECT_TRUE(last);
+  VerifySingleNaluPayload(next_fragmentation, 0, next_frame,
+                          sizeof(next_frame), packet, length);
+  EXPECT_FALSE(packetizer->NextPacket(packet, &length, &last));
+}
+
 TEST(RtpPacketizerH264Test, TestStapA) {
   const size_t kFrameSize =
       kMaxPayloadSize - 3 * kLengthFieldLength - kNalHeaderSize;
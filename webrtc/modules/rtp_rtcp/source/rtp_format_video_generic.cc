@@ -29,6 +29,12 @@ RtpPacketizerGeneric::RtpPacketizerGeneric(FrameType frame_type,
 RtpPacketizerGeneric::~RtpPacketizerGeneric() {
 }
 
+void RtpPacketizerGeneric::SetVideoHeader(
+    const RTPVideoTypeHeader* rtp_type_header,
+    FrameType frame_type) {
+  frame_type_ = frame_type;
+}
+
 void RtpPacketizerGeneric::SetPayloadData(
     const uint8_t* payload_data,
     size_t payload_size,
@@ -30,6 +30,9 @@ class RtpPacketizerGeneric : public RtpPacketizer {
 
   virtual ~RtpPacketizerGeneric();
 
+  void SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                      FrameType frame_type) override;
+
   void SetPayloadData(const uint8_t* payload_data,
                       size_t payload_size,
                       const RTPFragmentationHeader* fragmentation) override;
@@ -159,6 +159,7 @@ RtpPacketizerVp8::RtpPacketizerVp8(const RTPVideoHeaderVP8& hdr_info,
       hdr_info_(hdr_info),
       num_partitions_(0),
       max_payload_len_(max_payload_len),
+      next_packet_(0),
       packets_calculated_(false) {
 }
 
@@ -174,18 +175,28 @@ RtpPacketizerVp8::RtpPacketizerVp8(const RTPVideoHeaderVP8& hdr_info,
       hdr_info_(hdr_info),
       num_partitions_(0),
       max_payload_len_(max_payload_len),
+      next_packet_(0),
       packets_calculated_(false) {
 }
 
 RtpPacketizerVp8::~RtpPacketizerVp8() {
 }
 
+void RtpPacketizerVp8::SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                                      FrameType frame_type) {
+  assert(rtp_type_header != NULL);
+  hdr_info_ = rtp_type_header->VP8;
+}
+
 void RtpPacketizerVp8::SetPayloadData(
     const uint8_t* payload_data,
     size_t payload_size,
     const RTPFragmentationHeader* fragmentation) {
   payload_data_ = payload_data;
   payload_size_ = payload_size;
+  packets_.clear();
+  next_packet_ = 0;
+  packets_calculated_ = false;
   if (fragmentation) {
     part_info_.CopyFrom(*fragmentation);
     num_partitions_ = fragmentation->fragmentationVectorSize;
@@ -211,11 +222,10 @@ bool RtpPacketizerVp8::NextPacket(uint8_t* buffer,
       return false;
     }
   }
-  if (packets_.empty()) {
+  if (NoPacketsLeft()) {
     return false;
   }
-  InfoStruct packet_info = packets_.front();
-  packets_.pop();
+  const InfoStruct& packet_info = packets_[next_packet_++];
 
   int bytes = WriteHeaderAndPayload(packet_info, buffer, max_payload_len_);
   if (bytes < 0) {
@@ -223,7 +233,7 @@ bool RtpPacketizerVp8::NextPacket(uint8_t* buffer,
   }
   *bytes_to_send = static_cast<size_t>(bytes);
 
-  *last_packet = packets_.empty();
+  *last_packet = NoPacketsLeft();
   return true;
 }
 
@@ -346,17 +356,16 @@ int RtpPacketizerVp8::GeneratePacketsBalancedAggregates() {
     // descriptor and one payload byte. Return an error.
     return -1;
   }
-  std::vector<int> partition_decision;
   const size_t overhead =
       vp8_fixed_payload_descriptor_bytes_ + PayloadDescriptorExtraLength();
   const size_t max_payload_len = max_payload_len_ - overhead;
   int min_size, max_size;
-  AggregateSmallPartitions(&partition_decision, &min_size, &max_size);
+  AggregateSmallPartitions(&partition_decision_, &min_size, &max_size);
 
   size_t total_bytes_processed = 0;
   size_t part_ix = 0;
   while (part_ix < num_partitions_) {
-    if (partition_decision[part_ix] == -1) {
+    if (partition_decision_[part_ix] == -1) {
       // Split large partitions.
       size_t remaining_partition = part_info_.fragmentationLength[part_ix];
       size_t num_fragments = Vp8PartitionAggregator::CalcNumberOfFragments(
@@ -383,9 +392,9 @@ int RtpPacketizerVp8::GeneratePacketsBalancedAggregates() {
     } else {
       size_t this_packet_bytes = 0;
       const size_t first_partition_in_packet = part_ix;
-      const int aggregation_index = partition_decision[part_ix];
-      while (part_ix < partition_decision.size() &&
-             partition_decision[part_ix] == aggregation_index) {
+      const int aggregation_index = partition_decision_[part_ix];
+      while (part_ix < partition_decision_.size() &&
+             partition_decision_[part_ix] == aggregation_index) {
         // Collect all partitions that were aggregated into the same packet.
         this_packet_bytes += part_info_.fragmentationLength[part_ix];
         ++part_ix;
@@ -455,7 +464,7 @@ void RtpPacketizerVp8::QueuePacket(size_t start_pos,
   packet_info.size = packet_size;
   packet_info.first_partition_ix = first_partition_in_packet;
   packet_info.first_fragment = start_on_new_fragment;
-  packets_.push(packet_info);
+  packets_.push_back(packet_info);
 }
 
 int RtpPacketizerVp8::WriteHeaderAndPayload(const InfoStruct& packet_info,
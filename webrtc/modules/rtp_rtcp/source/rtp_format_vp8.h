@@ -25,7 +25,6 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP8_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP8_H_
 
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -60,6 +59,9 @@ class RtpPacketizerVp8 : public RtpPacketizer {
 
   virtual ~RtpPacketizerVp8();
 
+  void SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                      FrameType frame_type) override;
+
   void SetPayloadData(const uint8_t* payload_data,
                       size_t payload_size,
                       const RTPFragmentationHeader* fragmentation) override;
@@ -92,7 +94,6 @@ class RtpPacketizerVp8 : public RtpPacketizer {
     bool first_fragment;
     size_t first_partition_ix;
   } InfoStruct;
-  typedef std::queue<InfoStruct> InfoQueue;
   enum AggregationMode {
     kAggrNone = 0,    // No aggregation.
     kAggrPartitions,  // Aggregate intact partitions.
@@ -138,6 +139,9 @@ class RtpPacketizerVp8 : public RtpPacketizer {
                                 int* min_size,
                                 int* max_size);
 
+  // Returns true if no packets are left to send for the current frame.
+  bool NoPacketsLeft() const { return next_packet_ == packets_.size(); }
+
   // Insert packet into packet queue.
   void QueuePacket(size_t start_pos,
                    size_t packet_size,
@@ -206,10 +210,15 @@ class RtpPacketizerVp8 : public RtpPacketizer {
   const AggregationMode aggr_mode_;
   const bool balance_;
   const bool separate_first_;
-  const RTPVideoHeaderVP8 hdr_info_;
+  RTPVideoHeaderVP8 hdr_info_;
   size_t num_partitions_;
   const size_t max_payload_len_;
-  InfoQueue packets_;
+  // The packets of the current frame, of which the ones from |next_packet_|
+  // on are still to be sent. Kept, with |partition_decision_|, between frames
+  // so that their storage is reused.
+  std::vector<InfoStruct> packets_;
+  size_t next_packet_;
+  std::vector<int> partition_decision_;
   bool packets_calculated_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketizerVp8);
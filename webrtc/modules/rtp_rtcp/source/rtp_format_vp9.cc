@@ -13,11 +13,14 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cmath>
 
 #include "webrtc/base/bitbuffer.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
 #define RETURN_FALSE_ON_ERROR(x) \
   if (!(x)) {                    \
@@ -159,13 +162,13 @@ void QueuePacket(size_t start_pos,
                  size_t size,
                  bool layer_begin,
                  bool layer_end,
-                 RtpPacketizerVp9::PacketInfoQueue* packets) {
+                 RtpPacketizerVp9::PacketInfoVector* packets) {
   RtpPacketizerVp9::PacketInfo packet_info;
   packet_info.payload_start_pos = start_pos;
   packet_info.size = size;
   packet_info.layer_begin = layer_begin;
   packet_info.layer_end = layer_end;
-  packets->push(packet_info);
+  packets->push_back(packet_info);
 }
 
 // Picture ID:
@@ -301,6 +304,61 @@ bool WriteSsData(const RTPVideoHeaderVP9& vp9, rtc::BitBufferWriter* writer) {
   return true;
 }
 
+// Writes the payload descriptor for a packet of the layer frame described by
+// |vp9| to |buffer|. |layer_begin| and |layer_end| tell whether the packet is
+// the first and last one of the layer frame.
+bool WritePayloadDescriptor(const RTPVideoHeaderVP9& vp9,
+                            bool layer_begin,
+                            bool layer_end,
+                            uint8_t* buffer,
+                            size_t buffer_length,
+                            size_t* header_length) {
+  // Required payload descriptor byte.
+  bool i_bit = PictureIdPresent(vp9);
+  bool p_bit = vp9.inter_pic_predicted;
+  bool l_bit = LayerInfoPresent(vp9);
+  bool f_bit = vp9.flexible_mode;
+  bool b_bit = layer_begin;
+  bool e_bit = layer_end;
+  bool v_bit = vp9.ss_data_available && b_bit;
+
+  rtc::BitBufferWriter writer(buffer, buffer_length);
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(i_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(p_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(l_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(f_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(b_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(e_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(v_bit ? 1 : 0, 1));
+  RETURN_FALSE_ON_ERROR(writer.WriteBits(kReservedBitValue0, 1));
+
+  // Add fields that are present.
+  if (i_bit && !WritePictureId(vp9, &writer)) {
+    LOG(LS_ERROR) << "Failed writing VP9 picture id.";
+    return false;
+  }
+  if (l_bit && !WriteLayerInfo(vp9, &writer)) {
+    LOG(LS_ERROR) << "Failed writing VP9 layer info.";
+    return false;
+  }
+  if (p_bit && f_bit && !WriteRefIndices(vp9, &writer)) {
+    LOG(LS_ERROR) << "Failed writing VP9 ref indices.";
+    return false;
+  }
+  if (v_bit && !WriteSsData(vp9, &writer)) {
+    LOG(LS_ERROR) << "Failed writing VP9 SS data.";
+    return false;
+  }
+
+  size_t offset_bytes = 0;
+  size_t offset_bits = 0;
+  writer.GetCurrentOffset(&offset_bytes, &offset_bits);
+  assert(offset_bits == 0);
+
+  *header_length = offset_bytes;
+  return true;
+}
+
 // Picture ID:
 //
 //      +-+-+-+-+-+-+-+-+
@@ -474,6 +532,50 @@ size_t CalcNextSize(size_t max_length, size_t rem_bytes) {
   }
   return max_length >= rem_bytes ? rem_bytes : max_length;
 }
+
+// Returns the GOF of the stream that only has the pictures of |gof| up to
+// temporal layer |max_temporal_idx|, with the P_DIFFs counted in pictures of
+// that stream. References to dropped pictures are removed.
+GofInfoVP9 FilterGof(const GofInfoVP9& gof, uint8_t max_temporal_idx) {
+  GofInfoVP9 filtered;
+  filtered.num_frames_in_gof = 0;
+  // Number of pictures kept before each picture of the GOF.
+  size_t kept_before[kMaxVp9FramesInGof];
+  for (size_t i = 0; i < gof.num_frames_in_gof; ++i) {
+    kept_before[i] = filtered.num_frames_in_gof;
+    if (gof.temporal_idx[i] <= max_temporal_idx)
+      ++filtered.num_frames_in_gof;
+  }
+  const int num_frames = static_cast<int>(gof.num_frames_in_gof);
+  const int num_kept = static_cast<int>(filtered.num_frames_in_gof);
+  size_t n = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    if (gof.temporal_idx[i] > max_temporal_idx)
+      continue;
+    filtered.temporal_idx[n] = gof.temporal_idx[i];
+    filtered.temporal_up_switch[n] = gof.temporal_up_switch[i];
+    filtered.num_ref_pics[n] = 0;
+    for (uint8_t r = 0; r < gof.num_ref_pics[i]; ++r) {
+      // The referenced picture may be in one of the previous GOFs.
+      int ref = i - gof.pid_diff[i][r];
+      int cycles = 0;
+      while (ref < 0) {
+        ref += num_frames;
+        ++cycles;
+      }
+      if (gof.temporal_idx[ref] > max_temporal_idx)
+        continue;
+      int pid_diff = static_cast<int>(kept_before[i]) -
+                     static_cast<int>(kept_before[ref]) + cycles * num_kept;
+      if (pid_diff <= 0 || pid_diff > 0xFF)
+        continue;
+      filtered.pid_diff[n][filtered.num_ref_pics[n]++] =
+          static_cast<uint8_t>(pid_diff);
+    }
+    ++n;
+  }
+  return filtered;
+}
 }  // namespace
 
 
@@ -482,12 +584,19 @@ RtpPacketizerVp9::RtpPacketizerVp9(const RTPVideoHeaderVP9& hdr,
     : hdr_(hdr),
       max_payload_length_(max_payload_length),
       payload_(nullptr),
-      payload_size_(0) {
+      payload_size_(0),
+      next_packet_(0) {
 }
 
 RtpPacketizerVp9::~RtpPacketizerVp9() {
 }
 
+void RtpPacketizerVp9::SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                                      FrameType frame_type) {
+  assert(rtp_type_header != NULL);
+  hdr_ = rtp_type_header->VP9;
+}
+
 ProtectionType RtpPacketizerVp9::GetProtectionType() {
   bool protect =
       hdr_.temporal_idx == 0 || hdr_.temporal_idx == kNoTemporalIdx;
@@ -516,6 +625,8 @@ void RtpPacketizerVp9::SetPayloadData(
     const RTPFragmentationHeader* fragmentation) {
   payload_ = payload;
   payload_size_ = payload_size;
+  packets_.clear();
+  next_packet_ = 0;
   GeneratePackets();
 }
 
@@ -534,8 +645,7 @@ void RtpPacketizerVp9::GeneratePackets() {
     size_t packet_bytes = CalcNextSize(rem_payload_len, rem_bytes);
     if (packet_bytes == 0) {
       LOG(LS_ERROR) << "Failed to generate VP9 packets.";
-      while (!packets_.empty())
-        packets_.pop();
+      packets_.clear();
       return;
     }
     QueuePacket(bytes_processed, packet_bytes, bytes_processed == 0,
@@ -548,18 +658,18 @@ void RtpPacketizerVp9::GeneratePackets() {
 bool RtpPacketizerVp9::NextPacket(uint8_t* buffer,
                                   size_t* bytes_to_send,
                                   bool* last_packet) {
-  if (packets_.empty()) {
+  if (next_packet_ == packets_.size()) {
     return false;
   }
-  PacketInfo packet_info = packets_.front();
-  packets_.pop();
+  const PacketInfo& packet_info = packets_[next_packet_++];
 
   if (!WriteHeaderAndPayload(packet_info, buffer, bytes_to_send)) {
     return false;
   }
   *last_packet =
-      packets_.empty() && (hdr_.spatial_idx == kNoSpatialIdx ||
-                           hdr_.spatial_idx == hdr_.num_spatial_layers - 1);
+      next_packet_ == packets_.size() &&
+      (hdr_.spatial_idx == kNoSpatialIdx ||
+       hdr_.spatial_idx == hdr_.num_spatial_layers - 1);
   return true;
 }
 
@@ -617,50 +727,9 @@ bool RtpPacketizerVp9::WriteHeaderAndPayload(const PacketInfo& packet_info,
 bool RtpPacketizerVp9::WriteHeader(const PacketInfo& packet_info,
                                    uint8_t* buffer,
                                    size_t* header_length) const {
-  // Required payload descriptor byte.
-  bool i_bit = PictureIdPresent(hdr_);
-  bool p_bit = hdr_.inter_pic_predicted;
-  bool l_bit = LayerInfoPresent(hdr_);
-  bool f_bit = hdr_.flexible_mode;
-  bool b_bit = packet_info.layer_begin;
-  bool e_bit = packet_info.layer_end;
-  bool v_bit = hdr_.ss_data_available && b_bit;
-
-  rtc::BitBufferWriter writer(buffer, max_payload_length_);
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(i_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(p_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(l_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(f_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(b_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(e_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(v_bit ? 1 : 0, 1));
-  RETURN_FALSE_ON_ERROR(writer.WriteBits(kReservedBitValue0, 1));
-
-  // Add fields that are present.
-  if (i_bit && !WritePictureId(hdr_, &writer)) {
-    LOG(LS_ERROR) << "Failed writing VP9 picture id.";
-    return false;
-  }
-  if (l_bit && !WriteLayerInfo(hdr_, &writer)) {
-    LOG(LS_ERROR) << "Failed writing VP9 layer info.";
-    return false;
-  }
-  if (p_bit && f_bit && !WriteRefIndices(hdr_, &writer)) {
-    LOG(LS_ERROR) << "Failed writing VP9 ref indices.";
-    return false;
-  }
-  if (v_bit && !WriteSsData(hdr_, &writer)) {
-    LOG(LS_ERROR) << "Failed writing VP9 SS data.";
-    return false;
-  }
-
-  size_t offset_bytes = 0;
-  size_t offset_bits = 0;
-  writer.GetCurrentOffset(&offset_bytes, &offset_bits);
-  assert(offset_bits == 0);
-
-  *header_length = offset_bytes;
-  return true;
+  return WritePayloadDescriptor(hdr_, packet_info.layer_begin,
+                                packet_info.layer_end, buffer,
+                                max_payload_length_, header_length);
 }
 
 bool RtpDepacketizerVp9::Parse(ParsedPayload* parsed_payload,
@@ -740,4 +809,201 @@ bool RtpDepacketizerVp9::Parse(ParsedPayload* parsed_payload,
 
   return true;
 }
+
+RtpVp9LayerSelector::RtpVp9LayerSelector()
+    : target_spatial_idx_(kMaxVp9NumberOfSpatialLayers - 1),
+      target_temporal_idx_(kNoTemporalIdx - 1),
+      spatial_idx_(target_spatial_idx_),
+      temporal_idx_(target_temporal_idx_),
+      has_picture_(false),
+      picture_id_(kNoPictureId),
+      picture_forwarded_(false),
+      dropped_pictures_(0),
+      dropped_packets_(0),
+      has_ss_(false),
+      ss_changed_(false) {
+  for (size_t i = 0; i < kPictureIdHistory; ++i)
+    picture_ids_[i] = kNoPictureId;
+  ss_.InitRTPVideoHeaderVP9();
+}
+
+RtpVp9LayerSelector::~RtpVp9LayerSelector() {
+}
+
+void RtpVp9LayerSelector::SetTargetLayers(uint8_t spatial_idx,
+                                          uint8_t temporal_idx) {
+  target_spatial_idx_ = spatial_idx;
+  target_temporal_idx_ = temporal_idx;
+}
+
+bool RtpVp9LayerSelector::RewritePacket(const uint8_t* packet,
+                                        size_t length,
+                                        uint8_t* buffer,
+                                        size_t max_length,
+                                        size_t* rewritten_length) {
+  RtpUtility::RtpHeaderParser rtp_parser(packet, length);
+  RTPHeader header;
+  if (!rtp_parser.Parse(&header))
+    return false;
+  const size_t header_length = header.headerLength;
+  const size_t payload_length =
+      length - header.headerLength - header.paddingLength;
+  if (max_length < header_length)
+    return false;
+  memcpy(buffer, packet, header_length);
+
+  // Padding-only packets carry no layer; just keep their sequence numbers in
+  // line.
+  if (payload_length == 0) {
+    if (max_length < length)
+      return false;
+    memcpy(buffer + header_length, packet + header_length,
+           length - header_length);
+    ByteWriter<uint16_t>::WriteBigEndian(
+        buffer + 2, header.sequenceNumber - dropped_packets_);
+    *rewritten_length = length;
+    return true;
+  }
+
+  RtpDepacketizerVp9 depacketizer;
+  RtpDepacketizer::ParsedPayload parsed;
+  if (!depacketizer.Parse(&parsed, packet + header_length, payload_length)) {
+    LOG(LS_WARNING) << "Dropping VP9 packet that failed to parse.";
+    ++dropped_packets_;
+    return false;
+  }
+  RTPVideoHeaderVP9 vp9 = parsed.type.Video.codecHeader.VP9;
+  const uint8_t spatial_idx = vp9.spatial_idx;
+  if (vp9.ss_data_available) {
+    ss_ = vp9;
+    has_ss_ = true;
+    ss_changed_ = true;
+  }
+
+  bool new_picture =
+      !has_picture_ ||
+      (vp9.picture_id != kNoPictureId
+           ? vp9.picture_id != picture_id_
+           : vp9.beginning_of_frame && spatial_idx == 0);
+  if (new_picture)
+    OnNewPicture(vp9);
+
+  if (picture_forwarded_ && spatial_idx == spatial_idx_ + 1 &&
+      spatial_idx <= target_spatial_idx_ && vp9.beginning_of_frame &&
+      !vp9.inter_pic_predicted) {
+    // The layer frame only depends on the lower layers, which are forwarded.
+    spatial_idx_ = spatial_idx;
+    ss_changed_ = true;
+  }
+  if (!picture_forwarded_ || spatial_idx > spatial_idx_) {
+    ++dropped_packets_;
+    return false;
+  }
+
+  if (vp9.picture_id != kNoPictureId) {
+    vp9.picture_id = RewrittenPictureId(vp9.picture_id);
+    if (vp9.flexible_mode && vp9.inter_pic_predicted) {
+      uint8_t num_ref_pics = 0;
+      for (uint8_t i = 0; i < vp9.num_ref_pics; ++i) {
+        int16_t ref = RewrittenPictureId(vp9.ref_picture_id[i]);
+        if (ref == kNoPictureId)
+          continue;
+        vp9.pid_diff[num_ref_pics] =
+            (vp9.picture_id - ref) & vp9.max_picture_id;
+        vp9.ref_picture_id[num_ref_pics++] = ref;
+      }
+      if (num_ref_pics == 0) {
+        LOG(LS_WARNING) << "Dropping VP9 layer frame whose references were "
+                        << "all dropped.";
+        ++dropped_packets_;
+        return false;
+      }
+      vp9.num_ref_pics = num_ref_pics;
+    }
+  }
+  // SS data goes in the first packet of a picture.
+  vp9.ss_data_available = false;
+  if (vp9.beginning_of_frame && spatial_idx == 0 && has_ss_ && ss_changed_) {
+    GetForwardedSsData(&vp9);
+    vp9.ss_data_available = true;
+    ss_changed_ = false;
+  }
+
+  size_t descriptor_length;
+  if (!WritePayloadDescriptor(vp9, vp9.beginning_of_frame, vp9.end_of_frame,
+                              buffer + header_length,
+                              max_length - header_length,
+                              &descriptor_length) ||
+      header_length + descriptor_length + parsed.payload_length > max_length) {
+    LOG(LS_WARNING) << "Rewritten VP9 packet doesn't fit.";
+    ++dropped_packets_;
+    return false;
+  }
+  memcpy(buffer + header_length + descriptor_length, parsed.payload,
+         parsed.payload_length);
+
+  // The padding is dropped, and the marker bit moves to the last packet of
+  // the highest forwarded layer.
+  buffer[0] &= ~0x20;
+  if (header.markerBit || (vp9.end_of_frame && spatial_idx == spatial_idx_))
+    buffer[1] |= 0x80;
+  ByteWriter<uint16_t>::WriteBigEndian(
+      buffer + 2, header.sequenceNumber - dropped_packets_);
+  *rewritten_length =
+      header_length + descriptor_length + parsed.payload_length;
+  return true;
+}
+
+void RtpVp9LayerSelector::OnNewPicture(const RTPVideoHeaderVP9& vp9) {
+  const uint8_t temporal_idx =
+      vp9.temporal_idx == kNoTemporalIdx ? 0 : vp9.temporal_idx;
+  const bool key_picture = !vp9.inter_pic_predicted && vp9.spatial_idx == 0;
+  const uint8_t old_spatial_idx = spatial_idx_;
+  const uint8_t old_temporal_idx = temporal_idx_;
+
+  if (key_picture || target_spatial_idx_ < spatial_idx_)
+    spatial_idx_ = target_spatial_idx_;
+  if (key_picture || target_temporal_idx_ < temporal_idx_) {
+    temporal_idx_ = target_temporal_idx_;
+  } else if (temporal_idx > temporal_idx_ &&
+             temporal_idx <= target_temporal_idx_ &&
+             vp9.temporal_up_switch) {
+    temporal_idx_ = temporal_idx;
+  }
+  if (spatial_idx_ != old_spatial_idx || temporal_idx_ != old_temporal_idx)
+    ss_changed_ = true;
+
+  has_picture_ = true;
+  picture_id_ = vp9.picture_id;
+  picture_forwarded_ = temporal_idx <= temporal_idx_;
+  if (vp9.picture_id == kNoPictureId)
+    return;
+  size_t index = vp9.picture_id % kPictureIdHistory;
+  if (picture_forwarded_) {
+    picture_ids_[index] = vp9.picture_id;
+    rewritten_picture_ids_[index] =
+        (vp9.picture_id - dropped_pictures_) & vp9.max_picture_id;
+  } else {
+    picture_ids_[index] = kNoPictureId;
+    ++dropped_pictures_;
+  }
+}
+
+int16_t RtpVp9LayerSelector::RewrittenPictureId(int16_t picture_id) const {
+  size_t index = picture_id % kPictureIdHistory;
+  return picture_ids_[index] == picture_id ? rewritten_picture_ids_[index]
+                                           : kNoPictureId;
+}
+
+void RtpVp9LayerSelector::GetForwardedSsData(RTPVideoHeaderVP9* ss) const {
+  ss->num_spatial_layers =
+      std::min<size_t>(ss_.num_spatial_layers, spatial_idx_ + 1);
+  ss->spatial_layer_resolution_present = ss_.spatial_layer_resolution_present;
+  for (size_t i = 0; i < ss->num_spatial_layers; ++i) {
+    ss->width[i] = ss_.width[i];
+    ss->height[i] = ss_.height[i];
+  }
+  ss->gof = FilterGof(ss_.gof, temporal_idx_);
+}
+
 }  // namespace webrtc
@@ -21,8 +21,8 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP9_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP9_H_
 
-#include <queue>
 #include <string>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -37,6 +37,9 @@ class RtpPacketizerVp9 : public RtpPacketizer {
 
   virtual ~RtpPacketizerVp9();
 
+  void SetVideoHeader(const RTPVideoTypeHeader* rtp_type_header,
+                      FrameType frame_type) override;
+
   ProtectionType GetProtectionType() override;
 
   StorageType GetStorageType(uint32_t retransmission_settings) override;
@@ -65,7 +68,7 @@ class RtpPacketizerVp9 : public RtpPacketizer {
     bool layer_begin;
     bool layer_end;
   } PacketInfo;
-  typedef std::queue<PacketInfo> PacketInfoQueue;
+  typedef std::vector<PacketInfo> PacketInfoVector;
 
  private:
   // Calculates all packet sizes and loads info to packet queue.
@@ -85,11 +88,15 @@ class RtpPacketizerVp9 : public RtpPacketizer {
                    uint8_t* buffer,
                    size_t* header_length) const;
 
-  const RTPVideoHeaderVP9 hdr_;
+  RTPVideoHeaderVP9 hdr_;
   const size_t max_payload_length_;  // The max length in bytes of one packet.
   const uint8_t* payload_;           // The payload data to be packetized.
   size_t payload_size_;              // The size in bytes of the payload data.
-  PacketInfoQueue packets_;
+  // The packets of the current frame, of which the ones from |next_packet_|
+  // on are still to be sent. Kept between frames so that the storage is
+  // reused.
+  PacketInfoVector packets_;
+  size_t next_packet_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketizerVp9);
 };
@@ -104,5 +111,80 @@ class RtpDepacketizerVp9 : public RtpDepacketizer {
              size_t payload_length) override;
 };
 
+// Forwards a subset of the spatial and temporal layers of a VP9 SVC stream to
+// one receiver, e.g. in an SFU, without re-encoding. An instance is used per
+// receiver and stream. Packets of layers above the selected ones are dropped,
+// and the others are rewritten so that the receiver sees a consistent stream:
+// sequence numbers and picture ids have no gaps, P_DIFFs refer to the new
+// picture ids, the marker bit is set on the last forwarded packet of every
+// picture and the SS data only describes the forwarded layers.
+//
+// Layer changes take effect at switching points: lower layers at the next
+// picture, a higher spatial layer at a key picture or at a layer frame that
+// isn't inter-picture predicted, and a higher temporal layer at a key
+// picture or at a picture of that layer with the U bit set.
+// Packets are expected to arrive in order; reordered ones are rewritten
+// according to the state at the time they arrive.
+class RtpVp9LayerSelector {
+ public:
+  RtpVp9LayerSelector();
+  ~RtpVp9LayerSelector();
+
+  // Sets the highest spatial and temporal layers to forward. All layers are
+  // forwarded by default.
+  void SetTargetLayers(uint8_t spatial_idx, uint8_t temporal_idx);
+
+  // The highest layers currently being forwarded.
+  uint8_t spatial_idx() const { return spatial_idx_; }
+  uint8_t temporal_idx() const { return temporal_idx_; }
+
+  // Returns false if the RTP packet |packet| is to be dropped. Otherwise
+  // writes the packet to forward to |buffer|, which has room for |max_length|
+  // bytes, and its length to |rewritten_length|. The rewritten packet can be
+  // a few bytes longer than |packet| when SS data has to be added.
+  bool RewritePacket(const uint8_t* packet,
+                     size_t length,
+                     uint8_t* buffer,
+                     size_t max_length,
+                     size_t* rewritten_length);
+
+ private:
+  // Picture ids that forwarded pictures were given, for rewriting P_DIFFs.
+  // P_DIFF is 7 bits, so older pictures can't be referenced.
+  static const size_t kPictureIdHistory = 128;
+
+  // Updates the forwarded layers and the picture state at the start of a new
+  // picture.
+  void OnNewPicture(const RTPVideoHeaderVP9& vp9);
+  // Returns the picture id that picture |picture_id| was forwarded with, or
+  // kNoPictureId if it wasn't forwarded.
+  int16_t RewrittenPictureId(int16_t picture_id) const;
+  // Sets |ss| to the SS data of the forwarded layers.
+  void GetForwardedSsData(RTPVideoHeaderVP9* ss) const;
+
+  uint8_t target_spatial_idx_;
+  uint8_t target_temporal_idx_;
+  uint8_t spatial_idx_;
+  uint8_t temporal_idx_;
+
+  bool has_picture_;
+  int16_t picture_id_;
+  bool picture_forwarded_;
+  // Number of pictures and packets dropped so far, which later picture ids
+  // and sequence numbers are shifted by.
+  uint16_t dropped_pictures_;
+  uint16_t dropped_packets_;
+  int16_t picture_ids_[kPictureIdHistory];
+  int16_t rewritten_picture_ids_[kPictureIdHistory];
+
+  // The last SS data received, and whether it, or the forwarded layers, have
+  // changed since SS data was last forwarded.
+  bool has_ss_;
+  RTPVideoHeaderVP9 ss_;
+  bool ss_changed_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpVp9LayerSelector);
+};
+
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP9_H_
@@ -12,7 +12,9 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_format_vp9.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -206,6 +208,35 @@ TEST_F(RtpPacketizerVp9Test, TestEqualSizedMode_TwoPackets) {
   CreateParseAndCheckPackets(kExpectedHdrSizes, kExpectedSizes, kExpectedNum);
 }
 
+TEST_F(RtpPacketizerVp9Test, TestReusedForNextFrame) {
+  const size_t kFrameSize = 27;
+  const size_t kPacketSize = 27;
+  Init(kFrameSize, kPacketSize);
+  // Leave the second packet of the first frame unsent.
+  size_t length = 0;
+  bool last = false;
+  EXPECT_TRUE(packetizer_->NextPacket(packet_.get(), &length, &last));
+  EXPECT_FALSE(last);
+
+  // The next frame has a header of its own.
+  // I:0, P:0, L:1, F:1, B:1, E:1, V:0 (2hdr + 10 payload)
+  // L:   T:1, U:0, S:0, D:0
+  expected_.flexible_mode = true;
+  expected_.temporal_idx = 1;
+  RTPVideoTypeHeader type_header;
+  type_header.VP9 = expected_;
+  packetizer_->SetVideoHeader(&type_header, kVideoFrameDelta);
+  payload_size_ = 10;
+  payload_pos_ = 0;
+  packetizer_->SetPayloadData(payload_.get(), payload_size_, NULL);
+  EXPECT_EQ(kUnprotectedPacket, packetizer_->GetProtectionType());
+
+  const size_t kExpectedHdrSizes[] = {2};
+  const size_t kExpectedSizes[] = {12};
+  const size_t kExpectedNum = GTEST_ARRAY_SIZE_(kExpectedSizes);
+  CreateParseAndCheckPackets(kExpectedHdrSizes, kExpectedSizes, kExpectedNum);
+}
+
 TEST_F(RtpPacketizerVp9Test, TestTooShortBufferToFitPayload) {
   const size_t kFrameSize = 1;
   const size_t kPacketSize = 1;
@@ -687,4 +718,211 @@ TEST_F(RtpDepacketizerVp9Test, ParseFailsForTooShortBufferToFitPayload) {
   EXPECT_FALSE(depacketizer_->Parse(&parsed, packet, sizeof(packet)));
 }
 
+class RtpVp9LayerSelectorTest : public ::testing::Test {
+ protected:
+  static const size_t kRtpHeaderLength = 12;
+  static const size_t kMaxPacketLength = 1200;
+
+  struct ForwardedPacket {
+    uint16_t sequence_number;
+    bool marker;
+    RTPVideoHeaderVP9 vp9;
+  };
+
+  RtpVp9LayerSelectorTest() : sequence_number_(1000) {}
+
+  // Sends a layer frame that fits one packet through the selector. Returns
+  // false if it was dropped, and fills in |forwarded| otherwise.
+  bool SendLayerFrame(const RTPVideoHeaderVP9& hdr,
+                      bool marker,
+                      ForwardedPacket* forwarded) {
+    const uint8_t kPayload[] = {1, 2, 3, 4, 5};
+    RtpPacketizerVp9 packetizer(hdr, kMaxPacketLength - kRtpHeaderLength);
+    packetizer.SetPayloadData(kPayload, sizeof(kPayload), nullptr);
+    uint8_t packet[kMaxPacketLength] = {0};
+    size_t payload_length;
+    bool last;
+    EXPECT_TRUE(packetizer.NextPacket(packet + kRtpHeaderLength,
+                                      &payload_length, &last));
+    packet[0] = 0x80;
+    packet[1] = (marker ? 0x80 : 0) | 96;
+    ByteWriter<uint16_t>::WriteBigEndian(packet + 2, sequence_number_++);
+    ByteWriter<uint32_t>::WriteBigEndian(packet + 8, 0x12345678);
+
+    uint8_t rewritten[kMaxPacketLength];
+    size_t rewritten_length;
+    if (!selector_.RewritePacket(packet, kRtpHeaderLength + payload_length,
+                                 rewritten, sizeof(rewritten),
+                                 &rewritten_length)) {
+      return false;
+    }
+    RtpUtility::RtpHeaderParser rtp_parser(rewritten, rewritten_length);
+    RTPHeader header;
+    EXPECT_TRUE(rtp_parser.Parse(&header));
+    forwarded->sequence_number = header.sequenceNumber;
+    forwarded->marker = header.markerBit;
+    RtpDepacketizerVp9 depacketizer;
+    RtpDepacketizer::ParsedPayload parsed;
+    EXPECT_TRUE(depacketizer.Parse(&parsed, rewritten + header.headerLength,
+                                   rewritten_length - header.headerLength));
+    EXPECT_EQ(sizeof(kPayload), parsed.payload_length);
+    forwarded->vp9 = parsed.type.Video.codecHeader.VP9;
+    return true;
+  }
+
+  static RTPVideoHeaderVP9 LayerFrame(int16_t picture_id,
+                                      uint8_t spatial_idx,
+                                      uint8_t temporal_idx) {
+    RTPVideoHeaderVP9 hdr;
+    hdr.InitRTPVideoHeaderVP9();
+    hdr.picture_id = picture_id;
+    hdr.spatial_idx = spatial_idx;
+    hdr.temporal_idx = temporal_idx;
+    hdr.tl0_pic_idx = 0;
+    hdr.inter_pic_predicted = picture_id > 0 || spatial_idx > 0;
+    hdr.inter_layer_predicted = spatial_idx > 0;
+    return hdr;
+  }
+
+  uint16_t sequence_number_;
+  RtpVp9LayerSelector selector_;
+};
+
+TEST_F(RtpVp9LayerSelectorTest, ForwardsAllLayersByDefault) {
+  ForwardedPacket forwarded;
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(0, 0, 0), false, &forwarded));
+  EXPECT_EQ(1000, forwarded.sequence_number);
+  EXPECT_FALSE(forwarded.marker);
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(0, 1, 0), true, &forwarded));
+  EXPECT_EQ(1001, forwarded.sequence_number);
+  EXPECT_TRUE(forwarded.marker);
+  EXPECT_EQ(1, forwarded.vp9.spatial_idx);
+  EXPECT_EQ(0, forwarded.vp9.picture_id);
+}
+
+TEST_F(RtpVp9LayerSelectorTest, DropsHigherSpatialLayers) {
+  selector_.SetTargetLayers(0, kNoTemporalIdx);
+  ForwardedPacket forwarded;
+  RTPVideoHeaderVP9 key = LayerFrame(0, 0, 0);
+  key.ss_data_available = true;
+  key.num_spatial_layers = 2;
+  key.spatial_layer_resolution_present = true;
+  key.width[0] = 320;
+  key.height[0] = 180;
+  key.width[1] = 640;
+  key.height[1] = 360;
+  key.gof.SetGofInfoVP9(kTemporalStructureMode1);
+  EXPECT_TRUE(SendLayerFrame(key, false, &forwarded));
+  EXPECT_TRUE(forwarded.marker);
+  ASSERT_TRUE(forwarded.vp9.ss_data_available);
+  EXPECT_EQ(1U, forwarded.vp9.num_spatial_layers);
+  EXPECT_EQ(320, forwarded.vp9.width[0]);
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(0, 1, 0), true, &forwarded));
+
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(1, 0, 0), false, &forwarded));
+  EXPECT_EQ(1001, forwarded.sequence_number);
+  EXPECT_EQ(1, forwarded.vp9.picture_id);
+  EXPECT_TRUE(forwarded.marker);
+  EXPECT_FALSE(forwarded.vp9.ss_data_available);
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(1, 1, 0), true, &forwarded));
+}
+
+TEST_F(RtpVp9LayerSelectorTest, DropsHigherTemporalLayers) {
+  selector_.SetTargetLayers(0, 1);
+  ForwardedPacket forwarded;
+  // Temporal layers 0-2-1-2.
+  RTPVideoHeaderVP9 key = LayerFrame(0, 0, 0);
+  key.ss_data_available = true;
+  key.gof.SetGofInfoVP9(kTemporalStructureMode3);
+  EXPECT_TRUE(SendLayerFrame(key, true, &forwarded));
+  // The SS data describes the 0-1 structure the receiver gets.
+  ASSERT_TRUE(forwarded.vp9.ss_data_available);
+  ASSERT_EQ(2U, forwarded.vp9.gof.num_frames_in_gof);
+  EXPECT_EQ(0, forwarded.vp9.gof.temporal_idx[0]);
+  EXPECT_EQ(1, forwarded.vp9.gof.num_ref_pics[0]);
+  EXPECT_EQ(2, forwarded.vp9.gof.pid_diff[0][0]);
+  EXPECT_EQ(1, forwarded.vp9.gof.temporal_idx[1]);
+  EXPECT_EQ(1, forwarded.vp9.gof.num_ref_pics[1]);
+  EXPECT_EQ(1, forwarded.vp9.gof.pid_diff[1][0]);
+
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(1, 0, 2), true, &forwarded));
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(2, 0, 1), true, &forwarded));
+  EXPECT_EQ(1001, forwarded.sequence_number);
+  EXPECT_EQ(1, forwarded.vp9.picture_id);
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(3, 0, 2), true, &forwarded));
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(4, 0, 0), true, &forwarded));
+  EXPECT_EQ(1002, forwarded.sequence_number);
+  EXPECT_EQ(2, forwarded.vp9.picture_id);
+}
+
+TEST_F(RtpVp9LayerSelectorTest, SwitchesUpTemporallyAtUpSwitchPoints) {
+  selector_.SetTargetLayers(0, 0);
+  ForwardedPacket forwarded;
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(0, 0, 0), true, &forwarded));
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(1, 0, 1), true, &forwarded));
+
+  selector_.SetTargetLayers(0, 1);
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(2, 0, 0), true, &forwarded));
+  // Not a switching point.
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(3, 0, 1), true, &forwarded));
+  EXPECT_EQ(0, selector_.temporal_idx());
+  RTPVideoHeaderVP9 up_switch = LayerFrame(5, 0, 1);
+  up_switch.temporal_up_switch = true;
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(4, 0, 0), true, &forwarded));
+  EXPECT_TRUE(SendLayerFrame(up_switch, true, &forwarded));
+  EXPECT_EQ(1, selector_.temporal_idx());
+  EXPECT_EQ(3, forwarded.vp9.picture_id);
+  EXPECT_EQ(1003, forwarded.sequence_number);
+}
+
+TEST_F(RtpVp9LayerSelectorTest, SwitchesUpSpatiallyAtSwitchingPoints) {
+  selector_.SetTargetLayers(0, kNoTemporalIdx);
+  ForwardedPacket forwarded;
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(0, 0, 0), false, &forwarded));
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(0, 1, 0), true, &forwarded));
+
+  selector_.SetTargetLayers(1, kNoTemporalIdx);
+  // Inter-picture predicted from a layer frame the receiver didn't get.
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(1, 0, 0), false, &forwarded));
+  EXPECT_TRUE(forwarded.marker);
+  EXPECT_FALSE(SendLayerFrame(LayerFrame(1, 1, 0), true, &forwarded));
+
+  // Only predicted from the lower layer.
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(2, 0, 0), false, &forwarded));
+  RTPVideoHeaderVP9 switching_point = LayerFrame(2, 1, 0);
+  switching_point.inter_pic_predicted = false;
+  EXPECT_TRUE(SendLayerFrame(switching_point, true, &forwarded));
+  EXPECT_EQ(1, selector_.spatial_idx());
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(3, 0, 0), false, &forwarded));
+  EXPECT_FALSE(forwarded.marker);
+  EXPECT_TRUE(SendLayerFrame(LayerFrame(3, 1, 0), true, &forwarded));
+  EXPECT_TRUE(forwarded.marker);
+  EXPECT_EQ(1005, forwarded.sequence_number);
+}
+
+TEST_F(RtpVp9LayerSelectorTest, RewritesRefIndicesInFlexibleMode) {
+  selector_.SetTargetLayers(0, 0);
+  ForwardedPacket forwarded;
+  RTPVideoHeaderVP9 hdr = LayerFrame(10, 0, 0);
+  hdr.flexible_mode = true;
+  hdr.inter_pic_predicted = false;
+  EXPECT_TRUE(SendLayerFrame(hdr, true, &forwarded));
+
+  hdr = LayerFrame(11, 0, 1);
+  hdr.flexible_mode = true;
+  hdr.num_ref_pics = 1;
+  hdr.pid_diff[0] = 1;
+  EXPECT_FALSE(SendLayerFrame(hdr, true, &forwarded));
+
+  hdr = LayerFrame(12, 0, 0);
+  hdr.flexible_mode = true;
+  hdr.num_ref_pics = 1;
+  hdr.pid_diff[0] = 2;
+  EXPECT_TRUE(SendLayerFrame(hdr, true, &forwarded));
+  EXPECT_EQ(11, forwarded.vp9.picture_id);
+  ASSERT_EQ(1, forwarded.vp9.num_ref_pics);
+  EXPECT_EQ(1, forwarded.vp9.pid_diff[0]);
+  EXPECT_EQ(10, forwarded.vp9.ref_picture_id[0]);
+}
+
 }  // namespace webrtc
@@ -109,8 +109,14 @@ class RtpHeaderExtensionMap {
   RTPExtensionType Next(RTPExtensionType type) const;
 
  private:
+  static const uint8_t kMaxId = 14;
+
   int32_t Register(const RTPExtensionType type, const uint8_t id, bool active);
   std::map<uint8_t, HeaderExtension*> extensionMap_;
+  // Type registered for each id, kRtpExtensionNone if the id is free. Kept in
+  // sync with |extensionMap_| so that GetType(), which the RTP header parser
+  // calls for every extension element of every packet, is a table lookup.
+  RTPExtensionType types_[kMaxId + 1];
 };
 }  // namespace webrtc
 
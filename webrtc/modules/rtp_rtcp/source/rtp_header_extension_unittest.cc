@@ -96,6 +96,10 @@ TEST_F(RtpHeaderExtensionTest, GetType) {
   EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
   EXPECT_EQ(0, map_.GetType(kId, &typeOut));
   EXPECT_EQ(kRtpExtensionTransmissionTimeOffset, typeOut);
+
+  EXPECT_EQ(0, map_.Deregister(kRtpExtensionTransmissionTimeOffset));
+  EXPECT_EQ(-1, map_.GetType(kId, &typeOut));
+  EXPECT_EQ(-1, map_.GetType(15, &typeOut));
 }
 
 TEST_F(RtpHeaderExtensionTest, GetId) {
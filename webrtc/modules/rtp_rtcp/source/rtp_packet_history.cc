@@ -26,12 +26,18 @@
 namespace webrtc {
 
 static const int kMinPacketRequestBytes = 50;
+static const uint16_t kNoIndex = 0xFFFF;
+static const size_t kMaxArenaSize = kMaxHistoryCapacity * IP_PACKET_SIZE;
 
 RTPPacketHistory::RTPPacketHistory(Clock* clock)
     : clock_(clock),
       critsect_(CriticalSectionWrapper::CreateCriticalSection()),
       store_(false),
-      prev_index_(0) {}
+      sized_by_window_(false),
+      max_age_ms_(0),
+      oldest_index_(0),
+      num_stored_(0),
+      arena_head_(0) {}
 
 RTPPacketHistory::~RTPPacketHistory() {
 }
@@ -42,20 +48,50 @@ void RTPPacketHistory::SetStorePacketsStatus(bool enable,
   if (enable) {
     if (store_) {
       LOG(LS_WARNING) << "Purging packet history in order to re-set status.";
-      Free();
+      Clear();
     }
-    assert(!store_);
-    Allocate(number_to_store);
+    sized_by_window_ = false;
+    max_age_ms_ = 0;
+    Allocate(number_to_store, number_to_store * IP_PACKET_SIZE);
   } else {
     Free();
   }
 }
 
-void RTPPacketHistory::Allocate(size_t number_to_store) {
+void RTPPacketHistory::SetStorePacketsWindow(size_t max_bytes,
+                                             int64_t max_age_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  RTC_DCHECK_GE(max_age_ms, 0);
+  if (store_) {
+    LOG(LS_WARNING) << "Purging packet history in order to re-set status.";
+    Clear();
+  }
+  sized_by_window_ = true;
+  max_age_ms_ = max_age_ms;
+  // There must be room for at least one packet of any size.
+  max_bytes = std::max(std::min(max_bytes, kMaxArenaSize),
+                       static_cast<size_t>(IP_PACKET_SIZE));
+  // More slots are added as needed, since the packets may be much smaller.
+  Allocate(max_bytes / IP_PACKET_SIZE, max_bytes);
+}
+
+void RTPPacketHistory::Allocate(size_t number_to_store, size_t arena_size) {
   assert(number_to_store > 0);
   assert(number_to_store <= kMaxHistoryCapacity);
+  assert(num_stored_ == 0);
   store_ = true;
+  // None of these reallocate if the history was already this large.
   stored_packets_.resize(number_to_store);
+  arena_.resize(arena_size);
+  seq_index_.resize(1 << 16, kNoIndex);
+  oldest_index_ = 0;
+  arena_head_ = 0;
+}
+
+void RTPPacketHistory::Clear() {
+  while (num_stored_ > 0) {
+    DropOldestPacket();
+  }
 }
 
 void RTPPacketHistory::Free() {
@@ -63,10 +99,16 @@ void RTPPacketHistory::Free() {
     return;
   }
 
-  stored_packets_.clear();
+  std::vector<StoredPacket>().swap(stored_packets_);
+  std::vector<uint8_t>().swap(arena_);
+  std::vector<uint16_t>().swap(seq_index_);
 
   store_ = false;
-  prev_index_ = 0;
+  sized_by_window_ = false;
+  max_age_ms_ = 0;
+  oldest_index_ = 0;
+  num_stored_ = 0;
+  arena_head_ = 0;
 }
 
 bool RTPPacketHistory::StorePackets() const {
@@ -74,6 +116,12 @@ bool RTPPacketHistory::StorePackets() const {
   return store_;
 }
 
+size_t RTPPacketHistory::MemoryUsage() const {
+  CriticalSectionScoped cs(critsect_.get());
+  return stored_packets_.capacity() * sizeof(StoredPacket) +
+         arena_.capacity() + seq_index_.capacity() * sizeof(uint16_t);
+}
+
 int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
                                        size_t packet_length,
                                        int64_t capture_time_ms,
@@ -93,41 +141,142 @@ int32_t RTPPacketHistory::PutRTPPacket(const uint8_t* packet,
   }
 
   const uint16_t seq_num = (packet[2] << 8) + packet[3];
+  const int64_t now = clock_->TimeInMilliseconds();
 
-  // If index we're about to overwrite contains a packet that has not
-  // yet been sent (probably pending in paced sender), we need to expand
-  // the buffer.
-  if (stored_packets_[prev_index_].length > 0 &&
-      stored_packets_[prev_index_].send_time == 0) {
-    size_t current_size = static_cast<uint16_t>(stored_packets_.size());
-    if (current_size < kMaxHistoryCapacity) {
-      size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
-      expanded_size = std::min(expanded_size, kMaxHistoryCapacity);
-      Allocate(expanded_size);
-      // Causes discontinuity, but that's OK-ish. FindSeqNum() will still work,
-      // but may be slower - at least until buffer has wrapped around once.
-      prev_index_ = current_size;
+  if (max_age_ms_ > 0) {
+    DropExpiredPackets(now);
+  }
+
+  // Make room for the packet by dropping the oldest ones. If the oldest
+  // packet has not yet been sent (probably pending in paced sender), we need
+  // to expand the history instead.
+  while (num_stored_ == stored_packets_.size()) {
+    if (!ExpandPackets()) {
+      DropOldestPacket();
+    }
+  }
+  size_t offset = 0;
+  while (!FindFreeSlot(packet_length, &offset)) {
+    if (!ExpandArena()) {
+      DropOldestPacket();
     }
   }
 
   // Store packet
   // TODO(sprang): Overhaul this class and get rid of this copy step.
   //               (Finally introduce the RtpPacket class?)
-  memcpy(stored_packets_[prev_index_].data, packet, packet_length);
-  stored_packets_[prev_index_].length = packet_length;
+  size_t index = (oldest_index_ + num_stored_) % stored_packets_.size();
+  StoredPacket& stored_packet = stored_packets_[index];
+  memcpy(&arena_[offset], packet, packet_length);
+  stored_packet.offset = offset;
+  stored_packet.length = packet_length;
+
+  stored_packet.sequence_number = seq_num;
+  stored_packet.time_ms = (capture_time_ms > 0) ? capture_time_ms : now;
+  stored_packet.send_time = 0;  // Packet not sent.
+  stored_packet.storage_type = type;
+  stored_packet.has_been_retransmitted = false;
+
+  seq_index_[seq_num] = static_cast<uint16_t>(index);
+  ++num_stored_;
+  arena_head_ = offset + packet_length;
+  return 0;
+}
+
+bool RTPPacketHistory::ExpandPackets() {
+  size_t current_size = stored_packets_.size();
+  if (current_size >= kMaxHistoryCapacity) {
+    return false;
+  }
+  // A history sized by a window is only bounded by bytes and age.
+  if (!sized_by_window_ && stored_packets_[oldest_index_].send_time != 0) {
+    return false;
+  }
+  size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
+  expanded_size = std::min(expanded_size, kMaxHistoryCapacity);
+
+  // Move the packets to the start of the expanded ring, oldest first, so that
+  // the newest packet with a given sequence number ends up in the index.
+  std::vector<StoredPacket> expanded(expanded_size);
+  for (size_t i = 0; i < num_stored_; ++i) {
+    expanded[i] = stored_packets_[(oldest_index_ + i) % current_size];
+    seq_index_[expanded[i].sequence_number] = static_cast<uint16_t>(i);
+  }
+  stored_packets_.swap(expanded);
+  oldest_index_ = 0;
+  return true;
+}
 
-  stored_packets_[prev_index_].sequence_number = seq_num;
-  stored_packets_[prev_index_].time_ms =
-      (capture_time_ms > 0) ? capture_time_ms : clock_->TimeInMilliseconds();
-  stored_packets_[prev_index_].send_time = 0;  // Packet not sent.
-  stored_packets_[prev_index_].storage_type = type;
-  stored_packets_[prev_index_].has_been_retransmitted = false;
+bool RTPPacketHistory::ExpandArena() {
+  if (num_stored_ == 0 || arena_.size() >= kMaxArenaSize ||
+      stored_packets_[oldest_index_].send_time != 0) {
+    return false;
+  }
 
-  ++prev_index_;
-  if (prev_index_ >= stored_packets_.size()) {
-    prev_index_ = 0;
+  // Compact the packets at the start of the expanded arena.
+  std::vector<uint8_t> expanded(std::min(arena_.size() * 2, kMaxArenaSize));
+  size_t offset = 0;
+  for (size_t i = 0; i < num_stored_; ++i) {
+    StoredPacket& stored_packet =
+        stored_packets_[(oldest_index_ + i) % stored_packets_.size()];
+    memcpy(&expanded[offset], &arena_[stored_packet.offset],
+           stored_packet.length);
+    stored_packet.offset = offset;
+    offset += stored_packet.length;
   }
-  return 0;
+  arena_.swap(expanded);
+  arena_head_ = offset;
+  return true;
+}
+
+void RTPPacketHistory::DropOldestPacket() {
+  RTC_DCHECK_GT(num_stored_, 0u);
+  StoredPacket& oldest = stored_packets_[oldest_index_];
+  if (seq_index_[oldest.sequence_number] == oldest_index_) {
+    seq_index_[oldest.sequence_number] = kNoIndex;
+  }
+  oldest.length = 0;
+  oldest_index_ = (oldest_index_ + 1) % stored_packets_.size();
+  if (--num_stored_ == 0) {
+    arena_head_ = 0;
+  }
+}
+
+void RTPPacketHistory::DropExpiredPackets(int64_t now_ms) {
+  while (num_stored_ > 0) {
+    const StoredPacket& oldest = stored_packets_[oldest_index_];
+    if (oldest.send_time == 0 || now_ms - oldest.send_time <= max_age_ms_) {
+      return;
+    }
+    DropOldestPacket();
+  }
+}
+
+bool RTPPacketHistory::FindFreeSlot(size_t length, size_t* offset) const {
+  if (num_stored_ == 0) {
+    *offset = 0;
+    return length <= arena_.size();
+  }
+  size_t tail = stored_packets_[oldest_index_].offset;
+  if (tail < arena_head_) {
+    // There is free space after the newest packet and before the oldest one.
+    if (arena_.size() - arena_head_ >= length) {
+      *offset = arena_head_;
+      return true;
+    }
+    if (tail >= length) {
+      *offset = 0;
+      return true;
+    }
+    return false;
+  }
+  // The packets wrap around; the free space is between the newest packet and
+  // the oldest one.
+  if (tail - arena_head_ >= length) {
+    *offset = arena_head_;
+    return true;
+  }
+  return false;
 }
 
 bool RTPPacketHistory::HasRTPPacket(uint16_t sequence_number) const {
@@ -224,7 +373,7 @@ void RTPPacketHistory::GetPacket(int index,
                                  int64_t* stored_time_ms) const {
   // Get packet.
   size_t length = stored_packets_[index].length;
-  memcpy(packet, stored_packets_[index].data, length);
+  memcpy(packet, &arena_[stored_packets_[index].offset], length);
   *packet_length = length;
   *stored_time_ms = stored_packets_[index].time_ms;
 }
@@ -245,52 +394,27 @@ bool RTPPacketHistory::GetBestFittingPacket(uint8_t* packet,
 // private, lock should already be taken
 bool RTPPacketHistory::FindSeqNum(uint16_t sequence_number,
                                   int32_t* index) const {
-  uint16_t temp_sequence_number = 0;
-  if (prev_index_ > 0) {
-    *index = prev_index_ - 1;
-    temp_sequence_number = stored_packets_[*index].sequence_number;
-  } else {
-    *index = stored_packets_.size() - 1;
-    temp_sequence_number = stored_packets_[*index].sequence_number;  // wrap
-  }
-
-  int32_t idx = (prev_index_ - 1) - (temp_sequence_number - sequence_number);
-  if (idx >= 0 && idx < static_cast<int>(stored_packets_.size())) {
-    *index = idx;
-    temp_sequence_number = stored_packets_[*index].sequence_number;
-  }
-
-  if (temp_sequence_number != sequence_number) {
-    // We did not found a match, search all.
-    for (uint16_t m = 0; m < stored_packets_.size(); m++) {
-      if (stored_packets_[m].sequence_number == sequence_number) {
-        *index = m;
-        temp_sequence_number = stored_packets_[*index].sequence_number;
-        break;
-      }
-    }
-  }
-  if (temp_sequence_number == sequence_number) {
-    // We found a match.
-    return true;
+  uint16_t stored_index = seq_index_[sequence_number];
+  if (stored_index == kNoIndex) {
+    return false;
   }
-  return false;
+  *index = stored_index;
+  return stored_packets_[stored_index].length > 0 &&
+         stored_packets_[stored_index].sequence_number == sequence_number;
 }
 
 int RTPPacketHistory::FindBestFittingPacket(size_t size) const {
-  if (size < kMinPacketRequestBytes || stored_packets_.empty())
+  if (size < kMinPacketRequestBytes || num_stored_ == 0)
     return -1;
   size_t min_diff = std::numeric_limits<size_t>::max();
   int best_index = -1;  // Returned unchanged if we don't find anything.
-  for (size_t i = 0; i < stored_packets_.size(); ++i) {
-    if (stored_packets_[i].length == 0)
-      continue;
-    size_t diff = (stored_packets_[i].length > size)
-                      ? (stored_packets_[i].length - size)
-                      : (size - stored_packets_[i].length);
+  for (size_t i = 0; i < num_stored_; ++i) {
+    size_t index = (oldest_index_ + i) % stored_packets_.size();
+    size_t length = stored_packets_[index].length;
+    size_t diff = (length > size) ? (length - size) : (size - length);
     if (diff < min_diff) {
       min_diff = diff;
-      best_index = static_cast<int>(i);
+      best_index = static_cast<int>(index);
     }
   }
   return best_index;
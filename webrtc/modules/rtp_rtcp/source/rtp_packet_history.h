@@ -32,10 +32,22 @@ class RTPPacketHistory {
   explicit RTPPacketHistory(Clock* clock);
   ~RTPPacketHistory();
 
+  // Keeps at least the last |number_to_store| packets.
   void SetStorePacketsStatus(bool enable, uint16_t number_to_store);
 
+  // Enables storing, but sizes the history by a window rather than by a
+  // number of packets: sent packets are dropped once |max_bytes| of packet
+  // data are stored or once they were last sent more than |max_age_ms| ago
+  // (ignored if zero). Packets not yet sent are always kept, up to
+  // kMaxHistoryCapacity packets.
+  void SetStorePacketsWindow(size_t max_bytes, int64_t max_age_ms);
+
   bool StorePackets() const;
 
+  // Returns the number of bytes allocated for the history, which stays the
+  // same while packets come and go.
+  size_t MemoryUsage() const;
+
   // Stores RTP packet.
   int32_t PutRTPPacket(const uint8_t* packet,
                        size_t packet_length,
@@ -72,9 +84,15 @@ class RTPPacketHistory {
                  size_t* packet_length,
                  int64_t* stored_time_ms) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void Allocate(size_t number_to_store, size_t arena_size)
+      EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void Clear() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   void Free() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
-  void VerifyAndAllocatePacketLength(size_t packet_length, uint32_t start_index)
+  bool ExpandPackets() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  bool ExpandArena() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void DropOldestPacket() EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  void DropExpiredPackets(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
+  bool FindFreeSlot(size_t length, size_t* offset) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
   bool FindSeqNum(uint16_t sequence_number, int32_t* index) const
       EXCLUSIVE_LOCKS_REQUIRED(*critsect_);
@@ -85,7 +103,8 @@ class RTPPacketHistory {
   Clock* clock_;
   rtc::scoped_ptr<CriticalSectionWrapper> critsect_;
   bool store_ GUARDED_BY(critsect_);
-  uint32_t prev_index_ GUARDED_BY(critsect_);
+  bool sized_by_window_ GUARDED_BY(critsect_);
+  int64_t max_age_ms_ GUARDED_BY(critsect_);
 
   struct StoredPacket {
     StoredPacket();
@@ -95,10 +114,25 @@ class RTPPacketHistory {
     StorageType storage_type = kDontRetransmit;
     bool has_been_retransmitted = false;
 
-    uint8_t data[IP_PACKET_SIZE];
+    // Location of the packet in |arena_|; a length of zero marks a free slot.
+    size_t offset = 0;
     size_t length = 0;
   };
+  // Ring of packets in the order they were stored, oldest first.
   std::vector<StoredPacket> stored_packets_ GUARDED_BY(critsect_);
+  size_t oldest_index_ GUARDED_BY(critsect_);
+  size_t num_stored_ GUARDED_BY(critsect_);
+
+  // Ring of packet data. Packets are stored back to back in the same order as
+  // in |stored_packets_|; a packet that doesn't fit before the end of the
+  // arena is stored at its beginning instead.
+  std::vector<uint8_t> arena_ GUARDED_BY(critsect_);
+  // End of the newest packet in |arena_|.
+  size_t arena_head_ GUARDED_BY(critsect_);
+
+  // Index into |stored_packets_| of the newest packet with a given sequence
+  // number, or kNoIndex.
+  std::vector<uint16_t> seq_index_ GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
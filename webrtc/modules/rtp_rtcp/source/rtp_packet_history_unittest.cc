@@ -10,6 +10,8 @@
  * This file includes unit tests for the RTPPacketHistory.
  */
 
+#include <string.h>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -64,6 +66,21 @@ TEST_F(RtpPacketHistoryTest, SetStoreStatus) {
   EXPECT_FALSE(hist_->StorePackets());
 }
 
+TEST_F(RtpPacketHistoryTest, MemoryUsage) {
+  EXPECT_EQ(0u, hist_->MemoryUsage());
+  hist_->SetStorePacketsStatus(true, 10);
+  size_t allocated = hist_->MemoryUsage();
+  EXPECT_GE(allocated, 10u * IP_PACKET_SIZE);
+  size_t len = 0;
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len,
+                                   fake_clock_.TimeInMilliseconds(),
+                                   kAllowRetransmission));
+  EXPECT_EQ(allocated, hist_->MemoryUsage());
+  hist_->SetStorePacketsStatus(false, 0);
+  EXPECT_EQ(0u, hist_->MemoryUsage());
+}
+
 TEST_F(RtpPacketHistoryTest, NoStoreStatus) {
   EXPECT_FALSE(hist_->StorePackets());
   size_t len = 0;
@@ -289,4 +306,181 @@ TEST_F(RtpPacketHistoryTest, FullExpansion) {
   }
 }
 
+TEST_F(RtpPacketHistoryTest, ResetStoreStatusPurgesPackets) {
+  hist_->SetStorePacketsStatus(true, 10);
+  size_t len = 0;
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  CreateRtpPacket(kSeqNum, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                   kAllowRetransmission));
+  EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum));
+
+  hist_->SetStorePacketsStatus(true, 5);
+  EXPECT_TRUE(hist_->StorePackets());
+  EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum));
+
+  // The history can still be used after being re-set.
+  len = 0;
+  CreateRtpPacket(kSeqNum + 1, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                   kAllowRetransmission));
+  EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + 1));
+}
+
+TEST_F(RtpPacketHistoryTest, OldestPacketDroppedWhenFull) {
+  hist_->SetStorePacketsStatus(true, 10);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  for (int i = 0; i < 15; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                     kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+  }
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+  for (int i = 5; i < 15; ++i) {
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberGapsAndWrap) {
+  hist_->SetStorePacketsStatus(true, 10);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  // Sequence numbers used for padding are never stored.
+  const uint16_t kSeqNums[] = {65530, 65533, 65535, 0, 4, 5};
+  for (uint16_t seq_num : kSeqNums) {
+    size_t len = 0;
+    CreateRtpPacket(seq_num, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                     kAllowRetransmission));
+  }
+  for (uint16_t seq_num : kSeqNums) {
+    size_t len = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(seq_num, 0, false, packet_out_,
+                                               &len, &time));
+    EXPECT_EQ(seq_num, (packet_out_[2] << 8) + packet_out_[3]);
+  }
+  EXPECT_FALSE(hist_->HasRTPPacket(65534));
+  EXPECT_FALSE(hist_->HasRTPPacket(1));
+}
+
+TEST_F(RtpPacketHistoryTest, WindowDropsSentPacketsByBytes) {
+  static const size_t kPacketLength = 1000;
+  hist_->SetStorePacketsWindow(6 * kPacketLength, 0);
+  EXPECT_TRUE(hist_->StorePackets());
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  for (int i = 0; i < 10; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, kPacketLength, capture_time_ms,
+                                     kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+  for (int i = 4; i < 10; ++i) {
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, WindowDropsSentPacketsByAge) {
+  static const int64_t kMaxAgeMs = 1000;
+  hist_->SetStorePacketsWindow(100 * kMaxPacketLength, kMaxAgeMs);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  for (int i = 0; i < 3; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                     kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+    fake_clock_.AdvanceTimeMilliseconds(kMaxAgeMs / 2);
+  }
+
+  // The first packet was sent 1500 ms ago, the second 1000 ms ago.
+  size_t len = 0;
+  CreateRtpPacket(kSeqNum + 3, kSsrc, kPayload, kTimestamp, packet_, &len);
+  EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                   kAllowRetransmission));
+  EXPECT_FALSE(hist_->HasRTPPacket(kSeqNum));
+  for (int i = 1; i < 4; ++i) {
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, WindowKeepsUnsentPackets) {
+  static const size_t kPacketLength = 1000;
+  hist_->SetStorePacketsWindow(4 * kPacketLength, 0);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  // Twice as many bytes as the window, all pending in the pacer.
+  for (int i = 0; i < 8; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, kPacketLength, capture_time_ms,
+                                     kAllowRetransmission));
+  }
+  for (int i = 0; i < 8; ++i) {
+    size_t len = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(kSeqNum + i, 0, false,
+                                               packet_out_, &len, &time));
+    EXPECT_EQ(kPacketLength, len);
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, WindowStoresManySmallPackets) {
+  hist_->SetStorePacketsWindow(kMaxPacketLength, 0);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  // Far more packets than fit in a single full size slot.
+  for (int i = 0; i < 50; ++i) {
+    size_t len = 0;
+    CreateRtpPacket(kSeqNum + i, kSsrc, kPayload, kTimestamp, packet_, &len);
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                     kAllowRetransmission));
+    EXPECT_TRUE(hist_->SetSent(kSeqNum + i));
+  }
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_TRUE(hist_->HasRTPPacket(kSeqNum + i));
+  }
+}
+
+TEST_F(RtpPacketHistoryTest, VariableLengthPacketsWrapArena) {
+  hist_->SetStorePacketsWindow(3 * kMaxPacketLength, 0);
+  int64_t capture_time_ms = fake_clock_.TimeInMilliseconds();
+  for (int i = 0; i < 40; ++i) {
+    size_t len = 0;
+    uint16_t seq_num = kSeqNum + i;
+    CreateRtpPacket(seq_num, kSsrc, kPayload, kTimestamp, packet_, &len);
+    // Sizes between 100 and 1500 bytes, with a payload unique to the packet.
+    len = 100 + (i * 389) % (kMaxPacketLength - 99);
+    for (size_t j = 12; j < len; ++j) {
+      packet_[j] = static_cast<uint8_t>(i + j);
+    }
+    EXPECT_EQ(0, hist_->PutRTPPacket(packet_, len, capture_time_ms,
+                                     kAllowRetransmission));
+
+    size_t len_out = kMaxPacketLength;
+    int64_t time;
+    EXPECT_TRUE(hist_->GetPacketAndSetSendTime(seq_num, 0, false, packet_out_,
+                                               &len_out, &time));
+    EXPECT_EQ(len, len_out);
+    EXPECT_EQ(0, memcmp(packet_, packet_out_, len));
+
+    // The previous packet, if still stored, must not have been overwritten.
+    len_out = kMaxPacketLength;
+    if (i > 0 && hist_->HasRTPPacket(seq_num - 1)) {
+      EXPECT_TRUE(hist_->GetPacketAndSetSendTime(seq_num - 1, 0, false,
+                                                 packet_out_, &len_out, &time));
+      size_t prev_len = 100 + ((i - 1) * 389) % (kMaxPacketLength - 99);
+      EXPECT_EQ(prev_len, len_out);
+      for (size_t j = 12; j < prev_len; ++j) {
+        EXPECT_EQ(static_cast<uint8_t>(i - 1 + j), packet_out_[j]);
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
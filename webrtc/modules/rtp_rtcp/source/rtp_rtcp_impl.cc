@@ -96,7 +96,9 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
       key_frame_req_method_(kKeyFrameReqPliRtcp),
       remote_bitrate_(configuration.remote_bitrate_estimator),
       rtt_stats_(configuration.rtt_stats),
-      critical_section_rtt_(CriticalSectionWrapper::CreateCriticalSection()),
+      critical_section_rtt_(
+          CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+              "ModuleRtpRtcpImpl::critical_section_rtt_")),
       rtt_ms_(0) {
   send_video_codec_.codecType = kVideoCodecUnknown;
 
@@ -222,6 +224,11 @@ std::pair<int, int> ModuleRtpRtcpImpl::RtxSendPayloadType() const {
 int32_t ModuleRtpRtcpImpl::IncomingRtcpPacket(
     const uint8_t* rtcp_packet,
     const size_t length) {
+  // Stand-alone transport feedback is by far the most frequent RTCP, handle it
+  // without running the full parser.
+  if (rtcp_receiver_.IncomingTransportFeedback(rtcp_packet, length))
+    return 0;
+
   // Allow receive of non-compound RTCP packets.
   RTCPUtility::RTCPParserV2 rtcp_parser(rtcp_packet, length, true);
 
@@ -424,6 +431,9 @@ bool ModuleRtpRtcpImpl::TimeToSendPacket(uint32_t ssrc,
     return rtp_sender_.TimeToSendPacket(
         sequence_number, capture_time_ms, retransmission);
   }
+  if (SendingMedia() && ssrc != 0 && ssrc == rtp_sender_.FlexfecSsrc())
+    return rtp_sender_.TimeToSendFlexfecPacket(sequence_number,
+                                               capture_time_ms);
   // No RTP sender is interested in sending this packet.
   return true;
 }
@@ -759,6 +769,10 @@ bool ModuleRtpRtcpImpl::StorePackets() const {
   return rtp_sender_.StorePackets();
 }
 
+size_t ModuleRtpRtcpImpl::PacketHistoryMemoryUsage() const {
+  return rtp_sender_.PacketHistoryMemoryUsage();
+}
+
 void ModuleRtpRtcpImpl::RegisterRtcpStatisticsCallback(
     RtcpStatisticsCallback* callback) {
   rtcp_receiver_.RegisterRtcpStatisticsCallback(callback);
@@ -849,6 +863,16 @@ int32_t ModuleRtpRtcpImpl::SetFecParameters(
   return rtp_sender_.SetFecParameters(delta_params, key_params);
 }
 
+void ModuleRtpRtcpImpl::SetFlexfecStatus(bool enable,
+                                         uint8_t payload_type,
+                                         uint32_t ssrc) {
+  rtp_sender_.SetFlexfecStatus(enable, payload_type, ssrc);
+}
+
+uint32_t ModuleRtpRtcpImpl::FlexfecSsrc() const {
+  return rtp_sender_.FlexfecSsrc();
+}
+
 void ModuleRtpRtcpImpl::SetRemoteSSRC(const uint32_t ssrc) {
   // Inform about the incoming SSRC.
   rtcp_sender_.SetRemoteSSRC(ssrc);
@@ -225,6 +225,8 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
 
   bool StorePackets() const override;
 
+  size_t PacketHistoryMemoryUsage() const override;
+
   // Called on receipt of RTCP report block from remote side.
   void RegisterRtcpStatisticsCallback(
       RtcpStatisticsCallback* callback) override;
@@ -289,6 +291,12 @@ class ModuleRtpRtcpImpl : public RtpRtcp {
   int32_t SetFecParameters(const FecProtectionParams* delta_params,
                            const FecProtectionParams* key_params) override;
 
+  void SetFlexfecStatus(bool enable,
+                        uint8_t payload_type,
+                        uint32_t ssrc) override;
+
+  uint32_t FlexfecSsrc() const override;
+
   bool LastReceivedNTP(uint32_t* NTPsecs,
                        uint32_t* NTPfrac,
                        uint32_t* remote_sr) const;
@@ -36,6 +36,7 @@ namespace {
 
 const size_t kRtpHeaderLength = 12;
 const uint16_t kMaxInitRtpSeqNumber = 32767;  // 2^15 -1.
+const uint16_t kFlexfecHistorySize = 150;
 
 const char* FrameTypeToString(FrameType frame_type) {
   switch (frame_type) {
@@ -138,7 +139,8 @@ RTPSender::RTPSender(
       transport_sequence_number_allocator_(sequence_number_allocator),
       transport_feedback_observer_(transport_feedback_observer),
       last_capture_time_ms_sent_(0),
-      send_critsect_(CriticalSectionWrapper::CreateCriticalSection()),
+      send_critsect_(CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+          "RTPSender::send_critsect_")),
       transport_(transport),
       sending_media_(true),                      // Default to sending media.
       max_payload_length_(IP_PACKET_SIZE - 28),  // Default is IP-v4/UDP.
@@ -156,8 +158,10 @@ RTPSender::RTPSender(
       nack_byte_count_(),
       nack_bitrate_(clock, bitrates_->retransmit_bitrate_observer()),
       packet_history_(clock),
+      flexfec_history_(clock),
       // Statistics
-      statistics_crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      statistics_crit_(CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+          "RTPSender::statistics_crit_")),
       rtp_stats_callback_(NULL),
       frame_count_observer_(frame_count_observer),
       send_side_delay_observer_(send_side_delay_observer),
@@ -707,6 +711,10 @@ bool RTPSender::StorePackets() const {
   return packet_history_.StorePackets();
 }
 
+size_t RTPSender::PacketHistoryMemoryUsage() const {
+  return packet_history_.MemoryUsage() + flexfec_history_.MemoryUsage();
+}
+
 int32_t RTPSender::ReSendPacket(uint16_t packet_id, int64_t min_resend_time) {
   size_t length = IP_PACKET_SIZE;
   uint8_t data_buffer[IP_PACKET_SIZE];
@@ -903,6 +911,19 @@ bool RTPSender::TimeToSendPacket(uint16_t sequence_number,
                               retransmission);
 }
 
+bool RTPSender::TimeToSendFlexfecPacket(uint16_t sequence_number,
+                                        int64_t capture_time_ms) {
+  size_t length = IP_PACKET_SIZE;
+  uint8_t data_buffer[IP_PACKET_SIZE];
+  int64_t stored_time_ms;
+  if (!flexfec_history_.GetPacketAndSetSendTime(sequence_number, 0, false,
+                                                data_buffer, &length,
+                                                &stored_time_ms)) {
+    return true;
+  }
+  return SendFlexfecPacket(data_buffer, length);
+}
+
 bool RTPSender::PrepareAndSendPacket(uint8_t* buffer,
                                      size_t length,
                                      int64_t capture_time_ms,
@@ -998,6 +1019,9 @@ bool RTPSender::IsFecPacket(const uint8_t* buffer,
   if (!video_) {
     return false;
   }
+  uint32_t flexfec_ssrc = video_->FlexfecSsrc();
+  if (flexfec_ssrc != 0 && header.ssrc == flexfec_ssrc)
+    return true;
   bool fec_enabled;
   uint8_t pt_red;
   uint8_t pt_fec;
@@ -1091,6 +1115,34 @@ int32_t RTPSender::SendToNetwork(uint8_t* buffer,
   return 0;
 }
 
+int32_t RTPSender::SendFlexfecToNetwork(uint8_t* buffer,
+                                        size_t length,
+                                        int64_t capture_time_ms) {
+  if (paced_sender_) {
+    if (flexfec_history_.PutRTPPacket(buffer, length, capture_time_ms,
+                                      kDontRetransmit) != 0) {
+      return -1;
+    }
+    paced_sender_->InsertPacket(
+        RtpPacketSender::kLowPriority,
+        ByteReader<uint32_t>::ReadBigEndian(&buffer[8]),
+        ByteReader<uint16_t>::ReadBigEndian(&buffer[2]),
+        capture_time_ms + clock_delta_ms_, length - kRtpHeaderLength, false);
+    return 0;
+  }
+  return SendFlexfecPacket(buffer, length) ? 0 : -1;
+}
+
+bool RTPSender::SendFlexfecPacket(const uint8_t* buffer, size_t length) {
+  if (!SendPacketToNetwork(buffer, length, PacketOptions()))
+    return false;
+  RtpUtility::RtpHeaderParser rtp_parser(buffer, length);
+  RTPHeader rtp_header;
+  rtp_parser.Parse(&rtp_header);
+  UpdateRtpStats(buffer, length, rtp_header, false, false);
+  return true;
+}
+
 void RTPSender::UpdateDelayStatistics(int64_t capture_time_ms, int64_t now_ms) {
   if (!send_side_delay_observer_)
     return;
@@ -1817,6 +1869,18 @@ int32_t RTPSender::SetFecParameters(
   return 0;
 }
 
+void RTPSender::SetFlexfecStatus(bool enable,
+                                 uint8_t payload_type,
+                                 uint32_t ssrc) {
+  RTC_DCHECK(!audio_configured_);
+  video_->SetFlexfecStatus(enable, payload_type, ssrc);
+  flexfec_history_.SetStorePacketsStatus(enable, kFlexfecHistorySize);
+}
+
+uint32_t RTPSender::FlexfecSsrc() const {
+  return video_ ? video_->FlexfecSsrc() : 0;
+}
+
 void RTPSender::BuildRtxPacket(uint8_t* buffer, size_t* length,
                                uint8_t* buffer_rtx) {
   CriticalSectionScoped cs(send_critsect_.get());
@@ -77,6 +77,12 @@ class RTPSenderInterface {
                                 StorageType storage,
                                 RtpPacketSender::Priority priority) = 0;
 
+  // Sends, or queues in the pacer, the complete FlexFEC packet |buffer| of
+  // |length| bytes.
+  virtual int32_t SendFlexfecToNetwork(uint8_t* buffer,
+                                       size_t length,
+                                       int64_t capture_time_ms) = 0;
+
   virtual bool UpdateVideoRotation(uint8_t* rtp_packet,
                                    size_t rtp_packet_length,
                                    const RTPHeader& rtp_header,
@@ -209,6 +215,9 @@ class RTPSender : public RTPSenderInterface {
 
   bool TimeToSendPacket(uint16_t sequence_number, int64_t capture_time_ms,
                         bool retransmission);
+  // Called from the pacer for packets sent on FlexfecSsrc().
+  bool TimeToSendFlexfecPacket(uint16_t sequence_number,
+                               int64_t capture_time_ms);
   size_t TimeToSendPadding(size_t bytes);
 
   // NACK.
@@ -221,6 +230,9 @@ class RTPSender : public RTPSenderInterface {
 
   bool StorePackets() const;
 
+  // Bytes allocated for the retransmission and FlexFEC packet histories.
+  size_t PacketHistoryMemoryUsage() const;
+
   int32_t ReSendPacket(uint16_t packet_id, int64_t min_resend_time = 0);
 
   bool ProcessNACKBitRate(uint32_t now);
@@ -260,6 +272,10 @@ class RTPSender : public RTPSenderInterface {
                         StorageType storage,
                         RtpPacketSender::Priority priority) override;
 
+  int32_t SendFlexfecToNetwork(uint8_t* buffer,
+                               size_t length,
+                               int64_t capture_time_ms) override;
+
   // Audio.
 
   // Send a DTMF tone using RFC 2833 (4733).
@@ -295,6 +311,10 @@ class RTPSender : public RTPSenderInterface {
   int32_t SetFecParameters(const FecProtectionParams *delta_params,
                            const FecProtectionParams *key_params);
 
+  void SetFlexfecStatus(bool enable, uint8_t payload_type, uint32_t ssrc);
+  // Returns 0 if FlexFEC is off.
+  uint32_t FlexfecSsrc() const;
+
   size_t SendPadData(size_t bytes,
                      bool timestamp_provided,
                      uint32_t timestamp,
@@ -384,6 +404,8 @@ class RTPSender : public RTPSenderInterface {
                       bool is_retransmit);
   bool IsFecPacket(const uint8_t* buffer, const RTPHeader& header) const;
 
+  bool SendFlexfecPacket(const uint8_t* buffer, size_t length);
+
   Clock* clock_;
   int64_t clock_delta_ms_;
   Random random_ GUARDED_BY(send_critsect_);
@@ -423,6 +445,8 @@ class RTPSender : public RTPSenderInterface {
   Bitrate nack_bitrate_;
 
   RTPPacketHistory packet_history_;
+  // FlexFEC packets waiting in the pacer, by their own sequence numbers.
+  RTPPacketHistory flexfec_history_;
 
   // Statistics
   rtc::scoped_ptr<CriticalSectionWrapper> statistics_crit_;
@@ -22,6 +22,8 @@
 #include "webrtc/modules/rtp_rtcp/include/rtp_cvo.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_format_video_generic.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
@@ -457,6 +459,35 @@ TEST_F(RtpSenderTestWithoutPacer, BuildRTPPacketWithAbsoluteSendTimeExtension) {
   EXPECT_EQ(0u, rtp_header2.extension.absoluteSendTime);
 }
 
+TEST_F(RtpSenderTestWithoutPacer, ParseOnlyRequestedExtensions) {
+  EXPECT_EQ(0, rtp_sender_->SetTransmissionTimeOffset(kTimeOffset));
+  EXPECT_EQ(0, rtp_sender_->SetAbsoluteSendTime(kAbsoluteSendTime));
+  EXPECT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
+                   kRtpExtensionTransmissionTimeOffset,
+                   kTransmissionTimeOffsetExtensionId));
+  EXPECT_EQ(
+      0, rtp_sender_->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                                 kAbsoluteSendTimeExtensionId));
+
+  size_t length = static_cast<size_t>(rtp_sender_->BuildRTPheader(
+      packet_, kPayload, kMarkerBit, kTimestamp, 0));
+
+  RtpHeaderExtensionMap map;
+  map.Register(kRtpExtensionTransmissionTimeOffset,
+               kTransmissionTimeOffsetExtensionId);
+  map.Register(kRtpExtensionAbsoluteSendTime, kAbsoluteSendTimeExtensionId);
+  webrtc::RtpUtility::RtpHeaderParser rtp_parser(packet_, length);
+  webrtc::RTPHeader rtp_header;
+  ASSERT_TRUE(rtp_parser.ParseWithExtensions(
+      &rtp_header, &map, 1u << kRtpExtensionAbsoluteSendTime));
+
+  VerifyRTPHeaderCommon(rtp_header);
+  EXPECT_EQ(length, rtp_header.headerLength);
+  EXPECT_TRUE(rtp_header.extension.hasAbsoluteSendTime);
+  EXPECT_EQ(kAbsoluteSendTime, rtp_header.extension.absoluteSendTime);
+  EXPECT_FALSE(rtp_header.extension.hasTransmissionTimeOffset);
+}
+
 // Test CVO header extension is only set when marker bit is true.
 TEST_F(RtpSenderTestWithoutPacer, BuildRTPPacketWithVideoRotation_MarkerBit) {
   rtp_sender_->SetVideoRotation(kRotation);
@@ -973,6 +1004,86 @@ TEST_F(RtpSenderTestWithoutPacer, SendGenericVideo) {
   EXPECT_EQ(0, memcmp(payload, payload_data, sizeof(payload)));
 }
 
+TEST_F(RtpSenderTestWithoutPacer, SendsFlexfecOnItsOwnSsrc) {
+  const uint8_t kFlexfecPayloadType = 118;
+  const uint32_t kFlexfecSsrc = 0x12345678;
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  rtp_sender_->SetFlexfecStatus(true, kFlexfecPayloadType, kFlexfecSsrc);
+  EXPECT_EQ(kFlexfecSsrc, rtp_sender_->FlexfecSsrc());
+  // Full overhead: blocks of 2 x 2 packets.
+  FecProtectionParams fec_params;
+  fec_params.fec_mask_type = kFecMaskRandom;
+  fec_params.fec_rate = 255;
+  fec_params.max_fec_frames = 1;
+  fec_params.use_uep_protection = false;
+  rtp_sender_->SetFecParameters(&fec_params, &fec_params);
+
+  uint8_t payload[] = {47, 11, 32, 93, 89};
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameKey, payload_type,
+                                             1234, 4321, payload,
+                                             sizeof(payload), nullptr));
+  EXPECT_EQ(1, transport_.packets_sent_);
+  ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameDelta, payload_type,
+                                             1235, 4322, payload,
+                                             sizeof(payload), nullptr));
+  // The media packets aren't RED encapsulated, and the row of both is
+  // protected by a FlexFEC packet.
+  ASSERT_EQ(3, transport_.packets_sent_);
+  RtpUtility::RtpHeaderParser media_parser(
+      transport_.sent_packets_[1]->data(), transport_.sent_packets_[1]->size());
+  RTPHeader rtp_header;
+  ASSERT_TRUE(media_parser.Parse(&rtp_header));
+  EXPECT_EQ(payload_type, rtp_header.payloadType);
+  const rtc::Buffer& fec_packet = *transport_.sent_packets_[2];
+  RtpUtility::RtpHeaderParser fec_parser(fec_packet.data(), fec_packet.size());
+  ASSERT_TRUE(fec_parser.Parse(&rtp_header));
+  EXPECT_EQ(kFlexfecPayloadType, rtp_header.payloadType);
+  EXPECT_EQ(kFlexfecSsrc, rtp_header.ssrc);
+  EXPECT_EQ(rtp_sender_->SSRC(),
+            ByteReader<uint32_t>::ReadBigEndian(
+                &fec_packet.data()[kRtpHeaderSize + flexfec::kSsrcOffset]));
+  EXPECT_EQ(transport_.sent_packets_[1]->size() + flexfec::kHeaderSize,
+            fec_packet.size());
+}
+
+TEST_F(RtpSenderTest, PacesFlexfecPackets) {
+  const uint32_t kFlexfecSsrc = 0x12345678;
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  rtp_sender_->SetFlexfecStatus(true, 118, kFlexfecSsrc);
+  FecProtectionParams fec_params;
+  fec_params.fec_mask_type = kFecMaskRandom;
+  fec_params.fec_rate = 255;
+  fec_params.max_fec_frames = 1;
+  fec_params.use_uep_protection = false;
+  rtp_sender_->SetFecParameters(&fec_params, &fec_params);
+
+  EXPECT_CALL(mock_paced_sender_,
+              InsertPacket(RtpPacketSender::kLowPriority, kFlexfecSsrc, 0, _, _,
+                           false))
+      .Times(1);
+  uint8_t payload[] = {47, 11, 32, 93, 89};
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(0, rtp_sender_->SendOutgoingData(kVideoFrameDelta, payload_type,
+                                               1234 + i, 4321 + i, payload,
+                                               sizeof(payload), nullptr));
+  }
+  EXPECT_EQ(0, transport_.packets_sent_);
+
+  EXPECT_TRUE(rtp_sender_->TimeToSendFlexfecPacket(0, 4322));
+  ASSERT_EQ(1, transport_.packets_sent_);
+  RtpUtility::RtpHeaderParser rtp_parser(transport_.last_sent_packet_,
+                                         transport_.last_sent_packet_len_);
+  RTPHeader rtp_header;
+  ASSERT_TRUE(rtp_parser.Parse(&rtp_header));
+  EXPECT_EQ(kFlexfecSsrc, rtp_header.ssrc);
+}
+
 TEST_F(RtpSenderTest, FrameCountCallbacks) {
   class TestCallback : public FrameCountObserver {
    public:
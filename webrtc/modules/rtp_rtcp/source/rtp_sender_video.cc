@@ -39,6 +39,8 @@ RTPSenderVideo::RTPSenderVideo(Clock* clock, RTPSenderInterface* rtpSender)
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
       _videoType(kRtpVideoGeneric),
       _maxBitrate(0),
+      packetizer_type_(kRtpVideoNone),
+      packetizer_max_payload_length_(0),
       _retransmissionSettings(kRetransmitBaseLayer),
 
       // Generic FEC
@@ -176,6 +178,33 @@ void RTPSenderVideo::SendVideoPacketAsRed(uint8_t* data_buffer,
   }
 }
 
+void RTPSenderVideo::ProtectWithFlexfec(const uint8_t* data_buffer,
+                                        size_t packet_length,
+                                        uint32_t capture_timestamp,
+                                        int64_t capture_time_ms) {
+  std::vector<rtc::Buffer> fec_packets;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    if (!flexfec_sender_)
+      return;
+    flexfec_sender_->AddMediaPacket(data_buffer, packet_length);
+    fec_packets = flexfec_sender_->GetFecPackets();
+  }
+  for (rtc::Buffer& fec_packet : fec_packets) {
+    if (_rtpSender.SendFlexfecToNetwork(fec_packet.data(), fec_packet.size(),
+                                        capture_time_ms) == 0) {
+      _fecOverheadRate.Update(fec_packet.size());
+      TRACE_EVENT_INSTANT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
+                           "Video::PacketFlexfec", "timestamp",
+                           capture_timestamp, "seqnum",
+                           ByteReader<uint16_t>::ReadBigEndian(
+                               &fec_packet.data()[2]));
+    } else {
+      LOG(LS_WARNING) << "Failed to send FlexFEC packet.";
+    }
+  }
+}
+
 void RTPSenderVideo::SetGenericFECStatus(const bool enable,
                                          const uint8_t payloadTypeRED,
                                          const uint8_t payloadTypeFEC) {
@@ -199,8 +228,26 @@ void RTPSenderVideo::GenericFECStatus(bool* enable,
   *payloadTypeFEC = fec_payload_type_;
 }
 
+void RTPSenderVideo::SetFlexfecStatus(bool enable,
+                                      uint8_t payload_type,
+                                      uint32_t ssrc) {
+  CriticalSectionScoped cs(crit_.get());
+  flexfec_sender_.reset(enable ? new FlexfecSender(payload_type, ssrc)
+                               : nullptr);
+}
+
+uint32_t RTPSenderVideo::FlexfecSsrc() const {
+  CriticalSectionScoped cs(crit_.get());
+  return flexfec_sender_ ? flexfec_sender_->ssrc() : 0;
+}
+
 size_t RTPSenderVideo::FECPacketOverhead() const {
   CriticalSectionScoped cs(crit_.get());
+  if (!fec_enabled_ && flexfec_sender_) {
+    // FlexFEC packets are the protected packets past their 12 byte RTP
+    // header, prefixed by the FlexFEC header and a bare RTP header.
+    return flexfec::kHeaderSize;
+  }
   if (fec_enabled_) {
     // Overhead is FEC headers plus RED for FEC header plus anything in RTP
     // header beyond the 12 bytes base header (CSRC list, extensions...)
@@ -235,9 +282,17 @@ int32_t RTPSenderVideo::SendVideo(const RtpVideoCodecTypes videoType,
     return -1;
   }
 
-  rtc::scoped_ptr<RtpPacketizer> packetizer(
-      RtpPacketizer::Create(videoType, _rtpSender.MaxDataPayloadLength(),
-                            &(rtpHdr->codecHeader), frameType));
+  const size_t max_payload_length = _rtpSender.MaxDataPayloadLength();
+  if (!packetizer_ || packetizer_type_ != videoType ||
+      packetizer_max_payload_length_ != max_payload_length) {
+    packetizer_.reset(RtpPacketizer::Create(
+        videoType, max_payload_length, &(rtpHdr->codecHeader), frameType));
+    packetizer_type_ = videoType;
+    packetizer_max_payload_length_ = max_payload_length;
+  } else {
+    packetizer_->SetVideoHeader(&(rtpHdr->codecHeader), frameType);
+  }
+  RtpPacketizer* packetizer = packetizer_.get();
 
   StorageType storage;
   bool fec_enabled;
@@ -246,6 +301,8 @@ int32_t RTPSenderVideo::SendVideo(const RtpVideoCodecTypes videoType,
     FecProtectionParams* fec_params =
         frameType == kVideoFrameKey ? &key_fec_params_ : &delta_fec_params_;
     producer_fec_.SetFecParameters(fec_params, 0);
+    if (flexfec_sender_)
+      flexfec_sender_->SetFecRate(fec_params->fec_rate);
     storage = packetizer->GetStorageType(_retransmissionSettings);
     fec_enabled = fec_enabled_;
   }
@@ -269,9 +326,11 @@ int32_t RTPSenderVideo::SendVideo(const RtpVideoCodecTypes videoType,
 
   packetizer->SetPayloadData(data, payload_bytes_to_send, frag);
 
+  // Every packet overwrites the header and payload of the one before it, so
+  // the buffer is only cleared once per frame.
+  uint8_t dataBuffer[IP_PACKET_SIZE] = {0};
   bool last = false;
   while (!last) {
-    uint8_t dataBuffer[IP_PACKET_SIZE] = {0};
     size_t payload_bytes_in_packet = 0;
     if (!packetizer->NextPacket(&dataBuffer[rtp_header_length],
                                 &payload_bytes_in_packet, &last)) {
@@ -317,6 +376,9 @@ int32_t RTPSenderVideo::SendVideo(const RtpVideoCodecTypes videoType,
       SendVideoPacket(dataBuffer, payload_bytes_in_packet, rtp_header_length,
                       _rtpSender.SequenceNumber(), captureTimeStamp,
                       capture_time_ms, storage);
+      ProtectWithFlexfec(dataBuffer,
+                         rtp_header_length + payload_bytes_in_packet,
+                         captureTimeStamp, capture_time_ms);
     }
   }
 
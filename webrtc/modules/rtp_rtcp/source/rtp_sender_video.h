@@ -18,8 +18,10 @@
 #include "webrtc/common_types.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/bitrate.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 #include "webrtc/modules/rtp_rtcp/source/producer_fec.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
@@ -74,6 +76,14 @@ class RTPSenderVideo {
   void SetFecParameters(const FecProtectionParams* delta_params,
                         const FecProtectionParams* key_params);
 
+  // FlexFEC, sent with |payload_type| on |ssrc| instead of RED encapsulated
+  // along with the media. Protection follows the FEC parameters above. Not
+  // used while generic FEC is enabled.
+  void SetFlexfecStatus(bool enable, uint8_t payload_type, uint32_t ssrc);
+
+  // Returns the SSRC of FlexFEC, or 0 if it's off.
+  uint32_t FlexfecSsrc() const;
+
   void ProcessBitrate();
 
   uint32_t VideoBitrateSent() const;
@@ -100,6 +110,13 @@ class RTPSenderVideo {
                             StorageType media_packet_storage,
                             bool protect);
 
+  // Protects the sent media packet in |data_buffer| with FlexFEC, and sends
+  // any FEC packets that completes.
+  void ProtectWithFlexfec(const uint8_t* data_buffer,
+                          size_t packet_length,
+                          uint32_t capture_timestamp,
+                          int64_t capture_time_ms);
+
   RTPSenderInterface& _rtpSender;
 
   // Should never be held when calling out of this class.
@@ -107,6 +124,13 @@ class RTPSenderVideo {
 
   RtpVideoCodecTypes _videoType;
   uint32_t _maxBitrate;
+
+  // The packetizer of the last frame sent, which is reused for the next one
+  // if it has the same codec and max payload length. Only used by
+  // SendVideo(), which isn't called concurrently.
+  rtc::scoped_ptr<RtpPacketizer> packetizer_;
+  RtpVideoCodecTypes packetizer_type_;
+  size_t packetizer_max_payload_length_;
   int32_t _retransmissionSettings GUARDED_BY(crit_);
 
   // FEC
@@ -117,6 +141,7 @@ class RTPSenderVideo {
   FecProtectionParams delta_fec_params_ GUARDED_BY(crit_);
   FecProtectionParams key_fec_params_ GUARDED_BY(crit_);
   ProducerFec producer_fec_ GUARDED_BY(crit_);
+  rtc::scoped_ptr<FlexfecSender> flexfec_sender_ GUARDED_BY(crit_);
 
   // Bitrate used for FEC payload, RED headers, RTP headers for FEC packets
   // and any padding overhead.
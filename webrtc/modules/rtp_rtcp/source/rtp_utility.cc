@@ -182,6 +182,13 @@ bool RtpHeaderParser::ParseRtcp(RTPHeader* header) const {
 
 bool RtpHeaderParser::Parse(RTPHeader* header,
                             RtpHeaderExtensionMap* ptrExtensionMap) const {
+  return ParseWithExtensions(header, ptrExtensionMap, 0xFFFFFFFF);
+}
+
+bool RtpHeaderParser::ParseWithExtensions(
+    RTPHeader* header,
+    const RtpHeaderExtensionMap* ptrExtensionMap,
+    uint32_t extension_mask) const {
   const ptrdiff_t length = _ptrRTPDataEnd - _ptrRTPDataBegin;
   if (length < kRtpMinParseLength) {
     return false;
@@ -285,6 +292,7 @@ bool RtpHeaderParser::Parse(RTPHeader* header,
       const uint8_t* ptrRTPDataExtensionEnd = ptr + XLen;
       ParseOneByteExtensionHeader(header,
                                   ptrExtensionMap,
+                                  extension_mask,
                                   ptrRTPDataExtensionEnd,
                                   ptr);
     }
@@ -299,6 +307,7 @@ bool RtpHeaderParser::Parse(RTPHeader* header,
 void RtpHeaderParser::ParseOneByteExtensionHeader(
     RTPHeader* header,
     const RtpHeaderExtensionMap* ptrExtensionMap,
+    uint32_t extension_mask,
     const uint8_t* ptrRTPDataExtensionEnd,
     const uint8_t* ptr) const {
   if (!ptrExtensionMap) {
@@ -328,6 +337,8 @@ void RtpHeaderParser::ParseOneByteExtensionHeader(
     if (ptrExtensionMap->GetType(id, &type) != 0) {
       // If we encounter an unknown extension, just skip over it.
       LOG(LS_WARNING) << "Failed to find extension id: " << id;
+    } else if ((extension_mask & (1u << type)) == 0) {
+      // Not requested by the caller, skip over it.
     } else {
       switch (type) {
         case kRtpExtensionTransmissionTimeOffset: {
@@ -53,6 +53,13 @@ class RtpHeaderParser {
   bool ParseRtcp(RTPHeader* header) const;
   bool Parse(RTPHeader* parsedPacket,
              RtpHeaderExtensionMap* ptrExtensionMap = nullptr) const;
+  // Like Parse(), but only decodes the header extensions whose bit
+  // (1 << type) is set in |extension_mask|, skipping over all others. Callers
+  // that only need e.g. the transport sequence number use this on the receive
+  // path.
+  bool ParseWithExtensions(RTPHeader* parsedPacket,
+                           const RtpHeaderExtensionMap* ptrExtensionMap,
+                           uint32_t extension_mask) const;
   RTC_DEPRECATED bool Parse(
       RTPHeader& parsedPacket,  // NOLINT(runtime/references)
       RtpHeaderExtensionMap* ptrExtensionMap = nullptr) const {
@@ -62,6 +69,7 @@ class RtpHeaderParser {
  private:
   void ParseOneByteExtensionHeader(RTPHeader* parsedPacket,
                                    const RtpHeaderExtensionMap* ptrExtensionMap,
+                                   uint32_t extension_mask,
                                    const uint8_t* ptrRTPDataExtensionEnd,
                                    const uint8_t* ptr) const;
 
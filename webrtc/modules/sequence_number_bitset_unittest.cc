@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/include/sequence_number_bitset.h"
+
+#include <set>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/random.h"
+
+namespace webrtc {
+namespace {
+
+std::vector<uint16_t> Members(const SequenceNumberBitset& bitset) {
+  std::vector<uint16_t> members;
+  bitset.ForEach([&members](uint16_t sequence_number) {
+    members.push_back(sequence_number);
+    return true;
+  });
+  return members;
+}
+
+class SequenceNumberLessThan {
+ public:
+  bool operator()(uint16_t sequence_number1, uint16_t sequence_number2) const {
+    return IsNewerSequenceNumber(sequence_number2, sequence_number1);
+  }
+};
+
+typedef std::set<uint16_t, SequenceNumberLessThan> SequenceNumberSet;
+
+}  // namespace
+
+TEST(SequenceNumberBitset, Empty) {
+  SequenceNumberBitset bitset;
+  EXPECT_TRUE(bitset.empty());
+  EXPECT_EQ(0u, bitset.size());
+  EXPECT_FALSE(bitset.Contains(0));
+  EXPECT_TRUE(Members(bitset).empty());
+}
+
+TEST(SequenceNumberBitset, InsertAndErase) {
+  SequenceNumberBitset bitset;
+  EXPECT_TRUE(bitset.Insert(10));
+  EXPECT_FALSE(bitset.Insert(10));
+  EXPECT_TRUE(bitset.Insert(5));
+  EXPECT_TRUE(bitset.Insert(200));
+  EXPECT_EQ(3u, bitset.size());
+  EXPECT_EQ(5, bitset.oldest());
+  EXPECT_TRUE(bitset.Contains(10));
+  EXPECT_FALSE(bitset.Contains(11));
+
+  EXPECT_TRUE(bitset.Erase(5));
+  EXPECT_FALSE(bitset.Erase(5));
+  EXPECT_EQ(10, bitset.oldest());
+  EXPECT_EQ(std::vector<uint16_t>({10, 200}), Members(bitset));
+}
+
+TEST(SequenceNumberBitset, OrderedAcrossWrap) {
+  SequenceNumberBitset bitset;
+  bitset.InsertRange(0xFFF0, 0x0010);
+  EXPECT_EQ(32u, bitset.size());
+  EXPECT_EQ(0xFFF0, bitset.oldest());
+  std::vector<uint16_t> members = Members(bitset);
+  ASSERT_EQ(32u, members.size());
+  for (size_t i = 0; i < members.size(); ++i)
+    EXPECT_EQ(static_cast<uint16_t>(0xFFF0 + i), members[i]);
+
+  bitset.EraseUpTo(0x0002);
+  EXPECT_EQ(13u, bitset.size());
+  EXPECT_EQ(0x0003, bitset.oldest());
+}
+
+TEST(SequenceNumberBitset, InsertRangeCountsOnlyNewMembers) {
+  SequenceNumberBitset bitset;
+  bitset.Insert(100);
+  bitset.InsertRange(90, 110);
+  EXPECT_EQ(20u, bitset.size());
+  EXPECT_EQ(90, bitset.oldest());
+}
+
+TEST(SequenceNumberBitset, EraseUpToOlderThanOldestDoesNothing) {
+  SequenceNumberBitset bitset;
+  bitset.InsertRange(100, 110);
+  bitset.EraseUpTo(99);
+  EXPECT_EQ(10u, bitset.size());
+  bitset.EraseUpTo(200);
+  EXPECT_TRUE(bitset.empty());
+}
+
+TEST(SequenceNumberBitset, ForEachStopsWhenVisitorReturnsFalse) {
+  SequenceNumberBitset bitset;
+  bitset.InsertRange(1000, 1100);
+  int visited = 0;
+  bitset.ForEach([&visited](uint16_t sequence_number) {
+    return ++visited < 10;
+  });
+  EXPECT_EQ(10, visited);
+}
+
+TEST(SequenceNumberBitset, Clear) {
+  SequenceNumberBitset bitset;
+  bitset.InsertRange(0xFF00, 0x0100);
+  bitset.Clear();
+  EXPECT_TRUE(bitset.empty());
+  for (uint32_t i = 0; i <= 0xFFFF; ++i)
+    EXPECT_FALSE(bitset.Contains(static_cast<uint16_t>(i)));
+}
+
+TEST(SequenceNumberBitset, MatchesOrderedSet) {
+  Random random(0x5eed);
+  SequenceNumberBitset bitset;
+  SequenceNumberSet set;
+  uint16_t newest = 0xFF00;
+  for (int i = 0; i < 10000; ++i) {
+    switch (random.Rand(2)) {
+      case 0: {
+        // A gap after the newest sequence number.
+        uint16_t end = newest + 1 + random.Rand(100);
+        bitset.InsertRange(newest + 1, end);
+        for (uint16_t n = newest + 1; n != end; ++n)
+          set.insert(n);
+        newest = end;
+        break;
+      }
+      case 1: {
+        uint16_t sequence_number = newest - random.Rand(300);
+        EXPECT_EQ(set.erase(sequence_number) == 1,
+                  bitset.Erase(sequence_number));
+        break;
+      }
+      case 2: {
+        uint16_t last = newest - 200 - random.Rand(200);
+        bitset.EraseUpTo(last);
+        set.erase(set.begin(), set.upper_bound(last));
+        break;
+      }
+    }
+    ASSERT_EQ(set.size(), bitset.size());
+    if (!set.empty()) {
+      ASSERT_EQ(*set.begin(), bitset.oldest());
+    }
+  }
+  EXPECT_EQ(std::vector<uint16_t>(set.begin(), set.end()), Members(bitset));
+}
+
+}  // namespace webrtc
@@ -22,6 +22,12 @@ class AudioFrame;
 // than a class.
 class AudioFrameOperations {
  public:
+  // Adds |frame_to_add| to |result_frame|, saturating the samples, and
+  // updates the VAD and speech type like AudioFrame::operator+=. Does nothing
+  // if the frames have a different number of channels or samples, unless
+  // |result_frame| is empty, in which case |frame_to_add| is copied.
+  static void Add(const AudioFrame& frame_to_add, AudioFrame* result_frame);
+
   // Upmixes mono |src_audio| to stereo |dst_audio|. This is an out-of-place
   // operation, meaning src_audio and dst_audio must point to different
   // buffers. It is the caller's responsibility to ensure that |dst_audio| is
@@ -45,12 +51,16 @@ class AudioFrameOperations {
   // not stereo.
   static void SwapStereoChannels(AudioFrame* frame);
 
-  // Zeros out the audio and sets |frame.energy| to zero.
+  // Zeros out the audio and its level.
   static void Mute(AudioFrame& frame);
 
+  // Scales the left and right channels of a stereo |frame|, saturating.
   static int Scale(float left, float right, AudioFrame& frame);
 
   static int ScaleWithSat(float scale, AudioFrame& frame);
+
+  // Computes |frame.sum_squares_| and |frame.max_abs_| over all channels.
+  static void UpdateLevel(AudioFrame* frame);
 };
 
 }  // namespace webrtc
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_INCLUDE_PROCESS_THREAD_POOL_H_
+#define WEBRTC_MODULES_UTILITY_INCLUDE_PROCESS_THREAD_POOL_H_
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+
+namespace webrtc {
+
+// A fixed number of worker threads that run the modules and tasks of many
+// ProcessThreads. The modules and tasks of one ProcessThread are never run
+// concurrently, but may run on a different worker each time, so they must
+// not assume that they are always called on the same OS thread.
+class ProcessThreadPool {
+ public:
+  virtual ~ProcessThreadPool();
+
+  // Starts |num_workers| worker threads.
+  static rtc::scoped_ptr<ProcessThreadPool> Create(size_t num_workers);
+
+  // Returns a ProcessThread that is backed by the pool instead of a thread of
+  // its own. It behaves as any other ProcessThread, and must be destroyed
+  // before the pool. Can be called on any thread.
+  virtual rtc::scoped_ptr<ProcessThread> CreateProcessThread(
+      const char* thread_name) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_INCLUDE_PROCESS_THREAD_POOL_H_
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_INCLUDE_RTP_PACKET_RECORDER_H_
+#define WEBRTC_MODULES_UTILITY_INCLUDE_RTP_PACKET_RECORDER_H_
+
+#include <string>
+
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+class Clock;
+
+// Records RTP and RTCP packets as they are, i.e. with the audio or video
+// payload still encoded, to a file in rtpdump format. Recording a packet
+// copies it into a preallocated block; full blocks are written by a thread of
+// the recorder's own, so the calling thread never waits for the disk.
+class RtpPacketRecorder {
+ public:
+  virtual ~RtpPacketRecorder() {}
+
+  // Creates |file_name| and starts recording to it. Packet times in the file
+  // are relative to the time of this call, according to |clock|. Returns NULL
+  // if the file can't be created.
+  static rtc::scoped_ptr<RtpPacketRecorder> Create(const std::string& file_name,
+                                                   Clock* clock);
+
+  // Records a packet. Can be called on any thread. Returns false if the
+  // packet was dropped, because it is too large for the rtpdump format or
+  // because the writer thread has fallen behind.
+  virtual bool RecordRtpPacket(const uint8_t* packet, size_t length) = 0;
+  virtual bool RecordRtcpPacket(const uint8_t* packet, size_t length) = 0;
+
+  // Number of packets dropped so far.
+  virtual int dropped_packets() const = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_INCLUDE_RTP_PACKET_RECORDER_H_
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/audio_frame_kernels.h"
+
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+
+namespace {
+
+int16_t SaturateToInt16(float value) {
+  // Clamp before the conversion, which is undefined out of range.
+  if (value <= -32768.f)
+    return -32768;
+  if (value >= 32767.f)
+    return 32767;
+  return static_cast<int16_t>(value);
+}
+
+}  // namespace
+
+void AddWithSatC(const int16_t* src, size_t length, int16_t* dst) {
+  for (size_t i = 0; i < length; ++i) {
+    const int32_t sum = static_cast<int32_t>(dst[i]) + src[i];
+    if (sum < -32768) {
+      dst[i] = -32768;
+    } else if (sum > 32767) {
+      dst[i] = 32767;
+    } else {
+      dst[i] = static_cast<int16_t>(sum);
+    }
+  }
+}
+
+void ScaleWithSatC(float scale_even,
+                   float scale_odd,
+                   size_t length,
+                   int16_t* data) {
+  size_t i = 0;
+  for (; i + 1 < length; i += 2) {
+    data[i] = SaturateToInt16(scale_even * data[i]);
+    data[i + 1] = SaturateToInt16(scale_odd * data[i + 1]);
+  }
+  if (i < length)
+    data[i] = SaturateToInt16(scale_even * data[i]);
+}
+
+void AccumulateLevelC(const int16_t* data,
+                      size_t length,
+                      int64_t* sum_squares,
+                      int* max_abs) {
+  int64_t sum = 0;
+  int max = *max_abs;
+  for (size_t i = 0; i < length; ++i) {
+    const int32_t sample = data[i];
+    sum += sample * sample;
+    const int magnitude = sample < 0 ? -sample : sample;
+    if (magnitude > max)
+      max = magnitude;
+  }
+  *sum_squares += sum;
+  *max_abs = max;
+}
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+AddWithSatFunction GetAddWithSatFunction() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return AddWithSatSSE2;
+#else
+  // x86 CPU detection required.
+  return WebRtc_GetCPUInfo(kSSE2) ? AddWithSatSSE2 : AddWithSatC;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return AddWithSatNEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? AddWithSatNEON
+                                                        : AddWithSatC;
+#else
+  return AddWithSatC;
+#endif
+}
+
+ScaleWithSatFunction GetScaleWithSatFunction() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return ScaleWithSatSSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? ScaleWithSatSSE2 : ScaleWithSatC;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return ScaleWithSatNEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? ScaleWithSatNEON
+                                                        : ScaleWithSatC;
+#else
+  return ScaleWithSatC;
+#endif
+}
+
+AccumulateLevelFunction GetAccumulateLevelFunction() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return AccumulateLevelSSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? AccumulateLevelSSE2 : AccumulateLevelC;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return AccumulateLevelNEON;
+#elif defined(WEBRTC_DETECT_NEON)
+  return (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) ? AccumulateLevelNEON
+                                                        : AccumulateLevelC;
+#else
+  return AccumulateLevelC;
+#endif
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_KERNELS_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_KERNELS_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace internal {
+
+// Adds the |length| samples at |src| to |dst|, saturating to the int16_t
+// range.
+typedef void (*AddWithSatFunction)(const int16_t* src,
+                                   size_t length,
+                                   int16_t* dst);
+
+// Multiplies the |length| samples at |data| by |scale_even| and |scale_odd|
+// in turn, starting with |scale_even|, so that interleaved stereo can be
+// scaled per channel. The products are truncated toward zero and saturated to
+// the int16_t range.
+typedef void (*ScaleWithSatFunction)(float scale_even,
+                                     float scale_odd,
+                                     size_t length,
+                                     int16_t* data);
+
+// Adds the squares of the |length| samples at |data| to |*sum_squares| and
+// raises |*max_abs| to their largest magnitude, if larger.
+typedef void (*AccumulateLevelFunction)(const int16_t* data,
+                                        size_t length,
+                                        int64_t* sum_squares,
+                                        int* max_abs);
+
+void AddWithSatC(const int16_t* src, size_t length, int16_t* dst);
+void ScaleWithSatC(float scale_even,
+                   float scale_odd,
+                   size_t length,
+                   int16_t* data);
+void AccumulateLevelC(const int16_t* data,
+                      size_t length,
+                      int64_t* sum_squares,
+                      int* max_abs);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void AddWithSatSSE2(const int16_t* src, size_t length, int16_t* dst);
+void ScaleWithSatSSE2(float scale_even,
+                      float scale_odd,
+                      size_t length,
+                      int16_t* data);
+void AccumulateLevelSSE2(const int16_t* data,
+                         size_t length,
+                         int64_t* sum_squares,
+                         int* max_abs);
+#endif
+#if defined(WEBRTC_HAS_NEON) || defined(WEBRTC_DETECT_NEON)
+void AddWithSatNEON(const int16_t* src, size_t length, int16_t* dst);
+void ScaleWithSatNEON(float scale_even,
+                      float scale_odd,
+                      size_t length,
+                      int16_t* data);
+void AccumulateLevelNEON(const int16_t* data,
+                         size_t length,
+                         int64_t* sum_squares,
+                         int* max_abs);
+#endif
+
+// Return the fastest of the above that the CPU supports.
+AddWithSatFunction GetAddWithSatFunction();
+ScaleWithSatFunction GetScaleWithSatFunction();
+AccumulateLevelFunction GetAccumulateLevelFunction();
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_AUDIO_FRAME_KERNELS_H_
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/audio_frame_kernels.h"
+
+#include <arm_neon.h>
+
+#include <algorithm>
+
+namespace webrtc {
+namespace internal {
+
+namespace {
+
+// The float to int32 conversion truncates and saturates, and the narrowing
+// saturates to int16.
+int16x4_t ScaleFour(int16x4_t samples, float32x4_t scale) {
+  const float32x4_t scaled =
+      vmulq_f32(vcvtq_f32_s32(vmovl_s16(samples)), scale);
+  return vqmovn_s32(vcvtq_s32_f32(scaled));
+}
+
+}  // namespace
+
+void AddWithSatNEON(const int16_t* src, size_t length, int16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const int16x8_t a0 = vld1q_s16(dst + i);
+    const int16x8_t a1 = vld1q_s16(dst + i + 8);
+    vst1q_s16(dst + i, vqaddq_s16(a0, vld1q_s16(src + i)));
+    vst1q_s16(dst + i + 8, vqaddq_s16(a1, vld1q_s16(src + i + 8)));
+  }
+  AddWithSatC(src + i, length - i, dst + i);
+}
+
+void ScaleWithSatNEON(float scale_even,
+                      float scale_odd,
+                      size_t length,
+                      int16_t* data) {
+  const float scales[4] = {scale_even, scale_odd, scale_even, scale_odd};
+  const float32x4_t scale = vld1q_f32(scales);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const int16x8_t samples = vld1q_s16(data + i);
+    vst1q_s16(data + i, vcombine_s16(ScaleFour(vget_low_s16(samples), scale),
+                                     ScaleFour(vget_high_s16(samples), scale)));
+  }
+  // |i| is even, so the remainder starts with an even sample.
+  ScaleWithSatC(scale_even, scale_odd, length - i, data + i);
+}
+
+void AccumulateLevelNEON(const int16_t* data,
+                         size_t length,
+                         int64_t* sum_squares,
+                         int* max_abs) {
+  int64x2_t sum = vdupq_n_s64(0);
+  int16x8_t max = vdupq_n_s16(0);
+  int16x8_t min = vdupq_n_s16(0);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const int16x8_t samples = vld1q_s16(data + i);
+    const int16x4_t low = vget_low_s16(samples);
+    const int16x4_t high = vget_high_s16(samples);
+    // Each square is at most 2^30, so pairs are summed before widening.
+    sum = vpadalq_s32(sum, vmull_s16(low, low));
+    sum = vpadalq_s32(sum, vmull_s16(high, high));
+    max = vmaxq_s16(max, samples);
+    min = vminq_s16(min, samples);
+  }
+  int16_t maxes[8];
+  int16_t mins[8];
+  vst1q_s16(maxes, max);
+  vst1q_s16(mins, min);
+  *sum_squares += vgetq_lane_s64(sum, 0) + vgetq_lane_s64(sum, 1);
+  for (int j = 0; j < 8; ++j) {
+    *max_abs = std::max(*max_abs, std::max<int>(maxes[j], -mins[j]));
+  }
+  AccumulateLevelC(data + i, length - i, sum_squares, max_abs);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/audio_frame_kernels.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+
+namespace webrtc {
+namespace internal {
+
+namespace {
+
+// Scales four samples, widened to int32, and returns them as int32.
+__m128i ScaleFour(__m128i samples, __m128 scale) {
+  const __m128 kMin = _mm_set1_ps(-32768.f);
+  const __m128 kMax = _mm_set1_ps(32767.f);
+  __m128 scaled = _mm_mul_ps(_mm_cvtepi32_ps(samples), scale);
+  scaled = _mm_min_ps(_mm_max_ps(scaled, kMin), kMax);
+  return _mm_cvttps_epi32(scaled);
+}
+
+}  // namespace
+
+void AddWithSatSSE2(const int16_t* src, size_t length, int16_t* dst) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i a0 = _mm_loadu_si128(out);
+    const __m128i a1 = _mm_loadu_si128(out + 1);
+    _mm_storeu_si128(out, _mm_adds_epi16(a0, _mm_loadu_si128(in)));
+    _mm_storeu_si128(out + 1, _mm_adds_epi16(a1, _mm_loadu_si128(in + 1)));
+  }
+  AddWithSatC(src + i, length - i, dst + i);
+}
+
+void ScaleWithSatSSE2(float scale_even,
+                      float scale_odd,
+                      size_t length,
+                      int16_t* data) {
+  const __m128 scale =
+      _mm_setr_ps(scale_even, scale_odd, scale_even, scale_odd);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Sign extend to int32 by moving each sample to the upper half.
+    const __m128i low =
+        _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    const __m128i high =
+        _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i),
+                     _mm_packs_epi32(ScaleFour(low, scale),
+                                     ScaleFour(high, scale)));
+  }
+  // |i| is even, so the remainder starts with an even sample.
+  ScaleWithSatC(scale_even, scale_odd, length - i, data + i);
+}
+
+void AccumulateLevelSSE2(const int16_t* data,
+                         size_t length,
+                         int64_t* sum_squares,
+                         int* max_abs) {
+  const __m128i kZero = _mm_setzero_si128();
+  __m128i sum = kZero;
+  // Track the extremes rather than magnitudes, which cannot represent 32768.
+  __m128i max = kZero;
+  __m128i min = kZero;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // A sum of two squares is at most 2^31, so it fits the lanes as unsigned
+    // and is widened with zeros.
+    const __m128i pairs = _mm_madd_epi16(samples, samples);
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(pairs, kZero));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(pairs, kZero));
+    max = _mm_max_epi16(max, samples);
+    min = _mm_min_epi16(min, samples);
+  }
+  int64_t sums[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+  int16_t maxes[8];
+  int16_t mins[8];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(maxes), max);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(mins), min);
+  *sum_squares += sums[0] + sums[1];
+  for (int j = 0; j < 8; ++j) {
+    *max_abs = std::max(*max_abs, std::max<int>(maxes[j], -mins[j]));
+  }
+  AccumulateLevelC(data + i, length - i, sum_squares, max_abs);
+}
+
+}  // namespace internal
+}  // namespace webrtc
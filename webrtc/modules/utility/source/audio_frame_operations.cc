@@ -10,9 +10,53 @@
 
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
+#include "webrtc/modules/utility/source/audio_frame_kernels.h"
 
 namespace webrtc {
 
+void AudioFrameOperations::Add(const AudioFrame& frame_to_add,
+                               AudioFrame* result_frame) {
+  // Sanity check.
+  assert((result_frame->num_channels_ > 0) &&
+         (result_frame->num_channels_ < 3));
+  assert(result_frame->interleaved_ == frame_to_add.interleaved_);
+  if ((result_frame->num_channels_ > 2) || (result_frame->num_channels_ < 1))
+    return;
+  if (result_frame->num_channels_ != frame_to_add.num_channels_)
+    return;
+
+  bool no_previous_data = false;
+  if (result_frame->samples_per_channel_ != frame_to_add.samples_per_channel_) {
+    if (result_frame->samples_per_channel_ != 0)
+      return;
+    // Special case we have no data to start with.
+    result_frame->samples_per_channel_ = frame_to_add.samples_per_channel_;
+    no_previous_data = true;
+  }
+
+  if (result_frame->vad_activity_ == AudioFrame::kVadActive ||
+      frame_to_add.vad_activity_ == AudioFrame::kVadActive) {
+    result_frame->vad_activity_ = AudioFrame::kVadActive;
+  } else if (result_frame->vad_activity_ == AudioFrame::kVadUnknown ||
+             frame_to_add.vad_activity_ == AudioFrame::kVadUnknown) {
+    result_frame->vad_activity_ = AudioFrame::kVadUnknown;
+  }
+
+  if (result_frame->speech_type_ != frame_to_add.speech_type_)
+    result_frame->speech_type_ = AudioFrame::kUndefined;
+
+  const size_t length =
+      frame_to_add.samples_per_channel_ * frame_to_add.num_channels_;
+  if (no_previous_data) {
+    memcpy(result_frame->data_, frame_to_add.data_, sizeof(int16_t) * length);
+  } else {
+    internal::GetAddWithSatFunction()(frame_to_add.data_, length,
+                                      result_frame->data_);
+  }
+  result_frame->energy_ = 0xffffffff;
+  result_frame->sum_squares_ = -1;
+}
+
 void AudioFrameOperations::MonoToStereo(const int16_t* src_audio,
                                         size_t samples_per_channel,
                                         int16_t* dst_audio) {
@@ -36,6 +80,7 @@ int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
          sizeof(int16_t) * frame->samples_per_channel_);
   MonoToStereo(data_copy, frame->samples_per_channel_, frame->data_);
   frame->num_channels_ = 2;
+  frame->sum_squares_ = -1;
 
   return 0;
 }
@@ -55,6 +100,7 @@ int AudioFrameOperations::StereoToMono(AudioFrame* frame) {
 
   StereoToMono(frame->data_, frame->samples_per_channel_, frame->data_);
   frame->num_channels_ = 1;
+  frame->sum_squares_ = -1;
 
   return 0;
 }
@@ -72,6 +118,8 @@ void AudioFrameOperations::SwapStereoChannels(AudioFrame* frame) {
 void AudioFrameOperations::Mute(AudioFrame& frame) {
   memset(frame.data_, 0, sizeof(int16_t) *
       frame.samples_per_channel_ * frame.num_channels_);
+  frame.sum_squares_ = 0;
+  frame.max_abs_ = 0;
 }
 
 int AudioFrameOperations::Scale(float left, float right, AudioFrame& frame) {
@@ -79,31 +127,30 @@ int AudioFrameOperations::Scale(float left, float right, AudioFrame& frame) {
     return -1;
   }
 
-  for (size_t i = 0; i < frame.samples_per_channel_; i++) {
-    frame.data_[2 * i] =
-        static_cast<int16_t>(left * frame.data_[2 * i]);
-    frame.data_[2 * i + 1] =
-        static_cast<int16_t>(right * frame.data_[2 * i + 1]);
-  }
+  internal::GetScaleWithSatFunction()(left, right,
+                                      frame.samples_per_channel_ * 2,
+                                      frame.data_);
+  frame.sum_squares_ = -1;
   return 0;
 }
 
 int AudioFrameOperations::ScaleWithSat(float scale, AudioFrame& frame) {
-  int32_t temp_data = 0;
-
   // Ensure that the output result is saturated [-32768, +32767].
-  for (size_t i = 0; i < frame.samples_per_channel_ * frame.num_channels_;
-       i++) {
-    temp_data = static_cast<int32_t>(scale * frame.data_[i]);
-    if (temp_data < -32768) {
-      frame.data_[i] = -32768;
-    } else if (temp_data > 32767) {
-      frame.data_[i] = 32767;
-    } else {
-      frame.data_[i] = static_cast<int16_t>(temp_data);
-    }
-  }
+  internal::GetScaleWithSatFunction()(
+      scale, scale, frame.samples_per_channel_ * frame.num_channels_,
+      frame.data_);
+  frame.sum_squares_ = -1;
   return 0;
 }
 
+void AudioFrameOperations::UpdateLevel(AudioFrame* frame) {
+  int64_t sum_squares = 0;
+  int max_abs = 0;
+  internal::GetAccumulateLevelFunction()(
+      frame->data_, frame->samples_per_channel_ * frame->num_channels_,
+      &sum_squares, &max_abs);
+  frame->sum_squares_ = sum_squares;
+  frame->max_abs_ = max_abs;
+}
+
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
+#include "webrtc/modules/utility/source/audio_frame_kernels.h"
 
 namespace webrtc {
 namespace {
@@ -164,8 +165,7 @@ TEST_F(AudioFrameOperationsTest, DISABLED_ScaleFailsWithBadParameters) {
   EXPECT_EQ(-1, AudioFrameOperations::Scale(1.0, -1.0, frame_));
 }
 
-// TODO(andrew): fix the wraparound bug. We should always saturate.
-TEST_F(AudioFrameOperationsTest, DISABLED_ScaleDoesNotWrapAround) {
+TEST_F(AudioFrameOperationsTest, ScaleDoesNotWrapAround) {
   SetFrameData(&frame_, 4000, -4000);
   EXPECT_EQ(0, AudioFrameOperations::Scale(10.0, 10.0, frame_));
 
@@ -221,5 +221,94 @@ TEST_F(AudioFrameOperationsTest, ScaleWithSatSucceeds) {
   VerifyFramesAreEqual(scaled_frame, frame_);
 }
 
+TEST_F(AudioFrameOperationsTest, AddingToEmptyFrameCopies) {
+  AudioFrame frame_to_add;
+  frame_to_add.samples_per_channel_ = 320;
+  frame_to_add.num_channels_ = 2;
+  SetFrameData(&frame_to_add, 1000, -1000);
+  frame_to_add.vad_activity_ = AudioFrame::kVadActive;
+
+  frame_.samples_per_channel_ = 0;
+  frame_.vad_activity_ = AudioFrame::kVadPassive;
+  AudioFrameOperations::Add(frame_to_add, &frame_);
+  EXPECT_EQ(AudioFrame::kVadActive, frame_.vad_activity_);
+  VerifyFramesAreEqual(frame_to_add, frame_);
+}
+
+TEST_F(AudioFrameOperationsTest, AddSaturates) {
+  SetFrameData(&frame_, 30000, -30000);
+  AudioFrame frame_to_add;
+  frame_to_add.samples_per_channel_ = 320;
+  frame_to_add.num_channels_ = 2;
+  SetFrameData(&frame_to_add, 3000, -3000);
+  AudioFrameOperations::Add(frame_to_add, &frame_);
+
+  AudioFrame sum_frame;
+  sum_frame.samples_per_channel_ = 320;
+  sum_frame.num_channels_ = 2;
+  SetFrameData(&sum_frame, 32767, -32768);
+  VerifyFramesAreEqual(sum_frame, frame_);
+
+  // Mismatching frames are ignored.
+  frame_to_add.num_channels_ = 1;
+  AudioFrameOperations::Add(frame_to_add, &frame_);
+  VerifyFramesAreEqual(sum_frame, frame_);
+}
+
+// The kernels picked for this CPU must give the same result as the C ones for
+// all lengths, including those which leave a remainder.
+TEST(AudioFrameKernelsTest, OptimizedKernelsAreBitExact) {
+  const size_t kLength = 75;
+  int16_t src[kLength];
+  int16_t dst[kLength];
+  for (size_t i = 0; i < kLength; ++i) {
+    src[i] = static_cast<int16_t>((i * 7919) % 65536 - 32768);
+    dst[i] = static_cast<int16_t>((i * 104729) % 65536 - 32768);
+  }
+  const internal::AddWithSatFunction add = internal::GetAddWithSatFunction();
+  const internal::ScaleWithSatFunction scale =
+      internal::GetScaleWithSatFunction();
+  const internal::AccumulateLevelFunction accumulate_level =
+      internal::GetAccumulateLevelFunction();
+  for (size_t length = 0; length <= kLength; ++length) {
+    int16_t expected[kLength];
+    int16_t actual[kLength];
+    memcpy(expected, dst, sizeof(dst));
+    memcpy(actual, dst, sizeof(dst));
+    internal::AddWithSatC(src, length, expected);
+    add(src, length, actual);
+    EXPECT_EQ(0, memcmp(expected, actual, sizeof(expected))) << length;
+
+    memcpy(expected, dst, sizeof(dst));
+    memcpy(actual, dst, sizeof(dst));
+    internal::ScaleWithSatC(1.7f, -0.3f, length, expected);
+    scale(1.7f, -0.3f, length, actual);
+    EXPECT_EQ(0, memcmp(expected, actual, sizeof(expected))) << length;
+
+    int64_t expected_sum_squares = 0;
+    int64_t actual_sum_squares = 0;
+    int expected_max_abs = 0;
+    int actual_max_abs = 0;
+    internal::AccumulateLevelC(src, length, &expected_sum_squares,
+                               &expected_max_abs);
+    accumulate_level(src, length, &actual_sum_squares, &actual_max_abs);
+    EXPECT_EQ(expected_sum_squares, actual_sum_squares) << length;
+    EXPECT_EQ(expected_max_abs, actual_max_abs) << length;
+  }
+}
+
+TEST_F(AudioFrameOperationsTest, UpdateLevelCoversAllChannels) {
+  SetFrameData(&frame_, 3, -32768);
+  AudioFrameOperations::UpdateLevel(&frame_);
+  EXPECT_EQ(320 * (9 + 32768LL * 32768), frame_.sum_squares_);
+  EXPECT_EQ(32768, frame_.max_abs_);
+
+  AudioFrameOperations::ScaleWithSat(0.5f, frame_);
+  EXPECT_EQ(-1, frame_.sum_squares_);
+  AudioFrameOperations::Mute(frame_);
+  EXPECT_EQ(0, frame_.sum_squares_);
+  EXPECT_EQ(0, frame_.max_abs_);
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -0,0 +1,463 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/process_thread_pool_impl.h"
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <queue>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/thread_checker.h"
+#include "webrtc/modules/include/module.h"
+#include "webrtc/system_wrappers/include/tick_util.h"
+
+namespace webrtc {
+namespace {
+
+// We use this constant internally to signal that a module has requested
+// a callback right away.  When this is set, no call to TimeUntilNextProcess
+// should be made, but Process() should be called directly.
+const int64_t kCallProcessImmediately = -1;
+
+int64_t GetNextCallbackTime(Module* module, int64_t time_now) {
+  int64_t interval = module->TimeUntilNextProcess();
+  if (interval < 0) {
+    // Falling behind, we should call the callback now.
+    return time_now;
+  }
+  return time_now + interval;
+}
+}  // namespace
+
+// A ProcessThread whose modules and tasks are run by the workers of a
+// ProcessThreadPoolImpl.
+class PooledProcessThread : public ProcessThread {
+ public:
+  PooledProcessThread(ProcessThreadPoolImpl* pool, const char* thread_name);
+  ~PooledProcessThread() override;
+
+  void Start() override;
+  void Stop() override;
+
+  void WakeUp(Module* module) override;
+  void PostTask(rtc::scoped_ptr<ProcessTask> task) override;
+
+  void RegisterModule(Module* module) override;
+  void DeRegisterModule(Module* module) override;
+
+  // Processes the modules that are due and runs the queued tasks. Returns the
+  // time when the next module is due. Called on a worker.
+  int64_t Process();
+
+ private:
+  friend class ProcessThreadPoolImpl;
+
+  struct ModuleCallback {
+    explicit ModuleCallback(Module* module)
+        : module(module), next_callback(0) {}
+
+    Module* const module;
+    int64_t next_callback;  // Absolute timestamp.
+  };
+
+  ProcessThreadPoolImpl* const pool_;
+  rtc::ThreadChecker thread_checker_;
+
+  rtc::CriticalSection lock_;  // Used to guard modules_, queue_ and started_.
+  std::list<ModuleCallback> modules_;
+  std::queue<ProcessTask*> queue_;
+  bool started_;
+  const char* thread_name_;
+
+  // Scheduling state, guarded by the pool's lock.
+  bool schedulable_;
+  // On a run queue, or being run by a worker.
+  bool scheduled_;
+  // Woken up while scheduled, so it needs to run again.
+  bool wake_pending_;
+  // When it's due in the pool's timer heap, or -1.
+  int64_t timer_ms_;
+  // Signaled when it stops being scheduled while not schedulable.
+  rtc::Event unscheduled_;
+};
+
+PooledProcessThread::PooledProcessThread(ProcessThreadPoolImpl* pool,
+                                         const char* thread_name)
+    : pool_(pool),
+      started_(false),
+      thread_name_(thread_name),
+      schedulable_(false),
+      scheduled_(false),
+      wake_pending_(false),
+      timer_ms_(-1),
+      unscheduled_(false, false) {}
+
+PooledProcessThread::~PooledProcessThread() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  RTC_DCHECK(!started_);
+
+  while (!queue_.empty()) {
+    delete queue_.front();
+    queue_.pop();
+  }
+  pool_->RemoveThread(this);
+}
+
+void PooledProcessThread::Start() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK(!started_);
+    if (started_)
+      return;
+    started_ = true;
+    for (ModuleCallback& m : modules_)
+      m.module->ProcessThreadAttached(this);
+  }
+  pool_->Start(this);
+}
+
+void PooledProcessThread::Stop() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  // Once this returns, no worker is processing, or will process, this thread.
+  pool_->Stop(this);
+
+  rtc::CritScope lock(&lock_);
+  if (!started_)
+    return;
+  started_ = false;
+  for (ModuleCallback& m : modules_)
+    m.module->ProcessThreadAttached(nullptr);
+}
+
+void PooledProcessThread::WakeUp(Module* module) {
+  // Allowed to be called on any thread.
+  {
+    rtc::CritScope lock(&lock_);
+    for (ModuleCallback& m : modules_) {
+      if (m.module == module)
+        m.next_callback = kCallProcessImmediately;
+    }
+  }
+  pool_->Schedule(this);
+}
+
+void PooledProcessThread::PostTask(rtc::scoped_ptr<ProcessTask> task) {
+  // Allowed to be called on any thread.
+  {
+    rtc::CritScope lock(&lock_);
+    queue_.push(task.release());
+  }
+  pool_->Schedule(this);
+}
+
+void PooledProcessThread::RegisterModule(Module* module) {
+  RTC_DCHECK(module);
+  {
+    rtc::CritScope lock(&lock_);
+#if (!defined(NDEBUG) || defined(DCHECK_ALWAYS_ON))
+    // Catch programmer error.
+    for (const ModuleCallback& mc : modules_)
+      RTC_DCHECK(mc.module != module);
+#endif
+    if (started_)
+      module->ProcessThreadAttached(this);
+    modules_.push_back(ModuleCallback(module));
+  }
+
+  // The waiting time for the just registered module may be shorter than for
+  // all other registered modules.
+  pool_->Schedule(this);
+}
+
+void PooledProcessThread::DeRegisterModule(Module* module) {
+  // Allowed to be called on any thread. Since the lock is held while modules
+  // are processed, the module is not being processed once this returns.
+  RTC_DCHECK(module);
+  rtc::CritScope lock(&lock_);
+  modules_.remove_if([&module](const ModuleCallback& m) {
+      return m.module == module;
+    });
+  if (started_)
+    module->ProcessThreadAttached(nullptr);
+}
+
+int64_t PooledProcessThread::Process() {
+  int64_t now = TickTime::MillisecondTimestamp();
+  int64_t next_checkpoint = now + (1000 * 60);
+
+  rtc::CritScope lock(&lock_);
+  if (!started_)
+    return next_checkpoint;
+  for (ModuleCallback& m : modules_) {
+    if (m.next_callback == 0)
+      m.next_callback = GetNextCallbackTime(m.module, now);
+
+    if (m.next_callback <= now ||
+        m.next_callback == kCallProcessImmediately) {
+      m.module->Process();
+      // Use a new 'now' reference to calculate when the next callback
+      // should occur.  We'll continue to use 'now' above for the baseline
+      // of calculating how long we should wait, to reduce variance.
+      int64_t new_now = TickTime::MillisecondTimestamp();
+      m.next_callback = GetNextCallbackTime(m.module, new_now);
+    }
+
+    if (m.next_callback < next_checkpoint)
+      next_checkpoint = m.next_callback;
+  }
+
+  while (!queue_.empty()) {
+    ProcessTask* task = queue_.front();
+    queue_.pop();
+    lock_.Leave();
+    task->Run();
+    delete task;
+    lock_.Enter();
+  }
+  return next_checkpoint;
+}
+
+ProcessThreadPool::~ProcessThreadPool() {}
+
+// static
+rtc::scoped_ptr<ProcessThreadPool> ProcessThreadPool::Create(
+    size_t num_workers) {
+  return rtc::scoped_ptr<ProcessThreadPool>(
+      new ProcessThreadPoolImpl(num_workers));
+}
+
+ProcessThreadPoolImpl::Worker::Worker(ProcessThreadPoolImpl* pool,
+                                      size_t index)
+    : pool(pool),
+      index(index),
+      wake_up(false, false),
+      idle(false),
+      thread(&ProcessThreadPoolImpl::Run, this, "ProcessThreadPool") {}
+
+ProcessThreadPoolImpl::ProcessThreadPoolImpl(size_t num_workers)
+    : next_worker_(0), num_threads_(0), stop_(false) {
+  RTC_DCHECK_GT(num_workers, 0u);
+  for (size_t i = 0; i < num_workers; ++i)
+    workers_.push_back(new Worker(this, i));
+  for (Worker* worker : workers_)
+    worker->thread.Start();
+}
+
+ProcessThreadPoolImpl::~ProcessThreadPoolImpl() {
+  {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK_EQ(0u, num_threads_);
+    stop_ = true;
+  }
+  for (Worker* worker : workers_)
+    worker->wake_up.Set();
+  for (Worker* worker : workers_)
+    worker->thread.Stop();
+}
+
+rtc::scoped_ptr<ProcessThread> ProcessThreadPoolImpl::CreateProcessThread(
+    const char* thread_name) {
+  {
+    rtc::CritScope lock(&lock_);
+    ++num_threads_;
+  }
+  return rtc::scoped_ptr<ProcessThread>(
+      new PooledProcessThread(this, thread_name));
+}
+
+// static
+bool ProcessThreadPoolImpl::Run(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  return worker->pool->Process(worker);
+}
+
+bool ProcessThreadPoolImpl::Process(Worker* worker) {
+  PooledProcessThread* thread = Dequeue(worker);
+  if (thread) {
+    int64_t next_process_ms = thread->Process();
+    Reschedule(thread, worker, next_process_ms);
+    return true;
+  }
+
+  // Out of work; pick up the threads that are due, or wait until one is.
+  int wait_ms = rtc::Event::kForever;
+  {
+    rtc::CritScope lock(&lock_);
+    if (stop_)
+      return false;
+    int64_t now = TickTime::MillisecondTimestamp();
+    size_t num_due = 0;
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+      PooledProcessThread* due = timers_.begin()->second;
+      timers_.erase(timers_.begin());
+      due->timer_ms_ = -1;
+      due->scheduled_ = true;
+      rtc::CritScope queue_lock(&worker->queue_lock);
+      worker->queue.push_back(due);
+      ++num_due;
+    }
+    if (num_due > 0) {
+      // Let an idle worker steal the ones we won't get to right away.
+      if (num_due > 1)
+        WakeUpIdleWorker();
+      return true;
+    }
+    worker->idle = true;
+    if (!timers_.empty()) {
+      wait_ms = static_cast<int>(std::min<int64_t>(
+          timers_.begin()->first - now, std::numeric_limits<int>::max()));
+    }
+  }
+  worker->wake_up.Wait(wait_ms);
+  {
+    rtc::CritScope lock(&lock_);
+    worker->idle = false;
+  }
+  return true;
+}
+
+void ProcessThreadPoolImpl::Enqueue(PooledProcessThread* thread,
+                                    Worker* worker) {
+  {
+    rtc::CritScope lock(&worker->queue_lock);
+    worker->queue.push_back(thread);
+  }
+  worker->wake_up.Set();
+  // If |worker| is busy, have an idle one steal the thread.
+  rtc::CritScope lock(&lock_);
+  if (!worker->idle)
+    WakeUpIdleWorker();
+}
+
+PooledProcessThread* ProcessThreadPoolImpl::Dequeue(Worker* worker) {
+  {
+    rtc::CritScope lock(&worker->queue_lock);
+    if (!worker->queue.empty()) {
+      PooledProcessThread* thread = worker->queue.front();
+      worker->queue.pop_front();
+      return thread;
+    }
+  }
+  // Steal from the back of the other run queues.
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker* other = workers_[(worker->index + i) % workers_.size()];
+    rtc::CritScope lock(&other->queue_lock);
+    if (!other->queue.empty()) {
+      PooledProcessThread* thread = other->queue.back();
+      other->queue.pop_back();
+      return thread;
+    }
+  }
+  return nullptr;
+}
+
+void ProcessThreadPoolImpl::Start(PooledProcessThread* thread) {
+  {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK(!thread->schedulable_);
+    thread->schedulable_ = true;
+  }
+  Schedule(thread);
+}
+
+void ProcessThreadPoolImpl::Stop(PooledProcessThread* thread) {
+  lock_.Enter();
+  thread->schedulable_ = false;
+  thread->wake_pending_ = false;
+  CancelTimer(thread);
+  while (thread->scheduled_) {
+    lock_.Leave();
+    thread->unscheduled_.Wait(rtc::Event::kForever);
+    lock_.Enter();
+  }
+  lock_.Leave();
+}
+
+void ProcessThreadPoolImpl::Schedule(PooledProcessThread* thread) {
+  Worker* worker = nullptr;
+  {
+    rtc::CritScope lock(&lock_);
+    if (!thread->schedulable_)
+      return;
+    if (thread->scheduled_) {
+      thread->wake_pending_ = true;
+      return;
+    }
+    CancelTimer(thread);
+    thread->scheduled_ = true;
+    worker = workers_[next_worker_];
+    next_worker_ = (next_worker_ + 1) % workers_.size();
+  }
+  Enqueue(thread, worker);
+}
+
+void ProcessThreadPoolImpl::Reschedule(PooledProcessThread* thread,
+                                       Worker* worker,
+                                       int64_t next_process_ms) {
+  {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK(thread->scheduled_);
+    if (!thread->wake_pending_) {
+      // Once not scheduled, |thread| may be deleted as soon as the lock is
+      // released.
+      thread->scheduled_ = false;
+      if (thread->schedulable_)
+        SetTimer(thread, next_process_ms);
+      else
+        thread->unscheduled_.Set();
+      return;
+    }
+    thread->wake_pending_ = false;
+  }
+  // Woken up while running; run it again on this worker.
+  rtc::CritScope lock(&worker->queue_lock);
+  worker->queue.push_front(thread);
+}
+
+void ProcessThreadPoolImpl::RemoveThread(PooledProcessThread* thread) {
+  rtc::CritScope lock(&lock_);
+  RTC_DCHECK(!thread->scheduled_);
+  RTC_DCHECK_EQ(-1, thread->timer_ms_);
+  RTC_DCHECK_GT(num_threads_, 0u);
+  --num_threads_;
+}
+
+void ProcessThreadPoolImpl::SetTimer(PooledProcessThread* thread,
+                                     int64_t time_ms) {
+  RTC_DCHECK_EQ(-1, thread->timer_ms_);
+  bool earliest = timers_.empty() || time_ms < timers_.begin()->first;
+  timers_.insert(std::make_pair(time_ms, thread));
+  thread->timer_ms_ = time_ms;
+  // Idle workers may be waiting for a later timer.
+  if (earliest)
+    WakeUpIdleWorker();
+}
+
+void ProcessThreadPoolImpl::CancelTimer(PooledProcessThread* thread) {
+  if (thread->timer_ms_ == -1)
+    return;
+  timers_.erase(std::make_pair(thread->timer_ms_, thread));
+  thread->timer_ms_ = -1;
+}
+
+void ProcessThreadPoolImpl::WakeUpIdleWorker() {
+  for (Worker* worker : workers_) {
+    if (worker->idle) {
+      worker->idle = false;
+      worker->wake_up.Set();
+      return;
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_POOL_IMPL_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_POOL_IMPL_H_
+
+#include <deque>
+#include <set>
+#include <utility>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/utility/include/process_thread_pool.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+
+namespace webrtc {
+
+class PooledProcessThread;
+
+// Every ProcessThread created by the pool is scheduled as a unit: when one of
+// its modules is due, or it has tasks, it is put on the run queue of one of
+// the workers, and the worker processes everything that is due in it before
+// picking the next one. Workers that run out of work steal from the back of
+// the other run queues before going to sleep. ProcessThreads that have
+// nothing to do until later are kept in a timer heap ordered on when their
+// next module is due; idle workers wait for the earliest of those.
+class ProcessThreadPoolImpl : public ProcessThreadPool {
+ public:
+  explicit ProcessThreadPoolImpl(size_t num_workers);
+  ~ProcessThreadPoolImpl() override;
+
+  rtc::scoped_ptr<ProcessThread> CreateProcessThread(
+      const char* thread_name) override;
+
+ private:
+  friend class PooledProcessThread;
+
+  struct Worker {
+    Worker(ProcessThreadPoolImpl* pool, size_t index);
+
+    ProcessThreadPoolImpl* const pool;
+    const size_t index;
+    rtc::Event wake_up;
+    rtc::CriticalSection queue_lock;
+    std::deque<PooledProcessThread*> queue GUARDED_BY(queue_lock);
+    bool idle;  // Guarded by the pool's |lock_|.
+    rtc::PlatformThread thread;
+  };
+
+  static bool Run(void* obj);
+  bool Process(Worker* worker);
+
+  // Puts |thread|, which must have been marked as scheduled, on the run queue
+  // of |worker| and makes sure that some worker will pick it up.
+  void Enqueue(PooledProcessThread* thread, Worker* worker);
+  PooledProcessThread* Dequeue(Worker* worker);
+
+  // Called by PooledProcessThread when it's started, and schedules it.
+  void Start(PooledProcessThread* thread);
+  // Waits until |thread| is neither scheduled nor running, and keeps it from
+  // being scheduled until it is started again.
+  void Stop(PooledProcessThread* thread);
+  // Called by PooledProcessThread to have itself run as soon as possible.
+  void Schedule(PooledProcessThread* thread);
+  // Called by the worker that has run |thread|, with the time when it's next
+  // due.
+  void Reschedule(PooledProcessThread* thread,
+                  Worker* worker,
+                  int64_t next_process_ms);
+  // Called when |thread| is destroyed.
+  void RemoveThread(PooledProcessThread* thread);
+
+  void SetTimer(PooledProcessThread* thread, int64_t time_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void CancelTimer(PooledProcessThread* thread)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void WakeUpIdleWorker() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Guards the scheduling state of the pool and of the PooledProcessThreads.
+  rtc::CriticalSection lock_;
+  // Pairs of (due time, thread), earliest first.
+  std::set<std::pair<int64_t, PooledProcessThread*>> timers_ GUARDED_BY(lock_);
+  size_t next_worker_ GUARDED_BY(lock_);
+  size_t num_threads_ GUARDED_BY(lock_);
+  bool stop_ GUARDED_BY(lock_);
+  ScopedVector<Worker> workers_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_PROCESS_THREAD_POOL_IMPL_H_
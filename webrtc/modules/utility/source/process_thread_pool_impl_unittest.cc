@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/modules/include/module.h"
+#include "webrtc/modules/utility/source/process_thread_pool_impl.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+
+const int kTimeoutMs = 5000;
+
+class MockModule : public Module {
+ public:
+  MOCK_METHOD0(TimeUntilNextProcess, int64_t());
+  MOCK_METHOD0(Process, int32_t());
+  MOCK_METHOD1(ProcessThreadAttached, void(ProcessThread*));
+};
+
+class RaiseEventTask : public ProcessTask {
+ public:
+  explicit RaiseEventTask(rtc::Event* event) : event_(event) {}
+  void Run() override { event_->Set(); }
+
+ private:
+  rtc::Event* const event_;
+};
+
+ACTION_P(SetEvent, event) {
+  event->Set();
+}
+
+// Signals once it has been processed |expected_calls| times, and records if it
+// was ever processed concurrently with the other modules of its thread.
+class CountingModule : public Module {
+ public:
+  CountingModule(int expected_calls, volatile int* running)
+      : expected_calls_(expected_calls),
+        running_(running),
+        calls_(0),
+        concurrent_(false),
+        done_(false, false) {}
+
+  int64_t TimeUntilNextProcess() override { return 5; }
+
+  int32_t Process() override {
+    if (rtc::AtomicOps::Increment(running_) != 1)
+      concurrent_ = true;
+    SleepMs(1);
+    rtc::AtomicOps::Decrement(running_);
+    if (++calls_ == expected_calls_)
+      done_.Set();
+    return 0;
+  }
+
+  void ProcessThreadAttached(ProcessThread* process_thread) override {}
+
+  bool Wait() { return done_.Wait(kTimeoutMs); }
+  bool concurrent() const { return concurrent_; }
+
+ private:
+  const int expected_calls_;
+  volatile int* const running_;
+  int calls_;
+  bool concurrent_;
+  rtc::Event done_;
+};
+}  // namespace
+
+TEST(ProcessThreadPoolImpl, StartStop) {
+  ProcessThreadPoolImpl pool(2);
+  rtc::scoped_ptr<ProcessThread> thread(pool.CreateProcessThread("Thread"));
+  for (int i = 0; i < 5; ++i) {
+    thread->Start();
+    thread->Stop();
+  }
+}
+
+TEST(ProcessThreadPoolImpl, ProcessCall) {
+  ProcessThreadPoolImpl pool(2);
+  rtc::scoped_ptr<ProcessThread> thread(pool.CreateProcessThread("Thread"));
+  rtc::Event event(false, false);
+
+  MockModule module;
+  EXPECT_CALL(module, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(module, Process())
+      .WillOnce(DoAll(SetEvent(&event), Return(0)))
+      .WillRepeatedly(Return(0));
+  EXPECT_CALL(module, ProcessThreadAttached(thread.get())).Times(1);
+
+  thread->RegisterModule(&module);
+  thread->Start();
+  EXPECT_TRUE(event.Wait(kTimeoutMs));
+
+  EXPECT_CALL(module, ProcessThreadAttached(nullptr)).Times(1);
+  thread->Stop();
+}
+
+TEST(ProcessThreadPoolImpl, NotProcessedAfterDeregister) {
+  ProcessThreadPoolImpl pool(1);
+  rtc::scoped_ptr<ProcessThread> thread(pool.CreateProcessThread("Thread"));
+  rtc::Event event(false, false);
+
+  MockModule module;
+  EXPECT_CALL(module, TimeUntilNextProcess()).WillRepeatedly(Return(0));
+  EXPECT_CALL(module, Process())
+      .WillRepeatedly(DoAll(SetEvent(&event), Return(0)));
+  EXPECT_CALL(module, ProcessThreadAttached(_)).Times(2);
+
+  thread->Start();
+  thread->RegisterModule(&module);
+  EXPECT_TRUE(event.Wait(kTimeoutMs));
+  thread->DeRegisterModule(&module);
+
+  ::testing::Mock::VerifyAndClearExpectations(&module);
+  EXPECT_CALL(module, Process()).Times(0);
+  EXPECT_CALL(module, TimeUntilNextProcess()).Times(0);
+  SleepMs(20);
+  thread->Stop();
+}
+
+// A module that is due in a long time is processed once it's woken up.
+TEST(ProcessThreadPoolImpl, WakeUp) {
+  ProcessThreadPoolImpl pool(2);
+  rtc::scoped_ptr<ProcessThread> thread(pool.CreateProcessThread("Thread"));
+  rtc::Event event(false, false);
+
+  MockModule module;
+  EXPECT_CALL(module, TimeUntilNextProcess()).WillRepeatedly(Return(1000));
+  EXPECT_CALL(module, ProcessThreadAttached(_)).Times(2);
+  EXPECT_CALL(module, Process())
+      .WillOnce(DoAll(SetEvent(&event), Return(0)))
+      .WillRepeatedly(Return(0));
+
+  thread->RegisterModule(&module);
+  thread->Start();
+  SleepMs(20);
+  thread->WakeUp(&module);
+  EXPECT_TRUE(event.Wait(kTimeoutMs / 10));
+  thread->Stop();
+}
+
+TEST(ProcessThreadPoolImpl, PostTask) {
+  ProcessThreadPoolImpl pool(2);
+  rtc::scoped_ptr<ProcessThread> thread(pool.CreateProcessThread("Thread"));
+  rtc::Event event(false, false);
+  thread->Start();
+  thread->PostTask(rtc::scoped_ptr<ProcessTask>(new RaiseEventTask(&event)));
+  EXPECT_TRUE(event.Wait(kTimeoutMs));
+  thread->Stop();
+}
+
+// Many threads share a few workers, and the modules of each thread are never
+// processed concurrently.
+TEST(ProcessThreadPoolImpl, ProcessesModulesOfAllThreads) {
+  const int kNumThreads = 20;
+  const int kModulesPerThread = 3;
+  const int kExpectedCalls = 10;
+  ProcessThreadPoolImpl pool(3);
+  ScopedVector<ProcessThread> threads;
+  ScopedVector<CountingModule> modules;
+  volatile int running[kNumThreads] = {0};
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(pool.CreateProcessThread("Thread").release());
+    for (int j = 0; j < kModulesPerThread; ++j) {
+      modules.push_back(new CountingModule(kExpectedCalls, &running[i]));
+      threads.back()->RegisterModule(modules.back());
+    }
+    threads.back()->Start();
+  }
+
+  for (CountingModule* module : modules)
+    EXPECT_TRUE(module->Wait());
+  for (ProcessThread* thread : threads)
+    thread->Stop();
+  for (CountingModule* module : modules)
+    EXPECT_FALSE(module->concurrent());
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    for (int j = 0; j < kModulesPerThread; ++j)
+      threads[i]->DeRegisterModule(modules[i * kModulesPerThread + j]);
+  }
+}
+
+}  // namespace webrtc
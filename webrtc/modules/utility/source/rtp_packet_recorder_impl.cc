@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/utility/source/rtp_packet_recorder_impl.h"
+
+#include <string.h>
+
+#include "webrtc/base/logging.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+// The rtpdump format, as documented at
+// http://www.cs.columbia.edu/irt/software/rtptools/
+const char kFirstLine[] = "#!rtpplay1.0 0.0.0.0/0\n";
+const size_t kFileHeaderSize = 16;
+const size_t kPacketHeaderSize = 8;
+// The record length, including its header, is stored in 16 bits.
+const size_t kMaxRecordSize = 0xFFFF;
+
+void WriteBigEndian16(uint16_t value, uint8_t* data) {
+  data[0] = static_cast<uint8_t>(value >> 8);
+  data[1] = static_cast<uint8_t>(value);
+}
+
+void WriteBigEndian32(uint32_t value, uint8_t* data) {
+  WriteBigEndian16(static_cast<uint16_t>(value >> 16), data);
+  WriteBigEndian16(static_cast<uint16_t>(value), data + 2);
+}
+
+}  // namespace
+
+rtc::scoped_ptr<RtpPacketRecorder> RtpPacketRecorder::Create(
+    const std::string& file_name,
+    Clock* clock) {
+  FILE* file = fopen(file_name.c_str(), "wb");
+  if (!file) {
+    LOG(LS_ERROR) << "Can't create RTP recording " << file_name;
+    return nullptr;
+  }
+  const uint8_t header[kFileHeaderSize] = {0};
+  if (fputs(kFirstLine, file) < 0 ||
+      fwrite(header, sizeof(header), 1, file) != 1) {
+    LOG(LS_ERROR) << "Can't write RTP recording " << file_name;
+    fclose(file);
+    return nullptr;
+  }
+  return rtc::scoped_ptr<RtpPacketRecorder>(
+      new RtpPacketRecorderImpl(file, clock));
+}
+
+RtpPacketRecorderImpl::Block::Block()
+    : data(new uint8_t[kBlockSize]), size(0) {}
+
+RtpPacketRecorderImpl::RtpPacketRecorderImpl(FILE* file, Clock* clock)
+    : file_(file),
+      clock_(clock),
+      start_time_ms_(clock->TimeInMilliseconds()),
+      blocks_(kNumBlocks),
+      current_block_(&blocks_[0]),
+      dropped_packets_(0),
+      stopping_(false),
+      wake_(false, false),
+      thread_(&RtpPacketRecorderImpl::Run, this, "RtpPacketRecorder") {
+  for (size_t i = 1; i < blocks_.size(); ++i)
+    free_blocks_.push_back(&blocks_[i]);
+  thread_.Start();
+  thread_.SetPriority(rtc::kLowPriority);
+}
+
+RtpPacketRecorderImpl::~RtpPacketRecorderImpl() {
+  {
+    rtc::CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+  {
+    rtc::CritScope lock(&crit_);
+    if (current_block_ && current_block_->size > 0) {
+      full_blocks_.push_back(current_block_);
+      current_block_ = nullptr;
+    }
+  }
+  WriteBlocks();
+  fclose(file_);
+  if (dropped_packets_ > 0) {
+    LOG(LS_WARNING) << "RtpPacketRecorder dropped " << dropped_packets_
+                    << " packets.";
+  }
+}
+
+bool RtpPacketRecorderImpl::RecordRtpPacket(const uint8_t* packet,
+                                            size_t length) {
+  return RecordPacket(packet, length, length);
+}
+
+bool RtpPacketRecorderImpl::RecordRtcpPacket(const uint8_t* packet,
+                                             size_t length) {
+  return RecordPacket(packet, length, 0);
+}
+
+int RtpPacketRecorderImpl::dropped_packets() const {
+  rtc::CritScope lock(&crit_);
+  return dropped_packets_;
+}
+
+bool RtpPacketRecorderImpl::Run(void* obj) {
+  return static_cast<RtpPacketRecorderImpl*>(obj)->Process();
+}
+
+bool RtpPacketRecorderImpl::Process() {
+  const bool woken = wake_.Wait(kWriteIntervalMs);
+  {
+    rtc::CritScope lock(&crit_);
+    // Without a full block, keep the file no more than one interval behind.
+    if (!woken && current_block_ && current_block_->size > 0 &&
+        !free_blocks_.empty()) {
+      full_blocks_.push_back(current_block_);
+      current_block_ = free_blocks_.back();
+      free_blocks_.pop_back();
+    }
+  }
+  WriteBlocks();
+  rtc::CritScope lock(&crit_);
+  return !stopping_;
+}
+
+bool RtpPacketRecorderImpl::RecordPacket(const uint8_t* packet,
+                                         size_t length,
+                                         size_t original_length) {
+  const size_t record_size = kPacketHeaderSize + length;
+  const uint32_t offset_ms =
+      static_cast<uint32_t>(clock_->TimeInMilliseconds() - start_time_ms_);
+  bool wake_writer = false;
+  bool recorded = false;
+  {
+    rtc::CritScope lock(&crit_);
+    if (record_size > kMaxRecordSize) {
+      ++dropped_packets_;
+      return false;
+    }
+    if (current_block_ && current_block_->size + record_size > kBlockSize) {
+      full_blocks_.push_back(current_block_);
+      current_block_ = nullptr;
+      wake_writer = true;
+    }
+    if (!current_block_ && !free_blocks_.empty()) {
+      current_block_ = free_blocks_.back();
+      free_blocks_.pop_back();
+    }
+    if (!current_block_) {
+      ++dropped_packets_;
+    } else {
+      uint8_t* record = &current_block_->data[current_block_->size];
+      WriteBigEndian16(static_cast<uint16_t>(record_size), record);
+      WriteBigEndian16(static_cast<uint16_t>(original_length), record + 2);
+      WriteBigEndian32(offset_ms, record + 4);
+      memcpy(record + kPacketHeaderSize, packet, length);
+      current_block_->size += record_size;
+      recorded = true;
+    }
+  }
+  if (wake_writer)
+    wake_.Set();
+  return recorded;
+}
+
+void RtpPacketRecorderImpl::WriteBlocks() {
+  while (true) {
+    Block* block;
+    {
+      rtc::CritScope lock(&crit_);
+      if (full_blocks_.empty())
+        return;
+      block = full_blocks_.front();
+      full_blocks_.pop_front();
+    }
+    // Only this thread touches blocks that have been handed over, so the
+    // lock isn't held while writing.
+    if (fwrite(block->data.get(), 1, block->size, file_) != block->size)
+      LOG(LS_ERROR) << "Failed to write RTP recording.";
+    rtc::CritScope lock(&crit_);
+    block->size = 0;
+    free_blocks_.push_back(block);
+  }
+}
+
+}  // namespace webrtc
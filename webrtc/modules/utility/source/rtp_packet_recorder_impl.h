@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_UTILITY_SOURCE_RTP_PACKET_RECORDER_IMPL_H_
+#define WEBRTC_MODULES_UTILITY_SOURCE_RTP_PACKET_RECORDER_IMPL_H_
+
+#include <stdio.h>
+
+#include <deque>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/utility/include/rtp_packet_recorder.h"
+
+namespace webrtc {
+
+// Packets are appended to the current block, which is handed to the writer
+// thread when it is full, or when it has been filling for longer than
+// kWriteIntervalMs. A full block is written with a single fwrite() and then
+// reused. If all blocks are waiting to be written, packets are dropped.
+class RtpPacketRecorderImpl : public RtpPacketRecorder {
+ public:
+  static const size_t kBlockSize = 256 * 1024;
+  static const size_t kNumBlocks = 8;
+  static const int kWriteIntervalMs = 500;
+
+  RtpPacketRecorderImpl(FILE* file, Clock* clock);
+  ~RtpPacketRecorderImpl() override;
+
+  bool RecordRtpPacket(const uint8_t* packet, size_t length) override;
+  bool RecordRtcpPacket(const uint8_t* packet, size_t length) override;
+  int dropped_packets() const override;
+
+ private:
+  struct Block {
+    Block();
+    rtc::scoped_ptr<uint8_t[]> data;
+    size_t size;
+  };
+
+  static bool Run(void* obj);
+  bool Process();
+
+  // |original_length| is 0 for RTCP packets, as rtpdump specifies.
+  bool RecordPacket(const uint8_t* packet,
+                    size_t length,
+                    size_t original_length);
+  // Writes the blocks handed to the writer thread, and returns them to
+  // |free_blocks_|.
+  void WriteBlocks();
+
+  FILE* const file_;
+  Clock* const clock_;
+  const int64_t start_time_ms_;
+
+  mutable rtc::CriticalSection crit_;
+  std::vector<Block> blocks_;
+  Block* current_block_ GUARDED_BY(crit_);
+  std::vector<Block*> free_blocks_ GUARDED_BY(crit_);
+  std::deque<Block*> full_blocks_ GUARDED_BY(crit_);
+  int dropped_packets_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  rtc::Event wake_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketRecorderImpl);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_UTILITY_SOURCE_RTP_PACKET_RECORDER_IMPL_H_
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/modules/utility/include/rtp_packet_recorder.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+std::vector<uint8_t> MakePacket(size_t length, uint8_t seed) {
+  std::vector<uint8_t> packet(length);
+  for (size_t i = 0; i < length; ++i)
+    packet[i] = static_cast<uint8_t>(seed + i);
+  return packet;
+}
+
+}  // namespace
+
+// Records enough packets to fill several blocks, and reads them back.
+TEST(RtpPacketRecorderTest, RecordsPacketsInOrder) {
+  const std::string file_name =
+      test::OutputPath() + "rtp_packet_recorder_test.rtp";
+  const int kNumPackets = 1000;
+  SimulatedClock clock(100000);
+  {
+    rtc::scoped_ptr<RtpPacketRecorder> recorder =
+        RtpPacketRecorder::Create(file_name, &clock);
+    ASSERT_TRUE(recorder);
+    for (int i = 0; i < kNumPackets; ++i) {
+      std::vector<uint8_t> packet = MakePacket(100 + i, i);
+      if (i % 10 == 9) {
+        EXPECT_TRUE(recorder->RecordRtcpPacket(&packet[0], packet.size()));
+      } else {
+        EXPECT_TRUE(recorder->RecordRtpPacket(&packet[0], packet.size()));
+      }
+      clock.AdvanceTimeMilliseconds(10);
+    }
+    EXPECT_EQ(0, recorder->dropped_packets());
+  }
+
+  rtc::scoped_ptr<test::RtpFileReader> reader(
+      test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, file_name));
+  ASSERT_TRUE(reader);
+  test::RtpPacket packet;
+  for (int i = 0; i < kNumPackets; ++i) {
+    ASSERT_TRUE(reader->NextPacket(&packet));
+    std::vector<uint8_t> expected = MakePacket(100 + i, i);
+    ASSERT_EQ(expected.size(), packet.length);
+    EXPECT_EQ(0, memcmp(&expected[0], packet.data, packet.length));
+    EXPECT_EQ(i % 10 == 9 ? 0u : expected.size(), packet.original_length);
+    EXPECT_EQ(static_cast<uint32_t>(10 * i), packet.time_ms);
+  }
+  EXPECT_FALSE(reader->NextPacket(&packet));
+}
+
+TEST(RtpPacketRecorderTest, DropsPacketsTooLargeForRtpDump) {
+  const std::string file_name =
+      test::OutputPath() + "rtp_packet_recorder_test_large.rtp";
+  SimulatedClock clock(0);
+  rtc::scoped_ptr<RtpPacketRecorder> recorder =
+      RtpPacketRecorder::Create(file_name, &clock);
+  ASSERT_TRUE(recorder);
+  std::vector<uint8_t> packet(0x10000);
+  EXPECT_FALSE(recorder->RecordRtpPacket(&packet[0], packet.size()));
+  EXPECT_EQ(1, recorder->dropped_packets());
+  EXPECT_TRUE(recorder->RecordRtpPacket(&packet[0], 1000));
+  EXPECT_EQ(1, recorder->dropped_packets());
+}
+
+}  // namespace webrtc
@@ -20,9 +20,14 @@
 
 #include <iostream>
 #include <new>
+#include <vector>
 
+#include "webrtc/base/refcount.h"
+#include "webrtc/common_video/include/video_frame_buffer.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_capture/linux/video_capture_linux.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/system_wrappers/include/ref_count.h"
 #include "webrtc/system_wrappers/include/trace.h"
 
@@ -30,6 +35,187 @@ namespace webrtc
 {
 namespace videocapturemodule
 {
+namespace
+{
+// Frames are only delivered without a copy while at least this many other
+// buffers are queued with the driver, so that consumers holding on to frames
+// can't starve the capture.
+const int kMinQueuedBuffers = 2;
+
+bool ZeroCopyEnabled()
+{
+    return field_trial::FindFullName("WebRTC-V4L2ZeroCopy") == "Enabled";
+}
+}  // namespace
+
+// The mmap'd buffers of a capture session. Frames delivered without a copy
+// hold a reference, so the buffers stay mapped until the last of them is
+// released, even if capture has stopped by then.
+class V4L2BufferPool : public rtc::RefCountInterface
+{
+public:
+    struct Buffer
+    {
+        void* start;
+        size_t length;
+        int dmabuf_fd;
+    };
+
+    explicit V4L2BufferPool(int deviceFd)
+        : _critSect(CriticalSectionWrapper::CreateCriticalSection()),
+          _deviceFd(deviceFd),
+          _numDequeued(0)
+    {
+    }
+
+    // Maps the |count| buffers requested from the driver, exporting them as
+    // DMA-BUF if |exportDmaBuf| is set, and queues them for capture.
+    bool MapAndQueue(int count, bool exportDmaBuf)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            struct v4l2_buffer buffer;
+            memset(&buffer, 0, sizeof(v4l2_buffer));
+            buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buffer.memory = V4L2_MEMORY_MMAP;
+            buffer.index = i;
+
+            if (ioctl(_deviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
+                return false;
+
+            Buffer mapped;
+            mapped.start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, _deviceFd, buffer.m.offset);
+            if (MAP_FAILED == mapped.start)
+                return false;
+            mapped.length = buffer.length;
+            mapped.dmabuf_fd = -1;
+#if defined(VIDIOC_EXPBUF)
+            if (exportDmaBuf)
+            {
+                struct v4l2_exportbuffer expbuf;
+                memset(&expbuf, 0, sizeof(expbuf));
+                expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                expbuf.index = i;
+                expbuf.flags = O_RDONLY | O_CLOEXEC;
+                if (ioctl(_deviceFd, VIDIOC_EXPBUF, &expbuf) == 0)
+                    mapped.dmabuf_fd = expbuf.fd;
+            }
+#endif
+            _buffers.push_back(mapped);
+
+            if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    const Buffer& buffer(int index) const { return _buffers[index]; }
+    int size() const { return static_cast<int>(_buffers.size()); }
+
+    // Number of buffers currently queued with the driver.
+    int NumQueued() const
+    {
+        CriticalSectionScoped cs(_critSect.get());
+        return size() - _numDequeued;
+    }
+
+    void Dequeued()
+    {
+        CriticalSectionScoped cs(_critSect.get());
+        ++_numDequeued;
+    }
+
+    // Hands buffer |index| back to the driver, unless capture has stopped.
+    void Enqueue(int index)
+    {
+        CriticalSectionScoped cs(_critSect.get());
+        --_numDequeued;
+        if (_deviceFd == -1)
+            return;
+        struct v4l2_buffer buf;
+        memset(&buf, 0, sizeof(struct v4l2_buffer));
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = index;
+        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+        {
+            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture,
+                         -1, "Failed to enqueue capture buffer");
+        }
+    }
+
+    // Stops handing buffers back to the device, which is about to be closed.
+    void Stop()
+    {
+        CriticalSectionScoped cs(_critSect.get());
+        _deviceFd = -1;
+    }
+
+protected:
+    ~V4L2BufferPool()
+    {
+        for (size_t i = 0; i < _buffers.size(); i++)
+        {
+            munmap(_buffers[i].start, _buffers[i].length);
+            if (_buffers[i].dmabuf_fd != -1)
+                close(_buffers[i].dmabuf_fd);
+        }
+    }
+
+private:
+    const rtc::scoped_ptr<CriticalSectionWrapper> _critSect;
+    int _deviceFd;
+    int _numDequeued;
+    std::vector<Buffer> _buffers;
+};
+
+namespace
+{
+// A captured frame still in its V4L2 buffer. Converts to I420 on demand.
+class V4L2FrameBuffer : public NativeHandleBuffer
+{
+public:
+    V4L2FrameBuffer(const rtc::scoped_refptr<V4L2BufferPool>& pool,
+                    int index,
+                    size_t bytesUsed,
+                    const VideoCaptureCapability& frameInfo)
+        : NativeHandleBuffer(&_handle, frameInfo.width, frameInfo.height),
+          _pool(pool),
+          _index(index)
+    {
+        const V4L2BufferPool::Buffer& buffer = pool->buffer(index);
+        _handle.data = static_cast<const uint8_t*>(buffer.start);
+        _handle.length = bytesUsed;
+        _handle.type = frameInfo.rawType;
+        _handle.dmabuf_fd = buffer.dmabuf_fd;
+    }
+
+    rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() override
+    {
+        VideoFrame frame;
+        const int strideUV = (width_ + 1) / 2;
+        if (frame.CreateEmptyFrame(width_, height_, width_, strideUV,
+                                   strideUV) < 0 ||
+            ConvertToI420(RawVideoTypeToCommonVideoVideoType(_handle.type),
+                          _handle.data, 0, 0, width_, height_, _handle.length,
+                          kVideoRotation_0, &frame) < 0)
+        {
+            return nullptr;
+        }
+        return frame.video_frame_buffer();
+    }
+
+private:
+    friend class rtc::RefCountedObject<V4L2FrameBuffer>;
+    ~V4L2FrameBuffer() override { _pool->Enqueue(_index); }
+
+    V4L2BufferHandle _handle;
+    const rtc::scoped_refptr<V4L2BufferPool> _pool;
+    const int _index;
+};
+}  // namespace
+
 VideoCaptureModule* VideoCaptureImpl::Create(const int32_t id,
                                              const char* deviceUniqueId)
 {
@@ -56,7 +242,7 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2(const int32_t id)
       _currentFrameRate(-1),
       _captureStarted(false),
       _captureVideoType(kVideoI420),
-      _pool(NULL)
+      _zeroCopy(ZeroCopyEnabled())
 {
 }
 
@@ -345,48 +531,21 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
     _buffersAllocatedByDevice = rbuffer.count;
 
     //Map the buffers
-    _pool = new Buffer[rbuffer.count];
-
-    for (unsigned int i = 0; i < rbuffer.count; i++)
+    _pool = new rtc::RefCountedObject<V4L2BufferPool>(_deviceFd);
+    if (!_pool->MapAndQueue(rbuffer.count, _zeroCopy))
     {
-        struct v4l2_buffer buffer;
-        memset(&buffer, 0, sizeof(v4l2_buffer));
-        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buffer.memory = V4L2_MEMORY_MMAP;
-        buffer.index = i;
-
-        if (ioctl(_deviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
-        {
-            return false;
-        }
-
-        _pool[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED,
-                              _deviceFd, buffer.m.offset);
-
-        if (MAP_FAILED == _pool[i].start)
-        {
-            for (unsigned int j = 0; j < i; j++)
-                munmap(_pool[j].start, _pool[j].length);
-            return false;
-        }
-
-        _pool[i].length = buffer.length;
-
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
-        {
-            return false;
-        }
+        _pool = nullptr;
+        return false;
     }
     return true;
 }
 
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
 {
-    // unmap buffers
-    for (int i = 0; i < _buffersAllocatedByDevice; i++)
-        munmap(_pool[i].start, _pool[i].length);
-
-    delete[] _pool;
+    // Frames still held by consumers keep the buffers mapped, but must no
+    // longer hand them back to the device.
+    _pool->Stop();
+    _pool = nullptr;
 
     // turn off stream
     enum v4l2_buf_type type;
@@ -400,6 +559,23 @@ bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
     return true;
 }
 
+bool VideoCaptureModuleV4L2::DeliverWithoutCopy(
+    int index,
+    size_t bytesUsed,
+    const VideoCaptureCapability& frameInfo)
+{
+    // Rotation can't be applied without converting the frame, and the last
+    // buffers are kept with the driver.
+    if (!_zeroCopy || GetApplyRotation() ||
+        _pool->NumQueued() < kMinQueuedBuffers)
+    {
+        return false;
+    }
+    IncomingFrameBuffer(new rtc::RefCountedObject<V4L2FrameBuffer>(
+        _pool, index, bytesUsed, frameInfo));
+    return true;
+}
+
 bool VideoCaptureModuleV4L2::CaptureStarted()
 {
     return _captureStarted;
@@ -459,19 +635,21 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
                 return true;
             }
         }
+        _pool->Dequeued();
         VideoCaptureCapability frameInfo;
         frameInfo.width = _currentWidth;
         frameInfo.height = _currentHeight;
         frameInfo.rawType = _captureVideoType;
 
-        // convert to to I420 if needed
-        IncomingFrame((unsigned char*) _pool[buf.index].start,
-                      buf.bytesused, frameInfo);
-        // enqueue the buffer again
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+        // The frame buffer hands the buffer back to the driver once released.
+        if (!DeliverWithoutCopy(buf.index, buf.bytesused, frameInfo))
         {
-            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
-                       "Failed to enqueue capture buffer");
+            // convert to to I420 if needed
+            IncomingFrame(
+                static_cast<unsigned char*>(_pool->buffer(buf.index).start),
+                buf.bytesused, frameInfo);
+            // enqueue the buffer again
+            _pool->Enqueue(buf.index);
         }
     }
     _captureCritSect->Leave();
@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_VIDEO_CAPTURE_MAIN_SOURCE_LINUX_VIDEO_CAPTURE_LINUX_H_
 
 #include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/video_capture/video_capture_impl.h"
 
@@ -20,6 +21,27 @@ namespace webrtc
 class CriticalSectionWrapper;
 namespace videocapturemodule
 {
+class V4L2BufferPool;
+
+// The native handle of frames delivered without a copy, see
+// VideoCaptureModuleV4L2. The V4L2 buffer is handed back to the driver when
+// the last reference to the frame buffer holding this handle goes away, so
+// consumers must not keep it longer than the frame buffer.
+struct V4L2BufferHandle
+{
+    const uint8_t* data;
+    size_t length;
+    RawVideoType type;
+    // DMA-BUF file descriptor of the buffer, or -1 if the driver could not
+    // export it.
+    int dmabuf_fd;
+};
+
+// Captures from a V4L2 device into mmap'd buffers. Frames are normally
+// converted to I420 on the capture thread. With the "WebRTC-V4L2ZeroCopy"
+// field trial enabled, frames are instead delivered as native-handle buffers
+// wrapping the V4L2 buffer, and are only converted if a consumer asks for
+// I420.
 class VideoCaptureModuleV4L2: public VideoCaptureImpl
 {
 public:
@@ -38,6 +60,9 @@ private:
     bool CaptureProcess();
     bool AllocateVideoBuffers();
     bool DeAllocateVideoBuffers();
+    bool DeliverWithoutCopy(int index,
+                            size_t bytesUsed,
+                            const VideoCaptureCapability& frameInfo);
 
     // TODO(pbos): Stop using scoped_ptr and resetting the thread.
     rtc::scoped_ptr<rtc::PlatformThread> _captureThread;
@@ -52,12 +77,8 @@ private:
     int32_t _currentFrameRate;
     bool _captureStarted;
     RawVideoType _captureVideoType;
-    struct Buffer
-    {
-        void *start;
-        size_t length;
-    };
-    Buffer *_pool;
+    const bool _zeroCopy;
+    rtc::scoped_refptr<V4L2BufferPool> _pool;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
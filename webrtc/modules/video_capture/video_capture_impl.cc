@@ -320,6 +320,22 @@ int32_t VideoCaptureImpl::IncomingFrame(
     return 0;
 }
 
+int32_t VideoCaptureImpl::IncomingFrameBuffer(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    int64_t captureTime) {
+  CriticalSectionScoped cs(&_apiCs);
+  CriticalSectionScoped cs2(&_callBackCs);
+
+  TRACE_EVENT1("webrtc", "VC::IncomingFrameBuffer", "capture_time",
+               captureTime);
+
+  VideoFrame captureFrame(buffer, 0, TickTime::MillisecondTimestamp(),
+                          _rotateFrame);
+  captureFrame.set_ntp_time_ms(captureTime);
+  DeliverCapturedFrame(captureFrame);
+  return 0;
+}
+
 int32_t VideoCaptureImpl::SetCaptureRotation(VideoRotation rotation) {
   CriticalSectionScoped cs(&_apiCs);
   CriticalSectionScoped cs2(&_callBackCs);
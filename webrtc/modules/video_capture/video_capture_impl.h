@@ -105,6 +105,12 @@ protected:
     VideoCaptureImpl(const int32_t id);
     virtual ~VideoCaptureImpl();
     int32_t DeliverCapturedFrame(VideoFrame& captureFrame);
+    // Delivers |buffer| without converting it, for platforms that can hand out
+    // captured frames as they are. The capture rotation is only signalled on
+    // the frame, so this must not be used while rotation is to be applied.
+    int32_t IncomingFrameBuffer(
+        const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+        int64_t captureTime = 0);
 
     int32_t _id; // Module ID
     char* _deviceUniqueId; // current Device unique name;
@@ -10,87 +10,89 @@
 
 #include "webrtc/modules/video_coding/codec_timer.h"
 
-#include <assert.h>
+#include <algorithm>
+#include <vector>
 
 namespace webrtc {
 
 // The first kIgnoredSampleCount samples will be ignored.
 static const int32_t kIgnoredSampleCount = 5;
+// Decode times older than this are dropped from the models...
+static const int64_t kTimeLimitMs = 10000;
+// ...unless fewer than this many samples would remain, so that the key frame
+// model survives the long gaps between key frames.
+static const size_t kMinSamples = 5;
+// The percentile of the recent decode times used as the estimate. A max filter
+// is thrown off by single outliers, such as a frame decoded while the thread
+// was descheduled, which then inflate the delay for the whole window.
+static const int kPercentile = 95;
 
-VCMCodecTimer::VCMCodecTimer()
-    : _filteredMax(0), _ignoredSampleCount(0), _shortMax(0), _history() {
-  Reset();
-}
+VCMCodecTimer::DecodeTimeModel::DecodeTimeModel() : filtered_ms_(0) {}
 
-void VCMCodecTimer::Reset() {
-  _filteredMax = 0;
-  _ignoredSampleCount = 0;
-  _shortMax = 0;
-  for (int i = 0; i < MAX_HISTORY_SIZE; i++) {
-    _history[i].shortMax = 0;
-    _history[i].timeMs = -1;
-  }
+void VCMCodecTimer::DecodeTimeModel::Reset() {
+  history_.clear();
+  filtered_ms_ = 0;
 }
 
-// Update the max-value filter
-void VCMCodecTimer::MaxFilter(int32_t decodeTime, int64_t nowMs) {
-  if (_ignoredSampleCount >= kIgnoredSampleCount) {
-    UpdateMaxHistory(decodeTime, nowMs);
-    ProcessHistory(nowMs);
-  } else {
-    _ignoredSampleCount++;
+void VCMCodecTimer::DecodeTimeModel::AddSample(int32_t decode_time_ms,
+                                               int64_t now_ms) {
+  history_.push_back(Sample(decode_time_ms, now_ms));
+  while (history_.size() > kMinSamples &&
+         now_ms - history_.front().sample_time_ms > kTimeLimitMs) {
+    history_.pop_front();
   }
+
+  std::vector<int32_t> decode_times;
+  decode_times.reserve(history_.size());
+  for (const Sample& sample : history_)
+    decode_times.push_back(sample.decode_time_ms);
+  std::vector<int32_t>::iterator percentile =
+      decode_times.begin() + (decode_times.size() - 1) * kPercentile / 100;
+  std::nth_element(decode_times.begin(), percentile, decode_times.end());
+  filtered_ms_ = *percentile;
 }
 
-void VCMCodecTimer::UpdateMaxHistory(int32_t decodeTime, int64_t now) {
-  if (_history[0].timeMs >= 0 && now - _history[0].timeMs < SHORT_FILTER_MS) {
-    if (decodeTime > _shortMax) {
-      _shortMax = decodeTime;
-    }
-  } else {
-    // Only add a new value to the history once a second
-    if (_history[0].timeMs == -1) {
-      // First, no shift
-      _shortMax = decodeTime;
-    } else {
-      // Shift
-      for (int i = (MAX_HISTORY_SIZE - 2); i >= 0; i--) {
-        _history[i + 1].shortMax = _history[i].shortMax;
-        _history[i + 1].timeMs = _history[i].timeMs;
-      }
-    }
-    if (_shortMax == 0) {
-      _shortMax = decodeTime;
-    }
+VCMCodecTimer::VCMCodecTimer() : ignored_sample_count_(0), num_pixels_(0) {}
 
-    _history[0].shortMax = _shortMax;
-    _history[0].timeMs = now;
-    _shortMax = 0;
-  }
+void VCMCodecTimer::Reset() {
+  ignored_sample_count_ = 0;
+  num_pixels_ = 0;
+  key_frame_model_.Reset();
+  delta_frame_model_.Reset();
 }
 
-void VCMCodecTimer::ProcessHistory(int64_t nowMs) {
-  _filteredMax = _shortMax;
-  if (_history[0].timeMs == -1) {
+void VCMCodecTimer::AddTiming(int32_t decode_time_ms,
+                              int64_t now_ms,
+                              FrameType frame_type,
+                              int num_pixels) {
+  if (num_pixels > 0 && num_pixels != num_pixels_) {
+    // Decode times at the old resolution say little about the new one.
+    if (num_pixels_ > 0) {
+      key_frame_model_.Reset();
+      delta_frame_model_.Reset();
+    }
+    num_pixels_ = num_pixels;
+  }
+  if (ignored_sample_count_ < kIgnoredSampleCount) {
+    ignored_sample_count_++;
     return;
   }
-  for (int i = 0; i < MAX_HISTORY_SIZE; i++) {
-    if (_history[i].timeMs == -1) {
-      break;
-    }
-    if (nowMs - _history[i].timeMs > MAX_HISTORY_SIZE * SHORT_FILTER_MS) {
-      // This sample (and all samples after this) is too old
-      break;
-    }
-    if (_history[i].shortMax > _filteredMax) {
-      // This sample is the largest one this far into the history
-      _filteredMax = _history[i].shortMax;
-    }
+  if (frame_type == kVideoFrameKey) {
+    key_frame_model_.AddSample(decode_time_ms, now_ms);
+  } else {
+    delta_frame_model_.AddSample(decode_time_ms, now_ms);
   }
 }
 
-// Get the maximum observed time within a time window
-int32_t VCMCodecTimer::RequiredDecodeTimeMs(FrameType /*frameType*/) const {
-  return _filteredMax;
+int32_t VCMCodecTimer::RequiredDecodeTimeMs(FrameType frame_type) const {
+  return Model(frame_type).filtered_decode_time_ms();
 }
+
+const VCMCodecTimer::DecodeTimeModel& VCMCodecTimer::Model(
+    FrameType frame_type) const {
+  if (frame_type == kVideoFrameKey && !key_frame_model_.empty())
+    return key_frame_model_;
+  return delta_frame_model_;
+}
+
 }  // namespace webrtc
@@ -11,45 +11,67 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODEC_TIMER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODEC_TIMER_H_
 
+#include <deque>
+
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
-// MAX_HISTORY_SIZE * SHORT_FILTER_MS defines the window size in milliseconds
-#define MAX_HISTORY_SIZE 10
-#define SHORT_FILTER_MS 1000
-
-class VCMShortMaxSample {
- public:
-  VCMShortMaxSample() : shortMax(0), timeMs(-1) {}
-
-  int32_t shortMax;
-  int64_t timeMs;
-};
-
+// Predicts how long decoding a frame will take from the decode times of recent
+// frames. Key frames and delta frames are modeled separately, as key frames
+// usually take several times longer to decode, and both models start over when
+// the resolution of the decoded frames changes.
 class VCMCodecTimer {
  public:
   VCMCodecTimer();
 
-  // Updates the max filtered decode time.
-  void MaxFilter(int32_t newDecodeTimeMs, int64_t nowMs);
+  // Adds the decode time of a frame of type |frame_type| with |num_pixels|
+  // pixels, or 0 if the resolution is unknown.
+  void AddTiming(int32_t decode_time_ms,
+                 int64_t now_ms,
+                 FrameType frame_type,
+                 int num_pixels);
 
   // Empty the list of timers.
   void Reset();
 
-  // Get the required decode time in ms.
-  int32_t RequiredDecodeTimeMs(FrameType frameType) const;
+  // Get the required decode time in ms. This is a high percentile of the
+  // recent decode times of frames of |frame_type|, falling back to the delta
+  // frame estimate until a key frame has been timed.
+  int32_t RequiredDecodeTimeMs(FrameType frame_type) const;
 
  private:
-  void UpdateMaxHistory(int32_t decodeTime, int64_t now);
-  void ProcessHistory(int64_t nowMs);
+  struct Sample {
+    Sample(int32_t decode_time_ms, int64_t sample_time_ms)
+        : decode_time_ms(decode_time_ms), sample_time_ms(sample_time_ms) {}
+
+    int32_t decode_time_ms;
+    int64_t sample_time_ms;
+  };
+
+  class DecodeTimeModel {
+   public:
+    DecodeTimeModel();
+
+    void AddSample(int32_t decode_time_ms, int64_t now_ms);
+    void Reset();
+
+    bool empty() const { return history_.empty(); }
+    int32_t filtered_decode_time_ms() const { return filtered_ms_; }
+
+   private:
+    std::deque<Sample> history_;
+    int32_t filtered_ms_;
+  };
+
+  const DecodeTimeModel& Model(FrameType frame_type) const;
 
-  int32_t _filteredMax;
   // The number of samples ignored so far.
-  int32_t _ignoredSampleCount;
-  int32_t _shortMax;
-  VCMShortMaxSample _history[MAX_HISTORY_SIZE];
+  int32_t ignored_sample_count_;
+  int num_pixels_;
+  DecodeTimeModel key_frame_model_;
+  DecodeTimeModel delta_frame_model_;
 };
 
 }  // namespace webrtc
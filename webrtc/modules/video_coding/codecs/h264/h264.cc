@@ -27,6 +27,11 @@ namespace webrtc {
 extern bool IsH264CodecSupportedObjC();
 #endif
 
+// VideoToolbox on iOS is the only built-in implementation. A
+// VA-API backend for Linux and a native MediaCodec (NDK) backend for Android
+// would be added here, each behind its own build flag like VideoToolbox.
+// Until then, hardware H.264 codecs on other platforms are injected through
+// cricket::WebRtcVideoEncoderFactory and cricket::WebRtcVideoDecoderFactory.
 bool IsH264CodecSupported() {
 #if defined(WEBRTC_IOS)
   return IsH264CodecSupportedObjC();
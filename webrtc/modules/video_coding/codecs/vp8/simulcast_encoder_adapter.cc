@@ -16,6 +16,8 @@
 #include "libyuv/scale.h"  // NOLINT
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/common.h"
 #include "webrtc/modules/video_coding/codecs/vp8/screenshare_layers.h"
 
@@ -136,8 +138,73 @@ class AdapterEncodedImageCallback : public webrtc::EncodedImageCallback {
 
 namespace webrtc {
 
+// Encodes one stream at a time on a thread of its own.
+class SimulcastEncoderAdapter::EncodeWorker {
+ public:
+  explicit EncodeWorker(SimulcastEncoderAdapter* adapter)
+      : adapter_(adapter),
+        work_event_(false, false),
+        done_event_(false, false),
+        stop_(false),
+        stream_idx_(0),
+        input_image_(nullptr),
+        codec_specific_info_(nullptr),
+        send_key_frame_(false),
+        thread_(&EncodeWorker::Run, this, "SimulcastEncodeThread") {
+    thread_.Start();
+    thread_.SetPriority(rtc::kHighPriority);
+  }
+
+  ~EncodeWorker() {
+    stop_ = true;
+    work_event_.Set();
+    thread_.Stop();
+  }
+
+  // The frame and codec info must stay valid until Wait() returns.
+  void StartEncode(size_t stream_idx,
+                   const VideoFrame* input_image,
+                   const CodecSpecificInfo* codec_specific_info,
+                   bool send_key_frame) {
+    stream_idx_ = stream_idx;
+    input_image_ = input_image;
+    codec_specific_info_ = codec_specific_info;
+    send_key_frame_ = send_key_frame;
+    work_event_.Set();
+  }
+
+  void Wait() { done_event_.Wait(rtc::Event::kForever); }
+
+ private:
+  static bool Run(void* obj) { return static_cast<EncodeWorker*>(obj)->Work(); }
+
+  bool Work() {
+    work_event_.Wait(rtc::Event::kForever);
+    if (stop_)
+      return false;
+    adapter_->EncodeStream(stream_idx_, *input_image_, codec_specific_info_,
+                           send_key_frame_);
+    done_event_.Set();
+    return true;
+  }
+
+  SimulcastEncoderAdapter* const adapter_;
+  rtc::Event work_event_;
+  rtc::Event done_event_;
+  // Written before |work_event_| is set and read after it has been waited
+  // for, which orders the accesses.
+  bool stop_;
+  size_t stream_idx_;
+  const VideoFrame* input_image_;
+  const CodecSpecificInfo* codec_specific_info_;
+  bool send_key_frame_;
+  rtc::PlatformThread thread_;
+};
+
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory)
-    : factory_(factory), encoded_complete_callback_(NULL) {
+    : factory_(factory),
+      encoded_complete_callback_(NULL),
+      parallel_encoding_(false) {
   memset(&codec_, 0, sizeof(webrtc::VideoCodec));
 }
 
@@ -145,7 +212,13 @@ SimulcastEncoderAdapter::~SimulcastEncoderAdapter() {
   Release();
 }
 
+void SimulcastEncoderAdapter::SetParallelEncoding(bool enabled) {
+  parallel_encoding_ = enabled;
+}
+
 int SimulcastEncoderAdapter::Release() {
+  // Stop the workers before the encoders they may use go away.
+  encode_workers_.clear();
   // TODO(pbos): Keep the last encoder instance but call ::Release() on it, then
   // re-use this instance in ::InitEncode(). This means that changing
   // resolutions doesn't require reallocation of the first encoder, but only
@@ -225,6 +298,10 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     streaminfos_.push_back(StreamInfo(encoder, callback, stream_codec.width,
                                       stream_codec.height, send_stream));
   }
+  if (parallel_encoding_ && number_of_cores > 1) {
+    for (int i = 0; i < number_of_streams - 1; ++i)
+      encode_workers_.push_back(new EncodeWorker(this));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -258,56 +335,91 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  std::vector<EncodeWorker*> started_workers;
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream)
       continue;
 
-    std::vector<FrameType> stream_frame_types;
-    if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
+    if (send_key_frame)
       streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
-    }
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources), pass the image on directly. Otherwise, we'll
-    // scale it to match what the encoder expects (below).
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.IsZeroSize()) {
-      streaminfos_[stream_idx].encoder->Encode(input_image, codec_specific_info,
-                                               &stream_frame_types);
+    if (stream_idx < encode_workers_.size()) {
+      encode_workers_[stream_idx]->StartEncode(stream_idx, &input_image,
+                                               codec_specific_info,
+                                               send_key_frame);
+      started_workers.push_back(encode_workers_[stream_idx]);
     } else {
-      VideoFrame dst_frame;
-      // Making sure that destination frame is of sufficient size.
-      // Aligning stride values based on width.
-      dst_frame.CreateEmptyFrame(dst_width, dst_height, dst_width,
-                                 (dst_width + 1) / 2, (dst_width + 1) / 2);
-      libyuv::I420Scale(
-          input_image.buffer(kYPlane), input_image.stride(kYPlane),
-          input_image.buffer(kUPlane), input_image.stride(kUPlane),
-          input_image.buffer(kVPlane), input_image.stride(kVPlane), src_width,
-          src_height, dst_frame.buffer(kYPlane), dst_frame.stride(kYPlane),
-          dst_frame.buffer(kUPlane), dst_frame.stride(kUPlane),
-          dst_frame.buffer(kVPlane), dst_frame.stride(kVPlane), dst_width,
-          dst_height, libyuv::kFilterBilinear);
-      dst_frame.set_timestamp(input_image.timestamp());
-      dst_frame.set_render_time_ms(input_image.render_time_ms());
-      streaminfos_[stream_idx].encoder->Encode(dst_frame, codec_specific_info,
-                                               &stream_frame_types);
+      EncodeStream(stream_idx, input_image, codec_specific_info,
+                   send_key_frame);
     }
   }
+  for (EncodeWorker* worker : started_workers)
+    worker->Wait();
 
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    bool send_key_frame) {
+  std::vector<FrameType> stream_frame_types(
+      1, send_key_frame ? kVideoFrameKey : kVideoFrameDelta);
+
+  int src_width = input_image.width();
+  int src_height = input_image.height();
+  int dst_width = streaminfos_[stream_idx].width;
+  int dst_height = streaminfos_[stream_idx].height;
+  // If scaling isn't required, because the input resolution
+  // matches the destination or the input image is empty (e.g.
+  // a keyframe request for encoders with internal camera
+  // sources), pass the image on directly. Otherwise, we'll
+  // scale it to match what the encoder expects (below).
+  if ((dst_width == src_width && dst_height == src_height) ||
+      input_image.IsZeroSize()) {
+    streaminfos_[stream_idx].encoder->Encode(input_image, codec_specific_info,
+                                             &stream_frame_types);
+  } else {
+    // Keep native frames native if the buffer can scale itself, e.g. on the
+    // GPU. Otherwise they have to be scaled in memory like any other frame.
+    const VideoFrame* src_frame = &input_image;
+    VideoFrame converted_frame;
+    if (input_image.native_handle()) {
+      rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+          input_image.video_frame_buffer()->ScaleNative(dst_width, dst_height);
+      if (scaled_buffer) {
+        VideoFrame dst_frame(scaled_buffer, input_image.timestamp(),
+                             input_image.render_time_ms(),
+                             input_image.rotation());
+        streaminfos_[stream_idx].encoder->Encode(
+            dst_frame, codec_specific_info, &stream_frame_types);
+        return;
+      }
+      converted_frame = input_image.ConvertNativeToI420Frame();
+      src_frame = &converted_frame;
+    }
+    VideoFrame dst_frame;
+    // Making sure that destination frame is of sufficient size.
+    // Aligning stride values based on width.
+    dst_frame.CreateEmptyFrame(dst_width, dst_height, dst_width,
+                               (dst_width + 1) / 2, (dst_width + 1) / 2);
+    libyuv::I420Scale(
+        src_frame->buffer(kYPlane), src_frame->stride(kYPlane),
+        src_frame->buffer(kUPlane), src_frame->stride(kUPlane),
+        src_frame->buffer(kVPlane), src_frame->stride(kVPlane), src_width,
+        src_height, dst_frame.buffer(kYPlane), dst_frame.stride(kYPlane),
+        dst_frame.buffer(kUPlane), dst_frame.stride(kUPlane),
+        dst_frame.buffer(kVPlane), dst_frame.stride(kVPlane), dst_width,
+        dst_height, libyuv::kFilterBilinear);
+    dst_frame.set_timestamp(input_image.timestamp());
+    dst_frame.set_render_time_ms(input_image.render_time_ms());
+    streaminfos_[stream_idx].encoder->Encode(dst_frame, codec_specific_info,
+                                             &stream_frame_types);
+  }
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   encoded_complete_callback_ = callback;
@@ -383,6 +495,7 @@ int32_t SimulcastEncoderAdapter::Encoded(
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
   vp8Info->simulcastIdx = stream_idx;
 
+  rtc::CritScope lock(&encoded_crit_);
   return encoded_complete_callback_->Encoded(
       encodedImage, &stream_codec_specific, fragmentation);
 }
@@ -490,10 +603,13 @@ int SimulcastEncoderAdapter::GetTargetFramerate() {
 bool SimulcastEncoderAdapter::SupportsNativeHandle() const {
   // We should not be calling this method before streaminfos_ are configured.
   RTC_DCHECK(!streaminfos_.empty());
-  // TODO(pbos): Support textures when using more than one encoder.
-  if (streaminfos_.size() != 1)
-    return false;
-  return streaminfos_[0].encoder->SupportsNativeHandle();
+  // Native frames are scaled per stream in EncodeStream(), so they can be
+  // passed on as long as every encoder takes them.
+  for (const StreamInfo& info : streaminfos_) {
+    if (!info.encoder->SupportsNativeHandle())
+      return false;
+  }
+  return true;
 }
 
 const char* SimulcastEncoderAdapter::ImplementationName() const {
@@ -14,8 +14,10 @@
 
 #include <vector>
 
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
 
 namespace webrtc {
 
@@ -35,6 +37,15 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   explicit SimulcastEncoderAdapter(VideoEncoderFactory* factory);
   virtual ~SimulcastEncoderAdapter();
 
+  // When enabled, and InitEncode() is given more than one core, the lower
+  // resolution streams are scaled and encoded on worker threads of their own
+  // while the highest resolution stream is encoded on the calling thread.
+  // Encode() still returns only once all streams are done, but takes about as
+  // long as the largest stream rather than the sum of all. Encoded images may
+  // then be delivered on the worker threads, one at a time. Takes effect on
+  // the next InitEncode().
+  void SetParallelEncoding(bool enabled);
+
   // Implements VideoEncoder
   int Release() override;
   int InitEncode(const VideoCodec* inst,
@@ -62,6 +73,8 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   const char* ImplementationName() const override;
 
  private:
+  class EncodeWorker;
+
   struct StreamInfo {
     StreamInfo()
         : encoder(NULL),
@@ -109,11 +122,23 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   bool Initialized() const;
 
+  // Scales |input_image| as needed and encodes it on stream |stream_idx|.
+  void EncodeStream(size_t stream_idx,
+                    const VideoFrame& input_image,
+                    const CodecSpecificInfo* codec_specific_info,
+                    bool send_key_frame);
+
   rtc::scoped_ptr<VideoEncoderFactory> factory_;
   rtc::scoped_ptr<Config> screensharing_extra_options_;
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
+
+  bool parallel_encoding_;
+  // One per stream but the highest resolution one, if encoding in parallel.
+  ScopedVector<EncodeWorker> encode_workers_;
+  // Serializes delivery of encoded images from the workers.
+  rtc::CriticalSection encoded_crit_;
 };
 
 }  // namespace webrtc
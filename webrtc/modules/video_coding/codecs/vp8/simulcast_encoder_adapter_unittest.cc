@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "testing/gmock/include/gmock/gmock.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_encoder_adapter.h"
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_unittest.h"
@@ -115,6 +116,9 @@ class MockVideoEncoder : public VideoEncoder {
   int32_t Encode(const VideoFrame& inputImage,
                  const CodecSpecificInfo* codecSpecificInfo,
                  const std::vector<FrameType>* frame_types) override {
+    encode_thread_ = rtc::CurrentThreadRef();
+    ++num_encodes_;
+    last_frame_ = inputImage;
     return 0;
   }
 
@@ -137,6 +141,9 @@ class MockVideoEncoder : public VideoEncoder {
   virtual ~MockVideoEncoder() {}
 
   const VideoCodec& codec() const { return codec_; }
+  int num_encodes() const { return num_encodes_; }
+  const VideoFrame& last_frame() const { return last_frame_; }
+  const rtc::PlatformThreadRef& encode_thread() const { return encode_thread_; }
 
   void SendEncodedImage(int width, int height) {
     // Sends a fake image of the given width/height.
@@ -154,6 +161,9 @@ class MockVideoEncoder : public VideoEncoder {
 
  private:
   bool supports_native_handle_ = false;
+  int num_encodes_ = 0;
+  rtc::PlatformThreadRef encode_thread_;
+  VideoFrame last_frame_;
   VideoCodec codec_;
   EncodedImageCallback* callback_;
 };
@@ -383,6 +393,36 @@ TEST_F(TestSimulcastEncoderAdapterFake, EncodedCallbackForDifferentEncoders) {
   EXPECT_EQ(2, simulcast_index);
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, ParallelEncoding) {
+  static_cast<SimulcastEncoderAdapter*>(adapter_.get())
+      ->SetParallelEncoding(true);
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 2, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  // Set bitrates so that we send all layers.
+  adapter_->SetRates(1200, 30);
+
+  VideoFrame input_frame;
+  input_frame.CreateEmptyFrame(codec_.width, codec_.height, codec_.width,
+                               (codec_.width + 1) / 2, (codec_.width + 1) / 2);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(0, adapter_->Encode(input_frame, NULL, &frame_types));
+
+  // All streams are done once Encode() returns. The lower resolution streams
+  // are encoded on other threads.
+  const std::vector<MockVideoEncoder*>& encoders =
+      helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (MockVideoEncoder* encoder : encoders)
+    EXPECT_EQ(3, encoder->num_encodes());
+  const rtc::PlatformThreadRef thread = rtc::CurrentThreadRef();
+  EXPECT_FALSE(rtc::IsThreadRefEqual(thread, encoders[0]->encode_thread()));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(thread, encoders[1]->encode_thread()));
+  EXPECT_TRUE(rtc::IsThreadRefEqual(thread, encoders[2]->encode_thread()));
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, SupportsNativeHandleForSingleStreams) {
   TestVp8Simulcast::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
@@ -397,9 +437,7 @@ TEST_F(TestSimulcastEncoderAdapterFake, SupportsNativeHandleForSingleStreams) {
 }
 
 TEST_F(TestSimulcastEncoderAdapterFake,
-       SupportsNativeHandleDisabledForMultipleStreams) {
-  // TODO(pbos): Implement actual test (verify that it works) when implemented
-  // for multiple streams.
+       SupportsNativeHandleForMultipleStreams) {
   TestVp8Simulcast::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
   codec_.numberOfSimulcastStreams = 3;
@@ -408,8 +446,54 @@ TEST_F(TestSimulcastEncoderAdapterFake,
   ASSERT_EQ(3u, helper_->factory()->encoders().size());
   for (MockVideoEncoder* encoder : helper_->factory()->encoders())
     encoder->set_supports_native_handle(true);
+  EXPECT_TRUE(adapter_->SupportsNativeHandle());
+  // All encoders have to take native frames.
+  helper_->factory()->encoders()[1]->set_supports_native_handle(false);
   EXPECT_FALSE(adapter_->SupportsNativeHandle());
 }
 
+// Native buffer that can scale itself.
+class ScalableNativeBuffer : public NativeHandleBuffer {
+ public:
+  ScalableNativeBuffer(int width, int height)
+      : NativeHandleBuffer(this, width, height) {}
+
+  rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() override {
+    RTC_NOTREACHED();
+    return nullptr;
+  }
+
+  rtc::scoped_refptr<VideoFrameBuffer> ScaleNative(int width,
+                                                   int height) override {
+    return new rtc::RefCountedObject<ScalableNativeBuffer>(width, height);
+  }
+};
+
+TEST_F(TestSimulcastEncoderAdapterFake, KeepsNativeFramesNative) {
+  SetupCodec();
+  // Set bitrates so that we send all layers.
+  adapter_->SetRates(1200, 30);
+  for (MockVideoEncoder* encoder : helper_->factory()->encoders())
+    encoder->set_supports_native_handle(true);
+  ASSERT_TRUE(adapter_->SupportsNativeHandle());
+
+  VideoFrame input_frame(new rtc::RefCountedObject<ScalableNativeBuffer>(
+                             codec_.width, codec_.height),
+                         100, 1000, kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, NULL, &frame_types));
+
+  const std::vector<MockVideoEncoder*>& encoders =
+      helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (size_t i = 0; i < encoders.size(); ++i) {
+    const VideoFrame& frame = encoders[i]->last_frame();
+    EXPECT_TRUE(frame.native_handle() != nullptr);
+    EXPECT_EQ(codec_.simulcastStream[i].width, frame.width());
+    EXPECT_EQ(codec_.simulcastStream[i].height, frame.height());
+    EXPECT_EQ(100u, frame.timestamp());
+  }
+}
+
 }  // namespace testing
 }  // namespace webrtc
@@ -157,7 +157,8 @@ VP8EncoderImpl::VP8EncoderImpl()
       tl0_frame_dropper_(),
       tl1_frame_dropper_(kTl1MaxTimeToDropFrames),
       key_frame_request_(kMaxSimulcastStreams, false),
-      quality_scaler_enabled_(false) {
+      quality_scaler_enabled_(false),
+      active_map_enabled_(false) {
   uint32_t seed = static_cast<uint32_t>(TickTime::MillisecondTimestamp());
   srand(seed);
 
@@ -203,6 +204,7 @@ int VP8EncoderImpl::Release() {
     delete temporal_layers_.back();
     temporal_layers_.pop_back();
   }
+  active_map_enabled_ = false;
   inited_ = false;
   return ret_val;
 }
@@ -572,8 +574,11 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
       configurations_[i].g_w = inst->simulcastStream[stream_idx].width;
       configurations_[i].g_h = inst->simulcastStream[stream_idx].height;
 
-      // Use 1 thread for lower resolutions.
-      configurations_[i].g_threads = 1;
+      // Lower resolutions get threads by their own size; below VGA that is
+      // a single thread.
+      configurations_[i].g_threads =
+          NumberOfThreads(configurations_[i].g_w, configurations_[i].g_h,
+                          number_of_cores);
 
       // Setting alignment to 32 - as that ensures at least 16 for all
       // planes (32 for Y, 16 for U,V). Libvpx sets the requested stride for
@@ -880,6 +885,17 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
   assert(codec_.maxFramerate > 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
 
+  // Macroblocks outside the update region are coded as unchanged from the
+  // last frame. The last frame is only updated by the base layer, and the
+  // update region covers everything that changed since the last frame in the
+  // base layer, so this holds with temporal layers too.
+  if (encoders_.size() == 1 && !send_key_frame && !feedback_mode_ &&
+      !only_predict_from_key_frame && input_image.update_region().known()) {
+    SetActiveMap(&input_image.update_region());
+  } else {
+    SetActiveMap(NULL);
+  }
+
   // Note we must pass 0 for |flags| field in encode call below since they are
   // set above in |vpx_codec_control| function for each encoder/spatial layer.
   int error = vpx_codec_encode(&encoders_[0], &raw_images_[0], timestamp_,
@@ -895,6 +911,26 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
   return GetEncodedPartitions(input_image, only_predict_from_key_frame);
 }
 
+void VP8EncoderImpl::SetActiveMap(const VideoFrameUpdateRegion* region) {
+  if (!region && !active_map_enabled_)
+    return;
+  const int width = static_cast<int>(raw_images_[0].d_w);
+  const int height = static_cast<int>(raw_images_[0].d_h);
+  vpx_active_map_t map;
+  map.rows = (height + 15) / 16;
+  map.cols = (width + 15) / 16;
+  map.active_map = NULL;
+  if (region) {
+    active_map_.resize(map.rows * map.cols);
+    region->FillBlockMap(width, height, 16, &active_map_[0]);
+    map.active_map = &active_map_[0];
+  }
+  if (vpx_codec_control(&encoders_[0], VP8E_SET_ACTIVEMAP, &map) ==
+      VPX_CODEC_OK) {
+    active_map_enabled_ = region != NULL;
+  }
+}
+
 // TODO(pbos): Make sure this works for properly for >1 encoders.
 int VP8EncoderImpl::UpdateCodecFrameSize(const VideoFrame& input_image) {
   codec_.width = input_image.width();
@@ -955,6 +991,7 @@ int VP8EncoderImpl::GetEncodedPartitions(const VideoFrame& input_image,
 
   int stream_idx = static_cast<int>(encoders_.size()) - 1;
   int result = WEBRTC_VIDEO_CODEC_OK;
+  int scaler_qp = -1;
   for (size_t encoder_idx = 0; encoder_idx < encoders_.size();
        ++encoder_idx, --stream_idx) {
     vpx_codec_iter_t iter = NULL;
@@ -1005,6 +1042,14 @@ int VP8EncoderImpl::GetEncodedPartitions(const VideoFrame& input_image,
 
     int qp = -1;
     vpx_codec_control(&encoders_[encoder_idx], VP8E_GET_LAST_QUANTIZER_64, &qp);
+    if (encoder_idx == 0)
+      scaler_qp = qp;
+    // Report the QP on the [0, 127] scale of the VP8 bitstream, the same as
+    // receivers parse from the frame header.
+    int bitstream_qp = -1;
+    vpx_codec_control(&encoders_[encoder_idx], VP8E_GET_LAST_QUANTIZER,
+                      &bitstream_qp);
+    encoded_images_[encoder_idx].qp_ = bitstream_qp;
     temporal_layers_[stream_idx]->FrameEncoded(
         encoded_images_[encoder_idx]._length,
         encoded_images_[encoder_idx]._timeStamp, qp);
@@ -1031,9 +1076,7 @@ int VP8EncoderImpl::GetEncodedPartitions(const VideoFrame& input_image,
   }
   if (encoders_.size() == 1 && send_stream_[0]) {
     if (encoded_images_[0]._length > 0) {
-      int qp;
-      vpx_codec_control(&encoders_[0], VP8E_GET_LAST_QUANTIZER_64, &qp);
-      quality_scaler_.ReportQP(qp);
+      quality_scaler_.ReportQP(scaler_qp);
     } else {
       quality_scaler_.ReportDroppedFrame();
     }
@@ -1053,7 +1096,8 @@ int VP8EncoderImpl::RegisterEncodeCompleteCallback(
 }
 
 VP8DecoderImpl::VP8DecoderImpl()
-    : decode_complete_callback_(NULL),
+    : buffer_pool_(SharedI420BufferPool::Default()),
+      decode_complete_callback_(NULL),
       inited_(false),
       feedback_mode_(false),
       decoder_(NULL),
@@ -1063,7 +1107,8 @@ VP8DecoderImpl::VP8DecoderImpl()
       propagation_cnt_(-1),
       last_frame_width_(0),
       last_frame_height_(0),
-      key_frame_required_(true) {}
+      key_frame_required_(true),
+      number_of_cores_(1) {}
 
 VP8DecoderImpl::~VP8DecoderImpl() {
   inited_ = true;  // in order to do the actual release
@@ -1074,7 +1119,7 @@ int VP8DecoderImpl::Reset() {
   if (!inited_) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
-  InitDecode(&codec_, 1);
+  InitDecode(&codec_, number_of_cores_);
   propagation_cnt_ = -1;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -1090,9 +1135,10 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (inst && inst->codecType == kVideoCodecVP8) {
     feedback_mode_ = inst->codecSpecific.VP8.feedbackModeOn;
   }
+  number_of_cores_ = number_of_cores;
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  // Determine number of threads based on the image size and #cores.
+  cfg.threads = NumberOfThreads(inst->width, inst->height, number_of_cores);
   cfg.h = cfg.w = 0;  // set after decode
 
   vpx_codec_flags_t flags = 0;
@@ -1119,6 +1165,24 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int VP8DecoderImpl::NumberOfThreads(int width, int height, int cpus) {
+  // The decoder threads work on macroblock rows, so this mirrors the encoder
+  // but doesn't go beyond 4 threads as there is less work per row.
+  if (width * height >= 1920 * 1080 && cpus > 4) {
+    // 4 threads for 1080p.
+    return 4;
+  } else if (width * height > 1280 * 960 && cpus >= 4) {
+    // 3 threads for 1080p on fewer cores.
+    return 3;
+  } else if (width * height > 640 * 480 && cpus >= 3) {
+    // 2 threads for qHD/HD.
+    return 2;
+  } else {
+    // 1 thread for VGA or less.
+    return 1;
+  }
+}
+
 int VP8DecoderImpl::Decode(const EncodedImage& input_image,
                            bool missing_frames,
                            const RTPFragmentationHeader* fragmentation,
@@ -1335,7 +1399,7 @@ int VP8DecoderImpl::ReturnFrame(const vpx_image_t* img,
   last_frame_width_ = img->d_w;
   last_frame_height_ = img->d_h;
   // Allocate memory for decoded image.
-  VideoFrame decoded_image(buffer_pool_.CreateBuffer(img->d_w, img->d_h),
+  VideoFrame decoded_image(buffer_pool_->CreateBuffer(img->d_w, img->d_h),
                            timestamp, 0, kVideoRotation_0);
   libyuv::I420Copy(img->planes[VPX_PLANE_Y], img->stride[VPX_PLANE_Y],
                    img->planes[VPX_PLANE_U], img->stride[VPX_PLANE_U],
@@ -1377,7 +1441,6 @@ int VP8DecoderImpl::Release() {
     delete ref_frame_;
     ref_frame_ = NULL;
   }
-  buffer_pool_.Release();
   inited_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -89,6 +89,10 @@ class VP8EncoderImpl : public VP8Encoder {
   // Set the stream state for stream |stream_idx|.
   void SetStreamState(bool send_stream, int stream_idx);
 
+  // Limits encoding to the macroblocks that intersect |region|, or encodes
+  // all of them if |region| is NULL.
+  void SetActiveMap(const VideoFrameUpdateRegion* region);
+
   uint32_t MaxIntraTarget(uint32_t optimal_buffer_size);
 
   EncodedImageCallback* encoded_complete_callback_;
@@ -118,6 +122,8 @@ class VP8EncoderImpl : public VP8Encoder {
   std::vector<vpx_rational_t> downsampling_factors_;
   QualityScaler quality_scaler_;
   bool quality_scaler_enabled_;
+  std::vector<uint8_t> active_map_;
+  bool active_map_enabled_;
 };  // end of VP8EncoderImpl class
 
 class VP8DecoderImpl : public VP8Decoder {
@@ -141,6 +147,9 @@ class VP8DecoderImpl : public VP8Decoder {
   const char* ImplementationName() const override;
 
  private:
+  // Determine number of decoder threads to use.
+  int NumberOfThreads(int width, int height, int number_of_cores);
+
   // Copy reference image from this _decoder to the _decoder in copyTo. Set
   // which frame type to copy in _refFrame->frame_type before the call to
   // this function.
@@ -153,7 +162,10 @@ class VP8DecoderImpl : public VP8Decoder {
                   uint32_t timeStamp,
                   int64_t ntp_time_ms);
 
-  I420BufferPool buffer_pool_;
+  // Decoded frames come from the process-wide pool, so that decoders of many
+  // streams share their memory. libvpx can't decode VP8 into external frame
+  // buffers, so each frame is still copied out of the decoder.
+  const rtc::scoped_refptr<SharedI420BufferPool> buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
   bool inited_;
   bool feedback_mode_;
@@ -166,6 +178,7 @@ class VP8DecoderImpl : public VP8Decoder {
   int last_frame_width_;
   int last_frame_height_;
   bool key_frame_required_;
+  int number_of_cores_;
 };  // end of VP8DecoderImpl class
 }  // namespace webrtc
 
@@ -76,7 +76,8 @@ VP9EncoderImpl::VP9EncoderImpl()
       num_spatial_layers_(0),
       frames_encoded_(0),
       // Use two spatial when screensharing with flexible mode.
-      spatial_layer_(new ScreenshareLayersVP9(2)) {
+      spatial_layer_(new ScreenshareLayersVP9(2)),
+      active_map_enabled_(false) {
   memset(&codec_, 0, sizeof(codec_));
   uint32_t seed = static_cast<uint32_t>(TickTime::MillisecondTimestamp());
   srand(seed);
@@ -106,6 +107,7 @@ int VP9EncoderImpl::Release() {
     vpx_img_free(raw_);
     raw_ = NULL;
   }
+  active_map_enabled_ = false;
   inited_ = false;
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -121,18 +123,13 @@ bool VP9EncoderImpl::SetSvcRates() {
   uint8_t i = 0;
 
   if (ExplicitlyConfiguredSpatialLayers()) {
-    if (num_temporal_layers_ > 1) {
-      LOG(LS_ERROR) << "Multiple temporal layers when manually specifying "
-                       "spatial layers not implemented yet!";
-      return false;
-    }
     int total_bitrate_bps = 0;
     for (i = 0; i < num_spatial_layers_; ++i)
       total_bitrate_bps += codec_.spatialLayers[i].target_bitrate_bps;
     // If total bitrate differs now from what has been specified at the
     // beginning, update the bitrates in the same ratio as before.
     for (i = 0; i < num_spatial_layers_; ++i) {
-      config_->ss_target_bitrate[i] = config_->layer_target_bitrate[i] =
+      config_->ss_target_bitrate[i] =
           static_cast<int>(static_cast<int64_t>(config_->rc_target_bitrate) *
                            codec_.spatialLayers[i].target_bitrate_bps /
                            total_bitrate_bps);
@@ -156,26 +153,29 @@ bool VP9EncoderImpl::SetSvcRates() {
     for (i = 0; i < num_spatial_layers_; ++i) {
       config_->ss_target_bitrate[i] = static_cast<unsigned int>(
           config_->rc_target_bitrate * rate_ratio[i] / total);
-      if (num_temporal_layers_ == 1) {
-        config_->layer_target_bitrate[i] = config_->ss_target_bitrate[i];
-      } else if (num_temporal_layers_ == 2) {
-        config_->layer_target_bitrate[i * num_temporal_layers_] =
-            config_->ss_target_bitrate[i] * 2 / 3;
-        config_->layer_target_bitrate[i * num_temporal_layers_ + 1] =
-            config_->ss_target_bitrate[i];
-      } else if (num_temporal_layers_ == 3) {
-        config_->layer_target_bitrate[i * num_temporal_layers_] =
-            config_->ss_target_bitrate[i] / 2;
-        config_->layer_target_bitrate[i * num_temporal_layers_ + 1] =
-            config_->layer_target_bitrate[i * num_temporal_layers_] +
-            (config_->ss_target_bitrate[i] / 4);
-        config_->layer_target_bitrate[i * num_temporal_layers_ + 2] =
-            config_->ss_target_bitrate[i];
-      } else {
-        LOG(LS_ERROR) << "Unsupported number of temporal layers: "
-                      << num_temporal_layers_;
-        return false;
-      }
+    }
+  }
+
+  // Split the rate of every spatial layer over its temporal layers. The
+  // layer targets are cumulative, i.e. they include the lower temporal layers
+  // of the same spatial layer.
+  for (i = 0; i < num_spatial_layers_; ++i) {
+    unsigned int* layer_target_bitrate =
+        &config_->layer_target_bitrate[i * num_temporal_layers_];
+    if (num_temporal_layers_ == 1) {
+      layer_target_bitrate[0] = config_->ss_target_bitrate[i];
+    } else if (num_temporal_layers_ == 2) {
+      layer_target_bitrate[0] = config_->ss_target_bitrate[i] * 2 / 3;
+      layer_target_bitrate[1] = config_->ss_target_bitrate[i];
+    } else if (num_temporal_layers_ == 3) {
+      layer_target_bitrate[0] = config_->ss_target_bitrate[i] / 2;
+      layer_target_bitrate[1] =
+          layer_target_bitrate[0] + (config_->ss_target_bitrate[i] / 4);
+      layer_target_bitrate[2] = config_->ss_target_bitrate[i];
+    } else {
+      LOG(LS_ERROR) << "Unsupported number of temporal layers: "
+                    << num_temporal_layers_;
+      return false;
     }
   }
 
@@ -241,8 +241,9 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   if (inst->codecSpecific.VP9.numberOfTemporalLayers > 3) {
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
-  // libvpx currently supports only one or two spatial layers.
-  if (inst->codecSpecific.VP9.numberOfSpatialLayers > 2) {
+  // Up to three spatial layers are supported, e.g. quarter, half and full
+  // resolution for camera capture.
+  if (inst->codecSpecific.VP9.numberOfSpatialLayers > 3) {
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
 
@@ -316,8 +317,12 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   } else {
     config_->kf_mode = VPX_KF_DISABLED;
   }
+  // Spatial layers take the place of internal resizing, which libvpx doesn't
+  // support in SVC mode.
   config_->rc_resize_allowed =
-      inst->codecSpecific.VP9.automaticResizeOn ? 1 : 0;
+      (inst->codecSpecific.VP9.automaticResizeOn && num_spatial_layers_ == 1)
+          ? 1
+          : 0;
   // Determine number of threads based on the image size and #cores.
   config_->g_threads =
       NumberOfThreads(config_->g_w, config_->g_h, number_of_cores);
@@ -536,6 +541,17 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
     vpx_codec_control(encoder_, VP9E_SET_SVC_REF_FRAME_CONFIG, &enc_layer_conf);
   }
 
+  // Blocks outside the update region are coded as unchanged from the last
+  // frame. Layered streams predict from other frames, so they are encoded in
+  // full.
+  if (num_spatial_layers_ == 1 && num_temporal_layers_ == 1 &&
+      !is_flexible_mode_ && !send_keyframe &&
+      input_image.update_region().known()) {
+    SetActiveMap(&input_image.update_region());
+  } else {
+    SetActiveMap(NULL);
+  }
+
   assert(codec_.maxFramerate > 0);
   uint32_t duration = 90000 / codec_.maxFramerate;
   if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
@@ -547,6 +563,24 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP9EncoderImpl::SetActiveMap(const VideoFrameUpdateRegion* region) {
+  if (!region && !active_map_enabled_)
+    return;
+  const int width = static_cast<int>(raw_->d_w);
+  const int height = static_cast<int>(raw_->d_h);
+  vpx_active_map_t map;
+  map.rows = (height + 15) / 16;
+  map.cols = (width + 15) / 16;
+  map.active_map = NULL;
+  if (region) {
+    active_map_.resize(map.rows * map.cols);
+    region->FillBlockMap(width, height, 16, &active_map_[0]);
+    map.active_map = &active_map_[0];
+  }
+  if (vpx_codec_control(encoder_, VP8E_SET_ACTIVEMAP, &map) == VPX_CODEC_OK)
+    active_map_enabled_ = region != NULL;
+}
+
 void VP9EncoderImpl::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
                                            const vpx_codec_cx_pkt& pkt,
                                            uint32_t timestamp) {
@@ -692,6 +726,9 @@ int VP9EncoderImpl::GetEncodedLayerFrame(const vpx_codec_cx_pkt* pkt) {
     encoded_image_.capture_time_ms_ = input_image_->render_time_ms();
     encoded_image_._encodedHeight = raw_->d_h;
     encoded_image_._encodedWidth = raw_->d_w;
+    int qp = -1;
+    vpx_codec_control(encoder_, VP8E_GET_LAST_QUANTIZER, &qp);
+    encoded_image_.qp_ = qp;
     encoded_complete_callback_->Encoded(encoded_image_, &codec_specific,
                                         &frag_info);
   }
@@ -77,6 +77,11 @@ class VP9EncoderImpl : public VP9Encoder {
                              uint32_t timestamp);
 
   bool ExplicitlyConfiguredSpatialLayers() const;
+
+  // Limits encoding to the macroblocks that intersect |region|, or encodes
+  // all of them if |region| is NULL.
+  void SetActiveMap(const VideoFrameUpdateRegion* region);
+
   bool SetSvcRates();
 
   // Used for flexible mode to set the flags and buffer references used
@@ -129,6 +134,8 @@ class VP9EncoderImpl : public VP9Encoder {
   uint8_t num_ref_pics_[kMaxVp9NumberOfSpatialLayers];
   uint8_t p_diff_[kMaxVp9NumberOfSpatialLayers][kMaxVp9RefPics];
   rtc::scoped_ptr<ScreenshareLayersVP9> spatial_layer_;
+  std::vector<uint8_t> active_map_;
+  bool active_map_enabled_;
 };
 
 class VP9DecoderImpl : public VP9Decoder {
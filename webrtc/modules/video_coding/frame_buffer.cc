@@ -13,6 +13,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/video_coding/packet.h"
@@ -111,12 +113,16 @@ VCMFrameBufferEnum VCMFrameBuffer::InsertPacket(
     const uint32_t increments =
         requiredSizeBytes / kBufferIncStepSizeBytes +
         (requiredSizeBytes % kBufferIncStepSizeBytes > 0);
-    const uint32_t newSize = _size + increments * kBufferIncStepSizeBytes;
-    if (newSize > kMaxJBFrameSizeBytes) {
+    const uint32_t minSize = _size + increments * kBufferIncStepSizeBytes;
+    if (minSize > kMaxJBFrameSizeBytes) {
       LOG(LS_ERROR) << "Failed to insert packet due to frame being too "
                        "big.";
       return kSizeError;
     }
+    // Grow by at least doubling, so that assembling a large key frame
+    // reallocates and copies the buffer a logarithmic number of times.
+    const uint32_t newSize = std::max(
+        minSize, std::min<uint32_t>(2 * _size, kMaxJBFrameSizeBytes));
     VerifyAndAllocate(newSize);
     _sessionInfo.UpdateDataPointers(prevBuffer, _buffer);
   }
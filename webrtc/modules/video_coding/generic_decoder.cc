@@ -71,7 +71,8 @@ int32_t VCMDecodedFrameCallback::Decoded(VideoFrame& decodedImage,
         static_cast<int32_t>(now_ms - frameInfo->decodeStartTimeMs);
   }
   _timing->StopDecodeTimer(decodedImage.timestamp(), decode_time_ms, now_ms,
-                           frameInfo->renderTimeMs);
+                           frameInfo->renderTimeMs, frameInfo->frameType,
+                           decodedImage.width() * decodedImage.height());
 
   if (callback != NULL) {
     decodedImage.set_render_time_ms(frameInfo->renderTimeMs);
@@ -146,6 +147,7 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, int64_t nowMs) {
     _frameInfos[_nextFrameInfoIdx].decodeStartTimeMs = nowMs;
     _frameInfos[_nextFrameInfoIdx].renderTimeMs = frame.RenderTimeMs();
     _frameInfos[_nextFrameInfoIdx].rotation = frame.rotation();
+    _frameInfos[_nextFrameInfoIdx].frameType = frame.FrameType();
     _callback->Map(frame.TimeStamp(), &_frameInfos[_nextFrameInfoIdx]);
 
     _nextFrameInfoIdx = (_nextFrameInfoIdx + 1) % kDecoderFrameMemoryLength;
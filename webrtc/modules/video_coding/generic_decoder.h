@@ -28,6 +28,7 @@ struct VCMFrameInformation {
   int64_t decodeStartTimeMs;
   void* userData;
   VideoRotation rotation;
+  FrameType frameType;
 };
 
 class VCMDecodedFrameCallback : public DecodedImageCallback {
@@ -243,7 +243,6 @@ VCMJitterBuffer::VCMJitterBuffer(Clock* clock,
       nack_mode_(kNoNack),
       low_rtt_nack_threshold_ms_(-1),
       high_rtt_nack_threshold_ms_(-1),
-      missing_sequence_numbers_(SequenceNumberLessThan()),
       max_nack_list_size_(0),
       max_packet_age_to_nack_(0),
       max_incomplete_time_ms_(0),
@@ -368,7 +367,7 @@ void VCMJitterBuffer::Flush() {
   waiting_for_completion_.timestamp = 0;
   waiting_for_completion_.latest_packet_time = -1;
   first_packet_since_reset_ = true;
-  missing_sequence_numbers_.clear();
+  missing_sequence_numbers_.Clear();
 }
 
 // Get received key and delta frames
@@ -558,6 +557,17 @@ bool VCMJitterBuffer::NextMaybeIncompleteTimestamp(uint32_t* timestamp) {
   return true;
 }
 
+FrameType VCMJitterBuffer::NextFrameType(uint32_t timestamp) const {
+  CriticalSectionScoped cs(crit_sect_);
+  FrameList::const_iterator it = decodable_frames_.find(timestamp);
+  if (it != decodable_frames_.end())
+    return it->second->FrameType();
+  it = incomplete_frames_.find(timestamp);
+  if (it != incomplete_frames_.end())
+    return it->second->FrameType();
+  return kVideoFrameDelta;
+}
+
 VCMEncodedFrame* VCMJitterBuffer::ExtractAndSetDecode(uint32_t timestamp) {
   CriticalSectionScoped cs(crit_sect_);
   if (!running_) {
@@ -935,7 +945,7 @@ void VCMJitterBuffer::SetNackMode(VCMNackMode mode,
   CriticalSectionScoped cs(crit_sect_);
   nack_mode_ = mode;
   if (mode == kNoNack) {
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   assert(low_rtt_nack_threshold_ms >= -1 && high_rtt_nack_threshold_ms >= -1);
   assert(high_rtt_nack_threshold_ms == -1 ||
@@ -1046,8 +1056,12 @@ std::vector<uint16_t> VCMJitterBuffer::GetNackList(bool* request_key_frame) {
       }
     }
   }
-  std::vector<uint16_t> nack_list(missing_sequence_numbers_.begin(),
-                                  missing_sequence_numbers_.end());
+  std::vector<uint16_t> nack_list;
+  nack_list.reserve(missing_sequence_numbers_.size());
+  missing_sequence_numbers_.ForEach([&nack_list](uint16_t sequence_number) {
+    nack_list.push_back(sequence_number);
+    return true;
+  });
   return nack_list;
 }
 
@@ -1076,11 +1090,13 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
   if (IsNewerSequenceNumber(sequence_number,
                             latest_received_sequence_number_)) {
     // Push any missing sequence numbers to the NACK list.
-    for (uint16_t i = latest_received_sequence_number_ + 1;
-         IsNewerSequenceNumber(sequence_number, i); ++i) {
-      missing_sequence_numbers_.insert(missing_sequence_numbers_.end(), i);
-      TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "AddNack",
-                           "seqnum", i);
+    uint16_t first_missing = latest_received_sequence_number_ + 1;
+    if (first_missing != sequence_number) {
+      missing_sequence_numbers_.InsertRange(first_missing, sequence_number);
+      TRACE_EVENT_INSTANT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "AddNack",
+                           "seqnum", first_missing, "count",
+                           static_cast<uint16_t>(sequence_number -
+                                                 first_missing));
     }
     if (TooLargeNackList() && !HandleTooLargeNackList()) {
       LOG(LS_WARNING) << "Requesting key frame due to too large NACK list.";
@@ -1092,7 +1108,7 @@ bool VCMJitterBuffer::UpdateNackList(uint16_t sequence_number) {
       return false;
     }
   } else {
-    missing_sequence_numbers_.erase(sequence_number);
+    missing_sequence_numbers_.Erase(sequence_number);
     TRACE_EVENT_INSTANT1(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "RemoveNack",
                          "seqnum", sequence_number);
   }
@@ -1122,7 +1138,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
     return false;
   }
   const uint16_t age_of_oldest_missing_packet =
-      latest_sequence_number - *missing_sequence_numbers_.begin();
+      latest_sequence_number - missing_sequence_numbers_.oldest();
   // Recycle frames if the NACK list contains too old sequence numbers as
   // the packets may have already been dropped by the sender.
   return age_of_oldest_missing_packet > max_packet_age_to_nack_;
@@ -1131,7 +1147,7 @@ bool VCMJitterBuffer::MissingTooOldPacket(
 bool VCMJitterBuffer::HandleTooOldPackets(uint16_t latest_sequence_number) {
   bool key_frame_found = false;
   const uint16_t age_of_oldest_missing_packet =
-      latest_sequence_number - *missing_sequence_numbers_.begin();
+      latest_sequence_number - missing_sequence_numbers_.oldest();
   LOG_F(LS_WARNING) << "NACK list contains too old sequence numbers: "
                     << age_of_oldest_missing_packet << " > "
                     << max_packet_age_to_nack_;
@@ -1145,9 +1161,7 @@ void VCMJitterBuffer::DropPacketsFromNackList(
     uint16_t last_decoded_sequence_number) {
   // Erase all sequence numbers from the NACK list which we won't need any
   // longer.
-  missing_sequence_numbers_.erase(
-      missing_sequence_numbers_.begin(),
-      missing_sequence_numbers_.upper_bound(last_decoded_sequence_number));
+  missing_sequence_numbers_.EraseUpTo(last_decoded_sequence_number);
 }
 
 int64_t VCMJitterBuffer::LastDecodedTimestamp() const {
@@ -1221,7 +1235,7 @@ bool VCMJitterBuffer::RecycleFramesUntilKeyFrame() {
     // All frames dropped. Reset the decoding state and clear missing sequence
     // numbers as we're starting fresh.
     last_decoded_state_.Reset();
-    missing_sequence_numbers_.clear();
+    missing_sequence_numbers_.Clear();
   }
   return key_frame_found;
 }
@@ -1280,8 +1294,7 @@ void VCMJitterBuffer::CleanUpOldOrEmptyFrames() {
 
 // Must be called from within |crit_sect_|.
 bool VCMJitterBuffer::IsPacketRetransmitted(const VCMPacket& packet) const {
-  return missing_sequence_numbers_.find(packet.seqNum) !=
-         missing_sequence_numbers_.end();
+  return missing_sequence_numbers_.Contains(packet.seqNum);
 }
 
 // Must be called under the critical section |crit_sect_|. Should never be
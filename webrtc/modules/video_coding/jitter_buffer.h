@@ -13,12 +13,12 @@
 
 #include <list>
 #include <map>
-#include <set>
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/include/sequence_number_bitset.h"
 #include "webrtc/modules/video_coding/include/video_coding.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/modules/video_coding/decoding_state.h"
@@ -155,6 +155,10 @@ class VCMJitterBuffer {
   // timestamp is returned. Otherwise, returns false.
   bool NextMaybeIncompleteTimestamp(uint32_t* timestamp);
 
+  // Returns the type of the frame with |timestamp|, or kVideoFrameDelta if it
+  // is no longer in the jitter buffer.
+  FrameType NextFrameType(uint32_t timestamp) const;
+
   // Extract frame corresponding to input timestamp.
   // Frame will be set to a decoding state.
   VCMEncodedFrame* ExtractAndSetDecode(uint32_t timestamp);
@@ -213,15 +217,6 @@ class VCMJitterBuffer {
   void RegisterStatsCallback(VCMReceiveStatisticsCallback* callback);
 
  private:
-  class SequenceNumberLessThan {
-   public:
-    bool operator()(const uint16_t& sequence_number1,
-                    const uint16_t& sequence_number2) const {
-      return IsNewerSequenceNumber(sequence_number2, sequence_number1);
-    }
-  };
-  typedef std::set<uint16_t, SequenceNumberLessThan> SequenceNumberSet;
-
   // Gets the frame assigned to the timestamp of the packet. May recycle
   // existing frames if no free frames are available. Returns an error code if
   // failing, or kNoError on success. |frame_list| contains which list the
@@ -370,7 +365,7 @@ class VCMJitterBuffer {
   int64_t low_rtt_nack_threshold_ms_;
   int64_t high_rtt_nack_threshold_ms_;
   // Holds the internal NACK list (the missing sequence numbers).
-  SequenceNumberSet missing_sequence_numbers_;
+  SequenceNumberBitset missing_sequence_numbers_;
   uint16_t latest_received_sequence_number_;
   size_t max_nack_list_size_;
   int max_packet_age_to_nack_;  // Measured in sequence numbers.
@@ -90,6 +90,7 @@ MediaOptimization::MediaOptimization(Clock* clock)
       incoming_frame_rate_(0),
       enable_qm_(false),
       encoded_frame_samples_(),
+      encoded_frame_samples_bytes_(0),
       avg_sent_bit_rate_bps_(0),
       avg_sent_framerate_(0),
       key_frame_cnt_(0),
@@ -104,7 +105,6 @@ MediaOptimization::MediaOptimization(Clock* clock)
       suspension_threshold_bps_(0),
       suspension_window_bps_(0) {
   memset(send_statistics_, 0, sizeof(send_statistics_));
-  memset(incoming_frame_times_, -1, sizeof(incoming_frame_times_));
 }
 
 MediaOptimization::~MediaOptimization(void) {
@@ -115,7 +115,7 @@ void MediaOptimization::Reset() {
   CriticalSectionScoped lock(crit_sect_.get());
   SetEncodingDataInternal(kVideoCodecUnknown, 0, 0, 0, 0, 0, 0,
                           max_payload_size_);
-  memset(incoming_frame_times_, -1, sizeof(incoming_frame_times_));
+  incoming_frame_times_.clear();
   incoming_frame_rate_ = 0.0;
   frame_dropper_->Reset();
   loss_prot_logic_->Reset(clock_->TimeInMilliseconds());
@@ -134,6 +134,7 @@ void MediaOptimization::Reset() {
   last_qm_update_time_ = 0;
   last_change_time_ = 0;
   encoded_frame_samples_.clear();
+  encoded_frame_samples_bytes_ = 0;
   avg_sent_bit_rate_bps_ = 0;
   num_layers_ = 1;
 }
@@ -351,6 +352,7 @@ int32_t MediaOptimization::UpdateWithEncodedData(
     encoded_frame_samples_.push_back(
         EncodedFrameSample(encoded_length, timestamp, now_ms));
   }
+  encoded_frame_samples_bytes_ += encoded_length;
   UpdateSentBitrate(now_ms);
   UpdateSentFramerate();
   if (encoded_length > 0) {
@@ -439,15 +441,12 @@ void MediaOptimization::UpdateContentData(
 
 void MediaOptimization::UpdateIncomingFrameRate() {
   int64_t now = clock_->TimeInMilliseconds();
-  if (incoming_frame_times_[0] == 0) {
-    // No shifting if this is the first time.
-  } else {
-    // Shift all times one step.
-    for (int32_t i = (kFrameCountHistorySize - 2); i >= 0; i--) {
-      incoming_frame_times_[i + 1] = incoming_frame_times_[i];
-    }
+  incoming_frame_times_.push_front(now);
+  // At most the newest kFrameCountHistorySize - 1 frames are used.
+  if (incoming_frame_times_.size() >
+      static_cast<size_t>(kFrameCountHistorySize - 1)) {
+    incoming_frame_times_.pop_back();
   }
-  incoming_frame_times_[0] = now;
   ProcessIncomingFrameRate(now);
 }
 
@@ -485,6 +484,7 @@ void MediaOptimization::PurgeOldFrameSamples(int64_t now_ms) {
   while (!encoded_frame_samples_.empty()) {
     if (now_ms - encoded_frame_samples_.front().time_complete_ms >
         kBitrateAverageWinMs) {
+      encoded_frame_samples_bytes_ -= encoded_frame_samples_.front().size_bytes;
       encoded_frame_samples_.pop_front();
     } else {
       break;
@@ -497,11 +497,9 @@ void MediaOptimization::UpdateSentBitrate(int64_t now_ms) {
     avg_sent_bit_rate_bps_ = 0;
     return;
   }
-  size_t framesize_sum = 0;
-  for (FrameSampleList::iterator it = encoded_frame_samples_.begin();
-       it != encoded_frame_samples_.end(); ++it) {
-    framesize_sum += it->size_bytes;
-  }
+  // Kept up to date as samples are added and purged, so that the average
+  // doesn't need a pass over all samples per encoded frame.
+  const size_t framesize_sum = encoded_frame_samples_bytes_;
   float denom = static_cast<float>(
       now_ms - encoded_frame_samples_.front().time_complete_ms);
   if (denom >= 1.0f) {
@@ -539,7 +537,7 @@ bool MediaOptimization::QMUpdate(
   if (qm->change_resolution_temporal) {
     incoming_frame_rate_ = qm->frame_rate;
     // Reset frame rate estimate.
-    memset(incoming_frame_times_, -1, sizeof(incoming_frame_times_));
+    incoming_frame_times_.clear();
   }
 
   // Check for change in frame size.
@@ -588,20 +586,17 @@ bool MediaOptimization::CheckStatusForQMchange() {
 
 // Allowing VCM to keep track of incoming frame rate.
 void MediaOptimization::ProcessIncomingFrameRate(int64_t now) {
-  int32_t num = 0;
-  int32_t nr_of_frames = 0;
-  for (num = 1; num < (kFrameCountHistorySize - 1); ++num) {
-    if (incoming_frame_times_[num] <= 0 ||
-        // don't use data older than 2 s
-        now - incoming_frame_times_[num] > kFrameHistoryWinMs) {
-      break;
-    } else {
-      nr_of_frames++;
-    }
+  // Don't use data older than 2 s. Times only grow older, so old frames are
+  // removed for good instead of being skipped on every call. The newest frame
+  // is kept as the end of the window.
+  while (incoming_frame_times_.size() > 1 &&
+         now - incoming_frame_times_.back() > kFrameHistoryWinMs) {
+    incoming_frame_times_.pop_back();
   }
-  if (num > 1) {
+  if (incoming_frame_times_.size() > 1) {
+    const int nr_of_frames = static_cast<int>(incoming_frame_times_.size()) - 1;
     const int64_t diff =
-        incoming_frame_times_[0] - incoming_frame_times_[num - 1];
+        incoming_frame_times_.front() - incoming_frame_times_.back();
     incoming_frame_rate_ = 0.0;  // No frame rate estimate available.
     if (diff > 0) {
       incoming_frame_rate_ = nr_of_frames * 1000.0f / static_cast<float>(diff);
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_MEDIA_OPTIMIZATION_H_
 #define WEBRTC_MODULES_VIDEO_CODING_MEDIA_OPTIMIZATION_H_
 
+#include <deque>
 #include <list>
 
 #include "webrtc/base/scoped_ptr.h"
@@ -151,9 +152,13 @@ class MediaOptimization {
   int32_t max_payload_size_ GUARDED_BY(crit_sect_);
   int video_target_bitrate_ GUARDED_BY(crit_sect_);
   float incoming_frame_rate_ GUARDED_BY(crit_sect_);
-  int64_t incoming_frame_times_[kFrameCountHistorySize] GUARDED_BY(crit_sect_);
+  // Capture times of the most recent incoming frames, newest first. Frames
+  // that are too old to be used are removed.
+  std::deque<int64_t> incoming_frame_times_ GUARDED_BY(crit_sect_);
   bool enable_qm_ GUARDED_BY(crit_sect_);
   std::list<EncodedFrameSample> encoded_frame_samples_ GUARDED_BY(crit_sect_);
+  // The sum of the sizes in |encoded_frame_samples_|.
+  size_t encoded_frame_samples_bytes_ GUARDED_BY(crit_sect_);
   uint32_t avg_sent_bit_rate_bps_ GUARDED_BY(crit_sect_);
   uint32_t avg_sent_framerate_ GUARDED_BY(crit_sect_);
   uint32_t key_frame_cnt_ GUARDED_BY(crit_sect_);
@@ -16,6 +16,7 @@
 * This file includes parameters for content-aware media optimization
 ****************************************************************/
 
+#include "webrtc/modules/video_coding/qm_select.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -107,74 +108,75 @@ const float kFacLowRate = 0.5f;
 // Action for down-sampling:
 // motion=L/H/D,spatial==L/H/D, for low, high, middle levels;
 // rate = 0/1/2, for target rate state relative to transition rate.
-const uint8_t kSpatialAction[27] = {
+// The tables hold the actions themselves, so a decision is a single lookup.
+const SpatialAction kSpatialAction[27] = {
     // rateClass = 0:
-    1,  // L, L
-    1,  // L, H
-    1,  // L, D
-    4,  // H ,L
-    1,  // H, H
-    4,  // H, D
-    4,  // D, L
-    1,  // D, H
-    2,  // D, D
+    kNoChangeSpatial,           // L, L
+    kNoChangeSpatial,           // L, H
+    kNoChangeSpatial,           // L, D
+    kOneQuarterSpatialUniform,  // H ,L
+    kNoChangeSpatial,           // H, H
+    kOneQuarterSpatialUniform,  // H, D
+    kOneQuarterSpatialUniform,  // D, L
+    kNoChangeSpatial,           // D, H
+    kOneHalfSpatialUniform,     // D, D
 
     // rateClass = 1:
-    1,  // L, L
-    1,  // L, H
-    1,  // L, D
-    2,  // H ,L
-    1,  // H, H
-    2,  // H, D
-    2,  // D, L
-    1,  // D, H
-    2,  // D, D
+    kNoChangeSpatial,           // L, L
+    kNoChangeSpatial,           // L, H
+    kNoChangeSpatial,           // L, D
+    kOneHalfSpatialUniform,     // H ,L
+    kNoChangeSpatial,           // H, H
+    kOneHalfSpatialUniform,     // H, D
+    kOneHalfSpatialUniform,     // D, L
+    kNoChangeSpatial,           // D, H
+    kOneHalfSpatialUniform,     // D, D
 
     // rateClass = 2:
-    1,  // L, L
-    1,  // L, H
-    1,  // L, D
-    2,  // H ,L
-    1,  // H, H
-    2,  // H, D
-    2,  // D, L
-    1,  // D, H
-    2,  // D, D
+    kNoChangeSpatial,           // L, L
+    kNoChangeSpatial,           // L, H
+    kNoChangeSpatial,           // L, D
+    kOneHalfSpatialUniform,     // H ,L
+    kNoChangeSpatial,           // H, H
+    kOneHalfSpatialUniform,     // H, D
+    kOneHalfSpatialUniform,     // D, L
+    kNoChangeSpatial,           // D, H
+    kOneHalfSpatialUniform,     // D, D
 };
 
-const uint8_t kTemporalAction[27] = {
+const TemporalAction kTemporalAction[27] = {
     // rateClass = 0:
-    3,  // L, L
-    2,  // L, H
-    2,  // L, D
-    1,  // H ,L
-    3,  // H, H
-    1,  // H, D
-    1,  // D, L
-    2,  // D, H
-    1,  // D, D
+    kTwoThirdsTemporal,  // L, L
+    kOneHalfTemporal,    // L, H
+    kOneHalfTemporal,    // L, D
+    kNoChangeTemporal,   // H ,L
+    kTwoThirdsTemporal,  // H, H
+    kNoChangeTemporal,   // H, D
+    kNoChangeTemporal,   // D, L
+    kOneHalfTemporal,    // D, H
+    kNoChangeTemporal,   // D, D
 
     // rateClass = 1:
-    3,  // L, L
-    3,  // L, H
-    3,  // L, D
-    1,  // H ,L
-    3,  // H, H
-    1,  // H, D
-    1,  // D, L
-    3,  // D, H
-    1,  // D, D
+    kTwoThirdsTemporal,  // L, L
+    kTwoThirdsTemporal,  // L, H
+    kTwoThirdsTemporal,  // L, D
+    kNoChangeTemporal,   // H ,L
+    kTwoThirdsTemporal,  // H, H
+    kNoChangeTemporal,   // H, D
+    kNoChangeTemporal,   // D, L
+    kTwoThirdsTemporal,  // D, H
+    kNoChangeTemporal,   // D, D
 
     // rateClass = 2:
-    1,  // L, L
-    3,  // L, H
-    3,  // L, D
-    1,  // H ,L
-    3,  // H, H
-    1,  // H, D
-    1,  // D, L
-    3,  // D, H
-    1,  // D, D
+    kNoChangeTemporal,   // L, L
+    kTwoThirdsTemporal,  // L, H
+    kTwoThirdsTemporal,  // L, D
+    kNoChangeTemporal,   // H ,L
+    kTwoThirdsTemporal,  // H, H
+    kNoChangeTemporal,   // H, D
+    kNoChangeTemporal,   // D, L
+    kTwoThirdsTemporal,  // D, H
+    kNoChangeTemporal,   // D, D
 };
 
 // Control the total amount of down-sampling allowed.
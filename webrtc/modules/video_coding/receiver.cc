@@ -143,14 +143,17 @@ VCMEncodedFrame* VCMReceiver::FrameForDecoding(uint16_t max_wait_time_ms,
   }
 
   if (prefer_late_decoding) {
-    // Decode frame as close as possible to the render timestamp.
+    // Decode frame as close as possible to the render timestamp. Key frames
+    // take longer to decode, so the decode time budget depends on the type of
+    // the frame rather than on the slowest frame seen recently.
     const int32_t available_wait_time =
         max_wait_time_ms -
         static_cast<int32_t>(clock_->TimeInMilliseconds() - start_time_ms);
     uint16_t new_max_wait_time =
         static_cast<uint16_t>(VCM_MAX(available_wait_time, 0));
     uint32_t wait_time_ms = timing_->MaxWaitingTime(
-        *next_render_time_ms, clock_->TimeInMilliseconds());
+        *next_render_time_ms, clock_->TimeInMilliseconds(),
+        jitter_buffer_.NextFrameType(frame_timestamp));
     if (new_max_wait_time < wait_time_ms) {
       // We're not allowed to wait until the frame is supposed to be rendered,
       // waiting as long as we're allowed to avoid busy looping, and then return
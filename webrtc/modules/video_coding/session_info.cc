@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/video_coding/session_info.h"
 
+#include <vector>
+
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/video_coding/packet.h"
 
@@ -29,6 +31,8 @@ VCMSessionInfo::VCMSessionInfo()
       decodable_(false),
       frame_type_(kVideoFrameDelta),
       packets_(),
+      length_(0),
+      in_order_(true),
       empty_seq_num_low_(-1),
       empty_seq_num_high_(-1),
       first_packet_seq_num_(-1),
@@ -137,6 +141,8 @@ void VCMSessionInfo::Reset() {
   decodable_ = false;
   frame_type_ = kVideoFrameDelta;
   packets_.clear();
+  length_ = 0;
+  in_order_ = true;
   empty_seq_num_low_ = -1;
   empty_seq_num_high_ = -1;
   first_packet_seq_num_ = -1;
@@ -144,10 +150,7 @@ void VCMSessionInfo::Reset() {
 }
 
 size_t VCMSessionInfo::SessionLength() const {
-  size_t length = 0;
-  for (PacketIteratorConst it = packets_.begin(); it != packets_.end(); ++it)
-    length += (*it).sizeBytes;
-  return length;
+  return length_;
 }
 
 int VCMSessionInfo::NumPackets() const {
@@ -157,12 +160,13 @@ int VCMSessionInfo::NumPackets() const {
 size_t VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
                                     PacketIterator packet_it) {
   VCMPacket& packet = *packet_it;
-  PacketIterator it;
 
-  // Calculate the offset into the frame buffer for this packet.
-  size_t offset = 0;
-  for (it = packets_.begin(); it != packet_it; ++it)
-    offset += (*it).sizeBytes;
+  // The data is appended to the frame buffer in arrival order, so a
+  // reordered packet doesn't move the data of the packets after it. The data
+  // is put in sequence number order once, by Linearize().
+  const size_t offset = length_;
+  if (packet_it != --packets_.end())
+    in_order_ = false;
 
   // Set the data pointer to pointing to the start of this packet in the
   // frame buffer.
@@ -186,7 +190,6 @@ size_t VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
           length + (packet.insertStartCode ? kH264StartCodeLengthBytes : 0);
       nalu_ptr += kLengthFieldLength + length;
     }
-    ShiftSubsequentPackets(packet_it, required_length);
     nalu_ptr = packet_buffer + kH264NALHeaderLengthInBytes;
     uint8_t* frame_buffer_ptr = frame_buffer + offset;
     while (nalu_ptr < packet_buffer + packet.sizeBytes) {
@@ -197,18 +200,45 @@ size_t VCMSessionInfo::InsertBuffer(uint8_t* frame_buffer,
       nalu_ptr += length;
     }
     packet.sizeBytes = required_length;
+    length_ += packet.sizeBytes;
     return packet.sizeBytes;
   }
-  ShiftSubsequentPackets(
-      packet_it, packet.sizeBytes +
-                     (packet.insertStartCode ? kH264StartCodeLengthBytes : 0));
 
   packet.sizeBytes =
       Insert(packet_buffer, packet.sizeBytes, packet.insertStartCode,
              const_cast<uint8_t*>(packet.dataPtr));
+  length_ += packet.sizeBytes;
   return packet.sizeBytes;
 }
 
+void VCMSessionInfo::Linearize() {
+  if (in_order_)
+    return;
+  // The data of all packets is contiguous, starting with the packet that
+  // arrived first, which therefore has the lowest data pointer.
+  uint8_t* base_ptr = NULL;
+  std::vector<uint8_t> data;
+  data.reserve(length_);
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr == NULL)
+      continue;
+    if (base_ptr == NULL || (*it).dataPtr < base_ptr)
+      base_ptr = const_cast<uint8_t*>((*it).dataPtr);
+    data.insert(data.end(), (*it).dataPtr, (*it).dataPtr + (*it).sizeBytes);
+  }
+  assert(data.size() == length_);
+  if (!data.empty())
+    memcpy(base_ptr, &data[0], data.size());
+  size_t offset = 0;
+  for (PacketIterator it = packets_.begin(); it != packets_.end(); ++it) {
+    if ((*it).dataPtr == NULL)
+      continue;
+    (*it).dataPtr = base_ptr + offset;
+    offset += (*it).sizeBytes;
+  }
+  in_order_ = true;
+}
+
 size_t VCMSessionInfo::Insert(const uint8_t* buffer,
                               size_t length,
                               bool insert_start_code,
@@ -242,19 +272,13 @@ void VCMSessionInfo::ShiftSubsequentPackets(PacketIterator it,
 
 void VCMSessionInfo::UpdateCompleteSession() {
   if (HaveFirstPacket() && HaveLastPacket()) {
-    // Do we have all the packets in this session?
-    bool complete_session = true;
-    PacketIterator it = packets_.begin();
-    PacketIterator prev_it = it;
-    ++it;
-    for (; it != packets_.end(); ++it) {
-      if (!InSequence(it, prev_it)) {
-        complete_session = false;
-        break;
-      }
-      prev_it = it;
-    }
-    complete_ = complete_session;
+    // Do we have all the packets in this session? The list is sorted by
+    // sequence number, so there are no gaps exactly when it holds as many
+    // packets as its first and last sequence numbers span. A duplicate entry
+    // makes the list longer than the span, and the session incomplete.
+    const uint16_t span = static_cast<uint16_t>(packets_.back().seqNum -
+                                                packets_.front().seqNum);
+    complete_ = packets_.size() == static_cast<size_t>(span) + 1;
   }
 }
 
@@ -327,6 +351,7 @@ size_t VCMSessionInfo::DeletePacketData(PacketIterator start,
   }
   if (bytes_to_delete > 0)
     ShiftSubsequentPackets(end, -static_cast<int>(bytes_to_delete));
+  length_ -= bytes_to_delete;
   return bytes_to_delete;
 }
 
@@ -342,6 +367,7 @@ size_t VCMSessionInfo::BuildVP8FragmentationHeader(
          kMaxVP8Partitions * sizeof(size_t));
   if (packets_.empty())
     return new_length;
+  Linearize();
   PacketIterator it = FindNextPartitionBeginning(packets_.begin());
   while (it != packets_.end()) {
     const int partition_id =
@@ -426,6 +452,7 @@ size_t VCMSessionInfo::MakeDecodable() {
   if (packets_.empty()) {
     return 0;
   }
+  Linearize();
   PacketIterator it = packets_.begin();
   // Make sure we remove the first NAL unit if it's not decodable.
   if ((*it).completeNALU == kNaluIncomplete || (*it).completeNALU == kNaluEnd) {
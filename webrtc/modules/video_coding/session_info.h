@@ -62,7 +62,9 @@ class VCMSessionInfo {
 
   // Makes the frame decodable. I.e., only contain decodable NALUs. All
   // non-decodable NALUs will be deleted and packets will be moved to in
-  // memory to remove any empty space.
+  // memory to remove any empty space. Until this or
+  // BuildVP8FragmentationHeader() is called, the data of packets inserted out
+  // of order isn't in sequence number order in the frame buffer.
   // Returns the number of bytes deleted from the session.
   size_t MakeDecodable();
 
@@ -117,6 +119,9 @@ class VCMSessionInfo {
   static bool InSequence(const PacketIterator& it,
                          const PacketIterator& prev_it);
   size_t InsertBuffer(uint8_t* frame_buffer, PacketIterator packetIterator);
+  // Reorders the packet data in the frame buffer to sequence number order, if
+  // packets were inserted out of order.
+  void Linearize();
   size_t Insert(const uint8_t* buffer,
                 size_t length,
                 bool insert_start_code,
@@ -153,6 +158,11 @@ class VCMSessionInfo {
   webrtc::FrameType frame_type_;
   // Packets in this frame.
   PacketList packets_;
+  // Bytes of packet data in the frame buffer.
+  size_t length_;
+  // False if the packet data isn't laid out in sequence number order in the
+  // frame buffer, because packets were inserted out of order.
+  bool in_order_;
   int empty_seq_num_low_;
   int empty_seq_num_high_;
 
@@ -212,6 +212,35 @@ TEST_F(TestSessionInfo, NormalOperation) {
   }
 }
 
+TEST_F(TestSessionInfo, CompleteOnlyWhenAllPacketsInserted) {
+  // Insert packets 0, 2, 4, ... then 1, 3, 5, ... with sequence numbers
+  // wrapping around. The session is complete only after the last gap is
+  // filled, and the data is in sequence number order once it is prepared for
+  // decoding.
+  const uint16_t kFirstSeqNum = 0xFFFB;
+  const int kNumPackets = 10;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int i = pass; i < kNumPackets; i += 2) {
+      packet_.seqNum = kFirstSeqNum + i;
+      packet_.isFirstPacket = i == 0;
+      packet_.markerBit = i == kNumPackets - 1;
+      FillPacket(i);
+      EXPECT_FALSE(session_.complete());
+      ASSERT_EQ(packet_buffer_size(),
+                static_cast<size_t>(session_.InsertPacket(
+                    packet_, frame_buffer_, kNoErrors, frame_data)));
+    }
+  }
+  EXPECT_TRUE(session_.complete());
+
+  EXPECT_EQ(0U, session_.MakeDecodable());
+  EXPECT_EQ(kNumPackets * packet_buffer_size(), session_.SessionLength());
+  for (int i = 0; i < kNumPackets; ++i) {
+    SCOPED_TRACE("Calling VerifyPacket");
+    VerifyPacket(frame_buffer_ + i * packet_buffer_size(), i);
+  }
+}
+
 TEST_F(TestSessionInfo, ErrorsEqualDecodableState) {
   packet_.seqNum = 0xFFFF;
   packet_.isFirstPacket = false;
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_coding/temporal_layer_dropper.h"
+
+#include <algorithm>
+
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+namespace {
+// Layer changes are at least this far apart, so that the decode time has
+// adjusted to the layers decoded since the last one.
+const int64_t kMinLayerChangeIntervalMs = 2000;
+// A discarded layer is resumed when decoding takes less than this fraction
+// of the time between the frames decoded with it.
+const float kResumeDecodeTimeRatio = 0.7f;
+const float kFrameIntervalFilterAlpha = 0.9f;
+// Longer gaps between frames are pauses rather than the frame interval.
+const uint32_t kMaxFrameIntervalMs = 1000;
+const uint32_t kRtpTicksPerMs = 90;
+}  // namespace
+
+VCMTemporalLayerDropper::VCMTemporalLayerDropper()
+    : frame_interval_ms_(kFrameIntervalFilterAlpha) {
+  Reset();
+}
+
+void VCMTemporalLayerDropper::Reset() {
+  num_temporal_layers_ = 1;
+  target_temporal_idx_ = 0;
+  decoded_temporal_idx_ = 0;
+  has_last_timestamp_ = false;
+  last_timestamp_ = 0;
+  frame_interval_ms_.Reset(kFrameIntervalFilterAlpha);
+  last_layer_change_ms_ = -1;
+}
+
+bool VCMTemporalLayerDropper::DropFrame(
+    const EncodedImage& frame,
+    const CodecSpecificInfo& codec_specific,
+    int decode_time_ms,
+    int64_t now_ms) {
+  if (codec_specific.codecType != kVideoCodecVP8)
+    return false;
+  const CodecSpecificInfoVP8& vp8 = codec_specific.codecSpecific.VP8;
+  if (vp8.temporalIdx >= kMaxTemporalStreams)
+    return false;
+  const int temporal_idx = vp8.temporalIdx;
+
+  if (!has_last_timestamp_ ||
+      IsNewerTimestamp(frame._timeStamp, last_timestamp_)) {
+    if (has_last_timestamp_) {
+      uint32_t interval_ms =
+          (frame._timeStamp - last_timestamp_) / kRtpTicksPerMs;
+      if (interval_ms > 0 && interval_ms <= kMaxFrameIntervalMs)
+        frame_interval_ms_.Apply(1.0f, static_cast<float>(interval_ms));
+    }
+    has_last_timestamp_ = true;
+    last_timestamp_ = frame._timeStamp;
+  }
+
+  if (temporal_idx >= num_temporal_layers_) {
+    // Layers that show up while all layers are decoded are decoded as well.
+    if (target_temporal_idx_ == num_temporal_layers_ - 1)
+      target_temporal_idx_ = temporal_idx;
+    num_temporal_layers_ = temporal_idx + 1;
+  }
+
+  UpdateTargetLayer(decode_time_ms, now_ms);
+
+  // Key frames don't depend on anything, so every layer up to the target can
+  // be resumed after one.
+  if (frame._frameType == kVideoFrameKey)
+    decoded_temporal_idx_ = target_temporal_idx_;
+  if (temporal_idx <= decoded_temporal_idx_)
+    return false;
+  // A layer sync frame only depends on the base layer, but the frames after
+  // it may depend on the layer right below, so layers are resumed in order.
+  if (temporal_idx == decoded_temporal_idx_ + 1 &&
+      temporal_idx <= target_temporal_idx_ && vp8.layerSync) {
+    decoded_temporal_idx_ = temporal_idx;
+    return false;
+  }
+  return true;
+}
+
+float VCMTemporalLayerDropper::FrameIntervalMs(int temporal_idx) const {
+  // Every temporal layer doubles the frame rate of the layers below it.
+  return frame_interval_ms_.filtered() *
+         (1 << (num_temporal_layers_ - 1 - temporal_idx));
+}
+
+void VCMTemporalLayerDropper::UpdateTargetLayer(int decode_time_ms,
+                                                int64_t now_ms) {
+  if (frame_interval_ms_.filtered() == rtc::ExpFilter::kValueUndefined ||
+      decode_time_ms <= 0) {
+    return;
+  }
+  if (last_layer_change_ms_ >= 0 &&
+      now_ms - last_layer_change_ms_ < kMinLayerChangeIntervalMs) {
+    return;
+  }
+  if (target_temporal_idx_ > 0 &&
+      decode_time_ms > FrameIntervalMs(target_temporal_idx_)) {
+    LOG(LS_INFO) << "Decoding takes " << decode_time_ms
+                 << " ms per frame, discarding temporal layer "
+                 << target_temporal_idx_;
+    --target_temporal_idx_;
+    decoded_temporal_idx_ =
+        std::min(decoded_temporal_idx_, target_temporal_idx_);
+    last_layer_change_ms_ = now_ms;
+  } else if (target_temporal_idx_ < num_temporal_layers_ - 1 &&
+             decode_time_ms <
+                 kResumeDecodeTimeRatio *
+                     FrameIntervalMs(target_temporal_idx_ + 1)) {
+    ++target_temporal_idx_;
+    LOG(LS_INFO) << "Decoding takes " << decode_time_ms
+                 << " ms per frame, resuming temporal layer "
+                 << target_temporal_idx_;
+    last_layer_change_ms_ = now_ms;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_CODING_TEMPORAL_LAYER_DROPPER_H_
+#define WEBRTC_MODULES_VIDEO_CODING_TEMPORAL_LAYER_DROPPER_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/exp_filter.h"
+#include "webrtc/modules/video_coding/include/video_codec_interface.h"
+#include "webrtc/typedefs.h"
+#include "webrtc/video_frame.h"
+
+namespace webrtc {
+
+// Decides which VP8 temporal layers a CPU-bound receiver decodes. When the
+// time it takes to decode a frame exceeds the time between the frames that
+// are decoded, the highest of those temporal layers is discarded, halving the
+// decoded frame rate. Frames never reference a higher temporal layer than
+// their own, so the remaining ones decode without errors and without a key
+// frame request. A discarded layer is resumed, at its next layer sync frame,
+// once decoding is fast enough for the higher frame rate.
+class VCMTemporalLayerDropper {
+ public:
+  VCMTemporalLayerDropper();
+
+  void Reset();
+
+  // Returns true if |frame| should be discarded instead of decoded.
+  // |decode_time_ms| is the time decoding a frame is expected to take.
+  bool DropFrame(const EncodedImage& frame,
+                 const CodecSpecificInfo& codec_specific,
+                 int decode_time_ms,
+                 int64_t now_ms);
+
+  // The highest temporal layer that is currently decoded.
+  int decoded_temporal_idx() const { return decoded_temporal_idx_; }
+
+ private:
+  // Returns the time between the frames decoded when the layers above
+  // |temporal_idx| are discarded.
+  float FrameIntervalMs(int temporal_idx) const;
+  // Lowers or raises |target_temporal_idx_| if decoding too slow or fast
+  // enough for the layers currently decoded.
+  void UpdateTargetLayer(int decode_time_ms, int64_t now_ms);
+
+  int num_temporal_layers_;
+  // The highest layer to decode, and the highest one that is decoded. They
+  // differ while waiting for a layer sync frame to resume a layer at.
+  int target_temporal_idx_;
+  int decoded_temporal_idx_;
+  bool has_last_timestamp_;
+  uint32_t last_timestamp_;
+  rtc::ExpFilter frame_interval_ms_;
+  int64_t last_layer_change_ms_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VCMTemporalLayerDropper);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_CODING_TEMPORAL_LAYER_DROPPER_H_
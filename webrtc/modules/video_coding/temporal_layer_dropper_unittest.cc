@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
+#include "webrtc/modules/video_coding/temporal_layer_dropper.h"
+
+namespace webrtc {
+
+namespace {
+const int kFrameIntervalMs = 33;
+// The temporal layers of the VP8 three layer pattern.
+const int kTemporalIds[] = {0, 2, 1, 2};
+}  // namespace
+
+class TestTemporalLayerDropper : public ::testing::Test {
+ protected:
+  TestTemporalLayerDropper()
+      : frame_num_(0), now_ms_(0), layer_sync_enabled_(true) {
+    memset(&codec_specific_, 0, sizeof(codec_specific_));
+    codec_specific_.codecType = kVideoCodecVP8;
+  }
+
+  int NextTemporalIdx() const {
+    return kTemporalIds[frame_num_ % arraysize(kTemporalIds)];
+  }
+  // Every frame of the top layer is a layer sync frame in this pattern, the
+  // middle layer only every other time.
+  bool NextLayerSync() const {
+    int temporal_idx = NextTemporalIdx();
+    return layer_sync_enabled_ &&
+           (temporal_idx == 2 || (temporal_idx == 1 && frame_num_ % 8 == 2));
+  }
+
+  // Passes the next frame of the three layer pattern to the dropper and
+  // returns its temporal layer, or -1 if it was dropped.
+  int NextFrame(int decode_time_ms) { return NextFrame(decode_time_ms, false); }
+  int NextFrame(int decode_time_ms, bool key_frame) {
+    int temporal_idx = key_frame ? 0 : NextTemporalIdx();
+    EncodedImage frame;
+    frame._timeStamp =
+        static_cast<uint32_t>(frame_num_ * kFrameIntervalMs * 90);
+    frame._frameType = key_frame ? kVideoFrameKey : kVideoFrameDelta;
+    codec_specific_.codecSpecific.VP8.temporalIdx =
+        static_cast<uint8_t>(temporal_idx);
+    codec_specific_.codecSpecific.VP8.layerSync = !key_frame && NextLayerSync();
+    ++frame_num_;
+    now_ms_ += kFrameIntervalMs;
+    bool drop =
+        dropper_.DropFrame(frame, codec_specific_, decode_time_ms, now_ms_);
+    return drop ? -1 : temporal_idx;
+  }
+
+  // Runs |num_frames| frames and returns the highest layer decoded.
+  int RunFrames(int num_frames, int decode_time_ms) {
+    int max_decoded = -1;
+    for (int i = 0; i < num_frames; ++i)
+      max_decoded = std::max(max_decoded, NextFrame(decode_time_ms));
+    return max_decoded;
+  }
+
+  VCMTemporalLayerDropper dropper_;
+  CodecSpecificInfo codec_specific_;
+  int frame_num_;
+  int64_t now_ms_;
+  bool layer_sync_enabled_;
+};
+
+TEST_F(TestTemporalLayerDropper, DecodesAllLayersWhenFastEnough) {
+  EXPECT_EQ(2, RunFrames(300, kFrameIntervalMs / 2));
+  EXPECT_EQ(2, dropper_.decoded_temporal_idx());
+}
+
+TEST_F(TestTemporalLayerDropper, DropsTopLayerWhenTooSlow) {
+  EXPECT_EQ(2, RunFrames(8, 1));
+  // Too slow for the full frame rate, but fast enough for half of it.
+  const int kDecodeTimeMs = kFrameIntervalMs * 3 / 2;
+  RunFrames(8, kDecodeTimeMs);
+  EXPECT_EQ(1, dropper_.decoded_temporal_idx());
+  EXPECT_EQ(1, RunFrames(300, kDecodeTimeMs));
+  EXPECT_EQ(1, dropper_.decoded_temporal_idx());
+}
+
+TEST_F(TestTemporalLayerDropper, NeverDropsTheBaseLayer) {
+  RunFrames(8, 1);
+  RunFrames(300, kFrameIntervalMs * 10);
+  EXPECT_EQ(0, dropper_.decoded_temporal_idx());
+  for (int i = 0; i < 8; ++i) {
+    int expected = NextTemporalIdx() == 0 ? 0 : -1;
+    EXPECT_EQ(expected, NextFrame(kFrameIntervalMs * 10));
+  }
+}
+
+TEST_F(TestTemporalLayerDropper, ResumesLayersAtLayerSyncFrames) {
+  RunFrames(8, 1);
+  RunFrames(300, kFrameIntervalMs * 10);
+  ASSERT_EQ(0, dropper_.decoded_temporal_idx());
+
+  // Layers are resumed one at a time, each at one of its layer sync frames.
+  int decoded_temporal_idx = 0;
+  for (int i = 0; i < 300; ++i) {
+    int temporal_idx = NextTemporalIdx();
+    bool layer_sync = NextLayerSync();
+    int decoded = NextFrame(1);
+    if (decoded > decoded_temporal_idx) {
+      EXPECT_EQ(decoded_temporal_idx + 1, decoded);
+      EXPECT_EQ(temporal_idx, decoded);
+      EXPECT_TRUE(layer_sync);
+      decoded_temporal_idx = decoded;
+    }
+  }
+  EXPECT_EQ(2, decoded_temporal_idx);
+  EXPECT_EQ(2, dropper_.decoded_temporal_idx());
+}
+
+TEST_F(TestTemporalLayerDropper, KeyFrameResumesTargetLayers) {
+  RunFrames(8, 1);
+  RunFrames(300, kFrameIntervalMs * 10);
+  ASSERT_EQ(0, dropper_.decoded_temporal_idx());
+  // Without layer sync frames, the layers can't be resumed before a key frame.
+  layer_sync_enabled_ = false;
+  EXPECT_EQ(0, RunFrames(300, 1));
+  EXPECT_EQ(0, NextFrame(1, true));
+  EXPECT_EQ(2, dropper_.decoded_temporal_idx());
+  EXPECT_EQ(2, RunFrames(4, 1));
+}
+
+TEST_F(TestTemporalLayerDropper, IgnoresOtherCodecs) {
+  codec_specific_.codecType = kVideoCodecVP9;
+  EncodedImage frame;
+  for (int i = 0; i < 100; ++i) {
+    frame._timeStamp = i * kFrameIntervalMs * 90;
+    EXPECT_FALSE(dropper_.DropFrame(frame, codec_specific_,
+                                    kFrameIntervalMs * 10, i * 1000));
+  }
+}
+
+}  // namespace webrtc
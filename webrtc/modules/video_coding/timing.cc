@@ -171,9 +171,11 @@ void VCMTiming::UpdateCurrentDelay(int64_t render_time_ms,
 int32_t VCMTiming::StopDecodeTimer(uint32_t time_stamp,
                                    int32_t decode_time_ms,
                                    int64_t now_ms,
-                                   int64_t render_time_ms) {
+                                   int64_t render_time_ms,
+                                   FrameType frame_type,
+                                   int num_pixels) {
   CriticalSectionScoped cs(crit_sect_);
-  codec_timer_.MaxFilter(decode_time_ms, now_ms);
+  codec_timer_.AddTiming(decode_time_ms, now_ms, frame_type, num_pixels);
   assert(decode_time_ms >= 0);
   last_decode_ms_ = decode_time_ms;
 
@@ -224,11 +226,12 @@ int32_t VCMTiming::MaxDecodeTimeMs(
 }
 
 uint32_t VCMTiming::MaxWaitingTime(int64_t render_time_ms,
-                                   int64_t now_ms) const {
+                                   int64_t now_ms,
+                                   FrameType frame_type) const {
   CriticalSectionScoped cs(crit_sect_);
 
   const int64_t max_wait_time_ms =
-      render_time_ms - now_ms - MaxDecodeTimeMs() - render_delay_ms_;
+      render_time_ms - now_ms - MaxDecodeTimeMs(frame_type) - render_delay_ms_;
 
   if (max_wait_time_ms < 0) {
     return 0;
@@ -236,6 +239,11 @@ uint32_t VCMTiming::MaxWaitingTime(int64_t render_time_ms,
   return static_cast<uint32_t>(max_wait_time_ms);
 }
 
+int VCMTiming::RequiredDecodeTimeMs() const {
+  CriticalSectionScoped cs(crit_sect_);
+  return MaxDecodeTimeMs();
+}
+
 bool VCMTiming::EnoughTimeToDecode(
     uint32_t available_processing_time_ms) const {
   CriticalSectionScoped cs(crit_sect_);
@@ -55,11 +55,15 @@ class VCMTiming {
                           int64_t actual_decode_time_ms);
 
   // Stops the decoder timer, should be called when the decoder returns a frame
-  // or when the decoded frame callback is called.
+  // or when the decoded frame callback is called. |frame_type| and
+  // |num_pixels| select the decode time model the sample goes into; see
+  // VCMCodecTimer.
   int32_t StopDecodeTimer(uint32_t time_stamp,
                           int32_t decode_time_ms,
                           int64_t now_ms,
-                          int64_t render_time_ms);
+                          int64_t render_time_ms,
+                          FrameType frame_type = kVideoFrameDelta,
+                          int num_pixels = 0);
 
   // Used to report that a frame is passed to decoding. Updates the timestamp
   // filter which is used to map between timestamps and receiver system time.
@@ -70,13 +74,19 @@ class VCMTiming {
   int64_t RenderTimeMs(uint32_t frame_timestamp, int64_t now_ms) const;
 
   // Returns the maximum time in ms that we can wait for a frame to become
-  // complete before we must pass it to the decoder.
-  uint32_t MaxWaitingTime(int64_t render_time_ms, int64_t now_ms) const;
+  // complete before we must pass it to the decoder, given that decoding it
+  // takes as long as frames of |frame_type| usually do.
+  uint32_t MaxWaitingTime(int64_t render_time_ms,
+                          int64_t now_ms,
+                          FrameType frame_type = kVideoFrameDelta) const;
 
   // Returns the current target delay which is required delay + decode time +
   // render delay.
   uint32_t TargetVideoDelay() const;
 
+  // Returns the time decoding a delta frame is expected to take.
+  int RequiredDecodeTimeMs() const;
+
   // Calculates whether or not there is enough time to decode a frame given a
   // certain amount of processing time.
   bool EnoughTimeToDecode(uint32_t available_processing_time_ms) const;
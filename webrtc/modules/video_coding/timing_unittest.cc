@@ -146,4 +146,65 @@ TEST(ReceiverTiming, WrapAround) {
   }
 }
 
+TEST(ReceiverTiming, DecodeTimeIgnoresOutliers) {
+  const int kNumPixels = 640 * 480;
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  for (int i = 0; i < 100; ++i) {
+    // Two frames out of a hundred take far longer than the rest.
+    const int decode_time_ms = (i % 50 == 25) ? 200 : 10;
+    clock.AdvanceTimeMilliseconds(decode_time_ms);
+    timing.StopDecodeTimer(i, decode_time_ms, clock.TimeInMilliseconds(),
+                           clock.TimeInMilliseconds(), kVideoFrameDelta,
+                           kNumPixels);
+    clock.AdvanceTimeMilliseconds(1000 / 30);
+  }
+  EXPECT_EQ(10, timing.RequiredDecodeTimeMs());
+}
+
+TEST(ReceiverTiming, KeyFramesHaveTheirOwnDecodeTime) {
+  const int kNumPixels = 640 * 480;
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  for (int i = 0; i < 30; ++i) {
+    timing.StopDecodeTimer(i, 10, clock.TimeInMilliseconds(),
+                           clock.TimeInMilliseconds(), kVideoFrameDelta,
+                           kNumPixels);
+    clock.AdvanceTimeMilliseconds(1000 / 30);
+  }
+  const int64_t render_time_ms = clock.TimeInMilliseconds() + 100;
+  const uint32_t delta_wait_time_ms =
+      timing.MaxWaitingTime(render_time_ms, clock.TimeInMilliseconds());
+  // Without any timed key frame, the delta frame estimate is used.
+  EXPECT_EQ(delta_wait_time_ms,
+            timing.MaxWaitingTime(render_time_ms, clock.TimeInMilliseconds(),
+                                  kVideoFrameKey));
+
+  timing.StopDecodeTimer(30, 50, clock.TimeInMilliseconds(),
+                         clock.TimeInMilliseconds(), kVideoFrameKey,
+                         kNumPixels);
+  EXPECT_EQ(10, timing.RequiredDecodeTimeMs());
+  EXPECT_EQ(delta_wait_time_ms,
+            timing.MaxWaitingTime(render_time_ms, clock.TimeInMilliseconds()));
+  EXPECT_EQ(delta_wait_time_ms - 40,
+            timing.MaxWaitingTime(render_time_ms, clock.TimeInMilliseconds(),
+                                  kVideoFrameKey));
+}
+
+TEST(ReceiverTiming, ResolutionChangeResetsDecodeTime) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  for (int i = 0; i < 30; ++i) {
+    timing.StopDecodeTimer(i, 20, clock.TimeInMilliseconds(),
+                           clock.TimeInMilliseconds(), kVideoFrameDelta,
+                           1280 * 720);
+    clock.AdvanceTimeMilliseconds(1000 / 30);
+  }
+  EXPECT_EQ(20, timing.RequiredDecodeTimeMs());
+  timing.StopDecodeTimer(30, 5, clock.TimeInMilliseconds(),
+                         clock.TimeInMilliseconds(), kVideoFrameDelta,
+                         320 * 240);
+  EXPECT_EQ(5, timing.RequiredDecodeTimeMs());
+}
+
 }  // namespace webrtc
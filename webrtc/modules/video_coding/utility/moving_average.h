@@ -11,11 +11,13 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_UTILITY_MOVING_AVERAGE_H_
 #define WEBRTC_MODULES_VIDEO_CODING_UTILITY_MOVING_AVERAGE_H_
 
-#include <list>
+#include <deque>
 
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+// Average of the latest samples. Samples are kept in a deque, which stores
+// them in contiguous blocks rather than allocating a list node per sample.
 template <class T>
 class MovingAverage {
  public:
@@ -27,7 +29,7 @@ class MovingAverage {
 
  private:
   T sum_;
-  std::list<T> samples_;
+  std::deque<T> samples_;
 };
 
 template <class T>
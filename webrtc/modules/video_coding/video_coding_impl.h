@@ -24,6 +24,7 @@
 #include "webrtc/modules/video_coding/jitter_buffer.h"
 #include "webrtc/modules/video_coding/media_optimization.h"
 #include "webrtc/modules/video_coding/receiver.h"
+#include "webrtc/modules/video_coding/temporal_layer_dropper.h"
 #include "webrtc/modules/video_coding/timing.h"
 #include "webrtc/modules/video_coding/utility/qp_parser.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -211,6 +212,7 @@ class VideoReceiver {
   EncodedImageCallback* pre_decode_image_callback_ GUARDED_BY(_receiveCritSect);
 
   VCMCodecDataBase _codecDataBase GUARDED_BY(_receiveCritSect);
+  VCMTemporalLayerDropper layer_dropper_ GUARDED_BY(_receiveCritSect);
   VCMProcessTimer _receiveStatsTimer;
   VCMProcessTimer _retransmissionTimer;
   VCMProcessTimer _keyRequestTimer;
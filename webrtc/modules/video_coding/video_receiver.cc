@@ -307,6 +307,14 @@ int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
     }
   }
 #endif
+  // Discard frames of the highest temporal layers if decoding can't keep up,
+  // before the jitter buffer overflows and reference frames are lost.
+  if (layer_dropper_.DropFrame(frame->EncodedImage(), *frame->CodecSpecific(),
+                               _timing.RequiredDecodeTimeMs(),
+                               clock_->TimeInMilliseconds())) {
+    _receiver.ReleaseFrame(frame);
+    return VCM_OK;
+  }
   const int32_t ret = Decode(*frame);
   _receiver.ReleaseFrame(frame);
   return ret;
@@ -388,6 +396,7 @@ int32_t VideoReceiver::ResetDecoder() {
     if (_decoder != NULL) {
       _receiver.Reset();
       _timing.Reset();
+      layer_dropper_.Reset();
       reset_key_request = true;
       _decoder->Reset();
     }
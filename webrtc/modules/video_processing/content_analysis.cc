@@ -40,6 +40,14 @@ VPMContentAnalysis::VPMContentAnalysis(bool runtime_cpu_detection)
       ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_SSE2;
       TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_SSE2;
     }
+#elif defined(WEBRTC_HAS_NEON)
+    ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_NEON;
+    TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_NEON;
+#elif defined(WEBRTC_DETECT_NEON)
+    if (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) {
+      ComputeSpatialMetrics = &VPMContentAnalysis::ComputeSpatialMetrics_NEON;
+      TemporalDiffMetric = &VPMContentAnalysis::TemporalDiffMetric_NEON;
+    }
 #endif
   }
   Release();
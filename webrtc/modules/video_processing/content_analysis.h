@@ -63,6 +63,10 @@ class VPMContentAnalysis {
   int32_t ComputeSpatialMetrics_SSE2();
   int32_t TemporalDiffMetric_SSE2();
 #endif
+#if defined(WEBRTC_HAS_NEON) || defined(WEBRTC_DETECT_NEON)
+  int32_t ComputeSpatialMetrics_NEON();
+  int32_t TemporalDiffMetric_NEON();
+#endif
 
   const uint8_t* orig_frame_;
   uint8_t* prev_frame_;
@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_processing/content_analysis.h"
+
+#include <arm_neon.h>
+#include <math.h>
+
+namespace webrtc {
+
+static uint64_t HorizontalAddU32x4(const uint32x4_t v_32x4) {
+  const uint64x2_t a = vpaddlq_u32(v_32x4);
+  return vgetq_lane_u64(a, 0) + vgetq_lane_u64(a, 1);
+}
+
+static uint64_t HorizontalAddU64x2(const uint64x2_t v_64x2) {
+  return vgetq_lane_u64(v_64x2, 0) + vgetq_lane_u64(v_64x2, 1);
+}
+
+int32_t VPMContentAnalysis::TemporalDiffMetric_NEON() {
+  uint32_t num_pixels = 0;  // counter for # of pixels
+  const uint8_t* imgBufO = orig_frame_ + border_ * width_ + border_;
+  const uint8_t* imgBufP = prev_frame_ + border_ * width_ + border_;
+
+  const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
+
+  uint32x4_t sad_32 = vdupq_n_u32(0);
+  uint32x4_t sum_32 = vdupq_n_u32(0);
+  uint64x2_t sqsum_64 = vdupq_n_u64(0);
+
+  for (int32_t i = 0; i < (height_ - 2 * border_); i += skip_num_) {
+    // A lane gains at most 4 * 255 * 255 per 16 pixels, so a row of even 4K
+    // content fits in 32 bits. Rows are added to a 64 bit sum.
+    uint32x4_t sqsum_32 = vdupq_n_u32(0);
+
+    const uint8_t* lineO = imgBufO;
+    const uint8_t* lineP = imgBufP;
+
+    for (int32_t j = 0; j < width_end - border_; j += 16) {
+      const uint8x16_t o = vld1q_u8(lineO);
+      const uint8x16_t p = vld1q_u8(lineP);
+
+      lineO += 16;
+      lineP += 16;
+
+      // Abs pixel difference between frames.
+      sad_32 = vpadalq_u16(sad_32, vpaddlq_u8(vabdq_u8(o, p)));
+
+      // sum of all pixels in frame
+      sum_32 = vpadalq_u16(sum_32, vpaddlq_u8(o));
+
+      // Squared sum of all pixels in frame.
+      const uint8x8_t olo = vget_low_u8(o);
+      const uint8x8_t ohi = vget_high_u8(o);
+      sqsum_32 = vpadalq_u16(sqsum_32, vmull_u8(olo, olo));
+      sqsum_32 = vpadalq_u16(sqsum_32, vmull_u8(ohi, ohi));
+    }
+
+    sqsum_64 = vpadalq_u32(sqsum_64, sqsum_32);
+
+    imgBufO += width_ * skip_num_;
+    imgBufP += width_ * skip_num_;
+    num_pixels += (width_end - border_);
+  }
+
+  const uint32_t pixelSum = HorizontalAddU32x4(sum_32);
+  const uint64_t pixelSqSum = HorizontalAddU64x2(sqsum_64);
+  const uint32_t tempDiffSum = HorizontalAddU32x4(sad_32);
+
+  // Default.
+  motion_magnitude_ = 0.0f;
+
+  if (tempDiffSum == 0)
+    return VPM_OK;
+
+  // Normalize over all pixels.
+  const float tempDiffAvg =
+      static_cast<float>(tempDiffSum) / static_cast<float>(num_pixels);
+  const float pixelSumAvg =
+      static_cast<float>(pixelSum) / static_cast<float>(num_pixels);
+  const float pixelSqSumAvg =
+      static_cast<float>(pixelSqSum) / static_cast<float>(num_pixels);
+  float contrast = pixelSqSumAvg - (pixelSumAvg * pixelSumAvg);
+
+  if (contrast > 0.0) {
+    contrast = sqrt(contrast);
+    motion_magnitude_ = tempDiffAvg / contrast;
+  }
+
+  return VPM_OK;
+}
+
+int32_t VPMContentAnalysis::ComputeSpatialMetrics_NEON() {
+  const uint8_t* imgBuf = orig_frame_ + border_ * width_;
+  const int32_t width_end = ((width_ - 2 * border_) & -16) + border_;
+
+  uint32x4_t se_32 = vdupq_n_u32(0);
+  uint32x4_t sev_32 = vdupq_n_u32(0);
+  uint32x4_t seh_32 = vdupq_n_u32(0);
+  uint32x4_t msa_32 = vdupq_n_u32(0);
+
+  // Unlike the SSE2 version, which keeps 16 bit row sums, every 16 pixels
+  // are added to the 32 bit sums directly, so no content can roll them over
+  // before the C version would.
+  // skip_num_ is also used to reduce the number of rows
+  for (int32_t i = 0; i < (height_ - 2 * border_); i += skip_num_) {
+    const uint8_t* lineTop = imgBuf - width_ + border_;
+    const uint8_t* lineCen = imgBuf + border_;
+    const uint8_t* lineBot = imgBuf + width_ + border_;
+
+    for (int32_t j = 0; j < width_end - border_; j += 16) {
+      const uint8x16_t t = vld1q_u8(lineTop);
+      const uint8x16_t l = vld1q_u8(lineCen - 1);
+      const uint8x16_t c = vld1q_u8(lineCen);
+      const uint8x16_t r = vld1q_u8(lineCen + 1);
+      const uint8x16_t b = vld1q_u8(lineBot);
+
+      lineTop += 16;
+      lineCen += 16;
+      lineBot += 16;
+
+      // left right pixels and top bottom pixels added together. All values
+      // below are at most 4 * 255, so the 16 bit math is exact.
+      const int16x8_t lrlo = vreinterpretq_s16_u16(
+          vaddl_u8(vget_low_u8(l), vget_low_u8(r)));
+      const int16x8_t lrhi = vreinterpretq_s16_u16(
+          vaddl_u8(vget_high_u8(l), vget_high_u8(r)));
+      const int16x8_t tblo = vreinterpretq_s16_u16(
+          vaddl_u8(vget_low_u8(t), vget_low_u8(b)));
+      const int16x8_t tbhi = vreinterpretq_s16_u16(
+          vaddl_u8(vget_high_u8(t), vget_high_u8(b)));
+
+      // running sum of all pixels
+      msa_32 = vpadalq_u16(msa_32, vpaddlq_u8(c));
+
+      // center pixel times two and times four
+      const int16x8_t c2lo =
+          vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(c), 1));
+      const int16x8_t c2hi =
+          vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(c), 1));
+      const int16x8_t c4lo = vshlq_n_s16(c2lo, 1);
+      const int16x8_t c4hi = vshlq_n_s16(c2hi, 1);
+
+      se_32 = vpadalq_u16(se_32, vreinterpretq_u16_s16(vabdq_s16(
+                                     c4lo, vaddq_s16(lrlo, tblo))));
+      se_32 = vpadalq_u16(se_32, vreinterpretq_u16_s16(vabdq_s16(
+                                     c4hi, vaddq_s16(lrhi, tbhi))));
+      sev_32 =
+          vpadalq_u16(sev_32, vreinterpretq_u16_s16(vabdq_s16(c2lo, tblo)));
+      sev_32 =
+          vpadalq_u16(sev_32, vreinterpretq_u16_s16(vabdq_s16(c2hi, tbhi)));
+      seh_32 =
+          vpadalq_u16(seh_32, vreinterpretq_u16_s16(vabdq_s16(c2lo, lrlo)));
+      seh_32 =
+          vpadalq_u16(seh_32, vreinterpretq_u16_s16(vabdq_s16(c2hi, lrhi)));
+    }
+
+    imgBuf += width_ * skip_num_;
+  }
+
+  const uint32_t spatialErrSum = HorizontalAddU32x4(se_32);
+  const uint32_t spatialErrVSum = HorizontalAddU32x4(sev_32);
+  const uint32_t spatialErrHSum = HorizontalAddU32x4(seh_32);
+  const uint32_t pixelMSA = HorizontalAddU32x4(msa_32);
+
+  // Normalize over all pixels.
+  const float spatialErr = static_cast<float>(spatialErrSum >> 2);
+  const float spatialErrH = static_cast<float>(spatialErrHSum >> 1);
+  const float spatialErrV = static_cast<float>(spatialErrVSum >> 1);
+  const float norm = static_cast<float>(pixelMSA);
+
+  // 2X2:
+  spatial_pred_err_ = spatialErr / norm;
+
+  // 1X2:
+  spatial_pred_err_h_ = spatialErrH / norm;
+
+  // 2X1:
+  spatial_pred_err_v_ = spatialErrV / norm;
+
+  return VPM_OK;
+}
+
+}  // namespace webrtc
@@ -34,6 +34,8 @@ rtc::scoped_ptr<DenoiserFilter> DenoiserFilter::Create(
     } else {
       filter.reset(new DenoiserFilterC());
     }
+#elif defined(WEBRTC_HAS_NEON)
+    filter.reset(new DenoiserFilterNEON());
 #elif defined(WEBRTC_DETECT_NEON)
     if (WebRtc_GetCPUFeaturesARM() & kCPUFeatureNEON) {
       filter.reset(new DenoiserFilterNEON());
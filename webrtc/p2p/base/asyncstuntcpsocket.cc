@@ -95,26 +95,29 @@ void AsyncStunTCPSocket::ProcessInput(char* data, size_t* len) {
   // |         Channel Number        |            Length             |
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
-  while (true) {
-    // We need at least 4 bytes to read the STUN or ChannelData packet length.
-    if (*len < kPacketLenOffset + kPacketLenSize)
-      return;
-
+  // Deliver every complete packet in place, then move a trailing partial
+  // packet to the front of the buffer once.
+  size_t pos = 0;
+  // We need at least 4 bytes to read the STUN or ChannelData packet length.
+  while (*len - pos >= kPacketLenOffset + kPacketLenSize) {
     int pad_bytes;
-    size_t expected_pkt_len = GetExpectedLength(data, *len, &pad_bytes);
+    size_t expected_pkt_len =
+        GetExpectedLength(data + pos, *len - pos, &pad_bytes);
     size_t actual_length = expected_pkt_len + pad_bytes;
 
-    if (*len < actual_length) {
-      return;
+    if (*len - pos < actual_length) {
+      break;
     }
 
-    SignalReadPacket(this, data, expected_pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos, expected_pkt_len, remote_addr,
                      rtc::CreatePacketTime(0));
 
-    *len -= actual_length;
-    if (*len > 0) {
-      memmove(data, data + actual_length, *len);
-    }
+    pos += actual_length;
+  }
+
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
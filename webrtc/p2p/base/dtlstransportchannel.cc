@@ -32,6 +32,10 @@ static const size_t kMinRtpPacketLen = 12;
 // after they have been written, so a capacity of "1" is sufficient.
 static const size_t kMaxPendingPackets = 1;
 
+enum {
+  MSG_FLUSH_DTLS_RECORDS = 1,
+};
+
 static bool IsDtlsPacket(const char* data, size_t len) {
   const uint8_t* u = reinterpret_cast<const uint8_t*>(data);
   return (len >= kDtlsRecordHeaderLen && (u[0] > 19 && u[0] < 64));
@@ -44,7 +48,8 @@ static bool IsRtpPacket(const char* data, size_t len) {
 StreamInterfaceChannel::StreamInterfaceChannel(TransportChannel* channel)
     : channel_(channel),
       state_(rtc::SS_OPEN),
-      packets_(kMaxPendingPackets, kMaxDtlsPacketLen) {
+      packets_(kMaxPendingPackets, kMaxDtlsPacketLen),
+      max_packet_size_(0) {
 }
 
 rtc::StreamResult StreamInterfaceChannel::Read(void* buffer,
@@ -69,15 +74,45 @@ rtc::StreamResult StreamInterfaceChannel::Write(const void* data,
                                                       int* error) {
   // Always succeeds, since this is an unreliable transport anyway.
   // TODO: Should this block if channel_'s temporarily unwritable?
-  rtc::PacketOptions packet_options;
-  channel_->SendPacket(static_cast<const char*>(data), data_len,
-                       packet_options);
+  if (coalescing()) {
+    if (pending_packet_.size() + data_len > max_packet_size_)
+      SendPendingPacket();
+    if (data_len < max_packet_size_) {
+      pending_packet_.AppendData(static_cast<const uint8_t*>(data), data_len);
+    } else {
+      SendPacket(data, data_len);
+    }
+  } else {
+    SendPacket(data, data_len);
+  }
   if (written) {
     *written = data_len;
   }
   return rtc::SR_SUCCESS;
 }
 
+void StreamInterfaceChannel::StartCoalescing(size_t max_packet_size) {
+  ASSERT(max_packet_size > 0);
+  max_packet_size_ = max_packet_size;
+}
+
+void StreamInterfaceChannel::StopCoalescing() {
+  SendPendingPacket();
+  max_packet_size_ = 0;
+}
+
+void StreamInterfaceChannel::SendPacket(const void* data, size_t size) {
+  rtc::PacketOptions packet_options;
+  channel_->SendPacket(static_cast<const char*>(data), size, packet_options);
+}
+
+void StreamInterfaceChannel::SendPendingPacket() {
+  if (pending_packet_.size() == 0)
+    return;
+  SendPacket(pending_packet_.data(), pending_packet_.size());
+  pending_packet_.SetSize(0);
+}
+
 bool StreamInterfaceChannel::OnPacketReceived(const char* data, size_t size) {
   // We force a read event here to ensure that we don't overflow our queue.
   bool ret = packets_.WriteBack(data, size, NULL);
@@ -370,6 +405,12 @@ int DtlsTransportChannelWrapper::SendPacket(
 
         return channel_->SendPacket(data, size, options);
       } else {
+        if (coalesced_packet_size_ > 0 && !downward_->coalescing()) {
+          // Hold the records back until we're done with the current message,
+          // so whatever else gets sent by then can share their packets.
+          downward_->StartCoalescing(coalesced_packet_size_);
+          worker_thread_->Post(this, MSG_FLUSH_DTLS_RECORDS);
+        }
         return (dtls_->WriteAll(data, size, NULL, NULL) == rtc::SR_SUCCESS)
                    ? static_cast<int>(size)
                    : -1;
@@ -542,7 +583,8 @@ void DtlsTransportChannelWrapper::OnDtlsEvent(rtc::StreamInterface* dtls,
   if (sig & rtc::SE_READ) {
     char buf[kMaxDtlsPacketLen];
     size_t read;
-    if (dtls_->Read(buf, sizeof(buf), &read, NULL) == rtc::SR_SUCCESS) {
+    // A packet may carry several records, so read until the stream blocks.
+    while (dtls_->Read(buf, sizeof(buf), &read, NULL) == rtc::SR_SUCCESS) {
       SignalReadPacket(this, buf, read, rtc::CreatePacketTime(0), 0);
     }
   }
@@ -628,6 +670,20 @@ void DtlsTransportChannelWrapper::OnConnectionRemoved(
   SignalConnectionRemoved(this);
 }
 
+void DtlsTransportChannelWrapper::OnMessage(rtc::Message* msg) {
+  switch (msg->message_id) {
+    case MSG_FLUSH_DTLS_RECORDS:
+      // |downward_| may have been replaced since the message was posted, in
+      // which case there's nothing to flush.
+      if (downward_)
+        downward_->StopCoalescing();
+      break;
+    default:
+      ASSERT(false);
+      break;
+  }
+}
+
 void DtlsTransportChannelWrapper::Reconnect() {
   set_dtls_state(DTLS_TRANSPORT_NEW);
   set_writable(false);
@@ -16,7 +16,8 @@
 
 #include "webrtc/p2p/base/transportchannelimpl.h"
 #include "webrtc/base/buffer.h"
-#include "webrtc/base/bufferqueue.h"
+#include "webrtc/base/lockfreebufferqueue.h"
+#include "webrtc/base/messagehandler.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/stream.h"
@@ -32,6 +33,14 @@ class StreamInterfaceChannel : public rtc::StreamInterface {
   // Push in a packet; this gets pulled out from Read().
   bool OnPacketReceived(const char* data, size_t size);
 
+  // Until StopCoalescing() is called, packs what gets written into as few
+  // packets of at most |max_packet_size| bytes as it can, rather than sending
+  // each write as a packet of its own.
+  void StartCoalescing(size_t max_packet_size);
+  // Sends the packet being coalesced, if any, and stops coalescing.
+  void StopCoalescing();
+  bool coalescing() const { return max_packet_size_ > 0; }
+
   // Implementations of StreamInterface
   rtc::StreamState GetState() const override { return state_; }
   void Close() override { state_ = rtc::SS_CLOSED; }
@@ -45,9 +54,15 @@ class StreamInterfaceChannel : public rtc::StreamInterface {
                           int* error) override;
 
  private:
+  void SendPacket(const void* data, size_t size);
+  void SendPendingPacket();
+
   TransportChannel* channel_;  // owned by DtlsTransportChannelWrapper
   rtc::StreamState state_;
-  rtc::BufferQueue packets_;
+  // Written by OnPacketReceived() and read by Read().
+  rtc::LockFreeBufferQueue packets_;
+  size_t max_packet_size_;  // 0 when not coalescing.
+  rtc::Buffer pending_packet_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(StreamInterfaceChannel);
 };
@@ -79,7 +94,12 @@ class StreamInterfaceChannel : public rtc::StreamInterface {
 //
 //   - The SSLStreamAdapter writes to downward_->Write()
 //     which translates it into packet writes on channel_.
-class DtlsTransportChannelWrapper : public TransportChannelImpl {
+//
+//   - With record coalescing on, the records written to downward_ are
+//     collected until the current message has been handled, and then sent
+//     several to a packet.
+class DtlsTransportChannelWrapper : public TransportChannelImpl,
+                                    public rtc::MessageHandler {
  public:
   // The parameters here are:
   // transport -- the DtlsTransport that created us
@@ -123,6 +143,16 @@ class DtlsTransportChannelWrapper : public TransportChannelImpl {
 
   virtual bool SetSslMaxProtocolVersion(rtc::SSLProtocolVersion version);
 
+  // When |max_packet_size| isn't 0, the DTLS records of the data sent while
+  // handling one message on the worker thread are packed into packets of up
+  // to |max_packet_size| bytes, which should be no more than the path MTU
+  // allows. By default, each record is sent as a packet of its own.
+  void SetRecordCoalescing(size_t max_packet_size) {
+    coalesced_packet_size_ = max_packet_size;
+  }
+
+  void OnMessage(rtc::Message* msg) override;
+
   // Set up the ciphers to use for DTLS-SRTP. If this method is not called
   // before DTLS starts, or |ciphers| is empty, SRTP keys won't be negotiated.
   // This method should be called before SetupDtls.
@@ -231,6 +261,7 @@ class DtlsTransportChannelWrapper : public TransportChannelImpl {
   rtc::SSLProtocolVersion ssl_max_version_;
   rtc::Buffer remote_fingerprint_value_;
   std::string remote_fingerprint_algorithm_;
+  size_t coalesced_packet_size_ = 0;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(DtlsTransportChannelWrapper);
 };
@@ -51,7 +51,8 @@ class DtlsTestClient : public sigslot::has_slots<> {
         ssl_max_version_(rtc::SSL_PROTOCOL_DTLS_12),
         negotiated_dtls_(false),
         received_dtls_client_hello_(false),
-        received_dtls_server_hello_(false) {}
+        received_dtls_server_hello_(false),
+        num_application_data_packets_(0) {}
   void CreateCertificate(rtc::KeyType key_type) {
     certificate_ =
         rtc::RTCCertificate::Create(rtc::scoped_ptr<rtc::SSLIdentity>(
@@ -98,6 +99,11 @@ class DtlsTestClient : public sigslot::has_slots<> {
 
   cricket::Transport* transport() { return transport_.get(); }
 
+  void SetRecordCoalescing(size_t max_packet_size) {
+    for (cricket::DtlsTransportChannelWrapper* channel : channels_)
+      channel->SetRecordCoalescing(max_packet_size);
+  }
+
   cricket::FakeTransportChannel* GetFakeChannel(int component) {
     cricket::TransportChannelImpl* ch = transport_->GetChannel(component);
     cricket::DtlsTransportChannelWrapper* wrapper =
@@ -290,6 +296,12 @@ class DtlsTestClient : public sigslot::has_slots<> {
     return received_.size();
   }
 
+  // The number of packets of encrypted data that came in on the underlying
+  // channels.
+  size_t num_application_data_packets() const {
+    return num_application_data_packets_;
+  }
+
   bool VerifyPacket(const char* data, size_t size, uint32_t* out_num) {
     if (size != packet_size_ ||
         (data[0] != 0 && static_cast<uint8_t>(data[0]) != 0x80)) {
@@ -368,6 +380,7 @@ class DtlsTestClient : public sigslot::has_slots<> {
       } else if (!(data[0] >= 20 && data[0] <= 22)) {
         ASSERT_TRUE(data[0] == 23 || IsRtpLeadByte(data[0]));
         if (data[0] == 23) {
+          ++num_application_data_packets_;
           ASSERT_TRUE(VerifyEncryptedPacket(data, size));
         } else if (IsRtpLeadByte(data[0])) {
           ASSERT_TRUE(VerifyPacket(data, size, NULL));
@@ -388,6 +401,7 @@ class DtlsTestClient : public sigslot::has_slots<> {
   bool negotiated_dtls_;
   bool received_dtls_client_hello_;
   bool received_dtls_server_hello_;
+  size_t num_application_data_packets_;
   rtc::SentPacket sent_packet_;
 };
 
@@ -632,6 +646,27 @@ TEST_F(DtlsTransportChannelTest, MAYBE_TestTransferDtlsTwoChannels) {
   TestTransfer(1, 1000, 100, false);
 }
 
+#if defined(MEMORY_SANITIZER)
+// Fails under MemorySanitizer:
+// See https://code.google.com/p/webrtc/issues/detail?id=5381.
+#define MAYBE_TestTransferDtlsCoalesced DISABLED_TestTransferDtlsCoalesced
+#else
+#define MAYBE_TestTransferDtlsCoalesced TestTransferDtlsCoalesced
+#endif
+// Connect with DTLS and record coalescing, and check that data sent in one
+// go shares packets and still arrives intact.
+TEST_F(DtlsTransportChannelTest, MAYBE_TestTransferDtlsCoalesced) {
+  MAYBE_SKIP_TEST(HaveDtls);
+  PrepareDtls(true, true, rtc::KT_DEFAULT);
+  ASSERT_TRUE(Connect());
+  client1_.SetRecordCoalescing(1200);
+  TestTransfer(0, 100, 20, false);
+  EXPECT_LT(client2_.num_application_data_packets(), 20u);
+
+  // Records bigger than a packet are still sent.
+  TestTransfer(0, 1500, 5, false);
+}
+
 // Connect with A doing DTLS and B not, and transfer some data.
 TEST_F(DtlsTransportChannelTest, TestTransferDtlsRejected) {
   PrepareDtls(true, false, rtc::KT_DEFAULT);
@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/icecheckbudget.h"
+
+#include "webrtc/base/basictypes.h"
+
+namespace cricket {
+
+namespace {
+const double kBudgetPeriodSeconds = 1.0;
+}  // namespace
+
+IceCheckBudget::IceCheckBudget()
+    : limiter_(0, kBudgetPeriodSeconds), last_use_ms_(0) {}
+
+IceCheckBudget* IceCheckBudget::GetDefault() {
+  RTC_DEFINE_STATIC_LOCAL(IceCheckBudget, default_budget, ());
+  return &default_budget;
+}
+
+void IceCheckBudget::SetMaxChecksPerSecond(size_t max_checks_per_second) {
+  rtc::CritScope cs(&crit_);
+  limiter_ = rtc::RateLimiter(max_checks_per_second, kBudgetPeriodSeconds);
+}
+
+size_t IceCheckBudget::max_checks_per_second() const {
+  rtc::CritScope cs(&crit_);
+  return limiter_.max_per_period();
+}
+
+bool IceCheckBudget::TryUse(uint32_t now) {
+  rtc::CritScope cs(&crit_);
+  if (limiter_.max_per_period() == 0) {
+    return true;
+  }
+  if (now < last_use_ms_) {
+    // rtc::Time() wrapped around; start a new period.
+    limiter_ =
+        rtc::RateLimiter(limiter_.max_per_period(), kBudgetPeriodSeconds);
+  }
+  last_use_ms_ = now;
+  double now_seconds = now / 1000.0;
+  if (!limiter_.CanUse(1, now_seconds)) {
+    return false;
+  }
+  limiter_.Use(1, now_seconds);
+  return true;
+}
+
+}  // namespace cricket
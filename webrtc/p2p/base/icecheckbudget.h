@@ -0,0 +1,54 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_ICECHECKBUDGET_H_
+#define WEBRTC_P2P_BASE_ICECHECKBUDGET_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/ratelimiter.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace cricket {
+
+// Caps the number of connectivity checks that a group of
+// P2PTransportChannels, by default all of them in the process, send per
+// second together. A channel that finds the budget used up doesn't send its
+// check and tries again on its next tick. The budget is unlimited until
+// SetMaxChecksPerSecond is called. Thread safe, since the channels may live on
+// different worker threads.
+class IceCheckBudget {
+ public:
+  IceCheckBudget();
+
+  // The budget shared by the channels that aren't given one of their own.
+  static IceCheckBudget* GetDefault();
+
+  // Sets how many checks may be sent per second, or removes the cap if
+  // |max_checks_per_second| is 0.
+  void SetMaxChecksPerSecond(size_t max_checks_per_second);
+  size_t max_checks_per_second() const;
+
+  // Takes one check out of the budget at time |now|, in milliseconds. Returns
+  // false, without taking anything, if the budget for the current second has
+  // been used up.
+  bool TryUse(uint32_t now);
+
+ private:
+  mutable rtc::CriticalSection crit_;
+  rtc::RateLimiter limiter_ GUARDED_BY(crit_);
+  uint32_t last_use_ms_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(IceCheckBudget);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_ICECHECKBUDGET_H_
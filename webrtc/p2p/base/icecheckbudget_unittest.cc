@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/icecheckbudget.h"
+#include "webrtc/base/gunit.h"
+
+using cricket::IceCheckBudget;
+
+TEST(IceCheckBudgetTest, UnlimitedByDefault) {
+  IceCheckBudget budget;
+  EXPECT_EQ(0u, budget.max_checks_per_second());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(budget.TryUse(1000));
+  }
+}
+
+TEST(IceCheckBudgetTest, CapsChecksPerSecond) {
+  IceCheckBudget budget;
+  budget.SetMaxChecksPerSecond(3);
+  EXPECT_EQ(3u, budget.max_checks_per_second());
+  EXPECT_TRUE(budget.TryUse(10000));
+  EXPECT_TRUE(budget.TryUse(10100));
+  EXPECT_TRUE(budget.TryUse(10500));
+  EXPECT_FALSE(budget.TryUse(10600));
+  EXPECT_FALSE(budget.TryUse(10900));
+  // The next second starts with a full budget again.
+  EXPECT_TRUE(budget.TryUse(11100));
+  EXPECT_TRUE(budget.TryUse(11200));
+  EXPECT_TRUE(budget.TryUse(11300));
+  EXPECT_FALSE(budget.TryUse(11400));
+}
+
+TEST(IceCheckBudgetTest, RemovingCapAllowsAllChecks) {
+  IceCheckBudget budget;
+  budget.SetMaxChecksPerSecond(1);
+  EXPECT_TRUE(budget.TryUse(10000));
+  EXPECT_FALSE(budget.TryUse(10001));
+  budget.SetMaxChecksPerSecond(0);
+  EXPECT_TRUE(budget.TryUse(10002));
+  EXPECT_TRUE(budget.TryUse(10003));
+}
+
+TEST(IceCheckBudgetTest, NewPeriodWhenTimeWrapsAround) {
+  IceCheckBudget budget;
+  budget.SetMaxChecksPerSecond(1);
+  EXPECT_TRUE(budget.TryUse(0xFFFFFF00));
+  EXPECT_FALSE(budget.TryUse(0xFFFFFF10));
+  EXPECT_TRUE(budget.TryUse(10));
+}
+
+TEST(IceCheckBudgetTest, DefaultIsShared) {
+  EXPECT_TRUE(IceCheckBudget::GetDefault() != nullptr);
+  EXPECT_EQ(IceCheckBudget::GetDefault(), IceCheckBudget::GetDefault());
+}
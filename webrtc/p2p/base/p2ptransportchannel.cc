@@ -113,38 +113,6 @@ int CompareConnections(cricket::Connection* a, cricket::Connection* b) {
   return CompareConnectionCandidates(a, b);
 }
 
-// Wraps the comparison connection into a less than operator that puts higher
-// priority writable connections first.
-class ConnectionCompare {
- public:
-  bool operator()(const cricket::Connection *ca,
-                  const cricket::Connection *cb) {
-    cricket::Connection* a = const_cast<cricket::Connection*>(ca);
-    cricket::Connection* b = const_cast<cricket::Connection*>(cb);
-
-    // Compare first on writability and static preferences.
-    int cmp = CompareConnections(a, b);
-    if (cmp > 0)
-      return true;
-    if (cmp < 0)
-      return false;
-
-    // Otherwise, sort based on latency estimate.
-    return a->rtt() < b->rtt();
-
-    // Should we bother checking for the last connection that last received
-    // data? It would help rendezvous on the connection that is also receiving
-    // packets.
-    //
-    // TODO: Yes we should definitely do this.  The TCP protocol gains
-    // efficiency by being used bidirectionally, as opposed to two separate
-    // unidirectional streams.  This test should probably occur before
-    // comparison of local prefs (assuming combined prefs are the same).  We
-    // need to be careful though, not to bounce back and forth with both sides
-    // trying to rendevous with the other.
-  }
-};
-
 // Determines whether we should switch between two connections, based first on
 // connection states, static preferences, and then (if those are equal) on
 // latency estimates.
@@ -202,6 +170,73 @@ static const uint32_t MAX_CURRENT_STRONG_DELAY = 900;
 
 static const int MIN_CHECK_RECEIVING_DELAY = 50;  // ms
 
+P2PTransportChannel::ConnectionSortKey::ConnectionSortKey()
+    : write_state(-1),
+      receiving(false),
+      connected(false),
+      priority(0),
+      generation(0),
+      rtt(0) {}
+
+P2PTransportChannel::ConnectionSortKey::ConnectionSortKey(Connection* conn)
+    : write_state(conn->write_state()),
+      receiving(conn->receiving()),
+      connected(conn->connected()),
+      priority(conn->priority()),
+      generation(conn->remote_candidate().generation() +
+                 conn->port()->generation()),
+      rtt(conn->rtt()) {}
+
+bool P2PTransportChannel::ConnectionSortKey::operator==(
+    const ConnectionSortKey& other) const {
+  return write_state == other.write_state && receiving == other.receiving &&
+         connected == other.connected && priority == other.priority &&
+         generation == other.generation && rtt == other.rtt;
+}
+
+// Puts higher priority writable connections first, in the same way as
+// CompareConnections does.
+bool P2PTransportChannel::ConnectionSortKey::operator<(
+    const ConnectionSortKey& other) const {
+  // Compare first on writability and static preferences.
+  if (write_state != other.write_state)
+    return write_state < other.write_state;
+  if (receiving != other.receiving)
+    return receiving;
+  if (write_state == Connection::STATE_WRITABLE && connected != other.connected)
+    return connected;
+  if (priority != other.priority)
+    return priority > other.priority;
+  int generation_cmp = generation - other.generation;
+  if (generation_cmp != 0)
+    return generation_cmp > 0;
+
+  // Otherwise, sort based on latency estimate.
+  return rtt < other.rtt;
+
+  // Should we bother checking for the last connection that last received
+  // data? It would help rendezvous on the connection that is also receiving
+  // packets.
+  //
+  // TODO: Yes we should definitely do this.  The TCP protocol gains
+  // efficiency by being used bidirectionally, as opposed to two separate
+  // unidirectional streams.  This test should probably occur before
+  // comparison of local prefs (assuming combined prefs are the same).  We
+  // need to be careful though, not to bounce back and forth with both sides
+  // trying to rendevous with the other.
+}
+
+bool P2PTransportChannel::PingQueueEntry::operator<(
+    const PingQueueEntry& other) const {
+  if (time != other.time)
+    return time < other.time;
+  if (key < other.key)
+    return true;
+  if (other.key < key)
+    return false;
+  return id < other.id;
+}
+
 P2PTransportChannel::P2PTransportChannel(const std::string& transport_name,
                                          int component,
                                          P2PTransport* transport,
@@ -212,6 +247,7 @@ P2PTransportChannel::P2PTransportChannel(const std::string& transport_name,
       worker_thread_(rtc::Thread::Current()),
       incoming_only_(false),
       error_(0),
+      ice_check_budget_(IceCheckBudget::GetDefault()),
       best_connection_(NULL),
       pending_best_connection_(NULL),
       sort_dirty_(false),
@@ -260,6 +296,9 @@ void P2PTransportChannel::AddAllocatorSession(PortAllocatorSession* session) {
 
 void P2PTransportChannel::AddConnection(Connection* connection) {
   connections_.push_back(connection);
+  // The default key doesn't match any connection, so the next sort moves the
+  // new connection to its place.
+  connection_sort_keys_.push_back(ConnectionSortKey());
   connection->set_remote_ice_mode(remote_ice_mode_);
   connection->set_receiving_timeout(receiving_timeout_);
   connection->SignalReadPacket.connect(
@@ -271,9 +310,49 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
   connection->SignalDestroyed.connect(
       this, &P2PTransportChannel::OnConnectionDestroyed);
   connection->SignalNominated.connect(this, &P2PTransportChannel::OnNominated);
+  connection->SignalPingReceived.connect(
+      this, &P2PTransportChannel::OnConnectionPingReceived);
+  PingState& ping_state = ping_states_[connection];
+  ping_state.id = next_ping_state_id_++;
+  ping_state.key = ConnectionSortKey(connection);
+  ping_state.ping_entry = ping_queue_.end();
+  ping_state.triggered_entry = triggered_checks_.end();
+  UpdatePingQueues(connection);
   had_connection_ = true;
 }
 
+void P2PTransportChannel::UpdatePingQueues(Connection* conn) {
+  PingState& state = ping_states_[conn];
+  if (state.ping_entry != ping_queue_.end()) {
+    ping_queue_.erase(state.ping_entry);
+  }
+  if (state.triggered_entry != triggered_checks_.end()) {
+    triggered_checks_.erase(state.triggered_entry);
+  }
+  state.ping_entry =
+      ping_queue_.insert(PingQueueEntry(conn->last_ping_sent(), state.key,
+                                        state.id, conn)).first;
+  state.triggered_entry = triggered_checks_.end();
+  if (conn->last_ping_received() > conn->last_ping_sent()) {
+    state.triggered_entry =
+        triggered_checks_.insert(PingQueueEntry(conn->last_ping_received(),
+                                                state.key, state.id, conn))
+            .first;
+  }
+}
+
+void P2PTransportChannel::RemoveFromPingQueues(Connection* conn) {
+  std::map<Connection*, PingState>::iterator it = ping_states_.find(conn);
+  if (it == ping_states_.end()) {
+    return;
+  }
+  ping_queue_.erase(it->second.ping_entry);
+  if (it->second.triggered_entry != triggered_checks_.end()) {
+    triggered_checks_.erase(it->second.triggered_entry);
+  }
+  ping_states_.erase(it);
+}
+
 void P2PTransportChannel::SetIceRole(IceRole ice_role) {
   ASSERT(worker_thread_ == rtc::Thread::Current());
   if (ice_role_ != ice_role) {
@@ -996,9 +1075,21 @@ void P2PTransportChannel::SortConnections() {
   // Find the best alternative connection by sorting.  It is important to note
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
-  // need to consider switching to.
-  ConnectionCompare cmp;
-  std::stable_sort(connections_.begin(), connections_.end(), cmp);
+  // need to consider switching to.  Only the connections whose state has
+  // changed since the last sort can be out of order.
+  std::vector<size_t> moved;
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    ConnectionSortKey key(connections_[i]);
+    if (key != connection_sort_keys_[i]) {
+      connection_sort_keys_[i] = key;
+      moved.push_back(i);
+      ping_states_[connections_[i]].key = key;
+      UpdatePingQueues(connections_[i]);
+    }
+  }
+  if (!moved.empty()) {
+    ReorderConnections(moved);
+  }
   LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                   << " available connections:";
   for (size_t i = 0; i < connections_.size(); ++i) {
@@ -1043,6 +1134,48 @@ void P2PTransportChannel::SortConnections() {
   UpdateState();
 }
 
+// Takes the connections at the indices |moved| out of |connections_|, sorts
+// them and merges them back into the others, which are still in order. Ties
+// are broken on the old index, so the result is the same as a stable sort of
+// all the connections.
+void P2PTransportChannel::ReorderConnections(const std::vector<size_t>& moved) {
+  const std::vector<ConnectionSortKey>& keys = connection_sort_keys_;
+  auto precedes = [&keys](size_t a, size_t b) {
+    if (keys[a] < keys[b])
+      return true;
+    if (keys[b] < keys[a])
+      return false;
+    return a < b;
+  };
+  std::vector<size_t> sorted_moved(moved);
+  std::sort(sorted_moved.begin(), sorted_moved.end(), precedes);
+
+  std::vector<Connection*> connections;
+  std::vector<ConnectionSortKey> sort_keys;
+  connections.reserve(connections_.size());
+  sort_keys.reserve(connections_.size());
+  std::vector<size_t>::const_iterator next_moved = moved.begin();
+  std::vector<size_t>::const_iterator next_sorted = sorted_moved.begin();
+  for (size_t i = 0; i <= connections_.size(); ++i) {
+    if (next_moved != moved.end() && *next_moved == i) {
+      ++next_moved;
+      continue;
+    }
+    while (next_sorted != sorted_moved.end() &&
+           (i == connections_.size() || precedes(*next_sorted, i))) {
+      connections.push_back(connections_[*next_sorted]);
+      sort_keys.push_back(keys[*next_sorted]);
+      ++next_sorted;
+    }
+    if (i < connections_.size()) {
+      connections.push_back(connections_[i]);
+      sort_keys.push_back(keys[i]);
+    }
+  }
+  connections_.swap(connections);
+  connection_sort_keys_.swap(sort_keys);
+}
+
 Connection* P2PTransportChannel::best_nominated_connection() const {
   return (best_connection_ && best_connection_->nominated()) ? best_connection_
                                                              : nullptr;
@@ -1200,7 +1333,8 @@ void P2PTransportChannel::OnCheckAndPing() {
   int ping_delay = weak() ? weak_ping_delay_ : STRONG_PING_DELAY;
   if (rtc::Time() >= last_ping_sent_ms_ + ping_delay) {
     Connection* conn = FindNextPingableConnection();
-    if (conn) {
+    // If the budget is used up, the check is sent on one of the next ticks.
+    if (conn && ice_check_budget_->TryUse(rtc::Time())) {
       PingConnection(conn);
     }
   }
@@ -1266,32 +1400,24 @@ Connection* P2PTransportChannel::FindNextPingableConnection() {
   // that have received a ping but have not sent a ping since receiving
   // it (last_received_ping > last_sent_ping).  But we shouldn't do
   // triggered checks if the connection is already writable.
-  Connection* oldest_needing_triggered_check = nullptr;
-  Connection* oldest = nullptr;
-  for (Connection* conn : connections_) {
-    if (!IsPingable(conn, now)) {
-      continue;
-    }
-    bool needs_triggered_check =
-        (!conn->writable() &&
-         conn->last_ping_received() > conn->last_ping_sent());
-    if (needs_triggered_check &&
-        (!oldest_needing_triggered_check ||
-         (conn->last_ping_received() <
-          oldest_needing_triggered_check->last_ping_received()))) {
-      oldest_needing_triggered_check = conn;
-    }
-    if (!oldest || (conn->last_ping_sent() < oldest->last_ping_sent())) {
-      oldest = conn;
+  for (const PingQueueEntry& entry : triggered_checks_) {
+    Connection* conn = entry.connection;
+    if (!conn->writable() &&
+        conn->last_ping_received() > conn->last_ping_sent() &&
+        IsPingable(conn, now)) {
+      LOG(LS_INFO) << "Selecting connection for triggered check: " <<
+          conn->ToString();
+      return conn;
     }
   }
 
-  if (oldest_needing_triggered_check) {
-    LOG(LS_INFO) << "Selecting connection for triggered check: " <<
-        oldest_needing_triggered_check->ToString();
-    return oldest_needing_triggered_check;
+  // Otherwise, the one that was pinged longest ago.
+  for (const PingQueueEntry& entry : ping_queue_) {
+    if (IsPingable(entry.connection, now)) {
+      return entry.connection;
+    }
   }
-  return oldest;
+  return nullptr;
 }
 
 // Apart from sending ping from |conn| this method also updates
@@ -1318,6 +1444,7 @@ void P2PTransportChannel::PingConnection(Connection* conn) {
   conn->set_use_candidate_attr(use_candidate);
   last_ping_sent_ms_ = rtc::Time();
   conn->Ping(last_ping_sent_ms_);
+  UpdatePingQueues(conn);
 }
 
 // When a connection's state changes, we need to figure out who to use as
@@ -1361,7 +1488,10 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
   std::vector<Connection*>::iterator iter =
       std::find(connections_.begin(), connections_.end(), connection);
   ASSERT(iter != connections_.end());
+  connection_sort_keys_.erase(connection_sort_keys_.begin() +
+                              (iter - connections_.begin()));
   connections_.erase(iter);
+  RemoveFromPingQueues(connection);
 
   LOG_J(LS_INFO, this) << "Removed connection ("
     << static_cast<int>(connections_.size()) << " remaining)";
@@ -1387,6 +1517,12 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
   SignalConnectionRemoved(this);
 }
 
+// A connection that has received a ping may need a triggered check.
+void P2PTransportChannel::OnConnectionPingReceived(Connection* connection) {
+  ASSERT(worker_thread_ == rtc::Thread::Current());
+  UpdatePingQueues(connection);
+}
+
 // When a port is destroyed remove it from our list of ports to use for
 // connection attempts.
 void P2PTransportChannel::OnPortDestroyed(PortInterface* port) {
@@ -21,9 +21,11 @@
 #define WEBRTC_P2P_BASE_P2PTRANSPORTCHANNEL_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "webrtc/p2p/base/candidate.h"
+#include "webrtc/p2p/base/icecheckbudget.h"
 #include "webrtc/p2p/base/p2ptransport.h"
 #include "webrtc/p2p/base/portallocator.h"
 #include "webrtc/p2p/base/portinterface.h"
@@ -164,6 +166,12 @@ class P2PTransportChannel : public TransportChannelImpl,
   int receiving_timeout() const { return receiving_timeout_; }
   int check_receiving_delay() const { return check_receiving_delay_; }
 
+  // Sets the budget that the checks of this channel are taken from. The
+  // default budget is shared by all the channels in the process.
+  void set_ice_check_budget(IceCheckBudget* budget) {
+    ice_check_budget_ = budget;
+  }
+
   // Helper method used only in unittest.
   rtc::DiffServCodePoint DefaultDscpValue() const;
 
@@ -184,6 +192,55 @@ class P2PTransportChannel : public TransportChannelImpl,
   }
 
  private:
+  // A snapshot of the state that decides the place of a connection in
+  // |connections_|. One is kept for every connection, so that SortConnections
+  // only has to move the connections whose state has changed.
+  struct ConnectionSortKey {
+    ConnectionSortKey();
+    explicit ConnectionSortKey(Connection* conn);
+
+    bool operator==(const ConnectionSortKey& other) const;
+    bool operator!=(const ConnectionSortKey& other) const {
+      return !(*this == other);
+    }
+    // True if a connection with this key is sorted before one with |other|.
+    bool operator<(const ConnectionSortKey& other) const;
+
+    int write_state;
+    bool receiving;
+    bool connected;
+    uint64_t priority;
+    uint32_t generation;
+    uint32_t rtt;
+  };
+
+  // An entry of |ping_queue_| or |triggered_checks_|. They are ordered on
+  // |time| first, and then on the order of |connections_| as of the last sort,
+  // which is what FindNextPingableConnection breaks ties on.
+  struct PingQueueEntry {
+    PingQueueEntry(uint32_t time,
+                   const ConnectionSortKey& key,
+                   uint32_t id,
+                   Connection* connection)
+        : time(time), key(key), id(id), connection(connection) {}
+
+    bool operator<(const PingQueueEntry& other) const;
+
+    uint32_t time;
+    ConnectionSortKey key;
+    uint32_t id;  // Breaks ties between equal keys.
+    Connection* connection;
+  };
+  typedef std::set<PingQueueEntry> PingQueue;
+
+  struct PingState {
+    uint32_t id;
+    ConnectionSortKey key;  // As of the last sort.
+    PingQueue::iterator ping_entry;
+    // Equal to triggered_checks_.end() when no triggered check is pending.
+    PingQueue::iterator triggered_entry;
+  };
+
   rtc::Thread* thread() { return worker_thread_; }
   bool IsGettingPorts() { return allocator_session()->IsGettingPorts(); }
 
@@ -215,6 +272,11 @@ class P2PTransportChannel : public TransportChannelImpl,
   void PingConnection(Connection* conn);
   void AddAllocatorSession(PortAllocatorSession* session);
   void AddConnection(Connection* connection);
+  // Moves |conn| to the place in the ping queues that its last pings and sort
+  // key give it.
+  void UpdatePingQueues(Connection* conn);
+  void ReorderConnections(const std::vector<size_t>& moved);
+  void RemoveFromPingQueues(Connection* conn);
 
   void OnPortReady(PortAllocatorSession *session, PortInterface* port);
   void OnCandidatesReady(PortAllocatorSession *session,
@@ -235,6 +297,7 @@ class P2PTransportChannel : public TransportChannelImpl,
   void OnSentPacket(const rtc::SentPacket& sent_packet);
   void OnReadyToSend(Connection* connection);
   void OnConnectionDestroyed(Connection *connection);
+  void OnConnectionPingReceived(Connection* connection);
 
   void OnNominated(Connection* conn);
 
@@ -272,6 +335,16 @@ class P2PTransportChannel : public TransportChannelImpl,
   std::vector<PortAllocatorSession*> allocator_sessions_;
   std::vector<PortInterface *> ports_;
   std::vector<Connection *> connections_;
+  // The key of each of |connections_| as of the last sort, in the same order.
+  std::vector<ConnectionSortKey> connection_sort_keys_;
+  // Connections ordered on when they were last pinged.
+  PingQueue ping_queue_;
+  // Connections that have received a ping since they were last pinged,
+  // ordered on when that ping was received.
+  PingQueue triggered_checks_;
+  std::map<Connection*, PingState> ping_states_;
+  uint32_t next_ping_state_id_ = 0;
+  IceCheckBudget* ice_check_budget_;
   Connection* best_connection_;
   // Connection selected by the controlling agent. This should be used only
   // at controlled side when protocol type is RFC5245.
@@ -26,6 +26,7 @@
 #include "webrtc/base/proxyserver.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/ssladapter.h"
+#include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/virtualsocketserver.h"
 
@@ -2356,3 +2357,68 @@ TEST_F(P2PTransportChannelPingTest, TestStopPortAllocatorSessions) {
   conn2->ReceivedPingResponse();  // Becomes writable and receiving
   EXPECT_TRUE(!ch.allocator_session()->IsGettingPorts());
 }
+
+// Test that the connections stay sorted as the states of some of them change
+// between sorts. The channel is controlled so that nothing is pruned.
+TEST_F(P2PTransportChannelPingTest, TestConnectionsStaySorted) {
+  cricket::FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  cricket::P2PTransportChannel ch("test channel", 1, nullptr, &pa);
+  PrepareChannel(&ch);
+  ch.SetIceRole(cricket::ICEROLE_CONTROLLED);
+  ch.Connect();
+  ch.MaybeStartGathering();
+  const int kPriorities[] = {5, 9, 1, 7, 3, 10, 2, 8, 4, 6};
+  std::vector<cricket::Connection*> conns;
+  for (int priority : kPriorities) {
+    std::string ip = "1.1.1." + rtc::ToString(priority);
+    ch.AddRemoteCandidate(CreateCandidate(ip, priority, priority));
+    conns.push_back(WaitForConnectionTo(&ch, ip, priority));
+    ASSERT_TRUE(conns.back() != nullptr);
+  }
+  ASSERT_EQ(conns.size(), ch.connections().size());
+  for (size_t i = 1; i < ch.connections().size(); ++i) {
+    EXPECT_GT(ch.connections()[i - 1]->priority(),
+              ch.connections()[i]->priority());
+  }
+
+  // The writable connections move to the front, in priority order, and the
+  // others close the gaps they leave.
+  cricket::Connection* low = conns[4];   // Priority 3.
+  cricket::Connection* high = conns[3];  // Priority 7.
+  low->ReceivedPingResponse();
+  high->ReceivedPingResponse();
+  EXPECT_TRUE_WAIT(ch.connections()[0] == high && ch.connections()[1] == low,
+                   1000);
+  for (size_t i = 3; i < ch.connections().size(); ++i) {
+    EXPECT_GT(ch.connections()[i - 1]->priority(),
+              ch.connections()[i]->priority());
+  }
+}
+
+// Test that the checks of a channel are taken from its IceCheckBudget, and
+// that they stop when the budget is used up.
+TEST_F(P2PTransportChannelPingTest, TestIceCheckBudget) {
+  cricket::FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  cricket::P2PTransportChannel ch("test channel", 1, nullptr, &pa);
+  cricket::IceCheckBudget budget;
+  budget.SetMaxChecksPerSecond(1);
+  ch.set_ice_check_budget(&budget);
+  PrepareChannel(&ch);
+  ch.Connect();
+  ch.MaybeStartGathering();
+  ch.AddRemoteCandidate(CreateCandidate("1.1.1.1", 1, 1));
+  ch.AddRemoteCandidate(CreateCandidate("2.2.2.2", 2, 2));
+  cricket::Connection* conn1 = WaitForConnectionTo(&ch, "1.1.1.1", 1);
+  cricket::Connection* conn2 = WaitForConnectionTo(&ch, "2.2.2.2", 2);
+  ASSERT_TRUE(conn1 != nullptr);
+  ASSERT_TRUE(conn2 != nullptr);
+
+  // The channel is weak, so without the budget both connections would be
+  // pinged within a few WEAK_PING_DELAYs.
+  EXPECT_TRUE_WAIT(conn2->last_ping_sent() != 0, 1000);
+  rtc::Thread::Current()->ProcessMessages(300);
+  EXPECT_EQ(0u, conn1->last_ping_sent());
+
+  budget.SetMaxChecksPerSecond(0);
+  EXPECT_TRUE_WAIT(conn1->last_ping_sent() != 0, 1000);
+}
@@ -373,7 +373,8 @@ bool Port::GetStunMessage(const char* data, size_t size,
     }
 
     // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
-    if (!stun_msg->ValidateMessageIntegrity(data, size, password_)) {
+    if (!stun_msg->ValidateMessageIntegrity(data, size,
+                                            integrity_key_.Get(password_))) {
       LOG_J(LS_ERROR, this) << "Received STUN request with bad M-I "
                             << "from " << addr.ToSensitiveString()
                             << ", password_=" << password_;
@@ -560,7 +561,7 @@ void Port::SendBindingResponse(StunMessage* request,
 
   response.AddAttribute(
       new StunXorAddressAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS, addr));
-  response.AddMessageIntegrity(password_);
+  response.AddMessageIntegrity(integrity_key_.Get(password_));
   response.AddFingerprint();
 
   // Send the response message.
@@ -608,7 +609,7 @@ void Port::SendBindingErrorResponse(StunMessage* request,
   // because we don't have enough information to determine the shared secret.
   if (error_code != STUN_ERROR_BAD_REQUEST &&
       error_code != STUN_ERROR_UNAUTHORIZED)
-    response.AddMessageIntegrity(password_);
+    response.AddMessageIntegrity(integrity_key_.Get(password_));
   response.AddFingerprint();
 
   // Send the response message.
@@ -725,7 +726,7 @@ class ConnectionRequest : public StunRequest {
         new StunUInt32Attribute(STUN_ATTR_PRIORITY, prflx_priority));
 
     // Adding Message Integrity attribute.
-    request->AddMessageIntegrity(connection_->remote_candidate().password());
+    request->AddMessageIntegrity(connection_->remote_integrity_hmac());
     // Adding Fingerprint.
     request->AddFingerprint();
   }
@@ -932,8 +933,8 @@ void Connection::OnReadPacket(
       // id's match.
       case STUN_BINDING_RESPONSE:
       case STUN_BINDING_ERROR_RESPONSE:
-        if (msg->ValidateMessageIntegrity(
-                data, size, remote_candidate().password())) {
+        if (msg->ValidateMessageIntegrity(data, size,
+                                          remote_integrity_hmac())) {
           requests_.CheckResponse(msg.get());
         }
         // Otherwise silently discard the response message.
@@ -1104,6 +1105,7 @@ void Connection::Ping(uint32_t now) {
 void Connection::ReceivedPing() {
   set_receiving(true);
   last_ping_received_ = rtc::Time();
+  SignalPingReceived(this);
 }
 
 void Connection::ReceivedPingResponse() {
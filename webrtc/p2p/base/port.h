@@ -378,6 +378,8 @@ class Port : public PortInterface, public rtc::MessageHandler,
   // username_fragment().
   std::string ice_username_fragment_;
   std::string password_;
+  // Signs our responses and checks incoming requests with |password_|.
+  StunMessageIntegrityKey integrity_key_;
   std::vector<Candidate> candidates_;
   AddressMap connections_;
   int timeout_delay_;
@@ -481,8 +483,8 @@ class Connection : public rtc::MessageHandler,
   // Error if Send() returns < 0
   virtual int GetError() = 0;
 
-  sigslot::signal4<Connection*, const char*, size_t, const rtc::PacketTime&>
-      SignalReadPacket;
+  sigslot::fast_signal4<Connection*, const char*, size_t,
+                        const rtc::PacketTime&> SignalReadPacket;
 
   sigslot::signal1<Connection*> SignalReadyToSend;
 
@@ -536,6 +538,9 @@ class Connection : public rtc::MessageHandler,
   // public because the connection intercepts the first ping for us.
   uint32_t last_ping_received() const { return last_ping_received_; }
   void ReceivedPing();
+  // Sent from ReceivedPing, so that the channel can schedule a triggered
+  // check.
+  sigslot::signal1<Connection*> SignalPingReceived;
   // Handles the binding request; sends a response if this is a valid request.
   void HandleBindingRequest(IceMessage* msg);
 
@@ -630,6 +635,11 @@ class Connection : public rtc::MessageHandler,
   uint32_t sent_packets_total_;
 
  private:
+  // Signs our requests and checks the responses with the remote password.
+  rtc::HmacDigest* remote_integrity_hmac() {
+    return remote_integrity_key_.Get(remote_candidate_.password());
+  }
+
   void MaybeAddPrflxCandidate(ConnectionRequest* request,
                               StunMessage* response);
 
@@ -638,6 +648,7 @@ class Connection : public rtc::MessageHandler,
   // Time duration to switch from receiving to not receiving.
   uint32_t receiving_timeout_;
   uint32_t time_created_ms_;
+  StunMessageIntegrityKey remote_integrity_key_;
 
   friend class Port;
   friend class ConnectionRequest;
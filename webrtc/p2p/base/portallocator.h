@@ -58,6 +58,11 @@ enum {
   // Disallow use of UDP when connecting to a relay server. Since proxy servers
   // usually don't handle UDP, using UDP will leak the IP address.
   PORTALLOCATOR_DISABLE_UDP_RELAY = 0x1000,
+  // When specified, the UDP ports of all sessions of an allocator share one
+  // socket per local IP, which demultiplexes packets by ICE ufrag and remote
+  // address. Implies PORTALLOCATOR_ENABLE_SHARED_SOCKET, except for TURN
+  // ports, which keep a socket of their own.
+  PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX = 0x2000,
 };
 
 const uint32_t kDefaultPortAllocatorFlags = 0;
@@ -67,6 +72,13 @@ const uint32_t kDefaultStepDelay = 1000;  // 1 sec step delay.
 // internal. Less than 20ms is not acceptable. We choose 50ms as our default.
 const uint32_t kMinimumStepDelay = 50;
 
+// Port allocation for a network goes through phases (UDP and STUN, relay, TCP
+// and SSLTCP), which by default are started one per step. They can instead be
+// started a few, or with kAllPhasesPerStep all, at once, so that e.g. TURN
+// allocations don't wait for the step delay.
+const int kDefaultPhasesPerStep = 1;
+const int kAllPhasesPerStep = 4;
+
 // CF = CANDIDATE FILTER
 enum {
   CF_NONE = 0x0,
@@ -168,6 +180,7 @@ class PortAllocator : public sigslot::has_slots<> {
       min_port_(0),
       max_port_(0),
       step_delay_(kDefaultStepDelay),
+      phases_per_step_(kDefaultPhasesPerStep),
       allow_tcp_listen_(true),
       candidate_filter_(CF_ALL) {
     // This will allow us to have old behavior on non webrtc clients.
@@ -219,6 +232,10 @@ class PortAllocator : public sigslot::has_slots<> {
   uint32_t step_delay() const { return step_delay_; }
   void set_step_delay(uint32_t delay) { step_delay_ = delay; }
 
+  // Gets/Sets how many allocation phases are started in each step.
+  int phases_per_step() const { return phases_per_step_; }
+  void set_phases_per_step(int phases) { phases_per_step_ = phases; }
+
   bool allow_tcp_listen() const { return allow_tcp_listen_; }
   void set_allow_tcp_listen(bool allow_tcp_listen) {
     allow_tcp_listen_ = allow_tcp_listen;
@@ -248,6 +265,7 @@ class PortAllocator : public sigslot::has_slots<> {
   int min_port_;
   int max_port_;
   uint32_t step_delay_;
+  int phases_per_step_;
   bool allow_tcp_listen_;
   uint32_t candidate_filter_;
   std::string origin_;
@@ -112,8 +112,8 @@ class PortInterface {
   // through their respective connection and instead delivers every packet
   // through this port.
   virtual void EnablePortPackets() = 0;
-  sigslot::signal4<PortInterface*, const char*, size_t,
-                   const rtc::SocketAddress&> SignalReadPacket;
+  sigslot::fast_signal4<PortInterface*, const char*, size_t,
+                        const rtc::SocketAddress&> SignalReadPacket;
 
   // Emitted each time a packet is sent on this port.
   sigslot::signal1<const rtc::SentPacket&> SignalSentPacket;
@@ -75,6 +75,11 @@ const uint32_t JINGLE_HEADER_SIZE = 64;  // when relay framing is in use
 const uint32_t DEFAULT_RCV_BUF_SIZE = 60 * 1024;
 const uint32_t DEFAULT_SND_BUF_SIZE = 90 * 1024;
 
+// Largest sizes the receive and send buffers grow to when they have not been
+// set with SetOption().
+const uint32_t MAX_AUTO_RCV_BUF_SIZE = 2 * 1024 * 1024;
+const uint32_t MAX_AUTO_SND_BUF_SIZE = 2 * 1024 * 1024;
+
 //////////////////////////////////////////////////////////////////////
 // Global Constants and Functions
 //////////////////////////////////////////////////////////////////////
@@ -115,6 +120,12 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+// Set on ACKs whose payload is a list of selective acknowledgment blocks. Each
+// block is the sequence number of the first byte of a range of data held by
+// the receiver beyond the acknowledgment number, and of the byte following
+// it. Only sent to peers that sent TCP_OPT_SACK_PERMITTED.
+const uint8_t FLAG_SACK = 0x08;
+const uint32_t MAX_SACK_BLOCKS = 4;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -123,6 +134,7 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgments.
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -159,6 +171,17 @@ uint32_t bound(uint32_t lower, uint32_t middle, uint32_t upper) {
   return std::min(std::max(lower, middle), upper);
 }
 
+// Returns the smallest window scale factor with which a window of |size|
+// bytes fits in a 16-bit unsigned integer.
+uint8_t window_scale_factor(uint32_t size) {
+  uint8_t scale_factor = 0;
+  while (size > 0xFFFF) {
+    ++scale_factor;
+    size >>= 1;
+  }
+  return scale_factor;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Debugging Statistics
 //////////////////////////////////////////////////////////////////////
@@ -216,7 +239,8 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
       m_rbuf_len(DEFAULT_RCV_BUF_SIZE),
       m_rbuf(m_rbuf_len),
       m_sbuf_len(DEFAULT_SND_BUF_SIZE),
-      m_sbuf(m_sbuf_len) {
+      m_sbuf(m_sbuf_len),
+      m_packet(new uint8_t[MAX_PACKET]) {
   // Sanity check on buffer sizes (needed for OnTcpWriteable notification logic)
   ASSERT(m_rbuf_len + MIN_PACKET < m_sbuf_len);
 
@@ -225,7 +249,14 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_state = TCP_LISTEN;
   m_conv = conv;
   m_rcv_wnd = m_rbuf_len;
-  m_rwnd_scale = m_swnd_scale = 0;
+  // The window scale factor can't change once connected, so announce the one
+  // the receive buffer may grow to.
+  m_rwnd_scale = window_scale_factor(MAX_AUTO_RCV_BUF_SIZE);
+  m_swnd_scale = 0;
+  m_rbuf_autotune = m_sbuf_autotune = true;
+  m_rcv_rtt = m_rcv_rtt_seq = m_rcv_rtt_time = 0;
+  m_rcv_copied = 0;
+  m_rcv_copied_time = now;
   m_snd_nxt = 0;
   m_snd_wnd = 1;
   m_snd_una = m_rcv_nxt = 0;
@@ -248,6 +279,8 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
 
   m_dup_acks = 0;
   m_recover = 0;
+  m_sack_enabled = false;
+  m_sack_high = m_sack_rexmit = 0;
 
   m_ts_recent = m_ts_lastack = 0;
 
@@ -257,6 +290,7 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
   m_support_wnd_scale = true;
+  m_support_sack = true;
 }
 
 PseudoTcp::~PseudoTcp() {
@@ -386,9 +420,11 @@ void PseudoTcp::SetOption(Option opt, int value) {
     m_ack_delay = value;
   } else if (opt == OPT_SNDBUF) {
     ASSERT(m_state == TCP_LISTEN);
+    m_sbuf_autotune = false;
     resizeSendBuffer(value);
   } else if (opt == OPT_RCVBUF) {
     ASSERT(m_state == TCP_LISTEN);
+    m_rbuf_autotune = false;
     resizeReceiveBuffer(value);
   } else {
     ASSERT(false);
@@ -434,13 +470,17 @@ int PseudoTcp::Recv(char* buffer, size_t len) {
   }
   ASSERT(result == rtc::SR_SUCCESS);
 
+  m_rcv_copied += static_cast<uint32_t>(read);
+  autoTuneReceiveBuffer(Now());
+
   size_t available_space = 0;
   m_rbuf.GetWriteRemaining(&available_space);
 
   if (uint32_t(available_space) - m_rcv_wnd >=
       std::min<uint32_t>(m_rbuf_len / 2, m_mss)) {
     // TODO(jbeda): !?! Not sure about this was closed business
-    bool bWasClosed = (m_rcv_wnd == 0);
+    // The window is closed to the sender once it scales down to zero.
+    bool bWasClosed = ((m_rcv_wnd >> m_rwnd_scale) == 0);
     m_rcv_wnd = static_cast<uint32_t>(available_space);
 
     if (bWasClosed) {
@@ -518,28 +558,34 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 
   uint32_t now = Now();
 
-  rtc::scoped_ptr<uint8_t[]> buffer(new uint8_t[MAX_PACKET]);
-  long_to_bytes(m_conv, buffer.get());
-  long_to_bytes(seq, buffer.get() + 4);
-  long_to_bytes(m_rcv_nxt, buffer.get() + 8);
+  uint8_t* buffer = m_packet.get();
+  long_to_bytes(m_conv, buffer);
+  long_to_bytes(seq, buffer + 4);
+  long_to_bytes(m_rcv_nxt, buffer + 8);
   buffer[12] = 0;
-  buffer[13] = flags;
   short_to_bytes(static_cast<uint16_t>(m_rcv_wnd >> m_rwnd_scale),
-                 buffer.get() + 14);
+                 buffer + 14);
 
   // Timestamp computations
-  long_to_bytes(now, buffer.get() + 16);
-  long_to_bytes(m_ts_recent, buffer.get() + 20);
+  long_to_bytes(now, buffer + 16);
+  long_to_bytes(m_ts_recent, buffer + 20);
   m_ts_lastack = m_rcv_nxt;
 
+  uint32_t sack_len = 0;
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result = m_sbuf.ReadOffset(
-        buffer.get() + HEADER_SIZE, len, offset, &bytes_read);
+        buffer + HEADER_SIZE, len, offset, &bytes_read);
     RTC_UNUSED(result);
     ASSERT(result == rtc::SR_SUCCESS);
     ASSERT(static_cast<uint32_t>(bytes_read) == len);
+  } else if (m_sack_enabled && !m_rlist.empty()) {
+    // Tell the sender which data after the missing segment has arrived.
+    sack_len = writeSackBlocks(buffer + HEADER_SIZE);
+    if (sack_len)
+      flags |= FLAG_SACK;
   }
+  buffer[13] = flags;
 
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "<-- <CONV=" << m_conv
@@ -553,7 +599,7 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char *>(buffer), len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -587,6 +633,15 @@ bool PseudoTcp::parse(const uint8_t* buffer, uint32_t size) {
   seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE;
   seg.len = size - HEADER_SIZE;
 
+  // The payload of a SACK is its blocks; the segment carries no data.
+  seg.sack = NULL;
+  seg.sack_len = 0;
+  if (seg.flags & FLAG_SACK) {
+    seg.sack = seg.data;
+    seg.sack_len = seg.len;
+    seg.len = 0;
+  }
+
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "--> <CONV=" << seg.conv
                << "><FLG=" << static_cast<unsigned>(seg.flags)
@@ -706,6 +761,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (seg.sack_len && m_sack_enabled) {
+    applySackBlocks(seg.sack, seg.sack_len);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -771,9 +830,21 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
-          closedown(ECONNABORTED);
-          return false;
+        // With selective acknowledgments, retransmit the next segment known
+        // to be missing, and the first one only if it hasn't been
+        // retransmitted in this recovery yet.
+        SList::iterator it = m_slist.begin();
+        if (m_sack_enabled) {
+          it = nextSackHole();
+          if ((it == m_slist.end()) && (m_slist.front().seq >= m_sack_rexmit))
+            it = m_slist.begin();
+        }
+        if (it != m_slist.end()) {
+          if (!transmit(it, now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_sack_rexmit = it->seq + it->len;
         }
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
@@ -804,12 +875,27 @@ bool PseudoTcp::process(Segment& seg) {
           closedown(ECONNABORTED);
           return false;
         }
+        m_sack_rexmit = m_slist.front().seq + m_slist.front().len;
         m_recover = m_snd_nxt;
         uint32_t nInFlight = m_snd_nxt - m_snd_una;
         m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
         //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
+        // Retransmit the next segment known to be missing, rather than
+        // waiting for a partial ack to reveal it.
+        SList::iterator it =
+            m_sack_enabled ? nextSackHole() : m_slist.end();
+        if (it != m_slist.end()) {
+#if _DEBUGMSG >= _DBG_NORMAL
+          LOG(LS_INFO) << "sack retransmit";
+#endif // _DEBUGMSG
+          if (!transmit(it, now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_sack_rexmit = it->seq + it->len;
+        }
         m_cwnd += m_mss;
       }
     } else {
@@ -828,6 +914,15 @@ bool PseudoTcp::process(Segment& seg) {
     //notify(evOpen);
   }
 
+  // If the application is blocked on a send buffer no larger than what the
+  // windows would let us have in flight, the send buffer is what limits the
+  // throughput. Grow it.
+  if (m_sbuf_autotune && m_bWriteEnable &&
+      (m_sbuf_len < MAX_AUTO_SND_BUF_SIZE) &&
+      (std::min(m_snd_wnd, m_cwnd) + m_mss > m_sbuf_len)) {
+    resizeSendBuffer(std::min(MAX_AUTO_SND_BUF_SIZE, 2 * m_sbuf_len));
+  }
+
   // If we make room in the send queue, notify the user
   // The goal it to make sure we always have at least enough data to fill the
   // window.  We'd like to notify the app when we are halfway to that point.
@@ -931,6 +1026,21 @@ bool PseudoTcp::process(Segment& seg) {
           }
           it = m_rlist.erase(it);
         }
+
+        // Measure the time it takes to receive a window of data. It is the
+        // round trip time when the sender is limited by our window, and
+        // longer otherwise.
+        if (m_rcv_rtt_time == 0 || m_rcv_nxt >= m_rcv_rtt_seq) {
+          if (m_rcv_rtt_time != 0) {
+            int32_t rtt = rtc::TimeDiff(now, m_rcv_rtt_time);
+            if (rtt > 0 && (m_rcv_rtt == 0 || static_cast<uint32_t>(rtt) <
+                                                  m_rcv_rtt)) {
+              m_rcv_rtt = rtt;
+            }
+          }
+          m_rcv_rtt_seq = m_rcv_nxt + m_rcv_wnd;
+          m_rcv_rtt_time = now;
+        }
       } else {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "Saving " << seg.len << " bytes (" << seg.seq << " -> " << seg.seq + seg.len << ")";
@@ -1164,6 +1274,14 @@ PseudoTcp::isReceiveBufferFull() const {
 void
 PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
+  if (m_rbuf_autotune) {
+    m_rwnd_scale = 0;
+  }
+}
+
+void
+PseudoTcp::disableSack() {
+  m_support_sack = false;
 }
 
 void
@@ -1176,6 +1294,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1239,6 +1361,13 @@ void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
       return;
     }
     applyWindowScaleOption(data[0]);
+  } else if (kind == TCP_OPT_SACK_PERMITTED) {
+    // http://www.ietf.org/rfc/rfc2018.txt
+    if (len != 0) {
+      LOG_F(WARNING) << "Invalid SACK permitted option received.";
+      return;
+    }
+    m_sack_enabled = m_support_sack;
   }
 }
 
@@ -1252,17 +1381,12 @@ void PseudoTcp::resizeSendBuffer(uint32_t new_size) {
 }
 
 void PseudoTcp::resizeReceiveBuffer(uint32_t new_size) {
-  uint8_t scale_factor = 0;
-
   // Determine the scale factor such that the scaled window size can fit
   // in a 16-bit unsigned integer.
-  while (new_size > 0xFFFF) {
-    ++scale_factor;
-    new_size >>= 1;
-  }
+  uint8_t scale_factor = window_scale_factor(new_size);
 
   // Determine the proper size of the buffer.
-  new_size <<= scale_factor;
+  new_size = (new_size >> scale_factor) << scale_factor;
   bool result = m_rbuf.SetCapacity(new_size);
 
   // Make sure the new buffer is large enough to contain data in the old
@@ -1280,4 +1404,84 @@ void PseudoTcp::resizeReceiveBuffer(uint32_t new_size) {
   m_rcv_wnd = static_cast<uint32_t>(available_space);
 }
 
+void PseudoTcp::growReceiveBuffer(uint32_t new_size) {
+  // Out of order data beyond the buffered data would not be kept.
+  ASSERT(m_rlist.empty());
+  bool result = m_rbuf.SetCapacity(new_size);
+  ASSERT(result);
+  RTC_UNUSED(result);
+  m_rbuf_len = new_size;
+}
+
+void PseudoTcp::autoTuneReceiveBuffer(uint32_t now) {
+  if (!m_rbuf_autotune || m_rcv_rtt == 0)
+    return;
+  int32_t elapsed = rtc::TimeDiff(now, m_rcv_copied_time);
+  if (elapsed < static_cast<int32_t>(m_rcv_rtt))
+    return;
+
+  uint32_t copied_per_rtt =
+      static_cast<uint32_t>(static_cast<uint64_t>(m_rcv_copied) * m_rcv_rtt /
+                            elapsed);
+  m_rcv_copied = 0;
+  m_rcv_copied_time = now;
+
+  // Keep the buffer twice as large as what the application reads per round
+  // trip, so that the sender isn't limited by our window while the
+  // application keeps up. The buffer can't be resized while it holds out of
+  // order data.
+  const uint32_t limit =
+      std::min(MAX_AUTO_RCV_BUF_SIZE, 0xFFFFu << m_rwnd_scale);
+  if (copied_per_rtt > m_rbuf_len / 2 && m_rbuf_len < limit &&
+      m_rlist.empty()) {
+    growReceiveBuffer(
+        std::min(limit, static_cast<uint32_t>(2 * copied_per_rtt)));
+  }
+}
+
+uint32_t PseudoTcp::writeSackBlocks(uint8_t* buffer) {
+  uint32_t blocks = 0;
+  RList::const_iterator it = m_rlist.begin();
+  while ((it != m_rlist.end()) && (blocks < MAX_SACK_BLOCKS)) {
+    // |m_rlist| is sorted by sequence number; merge the segments that
+    // overlap or are adjacent into one block.
+    uint32_t left = it->seq;
+    uint32_t right = it->seq + it->len;
+    for (++it; (it != m_rlist.end()) && (it->seq <= right); ++it) {
+      right = std::max(right, it->seq + it->len);
+    }
+    long_to_bytes(left, buffer + 8 * blocks);
+    long_to_bytes(right, buffer + 8 * blocks + 4);
+    ++blocks;
+  }
+  return 8 * blocks;
+}
+
+void PseudoTcp::applySackBlocks(const char* data, uint32_t len) {
+  for (uint32_t i = 0; i + 8 <= len; i += 8) {
+    uint32_t left = bytes_to_long(data + i);
+    uint32_t right = bytes_to_long(data + i + 4);
+    if ((left >= right) || (right <= m_snd_una) || (right > m_snd_nxt)) {
+      continue;
+    }
+    for (SList::iterator it = m_slist.begin();
+         (it != m_slist.end()) && (it->seq < right); ++it) {
+      if ((it->seq >= left) && (it->seq + it->len <= right)) {
+        it->bSacked = true;
+      }
+    }
+    m_sack_high = std::max(m_sack_high, right);
+  }
+}
+
+PseudoTcp::SList::iterator PseudoTcp::nextSackHole() {
+  for (SList::iterator it = m_slist.begin();
+       (it != m_slist.end()) && (it->seq < m_sack_high); ++it) {
+    if ((it->seq >= m_sack_rexmit) && !it->bSacked) {
+      return it;
+    }
+  }
+  return m_slist.end();
+}
+
 }  // namespace cricket
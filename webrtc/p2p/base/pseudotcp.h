@@ -14,6 +14,7 @@
 #include <list>
 
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/stream.h"
 
 namespace cricket {
@@ -83,7 +84,9 @@ class PseudoTcp {
   // If an unrecognized option is set or got, an assertion will fire.
   //
   // Setting options for OPT_RCVBUF or OPT_SNDBUF after Connect() is called
-  // will result in an assertion.
+  // will result in an assertion. Unless they are set, both buffers start at
+  // their default sizes and grow with the measured throughput of the
+  // connection.
   enum Option {
     OPT_NODELAY,      // Whether to enable Nagle's algorithm (0 == off)
     OPT_ACKDELAY,     // The Delayed ACK timeout (0 == off).
@@ -117,15 +120,20 @@ class PseudoTcp {
     const char * data;
     uint32_t len;
     uint32_t tsval, tsecr;
+    // Selective acknowledgment blocks carried by the segment, if any.
+    const char* sack;
+    uint32_t sack_len;
   };
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Whether the receiver has reported holding this segment out of order.
+    bool bSacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -168,6 +176,10 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable selective
+  // acknowledgment support for testing backward compatibility.
+  void disableSack();
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -188,6 +200,27 @@ class PseudoTcp {
   // window scale factor |m_swnd_scale| accordingly.
   void resizeReceiveBuffer(uint32_t new_size);
 
+  // Grow the receive buffer to |new_size| in bytes once the connection is
+  // established, keeping the window scale factor that was negotiated.
+  void growReceiveBuffer(uint32_t new_size);
+
+  // Grow the receive buffer if the application has read more than half of it
+  // per round trip since the last check.
+  void autoTuneReceiveBuffer(uint32_t now);
+
+  // Write the out of order data held in |m_rlist| as selective
+  // acknowledgment blocks to |buffer|. Returns the number of bytes written.
+  uint32_t writeSackBlocks(uint8_t* buffer);
+
+  // Mark the segments in |m_slist| covered by the selective acknowledgment
+  // blocks in |data|.
+  void applySackBlocks(const char* data, uint32_t len);
+
+  // Returns the first segment from |m_sack_rexmit| on that was sent, has not
+  // been selectively acknowledged and is below a segment that has, or
+  // |m_slist.end()| if there is none.
+  SList::iterator nextSackHole();
+
   IPseudoTcpNotify* m_notify;
   enum Shutdown { SD_NONE, SD_GRACEFUL, SD_FORCEFUL } m_shutdown;
   int m_error;
@@ -205,11 +238,22 @@ class PseudoTcp {
   uint8_t m_rwnd_scale;  // Window scale factor.
   rtc::FifoBuffer m_rbuf;
 
+  // Receive buffer auto-tuning. The round trip time is measured as the time
+  // it takes to receive a window of data, and compared with the amount of
+  // data the application has read since |m_rcv_copied_time|.
+  bool m_rbuf_autotune;
+  uint32_t m_rcv_rtt, m_rcv_rtt_seq, m_rcv_rtt_time;
+  uint32_t m_rcv_copied, m_rcv_copied_time;
+
   // Outgoing data
   SList m_slist;
   uint32_t m_sbuf_len, m_snd_nxt, m_snd_wnd, m_lastsend, m_snd_una;
   uint8_t m_swnd_scale;  // Window scale factor.
   rtc::FifoBuffer m_sbuf;
+  bool m_sbuf_autotune;
+
+  // Buffer the packets are assembled in before they are sent.
+  rtc::scoped_ptr<uint8_t[]> m_packet;
 
   // Maximum segment size, estimated protocol level, largest segment sent
   uint32_t m_mss, m_msslevel, m_largest, m_mtu_advise;
@@ -228,6 +272,12 @@ class PseudoTcp {
   uint32_t m_recover;
   uint32_t m_t_ack;
 
+  // Selective acknowledgment: whether both sides support it, the end of the
+  // highest selectively acknowledged segment, and where the search for the
+  // next segment to retransmit in the current recovery continues from.
+  bool m_sack_enabled;
+  uint32_t m_sack_high, m_sack_rexmit;
+
   // Configuration options
   bool m_use_nagling;
   uint32_t m_ack_delay;
@@ -235,6 +285,10 @@ class PseudoTcp {
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+
+  // This is used by unit tests to test backward compatibility of
+  // PseudoTcp implementations that don't support selective acknowledgments.
+  bool m_support_sack;
 };
 
 }  // namespace cricket
@@ -37,6 +37,10 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   void disableWindowScale() {
     PseudoTcp::disableWindowScale();
   }
+
+  void disableSack() {
+    PseudoTcp::disableSack();
+  }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -97,6 +101,12 @@ class PseudoTcpTestBase : public testing::Test,
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
   }
+  void DisableRemoteSack() {
+    remote_.disableSack();
+  }
+  void DisableLocalSack() {
+    local_.disableSack();
+  }
 
  protected:
   int Connect() {
@@ -438,6 +448,13 @@ class PseudoTcpTestPingPong : public PseudoTcpTestBase {
 // contracts and enlarges correctly.
 class PseudoTcpTestReceiveWindow : public PseudoTcpTestBase {
  public:
+  PseudoTcpTestReceiveWindow() {
+    // The window is counted in bytes here, so fix the receive buffer at its
+    // default size; a scaled window is only advertised in multiples of the
+    // scale, and an auto-tuned one would grow between the transfers.
+    SetRemoteOptRcvBuf(60 * 1024);
+  }
+
   // Not all the data are transfered, |size| just need to be big enough
   // to fill up the receiver window twice.
   void TestTransfer(int size) {
@@ -660,6 +677,57 @@ TEST_F(PseudoTcpTest, TestSendWithDelayAndOptAckDelayOff) {
   TestTransfer(100000);  // less data so test runs faster
 }
 
+// Test sending data with packet loss to a receiver that doesn't support
+// selective acknowledgments.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+}
+
+// Test sending data with packet loss from a sender that doesn't support
+// selective acknowledgments.
+TEST_F(PseudoTcpTest, TestSendWithLossLocalNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableLocalSack();
+  TestTransfer(100000);
+}
+
+// Test that the buffers grow beyond their default sizes when the window
+// limits a transfer with a 100 ms RTT.
+TEST_F(PseudoTcpTest, TestSendWithDelayGrowsBuffers) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  TestTransfer(4000000);
+  int rcvbuf = 0;
+  int sndbuf = 0;
+  remote_.GetOption(PseudoTcp::OPT_RCVBUF, &rcvbuf);
+  local_.GetOption(PseudoTcp::OPT_SNDBUF, &sndbuf);
+  EXPECT_GT(rcvbuf, 60 * 1024);
+  EXPECT_GT(sndbuf, 90 * 1024);
+}
+
+// Test that buffers set with SetOption() don't grow.
+TEST_F(PseudoTcpTest, TestSendWithDelayKeepsSetBuffers) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetRemoteOptRcvBuf(60 * 1024);
+  SetOptSndBuf(90 * 1024);
+  TestTransfer(1000000);
+  int rcvbuf = 0;
+  int sndbuf = 0;
+  remote_.GetOption(PseudoTcp::OPT_RCVBUF, &rcvbuf);
+  local_.GetOption(PseudoTcp::OPT_SNDBUF, &sndbuf);
+  EXPECT_EQ(60 * 1024, rcvbuf);
+  EXPECT_EQ(90 * 1024, sndbuf);
+}
+
 // Test a large receive buffer with a sender that doesn't support scaling.
 TEST_F(PseudoTcpTest, TestSendRemoteNoWindowScale) {
   SetLocalMtu(1500);
@@ -838,3 +906,23 @@ TEST_F(PseudoTcpTest, TestSendWithMismatchedMtus) {
   TestTransfer(1000000);
 }
 */
+
+// Throughput benchmark over a range of one-way delays (in ms) and packet loss
+// rates (in percent). TestTransfer() logs the rate of each transfer.
+class PseudoTcpThroughputTest
+    : public PseudoTcpTest,
+      public ::testing::WithParamInterface<::testing::tuple<int, int>> {};
+
+TEST_P(PseudoTcpThroughputTest, DISABLED_Benchmark) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(::testing::get<0>(GetParam()));
+  SetLoss(::testing::get<1>(GetParam()));
+  TestTransfer(500000);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    PseudoTcpThroughputTest,
+    PseudoTcpThroughputTest,
+    ::testing::Combine(::testing::Values(0, 10, 50),  // delay
+                       ::testing::Values(0, 1, 5)));  // loss
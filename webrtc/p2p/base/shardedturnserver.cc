@@ -0,0 +1,271 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/shardedturnserver.h"
+
+#include <algorithm>
+
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/common.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/socket.h"
+#include "webrtc/base/thread.h"
+
+namespace cricket {
+
+namespace {
+
+enum {
+  MSG_SHARD_PACKET,  // A packet from a client, posted to a shard.
+  MSG_SHARD_SEND,    // A packet for a client, posted back by a shard.
+};
+
+struct ShardPacketData : public rtc::MessageData {
+  ShardPacketData(rtc::AsyncPacketSocket* socket,
+                  const char* data,
+                  size_t size,
+                  const rtc::SocketAddress& addr)
+      : socket(socket), data(data, size), addr(addr) {}
+
+  // The internal socket the packet is sent on; only used for MSG_SHARD_SEND.
+  rtc::AsyncPacketSocket* socket;
+  rtc::Buffer data;
+  rtc::SocketAddress addr;
+  rtc::PacketTime packet_time;
+  rtc::PacketOptions options;
+};
+
+}  // namespace
+
+// Stands in for one internal socket on one shard. Packets are handed to it by
+// the front thread and surface through SignalReadPacket on the shard thread;
+// anything the shard sends is posted back to the front thread.
+class ShardedTurnServer::ShardSocket : public rtc::AsyncPacketSocket,
+                                       public rtc::MessageHandler {
+ public:
+  ShardSocket(ShardedTurnServer* server, rtc::AsyncPacketSocket* socket)
+      : server_(server),
+        socket_(socket),
+        local_address_(socket->GetLocalAddress()),
+        error_(0) {}
+
+  rtc::SocketAddress GetLocalAddress() const override {
+    return local_address_;
+  }
+  // Internal UDP sockets are never connected.
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress();
+  }
+
+  int Send(const void* pv, size_t cb,
+           const rtc::PacketOptions& options) override {
+    error_ = ENOTCONN;
+    return -1;
+  }
+
+  int SendTo(const void* pv, size_t cb, const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override {
+    ShardPacketData* packet = new ShardPacketData(
+        socket_, static_cast<const char*>(pv), cb, addr);
+    packet->options = options;
+    server_->thread_->Post(server_, MSG_SHARD_SEND, packet);
+    return static_cast<int>(cb);
+  }
+
+  // The real socket is owned by the ShardedTurnServer.
+  int Close() override { return 0; }
+  State GetState() const override { return STATE_BOUND; }
+
+  // Options of the real socket can't be touched from the shard thread.
+  int GetOption(rtc::Socket::Option opt, int* value) override {
+    error_ = ENOTSUP;
+    return -1;
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override {
+    error_ = ENOTSUP;
+    return -1;
+  }
+
+  int GetError() const override { return error_; }
+  void SetError(int error) override { error_ = error; }
+
+  void OnMessage(rtc::Message* msg) override {
+    ASSERT(msg->message_id == MSG_SHARD_PACKET);
+    rtc::scoped_ptr<ShardPacketData> packet(
+        static_cast<ShardPacketData*>(msg->pdata));
+    SignalReadPacket(this, packet->data.data<char>(), packet->data.size(),
+                     packet->addr, packet->packet_time);
+  }
+
+ private:
+  ShardedTurnServer* server_;
+  rtc::AsyncPacketSocket* socket_;
+  const rtc::SocketAddress local_address_;
+  int error_;
+};
+
+struct ShardedTurnServer::Shard {
+  explicit Shard(rtc::Thread* thread) : thread(thread), server(thread) {}
+
+  rtc::scoped_ptr<rtc::Thread> thread;
+  TurnServer server;
+  // One per internal socket, in the same order; owned by |server|.
+  std::vector<ShardSocket*> sockets;
+};
+
+ShardedTurnServer::ShardedTurnServer(rtc::Thread* thread, size_t num_shards)
+    : thread_(thread), started_(false) {
+  ASSERT(num_shards > 0);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(new Shard(new rtc::Thread()));
+  }
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  // Stop the shards first so nothing is posted to us while tearing down.
+  for (Shard* shard : shards_) {
+    shard->thread->Stop();
+  }
+  thread_->Clear(this);
+  for (Shard* shard : shards_) {
+    delete shard;
+  }
+  for (rtc::AsyncPacketSocket* socket : internal_sockets_) {
+    delete socket;
+  }
+}
+
+TurnServer* ShardedTurnServer::shard(size_t index) const {
+  ASSERT(index < shards_.size());
+  return &shards_[index]->server;
+}
+
+rtc::Thread* ShardedTurnServer::shard_thread(size_t index) const {
+  ASSERT(index < shards_.size());
+  return shards_[index]->thread.get();
+}
+
+void ShardedTurnServer::set_realm(const std::string& realm) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_realm(realm);
+  }
+}
+
+void ShardedTurnServer::set_software(const std::string& software) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_software(software);
+  }
+}
+
+void ShardedTurnServer::set_auth_hook(TurnAuthInterface* auth_hook) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_auth_hook(auth_hook);
+  }
+}
+
+void ShardedTurnServer::set_redirect_hook(
+    TurnRedirectInterface* redirect_hook) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_redirect_hook(redirect_hook);
+  }
+}
+
+void ShardedTurnServer::set_enable_otu_nonce(bool enable) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_enable_otu_nonce(enable);
+  }
+}
+
+void ShardedTurnServer::set_reject_private_addresses(bool filter) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.set_reject_private_addresses(filter);
+  }
+}
+
+void ShardedTurnServer::AddInternalSocket(rtc::AsyncPacketSocket* socket) {
+  ASSERT(!started_);
+  ASSERT(std::find(internal_sockets_.begin(), internal_sockets_.end(),
+                   socket) == internal_sockets_.end());
+  internal_sockets_.push_back(socket);
+  socket->SignalReadPacket.connect(this, &ShardedTurnServer::OnInternalPacket);
+  for (Shard* shard : shards_) {
+    ShardSocket* shard_socket = new ShardSocket(this, socket);
+    shard->sockets.push_back(shard_socket);
+    shard->server.AddInternalSocket(shard_socket, PROTO_UDP);
+  }
+}
+
+void ShardedTurnServer::SetExternalAddress(const rtc::SocketAddress& address) {
+  ASSERT(!started_);
+  for (Shard* shard : shards_) {
+    shard->server.SetExternalSocketFactory(
+        new rtc::BasicPacketSocketFactory(shard->thread.get()), address);
+  }
+}
+
+bool ShardedTurnServer::Start() {
+  ASSERT(!started_);
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (!shards_[i]->thread->Start()) {
+      LOG(LS_ERROR) << "Failed to start TURN shard " << i;
+      return false;
+    }
+  }
+  started_ = true;
+  return true;
+}
+
+size_t ShardedTurnServer::GetShardIndex(size_t socket_index,
+                                        const rtc::SocketAddress& src) const {
+  // The destination and protocol are fixed per internal socket, so the
+  // socket's index and the source address identify the 5-tuple.
+  size_t hash = src.Hash() ^ (socket_index * 0x9e3779b9u);
+  return hash % shards_.size();
+}
+
+void ShardedTurnServer::OnInternalPacket(rtc::AsyncPacketSocket* socket,
+                                         const char* data, size_t size,
+                                         const rtc::SocketAddress& addr,
+                                         const rtc::PacketTime& packet_time) {
+  ASSERT(thread_ == rtc::Thread::Current());
+  if (!started_) {
+    return;
+  }
+  std::vector<rtc::AsyncPacketSocket*>::const_iterator it =
+      std::find(internal_sockets_.begin(), internal_sockets_.end(), socket);
+  ASSERT(it != internal_sockets_.end());
+  size_t socket_index = it - internal_sockets_.begin();
+  Shard* shard = shards_[GetShardIndex(socket_index, addr)];
+  ShardPacketData* packet = new ShardPacketData(NULL, data, size, addr);
+  packet->packet_time = packet_time;
+  shard->thread->Post(shard->sockets[socket_index], MSG_SHARD_PACKET, packet);
+}
+
+void ShardedTurnServer::OnMessage(rtc::Message* msg) {
+  ASSERT(msg->message_id == MSG_SHARD_SEND);
+  rtc::scoped_ptr<ShardPacketData> packet(
+      static_cast<ShardPacketData*>(msg->pdata));
+  if (packet->socket->SendTo(packet->data.data(), packet->data.size(),
+                             packet->addr, packet->options) < 0) {
+    LOG(LS_WARNING) << "Failed to send TURN packet to "
+                    << packet->addr.ToSensitiveString()
+                    << ", error: " << packet->socket->GetError();
+  }
+}
+
+}  // namespace cricket
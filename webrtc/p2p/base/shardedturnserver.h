@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+#define WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/turnserver.h"
+#include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/base/socketaddress.h"
+
+namespace rtc {
+class Thread;
+}
+
+namespace cricket {
+
+// A TURN server that spreads its allocations over several worker threads.
+// Every worker runs its own TurnServer, with its own allocation map and
+// external sockets, so the shards never share state. Packets arriving on the
+// internal UDP sockets are read on |thread| and handed to the shard picked by
+// hashing the client's 5-tuple; a given client therefore always talks to the
+// same shard. Responses are posted back to |thread| and sent from there.
+//
+// All configuration must be done before Start(). The auth and redirect hooks
+// are shared by all shards and are called on the worker threads, so they
+// must be thread safe. Only UDP internal sockets are supported.
+class ShardedTurnServer : public rtc::MessageHandler,
+                          public sigslot::has_slots<> {
+ public:
+  ShardedTurnServer(rtc::Thread* thread, size_t num_shards);
+  ~ShardedTurnServer() override;
+
+  size_t num_shards() const { return shards_.size(); }
+  // The server of shard |index| may only be used on shard_thread(index) once
+  // the server is started.
+  TurnServer* shard(size_t index) const;
+  rtc::Thread* shard_thread(size_t index) const;
+
+  void set_realm(const std::string& realm);
+  void set_software(const std::string& software);
+  // Sets the authentication callback; does not take ownership.
+  void set_auth_hook(TurnAuthInterface* auth_hook);
+  void set_redirect_hook(TurnRedirectInterface* redirect_hook);
+  void set_enable_otu_nonce(bool enable);
+  void set_reject_private_addresses(bool filter);
+
+  // Starts listening for packets from internal clients. Takes ownership of
+  // |socket|, which must have been created on |thread|.
+  void AddInternalSocket(rtc::AsyncPacketSocket* socket);
+  // Makes every shard create its external sockets on its own thread, bound
+  // to the IP of |address|.
+  void SetExternalAddress(const rtc::SocketAddress& address);
+
+  // Starts the worker threads.
+  bool Start();
+
+  // Returns the shard that handles packets from |src| that are received on
+  // the |socket_index|th internal socket.
+  size_t GetShardIndex(size_t socket_index,
+                       const rtc::SocketAddress& src) const;
+
+ private:
+  class ShardSocket;
+  struct Shard;
+
+  void OnInternalPacket(rtc::AsyncPacketSocket* socket, const char* data,
+                        size_t size, const rtc::SocketAddress& addr,
+                        const rtc::PacketTime& packet_time);
+
+  // Sends packets posted by the shards on the internal sockets.
+  void OnMessage(rtc::Message* msg) override;
+
+  rtc::Thread* thread_;
+  std::vector<Shard*> shards_;
+  std::vector<rtc::AsyncPacketSocket*> internal_sockets_;
+  bool started_;
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
@@ -0,0 +1,144 @@
+/*
+ *  Copyright 2015 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/shardedturnserver.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/helpers.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/testclient.h"
+#include "webrtc/base/thread.h"
+
+using namespace cricket;
+
+static const rtc::SocketAddress kLoopbackAddr("127.0.0.1", 0);
+static const char kRealm[] = "example.org";
+static const size_t kNumShards = 4;
+
+class ShardedTurnServerTest : public testing::Test,
+                              public TurnAuthInterface {
+ public:
+  ShardedTurnServerTest()
+      : thread_(rtc::Thread::Current()),
+        server_(thread_, kNumShards) {
+    rtc::AsyncUDPSocket* socket =
+        rtc::AsyncUDPSocket::Create(thread_->socketserver(), kLoopbackAddr);
+    server_addr_ = socket->GetLocalAddress();
+    server_.AddInternalSocket(socket);
+    server_.SetExternalAddress(kLoopbackAddr);
+    server_.set_realm(kRealm);
+    server_.set_auth_hook(this);
+    EXPECT_TRUE(server_.Start());
+  }
+
+  rtc::TestClient* CreateClient() {
+    return new rtc::TestClient(
+        rtc::AsyncUDPSocket::Create(thread_->socketserver(), kLoopbackAddr));
+  }
+
+  void Send(rtc::TestClient* client, const StunMessage& msg) {
+    rtc::ByteBuffer buf;
+    msg.Write(&buf);
+    client->SendTo(buf.Data(), buf.Length(), server_addr_);
+  }
+
+  StunMessage* Receive(rtc::TestClient* client) {
+    rtc::scoped_ptr<rtc::TestClient::Packet> packet(
+        client->NextPacket(rtc::TestClient::kTimeoutMs));
+    if (!packet) {
+      return NULL;
+    }
+    rtc::ByteBuffer buf(packet->buf, packet->size);
+    rtc::scoped_ptr<TurnMessage> msg(new TurnMessage());
+    if (!msg->Read(&buf)) {
+      return NULL;
+    }
+    return msg.release();
+  }
+
+ private:
+  // Accepts any user whose password is the same as the username.
+  bool GetKey(const std::string& username, const std::string& realm,
+              std::string* key) override {
+    return ComputeStunCredentialHash(username, realm, username, key);
+  }
+
+ protected:
+  rtc::Thread* thread_;
+  ShardedTurnServer server_;
+  rtc::SocketAddress server_addr_;
+};
+
+// The same 5-tuple must always map to the same shard, and different
+// clients should be spread across all of them.
+TEST_F(ShardedTurnServerTest, TestShardIndex) {
+  std::set<size_t> used;
+  for (int port = 1000; port < 1064; ++port) {
+    rtc::SocketAddress src("192.168.1.3", port);
+    size_t index = server_.GetShardIndex(0, src);
+    EXPECT_LT(index, kNumShards);
+    EXPECT_EQ(index, server_.GetShardIndex(0, src));
+    used.insert(index);
+  }
+  EXPECT_EQ(kNumShards, used.size());
+}
+
+// Every client gets its binding response back from its shard.
+TEST_F(ShardedTurnServerTest, TestBindingFromManyClients) {
+  std::vector<rtc::TestClient*> clients;
+  for (int i = 0; i < 16; ++i) {
+    rtc::TestClient* client = CreateClient();
+    clients.push_back(client);
+    StunMessage req;
+    req.SetType(STUN_BINDING_REQUEST);
+    req.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    Send(client, req);
+
+    rtc::scoped_ptr<StunMessage> msg(Receive(client));
+    ASSERT_TRUE(msg);
+    EXPECT_EQ(STUN_BINDING_RESPONSE, msg->type());
+    EXPECT_EQ(req.transaction_id(), msg->transaction_id());
+    const StunAddressAttribute* mapped_addr =
+        msg->GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+    ASSERT_TRUE(mapped_addr != NULL);
+    EXPECT_EQ(client->address(), mapped_addr->GetAddress());
+  }
+  for (rtc::TestClient* client : clients) {
+    delete client;
+  }
+}
+
+// An unauthenticated allocate request is challenged by the shard.
+TEST_F(ShardedTurnServerTest, TestUnauthorizedAllocate) {
+  rtc::scoped_ptr<rtc::TestClient> client(CreateClient());
+  TurnMessage req;
+  req.SetType(STUN_ALLOCATE_REQUEST);
+  req.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+  req.AddAttribute(new StunUInt32Attribute(STUN_ATTR_REQUESTED_TRANSPORT,
+                                           IPPROTO_UDP << 24));
+  Send(client.get(), req);
+
+  rtc::scoped_ptr<StunMessage> msg(Receive(client.get()));
+  ASSERT_TRUE(msg);
+  EXPECT_EQ(STUN_ALLOCATE_ERROR_RESPONSE, msg->type());
+  const StunErrorCodeAttribute* error = msg->GetErrorCode();
+  ASSERT_TRUE(error != NULL);
+  EXPECT_EQ(STUN_ERROR_UNAUTHORIZED, error->code());
+  const StunByteStringAttribute* realm =
+      msg->GetByteString(STUN_ATTR_REALM);
+  ASSERT_TRUE(realm != NULL);
+  EXPECT_EQ(kRealm, realm->GetString());
+  EXPECT_TRUE(msg->GetByteString(STUN_ATTR_NONCE) != NULL);
+}
@@ -0,0 +1,280 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/shardedudpsocketmux.h"
+
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/crc32.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/messagehandler.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+
+namespace cricket {
+
+namespace {
+
+enum {
+  MSG_FORWARDED_PACKET,  // A packet read by another shard.
+};
+
+// Routes that haven't been used for this long are forgotten. The sessions
+// send STUN requests, and thus refresh their routes, far more often.
+const int kRouteTimeoutMs = 30 * 1000;
+
+struct ForwardedPacketData : public rtc::MessageData {
+  ForwardedPacketData(const char* data,
+                      size_t size,
+                      const rtc::SocketAddress& addr,
+                      const rtc::PacketTime& packet_time)
+      : data(data, size), addr(addr), packet_time(packet_time) {}
+
+  rtc::Buffer data;
+  rtc::SocketAddress addr;
+  rtc::PacketTime packet_time;
+};
+
+// Returns the local ufrag from the USERNAME of |data| if it is a STUN
+// request.
+bool GetStunRequestUfrag(const char* data, size_t size, std::string* ufrag) {
+  if (size < kStunHeaderSize || (data[0] & 0xC0) != 0 ||
+      !IsStunRequestType(rtc::GetBE16(data))) {
+    return false;
+  }
+  IceMessage msg;
+  rtc::ByteBuffer buf(data, size);
+  if (!msg.Read(&buf))
+    return false;
+  const StunByteStringAttribute* username_attr =
+      msg.GetByteString(STUN_ATTR_USERNAME);
+  if (!username_attr)
+    return false;
+  const std::string& username = username_attr->GetString();
+  *ufrag = username.substr(0, username.find(':'));
+  return true;
+}
+
+}  // namespace
+
+// One thread and its socket. Packets its mux can't place are forwarded to
+// the shard they belong to; the routes used for that are cached here, so
+// they can be read without locking.
+class ShardedUdpSocketMux::Shard : public rtc::MessageHandler,
+                                   public sigslot::has_slots<> {
+ public:
+  Shard(ShardedUdpSocketMux* parent, size_t index)
+      : parent_(parent),
+        index_(index),
+        thread_(new rtc::Thread()),
+        socket_factory_(thread_.get()),
+        last_route_expiry_(rtc::Time()) {}
+  // Must only be called once the threads of all shards are stopped.
+  ~Shard() override { thread_->Clear(this); }
+
+  rtc::Thread* thread() const { return thread_.get(); }
+  rtc::PacketSocketFactory* socket_factory() { return &socket_factory_; }
+  UdpSocketMux* mux() const { return mux_.get(); }
+
+  bool CreateSocket(const rtc::SocketAddress& address, bool reuse_port) {
+    rtc::AsyncSocket* socket = thread_->socketserver()->CreateAsyncSocket(
+        address.family(), SOCK_DGRAM);
+    if (!socket)
+      return false;
+    if (reuse_port && socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) != 0) {
+      LOG(LS_ERROR) << "Failed to enable SO_REUSEPORT, error: "
+                    << socket->GetError();
+      delete socket;
+      return false;
+    }
+    rtc::AsyncUDPSocket* udp_socket =
+        rtc::AsyncUDPSocket::Create(socket, address);
+    if (!udp_socket)
+      return false;
+    mux_.reset(new UdpSocketMux(udp_socket));
+    mux_->SignalUnhandledPacket.connect(this, &Shard::OnUnhandledPacket);
+    mux_->SignalStunRequestSent.connect(this, &Shard::OnStunRequestSent);
+    return true;
+  }
+
+ private:
+  void OnUnhandledPacket(UdpSocketMux* mux,
+                         const char* data,
+                         size_t size,
+                         const rtc::SocketAddress& remote_addr,
+                         const rtc::PacketTime& packet_time) {
+    uint32_t now = rtc::Time();
+    ExpireRoutes(now);
+
+    size_t shard;
+    std::string ufrag;
+    RouteMap::iterator it;
+    if (GetStunRequestUfrag(data, size, &ufrag)) {
+      shard = parent_->GetShardIndex(ufrag);
+    } else if ((it = routes_.find(remote_addr)) != routes_.end()) {
+      shard = it->second.shard;
+    } else if (!parent_->FindRoute(remote_addr, &shard)) {
+      LOG(LS_VERBOSE) << "ShardedUdpSocketMux: dropping packet from unknown "
+                      << "address " << remote_addr.ToSensitiveString();
+      return;
+    }
+    // Our own sessions were already given a chance by the mux.
+    if (shard == index_)
+      return;
+
+    Route& route = routes_[remote_addr];
+    route.shard = shard;
+    route.time = now;
+    Shard* target = parent_->shards_[shard];
+    target->thread_->Post(
+        target, MSG_FORWARDED_PACKET,
+        new ForwardedPacketData(data, size, remote_addr, packet_time));
+  }
+
+  void OnStunRequestSent(UdpSocketMux* mux, const rtc::SocketAddress& addr) {
+    parent_->AddRoute(addr, index_);
+  }
+
+  void OnMessage(rtc::Message* msg) override {
+    RTC_DCHECK(msg->message_id == MSG_FORWARDED_PACKET);
+    rtc::scoped_ptr<ForwardedPacketData> packet(
+        static_cast<ForwardedPacketData*>(msg->pdata));
+    if (!mux_->HandlePacket(packet->data.data<char>(), packet->data.size(),
+                            packet->addr, packet->packet_time)) {
+      LOG(LS_VERBOSE) << "ShardedUdpSocketMux: dropping forwarded packet "
+                      << "from " << packet->addr.ToSensitiveString();
+    }
+  }
+
+  void ExpireRoutes(uint32_t now) {
+    if (rtc::TimeDiff(now, last_route_expiry_) < kRouteTimeoutMs)
+      return;
+    for (RouteMap::iterator it = routes_.begin(); it != routes_.end();) {
+      if (rtc::TimeDiff(now, it->second.time) > kRouteTimeoutMs)
+        routes_.erase(it++);
+      else
+        ++it;
+    }
+    last_route_expiry_ = now;
+  }
+
+  ShardedUdpSocketMux* const parent_;
+  const size_t index_;
+  rtc::scoped_ptr<rtc::Thread> thread_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  rtc::scoped_ptr<UdpSocketMux> mux_;
+  RouteMap routes_;
+  uint32_t last_route_expiry_;
+};
+
+ShardedUdpSocketMux::ShardedUdpSocketMux(size_t num_shards)
+    : started_(false), last_route_expiry_(rtc::Time()) {
+  RTC_DCHECK(num_shards > 0);
+  for (size_t i = 0; i < num_shards; ++i)
+    shards_.push_back(new Shard(this, i));
+}
+
+ShardedUdpSocketMux::~ShardedUdpSocketMux() {
+  // Stop every shard before deleting any, as they post to each other.
+  for (Shard* shard : shards_)
+    shard->thread()->Stop();
+  for (Shard* shard : shards_)
+    delete shard;
+}
+
+bool ShardedUdpSocketMux::Start(const rtc::SocketAddress& address) {
+  RTC_DCHECK(!started_);
+  bool reuse_port = shards_.size() > 1;
+  rtc::SocketAddress bind_address = address;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (!shards_[i]->CreateSocket(bind_address, reuse_port)) {
+      LOG(LS_ERROR) << "Failed to bind UDP shard " << i << " to "
+                    << bind_address.ToSensitiveString();
+      return false;
+    }
+    if (i == 0)
+      bind_address = shards_[0]->mux()->GetLocalAddress();
+  }
+  local_address_ = bind_address;
+
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (!shards_[i]->thread()->Start()) {
+      LOG(LS_ERROR) << "Failed to start UDP shard " << i;
+      return false;
+    }
+  }
+  started_ = true;
+  return true;
+}
+
+rtc::SocketAddress ShardedUdpSocketMux::GetLocalAddress() const {
+  return local_address_;
+}
+
+size_t ShardedUdpSocketMux::GetShardIndex(const std::string& ufrag) const {
+  return rtc::ComputeCrc32(ufrag) % shards_.size();
+}
+
+rtc::Thread* ShardedUdpSocketMux::shard_thread(size_t index) const {
+  RTC_DCHECK(index < shards_.size());
+  return shards_[index]->thread();
+}
+
+rtc::PacketSocketFactory* ShardedUdpSocketMux::shard_socket_factory(
+    size_t index) const {
+  RTC_DCHECK(index < shards_.size());
+  return shards_[index]->socket_factory();
+}
+
+rtc::AsyncPacketSocket* ShardedUdpSocketMux::CreateEndpoint(
+    const std::string& ufrag) {
+  RTC_DCHECK(started_);
+  Shard* shard = shards_[GetShardIndex(ufrag)];
+  RTC_DCHECK(shard->thread()->IsCurrent());
+  return shard->mux()->CreateEndpoint(ufrag);
+}
+
+void ShardedUdpSocketMux::AddRoute(const rtc::SocketAddress& addr,
+                                   size_t shard) {
+  uint32_t now = rtc::Time();
+  rtc::CritScope lock(&routes_crit_);
+  Route& route = routes_[addr];
+  route.shard = shard;
+  route.time = now;
+  if (rtc::TimeDiff(now, last_route_expiry_) < kRouteTimeoutMs)
+    return;
+  for (RouteMap::iterator it = routes_.begin(); it != routes_.end();) {
+    if (rtc::TimeDiff(now, it->second.time) > kRouteTimeoutMs)
+      routes_.erase(it++);
+    else
+      ++it;
+  }
+  last_route_expiry_ = now;
+}
+
+bool ShardedUdpSocketMux::FindRoute(const rtc::SocketAddress& addr,
+                                    size_t* shard) {
+  rtc::CritScope lock(&routes_crit_);
+  RouteMap::const_iterator it = routes_.find(addr);
+  if (it == routes_.end())
+    return false;
+  *shard = it->second.shard;
+  return true;
+}
+
+}  // namespace cricket
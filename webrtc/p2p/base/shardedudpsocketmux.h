@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_SHARDEDUDPSOCKETMUX_H_
+#define WEBRTC_P2P_BASE_SHARDEDUDPSOCKETMUX_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/socketaddress.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace rtc {
+class PacketSocketFactory;
+class Thread;
+}
+
+namespace cricket {
+
+// Spreads the UDP ingest of a server over several threads. Every shard owns a
+// thread and a UdpSocketMux whose socket is bound, with SO_REUSEPORT, to the
+// same local address as the sockets of all other shards, so the kernel
+// spreads the incoming packets over the shards by their 4-tuple.
+//
+// A session is pinned to the shard picked by its ICE ufrag: its UDPPort must
+// be created on that shard's thread, using CreateEndpoint() as its shared
+// socket and shard_socket_factory() as its factory. Packets the kernel hands
+// to another shard are forwarded to the session's shard: STUN requests by the
+// ufrag in their USERNAME, everything else by the remote address, which is
+// learnt from those requests and from the STUN requests the sessions send.
+// Since the kernel keeps sending a given 4-tuple to the same socket, most
+// packets are handled on the thread that read them and the rest take one
+// post.
+//
+// Endpoints must be destroyed, on their shard's thread, before the mux.
+class ShardedUdpSocketMux {
+ public:
+  explicit ShardedUdpSocketMux(size_t num_shards);
+  ~ShardedUdpSocketMux();
+
+  // Binds a socket per shard to |address| and starts the shard threads. If
+  // the port of |address| is 0, the first shard picks one for all of them.
+  bool Start(const rtc::SocketAddress& address);
+
+  rtc::SocketAddress GetLocalAddress() const;
+
+  size_t num_shards() const { return shards_.size(); }
+  // Returns the shard the session with the ICE ufrag |ufrag| is pinned to.
+  size_t GetShardIndex(const std::string& ufrag) const;
+  rtc::Thread* shard_thread(size_t index) const;
+  // Creates sockets on shard_thread(index); may only be used there.
+  rtc::PacketSocketFactory* shard_socket_factory(size_t index) const;
+
+  // Returns a new endpoint for the session with the ICE ufrag |ufrag|, which
+  // is owned by the caller, or null if |ufrag| is already in use. Must be
+  // called on shard_thread(GetShardIndex(ufrag)).
+  rtc::AsyncPacketSocket* CreateEndpoint(const std::string& ufrag);
+
+ private:
+  class Shard;
+  struct Route {
+    size_t shard;
+    uint32_t time;
+  };
+  typedef std::map<rtc::SocketAddress, Route> RouteMap;
+
+  // Remembers that packets from |addr| belong to the shard |shard|.
+  void AddRoute(const rtc::SocketAddress& addr, size_t shard);
+  bool FindRoute(const rtc::SocketAddress& addr, size_t* shard);
+
+  std::vector<Shard*> shards_;
+  rtc::SocketAddress local_address_;
+  bool started_;
+
+  rtc::CriticalSection routes_crit_;
+  // Routes learnt from the STUN requests sent by the sessions. The shards
+  // cache what they read from here, so this is only consulted the first time
+  // a shard reads a packet from an address it doesn't know.
+  RouteMap routes_ GUARDED_BY(routes_crit_);
+  uint32_t last_route_expiry_ GUARDED_BY(routes_crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ShardedUdpSocketMux);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_SHARDEDUDPSOCKETMUX_H_
@@ -0,0 +1,205 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "webrtc/p2p/base/shardedudpsocketmux.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/bind.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/testclient.h"
+#include "webrtc/base/thread.h"
+
+// SO_REUSEPORT isn't available on Windows.
+#if defined(WEBRTC_POSIX)
+
+using cricket::ShardedUdpSocketMux;
+using rtc::SocketAddress;
+using rtc::TestClient;
+
+static const SocketAddress kLoopbackAddr("127.0.0.1", 0);
+static const size_t kNumShards = 4;
+// Enough remotes that the kernel hands some of them to every shard.
+static const size_t kNumRemotes = 16;
+static const char kUfrag[] = "ufrag";
+
+class ShardedUdpSocketMuxTest : public testing::Test {
+ protected:
+  ShardedUdpSocketMuxTest() : mux_(kNumShards) {
+    EXPECT_TRUE(mux_.Start(kLoopbackAddr));
+    for (size_t i = 0; i < kNumRemotes; ++i) {
+      remotes_.push_back(new TestClient(rtc::AsyncUDPSocket::Create(
+          rtc::Thread::Current()->socketserver(), kLoopbackAddr)));
+    }
+  }
+  ~ShardedUdpSocketMuxTest() {
+    for (TestClient* remote : remotes_)
+      delete remote;
+  }
+
+  // Creates an endpoint for |ufrag| on the thread of its shard.
+  TestClient* CreateEndpoint(const std::string& ufrag) {
+    return ShardThread(ufrag)->Invoke<TestClient*>(rtc::Bind(
+        &ShardedUdpSocketMuxTest::CreateEndpoint_s, this, ufrag));
+  }
+  TestClient* CreateEndpoint_s(const std::string& ufrag) {
+    rtc::AsyncPacketSocket* endpoint = mux_.CreateEndpoint(ufrag);
+    return endpoint ? new TestClient(endpoint) : nullptr;
+  }
+  void DestroyEndpoint(const std::string& ufrag, TestClient* endpoint) {
+    ShardThread(ufrag)->Invoke<void>(
+        rtc::Bind(&ShardedUdpSocketMuxTest::DestroyEndpoint_s, endpoint));
+  }
+  static void DestroyEndpoint_s(TestClient* endpoint) { delete endpoint; }
+
+  int SendFromEndpoint(const std::string& ufrag,
+                       TestClient* endpoint,
+                       const std::string& data,
+                       const SocketAddress& addr) {
+    return ShardThread(ufrag)->Invoke<int>(
+        rtc::Bind(&ShardedUdpSocketMuxTest::SendFromEndpoint_s, endpoint,
+                  data, addr));
+  }
+  static int SendFromEndpoint_s(TestClient* endpoint,
+                                const std::string& data,
+                                const SocketAddress& addr) {
+    return endpoint->SendTo(data.c_str(), data.size(), addr);
+  }
+
+  rtc::Thread* ShardThread(const std::string& ufrag) {
+    return mux_.shard_thread(mux_.GetShardIndex(ufrag));
+  }
+
+  static std::string StunMessageToString(const cricket::StunMessage& msg) {
+    rtc::ByteBuffer buf;
+    msg.Write(&buf);
+    return std::string(buf.Data(), buf.Length());
+  }
+  static std::string BindingRequest(const std::string& username,
+                                    const std::string& transaction_id) {
+    cricket::IceMessage msg;
+    msg.SetType(cricket::STUN_BINDING_REQUEST);
+    msg.SetTransactionID(transaction_id);
+    msg.AddAttribute(new cricket::StunByteStringAttribute(
+        cricket::STUN_ATTR_USERNAME, username));
+    return StunMessageToString(msg);
+  }
+  static std::string BindingResponse(const std::string& transaction_id) {
+    cricket::IceMessage msg;
+    msg.SetType(cricket::STUN_BINDING_RESPONSE);
+    msg.SetTransactionID(transaction_id);
+    return StunMessageToString(msg);
+  }
+  static std::string TransactionId(size_t index) {
+    std::string id(cricket::kStunTransactionIdLength, 'a');
+    id[0] = static_cast<char>('a' + index);
+    return id;
+  }
+
+  // Expects |endpoint| to read |data| from every remote, in any order.
+  void ExpectReadFromAllRemotes(TestClient* endpoint,
+                                const std::vector<std::string>& data) {
+    std::vector<bool> read(remotes_.size(), false);
+    for (size_t i = 0; i < remotes_.size(); ++i) {
+      rtc::scoped_ptr<TestClient::Packet> packet(
+          endpoint->NextPacket(TestClient::kTimeoutMs));
+      ASSERT_TRUE(packet);
+      size_t j = 0;
+      while (j < remotes_.size() && packet->addr != remotes_[j]->address())
+        ++j;
+      ASSERT_LT(j, remotes_.size());
+      EXPECT_FALSE(read[j]);
+      EXPECT_EQ(data[j], std::string(packet->buf, packet->size));
+      read[j] = true;
+    }
+    EXPECT_TRUE(endpoint->CheckNoPacket());
+  }
+
+  ShardedUdpSocketMux mux_;
+  std::vector<TestClient*> remotes_;
+};
+
+TEST_F(ShardedUdpSocketMuxTest, TestAllShardsShareTheAddress) {
+  EXPECT_NE(0, mux_.GetLocalAddress().port());
+  EXPECT_EQ(kNumShards, mux_.num_shards());
+  EXPECT_EQ(mux_.GetShardIndex(kUfrag), mux_.GetShardIndex(kUfrag));
+}
+
+// STUN requests are handed to the shard of their ufrag, whichever socket
+// they arrive on, and so are the packets that follow from the same remotes.
+TEST_F(ShardedUdpSocketMuxTest, TestPacketsReachTheShardOfTheirSession) {
+  TestClient* endpoint = CreateEndpoint(kUfrag);
+  ASSERT_TRUE(endpoint != nullptr);
+
+  std::vector<std::string> requests;
+  for (size_t i = 0; i < remotes_.size(); ++i) {
+    requests.push_back(
+        BindingRequest(std::string(kUfrag) + ":remote", TransactionId(i)));
+    remotes_[i]->SendTo(requests[i].c_str(), requests[i].size(),
+                        mux_.GetLocalAddress());
+  }
+  ExpectReadFromAllRemotes(endpoint, requests);
+
+  std::vector<std::string> media;
+  for (size_t i = 0; i < remotes_.size(); ++i) {
+    media.push_back("media" + rtc::ToString(i));
+    remotes_[i]->SendTo(media[i].c_str(), media[i].size(),
+                        mux_.GetLocalAddress());
+  }
+  ExpectReadFromAllRemotes(endpoint, media);
+
+  DestroyEndpoint(kUfrag, endpoint);
+}
+
+// Responses to the requests a session sends find their way back to it.
+TEST_F(ShardedUdpSocketMuxTest, TestResponsesReachTheSender) {
+  TestClient* endpoint = CreateEndpoint(kUfrag);
+  ASSERT_TRUE(endpoint != nullptr);
+
+  std::vector<std::string> responses;
+  for (size_t i = 0; i < remotes_.size(); ++i) {
+    std::string request = BindingRequest("remote:" + std::string(kUfrag),
+                                         TransactionId(i));
+    EXPECT_EQ(static_cast<int>(request.size()),
+              SendFromEndpoint(kUfrag, endpoint, request,
+                               remotes_[i]->address()));
+    EXPECT_TRUE(remotes_[i]->CheckNextPacket(request.c_str(), request.size(),
+                                             nullptr));
+    responses.push_back(BindingResponse(TransactionId(i)));
+    remotes_[i]->SendTo(responses[i].c_str(), responses[i].size(),
+                        mux_.GetLocalAddress());
+  }
+  ExpectReadFromAllRemotes(endpoint, responses);
+
+  DestroyEndpoint(kUfrag, endpoint);
+}
+
+TEST_F(ShardedUdpSocketMuxTest, TestUnknownPacketsAreDropped) {
+  TestClient* endpoint = CreateEndpoint(kUfrag);
+  ASSERT_TRUE(endpoint != nullptr);
+
+  for (size_t i = 0; i < remotes_.size(); ++i) {
+    std::string request = BindingRequest("other:remote", TransactionId(i));
+    remotes_[i]->SendTo(request.c_str(), request.size(),
+                        mux_.GetLocalAddress());
+    std::string media = "media";
+    remotes_[i]->SendTo(media.c_str(), media.size(), mux_.GetLocalAddress());
+  }
+  EXPECT_TRUE(endpoint->CheckNoPacket());
+
+  DestroyEndpoint(kUfrag, endpoint);
+}
+
+#endif  // defined(WEBRTC_POSIX)
@@ -129,8 +129,14 @@ const StunUInt16ListAttribute* StunMessage::GetUnknownAttributes() const {
 // procedure outlined in RFC 5389, section 15.4.
 bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
                                            const std::string& password) {
+  rtc::HmacDigest hmac(rtc::DIGEST_SHA_1, password.data(), password.size());
+  return ValidateMessageIntegrity(data, size, &hmac);
+}
+
+bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
+                                           rtc::HmacDigest* hmac) {
   // Verifying the size of the message.
-  if ((size % 4) != 0) {
+  if ((size % 4) != 0 || size < kStunHeaderSize) {
     return false;
   }
 
@@ -170,10 +176,12 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
+  // Getting length of the message to calculate Message Integrity. The HMAC
+  // is computed over the message in place; only the header is copied, since
+  // its length field may have to be patched.
   size_t mi_pos = current_pos;
-  rtc::scoped_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
+  char header[kStunHeaderSize];
+  memcpy(header, data, kStunHeaderSize);
   if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
     // Stun message has other attributes after message integrity.
     // Adjust the length parameter in stun message to calculate HMAC.
@@ -187,22 +195,21 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
     //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     //     |0 0|     STUN Message Type     |         Message Length        |
     //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
+    rtc::SetBE16(header + 2, static_cast<uint16_t>(new_adjusted_len));
   }
 
-  char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      password.c_str(), password.size(),
-                                      temp_data.get(), mi_pos,
-                                      hmac, sizeof(hmac));
-  ASSERT(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
+  char computed[kStunMessageIntegritySize];
+  hmac->Update(header, kStunHeaderSize);
+  hmac->Update(data + kStunHeaderSize, mi_pos - kStunHeaderSize);
+  size_t ret = hmac->Finish(computed, sizeof(computed));
+  ASSERT(ret == sizeof(computed));
+  if (ret != sizeof(computed))
     return false;
 
   // Comparing the calculated HMAC with the one present in the message.
   return memcmp(data + current_pos + kStunAttributeHeaderSize,
-                hmac,
-                sizeof(hmac)) == 0;
+                computed,
+                sizeof(computed)) == 0;
 }
 
 bool StunMessage::AddMessageIntegrity(const std::string& password) {
@@ -211,6 +218,11 @@ bool StunMessage::AddMessageIntegrity(const std::string& password) {
 
 bool StunMessage::AddMessageIntegrity(const char* key,
                                       size_t keylen) {
+  rtc::HmacDigest hmac(rtc::DIGEST_SHA_1, key, keylen);
+  return AddMessageIntegrity(&hmac);
+}
+
+bool StunMessage::AddMessageIntegrity(rtc::HmacDigest* hmac) {
   // Add the attribute with a dummy value. Since this is a known attribute, it
   // can't fail.
   StunByteStringAttribute* msg_integrity_attr =
@@ -225,20 +237,18 @@ bool StunMessage::AddMessageIntegrity(const char* key,
 
   int msg_len_for_hmac = static_cast<int>(
       buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length());
-  char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      key, keylen,
-                                      buf.Data(), msg_len_for_hmac,
-                                      hmac, sizeof(hmac));
-  ASSERT(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
+  char computed[kStunMessageIntegritySize];
+  hmac->Update(buf.Data(), msg_len_for_hmac);
+  size_t ret = hmac->Finish(computed, sizeof(computed));
+  ASSERT(ret == sizeof(computed));
+  if (ret != sizeof(computed)) {
     LOG(LS_ERROR) << "HMAC computation failed. Message-Integrity "
                   << "has dummy value.";
     return false;
   }
 
   // Insert correct HMAC into the attribute.
-  msg_integrity_attr->CopyBytes(hmac, sizeof(hmac));
+  msg_integrity_attr->CopyBytes(computed, sizeof(computed));
   return true;
 }
 
@@ -306,28 +316,26 @@ bool StunMessage::Read(ByteBuffer* buf) {
   if (!buf->ReadUInt16(&length_))
     return false;
 
-  std::string magic_cookie;
-  if (!buf->ReadString(&magic_cookie, kStunMagicCookieLength))
+  // The magic cookie and transaction ID are taken straight from the buffer;
+  // if the magic cookie is invalid it means that the peer implements RFC3489
+  // instead of RFC5389, and it's part of the transaction ID.
+  if (buf->Length() < kStunMagicCookieLength + kStunTransactionIdLength)
     return false;
-
-  std::string transaction_id;
-  if (!buf->ReadString(&transaction_id, kStunTransactionIdLength))
-    return false;
-
-  uint32_t magic_cookie_int =
-      *reinterpret_cast<const uint32_t*>(magic_cookie.data());
-  if (rtc::NetworkToHost32(magic_cookie_int) != kStunMagicCookie) {
-    // If magic cookie is invalid it means that the peer implements
-    // RFC3489 instead of RFC5389.
-    transaction_id.insert(0, magic_cookie);
+  const char* magic_cookie = buf->Data();
+  if (rtc::GetBE32(magic_cookie) == kStunMagicCookie) {
+    transaction_id_.assign(magic_cookie + kStunMagicCookieLength,
+                           kStunTransactionIdLength);
+  } else {
+    transaction_id_.assign(magic_cookie, kStunLegacyTransactionIdLength);
   }
-  ASSERT(IsValidTransactionId(transaction_id));
-  transaction_id_ = transaction_id;
+  buf->Consume(kStunMagicCookieLength + kStunTransactionIdLength);
+  ASSERT(IsValidTransactionId(transaction_id_));
 
   if (length_ != buf->Length())
     return false;
 
   attrs_->resize(0);
+  attrs_->reserve(CountAttributes(buf->Data(), length_));
 
   size_t rest = buf->Length() - length_;
   while (buf->Length() > rest) {
@@ -356,6 +364,20 @@ bool StunMessage::Read(ByteBuffer* buf) {
   return true;
 }
 
+size_t StunMessage::CountAttributes(const char* data, size_t length) {
+  size_t count = 0;
+  size_t pos = 0;
+  while (pos + kStunAttributeHeaderSize <= length) {
+    size_t attr_length = rtc::GetBE16(data + pos + sizeof(uint16_t));
+    if ((attr_length % 4) != 0) {
+      attr_length += (4 - (attr_length % 4));
+    }
+    pos += kStunAttributeHeaderSize + attr_length;
+    ++count;
+  }
+  return count;
+}
+
 bool StunMessage::Write(ByteBuffer* buf) const {
   buf->WriteUInt16(type_);
   buf->WriteUInt16(length_);
@@ -411,6 +433,21 @@ bool StunMessage::IsValidTransactionId(const std::string& transaction_id) {
       transaction_id.size() == kStunLegacyTransactionIdLength;
 }
 
+// StunMessageIntegrityKey
+
+StunMessageIntegrityKey::StunMessageIntegrityKey() {}
+
+StunMessageIntegrityKey::~StunMessageIntegrityKey() {}
+
+rtc::HmacDigest* StunMessageIntegrityKey::Get(const std::string& password) {
+  if (!hmac_ || password != password_) {
+    password_ = password;
+    hmac_.reset(new rtc::HmacDigest(rtc::DIGEST_SHA_1, password.data(),
+                                    password.size()));
+  }
+  return hmac_.get();
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16_t type, uint16_t length)
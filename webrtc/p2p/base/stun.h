@@ -19,8 +19,14 @@
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/base/socketaddress.h"
 
+namespace rtc {
+class HmacDigest;
+}  // namespace rtc
+
 namespace cricket {
 
 // These are the types of STUN messages defined in RFC 5389.
@@ -168,9 +174,14 @@ class StunMessage {
   // padding data (which we discard when reading a StunMessage).
   static bool ValidateMessageIntegrity(const char* data, size_t size,
                                        const std::string& password);
+  // Like the previous function, with an HMAC-SHA1 that has already been keyed
+  // with the password; see StunMessageIntegrityKey.
+  static bool ValidateMessageIntegrity(const char* data, size_t size,
+                                       rtc::HmacDigest* hmac);
   // Adds a MESSAGE-INTEGRITY attribute that is valid for the current message.
   bool AddMessageIntegrity(const std::string& password);
   bool AddMessageIntegrity(const char* key, size_t keylen);
+  bool AddMessageIntegrity(rtc::HmacDigest* hmac);
 
   // Verifies that a given buffer is STUN by checking for a correct FINGERPRINT.
   static bool ValidateFingerprint(const char* data, size_t size);
@@ -197,6 +208,9 @@ class StunMessage {
   StunAttribute* CreateAttribute(int type, size_t length) /* const*/;
   const StunAttribute* GetAttribute(int type) const;
   static bool IsValidTransactionId(const std::string& transaction_id);
+  // Returns how many attributes the |length| bytes at |data| hold, going by
+  // their headers only, so that Read can size |attrs_| up front.
+  static size_t CountAttributes(const char* data, size_t length);
 
   uint16_t type_;
   uint16_t length_;
@@ -204,6 +218,25 @@ class StunMessage {
   std::vector<StunAttribute*>* attrs_;
 };
 
+// Keeps the HMAC for MESSAGE-INTEGRITY keyed with the password it was last
+// asked for. A Port or Connection signs and checks its messages with the same
+// password for most of its life, so the HMAC rarely has to be keyed again.
+class StunMessageIntegrityKey {
+ public:
+  StunMessageIntegrityKey();
+  ~StunMessageIntegrityKey();
+
+  // Returns the HMAC keyed with |password|. It stays owned by this object and
+  // is valid until the next call.
+  rtc::HmacDigest* Get(const std::string& password);
+
+ private:
+  std::string password_;
+  rtc::scoped_ptr<rtc::HmacDigest> hmac_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StunMessageIntegrityKey);
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
@@ -1202,6 +1202,52 @@ TEST_F(StunTest, ValidateMessageIntegrity) {
   }
 }
 
+// Check that messages signed with keys longer than the HMAC block, which are
+// hashed first, validate in place.
+TEST_F(StunTest, ValidateMessageIntegrityWithLongKey) {
+  const std::string kLongKey(100, 'k');
+  StunMessage msg;
+  msg.SetType(STUN_BINDING_REQUEST);
+  msg.SetTransactionID("0123456789ab");
+  EXPECT_TRUE(msg.AddAttribute(new StunByteStringAttribute(
+      STUN_ATTR_USERNAME, "username")));
+  EXPECT_TRUE(msg.AddMessageIntegrity(kLongKey));
+  EXPECT_TRUE(msg.AddFingerprint());
+
+  rtc::ByteBuffer buf;
+  EXPECT_TRUE(msg.Write(&buf));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    kLongKey));
+  EXPECT_FALSE(StunMessage::ValidateMessageIntegrity(
+      buf.Data(), buf.Length(), kLongKey.substr(1)));
+}
+
+// The cached key signs and validates the same as the password itself, and
+// follows password changes.
+TEST_F(StunTest, MessageIntegrityKeyCache) {
+  StunMessageIntegrityKey key;
+  StunMessage msg;
+  msg.SetType(STUN_BINDING_REQUEST);
+  msg.SetTransactionID("0123456789ab");
+  EXPECT_TRUE(msg.AddAttribute(new StunByteStringAttribute(
+      STUN_ATTR_USERNAME, "username")));
+  EXPECT_TRUE(msg.AddMessageIntegrity(key.Get("password")));
+
+  rtc::ByteBuffer buf;
+  EXPECT_TRUE(msg.Write(&buf));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    "password"));
+  // Validate twice to make sure the cached state isn't consumed.
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    key.Get("password")));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    key.Get("password")));
+  EXPECT_FALSE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                     key.Get("other")));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(buf.Data(), buf.Length(),
+                                                    key.Get("password")));
+}
+
 // Validate that we generate correct MESSAGE-INTEGRITY attributes.
 // Note the use of IceMessage instead of StunMessage; this is necessary because
 // the RFC5769 test messages used include attributes not found in basic STUN.
@@ -10,12 +10,18 @@
 
 #include "webrtc/p2p/base/stunserver.h"
 
+#include <string.h>
+
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/byteorder.h"
 #include "webrtc/base/logging.h"
 
 namespace cricket {
 
-StunServer::StunServer(rtc::AsyncUDPSocket* socket) : socket_(socket) {
+const size_t StunServer::kMaxBindingResponseSize;
+
+StunServer::StunServer(rtc::AsyncUDPSocket* socket)
+    : socket_(socket), fast_binding_responses_(false) {
   socket_->SignalReadPacket.connect(this, &StunServer::OnPacket);
 }
 
@@ -27,6 +33,18 @@ void StunServer::OnPacket(
     rtc::AsyncPacketSocket* socket, const char* buf, size_t size,
     const rtc::SocketAddress& remote_addr,
     const rtc::PacketTime& packet_time) {
+  if (fast_binding_responses_) {
+    char response[kMaxBindingResponseSize];
+    size_t response_size =
+        WriteBindingResponse(buf, size, remote_addr, response);
+    if (response_size > 0) {
+      rtc::PacketOptions options;
+      if (socket_->SendTo(response, response_size, remote_addr, options) < 0)
+        LOG_ERR(LS_ERROR) << "sendto";
+      return;
+    }
+  }
+
   // Parse the STUN message; eat any messages that fail to parse.
   rtc::ByteBuffer bbuf(buf, size);
   StunMessage msg;
@@ -86,8 +104,9 @@ void StunServer::GetStunBindReqponse(StunMessage* request,
   response->SetTransactionID(request->transaction_id());
 
   // Tell the user the address that we received their request from.
+  // RFC 3489 clients don't know XOR-MAPPED-ADDRESS.
   StunAddressAttribute* mapped_addr;
-  if (!request->IsLegacy()) {
+  if (request->IsLegacy()) {
     mapped_addr = StunAttribute::CreateAddress(STUN_ATTR_MAPPED_ADDRESS);
   } else {
     mapped_addr = StunAttribute::CreateXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
@@ -96,4 +115,76 @@ void StunServer::GetStunBindReqponse(StunMessage* request,
   response->AddAttribute(mapped_addr);
 }
 
+size_t StunServer::WriteBindingResponse(const char* request,
+                                        size_t request_size,
+                                        const rtc::SocketAddress& remote_addr,
+                                        char* response) {
+  if (request_size < kStunHeaderSize || request_size % 4 != 0 ||
+      rtc::GetBE16(request) != STUN_BINDING_REQUEST ||
+      rtc::GetBE16(request + 2) != request_size - kStunHeaderSize ||
+      rtc::GetBE32(request + 4) != kStunMagicCookie) {
+    return 0;
+  }
+
+  // The attributes must fill the message exactly, and a FINGERPRINT must be
+  // the last one.
+  size_t offset = kStunHeaderSize;
+  while (offset < request_size) {
+    if (offset + kStunAttributeHeaderSize > request_size)
+      return 0;
+    uint16_t attr_type = rtc::GetBE16(request + offset);
+    size_t attr_length = rtc::GetBE16(request + offset + 2);
+    offset += kStunAttributeHeaderSize + ((attr_length + 3) & ~3);
+    if (offset > request_size)
+      return 0;
+    if (attr_type == STUN_ATTR_FINGERPRINT &&
+        (offset != request_size ||
+         !StunMessage::ValidateFingerprint(request, request_size))) {
+      return 0;
+    }
+  }
+
+  const rtc::IPAddress& ip = remote_addr.ipaddr();
+  size_t address_length;
+  uint8_t family;
+  if (ip.family() == AF_INET) {
+    address_length = 4;
+    family = STUN_ADDRESS_IPV4;
+  } else if (ip.family() == AF_INET6) {
+    address_length = 16;
+    family = STUN_ADDRESS_IPV6;
+  } else {
+    return 0;
+  }
+  const size_t attr_length = 4 + address_length;
+  const size_t response_size =
+      kStunHeaderSize + kStunAttributeHeaderSize + attr_length;
+
+  // The header repeats the cookie and transaction ID of the request.
+  rtc::SetBE16(response, STUN_BINDING_RESPONSE);
+  rtc::SetBE16(response + 2,
+               static_cast<uint16_t>(response_size - kStunHeaderSize));
+  memcpy(response + 4, request + 4, kStunHeaderSize - 4);
+
+  // XOR-MAPPED-ADDRESS, XORed with the cookie and, for IPv6, the transaction
+  // ID, which follow each other in the header.
+  char* attr = response + kStunHeaderSize;
+  rtc::SetBE16(attr, STUN_ATTR_XOR_MAPPED_ADDRESS);
+  rtc::SetBE16(attr + 2, static_cast<uint16_t>(attr_length));
+  attr[4] = 0;
+  attr[5] = family;
+  rtc::SetBE16(attr + 6, remote_addr.port() ^ (kStunMagicCookie >> 16));
+  char* xored_ip = attr + 8;
+  if (ip.family() == AF_INET) {
+    in_addr v4addr = ip.ipv4_address();
+    memcpy(xored_ip, &v4addr, address_length);
+  } else {
+    in6_addr v6addr = ip.ipv6_address();
+    memcpy(xored_ip, &v6addr, address_length);
+  }
+  for (size_t i = 0; i < address_length; ++i)
+    xored_ip[i] ^= response[4 + i];
+  return response_size;
+}
+
 }  // namespace cricket
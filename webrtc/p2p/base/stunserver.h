@@ -21,11 +21,34 @@ const int STUN_SERVER_PORT = 3478;
 
 class StunServer : public sigslot::has_slots<> {
  public:
+  // Large enough for a binding response with an IPv6 XOR-MAPPED-ADDRESS.
+  static const size_t kMaxBindingResponseSize =
+      kStunHeaderSize + kStunAttributeHeaderSize + 20;
+
   // Creates a STUN server, which will listen on the given socket.
   explicit StunServer(rtc::AsyncUDPSocket* socket);
   // Removes the STUN server from the socket and deletes the socket.
   ~StunServer();
 
+  // Answers RFC 5389 binding requests straight from the received bytes, with
+  // WriteBindingResponse(), instead of parsing them into a StunMessage.
+  // Requests answered this way don't reach OnBindingRequest(), so this can't
+  // be used by subclasses that override it. Disabled by default.
+  void set_fast_binding_responses(bool enable) {
+    fast_binding_responses_ = enable;
+  }
+
+  // Writes the binding response to |request| into |response|, which must
+  // have room for kMaxBindingResponseSize bytes. The request header and the
+  // attribute lengths are checked, as is the FINGERPRINT, if there is one.
+  // Other attributes are ignored, as OnBindingRequest() does. Returns the
+  // size of the response, or 0 if |request| isn't an RFC 5389 binding request
+  // or is malformed.
+  static size_t WriteBindingResponse(const char* request,
+                                     size_t request_size,
+                                     const rtc::SocketAddress& remote_addr,
+                                     char* response);
+
  protected:
   // Slot for AsyncSocket.PacketRead:
   void OnPacket(
@@ -59,6 +82,7 @@ class StunServer : public sigslot::has_slots<> {
 
  private:
   rtc::scoped_ptr<rtc::AsyncUDPSocket> socket_;
+  bool fast_binding_responses_;
 };
 
 }  // namespace cricket
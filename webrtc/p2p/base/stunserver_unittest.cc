@@ -49,6 +49,9 @@ class StunServerTest : public testing::Test {
   bool ReceiveFails() {
     return(client_->CheckNoPacket());
   }
+  void EnableFastBindingResponses() {
+    server_->set_fast_binding_responses(true);
+  }
   StunMessage* Receive() {
     StunMessage* msg = NULL;
     rtc::TestClient::Packet* packet =
@@ -100,6 +103,24 @@ TEST_F(StunServerTest, TestGood) {
   delete msg;
 }
 
+TEST_F(StunServerTest, TestGoodWithFastBindingResponses) {
+  EnableFastBindingResponses();
+  StunMessage req;
+  req.SetType(STUN_BINDING_REQUEST);
+  req.SetTransactionID("0123456789ab");
+  req.AddFingerprint();
+  Send(req);
+
+  rtc::scoped_ptr<StunMessage> msg(Receive());
+  ASSERT_TRUE(msg);
+  EXPECT_EQ(STUN_BINDING_RESPONSE, msg->type());
+  EXPECT_EQ(req.transaction_id(), msg->transaction_id());
+  const StunAddressAttribute* mapped_addr =
+      msg->GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+  ASSERT_TRUE(mapped_addr != NULL);
+  EXPECT_EQ(client_addr.port(), mapped_addr->port());
+}
+
 #endif // if !defined(THREAD_SANITIZER)
 
 TEST_F(StunServerTest, TestBad) {
@@ -110,3 +131,84 @@ TEST_F(StunServerTest, TestBad) {
 
   ASSERT_TRUE(ReceiveFails());
 }
+
+// The fast path must answer exactly as a StunMessage would.
+TEST(StunServerWriteBindingResponseTest, MatchesStunMessage) {
+  const rtc::SocketAddress addrs[] = {
+      rtc::SocketAddress("1.2.3.4", 1234),
+      rtc::SocketAddress("2001:db8::1", 5678)};
+  for (const rtc::SocketAddress& addr : addrs) {
+    for (bool fingerprint : {false, true}) {
+      StunMessage req;
+      req.SetType(STUN_BINDING_REQUEST);
+      req.SetTransactionID("0123456789ab");
+      // Odd-sized, so the attribute is padded.
+      StunByteStringAttribute* username =
+          StunAttribute::CreateByteString(STUN_ATTR_USERNAME);
+      username->CopyBytes("abc");
+      req.AddAttribute(username);
+      if (fingerprint)
+        req.AddFingerprint();
+      rtc::ByteBuffer req_buf;
+      req.Write(&req_buf);
+
+      StunMessage expected;
+      expected.SetType(STUN_BINDING_RESPONSE);
+      expected.SetTransactionID(req.transaction_id());
+      StunAddressAttribute* mapped_addr =
+          StunAttribute::CreateXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+      mapped_addr->SetAddress(addr);
+      expected.AddAttribute(mapped_addr);
+      rtc::ByteBuffer expected_buf;
+      expected.Write(&expected_buf);
+
+      char response[StunServer::kMaxBindingResponseSize];
+      size_t response_size = StunServer::WriteBindingResponse(
+          req_buf.Data(), req_buf.Length(), addr, response);
+      ASSERT_EQ(expected_buf.Length(), response_size);
+      EXPECT_EQ(0, memcmp(expected_buf.Data(), response, response_size));
+    }
+  }
+}
+
+TEST(StunServerWriteBindingResponseTest, RejectsOtherMessages) {
+  const rtc::SocketAddress addr("1.2.3.4", 1234);
+  char response[StunServer::kMaxBindingResponseSize];
+
+  // Legacy RFC 3489 request.
+  StunMessage legacy;
+  legacy.SetType(STUN_BINDING_REQUEST);
+  legacy.SetTransactionID("0123456789abcdef");
+  rtc::ByteBuffer legacy_buf;
+  legacy.Write(&legacy_buf);
+  EXPECT_EQ(0u, StunServer::WriteBindingResponse(
+                    legacy_buf.Data(), legacy_buf.Length(), addr, response));
+
+  // Not a binding request.
+  StunMessage allocate;
+  allocate.SetType(STUN_ALLOCATE_REQUEST);
+  allocate.SetTransactionID("0123456789ab");
+  rtc::ByteBuffer allocate_buf;
+  allocate.Write(&allocate_buf);
+  EXPECT_EQ(0u, StunServer::WriteBindingResponse(
+                    allocate_buf.Data(), allocate_buf.Length(), addr,
+                    response));
+
+  // Corrupt fingerprint.
+  StunMessage req;
+  req.SetType(STUN_BINDING_REQUEST);
+  req.SetTransactionID("0123456789ab");
+  req.AddFingerprint();
+  rtc::ByteBuffer req_buf;
+  req.Write(&req_buf);
+  std::string corrupt(req_buf.Data(), req_buf.Length());
+  corrupt[corrupt.size() - 1] ^= 1;
+  EXPECT_EQ(0u, StunServer::WriteBindingResponse(
+                    corrupt.data(), corrupt.size(), addr, response));
+
+  // Attribute running past the end of the message.
+  std::string truncated(req_buf.Data(), req_buf.Length() - 4);
+  truncated[3] = static_cast<char>(truncated.size() - kStunHeaderSize);
+  EXPECT_EQ(0u, StunServer::WriteBindingResponse(
+                    truncated.data(), truncated.size(), addr, response));
+}
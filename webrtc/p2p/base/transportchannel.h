@@ -140,8 +140,8 @@ class TransportChannel : public sigslot::has_slots<> {
                                     size_t result_len) = 0;
 
   // Signalled each time a packet is received on this channel.
-  sigslot::signal5<TransportChannel*, const char*,
-                   size_t, const rtc::PacketTime&, int> SignalReadPacket;
+  sigslot::fast_signal5<TransportChannel*, const char*,
+                        size_t, const rtc::PacketTime&, int> SignalReadPacket;
 
   // Signalled each time a packet is sent on this channel.
   sigslot::signal2<TransportChannel*, const rtc::SentPacket&> SignalSentPacket;
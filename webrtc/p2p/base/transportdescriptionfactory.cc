@@ -93,12 +93,12 @@ TransportDescription* TransportDescriptionFactory::CreateAnswer(
   return desc.release();
 }
 
-bool TransportDescriptionFactory::SetSecurityInfo(
-    TransportDescription* desc, ConnectionRole role) const {
-  if (!certificate_) {
-    LOG(LS_ERROR) << "Cannot create identity digest with no certificate";
-    return false;
-  }
+void TransportDescriptionFactory::set_certificate(
+    const rtc::scoped_refptr<rtc::RTCCertificate>& certificate) {
+  certificate_ = certificate;
+  fingerprint_.reset();
+  if (!certificate_)
+    return;
 
   // This digest algorithm is used to produce the a=fingerprint lines in SDP.
   // RFC 4572 Section 5 requires that those lines use the same hash function as
@@ -107,17 +107,30 @@ bool TransportDescriptionFactory::SetSecurityInfo(
   if (!certificate_->ssl_certificate().GetSignatureDigestAlgorithm(
           &digest_alg)) {
     LOG(LS_ERROR) << "Failed to retrieve the certificate's digest algorithm";
-    return false;
+    return;
   }
 
-  desc->identity_fingerprint.reset(
+  fingerprint_.reset(
       rtc::SSLFingerprint::Create(digest_alg, certificate_->identity()));
-  if (!desc->identity_fingerprint.get()) {
+  if (!fingerprint_) {
     LOG(LS_ERROR) << "Failed to create identity fingerprint, alg="
                   << digest_alg;
+  }
+}
+
+bool TransportDescriptionFactory::SetSecurityInfo(
+    TransportDescription* desc, ConnectionRole role) const {
+  if (!certificate_) {
+    LOG(LS_ERROR) << "Cannot create identity digest with no certificate";
+    return false;
+  }
+  if (!fingerprint_) {
+    LOG(LS_ERROR) << "The certificate has no identity fingerprint";
     return false;
   }
 
+  desc->identity_fingerprint.reset(new rtc::SSLFingerprint(*fingerprint_));
+
   // Assign security role.
   desc->connection_role = role;
   return true;
@@ -42,10 +42,10 @@ class TransportDescriptionFactory {
   // Specifies the transport security policy to use.
   void set_secure(SecurePolicy s) { secure_ = s; }
   // Specifies the certificate to use (only used when secure != SEC_DISABLED).
+  // Its fingerprint is computed here once rather than for every transport
+  // description.
   void set_certificate(
-      const rtc::scoped_refptr<rtc::RTCCertificate>& certificate) {
-    certificate_ = certificate;
-  }
+      const rtc::scoped_refptr<rtc::RTCCertificate>& certificate);
 
   // Creates a transport description suitable for use in an offer.
   TransportDescription* CreateOffer(const TransportOptions& options,
@@ -62,6 +62,8 @@ class TransportDescriptionFactory {
 
   SecurePolicy secure_;
   rtc::scoped_refptr<rtc::RTCCertificate> certificate_;
+  // Fingerprint of |certificate_|, or null if it couldn't be computed.
+  rtc::scoped_ptr<rtc::SSLFingerprint> fingerprint_;
 };
 
 }  // namespace cricket
@@ -140,6 +140,22 @@ TEST_F(TransportDescriptionFactoryTest, TestOfferDtls) {
   CheckDesc(desc.get(), "", "", "", digest_alg);
 }
 
+// The fingerprint is computed when the certificate is set, so it must follow a
+// change of certificate.
+TEST_F(TransportDescriptionFactoryTest, TestOfferDtlsAfterCertificateChange) {
+  f1_.set_secure(cricket::SEC_ENABLED);
+  f1_.set_certificate(cert1_);
+  scoped_ptr<TransportDescription> offer1(f1_.CreateOffer(
+      TransportOptions(), NULL));
+  f1_.set_certificate(cert2_);
+  scoped_ptr<TransportDescription> offer2(f1_.CreateOffer(
+      TransportOptions(), NULL));
+  ASSERT_TRUE(offer1->identity_fingerprint.get() != NULL);
+  ASSERT_TRUE(offer2->identity_fingerprint.get() != NULL);
+  EXPECT_NE(offer1->identity_fingerprint->GetRfc4572Fingerprint(),
+            offer2->identity_fingerprint->GetRfc4572Fingerprint());
+}
+
 // Test generating an offer with DTLS fails with no identity.
 TEST_F(TransportDescriptionFactoryTest, TestOfferDtlsWithNoIdentity) {
   f1_.set_secure(cricket::SEC_ENABLED);
@@ -15,6 +15,7 @@
 #include "webrtc/p2p/base/common.h"
 #include "webrtc/p2p/base/stun.h"
 #include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/logging.h"
@@ -177,6 +178,8 @@ class TurnEntry : public sigslot::has_slots<> {
   // event actually fires, the TurnEntry will be destroyed only if the
   // timestamp here matches the one in the firing event.
   uint32_t destruction_timestamp_ = 0;
+  // Reused for every packet sent, so that sending doesn't allocate.
+  rtc::Buffer send_buffer_;
 };
 
 TurnPort::TurnPort(rtc::Thread* thread,
@@ -1413,7 +1416,7 @@ void TurnEntry::SendChannelBindRequest(int delay) {
 
 int TurnEntry::Send(const void* data, size_t size, bool payload,
                     const rtc::PacketOptions& options) {
-  rtc::ByteBuffer buf;
+  rtc::ByteBuffer buf(&send_buffer_);
   if (state_ != STATE_BOUND) {
     // If we haven't bound the channel yet, we have to use a Send Indication.
     TurnMessage msg;
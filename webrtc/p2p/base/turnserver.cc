@@ -10,6 +10,8 @@
 
 #include "webrtc/p2p/base/turnserver.h"
 
+#include <algorithm>
+
 #include "webrtc/p2p/base/asyncstuntcpsocket.h"
 #include "webrtc/p2p/base/common.h"
 #include "webrtc/p2p/base/packetsocketfactory.h"
@@ -21,6 +23,7 @@
 #include "webrtc/base/socketadapters.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 namespace cricket {
 
@@ -48,49 +51,7 @@ inline bool IsTurnChannelData(uint16_t msg_type) {
 // IDs used for posted messages for TurnServerAllocation.
 enum {
   MSG_ALLOCATION_TIMEOUT,
-};
-
-// Encapsulates a TURN permission.
-// The object is created when a create permission request is received by an
-// allocation, and self-deletes when its lifetime timer expires.
-class TurnServerAllocation::Permission : public rtc::MessageHandler {
- public:
-  Permission(rtc::Thread* thread, const rtc::IPAddress& peer);
-  ~Permission();
-
-  const rtc::IPAddress& peer() const { return peer_; }
-  void Refresh();
-
-  sigslot::signal1<Permission*> SignalDestroyed;
-
- private:
-  virtual void OnMessage(rtc::Message* msg);
-
-  rtc::Thread* thread_;
-  rtc::IPAddress peer_;
-};
-
-// Encapsulates a TURN channel binding.
-// The object is created when a channel bind request is received by an
-// allocation, and self-deletes when its lifetime timer expires.
-class TurnServerAllocation::Channel : public rtc::MessageHandler {
- public:
-  Channel(rtc::Thread* thread, int id,
-                     const rtc::SocketAddress& peer);
-  ~Channel();
-
-  int id() const { return id_; }
-  const rtc::SocketAddress& peer() const { return peer_; }
-  void Refresh();
-
-  sigslot::signal1<Channel*> SignalDestroyed;
-
- private:
-  virtual void OnMessage(rtc::Message* msg);
-
-  rtc::Thread* thread_;
-  int id_;
-  rtc::SocketAddress peer_;
+  MSG_EXPIRY_TIMEOUT,
 };
 
 static bool InitResponse(const StunMessage* req, StunMessage* resp) {
@@ -495,8 +456,13 @@ void TurnServer::SendStun(TurnServerConnection* conn, StunMessage* msg) {
 
 void TurnServer::Send(TurnServerConnection* conn,
                       const rtc::ByteBuffer& buf) {
+  Send(conn, buf.Data(), buf.Length());
+}
+
+void TurnServer::Send(TurnServerConnection* conn,
+                      const char* data, size_t size) {
   rtc::PacketOptions options;
-  conn->socket()->SendTo(buf.Data(), buf.Length(), conn->src(), options);
+  conn->socket()->SendTo(data, size, conn->src(), options);
 }
 
 void TurnServer::OnAllocationDestroyed(TurnServerAllocation* allocation) {
@@ -540,7 +506,11 @@ bool TurnServerConnection::operator==(const TurnServerConnection& c) const {
 }
 
 bool TurnServerConnection::operator<(const TurnServerConnection& c) const {
-  return src_ < c.src_ || dst_ < c.dst_ || proto_ < c.proto_;
+  if (src_ != c.src_)
+    return src_ < c.src_;
+  if (dst_ != c.dst_)
+    return dst_ < c.dst_;
+  return proto_ < c.proto_;
 }
 
 std::string TurnServerConnection::ToString() const {
@@ -561,21 +531,14 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
       thread_(thread),
       conn_(conn),
       external_socket_(socket),
-      key_(key) {
+      key_(key),
+      expiry_timer_pending_(false) {
   external_socket_->SignalReadPacket.connect(
       this, &TurnServerAllocation::OnExternalPacket);
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    delete *it;
-  }
-  for (PermissionList::iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    delete *it;
-  }
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
+  thread_->Clear(this);
   LOG_J(LS_INFO, this) << "Allocation destroyed";
 }
 
@@ -745,12 +708,9 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
 
   // Add or refresh this channel.
   if (!channel1) {
-    channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
-    channel1->SignalDestroyed.connect(this,
-        &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    AddChannel(channel_id, peer_attr->GetAddress());
   } else {
-    channel1->Refresh();
+    RefreshChannel(channel1);
   }
 
   // Channel binds also refresh permissions.
@@ -766,13 +726,19 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
 }
 
 void TurnServerAllocation::HandleChannelData(const char* data, size_t size) {
-  // Extract the channel number from the data.
+  // Extract the channel number and length from the data.
   uint16_t channel_id = rtc::GetBE16(data);
+  uint16_t length = rtc::GetBE16(data + 2);
   Channel* channel = FindChannel(channel_id);
   if (channel) {
-    // Send the data to the peer address.
-    SendExternal(data + TURN_CHANNEL_HEADER_SIZE,
-                 size - TURN_CHANNEL_HEADER_SIZE, channel->peer());
+    // The message may be padded, so forward only |length| bytes.
+    if (length > size - TURN_CHANNEL_HEADER_SIZE) {
+      LOG_J(LS_WARNING, this) << "Received truncated channel data, id="
+                              << channel_id;
+      return;
+    }
+    // Send the data to the peer address, straight from the receive buffer.
+    SendExternal(data + TURN_CHANNEL_HEADER_SIZE, length, channel->peer);
   } else {
     LOG_J(LS_WARNING, this) << "Received channel data for invalid channel, id="
                             << channel_id;
@@ -788,8 +754,17 @@ void TurnServerAllocation::OnExternalPacket(
   Channel* channel = FindChannel(addr);
   if (channel) {
     // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBuffer buf;
-    buf.WriteUInt16(channel->id());
+    if (socket->GetReceiveHeadroom() >= TURN_CHANNEL_HEADER_SIZE) {
+      // Prepend the channel header in the socket's receive buffer, which
+      // saves copying the packet.
+      char* message = const_cast<char*>(data) - TURN_CHANNEL_HEADER_SIZE;
+      rtc::SetBE16(message, static_cast<uint16_t>(channel->id));
+      rtc::SetBE16(message + 2, static_cast<uint16_t>(size));
+      server_->Send(&conn_, message, TURN_CHANNEL_HEADER_SIZE + size);
+      return;
+    }
+    rtc::ByteBuffer buf(&channel_data_buffer_);
+    buf.WriteUInt16(channel->id);
     buf.WriteUInt16(static_cast<uint16_t>(size));
     buf.WriteBytes(data, size);
     server_->Send(&conn_, buf);
@@ -820,50 +795,88 @@ int TurnServerAllocation::ComputeLifetime(const TurnMessage* msg) {
   return lifetime;
 }
 
-bool TurnServerAllocation::HasPermission(const rtc::IPAddress& addr) {
-  return (FindPermission(addr) != NULL);
+bool TurnServerAllocation::HasPermission(const rtc::IPAddress& addr) const {
+  return perms_.find(addr) != perms_.end();
 }
 
 void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
-  Permission* perm = FindPermission(addr);
-  if (!perm) {
-    perm = new Permission(thread_, addr);
-    perm->SignalDestroyed.connect(
-        this, &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
-  } else {
-    perm->Refresh();
-  }
+  uint32_t expires = rtc::TimeAfter(kPermissionTimeout);
+  perms_[addr] = expires;
+  perm_expiry_.push_back(std::make_pair(addr, expires));
+  ScheduleExpiry();
 }
 
-TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
-    const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
+    int channel_id) {
+  ChannelMap::iterator it = channels_.find(channel_id);
+  return (it != channels_.end()) ? &it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
-    int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
+    const rtc::SocketAddress& addr) {
+  ChannelIdMap::const_iterator it = channel_ids_.find(addr);
+  return (it != channel_ids_.end()) ? FindChannel(it->second) : NULL;
+}
+
+void TurnServerAllocation::AddChannel(int channel_id,
+                                      const rtc::SocketAddress& peer) {
+  uint32_t expires = rtc::TimeAfter(kChannelTimeout);
+  channels_.insert(
+      std::make_pair(channel_id, Channel(channel_id, peer, expires)));
+  channel_ids_[peer] = channel_id;
+  channel_expiry_.push_back(std::make_pair(channel_id, expires));
+  ScheduleExpiry();
+}
+
+void TurnServerAllocation::RefreshChannel(Channel* channel) {
+  channel->expires = rtc::TimeAfter(kChannelTimeout);
+  channel_expiry_.push_back(std::make_pair(channel->id, channel->expires));
+  ScheduleExpiry();
+}
+
+void TurnServerAllocation::ExpirePermissionsAndChannels() {
+  uint32_t now = rtc::Time();
+  while (!perm_expiry_.empty() &&
+         rtc::TimeIsLaterOrEqual(perm_expiry_.front().second, now)) {
+    PermissionMap::iterator it = perms_.find(perm_expiry_.front().first);
+    if (it != perms_.end() && it->second == perm_expiry_.front().second) {
+      LOG_J(LS_INFO, this) << "Permission expired, peer=" << it->first;
+      perms_.erase(it);
+    }
+    perm_expiry_.pop_front();
+  }
+  while (!channel_expiry_.empty() &&
+         rtc::TimeIsLaterOrEqual(channel_expiry_.front().second, now)) {
+    ChannelMap::iterator it = channels_.find(channel_expiry_.front().first);
+    if (it != channels_.end() &&
+        it->second.expires == channel_expiry_.front().second) {
+      LOG_J(LS_INFO, this) << "Channel expired, id=" << it->first;
+      channel_ids_.erase(it->second.peer);
+      channels_.erase(it);
+    }
+    channel_expiry_.pop_front();
   }
-  return NULL;
 }
 
-TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
-    const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
+void TurnServerAllocation::ScheduleExpiry() {
+  // Entries are only ever added with a later expiry than those ahead of
+  // them, so a single pending timer for the earliest one is enough.
+  if (expiry_timer_pending_ ||
+      (perm_expiry_.empty() && channel_expiry_.empty())) {
+    return;
   }
-  return NULL;
+  uint32_t next;
+  if (perm_expiry_.empty()) {
+    next = channel_expiry_.front().second;
+  } else if (channel_expiry_.empty()) {
+    next = perm_expiry_.front().second;
+  } else {
+    next = rtc::TimeMin(perm_expiry_.front().second,
+                        channel_expiry_.front().second);
+  }
+  thread_->PostDelayed(std::max(0, rtc::TimeUntil(next)), this,
+                       MSG_EXPIRY_TIMEOUT);
+  expiry_timer_pending_ = true;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -888,61 +901,12 @@ void TurnServerAllocation::SendExternal(const void* data, size_t size,
 }
 
 void TurnServerAllocation::OnMessage(rtc::Message* msg) {
-  ASSERT(msg->message_id == MSG_ALLOCATION_TIMEOUT);
-  SignalDestroyed(this);
-  delete this;
-}
-
-void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  ASSERT(it != perms_.end());
-  perms_.erase(it);
-}
-
-void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  ASSERT(it != channels_.end());
-  channels_.erase(it);
-}
-
-TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
-                                   const rtc::IPAddress& peer)
-    : thread_(thread), peer_(peer) {
-  Refresh();
-}
-
-TurnServerAllocation::Permission::~Permission() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-}
-
-void TurnServerAllocation::Permission::Refresh() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-  thread_->PostDelayed(kPermissionTimeout, this, MSG_ALLOCATION_TIMEOUT);
-}
-
-void TurnServerAllocation::Permission::OnMessage(rtc::Message* msg) {
-  ASSERT(msg->message_id == MSG_ALLOCATION_TIMEOUT);
-  SignalDestroyed(this);
-  delete this;
-}
-
-TurnServerAllocation::Channel::Channel(rtc::Thread* thread, int id,
-                             const rtc::SocketAddress& peer)
-    : thread_(thread), id_(id), peer_(peer) {
-  Refresh();
-}
-
-TurnServerAllocation::Channel::~Channel() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-}
-
-void TurnServerAllocation::Channel::Refresh() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-  thread_->PostDelayed(kChannelTimeout, this, MSG_ALLOCATION_TIMEOUT);
-}
-
-void TurnServerAllocation::Channel::OnMessage(rtc::Message* msg) {
+  if (msg->message_id == MSG_EXPIRY_TIMEOUT) {
+    expiry_timer_pending_ = false;
+    ExpirePermissionsAndChannels();
+    ScheduleExpiry();
+    return;
+  }
   ASSERT(msg->message_id == MSG_ALLOCATION_TIMEOUT);
   SignalDestroyed(this);
   delete this;
@@ -11,13 +11,17 @@
 #ifndef WEBRTC_P2P_BASE_TURNSERVER_H_
 #define WEBRTC_P2P_BASE_TURNSERVER_H_
 
-#include <list>
+#include <deque>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "webrtc/p2p/base/portinterface.h"
 #include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/ipaddress.h"
 #include "webrtc/base/messagequeue.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socketaddress.h"
@@ -88,10 +92,35 @@ class TurnServerAllocation : public rtc::MessageHandler,
   sigslot::signal1<TurnServerAllocation*> SignalDestroyed;
 
  private:
-  class Channel;
-  class Permission;
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  struct Channel {
+    Channel(int id, const rtc::SocketAddress& peer, uint32_t expires)
+        : id(id), peer(peer), expires(expires) {}
+    int id;
+    rtc::SocketAddress peer;
+    uint32_t expires;
+  };
+  struct IPAddressHash {
+    size_t operator()(const rtc::IPAddress& ip) const {
+      return rtc::HashIP(ip);
+    }
+  };
+  struct SocketAddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  // Maps each permitted peer to the time its permission expires.
+  typedef std::unordered_map<rtc::IPAddress, uint32_t, IPAddressHash>
+      PermissionMap;
+  typedef std::unordered_map<int, Channel> ChannelMap;
+  typedef std::unordered_map<rtc::SocketAddress, int, SocketAddressHash>
+      ChannelIdMap;
+  // Keys in the order they were added or refreshed, with their expiry time
+  // at that point. All permissions (and all channels) share one lifetime,
+  // so this is also the order in which they expire. A refresh leaves the
+  // old entry behind; it no longer matches the map and is skipped.
+  typedef std::deque<std::pair<rtc::IPAddress, uint32_t> > PermissionQueue;
+  typedef std::deque<std::pair<int, uint32_t> > ChannelQueue;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -105,11 +134,12 @@ class TurnServerAllocation : public rtc::MessageHandler,
                         const rtc::PacketTime& packet_time);
 
   static int ComputeLifetime(const TurnMessage* msg);
-  bool HasPermission(const rtc::IPAddress& addr);
+  bool HasPermission(const rtc::IPAddress& addr) const;
   void AddPermission(const rtc::IPAddress& addr);
-  Permission* FindPermission(const rtc::IPAddress& addr) const;
-  Channel* FindChannel(int channel_id) const;
-  Channel* FindChannel(const rtc::SocketAddress& addr) const;
+  Channel* FindChannel(int channel_id);
+  Channel* FindChannel(const rtc::SocketAddress& addr);
+  void AddChannel(int channel_id, const rtc::SocketAddress& peer);
+  void RefreshChannel(Channel* channel);
 
   void SendResponse(TurnMessage* msg);
   void SendBadRequestResponse(const TurnMessage* req);
@@ -118,8 +148,10 @@ class TurnServerAllocation : public rtc::MessageHandler,
   void SendExternal(const void* data, size_t size,
                     const rtc::SocketAddress& peer);
 
-  void OnPermissionDestroyed(Permission* perm);
-  void OnChannelDestroyed(Channel* channel);
+  // Drops the permissions and channels that have expired, and arms the
+  // timer for the next one to expire.
+  void ExpirePermissionsAndChannels();
+  void ScheduleExpiry();
   virtual void OnMessage(rtc::Message* msg);
 
   TurnServer* server_;
@@ -131,8 +163,15 @@ class TurnServerAllocation : public rtc::MessageHandler,
   std::string username_;
   std::string origin_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  PermissionQueue perm_expiry_;
+  ChannelMap channels_;
+  ChannelIdMap channel_ids_;
+  ChannelQueue channel_expiry_;
+  bool expiry_timer_pending_;
+  // Used to relay channel messages to the client when |external_socket_|
+  // leaves no room to prepend the channel header in place.
+  rtc::Buffer channel_data_buffer_;
 };
 
 // An interface through which the MD5 credential hash can be retrieved.
@@ -242,6 +281,7 @@ class TurnServer : public sigslot::has_slots<> {
 
   void SendStun(TurnServerConnection* conn, StunMessage* msg);
   void Send(TurnServerConnection* conn, const rtc::ByteBuffer& buf);
+  void Send(TurnServerConnection* conn, const char* data, size_t size);
 
   void OnAllocationDestroyed(TurnServerAllocation* allocation);
   void DestroyInternalSocket(rtc::AsyncPacketSocket* socket);
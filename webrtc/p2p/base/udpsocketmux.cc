@@ -0,0 +1,268 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/udpsocketmux.h"
+
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
+
+namespace cricket {
+
+namespace {
+
+// Requests whose response hasn't arrived after this long are forgotten. This
+// is well beyond the last retransmission of a StunRequest.
+const int kTransactionTimeoutMs = 30 * 1000;
+
+// Returns true if |data| looks like a STUN message, and fills in its type and
+// transaction ID. Legacy STUN messages, which have no magic cookie, have a 16
+// byte transaction ID.
+bool GetStunHeader(const char* data,
+                   size_t size,
+                   int* type,
+                   std::string* transaction_id) {
+  if (size < kStunHeaderSize || (data[0] & 0xC0) != 0)
+    return false;
+  *type = rtc::GetBE16(data);
+  if (rtc::GetBE32(data + 4) == kStunMagicCookie) {
+    transaction_id->assign(data + kStunTransactionIdOffset,
+                           kStunTransactionIdLength);
+  } else {
+    transaction_id->assign(data + 4, kStunLegacyTransactionIdLength);
+  }
+  return true;
+}
+
+// Returns the local ufrag from the USERNAME of the STUN request in |data|,
+// which is of the form "<local ufrag>:<remote ufrag>".
+bool GetLocalUfrag(const char* data, size_t size, std::string* ufrag) {
+  IceMessage msg;
+  rtc::ByteBuffer buf(data, size);
+  if (!msg.Read(&buf))
+    return false;
+  const StunByteStringAttribute* username_attr =
+      msg.GetByteString(STUN_ATTR_USERNAME);
+  if (!username_attr)
+    return false;
+  const std::string& username = username_attr->GetString();
+  *ufrag = username.substr(0, username.find(':'));
+  return true;
+}
+
+}  // namespace
+
+class UdpSocketMux::Endpoint : public rtc::AsyncPacketSocket {
+ public:
+  Endpoint(UdpSocketMux* mux, const std::string& ufrag)
+      : mux_(mux), ufrag_(ufrag) {}
+  ~Endpoint() override { mux_->RemoveEndpoint(this); }
+
+  const std::string& ufrag() const { return ufrag_; }
+
+  rtc::SocketAddress GetLocalAddress() const override {
+    return mux_->GetLocalAddress();
+  }
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress();
+  }
+  int Send(const void* data,
+           size_t size,
+           const rtc::PacketOptions& options) override {
+    RTC_NOTREACHED();
+    return -1;
+  }
+  int SendTo(const void* data,
+             size_t size,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override {
+    return mux_->SendTo(this, data, size, addr, options);
+  }
+  // The shared socket stays open until the mux goes away.
+  int Close() override { return 0; }
+  State GetState() const override { return mux_->socket()->GetState(); }
+  // Note that options apply to the shared socket, and thus to all endpoints.
+  int GetOption(rtc::Socket::Option opt, int* value) override {
+    return mux_->socket()->GetOption(opt, value);
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override {
+    return mux_->socket()->SetOption(opt, value);
+  }
+  int GetError() const override { return mux_->socket()->GetError(); }
+  void SetError(int error) override { mux_->socket()->SetError(error); }
+
+ private:
+  UdpSocketMux* const mux_;
+  const std::string ufrag_;
+};
+
+UdpSocketMux::UdpSocketMux(rtc::AsyncPacketSocket* socket)
+    : socket_(socket), sending_endpoint_(nullptr) {
+  socket_->SignalReadPacket.connect(this, &UdpSocketMux::OnReadPacket);
+  socket_->SignalSentPacket.connect(this, &UdpSocketMux::OnSentPacket);
+  socket_->SignalReadyToSend.connect(this, &UdpSocketMux::OnReadyToSend);
+}
+
+UdpSocketMux::~UdpSocketMux() {
+  RTC_DCHECK(endpoints_.empty());
+}
+
+rtc::SocketAddress UdpSocketMux::GetLocalAddress() const {
+  return socket_->GetLocalAddress();
+}
+
+rtc::AsyncPacketSocket* UdpSocketMux::CreateEndpoint(
+    const std::string& ufrag) {
+  if (endpoints_.find(ufrag) != endpoints_.end()) {
+    LOG(LS_WARNING) << "UdpSocketMux: ufrag " << ufrag << " is already in use.";
+    return nullptr;
+  }
+  Endpoint* endpoint = new Endpoint(this, ufrag);
+  endpoints_[ufrag] = endpoint;
+  return endpoint;
+}
+
+int UdpSocketMux::SendTo(Endpoint* endpoint,
+                         const void* data,
+                         size_t size,
+                         const rtc::SocketAddress& addr,
+                         const rtc::PacketOptions& options) {
+  int type;
+  std::string transaction_id;
+  if (GetStunHeader(static_cast<const char*>(data), size, &type,
+                    &transaction_id) &&
+      IsStunRequestType(type)) {
+    // Remember who sent the request, so that the response, and anything else
+    // from |addr|, goes back to |endpoint|. Retransmissions keep the
+    // transaction alive.
+    uint32_t now = rtc::Time();
+    ExpireTransactions(now);
+    transactions_[transaction_id] = std::make_pair(endpoint, now);
+    transaction_times_.push_back(std::make_pair(now, transaction_id));
+    remote_addresses_[addr] = endpoint;
+    SignalStunRequestSent(this, addr);
+  }
+
+  sending_endpoint_ = endpoint;
+  int sent = socket_->SendTo(data, size, addr, options);
+  sending_endpoint_ = nullptr;
+  return sent;
+}
+
+bool UdpSocketMux::HandlePacket(const char* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                const rtc::PacketTime& packet_time) {
+  Endpoint* endpoint = FindEndpoint(data, size, remote_addr);
+  if (!endpoint)
+    return false;
+  endpoint->SignalReadPacket(endpoint, data, size, remote_addr, packet_time);
+  return true;
+}
+
+void UdpSocketMux::RemoveEndpoint(Endpoint* endpoint) {
+  endpoints_.erase(endpoint->ufrag());
+  for (AddressMap::iterator it = remote_addresses_.begin();
+       it != remote_addresses_.end();) {
+    if (it->second == endpoint)
+      remote_addresses_.erase(it++);
+    else
+      ++it;
+  }
+  for (TransactionMap::iterator it = transactions_.begin();
+       it != transactions_.end();) {
+    if (it->second.first == endpoint)
+      transactions_.erase(it++);
+    else
+      ++it;
+  }
+}
+
+UdpSocketMux::Endpoint* UdpSocketMux::FindEndpoint(
+    const char* data,
+    size_t size,
+    const rtc::SocketAddress& remote_addr) {
+  int type;
+  std::string transaction_id;
+  if (GetStunHeader(data, size, &type, &transaction_id)) {
+    if (IsStunRequestType(type)) {
+      std::string ufrag;
+      EndpointMap::iterator it;
+      if (GetLocalUfrag(data, size, &ufrag) &&
+          (it = endpoints_.find(ufrag)) != endpoints_.end()) {
+        remote_addresses_[remote_addr] = it->second;
+        return it->second;
+      }
+    } else if (IsStunSuccessResponseType(type) ||
+               IsStunErrorResponseType(type)) {
+      TransactionMap::iterator it = transactions_.find(transaction_id);
+      if (it != transactions_.end()) {
+        Endpoint* endpoint = it->second.first;
+        transactions_.erase(it);
+        return endpoint;
+      }
+    }
+  }
+
+  AddressMap::iterator it = remote_addresses_.find(remote_addr);
+  return it != remote_addresses_.end() ? it->second : nullptr;
+}
+
+void UdpSocketMux::ExpireTransactions(uint32_t now) {
+  while (!transaction_times_.empty() &&
+         rtc::TimeDiff(now, transaction_times_.front().first) >
+             kTransactionTimeoutMs) {
+    TransactionMap::iterator it =
+        transactions_.find(transaction_times_.front().second);
+    // Only forget the transaction if it wasn't retransmitted since.
+    if (it != transactions_.end() &&
+        it->second.second == transaction_times_.front().first) {
+      transactions_.erase(it);
+    }
+    transaction_times_.pop_front();
+  }
+}
+
+void UdpSocketMux::OnReadPacket(rtc::AsyncPacketSocket* socket,
+                                const char* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                const rtc::PacketTime& packet_time) {
+  RTC_DCHECK(socket == socket_.get());
+  if (HandlePacket(data, size, remote_addr, packet_time))
+    return;
+  if (SignalUnhandledPacket.is_empty()) {
+    LOG(LS_VERBOSE) << "UdpSocketMux: dropping packet from unknown address "
+                    << remote_addr.ToSensitiveString();
+    return;
+  }
+  SignalUnhandledPacket(this, data, size, remote_addr, packet_time);
+}
+
+void UdpSocketMux::OnSentPacket(rtc::AsyncPacketSocket* socket,
+                                const rtc::SentPacket& sent_packet) {
+  if (sending_endpoint_)
+    sending_endpoint_->SignalSentPacket(sending_endpoint_, sent_packet);
+}
+
+void UdpSocketMux::OnReadyToSend(rtc::AsyncPacketSocket* socket) {
+  // Endpoints may be destroyed by the signal, so walk a copy.
+  EndpointMap endpoints(endpoints_);
+  for (const auto& kv : endpoints) {
+    EndpointMap::iterator it = endpoints_.find(kv.first);
+    if (it != endpoints_.end() && it->second == kv.second)
+      kv.second->SignalReadyToSend(kv.second);
+  }
+}
+
+}  // namespace cricket
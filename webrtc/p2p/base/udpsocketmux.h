@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
+#define WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/base/socketaddress.h"
+
+namespace cricket {
+
+// Lets the UDP ports of many ICE sessions share a single UDP socket. Every
+// session gets its own endpoint, an AsyncPacketSocket that sends through the
+// shared socket and only reads the packets meant for its session:
+//  - STUN requests are given to the endpoint whose ufrag is the local part of
+//    their USERNAME,
+//  - STUN responses go to the endpoint that sent the matching request,
+//  - everything else is demultiplexed by remote address, which is learnt from
+//    the STUN requests going either way.
+// Since the remote addresses of a session are only known from its STUN
+// traffic, endpoints are meant for UDPPorts; TURN allocations can't share the
+// socket, as the server would see the same 5-tuple for every session.
+//
+// Must be used on the thread of the shared socket. Endpoints must be
+// destroyed before the mux.
+class UdpSocketMux : public sigslot::has_slots<> {
+ public:
+  // Takes ownership of |socket|.
+  explicit UdpSocketMux(rtc::AsyncPacketSocket* socket);
+  ~UdpSocketMux() override;
+
+  rtc::AsyncPacketSocket* socket() const { return socket_.get(); }
+  rtc::SocketAddress GetLocalAddress() const;
+
+  // Returns a new endpoint for the session with the ICE ufrag |ufrag|, which
+  // is owned by the caller, or null if there already is an endpoint for
+  // |ufrag|.
+  rtc::AsyncPacketSocket* CreateEndpoint(const std::string& ufrag);
+
+  size_t num_endpoints() const { return endpoints_.size(); }
+
+  // Hands a packet that was read from another socket bound to the same local
+  // address to the endpoint it belongs to, as if it had been read from
+  // socket(). Returns false, and drops the packet, if it belongs to none.
+  bool HandlePacket(const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time);
+
+  // Emitted for packets read from socket() that belong to no endpoint.
+  sigslot::signal5<UdpSocketMux*,
+                   const char*,
+                   size_t,
+                   const rtc::SocketAddress&,
+                   const rtc::PacketTime&>
+      SignalUnhandledPacket;
+  // Emitted before an endpoint sends a STUN request to a remote address, so
+  // that the response can be routed back here if it arrives elsewhere.
+  sigslot::signal2<UdpSocketMux*, const rtc::SocketAddress&>
+      SignalStunRequestSent;
+
+ private:
+  class Endpoint;
+  typedef std::map<std::string, Endpoint*> EndpointMap;
+  typedef std::map<rtc::SocketAddress, Endpoint*> AddressMap;
+  // Transaction IDs of outstanding STUN requests, with the time they were
+  // last sent.
+  typedef std::map<std::string, std::pair<Endpoint*, uint32_t>>
+      TransactionMap;
+
+  int SendTo(Endpoint* endpoint,
+             const void* data,
+             size_t size,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options);
+  void RemoveEndpoint(Endpoint* endpoint);
+  Endpoint* FindEndpoint(const char* data,
+                         size_t size,
+                         const rtc::SocketAddress& remote_addr);
+  void ExpireTransactions(uint32_t now);
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time);
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet);
+  void OnReadyToSend(rtc::AsyncPacketSocket* socket);
+
+  rtc::scoped_ptr<rtc::AsyncPacketSocket> socket_;
+  EndpointMap endpoints_;
+  AddressMap remote_addresses_;
+  TransactionMap transactions_;
+  // Sent requests in the order they were sent, for expiring |transactions_|.
+  std::deque<std::pair<uint32_t, std::string>> transaction_times_;
+  // The endpoint whose packet is being sent, so that SignalSentPacket of the
+  // shared socket can be forwarded to it.
+  Endpoint* sending_endpoint_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(UdpSocketMux);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
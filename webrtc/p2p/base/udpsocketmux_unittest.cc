@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/helpers.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/testclient.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/virtualsocketserver.h"
+
+using cricket::UdpSocketMux;
+using rtc::SocketAddress;
+using rtc::TestClient;
+
+static const SocketAddress kLocalAddr("11.11.11.11", 0);
+static const SocketAddress kRemoteAddr1("22.22.22.22", 0);
+static const SocketAddress kRemoteAddr2("33.33.33.33", 0);
+
+class UdpSocketMuxTest : public testing::Test {
+ protected:
+  UdpSocketMuxTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        ss_(new rtc::VirtualSocketServer(pss_.get())),
+        ss_scope_(ss_.get()),
+        socket_factory_(rtc::Thread::Current()),
+        mux_(new UdpSocketMux(socket_factory_.CreateUdpSocket(kLocalAddr,
+                                                              0, 0))) {}
+
+  TestClient* CreateRemote(const SocketAddress& addr) {
+    return new TestClient(socket_factory_.CreateUdpSocket(addr, 0, 0));
+  }
+  TestClient* CreateEndpoint(const std::string& ufrag) {
+    rtc::AsyncPacketSocket* endpoint = mux_->CreateEndpoint(ufrag);
+    return endpoint ? new TestClient(endpoint) : nullptr;
+  }
+
+  static std::string StunMessageToString(const cricket::StunMessage& msg) {
+    rtc::ByteBuffer buf;
+    msg.Write(&buf);
+    return std::string(buf.Data(), buf.Length());
+  }
+  static std::string BindingRequest(const std::string& username,
+                                    const std::string& transaction_id) {
+    cricket::IceMessage msg;
+    msg.SetType(cricket::STUN_BINDING_REQUEST);
+    msg.SetTransactionID(transaction_id);
+    if (!username.empty()) {
+      msg.AddAttribute(new cricket::StunByteStringAttribute(
+          cricket::STUN_ATTR_USERNAME, username));
+    }
+    return StunMessageToString(msg);
+  }
+  static std::string BindingResponse(const std::string& transaction_id) {
+    cricket::IceMessage msg;
+    msg.SetType(cricket::STUN_BINDING_RESPONSE);
+    msg.SetTransactionID(transaction_id);
+    return StunMessageToString(msg);
+  }
+
+  // Sends |data| from |from| to the shared socket and checks that it's read by
+  // |to| only.
+  void ExpectDelivered(TestClient* from,
+                       const std::string& data,
+                       TestClient* to,
+                       TestClient* other) {
+    from->SendTo(data.c_str(), data.size(), mux_->GetLocalAddress());
+    SocketAddress addr;
+    EXPECT_TRUE(to->CheckNextPacket(data.c_str(), data.size(), &addr));
+    EXPECT_EQ(from->address(), addr);
+    EXPECT_TRUE(other->CheckNoPacket());
+  }
+
+  rtc::scoped_ptr<rtc::PhysicalSocketServer> pss_;
+  rtc::scoped_ptr<rtc::VirtualSocketServer> ss_;
+  rtc::SocketServerScope ss_scope_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  rtc::scoped_ptr<UdpSocketMux> mux_;
+};
+
+TEST_F(UdpSocketMuxTest, UfragsMustBeUnique) {
+  rtc::scoped_ptr<TestClient> endpoint(CreateEndpoint("ufrag1"));
+  ASSERT_TRUE(endpoint);
+  EXPECT_FALSE(CreateEndpoint("ufrag1"));
+  EXPECT_EQ(1u, mux_->num_endpoints());
+  EXPECT_EQ(mux_->GetLocalAddress(), endpoint->address());
+
+  endpoint.reset();
+  EXPECT_EQ(0u, mux_->num_endpoints());
+  endpoint.reset(CreateEndpoint("ufrag1"));
+  EXPECT_TRUE(endpoint);
+}
+
+// Binding requests are demultiplexed by ufrag, and the packets that follow
+// them by remote address.
+TEST_F(UdpSocketMuxTest, DemultiplexesByUfragAndRemoteAddress) {
+  rtc::scoped_ptr<TestClient> endpoint1(CreateEndpoint("ufrag1"));
+  rtc::scoped_ptr<TestClient> endpoint2(CreateEndpoint("ufrag2"));
+  rtc::scoped_ptr<TestClient> remote1(CreateRemote(kRemoteAddr1));
+  rtc::scoped_ptr<TestClient> remote2(CreateRemote(kRemoteAddr2));
+
+  // Nothing is known about the remote address yet.
+  std::string data("media");
+  remote1->SendTo(data.c_str(), data.size(), mux_->GetLocalAddress());
+  EXPECT_TRUE(endpoint1->CheckNoPacket());
+  EXPECT_TRUE(endpoint2->CheckNoPacket());
+
+  ExpectDelivered(remote1.get(),
+                  BindingRequest("ufrag1:remote", rtc::CreateRandomString(12)),
+                  endpoint1.get(), endpoint2.get());
+  ExpectDelivered(remote2.get(),
+                  BindingRequest("ufrag2:remote", rtc::CreateRandomString(12)),
+                  endpoint2.get(), endpoint1.get());
+  ExpectDelivered(remote1.get(), data, endpoint1.get(), endpoint2.get());
+  ExpectDelivered(remote2.get(), data, endpoint2.get(), endpoint1.get());
+
+  // Packets from the address of a destroyed endpoint are dropped.
+  endpoint1.reset();
+  remote1->SendTo(data.c_str(), data.size(), mux_->GetLocalAddress());
+  EXPECT_TRUE(endpoint2->CheckNoPacket());
+}
+
+// Responses go to the endpoint that sent the request, even if the requests of
+// several endpoints went to the same server.
+TEST_F(UdpSocketMuxTest, DemultiplexesResponsesByTransactionId) {
+  rtc::scoped_ptr<TestClient> endpoint1(CreateEndpoint("ufrag1"));
+  rtc::scoped_ptr<TestClient> endpoint2(CreateEndpoint("ufrag2"));
+  rtc::scoped_ptr<TestClient> server(CreateRemote(kRemoteAddr1));
+
+  std::string id1 = rtc::CreateRandomString(12);
+  std::string id2 = rtc::CreateRandomString(12);
+  std::string request1 = BindingRequest("", id1);
+  std::string request2 = BindingRequest("", id2);
+  endpoint1->SendTo(request1.c_str(), request1.size(), server->address());
+  endpoint2->SendTo(request2.c_str(), request2.size(), server->address());
+  SocketAddress addr;
+  EXPECT_TRUE(server->CheckNextPacket(request1.c_str(), request1.size(),
+                                      &addr));
+  EXPECT_TRUE(server->CheckNextPacket(request2.c_str(), request2.size(),
+                                      &addr));
+  EXPECT_EQ(mux_->GetLocalAddress(), addr);
+
+  ExpectDelivered(server.get(), BindingResponse(id1), endpoint1.get(),
+                  endpoint2.get());
+  ExpectDelivered(server.get(), BindingResponse(id2), endpoint2.get(),
+                  endpoint1.get());
+}
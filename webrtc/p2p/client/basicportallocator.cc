@@ -22,6 +22,7 @@
 #include "webrtc/p2p/base/tcpport.h"
 #include "webrtc/p2p/base/turnport.h"
 #include "webrtc/p2p/base/udpport.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/helpers.h"
@@ -128,6 +129,8 @@ void BasicPortAllocator::Construct() {
 }
 
 BasicPortAllocator::~BasicPortAllocator() {
+  for (auto& kv : udp_socket_muxes_)
+    delete kv.second;
 }
 
 PortAllocatorSession* BasicPortAllocator::CreateSessionInternal(
@@ -137,6 +140,26 @@ PortAllocatorSession* BasicPortAllocator::CreateSessionInternal(
       this, content_name, component, ice_ufrag, ice_pwd);
 }
 
+UdpSocketMux* BasicPortAllocator::GetUdpSocketMux(
+    rtc::PacketSocketFactory* factory,
+    const rtc::IPAddress& ip) {
+  std::map<rtc::IPAddress, UdpSocketMux*>::iterator it =
+      udp_socket_muxes_.find(ip);
+  if (it != udp_socket_muxes_.end())
+    return it->second;
+
+  rtc::AsyncPacketSocket* socket = factory->CreateUdpSocket(
+      rtc::SocketAddress(ip, 0), min_port(), max_port());
+  if (!socket) {
+    LOG(LS_WARNING) << "Failed to create the shared UDP socket for "
+                    << ip.ToSensitiveString();
+    return nullptr;
+  }
+  UdpSocketMux* mux = new UdpSocketMux(socket);
+  udp_socket_muxes_[ip] = mux;
+  return mux;
+}
+
 
 // BasicPortAllocatorSession
 BasicPortAllocatorSession::BasicPortAllocatorSession(
@@ -725,10 +748,21 @@ AllocationSequence::AllocationSequence(BasicPortAllocatorSession* session,
 }
 
 bool AllocationSequence::Init() {
+  if (IsFlagSet(PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX)) {
+    flags_ |= PORTALLOCATOR_ENABLE_SHARED_SOCKET;
+    // Falls back to a socket of our own if the ufrag is already in use, e.g.
+    // by the other component of the same transport.
+    UdpSocketMux* mux = session_->allocator()->GetUdpSocketMux(
+        session_->socket_factory(), ip_);
+    if (mux)
+      udp_socket_.reset(mux->CreateEndpoint(session_->username()));
+  }
   if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET)) {
-    udp_socket_.reset(session_->socket_factory()->CreateUdpSocket(
-        rtc::SocketAddress(ip_, 0), session_->allocator()->min_port(),
-        session_->allocator()->max_port()));
+    if (!udp_socket_) {
+      udp_socket_.reset(session_->socket_factory()->CreateUdpSocket(
+          rtc::SocketAddress(ip_, 0), session_->allocator()->min_port(),
+          session_->allocator()->max_port()));
+    }
     if (udp_socket_) {
       udp_socket_->SignalReadPacket.connect(
           this, &AllocationSequence::OnReadPacket);
@@ -811,36 +845,44 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
   };
 
   // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
-
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      EnableProtocol(PROTO_UDP);
-      break;
+  int phases_left = std::max(1, session_->allocator()->phases_per_step());
+  while (true) {
+    LOG_J(LS_INFO, network_) << "Allocation Phase="
+                             << PHASE_NAMES[phase_];
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        EnableProtocol(PROTO_UDP);
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      EnableProtocol(PROTO_TCP);
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        EnableProtocol(PROTO_TCP);
+        break;
 
-    case PHASE_SSLTCP:
-      state_ = kCompleted;
-      EnableProtocol(PROTO_SSLTCP);
-      break;
+      case PHASE_SSLTCP:
+        state_ = kCompleted;
+        EnableProtocol(PROTO_SSLTCP);
+        break;
 
-    default:
-      ASSERT(false);
+      default:
+        ASSERT(false);
+    }
+
+    if (state() != kRunning)
+      break;
+    ++phase_;
+    if (--phases_left == 0)
+      break;
   }
 
   if (state() == kRunning) {
-    ++phase_;
     session_->network_thread()->PostDelayed(
         session_->allocator()->step_delay(),
         this, MSG_ALLOCATION_PHASE);
@@ -1040,6 +1082,7 @@ void AllocationSequence::CreateTurnPort(const RelayServerConfig& config) {
     // TODO(mallinath) - Enable shared socket mode for TURN ports. Disabled
     // due to webrtc bug https://code.google.com/p/webrtc/issues/detail?id=3537
     if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) &&
+        !IsFlagSet(PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX) &&
         relay_port->proto == PROTO_UDP && udp_socket_) {
       port = TurnPort::Create(session_->network_thread(),
                               session_->socket_factory(),
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 #define WEBRTC_P2P_CLIENT_BASICPORTALLOCATOR_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,8 @@
 
 namespace cricket {
 
+class UdpSocketMux;
+
 class BasicPortAllocator : public PortAllocator {
  public:
   BasicPortAllocator(rtc::NetworkManager* network_manager,
@@ -77,6 +80,12 @@ class BasicPortAllocator : public PortAllocator {
       const std::string& ice_ufrag,
       const std::string& ice_pwd) override;
 
+  // Returns the socket shared by the sessions that allocate UDP ports on |ip|
+  // with PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX, creating it with |factory| if
+  // needed. Returns null if the socket can't be created.
+  UdpSocketMux* GetUdpSocketMux(rtc::PacketSocketFactory* factory,
+                                const rtc::IPAddress& ip);
+
  private:
   void Construct();
 
@@ -86,6 +95,7 @@ class BasicPortAllocator : public PortAllocator {
   std::vector<RelayServerConfig> turn_servers_;
   bool allow_tcp_listen_;
   int network_ignore_mask_ = rtc::kDefaultNetworkIgnoreMask;
+  std::map<rtc::IPAddress, UdpSocketMux*> udp_socket_muxes_;
 };
 
 struct PortConfiguration;
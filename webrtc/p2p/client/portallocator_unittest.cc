@@ -586,6 +586,19 @@ TEST_F(PortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Verify that all phases are started at once, despite the step delay of 1sec,
+// when the allocator is configured to.
+TEST_F(PortAllocatorTest, TestGetAllPortsWithAllPhasesInOneStep) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(cricket::kDefaultStepDelay);
+  allocator_->set_phases_per_step(cricket::kAllPhasesPerStep);
+  EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_EQ_WAIT(7U, candidates_.size(), 500);
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_TRUE(candidate_allocation_done_);
+}
+
 TEST_F(PortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   EXPECT_TRUE(CreateSession(cricket::ICE_CANDIDATE_COMPONENT_RTP,
@@ -1061,6 +1074,35 @@ TEST_F(PortAllocatorTest, TestSharedSocketWithNat) {
   EXPECT_EQ(3U, candidates_.size());
 }
 
+// Test that with PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX the UDP ports of all
+// sessions share one socket, unless they use the same ufrag.
+TEST_F(PortAllocatorTest, TestUdpSocketMuxSharesSocketAcrossSessions) {
+  AddInterface(kClientAddr);
+  allocator_->set_flags(allocator().flags() |
+                        cricket::PORTALLOCATOR_DISABLE_TCP |
+                        cricket::PORTALLOCATOR_DISABLE_RELAY |
+                        cricket::PORTALLOCATOR_ENABLE_UDP_SOCKET_MUX);
+  rtc::scoped_ptr<cricket::PortAllocatorSession> session1(
+      CreateSession("session1", kContentName,
+                    cricket::ICE_CANDIDATE_COMPONENT_RTP, "ufrag1", kIcePwd0));
+  rtc::scoped_ptr<cricket::PortAllocatorSession> session2(
+      CreateSession("session2", kContentName,
+                    cricket::ICE_CANDIDATE_COMPONENT_RTP, "ufrag2", kIcePwd0));
+  rtc::scoped_ptr<cricket::PortAllocatorSession> session3(
+      CreateSession("session3", kContentName,
+                    cricket::ICE_CANDIDATE_COMPONENT_RTCP, "ufrag2", kIcePwd0));
+  session1->StartGettingPorts();
+  session2->StartGettingPorts();
+  session3->StartGettingPorts();
+  ASSERT_EQ_WAIT(3U, candidates_.size(), kDefaultAllocationTimeout);
+  for (const cricket::Candidate& candidate : candidates_) {
+    EXPECT_PRED5(CheckCandidate, candidate, candidate.component(), "local",
+                 "udp", kClientAddr);
+  }
+  EXPECT_EQ(candidates_[0].address(), candidates_[1].address());
+  EXPECT_NE(candidates_[0].address(), candidates_[2].address());
+}
+
 // Test TURN port in shared socket mode with UDP and TCP TURN server addresses.
 TEST_F(PortAllocatorTest, TestSharedSocketWithoutNatUsingTurn) {
   turn_server_.AddInternalSocket(kTurnTcpIntAddr, cricket::PROTO_TCP);
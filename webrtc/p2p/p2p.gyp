@@ -30,6 +30,8 @@
         'base/constants.h',
         'base/dtlstransportchannel.cc',
         'base/dtlstransportchannel.h',
+        'base/icecheckbudget.cc',
+        'base/icecheckbudget.h',
         'base/p2ptransport.cc',
         'base/p2ptransport.h',
         'base/p2ptransportchannel.cc',
@@ -49,6 +51,10 @@
         'base/sessiondescription.cc',
         'base/sessiondescription.h',
         'base/sessionid.h',
+        'base/shardedturnserver.cc',
+        'base/shardedturnserver.h',
+        'base/shardedudpsocketmux.cc',
+        'base/shardedudpsocketmux.h',
         'base/stun.cc',
         'base/stun.h',
         'base/stunport.cc',
@@ -76,6 +82,8 @@
         'base/turnserver.cc',
         'base/turnserver.h',
         'base/udpport.h',
+        'base/udpsocketmux.cc',
+        'base/udpsocketmux.h',
         'client/basicportallocator.cc',
         'client/basicportallocator.h',
         'client/httpportallocator.cc',
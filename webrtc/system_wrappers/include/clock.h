@@ -79,6 +79,33 @@ class SimulatedClock : public Clock {
   rtc::scoped_ptr<RWLockWrapper> lock_;
 };
 
+// A clock that returns the time of another clock as it was at the last call
+// to Update(), so that code handling a batch of packets or a message can read
+// the time as often as it needs to while only reading the underlying clock
+// once. Not thread safe; each thread using it should own its own instance and
+// call Update() where the time needs to be fresh.
+class CachedClock : public Clock {
+ public:
+  // Reads |clock| once; it must outlive this object.
+  explicit CachedClock(Clock* clock);
+
+  ~CachedClock() override;
+
+  // Reads the underlying clock again.
+  void Update();
+
+  int64_t TimeInMilliseconds() const override;
+  int64_t TimeInMicroseconds() const override;
+  void CurrentNtp(uint32_t& seconds, uint32_t& fractions) const override;
+  int64_t CurrentNtpInMilliseconds() const override;
+
+ private:
+  Clock* const clock_;
+  int64_t time_us_;
+  uint32_t ntp_seconds_;
+  uint32_t ntp_fractions_;
+};
+
 };  // namespace webrtc
 
 #endif  // WEBRTC_SYSTEM_WRAPPERS_INCLUDE_CLOCK_H_
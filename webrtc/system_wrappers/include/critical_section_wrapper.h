@@ -23,6 +23,13 @@ class LOCKABLE CriticalSectionWrapper {
   // Factory method, constructor disabled
   static CriticalSectionWrapper* CreateCriticalSection();
 
+  // Creates a critical section that spins briefly before blocking, for locks
+  // that are held only briefly, see rtc::AdaptiveCriticalSection. |name|
+  // identifies the lock to rtc::LockContentionProfiler and must outlive it.
+  // Can't be used with ConditionVariableWrapper.
+  static CriticalSectionWrapper* CreateAdaptiveCriticalSection(
+      const char* name);
+
   virtual ~CriticalSectionWrapper() {}
 
   // Tries to grab lock, beginning of a critical section. Will wait for the
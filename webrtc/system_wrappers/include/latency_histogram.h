@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A latency histogram which media threads can record into without taking a
+// lock, for stages whose tail matters more than their average.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LATENCY_HISTOGRAM_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LATENCY_HISTOGRAM_H_
+
+#include "webrtc/base/constructormagic.h"
+
+namespace webrtc {
+
+// Values below 8 ms get a bucket each; above that, every power of two is split
+// into four buckets, so a percentile is off by at most 25%. Latencies of
+// kMaxLatencyMs and above share the last bucket.
+//
+// Add() is one atomic increment and may be called from any number of threads.
+// Percentile() and NumSamples() may run concurrently with Add(), and then see
+// some but not necessarily all of the concurrent samples.
+class LatencyHistogram {
+ public:
+  static const int kNumBuckets = 64;
+  static const int kMaxLatencyMs = 1 << 17;
+
+  LatencyHistogram();
+
+  // Records one sample. Negative latencies are counted as 0 ms.
+  void Add(int latency_ms);
+
+  // Returns an upper bound on the latency of |percent| percent of the
+  // samples, or -1 if there are none.
+  int Percentile(int percent) const;
+
+  int NumSamples() const;
+
+  // Exposed for testing.
+  static int BucketIndex(int latency_ms);
+  static int BucketUpperBound(int index);
+
+ private:
+  volatile int counts_[kNumBuckets];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A pointer which a real-time thread can use without taking a lock, while
+// other threads replace it.
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LOCK_FREE_POINTER_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LOCK_FREE_POINTER_H_
+
+#include <stddef.h>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+
+// Readers never block: a ScopedAccess costs one atomic increment, one
+// decrement and one load.
+// Set() swaps in the new pointer and then waits until no reader can still be
+// using the previous one, so the caller may delete it as soon as Set()
+// returns. Only the thread calling Set() ever waits.
+//
+// The pointer is not owned. Readers must not call Set() on the same instance
+// while holding a ScopedAccess, since Set() would then wait for itself.
+template <class T>
+class LockFreePointer {
+ public:
+  explicit LockFreePointer(T* value) : value_(value), readers_(0) {}
+  LockFreePointer() : value_(NULL), readers_(0) {}
+
+  class ScopedAccess {
+   public:
+    explicit ScopedAccess(LockFreePointer* pointer) : pointer_(pointer) {
+      // The increment is a full barrier, so either Set() sees this reader or
+      // the load below sees the value Set() stored.
+      rtc::AtomicOps::Increment(&pointer_->readers_);
+      value_ = rtc::AtomicOps::AcquireLoadPtr(&pointer_->value_);
+    }
+    ~ScopedAccess() { rtc::AtomicOps::Decrement(&pointer_->readers_); }
+
+    T* get() const { return value_; }
+    T* operator->() const { return value_; }
+
+   private:
+    LockFreePointer* const pointer_;
+    T* value_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(ScopedAccess);
+  };
+
+  // Publishes |value| and returns the previous pointer once no reader uses it
+  // anymore. Safe to call from several threads at once.
+  T* Set(T* value) {
+    T* previous = rtc::AtomicOps::AcquireLoadPtr(&value_);
+    for (;;) {
+      T* seen = rtc::AtomicOps::CompareAndSwapPtr(&value_, previous, value);
+      if (seen == previous)
+        break;
+      previous = seen;
+    }
+    // Readers hold the pointer for at most one audio callback, so a short
+    // sleep rarely happens more than once.
+    while (rtc::AtomicOps::AcquireLoad(&readers_) != 0)
+      SleepMs(1);
+    return previous;
+  }
+
+ private:
+  T* volatile value_;
+  volatile int readers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LockFreePointer);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INCLUDE_LOCK_FREE_POINTER_H_
@@ -25,7 +25,12 @@ namespace webrtc {
 // Disable all TRACE macros. The LOG macro is still functional.
 #define WEBRTC_TRACE true ? (void) 0 : Trace::Add
 #else
-#define WEBRTC_TRACE Trace::Add
+// Checks the level filter before the arguments are evaluated, so a filtered
+// trace costs one load.
+#define WEBRTC_TRACE(level, ...)                    \
+  ((Trace::level_filter() & (level))                \
+       ? Trace::Add((level), __VA_ARGS__)           \
+       : (void) 0)
 #endif
 
 class Trace {
@@ -69,8 +74,10 @@ class Trace {
   static int32_t SetTraceCallback(TraceCallback* callback);
 
   // Adds a trace message for writing to file. The message is put in a queue
-  // for writing to file whenever possible for performance reasons. I.e. there
-  // is a crash it is possible that the last, vital logs are not logged yet.
+  // which a separate thread writes to file and passes to the callback, so
+  // that tracing does not block the calling thread. I.e. if there is a crash
+  // it is possible that the last, vital logs are not logged yet, and if the
+  // queue is full the message is dropped.
   // level is the type of message to log. If that type of messages is
   // filtered it will not be written to file. module is an identifier for what
   // part of the code the message is coming.
@@ -268,4 +268,33 @@ void SimulatedClock::AdvanceTimeMicroseconds(int64_t microseconds) {
   time_us_ += microseconds;
 }
 
+CachedClock::CachedClock(Clock* clock) : clock_(clock) {
+  Update();
+}
+
+CachedClock::~CachedClock() {
+}
+
+void CachedClock::Update() {
+  time_us_ = clock_->TimeInMicroseconds();
+  clock_->CurrentNtp(ntp_seconds_, ntp_fractions_);
+}
+
+int64_t CachedClock::TimeInMilliseconds() const {
+  return (time_us_ + 500) / 1000;
+}
+
+int64_t CachedClock::TimeInMicroseconds() const {
+  return time_us_;
+}
+
+void CachedClock::CurrentNtp(uint32_t& seconds, uint32_t& fractions) const {
+  seconds = ntp_seconds_;
+  fractions = ntp_fractions_;
+}
+
+int64_t CachedClock::CurrentNtpInMilliseconds() const {
+  return NtpToMs(ntp_seconds_, ntp_fractions_);
+}
+
 };  // namespace webrtc
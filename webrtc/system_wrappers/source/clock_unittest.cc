@@ -25,4 +25,31 @@ TEST(ClockTest, NtpTime) {
   EXPECT_NEAR(milliseconds, Clock::NtpToMs(seconds, fractions), 100);
 }
 
+TEST(ClockTest, CachedClockOnlyChangesOnUpdate) {
+  SimulatedClock simulated_clock(1000000);
+  CachedClock clock(&simulated_clock);
+  EXPECT_EQ(1000000, clock.TimeInMicroseconds());
+  EXPECT_EQ(1000, clock.TimeInMilliseconds());
+
+  simulated_clock.AdvanceTimeMilliseconds(10);
+  EXPECT_EQ(1000, clock.TimeInMilliseconds());
+  EXPECT_EQ(simulated_clock.TimeInMilliseconds() - 10,
+            clock.CurrentNtpInMilliseconds() -
+                1000 * static_cast<int64_t>(kNtpJan1970));
+
+  clock.Update();
+  EXPECT_EQ(1010000, clock.TimeInMicroseconds());
+  EXPECT_EQ(1010, clock.TimeInMilliseconds());
+  uint32_t seconds;
+  uint32_t fractions;
+  clock.CurrentNtp(seconds, fractions);
+  uint32_t expected_seconds;
+  uint32_t expected_fractions;
+  simulated_clock.CurrentNtp(expected_seconds, expected_fractions);
+  EXPECT_EQ(expected_seconds, seconds);
+  EXPECT_EQ(expected_fractions, fractions);
+  EXPECT_EQ(simulated_clock.CurrentNtpInMilliseconds(),
+            clock.CurrentNtpInMilliseconds());
+}
+
 }  // namespace webrtc
@@ -47,6 +47,58 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Like __cpuid(), for leaves that also take a sub-leaf in ecx.
+static inline void CpuidEx(int cpu_info[4], int info_type, int sub_leaf) {
+#if defined(_MSC_VER)
+  __cpuidex(cpu_info, info_type, sub_leaf);
+#elif defined(__pic__) && defined(__i386__)
+  __asm__ volatile(
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_leaf));
+#else
+  __asm__ volatile(
+    "cpuid\n"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_leaf));
+#endif
+}
+
+// Returns the low word of extended control register 0, which tells which
+// register states the OS saves on context switches.
+static inline uint32_t GetXcr0() {
+#if defined(_MSC_VER)
+  return static_cast<uint32_t>(_xgetbv(0));
+#else
+  uint32_t xcr0_low, xcr0_high;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+  return xcr0_low;
+#endif
+}
+
+// AVX2 can only be used if the OS saves the full ymm registers, which is
+// what the OSXSAVE bit and XCR0 tell.
+static int HasAVX2() {
+  int cpu_info[4];
+  __cpuid(cpu_info, 0);
+  if (cpu_info[0] < 7)
+    return 0;
+  __cpuid(cpu_info, 1);
+  const int kOsxsave = 1 << 27;
+  const int kAvx = 1 << 28;
+  if ((cpu_info[2] & (kOsxsave | kAvx)) != (kOsxsave | kAvx))
+    return 0;
+  // xmm and ymm state.
+  if ((GetXcr0() & 0x6) != 0x6)
+    return 0;
+  CpuidEx(cpu_info, 7, 0);
+  return 0 != (cpu_info[1] & 0x00000020);
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 // Actual feature detection for x86.
 static int GetCPUInfo(CPUFeature feature) {
@@ -58,6 +110,9 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2) {
+    return HasAVX2();
+  }
   return 0;
 }
 #else
@@ -15,7 +15,23 @@
 #include "webrtc/system_wrappers/source/critical_section_posix.h"
 #endif
 
+#include "webrtc/base/criticalsection.h"
+
 namespace webrtc {
+namespace {
+
+class CriticalSectionAdaptive : public CriticalSectionWrapper {
+ public:
+  explicit CriticalSectionAdaptive(const char* name) : crit_(name) {}
+
+  void Enter() override NO_THREAD_SAFETY_ANALYSIS { crit_.Enter(); }
+  void Leave() override NO_THREAD_SAFETY_ANALYSIS { crit_.Leave(); }
+
+ private:
+  rtc::AdaptiveCriticalSection crit_;
+};
+
+}  // namespace
 
 CriticalSectionWrapper* CriticalSectionWrapper::CreateCriticalSection() {
 #ifdef _WIN32
@@ -25,4 +41,9 @@ CriticalSectionWrapper* CriticalSectionWrapper::CreateCriticalSection() {
 #endif
 }
 
+CriticalSectionWrapper* CriticalSectionWrapper::CreateAdaptiveCriticalSection(
+    const char* name) {
+  return new CriticalSectionAdaptive(name);
+}
+
 }  // namespace webrtc
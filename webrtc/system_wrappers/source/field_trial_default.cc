@@ -11,22 +11,23 @@
 #include "webrtc/system_wrappers/include/field_trial_default.h"
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 // Simple field trial implementation, which allows client to
 // specify desired flags in InitFieldTrialsFromString.
 namespace webrtc {
 namespace field_trial {
 
-static const char *trials_init_string = NULL;
-
-std::string FindFullName(const std::string& name) {
-  if (trials_init_string == NULL)
-    return std::string();
+typedef std::unordered_map<std::string, std::string> FieldTrialMap;
 
-  std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
+static const char *trials_init_string = NULL;
+// Parsed from |trials_init_string| when it is set, so that lookups don't
+// have to parse the string again.
+static const FieldTrialMap* trials_map = NULL;
 
+static FieldTrialMap* ParseFieldTrials(const std::string& trials_string) {
+  FieldTrialMap* trials = new FieldTrialMap();
   static const char kPersistentStringSeparator = '/';
   size_t next_item = 0;
   while (next_item < trials_string.length()) {
@@ -47,15 +48,28 @@ std::string FindFullName(const std::string& name) {
         field_value_end - field_name_end - 1);
     next_item = field_value_end + 1;
 
-    if (name == field_name)
-      return field_value;
+    // The first occurrence of a name wins, as it did when the string was
+    // searched on every lookup.
+    trials->insert(std::make_pair(field_name, field_value));
   }
-  return std::string();
+  return trials;
+}
+
+std::string FindFullName(const std::string& name) {
+  if (trials_map == NULL)
+    return std::string();
+
+  FieldTrialMap::const_iterator it = trials_map->find(name);
+  if (it == trials_map->end())
+    return std::string();
+  return it->second;
 }
 
 // Optionally initialize field trial from a string.
 void InitFieldTrialsFromString(const char* trials_string) {
   trials_init_string = trials_string;
+  delete trials_map;
+  trials_map = trials_string ? ParseFieldTrials(trials_string) : NULL;
 }
 
 const char* GetFieldTrialString() {
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/latency_histogram.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+namespace {
+// Values below this get a bucket each.
+const int kNumExactBuckets = 8;
+const int kBucketsPerOctave = 4;
+// log2(kNumExactBuckets).
+const int kFirstOctave = 3;
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() {
+  for (int i = 0; i < kNumBuckets; ++i)
+    counts_[i] = 0;
+}
+
+void LatencyHistogram::Add(int latency_ms) {
+  rtc::AtomicOps::Increment(&counts_[BucketIndex(latency_ms)]);
+}
+
+int LatencyHistogram::Percentile(int percent) const {
+  RTC_DCHECK_GE(percent, 0);
+  RTC_DCHECK_LE(percent, 100);
+  // Work on a copy, so that the total matches the counts walked below.
+  int counts[kNumBuckets];
+  int64_t total = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts[i] = rtc::AtomicOps::AcquireLoad(&counts_[i]);
+    total += counts[i];
+  }
+  if (total == 0)
+    return -1;
+  int64_t rank = (total * percent + 99) / 100;
+  if (rank < 1)
+    rank = 1;
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank)
+      return BucketUpperBound(i);
+  }
+  RTC_NOTREACHED();
+  return -1;
+}
+
+int LatencyHistogram::NumSamples() const {
+  int total = 0;
+  for (int i = 0; i < kNumBuckets; ++i)
+    total += rtc::AtomicOps::AcquireLoad(&counts_[i]);
+  return total;
+}
+
+int LatencyHistogram::BucketIndex(int latency_ms) {
+  if (latency_ms < kNumExactBuckets)
+    return latency_ms < 0 ? 0 : latency_ms;
+  if (latency_ms >= kMaxLatencyMs)
+    return kNumBuckets - 1;
+  int octave = kFirstOctave;
+  while (latency_ms >> (octave + 1))
+    ++octave;
+  // The two bits below the leading one pick the bucket within the octave.
+  int sub_bucket = (latency_ms >> (octave - 2)) & (kBucketsPerOctave - 1);
+  return kNumExactBuckets + (octave - kFirstOctave) * kBucketsPerOctave +
+         sub_bucket;
+}
+
+int LatencyHistogram::BucketUpperBound(int index) {
+  RTC_DCHECK_GE(index, 0);
+  RTC_DCHECK_LT(index, kNumBuckets);
+  if (index < kNumExactBuckets)
+    return index;
+  if (index == kNumBuckets - 1)
+    return kMaxLatencyMs;
+  int octave = kFirstOctave + (index - kNumExactBuckets) / kBucketsPerOctave;
+  int sub_bucket = (index - kNumExactBuckets) % kBucketsPerOctave;
+  return ((kBucketsPerOctave + sub_bucket + 1) << (octave - 2)) - 1;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/latency_histogram.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace webrtc {
+namespace {
+
+const int kSamplesPerThread = 10000;
+
+bool AddSamples(void* obj) {
+  LatencyHistogram* histogram = static_cast<LatencyHistogram*>(obj);
+  for (int i = 0; i < kSamplesPerThread; ++i)
+    histogram->Add(i % 100);
+  return false;
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.NumSamples());
+  EXPECT_EQ(-1, histogram.Percentile(50));
+}
+
+TEST(LatencyHistogramTest, BucketsCoverAllLatencies) {
+  int previous_index = 0;
+  for (int ms = 0; ms < LatencyHistogram::kMaxLatencyMs; ++ms) {
+    int index = LatencyHistogram::BucketIndex(ms);
+    ASSERT_GE(index, previous_index);
+    ASSERT_LE(index, previous_index + 1);
+    ASSERT_LE(ms, LatencyHistogram::BucketUpperBound(index));
+    // The bound overestimates by at most 25%.
+    ASSERT_LE(LatencyHistogram::BucketUpperBound(index), ms + ms / 4 + 1);
+    previous_index = index;
+  }
+  EXPECT_EQ(LatencyHistogram::kNumBuckets - 1, previous_index);
+  EXPECT_EQ(LatencyHistogram::kNumBuckets - 1,
+            LatencyHistogram::BucketIndex(LatencyHistogram::kMaxLatencyMs * 2));
+  EXPECT_EQ(0, LatencyHistogram::BucketIndex(-5));
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 95; ++i)
+    histogram.Add(5);
+  for (int i = 0; i < 5; ++i)
+    histogram.Add(200);
+  EXPECT_EQ(100, histogram.NumSamples());
+  EXPECT_EQ(5, histogram.Percentile(0));
+  EXPECT_EQ(5, histogram.Percentile(50));
+  EXPECT_EQ(5, histogram.Percentile(95));
+  EXPECT_EQ(223, histogram.Percentile(96));
+  EXPECT_EQ(223, histogram.Percentile(100));
+}
+
+TEST(LatencyHistogramTest, ConcurrentAdds) {
+  LatencyHistogram histogram;
+  rtc::PlatformThread thread1(&AddSamples, &histogram, "LatencyHistogram1");
+  rtc::PlatformThread thread2(&AddSamples, &histogram, "LatencyHistogram2");
+  thread1.Start();
+  thread2.Start();
+  thread1.Stop();
+  thread2.Stop();
+  EXPECT_EQ(2 * kSamplesPerThread, histogram.NumSamples());
+}
+
+}  // namespace webrtc
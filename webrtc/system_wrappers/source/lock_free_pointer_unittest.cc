@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/lock_free_pointer.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace webrtc {
+namespace {
+
+struct Gains {
+  Gains(int left, int right) : left(left), right(right) {}
+  int left;
+  int right;
+};
+
+struct ReaderState {
+  ReaderState(LockFreePointer<Gains>* gains) : gains(gains), stop(0),
+                                                torn_reads(0) {}
+  LockFreePointer<Gains>* gains;
+  volatile int stop;
+  int torn_reads;
+};
+
+bool ReadGains(void* obj) {
+  ReaderState* state = static_cast<ReaderState*>(obj);
+  if (rtc::AtomicOps::AcquireLoad(&state->stop))
+    return false;
+  LockFreePointer<Gains>::ScopedAccess gains(state->gains);
+  // Every published value has equal gains, and none is deleted while read.
+  if (gains->left != gains->right)
+    ++state->torn_reads;
+  return true;
+}
+
+}  // namespace
+
+TEST(LockFreePointerTest, SetReturnsPrevious) {
+  Gains first(1, 1);
+  Gains second(2, 2);
+  LockFreePointer<Gains> gains(&first);
+  {
+    LockFreePointer<Gains>::ScopedAccess access(&gains);
+    EXPECT_EQ(&first, access.get());
+  }
+  EXPECT_EQ(&first, gains.Set(&second));
+  {
+    LockFreePointer<Gains>::ScopedAccess access(&gains);
+    EXPECT_EQ(&second, access.get());
+  }
+  EXPECT_EQ(&second, gains.Set(NULL));
+  LockFreePointer<Gains>::ScopedAccess access(&gains);
+  EXPECT_TRUE(access.get() == NULL);
+}
+
+TEST(LockFreePointerTest, PreviousValueCanBeDeleted) {
+  LockFreePointer<Gains> gains(new Gains(0, 0));
+  ReaderState state(&gains);
+  rtc::PlatformThread reader(&ReadGains, &state, "LockFreePointerReader");
+  reader.Start();
+  for (int i = 1; i <= 1000; ++i)
+    delete gains.Set(new Gains(i, i));
+  rtc::AtomicOps::ReleaseStore(&state.stop, 1);
+  reader.Stop();
+  delete gains.Set(NULL);
+  EXPECT_EQ(0, state.torn_reads);
+}
+
+}  // namespace webrtc
@@ -31,6 +31,22 @@
 
 namespace webrtc {
 
+namespace {
+
+// How often the writer thread writes the queued messages.
+const int kWriteIntervalMs = 10;
+
+// Queue positions wrap around instead of overflowing.
+int SequenceAdd(int a, int b) {
+  return static_cast<int>(static_cast<unsigned>(a) + static_cast<unsigned>(b));
+}
+
+int SequenceDiff(int a, int b) {
+  return static_cast<int>(static_cast<unsigned>(a) - static_cast<unsigned>(b));
+}
+
+}  // namespace
+
 const int Trace::kBoilerplateLength = 71;
 const int Trace::kTimestampPosition = 13;
 const int Trace::kTimestampLength = 12;
@@ -68,14 +84,45 @@ TraceImpl::TraceImpl()
     : callback_(NULL),
       row_count_text_(0),
       file_count_text_(0),
-      trace_file_(FileWrapper::Create()) {
+      trace_file_(FileWrapper::Create()),
+      queue_(new QueuedMessage[WEBRTC_TRACE_MAX_QUEUE]),
+      enqueue_pos_(0),
+      dequeue_pos_(0),
+      dropped_messages_(0),
+      wake_(false, false),
+      thread_(&TraceImpl::WriterThread, this, "Trace") {
+  static_assert((WEBRTC_TRACE_MAX_QUEUE & (WEBRTC_TRACE_MAX_QUEUE - 1)) == 0,
+                "WEBRTC_TRACE_MAX_QUEUE must be a power of two.");
+  for (int i = 0; i < WEBRTC_TRACE_MAX_QUEUE; ++i)
+    queue_[i].sequence = i;
+  thread_.Start();
+  thread_.SetPriority(rtc::kLowPriority);
 }
 
 TraceImpl::~TraceImpl() {
+  // The subclass has already stopped the writer thread.
   trace_file_->Flush();
   trace_file_->CloseFile();
 }
 
+void TraceImpl::StopWriterThread() {
+  wake_.Set();
+  thread_.Stop();
+  rtc::CritScope lock(&crit_);
+  WriteQueuedMessages();
+}
+
+bool TraceImpl::WriterThread(void* obj) {
+  return static_cast<TraceImpl*>(obj)->Process();
+}
+
+bool TraceImpl::Process() {
+  wake_.Wait(kWriteIntervalMs);
+  rtc::CritScope lock(&crit_);
+  WriteQueuedMessages();
+  return true;
+}
+
 int32_t TraceImpl::AddThreadId(char* trace_message) const {
   uint32_t thread_id = rtc::CurrentThreadId();
   // Messages is 12 characters.
@@ -359,10 +406,62 @@ void TraceImpl::AddMessageToList(
     const char trace_message[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
     const uint16_t length,
     const TraceLevel level) {
-  rtc::CritScope lock(&crit_);
-  if (callback_)
-    callback_->Print(level, trace_message, length);
-  WriteToFile(trace_message, length);
+  int pos = rtc::AtomicOps::AcquireLoad(&enqueue_pos_);
+  QueuedMessage* cell;
+  while (true) {
+    cell = &queue_[pos & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    int diff = SequenceDiff(rtc::AtomicOps::AcquireLoad(&cell->sequence), pos);
+    if (diff == 0) {
+      int previous = rtc::AtomicOps::CompareAndSwap(&enqueue_pos_, pos,
+                                                    SequenceAdd(pos, 1));
+      if (previous == pos)
+        break;
+      pos = previous;
+    } else if (diff < 0) {
+      // The writer has not yet written the message from the previous lap.
+      rtc::AtomicOps::Increment(&dropped_messages_);
+      return;
+    } else {
+      // Another thread claimed the cell first.
+      pos = rtc::AtomicOps::AcquireLoad(&enqueue_pos_);
+    }
+  }
+  cell->level = level;
+  cell->length = length;
+  memcpy(cell->message, trace_message, length);
+  rtc::AtomicOps::ReleaseStore(&cell->sequence, SequenceAdd(pos, 1));
+  // Wake the writer early at every half lap, so that bursts do not fill the
+  // queue. This takes the event's lock, but only once per half lap.
+  if ((pos & (WEBRTC_TRACE_MAX_QUEUE / 2 - 1)) == 0)
+    wake_.Set();
+}
+
+void TraceImpl::WriteQueuedMessages() {
+  while (true) {
+    QueuedMessage* cell =
+        &queue_[dequeue_pos_ & (WEBRTC_TRACE_MAX_QUEUE - 1)];
+    if (rtc::AtomicOps::AcquireLoad(&cell->sequence) !=
+        SequenceAdd(dequeue_pos_, 1)) {
+      break;
+    }
+    if (callback_)
+      callback_->Print(cell->level, cell->message, cell->length);
+    WriteToFile(cell->message, cell->length);
+    rtc::AtomicOps::ReleaseStore(
+        &cell->sequence, SequenceAdd(dequeue_pos_, WEBRTC_TRACE_MAX_QUEUE));
+    dequeue_pos_ = SequenceAdd(dequeue_pos_, 1);
+  }
+
+  int dropped = rtc::AtomicOps::AcquireLoad(&dropped_messages_);
+  if (dropped > 0 &&
+      rtc::AtomicOps::CompareAndSwap(&dropped_messages_, dropped, 0) ==
+          dropped) {
+    // Goes through the queue like any other message, and is written by the
+    // next call.
+    char message[64];
+    sprintf(message, "Trace: dropped %d messages.", dropped);
+    AddImpl(kTraceWarning, kTraceUtility, -1, message);
+  }
 }
 
 void TraceImpl::WriteToFile(const char* msg, uint16_t length) {
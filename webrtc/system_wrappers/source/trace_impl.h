@@ -12,6 +12,7 @@
 #define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_IMPL_H_
 
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
@@ -22,10 +23,11 @@
 namespace webrtc {
 
 #define WEBRTC_TRACE_MAX_MESSAGE_SIZE 1024
-// Total buffer size is WEBRTC_TRACE_NUM_ARRAY (number of buffer partitions) *
-// WEBRTC_TRACE_MAX_QUEUE (number of lines per buffer partition) *
+// Number of lines that may be queued for the writer thread. Must be a power
+// of two. Total buffer size is WEBRTC_TRACE_MAX_QUEUE *
 // WEBRTC_TRACE_MAX_MESSAGE_SIZE (number of 1 byte charachters per line) =
-// 1 or 4 Mbyte.
+// 1 Mbyte.
+#define WEBRTC_TRACE_MAX_QUEUE 1024
 
 #define WEBRTC_TRACE_MAX_FILE_SIZE 100*1000
 // Number of rows that may be written to file. On average 110 bytes per row (max
@@ -63,9 +65,30 @@ class TraceImpl : public Trace {
 
   virtual int32_t AddDateTimeInfo(char* trace_message) const = 0;
 
+  // Stops the writer thread and writes what is still queued. Must be called
+  // from the destructor of the OS specific subclass, since writing calls
+  // AddDateTimeInfo().
+  void StopWriterThread();
+
  private:
   friend class Trace;
 
+  // A formatted message waiting to be written. |sequence| tells whether the
+  // cell is free for the caller with that enqueue position, or holds the
+  // message of the previous lap for the writer.
+  struct QueuedMessage {
+    volatile int sequence;
+    TraceLevel level;
+    uint16_t length;
+    char message[WEBRTC_TRACE_MAX_MESSAGE_SIZE];
+  };
+
+  static bool WriterThread(void* obj);
+  bool Process();
+  // Writes the queued messages in order, until the first cell which is not
+  // filled in yet.
+  void WriteQueuedMessages();
+
   int32_t AddLevel(char* sz_message, const TraceLevel level) const;
 
   int32_t AddModuleAndId(char* trace_message, const TraceModule module,
@@ -75,6 +98,8 @@ class TraceImpl : public Trace {
                      const char msg[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
                      const uint16_t written_so_far) const;
 
+  // Copies the message into the queue. Never blocks; the message is dropped
+  // if the queue is full.
   void AddMessageToList(
     const char trace_message[WEBRTC_TRACE_MAX_MESSAGE_SIZE],
     const uint16_t length,
@@ -98,7 +123,20 @@ class TraceImpl : public Trace {
   uint32_t file_count_text_ GUARDED_BY(crit_);
 
   const rtc::scoped_ptr<FileWrapper> trace_file_ GUARDED_BY(crit_);
+  // Held by the writer thread while it writes, and by the setters. Never
+  // taken by the threads that trace.
   rtc::CriticalSection crit_;
+
+  // Bounded multi-producer, single-consumer queue. Callers claim a cell by
+  // advancing |enqueue_pos_| with a compare-and-swap.
+  const rtc::scoped_ptr<QueuedMessage[]> queue_;
+  volatile int enqueue_pos_;
+  // Only used by the writer thread, or after it has stopped.
+  int dequeue_pos_;
+  volatile int dropped_messages_;
+
+  rtc::Event wake_;
+  rtc::PlatformThread thread_;
 };
 
 }  // namespace webrtc
@@ -17,17 +17,18 @@
 #include <sys/time.h>
 #include <time.h>
 
+#include "webrtc/base/atomicops.h"
+
 namespace webrtc {
 
-TracePosix::TracePosix()
-    : crit_sect_(*CriticalSectionWrapper::CreateCriticalSection()) {
+TracePosix::TracePosix() {
   struct timeval system_time_high_res;
   gettimeofday(&system_time_high_res, 0);
   prev_api_tick_count_ = prev_tick_count_ = system_time_high_res.tv_sec;
 }
 
 TracePosix::~TracePosix() {
-  delete &crit_sect_;
+  StopWriterThread();
 }
 
 int32_t TracePosix::AddTime(char* trace_message, const TraceLevel level) const {
@@ -40,17 +41,15 @@ int32_t TracePosix::AddTime(char* trace_message, const TraceLevel level) const {
     localtime_r(&system_time_high_res.tv_sec, &buffer);
 
   const uint32_t ms_time = system_time_high_res.tv_usec / 1000;
+  volatile int* prev_tick_count =
+      level == kTraceApiCall ? &prev_tick_count_ : &prev_api_tick_count_;
   uint32_t prev_tickCount = 0;
-  {
-    CriticalSectionScoped lock(&crit_sect_);
-    if (level == kTraceApiCall) {
-      prev_tickCount = prev_tick_count_;
-      prev_tick_count_ = ms_time;
-    } else {
-      prev_tickCount = prev_api_tick_count_;
-      prev_api_tick_count_ = ms_time;
-    }
-  }
+  int prev;
+  do {
+    prev = rtc::AtomicOps::AcquireLoad(prev_tick_count);
+  } while (rtc::AtomicOps::CompareAndSwap(prev_tick_count, prev,
+                                          static_cast<int>(ms_time)) != prev);
+  prev_tickCount = static_cast<uint32_t>(prev);
 
   uint32_t dw_delta_time = ms_time - prev_tickCount;
   if (prev_tickCount == 0) {
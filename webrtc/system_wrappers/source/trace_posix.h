@@ -11,7 +11,6 @@
 #ifndef WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_POSIX_H_
 #define WEBRTC_SYSTEM_WRAPPERS_SOURCE_TRACE_POSIX_H_
 
-#include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/source/trace_impl.h"
 
 namespace webrtc {
@@ -28,10 +27,9 @@ class TracePosix : public TraceImpl {
   int32_t AddDateTimeInfo(char* trace_message) const override;
 
  private:
-  volatile mutable uint32_t  prev_api_tick_count_;
-  volatile mutable uint32_t  prev_tick_count_;
-
-  CriticalSectionWrapper& crit_sect_;
+  // Updated with a compare-and-swap, so that AddTime() takes no lock.
+  volatile mutable int prev_api_tick_count_;
+  volatile mutable int prev_tick_count_;
 };
 
 }  // namespace webrtc
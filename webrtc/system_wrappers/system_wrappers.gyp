@@ -32,6 +32,8 @@
         'include/field_trial.h',
         'include/file_wrapper.h',
         'include/fix_interlocked_exchange_pointer_win.h',
+        'include/latency_histogram.h',
+        'include/lock_free_pointer.h',
         'include/logcat_trace_context.h',
         'include/logging.h',
         'include/metrics.h',
@@ -78,6 +80,7 @@
         'source/event_timer_win.h',
         'source/file_impl.cc',
         'source/file_impl.h',
+        'source/latency_histogram.cc',
         'source/logcat_trace_context.cc',
         'source/logging.cc',
         'source/rtp_to_ntp.cc',
@@ -24,6 +24,8 @@
         'source/clock_unittest.cc',
         'source/condition_variable_unittest.cc',
         'source/critical_section_unittest.cc',
+        'source/latency_histogram_unittest.cc',
+        'source/lock_free_pointer_unittest.cc',
         'source/logging_unittest.cc',
         'source/data_log_unittest.cc',
         'source/data_log_unittest_disabled.cc',
@@ -11,10 +11,14 @@
 #include "webrtc/test/fake_network_pipe.h"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <math.h>
+#include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <limits>
 
+#include "webrtc/base/checks.h"
 #include "webrtc/call.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
@@ -36,6 +40,89 @@ static bool UniformLoss(int loss_percent) {
   return outcome < loss_percent;
 }
 
+bool FakeNetworkPipe::LinkTrace::ReadFromFile(const std::string& path,
+                                              LinkTrace* trace) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file)
+    return false;
+  trace->entries.clear();
+  trace->duration_ms = 0;
+  Entry entry;
+  int64_t time_ms;
+  bool valid = true;
+  while (fscanf(file, "%" SCNd64 " %d %d %d", &time_ms,
+                &entry.link_capacity_kbps, &entry.queue_delay_ms,
+                &entry.loss_percent) == 4) {
+    if (!trace->entries.empty() && time_ms < trace->entries.back().time_ms) {
+      valid = false;
+      break;
+    }
+    entry.time_ms = time_ms;
+    trace->entries.push_back(entry);
+  }
+  valid &= feof(file) != 0;
+  fclose(file);
+  if (!valid || trace->entries.size() < 2 || trace->entries[0].time_ms != 0)
+    return false;
+  trace->duration_ms = trace->entries.back().time_ms;
+  trace->entries.pop_back();
+  return true;
+}
+
+bool FakeNetworkPipe::LinkTrace::ReadFromMahimahiFile(const std::string& path,
+                                                      int64_t interval_ms,
+                                                      LinkTrace* trace) {
+  const int kBitsPerOpportunity = 1500 * 8;
+  RTC_DCHECK_GT(interval_ms, 0);
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file)
+    return false;
+  std::vector<int> opportunities;
+  int64_t time_ms;
+  int64_t last_time_ms = 0;
+  bool valid = true;
+  while (fscanf(file, "%" SCNd64, &time_ms) == 1) {
+    if (time_ms < last_time_ms) {
+      valid = false;
+      break;
+    }
+    last_time_ms = time_ms;
+    // An opportunity at the end of an interval belongs to it, as Mahimahi
+    // opportunities happen at the end of their ms.
+    size_t interval = time_ms == 0 ? 0 : (time_ms - 1) / interval_ms;
+    if (opportunities.size() <= interval)
+      opportunities.resize(interval + 1, 0);
+    ++opportunities[interval];
+  }
+  valid &= feof(file) != 0;
+  fclose(file);
+  if (!valid || last_time_ms == 0)
+    return false;
+  trace->entries.clear();
+  for (size_t i = 0; i < opportunities.size(); ++i) {
+    trace->entries.push_back(Entry(
+        i * interval_ms,
+        static_cast<int>(opportunities[i] * kBitsPerOpportunity / interval_ms),
+        0, 0));
+  }
+  trace->duration_ms = opportunities.size() * interval_ms;
+  return true;
+}
+
+int FakeNetworkPipe::LinkTrace::AverageCapacityKbps() const {
+  if (entries.empty())
+    return 0;
+  if (duration_ms == 0)
+    return entries.back().link_capacity_kbps;
+  int64_t total_bits = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    int64_t end_ms =
+        i + 1 < entries.size() ? entries[i + 1].time_ms : duration_ms;
+    total_bits += entries[i].link_capacity_kbps * (end_ms - entries[i].time_ms);
+  }
+  return static_cast<int>(total_bits / duration_ms);
+}
+
 class NetworkPacket {
  public:
   NetworkPacket(const uint8_t* data, size_t length, int64_t send_time,
@@ -75,6 +162,8 @@ FakeNetworkPipe::FakeNetworkPipe(Clock* clock,
     : clock_(clock),
       packet_receiver_(NULL),
       config_(config),
+      trace_start_ms_(clock_->TimeInMilliseconds()),
+      trace_link_free_us_(0),
       dropped_packets_(0),
       sent_packets_(0),
       total_packet_delay_(0),
@@ -97,7 +186,8 @@ void FakeNetworkPipe::SetReceiver(PacketReceiver* receiver) {
 
 void FakeNetworkPipe::SetConfig(const FakeNetworkPipe::Config& config) {
   rtc::CritScope crit(&lock_);
-  config_ = config;  // Shallow copy of the struct.
+  config_ = config;
+  trace_start_ms_ = clock_->TimeInMilliseconds();
 }
 
 void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
@@ -114,19 +204,28 @@ void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
   }
 
   int64_t time_now = clock_->TimeInMilliseconds();
+  int64_t arrival_time;
+  if (!config_.link_trace.entries.empty()) {
+    trace_link_free_us_ = TraceTransmissionEndUs(
+        std::max(time_now * 1000, trace_link_free_us_), data_length);
+    // Rounded up, so that the packet has been sent when it arrives.
+    arrival_time = trace_link_free_us_ == std::numeric_limits<int64_t>::max()
+                       ? trace_link_free_us_
+                       : (trace_link_free_us_ + 999) / 1000;
+  } else {
+    // Delay introduced by the link capacity.
+    int64_t capacity_delay_ms = 0;
+    if (config_.link_capacity_kbps > 0)
+      capacity_delay_ms = data_length / (config_.link_capacity_kbps / 8);
+    int64_t network_start_time = time_now;
 
-  // Delay introduced by the link capacity.
-  int64_t capacity_delay_ms = 0;
-  if (config_.link_capacity_kbps > 0)
-    capacity_delay_ms = data_length / (config_.link_capacity_kbps / 8);
-  int64_t network_start_time = time_now;
-
-  // Check if there already are packets on the link and change network start
-  // time if there is.
-  if (capacity_link_.size() > 0)
-    network_start_time = capacity_link_.back()->arrival_time();
+    // Check if there already are packets on the link and change network start
+    // time if there is.
+    if (capacity_link_.size() > 0)
+      network_start_time = capacity_link_.back()->arrival_time();
 
-  int64_t arrival_time = network_start_time + capacity_delay_ms;
+    arrival_time = network_start_time + capacity_delay_ms;
+  }
   NetworkPacket* packet = new NetworkPacket(data, data_length, time_now,
                                             arrival_time);
   capacity_link_.push(packet);
@@ -162,15 +261,23 @@ void FakeNetworkPipe::Process() {
       NetworkPacket* packet = capacity_link_.front();
       capacity_link_.pop();
 
+      int loss_percent = config_.loss_percent;
+      int queue_delay_ms = config_.queue_delay_ms;
+      if (!config_.link_trace.entries.empty()) {
+        const LinkTrace::Entry& entry = TraceEntryAt(packet->arrival_time());
+        loss_percent = entry.loss_percent;
+        queue_delay_ms = entry.queue_delay_ms;
+      }
+
       // Packets are randomly dropped after being affected by the bottleneck.
-      if (UniformLoss(config_.loss_percent)) {
+      if (UniformLoss(loss_percent)) {
         delete packet;
         continue;
       }
 
       // Add extra delay and jitter, but make sure the arrival time is not
       // earlier than the last packet in the queue.
-      int extra_delay = GaussianRandom(config_.queue_delay_ms,
+      int extra_delay = GaussianRandom(queue_delay_ms,
                                        config_.delay_standard_deviation_ms);
       if (delay_link_.size() > 0 &&
           packet->arrival_time() + extra_delay <
@@ -216,4 +323,61 @@ int64_t FakeNetworkPipe::TimeUntilNextProcess() const {
                            0);
 }
 
+const FakeNetworkPipe::LinkTrace::Entry& FakeNetworkPipe::TraceEntryAt(
+    int64_t time_ms) const {
+  const std::vector<LinkTrace::Entry>& entries = config_.link_trace.entries;
+  int64_t trace_time_ms = std::max<int64_t>(time_ms - trace_start_ms_, 0);
+  if (config_.link_trace.duration_ms > 0)
+    trace_time_ms %= config_.link_trace.duration_ms;
+  // The last entry at or before |trace_time_ms|.
+  size_t i = entries.size() - 1;
+  while (entries[i].time_ms > trace_time_ms)
+    --i;
+  return entries[i];
+}
+
+int64_t FakeNetworkPipe::TraceTransmissionEndUs(int64_t start_time_us,
+                                                size_t data_length) const {
+  const LinkTrace& trace = config_.link_trace;
+  const int64_t start_us = trace_start_ms_ * 1000;
+  const int64_t duration_us = trace.duration_ms * 1000;
+  int64_t bits_left = 8 * static_cast<int64_t>(data_length);
+  int64_t time_us = std::max(start_time_us, start_us);
+  // Bounds the search if no entry has any capacity.
+  int64_t idle_us = 0;
+  while (true) {
+    int64_t trace_time_us = time_us - start_us;
+    if (duration_us > 0)
+      trace_time_us %= duration_us;
+    size_t i = trace.entries.size() - 1;
+    while (trace.entries[i].time_ms * 1000 > trace_time_us)
+      --i;
+    int64_t end_us;
+    if (i + 1 < trace.entries.size())
+      end_us = trace.entries[i + 1].time_ms * 1000;
+    else if (duration_us > 0)
+      end_us = duration_us;
+    else
+      end_us = std::numeric_limits<int64_t>::max();
+    const int64_t capacity_kbps = trace.entries[i].link_capacity_kbps;
+    if (capacity_kbps > 0) {
+      idle_us = 0;
+      // kbps is the same as bits per ms.
+      int64_t needed_us =
+          (bits_left * 1000 + capacity_kbps - 1) / capacity_kbps;
+      if (needed_us <= end_us - trace_time_us)
+        return time_us + needed_us;
+      bits_left -= capacity_kbps * (end_us - trace_time_us) / 1000;
+    } else {
+      idle_us += end_us - trace_time_us;
+      if (end_us == std::numeric_limits<int64_t>::max() ||
+          (duration_us > 0 && idle_us > duration_us)) {
+        // The link is down for good.
+        return std::numeric_limits<int64_t>::max();
+      }
+    }
+    time_us += end_us - trace_time_us;
+  }
+}
+
 }  // namespace webrtc
@@ -12,6 +12,8 @@
 #define WEBRTC_TEST_FAKE_NETWORK_PIPE_H_
 
 #include <queue>
+#include <string>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -32,6 +34,47 @@ class PacketReceiver;
 // TODO(mflodman) Add random and bursty packet loss.
 class FakeNetworkPipe {
  public:
+  // Link conditions that change over time, e.g. recorded on a cellular
+  // network. Each entry holds from its |time_ms| until the |time_ms| of the
+  // next entry, and the trace repeats after |duration_ms|.
+  struct LinkTrace {
+    struct Entry {
+      Entry() {}
+      Entry(int64_t time_ms,
+            int link_capacity_kbps,
+            int queue_delay_ms,
+            int loss_percent)
+          : time_ms(time_ms),
+            link_capacity_kbps(link_capacity_kbps),
+            queue_delay_ms(queue_delay_ms),
+            loss_percent(loss_percent) {}
+      // Time relative to the start of the trace. The first entry is at 0.
+      int64_t time_ms = 0;
+      // Unlike in Config, a capacity of 0 means that the link is down.
+      int link_capacity_kbps = 0;
+      int queue_delay_ms = 0;
+      int loss_percent = 0;
+    };
+
+    // Reads a trace with one "time_ms capacity_kbps delay_ms loss_percent"
+    // entry per line. The duration is the time of the last entry, which only
+    // ends the trace.
+    static bool ReadFromFile(const std::string& path, LinkTrace* trace);
+    // Reads a Mahimahi trace, which has the time in ms of one delivery
+    // opportunity for a 1500 byte packet per line, and turns it into one
+    // entry per |interval_ms|. The delay and loss of the entries are 0.
+    static bool ReadFromMahimahiFile(const std::string& path,
+                                     int64_t interval_ms,
+                                     LinkTrace* trace);
+
+    // The average capacity over one repetition of the trace.
+    int AverageCapacityKbps() const;
+
+    std::vector<Entry> entries;
+    // 0 means that the last entry lasts forever.
+    int64_t duration_ms = 0;
+  };
+
   struct Config {
     Config() {}
     // Queue length in number of packets.
@@ -44,6 +87,9 @@ class FakeNetworkPipe {
     int link_capacity_kbps = 0;
     // Random packet loss.
     int loss_percent = 0;
+    // If not empty, the trace replaces the capacity, delay and loss above.
+    // It starts when the config is set.
+    LinkTrace link_trace;
   };
 
   FakeNetworkPipe(Clock* clock, const FakeNetworkPipe::Config& config);
@@ -70,6 +116,14 @@ class FakeNetworkPipe {
   size_t sent_packets() { return sent_packets_; }
 
  private:
+  const LinkTrace::Entry& TraceEntryAt(int64_t time_ms) const
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the time in us when a packet of |data_length| bytes that starts
+  // to be sent at |start_time_us| has been sent on the traced link.
+  int64_t TraceTransmissionEndUs(int64_t start_time_us,
+                                 size_t data_length) const
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   Clock* const clock_;
   mutable rtc::CriticalSection lock_;
   PacketReceiver* packet_receiver_;
@@ -78,6 +132,10 @@ class FakeNetworkPipe {
 
   // Link configuration.
   Config config_;
+  int64_t trace_start_ms_;
+  // When the traced link is done sending the last packet on it, in us to
+  // not lose the fractions of a ms between packets.
+  int64_t trace_link_free_us_;
 
   // Statistics.
   size_t dropped_packets_;
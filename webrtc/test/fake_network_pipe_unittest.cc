@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -15,6 +17,7 @@
 #include "webrtc/call.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/test/fake_network_pipe.h"
+#include "webrtc/test/testsupport/fileutils.h"
 
 using ::testing::_;
 using ::testing::AnyNumber;
@@ -308,4 +311,77 @@ TEST_F(FakeNetworkPipeTest, ChangingCapacityWithPacketsInPipeTest) {
   EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(0);
   pipe->Process();
 }
+
+// Verify that a link trace changes the capacity over time, and that the link
+// is down while the capacity is 0.
+TEST_F(FakeNetworkPipeTest, LinkTraceTest) {
+  FakeNetworkPipe::Config config;
+  config.link_trace.entries.push_back(
+      FakeNetworkPipe::LinkTrace::Entry(0, 80, 0, 0));
+  config.link_trace.entries.push_back(
+      FakeNetworkPipe::LinkTrace::Entry(1000, 0, 0, 0));
+  config.link_trace.entries.push_back(
+      FakeNetworkPipe::LinkTrace::Entry(1500, 160, 0, 0));
+  config.link_trace.duration_ms = 2000;
+  EXPECT_EQ(80, config.link_trace.AverageCapacityKbps());
+  rtc::scoped_ptr<FakeNetworkPipe> pipe(
+      new FakeNetworkPipe(&fake_clock_, config));
+  pipe->SetReceiver(receiver_.get());
+
+  // 100 ms per packet at 80 kbps, and 50 ms at 160 kbps.
+  const int kPacketSize = 1000;
+  SendPackets(pipe.get(), 12, kPacketSize);
+
+  fake_clock_.AdvanceTimeMilliseconds(999);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(9);
+  pipe->Process();
+
+  fake_clock_.AdvanceTimeMilliseconds(1);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(1);
+  pipe->Process();
+
+  // The link is down until 1500 ms.
+  fake_clock_.AdvanceTimeMilliseconds(549);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(0);
+  pipe->Process();
+
+  fake_clock_.AdvanceTimeMilliseconds(1);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(1);
+  pipe->Process();
+
+  fake_clock_.AdvanceTimeMilliseconds(50);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(1);
+  pipe->Process();
+  EXPECT_EQ(12u, pipe->sent_packets());
+
+  // The trace repeats, so a packet sent at 2000 ms sees 80 kbps again.
+  fake_clock_.AdvanceTimeMilliseconds(400);
+  SendPackets(pipe.get(), 1, kPacketSize);
+  fake_clock_.AdvanceTimeMilliseconds(99);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(0);
+  pipe->Process();
+  fake_clock_.AdvanceTimeMilliseconds(1);
+  EXPECT_CALL(*receiver_, DeliverPacket(_, _, _, _)).Times(1);
+  pipe->Process();
+}
+
+TEST_F(FakeNetworkPipeTest, ReadsMahimahiTrace) {
+  const std::string filename = test::OutputPath() + "mahimahi_trace.txt";
+  FILE* file = fopen(filename.c_str(), "w");
+  ASSERT_TRUE(file != nullptr);
+  // Two opportunities in each 100 ms.
+  fprintf(file, "10\n100\n150\n200\n");
+  fclose(file);
+
+  FakeNetworkPipe::LinkTrace trace;
+  ASSERT_TRUE(
+      FakeNetworkPipe::LinkTrace::ReadFromMahimahiFile(filename, 100, &trace));
+  remove(filename.c_str());
+  ASSERT_EQ(2u, trace.entries.size());
+  EXPECT_EQ(200, trace.duration_ms);
+  EXPECT_EQ(0, trace.entries[0].time_ms);
+  EXPECT_EQ(2 * 1500 * 8 / 100, trace.entries[0].link_capacity_kbps);
+  EXPECT_EQ(100, trace.entries[1].time_ms);
+  EXPECT_EQ(2 * 1500 * 8 / 100, trace.entries[1].link_capacity_kbps);
+}
 }  // namespace webrtc
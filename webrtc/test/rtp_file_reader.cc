@@ -11,7 +11,9 @@
 #include "webrtc/test/rtp_file_reader.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -21,6 +23,11 @@
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
+#if defined(WEBRTC_POSIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace webrtc {
 namespace test {
 
@@ -43,67 +50,184 @@ static uint16_t kPacketHeaderSize = 8;
     }                                                  \
   } while (0)
 
-bool ReadUint32(uint32_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 4; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
+// Reads a file through a read-only memory mapping where supported, and
+// through stdio otherwise.
+class InputFile {
+ public:
+  InputFile()
+      : file_(NULL), mapped_data_(NULL), mapped_size_(0), position_(0) {}
+  ~InputFile() {
+#if defined(WEBRTC_POSIX)
+    if (mapped_data_ != NULL) {
+      RTC_CHECK_EQ(0,
+                   munmap(const_cast<uint8_t*>(mapped_data_), mapped_size_));
+    }
+#endif
+    if (file_ != NULL)
+      fclose(file_);
+  }
+
+  bool Open(const std::string& filename) {
+    file_ = fopen(filename.c_str(), "rb");
+    if (file_ == NULL)
       return false;
-    *out |= tmp;
+    Map();
+    return true;
+  }
+
+  bool mapped() const { return mapped_data_ != NULL; }
+
+  // Returns the next |length| bytes of the file and moves past them, or NULL
+  // if there are fewer left. A mapped file returns a pointer into the
+  // mapping; otherwise the bytes are read into |buffer|, which must hold
+  // |length| bytes, and |buffer| is returned.
+  const uint8_t* Read(size_t length, uint8_t* buffer) {
+    if (mapped_data_ != NULL) {
+      if (mapped_size_ - position_ < length)
+        return NULL;
+      const uint8_t* data = &mapped_data_[position_];
+      position_ += length;
+      return data;
+    }
+    return fread(buffer, 1, length, file_) == length ? buffer : NULL;
   }
-  return true;
-}
 
-bool ReadUint16(uint16_t* out, FILE* file) {
-  *out = 0;
-  for (size_t i = 0; i < 2; ++i) {
-    *out <<= 8;
-    uint8_t tmp;
-    if (fread(&tmp, 1, sizeof(uint8_t), file) != sizeof(uint8_t))
+  // Reads a line like fgets() does.
+  bool ReadLine(char* line, size_t max_length) {
+    if (mapped_data_ == NULL)
+      return fgets(line, static_cast<int>(max_length), file_) != NULL;
+    if (position_ == mapped_size_ || max_length == 0)
       return false;
-    *out |= tmp;
+    size_t i = 0;
+    while (i + 1 < max_length && position_ < mapped_size_) {
+      line[i] = static_cast<char>(mapped_data_[position_++]);
+      if (line[i++] == '\n')
+        break;
+    }
+    line[i] = '\0';
+    return true;
   }
+
+ private:
+  void Map() {
+#if defined(WEBRTC_POSIX)
+    struct stat file_stat;
+    if (fstat(fileno(file_), &file_stat) != 0 || file_stat.st_size <= 0 ||
+        static_cast<uint64_t>(file_stat.st_size) >
+            std::numeric_limits<size_t>::max()) {
+      return;
+    }
+    void* mapped = mmap(NULL, static_cast<size_t>(file_stat.st_size),
+                        PROT_READ, MAP_PRIVATE, fileno(file_), 0);
+    if (mapped == MAP_FAILED)
+      return;
+    // The file is read front to back, once.
+    madvise(mapped, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+    mapped_data_ = static_cast<const uint8_t*>(mapped);
+    mapped_size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+  }
+
+  FILE* file_;
+  const uint8_t* mapped_data_;
+  size_t mapped_size_;
+  size_t position_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(InputFile);
+};
+
+bool ReadUint32(uint32_t* out, InputFile* file) {
+  uint8_t buffer[4];
+  const uint8_t* data = file->Read(sizeof(buffer), buffer);
+  if (data == NULL)
+    return false;
+  *out = (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
   return true;
 }
 
+bool ReadUint16(uint16_t* out, InputFile* file) {
+  uint8_t buffer[2];
+  const uint8_t* data = file->Read(sizeof(buffer), buffer);
+  if (data == NULL)
+    return false;
+  *out = static_cast<uint16_t>((data[0] << 8) | data[1]);
+  return true;
+}
+
+// Copies |view| into |packet|, unless it already points into it.
+void CopyPacket(const RtpPacketView& view, RtpPacket* packet) {
+  if (view.length > RtpPacket::kMaxPacketBufferSize) {
+    FATAL() << "Packet is too large to fit: " << view.length << " bytes vs "
+            << RtpPacket::kMaxPacketBufferSize
+            << " bytes allocated. Consider increasing the buffer "
+               "size";
+  }
+  if (view.data != packet->data)
+    memcpy(packet->data, view.data, view.length);
+  packet->length = view.length;
+  packet->original_length = view.original_length;
+  packet->time_ms = view.time_ms;
+}
+
 class RtpFileReaderImpl : public RtpFileReader {
  public:
   virtual bool Init(const std::string& filename,
                     const std::set<uint32_t>& ssrc_filter) = 0;
+
+  // Readers that can't avoid the copy read into a buffer of their own.
+  bool NextPacketView(RtpPacketView* packet) override {
+    if (!NextPacket(&buffer_))
+      return false;
+    packet->data = buffer_.data;
+    packet->length = buffer_.length;
+    packet->original_length = buffer_.original_length;
+    packet->time_ms = buffer_.time_ms;
+    return true;
+  }
+
+ protected:
+  RtpPacket buffer_;
 };
 
 class InterleavedRtpFileReader : public RtpFileReaderImpl {
  public:
-  virtual ~InterleavedRtpFileReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
-  }
+  virtual ~InterleavedRtpFileReader() {}
 
   virtual bool Init(const std::string& filename,
                     const std::set<uint32_t>& ssrc_filter) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
+    if (!file_.Open(filename)) {
       printf("ERROR: Can't open file: %s\n", filename.c_str());
       return false;
     }
     return true;
   }
   virtual bool NextPacket(RtpPacket* packet) {
-    assert(file_ != NULL);
-    packet->length = RtpPacket::kMaxPacketBufferSize;
+    RtpPacketView view;
+    if (!ReadPacket(&view, packet->data))
+      return false;
+    CopyPacket(view, packet);
+    return true;
+  }
+  bool NextPacketView(RtpPacketView* packet) override {
+    return ReadPacket(packet, buffer_.data);
+  }
+
+ private:
+  // Reads the next packet into |buffer|, of RtpPacket::kMaxPacketBufferSize
+  // bytes, unless the file is mapped.
+  bool ReadPacket(RtpPacketView* packet, uint8_t* buffer) {
     uint32_t len = 0;
-    TRY(ReadUint32(&len, file_));
-    if (packet->length < len) {
+    TRY(ReadUint32(&len, &file_));
+    if (!file_.mapped() && RtpPacket::kMaxPacketBufferSize < len) {
       FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
+              << RtpPacket::kMaxPacketBufferSize
               << " bytes allocated. Consider increasing the buffer "
                  "size";
     }
-    if (fread(packet->data, 1, len, file_) != len)
-      return false;
+    packet->data = file_.Read(len, buffer);
+    TRY(packet->data != NULL);
 
     packet->length = len;
     packet->original_length = len;
@@ -112,8 +236,7 @@ class InterleavedRtpFileReader : public RtpFileReaderImpl {
     return true;
   }
 
- private:
-  FILE* file_ = NULL;
+  InputFile file_;
   int64_t time_ms_ = 0;
 };
 
@@ -121,24 +244,18 @@ class InterleavedRtpFileReader : public RtpFileReaderImpl {
 // http://www.cs.columbia.edu/irt/software/rtptools/
 class RtpDumpReader : public RtpFileReaderImpl {
  public:
-  RtpDumpReader() : file_(NULL) {}
-  virtual ~RtpDumpReader() {
-    if (file_ != NULL) {
-      fclose(file_);
-      file_ = NULL;
-    }
-  }
+  RtpDumpReader() {}
+  virtual ~RtpDumpReader() {}
 
   bool Init(const std::string& filename,
             const std::set<uint32_t>& ssrc_filter) {
-    file_ = fopen(filename.c_str(), "rb");
-    if (file_ == NULL) {
+    if (!file_.Open(filename)) {
       printf("ERROR: Can't open file: %s\n", filename.c_str());
       return false;
     }
 
     char firstline[kFirstLineLength + 1] = {0};
-    if (fgets(firstline, kFirstLineLength, file_) == NULL) {
+    if (!file_.ReadLine(firstline, kFirstLineLength)) {
       DEBUG_LOG("ERROR: Can't read from file\n");
       return false;
     }
@@ -162,37 +279,48 @@ class RtpDumpReader : public RtpFileReaderImpl {
     uint32_t source;
     uint16_t port;
     uint16_t padding;
-    TRY(ReadUint32(&start_sec, file_));
-    TRY(ReadUint32(&start_usec, file_));
-    TRY(ReadUint32(&source, file_));
-    TRY(ReadUint16(&port, file_));
-    TRY(ReadUint16(&padding, file_));
+    TRY(ReadUint32(&start_sec, &file_));
+    TRY(ReadUint32(&start_usec, &file_));
+    TRY(ReadUint32(&source, &file_));
+    TRY(ReadUint16(&port, &file_));
+    TRY(ReadUint16(&padding, &file_));
 
     return true;
   }
 
   bool NextPacket(RtpPacket* packet) override {
-    uint8_t* rtp_data = packet->data;
-    packet->length = RtpPacket::kMaxPacketBufferSize;
+    RtpPacketView view;
+    if (!ReadPacket(&view, packet->data))
+      return false;
+    CopyPacket(view, packet);
+    return true;
+  }
+
+  bool NextPacketView(RtpPacketView* packet) override {
+    return ReadPacket(packet, buffer_.data);
+  }
 
+ private:
+  // Reads the next packet into |buffer|, of RtpPacket::kMaxPacketBufferSize
+  // bytes, unless the file is mapped.
+  bool ReadPacket(RtpPacketView* packet, uint8_t* buffer) {
     uint16_t len;
     uint16_t plen;
     uint32_t offset;
-    TRY(ReadUint16(&len, file_));
-    TRY(ReadUint16(&plen, file_));
-    TRY(ReadUint32(&offset, file_));
+    TRY(ReadUint16(&len, &file_));
+    TRY(ReadUint16(&plen, &file_));
+    TRY(ReadUint32(&offset, &file_));
 
     // Use 'len' here because a 'plen' of 0 specifies rtcp.
     len -= kPacketHeaderSize;
-    if (packet->length < len) {
+    if (!file_.mapped() && RtpPacket::kMaxPacketBufferSize < len) {
       FATAL() << "Packet is too large to fit: " << len << " bytes vs "
-              << packet->length
+              << RtpPacket::kMaxPacketBufferSize
               << " bytes allocated. Consider increasing the buffer "
                  "size";
     }
-    if (fread(rtp_data, 1, len, file_) != len) {
-      return false;
-    }
+    packet->data = file_.Read(len, buffer);
+    TRY(packet->data != NULL);
 
     packet->length = len;
     packet->original_length = plen;
@@ -200,8 +328,7 @@ class RtpDumpReader : public RtpFileReaderImpl {
     return true;
   }
 
- private:
-  FILE* file_;
+  InputFile file_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpDumpReader);
 };
@@ -31,6 +31,17 @@ struct RtpPacket {
   uint32_t time_ms;
 };
 
+// A packet as read by RtpFileReader::NextPacketView(), pointing into memory
+// owned by the reader instead of holding a copy.
+struct RtpPacketView {
+  const uint8_t* data;
+  size_t length;
+  // The length the packet had on wire.
+  size_t original_length;
+
+  uint32_t time_ms;
+};
+
 class RtpFileReader {
  public:
   enum FileFormat { kPcap, kRtpDump, kLengthPacketInterleaved };
@@ -43,6 +54,12 @@ class RtpFileReader {
                                const std::set<uint32_t>& ssrc_filter);
 
   virtual bool NextPacket(RtpPacket* packet) = 0;
+
+  // Like NextPacket(), but without copying the packet where the reader can
+  // avoid it: RTP dumps are memory mapped where supported, and the packets
+  // point straight into the file. |packet->data| is valid until the next call
+  // to NextPacket() or NextPacketView().
+  virtual bool NextPacketView(RtpPacketView* packet) = 0;
 };
 }  // namespace test
 }  // namespace webrtc
@@ -11,80 +11,96 @@
 #include "webrtc/test/rtp_file_writer.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include <string>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/scoped_ptr.h"
 
 namespace webrtc {
 namespace test {
 
 static const uint16_t kPacketHeaderSize = 8;
 static const char kFirstLine[] = "#!rtpplay1.0 0.0.0.0/0\n";
+// Number of bytes RtpDumpWriter collects before writing them, 256 KiB.
+static const size_t kWriteBufferSize = 256 * 1024;
 
 // Write RTP packets to file in rtpdump format, as documented at:
 // http://www.cs.columbia.edu/irt/software/rtptools/
+// The packets are collected in a buffer and written in large blocks; the
+// file is complete once the writer has been destroyed.
 class RtpDumpWriter : public RtpFileWriter {
  public:
-  explicit RtpDumpWriter(FILE* file) : file_(file) {
+  explicit RtpDumpWriter(FILE* file)
+      : file_(file), buffer_(new uint8_t[kWriteBufferSize]), buffered_(0) {
     RTC_CHECK(file_ != NULL);
     Init();
   }
   virtual ~RtpDumpWriter() {
     if (file_ != NULL) {
+      Flush();
       fclose(file_);
       file_ = NULL;
     }
   }
 
   bool WritePacket(const RtpPacket* packet) override {
+    RTC_CHECK(packet->length <= RtpPacket::kMaxPacketBufferSize);
+    if (buffered_ + kPacketHeaderSize + packet->length > kWriteBufferSize &&
+        !Flush()) {
+      return false;
+    }
     uint16_t len = static_cast<uint16_t>(packet->length + kPacketHeaderSize);
     uint16_t plen = static_cast<uint16_t>(packet->original_length);
     uint32_t offset = packet->time_ms;
-    RTC_CHECK(WriteUint16(len));
-    RTC_CHECK(WriteUint16(plen));
-    RTC_CHECK(WriteUint32(offset));
-    return fwrite(packet->data, sizeof(uint8_t), packet->length, file_) ==
-           packet->length;
+    WriteUint16(len);
+    WriteUint16(plen);
+    WriteUint32(offset);
+    memcpy(&buffer_[buffered_], packet->data, packet->length);
+    buffered_ += packet->length;
+    return true;
   }
 
  private:
   bool Init() {
-    fprintf(file_, "%s", kFirstLine);
+    memcpy(buffer_.get(), kFirstLine, sizeof(kFirstLine) - 1);
+    buffered_ = sizeof(kFirstLine) - 1;
 
-    RTC_CHECK(WriteUint32(0));
-    RTC_CHECK(WriteUint32(0));
-    RTC_CHECK(WriteUint32(0));
-    RTC_CHECK(WriteUint16(0));
-    RTC_CHECK(WriteUint16(0));
+    WriteUint32(0);
+    WriteUint32(0);
+    WriteUint32(0);
+    WriteUint16(0);
+    WriteUint16(0);
 
     return true;
   }
 
-  bool WriteUint32(uint32_t in) {
+  // Writes the buffered bytes to the file.
+  bool Flush() {
+    const bool ok =
+        fwrite(buffer_.get(), sizeof(uint8_t), buffered_, file_) == buffered_;
+    buffered_ = 0;
+    return ok;
+  }
+
+  void WriteUint32(uint32_t in) {
     // Loop through shifts = {24, 16, 8, 0}.
-    for (int shifts = 24; shifts >= 0; shifts -= 8) {
-      uint8_t tmp = static_cast<uint8_t>((in >> shifts) & 0xFF);
-      if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-        return false;
-    }
-    return true;
+    for (int shifts = 24; shifts >= 0; shifts -= 8)
+      buffer_[buffered_++] = static_cast<uint8_t>((in >> shifts) & 0xFF);
   }
 
-  bool WriteUint16(uint16_t in) {
+  void WriteUint16(uint16_t in) {
     // Write 8 MSBs.
-    uint8_t tmp = static_cast<uint8_t>((in >> 8) & 0xFF);
-    if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-      return false;
+    buffer_[buffered_++] = static_cast<uint8_t>((in >> 8) & 0xFF);
     // Write 8 LSBs.
-    tmp = static_cast<uint8_t>(in & 0xFF);
-    if (fwrite(&tmp, sizeof(uint8_t), 1, file_) != 1)
-      return false;
-    return true;
+    buffer_[buffered_++] = static_cast<uint8_t>(in & 0xFF);
   }
 
   FILE* file_;
+  rtc::scoped_ptr<uint8_t[]> buffer_;
+  size_t buffered_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpDumpWriter);
 };
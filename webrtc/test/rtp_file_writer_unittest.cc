@@ -38,6 +38,20 @@ class RtpFileWriterTest : public ::testing::Test {
     }
   }
 
+  // Writes |num_packets| packets of |length| bytes, more than the writer
+  // buffers at once.
+  void WriteLargeRtpPackets(int num_packets, size_t length) {
+    ASSERT_TRUE(rtp_writer_.get() != NULL);
+    test::RtpPacket packet;
+    for (int i = 1; i <= num_packets; ++i) {
+      packet.length = length;
+      packet.original_length = length + i;
+      packet.time_ms = i;
+      memset(packet.data, i, packet.length);
+      EXPECT_TRUE(rtp_writer_->WritePacket(&packet));
+    }
+  }
+
   void CloseOutputFile() { rtp_writer_.reset(); }
 
   void VerifyFileContents(int expected_packets) {
@@ -60,6 +74,26 @@ class RtpFileWriterTest : public ::testing::Test {
     EXPECT_EQ(expected_packets, i);
   }
 
+  void VerifyLargePacketViews(int expected_packets, size_t length) {
+    ASSERT_TRUE(rtp_writer_.get() == NULL)
+        << "Must call CloseOutputFile before VerifyLargePacketViews";
+    rtc::scoped_ptr<test::RtpFileReader> rtp_reader(
+        test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, filename_));
+    ASSERT_TRUE(rtp_reader.get() != NULL);
+    test::RtpPacketView packet;
+    int i = 0;
+    while (rtp_reader->NextPacketView(&packet)) {
+      ++i;
+      ASSERT_EQ(length, packet.length);
+      EXPECT_EQ(length + i, packet.original_length);
+      EXPECT_EQ(static_cast<uint32_t>(i), packet.time_ms);
+      for (size_t j = 0; j < length; ++j) {
+        ASSERT_EQ(static_cast<uint8_t>(i), packet.data[j]);
+      }
+    }
+    EXPECT_EQ(expected_packets, i);
+  }
+
  private:
   rtc::scoped_ptr<test::RtpFileWriter> rtp_writer_;
   std::string filename_;
@@ -72,4 +106,11 @@ TEST_F(RtpFileWriterTest, WriteToRtpDump) {
   VerifyFileContents(10);
 }
 
+TEST_F(RtpFileWriterTest, WriteAndViewLargeRtpDump) {
+  Init("test_rtp_file_writer_large.rtp");
+  WriteLargeRtpPackets(300, 3000);
+  CloseOutputFile();
+  VerifyLargePacketViews(300, 3000);
+}
+
 }  // namespace webrtc
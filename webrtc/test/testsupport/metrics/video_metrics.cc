@@ -14,8 +14,12 @@
 #include <stdio.h>
 
 #include <algorithm>  // min_element, max_element
+#include <vector>
 
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/video_frame.h"
 
 namespace webrtc {
@@ -32,25 +36,112 @@ static bool LessForFrameResultValue(const FrameResult& s1,
 
 enum VideoMetricsType { kPSNR, kSSIM, kBoth };
 
-// Calculates metrics for a frame and adds statistics to the result for it.
-void CalculateFrame(VideoMetricsType video_metrics_type,
-                    const VideoFrame* ref,
-                    const VideoFrame* test,
-                    int frame_number,
-                    QualityMetricsResult* result) {
-  FrameResult frame_result = {0, 0};
-  frame_result.frame_number = frame_number;
-  switch (video_metrics_type) {
-    case kPSNR:
-      frame_result.value = I420PSNR(ref, test);
-      break;
-    case kSSIM:
-      frame_result.value = I420SSIM(ref, test);
-      break;
-    default:
-      assert(false);
+// Reads every |frame_step|-th frame pair of a reference and a test file,
+// starting at |first_frame|, and calculates their metrics. Each worker thread
+// runs one of these, with its own file handles, and writes only its own
+// frames of the results.
+class FrameComparer {
+ public:
+  FrameComparer(VideoMetricsType video_metrics_type,
+                const char* ref_filename,
+                const char* test_filename,
+                int width,
+                int height,
+                int first_frame,
+                int frame_step,
+                int num_frames,
+                std::vector<FrameResult>* psnr_frames,
+                std::vector<FrameResult>* ssim_frames)
+      : video_metrics_type_(video_metrics_type),
+        ref_filename_(ref_filename),
+        test_filename_(test_filename),
+        width_(width),
+        height_(height),
+        first_frame_(first_frame),
+        frame_step_(frame_step),
+        num_frames_(num_frames),
+        psnr_frames_(psnr_frames),
+        ssim_frames_(ssim_frames) {}
+
+  static bool Run(void* obj) {
+    static_cast<FrameComparer*>(obj)->CompareFrames();
+    return false;
+  }
+
+  void CompareFrames() {
+    FILE* ref_fp = fopen(ref_filename_, "rb");
+    FILE* test_fp = fopen(test_filename_, "rb");
+    if (ref_fp != NULL && test_fp != NULL) {
+      const size_t frame_length = 3 * width_ * height_ >> 1;
+      const long skip_length = static_cast<long>(frame_length) *
+                               (frame_step_ - 1);
+      VideoFrame ref_frame;
+      VideoFrame test_frame;
+      rtc::scoped_ptr<uint8_t[]> ref_buffer(new uint8_t[frame_length]);
+      rtc::scoped_ptr<uint8_t[]> test_buffer(new uint8_t[frame_length]);
+
+      // Set decoded image parameters.
+      int half_width = (width_ + 1) / 2;
+      ref_frame.CreateEmptyFrame(width_, height_, width_, half_width,
+                                 half_width);
+      test_frame.CreateEmptyFrame(width_, height_, width_, half_width,
+                                  half_width);
+
+      for (int i = 0; i < first_frame_; ++i) {
+        fseek(ref_fp, static_cast<long>(frame_length), SEEK_CUR);
+        fseek(test_fp, static_cast<long>(frame_length), SEEK_CUR);
+      }
+      for (int frame_number = first_frame_; frame_number < num_frames_;
+           frame_number += frame_step_) {
+        if (fread(ref_buffer.get(), 1, frame_length, ref_fp) != frame_length ||
+            fread(test_buffer.get(), 1, frame_length, test_fp) !=
+                frame_length) {
+          break;
+        }
+        // Converting from buffer to plane representation.
+        ConvertToI420(kI420, ref_buffer.get(), 0, 0, width_, height_, 0,
+                      kVideoRotation_0, &ref_frame);
+        ConvertToI420(kI420, test_buffer.get(), 0, 0, width_, height_, 0,
+                      kVideoRotation_0, &test_frame);
+        if (video_metrics_type_ != kSSIM) {
+          (*psnr_frames_)[frame_number].frame_number = frame_number;
+          (*psnr_frames_)[frame_number].value =
+              I420PSNR(&ref_frame, &test_frame);
+        }
+        if (video_metrics_type_ != kPSNR) {
+          (*ssim_frames_)[frame_number].frame_number = frame_number;
+          (*ssim_frames_)[frame_number].value =
+              I420SSIM(&ref_frame, &test_frame);
+        }
+        fseek(ref_fp, skip_length, SEEK_CUR);
+        fseek(test_fp, skip_length, SEEK_CUR);
+      }
+    }
+    if (ref_fp != NULL)
+      fclose(ref_fp);
+    if (test_fp != NULL)
+      fclose(test_fp);
   }
-  result->frames.push_back(frame_result);
+
+ private:
+  const VideoMetricsType video_metrics_type_;
+  const char* const ref_filename_;
+  const char* const test_filename_;
+  const int width_;
+  const int height_;
+  const int first_frame_;
+  const int frame_step_;
+  const int num_frames_;
+  std::vector<FrameResult>* const psnr_frames_;
+  std::vector<FrameResult>* const ssim_frames_;
+};
+
+// Returns the size of the open file |fp|.
+static long FileSize(FILE* fp) {
+  fseek(fp, 0, SEEK_END);
+  const long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  return size;
 }
 
 // Calculates average, min and max values for the supplied struct, if non-NULL.
@@ -105,61 +196,57 @@ int CalculateMetrics(VideoMetricsType video_metrics_type,
     fclose(ref_fp);
     return -2;
   }
-  int frame_number = 0;
-
-  // Read reference and test frames.
+  // Only frames up to the end of the shorter file are compared.
   const size_t frame_length = 3 * width * height >> 1;
-  VideoFrame ref_frame;
-  VideoFrame test_frame;
-  rtc::scoped_ptr<uint8_t[]> ref_buffer(new uint8_t[frame_length]);
-  rtc::scoped_ptr<uint8_t[]> test_buffer(new uint8_t[frame_length]);
-
-  // Set decoded image parameters.
-  int half_width = (width + 1) / 2;
-  ref_frame.CreateEmptyFrame(width, height, width, half_width, half_width);
-  test_frame.CreateEmptyFrame(width, height, width, half_width, half_width);
-
-  size_t ref_bytes = fread(ref_buffer.get(), 1, frame_length, ref_fp);
-  size_t test_bytes = fread(test_buffer.get(), 1, frame_length, test_fp);
-  while (ref_bytes == frame_length && test_bytes == frame_length) {
-    // Converting from buffer to plane representation.
-    ConvertToI420(kI420, ref_buffer.get(), 0, 0, width, height, 0,
-                  kVideoRotation_0, &ref_frame);
-    ConvertToI420(kI420, test_buffer.get(), 0, 0, width, height, 0,
-                  kVideoRotation_0, &test_frame);
-    switch (video_metrics_type) {
-      case kPSNR:
-        CalculateFrame(kPSNR, &ref_frame, &test_frame, frame_number,
-                       psnr_result);
-        break;
-      case kSSIM:
-        CalculateFrame(kSSIM, &ref_frame, &test_frame, frame_number,
-                       ssim_result);
-        break;
-      case kBoth:
-        CalculateFrame(kPSNR, &ref_frame, &test_frame, frame_number,
-                       psnr_result);
-        CalculateFrame(kSSIM, &ref_frame, &test_frame, frame_number,
-                       ssim_result);
-        break;
-    }
-    frame_number++;
-    ref_bytes = fread(ref_buffer.get(), 1, frame_length, ref_fp);
-    test_bytes = fread(test_buffer.get(), 1, frame_length, test_fp);
-  }
-  int return_code = 0;
-  if (frame_number == 0) {
+  const long file_size = std::min(FileSize(ref_fp), FileSize(test_fp));
+  const int num_frames =
+      file_size > 0 ? static_cast<int>(file_size / frame_length) : 0;
+  fclose(ref_fp);
+  fclose(test_fp);
+  if (num_frames == 0) {
     fprintf(stderr, "Tried to measure video metrics from empty files "
             "(reference file: %s  test file: %s)\n", ref_filename,
             test_filename);
-    return_code = -3;
-  } else {
+    return -3;
+  }
+
+  // The frames are independent, so they are split across the cores, each
+  // worker taking every |num_workers|-th frame.
+  std::vector<FrameResult> psnr_frames(
+      video_metrics_type != kSSIM ? num_frames : 0);
+  std::vector<FrameResult> ssim_frames(
+      video_metrics_type != kPSNR ? num_frames : 0);
+  const int num_workers = std::max(
+      1, std::min(num_frames,
+                  static_cast<int>(CpuInfo::DetectNumberOfCores())));
+  std::vector<rtc::scoped_ptr<FrameComparer>> comparers;
+  std::vector<rtc::scoped_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_workers; ++i) {
+    comparers.push_back(rtc::scoped_ptr<FrameComparer>(new FrameComparer(
+        video_metrics_type, ref_filename, test_filename, width, height, i,
+        num_workers, num_frames, &psnr_frames, &ssim_frames)));
+  }
+  for (int i = 1; i < num_workers; ++i) {
+    threads.push_back(rtc::scoped_ptr<rtc::PlatformThread>(
+        new rtc::PlatformThread(&FrameComparer::Run, comparers[i].get(),
+                                "VideoMetrics")));
+    threads.back()->Start();
+  }
+  comparers[0]->CompareFrames();
+  for (const auto& thread : threads)
+    thread->Stop();
+
+  if (psnr_result != NULL) {
+    psnr_result->frames.insert(psnr_result->frames.end(), psnr_frames.begin(),
+                               psnr_frames.end());
     CalculateStats(psnr_result);
+  }
+  if (ssim_result != NULL) {
+    ssim_result->frames.insert(ssim_result->frames.end(), ssim_frames.begin(),
+                               ssim_frames.end());
     CalculateStats(ssim_result);
   }
-  fclose(ref_fp);
-  fclose(test_fp);
-  return return_code;
+  return 0;
 }
 
 int I420MetricsFromFiles(const char* ref_filename,
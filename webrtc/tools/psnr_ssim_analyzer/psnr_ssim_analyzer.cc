@@ -8,21 +8,151 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-#include <map>
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+#include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/tools/frame_analyzer/video_quality_analysis.h"
 #include "webrtc/tools/simple_command_line_parser.h"
 
-#define MAX_NUM_FRAMES_PER_FILE INT_MAX
+// Frames read ahead per worker thread, so that the threads get even work.
+const int kFramesPerThread = 4;
+// Interval between checks for new frames in a test file still being written.
+const int kStreamingPollIntervalMs = 100;
+
+// Reads the frames of an I420 YUV or Y4M file in order, keeping the file open
+// instead of reopening it and seeking for every frame. In streaming mode, the
+// end of the file is taken as the point the writer has got to, and the reader
+// waits for more frames until none have been appended for |timeout_ms|.
+class SequentialFrameReader {
+ public:
+  SequentialFrameReader(const char* file_name,
+                        size_t frame_size,
+                        bool y4m,
+                        bool streaming,
+                        int timeout_ms)
+      : file_(fopen(file_name, "rb")),
+        frame_size_(frame_size),
+        y4m_(y4m),
+        streaming_(streaming),
+        timeout_ms_(timeout_ms) {
+    if (file_ == NULL) {
+      fprintf(stderr, "Couldn't open input file for reading: %s\n",
+              file_name);
+    } else if (y4m_ && !SkipLine()) {
+      // The Y4M file header is a line like
+      // "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
+      fprintf(stderr, "Corrupted Y4M header in %s\n", file_name);
+      fclose(file_);
+      file_ = NULL;
+    }
+  }
+
+  ~SequentialFrameReader() {
+    if (file_ != NULL)
+      fclose(file_);
+  }
+
+  // Reads the next frame into |frame|. Returns false at the end of the file.
+  bool ReadFrame(uint8_t* frame) {
+    if (file_ == NULL)
+      return false;
+    // Each Y4M frame has a "FRAME" header line.
+    if (y4m_ && !SkipLine())
+      return false;
+    size_t bytes_read = 0;
+    int idle_ms = 0;
+    while (true) {
+      const size_t bytes =
+          fread(frame + bytes_read, 1, frame_size_ - bytes_read, file_);
+      bytes_read += bytes;
+      if (bytes_read == frame_size_)
+        return true;
+      if (!streaming_ || ferror(file_))
+        return false;
+      // Wait for the writer to append the rest of the frame.
+      idle_ms = bytes > 0 ? 0 : idle_ms + kStreamingPollIntervalMs;
+      if (idle_ms > timeout_ms_)
+        return false;
+      clearerr(file_);
+      webrtc::SleepMs(kStreamingPollIntervalMs);
+    }
+  }
+
+ private:
+  bool SkipLine() {
+    int c;
+    while ((c = fgetc(file_)) != EOF) {
+      if (c == '\n')
+        return true;
+    }
+    return false;
+  }
+
+  FILE* file_;
+  const size_t frame_size_;
+  const bool y4m_;
+  const bool streaming_;
+  const int timeout_ms_;
+};
+
+// A batch of frame pairs, with the metrics calculated for them by
+// |num_threads| threads, each taking every |num_threads|-th frame.
+struct FrameBatch {
+  FrameBatch(int capacity, int frame_size, int width, int height)
+      : ref_frames(capacity * frame_size),
+        test_frames(capacity * frame_size),
+        psnr(capacity),
+        ssim(capacity),
+        frame_size(frame_size),
+        width(width),
+        height(height),
+        num_frames(0) {}
+
+  std::vector<uint8_t> ref_frames;
+  std::vector<uint8_t> test_frames;
+  std::vector<double> psnr;
+  std::vector<double> ssim;
+  const int frame_size;
+  const int width;
+  const int height;
+  int num_frames;
+};
+
+struct MetricsWorker {
+  static bool Run(void* obj) {
+    static_cast<MetricsWorker*>(obj)->CalculateMetrics();
+    return false;
+  }
+
+  void CalculateMetrics() {
+    for (int i = first_frame; i < batch->num_frames; i += frame_step) {
+      const uint8_t* ref_frame = &batch->ref_frames[i * batch->frame_size];
+      const uint8_t* test_frame = &batch->test_frames[i * batch->frame_size];
+      batch->psnr[i] = webrtc::test::CalculateMetrics(
+          webrtc::test::kPSNR, ref_frame, test_frame, batch->width,
+          batch->height);
+      batch->ssim[i] = webrtc::test::CalculateMetrics(
+          webrtc::test::kSSIM, ref_frame, test_frame, batch->width,
+          batch->height);
+    }
+  }
+
+  FrameBatch* batch;
+  int first_frame;
+  int frame_step;
+};
 
 void CompareFiles(const char* reference_file_name, const char* test_file_name,
-                  const char* results_file_name, int width, int height) {
+                  const char* results_file_name, int width, int height,
+                  int num_threads, bool streaming, int streaming_timeout_ms) {
   // Check if the reference_file_name ends with "y4m".
   bool y4m_mode = false;
   if (std::string(reference_file_name).find("y4m") != std::string::npos) {
@@ -32,34 +162,54 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
   FILE* results_file = fopen(results_file_name, "w");
 
   int size = webrtc::test::GetI420FrameSize(width, height);
+  SequentialFrameReader ref_reader(reference_file_name, size, y4m_mode, false,
+                                   0);
+  SequentialFrameReader test_reader(test_file_name, size, false, streaming,
+                                    streaming_timeout_ms);
 
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* ref_frame = new uint8_t[size];
+  FrameBatch batch(num_threads * kFramesPerThread, size, width, height);
+  std::vector<MetricsWorker> workers(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers[i].batch = &batch;
+    workers[i].first_frame = i;
+    workers[i].frame_step = num_threads;
+  }
 
+  int frame_counter = 0;
   bool read_result = true;
-  for (int frame_counter = 0; frame_counter < MAX_NUM_FRAMES_PER_FILE;
-      ++frame_counter) {
-    read_result &= (y4m_mode) ? webrtc::test::ExtractFrameFromY4mFile(
-        reference_file_name, width, height, frame_counter, ref_frame):
-        webrtc::test::ExtractFrameFromYuvFile(reference_file_name, width,
-                                              height, frame_counter, ref_frame);
-    read_result &=  webrtc::test::ExtractFrameFromYuvFile(test_file_name, width,
-        height, frame_counter, test_frame);
-
-    if (!read_result)
-      break;
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
+  while (read_result) {
+    // Read as many frames as there are in a batch, or are left.
+    batch.num_frames = 0;
+    while (batch.num_frames < static_cast<int>(batch.psnr.size())) {
+      const int offset = batch.num_frames * size;
+      read_result = ref_reader.ReadFrame(&batch.ref_frames[offset]) &&
+                    test_reader.ReadFrame(&batch.test_frames[offset]);
+      if (!read_result)
+        break;
+      ++batch.num_frames;
+    }
+
+    // Calculate the PSNR and SSIM of the frames in parallel.
+    std::vector<rtc::scoped_ptr<rtc::PlatformThread>> threads;
+    for (int i = 1; i < std::min(num_threads, batch.num_frames); ++i) {
+      threads.push_back(rtc::scoped_ptr<rtc::PlatformThread>(
+          new rtc::PlatformThread(&MetricsWorker::Run, &workers[i],
+                                  "PsnrSsimWorker")));
+      threads.back()->Start();
+    }
+    workers[0].CalculateMetrics();
+    for (const auto& thread : threads)
+      thread->Stop();
+
+    // Write the results in frame order.
+    for (int i = 0; i < batch.num_frames; ++i) {
+      fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
+              batch.psnr[i], batch.ssim[i]);
+      ++frame_counter;
+    }
+    // Let a reader of the results follow along in streaming mode.
+    fflush(results_file);
   }
-  delete[] test_frame;
-  delete[] ref_frame;
 
   fclose(results_file);
 }
@@ -75,10 +225,15 @@ void CompareFiles(const char* reference_file_name, const char* test_file_name,
  *
  * The max value for PSNR is 48.0 (between equal frames), as for SSIM it is 1.0.
  *
+ * The frames are compared on several threads, and the results written in frame
+ * order. In streaming mode the test video may still be being written, and the
+ * tool waits for new frames until none have been added for a while.
+ *
  * Usage:
  * psnr_ssim_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --results_file=<name_of_file> --width=<width_of_frames>
- * --height=<height_of_frames>
+ * --height=<height_of_frames> [--num_threads=<number_of_threads>]
+ * [--streaming=true --streaming_timeout_ms=<timeout>]
  */
 int main(int argc, char** argv) {
   std::string program_name = argv[0];
@@ -96,7 +251,13 @@ int main(int argc, char** argv) {
       "  - test_file(string): The test YUV file to run the analysis for."
       " Default: test_file.yuv\n"
       "  - results_file(string): The full name of the file where the results "
-      "will be written. Default: results.txt\n";
+      "will be written. Default: results.txt\n"
+      "  - num_threads(int): The number of threads comparing frames. "
+      "Default: the number of cores\n"
+      "  - streaming(bool): Whether the test file is still being written, so "
+      "that the end of it should be waited on. Default: false\n"
+      "  - streaming_timeout_ms(int): How long to wait for a new frame in "
+      "streaming mode before stopping. Default: 10000\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -110,6 +271,9 @@ int main(int argc, char** argv) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("results_file", "results.txt");
+  parser.SetFlag("num_threads", "0");
+  parser.SetFlag("streaming", "false");
+  parser.SetFlag("streaming_timeout_ms", "10000");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -127,7 +291,15 @@ int main(int argc, char** argv) {
     return -1;
   }
 
+  int num_threads = strtol((parser.GetFlag("num_threads")).c_str(), NULL, 10);
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(webrtc::CpuInfo::DetectNumberOfCores());
+  int streaming_timeout_ms =
+      strtol((parser.GetFlag("streaming_timeout_ms")).c_str(), NULL, 10);
+
   CompareFiles(parser.GetFlag("reference_file").c_str(),
                parser.GetFlag("test_file").c_str(),
-               parser.GetFlag("results_file").c_str(), width, height);
+               parser.GetFlag("results_file").c_str(), width, height,
+               std::max(num_threads, 1), parser.GetFlag("streaming") == "true",
+               streaming_timeout_ms);
 }
@@ -40,6 +40,8 @@
       'target_name': 'psnr_ssim_analyzer',
       'type': 'executable',
       'dependencies': [
+        '<(webrtc_root)/base/base.gyp:rtc_base_approved',
+        '<(webrtc_root)/system_wrappers/system_wrappers.gyp:system_wrappers',
         '<(webrtc_root)/tools/internal_tools.gyp:command_line_parser',
         'video_quality_analysis',
       ],
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/tick_util.h"
@@ -24,51 +25,8 @@ namespace {
 const int64_t kUpdateIntervalMs = 1000;
 // Weight factor to apply to the average rtt.
 const float kWeightFactor = 0.3f;
-
-void RemoveOldReports(int64_t now, std::list<CallStats::RttTime>* reports) {
-  // A rtt report is considered valid for this long.
-  const int64_t kRttTimeoutMs = 1500;
-  while (!reports->empty() &&
-         (now - reports->front().time) > kRttTimeoutMs) {
-    reports->pop_front();
-  }
-}
-
-int64_t GetMaxRttMs(std::list<CallStats::RttTime>* reports) {
-  int64_t max_rtt_ms = 0;
-  for (std::list<CallStats::RttTime>::const_iterator it = reports->begin();
-       it != reports->end(); ++it) {
-    max_rtt_ms = std::max(it->rtt, max_rtt_ms);
-  }
-  return max_rtt_ms;
-}
-
-int64_t GetAvgRttMs(std::list<CallStats::RttTime>* reports) {
-  if (reports->empty()) {
-    return 0;
-  }
-  int64_t sum = 0;
-  for (std::list<CallStats::RttTime>::const_iterator it = reports->begin();
-       it != reports->end(); ++it) {
-    sum += it->rtt;
-  }
-  return sum / reports->size();
-}
-
-void UpdateAvgRttMs(std::list<CallStats::RttTime>* reports, int64_t* avg_rtt) {
-  uint32_t cur_rtt_ms = GetAvgRttMs(reports);
-  if (cur_rtt_ms == 0) {
-    // Reset.
-    *avg_rtt = 0;
-    return;
-  }
-  if (*avg_rtt == 0) {
-    // Initialize.
-    *avg_rtt = cur_rtt_ms;
-    return;
-  }
-  *avg_rtt = *avg_rtt * (1.0f - kWeightFactor) + cur_rtt_ms * kWeightFactor;
-}
+// A rtt report is considered valid for this long.
+const int64_t kRttTimeoutMs = 1500;
 }  // namespace
 
 class RtcpObserver : public RtcpRttStats {
@@ -94,10 +52,14 @@ class RtcpObserver : public RtcpRttStats {
 CallStats::CallStats(Clock* clock)
     : clock_(clock),
       crit_(CriticalSectionWrapper::CreateCriticalSection()),
+      observers_crit_(CriticalSectionWrapper::CreateCriticalSection()),
       rtcp_rtt_stats_(new RtcpObserver(this)),
       last_process_time_(clock_->TimeInMilliseconds()),
       max_rtt_ms_(0),
-      avg_rtt_ms_(0) {}
+      avg_rtt_ms_(0),
+      published_avg_rtt_ms_(0),
+      first_report_(0),
+      num_reports_(0) {}
 
 CallStats::~CallStats() {
   assert(observers_.empty());
@@ -108,31 +70,39 @@ int64_t CallStats::TimeUntilNextProcess() {
 }
 
 int32_t CallStats::Process() {
-  CriticalSectionScoped cs(crit_.get());
-  int64_t now = clock_->TimeInMilliseconds();
-  if (now < last_process_time_ + kUpdateIntervalMs)
-    return 0;
-
-  last_process_time_ = now;
-
-  RemoveOldReports(now, &reports_);
-  max_rtt_ms_ = GetMaxRttMs(&reports_);
-  UpdateAvgRttMs(&reports_, &avg_rtt_ms_);
+  int64_t avg_rtt_ms;
+  int64_t max_rtt_ms;
+  {
+    CriticalSectionScoped cs(crit_.get());
+    int64_t now = clock_->TimeInMilliseconds();
+    if (now < last_process_time_ + kUpdateIntervalMs)
+      return 0;
+
+    last_process_time_ = now;
+
+    RemoveOldReports(now);
+    max_rtt_ms_ = GetMaxRttMs();
+    UpdateAvgRttMs();
+    rtc::AtomicOps::ReleaseStore(&published_avg_rtt_ms_,
+                                 static_cast<int>(avg_rtt_ms_));
+    avg_rtt_ms = avg_rtt_ms_;
+    max_rtt_ms = max_rtt_ms_;
+  }
 
   // If there is a valid rtt, update all observers with the max rtt.
   // TODO(asapersson): Consider changing this to report the average rtt.
-  if (max_rtt_ms_ > 0) {
+  if (max_rtt_ms > 0) {
+    CriticalSectionScoped cs(observers_crit_.get());
     for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
          it != observers_.end(); ++it) {
-      (*it)->OnRttUpdate(avg_rtt_ms_, max_rtt_ms_);
+      (*it)->OnRttUpdate(avg_rtt_ms, max_rtt_ms);
     }
   }
   return 0;
 }
 
 int64_t CallStats::avg_rtt_ms() const {
-  CriticalSectionScoped cs(crit_.get());
-  return avg_rtt_ms_;
+  return rtc::AtomicOps::AcquireLoad(&published_avg_rtt_ms_);
 }
 
 RtcpRttStats* CallStats::rtcp_rtt_stats() const {
@@ -140,7 +110,7 @@ RtcpRttStats* CallStats::rtcp_rtt_stats() const {
 }
 
 void CallStats::RegisterStatsObserver(CallStatsObserver* observer) {
-  CriticalSectionScoped cs(crit_.get());
+  CriticalSectionScoped cs(observers_crit_.get());
   for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
        it != observers_.end(); ++it) {
     if (*it == observer)
@@ -150,7 +120,7 @@ void CallStats::RegisterStatsObserver(CallStatsObserver* observer) {
 }
 
 void CallStats::DeregisterStatsObserver(CallStatsObserver* observer) {
-  CriticalSectionScoped cs(crit_.get());
+  CriticalSectionScoped cs(observers_crit_.get());
   for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
        it != observers_.end(); ++it) {
     if (*it == observer) {
@@ -162,7 +132,53 @@ void CallStats::DeregisterStatsObserver(CallStatsObserver* observer) {
 
 void CallStats::OnRttUpdate(int64_t rtt) {
   CriticalSectionScoped cs(crit_.get());
-  reports_.push_back(RttTime(rtt, clock_->TimeInMilliseconds()));
+  if (num_reports_ == kMaxReports) {
+    // Make room by dropping the oldest report.
+    first_report_ = (first_report_ + 1) % kMaxReports;
+    --num_reports_;
+  }
+  reports_[(first_report_ + num_reports_) % kMaxReports] =
+      RttTime(rtt, clock_->TimeInMilliseconds());
+  ++num_reports_;
+}
+
+void CallStats::RemoveOldReports(int64_t now) {
+  while (num_reports_ > 0 &&
+         (now - reports_[first_report_].time) > kRttTimeoutMs) {
+    first_report_ = (first_report_ + 1) % kMaxReports;
+    --num_reports_;
+  }
+}
+
+int64_t CallStats::GetMaxRttMs() const {
+  int64_t max_rtt_ms = 0;
+  for (size_t i = 0; i < num_reports_; ++i) {
+    max_rtt_ms =
+        std::max(reports_[(first_report_ + i) % kMaxReports].rtt, max_rtt_ms);
+  }
+  return max_rtt_ms;
+}
+
+void CallStats::UpdateAvgRttMs() {
+  uint32_t cur_rtt_ms = 0;
+  if (num_reports_ > 0) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < num_reports_; ++i)
+      sum += reports_[(first_report_ + i) % kMaxReports].rtt;
+    cur_rtt_ms = sum / num_reports_;
+  }
+  if (cur_rtt_ms == 0) {
+    // Reset.
+    avg_rtt_ms_ = 0;
+    return;
+  }
+  if (avg_rtt_ms_ == 0) {
+    // Initialize.
+    avg_rtt_ms_ = cur_rtt_ms;
+    return;
+  }
+  avg_rtt_ms_ =
+      avg_rtt_ms_ * (1.0f - kWeightFactor) + cur_rtt_ms * kWeightFactor;
 }
 
 }  // namespace webrtc
@@ -46,10 +46,11 @@ class CallStats : public Module {
 
   // Helper struct keeping track of the time a rtt value is reported.
   struct RttTime {
+    RttTime() : rtt(0), time(0) {}
     RttTime(int64_t new_rtt, int64_t rtt_time)
         : rtt(new_rtt), time(rtt_time) {}
-    const int64_t rtt;
-    const int64_t time;
+    int64_t rtt;
+    int64_t time;
   };
 
  protected:
@@ -58,9 +59,21 @@ class CallStats : public Module {
   int64_t avg_rtt_ms() const;
 
  private:
+  // The number of RTT reports kept. Reports are dropped when they time out,
+  // or, oldest first, when there are more than this many.
+  static const size_t kMaxReports = 256;
+
+  void RemoveOldReports(int64_t now);
+  int64_t GetMaxRttMs() const;
+  void UpdateAvgRttMs();
+
   Clock* const clock_;
-  // Protecting all members.
+  // Protecting the RTT reports and statistics. Never held while calling the
+  // observers, so that RTT reports aren't blocked by them.
   rtc::scoped_ptr<CriticalSectionWrapper> crit_;
+  // Protecting |observers_|, and held while calling them so that they can't
+  // be deregistered while being called.
+  rtc::scoped_ptr<CriticalSectionWrapper> observers_crit_;
   // Observer receiving statistics updates.
   rtc::scoped_ptr<RtcpRttStats> rtcp_rtt_stats_;
   // The last time 'Process' resulted in statistic update.
@@ -68,9 +81,15 @@ class CallStats : public Module {
   // The last RTT in the statistics update (zero if there is no valid estimate).
   int64_t max_rtt_ms_;
   int64_t avg_rtt_ms_;
-
-  // All Rtt reports within valid time interval, oldest first.
-  std::list<RttTime> reports_;
+  // |avg_rtt_ms_|, readable without taking |crit_| since it's polled by
+  // every RTP module.
+  volatile int published_avg_rtt_ms_;
+
+  // All Rtt reports within valid time interval, oldest first, in a ring
+  // starting at |first_report_|.
+  RttTime reports_[kMaxReports];
+  size_t first_report_;
+  size_t num_reports_;
 
   // Observers getting stats reports.
   std::list<CallStatsObserver*> observers_;
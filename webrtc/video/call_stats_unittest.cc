@@ -201,4 +201,24 @@ TEST_F(CallStatsTest, LastProcessedRtt) {
   call_stats_->DeregisterStatsObserver(&stats_observer);
 }
 
+// Verify that only the latest reports are kept when more are reported than
+// fit between two updates.
+TEST_F(CallStatsTest, DropsOldestReportsWhenFull) {
+  MockStatsObserver stats_observer;
+  call_stats_->RegisterStatsObserver(&stats_observer);
+  RtcpRttStats* rtcp_rtt_stats = call_stats_->rtcp_rtt_stats();
+  fake_clock_.AdvanceTimeMilliseconds(1000);
+
+  const int64_t kOldRtt = 500;
+  const int64_t kRtt = 100;
+  rtcp_rtt_stats->OnRttUpdate(kOldRtt);
+  for (int i = 0; i < 1000; ++i)
+    rtcp_rtt_stats->OnRttUpdate(kRtt);
+  EXPECT_CALL(stats_observer, OnRttUpdate(kRtt, kRtt)).Times(1);
+  call_stats_->Process();
+  EXPECT_EQ(kRtt, rtcp_rtt_stats->LastProcessedRtt());
+
+  call_stats_->DeregisterStatsObserver(&stats_observer);
+}
+
 }  // namespace webrtc
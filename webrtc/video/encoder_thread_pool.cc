@@ -0,0 +1,200 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/encoder_thread_pool.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
+#include <deque>
+#include <limits>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+
+// One thread of the pool and the tasks that run on it.
+class EncoderThreadPool::Worker {
+ public:
+  // |core| is the core to pin the thread to, or -1 to not pin it.
+  explicit Worker(int core)
+      : core_(core),
+        thread_(ThreadFunction, this, "EncoderThread"),
+        wake_up_event_(false, false),
+        stop_(0) {
+    thread_.Start();
+    thread_.SetPriority(rtc::kHighPriority);
+  }
+
+  ~Worker() {
+    rtc::AtomicOps::ReleaseStore(&stop_, 1);
+    wake_up_event_.Set();
+    thread_.Stop();
+    RTC_DCHECK(tasks_.empty());
+  }
+
+  void AddTask(Task* task) {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK(tasks_.find(task) == tasks_.end());
+    tasks_[task] = false;
+  }
+
+  void RemoveTask(Task* task) {
+    {
+      rtc::CritScope lock(&lock_);
+      tasks_.erase(task);
+      for (auto it = ready_tasks_.begin(); it != ready_tasks_.end(); ++it) {
+        if (*it == task) {
+          ready_tasks_.erase(it);
+          break;
+        }
+      }
+    }
+    // A task is taken off the queue with |run_lock_| held, so this waits for
+    // a run of |task| that is in progress.
+    rtc::CritScope run_lock(&run_lock_);
+  }
+
+  void Signal(Task* task) {
+    {
+      rtc::CritScope lock(&lock_);
+      auto it = tasks_.find(task);
+      // Signals can race with RemoveTask().
+      if (it == tasks_.end() || it->second)
+        return;
+      it->second = true;
+      ready_tasks_.push_back(task);
+    }
+    wake_up_event_.Set();
+  }
+
+  size_t NumTasks() const {
+    rtc::CritScope lock(&lock_);
+    return tasks_.size();
+  }
+
+ private:
+  static bool ThreadFunction(void* obj) {
+    return static_cast<Worker*>(obj)->Process();
+  }
+
+  bool Process() {
+    static const int kThreadWaitTimeMs = 100;
+    if (core_ >= 0) {
+      PinToCore(core_);
+      core_ = -1;
+    }
+    wake_up_event_.Wait(kThreadWaitTimeMs);
+    if (rtc::AtomicOps::AcquireLoad(&stop_))
+      return false;
+    while (true) {
+      Task* task;
+      {
+        rtc::CritScope lock(&lock_);
+        if (ready_tasks_.empty())
+          break;
+        task = ready_tasks_.front();
+        ready_tasks_.pop_front();
+        // Signals from now on run the task again.
+        tasks_[task] = false;
+        run_lock_.Enter();
+      }
+      task->Run();
+      run_lock_.Leave();
+    }
+    return true;
+  }
+
+  static void PinToCore(int core) {
+#if defined(WEBRTC_LINUX)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+      LOG(LS_WARNING) << "Failed to pin encoder thread to core " << core;
+#endif
+  }
+
+  // Only used on the worker thread.
+  int core_;
+  rtc::PlatformThread thread_;
+  rtc::Event wake_up_event_;
+  volatile int stop_;
+
+  mutable rtc::CriticalSection lock_;
+  // Held while a task runs.
+  rtc::CriticalSection run_lock_;
+  // All tasks of this thread, and whether each is in |ready_tasks_|.
+  std::map<Task*, bool> tasks_ GUARDED_BY(lock_);
+  std::deque<Task*> ready_tasks_ GUARDED_BY(lock_);
+};
+
+EncoderThreadPool::EncoderThreadPool(size_t num_threads, bool pin_to_cores) {
+  RTC_DCHECK_GT(num_threads, 0u);
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(new Worker(
+        pin_to_cores ? static_cast<int>(i % num_cores) : -1));
+  }
+}
+
+EncoderThreadPool::~EncoderThreadPool() {
+  RTC_DCHECK(workers_by_task_.empty());
+}
+
+void EncoderThreadPool::AddTask(Task* task) {
+  rtc::CritScope lock(&lock_);
+  RTC_DCHECK(workers_by_task_.find(task) == workers_by_task_.end());
+  Worker* least_loaded = nullptr;
+  size_t min_tasks = std::numeric_limits<size_t>::max();
+  for (Worker* worker : workers_) {
+    size_t num_tasks = worker->NumTasks();
+    if (num_tasks < min_tasks) {
+      min_tasks = num_tasks;
+      least_loaded = worker;
+    }
+  }
+  least_loaded->AddTask(task);
+  workers_by_task_[task] = least_loaded;
+}
+
+void EncoderThreadPool::RemoveTask(Task* task) {
+  Worker* worker;
+  {
+    rtc::CritScope lock(&lock_);
+    auto it = workers_by_task_.find(task);
+    RTC_DCHECK(it != workers_by_task_.end());
+    worker = it->second;
+    workers_by_task_.erase(it);
+  }
+  worker->RemoveTask(task);
+}
+
+void EncoderThreadPool::Signal(Task* task) {
+  rtc::CritScope lock(&lock_);
+  auto it = workers_by_task_.find(task);
+  if (it != workers_by_task_.end())
+    it->second->Signal(task);
+}
+
+std::vector<size_t> EncoderThreadPool::NumTasksPerThread() const {
+  std::vector<size_t> num_tasks;
+  for (const Worker* worker : workers_)
+    num_tasks.push_back(worker->NumTasks());
+  return num_tasks;
+}
+
+}  // namespace webrtc
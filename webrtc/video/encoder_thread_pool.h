@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_ENCODER_THREAD_POOL_H_
+#define WEBRTC_VIDEO_ENCODER_THREAD_POOL_H_
+
+#include <map>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+
+namespace webrtc {
+
+// Runs the encoding of many send streams on a fixed number of threads,
+// instead of on a thread per stream, so that the number of threads follows
+// the number of cores rather than the number of streams. Each stream is a
+// task that is signaled when it has a frame to encode. A task stays on one
+// thread, so it is never run on two threads at once, and signals that arrive
+// while it is queued or running are coalesced into a single run.
+class EncoderThreadPool {
+ public:
+  class Task {
+   public:
+    // Called on a pool thread after the task has been signaled.
+    virtual void Run() = 0;
+
+   protected:
+    virtual ~Task() {}
+  };
+
+  // Starts |num_threads| threads. If |pin_to_cores| is set, thread i only
+  // runs on core i modulo the number of cores. Pinning is only supported on
+  // Linux and is ignored elsewhere.
+  EncoderThreadPool(size_t num_threads, bool pin_to_cores);
+  // All tasks must have been removed.
+  ~EncoderThreadPool();
+
+  // Adds |task| to the least loaded thread. Can be called on any thread.
+  void AddTask(Task* task);
+
+  // Removes |task|. Once this returns, the task is not running and will not
+  // be run again. Can be called on any thread, but not from a task.
+  void RemoveTask(Task* task);
+
+  // Runs |task| on its thread as soon as possible. Can be called on any
+  // thread.
+  void Signal(Task* task);
+
+  // The number of tasks on each thread.
+  std::vector<size_t> NumTasksPerThread() const;
+
+ private:
+  class Worker;
+
+  ScopedVector<Worker> workers_;
+  rtc::CriticalSection lock_;
+  std::map<Task*, Worker*> workers_by_task_ GUARDED_BY(lock_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EncoderThreadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_ENCODER_THREAD_POOL_H_
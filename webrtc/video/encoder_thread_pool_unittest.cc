@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/video/encoder_thread_pool.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+namespace {
+const int kTimeoutMs = 5000;
+
+// Counts its runs, and checks that it is never run on two threads at once.
+class CountingTask : public EncoderThreadPool::Task {
+ public:
+  CountingTask() : runs_(0), running_(0), run_event_(false, false) {}
+  ~CountingTask() override {}
+
+  void Run() override {
+    EXPECT_EQ(1, rtc::AtomicOps::Increment(&running_));
+    if (block_event_)
+      block_event_->Wait(kTimeoutMs);
+    rtc::AtomicOps::Increment(&runs_);
+    rtc::AtomicOps::Decrement(&running_);
+    run_event_.Set();
+  }
+
+  bool WaitForRun() { return run_event_.Wait(kTimeoutMs); }
+  int runs() const { return rtc::AtomicOps::AcquireLoad(&runs_); }
+  void set_block_event(rtc::Event* event) { block_event_ = event; }
+
+ private:
+  volatile int runs_;
+  volatile int running_;
+  rtc::Event run_event_;
+  rtc::Event* block_event_ = nullptr;
+};
+}  // namespace
+
+TEST(EncoderThreadPoolTest, RunsSignaledTasks) {
+  EncoderThreadPool pool(2, false);
+  ScopedVector<CountingTask> tasks;
+  for (int i = 0; i < 5; ++i) {
+    tasks.push_back(new CountingTask());
+    pool.AddTask(tasks[i]);
+  }
+  for (CountingTask* task : tasks)
+    pool.Signal(task);
+  for (CountingTask* task : tasks) {
+    EXPECT_TRUE(task->WaitForRun());
+    EXPECT_EQ(1, task->runs());
+  }
+  for (CountingTask* task : tasks)
+    pool.RemoveTask(task);
+}
+
+TEST(EncoderThreadPoolTest, SpreadsTasksOverThreads) {
+  EncoderThreadPool pool(3, false);
+  ScopedVector<CountingTask> tasks;
+  for (int i = 0; i < 7; ++i) {
+    tasks.push_back(new CountingTask());
+    pool.AddTask(tasks[i]);
+  }
+  std::vector<size_t> num_tasks = pool.NumTasksPerThread();
+  ASSERT_EQ(3u, num_tasks.size());
+  EXPECT_EQ(3u, num_tasks[0]);
+  EXPECT_EQ(2u, num_tasks[1]);
+  EXPECT_EQ(2u, num_tasks[2]);
+
+  pool.RemoveTask(tasks[0]);
+  pool.RemoveTask(tasks[3]);
+  num_tasks = pool.NumTasksPerThread();
+  EXPECT_EQ(1u, num_tasks[0]);
+  for (size_t i = 1; i < tasks.size(); ++i) {
+    if (i != 3)
+      pool.RemoveTask(tasks[i]);
+  }
+}
+
+TEST(EncoderThreadPoolTest, CoalescesSignalsWhileRunning) {
+  EncoderThreadPool pool(1, false);
+  CountingTask task;
+  rtc::Event block_event(false, false);
+  task.set_block_event(&block_event);
+  pool.AddTask(&task);
+
+  pool.Signal(&task);
+  // Signaled three times while the first run is blocked, which makes one
+  // more run.
+  SleepMs(50);
+  pool.Signal(&task);
+  pool.Signal(&task);
+  pool.Signal(&task);
+  block_event.Set();
+  EXPECT_TRUE(task.WaitForRun());
+  block_event.Set();
+  EXPECT_TRUE(task.WaitForRun());
+  SleepMs(50);
+  EXPECT_EQ(2, task.runs());
+
+  pool.RemoveTask(&task);
+}
+
+TEST(EncoderThreadPoolTest, RemoveTaskWaitsForRun) {
+  EncoderThreadPool pool(1, true);
+  CountingTask task;
+  rtc::Event block_event(false, false);
+  task.set_block_event(&block_event);
+  pool.AddTask(&task);
+
+  pool.Signal(&task);
+  SleepMs(50);
+  block_event.Set();
+  pool.RemoveTask(&task);
+  EXPECT_EQ(1, task.runs());
+
+  // Signals after removal are ignored.
+  pool.Signal(&task);
+  SleepMs(50);
+  EXPECT_EQ(1, task.runs());
+}
+
+}  // namespace webrtc
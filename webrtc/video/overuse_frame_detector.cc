@@ -162,15 +162,111 @@ class OveruseFrameDetector::FrameQueue {
   int last_processing_time_ms_;
 };
 
+CpuBudgetCoordinator::CpuBudgetCoordinator(int budget_percent)
+    : budget_percent_(budget_percent),
+      expected_usage_change_(0),
+      period_start_ms_(-1) {
+  RTC_DCHECK_GT(budget_percent, 0);
+}
+
+CpuBudgetCoordinator::~CpuBudgetCoordinator() {
+  RTC_DCHECK(streams_.empty());
+}
+
+int CpuBudgetCoordinator::TotalUsagePercent() const {
+  rtc::CritScope cs(&crit_);
+  return 100 * TotalUsage() / budget_percent_;
+}
+
+void CpuBudgetCoordinator::AddStream(const OveruseFrameDetector* detector) {
+  rtc::CritScope cs(&crit_);
+  RTC_DCHECK(streams_.find(detector) == streams_.end());
+  streams_[detector] = Stream();
+}
+
+void CpuBudgetCoordinator::RemoveStream(const OveruseFrameDetector* detector) {
+  rtc::CritScope cs(&crit_);
+  streams_.erase(detector);
+}
+
+void CpuBudgetCoordinator::UpdateUsage(const OveruseFrameDetector* detector,
+                                       int usage_percent) {
+  rtc::CritScope cs(&crit_);
+  streams_[detector].usage_percent = usage_percent;
+}
+
+bool CpuBudgetCoordinator::MayAdaptDown(const OveruseFrameDetector* detector,
+                                        int threshold_percent,
+                                        int64_t now_ms) {
+  rtc::CritScope cs(&crit_);
+  MaybeStartNewPeriod(now_ms);
+  const int total_usage = TotalUsage();
+  // Still above the threshold once the adaptations already allowed have had
+  // their effect?
+  if (100 * (total_usage + expected_usage_change_) <
+      threshold_percent * budget_percent_) {
+    return false;
+  }
+  Stream& stream = streams_[detector];
+  // Adapt the streams that use the most first.
+  if (stream.usage_percent * static_cast<int>(streams_.size()) < total_usage)
+    return false;
+  ++stream.num_adaptations;
+  // Adapting down scales the number of pixels by about a half.
+  expected_usage_change_ -= stream.usage_percent / 2;
+  return true;
+}
+
+bool CpuBudgetCoordinator::MayAdaptUp(const OveruseFrameDetector* detector,
+                                      int threshold_percent,
+                                      int64_t now_ms) {
+  rtc::CritScope cs(&crit_);
+  MaybeStartNewPeriod(now_ms);
+  Stream& stream = streams_[detector];
+  // Adapting up doubles the number of pixels, so the usage of the stream is
+  // expected to double as well.
+  if (100 * (TotalUsage() + expected_usage_change_ + stream.usage_percent) >=
+      threshold_percent * budget_percent_) {
+    return false;
+  }
+  // Give back to the streams that have been adapted down the most first.
+  for (const auto& kv : streams_) {
+    if (kv.second.num_adaptations > stream.num_adaptations)
+      return false;
+  }
+  if (stream.num_adaptations > 0)
+    --stream.num_adaptations;
+  expected_usage_change_ += stream.usage_percent;
+  return true;
+}
+
+void CpuBudgetCoordinator::MaybeStartNewPeriod(int64_t now_ms) {
+  // Each detector checks for overuse once per |kProcessIntervalMs|, so by the
+  // next period the usage that streams report reflects earlier adaptations.
+  if (period_start_ms_ == -1 ||
+      now_ms - period_start_ms_ >= kProcessIntervalMs) {
+    period_start_ms_ = now_ms;
+    expected_usage_change_ = 0;
+  }
+}
+
+int CpuBudgetCoordinator::TotalUsage() const {
+  int total_usage = 0;
+  for (const auto& kv : streams_)
+    total_usage += kv.second.usage_percent;
+  return total_usage;
+}
 
 OveruseFrameDetector::OveruseFrameDetector(
     Clock* clock,
     const CpuOveruseOptions& options,
     CpuOveruseObserver* observer,
-    CpuOveruseMetricsObserver* metrics_observer)
+    CpuOveruseMetricsObserver* metrics_observer,
+    CpuBudgetCoordinator* budget_coordinator)
     : options_(options),
       observer_(observer),
       metrics_observer_(metrics_observer),
+      budget_coordinator_(budget_coordinator),
       clock_(clock),
       num_process_times_(0),
       last_capture_time_(0),
@@ -186,6 +282,8 @@ OveruseFrameDetector::OveruseFrameDetector(
       usage_(new SendProcessingUsage(options)),
       frame_queue_(new FrameQueue()) {
   RTC_DCHECK(metrics_observer != nullptr);
+  if (budget_coordinator_)
+    budget_coordinator_->AddStream(this);
   // Make sure stats are initially up-to-date. This simplifies unit testing
   // since we don't have to trigger an update using one of the methods which
   // would also alter the overuse state.
@@ -194,6 +292,8 @@ OveruseFrameDetector::OveruseFrameDetector(
 }
 
 OveruseFrameDetector::~OveruseFrameDetector() {
+  if (budget_coordinator_)
+    budget_coordinator_->RemoveStream(this);
 }
 
 int OveruseFrameDetector::LastProcessingTimeMs() const {
@@ -208,6 +308,11 @@ int OveruseFrameDetector::FramesInQueue() const {
 
 void OveruseFrameDetector::UpdateCpuOveruseMetrics() {
   metrics_.encode_usage_percent = usage_->Value();
+  if (budget_coordinator_) {
+    budget_coordinator_->UpdateUsage(this, metrics_.encode_usage_percent);
+    metrics_.total_encode_usage_percent =
+        budget_coordinator_->TotalUsagePercent();
+  }
 
   metrics_observer_->CpuOveruseMetricsUpdated(metrics_);
 }
@@ -297,8 +402,15 @@ int32_t OveruseFrameDetector::Process() {
     if (num_process_times_ <= options_.min_process_count)
       return 0;
   }
+  if (budget_coordinator_) {
+    current_metrics.total_encode_usage_percent =
+        budget_coordinator_->TotalUsagePercent();
+  }
 
-  if (IsOverusing(current_metrics)) {
+  if (IsOverusing(current_metrics) &&
+      (!budget_coordinator_ ||
+       budget_coordinator_->MayAdaptDown(
+           this, options_.high_encode_usage_threshold_percent, now))) {
     // If the last thing we did was going up, and now have to back down, we need
     // to check if this peak was short. If so we should back off to avoid going
     // back and forth between this load, the system doesn't seem to handle it.
@@ -323,7 +435,10 @@ int32_t OveruseFrameDetector::Process() {
 
     if (observer_ != NULL)
       observer_->OveruseDetected();
-  } else if (IsUnderusing(current_metrics, now)) {
+  } else if (IsUnderusing(current_metrics, now) &&
+             (!budget_coordinator_ ||
+              budget_coordinator_->MayAdaptUp(
+                  this, options_.low_encode_usage_threshold_percent, now))) {
     last_rampup_time_ = now;
     in_quick_rampup_ = true;
 
@@ -342,8 +457,14 @@ int32_t OveruseFrameDetector::Process() {
   return 0;
 }
 
+int OveruseFrameDetector::UsagePercent(
+    const CpuOveruseMetrics& metrics) const {
+  return budget_coordinator_ ? metrics.total_encode_usage_percent
+                             : metrics.encode_usage_percent;
+}
+
 bool OveruseFrameDetector::IsOverusing(const CpuOveruseMetrics& metrics) {
-  if (metrics.encode_usage_percent >=
+  if (UsagePercent(metrics) >=
       options_.high_encode_usage_threshold_percent) {
     ++checks_above_threshold_;
   } else {
@@ -358,7 +479,6 @@ bool OveruseFrameDetector::IsUnderusing(const CpuOveruseMetrics& metrics,
   if (time_now < last_rampup_time_ + delay)
     return false;
 
-  return metrics.encode_usage_percent <
-         options_.low_encode_usage_threshold_percent;
+  return UsagePercent(metrics) < options_.low_encode_usage_threshold_percent;
 }
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 #define WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 
+#include <map>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ptr.h"
@@ -22,6 +24,7 @@
 namespace webrtc {
 
 class Clock;
+class OveruseFrameDetector;
 
 // CpuOveruseObserver is called when a system overuse is detected and
 // VideoEngine cannot keep up the encoding frequency.
@@ -59,10 +62,15 @@ struct CpuOveruseOptions {
 };
 
 struct CpuOveruseMetrics {
-  CpuOveruseMetrics() : encode_usage_percent(-1) {}
+  CpuOveruseMetrics()
+      : encode_usage_percent(-1), total_encode_usage_percent(-1) {}
 
   int encode_usage_percent;  // Average encode time divided by the average time
                              // difference between incoming captured frames.
+  int total_encode_usage_percent;  // Sum of the encode usage of all streams
+                                   // sharing a CpuBudgetCoordinator, in
+                                   // percent of the budget. -1 if there is no
+                                   // coordinator.
 };
 
 class CpuOveruseMetricsObserver {
@@ -71,15 +79,71 @@ class CpuOveruseMetricsObserver {
   virtual void CpuOveruseMetricsUpdated(const CpuOveruseMetrics& metrics) = 0;
 };
 
+// Shares one CPU budget for encoding between the OveruseFrameDetectors of
+// many streams. Overuse and underuse are then judged on the encode usage of
+// all streams together, and only as many streams as are expected to bring the
+// total back within the thresholds are told to adapt: down, the streams with
+// above average usage, and up, the streams that have been adapted down the
+// most. Thread safe.
+class CpuBudgetCoordinator {
+ public:
+  // |budget_percent| is the encode usage, in percent of one core, that the
+  // streams together may use, e.g. 100 times the number of cores.
+  explicit CpuBudgetCoordinator(int budget_percent);
+  ~CpuBudgetCoordinator();
+
+  // Sum of the encode usage of all streams, in percent of the budget.
+  int TotalUsagePercent() const;
+
+ private:
+  friend class OveruseFrameDetector;
+
+  struct Stream {
+    Stream() : usage_percent(0), num_adaptations(0) {}
+    int usage_percent;
+    // Times the stream has been told to adapt down, less times up.
+    int num_adaptations;
+  };
+
+  void AddStream(const OveruseFrameDetector* detector);
+  void RemoveStream(const OveruseFrameDetector* detector);
+  void UpdateUsage(const OveruseFrameDetector* detector, int usage_percent);
+
+  // Return true if |detector| should act on overuse or underuse with the
+  // given threshold, in percent of the budget.
+  bool MayAdaptDown(const OveruseFrameDetector* detector,
+                    int threshold_percent,
+                    int64_t now_ms);
+  bool MayAdaptUp(const OveruseFrameDetector* detector,
+                  int threshold_percent,
+                  int64_t now_ms);
+
+  void MaybeStartNewPeriod(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  int TotalUsage() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  mutable rtc::CriticalSection crit_;
+  const int budget_percent_;
+  std::map<const OveruseFrameDetector*, Stream> streams_ GUARDED_BY(crit_);
+  // Expected change of the total usage, in percent of one core, from the
+  // adaptations allowed since |period_start_ms_|. Their effect isn't measured
+  // until the encode usage filters have caught up.
+  int expected_usage_change_ GUARDED_BY(crit_);
+  int64_t period_start_ms_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CpuBudgetCoordinator);
+};
 
 // Use to detect system overuse based on the send-side processing time of
 // incoming frames.
 class OveruseFrameDetector : public Module {
  public:
+  // If |budget_coordinator| is set, overuse is judged on the usage of all
+  // streams sharing it. It must outlive this object.
   OveruseFrameDetector(Clock* clock,
                        const CpuOveruseOptions& options,
                        CpuOveruseObserver* overuse_observer,
-                       CpuOveruseMetricsObserver* metrics_observer);
+                       CpuOveruseMetricsObserver* metrics_observer,
+                       CpuBudgetCoordinator* budget_coordinator);
   ~OveruseFrameDetector();
 
   // Called for each captured frame.
@@ -107,6 +171,7 @@ class OveruseFrameDetector : public Module {
   void AddProcessingTime(int elapsed_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Only called on the processing thread.
+  int UsagePercent(const CpuOveruseMetrics& metrics) const;
   bool IsOverusing(const CpuOveruseMetrics& metrics);
   bool IsUnderusing(const CpuOveruseMetrics& metrics, int64_t time_now);
 
@@ -130,6 +195,8 @@ class OveruseFrameDetector : public Module {
   CpuOveruseMetricsObserver* const metrics_observer_;
   CpuOveruseMetrics metrics_ GUARDED_BY(crit_);
 
+  CpuBudgetCoordinator* const budget_coordinator_;
+
   Clock* const clock_;
   int64_t num_process_times_ GUARDED_BY(crit_);
 
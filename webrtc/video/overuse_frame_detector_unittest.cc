@@ -15,6 +15,7 @@
 
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
 
 namespace webrtc {
 namespace {
@@ -59,8 +60,8 @@ class OveruseFrameDetectorTest : public ::testing::Test,
   }
 
   void ReinitializeOveruseDetector() {
-    overuse_detector_.reset(new OveruseFrameDetector(clock_.get(), options_,
-                                                     observer_.get(), this));
+    overuse_detector_.reset(new OveruseFrameDetector(
+        clock_.get(), options_, observer_.get(), this, nullptr));
   }
 
   void CpuOveruseMetricsUpdated(const CpuOveruseMetrics& metrics) override {
@@ -131,7 +132,7 @@ TEST_F(OveruseFrameDetectorTest, OveruseAndRecover) {
 
 TEST_F(OveruseFrameDetectorTest, OveruseAndRecoverWithNoObserver) {
   overuse_detector_.reset(
-      new OveruseFrameDetector(clock_.get(), options_, nullptr, this));
+      new OveruseFrameDetector(clock_.get(), options_, nullptr, this, nullptr));
   EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(0);
   TriggerOveruse(options_.high_threshold_consecutive_count);
   EXPECT_CALL(*(observer_.get()), NormalUsage()).Times(0);
@@ -149,8 +150,8 @@ TEST_F(OveruseFrameDetectorTest, DoubleOveruseAndRecover) {
 TEST_F(OveruseFrameDetectorTest, TriggerUnderuseWithMinProcessCount) {
   options_.min_process_count = 1;
   CpuOveruseObserverImpl overuse_observer;
-  overuse_detector_.reset(new OveruseFrameDetector(clock_.get(), options_,
-                                                   &overuse_observer, this));
+  overuse_detector_.reset(new OveruseFrameDetector(
+      clock_.get(), options_, &overuse_observer, this, nullptr));
   InsertAndSendFramesWithInterval(
       1200, kFrameInterval33ms, kWidth, kHeight, kProcessTime5ms);
   overuse_detector_->Process();
@@ -307,4 +308,109 @@ TEST_F(OveruseFrameDetectorTest, FrameDelay_NonMatchingSendFrameIgnored) {
   EXPECT_EQ(kProcessingTimeMs, overuse_detector_->LastProcessingTimeMs());
 }
 
+class CpuBudgetCoordinatorTest : public ::testing::Test,
+                                  public CpuOveruseMetricsObserver {
+ protected:
+  CpuBudgetCoordinatorTest() : clock_(1234) {
+    options_.min_process_count = 0;
+  }
+
+  void CpuOveruseMetricsUpdated(const CpuOveruseMetrics& metrics) override {
+    metrics_ = metrics;
+  }
+
+  void CreateStreams(int budget_percent, int num_streams) {
+    coordinator_.reset(new CpuBudgetCoordinator(budget_percent));
+    for (int i = 0; i < num_streams; ++i) {
+      observers_.push_back(new CpuOveruseObserverImpl());
+      detectors_.push_back(new OveruseFrameDetector(
+          &clock_, options_, observers_[i], this, coordinator_.get()));
+    }
+  }
+
+  // Sends 1000 frames on every stream, stream i taking |delays_ms[i]| to
+  // encode each of them, and then processes all streams.
+  void InsertAndProcess(const std::vector<int>& delays_ms) {
+    for (int frame = 0; frame < 1000; ++frame) {
+      int64_t capture_time_ms = clock_.TimeInMilliseconds();
+      for (OveruseFrameDetector* detector : detectors_)
+        detector->FrameCaptured(kWidth, kHeight, capture_time_ms);
+      for (int elapsed_ms = 0; elapsed_ms < kFrameInterval33ms; ++elapsed_ms) {
+        for (size_t i = 0; i < detectors_.size(); ++i) {
+          if (delays_ms[i] == elapsed_ms)
+            detectors_[i]->FrameSent(capture_time_ms);
+        }
+        clock_.AdvanceTimeMilliseconds(1);
+      }
+    }
+    for (OveruseFrameDetector* detector : detectors_)
+      detector->Process();
+  }
+
+  int NumOveruses() const {
+    int num_overuses = 0;
+    for (const CpuOveruseObserverImpl* observer : observers_)
+      num_overuses += observer->overuse_;
+    return num_overuses;
+  }
+
+  SimulatedClock clock_;
+  CpuOveruseOptions options_;
+  CpuOveruseMetrics metrics_;
+  rtc::scoped_ptr<CpuBudgetCoordinator> coordinator_;
+  ScopedVector<CpuOveruseObserverImpl> observers_;
+  ScopedVector<OveruseFrameDetector> detectors_;
+};
+
+TEST_F(CpuBudgetCoordinatorTest, ReportsTotalUsage) {
+  CreateStreams(200, 2);
+  InsertAndProcess(std::vector<int>(2, 16));
+  // Each stream uses about 16 / 33 of a core.
+  EXPECT_NEAR(48, metrics_.encode_usage_percent, 2);
+  EXPECT_NEAR(48, metrics_.total_encode_usage_percent, 2);
+  EXPECT_EQ(metrics_.total_encode_usage_percent,
+            coordinator_->TotalUsagePercent());
+}
+
+TEST_F(CpuBudgetCoordinatorTest, AdaptsOnlyAsManyStreamsAsNeeded) {
+  // Four streams using about half a core each, on two cores. No stream is
+  // overusing on its own, but together they are above the high threshold.
+  CreateStreams(200, 4);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i)
+    InsertAndProcess(std::vector<int>(4, 16));
+  EXPECT_GE(metrics_.total_encode_usage_percent,
+            options_.high_encode_usage_threshold_percent);
+  // Adapting one of them is expected to bring the total below the threshold.
+  EXPECT_EQ(1, NumOveruses());
+}
+
+TEST_F(CpuBudgetCoordinatorTest, AdaptsStreamsWithMostUsageDown) {
+  CreateStreams(100, 2);
+  std::vector<int> delays_ms;
+  delays_ms.push_back(5);
+  delays_ms.push_back(30);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i)
+    InsertAndProcess(delays_ms);
+  EXPECT_EQ(0, observers_[0]->overuse_);
+  EXPECT_EQ(1, observers_[1]->overuse_);
+}
+
+TEST_F(CpuBudgetCoordinatorTest, AdaptsStreamsAdaptedDownMostUp) {
+  CreateStreams(100, 2);
+  std::vector<int> delays_ms;
+  delays_ms.push_back(5);
+  delays_ms.push_back(30);
+  for (int i = 0; i < options_.high_threshold_consecutive_count; ++i)
+    InsertAndProcess(delays_ms);
+  ASSERT_EQ(1, observers_[1]->overuse_);
+
+  // Both streams are now below the low threshold together, but only the one
+  // that was adapted down is let up.
+  InsertAndProcess(std::vector<int>(2, 5));
+  EXPECT_LT(metrics_.total_encode_usage_percent,
+            options_.low_encode_usage_threshold_percent);
+  EXPECT_EQ(0, observers_[0]->normaluse_);
+  EXPECT_EQ(1, observers_[1]->normaluse_);
+}
+
 }  // namespace webrtc
@@ -20,13 +20,16 @@
 
 namespace webrtc {
 
+const int64_t ReceiveStatisticsProxy::kSnapshotIntervalMs = 1000;
+
 ReceiveStatisticsProxy::ReceiveStatisticsProxy(uint32_t ssrc, Clock* clock)
     : clock_(clock),
       // 1000ms window, scale 1000 for ms to s.
       decode_fps_estimator_(1000, 1000),
       renders_fps_estimator_(1000, 1000),
       render_fps_tracker_(100u, 10u),
-      render_pixel_tracker_(100u, 10u) {
+      render_pixel_tracker_(100u, 10u),
+      last_snapshot_ms_(-1) {
   stats_.ssrc = ssrc;
 }
 
@@ -77,6 +80,30 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   return stats_;
 }
 
+VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStatsSnapshot() {
+  StatsSnapshot<VideoReceiveStream::Stats>::PublishedRef snapshot =
+      snapshot_.Get();
+  // Streams that don't decode frames don't publish, so readers publish
+  // themselves if the snapshot is too old.
+  int64_t now = clock_->TimeInMilliseconds();
+  if (!snapshot || now - snapshot->time_ms > 2 * kSnapshotIntervalMs) {
+    rtc::CritScope lock(&crit_);
+    last_snapshot_ms_ = now;
+    snapshot_.Publish(stats_, now);
+    snapshot = snapshot_.Get();
+  }
+  return snapshot->value;
+}
+
+void ReceiveStatisticsProxy::MaybePublishSnapshot(int64_t now_ms) {
+  if (last_snapshot_ms_ != -1 &&
+      now_ms - last_snapshot_ms_ < kSnapshotIntervalMs) {
+    return;
+  }
+  last_snapshot_ms_ = now_ms;
+  snapshot_.Publish(stats_, now_ms);
+}
+
 void ReceiveStatisticsProxy::OnIncomingPayloadType(int payload_type) {
   rtc::CritScope lock(&crit_);
   stats_.current_payload_type = payload_type;
@@ -110,6 +137,10 @@ void ReceiveStatisticsProxy::OnDecoderTiming(int decode_ms,
   stats_.jitter_buffer_ms = jitter_buffer_ms;
   stats_.min_playout_delay_ms = min_playout_delay_ms;
   stats_.render_delay_ms = render_delay_ms;
+  decode_time_histogram_.Add(decode_ms);
+  stats_.decode_ms_p95 = decode_time_histogram_.Percentile(95);
+  jitter_buffer_histogram_.Add(jitter_buffer_ms);
+  stats_.jitter_buffer_ms_p95 = jitter_buffer_histogram_.Percentile(95);
   decode_time_counter_.Add(decode_ms);
   // Network delay (rtt/2) + target_delay_ms (jitter delay + decode time +
   // render delay).
@@ -161,6 +192,7 @@ void ReceiveStatisticsProxy::OnDecodedFrame() {
   rtc::CritScope lock(&crit_);
   decode_fps_estimator_.Update(1, now);
   stats_.decode_frame_rate = decode_fps_estimator_.Rate(now);
+  MaybePublishSnapshot(now);
 }
 
 void ReceiveStatisticsProxy::OnRenderedFrame(int width, int height) {
@@ -175,6 +207,7 @@ void ReceiveStatisticsProxy::OnRenderedFrame(int width, int height) {
   render_height_counter_.Add(height);
   render_fps_tracker_.AddSamples(1);
   render_pixel_tracker_.AddSamples(sqrt(width * height));
+  MaybePublishSnapshot(now);
 }
 
 void ReceiveStatisticsProxy::OnReceiveRatesUpdated(uint32_t bitRate,
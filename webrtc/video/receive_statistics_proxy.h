@@ -20,7 +20,9 @@
 #include "webrtc/frame_callback.h"
 #include "webrtc/modules/remote_bitrate_estimator/rate_statistics.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
+#include "webrtc/system_wrappers/include/latency_histogram.h"
 #include "webrtc/video/report_block_stats.h"
+#include "webrtc/video/stats_snapshot.h"
 #include "webrtc/video/vie_channel.h"
 #include "webrtc/video_receive_stream.h"
 #include "webrtc/video_renderer.h"
@@ -40,7 +42,14 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   ReceiveStatisticsProxy(uint32_t ssrc, Clock* clock);
   virtual ~ReceiveStatisticsProxy();
 
+  static const int64_t kSnapshotIntervalMs;
+
   VideoReceiveStream::Stats GetStats() const;
+  // Returns the stats as of the last snapshot, which is at most
+  // |kSnapshotIntervalMs| old while frames are being decoded. Unlike
+  // GetStats(), this does not take the lock that every stats update takes,
+  // and is meant for frequent polling.
+  VideoReceiveStream::Stats GetStatsSnapshot();
 
   void OnDecodedFrame();
   void OnRenderedFrame(int width, int height);
@@ -92,6 +101,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   };
 
   void UpdateHistograms() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void MaybePublishSnapshot(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   Clock* const clock_;
 
@@ -105,7 +115,12 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   SampleCounter render_height_counter_ GUARDED_BY(crit_);
   SampleCounter decode_time_counter_ GUARDED_BY(crit_);
   SampleCounter delay_counter_ GUARDED_BY(crit_);
+  LatencyHistogram decode_time_histogram_;
+  LatencyHistogram jitter_buffer_histogram_;
   ReportBlockStats report_block_stats_ GUARDED_BY(crit_);
+  // Publishing is serialized by |crit_|.
+  StatsSnapshot<VideoReceiveStream::Stats> snapshot_;
+  int64_t last_snapshot_ms_ GUARDED_BY(crit_);
   QpCounters qp_counters_;  // Only accessed on the decoding thread.
 };
 
@@ -10,17 +10,21 @@
 
 #include <stdio.h>
 
+#include <ctime>
 #include <map>
 #include <sstream>
+#include <vector>
 
 #include "gflags/gflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/encoder_settings.h"
@@ -37,8 +41,6 @@
 namespace webrtc {
 namespace flags {
 
-// TODO(pbos): Multiple receivers.
-
 // Flag for payload type.
 static bool ValidatePayloadType(const char* flagname, int32_t payload_type) {
   return payload_type > 0 && payload_type <= 127;
@@ -132,6 +134,25 @@ static std::string DecoderBitstreamFilename() {
 DEFINE_string(codec, "VP8", "Video codec");
 static std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
 
+// Flags for the benchmark mode.
+DEFINE_bool(benchmark,
+            false,
+            "Deliver the packets as fast as possible instead of in real time, "
+            "count the frames instead of rendering them, and report the "
+            "frame rate, latencies and CPU use of the receive streams.");
+static bool Benchmark() { return FLAGS_benchmark; }
+
+static bool ValidateNumStreams(const char* flagname, int32_t num_streams) {
+  return num_streams > 0;
+}
+DEFINE_int32(num_streams,
+             1,
+             "Number of receive streams decoding the input in parallel in "
+             "benchmark mode. The copies get consecutive SSRCs from --ssrc.");
+static int NumStreams() { return static_cast<int>(FLAGS_num_streams); }
+static const bool num_streams_dummy =
+    google::RegisterFlagValidator(&FLAGS_num_streams, &ValidateNumStreams);
+
 }  // namespace flags
 
 static const uint32_t kReceiverLocalSsrc = 0x123456;
@@ -208,52 +229,149 @@ class DecoderBitstreamFileWriter : public EncodedFrameObserver {
   FILE* file_;
 };
 
+// Counts the frames of a receive stream in benchmark mode. As it claims to
+// smooth the frames itself, they are handed over as soon as they are decoded.
+class FrameCounter : public VideoRenderer {
+ public:
+  FrameCounter() : num_frames_(0) {}
+
+  int num_frames() const { return rtc::AtomicOps::AcquireLoad(&num_frames_); }
+
+ private:
+  void RenderFrame(const VideoFrame& video_frame,
+                   int time_to_render_ms) override {
+    rtc::AtomicOps::Increment(&num_frames_);
+  }
+
+  bool IsTextureSupported() const override { return false; }
+  bool SmoothsRenderedFrames() const override { return true; }
+
+  volatile int num_frames_;
+};
+
+static int TotalFrames(const std::vector<FrameCounter*>& frame_counters) {
+  int total = 0;
+  for (const FrameCounter* frame_counter : frame_counters)
+    total += frame_counter->num_frames();
+  return total;
+}
+
+// Waits for the receive streams to render the frames still in their
+// pipelines, and returns the time of the last progress.
+static int64_t WaitForFramesToDrain(
+    const std::vector<FrameCounter*>& frame_counters) {
+  const int64_t kPollIntervalMs = 10;
+  const int64_t kIdleTimeoutMs = 1000;
+  Clock* clock = Clock::GetRealTimeClock();
+  int last_total = TotalFrames(frame_counters);
+  int64_t last_progress_ms = clock->TimeInMilliseconds();
+  while (clock->TimeInMilliseconds() - last_progress_ms < kIdleTimeoutMs) {
+    SleepMs(kPollIntervalMs);
+    const int total = TotalFrames(frame_counters);
+    if (total != last_total) {
+      last_total = total;
+      last_progress_ms = clock->TimeInMilliseconds();
+    }
+  }
+  return last_progress_ms;
+}
+
+static void PrintBenchmarkResults(
+    const std::vector<VideoReceiveStream*>& receive_streams,
+    const std::vector<FrameCounter*>& frame_counters,
+    int64_t elapsed_ms,
+    double cpu_ms) {
+  RTC_DCHECK_EQ(receive_streams.size(), frame_counters.size());
+  if (elapsed_ms <= 0)
+    elapsed_ms = 1;
+  printf("stream       ssrc  frames      fps  decode_ms  decode_ms_p95  "
+         "jitter_buffer_ms  jitter_buffer_ms_p95  current_delay_ms  "
+         "discarded_packets\n");
+  for (size_t i = 0; i < receive_streams.size(); ++i) {
+    const VideoReceiveStream::Stats stats = receive_streams[i]->GetStats();
+    const int frames = frame_counters[i]->num_frames();
+    printf("%6zu %10u %7d %8.1f %10d %14d %17d %21d %17d %18d\n", i,
+           stats.ssrc, frames, frames * 1000.0 / elapsed_ms, stats.decode_ms,
+           stats.decode_ms_p95, stats.jitter_buffer_ms,
+           stats.jitter_buffer_ms_p95, stats.current_delay_ms,
+           stats.discarded_packets);
+  }
+  const int total_frames = TotalFrames(frame_counters);
+  printf("total: %d frames in %.3f s, %.1f fps\n", total_frames,
+         elapsed_ms / 1000.0, total_frames * 1000.0 / elapsed_ms);
+  // The streams share the process, so only the average CPU use per stream
+  // can be told.
+  printf("cpu: %.1f%% of a core, %.1f%% per stream, %.3f ms per frame\n",
+         100.0 * cpu_ms / elapsed_ms,
+         100.0 * cpu_ms / elapsed_ms / receive_streams.size(),
+         total_frames > 0 ? cpu_ms / total_frames : 0.0);
+}
+
 void RtpReplay() {
-  rtc::scoped_ptr<test::VideoRenderer> playback_video(
-      test::VideoRenderer::Create("Playback Video", 640, 480));
+  const bool benchmark = flags::Benchmark();
+  const int num_streams = benchmark ? flags::NumStreams() : 1;
+
+  rtc::scoped_ptr<test::VideoRenderer> playback_video;
+  if (!benchmark) {
+    playback_video.reset(
+        test::VideoRenderer::Create("Playback Video", 640, 480));
+  }
   FileRenderPassthrough file_passthrough(flags::OutBase(),
                                          playback_video.get());
 
   rtc::scoped_ptr<Call> call(Call::Create(Call::Config()));
 
   test::NullTransport transport;
-  VideoReceiveStream::Config receive_config(&transport);
-  receive_config.rtp.remote_ssrc = flags::Ssrc();
-  receive_config.rtp.local_ssrc = kReceiverLocalSsrc;
-  receive_config.rtp.fec.ulpfec_payload_type = flags::FecPayloadType();
-  receive_config.rtp.fec.red_payload_type = flags::RedPayloadType();
-  receive_config.rtp.nack.rtp_history_ms = 1000;
-  if (flags::TransmissionOffsetId() != -1) {
-    receive_config.rtp.extensions.push_back(
-        RtpExtension(RtpExtension::kTOffset, flags::TransmissionOffsetId()));
-  }
-  if (flags::AbsSendTimeId() != -1) {
-    receive_config.rtp.extensions.push_back(
-        RtpExtension(RtpExtension::kAbsSendTime, flags::AbsSendTimeId()));
-  }
-  receive_config.renderer = &file_passthrough;
-
   VideoSendStream::Config::EncoderSettings encoder_settings;
   encoder_settings.payload_name = flags::Codec();
   encoder_settings.payload_type = flags::PayloadType();
-  VideoReceiveStream::Decoder decoder;
   rtc::scoped_ptr<DecoderBitstreamFileWriter> bitstream_writer;
   if (!flags::DecoderBitstreamFilename().empty()) {
     bitstream_writer.reset(new DecoderBitstreamFileWriter(
         flags::DecoderBitstreamFilename().c_str()));
-    receive_config.pre_decode_callback = bitstream_writer.get();
-  }
-  decoder = test::CreateMatchingDecoder(encoder_settings);
-  if (!flags::DecoderBitstreamFilename().empty()) {
-    // Replace with a null decoder if we're writing the bitstream to a file
-    // instead.
-    delete decoder.decoder;
-    decoder.decoder = new test::FakeNullDecoder();
   }
-  receive_config.decoders.push_back(decoder);
 
-  VideoReceiveStream* receive_stream =
-      call->CreateVideoReceiveStream(receive_config);
+  std::vector<VideoReceiveStream::Decoder> decoders;
+  std::vector<FrameCounter*> frame_counters;
+  std::vector<VideoReceiveStream*> receive_streams;
+  for (int i = 0; i < num_streams; ++i) {
+    VideoReceiveStream::Config receive_config(&transport);
+    receive_config.rtp.remote_ssrc = flags::Ssrc() + i;
+    receive_config.rtp.local_ssrc = kReceiverLocalSsrc + i;
+    receive_config.rtp.fec.ulpfec_payload_type = flags::FecPayloadType();
+    receive_config.rtp.fec.red_payload_type = flags::RedPayloadType();
+    receive_config.rtp.nack.rtp_history_ms = 1000;
+    if (flags::TransmissionOffsetId() != -1) {
+      receive_config.rtp.extensions.push_back(
+          RtpExtension(RtpExtension::kTOffset, flags::TransmissionOffsetId()));
+    }
+    if (flags::AbsSendTimeId() != -1) {
+      receive_config.rtp.extensions.push_back(
+          RtpExtension(RtpExtension::kAbsSendTime, flags::AbsSendTimeId()));
+    }
+    if (benchmark) {
+      frame_counters.push_back(new FrameCounter());
+      receive_config.renderer = frame_counters.back();
+    } else {
+      receive_config.renderer = &file_passthrough;
+    }
+
+    // Only the first stream's bitstream is written to file.
+    if (i == 0)
+      receive_config.pre_decode_callback = bitstream_writer.get();
+    VideoReceiveStream::Decoder decoder =
+        test::CreateMatchingDecoder(encoder_settings);
+    if (!flags::DecoderBitstreamFilename().empty()) {
+      // Replace with a null decoder if we're writing the bitstream to a file
+      // instead.
+      delete decoder.decoder;
+      decoder.decoder = new test::FakeNullDecoder();
+    }
+    decoders.push_back(decoder);
+    receive_config.decoders.push_back(decoder);
+
+    receive_streams.push_back(call->CreateVideoReceiveStream(receive_config));
+  }
 
   rtc::scoped_ptr<test::RtpFileReader> rtp_reader(test::RtpFileReader::Create(
       test::RtpFileReader::kRtpDump, flags::InputFile()));
@@ -274,8 +392,11 @@ void RtpReplay() {
       }
     }
   }
-  receive_stream->Start();
+  for (VideoReceiveStream* receive_stream : receive_streams)
+    receive_stream->Start();
 
+  const int64_t start_ms = Clock::GetRealTimeClock()->TimeInMilliseconds();
+  const std::clock_t start_cpu = std::clock();
   uint32_t last_time_ms = 0;
   int num_packets = 0;
   std::map<uint32_t, int> unknown_packets;
@@ -284,30 +405,52 @@ void RtpReplay() {
     if (!rtp_reader->NextPacket(&packet))
       break;
     ++num_packets;
-    switch (call->Receiver()->DeliverPacket(webrtc::MediaType::ANY, packet.data,
-                                            packet.length, PacketTime())) {
-      case PacketReceiver::DELIVERY_OK:
-        break;
-      case PacketReceiver::DELIVERY_UNKNOWN_SSRC: {
-        RTPHeader header;
-        rtc::scoped_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
-        parser->Parse(packet.data, packet.length, &header);
-        if (unknown_packets[header.ssrc] == 0)
-          fprintf(stderr, "Unknown SSRC: %u!\n", header.ssrc);
-        ++unknown_packets[header.ssrc];
-        break;
+    // The copies of the stream get their own SSRCs, written over the SSRC of
+    // the RTP header.
+    const bool copy_packet =
+        num_streams > 1 && !RtpHeaderParser::IsRtcp(packet.data,
+                                                     packet.length) &&
+        packet.length >= 12 &&
+        ByteReader<uint32_t>::ReadBigEndian(&packet.data[8]) == flags::Ssrc();
+    for (int i = 0; i < (copy_packet ? num_streams : 1); ++i) {
+      if (copy_packet)
+        ByteWriter<uint32_t>::WriteBigEndian(&packet.data[8],
+                                             flags::Ssrc() + i);
+      switch (call->Receiver()->DeliverPacket(webrtc::MediaType::ANY,
+                                              packet.data, packet.length,
+                                              PacketTime())) {
+        case PacketReceiver::DELIVERY_OK:
+          break;
+        case PacketReceiver::DELIVERY_UNKNOWN_SSRC: {
+          RTPHeader header;
+          rtc::scoped_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
+          parser->Parse(packet.data, packet.length, &header);
+          if (unknown_packets[header.ssrc] == 0)
+            fprintf(stderr, "Unknown SSRC: %u!\n", header.ssrc);
+          ++unknown_packets[header.ssrc];
+          break;
+        }
+        case PacketReceiver::DELIVERY_PACKET_ERROR:
+          fprintf(stderr,
+                  "Packet error, corrupt packets or incorrect setup?\n");
+          break;
       }
-      case PacketReceiver::DELIVERY_PACKET_ERROR:
-        fprintf(stderr, "Packet error, corrupt packets or incorrect setup?\n");
-        break;
     }
-    if (last_time_ms != 0 && last_time_ms != packet.time_ms) {
+    if (!benchmark && last_time_ms != 0 && last_time_ms != packet.time_ms) {
       SleepMs(packet.time_ms - last_time_ms);
     }
     last_time_ms = packet.time_ms;
   }
   fprintf(stderr, "num_packets: %d\n", num_packets);
 
+  if (benchmark) {
+    const int64_t end_ms = WaitForFramesToDrain(frame_counters);
+    const double cpu_ms =
+        1000.0 * (std::clock() - start_cpu) / CLOCKS_PER_SEC;
+    PrintBenchmarkResults(receive_streams, frame_counters, end_ms - start_ms,
+                          cpu_ms);
+  }
+
   for (std::map<uint32_t, int>::const_iterator it = unknown_packets.begin();
        it != unknown_packets.end();
        ++it) {
@@ -315,9 +458,13 @@ void RtpReplay() {
         stderr, "Packets for unknown ssrc '%u': %d\n", it->first, it->second);
   }
 
-  call->DestroyVideoReceiveStream(receive_stream);
+  for (VideoReceiveStream* receive_stream : receive_streams)
+    call->DestroyVideoReceiveStream(receive_stream);
 
-  delete decoder.decoder;
+  for (const VideoReceiveStream::Decoder& decoder : decoders)
+    delete decoder.decoder;
+  for (FrameCounter* frame_counter : frame_counters)
+    delete frame_counter;
 }
 }  // namespace webrtc
 
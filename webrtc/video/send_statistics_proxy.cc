@@ -14,6 +14,7 @@
 #include <cmath>
 #include <map>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
@@ -64,6 +65,7 @@ void UpdateCodecTypeHistogram(const std::string& payload_name) {
 
 
 const int SendStatisticsProxy::kStatsTimeoutMs = 5000;
+const int64_t SendStatisticsProxy::kSnapshotIntervalMs = 1000;
 
 SendStatisticsProxy::SendStatisticsProxy(
     Clock* clock,
@@ -74,6 +76,8 @@ SendStatisticsProxy::SendStatisticsProxy(
       content_type_(content_type),
       last_sent_frame_timestamp_(0),
       encode_time_(kEncodeTimeWeigthFactor),
+      last_snapshot_ms_(-1),
+      snapshot_outdated_(1),
       uma_container_(new UmaSamplesContainer(GetUmaPrefix(content_type_))) {
   UpdateCodecTypeHistogram(config_.encoder_settings.payload_name);
 }
@@ -188,6 +192,7 @@ void SendStatisticsProxy::CpuOveruseMetricsUpdated(
 void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
   rtc::CritScope lock(&crit_);
   stats_.suspended = is_suspended;
+  rtc::AtomicOps::ReleaseStore(&snapshot_outdated_, 1);
 }
 
 VideoSendStream::Stats SendStatisticsProxy::GetStats() {
@@ -195,18 +200,77 @@ VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   PurgeOldStats();
   stats_.input_frame_rate =
       round(uma_container_->input_frame_rate_tracker_.ComputeRate());
+  stats_.encode_time_p95_ms = encode_time_histogram_.Percentile(95);
   return stats_;
 }
 
+VideoSendStream::Stats SendStatisticsProxy::GetStatsSnapshot() {
+  return GetSnapshot()->value.stats;
+}
+
+VideoSendStream::Stats SendStatisticsProxy::GetStatsDelta(uint64_t* version) {
+  StatsSnapshot<Snapshot>::PublishedRef snapshot = GetSnapshot();
+  VideoSendStream::Stats stats = snapshot->value.stats;
+  for (auto it = stats.substreams.begin(); it != stats.substreams.end();) {
+    auto version_it = snapshot->value.substream_versions.find(it->first);
+    if (version_it != snapshot->value.substream_versions.end() &&
+        version_it->second <= *version) {
+      it = stats.substreams.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  *version = snapshot->version;
+  return stats;
+}
+
+StatsSnapshot<SendStatisticsProxy::Snapshot>::PublishedRef
+SendStatisticsProxy::GetSnapshot() {
+  StatsSnapshot<Snapshot>::PublishedRef snapshot = snapshot_.Get();
+  // Streams that don't send frames don't publish, so readers publish
+  // themselves if the snapshot is too old.
+  if (!snapshot || rtc::AtomicOps::AcquireLoad(&snapshot_outdated_) ||
+      clock_->TimeInMilliseconds() - snapshot->time_ms >
+          2 * kSnapshotIntervalMs) {
+    rtc::CritScope lock(&crit_);
+    PublishSnapshot();
+    snapshot = snapshot_.Get();
+  }
+  return snapshot;
+}
+
+void SendStatisticsProxy::MaybePublishSnapshot() {
+  if (!rtc::AtomicOps::AcquireLoad(&snapshot_outdated_) &&
+      clock_->TimeInMilliseconds() - last_snapshot_ms_ < kSnapshotIntervalMs) {
+    return;
+  }
+  PublishSnapshot();
+}
+
+void SendStatisticsProxy::PublishSnapshot() {
+  PurgeOldStats();
+  stats_.input_frame_rate =
+      round(uma_container_->input_frame_rate_tracker_.ComputeRate());
+  stats_.encode_time_p95_ms = encode_time_histogram_.Percentile(95);
+  Snapshot snapshot;
+  snapshot.stats = stats_;
+  snapshot.substream_versions = substream_versions_;
+  last_snapshot_ms_ = clock_->TimeInMilliseconds();
+  rtc::AtomicOps::ReleaseStore(&snapshot_outdated_, 0);
+  snapshot_.Publish(snapshot, last_snapshot_ms_);
+}
+
 void SendStatisticsProxy::PurgeOldStats() {
   int64_t old_stats_ms = clock_->TimeInMilliseconds() - kStatsTimeoutMs;
   for (std::map<uint32_t, VideoSendStream::StreamStats>::iterator it =
            stats_.substreams.begin();
        it != stats_.substreams.end(); ++it) {
     uint32_t ssrc = it->first;
-    if (update_times_[ssrc].resolution_update_ms <= old_stats_ms) {
+    if (update_times_[ssrc].resolution_update_ms <= old_stats_ms &&
+        (it->second.width != 0 || it->second.height != 0)) {
       it->second.width = 0;
       it->second.height = 0;
+      substream_versions_[ssrc] = snapshot_.next_version();
     }
   }
 }
@@ -215,8 +279,11 @@ VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
     uint32_t ssrc) {
   std::map<uint32_t, VideoSendStream::StreamStats>::iterator it =
       stats_.substreams.find(ssrc);
-  if (it != stats_.substreams.end())
+  if (it != stats_.substreams.end()) {
+    // The caller updates the entry.
+    substream_versions_[ssrc] = snapshot_.next_version();
     return &it->second;
+  }
 
   if (std::find(config_.rtp.ssrcs.begin(), config_.rtp.ssrcs.end(), ssrc) ==
           config_.rtp.ssrcs.end() &&
@@ -226,6 +293,8 @@ VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
     return nullptr;
   }
 
+  substream_versions_[ssrc] = snapshot_.next_version();
+  rtc::AtomicOps::ReleaseStore(&snapshot_outdated_, 1);
   return &stats_.substreams[ssrc];  // Insert new entry and return ptr.
 }
 
@@ -312,6 +381,7 @@ void SendStatisticsProxy::OnSendEncodedImage(
   uma_container_->max_sent_height_per_timestamp_ =
       std::max(uma_container_->max_sent_height_per_timestamp_,
                static_cast<int>(encoded_image._encodedHeight));
+  MaybePublishSnapshot();
 }
 
 void SendStatisticsProxy::OnIncomingFrame(int width, int height) {
@@ -319,9 +389,11 @@ void SendStatisticsProxy::OnIncomingFrame(int width, int height) {
   uma_container_->input_frame_rate_tracker_.AddSamples(1);
   uma_container_->input_width_counter_.Add(width);
   uma_container_->input_height_counter_.Add(height);
+  MaybePublishSnapshot();
 }
 
 void SendStatisticsProxy::OnEncodedFrame(int encode_time_ms) {
+  encode_time_histogram_.Add(encode_time_ms);
   rtc::CritScope lock(&crit_);
   uma_container_->encode_time_counter_.Add(encode_time_ms);
   encode_time_.Apply(1.0f, encode_time_ms);
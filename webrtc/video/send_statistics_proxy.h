@@ -23,7 +23,9 @@
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/latency_histogram.h"
 #include "webrtc/video/overuse_frame_detector.h"
+#include "webrtc/video/stats_snapshot.h"
 #include "webrtc/video/vie_encoder.h"
 #include "webrtc/video_send_stream.h"
 
@@ -39,6 +41,7 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
                             public SendSideDelayObserver {
  public:
   static const int kStatsTimeoutMs;
+  static const int64_t kSnapshotIntervalMs;
 
   SendStatisticsProxy(Clock* clock,
                       const VideoSendStream::Config& config,
@@ -47,6 +50,18 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
 
   VideoSendStream::Stats GetStats();
 
+  // Returns the stats as of the last snapshot, which is at most
+  // |kSnapshotIntervalMs| old while frames are being sent. Unlike GetStats(),
+  // this does not take the lock that every stats update takes, and is meant
+  // for frequent polling.
+  VideoSendStream::Stats GetStatsSnapshot();
+
+  // Like GetStatsSnapshot(), but only includes the substreams that have
+  // changed since the snapshot with version |*version|, for exporting stats
+  // as deltas. Sets |*version| to the version of the returned snapshot. Start
+  // with a |*version| of 0 to get all substreams.
+  VideoSendStream::Stats GetStatsDelta(uint64_t* version);
+
   virtual void OnSendEncodedImage(const EncodedImage& encoded_image,
                                   const RTPVideoHeader* rtp_video_header);
   // Used to update incoming frame rate.
@@ -125,9 +140,19 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     int64_t resolution_update_ms;
     int64_t bitrate_update_ms;
   };
+  struct Snapshot {
+    VideoSendStream::Stats stats;
+    // The version of the first snapshot with the current value of each
+    // substream.
+    std::map<uint32_t, uint64_t> substream_versions;
+  };
   void PurgeOldStats() EXCLUSIVE_LOCKS_REQUIRED(crit_);
   VideoSendStream::StreamStats* GetStatsEntry(uint32_t ssrc)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void MaybePublishSnapshot() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void PublishSnapshot() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Returns a snapshot that is recent enough to be returned to readers.
+  StatsSnapshot<Snapshot>::PublishedRef GetSnapshot();
 
   Clock* const clock_;
   const VideoSendStream::Config config_;
@@ -137,6 +162,16 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   uint32_t last_sent_frame_timestamp_ GUARDED_BY(crit_);
   std::map<uint32_t, StatsUpdateTimes> update_times_ GUARDED_BY(crit_);
   rtc::ExpFilter encode_time_ GUARDED_BY(crit_);
+  // Lock-free, so that the encoder thread records without contending with
+  // stats readers.
+  LatencyHistogram encode_time_histogram_;
+  std::map<uint32_t, uint64_t> substream_versions_ GUARDED_BY(crit_);
+  // Publishing is serialized by |crit_|.
+  StatsSnapshot<Snapshot> snapshot_;
+  int64_t last_snapshot_ms_ GUARDED_BY(crit_);
+  // Set when a change should be seen by readers right away, such as a new
+  // substream or a suspension, rather than at the next periodic snapshot.
+  volatile int snapshot_outdated_;
 
   // Contains stats used for UMA histograms. These stats will be reset if
   // content type changes between real-time video and screenshare, since these
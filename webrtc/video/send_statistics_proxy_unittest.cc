@@ -297,6 +297,16 @@ TEST_F(SendStatisticsProxyTest, OnEncodedFrame) {
   EXPECT_EQ(kEncodeTimeMs, stats.avg_encode_time_ms);
 }
 
+TEST_F(SendStatisticsProxyTest, EncodeTimePercentileIgnoresOutliers) {
+  EXPECT_EQ(-1, statistics_proxy_->GetStats().encode_time_p95_ms);
+  for (int i = 0; i < 19; ++i)
+    statistics_proxy_->OnEncodedFrame(10);
+  statistics_proxy_->OnEncodedFrame(100);
+
+  // 10 ms falls in the [10, 11] bucket.
+  EXPECT_EQ(11, statistics_proxy_->GetStats().encode_time_p95_ms);
+}
+
 TEST_F(SendStatisticsProxyTest, SwitchContentTypeUpdatesHistograms) {
   test::ClearHistograms();
   const int kMinRequiredSamples = 200;
@@ -431,4 +441,70 @@ TEST_F(SendStatisticsProxyTest, ClearsBitratesFromInactiveSsrcs) {
   EXPECT_EQ(0, stats.substreams[config_.rtp.ssrcs[1]].retransmit_bitrate_bps);
 }
 
+TEST_F(SendStatisticsProxyTest, SnapshotIsPublishedPeriodically) {
+  BitrateStatistics bitrate;
+  bitrate.bitrate_bps = 42;
+  BitrateStatisticsObserver* observer = statistics_proxy_.get();
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[0]);
+  // A new substream is published right away.
+  EXPECT_EQ(42, statistics_proxy_->GetStatsSnapshot()
+                    .substreams[config_.rtp.ssrcs[0]]
+                    .total_bitrate_bps);
+
+  // Other changes wait for the next snapshot.
+  bitrate.bitrate_bps = 84;
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[0]);
+  statistics_proxy_->OnIncomingFrame(640, 480);
+  EXPECT_EQ(42, statistics_proxy_->GetStatsSnapshot()
+                    .substreams[config_.rtp.ssrcs[0]]
+                    .total_bitrate_bps);
+
+  fake_clock_.AdvanceTimeMilliseconds(SendStatisticsProxy::kSnapshotIntervalMs);
+  statistics_proxy_->OnIncomingFrame(640, 480);
+  EXPECT_EQ(84, statistics_proxy_->GetStatsSnapshot()
+                    .substreams[config_.rtp.ssrcs[0]]
+                    .total_bitrate_bps);
+
+  // Without frames, readers update an old snapshot.
+  bitrate.bitrate_bps = 126;
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[0]);
+  fake_clock_.AdvanceTimeMilliseconds(2 *
+                                      SendStatisticsProxy::kSnapshotIntervalMs);
+  EXPECT_EQ(84, statistics_proxy_->GetStatsSnapshot()
+                    .substreams[config_.rtp.ssrcs[0]]
+                    .total_bitrate_bps);
+  fake_clock_.AdvanceTimeMilliseconds(1);
+  EXPECT_EQ(126, statistics_proxy_->GetStatsSnapshot()
+                     .substreams[config_.rtp.ssrcs[0]]
+                     .total_bitrate_bps);
+}
+
+TEST_F(SendStatisticsProxyTest, SnapshotDeltaHasChangedSubstreams) {
+  BitrateStatistics bitrate;
+  bitrate.bitrate_bps = 42;
+  BitrateStatisticsObserver* observer = statistics_proxy_.get();
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[0]);
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[1]);
+
+  uint64_t version = 0;
+  VideoSendStream::Stats stats = statistics_proxy_->GetStatsDelta(&version);
+  EXPECT_EQ(2u, stats.substreams.size());
+  EXPECT_GT(version, 0u);
+
+  // Nothing has changed.
+  stats = statistics_proxy_->GetStatsDelta(&version);
+  EXPECT_TRUE(stats.substreams.empty());
+
+  bitrate.bitrate_bps = 84;
+  observer->Notify(bitrate, bitrate, config_.rtp.ssrcs[1]);
+  fake_clock_.AdvanceTimeMilliseconds(SendStatisticsProxy::kSnapshotIntervalMs);
+  statistics_proxy_->OnIncomingFrame(640, 480);
+  stats = statistics_proxy_->GetStatsDelta(&version);
+  ASSERT_EQ(1u, stats.substreams.size());
+  EXPECT_EQ(84, stats.substreams[config_.rtp.ssrcs[1]].total_bitrate_bps);
+
+  // The full snapshot still has both substreams.
+  EXPECT_EQ(2u, statistics_proxy_->GetStatsSnapshot().substreams.size());
+}
+
 }  // namespace webrtc
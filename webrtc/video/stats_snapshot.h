@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_STATS_SNAPSHOT_H_
+#define WEBRTC_VIDEO_STATS_SNAPSHOT_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace webrtc {
+
+// Holds the latest published copy of some stats. The copy is made by the
+// thread that updates the stats, when it publishes them, so that readers
+// don't take the lock that every update takes. A reader only holds |lock_|
+// while it takes a reference to the published copy, and copies it after.
+template <typename T>
+class StatsSnapshot {
+ public:
+  struct Published {
+    T value;
+    int64_t time_ms = 0;
+    // Published copies are numbered from 1.
+    uint64_t version = 0;
+  };
+  typedef rtc::scoped_refptr<rtc::RefCountedObject<Published>> PublishedRef;
+
+  StatsSnapshot() : num_published_(0) {}
+
+  // Calls must be serialized by the caller, e.g. by the lock that guards the
+  // stats.
+  void Publish(const T& value, int64_t now_ms) {
+    PublishedRef published(new rtc::RefCountedObject<Published>());
+    published->value = value;
+    published->time_ms = now_ms;
+    published->version = ++num_published_;
+    rtc::CritScope lock(&lock_);
+    // The previous copy is released after |lock_|, when |published| goes out
+    // of scope.
+    latest_.swap(published);
+  }
+
+  // The version that the next call to Publish() will have. Same threading as
+  // Publish().
+  uint64_t next_version() const { return num_published_ + 1; }
+
+  // Returns null if nothing has been published. Can be called on any thread.
+  PublishedRef Get() const {
+    rtc::CritScope lock(&lock_);
+    return latest_;
+  }
+
+ private:
+  uint64_t num_published_;
+  mutable rtc::CriticalSection lock_;
+  PublishedRef latest_ GUARDED_BY(lock_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StatsSnapshot);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_STATS_SNAPSHOT_H_
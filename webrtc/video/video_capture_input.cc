@@ -34,13 +34,16 @@ VideoCaptureInput::VideoCaptureInput(
     VideoRenderer* local_renderer,
     SendStatisticsProxy* stats_proxy,
     CpuOveruseObserver* overuse_observer,
-    EncodingTimeObserver* encoding_time_observer)
+    EncodingTimeObserver* encoding_time_observer,
+    EncoderThreadPool* encoder_thread_pool,
+    CpuBudgetCoordinator* cpu_budget_coordinator)
     : capture_cs_(CriticalSectionWrapper::CreateCriticalSection()),
       module_process_thread_(module_process_thread),
       frame_callback_(frame_callback),
       local_renderer_(local_renderer),
       stats_proxy_(stats_proxy),
       incoming_frame_cs_(CriticalSectionWrapper::CreateCriticalSection()),
+      encoder_thread_pool_(encoder_thread_pool),
       encoder_thread_(EncoderThreadFunction, this, "EncoderThread"),
       capture_event_(false, false),
       stop_(0),
@@ -51,20 +54,30 @@ VideoCaptureInput::VideoCaptureInput(
       overuse_detector_(new OveruseFrameDetector(Clock::GetRealTimeClock(),
                                                  CpuOveruseOptions(),
                                                  overuse_observer,
-                                                 stats_proxy)),
+                                                 stats_proxy,
+                                                 cpu_budget_coordinator)),
       encoding_time_observer_(encoding_time_observer) {
-  encoder_thread_.Start();
-  encoder_thread_.SetPriority(rtc::kHighPriority);
+  dropped_update_region_.SetEmpty();
+  if (encoder_thread_pool_) {
+    encoder_thread_pool_->AddTask(this);
+  } else {
+    encoder_thread_.Start();
+    encoder_thread_.SetPriority(rtc::kHighPriority);
+  }
   module_process_thread_->RegisterModule(overuse_detector_.get());
 }
 
 VideoCaptureInput::~VideoCaptureInput() {
   module_process_thread_->DeRegisterModule(overuse_detector_.get());
 
-  // Stop the thread.
-  rtc::AtomicOps::ReleaseStore(&stop_, 1);
-  capture_event_.Set();
-  encoder_thread_.Stop();
+  if (encoder_thread_pool_) {
+    encoder_thread_pool_->RemoveTask(this);
+  } else {
+    // Stop the thread.
+    rtc::AtomicOps::ReleaseStore(&stop_, 1);
+    capture_event_.Set();
+    encoder_thread_.Stop();
+  }
 }
 
 void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
@@ -102,9 +115,19 @@ void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
                     << incoming_frame.ntp_time_ms()
                     << " <= " << last_captured_timestamp_
                     << ") for incoming frame. Dropping.";
+    dropped_update_region_.Add(incoming_frame.update_region());
     return;
   }
 
+  // The encoder will only see this frame, so it has to include whatever
+  // changed in the frames it replaces.
+  VideoFrameUpdateRegion* update_region =
+      incoming_frame.mutable_update_region();
+  update_region->Add(dropped_update_region_);
+  dropped_update_region_.SetEmpty();
+  if (!captured_frame_.IsZeroSize())
+    update_region->Add(captured_frame_.update_region());
+
   captured_frame_.ShallowCopy(incoming_frame);
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
 
@@ -115,7 +138,14 @@ void VideoCaptureInput::IncomingCapturedFrame(const VideoFrame& video_frame) {
   TRACE_EVENT_ASYNC_BEGIN1("webrtc", "Video", video_frame.render_time_ms(),
                            "render_time", video_frame.render_time_ms());
 
-  capture_event_.Set();
+  if (encoder_thread_pool_)
+    encoder_thread_pool_->Signal(this);
+  else
+    capture_event_.Set();
+}
+
+bool VideoCaptureInput::WillDropFrame() {
+  return frame_callback_->WillDropFrame();
 }
 
 bool VideoCaptureInput::EncoderThreadFunction(void* obj) {
@@ -124,41 +154,48 @@ bool VideoCaptureInput::EncoderThreadFunction(void* obj) {
 
 bool VideoCaptureInput::EncoderProcess() {
   static const int kThreadWaitTimeMs = 100;
-  int64_t capture_time = -1;
   if (capture_event_.Wait(kThreadWaitTimeMs)) {
     if (rtc::AtomicOps::AcquireLoad(&stop_))
       return false;
+    DeliverCapturedFrame();
+  }
+  return true;
+}
 
-    int64_t encode_start_time = -1;
-    VideoFrame deliver_frame;
-    {
-      CriticalSectionScoped cs(capture_cs_.get());
-      if (!captured_frame_.IsZeroSize()) {
-        deliver_frame = captured_frame_;
-        captured_frame_.Reset();
-      }
-    }
-    if (!deliver_frame.IsZeroSize()) {
-      capture_time = deliver_frame.render_time_ms();
-      encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
-      frame_callback_->DeliverFrame(deliver_frame);
+void VideoCaptureInput::Run() {
+  DeliverCapturedFrame();
+}
+
+void VideoCaptureInput::DeliverCapturedFrame() {
+  int64_t capture_time = -1;
+  int64_t encode_start_time = -1;
+  VideoFrame deliver_frame;
+  {
+    CriticalSectionScoped cs(capture_cs_.get());
+    if (!captured_frame_.IsZeroSize()) {
+      deliver_frame = captured_frame_;
+      captured_frame_.Reset();
     }
-    // Update the overuse detector with the duration.
-    if (encode_start_time != -1) {
-      int encode_time_ms = static_cast<int>(
-          Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time);
-      stats_proxy_->OnEncodedFrame(encode_time_ms);
-      if (encoding_time_observer_) {
-        encoding_time_observer_->OnReportEncodedTime(
-            deliver_frame.ntp_time_ms(), encode_time_ms);
-      }
+  }
+  if (!deliver_frame.IsZeroSize()) {
+    capture_time = deliver_frame.render_time_ms();
+    encode_start_time = Clock::GetRealTimeClock()->TimeInMilliseconds();
+    frame_callback_->DeliverFrame(deliver_frame);
+  }
+  // Update the overuse detector with the duration.
+  if (encode_start_time != -1) {
+    int encode_time_ms = static_cast<int>(
+        Clock::GetRealTimeClock()->TimeInMilliseconds() - encode_start_time);
+    stats_proxy_->OnEncodedFrame(encode_time_ms);
+    if (encoding_time_observer_) {
+      encoding_time_observer_->OnReportEncodedTime(
+          deliver_frame.ntp_time_ms(), encode_time_ms);
     }
   }
   // We're done!
   if (capture_time != -1) {
     overuse_detector_->FrameSent(capture_time);
   }
-  return true;
 }
 
 }  // namespace internal
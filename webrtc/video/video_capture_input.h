@@ -26,11 +26,13 @@
 #include "webrtc/modules/video_processing/include/video_processing.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
+#include "webrtc/video/encoder_thread_pool.h"
 #include "webrtc/video_send_stream.h"
 
 namespace webrtc {
 
 class Config;
+class CpuBudgetCoordinator;
 class CpuOveruseMetricsObserver;
 class CpuOveruseObserver;
 class CriticalSectionWrapper;
@@ -45,26 +47,42 @@ class VideoCaptureCallback {
   virtual ~VideoCaptureCallback() {}
 
   virtual void DeliverFrame(VideoFrame video_frame) = 0;
+  // Returns true if a frame delivered now would be dropped.
+  virtual bool WillDropFrame() = 0;
 };
 
 namespace internal {
-class VideoCaptureInput : public webrtc::VideoCaptureInput {
+class VideoCaptureInput : public webrtc::VideoCaptureInput,
+                          private EncoderThreadPool::Task {
  public:
+  // Frames are delivered on |encoder_thread_pool| if it is set, and on a
+  // thread of this object's own otherwise. Overuse is detected together with
+  // the other streams of |cpu_budget_coordinator|, if it is set. Both must
+  // outlive this object.
   VideoCaptureInput(ProcessThread* module_process_thread,
                     VideoCaptureCallback* frame_callback,
                     VideoRenderer* local_renderer,
                     SendStatisticsProxy* send_stats_proxy,
                     CpuOveruseObserver* overuse_observer,
-                    EncodingTimeObserver* encoding_time_observer);
+                    EncodingTimeObserver* encoding_time_observer,
+                    EncoderThreadPool* encoder_thread_pool,
+                    CpuBudgetCoordinator* cpu_budget_coordinator);
   ~VideoCaptureInput();
 
   void IncomingCapturedFrame(const VideoFrame& video_frame) override;
+  bool WillDropFrame() override;
 
  private:
   // Thread functions for deliver captured frames to receivers.
   static bool EncoderThreadFunction(void* obj);
   bool EncoderProcess();
 
+  // Implements EncoderThreadPool::Task.
+  void Run() override;
+
+  // Delivers the last captured frame, if there is one.
+  void DeliverCapturedFrame();
+
   rtc::scoped_ptr<CriticalSectionWrapper> capture_cs_;
   ProcessThread* const module_process_thread_;
 
@@ -76,12 +94,18 @@ class VideoCaptureInput : public webrtc::VideoCaptureInput {
   rtc::scoped_ptr<CriticalSectionWrapper> incoming_frame_cs_;
   VideoFrame incoming_frame_;
 
+  // Either frames are delivered on |encoder_thread_pool_|, or on
+  // |encoder_thread_| when there is no pool.
+  EncoderThreadPool* const encoder_thread_pool_;
   rtc::PlatformThread encoder_thread_;
   rtc::Event capture_event_;
 
   volatile int stop_;
 
   VideoFrame captured_frame_ GUARDED_BY(capture_cs_.get());
+  // What changed in frames that were dropped before |captured_frame_| was
+  // set, to be added to the update region of the next frame.
+  VideoFrameUpdateRegion dropped_update_region_ GUARDED_BY(capture_cs_.get());
   // Used to make sure incoming time stamp is increasing for every frame.
   int64_t last_captured_timestamp_;
   // Delta used for translating between NTP and internal timestamps.
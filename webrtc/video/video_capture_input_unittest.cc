@@ -37,6 +37,7 @@ namespace webrtc {
 class MockVideoCaptureCallback : public VideoCaptureCallback {
  public:
   MOCK_METHOD1(DeliverFrame, void(VideoFrame video_frame));
+  MOCK_METHOD0(WillDropFrame, bool());
 };
 
 bool EqualFrames(const VideoFrame& frame1, const VideoFrame& frame2);
@@ -64,7 +65,7 @@ class VideoCaptureInputTest : public ::testing::Test {
     Config config;
     input_.reset(new internal::VideoCaptureInput(
         mock_process_thread_.get(), mock_frame_callback_.get(), nullptr,
-        &stats_proxy_, nullptr, nullptr));
+        &stats_proxy_, nullptr, nullptr, nullptr, nullptr));
   }
 
   virtual void TearDown() {
@@ -186,6 +187,29 @@ TEST_F(VideoCaptureInputTest, DropsFramesWithSameOrOldNtpTimestamp) {
             input_frames_[0]->ntp_time_ms() * 90);
 }
 
+TEST_F(VideoCaptureInputTest, AddsUpdateRegionOfDroppedFrames) {
+  input_frames_.push_back(CreateVideoFrame(0));
+  input_frames_[0]->set_ntp_time_ms(17);
+  AddInputFrame(input_frames_[0]);
+  WaitOutputFrame();
+
+  // Dropped for its NTP timestamp, but what changed in it must still be
+  // encoded with the next frame.
+  input_frames_[0]->mutable_update_region()->SetEmpty();
+  input_frames_[0]->mutable_update_region()->AddRect(0, 0, 16, 16);
+  AddInputFrame(input_frames_[0]);
+  EXPECT_FALSE(output_frame_event_.Wait(FRAME_TIMEOUT_MS));
+
+  input_frames_[0]->set_ntp_time_ms(4711);
+  input_frames_[0]->mutable_update_region()->SetEmpty();
+  input_frames_[0]->mutable_update_region()->AddRect(32, 32, 16, 16);
+  AddInputFrame(input_frames_[0]);
+  WaitOutputFrame();
+  const VideoFrameUpdateRegion& region = output_frames_[1]->update_region();
+  EXPECT_TRUE(region.known());
+  EXPECT_EQ(2u, region.rects().size());
+}
+
 TEST_F(VideoCaptureInputTest, TestTextureFrames) {
   const int kNumFrame = 3;
   for (int i = 0 ; i < kNumFrame; ++i) {
@@ -247,6 +271,27 @@ TEST_F(VideoCaptureInputTest, TestTextureFrameAfterI420Frame) {
   EXPECT_TRUE(EqualFramesVector(input_frames_, output_frames_));
 }
 
+TEST_F(VideoCaptureInputTest, DeliversFramesOnEncoderThreadPool) {
+  EncoderThreadPool pool(1, false);
+  input_.reset(new internal::VideoCaptureInput(
+      mock_process_thread_.get(), mock_frame_callback_.get(), nullptr,
+      &stats_proxy_, nullptr, nullptr, &pool, nullptr));
+  EXPECT_EQ(1u, pool.NumTasksPerThread()[0]);
+
+  const int kNumFrame = 3;
+  for (int i = 0; i < kNumFrame; ++i) {
+    input_frames_.push_back(CreateVideoFrame(static_cast<uint8_t>(i + 1)));
+    // Different render times to make sure no frame is dropped.
+    input_frames_[i]->set_render_time_ms(i + 1);
+    AddInputFrame(input_frames_[i]);
+    WaitOutputFrame();
+  }
+  EXPECT_TRUE(EqualFramesVector(input_frames_, output_frames_));
+
+  input_.reset();
+  EXPECT_EQ(0u, pool.NumTasksPerThread()[0]);
+}
+
 bool EqualFrames(const VideoFrame& frame1, const VideoFrame& frame2) {
   if (frame1.native_handle() != NULL || frame2.native_handle() != NULL)
     return EqualTextureFrames(frame1, frame2);
@@ -326,7 +326,7 @@ void VideoReceiveStream::SetSyncChannel(VoiceEngine* voice_engine,
 }
 
 VideoReceiveStream::Stats VideoReceiveStream::GetStats() const {
-  return stats_proxy_->GetStats();
+  return stats_proxy_->GetStatsSnapshot();
 }
 
 bool VideoReceiveStream::DeliverRtcp(const uint8_t* packet, size_t length) {
@@ -116,7 +116,9 @@ VideoSendStream::VideoSendStream(
     BitrateAllocator* bitrate_allocator,
     const VideoSendStream::Config& config,
     const VideoEncoderConfig& encoder_config,
-    const std::map<uint32_t, RtpState>& suspended_ssrcs)
+    const std::map<uint32_t, RtpState>& suspended_ssrcs,
+    EncoderThreadPool* encoder_thread_pool,
+    CpuBudgetCoordinator* cpu_budget_coordinator)
     : stats_proxy_(Clock::GetRealTimeClock(),
                    config,
                    encoder_config.content_type),
@@ -208,7 +210,8 @@ VideoSendStream::VideoSendStream(
 
   input_.reset(new internal::VideoCaptureInput(
       module_process_thread_, vie_encoder_.get(), config_.local_renderer,
-      &stats_proxy_, this, config_.encoding_time_observer));
+      &stats_proxy_, this, config_.encoding_time_observer,
+      encoder_thread_pool, cpu_budget_coordinator));
 
   // 28 to match packet overhead in ModuleRtpRtcpImpl.
   RTC_DCHECK_LE(config_.rtp.max_packet_size, static_cast<size_t>(0xFFFF - 28));
@@ -452,7 +455,9 @@ bool VideoSendStream::DeliverRtcp(const uint8_t* packet, size_t length) {
 }
 
 VideoSendStream::Stats VideoSendStream::GetStats() {
-  return stats_proxy_.GetStats();
+  Stats stats = stats_proxy_.GetStatsSnapshot();
+  stats.packet_history_bytes = vie_channel_->PacketHistoryMemoryUsage();
+  return stats;
 }
 
 void VideoSendStream::OveruseDetected() {
@@ -29,8 +29,10 @@ namespace webrtc {
 
 class BitrateAllocator;
 class CallStats;
+class CpuBudgetCoordinator;
 class CongestionController;
 class EncoderStateFeedback;
+class EncoderThreadPool;
 class ProcessThread;
 class ViEChannel;
 class ViEEncoder;
@@ -47,7 +49,9 @@ class VideoSendStream : public webrtc::VideoSendStream,
                   BitrateAllocator* bitrate_allocator,
                   const VideoSendStream::Config& config,
                   const VideoEncoderConfig& encoder_config,
-                  const std::map<uint32_t, RtpState>& suspended_ssrcs);
+                  const std::map<uint32_t, RtpState>& suspended_ssrcs,
+                  EncoderThreadPool* encoder_thread_pool,
+                  CpuBudgetCoordinator* cpu_budget_coordinator);
 
   ~VideoSendStream() override;
 
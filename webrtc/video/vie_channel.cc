@@ -950,6 +950,13 @@ int32_t ViEChannel::SetMTU(uint16_t mtu) {
   return 0;
 }
 
+size_t ViEChannel::PacketHistoryMemoryUsage() const {
+  size_t bytes = 0;
+  for (RtpRtcp* rtp_rtcp : rtp_rtcp_modules_)
+    bytes += rtp_rtcp->PacketHistoryMemoryUsage();
+  return bytes;
+}
+
 RtpRtcp* ViEChannel::rtp_rtcp() {
   return rtp_rtcp_modules_[0];
 }
@@ -213,6 +213,9 @@ class ViEChannel : public VCMFrameTypeCallback,
   // IP, UDP and RTP headers.
   int32_t SetMTU(uint16_t mtu);
 
+  // Returns the bytes allocated for storing sent packets in all modules.
+  size_t PacketHistoryMemoryUsage() const;
+
   // Gets the modules used by the channel.
   RtpRtcp* rtp_rtcp();
   rtc::scoped_refptr<PayloadRouter> send_payload_router();
@@ -48,6 +48,10 @@ static const float kStopPaddingThresholdMs = 2000;
 
 static const int kMinKeyFrameRequestIntervalMs = 300;
 
+// Frames in which nothing changed are still encoded this often, so that
+// receivers don't take the stream for stalled.
+static const int64_t kMaxUnchangedFrameIntervalMs = 1000;
+
 std::vector<uint32_t> AllocateStreamBitrates(
     uint32_t total_bitrate,
     const SimulcastStream* stream_configs,
@@ -135,7 +139,10 @@ ViEEncoder::ViEEncoder(uint32_t number_of_cores,
       picture_id_sli_(0),
       has_received_rpsi_(false),
       picture_id_rpsi_(0),
-      video_suspended_(false) {
+      video_suspended_(false),
+      last_base_layer_timestamp_(0),
+      last_encode_request_ms_(0),
+      encode_next_frame_(false) {
   bitrate_observer_.reset(new ViEBitrateObserver(this));
 }
 
@@ -220,6 +227,8 @@ int32_t ViEEncoder::SetEncoder(const webrtc::VideoCodec& video_codec) {
   {
     CriticalSectionScoped cs(data_cs_.get());
     encoder_config_ = video_codec;
+    // The new encoder has nothing to predict from.
+    pending_update_region_.SetUnknown();
   }
 
   // Add a bitrate observer to the allocator and update the start, max and
@@ -336,8 +345,32 @@ void ViEEncoder::TraceFrameDropEnd() {
   encoder_paused_and_dropped_frame_ = false;
 }
 
+bool ViEEncoder::WillDropFrame() {
+  RTC_DCHECK(send_payload_router_ != NULL);
+  if (!send_payload_router_->active())
+    return true;
+  {
+    CriticalSectionScoped cs(data_cs_.get());
+    // The frame is dropped before DeliverFrame(), but still counts as
+    // activity for padding.
+    time_of_last_frame_activity_ms_ = TickTime::MillisecondTimestamp();
+    if (EncoderPaused()) {
+      TraceFrameDropStart();
+      return true;
+    }
+  }
+  // The media optimization drops all frames while the video is suspended.
+  return vcm_->VideoSuspended();
+}
+
 void ViEEncoder::DeliverFrame(VideoFrame video_frame) {
   RTC_DCHECK(send_payload_router_ != NULL);
+  {
+    CriticalSectionScoped cs(data_cs_.get());
+    // Until a frame is encoded in the base layer, whatever changed in this one
+    // has to be encoded along with the next.
+    pending_update_region_.Add(video_frame.update_region());
+  }
   if (!send_payload_router_->active()) {
     // We've paused or we have no channels attached, don't waste resources on
     // encoding.
@@ -353,6 +386,16 @@ void ViEEncoder::DeliverFrame(VideoFrame video_frame) {
     }
     TraceFrameDropEnd();
     codec_type = encoder_config_.codecType;
+
+    if (pending_update_region_.IsEmpty() && !encode_next_frame_ &&
+        time_of_last_frame_activity_ms_ - last_encode_request_ms_ <
+            kMaxUnchangedFrameIntervalMs) {
+      // Nothing changed since the last frame in the base layer.
+      return;
+    }
+    encode_next_frame_ = false;
+    last_encode_request_ms_ = time_of_last_frame_activity_ms_;
+    *video_frame.mutable_update_region() = pending_update_region_;
   }
 
   TRACE_EVENT_ASYNC_STEP0("webrtc", "Video", video_frame.render_time_ms(),
@@ -396,12 +439,22 @@ void ViEEncoder::DeliverFrame(VideoFrame video_frame) {
 
     vcm_->AddVideoFrame(*frame_to_send, vp_->GetContentMetrics(),
                         &codec_specific_info);
-    return;
+  } else {
+    vcm_->AddVideoFrame(*frame_to_send);
   }
-  vcm_->AddVideoFrame(*frame_to_send);
+
+  // A frame that the encoder dropped, or that is still being encoded, leaves
+  // the pending region as is.
+  CriticalSectionScoped cs(data_cs_.get());
+  if (last_base_layer_timestamp_ == frame_to_send->timestamp())
+    pending_update_region_.SetEmpty();
 }
 
 int ViEEncoder::SendKeyFrame() {
+  {
+    CriticalSectionScoped cs(data_cs_.get());
+    encode_next_frame_ = true;
+  }
   return vcm_->IntraFrameRequest(0);
 }
 
@@ -456,9 +509,16 @@ int32_t ViEEncoder::SendData(
     const RTPVideoHeader* rtp_video_hdr) {
   RTC_DCHECK(send_payload_router_ != NULL);
 
+  uint8_t temporal_idx = kNoTemporalIdx;
+  if (rtp_video_hdr && rtp_video_hdr->codec == kRtpVideoVp8)
+    temporal_idx = rtp_video_hdr->codecHeader.VP8.temporalIdx;
+  else if (rtp_video_hdr && rtp_video_hdr->codec == kRtpVideoVp9)
+    temporal_idx = rtp_video_hdr->codecHeader.VP9.temporal_idx;
   {
     CriticalSectionScoped cs(data_cs_.get());
     time_of_last_frame_activity_ms_ = TickTime::MillisecondTimestamp();
+    if (temporal_idx == kNoTemporalIdx || temporal_idx == 0)
+      last_base_layer_timestamp_ = encoded_image._timeStamp;
   }
 
   if (stats_proxy_ != NULL)
@@ -490,6 +550,7 @@ void ViEEncoder::OnReceivedSLI(uint32_t /*ssrc*/,
   CriticalSectionScoped cs(data_cs_.get());
   picture_id_sli_ = picture_id;
   has_received_sli_ = true;
+  encode_next_frame_ = true;
 }
 
 void ViEEncoder::OnReceivedRPSI(uint32_t /*ssrc*/,
@@ -497,6 +558,7 @@ void ViEEncoder::OnReceivedRPSI(uint32_t /*ssrc*/,
   CriticalSectionScoped cs(data_cs_.get());
   picture_id_rpsi_ = picture_id;
   has_received_rpsi_ = true;
+  encode_next_frame_ = true;
 }
 
 void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
@@ -525,6 +587,7 @@ void ViEEncoder::OnReceivedIntraFrameRequest(uint32_t ssrc) {
     }
     time_last_intra_request_ms_[ssrc] = now;
     idx = stream_it->second;
+    encode_next_frame_ = true;
   }
   // Release the critsect before triggering key frame.
   vcm_->IntraFrameRequest(idx);
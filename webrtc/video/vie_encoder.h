@@ -90,6 +90,7 @@ class ViEEncoder : public RtcpIntraFrameObserver,
 
   // Implementing VideoCaptureCallback.
   void DeliverFrame(VideoFrame video_frame) override;
+  bool WillDropFrame() override;
 
   int32_t SendKeyFrame();
 
@@ -189,6 +190,17 @@ class ViEEncoder : public RtcpIntraFrameObserver,
   std::map<uint32_t, int> ssrc_streams_ GUARDED_BY(data_cs_);
 
   bool video_suspended_ GUARDED_BY(data_cs_);
+
+  // What changed in the frames delivered since the last frame that was
+  // encoded in the base layer, which is what the encoder predicts the
+  // unchanged parts of the next frame from.
+  VideoFrameUpdateRegion pending_update_region_ GUARDED_BY(data_cs_);
+  uint32_t last_base_layer_timestamp_ GUARDED_BY(data_cs_);
+  // When the last frame was passed on to be encoded.
+  int64_t last_encode_request_ms_ GUARDED_BY(data_cs_);
+  // Set when a key frame or reference refresh is requested, so that the next
+  // frame is encoded even if nothing in it changed.
+  bool encode_next_frame_ GUARDED_BY(data_cs_);
 };
 
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_VIDEO_FRAME_H_
 #define WEBRTC_VIDEO_FRAME_H_
 
+#include <vector>
+
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_types.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
@@ -19,6 +21,47 @@
 
 namespace webrtc {
 
+// The parts of a video frame that changed since the previous frame from the
+// same source, for sources that know, such as screen capturers. The
+// rectangles may overlap. A region that isn't known covers the whole frame.
+class VideoFrameUpdateRegion {
+ public:
+  struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+  // Regions with more rectangles than this are replaced by their bounding box.
+  static const size_t kMaxRects = 16;
+
+  // Creates an unknown region.
+  VideoFrameUpdateRegion();
+
+  bool known() const { return known_; }
+  // Returns true if the region is known to be empty, i.e. nothing changed.
+  bool IsEmpty() const { return known_ && rects_.empty(); }
+  const std::vector<Rect>& rects() const { return rects_; }
+
+  void SetUnknown();
+  // Makes the region known and empty.
+  void SetEmpty();
+  // Adds a rectangle to a known region. Has no effect on an unknown region.
+  void AddRect(int x, int y, int width, int height);
+  // Adds |region|. The result is unknown if either region is.
+  void Add(const VideoFrameUpdateRegion& region);
+
+  // Fills |map|, which has one entry per |block_size| x |block_size| block of
+  // a |width| x |height| frame in row-major order, with 1 for the blocks that
+  // intersect the region and 0 for the others.
+  void FillBlockMap(int width, int height, int block_size, uint8_t* map) const;
+
+ private:
+  bool known_;
+  std::vector<Rect> rects_;
+};
+
 class VideoFrame {
  public:
   VideoFrame();
@@ -139,6 +182,13 @@ class VideoFrame {
   // Get render time in miliseconds.
   int64_t render_time_ms() const { return render_time_ms_; }
 
+  // The parts of the frame that changed since the previous frame from the
+  // same source. Unknown unless the source sets it.
+  const VideoFrameUpdateRegion& update_region() const {
+    return update_region_;
+  }
+  VideoFrameUpdateRegion* mutable_update_region() { return &update_region_; }
+
   // Return true if underlying plane buffers are of zero size, false if not.
   bool IsZeroSize() const;
 
@@ -167,6 +217,7 @@ class VideoFrame {
   int64_t ntp_time_ms_;
   int64_t render_time_ms_;
   VideoRotation rotation_;
+  VideoFrameUpdateRegion update_region_;
 };
 
 
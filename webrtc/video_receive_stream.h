@@ -60,6 +60,10 @@ class VideoReceiveStream : public ReceiveStream {
     int jitter_buffer_ms = 0;
     int min_playout_delay_ms = 0;
     int render_delay_ms = 10;
+    // 95th percentiles since the stream was created, or -1 before the first
+    // decoder timing update.
+    int decode_ms_p95 = -1;
+    int jitter_buffer_ms_p95 = -1;
 
     int current_payload_type = -1;
 
@@ -41,6 +41,12 @@ class VideoCaptureInput {
   // externally to make sure that any old frames are not delivered concurrently.
   virtual void IncomingCapturedFrame(const VideoFrame& video_frame) = 0;
 
+  // Returns true if a frame captured now would be dropped without being
+  // encoded, e.g. because the network is down or the pacer queue is too long.
+  // Sources can call this for each captured frame, to skip converting and
+  // scaling frames that would be dropped anyway.
+  virtual bool WillDropFrame() { return false; }
+
  protected:
   virtual ~VideoCaptureInput() {}
 };
@@ -66,11 +72,16 @@ class VideoSendStream : public SendStream {
     int input_frame_rate = 0;
     int encode_frame_rate = 0;
     int avg_encode_time_ms = 0;
+    // 95th percentile of the encode time since the stream was created, or -1
+    // before the first frame is encoded.
+    int encode_time_p95_ms = -1;
     int encode_usage_percent = 0;
     int target_media_bitrate_bps = 0;
     int media_bitrate_bps = 0;
     bool suspended = false;
     bool bw_limited_resolution = false;
+    // Bytes allocated for storing sent packets, for all substreams.
+    size_t packet_history_bytes = 0;
     std::map<uint32_t, StreamStats> substreams;
   };
 
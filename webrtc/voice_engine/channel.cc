@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <utility>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/logging.h"
@@ -487,6 +488,11 @@ Channel::OnReceivedPayloadData(const uint8_t* payloadData,
         return -1;
     }
 
+    rtc::AtomicOps::ReleaseStore(
+        &received_audio_level_,
+        rtpHeader->header.extension.hasAudioLevel ?
+            rtpHeader->header.extension.audioLevel : -1);
+
     // Update the packet delay.
     UpdatePacketDelay(rtpHeader->header.timestamp,
                       rtpHeader->header.sequenceNumber);
@@ -641,7 +647,8 @@ int32_t Channel::GetAudioFrame(int32_t id, AudioFrame* audioFrame)
         }
     }
 
-    // Measure audio level (0-9)
+    // Measure audio level (0-9). The level stays on the frame for the mixer.
+    AudioFrameOperations::UpdateLevel(audioFrame);
     _outputAudioLevel.ComputeLevel(*audioFrame);
 
     if (capture_start_rtp_time_stamp_ < 0 && audioFrame->timestamp_ != 0) {
@@ -717,6 +724,20 @@ Channel::NeededFrequency(int32_t id) const
     return(highestNeeded);
 }
 
+bool Channel::GetAudioLevel(int32_t id, uint8_t* level) const
+{
+    // The level of the latest received packet is used as an estimate of the
+    // level of the audio about to be played out.
+    const int received_level = rtc::AtomicOps::AcquireLoad(
+        &received_audio_level_);
+    if (received_level < 0)
+    {
+        return false;
+    }
+    *level = static_cast<uint8_t>(received_level);
+    return true;
+}
+
 int32_t Channel::CreateChannel(Channel*& channel,
                                int32_t channelId,
                                uint32_t instanceId,
@@ -847,6 +868,7 @@ Channel::Channel(int32_t channelId,
       playout_timestamp_rtcp_(0),
       playout_delay_ms_(0),
       _numberOfDiscardedPackets(0),
+      received_audio_level_(-1),
       send_sequence_number_(0),
       ts_stats_lock_(CriticalSectionWrapper::CreateCriticalSection()),
       rtp_ts_wraparound_handler_(new rtc::TimestampWrapAroundHandler()),
@@ -875,10 +897,10 @@ Channel::Channel(int32_t channelId,
       _lastPayloadType(0),
       _includeAudioLevelIndication(false),
       _outputSpeechType(AudioFrame::kNormalSpeech),
-      video_sync_lock_(CriticalSectionWrapper::CreateCriticalSection()),
       _average_jitter_buffer_delay_us(0),
       _previousTimestamp(0),
       _recPacketDelayMs(20),
+      jitter_buffer_delay_ms_(-1),
       _RxVadDetection(false),
       _rxAgcIsEnabled(false),
       _rxNsIsEnabled(false),
@@ -1708,23 +1730,49 @@ int32_t Channel::ReceivedRTPPacket(const int8_t* data, size_t length,
   // Store playout timestamp for the received RTP packet
   UpdatePlayoutTimestamp(false);
 
-  const uint8_t* received_packet = reinterpret_cast<const uint8_t*>(data);
+  return ParseAndReceivePacket(reinterpret_cast<const uint8_t*>(data),
+                               length) ? 0 : -1;
+}
+
+int Channel::ReceivedRTPPackets(
+    const VoENetwork::ReceivedPacket* const* packets,
+    size_t num_packets) {
+  WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId,_channelId),
+               "Channel::ReceivedRTPPackets(num_packets=%" PRIuS ")",
+               num_packets);
+
+  // All packets arrived at the same time, so they share one playout
+  // timestamp.
+  UpdatePlayoutTimestamp(false);
+
+  int accepted = 0;
+  for (size_t i = 0; i < num_packets; ++i) {
+    if (ParseAndReceivePacket(static_cast<const uint8_t*>(packets[i]->data),
+                              packets[i]->length)) {
+      ++accepted;
+    }
+  }
+  return accepted;
+}
+
+bool Channel::ParseAndReceivePacket(const uint8_t* packet,
+                                    size_t packet_length) {
   RTPHeader header;
-  if (!rtp_header_parser_->Parse(received_packet, length, &header)) {
+  if (!rtp_header_parser_->Parse(packet, packet_length, &header)) {
     WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVoice, _channelId,
                  "Incoming packet: invalid RTP header");
-    return -1;
+    return false;
   }
   header.payload_type_frequency =
       rtp_payload_registry_->GetPayloadTypeFrequency(header.payloadType);
   if (header.payload_type_frequency < 0)
-    return -1;
+    return false;
   bool in_order = IsPacketInOrder(header);
-  rtp_receive_statistics_->IncomingPacket(header, length,
+  rtp_receive_statistics_->IncomingPacket(header, packet_length,
       IsPacketRetransmitted(header, in_order));
   rtp_payload_registry_->SetIncomingPayloadType(header);
 
-  return ReceivePacket(received_packet, length, header, in_order) ? 0 : -1;
+  return ReceivePacket(packet, packet_length, header, in_order);
 }
 
 bool Channel::ReceivePacket(const uint8_t* packet,
@@ -3383,6 +3431,7 @@ Channel::PrepareEncodeAndSend(int mixingFrequency)
     if (channel_state_.Get().input_file_playing)
     {
         MixOrReplaceAudioWithFile(mixingFrequency);
+        _audioFrame.sum_squares_ = -1;
     }
 
     bool is_muted = Mute();  // Cache locally as Mute() takes a lock.
@@ -3403,6 +3452,7 @@ Channel::PrepareEncodeAndSend(int mixingFrequency)
                 _audioFrame.samples_per_channel_,
                 _audioFrame.sample_rate_hz_,
                 isStereo);
+            _audioFrame.sum_squares_ = -1;
         }
     }
 
@@ -3413,6 +3463,10 @@ Channel::PrepareEncodeAndSend(int mixingFrequency)
           _audioFrame.samples_per_channel_ * _audioFrame.num_channels_;
       if (is_muted) {
         rms_level_.ProcessMuted(length);
+      } else if (_audioFrame.sum_squares_ >= 0) {
+        // The TransmitMixer measured the level, and nothing has changed the
+        // audio since.
+        rms_level_.ProcessSumSquares(_audioFrame.sum_squares_, length);
       } else {
         rms_level_.Process(_audioFrame.data_, length);
       }
@@ -3571,13 +3625,13 @@ void Channel::GetDecodingCallStatistics(AudioDecodingCallStats* stats) const {
 
 bool Channel::GetDelayEstimate(int* jitter_buffer_delay_ms,
                                int* playout_buffer_delay_ms) const {
-  CriticalSectionScoped cs(video_sync_lock_.get());
-  if (_average_jitter_buffer_delay_us == 0) {
+  const int jitter_buffer_delay =
+      rtc::AtomicOps::AcquireLoad(&jitter_buffer_delay_ms_);
+  if (jitter_buffer_delay < 0) {
     return false;
   }
-  *jitter_buffer_delay_ms = (_average_jitter_buffer_delay_us + 500) / 1000 +
-      _recPacketDelayMs;
-  *playout_buffer_delay_ms = playout_delay_ms_;
+  *jitter_buffer_delay_ms = jitter_buffer_delay;
+  *playout_buffer_delay_ms = rtc::AtomicOps::AcquireLoad(&playout_delay_ms_);
   return true;
 }
 
@@ -3616,11 +3670,8 @@ Channel::SetMinimumPlayoutDelay(int delayMs)
 }
 
 int Channel::GetPlayoutTimestamp(unsigned int& timestamp) {
-  uint32_t playout_timestamp_rtp = 0;
-  {
-    CriticalSectionScoped cs(video_sync_lock_.get());
-    playout_timestamp_rtp = playout_timestamp_rtp_;
-  }
+  const uint32_t playout_timestamp_rtp = static_cast<uint32_t>(
+      rtc::AtomicOps::AcquireLoad(&playout_timestamp_rtp_));
   if (playout_timestamp_rtp == 0)  {
     _engineStatisticsPtr->SetLastError(
         VE_CANNOT_RETRIEVE_VALUE, kTraceError,
@@ -3851,6 +3902,7 @@ Channel::InsertInbandDtmfTone()
                 _audioFrame.data_[index] = toneBuffer[sample];
             }
         }
+        _audioFrame.sum_squares_ = -1;
 
         assert(_audioFrame.samples_per_channel_ == toneSamples);
     } else
@@ -3890,15 +3942,13 @@ void Channel::UpdatePlayoutTimestamp(bool rtcp) {
                "Channel::UpdatePlayoutTimestamp() => playoutTimestamp = %lu",
                playout_timestamp);
 
-  {
-    CriticalSectionScoped cs(video_sync_lock_.get());
-    if (rtcp) {
-      playout_timestamp_rtcp_ = playout_timestamp;
-    } else {
-      playout_timestamp_rtp_ = playout_timestamp;
-    }
-    playout_delay_ms_ = delay_ms;
+  if (rtcp) {
+    playout_timestamp_rtcp_ = playout_timestamp;
+  } else {
+    rtc::AtomicOps::ReleaseStore(&playout_timestamp_rtp_,
+                                 static_cast<int>(playout_timestamp));
   }
+  rtc::AtomicOps::ReleaseStore(&playout_delay_ms_, delay_ms);
 }
 
 // Called for incoming RTP packets after successful RTP header parsing.
@@ -3931,25 +3981,24 @@ void Channel::UpdatePacketDelay(uint32_t rtp_timestamp,
 
   if (timestamp_diff_ms == 0) return;
 
-  {
-    CriticalSectionScoped cs(video_sync_lock_.get());
-
-    if (packet_delay_ms >= 10 && packet_delay_ms <= 60) {
-      _recPacketDelayMs = packet_delay_ms;
-    }
-
-    if (_average_jitter_buffer_delay_us == 0) {
-      _average_jitter_buffer_delay_us = timestamp_diff_ms * 1000;
-      return;
-    }
+  if (packet_delay_ms >= 10 && packet_delay_ms <= 60) {
+    _recPacketDelayMs = packet_delay_ms;
+  }
 
+  if (_average_jitter_buffer_delay_us == 0) {
+    _average_jitter_buffer_delay_us = timestamp_diff_ms * 1000;
+  } else {
     // Filter average delay value using exponential filter (alpha is
     // 7/8). We derive 1000 *_average_jitter_buffer_delay_us here (reduces
-    // risk of rounding error) and compensate for it in GetDelayEstimate()
-    // later.
+    // risk of rounding error) and compensate for it when publishing the
+    // delay below.
     _average_jitter_buffer_delay_us = (_average_jitter_buffer_delay_us * 7 +
         1000 * timestamp_diff_ms + 500) / 8;
   }
+  rtc::AtomicOps::ReleaseStore(
+      &jitter_buffer_delay_ms_,
+      static_cast<int>((_average_jitter_buffer_delay_us + 500) / 1000 +
+                       _recPacketDelayMs));
 }
 
 void
@@ -226,6 +226,11 @@ public:
     int32_t DeRegisterExternalTransport();
     int32_t ReceivedRTPPacket(const int8_t* data, size_t length,
                               const PacketTime& packet_time);
+    // Processes the packets of one network wakeup, all for this channel.
+    // The playout timestamp is updated once for the batch rather than for
+    // every packet. Returns the number of packets accepted.
+    int ReceivedRTPPackets(const VoENetwork::ReceivedPacket* const* packets,
+                           size_t num_packets);
     int32_t ReceivedRTCPPacket(const int8_t* data, size_t length);
 
     // VoEFile
@@ -400,6 +405,7 @@ public:
     // From MixerParticipant
     int32_t GetAudioFrame(int32_t id, AudioFrame* audioFrame) override;
     int32_t NeededFrequency(int32_t id) const override;
+    bool GetAudioLevel(int32_t id, uint8_t* level) const override;
 
     // From FileCallback
     void PlayNotification(int32_t id, uint32_t durationMs) override;
@@ -470,6 +476,9 @@ protected:
     void OnIncomingFractionLoss(int fraction_lost);
 
 private:
+    // Parses |packet| and passes it on; the playout timestamp must already
+    // have been updated.
+    bool ParseAndReceivePacket(const uint8_t* packet, size_t packet_length);
     bool ReceivePacket(const uint8_t* packet, size_t packet_length,
                        const RTPHeader& header, bool in_order);
     bool HandleRtxPacket(const uint8_t* packet,
@@ -536,10 +545,15 @@ private:
 
     // Timestamp of the audio pulled from NetEq.
     uint32_t jitter_buffer_playout_timestamp_;
-    uint32_t playout_timestamp_rtp_ GUARDED_BY(video_sync_lock_);
+    // Published by the playout thread for the video sync, which reads them
+    // with rtc::AtomicOps rather than contending with audio for a lock.
+    volatile int playout_timestamp_rtp_;
     uint32_t playout_timestamp_rtcp_;
-    uint32_t playout_delay_ms_ GUARDED_BY(video_sync_lock_);
+    volatile int playout_delay_ms_;
     uint32_t _numberOfDiscardedPackets;
+    // Audio level header extension value of the latest received packet, or -1
+    // if it had none. Accessed with rtc::AtomicOps.
+    volatile int received_audio_level_;
     uint16_t send_sequence_number_;
     uint8_t restored_packet_[kVoiceEngineMaxIpPacketSizeBytes];
 
@@ -584,10 +598,13 @@ private:
     // VoENetwork
     AudioFrame::SpeechType _outputSpeechType;
     // VoEVideoSync
-    rtc::scoped_ptr<CriticalSectionWrapper> video_sync_lock_;
-    uint32_t _average_jitter_buffer_delay_us GUARDED_BY(video_sync_lock_);
+    uint32_t _average_jitter_buffer_delay_us;
     uint32_t _previousTimestamp;
-    uint16_t _recPacketDelayMs GUARDED_BY(video_sync_lock_);
+    uint16_t _recPacketDelayMs;
+    // The jitter buffer delay estimated on the packet receive path from the
+    // two above, or -1 before the first estimate. Accessed with
+    // rtc::AtomicOps.
+    volatile int jitter_buffer_delay_ms_;
     // VoEAudioProcessing
     bool _RxVadDetection;
     bool _rxAgcIsEnabled;
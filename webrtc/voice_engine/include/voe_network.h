@@ -44,6 +44,14 @@ class VoiceEngine;
 // VoENetwork
 class WEBRTC_DLLEXPORT VoENetwork {
  public:
+  // An RTP packet passed to ReceivedRTPPackets().
+  struct ReceivedPacket {
+    int channel;
+    const void* data;
+    size_t length;
+    PacketTime packet_time;
+  };
+
   // Factory for the VoENetwork sub-API. Increases an internal
   // reference counter if successful. Returns NULL if the API is not
   // supported or if construction fails.
@@ -77,6 +85,23 @@ class WEBRTC_DLLEXPORT VoENetwork {
     return 0;
   }
 
+  // Delivers the RTP packets read in one network wakeup, for any number of
+  // channels. The packets are grouped by channel so that each channel is
+  // looked up and prepared once per call instead of once per packet. The
+  // packets of one channel are processed in the order given, on the calling
+  // thread. Returns the number of packets that were accepted.
+  virtual int ReceivedRTPPackets(const ReceivedPacket* packets,
+                                 size_t num_packets) {
+    int accepted = 0;
+    for (size_t i = 0; i < num_packets; ++i) {
+      if (ReceivedRTPPacket(packets[i].channel, packets[i].data,
+                            packets[i].length, packets[i].packet_time) == 0) {
+        ++accepted;
+      }
+    }
+    return accepted;
+  }
+
   // The packets received from the network should be passed to this
   // function when external transport is enabled. Note that the data
   // including the RTCP-header must also be given to the VoiceEngine.
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
@@ -50,9 +52,16 @@ void AudioLevel::ComputeLevel(const AudioFrame& audioFrame)
     int16_t absValue(0);
 
     // Check speech level (works for 2 channels as well)
-    absValue = WebRtcSpl_MaxAbsValueW16(
-        audioFrame.data_,
-        audioFrame.samples_per_channel_*audioFrame.num_channels_);
+    if (audioFrame.sum_squares_ >= 0)
+    {
+        // Reuse the level measured by AudioFrameOperations::UpdateLevel().
+        absValue = static_cast<int16_t>(std::min(audioFrame.max_abs_, 32767));
+    } else
+    {
+        absValue = WebRtcSpl_MaxAbsValueW16(
+            audioFrame.data_,
+            audioFrame.samples_per_channel_*audioFrame.num_channels_);
+    }
 
     // Protect member access using a lock since this method is called on a
     // dedicated audio thread in the RecordedDataIsAvailable() callback.
@@ -10,6 +10,7 @@
 
 #include "webrtc/voice_engine/output_mixer.h"
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
@@ -68,8 +69,9 @@ void OutputMixer::RecordFileEnded(int32_t id)
                  "OutputMixer::RecordFileEnded(id=%d)", id);
     assert(id == _instanceId);
 
-    CriticalSectionScoped cs(&_fileCritSect);
-    _outputFileRecording = false;
+    // No lock here; this can be called from RecordAudioToFile() on the audio
+    // thread while StopRecordingPlayout() holds _fileCritSect.
+    rtc::AtomicOps::ReleaseStore(&_outputFileRecording, 0);
     WEBRTC_TRACE(kTraceStateInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::RecordFileEnded() =>"
                  "output file recorder module is shutdown");
@@ -98,13 +100,11 @@ OutputMixer::OutputMixer(uint32_t instanceId) :
     _audioLevel(),
     _dtmfGenerator(instanceId),
     _instanceId(instanceId),
-    _externalMediaCallbackPtr(NULL),
-    _externalMedia(false),
-    _panLeft(1.0f),
-    _panRight(1.0f),
+    _panGains(new PanGains(1.0f, 1.0f)),
     _mixingFrequencyHz(8000),
+    _playoutFrequencyHz(0),
     _outputFileRecorderPtr(NULL),
-    _outputFileRecording(false)
+    _outputFileRecording(0)
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::OutputMixer() - ctor");
@@ -133,14 +133,11 @@ OutputMixer::~OutputMixer()
 {
     WEBRTC_TRACE(kTraceMemory, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::~OutputMixer() - dtor");
-    if (_externalMedia)
-    {
-        DeRegisterExternalMediaProcessing();
-    }
     {
         CriticalSectionScoped cs(&_fileCritSect);
         if (_outputFileRecorderPtr)
         {
+            _outputFileRecorder.Set(NULL);
             _outputFileRecorderPtr->RegisterModuleFileCallback(NULL);
             _outputFileRecorderPtr->StopRecording();
             FileRecorder::DestroyFileRecorder(_outputFileRecorderPtr);
@@ -149,6 +146,7 @@ OutputMixer::~OutputMixer()
     }
     _mixerModule.UnRegisterMixedStreamCallback();
     delete &_mixerModule;
+    delete _panGains.Set(NULL);
     delete &_callbackCritSect;
     delete &_fileCritSect;
 }
@@ -179,8 +177,7 @@ int OutputMixer::RegisterExternalMediaProcessing(
                "OutputMixer::RegisterExternalMediaProcessing()");
 
     CriticalSectionScoped cs(&_callbackCritSect);
-    _externalMediaCallbackPtr = &proccess_object;
-    _externalMedia = true;
+    _externalMediaCallback.Set(&proccess_object);
 
     return 0;
 }
@@ -191,8 +188,8 @@ int OutputMixer::DeRegisterExternalMediaProcessing()
                  "OutputMixer::DeRegisterExternalMediaProcessing()");
 
     CriticalSectionScoped cs(&_callbackCritSect);
-    _externalMedia = false;
-    _externalMediaCallbackPtr = NULL;
+    // Returns once the audio thread no longer uses the callback.
+    _externalMediaCallback.Set(NULL);
 
     return 0;
 }
@@ -227,8 +224,29 @@ OutputMixer::SetAnonymousMixabilityStatus(MixerParticipant& participant,
 }
 
 int32_t
-OutputMixer::MixActiveChannels()
+OutputMixer::MixActiveChannels(int sample_rate_hz)
 {
+    if (sample_rate_hz != _playoutFrequencyHz)
+    {
+        // Only the mixer's own rates can be preferred. At other device rates,
+        // e.g. 44.1 kHz, the mix is resampled in GetMixedAudio() as before.
+        AudioConferenceMixer::Frequency preferred =
+            AudioConferenceMixer::kLowestPossible;
+        switch (sample_rate_hz)
+        {
+            case AudioConferenceMixer::kNbInHz:
+            case AudioConferenceMixer::kWbInHz:
+            case AudioConferenceMixer::kSwbInHz:
+            case AudioConferenceMixer::kFbInHz:
+                preferred = static_cast<AudioConferenceMixer::Frequency>(
+                    sample_rate_hz);
+                break;
+            default:
+                break;
+        }
+        _mixerModule.SetPreferredMixingFrequency(preferred);
+        _playoutFrequencyHz = sample_rate_hz;
+    }
     return _mixerModule.Process();
 }
 
@@ -257,16 +275,18 @@ OutputMixer::SetOutputVolumePan(float left, float right)
 {
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::SetOutputVolumePan()");
-    _panLeft = left;
-    _panRight = right;
+    delete _panGains.Set(new PanGains(left, right));
     return 0;
 }
 
 int
 OutputMixer::GetOutputVolumePan(float& left, float& right)
 {
-    left = _panLeft;
-    right = _panRight;
+    {
+        LockFreePointer<PanGains>::ScopedAccess panGains(&_panGains);
+        left = panGains->left;
+        right = panGains->right;
+    }
     WEBRTC_TRACE(kTraceStateInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "GetOutputVolumePan() => left=%2.1f, right=%2.1f",
                  left, right);
@@ -279,7 +299,7 @@ int OutputMixer::StartRecordingPlayout(const char* fileName,
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::StartRecordingPlayout(fileName=%s)", fileName);
 
-    if (_outputFileRecording)
+    if (rtc::AtomicOps::AcquireLoad(&_outputFileRecording))
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId,-1),
                      "StartRecordingPlayout() is already recording");
@@ -319,6 +339,7 @@ int OutputMixer::StartRecordingPlayout(const char* fileName,
     // Destroy the old instance
     if (_outputFileRecorderPtr)
     {
+        _outputFileRecorder.Set(NULL);
         _outputFileRecorderPtr->RegisterModuleFileCallback(NULL);
         FileRecorder::DestroyFileRecorder(_outputFileRecorderPtr);
         _outputFileRecorderPtr = NULL;
@@ -349,7 +370,8 @@ int OutputMixer::StartRecordingPlayout(const char* fileName,
         return -1;
     }
     _outputFileRecorderPtr->RegisterModuleFileCallback(this);
-    _outputFileRecording = true;
+    rtc::AtomicOps::ReleaseStore(&_outputFileRecording, 1);
+    _outputFileRecorder.Set(_outputFileRecorderPtr);
 
     return 0;
 }
@@ -360,7 +382,7 @@ int OutputMixer::StartRecordingPlayout(OutStream* stream,
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::StartRecordingPlayout()");
 
-    if (_outputFileRecording)
+    if (rtc::AtomicOps::AcquireLoad(&_outputFileRecording))
     {
         WEBRTC_TRACE(kTraceWarning, kTraceVoice, VoEId(_instanceId,-1),
                      "StartRecordingPlayout() is already recording");
@@ -399,6 +421,7 @@ int OutputMixer::StartRecordingPlayout(OutStream* stream,
     // Destroy the old instance
     if (_outputFileRecorderPtr)
     {
+        _outputFileRecorder.Set(NULL);
         _outputFileRecorderPtr->RegisterModuleFileCallback(NULL);
         FileRecorder::DestroyFileRecorder(_outputFileRecorderPtr);
         _outputFileRecorderPtr = NULL;
@@ -428,7 +451,8 @@ int OutputMixer::StartRecordingPlayout(OutStream* stream,
     }
 
     _outputFileRecorderPtr->RegisterModuleFileCallback(this);
-    _outputFileRecording = true;
+    rtc::AtomicOps::ReleaseStore(&_outputFileRecording, 1);
+    _outputFileRecorder.Set(_outputFileRecorderPtr);
 
     return 0;
 }
@@ -438,7 +462,7 @@ int OutputMixer::StopRecordingPlayout()
     WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId,-1),
                  "OutputMixer::StopRecordingPlayout()");
 
-    if (!_outputFileRecording)
+    if (!rtc::AtomicOps::AcquireLoad(&_outputFileRecording))
     {
         WEBRTC_TRACE(kTraceError, kTraceVoice, VoEId(_instanceId,-1),
                      "StopRecordingPlayout() file isnot recording");
@@ -447,17 +471,19 @@ int OutputMixer::StopRecordingPlayout()
 
     CriticalSectionScoped cs(&_fileCritSect);
 
+    _outputFileRecorder.Set(NULL);
     if (_outputFileRecorderPtr->StopRecording() != 0)
     {
         _engineStatisticsPtr->SetLastError(
             VE_STOP_RECORDING_FAILED, kTraceError,
             "StopRecording(), could not stop recording");
+        _outputFileRecorder.Set(_outputFileRecorderPtr);
         return -1;
     }
     _outputFileRecorderPtr->RegisterModuleFileCallback(NULL);
     FileRecorder::DestroyFileRecorder(_outputFileRecorderPtr);
     _outputFileRecorderPtr = NULL;
-    _outputFileRecording = false;
+    rtc::AtomicOps::ReleaseStore(&_outputFileRecording, 0);
 
     return 0;
 }
@@ -472,9 +498,9 @@ int OutputMixer::GetMixedAudio(int sample_rate_hz,
 
   // --- Record playout if enabled
   {
-    CriticalSectionScoped cs(&_fileCritSect);
-    if (_outputFileRecording && _outputFileRecorderPtr)
-      _outputFileRecorderPtr->RecordAudioToFile(_audioFrame);
+    LockFreePointer<FileRecorder>::ScopedAccess recorder(&_outputFileRecorder);
+    if (recorder.get() && rtc::AtomicOps::AcquireLoad(&_outputFileRecording))
+      recorder->RecordAudioToFile(_audioFrame);
   }
 
   frame->num_channels_ = num_channels;
@@ -503,7 +529,14 @@ OutputMixer::DoOperationsOnCombinedSignal(bool feed_data_to_apm)
     }
 
     // Scale left and/or right channel(s) if balance is active
-    if (_panLeft != 1.0 || _panRight != 1.0)
+    float panLeft;
+    float panRight;
+    {
+        LockFreePointer<PanGains>::ScopedAccess panGains(&_panGains);
+        panLeft = panGains->left;
+        panRight = panGains->right;
+    }
+    if (panLeft != 1.0 || panRight != 1.0)
     {
         if (_audioFrame.num_channels_ == 1)
         {
@@ -515,7 +548,7 @@ OutputMixer::DoOperationsOnCombinedSignal(bool feed_data_to_apm)
         }
 
         assert(_audioFrame.num_channels_ == 2);
-        AudioFrameOperations::Scale(_panLeft, _panRight, _audioFrame);
+        AudioFrameOperations::Scale(panLeft, panRight, _audioFrame);
     }
 
     // --- Far-end Voice Quality Enhancement (AudioProcessing Module)
@@ -536,24 +569,23 @@ OutputMixer::DoOperationsOnCombinedSignal(bool feed_data_to_apm)
 
     // --- External media processing
     {
-        CriticalSectionScoped cs(&_callbackCritSect);
-        if (_externalMedia)
+        LockFreePointer<VoEMediaProcess>::ScopedAccess externalMedia(
+            &_externalMediaCallback);
+        if (externalMedia.get())
         {
             const bool is_stereo = (_audioFrame.num_channels_ == 2);
-            if (_externalMediaCallbackPtr)
-            {
-                _externalMediaCallbackPtr->Process(
-                    -1,
-                    kPlaybackAllChannelsMixed,
-                    (int16_t*)_audioFrame.data_,
-                    _audioFrame.samples_per_channel_,
-                    _audioFrame.sample_rate_hz_,
-                    is_stereo);
-            }
+            externalMedia->Process(
+                -1,
+                kPlaybackAllChannelsMixed,
+                (int16_t*)_audioFrame.data_,
+                _audioFrame.samples_per_channel_,
+                _audioFrame.sample_rate_hz_,
+                is_stereo);
         }
     }
 
     // --- Measure audio level (0-9) for the combined signal
+    AudioFrameOperations::UpdateLevel(&_audioFrame);
     _audioLevel.ComputeLevel(_audioFrame);
 
     return 0;
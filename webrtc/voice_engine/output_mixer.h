@@ -16,6 +16,7 @@
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
 #include "webrtc/modules/utility/include/file_recorder.h"
+#include "webrtc/system_wrappers/include/lock_free_pointer.h"
 #include "webrtc/voice_engine/dtmf_inband.h"
 #include "webrtc/voice_engine/level_indicator.h"
 #include "webrtc/voice_engine/voice_engine_defines.h"
@@ -53,7 +54,10 @@ public:
     // VoEDtmf
     int PlayDtmfTone(uint8_t eventCode, int lengthMs, int attenuationDb);
 
-    int32_t MixActiveChannels();
+    // Mixes the active channels. |sample_rate_hz| is the rate GetMixedAudio()
+    // will be asked for; the channels are mixed at this rate when that avoids
+    // resampling them twice.
+    int32_t MixActiveChannels(int sample_rate_hz);
 
     int32_t DoOperationsOnCombinedSignal(bool feed_data_to_apm);
 
@@ -101,6 +105,12 @@ public:
     void RecordFileEnded(int32_t id);
 
 private:
+    struct PanGains {
+        PanGains(float left, float right) : left(left), right(right) {}
+        const float left;
+        const float right;
+    };
+
     OutputMixer(uint32_t instanceId);
     int InsertInbandDtmfTone();
 
@@ -109,8 +119,9 @@ private:
     AudioProcessing* _audioProcessingModulePtr;
 
     // owns
+    // serializes external media (de)registration
     CriticalSectionWrapper& _callbackCritSect;
-    // protect the _outputFileRecorderPtr and _outputFileRecording
+    // protect the _outputFileRecorderPtr
     CriticalSectionWrapper& _fileCritSect;
     AudioConferenceMixer& _mixerModule;
     AudioFrame _audioFrame;
@@ -121,13 +132,17 @@ private:
     AudioLevel _audioLevel;    // measures audio level for the combined signal
     DtmfInband _dtmfGenerator;
     int _instanceId;
-    VoEMediaProcess* _externalMediaCallbackPtr;
-    bool _externalMedia;
-    float _panLeft;
-    float _panRight;
+    // The audio thread reads the external media callback, the pan gains and
+    // the file recorder through these without locking.
+    LockFreePointer<VoEMediaProcess> _externalMediaCallback;
+    LockFreePointer<PanGains> _panGains;
     int _mixingFrequencyHz;
+    int _playoutFrequencyHz;
     FileRecorder* _outputFileRecorderPtr;
-    bool _outputFileRecording;
+    // _outputFileRecorderPtr once recording has started
+    LockFreePointer<FileRecorder> _outputFileRecorder;
+    // set from RecordFileEnded(), which may run on the audio thread
+    volatile int _outputFileRecording;
 };
 
 }  // namespace voe
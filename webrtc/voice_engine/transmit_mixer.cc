@@ -12,6 +12,7 @@
 
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
@@ -26,6 +27,18 @@
 namespace webrtc {
 namespace voe {
 
+namespace {
+
+bool IsNativeRate(int sample_rate_hz) {
+  for (size_t i = 0; i < AudioProcessing::kNumNativeSampleRates; ++i) {
+    if (AudioProcessing::kNativeSampleRatesHz[i] == sample_rate_hz)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 // TODO(ajm): The thread safety of this is dubious...
 void
 TransmitMixer::OnPeriodicProcess()
@@ -181,6 +194,7 @@ TransmitMixer::TransmitMixer(uint32_t instanceId) :
     audioproc_(NULL),
     _voiceEngineObserverPtr(NULL),
     _processThreadPtr(NULL),
+    apm_input_rate_hz_(0),
     _filePlayerPtr(NULL),
     _fileRecorderPtr(NULL),
     _fileCallRecorderPtr(NULL),
@@ -333,14 +347,17 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
                  nSamples, nChannels, samplesPerSec, totalDelayMS, clockDrift,
                  currentMicLevel);
 
-    // --- Resample input audio and create/store the initial audio frame
-    GenerateAudioFrame(static_cast<const int16_t*>(audioSamples),
-                       nSamples,
-                       nChannels,
-                       samplesPerSec);
-
     {
       CriticalSectionScoped cs(&_callbackCritSect);
+      // --- Resample input audio and create/store the initial audio frame
+      // An external preprocessor needs the audio at the processing rate before
+      // the AudioProcessing module runs, so only without one can the module
+      // do the resampling itself.
+      GenerateAudioFrame(static_cast<const int16_t*>(audioSamples),
+                         nSamples,
+                         nChannels,
+                         samplesPerSec,
+                         external_preproc_ptr_ == NULL);
       if (external_preproc_ptr_) {
         external_preproc_ptr_->Process(-1, kRecordingPreprocessing,
                                        _audioFrame.data_,
@@ -408,6 +425,8 @@ TransmitMixer::PrepareDemux(const void* audioSamples,
     }
 
     // --- Measure audio level of speech after all processing.
+    // The channels reuse it for the RTP audio level.
+    AudioFrameOperations::UpdateLevel(&_audioFrame);
     _audioLevel.ComputeLevel(_audioFrame);
     return 0;
 }
@@ -1134,7 +1153,8 @@ bool TransmitMixer::IsRecordingMic()
 void TransmitMixer::GenerateAudioFrame(const int16_t* audio,
                                        size_t samples_per_channel,
                                        size_t num_channels,
-                                       int sample_rate_hz) {
+                                       int sample_rate_hz,
+                                       bool allow_apm_resampling) {
   int codec_rate;
   size_t num_codec_channels;
   GetSendCodecInfo(&codec_rate, &num_codec_channels);
@@ -1149,16 +1169,84 @@ void TransmitMixer::GenerateAudioFrame(const int16_t* audio,
       break;
     }
   }
+  // If that rate is neither the input nor the codec rate, the audio would be
+  // resampled both here and by the AudioCodingModule before encoding, e.g.
+  // from 22.05 to 32 to 48 kHz. Process at the codec rate, or else at the
+  // input rate, instead, so that it is resampled only once.
+  if (_audioFrame.sample_rate_hz_ != sample_rate_hz &&
+      _audioFrame.sample_rate_hz_ != codec_rate) {
+    if (IsNativeRate(codec_rate)) {
+      _audioFrame.sample_rate_hz_ = codec_rate;
+    } else if (IsNativeRate(sample_rate_hz)) {
+      _audioFrame.sample_rate_hz_ = sample_rate_hz;
+    }
+  }
   if (audioproc_->echo_control_mobile()->is_enabled()) {
     // AECM only supports 8 and 16 kHz.
     _audioFrame.sample_rate_hz_ = std::min(
         _audioFrame.sample_rate_hz_, AudioProcessing::kMaxAECMSampleRateHz);
   }
   _audioFrame.num_channels_ = std::min(num_channels, num_codec_channels);
+
+  // When downsampling, hand the capture audio to the AudioProcessing module
+  // in float and let it resample and downmix. The audio is then converted
+  // once each way, instead of to float and back by |resampler_| and again by
+  // the module's own buffers.
+  apm_input_rate_hz_ = 0;
+  if (allow_apm_resampling && sample_rate_hz > _audioFrame.sample_rate_hz_) {
+    if (!apm_input_ ||
+        apm_input_->num_frames() != samples_per_channel ||
+        apm_input_->num_channels() != num_channels) {
+      apm_input_.reset(
+          new ChannelBuffer<float>(samples_per_channel, num_channels));
+    }
+    for (size_t i = 0; i < num_channels; ++i) {
+      float* channel = apm_input_->channels()[i];
+      for (size_t j = 0; j < samples_per_channel; ++j)
+        channel[j] = S16ToFloat(audio[j * num_channels + i]);
+    }
+    apm_input_rate_hz_ = sample_rate_hz;
+    _audioFrame.samples_per_channel_ =
+        static_cast<size_t>(_audioFrame.sample_rate_hz_ / 100);
+    return;
+  }
   RemixAndResample(audio, samples_per_channel, num_channels, sample_rate_hz,
                    &resampler_, &_audioFrame);
 }
 
+int TransmitMixer::ProcessApmInput() {
+  const size_t num_frames = _audioFrame.samples_per_channel_;
+  const size_t num_channels = _audioFrame.num_channels_;
+  if (!apm_output_ ||
+      apm_output_->num_frames() != num_frames ||
+      apm_output_->num_channels() != num_channels) {
+    apm_output_.reset(new ChannelBuffer<float>(num_frames, num_channels));
+  }
+  int err = audioproc_->ProcessStream(
+      apm_input_->channels(),
+      StreamConfig(apm_input_rate_hz_, apm_input_->num_channels()),
+      StreamConfig(_audioFrame.sample_rate_hz_, num_channels),
+      apm_output_->channels());
+  if (err != 0)
+    return err;
+
+  for (size_t i = 0; i < num_channels; ++i) {
+    const float* channel = apm_output_->channels()[i];
+    for (size_t j = 0; j < num_frames; ++j)
+      _audioFrame.data_[j * num_channels + i] = FloatToS16(channel[j]);
+  }
+  _audioFrame.sum_squares_ = -1;
+  // Unlike the AudioFrame interface, the float interface leaves the voice
+  // activity to be queried separately.
+  if (audioproc_->voice_detection()->is_enabled()) {
+    _audioFrame.vad_activity_ =
+        audioproc_->voice_detection()->stream_has_voice()
+            ? AudioFrame::kVadActive
+            : AudioFrame::kVadPassive;
+  }
+  return 0;
+}
+
 int32_t TransmitMixer::RecordAudioToFile(
     uint32_t mixingFrequency)
 {
@@ -1258,7 +1346,8 @@ void TransmitMixer::ProcessAudio(int delay_ms, int clock_drift,
 
   audioproc_->set_stream_key_pressed(key_pressed);
 
-  int err = audioproc_->ProcessStream(&_audioFrame);
+  int err = apm_input_rate_hz_ != 0 ? ProcessApmInput()
+                                     : audioproc_->ProcessStream(&_audioFrame);
   if (err != 0) {
     LOG(LS_ERROR) << "ProcessStream() error: " << err;
     assert(false);
@@ -12,6 +12,7 @@
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/channel_buffer.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_processing/typing_detection.h"
@@ -175,7 +176,8 @@ private:
     void GenerateAudioFrame(const int16_t audioSamples[],
                             size_t nSamples,
                             size_t nChannels,
-                            int samplesPerSec);
+                            int samplesPerSec,
+                            bool allow_apm_resampling);
     int32_t RecordAudioToFile(uint32_t mixingFrequency);
 
     int32_t MixOrReplaceAudioWithFile(
@@ -184,6 +186,9 @@ private:
     void ProcessAudio(int delay_ms, int clock_drift, int current_mic_level,
                       bool key_pressed);
 
+    // Processes |apm_input_| into |_audioFrame|, resampling it on the way.
+    int ProcessApmInput();
+
 #ifdef WEBRTC_VOICE_ENGINE_TYPING_DETECTION
     void TypingDetection(bool keyPressed);
 #endif
@@ -199,6 +204,11 @@ private:
     MonitorModule _monitorModule;
     AudioFrame _audioFrame;
     PushResampler<int16_t> resampler_;  // ADM sample rate -> mixing rate
+    // Capture audio left for the AudioProcessing module to resample; only in
+    // use while |apm_input_rate_hz_| is nonzero.
+    rtc::scoped_ptr<ChannelBuffer<float>> apm_input_;
+    rtc::scoped_ptr<ChannelBuffer<float>> apm_output_;
+    int apm_input_rate_hz_;
     FilePlayer* _filePlayerPtr;
     FileRecorder* _fileRecorderPtr;
     FileRecorder* _fileCallRecorderPtr;
@@ -69,6 +69,7 @@ void RemixAndResample(const int16_t* src_data,
     assert(false);
   }
   dst_frame->samples_per_channel_ = out_length / audio_ptr_num_channels;
+  dst_frame->sum_squares_ = -1;
 
   // Upmix after resampling.
   if (num_channels == 1 && dst_frame->num_channels_ == 2) {
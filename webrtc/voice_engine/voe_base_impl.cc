@@ -773,7 +773,7 @@ void VoEBaseImpl::GetPlayoutData(int sample_rate, size_t number_of_channels,
   // TODO(andrew): if the device is running in mono, we should tell the mixer
   // here so that it will only request mono from AudioCodingModule.
   // Perform mixing of all active participants (channel-based mixing)
-  shared_->output_mixer()->MixActiveChannels();
+  shared_->output_mixer()->MixActiveChannels(sample_rate);
 
   // Additional operations on the combined signal
   shared_->output_mixer()->DoOperationsOnCombinedSignal(feed_data_to_apm);
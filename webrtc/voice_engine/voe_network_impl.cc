@@ -10,6 +10,9 @@
 
 #include "webrtc/voice_engine/voe_network_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/logging.h"
@@ -21,6 +24,18 @@
 
 namespace webrtc {
 
+namespace {
+// L16 at 32 kHz, stereo, 10 ms frames (+12 byte RTP header) -> 1292 bytes
+bool IsValidRtpPacketLength(size_t length) {
+  return length >= 12 && length <= 1292;
+}
+
+bool ByChannel(const VoENetwork::ReceivedPacket* a,
+               const VoENetwork::ReceivedPacket* b) {
+  return a->channel < b->channel;
+}
+}  // namespace
+
 VoENetwork* VoENetwork::GetInterface(VoiceEngine* voiceEngine) {
   if (!voiceEngine) {
     return nullptr;
@@ -70,8 +85,7 @@ int VoENetworkImpl::ReceivedRTPPacket(int channel,
                                       const PacketTime& packet_time) {
   RTC_CHECK(_shared->statistics().Initialized());
   RTC_CHECK(data);
-  // L16 at 32 kHz, stereo, 10 ms frames (+12 byte RTP header) -> 1292 bytes
-  if ((length < 12) || (length > 1292)) {
+  if (!IsValidRtpPacketLength(length)) {
     LOG_F(LS_ERROR) << "Invalid packet length: " << length;
     return -1;
   }
@@ -89,6 +103,53 @@ int VoENetworkImpl::ReceivedRTPPacket(int channel,
                                        packet_time);
 }
 
+int VoENetworkImpl::ReceivedRTPPackets(const ReceivedPacket* packets,
+                                       size_t num_packets) {
+  RTC_CHECK(_shared->statistics().Initialized());
+  RTC_CHECK(packets || num_packets == 0);
+  // A stable sort keeps the packets of each channel in arrival order.
+  std::vector<const ReceivedPacket*> sorted(num_packets);
+  for (size_t i = 0; i < num_packets; ++i)
+    sorted[i] = &packets[i];
+  std::stable_sort(sorted.begin(), sorted.end(), ByChannel);
+
+  int accepted = 0;
+  std::vector<const ReceivedPacket*> valid;
+  valid.reserve(num_packets);
+  for (size_t begin = 0; begin < num_packets;) {
+    const int channel = sorted[begin]->channel;
+    size_t end = begin + 1;
+    while (end < num_packets && sorted[end]->channel == channel)
+      ++end;
+
+    valid.clear();
+    for (size_t i = begin; i < end; ++i) {
+      RTC_CHECK(sorted[i]->data);
+      if (IsValidRtpPacketLength(sorted[i]->length)) {
+        valid.push_back(sorted[i]);
+      } else {
+        LOG_F(LS_ERROR) << "Invalid packet length: " << sorted[i]->length;
+      }
+    }
+    begin = end;
+    if (valid.empty())
+      continue;
+
+    voe::ChannelOwner ch = _shared->channel_manager().GetChannel(channel);
+    voe::Channel* channelPtr = ch.channel();
+    if (!channelPtr) {
+      LOG_F(LS_ERROR) << "Failed to locate channel: " << channel;
+      continue;
+    }
+    if (!channelPtr->ExternalTransport()) {
+      LOG_F(LS_ERROR) << "No external transport for channel: " << channel;
+      continue;
+    }
+    accepted += channelPtr->ReceivedRTPPackets(&valid[0], valid.size());
+  }
+  return accepted;
+}
+
 int VoENetworkImpl::ReceivedRTCPPacket(int channel,
                                        const void* data,
                                        size_t length) {
@@ -27,6 +27,8 @@ class VoENetworkImpl : public VoENetwork {
                         const void* data,
                         size_t length,
                         const PacketTime& packet_time) override;
+  int ReceivedRTPPackets(const ReceivedPacket* packets,
+                         size_t num_packets) override;
 
   int ReceivedRTCPPacket(int channel, const void* data, size_t length) override;
 
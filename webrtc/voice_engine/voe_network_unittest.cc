@@ -97,6 +97,22 @@ TEST_F(VoENetworkTest, ReceivedTooLargeRTPPacketShouldFail) {
                     channelID, kPacket, kMaxValidSizeOfRtpPacketInBytes + 1));
 }
 
+TEST_F(VoENetworkTest, ReceivedRTPPacketsCountsOnlyAcceptedPackets) {
+  int channelID = CreateChannelAndRegisterExternalTransport();
+  int channelWithoutTransport = base_->CreateChannel();
+  EXPECT_NE(channelWithoutTransport, -1);
+  const VoENetwork::ReceivedPacket packets[] = {
+      {channelID, kPacketJunk, sizeof(kPacketJunk), PacketTime()},
+      {kNonExistingChannel, kPacket, sizeof(kPacket), PacketTime()},
+      {channelID, kPacket, kMinValidSizeOfRtpPacketInBytes - 1, PacketTime()},
+      {channelWithoutTransport, kPacket, sizeof(kPacket), PacketTime()},
+      {channelID, kPacket, kMaxValidSizeOfRtpPacketInBytes + 1, PacketTime()},
+  };
+  EXPECT_EQ(0, network_->ReceivedRTPPackets(packets, 0));
+  EXPECT_EQ(0, network_->ReceivedRTPPackets(
+                   packets, sizeof(packets) / sizeof(packets[0])));
+}
+
 TEST_F(VoENetworkTest, ReceivedRTCPPacketWithJunkDataShouldFail) {
   int channelID = CreateChannelAndRegisterExternalTransport();
   EXPECT_EQ(0, network_->ReceivedRTCPPacket(channelID, kPacketJunk,
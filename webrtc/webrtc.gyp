@@ -44,6 +44,16 @@
             'test/test.gyp:rtp_test_utils'
           ],
         },
+        {
+          'target_name': 'rtc_event_log_analyzer',
+          'type': 'executable',
+          'sources': ['call/rtc_event_log_analyzer.cc',],
+          'dependencies': [
+            '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+            'rtc_event_log',
+            'rtc_event_log_proto',
+          ],
+        },
       ],
     }],
   ],